@@ -0,0 +1,248 @@
+/*
+ * linux/arch/arm64/crypto/aes-offload.c - run bulk AES on the LITTLE cluster
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <asm/simd.h>
+#include <crypto/aes.h>
+#include <crypto/algapi.h>
+#include <linux/cpumask.h>
+#include <linux/module.h>
+#include <linux/workqueue.h>
+
+/*
+ * Async front end for the ECB/CBC/CTR/XTS modes of aes-glue.c.
+ *
+ * A request shorter than offload_min is done on the calling cpu, the way
+ * ablk_helper would. A longer one is queued to an unbound workqueue that
+ * only runs on the HMP slow cpus, so dm-crypt or IPsec bulk work does not
+ * take big-core cycles from the task that issued it. The cipher itself is
+ * the synchronous "__driver-*-aes-ce" (or -neon) blkcipher.
+ */
+#define AES_OFFLOAD_PRIO	400	/* above aes-glue-ce */
+#define AES_OFFLOAD_QLEN	256
+
+extern struct cpumask hmp_slow_cpu_mask;
+
+static unsigned int offload_min = 4096;
+module_param(offload_min, uint, 0644);
+
+struct aes_offload_ctx {
+	struct crypto_blkcipher *child;
+};
+
+struct aes_offload_reqctx {
+	bool encrypt;
+};
+
+static struct workqueue_struct *aes_offload_wq;
+static struct crypto_queue aes_offload_queue;
+static DEFINE_SPINLOCK(aes_offload_lock);
+/* one worker per slow cpu, all draining the same queue */
+static struct work_struct aes_offload_works[NR_CPUS];
+static unsigned int aes_offload_nr_works;
+static atomic_t aes_offload_next;
+
+static int aes_offload_setkey(struct crypto_ablkcipher *tfm, const u8 *key,
+			      unsigned int key_len)
+{
+	struct aes_offload_ctx *ctx = crypto_ablkcipher_ctx(tfm);
+	struct crypto_blkcipher *child = ctx->child;
+	int err;
+
+	crypto_blkcipher_clear_flags(child, CRYPTO_TFM_REQ_MASK);
+	crypto_blkcipher_set_flags(child, crypto_ablkcipher_get_flags(tfm) &
+				   CRYPTO_TFM_REQ_MASK);
+	err = crypto_blkcipher_setkey(child, key, key_len);
+	crypto_ablkcipher_set_flags(tfm, crypto_blkcipher_get_flags(child) &
+				    CRYPTO_TFM_RES_MASK);
+	return err;
+}
+
+static int aes_offload_do(struct ablkcipher_request *req, bool encrypt)
+{
+	struct aes_offload_ctx *ctx = crypto_ablkcipher_ctx(crypto_ablkcipher_reqtfm(req));
+	struct blkcipher_desc desc = {
+		.tfm = ctx->child,
+		.info = req->info,
+		.flags = 0,
+	};
+
+	if (encrypt)
+		return crypto_blkcipher_crt(desc.tfm)->encrypt(&desc, req->dst, req->src,
+							       req->nbytes);
+	return crypto_blkcipher_crt(desc.tfm)->decrypt(&desc, req->dst, req->src,
+						       req->nbytes);
+}
+
+static void aes_offload_work(struct work_struct *work)
+{
+	struct crypto_async_request *req, *backlog;
+	struct ablkcipher_request *areq;
+	struct aes_offload_reqctx *rctx;
+	int err;
+
+	for (;;) {
+		spin_lock_bh(&aes_offload_lock);
+		backlog = crypto_get_backlog(&aes_offload_queue);
+		req = crypto_dequeue_request(&aes_offload_queue);
+		spin_unlock_bh(&aes_offload_lock);
+		if (!req)
+			break;
+
+		if (backlog)
+			backlog->complete(backlog, -EINPROGRESS);
+		areq = ablkcipher_request_cast(req);
+		rctx = ablkcipher_request_ctx(areq);
+		err = aes_offload_do(areq, rctx->encrypt);
+
+		/* callers expect completion in softirq context */
+		local_bh_disable();
+		req->complete(req, err);
+		local_bh_enable();
+		cond_resched();
+	}
+}
+
+static int aes_offload_queue_req(struct ablkcipher_request *req, bool encrypt)
+{
+	struct aes_offload_reqctx *rctx = ablkcipher_request_ctx(req);
+	int err;
+
+	if (req->nbytes < offload_min && may_use_simd())
+		return aes_offload_do(req, encrypt);
+
+	rctx->encrypt = encrypt;
+	spin_lock_bh(&aes_offload_lock);
+	err = ablkcipher_enqueue_request(&aes_offload_queue, req);
+	spin_unlock_bh(&aes_offload_lock);
+	queue_work(aes_offload_wq, &aes_offload_works[(unsigned int)
+		   atomic_inc_return(&aes_offload_next) % aes_offload_nr_works]);
+	return err;
+}
+
+static int aes_offload_encrypt(struct ablkcipher_request *req)
+{
+	return aes_offload_queue_req(req, true);
+}
+
+static int aes_offload_decrypt(struct ablkcipher_request *req)
+{
+	return aes_offload_queue_req(req, false);
+}
+
+struct aes_offload_alg {
+	struct crypto_alg alg;
+	const char *child[2];	/* crypto extensions first, then plain NEON */
+};
+
+static int aes_offload_init(struct crypto_tfm *tfm)
+{
+	struct aes_offload_alg *oalg = container_of(tfm->__crt_alg, struct aes_offload_alg, alg);
+	struct aes_offload_ctx *ctx = crypto_tfm_ctx(tfm);
+	struct crypto_blkcipher *child;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(oalg->child); i++) {
+		child = crypto_alloc_blkcipher(oalg->child[i], 0, 0);
+		if (!IS_ERR(child))
+			break;
+	}
+	if (IS_ERR(child))
+		return PTR_ERR(child);
+	ctx->child = child;
+	tfm->crt_ablkcipher.reqsize = sizeof(struct aes_offload_reqctx);
+	return 0;
+}
+
+static void aes_offload_exit(struct crypto_tfm *tfm)
+{
+	struct aes_offload_ctx *ctx = crypto_tfm_ctx(tfm);
+
+	crypto_free_blkcipher(ctx->child);
+}
+
+#define AES_OFFLOAD_ALG(mode, keymul)					\
+{									\
+	.alg = {							\
+		.cra_name		= #mode "(aes)",		\
+		.cra_driver_name	= #mode "-aes-offload",		\
+		.cra_priority		= AES_OFFLOAD_PRIO,		\
+		.cra_flags		= CRYPTO_ALG_TYPE_ABLKCIPHER |	\
+					  CRYPTO_ALG_ASYNC,		\
+		.cra_blocksize		= AES_BLOCK_SIZE,		\
+		.cra_ctxsize		= sizeof(struct aes_offload_ctx), \
+		.cra_alignmask		= 7,				\
+		.cra_type		= &crypto_ablkcipher_type,	\
+		.cra_module		= THIS_MODULE,			\
+		.cra_init		= aes_offload_init,		\
+		.cra_exit		= aes_offload_exit,		\
+		.cra_ablkcipher = {					\
+			.min_keysize	= (keymul) * AES_MIN_KEY_SIZE,	\
+			.max_keysize	= (keymul) * AES_MAX_KEY_SIZE,	\
+			.ivsize		= AES_BLOCK_SIZE,		\
+			.setkey		= aes_offload_setkey,		\
+			.encrypt	= aes_offload_encrypt,		\
+			.decrypt	= aes_offload_decrypt,		\
+		}							\
+	},								\
+	.child = { "__driver-" #mode "-aes-ce",				\
+		   "__driver-" #mode "-aes-neon" },			\
+}
+
+static struct aes_offload_alg aes_offload_algs[] = {
+	AES_OFFLOAD_ALG(ecb, 1),
+	AES_OFFLOAD_ALG(cbc, 1),
+	AES_OFFLOAD_ALG(ctr, 1),
+	AES_OFFLOAD_ALG(xts, 2),
+};
+
+static int __init aes_offload_mod_init(void)
+{
+	struct workqueue_attrs *attrs;
+	int i, err;
+
+	if (cpumask_empty(&hmp_slow_cpu_mask))
+		return -ENODEV;
+
+	aes_offload_wq = alloc_workqueue("aes_offload", WQ_UNBOUND | WQ_MEM_RECLAIM, 0);
+	if (!aes_offload_wq)
+		return -ENOMEM;
+	attrs = alloc_workqueue_attrs(GFP_KERNEL);
+	if (!attrs) {
+		err = -ENOMEM;
+		goto out_wq;
+	}
+	cpumask_copy(attrs->cpumask, &hmp_slow_cpu_mask);
+	err = apply_workqueue_attrs(aes_offload_wq, attrs);
+	free_workqueue_attrs(attrs);
+	if (err)
+		goto out_wq;
+
+	aes_offload_nr_works = cpumask_weight(&hmp_slow_cpu_mask);
+	for (i = 0; i < aes_offload_nr_works; i++)
+		INIT_WORK(&aes_offload_works[i], aes_offload_work);
+	crypto_init_queue(&aes_offload_queue, AES_OFFLOAD_QLEN);
+	for (i = 0; i < ARRAY_SIZE(aes_offload_algs); i++) {
+		err = crypto_register_alg(&aes_offload_algs[i].alg);
+		if (err)
+			goto out_algs;
+	}
+	return 0;
+
+out_algs:
+	while (--i >= 0)
+		crypto_unregister_alg(&aes_offload_algs[i].alg);
+out_wq:
+	destroy_workqueue(aes_offload_wq);
+	return err;
+}
+
+/* after aes-glue so the children are there */
+late_initcall(aes_offload_mod_init);
+
+MODULE_DESCRIPTION("AES-ECB/CBC/CTR/XTS offloaded to the HMP slow cpus");
+MODULE_LICENSE("GPL v2");
@@ -0,0 +1,158 @@
+/*
+ * crc32-arm64.c - CRC32 and CRC32C shash using the ARMv8 CRC32 instructions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <asm/unaligned.h>
+#include <crypto/internal/hash.h>
+#include <linux/cpufeature.h>
+#include <linux/crc32.h>
+#include <linux/crypto.h>
+#include <linux/module.h>
+
+MODULE_DESCRIPTION("CRC32 and CRC32C using ARMv8 CRC32 instructions");
+MODULE_LICENSE("GPL v2");
+MODULE_ALIAS_CRYPTO("crc32");
+MODULE_ALIAS_CRYPTO("crc32c");
+
+/*
+ * The arithmetic is arch/arm64/lib/crc32.c behind crc32_le()/__crc32c_le();
+ * this only gives it a crypto API face with the same key and output
+ * conventions as crypto/crc32.c and crypto/crc32c.c, so it can replace them.
+ */
+#define CHKSUM_BLOCK_SIZE	1
+#define CHKSUM_DIGEST_SIZE	4
+
+struct chksum_ctx {
+	u32 key;
+};
+
+struct chksum_desc_ctx {
+	u32 crc;
+};
+
+static int crc32_cra_init(struct crypto_tfm *tfm)
+{
+	struct chksum_ctx *mctx = crypto_tfm_ctx(tfm);
+
+	mctx->key = 0;
+	return 0;
+}
+
+static int crc32c_cra_init(struct crypto_tfm *tfm)
+{
+	struct chksum_ctx *mctx = crypto_tfm_ctx(tfm);
+
+	mctx->key = ~0;
+	return 0;
+}
+
+static int chksum_setkey(struct crypto_shash *tfm, const u8 *key,
+			 unsigned int keylen)
+{
+	struct chksum_ctx *mctx = crypto_shash_ctx(tfm);
+
+	if (keylen != sizeof(mctx->key)) {
+		crypto_shash_set_flags(tfm, CRYPTO_TFM_RES_BAD_KEY_LEN);
+		return -EINVAL;
+	}
+	mctx->key = get_unaligned_le32(key);
+	return 0;
+}
+
+static int chksum_init(struct shash_desc *desc)
+{
+	struct chksum_ctx *mctx = crypto_shash_ctx(desc->tfm);
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	ctx->crc = mctx->key;
+	return 0;
+}
+
+static int crc32_update(struct shash_desc *desc, const u8 *data,
+			unsigned int length)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	ctx->crc = crc32_le(ctx->crc, data, length);
+	return 0;
+}
+
+static int crc32c_update(struct shash_desc *desc, const u8 *data,
+			 unsigned int length)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	ctx->crc = __crc32c_le(ctx->crc, data, length);
+	return 0;
+}
+
+static int crc32_final(struct shash_desc *desc, u8 *out)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	put_unaligned_le32(ctx->crc, out);
+	return 0;
+}
+
+static int crc32c_final(struct shash_desc *desc, u8 *out)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	put_unaligned_le32(~ctx->crc, out);
+	return 0;
+}
+
+static struct shash_alg crc32_algs[] = { {
+	.setkey			= chksum_setkey,
+	.init			= chksum_init,
+	.update			= crc32_update,
+	.final			= crc32_final,
+	.descsize		= sizeof(struct chksum_desc_ctx),
+	.digestsize		= CHKSUM_DIGEST_SIZE,
+	.base			= {
+		.cra_name		= "crc32",
+		.cra_driver_name	= "crc32-arm64",
+		.cra_priority		= 300,
+		.cra_flags		= CRYPTO_ALG_TYPE_SHASH,
+		.cra_blocksize		= CHKSUM_BLOCK_SIZE,
+		.cra_alignmask		= 0,
+		.cra_ctxsize		= sizeof(struct chksum_ctx),
+		.cra_module		= THIS_MODULE,
+		.cra_init		= crc32_cra_init,
+	}
+}, {
+	.setkey			= chksum_setkey,
+	.init			= chksum_init,
+	.update			= crc32c_update,
+	.final			= crc32c_final,
+	.descsize		= sizeof(struct chksum_desc_ctx),
+	.digestsize		= CHKSUM_DIGEST_SIZE,
+	.base			= {
+		.cra_name		= "crc32c",
+		.cra_driver_name	= "crc32c-arm64",
+		.cra_priority		= 300,
+		.cra_flags		= CRYPTO_ALG_TYPE_SHASH,
+		.cra_blocksize		= CHKSUM_BLOCK_SIZE,
+		.cra_alignmask		= 0,
+		.cra_ctxsize		= sizeof(struct chksum_ctx),
+		.cra_module		= THIS_MODULE,
+		.cra_init		= crc32c_cra_init,
+	}
+} };
+
+static int __init crc32_arm64_mod_init(void)
+{
+	return crypto_register_shashes(crc32_algs, ARRAY_SIZE(crc32_algs));
+}
+
+static void __exit crc32_arm64_mod_exit(void)
+{
+	crypto_unregister_shashes(crc32_algs, ARRAY_SIZE(crc32_algs));
+}
+
+module_cpu_feature_match(CRC32, crc32_arm64_mod_init);
+module_exit(crc32_arm64_mod_exit);
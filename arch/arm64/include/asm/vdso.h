@@ -27,6 +27,7 @@
 
 #ifndef __ASSEMBLY__
 
+#include <linux/topology.h>
 #include <generated/vdso-offsets.h>
 
 #define VDSO_SYMBOL(base, name)						   \
@@ -34,6 +35,16 @@
 	(void *)(vdso_offset_##name - VDSO_LBASE + (unsigned long)(base)); \
 })
 
+/*
+ * TPIDRRO_EL0 of a native task holds the cpu it runs on in the low and
+ * its node in the high word, for __kernel_getcpu. Compat tasks use the
+ * register for their TLS value instead.
+ */
+static inline unsigned long vdso_cpu_id(unsigned int cpu)
+{
+	return cpu | ((unsigned long)cpu_to_node(cpu) << 32);
+}
+
 #endif /* !__ASSEMBLY__ */
 
 #endif /* __KERNEL__ */
@@ -28,6 +28,8 @@ struct vdso_data {
 	__u64 xtime_coarse_nsec;
 	__u64 wtm_clock_sec;	/* Wall to monotonic time */
 	__u64 wtm_clock_nsec;
+	__u64 btm_sec;		/* Monotonic to boot time */
+	__u64 btm_nsec;
 	__u32 tb_seq_count;	/* Timebase sequence counter */
 	__u32 cs_mult;		/* Clocksource multiplier */
 	__u32 cs_shift;		/* Clocksource shift */
@@ -36,6 +36,7 @@
 DEFINE_PER_CPU(struct cpuinfo_arm64, cpu_data);
 static struct cpuinfo_arm64 boot_cpu_data;
 static bool mixed_endian_el0 = true;
+static bool all_cortex_a53 = true;
 
 bool cpu_supports_mixed_endian_el0(void)
 {
@@ -52,9 +53,25 @@ static void update_mixed_endian_el0_support(struct cpuinfo_arm64 *info)
 	mixed_endian_el0 &= id_aa64mmfr0_mixed_endian_el0(info->reg_id_aa64mmfr0);
 }
 
+/*
+ * memcpy() and the user copy routines have paths tuned for the in-order
+ * Cortex-A53, patched in by the alternatives only when every cpu that came
+ * up before smp_cpus_done() is one.
+ */
+static void update_cortex_a53_tuning(struct cpuinfo_arm64 *info)
+{
+	all_cortex_a53 &= MIDR_IMPLEMENTOR(info->reg_midr) == ARM_CPU_IMP_ARM &&
+			  MIDR_PARTNUM(info->reg_midr) == ARM_CPU_PART_CORTEX_A53;
+	if (all_cortex_a53)
+		cpus_set_cap(ARM64_TUNE_CORTEX_A53);
+	else
+		clear_bit(ARM64_TUNE_CORTEX_A53, cpu_hwcaps);
+}
+
 static void update_cpu_features(struct cpuinfo_arm64 *info)
 {
 	update_mixed_endian_el0_support(info);
+	update_cortex_a53_tuning(info);
 }
 
 static char *icache_policy_str[] = {
@@ -50,6 +50,7 @@
 #include <asm/mmu_context.h>
 #include <asm/processor.h>
 #include <asm/stacktrace.h>
+#include <asm/vdso.h>
 
 #ifdef CONFIG_CC_STACKPROTECTOR
 #include <linux/stackprotector.h>
@@ -410,7 +411,7 @@ static void tls_thread_switch(struct task_struct *next)
 		tpidrro = next->thread.tp_value;
 	} else {
 		tpidr = next->thread.tp_value;
-		tpidrro = 0;
+		tpidrro = vdso_cpu_id(smp_processor_id());
 	}
 
 	asm(
@@ -184,6 +184,10 @@ int arch_setup_additional_pages(struct linux_binprm *bprm,
 	if (IS_ERR(ret))
 		goto up_fail;
 
+	/* exec from a compat task left its TLS value here */
+	preempt_disable();
+	asm volatile("msr tpidrro_el0, %0" : : "r" (vdso_cpu_id(smp_processor_id())));
+	preempt_enable();
 
 	up_write(&mm->mmap_sem);
 	return 0;
@@ -200,6 +204,7 @@ up_fail:
 void update_vsyscall(struct timekeeper *tk)
 {
 	struct timespec xtime_coarse;
+	struct timespec btm = ktime_to_timespec(tk->offs_boot);
 	u32 use_syscall = strcmp(tk->tkr.clock->name, "arch_sys_counter");
 
 	++vdso_data->tb_seq_count;
@@ -211,6 +216,8 @@ void update_vsyscall(struct timekeeper *tk)
 	vdso_data->xtime_coarse_nsec		= xtime_coarse.tv_nsec;
 	vdso_data->wtm_clock_sec		= tk->wall_to_monotonic.tv_sec;
 	vdso_data->wtm_clock_nsec		= tk->wall_to_monotonic.tv_nsec;
+	vdso_data->btm_sec			= btm.tv_sec;
+	vdso_data->btm_nsec			= btm.tv_nsec;
 
 	if (!use_syscall) {
 		vdso_data->cs_cycle_last	= tk->tkr.cycle_last;
@@ -0,0 +1,57 @@
+/*
+ * CRC32 and CRC32C using the ARMv8 CRC32 instructions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/crc32.h>
+#include <linux/types.h>
+#include <asm/hwcap.h>
+#include <asm/unaligned.h>
+
+/*
+ * Overrides the weak crc32_le()/__crc32c_le() of lib/crc32.c. The
+ * instructions are optional in ARMv8.0, cpus without them fall back to the
+ * table driven version.
+ */
+#define CRC32_LOOP(crc, p, len, x, w, h, b)				\
+do {									\
+	while (len >= 8) {						\
+		asm(x " %w0, %w0, %x1" : "+r" (crc)			\
+		    : "r" (get_unaligned_le64(p)));			\
+		p += 8;							\
+		len -= 8;						\
+	}								\
+	if (len & 4) {							\
+		asm(w " %w0, %w0, %w1" : "+r" (crc)			\
+		    : "r" (get_unaligned_le32(p)));			\
+		p += 4;							\
+	}								\
+	if (len & 2) {							\
+		asm(h " %w0, %w0, %w1" : "+r" (crc)			\
+		    : "r" (get_unaligned_le16(p)));			\
+		p += 2;							\
+	}								\
+	if (len & 1)							\
+		asm(b " %w0, %w0, %w1" : "+r" (crc) : "r" (*p));	\
+} while (0)
+
+u32 __pure crc32_le(u32 crc, unsigned char const *p, size_t len)
+{
+	if (!(elf_hwcap & HWCAP_CRC32))
+		return crc32_le_base(crc, p, len);
+
+	CRC32_LOOP(crc, p, len, "crc32x", "crc32w", "crc32h", "crc32b");
+	return crc;
+}
+
+u32 __pure __crc32c_le(u32 crc, unsigned char const *p, size_t len)
+{
+	if (!(elf_hwcap & HWCAP_CRC32))
+		return __crc32c_le_base(crc, p, len);
+
+	CRC32_LOOP(crc, p, len, "crc32cx", "crc32cw", "crc32ch", "crc32cb");
+	return crc;
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2016 MediaTek Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <linux/uaccess.h>
+#include <asm/checksum.h>
+
+/*
+ * Internet checksum over 64-bit words. The quadword loads below become ldp,
+ * and adding a 128-bit value to its halves swapped is an adds/adcs pair that
+ * keeps the end-around carry in the flags. NEON is not used: the packets we
+ * sum are short, and kernel_neon_begin() would cost more than it saves.
+ */
+static inline u64 accumulate(u64 sum, u64 data)
+{
+	__uint128_t tmp = (__uint128_t)sum + data;
+
+	return tmp + (tmp >> 64);
+}
+
+unsigned int do_csum(const unsigned char *buff, int len)
+{
+	unsigned int offset, shift, sum;
+	const u64 *ptr;
+	u64 data, sum64 = 0;
+
+	if (unlikely(len <= 0))
+		return 0;
+
+	offset = (unsigned long)buff & 7;
+	/*
+	 * Rounding down cannot touch another page or cache line, and @buff
+	 * never points to anything read-sensitive, so the head and tail are
+	 * read as whole aligned words and the excess bytes masked off.
+	 */
+	ptr = (u64 *)(buff - offset);
+	len = len + offset - 8;
+
+	/*
+	 * Head: zero out the leading bytes. Shifting back by the same amount
+	 * keeps the odd/even alignment, which we fix up at the very end.
+	 */
+	shift = offset * 8;
+	data = *ptr++;
+#ifdef __AARCH64EB__
+	data = (data << shift) >> shift;
+#else
+	data = (data >> shift) << shift;
+#endif
+
+	/*
+	 * Body: aligned loads from here on. The main loop strictly excludes the
+	 * tail, so the second loop will always run at least once.
+	 */
+	while (unlikely(len > 64)) {
+		__uint128_t tmp1, tmp2, tmp3, tmp4;
+
+		tmp1 = *(__uint128_t *)ptr;
+		tmp2 = *(__uint128_t *)(ptr + 2);
+		tmp3 = *(__uint128_t *)(ptr + 4);
+		tmp4 = *(__uint128_t *)(ptr + 6);
+
+		len -= 64;
+		ptr += 8;
+
+		/* This is the "don't dump the carry flag into a GPR" idiom */
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		tmp2 += (tmp2 >> 64) | (tmp2 << 64);
+		tmp3 += (tmp3 >> 64) | (tmp3 << 64);
+		tmp4 += (tmp4 >> 64) | (tmp4 << 64);
+		tmp1 = ((tmp1 >> 64) << 64) | (tmp2 >> 64);
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		tmp3 = ((tmp3 >> 64) << 64) | (tmp4 >> 64);
+		tmp3 += (tmp3 >> 64) | (tmp3 << 64);
+		tmp1 = ((tmp1 >> 64) << 64) | (tmp3 >> 64);
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		tmp1 = ((tmp1 >> 64) << 64) | sum64;
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		sum64 = tmp1 >> 64;
+	}
+	while (len > 8) {
+		__uint128_t tmp;
+
+		sum64 = accumulate(sum64, data);
+		tmp = *(__uint128_t *)ptr;
+
+		len -= 16;
+		ptr += 2;
+
+#ifdef __AARCH64EB__
+		data = tmp;
+		sum64 = accumulate(sum64, tmp >> 64);
+#else
+		data = tmp >> 64;
+		sum64 = accumulate(sum64, tmp);
+#endif
+	}
+	if (len > 0) {
+		sum64 = accumulate(sum64, data);
+		data = *ptr;
+		len -= 8;
+	}
+	/* Tail: zero any over-read bytes, again preserving odd/even alignment */
+	shift = len * -8;
+#ifdef __AARCH64EB__
+	data = (data >> shift) << shift;
+#else
+	data = (data << shift) >> shift;
+#endif
+	sum64 = accumulate(sum64, data);
+
+	/* Finally, folding */
+	sum64 += (sum64 >> 32) | (sum64 << 32);
+	sum = sum64 >> 32;
+	sum += (sum >> 16) | (sum << 16);
+	if (offset & 1)
+		return (u16)swab32(sum);
+
+	return sum >> 16;
+}
+
+static inline __wsum csum_add64(__wsum sum, u64 sum64)
+{
+	u32 res = (__force u32)sum;
+
+	sum64 += (sum64 >> 32) | (sum64 << 32);
+	res += (u32)(sum64 >> 32);
+	return (__force __wsum)(res + (res < (u32)(sum64 >> 32)));
+}
+
+/*
+ * Copy and checksum in one pass. Words are summed as loaded from @src, so
+ * they are relative to its start whatever the alignment of either buffer;
+ * unaligned ldp/stp are cheap on normal memory.
+ */
+__wsum csum_partial_copy_nocheck(const void *src, void *dst, int len, __wsum sum)
+{
+	const unsigned char *s = src;
+	unsigned char *d = dst;
+	u64 sum64 = 0, data;
+
+	while (len >= 32) {
+		__uint128_t tmp1, tmp2;
+
+		memcpy(&tmp1, s, 16);
+		memcpy(&tmp2, s + 16, 16);
+		memcpy(d, &tmp1, 16);
+		memcpy(d + 16, &tmp2, 16);
+		s += 32;
+		d += 32;
+		len -= 32;
+
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		tmp2 += (tmp2 >> 64) | (tmp2 << 64);
+		tmp1 = ((tmp1 >> 64) << 64) | (tmp2 >> 64);
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		tmp1 = ((tmp1 >> 64) << 64) | sum64;
+		tmp1 += (tmp1 >> 64) | (tmp1 << 64);
+		sum64 = tmp1 >> 64;
+	}
+	while (len >= 8) {
+		memcpy(&data, s, 8);
+		memcpy(d, &data, 8);
+		sum64 = accumulate(sum64, data);
+		s += 8;
+		d += 8;
+		len -= 8;
+	}
+	if (len > 0) {
+		/* the remaining bytes keep their place in a zero padded word */
+		data = 0;
+		memcpy(&data, s, len);
+		memcpy(d, s, len);
+#ifdef __AARCH64EB__
+		data >>= (8 - len) * 8;
+		data <<= (8 - len) * 8;
+#endif
+		sum64 = accumulate(sum64, data);
+	}
+
+	return csum_add64(sum, sum64);
+}
+
+/*
+ * Copy from user in chunks small enough to be summed while still in L1.
+ * Chunks are even sized, so each one can be added in at an even offset.
+ * A fault zeroes the rest of @dst, like csum_partial_copy_from_user().
+ */
+#define CSUM_COPY_CHUNK		512
+
+__wsum csum_and_copy_from_user(const void __user *src, void *dst,
+			       int len, __wsum sum, int *err_ptr)
+{
+	int chunk, missing;
+
+	if (unlikely(!access_ok(VERIFY_READ, src, len))) {
+		if (len)
+			*err_ptr = -EFAULT;
+		return sum;
+	}
+
+	while (len > 0) {
+		chunk = min(len, CSUM_COPY_CHUNK);
+		missing = __copy_from_user(dst, src, chunk);
+		if (unlikely(missing)) {
+			memset(dst + chunk - missing, 0, len - chunk + missing);
+			*err_ptr = -EFAULT;
+			return csum_partial(dst, len, sum);
+		}
+		sum = csum_partial(dst, chunk, sum);
+		src += chunk;
+		dst += chunk;
+		len -= chunk;
+	}
+
+	return sum;
+}
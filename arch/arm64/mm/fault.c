@@ -228,6 +228,62 @@ out:
 	return fault;
 }
 
+/*
+ * Faults that need neither a VMA nor mmap_sem: the pte is already there
+ * and allows the access (another thread faulted it in while we trapped),
+ * or only the access flag is clear because reclaim aged the page. The
+ * tables are walked with interrupts off, which holds off their RCU freeing
+ * the way it does for gup_fast, and the access flag is set with a cmpxchg
+ * so a pte changed under us (zap, COW, migration) sends us down the locked
+ * path instead. A pte with AF clear is never in the TLB, so setting it
+ * needs no TLB maintenance.
+ */
+static bool do_page_fault_lockless(struct mm_struct *mm, unsigned long addr,
+				   unsigned long vm_flags)
+{
+	pgd_t *pgdp, pgd;
+	pud_t *pudp, pud;
+	pmd_t *pmdp, pmd;
+	pte_t *ptep, pte;
+	unsigned long flags;
+	bool done = false;
+
+	if (addr >= TASK_SIZE)
+		return false;
+
+	local_irq_save(flags);
+	pgdp = pgd_offset(mm, addr);
+	pgd = ACCESS_ONCE(*pgdp);
+	if (pgd_none(pgd) || pgd_bad(pgd))
+		goto out;
+	pudp = pud_offset(&pgd, addr);
+	pud = ACCESS_ONCE(*pudp);
+	if (pud_none(pud) || pud_bad(pud))
+		goto out;
+	pmdp = pmd_offset(&pud, addr);
+	pmd = ACCESS_ONCE(*pmdp);
+	/* block (huge) mappings are "bad" here and go the locked way */
+	if (pmd_none(pmd) || pmd_bad(pmd))
+		goto out;
+	ptep = pte_offset_map(&pmd, addr);
+	pte = ACCESS_ONCE(*ptep);
+
+	if (!pte_valid_user(pte))
+		goto out;
+	/* vm_flags is the one right the access needed, or all three for a read */
+	if (vm_flags == VM_WRITE && (pte_val(pte) & PTE_RDONLY))
+		goto out;
+	if (vm_flags == VM_EXEC && !pte_exec(pte))
+		goto out;
+
+	done = pte_young(pte) ||
+	       cmpxchg(&pte_val(*ptep), pte_val(pte), pte_val(pte_mkyoung(pte))) == pte_val(pte);
+	pte_unmap(ptep);
+out:
+	local_irq_restore(flags);
+	return done;
+}
+
 static int __kprobes do_page_fault(unsigned long addr, unsigned int esr,
 				   struct pt_regs *regs)
 {
@@ -261,6 +317,13 @@ static int __kprobes do_page_fault(unsigned long addr, unsigned int esr,
 		mm_flags |= FAULT_FLAG_WRITE;
 	}
 
+	if (do_page_fault_lockless(mm, addr, vm_flags)) {
+		perf_sw_event(PERF_COUNT_SW_PAGE_FAULTS, 1, regs, addr);
+		tsk->min_flt++;
+		perf_sw_event(PERF_COUNT_SW_PAGE_FAULTS_MIN, 1, regs, addr);
+		return 0;
+	}
+
 	/*
 	 * As per x86, we may deadlock here. However, since the kernel only
 	 * validly references user space from well defined areas of the code,
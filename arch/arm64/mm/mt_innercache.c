@@ -2,7 +2,15 @@
 #include <linux/interrupt.h>
 #include <linux/cpu.h>
 #include <linux/smp.h>
+#include <linux/debugfs.h>
+#include <linux/dma-direction.h>
+#include <linux/gfp.h>
+#include <linux/ktime.h>
+#include <linux/mm.h>
+#include <linux/seq_file.h>
+#include <asm/cacheflush.h>
 #include <mt-plat/sync_write.h>
+#include <mt-plat/mt_cache_sync.h>
 #include "mt_innercache.h"
 
 /*
@@ -62,7 +70,9 @@ int get_cluster_core_count(void)
  * Must not call this function with disabled interrupts or from a
  * hardware interrupt handler or from a bottom half handler.
  */
-void smp_inner_dcache_flush_all(void)
+static atomic64_t nr_flush_all;
+
+static void __smp_inner_dcache_flush_all(void)
 {
 	int i, j, num_core, total_core, online_cpu;
 	struct cpumask mask;
@@ -104,8 +114,193 @@ void smp_inner_dcache_flush_all(void)
 	preempt_enable();
 	put_online_cpus();
 }
+
+void smp_inner_dcache_flush_all(void)
+{
+	atomic64_inc(&nr_flush_all);
+	__smp_inner_dcache_flush_all();
+}
 EXPORT_SYMBOL(smp_inner_dcache_flush_all);
 
+/*
+ * mt_cache_sync() policy, see mt_cache_sync.h.
+ *
+ * By range costs range_ns_per_kb for each KB, on the calling cpu only. The
+ * set/way flush costs l1_flush_ns on each online cpu plus l2_flush_ns per
+ * online cluster, and every cpu sits in the IPI meanwhile, so its cost is
+ * scaled by setway_bias before the two are compared. setway_min_kb, if
+ * set, overrides the measured break-even size.
+ */
+static unsigned int range_ns_per_kb;
+static unsigned int l1_flush_ns;
+static unsigned int l2_flush_ns;
+static unsigned int setway_bias = 4;
+static unsigned int setway_min_kb;
+
+module_param(setway_bias, uint, 0644);
+module_param(setway_min_kb, uint, 0644);
+
+static atomic64_t nr_range, range_bytes;
+static atomic64_t nr_setway, setway_bytes;
+
+static int mt_cache_online_clusters(void)
+{
+	int i, j, num_core = get_cluster_core_count(), nr = 0;
+
+	for (i = 0; i < num_possible_cpus(); i += num_core) {
+		for (j = i; j < i + num_core; j++) {
+			if (cpu_online(j)) {
+				nr++;
+				break;
+			}
+		}
+	}
+	return nr;
+}
+
+/* break-even size in KB, 0 while the costs are not known */
+static unsigned long mt_cache_setway_kb(void)
+{
+	unsigned long cost;
+
+	if (setway_min_kb)
+		return setway_min_kb;
+	if (!range_ns_per_kb)
+		return 0;
+	cost = (unsigned long)l1_flush_ns * num_online_cpus() +
+	       (unsigned long)l2_flush_ns * mt_cache_online_clusters();
+	return cost * setway_bias / range_ns_per_kb;
+}
+
+static bool mt_cache_use_setway(unsigned long bytes)
+{
+	unsigned long kb = mt_cache_setway_kb();
+
+	/* the IPIs need interrupts on */
+	if (!kb || in_interrupt() || irqs_disabled())
+		return false;
+	return bytes >= kb * 1024;
+}
+
+static void mt_cache_sync_va(unsigned long start, unsigned long size, enum mt_cache_sync_op op)
+{
+	if (op == MT_CACHE_SYNC_CLEAN)
+		__dma_map_area((void *)start, size, DMA_TO_DEVICE);
+	else if (op == MT_CACHE_SYNC_INVALIDATE)
+		__dma_unmap_area((void *)start, size, DMA_FROM_DEVICE);
+	else
+		__dma_flush_range((void *)start, (void *)(start + size));
+}
+
+static int mt_cache_sync_sg(const struct mt_cache_range *r)
+{
+	unsigned long pos = 0, end = r->start + r->size, from, to;
+	struct scatterlist *sg;
+	struct page *page;
+	int i;
+
+	for_each_sg(r->table->sgl, sg, r->table->nents, i) {
+		if (pos >= end)
+			break;
+		from = max(pos, r->start);
+		to = min(pos + sg->length, end);
+		if (from < to) {
+			page = sg_page(sg);
+			if (!page || !pfn_valid(page_to_pfn(page)))
+				return -EINVAL;
+			mt_cache_sync_va((unsigned long)page_address(page) + sg->offset + from - pos,
+					 to - from, r->op);
+		}
+		pos += sg->length;
+	}
+	return 0;
+}
+
+int mt_cache_sync(const struct mt_cache_range *r, int nr)
+{
+	unsigned long total = 0;
+	int i, ret = 0;
+
+	for (i = 0; i < nr; i++)
+		total += r[i].size;
+
+	/* a flush is a superset of clean and invalidate */
+	if (mt_cache_use_setway(total)) {
+		atomic64_inc(&nr_setway);
+		atomic64_add(total, &setway_bytes);
+		__smp_inner_dcache_flush_all();
+		return 0;
+	}
+
+	atomic64_inc(&nr_range);
+	atomic64_add(total, &range_bytes);
+	for (i = 0; i < nr && !ret; i++) {
+		if (r[i].table)
+			ret = mt_cache_sync_sg(&r[i]);
+		else
+			mt_cache_sync_va(r[i].start, r[i].size, r[i].op);
+	}
+	return ret;
+}
+EXPORT_SYMBOL(mt_cache_sync);
+
+static int mt_cache_sync_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "range_ns_per_kb = %u, l1_flush_ns = %u, l2_flush_ns = %u\n",
+		   range_ns_per_kb, l1_flush_ns, l2_flush_ns);
+	seq_printf(m, "setway from %lu KB\n", mt_cache_setway_kb());
+	seq_printf(m, "range: %lld calls, %lld KB\n", (long long)atomic64_read(&nr_range),
+		   (long long)atomic64_read(&range_bytes) >> 10);
+	seq_printf(m, "setway: %lld calls, %lld KB\n", (long long)atomic64_read(&nr_setway),
+		   (long long)atomic64_read(&setway_bytes) >> 10);
+	seq_printf(m, "flush_all: %lld calls\n", (long long)atomic64_read(&nr_flush_all));
+	return 0;
+}
+
+static int mt_cache_sync_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mt_cache_sync_show, NULL);
+}
+
+static const struct file_operations mt_cache_sync_fops = {
+	.open = mt_cache_sync_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+#define MT_CACHE_MEASURE_ORDER	6	/* 256 KB, larger than L2 */
+
+static int __init mt_cache_sync_init(void)
+{
+	unsigned long buf, flags, size = PAGE_SIZE << MT_CACHE_MEASURE_ORDER;
+	ktime_t t;
+
+	buf = __get_free_pages(GFP_KERNEL, MT_CACHE_MEASURE_ORDER);
+	if (buf) {
+		memset((void *)buf, 0x5a, size);
+		t = ktime_get();
+		__dma_flush_range((void *)buf, (void *)(buf + size));
+		range_ns_per_kb = max_t(s64, 1, ktime_to_ns(ktime_sub(ktime_get(), t)) / (size >> 10));
+
+		/* a dirty cache, as the set/way flush would find it */
+		memset((void *)buf, 0xa5, size);
+		local_irq_save(flags);
+		t = ktime_get();
+		inner_dcache_flush_L1();
+		l1_flush_ns = ktime_to_ns(ktime_sub(ktime_get(), t));
+		t = ktime_get();
+		inner_dcache_flush_L2();
+		l2_flush_ns = ktime_to_ns(ktime_sub(ktime_get(), t));
+		local_irq_restore(flags);
+		free_pages(buf, MT_CACHE_MEASURE_ORDER);
+	}
+
+	debugfs_create_file("mt_cache_sync", 0444, NULL, NULL, &mt_cache_sync_fops);
+	return 0;
+}
+late_initcall(mt_cache_sync_init);
+
 #if 0
 static ssize_t cache_test_show(struct device_driver *driver, char *buf)
 {
@@ -608,6 +608,10 @@ struct request_queue *blk_alloc_queue_node(gfp_t gfp_mask, int node_id)
 	if (err)
 		goto fail_id;
 
+	q->comp_cpu_count = alloc_percpu(unsigned long);
+	if (!q->comp_cpu_count)
+		goto fail_bdi;
+
 	setup_timer(&q->backing_dev_info.laptop_mode_wb_timer,
 		    laptop_mode_timer_fn, (unsigned long) q);
 	setup_timer(&q->timeout, blk_rq_timed_out_timer, (unsigned long) q);
@@ -642,10 +646,12 @@ struct request_queue *blk_alloc_queue_node(gfp_t gfp_mask, int node_id)
 	init_waitqueue_head(&q->mq_freeze_wq);
 
 	if (blkcg_init_queue(q))
-		goto fail_bdi;
+		goto fail_count;
 
 	return q;
 
+fail_count:
+	free_percpu(q->comp_cpu_count);
 fail_bdi:
 	bdi_destroy(&q->backing_dev_info);
 fail_id:
@@ -2154,6 +2160,8 @@ void blk_account_io_completion(struct request *req, unsigned int bytes)
 
 void blk_account_io_done(struct request *req)
 {
+	this_cpu_inc(*req->q->comp_cpu_count);
+
 	/*
 	 * Account IO completion.  flush_rq isn't accounted as a
 	 * normal IO on queueing nor completion.  Accounting the
@@ -2449,6 +2457,10 @@ bool blk_update_request(struct request *req, int error, unsigned int nr_bytes)
 	if (!req->bio)
 		return false;
 
+	/* the write cache may be dirty again, see blk_flush_cache_clean() */
+	if (rq_data_dir(req) == WRITE)
+		atomic_long_inc(&req->q->flush_write_seq);
+
 	/*
 	 * For fs requests, rq is just carrier of independent bio's
 	 * and each partial completion should be handled separately.
@@ -52,6 +52,11 @@
  * For devices which support FUA, it isn't clear whether C2 (and thus C3)
  * is beneficial.
  *
+ * A PREFLUSH is skipped when no write has completed since the last
+ * successful flush was issued: everything it would make durable already
+ * is. Back to back fsyncs of a file that did not change, or flushes issued
+ * for each of several filesystems on one device, then cost nothing.
+ *
  * Note that a sequenced FLUSH/FUA request with DATA is completed twice.
  * Once while executing DATA and again after the whole sequence is
  * complete.  The first completion updates the contained bio but doesn't
@@ -110,6 +115,13 @@ static unsigned int blk_flush_policy(unsigned int fflags, struct request *rq)
 	return policy;
 }
 
+static bool blk_flush_cache_clean(struct request_queue *q,
+				  struct blk_flush_queue *fq)
+{
+	return ACCESS_ONCE(fq->flush_seq_clean) ==
+		(unsigned long)atomic_long_read(&q->flush_write_seq);
+}
+
 static unsigned int blk_flush_cur_seq(struct request *rq)
 {
 	return 1 << ffz(rq->flush.seq);
@@ -235,6 +247,8 @@ static void flush_end_io(struct request *flush_rq, int error)
 
 	/* account completion of the flush request */
 	fq->flush_running_idx ^= 1;
+	if (!error)
+		fq->flush_seq_clean = fq->flush_seq_issued;
 
 	if (!q->mq_ops)
 		elv_completed_request(q, flush_rq);
@@ -319,6 +333,7 @@ static bool blk_kick_flush(struct request_queue *q, struct blk_flush_queue *fq)
 	flush_rq->cmd_flags = WRITE_FLUSH | REQ_FLUSH_SEQ;
 	flush_rq->rq_disk = first_rq->rq_disk;
 	flush_rq->end_io = flush_end_io;
+	fq->flush_seq_issued = atomic_long_read(&q->flush_write_seq);
 
 	return blk_flush_queue_rq(flush_rq, false);
 }
@@ -375,6 +390,11 @@ void blk_insert_flush(struct request *rq)
 	unsigned int policy = blk_flush_policy(fflags, rq);
 	struct blk_flush_queue *fq = blk_get_flush_queue(q, rq->mq_ctx);
 
+	if ((policy & REQ_FSEQ_PREFLUSH) && blk_flush_cache_clean(q, fq)) {
+		policy &= ~REQ_FSEQ_PREFLUSH;
+		q->flush_elided++;
+	}
+
 	/*
 	 * @policy now records what operations need to be done.  Adjust
 	 * REQ_FLUSH and FUA for the driver.
@@ -509,6 +529,8 @@ struct blk_flush_queue *blk_alloc_flush_queue(struct request_queue *q,
 	INIT_LIST_HEAD(&fq->flush_queue[0]);
 	INIT_LIST_HEAD(&fq->flush_queue[1]);
 	INIT_LIST_HEAD(&fq->flush_data_in_flight);
+	/* nothing is known to be clean before the first flush */
+	fq->flush_seq_clean = ULONG_MAX;
 
 	return fq;
 
@@ -9,6 +9,7 @@
 #include <linux/interrupt.h>
 #include <linux/cpu.h>
 #include <linux/sched.h>
+#include <linux/topology.h>
 
 #include "blk.h"
 
@@ -102,6 +103,30 @@ static struct notifier_block blk_cpu_notifier = {
 	.notifier_call	= blk_cpu_notify,
 };
 
+/*
+ * rq_affinity 3: complete in the cluster of the submitting cpu @req_cpu.
+ * The interrupted cpu @cpu completes the request itself when it is in that
+ * cluster. Otherwise an awake cpu of the cluster, the submitter first, is
+ * picked so that the completion does not wake an idle one; if the whole
+ * cluster is idle, the submitter gets it.
+ */
+int blk_cluster_complete_cpu(int cpu, int req_cpu)
+{
+	const struct cpumask *cluster = topology_core_cpumask(req_cpu);
+	int i;
+
+	if (cpumask_test_cpu(cpu, cluster))
+		return cpu;
+	if (!idle_cpu(req_cpu))
+		return req_cpu;
+
+	for_each_cpu_and(i, cluster, cpu_online_mask)
+		if (!idle_cpu(i))
+			return i;
+
+	return req_cpu;
+}
+
 void __blk_complete_request(struct request *req)
 {
 	int ccpu, cpu;
@@ -119,7 +144,9 @@ void __blk_complete_request(struct request *req)
 	 */
 	if (req->cpu != -1) {
 		ccpu = req->cpu;
-		if (!test_bit(QUEUE_FLAG_SAME_FORCE, &q->queue_flags))
+		if (test_bit(QUEUE_FLAG_SAME_CLUSTER, &q->queue_flags))
+			ccpu = blk_cluster_complete_cpu(cpu, ccpu);
+		else if (!test_bit(QUEUE_FLAG_SAME_FORCE, &q->queue_flags))
 			shared = cpus_share_cache(cpu, ccpu);
 	} else
 		ccpu = cpu;
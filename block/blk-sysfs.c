@@ -255,6 +255,8 @@ static ssize_t queue_rq_affinity_show(struct request_queue *q, char *page)
 	bool set = test_bit(QUEUE_FLAG_SAME_COMP, &q->queue_flags);
 	bool force = test_bit(QUEUE_FLAG_SAME_FORCE, &q->queue_flags);
 
+	if (test_bit(QUEUE_FLAG_SAME_CLUSTER, &q->queue_flags))
+		return queue_var_show(3, page);
 	return queue_var_show(set << force, page);
 }
 
@@ -270,7 +272,12 @@ queue_rq_affinity_store(struct request_queue *q, const char *page, size_t count)
 		return ret;
 
 	spin_lock_irq(q->queue_lock);
-	if (val == 2) {
+	queue_flag_clear(QUEUE_FLAG_SAME_CLUSTER, q);
+	if (val == 3) {
+		queue_flag_set(QUEUE_FLAG_SAME_COMP, q);
+		queue_flag_clear(QUEUE_FLAG_SAME_FORCE, q);
+		queue_flag_set(QUEUE_FLAG_SAME_CLUSTER, q);
+	} else if (val == 2) {
 		queue_flag_set(QUEUE_FLAG_SAME_COMP, q);
 		queue_flag_set(QUEUE_FLAG_SAME_FORCE, q);
 	} else if (val == 1) {
@@ -285,6 +292,34 @@ queue_rq_affinity_store(struct request_queue *q, const char *page, size_t count)
 	return ret;
 }
 
+static ssize_t queue_completion_cpus_show(struct request_queue *q, char *page)
+{
+	ssize_t len = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		len += scnprintf(page + len, PAGE_SIZE - len, "cpu%d %lu\n", cpu,
+				 *per_cpu_ptr(q->comp_cpu_count, cpu));
+	return len;
+}
+
+static ssize_t queue_flush_elided_show(struct request_queue *q, char *page)
+{
+	return queue_var_show(q->flush_elided, page);
+}
+
+static ssize_t
+queue_completion_cpus_store(struct request_queue *q, const char *page,
+			    size_t count)
+{
+	int cpu;
+
+	/* any write clears the counts */
+	for_each_possible_cpu(cpu)
+		*per_cpu_ptr(q->comp_cpu_count, cpu) = 0;
+	return count;
+}
+
 static struct queue_sysfs_entry queue_requests_entry = {
 	.attr = {.name = "nr_requests", .mode = S_IRUGO | S_IWUSR },
 	.show = queue_requests_show,
@@ -392,6 +427,17 @@ static struct queue_sysfs_entry queue_rq_affinity_entry = {
 	.store = queue_rq_affinity_store,
 };
 
+static struct queue_sysfs_entry queue_flush_elided_entry = {
+	.attr = {.name = "flush_elided", .mode = S_IRUGO },
+	.show = queue_flush_elided_show,
+};
+
+static struct queue_sysfs_entry queue_completion_cpus_entry = {
+	.attr = {.name = "completion_cpus", .mode = S_IRUGO | S_IWUSR },
+	.show = queue_completion_cpus_show,
+	.store = queue_completion_cpus_store,
+};
+
 static struct queue_sysfs_entry queue_iostats_entry = {
 	.attr = {.name = "iostats", .mode = S_IRUGO | S_IWUSR },
 	.show = queue_show_iostats,
@@ -425,6 +471,8 @@ static struct attribute *default_attrs[] = {
 	&queue_nonrot_entry.attr,
 	&queue_nomerges_entry.attr,
 	&queue_rq_affinity_entry.attr,
+	&queue_completion_cpus_entry.attr,
+	&queue_flush_elided_entry.attr,
 	&queue_iostats_entry.attr,
 	&queue_random_entry.attr,
 	NULL,
@@ -521,6 +569,7 @@ static void blk_release_queue(struct kobject *kobj)
 	blk_trace_shutdown(q);
 
 	bdi_destroy(&q->backing_dev_info);
+	free_percpu(q->comp_cpu_count);
 
 	ida_simple_remove(&blk_queue_ida, q->id);
 	call_rcu(&q->rcu_head, blk_free_queue_rcu);
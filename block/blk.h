@@ -23,6 +23,8 @@ struct blk_flush_queue {
 	struct list_head	flush_data_in_flight;
 	struct request		*flush_rq;
 	spinlock_t		mq_flush_lock;
+	unsigned long		flush_seq_issued;	/* q->flush_write_seq at issue */
+	unsigned long		flush_seq_clean;	/* same, of the last good flush */
 };
 
 extern struct kmem_cache *blk_requestq_cachep;
@@ -84,6 +86,8 @@ void blk_account_io_start(struct request *req, bool new_io);
 void blk_account_io_completion(struct request *req, unsigned int bytes);
 void blk_account_io_done(struct request *req);
 
+int blk_cluster_complete_cpu(int cpu, int req_cpu);
+
 /*
  * Internal atomic flags for request handling
  */
@@ -13,6 +13,7 @@
 #include <linux/init.h>
 #include <linux/compiler.h>
 #include <linux/rbtree.h>
+#include <linux/sched.h>
 
 /*
  * See Documentation/block/deadline-iosched.txt
@@ -22,6 +23,11 @@ static const int write_expire = 5 * HZ; /* ditto for writes, these limits are SO
 static const int writes_starved = 2;    /* max times reads can starve a write */
 static const int fifo_batch = 16;       /* # of sequential requests treated as one
 				     by the above parameters. For throughput. */
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+static const int fg_expire = HZ / 20;	/* foreground class deadline */
+static const int fg_batch = 32;		/* max fg requests in a row while
+					   background requests wait */
+#endif
 
 struct deadline_data {
 	/*
@@ -41,6 +47,15 @@ struct deadline_data {
 	unsigned int batching;		/* number of sequential requests made */
 	sector_t last_sector;		/* head position */
 	unsigned int starved;		/* times reads have starved writes */
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	/*
+	 * foreground requests are on the sort_list of their direction
+	 * but on fg_fifo instead of the fifo_list
+	 */
+	struct list_head fg_fifo;
+	unsigned int fg_dispatched;	/* fg requests dispatched in a row */
+	unsigned int bg_quota;		/* background requests owed */
+#endif
 
 	/*
 	 * settings that change how the i/o scheduler behaves
@@ -49,8 +64,17 @@ struct deadline_data {
 	int fifo_batch;
 	int writes_starved;
 	int front_merges;
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	int fg_expire;
+	int fg_batch;
+#endif
 };
 
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+#define RQ_FG(rq)		((rq)->elv.priv[0])
+#define RQ_SET_FG(rq)		((rq)->elv.priv[0] = (void *) 1)
+#endif
+
 static void deadline_move_request(struct deadline_data *, struct request *);
 
 static inline struct rb_root *
@@ -106,10 +130,54 @@ deadline_add_request(struct request_queue *q, struct request *rq)
 	/*
 	 * set expire time and add to fifo list
 	 */
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	if (RQ_FG(rq)) {
+		rq->fifo_time = jiffies + dd->fg_expire;
+		list_add_tail(&rq->queuelist, &dd->fg_fifo);
+		return;
+	}
+#endif
 	rq->fifo_time = jiffies + dd->fifo_expire[data_dir];
 	list_add_tail(&rq->queuelist, &dd->fifo_list[data_dir]);
 }
 
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+/*
+ * Classify the request while we still run in the context of the task
+ * that submits it.  Only sync requests can be foreground, writeback of
+ * a foreground task's pages is background work.
+ */
+static int deadline_set_request(struct request_queue *q, struct request *rq,
+				struct bio *bio, gfp_t gfp_mask)
+{
+	if (rq_is_sync(rq) && task_io_foreground(current))
+		RQ_SET_FG(rq);
+
+	return 0;
+}
+
+/*
+ * A foreground bio merged into a background request: move the request
+ * to the foreground fifo, keeping the earlier of the two deadlines.
+ */
+static void deadline_bio_merged(struct request_queue *q, struct request *rq,
+				struct bio *bio)
+{
+	struct deadline_data *dd = q->elevator->elevator_data;
+	unsigned long expire;
+
+	if (RQ_FG(rq) || !rw_is_sync(bio->bi_rw) ||
+	    !task_io_foreground(current))
+		return;
+
+	RQ_SET_FG(rq);
+	expire = jiffies + dd->fg_expire;
+	if (time_before(expire, rq->fifo_time))
+		rq->fifo_time = expire;
+	list_move_tail(&rq->queuelist, &dd->fg_fifo);
+}
+#endif
+
 /*
  * remove rq from rbtree and fifo.
  */
@@ -177,6 +245,10 @@ deadline_merged_requests(struct request_queue *q, struct request *req,
 		if (time_before(next->fifo_time, req->fifo_time)) {
 			list_move(&req->queuelist, &next->queuelist);
 			req->fifo_time = next->fifo_time;
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+			/* took next's place, maybe on the fg_fifo */
+			req->elv.priv[0] = next->elv.priv[0];
+#endif
 		}
 	}
 
@@ -248,6 +320,28 @@ static int deadline_dispatch_requests(struct request_queue *q, int force)
 	struct request *rq;
 	int data_dir;
 
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	if (!list_empty(&dd->fg_fifo)) {
+		if (!reads && !writes)
+			goto dispatch_fg;
+
+		/*
+		 * Foreground requests go ahead of everything else, but after
+		 * fg_batch of them in a row background gets a batch.
+		 */
+		if (!dd->bg_quota) {
+			if (dd->fg_dispatched < dd->fg_batch) {
+				dd->fg_dispatched++;
+				goto dispatch_fg;
+			}
+			dd->bg_quota = max(dd->fifo_batch, 1);
+		}
+	}
+	dd->fg_dispatched = 0;
+	if (dd->bg_quota)
+		dd->bg_quota--;
+#endif
+
 	/*
 	 * batches are currently reads XOR writes
 	 */
@@ -322,6 +416,18 @@ dispatch_request:
 	deadline_move_request(dd, rq);
 
 	return 1;
+
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+dispatch_fg:
+	/*
+	 * all foreground requests have the same deadline, so the fifo
+	 * order is the deadline order
+	 */
+	rq = rq_entry_fifo(dd->fg_fifo.next);
+	deadline_move_request(dd, rq);
+
+	return 1;
+#endif
 }
 
 static void deadline_exit_queue(struct elevator_queue *e)
@@ -330,6 +436,9 @@ static void deadline_exit_queue(struct elevator_queue *e)
 
 	BUG_ON(!list_empty(&dd->fifo_list[READ]));
 	BUG_ON(!list_empty(&dd->fifo_list[WRITE]));
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	BUG_ON(!list_empty(&dd->fg_fifo));
+#endif
 
 	kfree(dd);
 }
@@ -362,6 +471,11 @@ static int deadline_init_queue(struct request_queue *q, struct elevator_type *e)
 	dd->writes_starved = writes_starved;
 	dd->front_merges = 1;
 	dd->fifo_batch = fifo_batch;
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	INIT_LIST_HEAD(&dd->fg_fifo);
+	dd->fg_expire = fg_expire;
+	dd->fg_batch = fg_batch;
+#endif
 
 	spin_lock_irq(q->queue_lock);
 	q->elevator = eq;
@@ -402,6 +516,10 @@ SHOW_FUNCTION(deadline_write_expire_show, dd->fifo_expire[WRITE], 1);
 SHOW_FUNCTION(deadline_writes_starved_show, dd->writes_starved, 0);
 SHOW_FUNCTION(deadline_front_merges_show, dd->front_merges, 0);
 SHOW_FUNCTION(deadline_fifo_batch_show, dd->fifo_batch, 0);
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+SHOW_FUNCTION(deadline_fg_expire_show, dd->fg_expire, 1);
+SHOW_FUNCTION(deadline_fg_batch_show, dd->fg_batch, 0);
+#endif
 #undef SHOW_FUNCTION
 
 #define STORE_FUNCTION(__FUNC, __PTR, MIN, MAX, __CONV)			\
@@ -425,6 +543,10 @@ STORE_FUNCTION(deadline_write_expire_store, &dd->fifo_expire[WRITE], 0, INT_MAX,
 STORE_FUNCTION(deadline_writes_starved_store, &dd->writes_starved, INT_MIN, INT_MAX, 0);
 STORE_FUNCTION(deadline_front_merges_store, &dd->front_merges, 0, 1, 0);
 STORE_FUNCTION(deadline_fifo_batch_store, &dd->fifo_batch, 0, INT_MAX, 0);
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+STORE_FUNCTION(deadline_fg_expire_store, &dd->fg_expire, 0, INT_MAX, 1);
+STORE_FUNCTION(deadline_fg_batch_store, &dd->fg_batch, 0, INT_MAX, 0);
+#endif
 #undef STORE_FUNCTION
 
 #define DD_ATTR(name) \
@@ -437,6 +559,10 @@ static struct elv_fs_entry deadline_attrs[] = {
 	DD_ATTR(writes_starved),
 	DD_ATTR(front_merges),
 	DD_ATTR(fifo_batch),
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	DD_ATTR(fg_expire),
+	DD_ATTR(fg_batch),
+#endif
 	__ATTR_NULL
 };
 
@@ -451,6 +577,10 @@ static struct elevator_type iosched_deadline = {
 		.elevator_latter_req_fn =	elv_rb_latter_request,
 		.elevator_init_fn =		deadline_init_queue,
 		.elevator_exit_fn =		deadline_exit_queue,
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+		.elevator_set_req_fn =		deadline_set_request,
+		.elevator_bio_merged_fn =	deadline_bio_merged,
+#endif
 	},
 
 	.elevator_attrs = deadline_attrs,
@@ -37,6 +37,9 @@
 #include <linux/math64.h>
 #include <linux/wait.h>
 #endif
+#ifdef CONFIG_MTPROF
+#include "bootprof.h"
+#endif
 
 #include "../base.h"
 #include "power.h"
@@ -537,11 +540,17 @@ static int dpm_run_callback(pm_callback_t cb, struct device *dev,
 {
 	ktime_t calltime;
 	int error;
+#ifdef CONFIG_MTPROF
+	unsigned long long ts;
+#endif
 
 	if (!cb)
 		return 0;
 
 	calltime = initcall_debug_start(dev);
+#ifdef CONFIG_MTPROF
+	ts = sched_clock();
+#endif
 
 	pm_dev_dbg(dev, state, info);
 	trace_device_pm_callback_start(dev, info, state.event);
@@ -549,6 +558,9 @@ static int dpm_run_callback(pm_callback_t cb, struct device *dev,
 	trace_device_pm_callback_end(dev, error);
 	suspend_report_result(cb, error);
 
+#ifdef CONFIG_MTPROF
+	bootprof_pm_dev(dev, info, ts);
+#endif
 	initcall_debug_report(dev, calltime, error, state, info);
 
 	return error;
@@ -1822,6 +1834,9 @@ int dpm_prepare(pm_message_t state)
 
 	trace_suspend_resume(TPS("dpm_prepare"), state.event, true);
 	might_sleep();
+#ifdef CONFIG_MTPROF
+	bootprof_pm_begin();
+#endif
 
 	mutex_lock(&dpm_list_mtx);
 	while (!list_empty(&dpm_list)) {
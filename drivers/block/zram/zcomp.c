@@ -13,6 +13,7 @@
 #include <linux/slab.h>
 #include <linux/wait.h>
 #include <linux/sched.h>
+#include <linux/percpu.h>
 
 #include "zcomp.h"
 #include "zcomp_lzo.h"
@@ -31,6 +32,7 @@ struct zcomp_strm_single {
 	struct zcomp_strm *zstrm;
 };
 
+#ifndef CONFIG_ZRAM_PERCPU_STREAMS
 /*
  * multi zcomp_strm backend
  */
@@ -45,6 +47,14 @@ struct zcomp_strm_multi {
 	struct list_head idle_strm;
 	wait_queue_head_t strm_wait;
 };
+#else
+/*
+ * per-cpu zcomp_strm backend
+ */
+struct zcomp_strm_percpu {
+	struct zcomp_strm * __percpu *zstrm;
+};
+#endif
 
 static struct zcomp_backend *backends[] = {
 	&zcomp_lzo,
@@ -99,6 +109,7 @@ static struct zcomp_strm *zcomp_strm_alloc(struct zcomp *comp)
 	return zstrm;
 }
 
+#ifndef CONFIG_ZRAM_PERCPU_STREAMS
 /*
  * get idle zcomp_strm or wait until other process release
  * (zcomp_strm_release()) one for us
@@ -223,6 +234,89 @@ static int zcomp_strm_multi_create(struct zcomp *comp, int max_strm)
 	list_add(&zstrm->list, &zs->idle_strm);
 	return 0;
 }
+#else
+/*
+ * use the stream of the current cpu. Its mutex is only contended when a
+ * writer got migrated while compressing, so there is no shared lock on
+ * the fast path.
+ */
+static struct zcomp_strm *zcomp_strm_percpu_find(struct zcomp *comp)
+{
+	struct zcomp_strm_percpu *zs = comp->stream;
+	struct zcomp_strm *zstrm;
+
+	zstrm = *per_cpu_ptr(zs->zstrm, raw_smp_processor_id());
+	mutex_lock(&zstrm->lock);
+	return zstrm;
+}
+
+static void zcomp_strm_percpu_release(struct zcomp *comp,
+		struct zcomp_strm *zstrm)
+{
+	mutex_unlock(&zstrm->lock);
+}
+
+static bool zcomp_strm_percpu_set_max_streams(struct zcomp *comp, int num_strm)
+{
+	/* one stream per possible cpu, the limit does not apply */
+	return true;
+}
+
+static void zcomp_strm_percpu_free(struct zcomp *comp,
+		struct zcomp_strm_percpu *zs)
+{
+	struct zcomp_strm *zstrm;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		zstrm = *per_cpu_ptr(zs->zstrm, cpu);
+		if (zstrm)
+			zcomp_strm_free(comp, zstrm);
+	}
+	free_percpu(zs->zstrm);
+	kfree(zs);
+}
+
+static void zcomp_strm_percpu_destroy(struct zcomp *comp)
+{
+	zcomp_strm_percpu_free(comp, comp->stream);
+}
+
+static int zcomp_strm_percpu_create(struct zcomp *comp)
+{
+	struct zcomp_strm_percpu *zs;
+	struct zcomp_strm *zstrm;
+	int cpu;
+
+	comp->destroy = zcomp_strm_percpu_destroy;
+	comp->strm_find = zcomp_strm_percpu_find;
+	comp->strm_release = zcomp_strm_percpu_release;
+	comp->set_max_streams = zcomp_strm_percpu_set_max_streams;
+	zs = kmalloc(sizeof(struct zcomp_strm_percpu), GFP_KERNEL);
+	if (!zs)
+		return -ENOMEM;
+
+	/* zeroed, so a partially populated set can be freed */
+	zs->zstrm = alloc_percpu(struct zcomp_strm *);
+	if (!zs->zstrm) {
+		kfree(zs);
+		return -ENOMEM;
+	}
+
+	for_each_possible_cpu(cpu) {
+		zstrm = zcomp_strm_alloc(comp);
+		if (!zstrm) {
+			zcomp_strm_percpu_free(comp, zs);
+			return -ENOMEM;
+		}
+		mutex_init(&zstrm->lock);
+		*per_cpu_ptr(zs->zstrm, cpu) = zstrm;
+	}
+
+	comp->stream = zs;
+	return 0;
+}
+#endif
 
 static struct zcomp_strm *zcomp_strm_single_find(struct zcomp *comp)
 {
@@ -355,7 +449,11 @@ struct zcomp *zcomp_create(const char *compress, int max_strm)
 
 	comp->backend = backend;
 	if (max_strm > 1)
+#ifdef CONFIG_ZRAM_PERCPU_STREAMS
+		zcomp_strm_percpu_create(comp);
+#else
 		zcomp_strm_multi_create(comp, max_strm);
+#endif
 	else
 		zcomp_strm_single_create(comp);
 	if (!comp->stream) {
@@ -23,6 +23,10 @@ struct zcomp_strm {
 	void *private;
 	/* used in multi stream backend, protected by backend strm_lock */
 	struct list_head list;
+#ifdef CONFIG_ZRAM_PERCPU_STREAMS
+	/* used in per-cpu stream backend, owner of the stream */
+	struct mutex lock;
+#endif
 };
 
 /* static compression backend */
@@ -35,9 +35,14 @@
 #include <linux/err.h>
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+#include <linux/kthread.h>
+#include <linux/swap.h>
+#include <asm/topology.h>
+#endif
 
 #ifdef CONFIG_ZSM
-#include <linux/rbtree.h>
+#include <linux/hash.h>
 #include <linux/time.h>
 #endif
 #include "zram_drv.h"
@@ -52,10 +57,21 @@ static unsigned int num_devices = 1;
 #ifdef CONFIG_ZSM
 #define SIZE_MASK (BIT(ZRAM_FLAG_SHIFT) - 1)
 #define TABLE_GET_SIZE(X) (X & SIZE_MASK)
-static struct rb_root root_zram_tree = RB_ROOT;
-static struct rb_root root_zram_tree_4k = RB_ROOT;
-spinlock_t zram_node_mutex;
-spinlock_t zram_node4k_mutex;
+/*
+ * Same page index: entries are hashed by the checksum the compressor
+ * computed and their stored size. Each bucket has its own lock, so dedup
+ * lookups of different pages do not serialize. A bucket holds one
+ * ZRAM_HASH_NODE entry per distinct key, entries sharing the key are
+ * chained on its ->head list.
+ */
+#define ZSM_HASH_BITS	10
+
+struct zsm_bucket {
+	spinlock_t lock;
+	struct hlist_head head;
+};
+
+static struct zsm_bucket zsm_hash[1 << ZSM_HASH_BITS];
 
 static int zram_test_flag(struct zram_meta *meta, u32 index,
 			enum zram_pageflags flag);
@@ -134,62 +150,45 @@ static struct zram_table_entry *search_node_in_zram_list(struct zram *zram, stru
 	}
 	return NULL;
 }
-static struct zram_table_entry *search_node_in_zram_tree(struct zram_table_entry *input_node,
-		struct rb_node **parent_node, struct rb_node ***new_node, unsigned char *match_content,
-		struct rb_root *local_root_zram_tree)
+static struct zsm_bucket *zsm_bucket_of(struct zram_table_entry *node)
 {
-	struct rb_node **new = &(local_root_zram_tree->rb_node);
-	struct zram_table_entry *current_node = NULL;
-	struct rb_node *parent = NULL;
-
-	current_node = rb_entry(*new, struct zram_table_entry, node);
-	if (input_node == NULL) {
-		pr_err("[zram][search_node_in_zram_tree] input_node is NULL\n");
-		return NULL;
-	}
-	if (current_node == NULL) {
-		*new_node = new;
-		*parent_node = NULL;
-		return NULL;
-	}
-
-	while (*new) {
-		current_node = rb_entry(*new, struct zram_table_entry, node);
-		parent = *new;
-		if (input_node->checksum > current_node->checksum) {
-			new = &parent->rb_right;
-		} else if (input_node->checksum < current_node->checksum) {
-			new = &parent->rb_left;
-		} else {
-			if (TABLE_GET_SIZE(input_node->value) > TABLE_GET_SIZE(current_node->value))
-				new = &parent->rb_right;
-			else if (TABLE_GET_SIZE(input_node->value) < TABLE_GET_SIZE(current_node->value))
-				new = &parent->rb_left;
-			else
-				return current_node;
-		}
+	u64 key = ((u64)node->checksum << 32) | TABLE_GET_SIZE(node->value);
+
+	return &zsm_hash[hash_64(key, ZSM_HASH_BITS)];
+}
+
+/* caller holds the bucket lock */
+static struct zram_table_entry *search_node_in_zsm_hash(struct zsm_bucket *bucket,
+		struct zram_table_entry *input_node)
+{
+	struct zram_table_entry *current_node;
+
+	hlist_for_each_entry(current_node, &bucket->head, hnode) {
+		if (input_node->checksum == current_node->checksum &&
+		    TABLE_GET_SIZE(input_node->value) == TABLE_GET_SIZE(current_node->value))
+			return current_node;
 	}
-	*parent_node = parent;
-	*new_node = new;
 	return NULL;
 }
-static u32 insert_node_to_zram_tree(struct zram *zram, struct zram_meta *meta, u32 index, unsigned char *match_content,
-		struct rb_root *local_root_zram_tree, u32 clen)
+static u32 insert_node_to_zsm_hash(struct zram *zram, struct zram_meta *meta, u32 index, unsigned char *match_content,
+		u32 clen)
 {
 	struct zram_table_entry *current_node = NULL;
 	struct zram_table_entry *node_in_list = NULL;
-	struct rb_node *parent = NULL;
-	struct rb_node **new = NULL;
 	struct zram_table_entry *input_node;
+	struct zsm_bucket *bucket;
+	u32 ret = 0;
 
 	input_node = &(meta->table[index]);
+	bucket = zsm_bucket_of(input_node);
+	spin_lock(&bucket->lock);
 	zsm_set_flag_index(meta, index, ZRAM_ZSM_NODE);
-	current_node = search_node_in_zram_tree(input_node, &parent, &new, match_content, local_root_zram_tree);
+	current_node = search_node_in_zsm_hash(bucket, input_node);
 
-	/* found node in zram_tree */
+	/* found node in zsm hash */
 	if (NULL != current_node) {
-		if (!zsm_test_flag(meta, current_node, ZRAM_RB_NODE)) {
-			pr_err("[ZRAM]ERROR !!found wrong rb node 0x%p\n", (void *)current_node);
+		if (!zsm_test_flag(meta, current_node, ZRAM_HASH_NODE)) {
+			pr_err("[ZRAM]ERROR !!found wrong hash node 0x%p\n", (void *)current_node);
 			BUG_ON(1);
 		}
 
@@ -216,19 +215,21 @@ static u32 insert_node_to_zram_tree(struct zram *zram, struct zram_meta *meta, u
 			input_node->handle = node_in_list->handle;
 			list_add(&input_node->head, &node_in_list->head);
 			zsm_set_flag_index(meta, index, ZRAM_ZSM_DONE_NODE);
-			return 1;
+			ret = 1;
+			goto out;
 		}
 		/* can't found node in list */
 		zsm_set_flag_index(meta, index, ZRAM_FIRST_NODE);
 		list_add(&input_node->head, &current_node->head);
 	} else {
-		/* insert node into rb tree */
+		/* insert node into the hash */
 		zsm_set_flag_index(meta, index, ZRAM_FIRST_NODE);
-		zsm_set_flag_index(meta, index, ZRAM_RB_NODE);
-		rb_link_node(&(meta->table[index].node), parent, new);
-		rb_insert_color(&(meta->table[index].node), local_root_zram_tree);
+		zsm_set_flag_index(meta, index, ZRAM_HASH_NODE);
+		hlist_add_head(&input_node->hnode, &bucket->head);
 	}
-	return 0;
+out:
+	spin_unlock(&bucket->lock);
+	return ret;
 }
 static int remove_node_from_zram_list(struct zram *zram, struct zram_meta *meta, u32 index)
 {
@@ -314,11 +315,12 @@ static int remove_node_from_zram_list(struct zram *zram, struct zram_meta *meta,
 	}
 	return 0;
 }
-static int remove_node_from_zram_tree(struct zram *zram, struct zram_meta *meta, u32 index,
-		struct rb_root *local_root_zram_tree)
+static int remove_node_from_zsm_hash(struct zram *zram, struct zram_meta *meta, u32 index)
 {
+	struct zsm_bucket *bucket = zsm_bucket_of(&meta->table[index]);
 	int ret;
 
+	spin_lock(&bucket->lock);
 	if (zsm_test_flag_index(meta, index, ZRAM_ZSM_NODE)) {
 		zsm_clear_flag_index(meta, index, ZRAM_ZSM_NODE);
 	} else {
@@ -329,33 +331,46 @@ static int remove_node_from_zram_tree(struct zram *zram, struct zram_meta *meta,
 		zsm_clear_flag_index(meta, index, ZRAM_ZSM_DONE_NODE);
 	else
 		pr_err("[ZSM] index node %x is not set and will be removed\n", index);
-	/* if it is rb node, choose other node from list and replace original node. */
-	if (zsm_test_flag_index(meta, index, ZRAM_RB_NODE)) {
-		zsm_clear_flag_index(meta, index, ZRAM_RB_NODE);
+	/* if it is hash node, choose other node from list and replace original node. */
+	if (zsm_test_flag_index(meta, index, ZRAM_HASH_NODE)) {
+		zsm_clear_flag_index(meta, index, ZRAM_HASH_NODE);
+		hlist_del(&(meta->table[index].hnode));
 		/* found next node in list */
 		if (&(meta->table[index].head) != meta->table[index].head.next) {
 			struct zram_table_entry *next_table;
 
 			next_table = list_entry(meta->table[index].head.next, struct zram_table_entry, head);
-			rb_replace_node(&(meta->table[index].node), &(next_table->node), local_root_zram_tree);
-			zsm_set_flag(meta, next_table, ZRAM_RB_NODE);
+			hlist_add_head(&(next_table->hnode), &bucket->head);
+			zsm_set_flag(meta, next_table, ZRAM_HASH_NODE);
 			ret = remove_node_from_zram_list(zram, meta, index);
-			return ret;
+			goto out;
 		}
-		/* if no other node can be found in list just remove node from rb tree and free handle */
+		/* if no other node can be found in list just remove node from hash and free handle */
 		if (zsm_test_flag_index(meta, index, ZRAM_FIRST_NODE)) {
 			zsm_clear_flag_index(meta, index, ZRAM_FIRST_NODE);
 		} else {
-			pr_err("[ZRAM]ERROR !!ZRAM_RB_NODR's flag != ZRAM_FIRST_NODE index %x\n ",
+			pr_err("[ZRAM]ERROR !!ZRAM_HASH_NODE's flag != ZRAM_FIRST_NODE index %x\n ",
 					index);
 			BUG_ON(1);
 		}
-		rb_erase(&(meta->table[index].node), local_root_zram_tree);
-		return 0;
+		ret = 0;
+		goto out;
 	}
 	ret = remove_node_from_zram_list(zram, meta, index);
+out:
+	spin_unlock(&bucket->lock);
 	return ret;
 }
+
+static void __init zsm_hash_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(zsm_hash); i++) {
+		spin_lock_init(&zsm_hash[i].lock);
+		INIT_HLIST_HEAD(&zsm_hash[i].head);
+	}
+}
 #endif
 
 
@@ -566,6 +581,43 @@ static ssize_t comp_algorithm_store(struct device *dev,
 	return len;
 }
 
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+static ssize_t async_compress_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	bool val;
+	struct zram *zram = dev_to_zram(dev);
+
+	down_read(&zram->init_lock);
+	val = zram->async_comp;
+	up_read(&zram->init_lock);
+
+	return scnprintf(buf, PAGE_SIZE, "%d\n", val);
+}
+
+static ssize_t async_compress_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	bool val;
+	int ret;
+
+	ret = strtobool(buf, &val);
+	if (ret < 0)
+		return ret;
+
+	down_write(&zram->init_lock);
+	if (init_done(zram)) {
+		up_write(&zram->init_lock);
+		pr_info("Can't change async compression for initialized device\n");
+		return -EBUSY;
+	}
+	zram->async_comp = val;
+	up_write(&zram->init_lock);
+	return len;
+}
+#endif
+
 /* flag operations needs meta->tb_lock */
 static int zram_test_flag(struct zram_meta *meta, u32 index,
 			enum zram_pageflags flag)
@@ -674,21 +726,36 @@ static void update_position(u32 *index, int *offset, struct bio_vec *bvec)
 	*offset = (*offset + bvec->bv_len) % PAGE_SIZE;
 }
 
-static int page_zero_filled(void *ptr)
+/*
+ * Pages made of one repeated word (zero pages, memset() patterns) are
+ * neither compressed nor looked up for duplicates: the word is all that
+ * gets stored.
+ */
+static int page_same_filled(void *ptr, unsigned long *element)
 {
 	unsigned int pos;
 	unsigned long *page;
 
 	page = (unsigned long *)ptr;
 
-	for (pos = 0; pos != PAGE_SIZE / sizeof(*page); pos++) {
-		if (page[pos])
+	for (pos = 1; pos != PAGE_SIZE / sizeof(*page); pos++) {
+		if (page[pos] != page[0])
 			return 0;
 	}
 
+	*element = page[0];
 	return 1;
 }
 
+static void zram_fill_page(void *ptr, unsigned long element)
+{
+	unsigned long *page = ptr;
+	unsigned int pos;
+
+	for (pos = 0; pos != PAGE_SIZE / sizeof(*page); pos++)
+		page[pos] = element;
+}
+
 static void handle_zero_page(struct bio_vec *bvec)
 {
 	struct page *page = bvec->bv_page;
@@ -705,6 +772,36 @@ static void handle_zero_page(struct bio_vec *bvec)
 }
 
 
+#ifdef CONFIG_ZRAM_WRITEBACK
+/* allocate a backing device block, 0 if the device is full */
+static unsigned long zram_bd_alloc(struct zram *zram)
+{
+	unsigned long blk;
+
+	spin_lock(&zram->bd_lock);
+	blk = find_next_zero_bit(zram->bd_bitmap, zram->bd_nr_pages,
+				 zram->bd_next);
+	if (blk >= zram->bd_nr_pages)
+		blk = find_next_zero_bit(zram->bd_bitmap, zram->bd_nr_pages, 1);
+	if (blk >= zram->bd_nr_pages) {
+		spin_unlock(&zram->bd_lock);
+		return 0;
+	}
+	set_bit(blk, zram->bd_bitmap);
+	zram->bd_next = blk + 1;
+	spin_unlock(&zram->bd_lock);
+
+	return blk;
+}
+
+static void zram_bd_free(struct zram *zram, unsigned long blk)
+{
+	spin_lock(&zram->bd_lock);
+	clear_bit(blk, zram->bd_bitmap);
+	spin_unlock(&zram->bd_lock);
+}
+#endif
+
 /*
  * To protect concurrent access to the same index entry,
  * caller should hold this table index entry's bit_spinlock to
@@ -717,6 +814,24 @@ static void zram_free_page(struct zram *zram, size_t index)
 #ifdef CONFIG_ZSM
 	int ret = 0;
 #endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	zram_clear_flag(meta, index, ZRAM_IDLE);
+	zram_clear_flag(meta, index, ZRAM_HUGE);
+	zram_clear_flag(meta, index, ZRAM_UNDER_WB);
+	if (zram_test_flag(meta, index, ZRAM_WB)) {
+		zram_clear_flag(meta, index, ZRAM_WB);
+		zram_bd_free(zram, handle);
+		atomic64_dec(&zram->stats.bd_count);
+		meta->table[index].handle = 0;
+		return;
+	}
+#endif
+	if (zram_test_flag(meta, index, ZRAM_SAME)) {
+		zram_clear_flag(meta, index, ZRAM_SAME);
+		meta->table[index].handle = 0;
+		atomic64_dec(&zram->stats.same_pages);
+		return;
+	}
 	if (unlikely(!handle)) {
 		/*
 		 * No memory is allocated for zero filled pages.
@@ -730,15 +845,7 @@ static void zram_free_page(struct zram *zram, size_t index)
 	}
 #ifdef CONFIG_ZSM
 	if (!zram_test_flag(meta, index, ZRAM_ZERO) && zsm_test_flag_index(meta, index, ZRAM_ZSM_NODE)) {
-		if (TABLE_GET_SIZE(meta->table[index].value) == PAGE_SIZE) {
-			spin_lock(&zram_node4k_mutex);
-			ret = remove_node_from_zram_tree(zram, meta, index, &root_zram_tree_4k);
-			spin_unlock(&zram_node4k_mutex);
-		} else {
-			spin_lock(&zram_node_mutex);
-			ret = remove_node_from_zram_tree(zram, meta, index, &root_zram_tree);
-			spin_unlock(&zram_node_mutex);
-		}
+		ret = remove_node_from_zsm_hash(zram, meta, index);
 	} else if (!zsm_test_flag_index(meta, index, ZRAM_ZSM_NODE))
 		pr_err("[ZSM]ERROR! try to free noexist ZSM node index %x\n", index);
 	if (ret == 0) {
@@ -772,6 +879,18 @@ static int zram_decompress_page(struct zram *zram, char *mem, u32 index)
 		clear_page(mem);
 		return 0;
 	}
+	if (zram_test_flag(meta, index, ZRAM_SAME)) {
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		zram_fill_page(mem, handle);
+		return 0;
+	}
+#ifdef CONFIG_ZRAM_WRITEBACK
+	/* the caller has to read it from the backing device */
+	if (zram_test_flag(meta, index, ZRAM_WB)) {
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		return -EAGAIN;
+	}
+#endif
 
 	cmem = zs_map_object(meta->mem_pool, handle, ZS_MM_RO);
 	if (size == PAGE_SIZE)
@@ -790,6 +909,107 @@ static int zram_decompress_page(struct zram *zram, char *mem, u32 index)
 	return 0;
 }
 
+#ifdef CONFIG_ZRAM_WRITEBACK
+struct zram_bd_read {
+	struct work_struct work;
+	struct zram *zram;
+	struct page *page;
+	unsigned long blk;
+	int ret;
+};
+
+static void zram_bd_read_work(struct work_struct *work)
+{
+	struct zram_bd_read *rd = container_of(work, struct zram_bd_read, work);
+	struct bio *bio;
+
+	bio = bio_alloc(GFP_NOIO, 1);
+	if (!bio) {
+		rd->ret = -ENOMEM;
+		return;
+	}
+	bio->bi_bdev = rd->zram->bdev;
+	bio->bi_iter.bi_sector = rd->blk << SECTORS_PER_PAGE_SHIFT;
+	bio_add_page(bio, rd->page, PAGE_SIZE, 0);
+	rd->ret = submit_bio_wait(READ, bio);
+	bio_put(bio);
+}
+
+/*
+ * Copy the page of @index from the backing device to @mem, -EAGAIN if it
+ * is not there (anymore). The read is issued from a worker: called from
+ * zram_make_request(), a bio submitted here would sit on current->bio_list
+ * until we return.
+ */
+static int zram_bd_read_page(struct zram *zram, char *mem, u32 index)
+{
+	struct zram_meta *meta = zram->meta;
+	struct zram_bd_read rd;
+
+	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+	if (!zram_test_flag(meta, index, ZRAM_WB)) {
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		return -EAGAIN;
+	}
+	rd.blk = meta->table[index].handle;
+	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+
+	rd.page = alloc_page(GFP_NOIO);
+	if (!rd.page)
+		return -ENOMEM;
+	rd.zram = zram;
+	INIT_WORK_ONSTACK(&rd.work, zram_bd_read_work);
+	queue_work(system_unbound_wq, &rd.work);
+	flush_work(&rd.work);
+	destroy_work_on_stack(&rd.work);
+
+	if (!rd.ret) {
+		copy_page(mem, page_address(rd.page));
+		atomic64_inc(&zram->stats.bd_reads);
+	}
+	__free_page(rd.page);
+	return rd.ret;
+}
+
+/* zram_decompress_page() that may sleep, wherever the page is */
+static int zram_read_page(struct zram *zram, char *mem, u32 index)
+{
+	int ret;
+
+	do {
+		ret = zram_decompress_page(zram, mem, index);
+		if (ret == -EAGAIN)
+			ret = zram_bd_read_page(zram, mem, index);
+	} while (ret == -EAGAIN);
+
+	return ret;
+}
+
+static int zram_bvec_read_bdev(struct zram *zram, struct bio_vec *bvec,
+			       u32 index, int offset)
+{
+	struct page *page = bvec->bv_page;
+	unsigned char *user_mem, *uncmem;
+	int ret;
+
+	uncmem = kmalloc(PAGE_SIZE, GFP_NOIO);
+	if (!uncmem)
+		return -ENOMEM;
+
+	ret = zram_read_page(zram, uncmem, index);
+	if (!ret) {
+		user_mem = kmap_atomic(page);
+		memcpy(user_mem + bvec->bv_offset, uncmem + offset,
+		       bvec->bv_len);
+		kunmap_atomic(user_mem);
+		flush_dcache_page(page);
+	}
+
+	kfree(uncmem);
+	return ret;
+}
+#endif
+
 static int zram_bvec_read(struct zram *zram, struct bio_vec *bvec,
 			  u32 index, int offset, struct bio *bio)
 {
@@ -807,6 +1027,14 @@ static int zram_bvec_read(struct zram *zram, struct bio_vec *bvec,
 		handle_zero_page(bvec);
 		return 0;
 	}
+#ifdef CONFIG_ZRAM_WRITEBACK
+	if (zram_test_flag(meta, index, ZRAM_WB)) {
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		return zram_bvec_read_bdev(zram, bvec, index, offset);
+	}
+	/* accessed, keep it in memory */
+	zram_clear_flag(meta, index, ZRAM_IDLE);
+#endif
 	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 
 	if (is_partial_io(bvec))
@@ -824,6 +1052,15 @@ static int zram_bvec_read(struct zram *zram, struct bio_vec *bvec,
 	}
 
 	ret = zram_decompress_page(zram, uncmem, index);
+#ifdef CONFIG_ZRAM_WRITEBACK
+	/* written back under us, read it from the device out of kmap */
+	if (ret == -EAGAIN) {
+		kunmap_atomic(user_mem);
+		if (is_partial_io(bvec))
+			kfree(uncmem);
+		return zram_bvec_read_bdev(zram, bvec, index, offset);
+	}
+#endif
 	/* Should NEVER happen. Return bio error if it does. */
 	if (unlikely(ret))
 		goto out_cleanup;
@@ -864,7 +1101,7 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 	int checksum = 0;
 #endif
 	size_t clen;
-	unsigned long handle;
+	unsigned long handle, element;
 	struct page *page;
 	unsigned char *user_mem, *cmem, *src, *uncmem = NULL;
 	struct zram_meta *meta = zram->meta;
@@ -884,20 +1121,17 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 			ret = -ENOMEM;
 			goto out;
 		}
+#ifdef CONFIG_ZRAM_WRITEBACK
+		ret = zram_read_page(zram, uncmem, index);
+#else
 		ret = zram_decompress_page(zram, uncmem, index);
+#endif
 		if (ret)
 			goto out;
 #ifdef CONFIG_ZSM
-		if (!zram_test_flag(meta, index, ZRAM_ZERO)) {
-			if (zram_get_obj_size(meta, index) == PAGE_SIZE) {
-				spin_lock(&zram_node4k_mutex);
-				ret = remove_node_from_zram_tree(zram, meta, index, &root_zram_tree_4k);
-				spin_unlock(&zram_node4k_mutex);
-			} else {
-				spin_lock(&zram_node_mutex);
-				ret = remove_node_from_zram_tree(zram, meta, index, &root_zram_tree);
-				spin_unlock(&zram_node_mutex);
-			}
+		if (!zram_test_flag(meta, index, ZRAM_ZERO) &&
+		    !zram_test_flag(meta, index, ZRAM_SAME)) {
+			ret = remove_node_from_zsm_hash(zram, meta, index);
 		}
 #endif
 	}
@@ -915,16 +1149,24 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 		uncmem = user_mem;
 	}
 
-	if (page_zero_filled(uncmem)) {
+	if (page_same_filled(uncmem, &element)) {
 		if (user_mem)
 			kunmap_atomic(user_mem);
 		/* Free memory associated with this sector now. */
 		bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
 		zram_free_page(zram, index);
-		zram_set_flag(meta, index, ZRAM_ZERO);
+		if (element) {
+			meta->table[index].handle = element;
+			zram_set_flag(meta, index, ZRAM_SAME);
+		} else {
+			zram_set_flag(meta, index, ZRAM_ZERO);
+		}
 		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 
-		atomic64_inc(&zram->stats.zero_pages);
+		if (element)
+			atomic64_inc(&zram->stats.same_pages);
+		else
+			atomic64_inc(&zram->stats.zero_pages);
 		ret = 0;
 		goto out;
 	}
@@ -963,14 +1205,10 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 		if ((clen == PAGE_SIZE) && !is_partial_io(bvec)) {
 			src = kmap_atomic(page);
-			spin_lock(&zram_node4k_mutex);
-			search_ret = insert_node_to_zram_tree(zram, meta, index, src, &root_zram_tree_4k, clen);
-			spin_unlock(&zram_node4k_mutex);
+			search_ret = insert_node_to_zsm_hash(zram, meta, index, src, clen);
 			kunmap_atomic(src);
 		} else {
-			spin_lock(&zram_node4k_mutex);
-			search_ret = insert_node_to_zram_tree(zram, meta, index, src, &root_zram_tree_4k, clen);
-			spin_unlock(&zram_node4k_mutex);
+			search_ret = insert_node_to_zsm_hash(zram, meta, index, src, clen);
 		}
 		if (search_ret) {
 			ret = 0;
@@ -992,9 +1230,7 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 		meta->table[index].copy_count = 0;
 		INIT_LIST_HEAD(&(meta->table[index].head));
 		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
-		spin_lock(&zram_node_mutex);
-		search_ret = insert_node_to_zram_tree(zram, meta, index, src, &root_zram_tree, clen);
-		spin_unlock(&zram_node_mutex);
+		search_ret = insert_node_to_zsm_hash(zram, meta, index, src, clen);
 		if (search_ret) {
 			ret = 0;
 			goto out;
@@ -1042,6 +1278,10 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 	zram_set_obj_size(meta, index, clen);
 #ifdef CONFIG_ZSM
 	zsm_set_flag_index(meta, index, ZRAM_ZSM_DONE_NODE);
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	if (clen == PAGE_SIZE)
+		zram_set_flag(meta, index, ZRAM_HUGE);
 #endif
 	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 
@@ -1080,6 +1320,385 @@ static int zram_bvec_rw(struct zram *zram, struct bio_vec *bvec, u32 index,
 	return ret;
 }
 
+#ifdef CONFIG_ZRAM_WRITEBACK
+#define ZRAM_WB_IDLE	0	/* pages marked idle and not accessed since */
+#define ZRAM_WB_HUGE	1	/* pages that did not compress */
+
+struct zram_wb_batch {
+	int nr;
+	u32 index[ZRAM_WB_BATCH];
+	unsigned long blk[ZRAM_WB_BATCH];
+	struct page *page[ZRAM_WB_BATCH];
+};
+
+static bool zram_wb_candidate(struct zram_meta *meta, u32 index, int mode)
+{
+	if (!meta->table[index].handle ||
+	    zram_test_flag(meta, index, ZRAM_ZERO) ||
+	    zram_test_flag(meta, index, ZRAM_SAME) ||
+	    zram_test_flag(meta, index, ZRAM_WB))
+		return false;
+
+	if (mode == ZRAM_WB_HUGE)
+		return zram_test_flag(meta, index, ZRAM_HUGE);
+	return zram_test_flag(meta, index, ZRAM_IDLE);
+}
+
+static void zram_wb_cancel(struct zram_meta *meta, u32 index)
+{
+	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+	zram_clear_flag(meta, index, ZRAM_UNDER_WB);
+	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+}
+
+/*
+ * Write the batch, which covers consecutive backing blocks, with a single
+ * bio and switch the entries that were not rewritten meanwhile over to the
+ * backing device.
+ */
+static int zram_wb_flush(struct zram *zram, struct zram_wb_batch *wb)
+{
+	struct zram_meta *meta = zram->meta;
+	struct bio *bio;
+	int i, ret, done = 0;
+
+	if (!wb->nr)
+		return 0;
+
+	bio = bio_alloc(GFP_KERNEL, wb->nr);
+	if (!bio) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	bio->bi_bdev = zram->bdev;
+	bio->bi_iter.bi_sector = wb->blk[0] << SECTORS_PER_PAGE_SHIFT;
+	for (i = 0; i < wb->nr; i++)
+		bio_add_page(bio, wb->page[i], PAGE_SIZE, 0);
+	ret = submit_bio_wait(WRITE, bio);
+	bio_put(bio);
+	if (ret)
+		goto out;
+
+	for (i = 0; i < wb->nr; i++) {
+		u32 index = wb->index[i];
+
+		bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+		if (!zram_test_flag(meta, index, ZRAM_UNDER_WB)) {
+			bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+			continue;
+		}
+		zram_free_page(zram, index);
+		meta->table[index].handle = wb->blk[i];
+		zram_set_flag(meta, index, ZRAM_WB);
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+
+		/* now owned by the entry */
+		wb->blk[i] = 0;
+		atomic64_inc(&zram->stats.bd_count);
+		atomic64_inc(&zram->stats.bd_writes);
+		done++;
+	}
+	ret = done;
+out:
+	for (i = 0; i < wb->nr; i++) {
+		if (!wb->blk[i])
+			continue;
+		zram_wb_cancel(meta, wb->index[i]);
+		zram_bd_free(zram, wb->blk[i]);
+	}
+	wb->nr = 0;
+	return ret;
+}
+
+/* write back idle or huge pages, returns the number of pages written */
+static long zram_writeback(struct zram *zram, int mode)
+{
+	struct zram_meta *meta = zram->meta;
+	unsigned long nr_pages = zram->disksize >> PAGE_SHIFT;
+	struct zram_wb_batch *wb;
+	unsigned long blk = 0;
+	long ret, written = 0;
+	u32 index;
+	int i;
+
+	if (!zram->bdev)
+		return -ENODEV;
+
+	wb = kzalloc(sizeof(*wb), GFP_KERNEL);
+	if (!wb)
+		return -ENOMEM;
+	for (i = 0; i < ZRAM_WB_BATCH; i++) {
+		wb->page[i] = alloc_page(GFP_KERNEL);
+		if (!wb->page[i]) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+
+	mutex_lock(&zram->wb_lock);
+	for (index = 0; index < nr_pages; index++) {
+		if (!blk) {
+			blk = zram_bd_alloc(zram);
+			if (!blk)
+				break;
+		}
+
+		bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+		if (!zram_wb_candidate(meta, index, mode)) {
+			bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+			continue;
+		}
+		zram_set_flag(meta, index, ZRAM_UNDER_WB);
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+
+		/* one bio per run of consecutive blocks */
+		if (wb->nr && blk != wb->blk[wb->nr - 1] + 1) {
+			ret = zram_wb_flush(zram, wb);
+			if (ret < 0) {
+				zram_wb_cancel(meta, index);
+				break;
+			}
+			written += ret;
+		}
+
+		if (zram_decompress_page(zram, page_address(wb->page[wb->nr]),
+					 index)) {
+			zram_wb_cancel(meta, index);
+			continue;
+		}
+		wb->index[wb->nr] = index;
+		wb->blk[wb->nr] = blk;
+		blk = 0;
+		if (++wb->nr < ZRAM_WB_BATCH)
+			continue;
+
+		ret = zram_wb_flush(zram, wb);
+		if (ret < 0)
+			break;
+		written += ret;
+	}
+	if (blk)
+		zram_bd_free(zram, blk);
+	ret = zram_wb_flush(zram, wb);
+	if (ret > 0)
+		written += ret;
+	mutex_unlock(&zram->wb_lock);
+
+	ret = written;
+out:
+	for (i = 0; i < ZRAM_WB_BATCH; i++)
+		if (wb->page[i])
+			__free_page(wb->page[i]);
+	kfree(wb);
+	return ret;
+}
+
+/* mark every page in memory idle, an access clears it again */
+static void zram_mark_idle(struct zram *zram)
+{
+	struct zram_meta *meta = zram->meta;
+	unsigned long nr_pages = zram->disksize >> PAGE_SHIFT;
+	u32 index;
+
+	for (index = 0; index < nr_pages; index++) {
+		bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+		if (meta->table[index].handle &&
+		    !zram_test_flag(meta, index, ZRAM_WB))
+			zram_set_flag(meta, index, ZRAM_IDLE);
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		cond_resched();
+	}
+}
+
+/*
+ * Every wb_idle_secs: write back what stayed idle since the last run,
+ * i.e. for at least wb_idle_secs, then mark everything idle again.
+ */
+static void zram_wb_work(struct work_struct *work)
+{
+	struct zram *zram = container_of(to_delayed_work(work),
+					 struct zram, wb_work);
+	long ret;
+
+	down_read(&zram->init_lock);
+	if (!init_done(zram) || !zram->bdev || !zram->wb_idle_secs) {
+		up_read(&zram->init_lock);
+		return;
+	}
+
+	ret = zram_writeback(zram, ZRAM_WB_HUGE);
+	if (ret >= 0)
+		ret = zram_writeback(zram, ZRAM_WB_IDLE);
+	if (ret < 0)
+		pr_debug("Writeback failed: %ld\n", ret);
+	zram_mark_idle(zram);
+
+	queue_delayed_work(system_long_wq, &zram->wb_work,
+			   zram->wb_idle_secs * HZ);
+	up_read(&zram->init_lock);
+}
+
+static void zram_reset_bdev(struct zram *zram)
+{
+	if (!zram->bdev)
+		return;
+
+	blkdev_put(zram->bdev, FMODE_READ | FMODE_WRITE | FMODE_EXCL);
+	zram->bdev = NULL;
+	vfree(zram->bd_bitmap);
+	zram->bd_bitmap = NULL;
+	zram->bd_nr_pages = 0;
+	zram->backing_dev[0] = '\0';
+}
+
+static ssize_t backing_dev_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct zram *zram = dev_to_zram(dev);
+	ssize_t ret;
+
+	down_read(&zram->init_lock);
+	ret = scnprintf(buf, PAGE_SIZE, "%s\n",
+			zram->bdev ? zram->backing_dev : "none");
+	up_read(&zram->init_lock);
+
+	return ret;
+}
+
+static ssize_t backing_dev_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct block_device *bdev;
+	unsigned long nr_pages, *bitmap;
+	char path[sizeof(zram->backing_dev)];
+	int ret;
+
+	strlcpy(path, buf, sizeof(path));
+	strim(path);
+
+	down_write(&zram->init_lock);
+	if (init_done(zram)) {
+		pr_info("Can't setup backing device for initialized device\n");
+		ret = -EBUSY;
+		goto out;
+	}
+
+	zram_reset_bdev(zram);
+	if (!strcmp(path, "none")) {
+		ret = len;
+		goto out;
+	}
+
+	bdev = blkdev_get_by_path(path, FMODE_READ | FMODE_WRITE | FMODE_EXCL,
+				  zram);
+	if (IS_ERR(bdev)) {
+		ret = PTR_ERR(bdev);
+		goto out;
+	}
+
+	nr_pages = i_size_read(bdev->bd_inode) >> PAGE_SHIFT;
+	bitmap = vzalloc(BITS_TO_LONGS(nr_pages) * sizeof(long));
+	if (nr_pages < 2 || !bitmap) {
+		vfree(bitmap);
+		blkdev_put(bdev, FMODE_READ | FMODE_WRITE | FMODE_EXCL);
+		ret = nr_pages < 2 ? -EINVAL : -ENOMEM;
+		goto out;
+	}
+
+	ret = set_blocksize(bdev, PAGE_SIZE);
+	if (ret) {
+		vfree(bitmap);
+		blkdev_put(bdev, FMODE_READ | FMODE_WRITE | FMODE_EXCL);
+		goto out;
+	}
+
+	/* block 0 stays reserved so that a block number is never 0 */
+	set_bit(0, bitmap);
+	zram->bdev = bdev;
+	zram->bd_bitmap = bitmap;
+	zram->bd_nr_pages = nr_pages;
+	zram->bd_next = 1;
+	strlcpy(zram->backing_dev, path, sizeof(zram->backing_dev));
+	pr_info("Setup backing device %s, %lu pages\n", path, nr_pages);
+	ret = len;
+out:
+	up_write(&zram->init_lock);
+	return ret;
+}
+
+static ssize_t idle_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	ssize_t ret = len;
+
+	if (!sysfs_streq(buf, "all"))
+		return -EINVAL;
+
+	down_read(&zram->init_lock);
+	if (init_done(zram))
+		zram_mark_idle(zram);
+	else
+		ret = -EINVAL;
+	up_read(&zram->init_lock);
+
+	return ret;
+}
+
+static ssize_t writeback_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	int mode;
+	long ret;
+
+	if (sysfs_streq(buf, "idle"))
+		mode = ZRAM_WB_IDLE;
+	else if (sysfs_streq(buf, "huge"))
+		mode = ZRAM_WB_HUGE;
+	else
+		return -EINVAL;
+
+	down_read(&zram->init_lock);
+	if (init_done(zram))
+		ret = zram_writeback(zram, mode);
+	else
+		ret = -EINVAL;
+	up_read(&zram->init_lock);
+
+	return ret < 0 ? ret : len;
+}
+
+static ssize_t writeback_idle_secs_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct zram *zram = dev_to_zram(dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", zram->wb_idle_secs);
+}
+
+static ssize_t writeback_idle_secs_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	unsigned int secs;
+	int ret;
+
+	ret = kstrtouint(buf, 0, &secs);
+	if (ret < 0)
+		return ret;
+
+	down_read(&zram->init_lock);
+	zram->wb_idle_secs = secs;
+	if (secs && init_done(zram))
+		mod_delayed_work(system_long_wq, &zram->wb_work, secs * HZ);
+	up_read(&zram->init_lock);
+
+	return len;
+}
+#endif
+
 /*
  * zram_bio_discard - handler on discard request
  * @index: physical block index in PAGE_SIZE units
@@ -1119,11 +1738,23 @@ static void zram_bio_discard(struct zram *zram, u32 index,
 	}
 }
 
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+static void zram_async_start(struct zram *zram);
+static void zram_async_stop(struct zram *zram);
+#endif
+
 static void zram_reset_device(struct zram *zram, bool reset_capacity)
 {
 	size_t index;
 	struct zram_meta *meta;
 
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+	/* workers do not take init_lock, drain them before tearing down */
+	zram_async_stop(zram);
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	cancel_delayed_work_sync(&zram->wb_work);
+#endif
 	down_write(&zram->init_lock);
 
 	zram->limit_pages = 0;
@@ -1138,8 +1769,13 @@ static void zram_reset_device(struct zram *zram, bool reset_capacity)
 	for (index = 0; index < zram->disksize >> PAGE_SHIFT; index++) {
 		unsigned long handle = meta->table[index].handle;
 
-		if (!handle)
+		if (!handle || zram_test_flag(meta, index, ZRAM_SAME))
+			continue;
+#ifdef CONFIG_ZRAM_WRITEBACK
+		/* a block of the backing device, released below */
+		if (zram_test_flag(meta, index, ZRAM_WB))
 			continue;
+#endif
 
 		zs_free(meta->mem_pool, handle);
 	}
@@ -1155,6 +1791,9 @@ static void zram_reset_device(struct zram *zram, bool reset_capacity)
 	zram->disksize = 0;
 	if (reset_capacity)
 		set_capacity(zram->disk, 0);
+#ifdef CONFIG_ZRAM_WRITEBACK
+	zram_reset_bdev(zram);
+#endif
 
 	up_write(&zram->init_lock);
 
@@ -1211,6 +1850,16 @@ static ssize_t disksize_store(struct device *dev,
 	set_capacity(zram->disk, zram->disksize >> SECTOR_SHIFT);
 	up_write(&zram->init_lock);
 
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+	if (zram->async_comp)
+		zram_async_start(zram);
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	if (zram->wb_idle_secs)
+		queue_delayed_work(system_long_wq, &zram->wb_work,
+				   zram->wb_idle_secs * HZ);
+#endif
+
 	/*
 	 * Revalidate disk out of the init_lock to avoid lockdep splat.
 	 * It's okay because disk's capacity is protected by init_lock
@@ -1322,6 +1971,149 @@ out:
 	bio_io_error(bio);
 }
 
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+/*
+ * Asynchronous compression: writes issued by kswapd are queued and
+ * compressed by one worker per cpu of the little cluster, so that reclaim
+ * does not burn big core time on compression. A page stays in the swap
+ * cache under writeback until its bio completes, so reads never race
+ * with a queued write.
+ */
+static bool zram_async_queue(struct zram *zram, struct bio *bio)
+{
+	bool queued = false;
+
+	if (bio_data_dir(bio) != WRITE || (bio->bi_rw & REQ_DISCARD) ||
+	    !current_is_kswapd())
+		return false;
+
+	spin_lock(&zram->async_lock);
+	if (zram->async_active &&
+	    zram->async_pending < ZRAM_ASYNC_MAX_PENDING) {
+		bio_list_add(&zram->async_bios, bio);
+		zram->async_pending++;
+		queued = true;
+	}
+	spin_unlock(&zram->async_lock);
+
+	if (queued)
+		wake_up(&zram->async_wait);
+	return queued;
+}
+
+static int zram_async_fetch(struct zram *zram, struct bio_list *batch)
+{
+	struct bio *bio;
+	int nr = 0;
+
+	bio_list_init(batch);
+	spin_lock(&zram->async_lock);
+	while (nr < ZRAM_ASYNC_BATCH &&
+	       (bio = bio_list_pop(&zram->async_bios))) {
+		bio_list_add(batch, bio);
+		nr++;
+	}
+	zram->async_pending -= nr;
+	spin_unlock(&zram->async_lock);
+
+	return nr;
+}
+
+static int zram_async_thread(void *data)
+{
+	struct zram *zram = data;
+	struct bio_list batch;
+	struct bio *bio;
+
+	while (!kthread_should_stop()) {
+		wait_event_interruptible(zram->async_wait,
+					 !bio_list_empty(&zram->async_bios) ||
+					 kthread_should_stop());
+
+		while (zram_async_fetch(zram, &batch))
+			while ((bio = bio_list_pop(&batch)))
+				__zram_make_request(zram, bio);
+	}
+
+	return 0;
+}
+
+/* cluster 0 is the slowest one on MTK big.LITTLE parts */
+static void zram_async_cpus(struct cpumask *cpus)
+{
+	arch_get_cluster_cpus(cpus, 0);
+	cpumask_and(cpus, cpus, cpu_possible_mask);
+	if (cpumask_empty(cpus))
+		cpumask_copy(cpus, cpu_possible_mask);
+}
+
+static void zram_async_start(struct zram *zram)
+{
+	struct task_struct *tsk;
+	cpumask_var_t cpus;
+	int i, nr;
+
+	if (!alloc_cpumask_var(&cpus, GFP_KERNEL))
+		return;
+
+	zram_async_cpus(cpus);
+	nr = cpumask_weight(cpus);
+	zram->async_workers = kcalloc(nr, sizeof(*zram->async_workers),
+				      GFP_KERNEL);
+	if (!zram->async_workers)
+		goto out;
+
+	for (i = 0; i < nr; i++) {
+		tsk = kthread_create(zram_async_thread, zram, "%s_comp/%d",
+				     zram->disk->disk_name, i);
+		if (IS_ERR(tsk))
+			break;
+		set_cpus_allowed_ptr(tsk, cpus);
+		zram->async_workers[i] = tsk;
+		wake_up_process(tsk);
+	}
+	zram->nr_async_workers = i;
+
+	if (!zram->nr_async_workers) {
+		pr_info("Cannot start compression workers, compressing synchronously\n");
+		kfree(zram->async_workers);
+		zram->async_workers = NULL;
+		goto out;
+	}
+
+	spin_lock(&zram->async_lock);
+	zram->async_active = true;
+	spin_unlock(&zram->async_lock);
+out:
+	free_cpumask_var(cpus);
+}
+
+static void zram_async_stop(struct zram *zram)
+{
+	struct bio_list batch;
+	struct bio *bio;
+	int i;
+
+	if (!zram->async_workers)
+		return;
+
+	spin_lock(&zram->async_lock);
+	zram->async_active = false;
+	spin_unlock(&zram->async_lock);
+
+	/* workers flush what is still queued before they exit */
+	for (i = 0; i < zram->nr_async_workers; i++)
+		kthread_stop(zram->async_workers[i]);
+	while (zram_async_fetch(zram, &batch))
+		while ((bio = bio_list_pop(&batch)))
+			__zram_make_request(zram, bio);
+
+	kfree(zram->async_workers);
+	zram->async_workers = NULL;
+	zram->nr_async_workers = 0;
+}
+#endif
+
 /*
  * Handler function for all zram I/O requests.
  */
@@ -1338,6 +2130,13 @@ static void zram_make_request(struct request_queue *queue, struct bio *bio)
 		goto error;
 	}
 
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+	if (zram_async_queue(zram, bio)) {
+		up_read(&zram->init_lock);
+		return;
+	}
+#endif
+
 	__zram_make_request(zram, bio);
 	up_read(&zram->init_lock);
 
@@ -1382,6 +2181,18 @@ static DEVICE_ATTR(max_comp_streams, S_IRUGO | S_IWUSR,
 		max_comp_streams_show, max_comp_streams_store);
 static DEVICE_ATTR(comp_algorithm, S_IRUGO | S_IWUSR,
 		comp_algorithm_show, comp_algorithm_store);
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+static DEVICE_ATTR(async_compress, S_IRUGO | S_IWUSR,
+		async_compress_show, async_compress_store);
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+static DEVICE_ATTR(backing_dev, S_IRUGO | S_IWUSR,
+		backing_dev_show, backing_dev_store);
+static DEVICE_ATTR(idle, S_IWUSR, NULL, idle_store);
+static DEVICE_ATTR(writeback, S_IWUSR, NULL, writeback_store);
+static DEVICE_ATTR(writeback_idle_secs, S_IRUGO | S_IWUSR,
+		writeback_idle_secs_show, writeback_idle_secs_store);
+#endif
 
 ZRAM_ATTR_RO(num_reads);
 ZRAM_ATTR_RO(num_writes);
@@ -1390,7 +2201,13 @@ ZRAM_ATTR_RO(failed_writes);
 ZRAM_ATTR_RO(invalid_io);
 ZRAM_ATTR_RO(notify_free);
 ZRAM_ATTR_RO(zero_pages);
+ZRAM_ATTR_RO(same_pages);
 ZRAM_ATTR_RO(compr_data_size);
+#ifdef CONFIG_ZRAM_WRITEBACK
+ZRAM_ATTR_RO(bd_count);
+ZRAM_ATTR_RO(bd_reads);
+ZRAM_ATTR_RO(bd_writes);
+#endif
 
 static struct attribute *zram_disk_attrs[] = {
 	&dev_attr_disksize.attr,
@@ -1403,6 +2220,7 @@ static struct attribute *zram_disk_attrs[] = {
 	&dev_attr_invalid_io.attr,
 	&dev_attr_notify_free.attr,
 	&dev_attr_zero_pages.attr,
+	&dev_attr_same_pages.attr,
 	&dev_attr_orig_data_size.attr,
 	&dev_attr_compr_data_size.attr,
 	&dev_attr_mem_used_total.attr,
@@ -1410,6 +2228,18 @@ static struct attribute *zram_disk_attrs[] = {
 	&dev_attr_mem_used_max.attr,
 	&dev_attr_max_comp_streams.attr,
 	&dev_attr_comp_algorithm.attr,
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+	&dev_attr_async_compress.attr,
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	&dev_attr_backing_dev.attr,
+	&dev_attr_idle.attr,
+	&dev_attr_writeback.attr,
+	&dev_attr_writeback_idle_secs.attr,
+	&dev_attr_bd_count.attr,
+	&dev_attr_bd_reads.attr,
+	&dev_attr_bd_writes.attr,
+#endif
 	NULL,
 };
 
@@ -1422,9 +2252,16 @@ static int create_device(struct zram *zram, int device_id)
 	int ret = -ENOMEM;
 
 	init_rwsem(&zram->init_lock);
-#ifdef CONFIG_ZSM
-	spin_lock_init(&zram_node_mutex);
-	spin_lock_init(&zram_node4k_mutex);
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+	spin_lock_init(&zram->async_lock);
+	bio_list_init(&zram->async_bios);
+	init_waitqueue_head(&zram->async_wait);
+	zram->async_comp = true;
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	spin_lock_init(&zram->bd_lock);
+	mutex_init(&zram->wb_lock);
+	INIT_DELAYED_WORK(&zram->wb_work, zram_wb_work);
 #endif
 	zram->queue = blk_alloc_queue(GFP_KERNEL);
 	if (!zram->queue) {
@@ -1599,6 +2436,10 @@ static int __init zram_init(void)
 		goto out;
 	}
 
+#ifdef CONFIG_ZSM
+	zsm_hash_init();
+#endif
+
 	zram_major = register_blkdev(0, "zram");
 	if (zram_major <= 0) {
 		pr_warn("Unable to get major number\n");
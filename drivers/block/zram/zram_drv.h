@@ -17,6 +17,13 @@
 
 #include <linux/spinlock.h>
 #include <linux/zsmalloc.h>
+#if defined(CONFIG_ZRAM_ASYNC_COMP) || defined(CONFIG_ZRAM_WRITEBACK)
+#include <linux/bio.h>
+#include <linux/wait.h>
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+#include <linux/workqueue.h>
+#endif
 
 #include "zcomp.h"
 
@@ -45,6 +52,18 @@ static const size_t max_zpage_size = PAGE_SIZE / 4 * 3;
  * always return failure.
  */
 
+#ifdef CONFIG_ZRAM_WRITEBACK
+/* pages per backing device write */
+#define ZRAM_WB_BATCH		32
+#endif
+
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+/* bios one compression worker takes from the queue at a time */
+#define ZRAM_ASYNC_BATCH	16
+/* queued bios beyond which kswapd compresses synchronously again */
+#define ZRAM_ASYNC_MAX_PENDING	256
+#endif
+
 /*-- End of configurable params */
 
 #define SECTOR_SHIFT		9
@@ -73,11 +92,12 @@ static const size_t max_zpage_size = PAGE_SIZE / 4 * 3;
 enum zram_pageflags {
 	/* Page consists entirely of zeros */
 	ZRAM_FIRST_NODE ,
-	ZRAM_RB_NODE,
+	ZRAM_HASH_NODE,
 	ZRAM_ZSM_NODE,
 	ZRAM_ZSM_DONE_NODE,
 	ZRAM_ZERO = ZRAM_FLAG_SHIFT + 1,
 	ZRAM_ACCESS,	/* page in now accessed */
+	ZRAM_SAME,	/* one repeated word, kept in handle */
 	__NR_ZRAM_PAGEFLAGS,
 };
 #else
@@ -85,6 +105,13 @@ enum zram_pageflags {
 	/* Page consists entirely of zeros */
 	ZRAM_ZERO = ZRAM_FLAG_SHIFT + 1,
 	ZRAM_ACCESS,	/* page in now accessed */
+	ZRAM_SAME,	/* one repeated word, kept in handle */
+#ifdef CONFIG_ZRAM_WRITEBACK
+	ZRAM_WB,	/* page is on the backing device, handle is its block */
+	ZRAM_HUGE,	/* incompressible page, stored as is */
+	ZRAM_IDLE,	/* not accessed since it was last marked idle */
+	ZRAM_UNDER_WB,	/* being written back, cleared if the page changes */
+#endif
 	__NR_ZRAM_PAGEFLAGS,
 };
 #endif
@@ -96,7 +123,7 @@ enum zram_pageflags {
 struct zram_table_entry {
 	unsigned long handle;
 	unsigned long value;
-	struct rb_node node;
+	struct hlist_node hnode;	/* zsm_hash bucket, ZRAM_HASH_NODE only */
 	struct list_head head;
 	u32 copy_count;
 	u32 next_index;
@@ -119,12 +146,18 @@ struct zram_stats {
 	atomic64_t invalid_io;	/* non-page-aligned I/O requests */
 	atomic64_t notify_free;	/* no. of swap slot free notifications */
 	atomic64_t zero_pages;		/* no. of zero filled pages */
+	atomic64_t same_pages;		/* no. of pages of one repeated word */
 	atomic64_t pages_stored;	/* no. of pages currently stored */
 	atomic_long_t max_used_pages;	/* no. of maximum pages stored */
 #ifdef CONFIG_ZSM
 	atomic64_t zsm_saved;          /* saved physical size*/
 	atomic64_t zsm_saved4k;
 #endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	atomic64_t bd_count;		/* no. of pages on the backing device */
+	atomic64_t bd_reads;		/* no. of pages read from it */
+	atomic64_t bd_writes;		/* no. of pages written to it */
+#endif
 };
 
 struct zram_meta {
@@ -153,6 +186,30 @@ struct zram {
 	unsigned long limit_pages;
 
 	char compressor[10];
+#ifdef CONFIG_ZRAM_ASYNC_COMP
+	/* kswapd writes compressed by workers on the little cluster */
+	bool async_comp;	/* async_compress attribute */
+	bool async_active;	/* workers accept bios, async_lock */
+	spinlock_t async_lock;
+	struct bio_list async_bios;	/* async_lock */
+	int async_pending;	/* bios in async_bios, async_lock */
+	wait_queue_head_t async_wait;
+	int nr_async_workers;
+	struct task_struct **async_workers;
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	/* backing device idle and incompressible pages are written to */
+	struct block_device *bdev;
+	char backing_dev[64];
+	unsigned long bd_nr_pages;
+	unsigned long *bd_bitmap;	/* used blocks, block 0 is reserved */
+	unsigned long bd_next;		/* allocation cursor, keeps I/O sequential */
+	spinlock_t bd_lock;		/* protects bd_bitmap and bd_next */
+	struct mutex wb_lock;		/* serializes writeback passes */
+	/* write back pages idle for this long, 0 leaves it to userspace */
+	unsigned int wb_idle_secs;
+	struct delayed_work wb_work;
+#endif
 };
 
 /* mlog */
@@ -1941,6 +1941,30 @@ static int __target_index(struct cpufreq_policy *policy,
 	return retval;
 }
 
+/**
+ * cpufreq_driver_fast_switch - post a frequency change without sleeping
+ * @policy: cpufreq policy to switch the frequency for
+ * @target_freq: new frequency to set (may be approximate)
+ *
+ * Only valid if policy->fast_switch_possible is set; callable from scheduler
+ * context. Returns the frequency that will be set, or 0 if the driver could
+ * not take the request and the caller has to use __cpufreq_driver_target().
+ */
+unsigned int cpufreq_driver_fast_switch(struct cpufreq_policy *policy,
+					unsigned int target_freq)
+{
+	if (!cpufreq_driver->fast_switch || !policy->fast_switch_possible)
+		return 0;
+
+	if (target_freq > policy->max)
+		target_freq = policy->max;
+	if (target_freq < policy->min)
+		target_freq = policy->min;
+
+	return cpufreq_driver->fast_switch(policy, target_freq);
+}
+EXPORT_SYMBOL_GPL(cpufreq_driver_fast_switch);
+
 int __cpufreq_driver_target(struct cpufreq_policy *policy,
 			    unsigned int target_freq,
 			    unsigned int relation)
@@ -33,6 +33,11 @@ int __attribute__((weak)) mt_idle_select(int cpu)
 	return -1;
 }
 
+void __attribute__((weak)) mt_idle_reflect(int cpu, int index, int residency_us)
+{
+
+}
+
 void __attribute__((weak)) mt_cpuidle_framework_init(void)
 {
 
@@ -63,7 +68,7 @@ static int mtk_governor_select(struct cpuidle_driver *drv, struct cpuidle_device
  */
 static void mtk_governor_reflect(struct cpuidle_device *dev, int index)
 {
-	/* TODO: implement actions for MTK governor & replace it */
+	mt_idle_reflect(dev->cpu, index, cpuidle_get_last_residency(dev));
 }
 
 /*
@@ -20,6 +20,7 @@
 
 #include <linux/device.h>
 #include <linux/proc_fs.h>  /*proc*/
+#include <mt-plat/mtk_input_boost.h>
 static int tpd_flag;
 static int tpd_halt;
 static int tpd_eint_mode = 1;
@@ -1135,6 +1136,9 @@ out:
 static irqreturn_t tpd_interrupt_handler(int irq, void *dev_id)
 {
 	TPD_DEBUG_PRINT_INT;
+	/* start the touch boost now rather than after the coordinate read */
+	if (!tpd_halt)
+		input_boost_kick();
 	tpd_flag = 1;
 	wake_up_interruptible(&waiter);
 	return IRQ_HANDLED;
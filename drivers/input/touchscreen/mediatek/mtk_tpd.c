@@ -26,6 +26,7 @@
 #include <linux/slab.h>
 #include <linux/uaccess.h>
 #include <linux/fb.h>
+#include <mt-plat/mt_wq.h>
 
 #ifdef CONFIG_COMPAT
 #include <linux/compat.h>
@@ -314,7 +315,6 @@ static long tpd_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned lon
 	return err;
 }
 static struct work_struct touch_resume_work;
-static struct workqueue_struct *touch_resume_workqueue;
 static const struct file_operations tpd_fops = {
 /* .owner = THIS_MODULE, */
 	.open = tpd_misc_open,
@@ -396,7 +396,7 @@ static int tpd_fb_notifier_callback(struct notifier_block *self, unsigned long e
 	case FB_BLANK_UNBLANK:
 		TPD_DMESG("LCD ON Notify\n");
 		if (g_tpd_drv && tpd_suspend_flag) {
-			err = queue_work(touch_resume_workqueue, &touch_resume_work);
+			err = mt_queue_work(MT_WQ_CLUSTER, &touch_resume_work);
 			if (!err) {
 				TPD_DMESG("start touch_resume_workqueue failed\n");
 				return err;
@@ -607,7 +607,10 @@ static int tpd_probe(struct platform_device *pdev)
 			return 0;
 		}
 	}
-	touch_resume_workqueue = create_singlethread_workqueue("touch_resume");
+	/*
+	 * on the screen-on path: high priority, on the cluster of the fb
+	 * notifier, which the screen-on boost has woken up already
+	 */
 	INIT_WORK(&touch_resume_work, touch_resume_workqueue_callback);
 	/* use fb_notifier */
 	tpd_fb_notifier.notifier_call = tpd_fb_notifier_callback;
@@ -81,6 +81,7 @@
 #include <linux/regulator/consumer.h>
 #include <linux/of.h>
 #include <linux/of_irq.h>
+#include <mt-plat/mtk_input_boost.h>
 
 
 /****************************************************************************
@@ -493,7 +494,6 @@ static char I2CDMABuf[4096];
 
 
 struct i2c_client *tpd_i2c_client = NULL;
-static int tpd_flag;
 
 struct class *touch_class;
 struct workqueue_struct *touch_wq;
@@ -507,12 +507,12 @@ static DEFINE_MUTEX(notify_access);
 static DEFINE_MUTEX(knock_access);
 static DEFINE_MUTEX(s3320_i2c_access);
 
-static DECLARE_WAIT_QUEUE_HEAD(tpd_waiter);
 
 /****************************************************************************
 * Local Function Prototypes
 ****************************************************************************/
-static irqreturn_t touch_eint_interrupt_handler(unsigned irq, struct irq_desc *desc);
+static irqreturn_t touch_eint_interrupt_handler(int irq, void *dev_id);
+static irqreturn_t synaptics_touch_event_handler(int irq, void *dev_id);
 
 #ifdef LGE_USE_SYNAPTICS_FW_UPGRADE
 static void synaptics_firmware_update(struct work_struct *work_fw_upgrade);
@@ -561,8 +561,9 @@ static int touch_irq_registration(void)
 
 		TPD_LOG("tpd_intr_type = %d!IRQF_TRIGGER_LOW\n", tpd_intr_type);
 		ret =
-		    request_irq(touch_irq, (irq_handler_t) touch_eint_interrupt_handler,
-				IRQF_TRIGGER_FALLING, "TOUCH_PANEL-eint", NULL);
+		    request_threaded_irq(touch_irq, touch_eint_interrupt_handler,
+					 synaptics_touch_event_handler,
+					 IRQF_TRIGGER_FALLING | IRQF_ONESHOT, "TOUCH_PANEL-eint", NULL);
 
 		if (ret > 0) {
 			ret = -1;
@@ -1063,7 +1064,8 @@ static void synaptics_ic_reset(void)
 #else
 	TPD_FUN();
 
-	disable_irq(touch_irq);
+	/* may run from the irq thread itself (ESD recovery), so don't sync */
+	disable_irq_nosync(touch_irq);
 
 	msleep(20);
 	gpio_set_value(P_GPIO_CTP_RST_PIN, 0);
@@ -1946,23 +1948,20 @@ error:
 /****************************************************************************
 * Touch Interrupt Service Routines
 ****************************************************************************/
-static irqreturn_t touch_eint_interrupt_handler(unsigned irq, struct irq_desc *desc)
+/*
+ * Hard irq: the line stays masked (IRQF_ONESHOT) until the irq thread below
+ * has read and reported the frame. A touch-down boost is kicked here so the
+ * CPU/GPU ramp starts in parallel with the I2C read instead of after it.
+ */
+static irqreturn_t touch_eint_interrupt_handler(int irq, void *dev_id)
 {
-	/* TPD_FUN(); */
-	/* printk("[S3320] %s\n", __func__); */
-	disable_irq_nosync(touch_irq);
-
-	tpd_flag = 1;
-	wake_up_interruptible(&tpd_waiter);
-
-	return IRQ_HANDLED;
+	if (!suspend_status)
+		input_boost_kick();
 
+	return IRQ_WAKE_THREAD;
 }
 
-static int tpd_eint_mode = 1;
-static int tpd_polling_time = 50;
-
-static int synaptics_touch_event_handler(void *unused)
+static irqreturn_t synaptics_touch_event_handler(int irq, void *dev_id)
 {
 	int ret = 0;
 	u8 int_status;
@@ -1974,238 +1973,221 @@ static int synaptics_touch_event_handler(void *unused)
 	touch_sensor_data sensor_data;
 	touch_finger_info finger_info;
 	char report_enable = 0;
+	static bool prio_set;
 
-	struct sched_param param = {.sched_priority = RTPM_PRIO_TPD };
-
-	sched_setscheduler(current, SCHED_RR, &param);
-
-	do {
-
-		/* TPD_FUN(); */
-		set_current_state(TASK_INTERRUPTIBLE);
-
-		if (tpd_eint_mode == 1) {
-			/* TPD_ERR("interrupt mode\n"); */
-			wait_event_interruptible(tpd_waiter, tpd_flag != 0);
-		} else {
-			TPD_ERR("polling mode\n");
-			msleep(tpd_polling_time);
-		}
-
-
-		tpd_flag = 0;
-		set_current_state(TASK_RUNNING);
-
-		mutex_lock(&i2c_access);
-
-
+	/* keep the priority the old event kthread ran at */
+	if (unlikely(!prio_set)) {
+		struct sched_param param = {.sched_priority = RTPM_PRIO_TPD };
 
+		sched_setscheduler(current, SCHED_RR, &param);
+		prio_set = true;
+	}
 
-		index = 0;
-		memset(&sensor_data, 0x0, sizeof(touch_sensor_data));
-		memset(&finger_info, 0x0, sizeof(touch_finger_info));
-		pressure_zero = 0;
+	mutex_lock(&i2c_access);
 
-		/* TPD_ERR("synaptics_ic_status_check\n"); */
-		ret = synaptics_ic_status_check();
-		if (ret != 0) {
-			TPD_LOG("ignore ic status ");
-			goto exit_work;
-		}
-		/* read interrupt information */
-		/* TPD_ERR("read interrupt information\n"); */
-		ret =
-		    synaptics_ts_read(tpd_i2c_client, INTERRUPT_STATUS_REG, 1, (u8 *) &int_status);
-		if (ret < 0) {
-			TPD_ERR("INTERRUPT_STATUS_REG read fail\n");
-			goto exit_work;
-		}
+	index = 0;
+	memset(&sensor_data, 0x0, sizeof(touch_sensor_data));
+	memset(&finger_info, 0x0, sizeof(touch_finger_info));
+	pressure_zero = 0;
 
-		if (int_status == 0) {
-			TPD_LOG("KNOCK ISSUE ");
-			/* goto exit_work; */
-		}
+	/* TPD_ERR("synaptics_ic_status_check\n"); */
+	ret = synaptics_ic_status_check();
+	if (ret != 0) {
+		TPD_LOG("ignore ic status ");
+		goto exit_work;
+	}
+	/* read interrupt information */
+	/* TPD_ERR("read interrupt information\n"); */
+	ret =
+	    synaptics_ts_read(tpd_i2c_client, INTERRUPT_STATUS_REG, 1, (u8 *) &int_status);
+	if (ret < 0) {
+		TPD_ERR("INTERRUPT_STATUS_REG read fail\n");
+		goto exit_work;
+	}
 
-		/* Knock On or Knock Code Check */
+	if (int_status == 0) {
+		TPD_LOG("KNOCK ISSUE ");
+		/* goto exit_work; */
+	}
 
-		if (suspend_status && knock_on_enable) {
-			if (download_status == 1) {
-				TPD_LOG("knock_on is not checked (F/W downloading...)\n");
-			} else {
-				ret = synaptics_ts_get_data(tpd_i2c_client);
-				if (ret != 0)
-					TPD_LOG("Touch Knock_On fail\n");
+	/* Knock On or Knock Code Check */
 
-			}
+	if (suspend_status && knock_on_enable) {
+		if (download_status == 1) {
+			TPD_LOG("knock_on is not checked (F/W downloading...)\n");
+		} else {
+			ret = synaptics_ts_get_data(tpd_i2c_client);
+			if (ret != 0)
+				TPD_LOG("Touch Knock_On fail\n");
 
-			goto exit_work;
 		}
 
-		ret =
-		    synaptics_ts_read(tpd_i2c_client, INTERRUPT_ENABLE_REG, 1, (u8 *) &int_enable);
-		if (ret < 0) {
-			TPD_ERR("INTERRUPT_ENABLE_REG read fail\n");
-			goto exit_work;
-		}
-		/* TPD_ERR("set INTERRUPT_ENABLE_REG : %d\n",int_enable); */
+		goto exit_work;
+	}
 
-		/* read finger state & finger data */
-		ret =
-		    synaptics_ts_read(tpd_i2c_client, TWO_D_FINGER_STATE_REG, sizeof(sensor_data),
-				      (u8 *) &sensor_data.finger_data[0]);
-		if (ret < 0) {
-			TPD_ERR("TWO_D_FINGER_STATE_REG read fail\n");
-			goto exit_work;
-		}
+	ret =
+	    synaptics_ts_read(tpd_i2c_client, INTERRUPT_ENABLE_REG, 1, (u8 *) &int_enable);
+	if (ret < 0) {
+		TPD_ERR("INTERRUPT_ENABLE_REG read fail\n");
+		goto exit_work;
+	}
+	/* TPD_ERR("set INTERRUPT_ENABLE_REG : %d\n",int_enable); */
 
-		/* Finger Event Processing */
-		if ((int_status & ABS0_MASK) && (int_enable & ABS0_MASK)) {
-			for (finger_count = 0; finger_count < MAX_NUM_OF_FINGER; finger_count++) {
-				if (sensor_data.finger_data[finger_count][0] == F12_FINGER_STATUS
-				    || sensor_data.finger_data[finger_count][0] == F12_STYLUS_STATUS
-				    /*
-				       || sensor_data.finger_data[finger_count][0] == F12_PALM_STATUS
-				       || sensor_data.finger_data[finger_count][0] == F12_GLOVED_FINGER_STATUS */
-				    ) {
-					finger_info.pos_x[finger_count] =
-					    TS_SNTS_GET_X_POSITION(sensor_data.finger_data
-								   [finger_count]
-								   [X_POSITION_MSB],
-								   sensor_data.finger_data
-								   [finger_count]
-								   [X_POSITION_LSB]);
-					finger_info.pos_y[finger_count] =
-					    TS_SNTS_GET_Y_POSITION(sensor_data.finger_data
-								   [finger_count]
-								   [Y_POSITION_MSB],
-								   sensor_data.finger_data
-								   [finger_count]
-								   [Y_POSITION_LSB]);
-
-					width_max =
-					    TS_SNTS_GET_WIDTH_MAJOR(sensor_data.finger_data
-								    [finger_count]
-								    [WX_VALUE],
-								    sensor_data.finger_data
-								    [finger_count]
-								    [WY_VALUE]);
-					width_min =
-					    TS_SNTS_GET_WIDTH_MINOR(sensor_data.finger_data
-								    [finger_count]
-								    [WX_VALUE],
-								    sensor_data.finger_data
-								    [finger_count]
-								    [WY_VALUE]);
-					width_orientation =
-					    TS_SNTS_GET_ORIENTATION(sensor_data.finger_data
-								    [finger_count]
-								    [WX_VALUE],
-								    sensor_data.finger_data
-								    [finger_count]
-								    [WY_VALUE]);
-
-					finger_info.pressure[finger_count] =
-					    TS_SNTS_GET_PRESSURE(sensor_data.finger_data
-								 [finger_count]
-								 [PRESSURE]);
-					if (qcover == 1) {	/* 726 1606 */
-					if ((finger_info.pos_x[finger_count] <
-						     Double_Tap_Area_X1)
-						    || (finger_info.pos_x[finger_count] >
-							Double_Tap_Area_X2)
-						    || (finger_info.pos_y[finger_count] <
-							Double_Tap_Area_Y1)
-						    || (finger_info.pos_y[finger_count] >
-							Double_Tap_Area_Y2))
-							continue;
-					}
-#if !defined(MT_PROTOCOL_A)
-					input_mt_slot(tpd->dev, finger_count);
-					input_mt_report_slot_state(tpd->dev, MT_TOOL_FINGER, true);
-#endif
-					input_report_abs(tpd->dev, ABS_MT_POSITION_X,
-							 finger_info.pos_x[finger_count]);
-					input_report_abs(tpd->dev, ABS_MT_POSITION_Y,
-							 finger_info.pos_y[finger_count]);
-					input_report_abs(tpd->dev, ABS_MT_PRESSURE,
-							 finger_info.pressure[finger_count]);
-					input_report_abs(tpd->dev, ABS_MT_WIDTH_MAJOR, width_max);
-					input_report_abs(tpd->dev, ABS_MT_WIDTH_MINOR, width_min);
-					input_report_abs(tpd->dev, ABS_MT_ORIENTATION,
-							 width_orientation);
-
-					input_report_abs(tpd->dev, ABS_MT_TRACKING_ID,
-							 finger_count);
-
-					report_enable = 1;
-
-					old_touch_info.pos_x[finger_count] =
-					    pre_touch_info.pos_x[finger_count];
-					old_touch_info.pos_y[finger_count] =
-					    pre_touch_info.pos_y[finger_count];
-					old_touch_info.pressure[finger_count] =
-					    pre_touch_info.pressure[finger_count];
-					pre_touch_info.pos_x[finger_count] =
-					    finger_info.pos_x[finger_count];
-					pre_touch_info.pos_y[finger_count] =
-					    finger_info.pos_y[finger_count];
-					pre_touch_info.pressure[finger_count] =
-					    finger_info.pressure[finger_count];
-					index++;
-
-					/* ignore Key event during Finger event processing */
-					if (finger_prestate[finger_count] == TOUCH_RELEASED) {
-						finger_oldstate[finger_count] =
-						    finger_prestate[finger_count];
-						finger_prestate[finger_count] = TOUCH_PRESSED;
-						TPD_LOG("%d key is %s ( x/y = %d, %d)\n",
-							finger_count,
-							finger_prestate[finger_count] ? "pressed" :
-							"released",
-							pre_touch_info.pos_x[finger_count],
-							pre_touch_info.pos_y[finger_count]);
-					}
-				} else if (finger_prestate[finger_count] == TOUCH_PRESSED) {
+	/* read finger state & finger data */
+	ret =
+	    synaptics_ts_read(tpd_i2c_client, TWO_D_FINGER_STATE_REG, sizeof(sensor_data),
+			      (u8 *) &sensor_data.finger_data[0]);
+	if (ret < 0) {
+		TPD_ERR("TWO_D_FINGER_STATE_REG read fail\n");
+		goto exit_work;
+	}
+
+	/* Finger Event Processing */
+	if ((int_status & ABS0_MASK) && (int_enable & ABS0_MASK)) {
+		for (finger_count = 0; finger_count < MAX_NUM_OF_FINGER; finger_count++) {
+			if (sensor_data.finger_data[finger_count][0] == F12_FINGER_STATUS
+			    || sensor_data.finger_data[finger_count][0] == F12_STYLUS_STATUS
+			    /*
+			       || sensor_data.finger_data[finger_count][0] == F12_PALM_STATUS
+			       || sensor_data.finger_data[finger_count][0] == F12_GLOVED_FINGER_STATUS */
+			    ) {
+				finger_info.pos_x[finger_count] =
+				    TS_SNTS_GET_X_POSITION(sensor_data.finger_data
+							   [finger_count]
+							   [X_POSITION_MSB],
+							   sensor_data.finger_data
+							   [finger_count]
+							   [X_POSITION_LSB]);
+				finger_info.pos_y[finger_count] =
+				    TS_SNTS_GET_Y_POSITION(sensor_data.finger_data
+							   [finger_count]
+							   [Y_POSITION_MSB],
+							   sensor_data.finger_data
+							   [finger_count]
+							   [Y_POSITION_LSB]);
+
+				width_max =
+				    TS_SNTS_GET_WIDTH_MAJOR(sensor_data.finger_data
+							    [finger_count]
+							    [WX_VALUE],
+							    sensor_data.finger_data
+							    [finger_count]
+							    [WY_VALUE]);
+				width_min =
+				    TS_SNTS_GET_WIDTH_MINOR(sensor_data.finger_data
+							    [finger_count]
+							    [WX_VALUE],
+							    sensor_data.finger_data
+							    [finger_count]
+							    [WY_VALUE]);
+				width_orientation =
+				    TS_SNTS_GET_ORIENTATION(sensor_data.finger_data
+							    [finger_count]
+							    [WX_VALUE],
+							    sensor_data.finger_data
+							    [finger_count]
+							    [WY_VALUE]);
+
+				finger_info.pressure[finger_count] =
+				    TS_SNTS_GET_PRESSURE(sensor_data.finger_data
+							 [finger_count]
+							 [PRESSURE]);
+				if (qcover == 1) {	/* 726 1606 */
+				if ((finger_info.pos_x[finger_count] <
+					     Double_Tap_Area_X1)
+					    || (finger_info.pos_x[finger_count] >
+						Double_Tap_Area_X2)
+					    || (finger_info.pos_y[finger_count] <
+						Double_Tap_Area_Y1)
+					    || (finger_info.pos_y[finger_count] >
+						Double_Tap_Area_Y2))
+						continue;
+				}
 #if !defined(MT_PROTOCOL_A)
-					input_mt_slot(tpd->dev, finger_count);
-					input_mt_report_slot_state(tpd->dev, MT_TOOL_FINGER, false);
+				input_mt_slot(tpd->dev, finger_count);
+				input_mt_report_slot_state(tpd->dev, MT_TOOL_FINGER, true);
 #endif
+				input_report_abs(tpd->dev, ABS_MT_POSITION_X,
+						 finger_info.pos_x[finger_count]);
+				input_report_abs(tpd->dev, ABS_MT_POSITION_Y,
+						 finger_info.pos_y[finger_count]);
+				input_report_abs(tpd->dev, ABS_MT_PRESSURE,
+						 finger_info.pressure[finger_count]);
+				input_report_abs(tpd->dev, ABS_MT_WIDTH_MAJOR, width_max);
+				input_report_abs(tpd->dev, ABS_MT_WIDTH_MINOR, width_min);
+				input_report_abs(tpd->dev, ABS_MT_ORIENTATION,
+						 width_orientation);
+
+				input_report_abs(tpd->dev, ABS_MT_TRACKING_ID,
+						 finger_count);
+
+				report_enable = 1;
+
+				old_touch_info.pos_x[finger_count] =
+				    pre_touch_info.pos_x[finger_count];
+				old_touch_info.pos_y[finger_count] =
+				    pre_touch_info.pos_y[finger_count];
+				old_touch_info.pressure[finger_count] =
+				    pre_touch_info.pressure[finger_count];
+				pre_touch_info.pos_x[finger_count] =
+				    finger_info.pos_x[finger_count];
+				pre_touch_info.pos_y[finger_count] =
+				    finger_info.pos_y[finger_count];
+				pre_touch_info.pressure[finger_count] =
+				    finger_info.pressure[finger_count];
+				index++;
+
+				/* ignore Key event during Finger event processing */
+				if (finger_prestate[finger_count] == TOUCH_RELEASED) {
 					finger_oldstate[finger_count] =
 					    finger_prestate[finger_count];
-					finger_prestate[finger_count] = TOUCH_RELEASED;
-					TPD_LOG("%d key is %s ( x/y =                    %d, %d)\n",
+					finger_prestate[finger_count] = TOUCH_PRESSED;
+					TPD_LOG("%d key is %s ( x/y = %d, %d)\n",
 						finger_count,
 						finger_prestate[finger_count] ? "pressed" :
-						"released", pre_touch_info.pos_x[finger_count],
+						"released",
+						pre_touch_info.pos_x[finger_count],
 						pre_touch_info.pos_y[finger_count]);
-					report_enable = 1;
-
-					pre_touch_info.pos_x[finger_count] = 0;
-					pre_touch_info.pos_y[finger_count] = 0;
 				}
+			} else if (finger_prestate[finger_count] == TOUCH_PRESSED) {
+#if !defined(MT_PROTOCOL_A)
+				input_mt_slot(tpd->dev, finger_count);
+				input_mt_report_slot_state(tpd->dev, MT_TOOL_FINGER, false);
+#endif
+				finger_oldstate[finger_count] =
+				    finger_prestate[finger_count];
+				finger_prestate[finger_count] = TOUCH_RELEASED;
+				TPD_LOG("%d key is %s ( x/y =                    %d, %d)\n",
+					finger_count,
+					finger_prestate[finger_count] ? "pressed" :
+					"released", pre_touch_info.pos_x[finger_count],
+					pre_touch_info.pos_y[finger_count]);
+				report_enable = 1;
+
+				pre_touch_info.pos_x[finger_count] = 0;
+				pre_touch_info.pos_y[finger_count] = 0;
+			}
 
-				if (report_enable) {
+			if (report_enable) {
 #if defined(MT_PROTOCOL_A)
-					input_mt_sync(tpd->dev);
+				input_mt_sync(tpd->dev);
 #endif
-					report_enable = 0;
-				}
+				report_enable = 0;
 			}
+		}
 
-			finger_info.total_num = index;
-			old_touch_info.total_num = pre_touch_info.total_num;
-			pre_touch_info.total_num = finger_info.total_num;
+		finger_info.total_num = index;
+		old_touch_info.total_num = pre_touch_info.total_num;
+		pre_touch_info.total_num = finger_info.total_num;
 
-			input_sync(tpd->dev);
-		}
+		input_sync(tpd->dev);
+	}
 
 
 exit_work:
-		mutex_unlock(&i2c_access);
-		enable_irq(touch_irq);
-	} while (!kthread_should_stop());
+	mutex_unlock(&i2c_access);
 
-	return 0;
+	return IRQ_HANDLED;
 }
 
 /****************************************************************************
@@ -2971,7 +2953,6 @@ static struct foo_obj *create_foo_obj(const char *name)
 static int synaptics_i2c_probe(struct i2c_client *client, const struct i2c_device_id *id)
 {
 	int ret = 0;
-	struct task_struct *thread = NULL;
 
 	TPD_ERR("START : synaptics_i2c_probe\n");
 	/* i2c_check_functionality */
@@ -3026,14 +3007,7 @@ static int synaptics_i2c_probe(struct i2c_client *client, const struct i2c_devic
 		goto err_probing;
 	}
 
-	thread = kthread_run(synaptics_touch_event_handler, 0, TPD_DEVICE);
-	if (IS_ERR(thread)) {
-		ret = PTR_ERR(thread);
-		TPD_ERR("failed to create kernel thread: %d\n", ret);
-		goto err_probing;
-	}
-
-	/* Configure external ( GPIO ) interrupt */
+	/* Configure external ( GPIO ) interrupt, touch reports run in its irq thread */
 	synaptics_setup_eint();
 
 	/* Find register map */
@@ -20,6 +20,7 @@
 #include <linux/delay.h>
 #include <linux/input.h>
 #include <linux/workqueue.h>
+#include <linux/math64.h>
 #include <linux/kobject.h>
 #include <linux/platform_device.h>
 #include <asm/atomic.h>
@@ -148,6 +149,20 @@ struct mpu6515_i2c_data {
 	struct early_suspend early_drv;
 #endif
 	u8 bandwidth;
+
+#ifndef CUSTOM_KERNEL_SENSORHUB
+	/* fifo batch mode, all under gsensor_mutex */
+	bool fifo_en;
+	bool fifo_drained;
+	int fifo_period_ms;
+	int fifo_rec_len;	/* bytes per fifo record, accel first */
+	int fifo_count;
+	int fifo_idx;
+	int64_t fifo_last_ts;
+	struct hwm_sensor_data fifo_data[MPU6515_FIFO_SIZE / MPU6515_DATA_LEN];
+	u8 fifo_buf[MPU6515_FIFO_BURST];
+	struct delayed_work fifo_wm_work;
+#endif
 };
 /*----------------------------------------------------------------------------*/
 #ifdef CONFIG_OF
@@ -342,6 +357,53 @@ static int mpu_i2c_read_block(struct i2c_client *client, u8 addr, u8 *data, u8 l
 	return err;
 }
 
+/* one write-read transfer of up to MPU6515_FIFO_BURST bytes from FIFO_R_W */
+static int mpu_i2c_read_fifo(struct i2c_client *client, u8 *data, int len)
+{
+	u8 addr = MPU6515_REG_FIFO_R_W;
+	int err;
+#ifdef CONFIG_MTK_I2C_EXTENSION
+	/* the adapter moves to dma on its own above its 8 byte fifo */
+	err = mtk_i2c_write_read(client, &addr, 1, data, len);
+	if (err >= 0 && err != len)
+		err = -EIO;
+#else
+	struct i2c_msg msg[2] = {
+		{ .addr = client->addr, .flags = 0, .len = 1, .buf = &addr },
+		{ .addr = client->addr, .flags = I2C_M_RD, .len = len, .buf = data },
+	};
+
+	err = i2c_transfer(client->adapter, msg, 2);
+	if (err >= 0 && err != 2)
+		err = -EIO;
+#endif
+	if (err < 0)
+		GSE_ERR("fifo read error: (%d) %d\n", len, err);
+	else
+		err = 0;
+
+	return err;
+}
+
+int MPU6515_hwmsen_read_fifo(u8 *buf, int len)
+{
+	int err = 0;
+	int n;
+
+	if (NULL == mpu6515_i2c_client) {
+		GSE_ERR("MPU6515_hwmsen_read_fifo null ptr!!\n");
+		return MPU6515_ERR_I2C;
+	}
+	while (len > 0 && !err) {
+		n = min(len, MPU6515_FIFO_BURST);
+		err = mpu_i2c_read_fifo(mpu6515_i2c_client, buf, n);
+		buf += n;
+		len -= n;
+	}
+	return err;
+}
+EXPORT_SYMBOL(MPU6515_hwmsen_read_fifo);
+
 int MPU6515_hwmsen_read_block(u8 addr, u8 *buf, u8 len)
 {
 #ifndef GSENSOR_UT
@@ -2172,6 +2234,17 @@ static int mpu6515_resume(struct i2c_client *client)
 		GSE_ERR("initialize client fail!!\n");
 		return err;
 	}
+#ifndef CUSTOM_KERNEL_SENSORHUB
+	/* fifo setup is lost with the supply */
+	if (obj->fifo_en) {
+		mutex_lock(&gsensor_mutex);
+		obj->fifo_en = false;
+		err = MPU6515_SetFifoMode(obj, true, obj->fifo_period_ms);
+		mutex_unlock(&gsensor_mutex);
+		if (err)
+			GSE_ERR("restore fifo mode fail!!\n");
+	}
+#endif				/* #ifndef CUSTOM_KERNEL_SENSORHUB */
 	atomic_set(&obj->suspend, 0);
 	/* mutex_unlock(&gsensor_mutex); */
 	GSE_LOG("mpu6515_resume ok\n");
@@ -2458,6 +2531,244 @@ static int gsensor_get_data(int *x, int *y, int *z, int *status)
 	return 0;
 }
 
+/*----------------------------------------------------------------------------*/
+#ifndef CUSTOM_KERNEL_SENSORHUB
+static int64_t mpu6515_get_time_ns(void)
+{
+	struct timespec time;
+
+	get_monotonic_boottime(&time);
+	return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+/*----------------------------------------------------------------------------*/
+static int MPU6515_ResetFifo(struct i2c_client *client)
+{
+	u8 databuf[2];
+
+	if (hwmsen_read_byte(client, MPU6515_REG_USER_CTRL, databuf))
+		return MPU6515_ERR_I2C;
+
+	databuf[1] = databuf[0] | MPU6515_USER_FIFO_RST;
+	databuf[0] = MPU6515_REG_USER_CTRL;
+	if (i2c_master_send(client, databuf, 0x2) <= 0)
+		return MPU6515_ERR_I2C;
+
+	return MPU6515_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+/* caller holds gsensor_mutex */
+static int MPU6515_SetFifoMode(struct mpu6515_i2c_data *obj, bool enable, int period_ms)
+{
+	struct i2c_client *client = obj->client;
+	u8 databuf[2];
+	u8 fifo_en, user_ctrl;
+
+	if (!enable && !obj->fifo_en)
+		return MPU6515_SUCCESS;
+
+	if (hwmsen_read_byte(client, MPU6515_REG_FIFO_EN, &fifo_en) ||
+	    hwmsen_read_byte(client, MPU6515_REG_USER_CTRL, &user_ctrl)) {
+		GSE_ERR("read fifo registers err!\n");
+		return MPU6515_ERR_I2C;
+	}
+
+	if (enable) {
+		period_ms = clamp(period_ms, 1, 256);
+		/* the gyro driver owns the sample rate while it is on */
+		if (MPU6515_gyro_mode() == false) {
+			if (hwmsen_read_byte(client, MPU6515_REG_CONFIG, databuf))
+				return MPU6515_ERR_I2C;
+			databuf[1] = (databuf[0] & ~MPU6515_DLPF_CFG_MASK) | MPU6515_DLPF_CFG_184HZ;
+			databuf[0] = MPU6515_REG_CONFIG;
+			if (i2c_master_send(client, databuf, 0x2) <= 0)
+				return MPU6515_ERR_I2C;
+
+			databuf[0] = MPU6515_REG_SMPLRT_DIV;
+			databuf[1] = period_ms - 1;
+			if (i2c_master_send(client, databuf, 0x2) <= 0)
+				return MPU6515_ERR_I2C;
+		}
+		fifo_en |= MPU6515_FIFO_ACCEL_EN;
+		user_ctrl |= MPU6515_USER_FIFO_EN | MPU6515_USER_FIFO_RST;
+	} else {
+		fifo_en &= ~MPU6515_FIFO_ACCEL_EN;
+		if (0 == fifo_en)
+			user_ctrl &= ~MPU6515_USER_FIFO_EN;
+	}
+
+	databuf[0] = MPU6515_REG_FIFO_EN;
+	databuf[1] = fifo_en;
+	if (i2c_master_send(client, databuf, 0x2) <= 0)
+		return MPU6515_ERR_I2C;
+
+	databuf[0] = MPU6515_REG_USER_CTRL;
+	databuf[1] = user_ctrl;
+	if (i2c_master_send(client, databuf, 0x2) <= 0)
+		return MPU6515_ERR_I2C;
+
+	/* records hold the enabled outputs in register order, accel first */
+	obj->fifo_rec_len = MPU6515_DATA_LEN + 2 * hweight8(fifo_en & MPU6515_FIFO_GYRO_EN);
+	if (fifo_en & MPU6515_FIFO_TEMP_EN)
+		obj->fifo_rec_len += 2;
+
+	obj->fifo_en = enable;
+	obj->fifo_period_ms = period_ms;
+	obj->fifo_count = 0;
+	obj->fifo_idx = 0;
+	obj->fifo_drained = false;
+	obj->fifo_last_ts = mpu6515_get_time_ns();
+
+	GSE_LOG("fifo mode %d, period %dms, record %d bytes\n", enable, period_ms,
+		obj->fifo_rec_len);
+	return MPU6515_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+/*
+ * Drain the fifo in as few bursts as possible and spread the samples evenly
+ * between the previous drain and this one. Caller holds gsensor_mutex.
+ */
+static int MPU6515_ReadFifo(struct mpu6515_i2c_data *obj)
+{
+	struct i2c_client *client = obj->client;
+	int rec = obj->fifo_rec_len;
+	int per_burst = MPU6515_FIFO_BURST / rec;
+	u8 cnt[2];
+	int64_t now;
+	u64 delta, t;
+	int bytes, n, m, i, j, k, err;
+
+	obj->fifo_count = 0;
+	obj->fifo_idx = 0;
+
+	err = mpu_i2c_read_block(client, MPU6515_REG_FIFO_COUNTH, cnt, 2);
+	if (err)
+		return err;
+	now = mpu6515_get_time_ns();
+
+	bytes = ((cnt[0] & 0x1f) << 8) | cnt[1];
+	if (bytes >= MPU6515_FIFO_SIZE) {
+		/* oldest bytes were overwritten, records are no longer aligned */
+		GSE_ERR("fifo overflow, %d bytes dropped\n", bytes);
+		obj->fifo_last_ts = now;
+		return MPU6515_ResetFifo(client);
+	}
+
+	n = bytes / rec;
+	delta = now - obj->fifo_last_ts;
+	for (i = 0; i < n; i += m) {
+		m = min(n - i, per_burst);
+		err = mpu_i2c_read_fifo(client, obj->fifo_buf, m * rec);
+		if (err) {
+			MPU6515_ResetFifo(client);
+			break;
+		}
+
+		for (j = 0; j < m; j++) {
+			struct hwm_sensor_data *d = &obj->fifo_data[i + j];
+			u8 *p = obj->fifo_buf + j * rec;
+			int acc[MPU6515_AXES_NUM];
+			s16 raw;
+
+			for (k = 0; k < MPU6515_AXES_NUM; k++) {
+				raw = (s16) ((p[k * 2] << 8) | p[k * 2 + 1]);
+				acc[obj->cvt.map[k]] = obj->cvt.sign[k] * (raw + obj->cali_sw[k]);
+			}
+			/* mg, matching the divisor registered with batch */
+			for (k = 0; k < MPU6515_AXES_NUM; k++)
+				d->values[k] = acc[k] * 1000 / obj->reso->sensitivity;
+
+			d->sensor = ID_ACCELEROMETER;
+			d->status = SENSOR_STATUS_ACCURACY_MEDIUM;
+			t = delta * (i + j + 1);
+			do_div(t, n);
+			d->time = obj->fifo_last_ts + t;
+		}
+	}
+
+	obj->fifo_count = i;
+	obj->fifo_last_ts = now;
+	if (atomic_read(&obj->trace) & MPU6515_TRC_RAWDATA)
+		GSE_LOG("fifo drained %d of %d samples\n", i, n);
+
+	return err;
+}
+
+/*----------------------------------------------------------------------------*/
+static void gsensor_fifo_arm_wm(struct mpu6515_i2c_data *obj)
+{
+	int ms = MPU6515_FIFO_WATERMARK / obj->fifo_rec_len * obj->fifo_period_ms;
+
+	mod_delayed_work(system_wq, &obj->fifo_wm_work, msecs_to_jiffies(ms));
+}
+
+/*----------------------------------------------------------------------------*/
+/* no fifo interrupt is wired up, this stands in for the watermark irq */
+static void gsensor_fifo_wm_work(struct work_struct *work)
+{
+	batch_notify(TYPE_BATCHFULL);
+}
+
+/*----------------------------------------------------------------------------*/
+static int gsensor_enable_hw_batch(int handle, int enable, int flag, long long samplingPeriodNs,
+				   long long maxBatchReportLatencyNs)
+{
+	struct mpu6515_i2c_data *obj = obj_i2c_data;
+	bool fifo = enable && (maxBatchReportLatencyNs != 0);
+	int err;
+
+	mutex_lock(&gsensor_mutex);
+	err = MPU6515_SetFifoMode(obj, fifo, (int)div_s64(samplingPeriodNs, 1000000));
+	if ((err == MPU6515_SUCCESS) && fifo)
+		gsensor_fifo_arm_wm(obj);
+	mutex_unlock(&gsensor_mutex);
+
+	if (!fifo)
+		cancel_delayed_work_sync(&obj->fifo_wm_work);
+
+	if (err != MPU6515_SUCCESS) {
+		GSE_ERR("gsensor_enable_hw_batch fail!\n");
+		return -1;
+	}
+	return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+static int gsensor_flush(int handle)
+{
+	return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* batch reads until this returns non-zero, so drain the fifo once per round */
+static int gsensor_batch_get_data(int handle, struct hwm_sensor_data *data)
+{
+	struct mpu6515_i2c_data *obj = obj_i2c_data;
+	int err = 0;
+
+	mutex_lock(&gsensor_mutex);
+	if (obj->fifo_idx >= obj->fifo_count) {
+		if (obj->fifo_drained || !obj->fifo_en || atomic_read(&obj->suspend)) {
+			obj->fifo_drained = false;
+			err = 1;
+		} else {
+			MPU6515_ReadFifo(obj);
+			gsensor_fifo_arm_wm(obj);
+			obj->fifo_drained = (obj->fifo_count != 0);
+			if (!obj->fifo_drained)
+				err = 1;
+		}
+	}
+	if (0 == err)
+		*data = obj->fifo_data[obj->fifo_idx++];
+	mutex_unlock(&gsensor_mutex);
+
+	return err;
+}
+#endif				/* #ifndef CUSTOM_KERNEL_SENSORHUB */
+
 /*----------------------------------------------------------------------------*/
 static int mpu6515_i2c_detect(struct i2c_client *client, struct i2c_board_info *info)
 {
@@ -2472,6 +2783,10 @@ static int mpu6515_i2c_probe(struct i2c_client *client, const struct i2c_device_
 	struct mpu6515_i2c_data *obj;
 	struct acc_control_path ctl = { 0 };
 	struct acc_data_path data = { 0 };
+#ifndef CUSTOM_KERNEL_SENSORHUB
+	struct batch_control_path batch_ctl = { 0 };
+	struct batch_data_path batch_data = { 0 };
+#endif
 	int err = 0;
 
 	GSE_FUN();
@@ -2494,6 +2809,8 @@ static int mpu6515_i2c_probe(struct i2c_client *client, const struct i2c_device_
 	}
 #ifdef CUSTOM_KERNEL_SENSORHUB
 	INIT_WORK(&obj->irq_work, gsensor_irq_work);
+#else
+	INIT_DELAYED_WORK(&obj->fifo_wm_work, gsensor_fifo_wm_work);
 #endif				/* #ifdef CUSTOM_KERNEL_SENSORHUB */
 
 	obj_i2c_data = obj;
@@ -2555,11 +2872,7 @@ static int mpu6515_i2c_probe(struct i2c_client *client, const struct i2c_device_
 #endif
 	ctl.set_delay = gsensor_set_delay;
 	ctl.is_report_input_direct = false;
-#ifdef CUSTOM_KERNEL_SENSORHUB
 	ctl.is_support_batch = obj->hw->is_batch_supported;
-#else
-	ctl.is_support_batch = false;
-#endif
 
 	err = acc_register_control_path(&ctl);
 	if (err) {
@@ -2580,6 +2893,20 @@ static int mpu6515_i2c_probe(struct i2c_client *client, const struct i2c_device_
 		GSE_ERR("register gsensor batch support err = %d\n", err);
 		goto exit_create_attr_failed;
 	}
+#ifndef CUSTOM_KERNEL_SENSORHUB
+	if (ctl.is_support_batch) {
+		batch_ctl.enable_hw_batch = gsensor_enable_hw_batch;
+		batch_ctl.flush = gsensor_flush;
+		batch_data.get_data = gsensor_batch_get_data;
+		err = batch_register_control_path(ID_ACCELEROMETER, &batch_ctl);
+		if (!err)
+			err = batch_register_data_path(ID_ACCELEROMETER, &batch_data);
+		if (err) {
+			GSE_ERR("register gsensor batch path err = %d\n", err);
+			goto exit_create_attr_failed;
+		}
+	}
+#endif
 #if defined(CONFIG_HAS_EARLYSUSPEND) && defined(USE_EARLY_SUSPEND)
 	obj->early_drv.level = EARLY_SUSPEND_LEVEL_STOP_DRAWING - 2,
 	    obj->early_drv.suspend = mpu6515_early_suspend,
@@ -2616,6 +2943,9 @@ static int mpu6515_i2c_remove(struct i2c_client *client)
 	if (err)
 		GSE_ERR("misc_deregister fail: %d\n", err);
 
+#ifndef CUSTOM_KERNEL_SENSORHUB
+	cancel_delayed_work_sync(&obj_i2c_data->fifo_wm_work);
+#endif
 	mpu6515_i2c_client = NULL;
 	i2c_unregister_device(client);
 	kfree(i2c_get_clientdata(client));
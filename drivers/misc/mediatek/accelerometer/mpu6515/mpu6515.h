@@ -17,6 +17,12 @@
 #define MPU6515_REG_DATAY0			0x3D
 #define MPU6515_REG_DATAZ0			0x3F
 #define MPU6515_REG_RESET               0x68
+#define MPU6515_REG_SMPLRT_DIV		0x19
+#define MPU6515_REG_CONFIG			0x1A
+#define MPU6515_REG_FIFO_EN			0x23
+#define MPU6515_REG_USER_CTRL		0x6A
+#define MPU6515_REG_FIFO_COUNTH		0x72
+#define MPU6515_REG_FIFO_R_W		0x74
 
 /* register Value */
 #define MPU6515_FIXED_DEVID         0x74
@@ -42,6 +48,23 @@
 
 #define MPU6515_SLEEP				0x40	/* enable low power sleep mode */
 
+/* for MPU6515_REG_CONFIG, 1kHz internal rate so SMPLRT_DIV applies */
+#define MPU6515_DLPF_CFG_MASK		0x07
+#define MPU6515_DLPF_CFG_184HZ		0x01
+
+/* for MPU6515_REG_FIFO_EN */
+#define MPU6515_FIFO_TEMP_EN		0x80
+#define MPU6515_FIFO_GYRO_EN		0x70	/* x, y and z */
+#define MPU6515_FIFO_ACCEL_EN		0x08
+
+/* for MPU6515_REG_USER_CTRL */
+#define MPU6515_USER_FIFO_EN		0x40
+#define MPU6515_USER_FIFO_RST		0x04
+
+#define MPU6515_FIFO_SIZE			512
+/* software watermark, the part only raises an interrupt on overflow */
+#define MPU6515_FIFO_WATERMARK		(MPU6515_FIFO_SIZE * 3 / 4)
+
 
 
 /* below do not modify */
@@ -9,5 +9,9 @@ int MPU6515_i2c_master_send(u8 *buf, u8 len);
 int MPU6515_i2c_master_recv(u8 *buf, u8 len);
 int MPU6515_hwmsen_read_block(u8 addr, u8 *buf, u8 len);
 int MPU6515_hwmsen_read_byte(u8 addr, u8 *buf);
+int MPU6515_hwmsen_read_fifo(u8 *buf, int len);
+
+/* largest FIFO_R_W burst, a multiple of 6 and 12 byte records that fits one i2c dma transfer */
+#define MPU6515_FIFO_BURST		240
 
 #endif
@@ -25,6 +25,7 @@
 #include <linux/semaphore.h>
 #include <linux/workqueue.h>
 #include <linux/kthread.h>
+#include <linux/stacktrace.h>
 #include <mt-plat/aee.h>
 #include <linux/seq_file.h>
 #include "aed.h"
@@ -457,6 +458,195 @@ static int hang_detect_thread(void *arg)
 	return 0;
 }
 
+/*
+ * Stall sampler: the threads that make the UI move are sampled every
+ * hd_sample_ms into a small ring each. When one of them stays runnable
+ * without a cpu, or in D state, for hd_stall_ms, the samples of that stall
+ * are printed once, so the sub-second stalls that never reach the
+ * hang_detect timeout still leave a trace. hd_stall_ms=0 turns it off.
+ */
+#define HD_SAMPLE_NR		16	/* per thread, power of 2 */
+#define HD_SAMPLE_DEPTH		6
+#define HD_RESOLVE_INTER	(5 * HZ)	/* look the threads up again */
+
+struct hd_sample {
+	unsigned long jiffies;
+	char state;		/* 'R' waiting for a cpu, 'D', '-' not stalled */
+	unsigned char nr_entries;
+	unsigned long entries[HD_SAMPLE_DEPTH];
+};
+
+struct hd_stall_target {
+	const char *proc;	/* comm of the thread group leader */
+	const char *thread;	/* comm of the thread */
+	pid_t pid;
+	unsigned long stall_start;	/* jiffies, 0 when not stalled */
+	bool reported;
+	unsigned int head;
+	struct hd_sample samples[HD_SAMPLE_NR];
+};
+
+static struct hd_stall_target hd_stall_targets[] = {
+	{ .proc = "system_server", .thread = "system_server" },
+	{ .proc = "system_server", .thread = "android.ui" },
+	{ .proc = "system_server", .thread = "android.display" },
+	{ .proc = "surfaceflinger", .thread = "surfaceflinger" },
+};
+
+static int hd_sample_ms = 100;
+static int hd_stall_ms = 500;
+module_param(hd_sample_ms, int, 0644);
+module_param(hd_stall_ms, int, 0644);
+
+static void hd_stall_resolve(void)
+{
+	struct hd_stall_target *tg;
+	struct task_struct *p, *t;
+	int i;
+
+	rcu_read_lock();
+	for_each_process(p) {
+		for (i = 0; i < ARRAY_SIZE(hd_stall_targets); i++) {
+			tg = &hd_stall_targets[i];
+			if (strcmp(p->comm, tg->proc))
+				continue;
+			for_each_thread(p, t) {
+				if (strcmp(t->comm, tg->thread) || t->pid == tg->pid)
+					continue;
+				tg->pid = t->pid;
+				tg->stall_start = 0;
+				tg->reported = false;
+				break;
+			}
+		}
+	}
+	rcu_read_unlock();
+}
+
+static void hd_stall_report(struct hd_stall_target *tg)
+{
+	char line[256];
+	struct hd_sample *s, *prev = NULL;
+	unsigned int idx, first, repeat = 0;
+	int len, i;
+
+	LOGE("[Hang_Detect] stall %s/%s(%d) %c for %u ms\n", tg->proc, tg->thread, tg->pid,
+	     tg->samples[(tg->head - 1) & (HD_SAMPLE_NR - 1)].state,
+	     jiffies_to_msecs(jiffies - tg->stall_start));
+
+	/* samples of the stall, plus the one before it; equal stacks folded */
+	first = tg->head > HD_SAMPLE_NR ? tg->head - HD_SAMPLE_NR : 0;
+	for (idx = first; idx <= tg->head; idx++) {
+		s = idx < tg->head ? &tg->samples[idx & (HD_SAMPLE_NR - 1)] : NULL;
+		if (s && time_before(s->jiffies, tg->stall_start - msecs_to_jiffies(hd_sample_ms)))
+			continue;
+		if (s && prev && s->state == prev->state && s->nr_entries == prev->nr_entries &&
+		    !memcmp(s->entries, prev->entries, s->nr_entries * sizeof(s->entries[0]))) {
+			repeat++;
+			continue;
+		}
+		if (prev) {
+			len = snprintf(line, sizeof(line), " -%ums %c x%u",
+				       jiffies_to_msecs(jiffies - prev->jiffies), prev->state, repeat);
+			for (i = 0; i < prev->nr_entries && len < sizeof(line); i++)
+				len += snprintf(line + len, sizeof(line) - len, "%s%pS",
+						i ? " <- " : " ", (void *)prev->entries[i]);
+			LOGE("[Hang_Detect] %s\n", line);
+		}
+		prev = s;
+		repeat = 1;
+	}
+}
+
+static void hd_stall_sample(struct hd_stall_target *tg)
+{
+	struct hd_sample *s;
+	struct stack_trace trace;
+	struct task_struct *p;
+	char state = '-';
+
+	rcu_read_lock();
+	p = find_task_by_vpid(tg->pid);
+	if (p && strcmp(p->comm, tg->thread))
+		p = NULL;
+	if (p)
+		get_task_struct(p);
+	rcu_read_unlock();
+	if (!p) {
+		tg->pid = 0;
+		tg->stall_start = 0;
+		tg->reported = false;
+		return;
+	}
+
+	if (p->state == TASK_RUNNING && !task_curr(p))
+		state = 'R';
+	else if (p->state & TASK_UNINTERRUPTIBLE)
+		state = 'D';
+
+	s = &tg->samples[tg->head++ & (HD_SAMPLE_NR - 1)];
+	s->jiffies = jiffies;
+	s->state = state;
+	s->nr_entries = 0;
+	/* the stack of a task that is on a cpu can not be walked from here */
+	if (!task_curr(p)) {
+		trace.entries = s->entries;
+		trace.nr_entries = 0;
+		trace.max_entries = HD_SAMPLE_DEPTH;
+		trace.skip = 0;
+		save_stack_trace_tsk(p, &trace);
+		s->nr_entries = trace.nr_entries;
+	}
+	put_task_struct(p);
+
+	if (state == '-') {
+		tg->stall_start = 0;
+		tg->reported = false;
+		return;
+	}
+	if (!tg->stall_start)
+		tg->stall_start = s->jiffies;
+	if (!tg->reported &&
+	    time_after_eq(s->jiffies, tg->stall_start + msecs_to_jiffies(hd_stall_ms))) {
+		hd_stall_report(tg);
+		tg->reported = true;
+	}
+}
+
+static int hd_stall_thread(void *arg)
+{
+	struct sched_param param = { .sched_priority = 1 };
+	unsigned long resolved = jiffies - HD_RESOLVE_INTER;
+	bool missing;
+	int i;
+
+	/* a stalled target must not keep its sampler from running */
+	sched_setscheduler(current, SCHED_FIFO, &param);
+
+	while (!kthread_should_stop()) {
+		if (hd_stall_ms <= 0 || hd_sample_ms <= 0) {
+			schedule_timeout_interruptible(HD_RESOLVE_INTER);
+			continue;
+		}
+
+		missing = false;
+		for (i = 0; i < ARRAY_SIZE(hd_stall_targets); i++)
+			missing |= !hd_stall_targets[i].pid;
+		if (missing && time_after_eq(jiffies, resolved + HD_RESOLVE_INTER)) {
+			hd_stall_resolve();
+			resolved = jiffies;
+		}
+
+		for (i = 0; i < ARRAY_SIZE(hd_stall_targets); i++) {
+			if (hd_stall_targets[i].pid)
+				hd_stall_sample(&hd_stall_targets[i]);
+		}
+
+		schedule_timeout_interruptible(msecs_to_jiffies(hd_sample_ms));
+	}
+	return 0;
+}
+
 void hd_test(void)
 {
 	hang_detect_counter = 0;
@@ -574,6 +764,10 @@ int hang_detect_init(void)
 		 name);
 	wake_up_process(hd_thread);
 
+	hd_thread = kthread_run(hd_stall_thread, NULL, "hang_sampler");
+	if (IS_ERR(hd_thread))
+		LOGE("[Hang_Detect] failed to start hang_sampler\n");
+
 	return 0;
 }
 
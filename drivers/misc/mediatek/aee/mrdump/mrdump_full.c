@@ -8,6 +8,8 @@
 #include <linux/elfcore.h>
 #include <linux/kallsyms.h>
 #include <linux/memblock.h>
+#include <linux/mmzone.h>
+#include <linux/bitmap.h>
 #include <linux/miscdevice.h>
 #include <mt-plat/mtk_ram_console.h>
 #include <linux/reboot.h>
@@ -50,6 +52,16 @@ static const struct mrdump_platform *mrdump_plat;
 static char mrdump_lk[12];
 static int mrdump_rsv_conflict;
 
+/* full dump hints, see struct mrdump_dump_hint */
+static bool mrdump_lk_hint;
+static unsigned int mrdump_compress = MRDUMP_COMP_LZ4;
+static unsigned int mrdump_streams = 4;
+static bool mrdump_skip_free = 1;
+static bool mrdump_skip_zero = 1;
+static unsigned long *mrdump_skip_bitmap;
+static unsigned long mrdump_skip_pfn_start;
+static unsigned long mrdump_skip_nr_pfns;
+
 static u32 *append_elf_note(u32 *buf, char *name, unsigned type, void *data,
 			    size_t data_len)
 {
@@ -205,6 +217,88 @@ static void __mrdump_reboot_stop_all(struct mrdump_crash_record *crash_record, i
 
 #endif
 
+/* the free lists may be half updated by the crash, never follow a bad link */
+static bool mrdump_page_ok(struct page *page)
+{
+	unsigned long pfn = page_to_pfn(page);
+
+	return pfn_valid(pfn) && pfn_to_page(pfn) == page;
+}
+
+static void mrdump_skip_pages(unsigned long pfn, unsigned long nr)
+{
+	if (pfn < mrdump_skip_pfn_start || pfn + nr > mrdump_skip_pfn_start + mrdump_skip_nr_pfns)
+		return;
+	bitmap_set(mrdump_skip_bitmap, pfn - mrdump_skip_pfn_start, nr);
+}
+
+/*
+ * Other cpus are stopped, so the zone locks are not taken; whoever held one
+ * is not coming back. Returns false if a list looked corrupted.
+ */
+static bool mrdump_mark_free_pages(void)
+{
+	struct per_cpu_pages *pcp;
+	struct zone *zone;
+	struct page *page;
+	unsigned long budget;
+	int order, t, cpu;
+
+	bitmap_zero(mrdump_skip_bitmap, mrdump_skip_nr_pfns);
+	for_each_populated_zone(zone) {
+		budget = zone->managed_pages;
+		for_each_migratetype_order(order, t) {
+			list_for_each_entry(page, &zone->free_area[order].free_list[t], lru) {
+				if (!budget-- || !mrdump_page_ok(page))
+					return false;
+				if (PageBuddy(page) && page_private(page) == order)
+					mrdump_skip_pages(page_to_pfn(page), 1UL << order);
+			}
+		}
+		for_each_possible_cpu(cpu) {
+			pcp = &per_cpu_ptr(zone->pageset, cpu)->pcp;
+			for (t = 0; t < MIGRATE_PCPTYPES; t++) {
+				list_for_each_entry(page, &pcp->lists[t], lru) {
+					if (!budget-- || !mrdump_page_ok(page))
+						return false;
+					mrdump_skip_pages(page_to_pfn(page), 1);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+static void mrdump_fill_hint(void)
+{
+	struct mrdump_dump_hint *hint = &mrdump_cblock.hint;
+
+	if (!mrdump_lk_hint)
+		return;
+	memset(hint, 0, sizeof(*hint));
+	hint->compress = mrdump_compress;
+	hint->nr_streams = mrdump_streams;
+	if (mrdump_skip_zero)
+		hint->flags |= MRDUMP_HINT_SKIP_ZERO;
+	if (mrdump_skip_free && mrdump_skip_bitmap && mrdump_mark_free_pages()) {
+		hint->flags |= MRDUMP_HINT_SKIP_FREE;
+		hint->skip_bitmap = __pa(mrdump_skip_bitmap);
+		hint->skip_pfn_start = mrdump_skip_pfn_start;
+		hint->skip_nr_pfns = mrdump_skip_nr_pfns;
+	}
+}
+
+static void mrdump_skip_bitmap_init(void)
+{
+	size_t size;
+
+	mrdump_skip_pfn_start = min_low_pfn;
+	mrdump_skip_nr_pfns = max_pfn - min_low_pfn;
+	size = BITS_TO_LONGS(mrdump_skip_nr_pfns) * sizeof(long);
+	mrdump_skip_bitmap = alloc_pages_exact(size, GFP_KERNEL);
+	if (!mrdump_skip_bitmap)
+		pr_warn("MT-RAMDUMP: no %zu bytes for the free page bitmap, dumping all\n", size);
+}
 
 static void __mrdump_reboot_va(AEE_REBOOT_MODE reboot_mode, struct pt_regs *regs, const char *msg, va_list ap)
 {
@@ -232,6 +326,7 @@ static void __mrdump_reboot_va(AEE_REBOOT_MODE reboot_mode, struct pt_regs *regs
 	vsnprintf(crash_record->msg, sizeof(crash_record->msg), msg, ap);
 	crash_record->fault_cpu = cpu;
 	save_current_task();
+	mrdump_fill_hint();
 
 	/* FIXME: Check reboot_mode is valid */
 	crash_record->reboot_mode = reboot_mode;
@@ -350,7 +445,10 @@ int __init mrdump_platform_init(const struct mrdump_platform *plat)
 		return -EINVAL;
 	}
 
-	if (strcmp(mrdump_lk, MRDUMP_GO_DUMP) != 0) {
+	if (strcmp(mrdump_lk, MRDUMP_GO_DUMP_HINT) == 0) {
+		mrdump_lk_hint = 1;
+		mrdump_skip_bitmap_init();
+	} else if (strcmp(mrdump_lk, MRDUMP_GO_DUMP) != 0) {
 		mrdump_enable = 0;
 		pr_err("%s: MT-RAMDUMP init failed, lk version %s not matched.\n", __func__, mrdump_lk);
 		return -EINVAL;
@@ -521,6 +619,12 @@ static int param_set_mrdump_lbaooo(const char *val, const struct kernel_param *k
 
 module_param_string(lk, mrdump_lk, sizeof(mrdump_lk), S_IRUGO);
 
+/* read at crash time, only used by an lk reporting MRDUMP_GO_DUMP_HINT */
+module_param_named(compress, mrdump_compress, uint, S_IRUGO | S_IWUSR);
+module_param_named(streams, mrdump_streams, uint, S_IRUGO | S_IWUSR);
+module_param_named(skip_free, mrdump_skip_free, bool, S_IRUGO | S_IWUSR);
+module_param_named(skip_zero, mrdump_skip_zero, bool, S_IRUGO | S_IWUSR);
+
 /* sys/modules/mrdump/parameter/lbaooo */
 struct kernel_param_ops param_ops_mrdump_lbaooo = {
 	.set = param_set_mrdump_lbaooo,
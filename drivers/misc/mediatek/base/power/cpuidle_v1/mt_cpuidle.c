@@ -20,6 +20,8 @@
 
 #include <linux/of_address.h>
 #include <linux/of.h>
+#include <linux/percpu.h>
+#include <linux/sched.h>
 
 #include <mt-plat/mt_dbg.h>
 #include <mt-plat/mt_io.h>
@@ -658,11 +660,41 @@ static void mt_cluster_restore(int flags)
 #endif
 }
 
-void mt_cpu_save(void)
+/* cores of the cluster in WFI, this one included */
+static unsigned int cluster_sleep_sta(int cpuid, int clusterid)
+{
+	unsigned int sleep_sta;
+
+	if (clusterid == 0)
+		sleep_sta = (spm_read(CPUIDLE_CPU_IDLE_STA) >> CPUIDLE_CPU_IDLE_STA_OFFSET) & 0x0f;
+	else
+		sleep_sta = (spm_read(CPUIDLE_CPU_IDLE_STA) >> (CPUIDLE_CPU_IDLE_STA_OFFSET + 4)) & 0x0f;
+
+	return sleep_sta | (1 << cpuid);
+}
+
+/*
+ * Only the last core going down takes the cluster with it; the others
+ * just lose their own context and the L2 stays powered and warm.
+ */
+static int mt_dormant_path(int flags)
+{
+	int cpuid, clusterid;
+
+	if (IS_DORMANT_CPUSYS_OFF(flags))
+		return MT_DORMANT_CLUSTER_OFF;
+
+	read_id(&cpuid, &clusterid);
+	if (cluster_sleep_sta(cpuid, clusterid) == 0x0f)
+		return MT_DORMANT_CLUSTER_OFF;
+
+	return MT_DORMANT_CORE_OFF;
+}
+
+void mt_cpu_save(int path)
 {
 	struct core_context *core;
 	struct cluster_context *cluster;
-	unsigned int sleep_sta;
 	int cpuid, clusterid;
 
 	read_id(&cpuid, &clusterid);
@@ -672,12 +704,7 @@ void mt_cpu_save(void)
 	mt_save_generic_timer((unsigned int *)core->timer_data, 0x0);
 	stop_generic_timer();
 
-	if (clusterid == 0)
-		sleep_sta = (spm_read(CPUIDLE_CPU_IDLE_STA) >> CPUIDLE_CPU_IDLE_STA_OFFSET) & 0x0f;
-	else
-		sleep_sta = (spm_read(CPUIDLE_CPU_IDLE_STA) >> (CPUIDLE_CPU_IDLE_STA_OFFSET + 4)) & 0x0f;
-
-	if ((sleep_sta | (1 << cpuid)) == 0x0f) { /* last core */
+	if (path == MT_DORMANT_CLUSTER_OFF) {
 		cluster = GET_CLUSTER_DATA();
 		mt_save_dbg_regs((unsigned int *)cluster->dbg_data, cpuid + (clusterid * 4));
 	}
@@ -694,12 +721,7 @@ void mt_cpu_restore(void)
 
 	core = GET_CORE_DATA();
 
-	if (clusterid == 0)
-		sleep_sta = (spm_read(CPUIDLE_CPU_IDLE_STA) >> CPUIDLE_CPU_IDLE_STA_OFFSET) & 0x0f;
-	else
-		sleep_sta = (spm_read(CPUIDLE_CPU_IDLE_STA) >> (CPUIDLE_CPU_IDLE_STA_OFFSET + 4)) & 0x0f;
-
-	sleep_sta = (sleep_sta | (1 << cpuid));
+	sleep_sta = cluster_sleep_sta(cpuid, clusterid);
 
 	if (sleep_sta == 0x0f) { /* first core */
 		cluster = GET_CLUSTER_DATA();
@@ -713,11 +735,12 @@ void mt_cpu_restore(void)
 	mt_restore_generic_timer((unsigned int *)core->timer_data, 0x0);
 }
 
-void mt_platform_save_context(int flags)
+void mt_platform_save_context(int flags, int path)
 {
-	mt_cpu_save();
+	mt_cpu_save(path);
 
 #if defined(CONFIG_ARCH_MT6580)
+	/* refcounted: any core may turn out to be the last one */
 	mt_cluster_save(flags);
 
 	if (IS_DORMANT_GIC_OFF(flags)) {
@@ -838,6 +861,42 @@ __naked void cpu_resume_wrapper(void)
 }
 #endif
 
+/*
+ * Kernel side cost of the dormant sequences: entry is from mt_cpu_dormant()
+ * to the PSCI call, exit from the return of cpu_suspend() to the end of the
+ * restore. Running averages in ns, read by the idle governor.
+ */
+struct dormant_latency {
+	unsigned int entry_ns[NR_MT_DORMANT_PATHS];
+	unsigned int exit_ns[NR_MT_DORMANT_PATHS];
+};
+
+static DEFINE_PER_CPU(struct dormant_latency, dormant_latency);
+
+static inline unsigned int dormant_ewma(unsigned int avg, u64 sample)
+{
+	sample = min_t(u64, sample, UINT_MAX / 8);
+	return avg ? (avg * 7 + (unsigned int)sample) / 8 : (unsigned int)sample;
+}
+
+static void mt_dormant_account(int path, u64 enter, u64 suspend, u64 resume)
+{
+	struct dormant_latency *lat = this_cpu_ptr(&dormant_latency);
+
+	lat->entry_ns[path] = dormant_ewma(lat->entry_ns[path], suspend - enter);
+	lat->exit_ns[path] = dormant_ewma(lat->exit_ns[path],
+					  sched_clock() - resume);
+}
+
+void mt_cpu_dormant_latency(int cpu, int path, unsigned int *entry_us,
+			    unsigned int *exit_us)
+{
+	struct dormant_latency *lat = &per_cpu(dormant_latency, cpu);
+
+	*entry_us = DIV_ROUND_UP(ACCESS_ONCE(lat->entry_ns[path]), NSEC_PER_USEC);
+	*exit_us = DIV_ROUND_UP(ACCESS_ONCE(lat->exit_ns[path]), NSEC_PER_USEC);
+}
+
 static int mt_cpu_dormant_abort(unsigned long index)
 {
 #if defined(CONFIG_ARCH_MT6580)
@@ -874,10 +933,13 @@ int mt_cpu_dormant(unsigned long flags)
 {
 	int ret;
 	int cpuid, clusterid;
+	int path = MT_DORMANT_CORE_OFF;
+	u64 enter, suspend, resume;
 
 	if (!mt_dormant_initialized)
 		return MT_CPU_DORMANT_BYPASS;
 
+	enter = sched_clock();
 	read_id(&cpuid, &clusterid);
 
 	DORMANT_LOG(clusterid * MAX_CORES + cpuid, 0x101);
@@ -893,7 +955,8 @@ int mt_cpu_dormant(unsigned long flags)
 		goto dormant_exit;
 	}
 
-	mt_platform_save_context(flags);
+	path = mt_dormant_path(flags);
+	mt_platform_save_context(flags, path);
 
 	DORMANT_LOG(clusterid * MAX_CORES + cpuid, 0x102);
 
@@ -906,6 +969,7 @@ int mt_cpu_dormant(unsigned long flags)
 
 	DORMANT_LOG(clusterid * MAX_CORES + cpuid, 0x103);
 
+	suspend = sched_clock();
 #if !defined(CONFIG_ARM64) && !defined(CONFIG_ARCH_MT6580)
 	ret = cpu_suspend(flags, mt_cpu_dormant_psci);
 #elif !defined(CONFIG_ARCH_MT6580)
@@ -921,6 +985,7 @@ int mt_cpu_dormant(unsigned long flags)
 #endif
 	ret = cpu_suspend(flags, mt_cpu_dormant_reset);
 #endif
+	resume = sched_clock();
 	DORMANT_LOG(clusterid * MAX_CORES + cpuid, 0x601);
 
 #if defined(CONFIG_ARCH_MT6580)
@@ -961,6 +1026,7 @@ int mt_cpu_dormant(unsigned long flags)
 	switch (ret) {
 	case 0: /* back from dormant reset */
 		mt_platform_restore_context(flags);
+		mt_dormant_account(path, enter, suspend, resume);
 		ret = MT_CPU_DORMANT_RESET;
 		break;
 
@@ -990,6 +1056,12 @@ dormant_exit:
 	return ret & 0x0ff;
 }
 
+/* MCDI: give up as soon as the SPM has a wakeup pending for this core */
+int mt_cpu_dormant_interruptible(unsigned long flags)
+{
+	return mt_cpu_dormant(flags | DORMANT_BREAK_CHECK);
+}
+
 static unsigned long get_dts_node_address(char *node_compatible, int index)
 {
 	unsigned long node_address = 0;
@@ -83,6 +83,26 @@
 
 int mt_cpu_dormant_init(void);
 int mt_cpu_dormant(unsigned long data);
+int mt_cpu_dormant_interruptible(unsigned long data);
+
+/*
+ * Power-down sequences of mt_cpu_dormant(). The core-off one is taken when
+ * the cluster stays up (another core of it is running) and only saves the
+ * core's own context; the cluster-off one also saves what the cluster
+ * loses: the debug registers of the last core and, with CPUSYS off, the
+ * GIC. mt_cpu_dormant_latency() returns the running averages of the
+ * kernel side entry and exit time of a sequence on @cpu, 0 before the
+ * first one. They leave out the SPM and firmware part of the cost, so
+ * they are for reporting, not for idle decisions.
+ */
+enum mt_dormant_path {
+	MT_DORMANT_CORE_OFF,
+	MT_DORMANT_CLUSTER_OFF,
+	NR_MT_DORMANT_PATHS,
+};
+
+void mt_cpu_dormant_latency(int cpu, int path, unsigned int *entry_us,
+			    unsigned int *exit_us);
 
 extern void write_cntpctl(int cntpctl);
 extern int read_cntpctl(void);
@@ -81,6 +81,9 @@ struct init_sta {
 	bool is_on[NUM_CPU_CLUSTER];		/* on/off */
 };
 
+/* DVFS done of a posted OPP (SW index), @volt is Vproc PMIC value */
+typedef void (*cpuhvfs_notify_t)(unsigned int cluster, unsigned int index, unsigned int volt);
+
 
 /**************************************
  * [Hybrid DVFS] Macro / Inline
@@ -121,6 +124,8 @@ extern void cpuhvfs_notify_cluster_on(unsigned int cluster);
 extern void cpuhvfs_notify_cluster_off(unsigned int cluster);
 
 extern int cpuhvfs_set_target_opp(unsigned int cluster, unsigned int index, unsigned int *ret_volt);
+extern int cpuhvfs_post_target_opp(unsigned int cluster, unsigned int index);
+extern void cpuhvfs_register_dvfs_notify(cpuhvfs_notify_t notify);
 extern unsigned int cpuhvfs_get_curr_volt(unsigned int cluster);
 
 extern int cpuhvfs_get_dvfsp_semaphore(enum sema_user user);
@@ -145,6 +150,9 @@ static inline void cpuhvfs_notify_cluster_off(unsigned int cluster)	{ BUG(); }
 
 static inline int cpuhvfs_set_target_opp(unsigned int cluster, unsigned int index,
 					 unsigned int *ret_volt)	{ return -ENODEV; }
+static inline int cpuhvfs_post_target_opp(unsigned int cluster,
+					  unsigned int index)		{ return -ENODEV; }
+static inline void cpuhvfs_register_dvfs_notify(cpuhvfs_notify_t notify)	{}
 static inline unsigned int cpuhvfs_get_curr_volt(unsigned int cluster)	{ return UINT_MAX; }
 
 static inline int cpuhvfs_get_dvfsp_semaphore(enum sema_user user)	{ return 0; }
@@ -30,6 +30,7 @@
 #include <linux/io.h>
 #include <linux/topology.h>
 #include <linux/suspend.h>
+#include <linux/sched/energy.h>
 #include <mt-plat/sync_write.h>
 #include <mt-plat/mt_io.h>
 #include <mt-plat/aee.h>
@@ -125,6 +126,12 @@ static unsigned long apmixed_base;
  * 2: get voltage from PMIC through I2C
  */
 static u32 enable_cpuhvfs = 1;
+
+/**
+ * 1: post OPP to DVFSP without waiting for DVFS done, allows fast switch
+ * 0: wait for DVFS done in set_cur_freq_hybrid
+ */
+static u32 async_cpuhvfs = 1;
 #endif
 
 #include <linux/time.h>
@@ -282,17 +289,23 @@ static DEFINE_SPINLOCK(cpufreq_lock);
 #else				/* mutex */
 static DEFINE_MUTEX(cpufreq_mutex);
 bool is_in_cpufreq = 0;
+/* orders is_in_cpufreq against _mt_cpufreq_fast_switch() */
+static DEFINE_SPINLOCK(cpufreq_fast_lock);
 #define cpufreq_lock(flags) \
 	do { \
 		flags = (unsigned long)&flags; \
 		mutex_lock(&cpufreq_mutex); \
+		spin_lock_irq(&cpufreq_fast_lock); \
 		is_in_cpufreq = 1;\
+		spin_unlock_irq(&cpufreq_fast_lock); \
 	} while (0)
 
 #define cpufreq_unlock(flags) \
 	do { \
 		flags = (unsigned long)&flags; \
+		spin_lock_irq(&cpufreq_fast_lock); \
 		is_in_cpufreq = 0;\
+		spin_unlock_irq(&cpufreq_fast_lock); \
 		mutex_unlock(&cpufreq_mutex); \
 	} while (0)
 #endif
@@ -1689,11 +1702,53 @@ static void set_cur_freq_hybrid(struct mt_cpu_dvfs *p, unsigned int cur_khz, uns
 
 	aee_record_cpu_volt(p, volt);
 
+	if (async_cpuhvfs && !do_dvfs_stress_test) {
+		/* volt sampler is notified by cpuhvfs_dvfs_done() */
+		r = cpuhvfs_post_target_opp(cluster, index);
+		if (!r)
+			return;
+
+		/* mailbox busy or DVFSP paused, do this one synchronously */
+		cpufreq_err("cluster%u: post opp %d failed (%d), set it synchronously\n",
+			    cluster, index, r);
+	}
+
 	r = cpuhvfs_set_target_opp(cluster, index, &volt_val);
 	BUG_ON(r);
 
 	notify_cpu_volt_sampler(p, EXTBUCK_VAL_TO_VOLT(volt_val));
 }
+
+#ifndef DISABLE_PBM_FEATURE
+static void cpuhvfs_kick_pbm_work_fn(struct work_struct *work)
+{
+	unsigned long flags;
+
+	cpufreq_lock(flags);
+	_kick_PBM_by_cpu(id_to_cpu_dvfs(MT_CPU_DVFS_LITTLE));
+	cpufreq_unlock(flags);
+}
+
+static DECLARE_WORK(cpuhvfs_kick_pbm_work, cpuhvfs_kick_pbm_work_fn);
+static int cpuhvfs_kick_pbm_pending;
+#endif
+
+/* DVFS done of a posted OPP, called by DVFSP driver in hard IRQ context */
+static void cpuhvfs_dvfs_done(unsigned int cluster, unsigned int index, unsigned int volt_val)
+{
+	struct mt_cpu_dvfs *p;
+
+	p = id_to_cpu_dvfs(cluster == CPU_CLUSTER_LL ? MT_CPU_DVFS_LITTLE : MT_CPU_DVFS_BIG);
+
+	if (volt_val != UINT_MAX)
+		notify_cpu_volt_sampler(p, EXTBUCK_VAL_TO_VOLT(volt_val));
+
+#ifndef DISABLE_PBM_FEATURE
+	/* fast switch cannot kick PBM with rq->lock held */
+	if (xchg(&cpuhvfs_kick_pbm_pending, 0))
+		schedule_work(&cpuhvfs_kick_pbm_work);
+#endif
+}
 #endif
 
 /* for volt change (PMICWRAP/extBuck) */
@@ -2610,6 +2665,9 @@ static int _mt_cpufreq_setup_freqs_table(struct cpufreq_policy *policy,
 static unsigned int _calc_new_opp_idx(struct mt_cpu_dvfs *p, int new_opp_idx)
 {
 	unsigned int online_cpus;
+#ifndef DISABLE_PBM_FEATURE
+	unsigned int emerg_khz;
+#endif
 
 	FUNC_ENTER(FUNC_LV_HELP);
 
@@ -2634,6 +2692,15 @@ static unsigned int _calc_new_opp_idx(struct mt_cpu_dvfs *p, int new_opp_idx)
 	if ((p->idx_opp_ppm_base == p->idx_opp_ppm_limit) && p->idx_opp_ppm_base != -1)
 		new_opp_idx = p->idx_opp_ppm_base;
 
+#ifndef DISABLE_PBM_FEATURE
+	/* PBM cap for a consumer peak until PPM catches up, see mt_pbm.c */
+	emerg_khz = mt_pbm_get_emerg_cpu_khz(cpu_dvfs_is(p, MT_CPU_DVFS_LITTLE) ?
+					     MT_CPU_DVFS_LITTLE : MT_CPU_DVFS_BIG);
+	while (emerg_khz && new_opp_idx < p->nr_opp_tbl - 1 &&
+	       cpu_dvfs_get_freq_by_idx(p, new_opp_idx) > emerg_khz)
+		new_opp_idx++;
+#endif
+
 #ifdef CONFIG_CPU_DVFS_AEE_RR_REC
 	if (cpu_dvfs_is(p, MT_CPU_DVFS_LITTLE))
 		aee_rr_rec_cpu_dvfs_oppidx((aee_rr_curr_cpu_dvfs_oppidx() & 0xF0) | new_opp_idx);
@@ -2854,6 +2921,127 @@ static int _mt_cpufreq_target(struct cpufreq_policy *policy, unsigned int target
 	return ret;
 }
 
+#ifdef CONFIG_HYBRID_CPU_DVFS
+/*
+ * Called from scheduler context (rq->lock held, IRQ disabled): only post the
+ * OPP to DVFSP. Return 0 to make the governor fall back to _mt_cpufreq_target()
+ * when the mutex-protected path is busy or DVFSP cannot take posts
+ */
+static unsigned int _mt_cpufreq_fast_switch(struct cpufreq_policy *policy,
+					    unsigned int target_freq)
+{
+	struct mt_cpu_dvfs *p = id_to_cpu_dvfs(_get_cpu_dvfs_id(policy->cpu));
+	unsigned int new_opp_idx, target_khz, freq = 0;
+	int index;
+
+	if (!enable_cpuhvfs || !async_cpuhvfs || do_dvfs_stress_test)
+		return 0;
+
+	if (!p || p->dvfs_disable_by_procfs || p->armpll_is_available != 1)
+		return 0;
+
+	/*
+	 * The mutex cannot be taken here; holding cpufreq_fast_lock while
+	 * is_in_cpufreq is clear keeps the ->target path out until the OPP
+	 * is posted and idx_opp_tbl updated.
+	 */
+	if (!spin_trylock(&cpufreq_fast_lock))
+		return 0;
+	if (is_in_cpufreq)
+		goto out;
+
+	if (cpufreq_frequency_table_target(policy, p->freq_tbl_for_cpufreq, target_freq,
+					   CPUFREQ_RELATION_L, &new_opp_idx))
+		return 0;
+
+	new_opp_idx = _calc_new_opp_idx(p, new_opp_idx);	/* PPM and thermal limits */
+
+	target_khz = get_turbo_freq(p->cpu_id, cpu_dvfs_get_freq_by_idx(p, new_opp_idx));
+	index = search_table_idx_by_freq(p, target_khz);
+
+	if (cpuhvfs_post_target_opp(cpu_dvfs_to_cluster(p), index))
+		goto out;
+
+	aee_record_cpu_volt(p, cpu_dvfs_get_volt_by_idx(p, index));
+	p->idx_opp_tbl = new_opp_idx;
+#ifndef DISABLE_PBM_FEATURE
+	cpuhvfs_kick_pbm_pending = 1;
+#endif
+	freq = cpu_dvfs_get_freq_by_idx(p, new_opp_idx);
+out:
+	spin_unlock(&cpufreq_fast_lock);
+	return freq;
+}
+#endif
+
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+/*
+ * Dynamic power coefficient of one core in uW / (MHz * V^2). Both clusters
+ * are Cortex-A53, the L cluster is implemented for higher speed and has a
+ * larger switched capacitance.
+ */
+static const unsigned int cpu_dyn_power_coef[NR_MT_CPU_DVFS] = {
+	[MT_CPU_DVFS_LITTLE] = 110,
+	[MT_CPU_DVFS_BIG] = 140,
+};
+
+/* Tj used to estimate leakage for the energy model (degree C) */
+#define ENERGY_MODEL_TEMP	65
+
+static unsigned long _cpu_leakage_uw(unsigned int mv)
+{
+	int leak_mw = mt_spower_get_leakage(MT_SPOWER_CPU, mv, ENERGY_MODEL_TEMP);
+
+	/* sptab may not be ready yet, leave leakage out of the model then */
+	if (leak_mw < 0)
+		return 0;
+
+	/* MT_SPOWER_CPU covers the whole vproc rail, split it per core */
+	return (unsigned long)leak_mw * 1000 / num_possible_cpus();
+}
+
+/*
+ * Build the energy model of the cluster of @p from its OPP table and hand
+ * it to the scheduler. opp_tbl[] is sorted by descending frequency while
+ * the scheduler wants ascending capacity.
+ */
+static void _mt_cpufreq_register_energy(struct mt_cpu_dvfs *p, enum mt_cpu_dvfs_id id)
+{
+	struct capacity_state cs[SCHED_ENERGY_MAX_CAP_STATES];
+	struct cpumask cpus;
+	unsigned long max_cap, max_khz, dyn;
+	unsigned int khz, mv;
+	int i, nr;
+
+	arch_get_cluster_cpus(&cpus, id);
+	if (cpumask_empty(&cpus))
+		return;
+
+	nr = min(p->nr_opp_tbl, SCHED_ENERGY_MAX_CAP_STATES);
+	max_khz = cpu_dvfs_get_max_freq(p);
+	max_cap = arch_get_max_cpu_capacity(cpumask_first(&cpus));
+
+	for (i = 0; i < nr; i++) {
+		khz = cpu_dvfs_get_freq_by_idx(p, i);
+		mv = cpu_dvfs_get_volt_by_idx(p, i) / 100;
+
+		dyn = (unsigned long)cpu_dyn_power_coef[id] * (khz / 1000) * mv * mv;
+		dyn /= 1000000;
+
+		cs[nr - 1 - i].cap = max_cap * khz / max_khz;
+		cs[nr - 1 - i].power = dyn + _cpu_leakage_uw(mv);
+	}
+
+	mv = cpu_dvfs_get_volt_by_idx(p, p->nr_opp_tbl - 1) / 100;
+	if (sched_energy_register(id, &cpus, cs, nr, _cpu_leakage_uw(mv)))
+		cpufreq_err("%s: failed to register energy model\n", cpu_dvfs_get_name(p));
+}
+#else
+static inline void _mt_cpufreq_register_energy(struct mt_cpu_dvfs *p, enum mt_cpu_dvfs_id id)
+{
+}
+#endif
+
 static int _mt_cpufreq_init(struct cpufreq_policy *policy)
 {
 	int ret = -EINVAL;
@@ -2872,6 +3060,9 @@ static int _mt_cpufreq_init(struct cpufreq_policy *policy)
 	cpumask_setall(policy->cpus);
 
 	policy->cpuinfo.transition_latency = 1000;
+#ifdef CONFIG_HYBRID_CPU_DVFS
+	policy->fast_switch_possible = !!enable_cpuhvfs;
+#endif
 
 	{
 		enum mt_cpu_dvfs_id id = _get_cpu_dvfs_id(policy->cpu);
@@ -2891,6 +3082,8 @@ static int _mt_cpufreq_init(struct cpufreq_policy *policy)
 
 		ret = _mt_cpufreq_setup_freqs_table(policy,
 						    opp_tbl_info->opp_tbl, opp_tbl_info->size);
+		if (!ret)
+			_mt_cpufreq_register_energy(p, id);
 
 		policy->cpuinfo.max_freq = cpu_dvfs_get_max_freq(id_to_cpu_dvfs(id));
 		policy->cpuinfo.min_freq = cpu_dvfs_get_min_freq(id_to_cpu_dvfs(id));
@@ -3032,6 +3225,9 @@ static struct freq_attr *_mt_cpufreq_attr[] = {
 static struct cpufreq_driver _mt_cpufreq_driver = {
 	.verify = _mt_cpufreq_verify,
 	.target = _mt_cpufreq_target,
+#ifdef CONFIG_HYBRID_CPU_DVFS
+	.fast_switch = _mt_cpufreq_fast_switch,
+#endif
 	.init = _mt_cpufreq_init,
 	.exit = _mt_cpufreq_exit,
 	.get = _mt_cpufreq_get,
@@ -3200,6 +3396,7 @@ static int _mt_cpufreq_pdrv_probe(struct platform_device *pdev)
 					p->ops->get_cur_volt = get_cur_volt_hybrid;
 			}
 
+			cpuhvfs_register_dvfs_notify(cpuhvfs_dvfs_done);
 			register_syscore_ops(&_mt_cpufreq_syscore_ops);
 		} else {
 			enable_cpuhvfs = 0;
@@ -3614,6 +3811,31 @@ static ssize_t enable_cpuhvfs_proc_write(struct file *file, const char __user *u
 
 	return count;
 }
+
+static int async_cpuhvfs_proc_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "%u\n", async_cpuhvfs);
+
+	return 0;
+}
+
+static ssize_t async_cpuhvfs_proc_write(struct file *file, const char __user *ubuf, size_t count,
+					loff_t *ppos)
+{
+	int r;
+	unsigned int val;
+	unsigned long flags;
+
+	r = kstrtouint_from_user(ubuf, count, 0, &val);
+	if (r)
+		return -EINVAL;
+
+	cpufreq_lock(flags);
+	async_cpuhvfs = !!val;
+	cpufreq_unlock(flags);
+
+	return count;
+}
 #endif
 
 /* cpufreq_ptpod_freq_volt */
@@ -3908,6 +4130,7 @@ PROC_FOPS_RW(cpufreq_stress_test);
 PROC_FOPS_RW(cpufreq_power_mode);
 #ifdef CONFIG_HYBRID_CPU_DVFS
 PROC_FOPS_RW(enable_cpuhvfs);
+PROC_FOPS_RW(async_cpuhvfs);
 #endif
 PROC_FOPS_RO(cpufreq_ptpod_freq_volt);
 PROC_FOPS_RW(cpufreq_oppidx);
@@ -3934,6 +4157,7 @@ static int _create_procfs(void)
 		PROC_ENTRY(cpufreq_power_mode),
 #ifdef CONFIG_HYBRID_CPU_DVFS
 		PROC_ENTRY(enable_cpuhvfs),
+		PROC_ENTRY(async_cpuhvfs),
 #endif
 	};
 
@@ -9,6 +9,7 @@
 #include <linux/debugfs.h>
 #include <linux/delay.h>
 #include <linux/wait.h>
+#include <linux/hrtimer.h>
 
 #include <mt-plat/sync_write.h>
 #include <mt-plat/mt_lpae.h>
@@ -45,6 +46,7 @@
 #define OFFS_LOG_E		0xf70
 
 #define DVFS_TIMEOUT		3000		/* us */
+#define DVFS_POLL_INTV		20		/* us */
 #define SEMA_GET_TIMEOUT	1500		/* us */
 #define PAUSE_TIMEOUT		1500		/* us */
 
@@ -373,6 +375,7 @@ struct cpuhvfs_dvfsp {
 
 	int (*set_target)(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster, unsigned int index,
 			  unsigned int *ret_volt);
+	int (*post_target)(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster, unsigned int index);
 	unsigned int (*get_volt)(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster);
 
 	int (*get_sema)(struct cpuhvfs_dvfsp *dvfsp, enum sema_user user);
@@ -452,6 +455,29 @@ static DEFINE_SPINLOCK(dvfs_lock);
 
 static DECLARE_WAIT_QUEUE_HEAD(dvfs_wait);
 
+/**
+ * Asynchronous OPP post of a cluster
+ * @index, @pending: latest request not handed over to FW yet (post_lock)
+ * @busy_index, @f_des, @busy, @start: request FW is working on (dvfs_lock)
+ */
+struct dvfs_post {
+	unsigned int index;
+	bool pending;
+
+	unsigned int busy_index;
+	u32 f_des;
+	bool busy;
+	ktime_t start;
+
+	struct hrtimer timer;	/* completion polling */
+};
+
+static struct dvfs_post dvfs_post[NUM_CPU_CLUSTER];
+
+static DEFINE_SPINLOCK(post_lock);
+
+static cpuhvfs_notify_t dvfs_notify;
+
 static int cspm_module_init(struct cpuhvfs_dvfsp *dvfsp);
 static int cspm_go_to_dvfs(struct cpuhvfs_dvfsp *dvfsp, struct init_sta *sta);
 static bool cspm_is_pcm_kicked(struct cpuhvfs_dvfsp *dvfsp);
@@ -461,7 +487,9 @@ static void cspm_cluster_notify_off(struct cpuhvfs_dvfsp *dvfsp, unsigned int cl
 
 static int cspm_set_target_opp(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster, unsigned int index,
 			       unsigned int *ret_volt);
+static int cspm_post_target_opp(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster, unsigned int index);
 static unsigned int cspm_get_curr_volt(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster);
+static void __cspm_start_posted_opp(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster);
 
 static int cspm_get_semaphore(struct cpuhvfs_dvfsp *dvfsp, enum sema_user user);
 static void cspm_release_semaphore(struct cpuhvfs_dvfsp *dvfsp, enum sema_user user);
@@ -489,6 +517,7 @@ static struct cpuhvfs_dvfsp g_dvfsp = {
 	.cluster_off	= cspm_cluster_notify_off,
 
 	.set_target	= cspm_set_target_opp,
+	.post_target	= cspm_post_target_opp,
 	.get_volt	= cspm_get_curr_volt,
 
 	.get_sema	= cspm_get_semaphore,
@@ -892,7 +921,7 @@ static int __cspm_pause_pcm_running(struct cpuhvfs_dvfsp *dvfsp, u32 psf)
 
 static void __cspm_unpause_pcm_to_run(struct cpuhvfs_dvfsp *dvfsp, u32 psf)
 {
-	int r;
+	int r, i;
 	u32 rsv4;
 
 	/* @dvfsp may be uninitialized (PAUSE_INIT is set) */
@@ -918,6 +947,9 @@ static void __cspm_unpause_pcm_to_run(struct cpuhvfs_dvfsp *dvfsp, u32 psf)
 
 			wake_up(&dvfs_wait);	/* for set_target_opp */
 			csram_write(OFFS_DVFS_WAIT, 0);
+
+			for (i = 0; i < NUM_CPU_CLUSTER; i++)
+				__cspm_start_posted_opp(dvfsp, i);	/* for post_target_opp */
 		} else {
 			cspm_err("FAILED TO ENABLE I2C CLOCK (%d)\n", r);
 			BUG();
@@ -1047,6 +1079,8 @@ static int cspm_set_target_opp(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster
 		spin_lock(&dvfs_lock);
 	}
 
+	dvfs_post[cluster].busy = false;	/* superseded by this request */
+
 	rsv4 = cspm_read(CSPM_SW_RSV4);
 	csram_write(OFFS_SW_RSV4, rsv4);
 
@@ -1107,6 +1141,159 @@ static unsigned int cspm_get_curr_volt(struct cpuhvfs_dvfsp *dvfsp, unsigned int
 	return UINT_MAX;
 }
 
+static u32 __cspm_get_curr_freq(unsigned int cluster)
+{
+	switch (cluster) {
+	case CPU_CLUSTER_LL:
+		return cspm_get_curr_freq_ll();
+	case CPU_CLUSTER_L:
+	default:
+		return cspm_get_curr_freq_l();
+	}
+}
+
+static void __cspm_notify_posted_done(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster,
+				      unsigned int index)
+{
+	cpuhvfs_notify_t notify = ACCESS_ONCE(dvfs_notify);
+
+	if (notify)
+		notify(cluster, index, cspm_get_curr_volt(dvfsp, cluster));
+}
+
+/**
+ * Hand the latest posted OPP of @cluster over to FW if FW is idle for it.
+ * Must hold dvfs_lock. The polling timer is (re)armed for completion.
+ */
+static void __cspm_start_posted_opp(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster)
+{
+	struct dvfs_post *post = &dvfs_post[cluster];
+	unsigned long flags;
+	unsigned int index;
+	u32 f_des, rsv4;
+	bool is_off;
+
+	if (post->busy || pause_src_map != 0)
+		return;		/* completion or unpause will come back here */
+
+	spin_lock_irqsave(&post_lock, flags);
+	if (!post->pending) {
+		spin_unlock_irqrestore(&post_lock, flags);
+		return;
+	}
+	index = post->index;
+	post->pending = false;
+	spin_unlock_irqrestore(&post_lock, flags);
+
+	f_des = opp_sw_to_fw(index);
+	csram_write(OFFS_FUNC_ENTER, (cluster << 24) | (index << 16) | FEF_DVFS);
+
+	cspm_dbgx(DVFS, "cluster%u dvfs post, opp = (%u, %u)\n", cluster, index, f_des);
+
+	rsv4 = cspm_read(CSPM_SW_RSV4);
+	csram_write(OFFS_SW_RSV4, rsv4);
+
+	switch (cluster) {
+	case CPU_CLUSTER_LL:
+		is_off = !!(rsv4 & SW_L_PAUSE);
+		if (!is_off) {
+			rsv4 &= ~SW_L_F_DES_MASK;
+			cspm_write(CSPM_SW_RSV4, rsv4 | SW_L_F_ASSIGN | SW_L_F_DES(f_des));
+			csram_write(OFFS_SW_RSV4, cspm_read(CSPM_SW_RSV4));
+		}
+		break;
+	case CPU_CLUSTER_L:
+	default:
+		is_off = !!(rsv4 & SW_B_PAUSE);
+		if (!is_off) {
+			rsv4 &= ~SW_B_F_DES_MASK;
+			cspm_write(CSPM_SW_RSV4, rsv4 | SW_B_F_ASSIGN | SW_B_F_DES(f_des));
+			csram_write(OFFS_SW_RSV4, cspm_read(CSPM_SW_RSV4));
+		}
+		break;
+	}
+
+	csram_write(OFFS_FUNC_ENTER, 0);
+
+	if (is_off) {	/* same as set_target_opp, nothing to wait for */
+		__cspm_notify_posted_done(dvfsp, cluster, index);
+		return;
+	}
+
+	post->busy_index = index;
+	post->f_des = f_des;
+	post->busy = true;
+	post->start = ktime_get();
+
+	hrtimer_start(&post->timer, ns_to_ktime(DVFS_POLL_INTV * NSEC_PER_USEC),
+		      HRTIMER_MODE_REL);
+}
+
+/**
+ * Runs in hard IRQ context. Never restarts itself by return value, all arming
+ * goes through hrtimer_start() so that posters on other CPUs can re-arm it.
+ */
+static enum hrtimer_restart cspm_post_timer_fn(struct hrtimer *timer)
+{
+	struct dvfs_post *post = container_of(timer, struct dvfs_post, timer);
+	unsigned int cluster = post - dvfs_post;
+	struct cpuhvfs_dvfsp *dvfsp = g_cpuhvfs.dvfsp;
+
+	if (!spin_trylock(&dvfs_lock)) {	/* sync DVFS or pause is ongoing */
+		hrtimer_start(timer, ns_to_ktime(DVFS_POLL_INTV * NSEC_PER_USEC),
+			      HRTIMER_MODE_REL);
+		return HRTIMER_NORESTART;
+	}
+
+	if (post->busy) {
+		if (__cspm_get_curr_freq(cluster) == post->f_des) {
+			post->busy = false;
+			csram_write_fw_sta();
+
+			__cspm_notify_posted_done(dvfsp, cluster, post->busy_index);
+		} else if (ktime_us_delta(ktime_get(), post->start) > DVFS_TIMEOUT) {
+			post->busy = false;
+
+			cspm_dump_debug_info(dvfsp, "CLUSTER%u DVFS POST TIMEOUT, opp = (%u, %u)",
+						    cluster, post->busy_index, post->f_des);
+			BUG_ON(dvfs_fail_ke);
+		} else {
+			hrtimer_start(timer, ns_to_ktime(DVFS_POLL_INTV * NSEC_PER_USEC),
+				      HRTIMER_MODE_REL);
+		}
+	}
+
+	__cspm_start_posted_opp(dvfsp, cluster);
+	spin_unlock(&dvfs_lock);
+
+	return HRTIMER_NORESTART;
+}
+
+/**
+ * Never sleeps or spins on FW: a newer post of the same cluster replaces an
+ * older one that FW has not started yet.
+ */
+static int cspm_post_target_opp(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster, unsigned int index)
+{
+	struct dvfs_post *post = &dvfs_post[cluster];
+	unsigned long flags;
+
+	spin_lock_irqsave(&post_lock, flags);
+	post->index = index;
+	post->pending = true;
+	spin_unlock_irqrestore(&post_lock, flags);
+
+	if (spin_trylock(&dvfs_lock)) {
+		__cspm_start_posted_opp(dvfsp, cluster);
+		spin_unlock(&dvfs_lock);
+	} else {	/* let the timer retry after the lock holder */
+		hrtimer_start(&post->timer, ns_to_ktime(DVFS_POLL_INTV * NSEC_PER_USEC),
+			      HRTIMER_MODE_REL);
+	}
+
+	return 0;
+}
+
 static void cspm_cluster_notify_on(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster)
 {
 	u32 time, rsv4;
@@ -1150,11 +1337,17 @@ static void cspm_cluster_notify_on(struct cpuhvfs_dvfsp *dvfsp, unsigned int clu
 static void cspm_cluster_notify_off(struct cpuhvfs_dvfsp *dvfsp, unsigned int cluster)
 {
 	int r;
+	unsigned long flags;
 	u32 time, rsv4;
 
 	spin_lock(&dvfs_lock);
 	csram_write(OFFS_FUNC_ENTER, (cluster << 24) | FEF_CLUSTER_OFF);
 
+	spin_lock_irqsave(&post_lock, flags);
+	dvfs_post[cluster].pending = false;	/* re-posted after cluster on */
+	spin_unlock_irqrestore(&post_lock, flags);
+	dvfs_post[cluster].busy = false;
+
 	time = cspm_get_timestamp();
 	rsv4 = cspm_read(CSPM_SW_RSV4);
 	csram_write(OFFS_SW_RSV4, rsv4);
@@ -1324,7 +1517,12 @@ static struct platform_driver cspm_driver = {
 
 static int cspm_module_init(struct cpuhvfs_dvfsp *dvfsp)
 {
-	int r;
+	int r, i;
+
+	for (i = 0; i < NUM_CPU_CLUSTER; i++) {
+		hrtimer_init(&dvfs_post[i].timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+		dvfs_post[i].timer.function = cspm_post_timer_fn;
+	}
 
 	r = platform_driver_register(&cspm_driver);
 	if (r) {
@@ -1624,6 +1822,32 @@ int cpuhvfs_set_target_opp(unsigned int cluster, unsigned int index, unsigned in
 	return dvfsp->set_target(dvfsp, cluster, index, ret_volt);
 }
 
+/**
+ * Post @index to DVFSP and return without waiting for it, safe from atomic
+ * (scheduler) context. Completion is reported through the notify callback
+ * registered by cpuhvfs_register_dvfs_notify(), from hard IRQ context
+ */
+int cpuhvfs_post_target_opp(unsigned int cluster, unsigned int index)
+{
+	struct cpuhvfs_dvfsp *dvfsp = g_cpuhvfs.dvfsp;
+
+	if (cluster >= NUM_CPU_CLUSTER || index >= NUM_CPU_OPP)
+		return -EINVAL;
+
+	if (is_dvfsp_uninit(dvfsp))
+		return -ENODEV;
+
+	if (!dvfsp->is_kicked(dvfsp))
+		return -EPERM;
+
+	return dvfsp->post_target(dvfsp, cluster, index);
+}
+
+void cpuhvfs_register_dvfs_notify(cpuhvfs_notify_t notify)
+{
+	ACCESS_ONCE(dvfs_notify) = notify;
+}
+
 /**
  * Get current voltage (PMIC value) from DVFSP. Return UINT_MAX if unavailable
  */
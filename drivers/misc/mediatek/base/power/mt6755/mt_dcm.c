@@ -4,6 +4,7 @@
 #include <linux/kernel.h>
 #include <linux/cpumask.h>
 #include <linux/cpu.h>
+#include <linux/sched.h>
 #include <asm/bug.h>
 #include <mt-plat/mt_io.h>
 #include <mt-plat/sync_write.h>
@@ -1516,7 +1517,226 @@ void dcm_dump_regs(void)
 }
 
 
+/*
+ * Bandwidth driven DCM tuning.
+ *
+ * The golden setting above has to suit the busiest use case. When the EMI
+ * bandwidth monitor reports little traffic for dcm_auto_samples samples in
+ * a row, the bus domains in dcm_auto_mask are switched to their most
+ * aggressive setting: the shortest infra/peri idle debounce and EMI DCM on.
+ * Traffic above dcm_auto_high_mbps or MM traffic above dcm_auto_mm_mbps
+ * (display/camera/video, which can not take the extra wake-up latency)
+ * switches back at once. A domain that is disabled through dcm_disable()
+ * or set off is left alone.
+ */
+#define DCM_AUTO_TYPE	(INFRA_DCM_TYPE | PERI_DCM_TYPE | EMI_DCM_TYPE)
+#define DCM_DBC_MASK	(0x1f << 15)
+#define DCM_AUTO_LOG	16
+
+static int dcm_auto_enable;
+static unsigned int dcm_auto_mask = DCM_AUTO_TYPE;
+static unsigned int dcm_auto_low_mbps = 300;
+static unsigned int dcm_auto_high_mbps = 800;
+static unsigned int dcm_auto_mm_mbps = 200;
+static unsigned int dcm_auto_samples = 4;
+static unsigned int dcm_auto_dbc = 1;
+module_param(dcm_auto_mask, uint, 0644);
+module_param(dcm_auto_low_mbps, uint, 0644);
+module_param(dcm_auto_high_mbps, uint, 0644);
+module_param(dcm_auto_mm_mbps, uint, 0644);
+module_param(dcm_auto_samples, uint, 0644);
+module_param(dcm_auto_dbc, uint, 0644);
+
+static struct {
+	bool aggressive;
+	unsigned int types;		/* domains switched */
+	unsigned int calm;
+	unsigned long long since_ns;
+	unsigned long long time_ms[2];	/* residency, golden / aggressive */
+	/* golden fields saved on the way in */
+	unsigned int infra_dbc;
+	unsigned int peri_dbc;
+	unsigned int emi_conm;
+} dcm_auto;
+
+static struct dcm_auto_log {
+	unsigned long long ts_ns;
+	bool aggressive;
+	unsigned int types;
+	unsigned int total_mbps;
+	unsigned int mm_mbps;
+} dcm_auto_log[DCM_AUTO_LOG];
+static unsigned int dcm_auto_log_idx;
+
+static bool dcm_auto_usable(unsigned int type)
+{
+	int i;
+
+	for (i = 0; i < NR_DCM_TYPE; i++) {
+		if (dcm_array[i].typeid == type)
+			return !dcm_array[i].disable_refcnt &&
+				dcm_array[i].current_state != DCM_OFF;
+	}
+	return false;
+}
+
+/* dcm_lock held */
+static void dcm_auto_switch(bool aggressive, unsigned int total_mbps,
+			    unsigned int mm_mbps)
+{
+	unsigned long long now = sched_clock();
+	struct dcm_auto_log *log;
+	unsigned int types;
+
+	if (aggressive == dcm_auto.aggressive)
+		return;
+
+	if (aggressive) {
+		types = 0;
+		if ((dcm_auto_mask & INFRA_DCM_TYPE) && dcm_auto_usable(INFRA_DCM_TYPE)) {
+			dcm_auto.infra_dbc = reg_read(INFRA_BUS_DCM_CTRL) & DCM_DBC_MASK;
+			dcm_infra_dbc(dcm_auto_dbc & 0x1f);
+			types |= INFRA_DCM_TYPE;
+		}
+		if ((dcm_auto_mask & PERI_DCM_TYPE) && dcm_auto_usable(PERI_DCM_TYPE)) {
+			dcm_auto.peri_dbc = reg_read(PERI_BUS_DCM_CTRL) & DCM_DBC_MASK;
+			dcm_peri_dbc(dcm_auto_dbc & 0x1f);
+			types |= PERI_DCM_TYPE;
+		}
+		if ((dcm_auto_mask & EMI_DCM_TYPE) && dcm_auto_usable(EMI_DCM_TYPE)) {
+			dcm_auto.emi_conm = reg_read(EMI_CONM) & EMI_CONM_MASK;
+			dcm_emi(EMI_DCM_ON);
+			types |= EMI_DCM_TYPE;
+		}
+		dcm_auto.types = types;
+	} else {
+		types = dcm_auto.types;
+		if (types & INFRA_DCM_TYPE)
+			reg_write(INFRA_BUS_DCM_CTRL, aor(reg_read(INFRA_BUS_DCM_CTRL),
+							 ~DCM_DBC_MASK, dcm_auto.infra_dbc));
+		if (types & PERI_DCM_TYPE)
+			reg_write(PERI_BUS_DCM_CTRL, aor(reg_read(PERI_BUS_DCM_CTRL),
+							~DCM_DBC_MASK, dcm_auto.peri_dbc));
+		if (types & EMI_DCM_TYPE)
+			reg_write(EMI_CONM, aor(reg_read(EMI_CONM), ~EMI_CONM_MASK,
+						dcm_auto.emi_conm));
+		dcm_auto.types = 0;
+	}
+
+	if (dcm_auto.since_ns)
+		dcm_auto.time_ms[dcm_auto.aggressive] += div_u64(now - dcm_auto.since_ns, NSEC_PER_MSEC);
+	dcm_auto.since_ns = now;
+	dcm_auto.aggressive = aggressive;
+
+	log = &dcm_auto_log[dcm_auto_log_idx++ % DCM_AUTO_LOG];
+	log->ts_ns = now;
+	log->aggressive = aggressive;
+	log->types = types;
+	log->total_mbps = total_mbps;
+	log->mm_mbps = mm_mbps;
+}
+
+/*
+ * Called with every sample of the EMI bandwidth monitor, see mt_mem_bw.c.
+ */
+void mt_dcm_update_bw(unsigned int total_mbps, unsigned int mm_mbps)
+{
+	if (!dcm_initiated)
+		return;
+
+	mutex_lock(&dcm_lock);
+
+	if (!dcm_auto_enable) {
+		dcm_auto_switch(false, total_mbps, mm_mbps);
+	} else if (mm_mbps > dcm_auto_mm_mbps || total_mbps > dcm_auto_high_mbps) {
+		dcm_auto.calm = 0;
+		dcm_auto_switch(false, total_mbps, mm_mbps);
+	} else if (total_mbps < dcm_auto_low_mbps) {
+		if (++dcm_auto.calm >= dcm_auto_samples)
+			dcm_auto_switch(true, total_mbps, mm_mbps);
+	} else {
+		dcm_auto.calm = 0;
+	}
+
+	mutex_unlock(&dcm_lock);
+}
+EXPORT_SYMBOL(mt_dcm_update_bw);
+
+/* no more samples coming, go back to golden */
+void mt_dcm_stop_bw(void)
+{
+	if (!dcm_initiated)
+		return;
+
+	mutex_lock(&dcm_lock);
+	dcm_auto.calm = 0;
+	dcm_auto_switch(false, 0, 0);
+	mutex_unlock(&dcm_lock);
+}
+EXPORT_SYMBOL(mt_dcm_stop_bw);
+
 #if defined(CONFIG_PM)
+static ssize_t dcm_auto_show(struct kobject *kobj, struct kobj_attribute *attr,
+			     char *buf)
+{
+	unsigned long long time_ms[2];
+	char *p = buf;
+	int i;
+
+	mutex_lock(&dcm_lock);
+
+	time_ms[0] = dcm_auto.time_ms[0];
+	time_ms[1] = dcm_auto.time_ms[1];
+	if (dcm_auto.since_ns)
+		time_ms[dcm_auto.aggressive] += div_u64(sched_clock() - dcm_auto.since_ns,
+							NSEC_PER_MSEC);
+
+	p += sprintf(p, "enable: %d, aggressive: %d (0x%x)\n", dcm_auto_enable,
+		     dcm_auto.aggressive, dcm_auto.types);
+	p += sprintf(p, "time ms: golden %llu, aggressive %llu\n", time_ms[0], time_ms[1]);
+	p += sprintf(p, "%16s %10s %6s %10s %8s\n", "time_ns", "aggressive", "types",
+		     "total_mbps", "mm_mbps");
+	for (i = 0; i < DCM_AUTO_LOG; i++) {
+		struct dcm_auto_log *log = &dcm_auto_log[(dcm_auto_log_idx + i) % DCM_AUTO_LOG];
+
+		if (!log->ts_ns)
+			continue;
+		p += sprintf(p, "%16llu %10d %6x %10u %8u\n", log->ts_ns, log->aggressive,
+			     log->types, log->total_mbps, log->mm_mbps);
+	}
+
+	mutex_unlock(&dcm_lock);
+
+	return p - buf;
+}
+
+static ssize_t dcm_auto_store(struct kobject *kobj, struct kobj_attribute *attr,
+			      const char *buf, size_t n)
+{
+	int val;
+
+	if (kstrtoint(buf, 10, &val))
+		return -EINVAL;
+
+	mutex_lock(&dcm_lock);
+	dcm_auto_enable = !!val;
+	dcm_auto.calm = 0;
+	if (!dcm_auto_enable)
+		dcm_auto_switch(false, 0, 0);
+	mutex_unlock(&dcm_lock);
+
+	return n;
+}
+
+static struct kobj_attribute dcm_auto_attr = {
+	.attr = {
+		 .name = "dcm_auto",
+		 .mode = 0644,
+		 },
+	.show = dcm_auto_show,
+	.store = dcm_auto_store,
+};
+
 static ssize_t dcm_state_show(struct kobject *kobj, struct kobj_attribute *attr,
 			      char *buf)
 {
@@ -1700,6 +1920,9 @@ int mt_dcm_init(void)
 		err = sysfs_create_file(power_kobj, &dcm_state_attr.attr);
 		if (err)
 			dcm_err("[%s]: fail to create sysfs\n", __func__);
+		err = sysfs_create_file(power_kobj, &dcm_auto_attr.attr);
+		if (err)
+			dcm_err("[%s]: fail to create sysfs\n", __func__);
 	}
 
 #if defined(DCM_DEBUG_MON)
@@ -18,5 +18,8 @@ int sync_dcm_set_cci_freq(unsigned int cci);
 int sync_dcm_set_mp0_freq(unsigned int mp0);
 int sync_dcm_set_mp1_freq(unsigned int mp1);
 
+void mt_dcm_update_bw(unsigned int total_mbps, unsigned int mm_mbps);
+void mt_dcm_stop_bw(void);
+
 #endif /* #ifndef __MT_DCM_H__ */
 
@@ -1430,6 +1430,9 @@ unsigned int mt_gpufreq_target(unsigned int idx)
 {
 	/* unsigned long flags; */
 	unsigned int target_freq, target_volt, target_idx, target_OPPidx;
+#ifndef DISABLE_PBM_FEATURE
+	unsigned int emerg_khz;
+#endif
 
 	mutex_lock(&mt_gpufreq_lock);
 
@@ -1543,6 +1546,18 @@ unsigned int mt_gpufreq_target(unsigned int idx)
 				    mt_gpufreqs[mt_gpufreq_pbm_limited_index].gpufreq_khz);
 		}
 	}
+
+	/* PBM cap for a consumer peak until the limit above catches up */
+	emerg_khz = mt_pbm_get_emerg_gpu_khz();
+	if (emerg_khz && target_freq > emerg_khz) {
+		while (target_OPPidx < mt_gpufreqs_num - 1 &&
+		       mt_gpufreqs[target_OPPidx].gpufreq_khz > emerg_khz)
+			target_OPPidx++;
+		target_freq = mt_gpufreqs[target_OPPidx].gpufreq_khz;
+		target_volt = mt_gpufreqs[target_OPPidx].gpufreq_volt;
+		target_idx = mt_gpufreqs[target_OPPidx].gpufreq_idx;
+		gpufreq_dbg("Limit! PBM emergency gpu frequency %d\n", target_freq);
+	}
 #endif
 
 	/************************************************
@@ -12,6 +12,7 @@
 #include <linux/init.h>		/* module_init, module_exit */
 #include <linux/cpu.h>		/* cpu_up */
 #include <linux/kthread.h>	/* kthread_create */
+#include <linux/sched.h>	/* nr_running */
 #include <linux/wakelock.h>	/* wake_lock_init */
 #include <linux/delay.h>	/* msleep */
 #include <asm-generic/bug.h>	/* BUG_ON */
@@ -191,10 +192,12 @@ void hps_algo_amp(void)
 	int big_num_base, big_num_limit, big_num_online;
 	int target_root_cpu, state_tran_active;
 	struct hps_func_data hps_func;
+	unsigned long events;
 	/*
 	 * run algo or not by hps_ctxt.enabled
 	 */
 	if (!hps_ctxt.enabled) {
+		hps_ctxt.wake_up_by_event = 0;
 		atomic_set(&hps_ctxt.is_ondemand, 0);
 		return;
 	}
@@ -205,6 +208,7 @@ void hps_algo_amp(void)
 	mutex_lock(&hps_ctxt.lock);
 	hps_ctxt.action = ACTION_NONE;
 	atomic_set(&hps_ctxt.is_ondemand, 0);
+	events = xchg(&hps_ctxt.wake_up_by_event, 0);
 
 	/*
 	 * algo - get boundary
@@ -324,6 +328,48 @@ void hps_algo_amp(void)
 			hps_ctxt.action = ACTION_NONE;
 	}
 
+/* ALGO_EVENT_UP: */
+	/*
+	 * algo - event up
+	 * Woken by the scheduler: ramp up now from the instantaneous runqueue
+	 * length instead of waiting for up_times sampling windows to fill.
+	 */
+	if (events && (little_num_online + big_num_online) < num_possible_cpus()) {
+		val = nr_running();
+		if (val <= little_num_online + big_num_online)
+			val = little_num_online + big_num_online + 1;
+		if (val > num_possible_cpus())
+			val = num_possible_cpus();
+		target_little_cores = target_big_cores = 0;
+		val -= base_val;
+
+		hps_func.cores = val;
+		hps_func.action_LL = ACTION_UP_LITTLE;
+		hps_func.action_L = ACTION_UP_BIG;
+		hps_func.target_LL = hps_func.target_L = 0;
+		hps_cal_cores(&hps_func);
+		target_little_cores = hps_func.target_LL;
+		target_big_cores = hps_func.target_L;
+
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+		/* a heavy task is waiting for a big core, give it one */
+		if (test_bit(SCHED_NR_EVENT_HMP_UP, &events) && !big_num_online &&
+		    !big_num_base && !target_big_cores && big_num_limit) {
+			target_big_cores = 1;
+			set_bit(ACTION_UP_BIG, (unsigned long *)&hps_ctxt.action);
+		}
+#endif
+	}
+	if (hps_ctxt.action) {
+		target_little_cores += hps_ctxt.little_num_base_perf_serv;
+		target_big_cores += hps_ctxt.big_num_base_perf_serv;
+		if (!((little_num_online == target_little_cores)
+		      && (big_num_online == target_big_cores)))
+			goto ALGO_END_WITH_ACTION;
+		else
+			hps_ctxt.action = ACTION_NONE;
+	}
+
 /* ALGO_UP: */
 	/*
 	 * algo - cpu up
@@ -12,8 +12,10 @@
 #include <linux/init.h>		/* module_init, module_exit */
 #include <linux/cpu.h>		/* cpu_up */
 #include <linux/kthread.h>	/* kthread_create */
+#include <linux/sched.h>	/* sched_nr_event_register */
 #include <linux/wakelock.h>	/* wake_lock_init */
 #include <asm-generic/bug.h>	/* BUG_ON */
+#include <mt-plat/mt_timer_coalesce.h>	/* mt_ctimer_expires */
 
 /* local includes */
 #include "mt_hotplug_strategy_internal.h"
@@ -57,9 +59,12 @@ static ktime_t ktime;
 /*
  * hps timer callback
  */
+static DEFINE_MT_CTIMER_SRC(hps_ctimer_src, "hps", 10);
+
 static int _hps_timer_callback(unsigned long data)
 {
 	/*hps_warn("_hps_timer_callback\n"); */
+	mt_ctimer_fired(&hps_ctimer_src);
 	if (hps_ctxt.tsk_struct_ptr)
 		wake_up_process(hps_ctxt.tsk_struct_ptr);
 	return HRTIMER_NORESTART;
@@ -182,7 +187,8 @@ HPS_WAIT_EVENT:
 		} else if (hps_ctxt.periodical_by == HPS_PERIODICAL_BY_TIMER) {
 			if (atomic_read(&hps_ctxt.is_ondemand) == 0) {
 				mod_timer(&hps_ctxt.tmr_list,
-					  (jiffies + msecs_to_jiffies(HPS_TIMER_INTERVAL_MS)));
+					  mt_ctimer_expires(&hps_ctimer_src,
+						jiffies + msecs_to_jiffies(HPS_TIMER_INTERVAL_MS)));
 				set_current_state(TASK_INTERRUPTIBLE);
 				schedule();
 			}
@@ -203,9 +209,43 @@ HPS_WAIT_EVENT:
 	return 0;
 }
 
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+/*
+ * scheduler event callback, runs from irq_work context
+ */
+static void hps_sched_nr_event(unsigned long events)
+{
+	int bit;
+
+	if (!hps_ctxt.enabled || !hps_ctxt.event_enabled)
+		return;
+
+	for_each_set_bit(bit, &events, BITS_PER_LONG)
+		set_bit(bit, &hps_ctxt.wake_up_by_event);
+	hps_task_wakeup_nolock();
+}
+#endif
+
 /*============================================================================*/
 /* Gobal function definition */
 /*============================================================================*/
+/*
+ * event interface, call with hps_ctxt.lock held or before the task starts
+ */
+void hps_core_event_update(void)
+{
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+	int r;
+
+	r = sched_nr_event_register(hps_ctxt.event_enabled ? hps_sched_nr_event : NULL,
+				    hps_ctxt.event_rq_length);
+	if (r)
+		hps_error("sched_nr_event_register fail(%d)\n", r);
+#endif
+	if (!hps_ctxt.event_enabled)
+		hps_ctxt.wake_up_by_event = 0;
+}
+
 /*
  * hps task control interface
  */
@@ -329,6 +369,7 @@ int hps_core_init(void)
 	}
 
 	mt_ppm_register_client(PPM_CLIENT_HOTPLUG, &ppm_limit_callback);	/* register PPM callback */
+	hps_core_event_update();	/* register scheduler event callback */
 	return r;
 }
 
@@ -349,6 +390,9 @@ int hps_core_deinit(void)
 		if (r)
 			hps_error("hps hr timer delete error!\n");
 	}
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+	sched_nr_event_register(NULL, 0);
+#endif
 
 	hps_task_stop();
 	return r;
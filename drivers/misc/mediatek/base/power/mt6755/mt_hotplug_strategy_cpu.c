@@ -83,6 +83,9 @@ unsigned int num_online_little_cpus(void)
 	struct cpumask dst_cpumask;
 
 	cpumask_and(&dst_cpumask, &hps_ctxt.little_cpumask, cpu_online_mask);
+#ifdef CONFIG_CPU_ISOLATION
+	cpumask_andnot(&dst_cpumask, &dst_cpumask, cpu_isolate_mask);
+#endif
 	return cpumask_weight(&dst_cpumask);
 }
 
@@ -91,6 +94,9 @@ unsigned int num_online_big_cpus(void)
 	struct cpumask dst_cpumask;
 
 	cpumask_and(&dst_cpumask, &hps_ctxt.big_cpumask, cpu_online_mask);
+#ifdef CONFIG_CPU_ISOLATION
+	cpumask_andnot(&dst_cpumask, &dst_cpumask, cpu_isolate_mask);
+#endif
 	return cpumask_weight(&dst_cpumask);
 }
 
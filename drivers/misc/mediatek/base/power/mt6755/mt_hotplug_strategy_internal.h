@@ -51,6 +51,8 @@
 #define DEF_CPU_DOWN_THRESHOLD              (85)
 #define DEF_CPU_DOWN_TIMES                  (1)
 #define DEF_TLP_TIMES                       (1)
+#define EN_CPU_EVENT                        (1)
+#define DEF_CPU_EVENT_RQ_LENGTH             (3)
 
 #define EN_CPU_INPUT_BOOST                  (1)
 #define DEF_CPU_INPUT_BOOST_CPU_NUM         (2)
@@ -203,6 +205,8 @@ typedef struct hps_ctxt_struct {
 	unsigned int rush_boost_threshold;
 	unsigned int rush_boost_times;
 	unsigned int tlp_times;
+	unsigned int event_enabled;
+	unsigned int event_rq_length;
 
 	/* algo bound */
 	unsigned int little_num_base_perf_serv;
@@ -239,6 +243,8 @@ typedef struct hps_ctxt_struct {
 	/* For fast hotplug integration */
 	unsigned int wake_up_by_fasthotplug;
 	unsigned int root_cpu;
+	/* SCHED_NR_EVENT_* bits latched since the last algo run */
+	unsigned long wake_up_by_event;
 
 	/* algo action */
 	unsigned long action;
@@ -292,6 +298,7 @@ extern int hps_task_start(void);
 extern void hps_task_stop(void);
 extern void hps_task_wakeup_nolock(void);
 extern void hps_task_wakeup(void);
+extern void hps_core_event_update(void);
 
 /*
  * mt_hotplug_strategy_algo.c
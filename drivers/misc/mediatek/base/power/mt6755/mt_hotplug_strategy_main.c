@@ -113,6 +113,8 @@ hps_ctxt_t hps_ctxt = {
 	.rush_boost_threshold = DEF_CPU_RUSH_BOOST_THRESHOLD,
 	.rush_boost_times = DEF_CPU_RUSH_BOOST_TIMES,
 	.tlp_times = DEF_TLP_TIMES,
+	.event_enabled = EN_CPU_EVENT,
+	.event_rq_length = DEF_CPU_EVENT_RQ_LENGTH,
 
 	/* algo bound */
 	/* .little_num_base_perf_serv = 1, */
@@ -258,6 +260,8 @@ void hps_ctxt_print_algo_config(int toUart)
 		hps_warn("hps_ctxt.rush_boost_threshold: %u\n", hps_ctxt.rush_boost_threshold);
 		hps_warn("hps_ctxt.rush_boost_times: %u\n", hps_ctxt.rush_boost_times);
 		hps_warn("hps_ctxt.tlp_times: %u\n", hps_ctxt.tlp_times);
+		hps_warn("hps_ctxt.event_enabled: %u\n", hps_ctxt.event_enabled);
+		hps_warn("hps_ctxt.event_rq_length: %u\n", hps_ctxt.event_rq_length);
 	} else {
 		hps_debug("hps_ctxt.up_threshold: %u\n", hps_ctxt.up_threshold);
 		hps_debug("hps_ctxt.up_times: %u\n", hps_ctxt.up_times);
@@ -269,6 +273,8 @@ void hps_ctxt_print_algo_config(int toUart)
 		hps_debug("hps_ctxt.rush_boost_threshold: %u\n", hps_ctxt.rush_boost_threshold);
 		hps_debug("hps_ctxt.rush_boost_times: %u\n", hps_ctxt.rush_boost_times);
 		hps_debug("hps_ctxt.tlp_times: %u\n", hps_ctxt.tlp_times);
+		hps_debug("hps_ctxt.event_enabled: %u\n", hps_ctxt.event_enabled);
+		hps_debug("hps_ctxt.event_rq_length: %u\n", hps_ctxt.event_rq_length);
 	}
 }
 
@@ -78,6 +78,18 @@ static void reset_unlock_hps_ctxt(void)
 	mutex_unlock(&hps_ctxt.lock);
 }
 
+static void event_unlock_hps_ctxt(void)
+{
+	hps_core_event_update();
+	mutex_unlock(&hps_ctxt.lock);
+}
+
+static ssize_t hps_proc_uint_write_with_lock_event(struct file *file, const char __user *buffer,
+						   size_t count, loff_t *pos)
+{
+	return hps_proc_uint_write(file, buffer, count, pos, lock_hps_ctxt, event_unlock_hps_ctxt);
+}
+
 static ssize_t hps_proc_uint_write_with_lock(struct file *file, const char __user *buffer,
 					     size_t count, loff_t *pos)
 {
@@ -157,6 +169,8 @@ PROC_FOPS_RW_UINT(stats_dump_enabled, hps_ctxt.stats_dump_enabled, hps_proc_uint
 *                     - rush_boost_threshold
 *                     - rush_boost_times
 *                     - tlp_times
+*                     - event_enabled
+*                     - event_rq_length
 ***********************************************************/
 PROC_FOPS_RW_UINT(up_threshold, hps_ctxt.up_threshold, hps_proc_uint_write_with_lock_reset);
 PROC_FOPS_RW_UINT(up_times, hps_ctxt.up_times, hps_proc_uint_write_with_lock_reset);
@@ -169,6 +183,8 @@ PROC_FOPS_RW_UINT(rush_boost_threshold,
 		  hps_ctxt.rush_boost_threshold, hps_proc_uint_write_with_lock_reset);
 PROC_FOPS_RW_UINT(rush_boost_times, hps_ctxt.rush_boost_times, hps_proc_uint_write_with_lock_reset);
 PROC_FOPS_RW_UINT(tlp_times, hps_ctxt.tlp_times, hps_proc_uint_write_with_lock_reset);
+PROC_FOPS_RW_UINT(event_enabled, hps_ctxt.event_enabled, hps_proc_uint_write_with_lock_event);
+PROC_FOPS_RW_UINT(event_rq_length, hps_ctxt.event_rq_length, hps_proc_uint_write_with_lock_event);
 
 /***********************************************************
 * procfs callback - algo bound series
@@ -655,6 +671,8 @@ int hps_procfs_init(void)
 		PROC_ENTRY(rush_boost_threshold),
 		PROC_ENTRY(rush_boost_times),
 		PROC_ENTRY(tlp_times),
+		PROC_ENTRY(event_enabled),
+		PROC_ENTRY(event_rq_length),
 		PROC_ENTRY(num_base_perf_serv),
 		PROC_ENTRY(num_limit_thermal),
 		PROC_ENTRY(num_limit_low_battery),
@@ -97,6 +97,17 @@ struct governor_profile {
 	u32 perform_bw_hpm_threshold;
 	bool total_bw_enable;
 	bool perform_bw_enable;
+
+	/* demand mode, fed by the EMI monitor samples in mt_mem_bw */
+	bool bw_demand_enable;
+	bool bw_demand_dirty;
+	u32 bw_demand_kir_mask;
+	u32 bw_demand_lpm_mbps;
+	u32 bw_demand_hpm_mbps;
+	u32 bw_demand_hold;
+	u32 bw_demand_calm;
+	u32 bw_demand_mbps;
+	int bw_demand_opp;
 };
 
 static struct governor_profile governor_ctrl = {
@@ -118,6 +129,15 @@ static struct governor_profile governor_ctrl = {
 
 	.total_bw_enable = false,
 	.perform_bw_enable = false,
+
+	.bw_demand_enable = false,
+	/* scenarios that hold HPM for their whole duration */
+	.bw_demand_kir_mask = ((1 << KIR_MM_WFD) | (1 << KIR_MM_MHL) | (1 << KIR_OVL)),
+	/* LPDDR3 1333 peak is ~5300MB/s, HPM above half of it */
+	.bw_demand_lpm_mbps = 1800,
+	.bw_demand_hpm_mbps = 2600,
+	.bw_demand_hold = 10,
+	.bw_demand_opp = OPPI_UNREQ,
 };
 
 static struct opp_profile opp_table[] __nosavedata = {
@@ -144,6 +164,8 @@ static char *kicker_name[] = {
 	"KIR_PERF",
 	"KIR_SYSFS",
 	"KIR_SYSFS_N",
+	"KIR_BOOST",
+	"KIR_EMI_QOS",
 	"NUM_KICKER",
 	"KIR_LATE_INIT",
 	"KIR_SYSFSX",
@@ -591,6 +613,11 @@ char *vcorefs_get_dvfs_info(char *p)
 	p += sprintf(p, "[total_bw    ]: en = %d, lpm_thres = 0x%x, hpm_thres =0x%x\n",
 		     gvrctrl->total_bw_enable, gvrctrl->total_bw_lpm_threshold,
 		     gvrctrl->total_bw_hpm_threshold);
+	p += sprintf(p, "[bw_demand   ]: en = %d, lpm_mbps = %u, hpm_mbps = %u, kir_mask = 0x%x\n",
+		     gvrctrl->bw_demand_enable, gvrctrl->bw_demand_lpm_mbps,
+		     gvrctrl->bw_demand_hpm_mbps, gvrctrl->bw_demand_kir_mask);
+	p += sprintf(p, "[bw_demand   ]: mbps = %u, opp = %d\n",
+		     gvrctrl->bw_demand_mbps, gvrctrl->bw_demand_opp);
 	p += sprintf(p, "\n");
 	p = vcorefs_get_sram_debug_info(p);
 	p += sprintf(p, "[dvfs_latency_spec]: count=%d\n", dbg_ctrl->dvfs_latency_spec);
@@ -697,6 +724,20 @@ int vcorefs_set_perform_bw_threshold(u32 lpm_threshold, u32 hpm_threshold)
 	return 0;
 }
 
+int vcorefs_set_bw_demand_threshold(u32 lpm_mbps, u32 hpm_mbps)
+{
+	struct governor_profile *gvrctrl = &governor_ctrl;
+
+	if (lpm_mbps == 0 || lpm_mbps >= hpm_mbps)
+		return -1;
+
+	mutex_lock(&governor_mutex);
+	gvrctrl->bw_demand_lpm_mbps = lpm_mbps;
+	gvrctrl->bw_demand_hpm_mbps = hpm_mbps;
+	mutex_unlock(&governor_mutex);
+	return 0;
+}
+
 int vcorefs_release_hpm(int opp, int vcore, int ddr)
 {
 	int r = -1;
@@ -769,6 +810,10 @@ int governor_debug_store(const char *buf)
 			/* val1: lpm_threshold,
 			   val2: hpm_threshold */
 			vcorefs_set_total_bw_threshold(val, val2);
+		} else if (!strcmp(cmd, "bw_demand_threshold")) {
+			/* val1: lpm_mbps,
+			   val2: hpm_mbps */
+			vcorefs_set_bw_demand_threshold(val, val2);
 		} else {
 			r = -EPERM;
 		}
@@ -788,6 +833,10 @@ int governor_debug_store(const char *buf)
 			vcorefs_reload_spm_firmware(val);
 		else if (!strcmp(cmd, "dvfs_latency_spec"))
 			vcorefs_set_dvfs_latency_spec(val);
+		else if (!strcmp(cmd, "bw_demand"))
+			vcorefs_enable_bw_demand(val);
+		else if (!strcmp(cmd, "bw_demand_kir_mask"))
+			vcorefs_set_bw_demand_kir_mask(val);
 		else
 			r = -EPERM;
 	} else {
@@ -809,7 +858,8 @@ struct dvfs_func {
 static struct dvfs_func spm_dvfs_func_list[] = {
 	{spm_vcorefs_set_dvfs_hpm_force,
 	 (1 << KIR_MM_16MCAM | 1 << KIR_SDIO | 1 << KIR_SYSFS | 1 << KIR_PERF | 1 << KIR_OVL), "set hpm_force"},
-	{spm_vcorefs_set_dvfs_hpm, (1 << KIR_MM_WFD | 1 << KIR_MM_MHL | 1 << KIR_SYSFS_N),
+	{spm_vcorefs_set_dvfs_hpm, (1 << KIR_MM_WFD | 1 << KIR_MM_MHL | 1 << KIR_SYSFS_N | 1 << KIR_BOOST |
+	  1 << KIR_EMI_QOS),
 	 "set hpm"},
 	{vcorefs_release_hpm, (1 << KIR_LATE_INIT), "clear hpm_lpm_forced"},
 	{vcorefs_handle_kir_sysfsx_req,
@@ -852,7 +902,7 @@ int get_kicker_group_opp(int kicker, int group_id)
 	group_kickers = spm_dvfs_func_list[id].kicker_mask;
 	for (i = 0; i < NUM_KICKER; i++) {
 		if ((group_kickers & 1 << i) != 0) {
-			if (kicker_table[i] < 0)
+			if (kicker_table[i] < 0 || !vcorefs_kicker_is_floor(i))
 				continue;
 			if (kicker_table[i] < result_opp)
 				result_opp = kicker_table[i];
@@ -1251,6 +1301,92 @@ int vcorefs_enable_total_bw(bool enable)
 	return 0;
 }
 
+/*
+ * Bandwidth demand mode
+ *
+ * Kickers in bw_demand_kir_mask stop holding HPM by themselves, the OPP
+ * follows the bandwidth measured by the EMI monitors (KIR_EMI_QOS) and the
+ * remaining kickers only act as floors. HPM is requested as soon as the
+ * demand crosses the hpm threshold and released after bw_demand_hold
+ * samples below the lpm threshold.
+ */
+bool vcorefs_kicker_is_floor(int kicker)
+{
+	struct governor_profile *gvrctrl = &governor_ctrl;
+
+	return !gvrctrl->bw_demand_enable || !(gvrctrl->bw_demand_kir_mask & (1U << kicker));
+}
+
+int vcorefs_enable_bw_demand(bool enable)
+{
+	struct governor_profile *gvrctrl = &governor_ctrl;
+
+	mutex_lock(&governor_mutex);
+	gvrctrl->bw_demand_enable = enable;
+	/* re-evaluate the kicker table on the next sample */
+	gvrctrl->bw_demand_dirty = true;
+	mutex_unlock(&governor_mutex);
+	return 0;
+}
+
+int vcorefs_set_bw_demand_kir_mask(u32 mask)
+{
+	struct governor_profile *gvrctrl = &governor_ctrl;
+
+	mutex_lock(&governor_mutex);
+	gvrctrl->bw_demand_kir_mask = mask & ((1U << NUM_KICKER) - 1) & ~(1U << KIR_EMI_QOS);
+	gvrctrl->bw_demand_dirty = true;
+	mutex_unlock(&governor_mutex);
+	return 0;
+}
+
+void vcorefs_update_bw_demand(u32 mbps, u32 page_hit_pct)
+{
+	struct governor_profile *gvrctrl = &governor_ctrl;
+	u32 demand;
+	int opp;
+	bool kick;
+
+	/* page misses cost DRAM cycles, count them as extra demand */
+	demand = mbps * (200 - min_t(u32, page_hit_pct, 100)) / 100;
+
+	mutex_lock(&governor_mutex);
+	gvrctrl->bw_demand_mbps = demand;
+	opp = gvrctrl->bw_demand_opp;
+	if (demand > gvrctrl->bw_demand_hpm_mbps) {
+		gvrctrl->bw_demand_calm = 0;
+		opp = OPPI_PERF;
+	} else if (demand < gvrctrl->bw_demand_lpm_mbps) {
+		if (++gvrctrl->bw_demand_calm >= gvrctrl->bw_demand_hold)
+			opp = OPPI_UNREQ;
+	} else {
+		gvrctrl->bw_demand_calm = 0;
+	}
+	kick = (opp != gvrctrl->bw_demand_opp) || gvrctrl->bw_demand_dirty;
+	gvrctrl->bw_demand_opp = opp;
+	gvrctrl->bw_demand_dirty = false;
+	mutex_unlock(&governor_mutex);
+
+	if (kick)
+		vcorefs_request_dvfs_opp(KIR_EMI_QOS, opp);
+}
+
+void vcorefs_stop_bw_demand(void)
+{
+	struct governor_profile *gvrctrl = &governor_ctrl;
+	bool kick;
+
+	mutex_lock(&governor_mutex);
+	kick = (gvrctrl->bw_demand_opp != OPPI_UNREQ);
+	gvrctrl->bw_demand_opp = OPPI_UNREQ;
+	gvrctrl->bw_demand_calm = 0;
+	gvrctrl->bw_demand_mbps = 0;
+	mutex_unlock(&governor_mutex);
+
+	if (kick)
+		vcorefs_request_dvfs_opp(KIR_EMI_QOS, OPPI_UNREQ);
+}
+
 /*
  * AutoK related API
  */
@@ -56,6 +56,8 @@ enum dvfs_kicker {
 	KIR_PERF,
 	KIR_SYSFS,
 	KIR_SYSFS_N,
+	KIR_BOOST,
+	KIR_EMI_QOS,
 	NUM_KICKER,
 
 	/* internal kicker */
@@ -157,6 +159,14 @@ extern int vcorefs_set_total_bw_threshold(u32 lpm_threshold, u32 hpm_threshold);
 extern int vcorefs_enable_perform_bw(bool enable);
 extern int vcorefs_enable_total_bw(bool enable);
 
+/* bandwidth demand mode */
+extern bool vcorefs_kicker_is_floor(int kicker);
+extern int vcorefs_enable_bw_demand(bool enable);
+extern int vcorefs_set_bw_demand_threshold(u32 lpm_mbps, u32 hpm_mbps);
+extern int vcorefs_set_bw_demand_kir_mask(u32 mask);
+extern void vcorefs_update_bw_demand(u32 mbps, u32 page_hit_pct);
+extern void vcorefs_stop_bw_demand(void);
+
 /* screen size */
 extern unsigned int DISP_GetScreenWidth(void);
 extern unsigned int DISP_GetScreenHeight(void);
@@ -117,7 +117,7 @@ static int _get_dvfs_opp(struct vcorefs_profile *pwrctrl)
 	vcorefs_info("kr opp: %s\n", table);
 
 	for (i = 0; i < NUM_KICKER; i++) {
-		if (kicker_table[i] < 0)
+		if (kicker_table[i] < 0 || !vcorefs_kicker_is_floor(i))
 			continue;
 
 		if (kicker_table[i] < opp)
@@ -133,8 +133,11 @@ static int _get_dvfs_opp(struct vcorefs_profile *pwrctrl)
 
 static int kicker_request_compare(enum dvfs_kicker kicker, enum dvfs_opp opp)
 {
-	/* compare kicker table opp with request opp (except SYSFS) */
-	if (opp == kicker_table[kicker] && kicker != KIR_SYSFS) {
+	/*
+	 * compare kicker table opp with request opp (except SYSFS, and
+	 * EMI_QOS which re-kicks when the bandwidth demand mode changes)
+	 */
+	if (opp == kicker_table[kicker] && kicker != KIR_SYSFS && kicker != KIR_EMI_QOS) {
 		/* try again since previous change is partial success */
 		if (vcorefs_curr_opp == vcorefs_prev_opp) {
 			vcorefs_err("opp no change, kr_tb: %d, kr: %d, opp: %d\n",
@@ -16,6 +16,8 @@
 #include <linux/vmalloc.h>
 #include <linux/suspend.h>
 #include <linux/proc_fs.h>
+#include <linux/spinlock.h>
+#include <linux/jiffies.h>
 
 #include <mach/mt_pbm.h>
 #include <mach/upmu_sw.h>
@@ -188,6 +190,41 @@ static DEFINE_MUTEX(pbm_mutex);
 static DEFINE_MUTEX(pbm_table_lock);
 static struct task_struct *pbm_thread;
 static atomic_t kthread_nreq = ATOMIC_INIT(0);
+
+/*
+ * Budget split priority of CPU and GPU. With equal priority the budget left
+ * after the fixed consumers is split in proportion to their requests, else
+ * the higher one is served first.
+ */
+static int pbm_prio_cpu;
+static int pbm_prio_gpu;
+
+/*
+ * Fast path for consumer peaks.
+ *
+ * The split runs in the pbm thread and reaches the CPU through PPM, which
+ * takes from a few ms to tens of ms. With pbm_fast set, a peak reported
+ * by a consumer (flash on, modem TX) is checked right away against the
+ * last split: the shortfall is taken from CPU and GPU, lowest priority
+ * first, and published as frequency caps that mt_cpufreq/mt_gpufreq apply
+ * on their next OPP choice. The caps go away when the peak ends, or after
+ * pbm_emerg_ms, by which time the pbm thread has redone the split.
+ */
+static int pbm_fast;
+static unsigned int pbm_emerg_ms = 100;
+
+static struct {
+	int leakage;
+	int cpu;		/* budget given to CPU and GPU by the last split */
+	int gpu;
+	int cpu_lower_bound;
+} pbm_alloc;
+
+static DEFINE_SPINLOCK(pbm_emerg_lock);
+static unsigned int pbm_emerg_cpu_khz[NR_MT_CPU_DVFS];
+static unsigned int pbm_emerg_gpu_khz;
+static unsigned long pbm_emerg_expires;
+static unsigned int pbm_emerg_count;
 /* extern u32 get_devinfo_with_index(u32 index); */
 
 /*
@@ -278,7 +315,9 @@ unsigned long hpf_get_power_flash(void)
 {
 	struct hpf *hpfmgr = &hpf_ctrl;
 
-	if (hpfmgr->switch_flash)
+	if (hpfmgr->demand_flash)
+		return hpfmgr->demand_flash;
+	else if (hpfmgr->switch_flash)
 		return hpfmgr->loading_flash;
 	else
 		return 0;
@@ -653,6 +692,8 @@ unsigned long hpf_get_power_md1(void)
 #endif
 
 	if (hpfmgr->switch_md1) {
+		if (hpfmgr->demand_md1)
+			return hpfmgr->demand_md1;
 #if MD_POWER_METER_ENABLE
 		if (!hpfmgr->md1_ccci_ready)
 			return MD1_MAX_PW;
@@ -686,6 +727,8 @@ unsigned long hpf_get_power_md3(void)
 #endif
 
 	if (hpfmgr->switch_md3) {
+		if (hpfmgr->demand_md3)
+			return hpfmgr->demand_md3;
 #if MD_POWER_METER_ENABLE
 		if (!hpfmgr->md3_ccci_ready)
 			return MD3_MAX_PW;
@@ -715,6 +758,7 @@ static void pbm_allocate_budget_manager(void)
 	int tocpu = 0, togpu = 0;
 	int multiple = 0;
 	int cpu_lower_bound = tscpu_get_min_cpu_pwr();
+	unsigned long flags;
 
 	mutex_lock(&pbm_table_lock);
 	/* dump_kicker_info(); */
@@ -749,6 +793,30 @@ static void pbm_allocate_budget_manager(void)
 			tocpu = 1;
 
 		mt_ppm_dlpt_set_limit_by_pbm(tocpu);
+	} else if (pbm_prio_cpu > pbm_prio_gpu) {
+		tocpu = min(cpu, _dlpt);
+		if (tocpu < cpu_lower_bound)
+			tocpu = cpu_lower_bound;
+		togpu = _dlpt - tocpu;
+
+		if (tocpu <= 0)
+			tocpu = 1;
+		if (togpu <= 0)
+			togpu = 1;
+
+		mt_ppm_dlpt_set_limit_by_pbm(tocpu);
+		mt_gpufreq_set_power_limit_by_pbm(togpu);
+	} else if (pbm_prio_gpu > pbm_prio_cpu) {
+		togpu = min(gpu, _dlpt - cpu_lower_bound);
+		tocpu = _dlpt - togpu;
+
+		if (tocpu <= 0)
+			tocpu = 1;
+		if (togpu <= 0)
+			togpu = 1;
+
+		mt_ppm_dlpt_set_limit_by_pbm(tocpu);
+		mt_gpufreq_set_power_limit_by_pbm(togpu);
 	} else {
 		multiple = (_dlpt * 1000) / (cpu + gpu);
 
@@ -775,6 +843,13 @@ static void pbm_allocate_budget_manager(void)
 		mt_gpufreq_set_power_limit_by_pbm(togpu);
 	}
 
+	spin_lock_irqsave(&pbm_emerg_lock, flags);
+	pbm_alloc.leakage = leakage;
+	pbm_alloc.cpu = tocpu;
+	pbm_alloc.gpu = togpu;
+	pbm_alloc.cpu_lower_bound = cpu_lower_bound;
+	spin_unlock_irqrestore(&pbm_emerg_lock, flags);
+
 	if (mt_pbm_debug) {
 		pbm_debug("(C/G)=%d,%d => (D/L/M1/M3/F/C/G)=%d,%d,%d,%d,%d,%d,%d (Multi:%d),%d\n",
 			 cpu, gpu, dlpt, leakage, md1, md3, flash, tocpu, togpu, multiple, cpu_lower_bound);
@@ -854,6 +929,107 @@ static bool pbm_update_table_info(enum pbm_kicker kicker, struct mrp *mrpmgr)
 	return is_update;
 }
 
+/* fixed consumer power from the cached values, no modem share memory access */
+static int pbm_fixed_power(void)
+{
+	struct hpf *hpfmgr = &hpf_ctrl;
+	int power = 0;
+
+	if (hpfmgr->switch_md1)
+		power += hpfmgr->demand_md1 ? hpfmgr->demand_md1 : hpfmgr->loading_md1;
+	if (hpfmgr->switch_md3)
+		power += hpfmgr->demand_md3 ? hpfmgr->demand_md3 : hpfmgr->loading_md3;
+
+	return power + hpf_get_power_flash();
+}
+
+static unsigned int pbm_emerg_cap(unsigned int khz, int budget, int shed)
+{
+	if (!shed || budget <= 0)
+		return 0;
+
+	/* power drops at least as fast as frequency, scale linearly */
+	return max_t(unsigned int, 1, (unsigned long long)khz * (budget - shed) / budget);
+}
+
+/*
+ * Check the last split against the fixed consumers as they are now and
+ * publish the caps covering the shortfall, or drop them if there is none.
+ */
+static void pbm_emerg_update(void)
+{
+	struct hpf *hpfmgr = &hpf_ctrl;
+	int need, room_cpu, room_gpu, shed_cpu = 0, shed_gpu = 0;
+	unsigned long flags;
+	int i;
+
+	if (!pbm_fast)
+		return;
+
+	spin_lock_irqsave(&pbm_emerg_lock, flags);
+
+	need = 0;
+	if (hpfmgr->loading_dlpt && pbm_alloc.cpu)
+		need = pbm_alloc.leakage + pbm_fixed_power() + pbm_alloc.cpu +
+			pbm_alloc.gpu - hpfmgr->loading_dlpt;
+
+	if (need > 0) {
+		room_cpu = max(pbm_alloc.cpu - pbm_alloc.cpu_lower_bound, 0);
+		room_gpu = max(pbm_alloc.gpu - 1, 0);
+
+		if (pbm_prio_cpu > pbm_prio_gpu) {
+			shed_gpu = min(need, room_gpu);
+			shed_cpu = min(need - shed_gpu, room_cpu);
+		} else if (pbm_prio_gpu > pbm_prio_cpu) {
+			shed_cpu = min(need, room_cpu);
+			shed_gpu = min(need - shed_cpu, room_gpu);
+		} else if (room_cpu + room_gpu) {
+			shed_cpu = min(need * room_cpu / (room_cpu + room_gpu), room_cpu);
+			shed_gpu = min(need - shed_cpu, room_gpu);
+		}
+	}
+
+	for (i = 0; i < NR_MT_CPU_DVFS; i++)
+		pbm_emerg_cpu_khz[i] = pbm_emerg_cap(shed_cpu ? mt_cpufreq_get_cur_phy_freq(i) : 0,
+						     pbm_alloc.cpu, shed_cpu);
+	pbm_emerg_gpu_khz = pbm_emerg_cap(shed_gpu ? mt_gpufreq_get_cur_freq() : 0,
+					  pbm_alloc.gpu, shed_gpu);
+	pbm_emerg_expires = jiffies + msecs_to_jiffies(pbm_emerg_ms);
+	if (shed_cpu || shed_gpu)
+		pbm_emerg_count++;
+
+	spin_unlock_irqrestore(&pbm_emerg_lock, flags);
+
+	if (shed_cpu || shed_gpu)
+		pbm_debug("emergency: need %d, shed (C/G)=%d,%d\n", need, shed_cpu, shed_gpu);
+}
+
+unsigned int mt_pbm_get_emerg_cpu_khz(int cluster)
+{
+	unsigned int khz;
+
+	if (cluster < 0 || cluster >= NR_MT_CPU_DVFS)
+		return 0;
+
+	khz = ACCESS_ONCE(pbm_emerg_cpu_khz[cluster]);
+	if (khz && time_after(jiffies, ACCESS_ONCE(pbm_emerg_expires)))
+		return 0;
+
+	return khz;
+}
+EXPORT_SYMBOL(mt_pbm_get_emerg_cpu_khz);
+
+unsigned int mt_pbm_get_emerg_gpu_khz(void)
+{
+	unsigned int khz = ACCESS_ONCE(pbm_emerg_gpu_khz);
+
+	if (khz && time_after(jiffies, ACCESS_ONCE(pbm_emerg_expires)))
+		return 0;
+
+	return khz;
+}
+EXPORT_SYMBOL(mt_pbm_get_emerg_gpu_khz);
+
 static void pbm_wake_up_thread(enum pbm_kicker kicker, struct mrp *mrpmgr)
 {
 	if (atomic_read(&kthread_nreq) <= 0) {
@@ -861,6 +1037,10 @@ static void pbm_wake_up_thread(enum pbm_kicker kicker, struct mrp *mrpmgr)
 		wake_up_process(pbm_thread);
 	}
 
+	/* with the fast path the caps already cover the flash */
+	if (pbm_fast)
+		return;
+
 	while (kicker == KR_FLASH && mrpmgr->switch_flash == 1) {
 		if (atomic_read(&kthread_nreq) == 0)
 			return;
@@ -882,6 +1062,9 @@ static void mtk_power_budget_manager(enum pbm_kicker kicker, struct mrp *mrpmgr)
 	if (!pbm_enable)
 		return;
 
+	if (kicker == KR_MD1 || kicker == KR_MD3 || kicker == KR_FLASH)
+		pbm_emerg_update();
+
 	pbm_wake_up_thread(kicker, mrpmgr);
 }
 
@@ -972,6 +1155,49 @@ void kicker_pbm_by_flash(bool status)
 		mtk_power_budget_manager(KR_FLASH, &mrpmgr);
 }
 
+/*
+ * kicker: 1, 2, 5
+ * who call : MD1, MD3, Flash
+ * mw: power drawn right now, 0 to go back to the estimate
+ * condition: start and end of a peak (TX burst, flash pulse), any context
+ */
+void kicker_pbm_by_demand(enum pbm_kicker kicker, unsigned int mw)
+{
+	struct pbm *pwrctrl = &pbm_ctrl;
+	struct hpf *hpfmgr = &hpf_ctrl;
+	unsigned long *demand;
+
+	switch (kicker) {
+	case KR_MD1:
+		demand = &hpfmgr->demand_md1;
+		break;
+	case KR_MD3:
+		demand = &hpfmgr->demand_md3;
+		break;
+	case KR_FLASH:
+		demand = &hpfmgr->demand_flash;
+		break;
+	default:
+		pbm_crit("[%s] ERROR, no demand from kicker [%d]\n", __func__, kicker);
+		return;
+	}
+
+	if (!BIT_CHECK(pwrctrl->hpf_en, kicker) || *demand == mw)
+		return;
+
+	ACCESS_ONCE(*demand) = mw;
+
+	if (!pwrctrl->feature_en || !pwrctrl->pbm_drv_done)
+		return;
+
+	pbm_emerg_update();
+	if (atomic_read(&kthread_nreq) <= 0) {
+		atomic_inc(&kthread_nreq);
+		wake_up_process(pbm_thread);
+	}
+}
+EXPORT_SYMBOL(kicker_pbm_by_demand);
+
 /* extern int g_dlpt_stop; in mt_pbm.h*/
 int g_dlpt_state_sync = 0;
 
@@ -1134,7 +1360,103 @@ static const struct file_operations mt_ ## name ## _proc_fops = {		\
 
 #define PROC_ENTRY(name)	{__stringify(name), &mt_ ## name ## _proc_fops}
 
+static int mt_pbm_fast_proc_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "%d %u\n", pbm_fast, pbm_emerg_ms);
+
+	return 0;
+}
+
+/*
+ * echo <enable> [caps lifetime ms] > /proc/pbm/pbm_fast
+ */
+static ssize_t mt_pbm_fast_proc_write(struct file *file, const char __user *buffer,
+				      size_t count, loff_t *data)
+{
+	char desc[32];
+	int len = 0;
+	int enable;
+	unsigned int ms;
+
+	len = (count < (sizeof(desc) - 1)) ? count : (sizeof(desc) - 1);
+	if (copy_from_user(desc, buffer, len))
+		return 0;
+	desc[len] = '\0';
+
+	switch (sscanf(desc, "%d %u", &enable, &ms)) {
+	case 2:
+		pbm_emerg_ms = ms;
+		/* fall through */
+	case 1:
+		pbm_fast = !!enable;
+		break;
+	default:
+		pbm_warn("bad argument!! should be <enable> [lifetime ms]\n");
+	}
+
+	return count;
+}
+
+static int mt_pbm_prio_proc_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "cpu %d gpu %d\n", pbm_prio_cpu, pbm_prio_gpu);
+
+	return 0;
+}
+
+/*
+ * echo <cpu prio> <gpu prio> > /proc/pbm/pbm_prio
+ */
+static ssize_t mt_pbm_prio_proc_write(struct file *file, const char __user *buffer,
+				      size_t count, loff_t *data)
+{
+	char desc[32];
+	int len = 0;
+	int cpu, gpu;
+
+	len = (count < (sizeof(desc) - 1)) ? count : (sizeof(desc) - 1);
+	if (copy_from_user(desc, buffer, len))
+		return 0;
+	desc[len] = '\0';
+
+	if (sscanf(desc, "%d %d", &cpu, &gpu) == 2) {
+		pbm_prio_cpu = cpu;
+		pbm_prio_gpu = gpu;
+	} else
+		pbm_warn("bad argument!! should be <cpu prio> <gpu prio>\n");
+
+	return count;
+}
+
+static int mt_pbm_state_proc_show(struct seq_file *m, void *v)
+{
+	struct hpf *hpfmgr = &hpf_ctrl;
+	unsigned long flags;
+	int i;
+
+	seq_printf(m, "dlpt %lu, md1 %lu/%lu, md3 %lu/%lu, flash %lu\n",
+		   hpfmgr->loading_dlpt,
+		   hpfmgr->switch_md1 ? hpfmgr->loading_md1 : 0, hpfmgr->demand_md1,
+		   hpfmgr->switch_md3 ? hpfmgr->loading_md3 : 0, hpfmgr->demand_md3,
+		   hpf_get_power_flash());
+
+	spin_lock_irqsave(&pbm_emerg_lock, flags);
+	seq_printf(m, "split: leakage %d, cpu %d (floor %d), gpu %d\n",
+		   pbm_alloc.leakage, pbm_alloc.cpu, pbm_alloc.cpu_lower_bound, pbm_alloc.gpu);
+	seq_printf(m, "emergency: %u times, caps", pbm_emerg_count);
+	spin_unlock_irqrestore(&pbm_emerg_lock, flags);
+
+	for (i = 0; i < NR_MT_CPU_DVFS; i++)
+		seq_printf(m, " cpu%d %u", i, mt_pbm_get_emerg_cpu_khz(i));
+	seq_printf(m, " gpu %u\n", mt_pbm_get_emerg_gpu_khz());
+
+	return 0;
+}
+
 PROC_FOPS_RW(pbm_debug);
+PROC_FOPS_RW(pbm_fast);
+PROC_FOPS_RW(pbm_prio);
+PROC_FOPS_RO(pbm_state);
 
 static int mt_pbm_create_procfs(void)
 {
@@ -1148,6 +1470,9 @@ static int mt_pbm_create_procfs(void)
 
 	const struct pentry entries[] = {
 		PROC_ENTRY(pbm_debug),
+		PROC_ENTRY(pbm_fast),
+		PROC_ENTRY(pbm_prio),
+		PROC_ENTRY(pbm_state),
 	};
 
 	dir = proc_mkdir("pbm", NULL);
@@ -1218,6 +1543,20 @@ void kicker_pbm_by_flash(bool status)
 {
 }
 
+void kicker_pbm_by_demand(enum pbm_kicker kicker, unsigned int mw)
+{
+}
+
+unsigned int mt_pbm_get_emerg_cpu_khz(int cluster)
+{
+	return 0;
+}
+
+unsigned int mt_pbm_get_emerg_gpu_khz(void)
+{
+	return 0;
+}
+
 void init_md_section_level(enum pbm_kicker kicker)
 {
 }
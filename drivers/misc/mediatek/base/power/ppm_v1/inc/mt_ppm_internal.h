@@ -16,6 +16,7 @@ extern "C" {
 #include <linux/seq_file.h>
 #include <linux/printk.h>
 #include <linux/sched.h>
+#include <linux/seqlock.h>
 
 #include "mach/mt_ppm_api.h"
 #include "mt_ppm_platform.h"
@@ -194,6 +195,8 @@ struct ppm_policy_data {
 	/* status */
 	bool is_enabled;
 	bool is_activated;
+	/* req.limit is up to date for cur_power_state, see mt_ppm_main() */
+	bool is_limit_valid;
 	/* lock */
 	struct mutex lock;
 	/* list link */
@@ -239,7 +242,9 @@ struct ppm_data {
 	struct ppm_cluster_info *cluster_info;
 	struct ppm_client_data client_info[NR_PPM_CLIENTS];
 	struct ppm_client_req client_req;
-	struct ppm_client_req last_req;	/* for debugging purpose */
+	struct ppm_client_req last_req;	/* limit last sent to clients */
+	seqcount_t last_req_seq;	/* lockless readers of last_req */
+	bool is_limit_dirty;		/* recompute all policies' limits */
 	struct list_head policy_list;
 	struct task_struct *ppm_task;
 	wait_queue_head_t ppm_wq;
@@ -366,6 +371,8 @@ extern void ppm_main_update_req_by_pwr(enum ppm_power_state new_state, struct pp
 extern int ppm_main_freq_to_idx(unsigned int cluster_id,
 					unsigned int freq, unsigned int relation);
 extern void ppm_task_wakeup(void);
+extern void ppm_task_wakeup_policy(struct ppm_policy_data *policy);
+extern void ppm_main_save_last_req(struct ppm_client_req *c_req);
 extern void ppm_main_clear_client_req(struct ppm_client_req *c_req);
 extern int ppm_main_register_policy(struct ppm_policy_data *policy);
 extern void ppm_main_unregister_policy(struct ppm_policy_data *policy);
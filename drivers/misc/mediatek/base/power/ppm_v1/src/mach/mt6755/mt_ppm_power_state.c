@@ -312,8 +312,12 @@ static bool ppm_trans_rule_LL_ONLY_to_L_ONLY(
 	if (ppm_lcmoff_is_policy_activated())
 		return false;
 
-	/* check loading */
-	if (data.ppm_cur_loads > (settings->loading_bond - settings->loading_delta)
+	/*
+	 * check loading; a heavy task (one the HMP scheduler would up-migrate)
+	 * counts as demand for the L cluster too
+	 */
+	if ((data.ppm_cur_loads > (settings->loading_bond - settings->loading_delta)
+		|| data.ppm_cur_nr_heavy_task)
 		&& data.ppm_cur_tlp <= settings->tlp_bond) {
 		settings->loading_hold_cnt++;
 		if (settings->loading_hold_cnt >= settings->loading_hold_time)
@@ -360,6 +364,12 @@ static bool ppm_trans_rule_L_ONLY_to_LL_ONLY(
 	if (ppm_main_info.fixed_root_cluster == 1)
 		return false;
 
+	/* keep in L_ONLY state while the HMP scheduler still has heavy tasks */
+	if (data.ppm_cur_nr_heavy_task) {
+		settings->freq_hold_cnt = 0;
+		return false;
+	}
+
 	cur_freq_L = mt_cpufreq_get_cur_phy_freq(MT_CPU_DVFS_BIG); /* FIXME */
 	ppm_dbg(HICA, "L cur freq = %d\n", cur_freq_L);
 
@@ -120,7 +120,6 @@ static ssize_t ppm_enabled_proc_write(struct file *file, const char __user *buff
 		if (!ppm_main_info.is_enabled) {
 			int i;
 			struct ppm_client_req *c_req = &(ppm_main_info.client_req);
-			struct ppm_client_req *last_req = &(ppm_main_info.last_req);
 
 			/* send default limit to client */
 			ppm_main_clear_client_req(c_req);
@@ -128,8 +127,7 @@ static ssize_t ppm_enabled_proc_write(struct file *file, const char __user *buff
 				if (ppm_main_info.client_info[i].limit_cb)
 					ppm_main_info.client_info[i].limit_cb(*c_req);
 			}
-			memcpy(last_req->cpu_limit, c_req->cpu_limit,
-				ppm_main_info.cluster_num * sizeof(*c_req->cpu_limit));
+			ppm_main_save_last_req(c_req);
 
 			ppm_info("send no limit to clinet since ppm is disabled!\n");
 		}
@@ -63,6 +63,8 @@ struct ppm_data ppm_main_info = {
 	},
 
 	.lock = __MUTEX_INITIALIZER(ppm_main_info.lock),
+	.last_req_seq = SEQCNT_ZERO(ppm_main_info.last_req_seq),
+	.is_limit_dirty = true,
 	.policy_list = LIST_HEAD_INIT(ppm_main_info.policy_list),
 	.ppm_task = NULL,
 	.ppm_wq = __WAIT_QUEUE_HEAD_INITIALIZER(ppm_main_info.ppm_wq),
@@ -165,10 +167,18 @@ void ppm_main_clear_client_req(struct ppm_client_req *c_req)
 	}
 }
 
+/*
+ * Every policy's update_limit_cb() is re-run on the next mt_ppm_main().
+ * For callers that do not say which policy changed.
+ */
 void ppm_task_wakeup(void)
 {
 	FUNC_ENTER(FUNC_LV_MAIN);
 
+	ppm_lock(&ppm_main_info.lock);
+	ppm_main_info.is_limit_dirty = true;
+	ppm_unlock(&ppm_main_info.lock);
+
 #if 0
 	ppm_lock(&ppm_main_info.lock);
 	if (ppm_main_info.ppm_task) {
@@ -183,6 +193,53 @@ void ppm_task_wakeup(void)
 	FUNC_EXIT(FUNC_LV_MAIN);
 }
 
+/*
+ * Only @policy's request changed: unless the power state changes too, the
+ * other policies keep the limits they computed last time and only @policy's
+ * update_limit_cb() runs. Meant for frequent updaters like perfserv.
+ */
+void ppm_task_wakeup_policy(struct ppm_policy_data *policy)
+{
+	FUNC_ENTER(FUNC_LV_MAIN);
+
+	ppm_lock(&ppm_main_info.lock);
+	policy->is_limit_valid = false;
+	ppm_unlock(&ppm_main_info.lock);
+
+	mt_ppm_main();
+
+	FUNC_EXIT(FUNC_LV_MAIN);
+}
+
+/* must hold ppm_main_info.lock */
+void ppm_main_save_last_req(struct ppm_client_req *c_req)
+{
+	write_seqcount_begin(&ppm_main_info.last_req_seq);
+	memcpy(ppm_main_info.last_req.cpu_limit, c_req->cpu_limit,
+		ppm_main_info.cluster_num * sizeof(*c_req->cpu_limit));
+	write_seqcount_end(&ppm_main_info.last_req_seq);
+}
+
+/*
+ * mt_ppm_get_cur_limit - limit of @cluster last sent to the clients,
+ * without taking the PPM lock. Callable from any context.
+ */
+int mt_ppm_get_cur_limit(unsigned int cluster, struct ppm_client_limit *limit)
+{
+	unsigned int seq;
+
+	if (cluster >= ppm_main_info.cluster_num || !ppm_main_info.last_req.cpu_limit)
+		return -EINVAL;
+
+	do {
+		seq = read_seqcount_begin(&ppm_main_info.last_req_seq);
+		*limit = ppm_main_info.last_req.cpu_limit[cluster];
+	} while (read_seqcount_retry(&ppm_main_info.last_req_seq, seq));
+
+	return 0;
+}
+EXPORT_SYMBOL(mt_ppm_get_cur_limit);
+
 int ppm_main_register_policy(struct ppm_policy_data *policy)
 {
 	struct list_head *pos;
@@ -221,6 +278,7 @@ int ppm_main_register_policy(struct ppm_policy_data *policy)
 	list_add_tail(&policy->link, pos);
 
 	policy->is_enabled = true;
+	policy->is_limit_valid = false;
 
 out:
 	ppm_unlock(&ppm_main_info.lock);
@@ -492,6 +550,7 @@ int mt_ppm_main(void)
 	enum ppm_power_state prev_state;
 	enum ppm_power_state next_state;
 	int i, notify_hps_first = 0;
+	bool update_all;
 
 	FUNC_ENTER(FUNC_LV_MAIN);
 
@@ -507,14 +566,24 @@ int mt_ppm_main(void)
 	next_state = ppm_main_hica_state_decision();
 	ppm_main_info.cur_power_state = next_state;
 
-	/* update active policy's limit according to current state */
+	/*
+	 * update active policy's limit according to current state; with the
+	 * state unchanged, a policy whose request was not touched since its
+	 * last update keeps its limit (HICA is always re-evaluated)
+	 */
+	update_all = ppm_main_info.is_limit_dirty || prev_state != next_state;
+	ppm_main_info.is_limit_dirty = false;
 	list_for_each_entry(pos, &ppm_main_info.policy_list, link) {
 		if ((pos->is_activated || pos->policy == PPM_POLICY_HICA)
 			&& pos->update_limit_cb) {
-			ppm_lock(&pos->lock);
-			pos->update_limit_cb(next_state);
-			ppm_unlock(&pos->lock);
-		}
+			if (update_all || !pos->is_limit_valid || pos->policy == PPM_POLICY_HICA) {
+				ppm_lock(&pos->lock);
+				pos->update_limit_cb(next_state);
+				ppm_unlock(&pos->lock);
+			}
+			pos->is_limit_valid = true;
+		} else
+			pos->is_limit_valid = false;
 	}
 
 	/* calculate final limit and fill-in client request structure */
@@ -590,8 +659,7 @@ int mt_ppm_main(void)
 
 		ppm_dbg(MAIN, "(%d)%s\n", c_req->root_cluster, buf);
 
-		memcpy(last_req->cpu_limit, c_req->cpu_limit,
-			ppm_main_info.cluster_num * sizeof(*c_req->cpu_limit));
+		ppm_main_save_last_req(c_req);
 	}
 
 #if PPM_UPDATE_STATE_DIRECT_TO_MET
@@ -652,7 +720,6 @@ static int ppm_main_task(void *data)
 static void ppm_main_send_request_for_suspend(void)
 {
 	struct ppm_client_req *c_req = &(ppm_main_info.client_req);
-	struct ppm_client_req *last_req = &(ppm_main_info.last_req);
 	int i;
 
 	FUNC_ENTER(FUNC_LV_MAIN);
@@ -685,8 +752,7 @@ static void ppm_main_send_request_for_suspend(void)
 			ppm_main_info.client_info[i].limit_cb(*c_req);
 	}
 
-	memcpy(last_req->cpu_limit, c_req->cpu_limit,
-		ppm_main_info.cluster_num * sizeof(*c_req->cpu_limit));
+	ppm_main_save_last_req(c_req);
 
 	ppm_info("send fix idx to DVFS before suspend!\n");
 
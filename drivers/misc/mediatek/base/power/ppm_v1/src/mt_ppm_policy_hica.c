@@ -5,6 +5,8 @@
 #include <linux/types.h>
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
+#include <linux/jiffies.h>
+#include <linux/ktime.h>
 #include <asm/uaccess.h>
 
 #include "mt_ppm_internal.h"
@@ -54,6 +56,47 @@
 
 static enum ppm_power_state fix_power_state = PPM_POWER_STATE_NONE;
 
+/*
+ * After a state transition HICA holds the new state for at least
+ * hica_min_dwell_ms before it evaluates the transfer rules again, so a burst
+ * that ends right after a cluster switch does not bounce the state back
+ * (each switch costs a cluster power up/down plus task migration).
+ */
+static unsigned int hica_min_dwell_ms = 200;
+static unsigned long hica_last_trans_jiffies;
+
+/* why the last state transition happened, see hica_trans_log */
+enum ppm_hica_trans_reason {
+	HICA_TRANS_PERF,	/* transfer_by_perf rule */
+	HICA_TRANS_PWR,		/* transfer_by_pwr rule */
+	HICA_TRANS_ROOT_CLUSTER,	/* root cluster fixed by user */
+	HICA_TRANS_OTHER,	/* final state decided by another policy */
+
+	NR_HICA_TRANS_REASONS,
+};
+
+static const char * const hica_trans_reason_name[NR_HICA_TRANS_REASONS] = {
+	"perf", "pwr", "root_cluster", "other",
+};
+
+#define HICA_TRANS_LOG_SIZE	16
+
+static struct ppm_hica_trans_log {
+	u64 ts_ms;
+	enum ppm_power_state from;
+	enum ppm_power_state to;
+	enum ppm_hica_trans_reason reason;
+	int rule;	/* index in transfer data, -1 if none */
+	unsigned int loads;
+	unsigned int tlp;
+	unsigned int nr_heavy_task;
+} hica_trans_log[HICA_TRANS_LOG_SIZE];
+static unsigned int hica_trans_log_cnt;
+
+/* reason of ppm_hica_algo_data.new_state, under hica_policy.lock */
+static enum ppm_hica_trans_reason hica_pending_reason = HICA_TRANS_OTHER;
+static int hica_pending_rule = -1;
+
 static void ppm_hica_reset_data_for_state(enum ppm_power_state new_state);
 static void ppm_hica_update_limit_cb(enum ppm_power_state new_state);
 static void ppm_hica_status_change_cb(bool enable);
@@ -116,6 +159,13 @@ void mt_ppm_hica_update_algo_data(unsigned int cur_loads,
 	if (fix_power_state != PPM_POWER_STATE_NONE)
 		goto end;
 
+	/* hold the current state for a while after a transition */
+	if (time_before(jiffies, hica_last_trans_jiffies + msecs_to_jiffies(hica_min_dwell_ms))) {
+		ppm_dbg(HICA, "hold in %s state for min dwell time\n",
+			ppm_get_power_state_name(cur_state));
+		goto end;
+	}
+
 	for (i = 0; i < 2; i++) {
 		data = (i == 0) ? state_info[cur_state].transfer_by_perf
 				: state_info[cur_state].transfer_by_pwr;
@@ -128,6 +178,8 @@ void mt_ppm_hica_update_algo_data(unsigned int cur_loads,
 			if (data->transition_data[j].transition_rule(
 				ppm_hica_algo_data, &data->transition_data[j])) {
 				ppm_hica_algo_data.new_state = data->transition_data[j].next_state;
+				hica_pending_reason = (i == 0) ? HICA_TRANS_PERF : HICA_TRANS_PWR;
+				hica_pending_rule = j;
 				ppm_dbg(HICA, "[%s(%d)] Need state transfer: %s --> %s\n",
 					(i == 0) ? "PERF" : "PWR",
 					j,
@@ -369,6 +421,8 @@ void ppm_hica_fix_root_cluster_changed(int cluster_id)
 			__func__, ppm_get_power_state_name(new_state), ppm_main_info.fixed_root_cluster);
 		ppm_lock(&hica_policy.lock);
 		ppm_hica_algo_data.new_state = new_state;
+		hica_pending_reason = HICA_TRANS_ROOT_CLUSTER;
+		hica_pending_rule = -1;
 		ppm_unlock(&hica_policy.lock);
 		ppm_task_wakeup();
 	}
@@ -399,6 +453,35 @@ static void ppm_hica_reset_data_for_state(enum ppm_power_state state)
 	FUNC_EXIT(FUNC_LV_HICA);
 }
 
+/* called with hica_policy.lock held */
+static void ppm_hica_log_transition(enum ppm_power_state from, enum ppm_power_state to)
+{
+	struct ppm_hica_trans_log *log = &hica_trans_log[hica_trans_log_cnt % HICA_TRANS_LOG_SIZE];
+
+	log->ts_ms = ktime_to_ms(ktime_get());
+	log->from = from;
+	log->to = to;
+	if (to == ppm_hica_algo_data.new_state) {
+		log->reason = hica_pending_reason;
+		log->rule = hica_pending_rule;
+	} else {
+		log->reason = HICA_TRANS_OTHER;
+		log->rule = -1;
+	}
+	log->loads = ppm_hica_algo_data.ppm_cur_loads;
+	log->tlp = ppm_hica_algo_data.ppm_cur_tlp;
+	log->nr_heavy_task = ppm_hica_algo_data.ppm_cur_nr_heavy_task;
+	hica_trans_log_cnt++;
+
+	hica_last_trans_jiffies = jiffies;
+	hica_pending_reason = HICA_TRANS_OTHER;
+	hica_pending_rule = -1;
+
+	ppm_dbg(HICA, "state transfer reason = %s(%d), loads = %d, tlp = %d, heavy = %d\n",
+		hica_trans_reason_name[log->reason], log->rule,
+		log->loads, log->tlp, log->nr_heavy_task);
+}
+
 static void ppm_hica_update_limit_cb(enum ppm_power_state new_state)
 {
 	FUNC_ENTER(FUNC_LV_HICA);
@@ -416,6 +499,7 @@ static void ppm_hica_update_limit_cb(enum ppm_power_state new_state)
 			ppm_get_power_state_name(ppm_hica_algo_data.cur_state),
 			ppm_get_power_state_name(new_state)
 			);
+		ppm_hica_log_transition(ppm_hica_algo_data.cur_state, new_state);
 		ppm_hica_algo_data.cur_state = new_state;
 		ppm_hica_reset_data_for_state(new_state);
 	}
@@ -480,7 +564,61 @@ static ssize_t ppm_hica_power_state_proc_write(struct file *file, const char __u
 	return count;
 }
 
+static int ppm_hica_min_dwell_proc_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "%u\n", hica_min_dwell_ms);
+	return 0;
+}
+
+static ssize_t ppm_hica_min_dwell_proc_write(struct file *file, const char __user *buffer,
+					size_t count, loff_t *pos)
+{
+	unsigned int ms;
+
+	char *buf = ppm_copy_from_user_for_proc(buffer, count);
+
+	if (!buf)
+		return -EINVAL;
+
+	if (!kstrtouint(buf, 10, &ms))
+		hica_min_dwell_ms = ms;
+	else
+		ppm_err("echo (ms) > /proc/ppm/policy/hica_min_dwell\n");
+
+	free_page((unsigned long)buf);
+	return count;
+}
+
+static int ppm_hica_trans_log_proc_show(struct seq_file *m, void *v)
+{
+	struct ppm_hica_trans_log *log;
+	unsigned int i, first;
+
+	ppm_lock(&hica_policy.lock);
+
+	seq_printf(m, "total transitions = %u\n", hica_trans_log_cnt);
+	seq_puts(m, "time(ms)\tfrom\tto\treason(rule)\tloads\ttlp\theavy\n");
+
+	first = (hica_trans_log_cnt > HICA_TRANS_LOG_SIZE)
+		? hica_trans_log_cnt - HICA_TRANS_LOG_SIZE : 0;
+	for (i = first; i < hica_trans_log_cnt; i++) {
+		log = &hica_trans_log[i % HICA_TRANS_LOG_SIZE];
+		seq_printf(m, "%llu\t%s\t%s\t%s(%d)\t%u\t%u\t%u\n",
+			log->ts_ms,
+			ppm_get_power_state_name(log->from),
+			ppm_get_power_state_name(log->to),
+			hica_trans_reason_name[log->reason], log->rule,
+			log->loads, log->tlp, log->nr_heavy_task);
+	}
+
+	ppm_unlock(&hica_policy.lock);
+
+	return 0;
+}
+
 PROC_FOPS_RW(hica_power_state);
+PROC_FOPS_RW(hica_min_dwell);
+PROC_FOPS_RO(hica_trans_log);
 PROC_FOPS_RW_HICA_SETTINGS(mode_mask, p->mode_mask);
 PROC_FOPS_RW_HICA_SETTINGS(loading_delta, p->loading_delta);
 PROC_FOPS_RW_HICA_SETTINGS(loading_hold_time, p->loading_hold_time);
@@ -506,6 +644,8 @@ static int __init ppm_hica_policy_init(void)
 
 	const struct pentry entries[] = {
 		PROC_ENTRY(hica_power_state),
+		PROC_ENTRY(hica_min_dwell),
+		PROC_ENTRY(hica_trans_log),
 	};
 
 	const struct pentry trans_rule_entries[] = {
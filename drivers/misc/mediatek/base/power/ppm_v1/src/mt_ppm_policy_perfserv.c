@@ -136,7 +136,7 @@ static ssize_t ppm_perfserv_perf_idx_proc_write(struct file *file, const char __
 		perfserv_policy.is_activated = ppm_perfserv_is_policy_active();
 
 		ppm_unlock(&perfserv_policy.lock);
-		ppm_task_wakeup();
+		ppm_task_wakeup_policy(&perfserv_policy);
 	} else
 		ppm_err("@%s: Invalid input!\n", __func__);
 
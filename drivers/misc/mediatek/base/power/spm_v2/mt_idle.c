@@ -9,6 +9,8 @@
 #include <linux/irq.h>
 #include <linux/spinlock.h>
 #include <linux/cpumask.h>
+#include <linux/math64.h>
+#include <linux/vmalloc.h>
 
 #include <linux/debugfs.h>
 #include <linux/seq_file.h>
@@ -33,6 +35,7 @@
 #include <mach/mt_spm_mtcmos_internal.h>
 #include "mt_spm_reg.h"
 #include "mt_cpufreq_hybrid.h"
+#include "mt_cpuidle.h"
 
 #include <asm/uaccess.h>
 
@@ -425,6 +428,60 @@ static unsigned long mcidle_block_cnt[NR_CPUS][NR_REASONS] = { {0}, {0} };
 u64 mcidle_timer_before_wfi[NR_CPUS];
 static unsigned int idle_spm_lock;
 
+/*
+ * Per-cpu idle statistics, exported raw by debugfs cpuidle/idle_stat.
+ *
+ * When a state is refused, the reason (and for BY_CLK the clock groups
+ * in its block mask) is kept as pending; the residency of the idle
+ * period the cpu then spends in a shallower state is charged to it, so
+ * block_us is the time each blocker kept the SoC out of that state.
+ */
+#define IDLE_STAT_MAGIC		0x54534449	/* "IDST" */
+#define IDLE_STAT_VERSION	1
+
+struct idle_stat_hdr {
+	u32 magic;
+	u16 version;
+	u16 rec_size;
+	u16 nr_cpus;
+	u16 nr_types;
+	u16 nr_reasons;
+	u16 nr_grps;
+};
+
+struct idle_stat_rec {
+	u64 enter_cnt[NR_TYPES];
+	u64 short_cnt[NR_TYPES];	/* residency below break-even */
+	u64 residency_us[NR_TYPES];
+	u64 block_cnt[NR_TYPES][NR_REASONS];
+	u64 block_us[NR_TYPES][NR_REASONS];
+	u64 block_grp_us[NR_TYPES][NR_GRPS];
+};
+
+struct idle_stat_cpu {
+	struct idle_stat_rec rec;
+	u8 pending_reason[NR_TYPES];
+	u32 pending_grps[NR_TYPES];
+};
+
+static DEFINE_PER_CPU(struct idle_stat_cpu, idle_stat);
+
+static void idle_stat_block(int cpu, int type, int reason, const unsigned int *block_mask)
+{
+	struct idle_stat_cpu *st = &per_cpu(idle_stat, cpu);
+	u32 grps = 0;
+	int i;
+
+	st->rec.block_cnt[type][reason]++;
+	st->pending_reason[type] = reason;
+	if (reason == BY_CLK && block_mask) {
+		for (i = 0; i < NR_GRPS; i++)
+			if (block_mask[i])
+				grps |= 1U << i;
+	}
+	st->pending_grps[type] = grps;
+}
+
 /* Workaround of static analysis defect*/
 int idle_gpt_get_cnt(unsigned int id, unsigned int *ptr)
 {
@@ -482,7 +539,7 @@ bool is_cpus_offline_or_isolated(cpumask_var_t mask)
 	cpumask_var_t tmp_mask;
 
 	/* remove offline CPUs from mask */
-	cpumask_andnot(tmp_mask, mask, cpu_online_mask);
+	cpumask_and(tmp_mask, mask, cpu_online_mask);
 
 	/* remove isolated CPUs from mask */
 	cpumask_andnot(tmp_mask, tmp_mask, cpu_isolate_mask);
@@ -743,6 +800,7 @@ out:
 		}
 
 		soidle3_block_cnt[reason]++;
+		idle_stat_block(cpu, IDLE_TYPE_SO3, reason, soidle3_block_mask);
 		ret = false;
 	} else {
 		soidle3_block_prev_time = idle_get_current_time_ms();
@@ -1028,6 +1086,7 @@ out:
 		}
 
 		soidle_block_cnt[reason]++;
+		idle_stat_block(cpu, IDLE_TYPE_SO, reason, soidle_block_mask);
 		ret = false;
 	} else {
 		soidle_block_prev_time = idle_get_current_time_ms();
@@ -1136,6 +1195,7 @@ bool mcidle_can_enter(int cpu)
 mcidle_out:
 	if (reason < NR_REASONS) {
 		mcidle_block_cnt[cpu][reason]++;
+		idle_stat_block(cpu, IDLE_TYPE_MC, reason, NULL);
 		return false;
 	}
 
@@ -1395,6 +1455,7 @@ out:
 			}
 		}
 		dpidle_block_cnt[reason]++;
+		idle_stat_block(cpu, IDLE_TYPE_DP, reason, dpidle_block_mask);
 		ret = false;
 	} else {
 		dpidle_block_prev_time = idle_get_current_time_ms();
@@ -1936,13 +1997,122 @@ inline void idle_ratio_calc_stop(int type, int cpu)
 		idle_ratio_value[type] += (idle_get_current_time_ms() - idle_ratio_start_time[type]);
 }
 
+/*
+ * Idle length prediction, menu governor style.
+ *
+ * The *_can_enter() checks only know the next timer, so a cpu woken by a
+ * periodic IRQ keeps going into SODI/DP and comes back right away. The
+ * governor reports every residency through mt_idle_reflect(); when the last
+ * IDLE_PRED_SLOTS of them agree (stddev under 1/6 of the mean, after
+ * dropping up to two outliers) the mean is the prediction and states whose
+ * break-even time is longer are not tried.
+ *
+ * A residency shorter than the break-even of the state it was spent in
+ * counts as short, i.e. the entry/exit cost was paid for nothing.
+ */
+#define IDLE_PRED_SLOTS		8
+#define IDLE_PRED_NONE		UINT_MAX
+#define IDLE_PRED_CAP_US	1000000
+
+struct idle_pred {
+	unsigned int intervals[IDLE_PRED_SLOTS];
+	unsigned int idx;
+};
+
+static bool idle_pred_en = true;
+/* us, from the *_time_critera of each state */
+static unsigned int idle_pred_min_us[NR_TYPES] = {
+	[IDLE_TYPE_DP] = 2000,
+	[IDLE_TYPE_SO3] = 5000,
+	[IDLE_TYPE_SO] = 2000,
+	[IDLE_TYPE_MC] = 3000,
+};
+static DEFINE_PER_CPU(struct idle_pred, idle_pred);
+static unsigned long idle_pred_skip_cnt[NR_CPUS][NR_TYPES];
+
+static unsigned int idle_pred_get(int cpu)
+{
+	struct idle_pred *pred = &per_cpu(idle_pred, cpu);
+	unsigned int thresh = IDLE_PRED_NONE, max, v;
+	u64 sum, var;
+	int i, n, round;
+
+	for (round = 0; round < 3; round++) {
+		sum = 0;
+		n = 0;
+		max = 0;
+		for (i = 0; i < IDLE_PRED_SLOTS; i++) {
+			v = pred->intervals[i];
+			if (v <= thresh) {
+				sum += v;
+				n++;
+				max = max(max, v);
+			}
+		}
+		if (n < IDLE_PRED_SLOTS - 2)
+			break;
+		do_div(sum, n);
+
+		var = 0;
+		for (i = 0; i < IDLE_PRED_SLOTS; i++) {
+			v = pred->intervals[i];
+			if (v <= thresh)
+				var += (u64)((s64)v - (s64)sum) * ((s64)v - (s64)sum);
+		}
+		do_div(var, n);
+
+		if (sum * sum > 36 * var || var <= 400)
+			return sum;
+		thresh = max - 1;
+	}
+
+	return IDLE_PRED_NONE;
+}
+
+void mt_idle_reflect(int cpu, int type, int residency_us)
+{
+	struct idle_pred *pred = &per_cpu(idle_pred, cpu);
+	struct idle_stat_cpu *st = &per_cpu(idle_stat, cpu);
+	int t, i;
+
+	if (type < 0 || type >= NR_TYPES || residency_us < 0)
+		return;
+
+	/* capped, only the few ms around the break-even times matter */
+	pred->intervals[pred->idx++ % IDLE_PRED_SLOTS] = min(residency_us, IDLE_PRED_CAP_US);
+
+	st->rec.enter_cnt[type]++;
+	st->rec.residency_us[type] += residency_us;
+	if (residency_us < idle_pred_min_us[type])
+		st->rec.short_cnt[type]++;
+
+	for (t = 0; t < type; t++) {
+		if (st->pending_reason[t] >= NR_REASONS)
+			continue;
+		st->rec.block_us[t][st->pending_reason[t]] += residency_us;
+		for (i = 0; i < NR_GRPS; i++)
+			if (st->pending_grps[t] & (1U << i))
+				st->rec.block_grp_us[t][i] += residency_us;
+	}
+}
+
 int mt_idle_select(int cpu)
 {
 	int i = NR_TYPES - 1;
+	unsigned int pred_us = IDLE_PRED_NONE;
 
 	dump_idle_cnt_in_interval(cpu);
 
+	memset(per_cpu(idle_stat, cpu).pending_reason, NR_REASONS, NR_TYPES);
+
+	if (idle_pred_en)
+		pred_us = idle_pred_get(cpu);
+
 	for (i = 0; i < NR_TYPES; i++) {
+		if (pred_us < idle_pred_min_us[i]) {
+			idle_pred_skip_cnt[cpu][i]++;
+			continue;
+		}
 		if (idle_select_handlers[i] (cpu))
 			break;
 	}
@@ -2216,10 +2386,25 @@ static ssize_t idle_state_read(struct file *filp,
 	p += sprintf(p, "\n");
 	p += sprintf(p, "idle_ratio_en = %u\n", idle_ratio_en);
 
+	p += sprintf(p, "\n********** idle prediction (pred_en = %u) **********\n", idle_pred_en);
+	for (i = 0; i < NR_TYPES; i++) {
+		unsigned long enter = 0, short_cnt = 0, skip = 0;
+		int cpu;
+
+		for_each_possible_cpu(cpu) {
+			enter += per_cpu(idle_stat, cpu).rec.enter_cnt[i];
+			short_cnt += per_cpu(idle_stat, cpu).rec.short_cnt[i];
+			skip += idle_pred_skip_cnt[cpu][i];
+		}
+		p += sprintf(p, "%s: min_us=%u, enter=%lu, short=%lu, skipped=%lu\n",
+				idle_name[i], idle_pred_min_us[i], enter, short_cnt, skip);
+	}
+
 	p += sprintf(p, "\n********** idle command help **********\n");
 	p += sprintf(p, "status help:   cat /sys/kernel/debug/cpuidle/idle_state\n");
 	p += sprintf(p, "switch on/off: echo switch mask > /sys/kernel/debug/cpuidle/idle_state\n");
 	p += sprintf(p, "idle ratio profile: echo ratio 1/0 > /sys/kernel/debug/cpuidle/idle_state\n");
+	p += sprintf(p, "idle prediction: echo pred 1/0 > /sys/kernel/debug/cpuidle/idle_state\n");
 
 	p += sprintf(p, "soidle3 help:   cat /sys/kernel/debug/cpuidle/soidle3_state\n");
 	p += sprintf(p, "soidle help:   cat /sys/kernel/debug/cpuidle/soidle_state\n");
@@ -2251,6 +2436,8 @@ static ssize_t idle_state_write(struct file *filp,
 		if (!strcmp(cmd, "switch")) {
 			for (idx = 0; idx < NR_TYPES; idx++)
 				idle_switch[idx] = (param & (1U << idx)) ? 1 : 0;
+		} else if (!strcmp(cmd, "pred")) {
+			idle_pred_en = param;
 		} else if (!strcmp(cmd, "ratio")) {
 			idle_ratio_en = param;
 
@@ -2274,6 +2461,51 @@ static const struct file_operations idle_state_fops = {
 	.release = single_release,
 };
 
+/* idle_stat: struct idle_stat_hdr, then one struct idle_stat_rec per cpu */
+static int idle_stat_open(struct inode *inode, struct file *filp)
+{
+	struct idle_stat_hdr *hdr;
+	struct idle_stat_rec *rec;
+	int cpu;
+
+	hdr = vzalloc(sizeof(*hdr) + nr_cpu_ids * sizeof(*rec));
+	if (!hdr)
+		return -ENOMEM;
+
+	hdr->magic = IDLE_STAT_MAGIC;
+	hdr->version = IDLE_STAT_VERSION;
+	hdr->rec_size = sizeof(*rec);
+	hdr->nr_cpus = nr_cpu_ids;
+	hdr->nr_types = NR_TYPES;
+	hdr->nr_reasons = NR_REASONS;
+	hdr->nr_grps = NR_GRPS;
+	rec = (struct idle_stat_rec *)(hdr + 1);
+	for_each_possible_cpu(cpu)
+		rec[cpu] = per_cpu(idle_stat, cpu).rec;
+
+	filp->private_data = hdr;
+	return 0;
+}
+
+static ssize_t idle_stat_read(struct file *filp, char __user *userbuf, size_t count, loff_t *f_pos)
+{
+	return simple_read_from_buffer(userbuf, count, f_pos, filp->private_data,
+			sizeof(struct idle_stat_hdr) + nr_cpu_ids * sizeof(struct idle_stat_rec));
+}
+
+static int idle_stat_release(struct inode *inode, struct file *filp)
+{
+	vfree(filp->private_data);
+	return 0;
+}
+
+static const struct file_operations idle_stat_fops = {
+	.open = idle_stat_open,
+	.read = idle_stat_read,
+	.llseek = default_llseek,
+	.release = idle_stat_release,
+};
+
 /* mcidle_state */
 static int _mcidle_state_open(struct seq_file *s, void *data)
 {
@@ -2289,24 +2521,31 @@ static ssize_t mcidle_state_read(struct file *filp, char __user *userbuf, size_t
 {
 	int len = 0;
 	char *p = dbg_buf;
+	char *end = dbg_buf + sizeof(dbg_buf);
 	int cpus, reason;
 
-	p += sprintf(p, "*********** deep idle state ************\n");
-	p += sprintf(p, "mcidle_time_critera=%u\n", mcidle_time_critera);
+	p += scnprintf(p, end - p, "*********** deep idle state ************\n");
+	p += scnprintf(p, end - p, "mcidle_time_critera=%u\n", mcidle_time_critera);
 
 	for (cpus = 0; cpus < nr_cpu_ids; cpus++) {
-		p += sprintf(p, "cpu:%d\n", cpus);
+		unsigned int core_in, core_out, cluster_in, cluster_out;
+
+		mt_cpu_dormant_latency(cpus, MT_DORMANT_CORE_OFF, &core_in, &core_out);
+		mt_cpu_dormant_latency(cpus, MT_DORMANT_CLUSTER_OFF, &cluster_in, &cluster_out);
+		p += scnprintf(p, end - p, "cpu:%d\n", cpus);
+		p += scnprintf(p, end - p, "dormant core_off=%u/%uus cluster_off=%u/%uus\n",
+			       core_in, core_out, cluster_in, cluster_out);
 		for (reason = 0; reason < NR_REASONS; reason++) {
-			p += sprintf(p, "[%d]mcidle_block_cnt[%s]=%lu\n", reason,
-				     reason_name[reason], mcidle_block_cnt[cpus][reason]);
+			p += scnprintf(p, end - p, "[%d]mcidle_block_cnt[%s]=%lu\n", reason,
+				       reason_name[reason], mcidle_block_cnt[cpus][reason]);
 		}
-		p += sprintf(p, "\n");
+		p += scnprintf(p, end - p, "\n");
 	}
 
-	p += sprintf(p, "\n********** mcidle command help **********\n");
-	p += sprintf(p, "mcidle help:   cat /sys/kernel/debug/cpuidle/mcidle_state\n");
-	p += sprintf(p, "switch on/off: echo [mcidle] 1/0 > /sys/kernel/debug/cpuidle/mcidle_state\n");
-	p += sprintf(p, "modify tm_cri: echo time value(dec) > /sys/kernel/debug/cpuidle/mcidle_state\n");
+	p += scnprintf(p, end - p, "\n********** mcidle command help **********\n");
+	p += scnprintf(p, end - p, "mcidle help:   cat /sys/kernel/debug/cpuidle/mcidle_state\n");
+	p += scnprintf(p, end - p, "switch on/off: echo [mcidle] 1/0 > /sys/kernel/debug/cpuidle/mcidle_state\n");
+	p += scnprintf(p, end - p, "modify tm_cri: echo time value(dec) > /sys/kernel/debug/cpuidle/mcidle_state\n");
 
 	len = p - dbg_buf;
 
@@ -2906,6 +3145,7 @@ static int mt_cpuidle_debugfs_init(void)
 	}
 
 	debugfs_create_file("idle_state", 0644, root_entry, NULL, &idle_state_fops);
+	debugfs_create_file("idle_stat", 0444, root_entry, NULL, &idle_stat_fops);
 	debugfs_create_file("dpidle_state", 0644, root_entry, NULL, &dpidle_state_fops);
 	debugfs_create_file("soidle3_state", 0644, root_entry, NULL, &soidle3_state_fops);
 	debugfs_create_file("soidle_state", 0644, root_entry, NULL, &soidle_state_fops);
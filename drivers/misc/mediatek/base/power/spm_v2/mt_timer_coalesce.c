@@ -0,0 +1,123 @@
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/jiffies.h>
+#include <linux/spinlock.h>
+#include <linux/sched.h>
+#include <linux/fb.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include <mt-plat/mt_timer_coalesce.h>
+
+/*
+ * Shared wake windows of the coalesced driver timers, see
+ * mt_timer_coalesce.h. With the screen on the default window of 0 only
+ * rounds each timer to its own slack; with the screen off the timers that
+ * can wait are pushed onto whole seconds so the cpus leave SODI/dpidle once
+ * for all of them.
+ */
+static unsigned int window_on_ms;
+static unsigned int window_off_ms = 1000;
+static bool screen_off;
+
+module_param(window_on_ms, uint, 0644);
+module_param(window_off_ms, uint, 0644);
+
+static LIST_HEAD(mt_ctimer_list);
+static DEFINE_SPINLOCK(mt_ctimer_lock);
+
+static void mt_ctimer_register(struct mt_ctimer_src *src)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&mt_ctimer_lock, flags);
+	if (list_empty(&src->link))
+		list_add_tail(&src->link, &mt_ctimer_list);
+	spin_unlock_irqrestore(&mt_ctimer_lock, flags);
+}
+
+unsigned long mt_ctimer_expires(struct mt_ctimer_src *src, unsigned long expires)
+{
+	unsigned long slack = msecs_to_jiffies(src->slack_ms);
+	unsigned long win = msecs_to_jiffies(ACCESS_ONCE(screen_off) ? window_off_ms : window_on_ms);
+	unsigned long aligned;
+
+	if (unlikely(list_empty(&src->link)))
+		mt_ctimer_register(src);
+
+	if (slack <= 1)
+		return expires;
+
+	if (win > 1) {
+		aligned = roundup(expires, win);
+		if (aligned - expires <= slack)
+			return aligned;
+	}
+
+	return roundup(expires, slack);
+}
+EXPORT_SYMBOL(mt_ctimer_expires);
+
+void mt_ctimer_fired(struct mt_ctimer_src *src)
+{
+	atomic_long_inc(&src->nr_fired);
+	/* the timer softirq ran on the idle task: this (shared) wakeup is ours */
+	if (is_idle_task(current))
+		atomic_long_inc(&src->nr_idle_fired);
+}
+EXPORT_SYMBOL(mt_ctimer_fired);
+
+static int mt_ctimer_fb_notifier(struct notifier_block *nb, unsigned long event, void *data)
+{
+	struct fb_event *evdata = data;
+
+	if (event != FB_EVENT_BLANK)
+		return NOTIFY_DONE;
+
+	screen_off = (*(int *)evdata->data != FB_BLANK_UNBLANK);
+	return NOTIFY_OK;
+}
+
+static struct notifier_block mt_ctimer_fb_nb = {
+	.notifier_call = mt_ctimer_fb_notifier,
+};
+
+static int mt_ctimer_show(struct seq_file *m, void *v)
+{
+	struct mt_ctimer_src *src;
+	unsigned long flags;
+
+	seq_printf(m, "screen_off = %d, window = %u ms\n", screen_off,
+		   screen_off ? window_off_ms : window_on_ms);
+	seq_printf(m, "%-24s %8s %12s %12s\n", "source", "slack_ms", "fired", "idle_fired");
+
+	spin_lock_irqsave(&mt_ctimer_lock, flags);
+	list_for_each_entry(src, &mt_ctimer_list, link)
+		seq_printf(m, "%-24s %8u %12ld %12ld\n", src->name, src->slack_ms,
+			   atomic_long_read(&src->nr_fired),
+			   atomic_long_read(&src->nr_idle_fired));
+	spin_unlock_irqrestore(&mt_ctimer_lock, flags);
+
+	return 0;
+}
+
+static int mt_ctimer_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mt_ctimer_show, NULL);
+}
+
+static const struct file_operations mt_ctimer_fops = {
+	.open = mt_ctimer_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init mt_ctimer_init(void)
+{
+	fb_register_client(&mt_ctimer_fb_nb);
+	debugfs_create_file("mt_ctimer", 0444, NULL, NULL, &mt_ctimer_fops);
+	return 0;
+}
+late_initcall(mt_ctimer_init);
@@ -1065,6 +1065,145 @@ int hal_rx_dma_irq_handler(P_MTK_DMA_INFO_STR p_dma_info,
 	return i_ret;
 }
 
+/*****************************************************************************
+* FUNCTION
+*  hal_rx_dma_irq_defer
+* DESCRIPTION
+*  ack rx dma interrupt and leave rx IER disabled, vFIFO data is kept for
+*  hal_rx_dma_consume to be called from bottom half
+* PARAMETERS
+* p_dma_info   [IN]        pointer to BTIF dma channel's information
+* RETURNS
+*  0 means success, negative means fail
+*****************************************************************************/
+int hal_rx_dma_irq_defer(P_MTK_DMA_INFO_STR p_dma_info)
+{
+	unsigned long base = p_dma_info->base;
+	unsigned long flag = 0;
+
+	spin_lock_irqsave(&(g_clk_cg_spinlock), flag);
+#if defined(CONFIG_MTK_CLKMGR)
+	if (0 == clock_is_on(MTK_BTIF_APDMA_CLK_CG)) {
+		spin_unlock_irqrestore(&(g_clk_cg_spinlock), flag);
+		BTIF_ERR_FUNC("%s: clock is off before irq handle done!!!\n",
+			      __FILE__);
+		return -1;
+	}
+#endif
+/*disable DMA Rx IER, hal_rx_dma_consume enables it again*/
+	hal_btif_dma_ier_ctrl(p_dma_info, false);
+
+/*clear Rx DMA's interrupt status, data arrived after this point raises
+the flag again and is seen as soon as IER is enabled*/
+	BTIF_SET_BIT(RX_DMA_INT_FLAG(base), RX_DMA_INT_DONE | RX_DMA_INT_THRE);
+
+	spin_unlock_irqrestore(&(g_clk_cg_spinlock), flag);
+
+	return 0;
+}
+
+/*****************************************************************************
+* FUNCTION
+*  hal_rx_dma_consume
+* DESCRIPTION
+*  hand rx vFIFO data to rx_cb in place, rx_cb is called without lock held,
+*  rx IER is enabled again once vFIFO is empty
+* PARAMETERS
+* p_dma_info   [IN]        pointer to BTIF dma channel's information
+* rx_cb           [IN]        consumer of vFIFO data
+* RETURNS
+*  length of data consumed, negative means fail
+*****************************************************************************/
+int hal_rx_dma_consume(P_MTK_DMA_INFO_STR p_dma_info, dma_rx_buf_write rx_cb)
+{
+	int i_ret = 0;
+	unsigned int valid_len = 0;
+	unsigned int wpt_wrap = 0;
+	unsigned int rpt_wrap = 0;
+	unsigned int wpt = 0;
+	unsigned int rpt = 0;
+	unsigned int tail_len = 0;
+	unsigned int real_len = 0;
+	unsigned long base = p_dma_info->base;
+	P_DMA_VFIFO p_vfifo = p_dma_info->p_vfifo;
+	unsigned char *p_vff_buf = NULL;
+	unsigned char *vff_base = p_vfifo->p_vir_addr;
+	unsigned int vff_size = p_vfifo->vfifo_size;
+	P_MTK_BTIF_DMA_VFIFO p_mtk_vfifo = container_of(p_vfifo,
+							MTK_BTIF_DMA_VFIFO,
+							vfifo);
+	unsigned long flag = 0;
+
+	if (NULL == rx_cb) {
+		BTIF_ERR_FUNC("no rx_cb found, please check your init process\n");
+		return -1;
+	}
+
+	while (1) {
+		spin_lock_irqsave(&(g_clk_cg_spinlock), flag);
+#if defined(CONFIG_MTK_CLKMGR)
+		if (0 == clock_is_on(MTK_BTIF_APDMA_CLK_CG)) {
+			spin_unlock_irqrestore(&(g_clk_cg_spinlock), flag);
+			BTIF_ERR_FUNC("%s: clock is off before rx vfifo drained!!!\n",
+				      __FILE__);
+			return i_ret;
+		}
+#endif
+		if (0 < real_len) {
+/*data handed out last round is consumed, give room back to DMA controller*/
+			rpt += real_len;
+			if (rpt >= vff_size) {
+				/*read wrap bit should be revert*/
+				rpt_wrap ^= DMA_RPT_WRAP;
+				rpt %= vff_size;
+			}
+			rpt |= rpt_wrap;
+			p_mtk_vfifo->rpt = rpt;
+			p_mtk_vfifo->last_rpt_wrap = rpt_wrap;
+			btif_reg_sync_writel(rpt, RX_DMA_VFF_RPT(base));
+		}
+
+		valid_len = BTIF_READ32(RX_DMA_VFF_VALID_SIZE(base));
+		rpt = BTIF_READ32(RX_DMA_VFF_RPT(base));
+		wpt = BTIF_READ32(RX_DMA_VFF_WPT(base));
+		if ((0 == valid_len) && (rpt == wpt)) {
+/*vFIFO drained, enable DMA Rx IER*/
+			hal_btif_dma_ier_ctrl(p_dma_info, true);
+			spin_unlock_irqrestore(&(g_clk_cg_spinlock), flag);
+			break;
+		}
+
+		rpt_wrap = rpt & DMA_RPT_WRAP;
+		wpt_wrap = wpt & DMA_WPT_WRAP;
+		rpt &= DMA_RPT_MASK;
+		wpt &= DMA_WPT_MASK;
+
+/*calcaute length of available data  in vFIFO*/
+		if (wpt_wrap != p_mtk_vfifo->last_wpt_wrap)
+			real_len = wpt + vff_size - rpt;
+		else
+			real_len = wpt - rpt;
+
+		p_mtk_vfifo->wpt = wpt;
+		p_mtk_vfifo->last_wpt_wrap = wpt_wrap;
+		spin_unlock_irqrestore(&(g_clk_cg_spinlock), flag);
+
+/*DMA controller does not touch [rpt, rpt + real_len) until rpt is updated*/
+		tail_len = vff_size - rpt;
+		p_vff_buf = vff_base + rpt;
+		if (tail_len >= real_len) {
+			(*rx_cb) (p_dma_info, p_vff_buf, real_len);
+		} else {
+			(*rx_cb) (p_dma_info, p_vff_buf, tail_len);
+			(*rx_cb) (p_dma_info, vff_base, real_len - tail_len);
+		}
+		mb();
+		i_ret += real_len;
+	}
+
+	return i_ret;
+}
+
 static int hal_tx_dma_dump_reg(P_MTK_DMA_INFO_STR p_dma_info,
 			       ENUM_BTIF_REG_ID flag)
 {
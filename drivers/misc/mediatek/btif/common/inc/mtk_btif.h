@@ -76,6 +76,15 @@ typedef enum _ENUM_BTIF_STATE_ {
 #define BTIF_RX_MODE BTIF_MODE_PIO
 #endif
 
+/*hand Rx DMA vFIFO data to rx_cb in place from bottom half instead of
+copying it into btif_buf in irq context, Rx DMA irq stays masked until
+bottom half drained vFIFO, so back-to-back DMA interrupts are coalesced*/
+#ifdef ENABLE_BTIF_RX_DMA
+#define BTIF_RX_DMA_ZERO_COPY 1
+#else
+#define BTIF_RX_DMA_ZERO_COPY 0
+#endif
+
 #define BTIF_RX_BTM_CTX BTIF_THREAD_CTX/*BTIF_WQ_CTX*//* BTIF_TASKLET_CTX */
 /*-- cannot be used because ,
 mtk_wcn_stp_parser data will call *(stp_if_tx) to send ack,
@@ -232,6 +241,10 @@ typedef struct _mtk_btif_ {
 
 	MTK_WCN_BTIF_RX_CB rx_cb;	/*Rx callback function */
 	MTK_BTIF_RX_NOTIFY rx_notify;
+#if BTIF_RX_DMA_ZERO_COPY
+	/*set by Rx DMA irq, vFIFO data is left for bottom half to consume*/
+	atomic_t rx_dma_defer;
+#endif
 
 	P_MTK_BTIF_INFO_STR p_btif_info;	/*BTIF's information */
 
@@ -1039,7 +1039,14 @@ irqreturn_t btif_rx_dma_irq_handler(int irq, void *data)
 	hal_btif_dma_clk_ctrl(p_rx_dma_info, CLK_OUT_ENABLE);
 #endif
 
-	hal_rx_dma_irq_handler(p_rx_dma_info, NULL, 0);
+#if BTIF_RX_DMA_ZERO_COPY
+/*only ack irq here when there's a rx_cb to hand vFIFO data to*/
+	if ((NULL != p_btif->rx_cb) &&
+	    (0 == hal_rx_dma_irq_defer(p_rx_dma_info)))
+		atomic_set(&p_btif->rx_dma_defer, 1);
+	else
+#endif
+		hal_rx_dma_irq_handler(p_rx_dma_info, NULL, 0);
 
 #if MTK_BTIF_ENABLE_CLK_REF_COUNTER
 	hal_btif_dma_clk_ctrl(p_rx_dma_info, CLK_OUT_DISABLE);
@@ -1074,6 +1081,50 @@ unsigned int btif_dma_rx_data_receiver(P_MTK_DMA_INFO_STR p_dma_info,
 	return 0;
 }
 
+#if BTIF_RX_DMA_ZERO_COPY
+static unsigned int btif_dma_rx_data_deliver(void *p_dma_info,
+					     unsigned char *p_buf,
+					     unsigned int buf_len)
+{
+	unsigned int index = 0;
+	p_mtk_btif p_btif = &(g_btif[index]);
+
+	if (0 == buf_len)
+		return 0;
+
+/*save DMA Rx packet here*/
+	btif_log_buf_dmp_in(&p_btif->rx_log, p_buf, buf_len);
+
+/*p_buf points into Rx vFIFO, rx_cb may have been unregistered after irq*/
+	if (p_btif->rx_cb)
+		(*(p_btif->rx_cb)) (p_buf, buf_len);
+	else
+		btif_bbs_write(&(p_btif->btif_buf), p_buf, buf_len);
+
+	return 0;
+}
+
+static int btif_rx_dma_consummer(p_mtk_btif p_btif)
+{
+	int i_ret = 0;
+	P_MTK_DMA_INFO_STR p_rx_dma_info = p_btif->p_rx_dma->p_dma_info;
+
+#if MTK_BTIF_ENABLE_CLK_REF_COUNTER
+	hal_btif_clk_ctrl(p_btif->p_btif_info, CLK_OUT_ENABLE);
+	hal_btif_dma_clk_ctrl(p_rx_dma_info, CLK_OUT_ENABLE);
+#endif
+
+	i_ret = hal_rx_dma_consume(p_rx_dma_info, btif_dma_rx_data_deliver);
+
+#if MTK_BTIF_ENABLE_CLK_REF_COUNTER
+	hal_btif_dma_clk_ctrl(p_rx_dma_info, CLK_OUT_DISABLE);
+	hal_btif_clk_ctrl(p_btif->p_btif_info, CLK_OUT_DISABLE);
+#endif
+
+	return i_ret;
+}
+#endif
+
 unsigned int btif_pio_rx_data_receiver(P_MTK_BTIF_INFO_STR p_btif_info,
 				       unsigned char *p_buf,
 				       unsigned int buf_len)
@@ -2061,7 +2112,7 @@ static int _btif_state_deinit(p_mtk_btif p_btif)
 	return 0;
 }
 
-static int btif_rx_data_consummer(p_mtk_btif p_btif)
+static int btif_rx_bbs_consummer(p_mtk_btif p_btif)
 {
 	unsigned int length = 0;
 	unsigned char *p_buf = NULL;
@@ -2132,6 +2183,22 @@ we record wr_idx here*/
 	return length;
 }
 
+static int btif_rx_data_consummer(p_mtk_btif p_btif)
+{
+	int length = btif_rx_bbs_consummer(p_btif);
+
+#if BTIF_RX_DMA_ZERO_COPY
+/*btif_buf holds older data than vFIFO, so it is always drained first*/
+	if (atomic_xchg(&p_btif->rx_dma_defer, 0)) {
+		btif_rx_dma_consummer(p_btif);
+		/*without rx_cb, vFIFO data was copied to btif_buf instead*/
+		if (NULL == p_btif->rx_cb)
+			length = btif_rx_bbs_consummer(p_btif);
+	}
+#endif
+	return length;
+}
+
 #if BTIF_RXD_BE_BLOCKED_DETECT
 static int mtk_btif_rxd_be_blocked_by_timer(void)
 {
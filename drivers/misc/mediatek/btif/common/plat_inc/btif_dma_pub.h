@@ -166,6 +166,33 @@ bool hal_dma_is_tx_allow(P_MTK_DMA_INFO_STR p_dma_info);
 int hal_rx_dma_irq_handler(P_MTK_DMA_INFO_STR p_dma_info,
 			   unsigned char *p_buf, const unsigned int max_len);
 
+/*****************************************************************************
+* FUNCTION
+*  hal_rx_dma_irq_defer
+* DESCRIPTION
+*  ack rx dma interrupt and leave rx IER disabled, vFIFO data is kept for
+*  hal_rx_dma_consume to be called from bottom half
+* PARAMETERS
+* p_dma_info   [IN]        pointer to BTIF dma channel's information
+* RETURNS
+*  0 means success, negative means fail
+*****************************************************************************/
+int hal_rx_dma_irq_defer(P_MTK_DMA_INFO_STR p_dma_info);
+
+/*****************************************************************************
+* FUNCTION
+*  hal_rx_dma_consume
+* DESCRIPTION
+*  hand rx vFIFO data to rx_cb in place, rx_cb is called without lock held,
+*  rx IER is enabled again once vFIFO is empty
+* PARAMETERS
+* p_dma_info   [IN]        pointer to BTIF dma channel's information
+* rx_cb           [IN]        consumer of vFIFO data
+* RETURNS
+*  length of data consumed, negative means fail
+*****************************************************************************/
+int hal_rx_dma_consume(P_MTK_DMA_INFO_STR p_dma_info, dma_rx_buf_write rx_cb);
+
 /*****************************************************************************
 * FUNCTION
 *  hal_dma_dump_reg
@@ -764,6 +764,115 @@ static void *pBuf_kmalloc;
 /*	*/
 static volatile ISP_RT_BUF_STRUCT *pstRTBuf;
 
+/*
+ * Per dma port pass1 done rings. The port's pass1 ISR is the only producer
+ * (head), ISP_DONE_RING_DEQUE under Lock is the only consumer (tail), so no
+ * spinlock is shared with the ISR and each done wakes only that port's
+ * waiters instead of every IspInfo.WaitQueueHead sleeper.
+ */
+#define ISP_DONE_RING_SIZE 32	/* power of 2 */
+typedef struct {
+	unsigned int head;
+	unsigned int tail;
+	atomic_t dropped;
+	ISP_DONE_RING_ENTRY_STRUCT entry[ISP_DONE_RING_SIZE];
+	wait_queue_head_t WaitQueueHead;
+	struct mutex Lock;
+} ISP_DONE_RING;
+static ISP_DONE_RING g_IspDoneRing[_rt_dma_max_];
+
+static void ISP_DoneRing_Init(void)
+{
+	int i;
+
+	for (i = 0; i < _rt_dma_max_; i++) {
+		init_waitqueue_head(&g_IspDoneRing[i].WaitQueueHead);
+		mutex_init(&g_IspDoneRing[i].Lock);
+	}
+}
+
+/* first user only, nothing produces or consumes yet */
+static void ISP_DoneRing_Reset(void)
+{
+	int i;
+
+	for (i = 0; i < _rt_dma_max_; i++) {
+		g_IspDoneRing[i].head = 0;
+		g_IspDoneRing[i].tail = 0;
+		atomic_set(&g_IspDoneRing[i].dropped, 0);
+	}
+}
+
+/* ISR side, called once the buffer at ring_buf[dma].data[idx] is filled */
+static void ISP_DoneRing_Push(unsigned int dma, unsigned int idx)
+{
+	ISP_DONE_RING *pRing = &g_IspDoneRing[dma];
+	ISP_DONE_RING_ENTRY_STRUCT *pEntry;
+	unsigned int head = pRing->head;
+
+	if (head - ACCESS_ONCE(pRing->tail) >= ISP_DONE_RING_SIZE) {
+		atomic_inc(&pRing->dropped);
+	} else {
+		pEntry = &pRing->entry[head & (ISP_DONE_RING_SIZE - 1)];
+		pEntry->dma = dma;
+		pEntry->bufIdx = idx;
+		pEntry->memID = pstRTBuf->ring_buf[dma].data[idx].memID;
+		pEntry->img_cnt = pstRTBuf->ring_buf[dma].img_cnt;
+		pEntry->timeStampS = pstRTBuf->ring_buf[dma].data[idx].timeStampS;
+		pEntry->timeStampUs = pstRTBuf->ring_buf[dma].data[idx].timeStampUs;
+		/* entry must be visible before the consumer sees the new head */
+		smp_wmb();
+		ACCESS_ONCE(pRing->head) = head + 1;
+	}
+	if (waitqueue_active(&pRing->WaitQueueHead))
+		wake_up_interruptible(&pRing->WaitQueueHead);
+}
+
+static MINT32 ISP_DoneRing_Deque(ISP_DONE_RING_STRUCT *pDeque)
+{
+	ISP_DONE_RING *pRing;
+	unsigned int tail, n = 0;
+	long Timeout;
+
+	if (pDeque->dma >= _rt_dma_max_ || pDeque->count == 0)
+		return -EINVAL;
+	if (pDeque->count > ISP_DONE_RING_DEQUE_MAX)
+		pDeque->count = ISP_DONE_RING_DEQUE_MAX;
+	pRing = &g_IspDoneRing[pDeque->dma];
+
+	if (pDeque->timeout != 0) {
+		Timeout = (pDeque->timeout < 0) ? MAX_SCHEDULE_TIMEOUT :
+			  msecs_to_jiffies(pDeque->timeout);
+		Timeout = wait_event_interruptible_timeout(pRing->WaitQueueHead,
+				ACCESS_ONCE(pRing->head) != ACCESS_ONCE(pRing->tail), Timeout);
+		if (Timeout < 0)
+			return Timeout;
+	}
+
+	mutex_lock(&pRing->Lock);
+	tail = pRing->tail;
+	while (n < pDeque->count && tail != ACCESS_ONCE(pRing->head)) {
+		/* read the entry only after seeing the head that covers it */
+		smp_rmb();
+		pDeque->entry[n++] = pRing->entry[tail & (ISP_DONE_RING_SIZE - 1)];
+		tail++;
+	}
+	/* done reading the slots before handing them back to the ISR */
+	smp_mb();
+	ACCESS_ONCE(pRing->tail) = tail;
+	mutex_unlock(&pRing->Lock);
+
+	pDeque->count = n;
+	pDeque->dropped = atomic_xchg(&pRing->dropped, 0);
+	return (n || pDeque->timeout == 0) ? 0 : -ETIMEDOUT;
+}
+
+/*
+ * ZSL depth per pass1 tg, 0 when off. Written under SpinLockIrq[_IRQ], which
+ * the P1 done handling of both tgs runs under.
+ */
+static unsigned int g_IspZslDepth[_cam_tg2_ + 1];
+
 /* static ISP_DEQUE_BUF_INFO_STRUCT	g_deque_buf	= {0,{}};	// Marked to remove	build warning. */
 
 unsigned long g_Flash_SpinLock;
@@ -6827,6 +6936,7 @@ static MINT32 ISP_CAMSV_DONE_Buf_Time(unsigned int dma, CQ_RTBC_FBC fbc, unsigne
 			    (curr + 1) % pstRTBuf->ring_buf[dma].total_count;
 			pstRTBuf->ring_buf[dma].empty_count--;
 			pstRTBuf->ring_buf[dma].img_cnt = sof_count[out];
+			ISP_DoneRing_Push(dma, curr);
 
 			if (g1stSof[irqT] == MTRUE)
 				LOG_ERR("Done&&Sof recieve at the same time	in 1st f\n");
@@ -6877,12 +6987,156 @@ static MINT32 ISP_CAMSV_DONE_Buf_Time(unsigned int dma, CQ_RTBC_FBC fbc, unsigne
 
 /* mark	the	behavior of	reading	FBC	at local. to prevent hw	interruptting duing	sw isr flow. */
 /* above behavior will make	FBC	write-buffer-patch fail	at p1_done */
+/*
+ * ZSL: give the oldest filled buffers of the tg back to the HW until depth
+ * buffers are empty again, the same way ISP_RT_BUF_CTRL_ENQUE would. The ring
+ * is walked in HW order, so a LOCKED frame stops recycling until it is
+ * enqueued back. Called from the P1 done ISR under SpinLockIrq[_IRQ].
+ */
+static void ISP_ZSL_Recycle(eISPIrq irqT)
+{
+	unsigned int tg = (_IRQ == irqT) ? _cam_tg_ : _cam_tg2_;
+	unsigned int dma[2], fbc_reg[2], addr_reg[2];
+	unsigned int ref, total, idx, n, j;
+	CQ_RTBC_FBC fbc;
+	volatile ISP_RT_RING_BUF_INFO_STRUCT *pRing;
+
+	if (0 == g_IspZslDepth[tg])
+		return;
+
+	if (_IRQ == irqT) {
+		dma[0] = _imgo_;
+		dma[1] = _rrzo_;
+		fbc_reg[0] = ISP_REG_ADDR_IMGO_FBC;
+		fbc_reg[1] = ISP_REG_ADDR_RRZO_FBC;
+		addr_reg[0] = ISP_REG_ADDR_IMGO_BASE_ADDR;
+		addr_reg[1] = ISP_REG_ADDR_RRZO_BASE_ADDR;
+	} else {
+		dma[0] = _imgo_d_;
+		dma[1] = _rrzo_d_;
+		fbc_reg[0] = ISP_REG_ADDR_IMGO_D_FBC;
+		fbc_reg[1] = ISP_REG_ADDR_RRZO_D_FBC;
+		addr_reg[0] = ISP_REG_ADDR_IMGO_D_BASE_ADDR;
+		addr_reg[1] = ISP_REG_ADDR_RRZO_D_BASE_ADDR;
+	}
+
+	ref = pstRTBuf->ring_buf[dma[0]].active ? dma[0] : dma[1];
+	total = pstRTBuf->ring_buf[ref].total_count;
+	if (!pstRTBuf->ring_buf[ref].active || 0 == total)
+		return;
+
+	for (n = 0; n < total && pstRTBuf->ring_buf[ref].empty_count < g_IspZslDepth[tg]; n++) {
+		idx = (pstRTBuf->ring_buf[ref].start + pstRTBuf->ring_buf[ref].empty_count) % total;
+		for (j = 0; j < 2; j++) {
+			pRing = &pstRTBuf->ring_buf[dma[j]];
+			if (pRing->active && ISP_RTBC_BUF_FILLED != pRing->data[idx].bFilled)
+				return;
+		}
+		for (j = 0; j < 2; j++) {
+			pRing = &pstRTBuf->ring_buf[dma[j]];
+			if (!pRing->active)
+				continue;
+			pRing->data[idx].bFilled = ISP_RTBC_BUF_EMPTY;
+			pRing->empty_count++;
+			if (pRing->read_idx == idx)
+				pRing->read_idx = (idx + 1) % total;
+			fbc.Reg_val = ISP_RD32(fbc_reg[j]);
+			if ((fbc.Bits.FB_NUM == fbc.Bits.FBC_CNT) ||
+			    ((fbc.Bits.FB_NUM - 1) == fbc.Bits.FBC_CNT))
+				ISP_WR32(addr_reg[j], pRing->data[idx].base_pAddr);
+			fbc.Bits.RCNT_INC = 1;
+			ISP_WR32(fbc_reg[j], fbc.Reg_val);
+		}
+		if (IspInfo.DebugMask & ISP_DBG_BUF_CTRL)
+			IRQ_LOG_KEEPER(irqT, m_CurrentPPB, _LOG_INF, "[zsl]recycle tg(%d) idx(%d)\n", tg, idx);
+	}
+}
+
+static MINT32 ISP_ZSL_Ctrl(ISP_ZSL_CTRL_STRUCT *pZsl)
+{
+	unsigned int dma[2], ref, total, idx, j;
+	unsigned long long want, ts, diff, best_diff = 0;
+	signed int best = -1;
+	unsigned long flags;
+	volatile ISP_RT_BUF_INFO_STRUCT *pData;
+
+	if (pZsl->tg != _cam_tg_ && pZsl->tg != _cam_tg2_)
+		return -EINVAL;
+	dma[0] = (_cam_tg_ == pZsl->tg) ? _imgo_ : _imgo_d_;
+	dma[1] = (_cam_tg_ == pZsl->tg) ? _rrzo_ : _rrzo_d_;
+
+	switch (pZsl->ctrl) {
+	case ISP_ZSL_CTRL_ENABLE:
+		if (pZsl->depth < 2 || pZsl->depth > ISP_RT_BUF_SIZE)
+			return -EINVAL;
+		spin_lock_irqsave(&(IspInfo.SpinLockIrq[_IRQ]), flags);
+		g_IspZslDepth[pZsl->tg] = pZsl->depth;
+		spin_unlock_irqrestore(&(IspInfo.SpinLockIrq[_IRQ]), flags);
+		LOG_INF("[zsl]tg(%d) depth(%d)\n", pZsl->tg, pZsl->depth);
+		return 0;
+	case ISP_ZSL_CTRL_DISABLE:
+		spin_lock_irqsave(&(IspInfo.SpinLockIrq[_IRQ]), flags);
+		g_IspZslDepth[pZsl->tg] = 0;
+		spin_unlock_irqrestore(&(IspInfo.SpinLockIrq[_IRQ]), flags);
+		return 0;
+	case ISP_ZSL_CTRL_LOCK:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	want = (unsigned long long)pZsl->timeStampS * 1000000 + pZsl->timeStampUs;
+	spin_lock_irqsave(&(IspInfo.SpinLockIrq[_IRQ]), flags);
+	ref = pstRTBuf->ring_buf[dma[0]].active ? dma[0] : dma[1];
+	total = pstRTBuf->ring_buf[ref].total_count;
+	for (idx = 0; pstRTBuf->ring_buf[ref].active && idx < total; idx++) {
+		for (j = 0; j < 2; j++) {
+			if (pstRTBuf->ring_buf[dma[j]].active &&
+			    ISP_RTBC_BUF_FILLED != pstRTBuf->ring_buf[dma[j]].data[idx].bFilled)
+				break;
+		}
+		if (j < 2)
+			continue;
+		pData = &pstRTBuf->ring_buf[ref].data[idx];
+		ts = (unsigned long long)pData->timeStampS * 1000000 + pData->timeStampUs;
+		if (0 == want)
+			diff = ~ts;	/* newest wins */
+		else
+			diff = (ts > want) ? (ts - want) : (want - ts);
+		if (best < 0 || diff < best_diff) {
+			best = idx;
+			best_diff = diff;
+		}
+	}
+	if (best >= 0) {
+		for (j = 0; j < 2; j++) {
+			pData = &pstRTBuf->ring_buf[dma[j]].data[best];
+			if (!pstRTBuf->ring_buf[dma[j]].active) {
+				pZsl->memID[j] = 0;
+				pZsl->base_pAddr[j] = 0;
+				continue;
+			}
+			pData->bFilled = ISP_RTBC_BUF_LOCKED;
+			pZsl->memID[j] = pData->memID;
+			pZsl->base_pAddr[j] = pData->base_pAddr;
+		}
+		pData = &pstRTBuf->ring_buf[ref].data[best];
+		pZsl->timeStampS = pData->timeStampS;
+		pZsl->timeStampUs = pData->timeStampUs;
+	}
+	pZsl->bufIdx = best;
+	spin_unlock_irqrestore(&(IspInfo.SpinLockIrq[_IRQ]), flags);
+
+	return (best >= 0) ? 0 : -EAGAIN;
+}
+
 static MINT32 ISP_DONE_Buf_Time(eISPIrq irqT, CQ_RTBC_FBC *pFbc, unsigned long long sec,
 				unsigned long usec)
 {
 	int i, k, m;
 	int i_dma;
 	unsigned int curr;
+	int done_idx;
 	/* unsigned     int     reg_fbc; */
 	/* MUINT32 reg_val = 0; */
 	MUINT32 ch_imgo, ch_rrzo;
@@ -6996,6 +7250,7 @@ static MINT32 ISP_DONE_Buf_Time(eISPIrq irqT, CQ_RTBC_FBC *pFbc, unsigned long l
 			}
 #endif
 			curr = pstRTBuf->ring_buf[i_dma].start;
+			done_idx = -1;
 			/* MUINT32 loopCount = 0; */
 			while (1) {
 				if (IspInfo.DebugMask & ISP_DBG_INT_2) {
@@ -7014,6 +7269,7 @@ static MINT32 ISP_DONE_Buf_Time(eISPIrq irqT, CQ_RTBC_FBC *pFbc, unsigned long l
 							       i_dma, curr);
 					pstRTBuf->ring_buf[i_dma].data[curr].bFilled =
 					    ISP_RTBC_BUF_FILLED;
+					done_idx = curr;
 					/* start + 1 */
 					pstRTBuf->ring_buf[i_dma].start =
 					    (curr + 1) % pstRTBuf->ring_buf[i_dma].total_count;
@@ -7102,6 +7358,8 @@ static MINT32 ISP_DONE_Buf_Time(eISPIrq irqT, CQ_RTBC_FBC *pFbc, unsigned long l
 			/*      */
 			DMA_TRANS(i_dma, out);
 			pstRTBuf->ring_buf[i_dma].img_cnt = sof_count[out];
+			if (done_idx >= 0)
+				ISP_DoneRing_Push(i_dma, done_idx);
 		}
 	}
 
@@ -7135,6 +7393,8 @@ static MINT32 ISP_DONE_Buf_Time(eISPIrq irqT, CQ_RTBC_FBC *pFbc, unsigned long l
 	pstRTBuf->state = ISP_RTBC_STATE_DONE;
 	/* spin_unlock_irqrestore(&(IspInfo.SpinLockRTBC),g_Flash_SpinLock); */
 
+	ISP_ZSL_Recycle(irqT);
+
 	return 0;
 }
 
@@ -9959,6 +10219,8 @@ static long ISP_ioctl(struct file *pFile, unsigned int Cmd, unsigned long Param)
 	int userKey = -1;
 	int	type	=  0;
 	ISP_REGISTER_USERKEY_STRUCT RegUserKey;
+	ISP_DONE_RING_STRUCT doneDeque;
+	ISP_ZSL_CTRL_STRUCT zslCtrl;
 	/*      */
 	if (pFile->private_data == NULL) {
 		LOG_WRN("private_data is NULL,(process,	pid, tgid)=(%s,	%d,	%d)", current->comm,
@@ -10545,6 +10807,32 @@ static long ISP_ioctl(struct file *pFile, unsigned int Cmd, unsigned long Param)
 	case ISP_WAIT_DUMPIMEM:
 		Ret = ISP_WaitImemDump(pUserInfo->Pid);
 		break;
+	case ISP_DONE_RING_DEQUE:
+		if (copy_from_user(&doneDeque, (void *)Param, sizeof(ISP_DONE_RING_STRUCT)) == 0) {
+			Ret = ISP_DoneRing_Deque(&doneDeque);
+			if (Ret == 0 &&
+			    copy_to_user((void *)Param, &doneDeque, sizeof(ISP_DONE_RING_STRUCT)) != 0) {
+				LOG_ERR("copy_to_user failed");
+				Ret = -EFAULT;
+			}
+		} else {
+			LOG_ERR("copy_from_user	failed");
+			Ret = -EFAULT;
+		}
+		break;
+	case ISP_ZSL_CTRL:
+		if (copy_from_user(&zslCtrl, (void *)Param, sizeof(ISP_ZSL_CTRL_STRUCT)) == 0) {
+			Ret = ISP_ZSL_Ctrl(&zslCtrl);
+			if (Ret == 0 &&
+			    copy_to_user((void *)Param, &zslCtrl, sizeof(ISP_ZSL_CTRL_STRUCT)) != 0) {
+				LOG_ERR("copy_to_user failed");
+				Ret = -EFAULT;
+			}
+		} else {
+			LOG_ERR("copy_from_user	failed");
+			Ret = -EFAULT;
+		}
+		break;
 	case ISP_WRITE_DUMPIMEM:
 		if (copy_from_user(&type, (void *)Param, sizeof(MINT32)) == 0)	{
 			Ret = ISP_WriteImemDump(pUserInfo->Pid, type);
@@ -11141,6 +11429,9 @@ static long ISP_ioctl_compat(struct file *filp, unsigned int cmd, unsigned long
 	case ISP_WAKELOCK_CTRL:
 	case ISP_WAIT_DUMPIMEM:
 	case ISP_WRITE_DUMPIMEM:
+		/* structure (no pointer) */
+	case ISP_DONE_RING_DEQUE:
+	case ISP_ZSL_CTRL:
 		return filp->f_op->unlocked_ioctl(filp, cmd, arg);
 	default:
 		return -ENOIOCTLCMD;
@@ -11203,6 +11494,8 @@ static MINT32 ISP_open(struct inode *pInode, struct file *pFile)
 	/* do wait queue head init when re-enter in camera */
 	EDBufQueRemainNodeCnt = 0;
 	P2_Support_BurstQNum = 1;
+	ISP_DoneRing_Reset();
+	memset(g_IspZslDepth, 0, sizeof(g_IspZslDepth));
 	/*      */
 	for (i = 0; i < IRQ_USER_NUM_MAX; i++) {
 		FirstUnusedIrqUserKey = 1;
@@ -11812,6 +12105,7 @@ static MINT32 ISP_probe(struct platform_device *pDev)
 #endif
 	/*      */
 	init_waitqueue_head((wait_queue_head_t *)&IspInfo.WaitQueueHead);
+	ISP_DoneRing_Init();
 	tasklet_init(&isp_tasklet, ISP_TaskletFunc, 0);
 
 #ifdef CONFIG_PM_WAKELOCKS
@@ -587,6 +587,48 @@ typedef struct {
 	unsigned int img_cnt;	/* cnt for mapping to which sof */
 	ISP_RT_BUF_INFO_STRUCT data[ISP_RT_BUF_SIZE];
 } ISP_RT_RING_BUF_INFO_STRUCT;
+/* one pass1 done buffer, as pushed by the ISR into the port's done ring */
+typedef struct {
+	unsigned int dma;	/* _isp_dma_enum_ */
+	unsigned int bufIdx;	/* index into ring_buf[dma].data[] */
+	unsigned int memID;
+	unsigned int img_cnt;	/* sof count the frame belongs to */
+	unsigned int timeStampS;
+	unsigned int timeStampUs;
+} ISP_DONE_RING_ENTRY_STRUCT;
+
+#define ISP_DONE_RING_DEQUE_MAX 4
+/* ISP_DONE_RING_DEQUE: wait on one dma port and take its done entries */
+typedef struct {
+	unsigned int dma;	/* in: port */
+	signed int timeout;	/* in: ms, <0 wait forever, 0 poll */
+	unsigned int count;	/* in: max entries wanted, out: entries returned */
+	unsigned int dropped;	/* out: entries lost to overflow since last call */
+	ISP_DONE_RING_ENTRY_STRUCT entry[ISP_DONE_RING_DEQUE_MAX];
+} ISP_DONE_RING_STRUCT;
+/*  */
+typedef enum {
+	ISP_ZSL_CTRL_ENABLE,	/* 0 */
+	ISP_ZSL_CTRL_DISABLE,	/* 1 */
+	ISP_ZSL_CTRL_LOCK,	/* 2 */
+} ISP_ZSL_CTRL_ENUM;
+/*
+ * ISP_ZSL_CTRL: with ZSL enabled on a pass1 tg, the P1 done ISR hands the
+ * oldest filled imgo/rrzo buffer back to the HW whenever fewer than depth
+ * empty buffers are left, so no per frame enque is needed. LOCK takes the
+ * filled frame closest to the given time stamp (0: newest) out of the ring;
+ * it is given back with the usual ISP_RT_BUF_CTRL_ENQUE of each port.
+ */
+typedef struct {
+	unsigned int ctrl;	/* ISP_ZSL_CTRL_ENUM */
+	unsigned int tg;	/* _cam_tg_ or _cam_tg2_ */
+	unsigned int depth;	/* ENABLE: empty buffers kept ahead of the HW, >= 2 */
+	unsigned int timeStampS;	/* LOCK in: wanted frame, out: locked frame */
+	unsigned int timeStampUs;
+	signed int bufIdx;	/* LOCK out: index into ring_buf[].data[] */
+	unsigned int memID[2];	/* LOCK out: imgo, rrzo (0 if port not active) */
+	unsigned int base_pAddr[2];
+} ISP_ZSL_CTRL_STRUCT;
 /*  */
 typedef enum {
 	ISP_RT_BUF_CTRL_ENQUE,	/* 0 */
@@ -886,6 +928,8 @@ typedef enum {
 	ISP_CMD_FLUSH_IRQ_REQUEST,                    /* flush signal */
 	ISP_CMD_WAIT_DUMPIMEM,                    /* wait for dumping imem dbg msg */
 	ISP_CMD_WRITE_DUMPIMEM,                    /* write type for dump imem dbg msg */
+	ISP_CMD_DONE_RING_DEQUE,                   /* per dma port pass1 done queue */
+	ISP_CMD_ZSL_CTRL,                          /* kernel recycled pass1 ring for ZSL */
 } ISP_CMD_ENUM;
 /*  */
 #define ISP_RESET_CAM_P1    _IO(ISP_MAGIC, ISP_CMD_RESET_CAM_P1)
@@ -928,6 +972,8 @@ typedef enum {
 #define ISP_WRITE_DUMPIMEM       _IOW(ISP_MAGIC, ISP_CMD_WRITE_DUMPIMEM, int)
 
 #define ISP_WAKELOCK_CTRL     _IOWR(ISP_MAGIC, ISP_CMD_WAKELOCK_CTRL,      unsigned int)
+#define ISP_DONE_RING_DEQUE   _IOWR(ISP_MAGIC, ISP_CMD_DONE_RING_DEQUE,    ISP_DONE_RING_STRUCT)
+#define ISP_ZSL_CTRL          _IOWR(ISP_MAGIC, ISP_CMD_ZSL_CTRL,           ISP_ZSL_CTRL_STRUCT)
 
 #ifdef CONFIG_COMPAT
 
@@ -10,6 +10,8 @@
 #include <linux/slab.h>
 
 #include <linux/firmware.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
 #include <linux/syscalls.h>
 #include <linux/uaccess.h>
 #include <linux/platform_device.h>
@@ -699,7 +701,8 @@ static void get_md_postfix(int md_id, char k[], char buf[], char buf_ex[])
 	}
 }
 static int check_if_bypass_header(void *buf, int *img_size);
-int ccci_load_firmware(int md_id, void *img_inf, char img_err_str[], char post_fix[], struct device *dev)
+int ccci_load_md_firmware(int md_id, void *img_inf, char img_err_str[], char post_fix[], struct device *dev,
+			  void (*hdr_ready)(void *data), void *data)
 {
 #define MAX_REMAP_SIZE (1024 * 1024)
 	int i = 0;
@@ -708,9 +711,7 @@ int ccci_load_firmware(int md_id, void *img_inf, char img_err_str[], char post_f
 	int read_size = 0;
 	unsigned long load_addr = 0;
 	void *start = NULL;
-	unsigned long end_addr;
 	const struct firmware *fw_entry = NULL;
-	const int dsp_header_size = 1024;
 	int size_per_read = MAX_REMAP_SIZE;
 	char img_name[IMG_NAME_LEN];
 	struct ccci_image_info *img = (struct ccci_image_info *)img_inf;
@@ -784,20 +785,41 @@ TRY_LOAD_IMG:
 	CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "Not cipher image: %s Firmware:size=%zu, img_size=%d\n",
 		img_name, fw_entry->size, img->size);
 
+	/* check header straight from the firmware buffer, a mismatch is found before the copy */
+	CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "Firmware check header:load_addr=%lx, size=%d\n", load_addr, img->size);
+	if (img->type == IMG_MD) {
+		check_ret = check_md_header(md_id, img_data_ptr + img->size, img);
+		if (check_ret < 0) {
+			ret = check_ret;
+			goto out;
+		}
+	} else if (img->type == IMG_DSP) {
+		check_ret = check_dsp_header(md_id, img_data_ptr, img);
+		if (check_ret < 0) {
+			ret = check_ret;
+			goto out;
+		}
+	}
+	if (hdr_ready)
+		hdr_ready(data);
+
 	while (1) {
-		/*  Map 1M memory */
-		CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "Firmware:read_size=%d, size_per_read=%d\n", read_size, size_per_read);
-		start = ioremap_nocache((load_addr + read_size), MAX_REMAP_SIZE);
+		/*  Map 1M memory, write combined: nothing reads it back before the modem boots */
+		CCCI_UTIL_DBG_MSG_WITH_ID(md_id, "Firmware:read_size=%d, size_per_read=%d\n", read_size, size_per_read);
+		start = ioremap_wc((load_addr + read_size), MAX_REMAP_SIZE);
 		if (start == 0) {
 			CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "image ioremap fail %d\n",
 						(unsigned int)(load_addr + read_size));
-			return -CCCI_ERR_LOAD_IMG_NOMEM;
+			ret = -CCCI_ERR_LOAD_IMG_NOMEM;
+			goto out;
 		}
 		if (read_size + size_per_read > img->size - img->tail_length)
 			size_per_read = img->size - img->tail_length - read_size;
 		else
 			size_per_read = MAX_REMAP_SIZE;
 		memcpy(start, (void *)(img_data_ptr + read_size), size_per_read);
+		/* drain the write buffer before the mapping goes */
+		wmb();
 		iounmap(start);
 		start = NULL;
 		read_size += size_per_read;
@@ -805,25 +827,6 @@ TRY_LOAD_IMG:
 			break;
 	}
 
-	CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "Firmware check header:load_addr=%lx, size=%d\n", load_addr, img->size);
-	if (img->type == IMG_MD) {
-		start = ioremap_nocache(round_down(load_addr + img->size - 0x4000, 0x4000),
-			round_up(img->size, 0x4000) - round_down(img->size - 0x4000, 0x4000));
-		end_addr =
-		    ((unsigned long)start + img->size - round_down(img->size - 0x4000, 0x4000));
-		check_ret = check_md_header(md_id, (void *)end_addr, img);
-		if (check_ret < 0) {
-			ret = check_ret;
-			goto out;
-		}
-	} else if (img->type == IMG_DSP) {
-		start = ioremap_nocache(load_addr, dsp_header_size);
-		check_ret = check_dsp_header(md_id, start, img);
-		if (check_ret < 0) {
-			ret = check_ret;
-			goto out;
-		}
-	}
 	ret = read_size;
 	CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "Request firmware: %s (size=0x%x) to 0x%lx\n",
 		     img->file_name, img->size - img->tail_length, load_addr);
@@ -855,6 +858,38 @@ TRY_LOAD_IMG:
 	return ret;
 }
 
+int ccci_load_firmware(int md_id, void *img_inf, char img_err_str[], char post_fix[], struct device *dev)
+{
+	return ccci_load_md_firmware(md_id, img_inf, img_err_str, post_fix, dev, NULL, NULL);
+}
+
+static void ccci_load_firmware_work(struct work_struct *work)
+{
+	struct ccci_img_load *load = container_of(work, struct ccci_img_load, work);
+
+	load->ret = ccci_load_firmware(load->md_id, load->img, load->err_str, load->post_fix, load->dev);
+	complete(&load->done);
+}
+
+void ccci_load_firmware_start(struct ccci_img_load *load, int md_id, struct ccci_image_info *img,
+			      struct device *dev)
+{
+	load->md_id = md_id;
+	load->img = img;
+	load->dev = dev;
+	load->err_str[0] = '\0';
+	init_completion(&load->done);
+	INIT_WORK_ONSTACK(&load->work, ccci_load_firmware_work);
+	queue_work(system_unbound_wq, &load->work);
+}
+
+int ccci_load_firmware_wait(struct ccci_img_load *load)
+{
+	wait_for_completion(&load->done);
+	destroy_work_on_stack(&load->work);
+	return load->ret;
+}
+
 #if 0
 int get_img_info(int md_id, int img_type, struct ccci_image_info *info_ptr)
 {
@@ -31,6 +31,9 @@
 #include <linux/sockios.h>
 #include <linux/device.h>
 #include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/if_arp.h>
+#include <net/busy_poll.h>
 #include <trace/events/netdev_rx.h>
 #include "ccmni.h"
 
@@ -38,6 +41,13 @@
 ccmni_ctl_block_t *ccmni_ctl_blk[MAX_MD_NUM];
 unsigned int ccmni_debug_level = 0;
 unsigned long long net_rx_delay[4];
+/* TX classifier tunables, see ccmni_tx_classify() */
+static unsigned int ccmni_tx_small_len = 256;
+static unsigned int ccmni_tx_flow_quota = 32 * 1024;
+#ifdef CONFIG_NET_RX_BUSY_POLL
+/* CPUs a SO_BUSY_POLL socket may spin on the RX backlog from, bit n = CPU n */
+static unsigned int ccmni_busy_poll_cpus = 0xFFFFFFFF;
+#endif
 
 /********************internal function*********************/
 static int get_ccmni_idx_from_ch(int md_id, int ch)
@@ -132,6 +142,53 @@ static inline int is_ack_skb(int md_id, struct sk_buff *skb)
 	return ret;
 }
 
+/*
+ * pick the TX queue of a packet: pure ACKs go to the FAST queue, small packets to the INTERACTIVE
+ * one and the rest to the NORMAL queue. A flow may only send ccmni_tx_flow_quota bytes of small packets
+ * per CCMNI_TX_FLOW_WINDOW ahead of bulk, beyond that it is demoted to NORMAL for the rest of the window,
+ * so a flood of small packets can't starve the interactive flows sharing the ACK channel.
+ * the flow table is racy between CPUs, which only skews the accounting a bit.
+ */
+static u16 ccmni_tx_classify(ccmni_instance_t *ccmni, struct sk_buff *skb)
+{
+	struct ccmni_tx_flow *flow;
+
+	if (is_ack_skb(ccmni->md_id, skb))
+		return CCMNI_TXQ_FAST;
+	if (skb->len > ccmni_tx_small_len)
+		return CCMNI_TXQ_NORMAL;
+
+	flow = &ccmni->tx_flow[skb_get_hash(skb) % CCMNI_TX_FLOW_NUM];
+	if (time_after(jiffies, flow->start + CCMNI_TX_FLOW_WINDOW)) {
+		flow->start = jiffies;
+		flow->bytes = 0;
+	}
+	flow->bytes += skb->len;
+	if (flow->bytes > ccmni_tx_flow_quota) {
+		ccmni->tx_demoted++;
+		return CCMNI_TXQ_NORMAL;
+	}
+	return CCMNI_TXQ_INTERACTIVE;
+}
+
+/* stop or wake the netdev TX queues sitting on the CCCI TX channel ch_num */
+static void ccmni_tx_queue_ctl(ccmni_instance_t *ccmni, unsigned int ch_num, int stop)
+{
+	struct netdev_queue *net_queue;
+	int ack_ch = (ch_num == CCCI_CCMNI1_DL_ACK) || (ch_num == CCCI_CCMNI2_DL_ACK);
+	int qno;
+
+	for (qno = 0; qno < CCMNI_TXQ_NUM; qno++) {
+		if (ack_ch == (qno == CCMNI_TXQ_NORMAL))
+			continue;
+		net_queue = netdev_get_tx_queue(ccmni->dev, qno);
+		if (stop)
+			netif_tx_stop_queue(net_queue);
+		else if (netif_tx_queue_stopped(net_queue))
+			netif_tx_wake_queue(net_queue);
+	}
+}
+
 
 /********************internal debug function*********************/
 #if 1
@@ -186,7 +243,7 @@ static void ccmni_dbg_skb_header(int md_id, bool tx, struct sk_buff *skb)
 	__be16 frag_off;
 	u32 l4_off;
 
-	if (!tx) {
+	if (!tx && skb->dev->type == ARPHRD_ETHER) {
 		ethh = (struct ethhdr *)(skb->data-ETH_HLEN);
 		ccmni_dbg_eth_header(md_id, tx, ethh);
 	}
@@ -212,6 +269,93 @@ static void ccmni_dbg_skb_header(int md_id, bool tx, struct sk_buff *skb)
 }
 #endif
 
+static int ccmni_gro_stat_show(struct seq_file *m, void *v)
+{
+	int md_id = (int)(long)m->private;
+	ccmni_ctl_block_t *ctlb = ccmni_ctl_blk[md_id];
+	ccmni_instance_t *ccmni;
+	unsigned long rx;
+	int i;
+
+	if (ctlb == NULL || ctlb->ccci_ops == NULL)
+		return 0;
+
+	for (i = 0; i < ctlb->ccci_ops->ccmni_num; i++) {
+		if (ctlb->ccmni_inst[i] == NULL || ctlb->ccmni_inst[i]->dev == NULL)
+			continue;
+		/* the stats live in the instance owning the netdev */
+		ccmni = (ccmni_instance_t *)netdev_priv(ctlb->ccmni_inst[i]->dev);
+		rx = ccmni->rx_gro_merged + ccmni->rx_gro_held + ccmni->rx_gro_normal;
+		seq_printf(m, "%s: rx=%lu merged=%lu held=%lu normal=%lu drop=%lu polls=%lu hit=%lu%%\n",
+			ccmni->dev->name, rx, ccmni->rx_gro_merged, ccmni->rx_gro_held,
+			ccmni->rx_gro_normal, ccmni->rx_gro_drop, ccmni->rx_polls,
+			rx ? ccmni->rx_gro_merged * 100 / rx : 0);
+	}
+
+	return 0;
+}
+
+static int ccmni_gro_stat_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, ccmni_gro_stat_show, inode->i_private);
+}
+
+static const struct file_operations ccmni_gro_stat_fops = {
+	.open = ccmni_gro_stat_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int ccmni_tx_queue_show(struct seq_file *m, void *v)
+{
+	int md_id = (int)(long)m->private;
+	ccmni_ctl_block_t *ctlb = ccmni_ctl_blk[md_id];
+	ccmni_instance_t *ccmni;
+	struct netdev_queue *txq;
+	struct Qdisc *q;
+	unsigned int qno;
+	int i;
+
+	if (ctlb == NULL || ctlb->ccci_ops == NULL)
+		return 0;
+
+	for (i = 0; i < ctlb->ccci_ops->ccmni_num; i++) {
+		if (ctlb->ccmni_inst[i] == NULL || ctlb->ccmni_inst[i]->dev == NULL)
+			continue;
+		ccmni = (ccmni_instance_t *)netdev_priv(ctlb->ccmni_inst[i]->dev);
+		seq_printf(m, "%s: demoted=%lu\n", ccmni->dev->name, ccmni->tx_demoted);
+		for (qno = 0; qno < ccmni->dev->real_num_tx_queues; qno++) {
+			txq = netdev_get_tx_queue(ccmni->dev, qno);
+			rcu_read_lock_bh();
+			q = rcu_dereference_bh(txq->qdisc);
+			seq_printf(m, "  txq%u: pkts=%lu qlen=%u stopped=%d", qno,
+				qno < CCMNI_TXQ_NUM ? ccmni->tx_class_pkts[qno] : 0,
+				q ? qdisc_qlen(q) : 0, netif_tx_queue_stopped(txq));
+			rcu_read_unlock_bh();
+#ifdef CONFIG_BQL
+			seq_printf(m, " inflight=%u limit=%u", txq->dql.num_queued - txq->dql.num_completed,
+				txq->dql.limit);
+#endif
+			seq_puts(m, "\n");
+		}
+	}
+
+	return 0;
+}
+
+static int ccmni_tx_queue_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, ccmni_tx_queue_show, inode->i_private);
+}
+
+static const struct file_operations ccmni_tx_queue_fops = {
+	.open = ccmni_tx_queue_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 /* ccmni debug sys file create */
 int ccmni_debug_file_init(int md_id)
 {
@@ -242,6 +386,19 @@ int ccmni_debug_file_init(int md_id)
 		return -ENOENT;
 	}
 
+	dentry3 = debugfs_create_file("gro_stat", 0400, dentry2, (void *)(long)md_id, &ccmni_gro_stat_fops);
+	if (!dentry3)
+		CCMNI_ERR_MSG(md_id, "create /proc/ccmni/md%d/gro_stat fail\n", md_id);
+
+	dentry3 = debugfs_create_file("tx_queue", 0400, dentry2, (void *)(long)md_id, &ccmni_tx_queue_fops);
+	if (!dentry3)
+		CCMNI_ERR_MSG(md_id, "create /proc/ccmni/md%d/tx_queue fail\n", md_id);
+	debugfs_create_u32("tx_small_len", 0600, dentry2, &ccmni_tx_small_len);
+	debugfs_create_u32("tx_flow_quota", 0600, dentry2, &ccmni_tx_flow_quota);
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	debugfs_create_x32("busy_poll_cpus", 0600, dentry2, &ccmni_busy_poll_cpus);
+#endif
+
 	return 0;
 }
 
@@ -251,12 +408,9 @@ static u16 ccmni_select_queue(struct net_device *dev, struct sk_buff *skb,
 {
 	ccmni_instance_t *ccmni = (ccmni_instance_t *)netdev_priv(dev);
 
-	if (ccmni->ch.rx == CCCI_CCMNI1_RX || ccmni->ch.rx == CCCI_CCMNI2_RX) {
-		if (is_ack_skb(ccmni->md_id, skb))
-			return CCMNI_TXQ_FAST;
-		else
-			return CCMNI_TXQ_NORMAL;
-	} else
+	if (ccmni->ch.rx == CCCI_CCMNI1_RX || ccmni->ch.rx == CCCI_CCMNI2_RX)
+		return ccmni_tx_classify(ccmni, skb);
+	else
 		return CCMNI_TXQ_NORMAL;
 }
 
@@ -276,10 +430,10 @@ static int ccmni_open(struct net_device *dev)
 	else
 		netif_start_queue(dev);
 
-	if (unlikely(ccmni_ctl->ccci_ops->md_ability & MODEM_CAP_NAPI)) {
-		napi_enable(&ccmni->napi);
+	napi_enable(&ccmni->napi);
+	napi_hash_add(&ccmni->napi);
+	if (unlikely(ccmni_ctl->ccci_ops->md_ability & MODEM_CAP_NAPI))
 		napi_schedule(&ccmni->napi);
-	}
 
 	atomic_inc(&ccmni->usage);
 	ccmni_tmp = ccmni_ctl->ccmni_inst[ccmni->index];
@@ -313,8 +467,9 @@ static int ccmni_close(struct net_device *dev)
 	else
 		netif_stop_queue(dev);
 
-	if (unlikely(ccmni_ctl->ccci_ops->md_ability & MODEM_CAP_NAPI))
-		napi_disable(&ccmni->napi);
+	napi_hash_del(&ccmni->napi);
+	napi_disable(&ccmni->napi);
+	skb_queue_purge(&ccmni->rx_list);
 
 	CCMNI_INF_MSG(ccmni->md_id, "%s_Close: cnt=(%d, %d)\n",
 		dev->name, atomic_read(&ccmni->usage), atomic_read(&ccmni_tmp->usage));
@@ -351,7 +506,11 @@ static int ccmni_start_xmit(struct sk_buff *skb, struct net_device *dev)
 	ccci_tx_ch = tx_ch = ccmni->ch.tx;
 	if (ctlb->ccci_ops->md_ability & MODEM_CAP_DATA_ACK_DVD) {
 		if (ccmni->ch.rx == CCCI_CCMNI1_RX || ccmni->ch.rx == CCCI_CCMNI2_RX) {
-			is_ack = is_ack_skb(ccmni->md_id, skb);
+			/* with multiple TX queues ccmni_select_queue() has classified it */
+			if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ)
+				is_ack = (skb_get_queue_mapping(skb) != CCMNI_TXQ_NORMAL);
+			else
+				is_ack = is_ack_skb(ccmni->md_id, skb);
 			if (is_ack)
 				ccci_tx_ch = (ccmni->ch.tx == CCCI_CCMNI1_TX)?CCCI_CCMNI1_DL_ACK:CCCI_CCMNI2_DL_ACK;
 			else
@@ -379,6 +538,8 @@ static int ccmni_start_xmit(struct sk_buff *skb, struct net_device *dev)
 	}
 	dev->stats.tx_packets++;
 	dev->stats.tx_bytes += skb_len;
+	if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ)
+		ccmni->tx_class_pkts[skb_get_queue_mapping(skb)]++;
 	if (ccmni->tx_busy_cnt > 10) {
 		CCMNI_ERR_MSG(ccmni->md_id, "[TX]CCMNI%d TX busy: tx_pkt=%ld retry %ld times done\n",
 			ccmni->index, dev->stats.tx_packets, ccmni->tx_busy_cnt);
@@ -546,6 +707,10 @@ static int ccmni_ioctl(struct net_device *dev, struct ifreq *ifr, int cmd)
 	return 0;
 }
 
+#ifdef CONFIG_NET_RX_BUSY_POLL
+static int ccmni_busy_poll(struct napi_struct *napi);
+#endif
+
 static const struct net_device_ops ccmni_netdev_ops = {
 	.ndo_open		= ccmni_open,
 	.ndo_stop		= ccmni_close,
@@ -554,21 +719,107 @@ static const struct net_device_ops ccmni_netdev_ops = {
 	.ndo_do_ioctl   = ccmni_ioctl,
 	.ndo_change_mtu = ccmni_change_mtu,
 	.ndo_select_queue = ccmni_select_queue,
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	.ndo_busy_poll	= ccmni_busy_poll,
+#endif
 };
 
+static void ccmni_gro_receive(ccmni_instance_t *ccmni, struct sk_buff *skb)
+{
+	switch (napi_gro_receive(&ccmni->napi, skb)) {
+	case GRO_MERGED:
+	case GRO_MERGED_FREE:
+		ccmni->rx_gro_merged++;
+		break;
+	case GRO_HELD:
+		ccmni->rx_gro_held++;
+		break;
+	case GRO_DROP:
+		ccmni->rx_gro_drop++;
+		break;
+	default:
+		ccmni->rx_gro_normal++;
+		break;
+	}
+}
+
+/*
+ * With MODEM_CAP_NAPI the CCCI driver polls its RX queue and calls back
+ * ccmni_rx_callback() from here. Otherwise ccmni_rx_callback() queues
+ * the packets on rx_list and they are fed to GRO here in one batch.
+ */
 static int ccmni_napi_poll(struct napi_struct *napi , int budget)
 {
 	ccmni_instance_t *ccmni = (ccmni_instance_t *)netdev_priv(napi->dev);
 	int md_id = ccmni->md_id;
 	ccmni_ctl_block_t *ctlb = ccmni_ctl_blk[md_id];
+	struct sk_buff *skb;
+	int work = 0;
 
-	del_timer(&ccmni->timer);
+	ccmni->rx_polls++;
+	if (ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI) {
+		del_timer(&ccmni->timer);
 
-	if (ctlb->ccci_ops->napi_poll)
-		return ctlb->ccci_ops->napi_poll(md_id, ccmni->ch.rx, napi, budget);
-	else
-		return 0;
+		if (ctlb->ccci_ops->napi_poll)
+			return ctlb->ccci_ops->napi_poll(md_id, ccmni->ch.rx, napi, budget);
+		else
+			return 0;
+	}
+
+	while (work < budget && (skb = skb_dequeue(&ccmni->rx_list)) != NULL) {
+		skb_mark_napi_id(skb, napi);
+		ccmni_gro_receive(ccmni, skb);
+		work++;
+	}
+
+	if (work < budget) {
+		napi_complete(napi);
+		/* a packet queued after the last dequeue lost its schedule */
+		if (!skb_queue_empty(&ccmni->rx_list))
+			napi_schedule(napi);
+	}
+
+	return work;
+}
+
+#ifdef CONFIG_NET_RX_BUSY_POLL
+/*
+ * Called by a SO_BUSY_POLL socket waiting for data. The rx_list backlog is
+ * drained the same way ccmni_napi_poll() does, after taking NAPI_STATE_SCHED
+ * so that GRO state is never touched from two CPUs. With MODEM_CAP_NAPI the
+ * CCCI queue belongs to the CCCI driver and busy polling is refused.
+ */
+static int ccmni_busy_poll(struct napi_struct *napi)
+{
+	ccmni_instance_t *ccmni = (ccmni_instance_t *)netdev_priv(napi->dev);
+	struct sk_buff *skb;
+	int work = 0;
+
+	if (ccmni->ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI)
+		return LL_FLUSH_FAILED;
+	/* keep latency sensitive spinning on the cluster it was placed on */
+	if (smp_processor_id() >= 32 || !(ccmni_busy_poll_cpus & (1U << smp_processor_id())))
+		return LL_FLUSH_FAILED;
+	if (!napi_schedule_prep(napi))
+		return LL_FLUSH_BUSY;
+
+	while (work < CCMNI_BUSY_POLL_BUDGET && (skb = skb_dequeue(&ccmni->rx_list)) != NULL) {
+		skb_mark_napi_id(skb, napi);
+		ccmni_gro_receive(ccmni, skb);
+		work++;
+	}
+	napi_gro_flush(napi, false);
+
+	/* never on a poll list, so release ownership without napi_complete() */
+	smp_mb__before_atomic();
+	clear_bit(NAPI_STATE_SCHED, &napi->state);
+	/* a packet queued meanwhile could not schedule the NAPI */
+	if (!skb_queue_empty(&ccmni->rx_list))
+		napi_schedule(napi);
+
+	return work;
 }
+#endif
 
 static void ccmni_napi_poll_timeout(unsigned long data)
 {
@@ -602,12 +853,16 @@ static inline int ccmni_inst_init(int md_id, ccmni_instance_t *ccmni, struct net
 	ccmni->ch.tx_ack = channel.tx_ack;
 
 	/* register napi device */
-	if (dev && (ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI)) {
-		init_timer(&ccmni->timer);
-		ccmni->timer.function = ccmni_napi_poll_timeout;
-		ccmni->timer.data = (unsigned long)ccmni;
+	skb_queue_head_init(&ccmni->rx_list);
+	init_timer(&ccmni->timer);
+	ccmni->timer.function = ccmni_napi_poll_timeout;
+	ccmni->timer.data = (unsigned long)ccmni;
+	if (dev && (ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI))
 		netif_napi_add(dev, &ccmni->napi, ccmni_napi_poll, ctlb->ccci_ops->napi_poll_weigh);
-	}
+	else if (dev && ccmni == netdev_priv(dev))
+		/* RX backlog for GRO, an IRAT instance uses the owner's one */
+		netif_napi_add(dev, &ccmni->napi, ccmni_napi_poll,
+			ctlb->ccci_ops->napi_poll_weigh ? : NAPI_POLL_WEIGHT);
 
 	atomic_set(&ccmni->usage, 0);
 	spin_lock_init(&ccmni->spinlock);
@@ -660,8 +915,8 @@ static int ccmni_init(int md_id, ccmni_ccci_ops_t *ccci_info)
 		for (i = 0; i < ctlb->ccci_ops->ccmni_num; i++) {
 			/* allocate netdev */
 			if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ)
-				/* alloc multiple tx queue, 2 txq and 1 rxq */
-				dev = alloc_etherdev_mqs(sizeof(ccmni_instance_t), 2, 1);
+				/* alloc multiple tx queue, CCMNI_TXQ_NUM txq and 1 rxq */
+				dev = alloc_etherdev_mqs(sizeof(ccmni_instance_t), CCMNI_TXQ_NUM, 1);
 			else
 				dev = alloc_etherdev(sizeof(ccmni_instance_t));
 			if (unlikely(dev == NULL)) {
@@ -683,8 +938,19 @@ static int ccmni_init(int md_id, ccmni_ccci_ops_t *ccci_info)
 				dev->hw_features |= NETIF_F_SG;
 			}
 			dev->addr_len = ETH_ALEN; /* ethernet header size */
+			if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_RAWIP) {
+				/* RX packets go up without a fake ethernet header */
+				dev->type = ARPHRD_NONE;
+				dev->hard_header_len = 0;
+				dev->addr_len = 0;
+				dev->flags |= IFF_POINTOPOINT;
+			}
 			dev->destructor = free_netdev;
-			dev->hard_header_len += sizeof(struct ccci_header); /* reserve Tx CCCI header room */
+			/*
+			 * reserve Tx CCCI header room. Not in hard_header_len, GRO takes
+			 * that much of the packet as the MAC header it compares.
+			 */
+			dev->needed_headroom += sizeof(struct ccci_header);
 			dev->netdev_ops = &ccmni_netdev_ops;
 			random_ether_addr((u8 *) dev->dev_addr);
 
@@ -857,18 +1123,28 @@ static int ccmni_rx_callback(int md_id, int rx_ch, struct sk_buff *skb, void *pr
 	}
 	ccmni = ctlb->ccmni_inst[ccmni_idx];
 	dev = ccmni->dev;
+	/* ccmni diff from ctlb->ccmni_inst for MD IRAT, NAPI of the netdev owner */
+	ccmni = (ccmni_instance_t *)netdev_priv(dev);
 
 /* skb_pull(skb, sizeof(struct ccci_header)); */
 	pkt_type = skb->data[0] & 0xF0;
-	ccmni_make_etherframe(skb->data-ETH_HLEN, dev->dev_addr, pkt_type);
-	skb_set_mac_header(skb, -ETH_HLEN);
+	if (dev->type == ARPHRD_ETHER) {
+		ccmni_make_etherframe(skb->data-ETH_HLEN, dev->dev_addr, pkt_type);
+		skb_set_mac_header(skb, -ETH_HLEN);
+	} else {
+		skb_reset_mac_header(skb);
+	}
+	skb_reset_network_header(skb);
 	skb->dev = dev;
 	if (pkt_type == 0x60)
 		skb->protocol  = htons(ETH_P_IPV6);
 	else
 		skb->protocol  = htons(ETH_P_IP);
 
-	skb->ip_summed = CHECKSUM_NONE;
+	if (ctlb->ccci_ops->md_ability & MODEM_CAP_RX_CSUM)
+		skb->ip_summed = CHECKSUM_UNNECESSARY;
+	else
+		skb->ip_summed = CHECKSUM_NONE;
 	skb_len = skb->len;
 
 	if (unlikely(ccmni_debug_level&CCMNI_DBG_LEVEL_RX))
@@ -888,13 +1164,19 @@ static int ccmni_rx_callback(int md_id, int rx_ch, struct sk_buff *skb, void *pr
 	net_rx_delay[3] = sched_clock();
 #endif
 
-	if (likely(ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI)) {
-		netif_receive_skb(skb);
+	if (likely(ccmni->ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI)) {
+		/* called back from ccmni_napi_poll() */
+		ccmni_gro_receive(ccmni, skb);
 	} else {
-		if (!in_interrupt())
-			netif_rx_ni(skb);
-		else
-			netif_rx(skb);
+		skb_queue_tail(&ccmni->rx_list, skb);
+		preempt_disable();
+		if (napi_schedule_prep(&ccmni->napi)) {
+			__napi_schedule(&ccmni->napi);
+			/* from the rx push thread: let ksoftirqd run the poll */
+			if (!in_interrupt())
+				raise_softirq(NET_RX_SOFTIRQ);
+		}
+		preempt_enable();
 	}
 	dev->stats.rx_packets++;
 	dev->stats.rx_bytes += skb_len;
@@ -916,7 +1198,6 @@ static void ccmni_md_state_callback(int md_id, int rx_ch, MD_STATE state)
 	ccmni_instance_t  *ccmni = NULL;
 	int ccmni_idx = 0;
 	unsigned int ch_num = rx_ch & 0xFFFF;
-	struct netdev_queue *net_queue = NULL;
 
 	if (unlikely(ctlb == NULL)) {
 		CCMNI_ERR_MSG(md_id, "invalid ccmni ctrl struct when rx_ch=%d md_sta=%d\n", rx_ch, state);
@@ -958,12 +1239,7 @@ static void ccmni_md_state_callback(int md_id, int rx_ch, MD_STATE state)
 	case TX_IRQ:
 		if (netif_running(ccmni->dev) && atomic_read(&ccmni->usage) > 0) {
 			if (likely(ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ)) {
-				if ((ch_num == CCCI_CCMNI1_DL_ACK) || (ch_num == CCCI_CCMNI2_DL_ACK))
-					net_queue = netdev_get_tx_queue(ccmni->dev, CCMNI_TXQ_FAST);
-				else
-					net_queue = netdev_get_tx_queue(ccmni->dev, CCMNI_TXQ_NORMAL);
-				if (netif_tx_queue_stopped(net_queue))
-					netif_tx_wake_queue(net_queue);
+				ccmni_tx_queue_ctl(ccmni, ch_num, 0);
 			} else {
 				if (netif_queue_stopped(ccmni->dev))
 					netif_wake_queue(ccmni->dev);
@@ -975,13 +1251,9 @@ static void ccmni_md_state_callback(int md_id, int rx_ch, MD_STATE state)
 
 	case TX_FULL:
 		if (atomic_read(&ccmni->usage) > 0) {
-			if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ) {
-				if ((ch_num == CCCI_CCMNI1_DL_ACK) || (ch_num == CCCI_CCMNI2_DL_ACK))
-					net_queue = netdev_get_tx_queue(ccmni->dev, CCMNI_TXQ_FAST);
-				else
-					net_queue = netdev_get_tx_queue(ccmni->dev, CCMNI_TXQ_NORMAL);
-				netif_tx_stop_queue(net_queue);
-			} else
+			if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ)
+				ccmni_tx_queue_ctl(ccmni, ch_num, 1);
+			else
 				netif_stop_queue(ccmni->dev);
 			CCMNI_INF_MSG(md_id, "md_state_cb: %s, md_sta=TX_FULL, ch=0x%x, usage=%d\n",
 				ccmni->dev->name, rx_ch, atomic_read(&ccmni->usage));
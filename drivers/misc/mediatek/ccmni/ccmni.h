@@ -23,6 +23,9 @@
 #define  CCMNI_MTU              1500
 #define  CCMNI_TX_QUEUE         1000
 #define  CCMNI_NETDEV_WDT_TO    (1*HZ)
+#define  CCMNI_TX_FLOW_NUM      64	/* buckets of the TX flow classifier */
+#define  CCMNI_BUSY_POLL_BUDGET  8	/* packets per ndo_busy_poll call */
+#define  CCMNI_TX_FLOW_WINDOW   (HZ/10)
 
 #define  IPV4_VERSION           0x40
 #define  IPV6_VERSION           0x60
@@ -32,6 +35,24 @@
 
 typedef struct ccmni_ctl_block ccmni_ctl_block_t;
 
+/* bytes a flow sent on the interactive TX queue in current window */
+struct ccmni_tx_flow {
+	unsigned long      start;
+	unsigned int       bytes;
+};
+
+/*
+ * netdev TX queues of a MODEM_CAP_CCMNI_MQ ccmni, FAST and INTERACTIVE both go to
+ * modem's DL ACK channel (CLDMA ACK queue), NORMAL goes to the data channel.
+ */
+typedef enum {
+	CCMNI_TXQ_NORMAL   = 0,	/* bulk */
+	CCMNI_TXQ_FAST     = 1,	/* pure TCP ACK */
+	CCMNI_TXQ_INTERACTIVE = 2,	/* small packets of a light flow */
+	CCMNI_TXQ_NUM,
+	CCMNI_TXQ_END     = CCMNI_TXQ_NUM
+} CCMNI_TXQ_NO;
+
 struct ccmni_ch {
 	int		   rx;
 	int		   rx_ack;
@@ -55,6 +76,17 @@ typedef struct ccmni_instance {
 	ccmni_ctl_block_t  *ctlb;
 	unsigned long      tx_busy_cnt;
 	void               *priv_data;
+	struct sk_buff_head rx_list;	/* RX backlog drained by ccmni_napi_poll */
+	/* RX GRO statistics, updated in NAPI context only */
+	unsigned long      rx_gro_merged;	/* merged into a held packet */
+	unsigned long      rx_gro_held;	/* held for later packets */
+	unsigned long      rx_gro_normal;	/* passed up as is */
+	unsigned long      rx_gro_drop;
+	unsigned long      rx_polls;
+	/* TX classifier, see ccmni_tx_classify() */
+	struct ccmni_tx_flow tx_flow[CCMNI_TX_FLOW_NUM];
+	unsigned long      tx_class_pkts[CCMNI_TXQ_NUM];
+	unsigned long      tx_demoted;	/* interactive packets demoted to normal queue */
 } ccmni_instance_t;
 
 typedef struct ccmni_ccci_ops {
@@ -118,13 +150,6 @@ typedef enum {
 	CCMNI_DBG_LEVEL_RX_SKB = (1<<5),
 } CCMNI_DBG_LEVEL;
 
-typedef enum {
-	CCMNI_TXQ_NORMAL   = 0,
-	CCMNI_TXQ_FAST     = 1,
-	CCMNI_TXQ_NUM,
-	CCMNI_TXQ_END     = CCMNI_TXQ_NUM
-} CCMNI_TXQ_NO;
-
 /*****************************extern function************************************/
 /* int  ccmni_init(int md_id, ccmni_ccci_ops_t *ccci_info); */
 /* void ccmni_exit(int md_id); */
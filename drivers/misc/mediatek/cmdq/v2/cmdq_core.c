@@ -71,7 +71,11 @@ static DEFINE_SPINLOCK(gCmdqThreadLock);
 static atomic_t gCmdqThreadUsage;
 static atomic_t gSMIThreadUsage;
 static bool gCmdqSuspended;
-static DEFINE_SPINLOCK(gCmdqExecLock);
+/* Per HW thread lock of ThreadStruct and the thread's GCE registers, */
+/* so that tasks on different HW threads do not serialize in submit/IRQ. */
+static spinlock_t gCmdqThreadExecLock[CMDQ_MAX_THREAD_COUNT];
+/* Error records are shared by all HW threads. */
+static DEFINE_SPINLOCK(gCmdqErrorLock);
 static DEFINE_SPINLOCK(gCmdqRecordLock);
 static DEFINE_MUTEX(gCmdqResourceMutex);
 
@@ -79,6 +83,10 @@ static DEFINE_MUTEX(gCmdqResourceMutex);
 static DEFINE_SPINLOCK(gCmdqAllocLock);
 static EmergencyBufferStruct gCmdqEmergencyBuffer[CMDQ_EMERGENCY_BLOCK_COUNT];
 
+/* Recycled task command buffers, one free stack per power-of-two size class. */
+static DEFINE_SPINLOCK(gCmdqCmdBufferPoolLock);
+static CmdBufferPoolStruct gCmdqCmdBufferPool[CMDQ_CMD_BUFFER_POOL_CLASS];
+
 /* The main context structure */
 static wait_queue_head_t gCmdWaitQueue[CMDQ_MAX_THREAD_COUNT];	/* task done notification */
 static wait_queue_head_t gCmdqThreadDispatchQueue;	/* thread acquire notification */
@@ -450,6 +458,110 @@ bool cmdq_core_is_emergency_buffer(void *va)
 	return ret;
 }
 
+/*  */
+/* Command buffer pool */
+/*  */
+/* Task command buffers are requested and released for every flush. Sizes */
+/* up to PAGE_SIZE << (CMDQ_CMD_BUFFER_POOL_CLASS - 1) are rounded up to a */
+/* power-of-two class and recycled here instead of going back to */
+/* dma_alloc_coherent, which is comparatively slow on the display path. */
+/*  */
+static int32_t cmdq_core_cmd_buffer_pool_class(uint32_t size)
+{
+	int32_t class;
+
+	for (class = 0; class < CMDQ_CMD_BUFFER_POOL_CLASS; ++class) {
+		if (size <= (PAGE_SIZE << class))
+			return class;
+	}
+
+	return -1;
+}
+
+static uint32_t cmdq_core_cmd_buffer_pool_round(uint32_t size)
+{
+	const int32_t class = cmdq_core_cmd_buffer_pool_class(size);
+
+	return (class < 0) ? size : (PAGE_SIZE << class);
+}
+
+static void *cmdq_core_cmd_buffer_pool_get(uint32_t size, dma_addr_t *pa)
+{
+	const int32_t class = cmdq_core_cmd_buffer_pool_class(size);
+	CmdBufferPoolStruct *pool;
+	unsigned long flags;
+	void *va = NULL;
+
+	if (class < 0 || size != (PAGE_SIZE << class))
+		return NULL;
+
+	pool = &gCmdqCmdBufferPool[class];
+
+	spin_lock_irqsave(&gCmdqCmdBufferPoolLock, flags);
+	if (pool->count > 0) {
+		--pool->count;
+		va = pool->va[pool->count];
+		*pa = pool->pa[pool->count];
+		++pool->hit;
+	} else {
+		++pool->miss;
+	}
+	spin_unlock_irqrestore(&gCmdqCmdBufferPoolLock, flags);
+
+	return va;
+}
+
+static bool cmdq_core_cmd_buffer_pool_put(uint32_t size, void *va, dma_addr_t pa)
+{
+	const int32_t class = cmdq_core_cmd_buffer_pool_class(size);
+	CmdBufferPoolStruct *pool;
+	unsigned long flags;
+	bool cached = false;
+
+	if (class < 0 || size != (PAGE_SIZE << class))
+		return false;
+
+	pool = &gCmdqCmdBufferPool[class];
+
+	spin_lock_irqsave(&gCmdqCmdBufferPoolLock, flags);
+	if (pool->count < CMDQ_CMD_BUFFER_POOL_DEPTH) {
+		pool->va[pool->count] = va;
+		pool->pa[pool->count] = pa;
+		++pool->count;
+		cached = true;
+	}
+	spin_unlock_irqrestore(&gCmdqCmdBufferPoolLock, flags);
+
+	return cached;
+}
+
+static void cmdq_core_cmd_buffer_pool_drain(void)
+{
+	CmdBufferPoolStruct *pool;
+	unsigned long flags;
+	void *va;
+	dma_addr_t pa;
+	int32_t class;
+
+	for (class = 0; class < CMDQ_CMD_BUFFER_POOL_CLASS; ++class) {
+		pool = &gCmdqCmdBufferPool[class];
+
+		while (1) {
+			spin_lock_irqsave(&gCmdqCmdBufferPoolLock, flags);
+			if (0 == pool->count) {
+				spin_unlock_irqrestore(&gCmdqCmdBufferPoolLock, flags);
+				break;
+			}
+			--pool->count;
+			va = pool->va[pool->count];
+			pa = pool->pa[pool->count];
+			spin_unlock_irqrestore(&gCmdqCmdBufferPoolLock, flags);
+
+			cmdq_core_free_hw_buffer(cmdq_dev_get(), PAGE_SIZE << class, va, pa);
+		}
+	}
+}
+
 int32_t cmdq_core_set_secure_IRQ_status(uint32_t value)
 {
 #ifdef CMDQ_SECURE_PATH_SUPPORT
@@ -569,6 +681,19 @@ cmdqSecSharedMemoryHandle cmdq_core_get_secure_shared_memory(void)
 	return gCmdqContext.hSecSharedMem;
 }
 
+/*  */
+/* Secure threads and the secure notify thread share one lock, */
+/* since the notify thread IRQ completes tasks of all secure threads. */
+/*  */
+static spinlock_t *cmdq_core_thread_exec_lock(const int32_t thread)
+{
+	if (cmdq_get_func()->isSecureThread(thread) ||
+	    cmdq_get_func()->isValidNotifyThread(thread))
+		return &gCmdqThreadExecLock[CMDQ_MIN_SECURE_THREAD_ID];
+
+	return &gCmdqThreadExecLock[thread];
+}
+
 int32_t cmdq_core_stop_secure_path_notify_thread(void)
 {
 #if defined(CMDQ_SECURE_PATH_SUPPORT) && !defined(CMDQ_SECURE_PATH_NORMAL_IRQ)
@@ -590,10 +715,10 @@ int32_t cmdq_core_stop_secure_path_notify_thread(void)
 		}
 
 		/* destroy handle */
-		spin_lock_irqsave(&gCmdqExecLock, flags);
+		spin_lock_irqsave(cmdq_core_thread_exec_lock(CMDQ_MIN_SECURE_THREAD_ID), flags);
 		cmdqRecDestroy(gCmdqContext.hNotifyLoop);
 		gCmdqContext.hNotifyLoop = NULL;
-		spin_unlock_irqrestore(&gCmdqExecLock, flags);
+		spin_unlock_irqrestore(cmdq_core_thread_exec_lock(CMDQ_MIN_SECURE_THREAD_ID), flags);
 
 		/* CPU clear event */
 		CMDQ_REG_SET32(CMDQ_SYNC_TOKEN_UPD, CMDQ_SYNC_SECURE_THR_EOF);
@@ -638,9 +763,9 @@ int32_t cmdq_core_start_secure_path_notify_thread(void)
 		}
 
 		/* update notify handle */
-		spin_lock_irqsave(&gCmdqExecLock, flags);
+		spin_lock_irqsave(cmdq_core_thread_exec_lock(CMDQ_MIN_SECURE_THREAD_ID), flags);
 		gCmdqContext.hNotifyLoop = (CmdqRecLoopHandle *) handle;
-		spin_unlock_irqrestore(&gCmdqExecLock, flags);
+		spin_unlock_irqrestore(cmdq_core_thread_exec_lock(CMDQ_MIN_SECURE_THREAD_ID), flags);
 	} while (0);
 	mutex_unlock(&gCmdqNotifyLoopMutex);
 
@@ -1084,6 +1209,15 @@ int cmdqCorePrintStatusSeq(struct seq_file *m, void *v)
 			   pEngine->currOwner, pEngine->failCount, pEngine->resetCount);
 	}
 
+	seq_puts(m, "====== Command Buffer Pool =======\n");
+
+	spin_lock_irqsave(&gCmdqCmdBufferPoolLock, flags);
+	for (index = 0; index < CMDQ_CMD_BUFFER_POOL_CLASS; index++) {
+		seq_printf(m, "%lu bytes: cached %d, hit: %d, miss: %d\n",
+			   PAGE_SIZE << index, gCmdqCmdBufferPool[index].count,
+			   gCmdqCmdBufferPool[index].hit, gCmdqCmdBufferPool[index].miss);
+	}
+	spin_unlock_irqrestore(&gCmdqCmdBufferPoolLock, flags);
 
 	mutex_lock(&gCmdqTaskMutex);
 
@@ -1433,7 +1567,8 @@ void cmdq_task_free_task_command_buffer(TaskStruct *pTask)
 	if (pTask->pVABase) {
 		if (pTask->useEmergencyBuf) {
 			cmdq_core_free_emergency_buffer(pTask->pVABase, pTask->MVABase);
-		} else {
+		} else if (!cmdq_core_cmd_buffer_pool_put(pTask->bufferSize,
+							  pTask->pVABase, pTask->MVABase)) {
 			cmdq_core_free_hw_buffer(cmdq_dev_get(), pTask->bufferSize,
 						 pTask->pVABase, pTask->MVABase);
 		}
@@ -1459,19 +1594,30 @@ static int32_t cmdq_core_task_realloc_buffer_size(TaskStruct *pTask, uint32_t si
 	dma_addr_t newMVABase = 0;
 	int32_t commandSize = 0;
 	uint32_t *pCMDEnd = NULL;
+	bool useEmergencyBuf = false;
 
 	if (pTask->pVABase && pTask->bufferSize >= size) {
 		/* buffer size is already good, do nothing. */
 		return 0;
 	}
 
+	/* round up to a pool size class so the buffer can be recycled */
+	size = cmdq_core_cmd_buffer_pool_round(size);
+
 	do {
+		/* reuse a recycled buffer of the same size class */
+		pNewBuffer = cmdq_core_cmd_buffer_pool_get(size, &newMVABase);
+		if (pNewBuffer) {
+			useEmergencyBuf = false;
+			break;
+		}
+
 		/* allocate new buffer, try if we can alloc without reclaim */
 		pNewBuffer = cmdq_core_alloc_hw_buffer(cmdq_dev_get(), size,
 						&newMVABase, GFP_KERNEL | __GFP_NO_KSWAPD);
 
 		if (pNewBuffer) {
-			pTask->useEmergencyBuf = false;
+			useEmergencyBuf = false;
 			break;
 		}
 
@@ -1481,7 +1627,7 @@ static int32_t cmdq_core_task_realloc_buffer_size(TaskStruct *pTask, uint32_t si
 
 		if (pNewBuffer) {
 			CMDQ_MSG("emergency buffer %p allocated\n", pNewBuffer);
-			pTask->useEmergencyBuf = true;
+			useEmergencyBuf = true;
 			break;
 		}
 
@@ -1490,7 +1636,7 @@ static int32_t cmdq_core_task_realloc_buffer_size(TaskStruct *pTask, uint32_t si
 		    cmdq_core_alloc_hw_buffer(cmdq_dev_get(), size, &newMVABase,
 					      GFP_KERNEL);
 		if (pNewBuffer) {
-			pTask->useEmergencyBuf = false;
+			useEmergencyBuf = false;
 			break;
 		}
 	} while (0);
@@ -1500,11 +1646,13 @@ static int32_t cmdq_core_task_realloc_buffer_size(TaskStruct *pTask, uint32_t si
 		return -ENOMEM;
 	}
 
-	memset(pNewBuffer, 0, size);
-
-	/* copy and release old buffer */
-	if (pTask->pVABase)
+	/* copy and release old buffer, only clear the part not overwritten */
+	if (pTask->pVABase) {
 		memcpy(pNewBuffer, pTask->pVABase, pTask->bufferSize);
+		memset((uint8_t *)pNewBuffer + pTask->bufferSize, 0, size - pTask->bufferSize);
+	} else {
+		memset(pNewBuffer, 0, size);
+	}
 
 	/* we should keep track of pCMDEnd and cmdSize since they are cleared in free command buffer */
 	pCMDEnd = pTask->pCMDEnd;
@@ -1516,6 +1664,7 @@ static int32_t cmdq_core_task_realloc_buffer_size(TaskStruct *pTask, uint32_t si
 	pTask->pVABase = (uint32_t *) pNewBuffer;
 	pTask->MVABase = newMVABase;
 	pTask->bufferSize = size;
+	pTask->useEmergencyBuf = useEmergencyBuf;
 	pTask->pCMDEnd = pCMDEnd;
 	pTask->commandSize = commandSize;
 
@@ -3180,7 +3329,7 @@ static int32_t cmdq_core_find_a_free_HW_thread(uint64_t engineFlag,
 
 			for (index = startIndex; index < endIndex; ++index) {
 
-				spin_lock_irqsave(&gCmdqExecLock, flagsExecLock);
+				spin_lock_irqsave(cmdq_core_thread_exec_lock(index), flagsExecLock);
 
 				if ((0 == pThread[index].engineFlag) &&
 				    (0 == pThread[index].taskCount) &&
@@ -3193,11 +3342,12 @@ static int32_t cmdq_core_find_a_free_HW_thread(uint64_t engineFlag,
 
 					thread = index;
 					pThread[index].allowDispatching = 0;
-					spin_unlock_irqrestore(&gCmdqExecLock, flagsExecLock);
+					spin_unlock_irqrestore(cmdq_core_thread_exec_lock(index),
+							       flagsExecLock);
 					break;
 				}
 
-				spin_unlock_irqrestore(&gCmdqExecLock, flagsExecLock);
+				spin_unlock_irqrestore(cmdq_core_thread_exec_lock(index), flagsExecLock);
 			}
 		}
 
@@ -4984,6 +5134,7 @@ static void cmdq_core_attach_error_task(const TaskStruct *pTask, int32_t thread,
 	const TaskStruct *pNGTask = NULL;
 	uint64_t engFlag = 0;
 	int32_t index = 0;
+	unsigned long flags;
 
 	if (NULL == pTask) {
 		CMDQ_ERR("attach error failed since pTask is NULL");
@@ -4993,6 +5144,8 @@ static void cmdq_core_attach_error_task(const TaskStruct *pTask, int32_t thread,
 	pThread = &(gCmdqContext.thread[thread]);
 	pEngine = gCmdqContext.engine;
 
+	spin_lock_irqsave(&gCmdqErrorLock, flags);
+
 	CMDQ_PROF_MMP(cmdq_mmp_get_event()->warning, MMProfileFlagPulse, ((unsigned long)pTask),
 		      thread);
 
@@ -5041,6 +5194,8 @@ static void cmdq_core_attach_error_task(const TaskStruct *pTask, int32_t thread,
 		 gCmdqContext.errNum);
 	gCmdqContext.errNum++;
 
+	spin_unlock_irqrestore(&gCmdqErrorLock, flags);
+
 	if (pOutNGTask != NULL) {
 		if (NULL != pNGTask)
 			*pOutNGTask = pNGTask;
@@ -5390,7 +5545,7 @@ static void cmdqCoreHandleError(int32_t thread, int32_t value, CMDQ_TIME *pGotIR
 	cmdq_core_dump_task_in_thread(thread, true, true, true);
 #endif
 	/* suspend HW thread first, so that we work in a consistent state */
-	/* outer function should acquire spinlock - gCmdqExecLock */
+	/* outer function should acquire spinlock - cmdq_core_thread_exec_lock(thread) */
 	status = cmdq_core_suspend_HW_thread(thread, __LINE__);
 	if (0 > status) {
 		/* suspend HW thread failed */
@@ -5517,7 +5672,7 @@ void cmdqCoreHandleIRQ(int32_t thread)
 	/* Normal execution, marks tasks done and remove from thread */
 	/* Also, handle "loop CB fail" case */
 	/*  */
-	spin_lock_irqsave(&gCmdqExecLock, flags);
+	spin_lock_irqsave(cmdq_core_thread_exec_lock(thread), flags);
 
 	/* it is possible for another CPU core */
 	/* to run "releaseTask" right before we acquire the spin lock */
@@ -5528,7 +5683,7 @@ void cmdqCoreHandleIRQ(int32_t thread)
 	if (0 == (value & 0x13)) {
 		CMDQ_ERR("IRQ: thread %d got interrupt but IRQ flag is 0x%08x in NWd\n", thread,
 			 value);
-		spin_unlock_irqrestore(&gCmdqExecLock, flags);
+		spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 		return;
 	}
 
@@ -5538,7 +5693,7 @@ void cmdqCoreHandleIRQ(int32_t thread)
 		if (0 == (enabled & 0x01)) {
 			CMDQ_ERR("IRQ: thread %d got interrupt already disabled 0x%08x\n", thread,
 				 enabled);
-			spin_unlock_irqrestore(&gCmdqExecLock, flags);
+			spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 			return;
 		}
 	}
@@ -5559,7 +5714,7 @@ void cmdqCoreHandleIRQ(int32_t thread)
 
 	CMDQ_PROF_END(0, gCmdqThreadLabel[thread]);
 
-	spin_unlock_irqrestore(&gCmdqExecLock, flags);
+	spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 }
 
 static TaskStruct *cmdq_core_search_task_by_pc(uint32_t threadPC, const ThreadStruct *pThread, int32_t thread)
@@ -5613,16 +5768,19 @@ static int32_t cmdq_core_wait_task_done_with_timeout_impl(TaskStruct *pTask, int
 
 		++retryCount;
 
-		spin_lock_irqsave(&gCmdqExecLock, flags);
+		spin_lock_irqsave(cmdq_core_thread_exec_lock(thread), flags);
 		cmdq_core_dump_status("INFO");
 		cmdq_core_dump_pc(pTask, thread, "INFO");
+		spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 
 		/* HACK: check trigger thread status */
+		spin_lock_irqsave(cmdq_core_thread_exec_lock(CMDQ_MAX_HIGH_PRIORITY_THREAD_COUNT),
+				  flags);
 		cmdq_core_dump_disp_trigger_loop("INFO");
+		spin_unlock_irqrestore(cmdq_core_thread_exec_lock(CMDQ_MAX_HIGH_PRIORITY_THREAD_COUNT),
+				       flags);
 		/* end of HACK */
 
-		spin_unlock_irqrestore(&gCmdqExecLock, flags);
-
 		/* then we wait again */
 		waitQ = wait_event_timeout(gCmdWaitQueue[thread],
 					   (TASK_STATE_BUSY != pTask->taskState
@@ -5769,7 +5927,7 @@ static int32_t cmdq_core_handle_wait_task_result_impl(TaskStruct *pTask, int32_t
 
 	/* Note that although we disable IRQ, HW continues to execute */
 	/* so it's possible to have pending IRQ */
-	spin_lock_irqsave(&gCmdqExecLock, flags);
+	spin_lock_irqsave(cmdq_core_thread_exec_lock(thread), flags);
 
 	do {
 		TaskStruct *pNextTask = NULL;
@@ -6002,7 +6160,7 @@ static int32_t cmdq_core_handle_wait_task_result_impl(TaskStruct *pTask, int32_t
 		cmdq_core_resume_HW_thread(thread);
 	}
 
-	spin_unlock_irqrestore(&gCmdqExecLock, flags);
+	spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 
 	if (throwAEE) {
 		const uint32_t op = (instA & 0xFF000000) >> 24;
@@ -6324,7 +6482,7 @@ static int32_t cmdq_core_exec_task_async_impl(TaskStruct *pTask, int32_t thread)
 
 	pTask->trigger = sched_clock();
 
-	spin_lock_irqsave(&gCmdqExecLock, flags);
+	spin_lock_irqsave(cmdq_core_thread_exec_lock(thread), flags);
 
 	/* update task's thread info */
 	pTask->thread = thread;
@@ -6344,7 +6502,7 @@ static int32_t cmdq_core_exec_task_async_impl(TaskStruct *pTask, int32_t thread)
 		CMDQ_MSG("EXEC: new HW thread(%d)\n", thread);
 
 		if (cmdq_core_reset_HW_thread(thread) < 0) {
-			spin_unlock_irqrestore(&gCmdqExecLock, flags);
+			spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 			return -EFAULT;
 		}
 
@@ -6403,7 +6561,7 @@ static int32_t cmdq_core_exec_task_async_impl(TaskStruct *pTask, int32_t thread)
 #else
 		status = cmdq_core_suspend_HW_thread(thread, __LINE__);
 		if (status < 0) {
-			spin_unlock_irqrestore(&gCmdqExecLock, flags);
+			spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 			return status;
 		}
 
@@ -6492,7 +6650,7 @@ static int32_t cmdq_core_exec_task_async_impl(TaskStruct *pTask, int32_t thread)
 #ifdef CMDQ_APPEND_WITHOUT_SUSPEND
 				cmdqCoreSetEvent(CMDQ_SYNC_TOKEN_APPEND_THR(thread));
 #endif
-				spin_unlock_irqrestore(&gCmdqExecLock, flags);
+				spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 				return -EFAULT;
 			}
 
@@ -6509,7 +6667,7 @@ static int32_t cmdq_core_exec_task_async_impl(TaskStruct *pTask, int32_t thread)
 #ifdef CMDQ_APPEND_WITHOUT_SUSPEND
 				cmdqCoreSetEvent(CMDQ_SYNC_TOKEN_APPEND_THR(thread));
 #endif
-				spin_unlock_irqrestore(&gCmdqExecLock, flags);
+				spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 				CMDQ_AEE("CMDQ", "Invalid task state for reorder.\n");
 				return status;
 			}
@@ -6542,7 +6700,7 @@ static int32_t cmdq_core_exec_task_async_impl(TaskStruct *pTask, int32_t thread)
 #endif
 	}
 
-	spin_unlock_irqrestore(&gCmdqExecLock, flags);
+	spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 
 	CMDQ_MSG("<--EXEC: status: %d\n", status);
 
@@ -6619,12 +6777,12 @@ int32_t cmdqCoreSuspend(void)
 			pTask = list_entry(p, struct TaskStruct, listEntry);
 
 			if (pTask->thread != CMDQ_INVALID_THREAD) {
-				spin_lock_irqsave(&gCmdqExecLock, flags);
+				spin_lock_irqsave(cmdq_core_thread_exec_lock(pTask->thread), flags);
 
 				cmdq_core_force_remove_task_from_thread(pTask, pTask->thread);
 				pTask->taskState = TASK_STATE_KILLED;
 
-				spin_unlock_irqrestore(&gCmdqExecLock, flags);
+				spin_unlock_irqrestore(cmdq_core_thread_exec_lock(pTask->thread), flags);
 
 				/* release all thread and mark all active tasks as "KILLED" */
 				/* (so that thread won't release again) */
@@ -6976,7 +7134,7 @@ int32_t cmdqCoreReleaseTask(TaskStruct *pTask)
 		/* this task is being executed (or queueed) on a HW thread */
 
 		/* get SW lock first to ensure atomic access HW */
-		spin_lock_irqsave(&gCmdqExecLock, flags);
+		spin_lock_irqsave(cmdq_core_thread_exec_lock(thread), flags);
 		/* make sure instructions are really in DRAM */
 		smp_mb();
 
@@ -6999,7 +7157,7 @@ int32_t cmdqCoreReleaseTask(TaskStruct *pTask)
 				cmdq_core_resume_HW_thread(thread);
 		}
 
-		spin_unlock_irqrestore(&gCmdqExecLock, flags);
+		spin_unlock_irqrestore(cmdq_core_thread_exec_lock(thread), flags);
 		wake_up(&gCmdWaitQueue[thread]);
 	}
 
@@ -7068,7 +7226,7 @@ static void cmdq_core_auto_release_work(struct work_struct *workItem)
 	int32_t status = 0;
 	TaskStruct *pTask = NULL;
 	CmdqAsyncFlushCB finishCallback = NULL;
-	uint32_t userData = 0;
+	unsigned long userData = 0;
 	uint32_t *pCmd = NULL;
 	int32_t commandSize = 0;
 
@@ -7092,7 +7250,7 @@ static void cmdq_core_auto_release_work(struct work_struct *workItem)
 
 		/* Notify user */
 		if (finishCallback) {
-			CMDQ_VERBOSE("[Auto Release] call user callback %p with data 0x%08x\n",
+			CMDQ_VERBOSE("[Auto Release] call user callback %p with data 0x%08lx\n",
 				     finishCallback, userData);
 			if (0 > finishCallback(userData)) {
 				CMDQ_LOG
@@ -7352,8 +7510,10 @@ int32_t cmdqCoreInitialize(void)
 	BUG_ON(0 != atomic_read(&gCmdqThreadUsage));
 	BUG_ON(0 != atomic_read(&gSMIThreadUsage));
 
-	for (index = 0; index < CMDQ_MAX_THREAD_COUNT; index++)
+	for (index = 0; index < CMDQ_MAX_THREAD_COUNT; index++) {
 		init_waitqueue_head(&gCmdWaitQueue[index]);
+		spin_lock_init(&gCmdqThreadExecLock[index]);
+	}
 
 	init_waitqueue_head(&gCmdqThreadDispatchQueue);
 
@@ -7511,6 +7671,9 @@ void cmdqCoreDeInitialize(void)
 	kmem_cache_destroy(gCmdqContext.taskCache);
 	gCmdqContext.taskCache = NULL;
 
+	/* release pooled command buffers */
+	cmdq_core_cmd_buffer_pool_drain();
+
 	/* release emergency buffer */
 	cmdq_core_uninit_emergency_buffer();
 
@@ -566,6 +566,14 @@ typedef struct EmergencyBufferStruct {
 	dma_addr_t pa;
 } EmergencyBufferStruct;
 
+typedef struct CmdBufferPoolStruct {
+	uint32_t count;		/* cached buffers in this size class */
+	void *va[CMDQ_CMD_BUFFER_POOL_DEPTH];
+	dma_addr_t pa[CMDQ_CMD_BUFFER_POOL_DEPTH];
+	uint32_t hit;
+	uint32_t miss;
+} CmdBufferPoolStruct;
+
 /**
  * shared memory between normal and secure world
  */
@@ -44,6 +44,8 @@
 #define CMDQ_INITIAL_CMD_BLOCK_SIZE     (PAGE_SIZE)
 #define CMDQ_EMERGENCY_BLOCK_SIZE       (256 * 1024)	/* 256 KB command buffer */
 #define CMDQ_EMERGENCY_BLOCK_COUNT      (4)
+#define CMDQ_CMD_BUFFER_POOL_CLASS      (5)	/* pooled sizes: PAGE_SIZE << 0..4 */
+#define CMDQ_CMD_BUFFER_POOL_DEPTH      (8)	/* cached buffers per size class */
 #define CMDQ_INST_SIZE                  (2 * sizeof(uint32_t))	/* instruction is 64-bit */
 
 #define CMDQ_MAX_LOOP_COUNT             (1000000)
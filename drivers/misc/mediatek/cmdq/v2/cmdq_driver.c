@@ -23,6 +23,10 @@
 #include <linux/sched.h>
 #include <linux/pm.h>
 #include <linux/suspend.h>
+#include <linux/workqueue.h>
+#ifdef CMDQ_FENCE_JOB_SUPPORT
+#include "mtk_sync.h"
+#endif
 #ifdef CMDQ_USE_LEGACY
 #include <mach/mt_boot.h>
 #endif
@@ -481,6 +485,185 @@ bool cmdq_driver_support_wait_and_receive_event_in_same_tick(void)
 #endif
 }
 
+#ifdef CMDQ_FENCE_JOB_SUPPORT
+/*  */
+/* Fence based async job */
+/*  */
+/* Each job owns a one-shot sw_sync timeline, so jobs finishing out of */
+/* order on different GCE threads signal their own fence only. */
+/* Tasks are auto released and complete the out fence in their flush */
+/* callback, so no user thread has to block on a job. A job with a */
+/* pending input fence is submitted from gCmdqFenceJobWQ when it signals. */
+/*  */
+typedef struct cmdqFenceJobContext {
+	cmdqCommandStruct command;
+	void *pKernelBuffer;	/* command copy for deferred submit */
+	struct sw_sync_timeline *timeline;
+	struct sync_fence *inFence;
+	struct sync_fence_waiter waiter;
+	struct work_struct submitWork;
+} cmdqFenceJobContext;
+
+static struct workqueue_struct *gCmdqFenceJobWQ;
+
+static int32_t cmdq_driver_fence_job_done(unsigned long data)
+{
+	cmdqFenceJobContext *pJob = (cmdqFenceJobContext *) data;
+
+	/* signal the out fence, it stays valid after timeline destroyed */
+	timeline_inc(pJob->timeline, 1);
+	timeline_destroy(pJob->timeline);
+
+	if (pJob->inFence)
+		sync_fence_put(pJob->inFence);
+
+	kfree(pJob->pKernelBuffer);
+	kfree(pJob);
+	return 0;
+}
+
+static int32_t cmdq_driver_fence_job_submit(cmdqFenceJobContext *pJob)
+{
+	TaskStruct *pTask = NULL;
+	int32_t status;
+
+	status = cmdqCoreSubmitTaskAsync(&pJob->command, NULL, 0, &pTask);
+	if (NULL == pTask)
+		return (status < 0) ? status : -EFAULT;
+
+	pTask->flushCallback = cmdq_driver_fence_job_done;
+	pTask->flushData = (unsigned long)pJob;
+
+	return cmdqCoreAutoReleaseTask(pTask);
+}
+
+static void cmdq_driver_fence_job_submit_work(struct work_struct *workItem)
+{
+	cmdqFenceJobContext *pJob = container_of(workItem, cmdqFenceJobContext, submitWork);
+	mm_segment_t oldFs;
+	int32_t status;
+
+	/* user space scenario copies command with copy_from_user, */
+	/* but the command is in kernel buffer now */
+	oldFs = get_fs();
+	set_fs(KERNEL_DS);
+	status = cmdq_driver_fence_job_submit(pJob);
+	set_fs(oldFs);
+
+	if (status < 0) {
+		CMDQ_ERR("[FENCE]deferred submit failed:%d\n", status);
+		cmdq_driver_fence_job_done((unsigned long)pJob);
+	}
+}
+
+static void cmdq_driver_fence_job_in_fence_signaled(struct sync_fence *fence,
+						    struct sync_fence_waiter *waiter)
+{
+	cmdqFenceJobContext *pJob = container_of(waiter, cmdqFenceJobContext, waiter);
+
+	/* fence callback is in atomic context */
+	queue_work(gCmdqFenceJobWQ, &pJob->submitWork);
+}
+
+static long cmdq_driver_process_fence_job(unsigned long param, void *privateData)
+{
+	cmdqFenceJobStruct fenceJob;
+	cmdqFenceJobContext *pJob;
+	struct fence_data data;
+	int32_t status;
+
+	if (copy_from_user(&fenceJob, (void *)param, sizeof(fenceJob)))
+		return -EFAULT;
+
+	if (true == fenceJob.command.secData.isSecure ||
+	    0 != fenceJob.command.regRequest.count || 0 != fenceJob.command.readAddress.count) {
+		CMDQ_ERR("[FENCE]secure path and register read back are not supported\n");
+		return -EINVAL;
+	}
+
+	pJob = kzalloc(sizeof(cmdqFenceJobContext), GFP_KERNEL);
+	if (NULL == pJob)
+		return -ENOMEM;
+
+	pJob->command = fenceJob.command;
+	pJob->command.regValue.count = 0;
+	pJob->command.regValue.regValues = (cmdqU32Ptr_t) (unsigned long)NULL;
+	pJob->command.debugRegDump = 0;
+	/* insert private_data for resource reclaim */
+	pJob->command.privateData = (cmdqU32Ptr_t) (unsigned long)privateData;
+	/* scenario id fixup */
+	cmdq_core_fix_command_scenario_for_user_space(&pJob->command);
+
+	INIT_WORK(&pJob->submitWork, cmdq_driver_fence_job_submit_work);
+	sync_fence_waiter_init(&pJob->waiter, cmdq_driver_fence_job_in_fence_signaled);
+
+	pJob->timeline = timeline_create("cmdq_job");
+	if (NULL == pJob->timeline) {
+		kfree(pJob);
+		return -ENOMEM;
+	}
+
+	memset(&data, 0, sizeof(data));
+	data.value = 1;
+	strncpy(data.name, "cmdq_job", sizeof(data.name) - 1);
+	status = fence_create(pJob->timeline, &data);
+	if (status < 0) {
+		timeline_destroy(pJob->timeline);
+		kfree(pJob);
+		return status;
+	}
+
+	/* from here on, the out fence must be signaled on every path */
+	fenceJob.outFenceFd = data.fence;
+	if (copy_to_user((void *)param, &fenceJob, sizeof(fenceJob))) {
+		CMDQ_ERR("[FENCE]copy_to_user failed\n");
+		cmdq_driver_fence_job_done((unsigned long)pJob);
+		return -EFAULT;
+	}
+
+	if (0 > fenceJob.inFenceFd) {
+		status = cmdq_driver_fence_job_submit(pJob);
+		if (status < 0)
+			cmdq_driver_fence_job_done((unsigned long)pJob);
+		return status;
+	}
+
+	do {
+		pJob->inFence = sync_fence_fdget(fenceJob.inFenceFd);
+		if (NULL == pJob->inFence) {
+			status = -EINVAL;
+			break;
+		}
+
+		/* keep a kernel copy, the submit may run out of this process */
+		pJob->pKernelBuffer = kmalloc(pJob->command.blockSize, GFP_KERNEL);
+		if (NULL == pJob->pKernelBuffer) {
+			status = -ENOMEM;
+			break;
+		}
+
+		if (copy_from_user(pJob->pKernelBuffer, CMDQ_U32_PTR(pJob->command.pVABase),
+				   pJob->command.blockSize)) {
+			status = -EFAULT;
+			break;
+		}
+		pJob->command.pVABase = (cmdqU32Ptr_t) (unsigned long)pJob->pKernelBuffer;
+
+		status = sync_fence_wait_async(pJob->inFence, &pJob->waiter);
+		if (1 == status) {
+			/* already signaled */
+			cmdq_driver_fence_job_submit_work(&pJob->submitWork);
+			status = 0;
+		}
+	} while (0);
+
+	if (status < 0)
+		cmdq_driver_fence_job_done((unsigned long)pJob);
+
+	return status;
+}
+#endif
+
 static long cmdq_ioctl(struct file *pFile, unsigned int code, unsigned long param)
 {
 	struct cmdqCommandStruct command;
@@ -761,6 +944,10 @@ static long cmdq_ioctl(struct file *pFile, unsigned int code, unsigned long para
 			cmdqCoreLockResource(engineFlag, true);
 		} while (0);
 		break;
+#ifdef CMDQ_FENCE_JOB_SUPPORT
+	case CMDQ_IOCTL_ASYNC_JOB_EXEC_FENCE:
+		return cmdq_driver_process_fence_job(param, pFile->private_data);
+#endif
 	default:
 		CMDQ_ERR("unrecognized ioctl 0x%08x\n", code);
 		return -ENOIOCTLCMD;
@@ -783,6 +970,9 @@ static long cmdq_ioctl_compat(struct file *pFile, unsigned int code, unsigned lo
 	case CMDQ_IOCTL_QUERY_CAP_BITS:
 	case CMDQ_IOCTL_QUERY_DTS:
 	case CMDQ_IOCTL_NOTIFY_ENGINE:
+#ifdef CMDQ_FENCE_JOB_SUPPORT
+	case CMDQ_IOCTL_ASYNC_JOB_EXEC_FENCE:
+#endif
 		/* All ioctl structures should be the same size in 32-bit and 64-bit linux. */
 		return cmdq_ioctl(pFile, code, param);
 	case CMDQ_IOCTL_LOCK_MUTEX:
@@ -1065,6 +1255,10 @@ static int __init cmdq_init(void)
 		return -ENODEV;
 	}
 
+#ifdef CMDQ_FENCE_JOB_SUPPORT
+	gCmdqFenceJobWQ = create_singlethread_workqueue("cmdq_fence_job");
+#endif
+
 	CMDQ_MSG("CMDQ driver init end\n");
 
 	return 0;
@@ -1095,6 +1289,11 @@ static void __exit cmdq_exit(void)
 		CMDQ_ERR("Failed to unregister_pm_notifier(%d)\n", status);
 	}
 
+#ifdef CMDQ_FENCE_JOB_SUPPORT
+	destroy_workqueue(gCmdqFenceJobWQ);
+	gCmdqFenceJobWQ = NULL;
+#endif
+
 	/* Unregister MDP callback */
 	cmdqCoreRegisterCB(CMDQ_GROUP_MDP, NULL, NULL, NULL, NULL);
 
@@ -77,4 +77,17 @@ typedef struct cmdqWriteAddressStruct {
 /*  */
 #define CMDQ_IOCTL_NOTIFY_ENGINE _IOW(CMDQ_IOCTL_MAGIC_NUMBER, 12, uint64_t)
 
+/*  */
+/* Fence based async job. */
+/* The job is released by driver when done, so no WAIT_AND_CLOSE is needed. */
+/* Register read back (regRequest / readAddress) and secure path are not supported. */
+/*  */
+typedef struct cmdqFenceJobStruct {
+	struct cmdqCommandStruct command;	/* [IN] the job */
+	int32_t inFenceFd;	/* [IN] execute after this fence signals, -1 for none */
+	int32_t outFenceFd;	/* [OUT] signaled when the job finished on GCE */
+} cmdqFenceJobStruct;
+
+#define CMDQ_IOCTL_ASYNC_JOB_EXEC_FENCE _IOWR(CMDQ_IOCTL_MAGIC_NUMBER, 13, cmdqFenceJobStruct)
+
 #endif				/* __CMDQ_DRIVER_H__ */
@@ -1392,6 +1392,47 @@ int32_t cmdqRecSetNOP(cmdqRecHandle handle, uint32_t index)
 	return index;
 }
 
+int32_t cmdqRecWriteTemplate(cmdqRecHandle handle, uint32_t addr, uint32_t value, uint32_t mask)
+{
+	int32_t status;
+	uint32_t *pCommand;
+	uint32_t index = handle ? handle->blockSize / CMDQ_INST_SIZE : 0;
+
+	status = cmdqRecWrite(handle, addr, value, mask);
+	if (0 != status)
+		return status;
+
+	/* skip MOVE for mask, prefetch marker and GPR lock inserted before the WRITE */
+	for (; index < handle->blockSize / CMDQ_INST_SIZE; ++index) {
+		pCommand = (uint32_t *) ((uint8_t *) handle->pBuffer + index * CMDQ_INST_SIZE);
+		if (CMDQ_CODE_WRITE == (pCommand[1] >> 24))
+			return index;
+	}
+
+	return -EFAULT;
+}
+
+int32_t cmdqRecPatchWrite(cmdqRecHandle handle, uint32_t index, uint32_t value)
+{
+	uint32_t *pCommand;
+	uint32_t offsetIndex = index * CMDQ_INST_SIZE;
+
+	if (NULL == handle || offsetIndex > (handle->blockSize - CMDQ_INST_SIZE))
+		return -EFAULT;
+
+	pCommand = (uint32_t *) ((uint8_t *) handle->pBuffer + offsetIndex);
+
+	/* only immediate-value WRITE can be patched, bit 54: argB type */
+	if (CMDQ_CODE_WRITE != (pCommand[1] >> 24) || (pCommand[1] & (1 << 22))) {
+		CMDQ_ERR("REC: 0x%p index %d is not a WRITE: 0x%08x:0x%08x\n",
+			 handle, index, pCommand[1], pCommand[0]);
+		return -EINVAL;
+	}
+
+	pCommand[0] = value;
+	return 0;
+}
+
 int32_t cmdqRecQueryOffset(cmdqRecHandle handle, uint32_t startIndex, const CMDQ_CODE_ENUM opCode,
 			   CMDQ_EVENT_ENUM event)
 {
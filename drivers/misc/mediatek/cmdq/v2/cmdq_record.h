@@ -420,6 +420,38 @@ extern "C" {
  */
 	int32_t cmdqRecSetNOP(cmdqRecHandle handle, uint32_t index);
 
+/**
+ * Append a write command like cmdqRecWrite() and return its instruction
+ * index, so the value can later be changed with cmdqRecPatchWrite().
+ *
+ * Together they allow a record to be used as a template: build the command
+ * sequence once, then per frame patch the register values and flush again.
+ * A finalized record may be flushed repeatedly without cmdqRecReset(), since
+ * each flush copies the record buffer into its own task.
+ *
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     addr: the specified target register physical address
+ *     value: the specified target register value
+ *     mask: the specified target register mask
+ * Return:
+ *     >= 0 (index) of the WRITE instruction; else the error code is returned
+ */
+	int32_t cmdqRecWriteTemplate(cmdqRecHandle handle, uint32_t addr, uint32_t value,
+				     uint32_t mask);
+
+/**
+ * Replace the value of a WRITE instruction created by cmdqRecWriteTemplate()
+ *
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     index: the index returned by cmdqRecWriteTemplate()
+ *     value: the new register value
+ * Return:
+ *     0 for success; else the error code is returned
+ */
+	int32_t cmdqRecPatchWrite(cmdqRecHandle handle, uint32_t index, uint32_t value);
+
 /**
  * Query offset of instruction by instruction name
  *
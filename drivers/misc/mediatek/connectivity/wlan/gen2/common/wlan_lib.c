@@ -2707,6 +2707,10 @@ wlanImageSectionDownloadAggregated(IN P_ADAPTER_T prAdapter,
 	PUINT_8 pucOutputBuf = (PUINT_8) NULL;	/* Pointer to Transmit Data Structure Frame */
 	UINT_32 u4PktCnt, u4Offset, u4Length;
 	UINT_32 u4TotalLength;
+#if CFG_FW_DOWNLOAD_PIPELINE
+	PUINT_8 apucBatchBuf[2];
+	UINT_8 ucBatchIdx = 0;
+#endif
 
 	ASSERT(prAdapter);
 	ASSERT(pucImgSecBuf);
@@ -2717,6 +2721,17 @@ wlanImageSectionDownloadAggregated(IN P_ADAPTER_T prAdapter,
 
 	if (u4ImgSecSize == 0)
 		return WLAN_STATUS_SUCCESS;
+
+#if CFG_FW_DOWNLOAD_PIPELINE
+	/* ping-pong between two batch buffers so the next batch is packed
+	 * (header, CRC32, payload copy) while the previous one is on the DMA.
+	 * Without the second buffer fall back to one synchronous batch at a time.
+	 */
+	apucBatchBuf[0] = pucOutputBuf;
+	apucBatchBuf[1] = NULL;
+	if (u4ImgSecSize > CMD_PKT_SIZE_FOR_IMAGE)
+		apucBatchBuf[1] = kalMemAlloc(prAdapter->u4CoalescingBufCachedSize, PHY_MEM_TYPE);
+#endif
 	/* 1. Allocate CMD Info Packet and Pre-fill Headers */
 	prCmdInfo = cmdBufAllocateCmdInfo(prAdapter,
 					  sizeof(INIT_HIF_TX_HEADER_T) + sizeof(INIT_CMD_DOWNLOAD_BUF) +
@@ -2790,6 +2805,13 @@ wlanImageSectionDownloadAggregated(IN P_ADAPTER_T prAdapter,
 			if (u4Offset < u4ImgSecSize)
 				continue;
 		} else if (u4PktCnt == 0) {
+#if CFG_FW_DOWNLOAD_PIPELINE
+			/* TX released count must not be polled with a DMA in flight */
+			if (kalDevPortWriteWait(prAdapter->prGlueInfo) == FALSE) {
+				u4Status = WLAN_STATUS_FAILURE;
+				break;
+			}
+#endif
 			/* no resource, so get some back */
 			if (nicTxPollingResource(prAdapter, ucTC) != WLAN_STATUS_SUCCESS) {
 				u4Status = WLAN_STATUS_FAILURE;
@@ -2800,6 +2822,19 @@ wlanImageSectionDownloadAggregated(IN P_ADAPTER_T prAdapter,
 
 		if (u4PktCnt != 0) {
 			/* start transmission */
+#if CFG_FW_DOWNLOAD_PIPELINE
+			if (apucBatchBuf[1] != NULL) {
+				/* waits for the previous batch, then returns with this one on the DMA */
+				if (kalDevPortWriteAsync(prAdapter->prGlueInfo, MCR_WTDR0, u4TotalLength,
+							 pucOutputBuf, prAdapter->u4CoalescingBufCachedSize) == FALSE) {
+					u4Status = WLAN_STATUS_FAILURE;
+					DBGLOG(INIT, ERROR, "FW image batch DMA fail\n");
+					break;
+				}
+				ucBatchIdx ^= 1;
+				pucOutputBuf = apucBatchBuf[ucBatchIdx];
+			} else
+#endif
 			HAL_WRITE_TX_PORT(prAdapter,
 					  0,
 					  u4TotalLength, (PUINT_8) pucOutputBuf, prAdapter->u4CoalescingBufCachedSize);
@@ -2810,6 +2845,15 @@ wlanImageSectionDownloadAggregated(IN P_ADAPTER_T prAdapter,
 		}
 	}
 
+#if CFG_FW_DOWNLOAD_PIPELINE
+	/* the last batch may still be on the DMA */
+	if (kalDevPortWriteWait(prAdapter->prGlueInfo) == FALSE)
+		u4Status = WLAN_STATUS_FAILURE;
+
+	if (apucBatchBuf[1] != NULL)
+		kalMemFree(apucBatchBuf[1], PHY_MEM_TYPE, prAdapter->u4CoalescingBufCachedSize);
+#endif
+
 	/* 8. Free CMD Info Packet. */
 	cmdBufFreeCmdInfo(prAdapter, prCmdInfo);
 
@@ -2559,12 +2559,60 @@ VOID nicRxProcessMgmtPacket(IN P_ADAPTER_T prAdapter, IN OUT P_SW_RFB_T prSwRfb)
 }
 
 #if CFG_SUPPORT_WAKEUP_REASON_DEBUG
-static VOID nicRxCheckWakeupReason(P_SW_RFB_T prSwRfb)
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Classify an IPv4 packet that woke the host
+*
+* @param pucIp Start of the IPv4 header
+* @param u2Len Bytes available from pucIp on
+* @param fgIsBmcast The destination MAC is broadcast/multicast
+* @param pucIpProto Returns the IP protocol
+* @param pu2DstPort Returns the TCP/UDP destination port, or 0
+*
+* @return The wakeup reason
+*/
+/*----------------------------------------------------------------------------*/
+static ENUM_WAKEUP_REASON_T
+nicRxClassifyIpv4Wakeup(PUINT_8 pucIp, UINT_16 u2Len, BOOLEAN fgIsBmcast,
+			PUINT_8 pucIpProto, PUINT_16 pu2DstPort)
+{
+	UINT_32 u4IpHdrLen;
+	UINT_16 u2DstPort;
+
+	*pucIpProto = 0;
+	*pu2DstPort = 0;
+	if (u2Len < 20)
+		return WAKEUP_REASON_IPV4_OTHER;
+
+	*pucIpProto = pucIp[9];
+	u4IpHdrLen = (pucIp[0] & 0x0F) << 2;
+	if ((*pucIpProto != IPPROTO_TCP && *pucIpProto != IPPROTO_UDP) || u2Len < u4IpHdrLen + 4)
+		return fgIsBmcast ? WAKEUP_REASON_IPV4_BMCAST : WAKEUP_REASON_IPV4_OTHER;
+
+	u2DstPort = (pucIp[u4IpHdrLen + 2] << 8) | pucIp[u4IpHdrLen + 3];
+	*pu2DstPort = u2DstPort;
+
+	if (*pucIpProto == IPPROTO_UDP) {
+		if (u2DstPort == 5353)
+			return WAKEUP_REASON_MDNS;
+		if (u2DstPort == 1900)
+			return WAKEUP_REASON_SSDP;
+	}
+	if (fgIsBmcast)
+		return WAKEUP_REASON_IPV4_BMCAST;
+
+	return (*pucIpProto == IPPROTO_TCP) ? WAKEUP_REASON_IPV4_TCP : WAKEUP_REASON_IPV4_UDP;
+}
+
+static VOID nicRxCheckWakeupReason(P_ADAPTER_T prAdapter, P_SW_RFB_T prSwRfb)
 {
 	PUINT_8 pvHeader = NULL;
 	P_HIF_RX_HEADER_T prHifRxHdr;
 	UINT_16 u2PktLen = 0;
 	UINT_32 u4HeaderOffset;
+	ENUM_WAKEUP_REASON_T eReason = WAKEUP_REASON_UNKNOWN;
+	UINT_8 ucIpProto = 0;
+	UINT_16 u2DstPort = 0;
 
 	if (!prSwRfb)
 		return;
@@ -2580,6 +2628,7 @@ static VOID nicRxCheckWakeupReason(P_SW_RFB_T prSwRfb)
 		if (HIF_RX_HDR_GET_BAR_FLAG(prHifRxHdr)) {
 			DBGLOG(RX, INFO, "BAR frame[SSN:%d, TID:%d] wakeup host\n",
 				(UINT_16)HIF_RX_HDR_GET_SN(prHifRxHdr), (UINT_8)HIF_RX_HDR_GET_TID(prHifRxHdr));
+			eReason = WAKEUP_REASON_BAR;
 			break;
 		}
 		u4HeaderOffset = (UINT_32)(prHifRxHdr->ucHerderLenOffset & HIF_RX_HDR_HEADER_OFFSET_MASK);
@@ -2593,24 +2642,42 @@ static VOID nicRxCheckWakeupReason(P_SW_RFB_T prSwRfb)
 
 		switch (u2Temp) {
 		case ETH_P_IPV4:
+			if (u2PktLen > ETH_HLEN)
+				eReason = nicRxClassifyIpv4Wakeup(&pvHeader[ETH_HLEN], u2PktLen - ETH_HLEN,
+								  (pvHeader[0] & BIT(0)) ? TRUE : FALSE,
+								  &ucIpProto, &u2DstPort);
+			else
+				eReason = WAKEUP_REASON_IPV4_OTHER;
 			u2Temp = *(UINT_16 *) &pvHeader[ETH_HLEN + 4];
-			DBGLOG(RX, INFO, "IP Packet from:%d.%d.%d.%d, IP ID 0x%04x wakeup host\n",
+			DBGLOG(RX, INFO, "IP Packet from:%d.%d.%d.%d, IP ID 0x%04x proto %u port %u wakeup host\n",
 				pvHeader[ETH_HLEN + 12], pvHeader[ETH_HLEN + 13],
-				pvHeader[ETH_HLEN + 14], pvHeader[ETH_HLEN + 15], u2Temp);
+				pvHeader[ETH_HLEN + 14], pvHeader[ETH_HLEN + 15], u2Temp, ucIpProto, u2DstPort);
+			break;
+		case ETH_P_ARP:
+			eReason = WAKEUP_REASON_ARP;
+			DBGLOG(RX, INFO, "ARP Packet wakeup host\n");
+			break;
+		case ETH_P_IPV6:
+			eReason = WAKEUP_REASON_IPV6;
+			DBGLOG(RX, INFO, "Data Packet, EthType 0x%04x wakeup host\n", u2Temp);
 			break;
 		case ETH_P_1X:
 		case ETH_P_PRE_1X:
 #if CFG_SUPPORT_WAPI
 		case ETH_WPI_1X:
 #endif
+			eReason = WAKEUP_REASON_1X;
+			DBGLOG(RX, INFO, "Data Packet, EthType 0x%04x wakeup host\n", u2Temp);
+			break;
 		case ETH_P_AARP:
-		case ETH_P_IPV6:
 		case ETH_P_IPX:
 		case 0x8100: /* VLAN */
 		case 0x890d: /* TDLS */
+			eReason = WAKEUP_REASON_DATA_OTHER;
 			DBGLOG(RX, INFO, "Data Packet, EthType 0x%04x wakeup host\n", u2Temp);
 			break;
 		default:
+			eReason = WAKEUP_REASON_DATA_OTHER;
 			DBGLOG(RX, WARN, "maybe abnormal data packet, EthType 0x%04x wakeup host, dump it\n",
 				u2Temp);
 			DBGLOG_MEM8(RX, INFO, pvHeader, u2PktLen > 50 ? 50:u2PacketLen);
@@ -2622,6 +2689,7 @@ static VOID nicRxCheckWakeupReason(P_SW_RFB_T prSwRfb)
 	{
 		P_WIFI_EVENT_T prEvent = (P_WIFI_EVENT_T) prSwRfb->pucRecvBuff;
 
+		eReason = WAKEUP_REASON_EVENT;
 		DBGLOG(RX, INFO, "Event 0x%02x wakeup host\n", prEvent->ucEID);
 		break;
 	}
@@ -2639,6 +2707,7 @@ static VOID nicRxCheckWakeupReason(P_SW_RFB_T prSwRfb)
 		prWlanMgmtHeader = (P_WLAN_MAC_MGMT_HEADER_T)pvHeader;
 		ucSubtype = (prWlanMgmtHeader->u2FrameCtrl & MASK_FC_SUBTYPE) >>
 				OFFSET_OF_FC_SUBTYPE;
+		eReason = WAKEUP_REASON_MGMT;
 		DBGLOG(RX, INFO, "MGMT frame subtype: %d SeqCtrl %d wakeup host\n",
 				ucSubtype, prWlanMgmtHeader->u2SeqCtrl);
 		break;
@@ -2647,6 +2716,8 @@ static VOID nicRxCheckWakeupReason(P_SW_RFB_T prSwRfb)
 		DBGLOG(RX, WARN, "Unknown Packet %d wakeup host\n", prSwRfb->ucPacketType);
 		break;
 	}
+
+	kalUpdateWakeupStats(prAdapter->prGlueInfo, eReason, ucIpProto, u2DstPort);
 }
 #endif
 /*----------------------------------------------------------------------------*/
@@ -2683,7 +2754,7 @@ VOID nicRxProcessRFBs(IN P_ADAPTER_T prAdapter)
 		if (prSwRfb) {
 #if CFG_SUPPORT_WAKEUP_REASON_DEBUG
 			if (kalIsWakeupByWlan(prAdapter))
-				nicRxCheckWakeupReason(prSwRfb);
+				nicRxCheckWakeupReason(prAdapter, prSwRfb);
 #endif
 			switch (prSwRfb->ucPacketType) {
 			case HIF_RX_PKT_TYPE_DATA:
@@ -3065,6 +3136,7 @@ VOID nicRxSDIOAggReceiveRFBs(IN P_ADAPTER_T prAdapter)
 	P_RX_CTRL_T prRxCtrl;
 	P_SDIO_CTRL_T prSDIOCtrl;
 	P_SW_RFB_T prSwRfb = (P_SW_RFB_T) NULL;
+	P_SW_RFB_T prDirectSwRfb;
 	UINT_32 u4RxLength;
 	UINT_32 i, rxNum;
 	UINT_32 u4RxAggCount = 0, u4RxAggLength = 0;
@@ -3174,15 +3246,42 @@ VOID nicRxSDIOAggReceiveRFBs(IN P_ADAPTER_T prAdapter)
 			/* DBGLOG(RX, INFO, ("u4RxAggCount = %d, u4RxAggLength = %d\n", */
 			/* u4RxAggCount, u4RxAggLength)); */
 
-			HAL_READ_RX_PORT(prAdapter,
-					 rxNum,
-					 u4RxAggLength, prRxCtrl->pucRxCoalescingBufPtr, CFG_RX_COALESCING_BUFFER_SIZE);
-			if (!fgResult) {
-				DBGLOG(RX, ERROR, "Read RX Agg Packet Error\n");
-				continue;
+			prDirectSwRfb = NULL;
+#if CFG_RX_DIRECT_DMA
+			/* a lone frame (plus the enhance mode trailer) fits in its RFB, so
+			 * DMA it there and skip the bounce through the coalescing buffer */
+			if (u4RxAggCount == 1 && u4RxAggLength <= CFG_RX_MAX_PKT_SIZE) {
+				KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+				QUEUE_REMOVE_HEAD(&prRxCtrl->rFreeSwRfbList, prDirectSwRfb, P_SW_RFB_T);
+				KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+				ASSERT(prDirectSwRfb);
+			}
+
+			if (prDirectSwRfb) {
+				HAL_READ_RX_PORT(prAdapter,
+						 rxNum, u4RxAggLength, prDirectSwRfb->pucRecvBuff, CFG_RX_MAX_PKT_SIZE);
+				if (!fgResult) {
+					DBGLOG(RX, ERROR, "Read RX Packet Error\n");
+					KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+					QUEUE_INSERT_HEAD(&prRxCtrl->rFreeSwRfbList, &prDirectSwRfb->rQueEntry);
+					KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+					continue;
+				}
+				pucSrcAddr = prDirectSwRfb->pucRecvBuff;
+			} else
+#endif
+			{
+				HAL_READ_RX_PORT(prAdapter,
+						 rxNum,
+						 u4RxAggLength, prRxCtrl->pucRxCoalescingBufPtr,
+						 CFG_RX_COALESCING_BUFFER_SIZE);
+				if (!fgResult) {
+					DBGLOG(RX, ERROR, "Read RX Agg Packet Error\n");
+					continue;
+				}
+				pucSrcAddr = prRxCtrl->pucRxCoalescingBufPtr;
 			}
 
-			pucSrcAddr = prRxCtrl->pucRxCoalescingBufPtr;
 			for (i = 0; i < u4RxAggCount; i++) {
 				UINT_16 u2PktLength;
 
@@ -3190,13 +3289,17 @@ VOID nicRxSDIOAggReceiveRFBs(IN P_ADAPTER_T prAdapter)
 					       prEnhDataStr->rRxInfo.u.au2Rx0Len[i] :
 					       prEnhDataStr->rRxInfo.u.au2Rx1Len[i]);
 
-				KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-				QUEUE_REMOVE_HEAD(&prRxCtrl->rFreeSwRfbList, prSwRfb, P_SW_RFB_T);
-				KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+				if (prDirectSwRfb) {
+					prSwRfb = prDirectSwRfb;
+				} else {
+					KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+					QUEUE_REMOVE_HEAD(&prRxCtrl->rFreeSwRfbList, prSwRfb, P_SW_RFB_T);
+					KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 
-				ASSERT(prSwRfb);
-				kalMemCopy(prSwRfb->pucRecvBuff, pucSrcAddr,
-					   ALIGN_4(u2PktLength + HIF_RX_HW_APPENDED_LEN));
+					ASSERT(prSwRfb);
+					kalMemCopy(prSwRfb->pucRecvBuff, pucSrcAddr,
+						   ALIGN_4(u2PktLength + HIF_RX_HW_APPENDED_LEN));
+				}
 
 				/* record the rx time */
 				STATS_RX_ARRIVE_TIME_RECORD(prSwRfb);	/* ms */
@@ -429,6 +429,10 @@
 *                              C O N S T A N T S
 ********************************************************************************
 */
+#if CFG_TX_DIRECT_DMA
+/* below this a memcpy into the coalescing buffer is cheaper than an own DMA */
+#define NIC_TX_DIRECT_DMA_THRESHOLD     512
+#endif
 
 /*******************************************************************************
 *                             D A T A   T Y P E S
@@ -1316,6 +1320,10 @@ WLAN_STATUS nicTxMsduQueue(IN P_ADAPTER_T prAdapter, UINT_8 ucPortIdx, P_QUE_T p
 #if CFG_TCP_IP_CHKSUM_OFFLOAD
 	UINT_8 ucChksumFlag;
 #endif
+#if CFG_TX_DIRECT_DMA
+	PUINT_8 pucDirectBuf;
+	UINT_32 u4DirectLength;
+#endif
 
 	ASSERT(prAdapter);
 	ASSERT(ucPortIdx < 2);
@@ -1443,18 +1451,43 @@ WLAN_STATUS nicTxMsduQueue(IN P_ADAPTER_T prAdapter, UINT_8 ucPortIdx, P_QUE_T p
 			STATS_TX_TIME_TO_HIF(prMsduInfo, &rHwTxHeader);
 
 #if CFG_SDIO_TX_AGG
-			/* attach to coalescing buffer */
-			kalMemCopy(pucOutputBuf + u4TotalLength, &rHwTxHeader, u4TxHdrSize);
-			u4TotalLength += u4TxHdrSize;
+#if CFG_TX_DIRECT_DMA
+			pucDirectBuf = NULL;
+			if ((prMsduInfo->eSrc == TX_PACKET_OS || prMsduInfo->eSrc == TX_PACKET_FORWARDING) &&
+			    prMsduInfo->u2FrameLength >= NIC_TX_DIRECT_DMA_THRESHOLD)
+				pucDirectBuf = kalTxPushHwHeader(prAdapter->prGlueInfo, prNativePacket, u4TxHdrSize);
+
+			if (pucDirectBuf) {
+				/* frames must reach the port in order, send what is coalesced first */
+				if (u4TotalLength > 0) {
+					HAL_WRITE_TX_PORT(prAdapter, ucPortIdx, u4TotalLength, (PUINT_8) pucOutputBuf,
+							  u4ValidBufSize);
+					u4TotalLength = 0;
+				}
 
-			if (prMsduInfo->eSrc == TX_PACKET_OS || prMsduInfo->eSrc == TX_PACKET_FORWARDING)
-				kalCopyFrame(prAdapter->prGlueInfo, prNativePacket, pucOutputBuf + u4TotalLength);
-			else if (prMsduInfo->eSrc == TX_PACKET_MGMT)
-				kalMemCopy(pucOutputBuf + u4TotalLength, prNativePacket, prMsduInfo->u2FrameLength);
-			else
-				ASSERT(0);
+				/* the HW header goes into the skb headroom and the frame is DMA'd in place */
+				kalMemCopy(pucDirectBuf, &rHwTxHeader, u4TxHdrSize);
+				u4DirectLength = ALIGN_4(u4TxHdrSize + prMsduInfo->u2FrameLength);
+				HAL_WRITE_TX_PORT(prAdapter, ucPortIdx, u4DirectLength, pucDirectBuf, u4DirectLength);
 
-			u4TotalLength += ALIGN_4(prMsduInfo->u2FrameLength);
+				kalTxPullHwHeader(prAdapter->prGlueInfo, prNativePacket, u4TxHdrSize);
+			} else
+#endif
+			{
+				/* attach to coalescing buffer */
+				kalMemCopy(pucOutputBuf + u4TotalLength, &rHwTxHeader, u4TxHdrSize);
+				u4TotalLength += u4TxHdrSize;
+
+				if (prMsduInfo->eSrc == TX_PACKET_OS || prMsduInfo->eSrc == TX_PACKET_FORWARDING)
+					kalCopyFrame(prAdapter->prGlueInfo, prNativePacket, pucOutputBuf + u4TotalLength);
+				else if (prMsduInfo->eSrc == TX_PACKET_MGMT)
+					kalMemCopy(pucOutputBuf + u4TotalLength, prNativePacket,
+						   prMsduInfo->u2FrameLength);
+				else
+					ASSERT(0);
+
+				u4TotalLength += ALIGN_4(prMsduInfo->u2FrameLength);
+			}
 
 #else
 			kalMemCopy(pucOutputBuf, &rHwTxHeader, u4TxHdrSize);
@@ -1516,8 +1549,14 @@ WLAN_STATUS nicTxMsduQueue(IN P_ADAPTER_T prAdapter, UINT_8 ucPortIdx, P_QUE_T p
 #endif
 
 		/* send coalescing buffer */
+#if CFG_TX_DIRECT_DMA
+		/* may be empty if the last frames went out directly */
+		if (u4TotalLength > 0)
+			HAL_WRITE_TX_PORT(prAdapter, ucPortIdx, u4TotalLength, (PUINT_8) pucOutputBuf, u4ValidBufSize);
+#else
 		HAL_WRITE_TX_PORT(prAdapter, ucPortIdx, u4TotalLength, (PUINT_8) pucOutputBuf, u4ValidBufSize);
 #endif
+#endif
 
 #if CFG_ENABLE_PKT_LIFETIME_PROFILE
 #if CFG_SUPPORT_WFD && CFG_PRINT_RTP_PROFILE && !CFG_ENABLE_PER_STA_STATISTICS
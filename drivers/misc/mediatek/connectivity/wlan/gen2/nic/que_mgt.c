@@ -470,11 +470,35 @@ Add per station flow control when STA is in PS
 *                              C O N S T A N T S
 ********************************************************************************
 */
+#if CFG_QM_AIRTIME_FAIRNESS
+/* Airtime (us) credited to every backlogged STA per deficit round */
+#define QM_ATF_QUANTUM_US			4000
+/* Initial airtime cost per KB, roughly 54 Mbps including MAC overhead */
+#define QM_ATF_DEFAULT_US_PER_KBYTE		180
+#define QM_ATF_MIN_US_PER_KBYTE			20	/* ~400 Mbps */
+#define QM_ATF_MAX_US_PER_KBYTE			8000	/* ~1 Mbps */
+/* TX-done intervals longer than this are idle time, not airtime */
+#define QM_ATF_MAX_SAMPLE_MS			100
+#define QM_ATF_MAX_INFLIGHT_BYTES		(256 * 1024)
+/* Per STA per AC queue limits, in bytes so queueing delay stays bounded */
+#define QM_ATF_FWD_QUE_BYTES_LIMIT		(48 * 1024)
+#define QM_ATF_QUE_BYTES_LIMIT			(128 * 1024)
+#endif
 
 /*******************************************************************************
 *                             D A T A   T Y P E S
 ********************************************************************************
 */
+#if CFG_QM_AIRTIME_FAIRNESS
+typedef struct _QM_ATF_STA_INFO_T {
+	INT_32 ai4DeficitUs[NUM_OF_PER_STA_TX_QUEUES];	/* Airtime the STA may still use this round */
+	UINT_32 au4QueuedBytes[NUM_OF_PER_STA_TX_QUEUES];
+	UINT_32 u4UsPerKByte;	/* Estimated airtime cost of 1 KB to this STA */
+	UINT_32 u4AvgFrameLen;
+	UINT_32 u4InflightBytes;	/* Dequeued to FW but not yet reported TX done */
+	OS_SYSTIME rLastTxDoneTime;
+} QM_ATF_STA_INFO_T, *P_QM_ATF_STA_INFO_T;
+#endif
 
 /*******************************************************************************
 *                            P U B L I C   D A T A
@@ -490,6 +514,9 @@ OS_SYSTIME g_arMissTimeout[CFG_STA_REC_NUM][CFG_RX_MAX_BA_TID_NUM];
 static UINT_16 arpMoniter;
 static UINT_8 apIp[4];
 #endif
+#if CFG_QM_AIRTIME_FAIRNESS
+static QM_ATF_STA_INFO_T g_arQmAtfStaInfo[CFG_NUM_OF_STA_RECORD];
+#endif
 /*******************************************************************************
 *                                 M A C R O S
 ********************************************************************************
@@ -514,6 +541,204 @@ qmDequeueTxPacketsFromPerTypeQueues(IN P_ADAPTER_T prAdapter, OUT P_QUE_T prQue,
 ********************************************************************************
 */
 
+#if CFG_QM_AIRTIME_FAIRNESS
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Reset the airtime fairness state of a STA_REC
+*
+* \param[in] u4StaRecIdx The index of the STA_REC
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID qmAtfResetStaInfo(IN UINT_32 u4StaRecIdx)
+{
+	P_QM_ATF_STA_INFO_T prAtf = &g_arQmAtfStaInfo[u4StaRecIdx];
+
+	kalMemZero(prAtf, sizeof(QM_ATF_STA_INFO_T));
+	prAtf->u4UsPerKByte = QM_ATF_DEFAULT_US_PER_KBYTE;
+}
+
+static inline UINT_32 qmAtfFrameCost(IN P_QM_ATF_STA_INFO_T prAtf, IN UINT_32 u4Len)
+{
+	return (u4Len * prAtf->u4UsPerKByte) >> 10;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Check whether a per-STA TX queue holds too many bytes to take one
+*        more frame. Forwarded frames get the tighter limit since they have
+*        no socket backpressure at all. Our own frames to an AP peer are left
+*        to the netif queue flow control as before.
+*
+* \param[in] prStaRec The destination STA_REC
+* \param[in] ucTC The TC index of the queue
+* \param[in] prMsduInfo The frame to be queued
+*
+* \return TRUE if the frame shall be dropped
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN qmAtfIsQueueFull(IN P_STA_RECORD_T prStaRec, IN UINT_8 ucTC, IN P_MSDU_INFO_T prMsduInfo)
+{
+	UINT_32 u4Limit;
+
+	if (ucTC >= NUM_OF_PER_STA_TX_QUEUES)
+		return FALSE;
+
+	if (prMsduInfo->eSrc == TX_PACKET_FORWARDING)
+		u4Limit = QM_ATF_FWD_QUE_BYTES_LIMIT;
+	else if (!prStaRec->fgIsAp)
+		u4Limit = QM_ATF_QUE_BYTES_LIMIT;
+	else
+		return FALSE;
+
+	return (g_arQmAtfStaInfo[prStaRec->ucIndex].au4QueuedBytes[ucTC] + prMsduInfo->u2FrameLength) > u4Limit;
+}
+
+static VOID qmAtfEnqueue(IN UINT_32 u4StaRecIdx, IN UINT_8 ucTC, IN P_MSDU_INFO_T prMsduInfo)
+{
+	if (ucTC < NUM_OF_PER_STA_TX_QUEUES)
+		g_arQmAtfStaInfo[u4StaRecIdx].au4QueuedBytes[ucTC] += prMsduInfo->u2FrameLength;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Charge a frame leaving a per-STA queue against the STA's deficit
+*
+* \param[in] u4StaRecIdx The index of the STA_REC
+* \param[in] ucTC The TC index of the queue
+* \param[in] prMsduInfo The dequeued frame
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID qmAtfDequeue(IN UINT_32 u4StaRecIdx, IN UINT_8 ucTC, IN P_MSDU_INFO_T prMsduInfo)
+{
+	P_QM_ATF_STA_INFO_T prAtf = &g_arQmAtfStaInfo[u4StaRecIdx];
+	UINT_32 u4Len = prMsduInfo->u2FrameLength;
+
+	if (ucTC >= NUM_OF_PER_STA_TX_QUEUES)
+		return;
+
+	if (prAtf->au4QueuedBytes[ucTC] > u4Len)
+		prAtf->au4QueuedBytes[ucTC] -= u4Len;
+	else
+		prAtf->au4QueuedBytes[ucTC] = 0;
+
+	prAtf->ai4DeficitUs[ucTC] -= (INT_32) qmAtfFrameCost(prAtf, u4Len);
+
+	/* An idle STA starts a new busy period: airtime counts from now on */
+	if (prAtf->u4InflightBytes == 0)
+		GET_CURRENT_SYSTIME(&prAtf->rLastTxDoneTime);
+	if (prAtf->u4InflightBytes < QM_ATF_MAX_INFLIGHT_BYTES)
+		prAtf->u4InflightBytes += u4Len;
+
+	prAtf->u4AvgFrameLen = prAtf->u4AvgFrameLen ? (prAtf->u4AvgFrameLen * 7 + u4Len) >> 3 : u4Len;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Start a new deficit round for a TC if no backlogged STA has airtime
+*        left. Every backlogged STA is credited by the same amount, enough
+*        for the best one to get a full quantum, which is what running as
+*        many plain DRR rounds would do.
+*
+* \param[in] prAdapter Pointer to the Adapter structure
+* \param[in] ucTC The TC index
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID qmAtfRefillDeficit(IN P_ADAPTER_T prAdapter, IN UINT_8 ucTC)
+{
+	P_STA_RECORD_T prStaRec;
+	INT_32 i4MaxDeficit = 0;
+	BOOLEAN fgBacklogged = FALSE;
+	UINT_32 i;
+
+	if (ucTC >= NUM_OF_PER_STA_TX_QUEUES)
+		return;
+
+	for (i = 0; i < CFG_NUM_OF_STA_RECORD; i++) {
+		prStaRec = &prAdapter->arStaRec[i];
+		if (!prStaRec->fgIsValid || QUEUE_IS_EMPTY(&prStaRec->arTxQueue[ucTC]))
+			continue;
+
+		if (!fgBacklogged || g_arQmAtfStaInfo[i].ai4DeficitUs[ucTC] > i4MaxDeficit)
+			i4MaxDeficit = g_arQmAtfStaInfo[i].ai4DeficitUs[ucTC];
+		fgBacklogged = TRUE;
+	}
+
+	if (!fgBacklogged || i4MaxDeficit > 0)
+		return;
+
+	for (i = 0; i < CFG_NUM_OF_STA_RECORD; i++) {
+		prStaRec = &prAdapter->arStaRec[i];
+		if (!prStaRec->fgIsValid)
+			continue;
+
+		if (QUEUE_IS_EMPTY(&prStaRec->arTxQueue[ucTC]))
+			/* Idle STAs do not bank airtime */
+			g_arQmAtfStaInfo[i].ai4DeficitUs[ucTC] = 0;
+		else
+			g_arQmAtfStaInfo[i].ai4DeficitUs[ucTC] += QM_ATF_QUANTUM_US - i4MaxDeficit;
+	}
+}
+
+static inline BOOLEAN qmAtfHasDeficit(IN UINT_32 u4StaRecIdx, IN UINT_8 ucTC)
+{
+	if (ucTC >= NUM_OF_PER_STA_TX_QUEUES)
+		return TRUE;
+
+	return g_arQmAtfStaInfo[u4StaRecIdx].ai4DeficitUs[ucTC] > 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Learn the airtime cost of a STA from a TX done report. The time since
+*        the previous report, while the STA had frames in flight, is taken as
+*        the airtime spent on the frames just completed.
+*
+* \param[in] u4StaRecIdx The index of the STA_REC
+* \param[in] ucNumOfTxDone Number of frames the FW reports as done
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID qmAtfUpdateAirtime(IN UINT_32 u4StaRecIdx, IN UINT_8 ucNumOfTxDone)
+{
+	P_QM_ATF_STA_INFO_T prAtf = &g_arQmAtfStaInfo[u4StaRecIdx];
+	OS_SYSTIME rCurrentTime;
+	UINT_32 u4ElapsedMs;
+	UINT_32 u4DoneBytes;
+	UINT_32 u4Sample;
+
+	if (ucNumOfTxDone == 0 || prAtf->u4InflightBytes == 0)
+		return;
+
+	GET_CURRENT_SYSTIME(&rCurrentTime);
+	u4ElapsedMs = (UINT_32) (rCurrentTime - prAtf->rLastTxDoneTime);
+	prAtf->rLastTxDoneTime = rCurrentTime;
+
+	u4DoneBytes = ucNumOfTxDone * prAtf->u4AvgFrameLen;
+	if (u4DoneBytes > prAtf->u4InflightBytes || u4DoneBytes == 0)
+		u4DoneBytes = prAtf->u4InflightBytes;
+	prAtf->u4InflightBytes -= u4DoneBytes;
+
+	/* Several reports within one tick tell nothing about the rate */
+	if (u4ElapsedMs == 0 || u4ElapsedMs > QM_ATF_MAX_SAMPLE_MS)
+		return;
+
+	u4Sample = (u4ElapsedMs * 1000 * 1024) / u4DoneBytes;
+	if (u4Sample < QM_ATF_MIN_US_PER_KBYTE)
+		u4Sample = QM_ATF_MIN_US_PER_KBYTE;
+	else if (u4Sample > QM_ATF_MAX_US_PER_KBYTE)
+		u4Sample = QM_ATF_MAX_US_PER_KBYTE;
+
+	prAtf->u4UsPerKByte = (prAtf->u4UsPerKByte * 7 + u4Sample) >> 3;
+}
+#endif /* CFG_QM_AIRTIME_FAIRNESS */
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief Init Queue Management for TX
@@ -600,6 +825,11 @@ VOID qmInit(IN P_ADAPTER_T prAdapter)
 
 	kalMemSet(&g_arMissTimeout, 0, sizeof(g_arMissTimeout));
 
+#if CFG_QM_AIRTIME_FAIRNESS
+	for (i = 0; i < CFG_NUM_OF_STA_RECORD; i++)
+		qmAtfResetStaInfo(i);
+#endif
+
 #if QM_ADAPTIVE_TC_RESOURCE_CTRL
 	/* 4 <4> Initialize TC resource control variables */
 	for (i = 0; i < TC_NUM; i++)
@@ -787,6 +1017,10 @@ VOID qmActivateStaRec(IN P_ADAPTER_T prAdapter, IN P_STA_RECORD_T prStaRec)
 	prStaRec->ucPsSessionID = 0xFF;
 	prStaRec->fgIsAp = (IS_AP_STA(prStaRec)) ? TRUE : FALSE;
 
+#if CFG_QM_AIRTIME_FAIRNESS
+	qmAtfResetStaInfo(prStaRec->ucIndex);
+#endif
+
 	/* Done in qmInit() or qmDeactivateStaRec() */
 #if 0
 	/* At the beginning, no RX BA agreements have been established */
@@ -945,6 +1179,10 @@ P_MSDU_INFO_T qmFlushTxQueues(IN P_ADAPTER_T prAdapter)
 
 			QUEUE_INITIALIZE(&prAdapter->arStaRec[ucStaArrayIdx].arTxQueue[ucQueArrayIdx]);
 		}
+#if CFG_QM_AIRTIME_FAIRNESS
+		kalMemZero(g_arQmAtfStaInfo[ucStaArrayIdx].au4QueuedBytes,
+			   sizeof(g_arQmAtfStaInfo[ucStaArrayIdx].au4QueuedBytes));
+#endif
 	}
 
 	/* Flush per-Type queues */
@@ -1035,6 +1273,9 @@ P_MSDU_INFO_T qmFlushStaTxQueues(IN P_ADAPTER_T prAdapter, IN UINT_32 u4StaRecId
 		QUEUE_INITIALIZE(&prStaRec->arTxQueue[ucQueArrayIdx]);
 
 	}
+#if CFG_QM_AIRTIME_FAIRNESS
+	kalMemZero(g_arQmAtfStaInfo[u4StaRecIdx].au4QueuedBytes, sizeof(g_arQmAtfStaInfo[u4StaRecIdx].au4QueuedBytes));
+#endif
 
 #if 0
 	if (prMsduInfoListTail) {
@@ -1210,6 +1451,9 @@ P_MSDU_INFO_T qmEnqueueTxPackets(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMs
 		P_BSS_INFO_T prBssInfo;
 		BOOLEAN fgCheckACMAgain;
 		ENUM_WMM_ACI_T eAci = WMM_AC_BE_INDEX;
+#if CFG_QM_AIRTIME_FAIRNESS
+		BOOLEAN fgIsPerStaQue = FALSE;
+#endif
 
 		prCurrentMsduInfo = prNextMsduInfo;
 		prNextMsduInfo = QM_TX_GET_NEXT_MSDU_INFO(prCurrentMsduInfo);
@@ -1337,6 +1581,9 @@ P_MSDU_INFO_T qmEnqueueTxPackets(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMs
 						fgCheckACMAgain = TRUE;
 					}
 				} while (fgCheckACMAgain);
+#if CFG_QM_AIRTIME_FAIRNESS
+				fgIsPerStaQue = TRUE;
+#endif
 
 				/* LOG_FUNC ("QoS %u UP %u TC %u", */
 				/*		prStaRec->fgIsQoS,prCurrentMsduInfo->ucUserPriority, ucTC); */
@@ -1368,6 +1615,18 @@ P_MSDU_INFO_T qmEnqueueTxPackets(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMs
 				break;	/*default */
 			}	/* switch (prCurrentMsduInfo->ucStaRecIndex) */
 
+#if CFG_QM_AIRTIME_FAIRNESS
+			if (fgIsPerStaQue) {
+				if (qmAtfIsQueueFull(prStaRec, ucTC, prCurrentMsduInfo)) {
+					DBGLOG(QM, WARN, "Drop the Packet for full Tx queue STA %u TC %u\n",
+					       prStaRec->ucIndex, ucTC);
+					if (prCurrentMsduInfo->eSrc == TX_PACKET_FORWARDING)
+						TX_INC_CNT(&prAdapter->rTxCtrl, TX_FORWARD_OVERFLOW_DROP);
+					prTxQue = &rNotEnqueuedQue;
+					fgIsPerStaQue = FALSE;
+				}
+			} else
+#endif
 			if (prCurrentMsduInfo->eSrc == TX_PACKET_FORWARDING) {
 				if (prTxQue->u4NumElem > 32) {
 					DBGLOG(QM, WARN,
@@ -1409,6 +1668,10 @@ P_MSDU_INFO_T qmEnqueueTxPackets(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMs
 
 		/* 4 <4> Enqueue the packet to different AC queue (max 5 AC queues) */
 		QUEUE_INSERT_TAIL(prTxQue, (P_QUE_ENTRY_T) prCurrentMsduInfo);
+#if CFG_QM_AIRTIME_FAIRNESS
+		if (fgIsPerStaQue)
+			qmAtfEnqueue(prStaRec->ucIndex, ucTC, prCurrentMsduInfo);
+#endif
 #if QM_TC_RESOURCE_EMPTY_COUNTER
 		{
 			P_TX_CTRL_T prTxCtrl = &prAdapter->rTxCtrl;
@@ -1560,6 +1823,10 @@ qmDequeueTxPacketsFromPerStaQueues(IN P_ADAPTER_T prAdapter,
 
 	u4Resource = ucCurrentQuota;
 
+#if CFG_QM_AIRTIME_FAIRNESS
+	qmAtfRefillDeficit(prAdapter, ucTC);
+#endif
+
 	/* 4 <1> Determine the head STA */
 	/* The head STA shall be an active STA */
 
@@ -1635,8 +1902,20 @@ qmDequeueTxPacketsFromPerStaQueues(IN P_ADAPTER_T prAdapter,
 #endif /* CFG_ENABLE_WIFI_DIRECT */
 
 			/* Determine whether the head STA can continue to forward packets in this round */
-			if ((*pu4HeadStaRecForwardCount) < u4MaxForwardCount)
+			if ((*pu4HeadStaRecForwardCount) < u4MaxForwardCount) {
+#if CFG_QM_AIRTIME_FAIRNESS
+				/* A backlogged STA that used up its airtime waits for the next round */
+				if (!qmAtfHasDeficit(prStaRec->ucIndex, ucTC) &&
+				    QUEUE_IS_NOT_EMPTY(&prStaRec->arTxQueue[ucTC])) {
+					prStaRec = NULL;
+					(*pu4HeadStaRecIndex)++;
+					(*pu4HeadStaRecIndex) %= CFG_NUM_OF_STA_RECORD;
+					(*pu4HeadStaRecForwardCount) = 0;
+					continue;
+				}
+#endif
 				break;
+			}
 
 		} /* prStaRec->fgIsValid */
 		else {
@@ -1694,6 +1973,13 @@ qmDequeueTxPacketsFromPerStaQueues(IN P_ADAPTER_T prAdapter,
 		}
 #endif
 
+#if CFG_QM_AIRTIME_FAIRNESS
+		if (!qmAtfHasDeficit(prStaRec->ucIndex, ucTC)) {
+			fgChangeHeadSta = TRUE;
+			break;
+		}
+#endif
+
 		/* Three cases to break: (1) No resource (2) No packets (3) Fairness */
 		if (QUEUE_IS_EMPTY(prCurrQueue) || ((*pu4HeadStaRecForwardCount) >= u4MaxForwardCount)) {
 			fgChangeHeadSta = TRUE;
@@ -1751,6 +2037,9 @@ qmDequeueTxPacketsFromPerStaQueues(IN P_ADAPTER_T prAdapter,
 		QUEUE_INSERT_TAIL(prQue, (P_QUE_ENTRY_T) prDequeuedPkt);
 		u4Resource--;
 		(*pu4HeadStaRecForwardCount)++;
+#if CFG_QM_AIRTIME_FAIRNESS
+		qmAtfDequeue(prStaRec->ucIndex, ucTC, prDequeuedPkt);
+#endif
 
 #if CFG_ENABLE_WIFI_DIRECT
 		/* XXX The PHASE 2: decrease from  aucFreeQuotaPerQueue[] */
@@ -1851,6 +2140,11 @@ qmDequeueTxPacketsFromPerStaQueues(IN P_ADAPTER_T prAdapter,
 			/* Three cases to break: (1) No resource (2) No packets (3) Fairness */
 			if ((u4Resource == 0) || QUEUE_IS_EMPTY(prCurrQueue) || (u4ForwardCount >= u4MaxForwardCount))
 				break;
+#if CFG_QM_AIRTIME_FAIRNESS
+			/* Residual resource also follows the deficits once anything has been sent */
+			if ((u4Resource < ucCurrentQuota) && !qmAtfHasDeficit(prStaRec->ucIndex, ucTC))
+				break;
+#endif
 
 
 			QUEUE_REMOVE_HEAD(prCurrQueue, prDequeuedPkt, P_MSDU_INFO_T);
@@ -1886,6 +2180,9 @@ qmDequeueTxPacketsFromPerStaQueues(IN P_ADAPTER_T prAdapter,
 			QUEUE_INSERT_TAIL(prQue, (P_QUE_ENTRY_T) prDequeuedPkt);
 			u4Resource--;
 			u4ForwardCount++;
+#if CFG_QM_AIRTIME_FAIRNESS
+			qmAtfDequeue(prStaRec->ucIndex, ucTC, prDequeuedPkt);
+#endif
 
 #if CFG_ENABLE_WIFI_DIRECT
 			/* XXX The PHASE 2: decrease from  aucFreeQuotaPerQueue[] */
@@ -2832,6 +3129,92 @@ P_SW_RFB_T qmHandleRxPackets(IN P_ADAPTER_T prAdapter, IN P_SW_RFB_T prSwRfbList
 
 }
 
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Keep the reorder hole timer of a BA entry in step with its miss
+*        timestamp: armed when a new hole is recorded, stopped when it is gone.
+*
+* \param[in] prAdapter Pointer to the Adapter structure
+* \param[in] prReorderQueParm The BA entry
+* \param[in] rPrevMissTimeout The miss timestamp before the reorder queue update
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID
+qmUpdateRxBaMissTimer(IN P_ADAPTER_T prAdapter, IN P_RX_BA_ENTRY_T prReorderQueParm, IN OS_SYSTIME rPrevMissTimeout)
+{
+	UINT_8 ucStaRecIdx = prReorderQueParm->ucStaRecIdx;
+	UINT_8 ucTid = prReorderQueParm->ucTid;
+	OS_SYSTIME rMissTimeout = g_arMissTimeout[ucStaRecIdx][ucTid];
+
+	if (rMissTimeout == rPrevMissTimeout)
+		return;
+
+	if (rMissTimeout == 0)
+		kalRxBaTimerStop(prAdapter->prGlueInfo, ucStaRecIdx, ucTid);
+	else
+		kalRxBaTimerStart(prAdapter->prGlueInfo, ucStaRecIdx, ucTid, QM_RX_BA_ENTRY_MISS_TIMEOUT_MS);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Pass up the frames held behind reorder holes that timed out. Called
+*        from the thread serving the interrupt when a reorder hole timer
+*        fires, so a hole is flushed even if the peer sends nothing more.
+*
+* \param[in] prAdapter Pointer to the Adapter structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID qmHandleRxBaTimeout(IN P_ADAPTER_T prAdapter)
+{
+	P_RX_CTRL_T prRxCtrl = &prAdapter->rRxCtrl;
+	P_STA_RECORD_T prStaRec;
+	P_RX_BA_ENTRY_T prReorderQueParm;
+	QUE_T rReturnedQue;
+	OS_SYSTIME rCurrentTime, rPrevMissTimeout;
+	BOOLEAN fgIsBaTimeout;
+	UINT_32 i, j;
+
+	prRxCtrl->ucNumIndPacket = 0;
+	prRxCtrl->ucNumRetainedPacket = 0;
+
+	GET_CURRENT_SYSTIME(&rCurrentTime);
+
+	for (i = 0; i < CFG_NUM_OF_STA_RECORD; i++) {
+		prStaRec = &prAdapter->arStaRec[i];
+
+		for (j = 0; j < CFG_RX_MAX_BA_TID_NUM; j++) {
+			prReorderQueParm = prStaRec->aprRxReorderParamRefTbl[j];
+			if (!prReorderQueParm || !prReorderQueParm->fgIsValid)
+				continue;
+
+			rPrevMissTimeout = g_arMissTimeout[i][j];
+			if (!rPrevMissTimeout ||
+			    !CHECK_FOR_TIMEOUT(rCurrentTime, rPrevMissTimeout,
+					       MSEC_TO_SYSTIME(QM_RX_BA_ENTRY_MISS_TIMEOUT_MS)))
+				continue;
+
+			QUEUE_INITIALIZE(&rReturnedQue);
+			qmPopOutDueToFallWithin(prReorderQueParm, &rReturnedQue, &fgIsBaTimeout);
+			qmUpdateRxBaMissTimer(prAdapter, prReorderQueParm, rPrevMissTimeout);
+			STATS_RX_REORDER_HOLE_TIMEOUT_INC(prStaRec, fgIsBaTimeout);
+
+			if (QUEUE_IS_NOT_EMPTY(&rReturnedQue)) {
+				QM_TX_SET_NEXT_MSDU_INFO((P_SW_RFB_T) QUEUE_GET_TAIL(&rReturnedQue), NULL);
+				wlanProcessQueuedSwRfb(prAdapter, (P_SW_RFB_T) QUEUE_GET_HEAD(&rReturnedQue));
+			}
+		}
+	}
+
+	if (prRxCtrl->ucNumIndPacket > 0) {
+		RX_ADD_CNT(prRxCtrl, RX_DATA_INDICATION_COUNT, prRxCtrl->ucNumIndPacket);
+		kalRxIndicatePkts(prAdapter->prGlueInfo, prRxCtrl->apvIndPacket, (UINT_32) prRxCtrl->ucNumIndPacket);
+	}
+}
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief Reorder the received packet
@@ -2855,6 +3238,8 @@ VOID qmProcessPktWithReordering(IN P_ADAPTER_T prAdapter, IN P_SW_RFB_T prSwRfb,
 	P_QUE_T prReorderQue;
 	/* P_SW_RFB_T prReorderedSwRfb; */
 	BOOLEAN fgIsBaTimeout;
+	BOOLEAN fgIsQueEmpty;
+	OS_SYSTIME rPrevMissTimeout;
 
 	DEBUGFUNC("qmProcessPktWithReordering");
 
@@ -2935,7 +3320,10 @@ VOID qmProcessPktWithReordering(IN P_ADAPTER_T prAdapter, IN P_SW_RFB_T prSwRfb,
 		}
 #endif
 
-		if (qmPopOutDueToFallWithin(prReorderQueParm, prReturnedQue, &fgIsBaTimeout) == FALSE)
+		rPrevMissTimeout = g_arMissTimeout[prReorderQueParm->ucStaRecIdx][prReorderQueParm->ucTid];
+		fgIsQueEmpty = qmPopOutDueToFallWithin(prReorderQueParm, prReturnedQue, &fgIsBaTimeout);
+		qmUpdateRxBaMissTimer(prAdapter, prReorderQueParm, rPrevMissTimeout);
+		if (fgIsQueEmpty == FALSE)
 			STATS_RX_REORDER_HOLE_INC(prStaRec);	/* record hole count */
 		STATS_RX_REORDER_HOLE_TIMEOUT_INC(prStaRec, fgIsBaTimeout);
 	}
@@ -3534,6 +3922,9 @@ VOID qmDelRxBaEntry(IN P_ADAPTER_T prAdapter, IN UINT_8 ucStaRecIdx, IN UINT_8 u
 
 	if (prRxBaEntry) {
 
+		kalRxBaTimerStop(prAdapter->prGlueInfo, ucStaRecIdx, ucTid);
+		g_arMissTimeout[ucStaRecIdx][ucTid] = 0;
+
 		prFlushedPacketList = qmFlushStaRxQueue(prAdapter, ucStaRecIdx, ucTid);
 
 		if (prFlushedPacketList) {
@@ -4745,6 +5136,10 @@ VOID qmHandleEventStaUpdateFreeQuota(IN P_ADAPTER_T prAdapter, IN P_WIFI_EVENT_T
 	ASSERT(prStaRec);
 
 	if (prStaRec) {
+#if CFG_QM_AIRTIME_FAIRNESS
+		/* aucReserved[0] carries the number of frames TX done for the STA */
+		qmAtfUpdateAirtime(prStaRec->ucIndex, prEventStaUpdateFreeQuota->aucReserved[0]);
+#endif
 		if (prStaRec->fgIsInPS) {
 			qmUpdateFreeQuota(prAdapter,
 					  prStaRec,
@@ -1678,6 +1678,10 @@ static void createWirelessDevice(void)
 #if CFG_TCP_IP_CHKSUM_OFFLOAD
 	prNetDev->features = NETIF_F_HW_CSUM;
 #endif
+#if CFG_TX_DIRECT_DMA
+	/* room for the HIF TX header, see kalTxPushHwHeader() */
+	prNetDev->needed_headroom = TX_HDR_SIZE;
+#endif
 
 	/* <2.2> co-relate net device & device tree */
 	SET_NETDEV_DEV(prNetDev, wiphy_dev(prWiphy));
@@ -2289,8 +2293,31 @@ static const struct net_device_ops wlan_netdev_ops = {
 	.ndo_init = wlanInit,
 	.ndo_uninit = wlanUninit,
 	.ndo_select_queue = wlanSelectQueue,
+#if CFG_SUPPORT_MULTITHREAD && defined(CONFIG_NET_RX_BUSY_POLL)
+	.ndo_busy_poll = kalRxNapiBusyPoll,
+#endif
+};
+
+#if CFG_SUPPORT_WAKEUP_FILTER
+/* mDNS and SSDP groups, IPv4 and IPv6 */
+static const UINT_8 aucWakeFilterDefGroup[][MAC_ADDR_LEN] = {
+	{0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb},
+	{0x33, 0x33, 0x00, 0x00, 0x00, 0xfb},
+	{0x01, 0x00, 0x5e, 0x7f, 0xff, 0xfa},
+	{0x33, 0x33, 0x00, 0x00, 0x00, 0x0c},
 };
 
+static VOID wlanWakeFilterInit(P_GLUE_INFO_T prGlueInfo)
+{
+	P_GL_WAKE_FILTER_T prFilter = &prGlueInfo->rWakeFilter;
+
+	prFilter->fgEnable = TRUE;
+	prFilter->fgDropBroadcast = FALSE;
+	prFilter->u4GroupNum = ARRAY_SIZE(aucWakeFilterDefGroup);
+	kalMemCopy(prFilter->aucDropGroup, aucWakeFilterDefGroup, sizeof(aucWakeFilterDefGroup));
+}
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief A method for creating Linux NET4 struct net_device object and the
@@ -2368,6 +2395,10 @@ static struct wireless_dev *wlanNetCreate(PVOID pvData)
 	prGlueInfo->prDevHandler->ieee80211_ptr = prWdev;
 #if CFG_TCP_IP_CHKSUM_OFFLOAD
 	prGlueInfo->prDevHandler->features = NETIF_F_HW_CSUM;
+#endif
+#if CFG_TX_DIRECT_DMA
+	/* room for the HIF TX header, see kalTxPushHwHeader() */
+	prGlueInfo->prDevHandler->needed_headroom = TX_HDR_SIZE;
 #endif
 	prWdev->netdev = prGlueInfo->prDevHandler;
 
@@ -2417,6 +2448,13 @@ static struct wireless_dev *wlanNetCreate(PVOID pvData)
 	init_waitqueue_head(&prGlueInfo->waitq);
 	QUEUE_INITIALIZE(&prGlueInfo->rCmdQueue);
 	QUEUE_INITIALIZE(&prGlueInfo->rTxQueue);
+	kalRxBaTimerInit(prGlueInfo);
+#if CFG_SUPPORT_MULTITHREAD
+	kalDataPathInit(prGlueInfo);
+#endif
+#if CFG_SUPPORT_WAKEUP_FILTER
+	wlanWakeFilterInit(prGlueInfo);
+#endif
 
 	/* 4 <4> Create Adapter structure */
 	prGlueInfo->prAdapter = (P_ADAPTER_T) wlanAdapterCreate(prGlueInfo);
@@ -2460,6 +2498,7 @@ static VOID wlanNetDestroy(struct wireless_dev *prWdev)
 
 	/* destroy kal OS timer */
 	kalCancelTimer(prGlueInfo);
+	kalRxBaTimerUninit(prGlueInfo);
 
 	glClearHifInfo(prGlueInfo);
 
@@ -2496,6 +2535,84 @@ static void wlanNotifyFwSuspend(P_GLUE_INFO_T prGlueInfo, BOOLEAN fgSuspend)
 		DBGLOG(INIT, INFO, "wlanNotifyFwSuspend fail\n");
 }
 
+#if CFG_SUPPORT_WAKEUP_FILTER
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Program the FW RX filter so that noise the host does not need to see
+*        while suspended never reaches it: multicast groups in the wake filter
+*        are left out of the FW group table, and broadcast is optionally
+*        dropped. On resume the regular filter is restored through the
+*        multicast work queue.
+*
+* \param[in] prGlueInfo Pointer to the glue structure
+* \param[in] prDev      The wlan net_device
+* \param[in] fgSuspend  TRUE to apply the suspend filter, FALSE to restore
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static void wlanSetSuspendRxFilter(P_GLUE_INFO_T prGlueInfo, struct net_device *prDev, BOOLEAN fgSuspend)
+{
+	P_GL_WAKE_FILTER_T prFilter = &prGlueInfo->rWakeFilter;
+	UINT_32 u4PacketFilter = 0;
+	UINT_32 u4SetInfoLen;
+	struct netdev_hw_addr *ha;
+	PUINT_8 prMCAddrList;
+	UINT_32 j;
+	UINT_32 u4Num = 0;
+
+	if (!prFilter->fgEnable)
+		return;
+
+	if (!fgSuspend) {
+		wlanSetMulticastList(prDev);
+		return;
+	}
+
+	if ((prDev->flags & IFF_BROADCAST) && !prFilter->fgDropBroadcast)
+		u4PacketFilter |= PARAM_PACKET_FILTER_BROADCAST;
+
+	prMCAddrList = kalMemAlloc(MAX_NUM_GROUP_ADDR * ETH_ALEN, VIR_MEM_TYPE);
+	if (!prMCAddrList)
+		return;
+
+	if (prDev->flags & IFF_MULTICAST) {
+		u4PacketFilter |= PARAM_PACKET_FILTER_MULTICAST;
+
+		netif_addr_lock_bh(prDev);
+		netdev_for_each_mc_addr(ha, prDev) {
+			for (j = 0; j < prFilter->u4GroupNum; j++)
+				if (ether_addr_equal(ha->addr, prFilter->aucDropGroup[j]))
+					break;
+			if (j < prFilter->u4GroupNum)
+				continue;
+
+			if (u4Num == MAX_NUM_GROUP_ADDR) {
+				/* FW group table too small: the groups cannot be filtered */
+				u4PacketFilter &= ~PARAM_PACKET_FILTER_MULTICAST;
+				u4PacketFilter |= PARAM_PACKET_FILTER_ALL_MULTICAST;
+				break;
+			}
+			memcpy(prMCAddrList + u4Num * ETH_ALEN, ha->addr, ETH_ALEN);
+			u4Num++;
+		}
+		netif_addr_unlock_bh(prDev);
+	}
+
+	if (kalIoctl(prGlueInfo,
+		     wlanoidSetCurrentPacketFilter,
+		     &u4PacketFilter, sizeof(u4PacketFilter), FALSE, FALSE, TRUE, FALSE, &u4SetInfoLen) ==
+	    WLAN_STATUS_SUCCESS && (u4PacketFilter & PARAM_PACKET_FILTER_MULTICAST))
+		kalIoctl(prGlueInfo,
+			 wlanoidSetMulticastList,
+			 prMCAddrList, (u4Num * ETH_ALEN), FALSE, FALSE, TRUE, FALSE, &u4SetInfoLen);
+
+	DBGLOG(INIT, INFO, "suspend rx filter 0x%x, %u mc groups\n", u4PacketFilter, u4Num);
+
+	kalMemFree(prMCAddrList, VIR_MEM_TYPE, MAX_NUM_GROUP_ADDR * ETH_ALEN);
+}
+#endif
+
 void wlanHandleSystemSuspend(void)
 {
 	WLAN_STATUS rStatus = WLAN_STATUS_FAILURE;
@@ -2592,6 +2709,9 @@ void wlanHandleSystemSuspend(void)
 	}
 
 notify_suspend:
+#if CFG_SUPPORT_WAKEUP_FILTER
+	wlanSetSuspendRxFilter(prGlueInfo, prDev, TRUE);
+#endif
 	DBGLOG(INIT, INFO, "IP: %d.%d.%d.%d, rStatus: %u\n", ip[0], ip[1], ip[2], ip[3], rStatus);
 	if (rStatus != WLAN_STATUS_SUCCESS)
 		wlanNotifyFwSuspend(prGlueInfo, TRUE);
@@ -2628,6 +2748,10 @@ void wlanHandleSystemResume(void)
 	prGlueInfo = *((P_GLUE_INFO_T *) netdev_priv(prDev));
 	ASSERT(prGlueInfo);
 
+#if CFG_SUPPORT_WAKEUP_FILTER
+	wlanSetSuspendRxFilter(prGlueInfo, prDev, FALSE);
+#endif
+
 	/*
 	   We will receive the event in rx, we will check if the status is the same in driver
 	   and FW, if not the same, trigger disconnetion procedure.
@@ -2788,6 +2912,54 @@ int set_p2p_mode_handler(struct net_device *netdev, PARAM_CUSTOM_P2P_SET_STRUCT_
 #endif
 }
 
+#if CFG_SUPPORT_MULTITHREAD
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Start hif_thread and the RX NAPI next to tx_thread, each on the CPUs
+*        configured in arThreadCpuMask[].
+*
+* \param[in] prGlueInfo  Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID wlanStartHifThread(P_GLUE_INFO_T prGlueInfo)
+{
+	KAL_WAKE_LOCK_INIT(prGlueInfo->prAdapter, &prGlueInfo->rHifThreadWakeLock, "WLAN HIF THREAD");
+
+	prGlueInfo->hif_thread = kthread_run(hif_thread, prGlueInfo->prDevHandler, "hif_thread");
+
+	kalSetThreadAffinity(prGlueInfo, GLUE_THREAD_TX, &prGlueInfo->arThreadCpuMask[GLUE_THREAD_TX]);
+	kalSetThreadAffinity(prGlueInfo, GLUE_THREAD_HIF, &prGlueInfo->arThreadCpuMask[GLUE_THREAD_HIF]);
+
+	napi_enable(&prGlueInfo->rRxNapi);
+	napi_hash_add(&prGlueInfo->rRxNapi);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Wait for hif_thread to stop and drain the RX NAPI. GLUE_FLAG_HALT must
+*        already be set. This is done before waiting for tx_thread, so tx_thread
+*        flushes its queues with nobody else touching the HW.
+*
+* \param[in] prGlueInfo  Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID wlanStopHifThread(P_GLUE_INFO_T prGlueInfo)
+{
+	wake_up_interruptible(&prGlueInfo->waitq_hif);
+	wait_for_completion_interruptible(&prGlueInfo->rHifHaltComp);
+	KAL_WAKE_LOCK_DESTROY(prGlueInfo->prAdapter, &prGlueInfo->rHifThreadWakeLock);
+	prGlueInfo->hif_thread = NULL;
+
+	napi_hash_del(&prGlueInfo->rRxNapi);
+	napi_disable(&prGlueInfo->rRxNapi);
+	skb_queue_purge(&prGlueInfo->rRxNapiQueue);
+}
+#endif
+
 static void set_dbg_level_handler(unsigned char dbg_lvl[DBG_MODULE_NUM])
 {
 	kalMemCopy(aucDebugModule, dbg_lvl, sizeof(aucDebugModule));
@@ -2990,6 +3162,9 @@ bailout:
 			prWdev->wiphy->bands[IEEE80211_BAND_5GHZ] = NULL;
 
 		prGlueInfo->main_thread = kthread_run(tx_thread, prGlueInfo->prDevHandler, "tx_thread");
+#if CFG_SUPPORT_MULTITHREAD
+		wlanStartHifThread(prGlueInfo);
+#endif
 		g_u4HaltFlag = 0;
 #if CFG_SUPPORT_ROAMING_ENC
 		/* adjust roaming threshold */
@@ -3117,6 +3292,9 @@ bailout:
 			set_bit(GLUE_FLAG_HALT_BIT, &prGlueInfo->ulFlag);
 			/* wake up main thread */
 			wake_up_interruptible(&prGlueInfo->waitq);
+#if CFG_SUPPORT_MULTITHREAD
+			wlanStopHifThread(prGlueInfo);
+#endif
 			/* wait main thread stops */
 			wait_for_completion_interruptible(&prGlueInfo->rHaltComp);
 			KAL_WAKE_LOCK_DESTROY(prAdapter, &prAdapter->rTxThreadWakeLock);
@@ -3129,6 +3307,9 @@ bailout:
 			set_bit(GLUE_FLAG_HALT_BIT, &prGlueInfo->ulFlag);
 			/* wake up main thread */
 			wake_up_interruptible(&prGlueInfo->waitq);
+#if CFG_SUPPORT_MULTITHREAD
+			wlanStopHifThread(prGlueInfo);
+#endif
 			/* wait main thread stops */
 			wait_for_completion_interruptible(&prGlueInfo->rHaltComp);
 			KAL_WAKE_LOCK_DESTROY(prAdapter, &prAdapter->rTxThreadWakeLock);
@@ -3305,6 +3486,10 @@ static VOID wlanRemove(VOID)
 
 	DBGLOG(INIT, TRACE, "wait_for_completion_interruptible\n");
 
+#if CFG_SUPPORT_MULTITHREAD
+	wlanStopHifThread(prGlueInfo);
+#endif
+
 	/* wait main thread stops */
 	wait_for_completion_interruptible(&prGlueInfo->rHaltComp);
 
@@ -3450,6 +3635,10 @@ static VOID exitWlan(void)
 	/* free pre-allocated memory */
 	kalUninitIOBuffer();
 
+#if CFG_ENABLE_FW_DOWNLOAD && CFG_FW_IMAGE_CACHE
+	kalFirmwareImageCacheFree();
+#endif
+
 	DBGLOG(INIT, INFO, "exitWlan\n");
 	procUninitProcFs();
 
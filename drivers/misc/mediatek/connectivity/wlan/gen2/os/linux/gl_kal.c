@@ -704,10 +704,14 @@
 #endif
 #if CFG_SUPPORT_AGPS_ASSIST
 #include <net/netlink.h>
+#include <net/busy_poll.h>
 #endif
 #if CFG_SUPPORT_WAKEUP_REASON_DEBUG
 #include <mt_sleep.h>
 #endif
+#if CFG_FW_IMAGE_CACHE
+#include <linux/crc32.h>
+#endif
 
 /*******************************************************************************
 *                              C O N S T A N T S
@@ -765,6 +769,15 @@ typedef enum _ENUM_WMTHWVER_TYPE_T {
 } ENUM_WMTHWVER_TYPE_T, *P_ENUM_WMTHWVER_TYPE_T;
 #endif
 
+#if CFG_SUPPORT_MULTITHREAD
+static VOID kalRxNapiSchedule(IN P_GLUE_INFO_T prGlueInfo);
+#endif
+
+#if CFG_ENABLE_FW_DOWNLOAD && CFG_FW_IMAGE_CACHE
+static BOOLEAN kalFirmwareImageCacheLookup(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4FileSize);
+static VOID kalFirmwareImageCacheStore(IN PVOID pvFwBuf, IN UINT_32 u4Size);
+#endif
+
 /*******************************************************************************
 *                              F U N C T I O N S
 ********************************************************************************
@@ -781,6 +794,19 @@ static uid_t orgfsuid;
 static gid_t orgfsgid;
 static mm_segment_t orgfs;
 
+#if CFG_FW_IMAGE_CACHE
+/* FW image kept in memory across WLAN off/on, so a restart only has to
+ * re-validate it instead of reading ~500KB from flash again.
+ */
+static struct {
+	PVOID pvBuf;
+	UINT_32 u4Size;
+	UINT_32 u4Crc;
+	unsigned long ulIno;
+	struct timespec rMtime;
+} rFwImageCache;
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief This function is provided by GLUE Layer for internal driver stack to
@@ -993,8 +1019,22 @@ PVOID kalFirmwareImageMapping(IN P_GLUE_INFO_T prGlueInfo, OUT PPVOID ppvMapFile
 
 		/* <2> Query firmare size */
 		kalFirmwareSize(prGlueInfo, &u4FwSize);
+#if CFG_FW_IMAGE_CACHE
+		/* <2.1> Reuse the cached image if the file is unchanged and the copy is intact */
+		if (kalFirmwareImageCacheLookup(prGlueInfo, u4FwSize)) {
+			*pu4FileLength = rFwImageCache.u4Size;
+			*ppvMapFileBuf = rFwImageCache.pvBuf;
+
+			return rFwImageCache.pvBuf;
+		}
+#endif
 		/* <3> Use vmalloc for allocating large memory trunk */
 		prFwBuffer = vmalloc(ALIGN_4(u4FwSize));
+		if (prFwBuffer == NULL) {
+			kalFirmwareClose(prGlueInfo);
+			DBGLOG(INIT, ERROR, "vmalloc %u bytes for FW image fail!\n", u4FwSize);
+			break;
+		}
 		/* <4> Load image binary into buffer */
 		if (kalFirmwareLoad(prGlueInfo, prFwBuffer, 0, &u4FwSize) != WLAN_STATUS_SUCCESS) {
 			vfree(prFwBuffer);
@@ -1002,6 +1042,10 @@ PVOID kalFirmwareImageMapping(IN P_GLUE_INFO_T prGlueInfo, OUT PPVOID ppvMapFile
 			DBGLOG(INIT, TRACE, "kalFirmwareLoad fail!\n");
 			break;
 		}
+#if CFG_FW_IMAGE_CACHE
+		/* <4.1> Remember the image for the next WLAN on */
+		kalFirmwareImageCacheStore(prFwBuffer, u4FwSize);
+#endif
 		/* <5> write back info */
 		*pu4FileLength = u4FwSize;
 		*ppvMapFileBuf = prFwBuffer;
@@ -1032,12 +1076,98 @@ VOID kalFirmwareImageUnmapping(IN P_GLUE_INFO_T prGlueInfo, IN PVOID prFwHandle,
 	ASSERT(prGlueInfo);
 
 	/* pvMapFileBuf might be NULL when file doesn't exist */
+#if CFG_FW_IMAGE_CACHE
+	/* the cached image stays until kalFirmwareImageCacheFree() */
+	if (pvMapFileBuf && pvMapFileBuf != rFwImageCache.pvBuf)
+#else
 	if (pvMapFileBuf)
+#endif
 		vfree(pvMapFileBuf);
 
 	kalFirmwareClose(prGlueInfo);
 }
 
+#if CFG_FW_IMAGE_CACHE
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief This routine checks whether the cached firmware image can be used
+*        for the file opened by kalFirmwareOpen()
+*
+* \param prGlueInfo     Pointer of GLUE Data Structure
+* \param u4FileSize     Size of the opened firmware file
+*
+* \retval TRUE          cached image matches the file and passed its CRC check
+* \retval FALSE         caller must load the image from the file
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN kalFirmwareImageCacheLookup(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4FileSize)
+{
+	struct inode *inode;
+
+	ASSERT(prGlueInfo);
+
+	if (rFwImageCache.pvBuf == NULL)
+		return FALSE;
+
+	inode = file_inode(filp);
+	if (inode->i_ino != rFwImageCache.ulIno || u4FileSize != rFwImageCache.u4Size ||
+	    !timespec_equal(&inode->i_mtime, &rFwImageCache.rMtime)) {
+		DBGLOG(INIT, INFO, "FW image changed on disk, reload\n");
+		kalFirmwareImageCacheFree();
+		return FALSE;
+	}
+
+	/* a vmalloc area lives for the whole driver lifetime, catch stray writes */
+	if (crc32_le(~0, rFwImageCache.pvBuf, rFwImageCache.u4Size) != rFwImageCache.u4Crc) {
+		DBGLOG(INIT, ERROR, "Cached FW image CRC mismatch, reload\n");
+		kalFirmwareImageCacheFree();
+		return FALSE;
+	}
+
+	DBGLOG(INIT, INFO, "Use cached FW image, %u bytes\n", rFwImageCache.u4Size);
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief This routine takes ownership of a freshly loaded firmware image
+*
+* \param pvFwBuf        vmalloc'ed firmware image
+* \param u4Size         Length of the image
+*
+* \retval none
+*/
+/*----------------------------------------------------------------------------*/
+static VOID kalFirmwareImageCacheStore(IN PVOID pvFwBuf, IN UINT_32 u4Size)
+{
+	struct inode *inode = file_inode(filp);
+
+	kalFirmwareImageCacheFree();
+
+	rFwImageCache.pvBuf = pvFwBuf;
+	rFwImageCache.u4Size = u4Size;
+	rFwImageCache.u4Crc = crc32_le(~0, pvFwBuf, u4Size);
+	rFwImageCache.ulIno = inode->i_ino;
+	rFwImageCache.rMtime = inode->i_mtime;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief This routine releases the cached firmware image, called when the
+*        module is unloaded
+*
+* \retval none
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalFirmwareImageCacheFree(VOID)
+{
+	if (rFwImageCache.pvBuf)
+		vfree(rFwImageCache.pvBuf);
+
+	kalMemZero(&rFwImageCache, sizeof(rFwImageCache));
+}
+#endif
+
 #endif
 
 #if 0
@@ -1270,6 +1400,39 @@ VOID kalUpdateRxCSUMOffloadParam(IN PVOID pvPacket, IN ENUM_CSUM_RESULT_T aeCSUM
 }				/* kalUpdateRxCSUMOffloadParam */
 #endif /* CFG_TCP_IP_CHKSUM_OFFLOAD */
 
+#if CFG_TX_DIRECT_DMA
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Make room for the HIF TX header in front of an OS packet, so the
+*        frame can be DMA'd to the TX port from where it is.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] pvPacket   Pointer to the packet descriptor
+* \param[in] u4HdrLen   Length of the HIF TX header
+*
+* \return Start of the header, or NULL if the packet has to be copied
+*/
+/*----------------------------------------------------------------------------*/
+PUINT_8 kalTxPushHwHeader(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket, IN UINT_32 u4HdrLen)
+{
+	struct sk_buff *prSkb = (struct sk_buff *)pvPacket;
+	UINT_32 u4Pad = ALIGN_4(prSkb->len + u4HdrLen) - (prSkb->len + u4HdrLen);
+
+	/* the TX port takes one contiguous, 4 byte aligned burst */
+	if (skb_is_nonlinear(prSkb) || skb_header_cloned(prSkb) ||
+	    skb_headroom(prSkb) < u4HdrLen || skb_tailroom(prSkb) < u4Pad ||
+	    !IS_ALIGNED((ULONG) (prSkb->data - u4HdrLen), 4))
+		return NULL;
+
+	return (PUINT_8) skb_push(prSkb, u4HdrLen);
+}
+
+VOID kalTxPullHwHeader(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket, IN UINT_32 u4HdrLen)
+{
+	skb_pull((struct sk_buff *)pvPacket, u4HdrLen);
+}
+#endif /* CFG_TX_DIRECT_DMA */
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief This function is called to free packet allocated from kalPacketAlloc.
@@ -1603,14 +1766,23 @@ WLAN_STATUS kalRxIndicatePkts(IN P_GLUE_INFO_T prGlueInfo, IN PVOID apvPkts[], I
 		DBGLOG(BOW, TRACE, "\n");
 #endif
 
+#if CFG_SUPPORT_MULTITHREAD
+		skb_queue_tail(&prGlueInfo->rRxNapiQueue, prSkb);
+#else
 		if (!in_interrupt())
 			netif_rx_ni(prSkb);	/* only in non-interrupt context */
 		else
 			netif_rx(prSkb);
+#endif
 
 		wlanReturnPacket(prGlueInfo->prAdapter, NULL);
 	}
 
+#if CFG_SUPPORT_MULTITHREAD
+	if (!skb_queue_empty(&prGlueInfo->rRxNapiQueue))
+		kalRxNapiSchedule(prGlueInfo);
+#endif
+
 	return WLAN_STATUS_SUCCESS;
 }
 
@@ -2720,7 +2892,12 @@ int tx_thread(void *data)
 		 */
 		KAL_WAKE_UNLOCK(prGlueInfo->prAdapter, &(prGlueInfo->prAdapter)->rTxThreadWakeLock);
 
+#if CFG_SUPPORT_MULTITHREAD
+		ret = wait_event_interruptible(prGlueInfo->waitq,
+					       (prGlueInfo->ulFlag & GLUE_FLAG_MAIN_PROCESS) != 0);
+#else
 		ret = wait_event_interruptible(prGlueInfo->waitq, (prGlueInfo->ulFlag != 0));
+#endif
 
 		KAL_WAKE_LOCK(prGlueInfo->prAdapter, &(prGlueInfo->prAdapter)->rTxThreadWakeLock);
 
@@ -2759,6 +2936,10 @@ int tx_thread(void *data)
 
 		fgNeedHwAccess = FALSE;
 
+#if CFG_SUPPORT_MULTITHREAD
+		/* interrupts are serviced by hif_thread, only share the HW with it */
+		mutex_lock(&prGlueInfo->rHifMutex);
+#else
 		/* Handle Interrupt */
 		if (test_and_clear_bit(GLUE_FLAG_INT_BIT, &prGlueInfo->ulFlag)) {
 			if (fgNeedHwAccess == FALSE) {
@@ -2781,6 +2962,10 @@ int tx_thread(void *data)
 			}
 		}
 
+		if (test_and_clear_bit(GLUE_FLAG_RX_BA_TIMEOUT_BIT, &prGlueInfo->ulFlag))
+			qmHandleRxBaTimeout(prGlueInfo->prAdapter);
+#endif
+
 		/* transfer ioctl to OID request */
 #if 0
 		if (prGlueInfo->u4Flag & GLUE_FLAG_HALT) {
@@ -2842,6 +3027,9 @@ int tx_thread(void *data)
 #endif
 
 		if (test_and_clear_bit(GLUE_FLAG_TXREQ_BIT, &prGlueInfo->ulFlag)) {
+#if CFG_SUPPORT_MULTITHREAD
+			UINT_32 u4TxBatch = 0;
+#endif
 			/* Process Mailbox Messages */
 			wlanProcessMboxMessage(prGlueInfo->prAdapter);
 
@@ -2860,6 +3048,19 @@ int tx_thread(void *data)
 			/* Handle Packet Tx */
 			{
 				while (QUEUE_IS_NOT_EMPTY(prTxQueue)) {
+#if CFG_SUPPORT_MULTITHREAD
+					/* let a pending interrupt in between TX batches */
+					if (++u4TxBatch % GLUE_TX_YIELD_BATCH == 0 &&
+					    test_bit(GLUE_FLAG_INT_BIT, &prGlueInfo->ulFlag)) {
+						if (fgNeedHwAccess == TRUE) {
+							wlanReleasePowerControl(prGlueInfo->prAdapter);
+							fgNeedHwAccess = FALSE;
+						}
+						mutex_unlock(&prGlueInfo->rHifMutex);
+						cond_resched();
+						mutex_lock(&prGlueInfo->rHifMutex);
+					}
+#endif
 					GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
 					QUEUE_REMOVE_HEAD(prTxQueue, prQueueEntry, P_QUE_ENTRY_T);
 					GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
@@ -2914,6 +3115,9 @@ int tx_thread(void *data)
 		/* handle cnmTimer time out */
 		if (test_and_clear_bit(GLUE_FLAG_TIMEOUT_BIT, &prGlueInfo->ulFlag))
 			wlanTimerTimeoutCheck(prGlueInfo->prAdapter);
+#if CFG_SUPPORT_MULTITHREAD
+		mutex_unlock(&prGlueInfo->rHifMutex);
+#endif
 #if CFG_DBG_GPIO_PINS
 		/* TX thread go to sleep */
 		if (!prGlueInfo->ulFlag)
@@ -2947,6 +3151,360 @@ int tx_thread(void *data)
 
 }
 
+static enum hrtimer_restart kalRxBaTimerFunc(struct hrtimer *timer)
+{
+	P_GL_RX_BA_TIMER_T prBaTimer = container_of(timer, GL_RX_BA_TIMER_T, rTimer);
+	P_GLUE_INFO_T prGlueInfo = prBaTimer->prGlueInfo;
+
+	set_bit(GLUE_FLAG_RX_BA_TIMEOUT_BIT, &prGlueInfo->ulFlag);
+#if CFG_SUPPORT_MULTITHREAD
+	wake_up_interruptible(&prGlueInfo->waitq_hif);
+#else
+	wake_up_interruptible(&prGlueInfo->waitq);
+#endif
+
+	return HRTIMER_NORESTART;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Initialize the RX BA reorder hole timers.
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxBaTimerInit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	P_GL_RX_BA_TIMER_T prBaTimer;
+	int i, j;
+
+	for (i = 0; i < CFG_STA_REC_NUM; i++) {
+		for (j = 0; j < CFG_RX_MAX_BA_TID_NUM; j++) {
+			prBaTimer = &prGlueInfo->arRxBaTimer[i][j];
+			hrtimer_init(&prBaTimer->rTimer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+			prBaTimer->rTimer.function = kalRxBaTimerFunc;
+			prBaTimer->prGlueInfo = prGlueInfo;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Arm the reorder hole timer of a (STA, TID). When it fires the thread
+*        serving the interrupt calls qmHandleRxBaTimeout().
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+* @param ucStaRecIdx    STA_REC index of the BA agreement
+* @param ucTid          TID of the BA agreement
+* @param u4TimeoutMs    time to wait for the missing frame
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxBaTimerStart(IN P_GLUE_INFO_T prGlueInfo, IN UINT_8 ucStaRecIdx, IN UINT_8 ucTid, IN UINT_32 u4TimeoutMs)
+{
+	hrtimer_start(&prGlueInfo->arRxBaTimer[ucStaRecIdx][ucTid].rTimer,
+		      ms_to_ktime(u4TimeoutMs), HRTIMER_MODE_REL);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Disarm the reorder hole timer of a (STA, TID). This does not wait for
+*        a running callback, which at worst causes one spurious scan.
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+* @param ucStaRecIdx    STA_REC index of the BA agreement
+* @param ucTid          TID of the BA agreement
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxBaTimerStop(IN P_GLUE_INFO_T prGlueInfo, IN UINT_8 ucStaRecIdx, IN UINT_8 ucTid)
+{
+	hrtimer_try_to_cancel(&prGlueInfo->arRxBaTimer[ucStaRecIdx][ucTid].rTimer);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Cancel all RX BA reorder hole timers, waiting for running callbacks.
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxBaTimerUninit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	int i, j;
+
+	for (i = 0; i < CFG_STA_REC_NUM; i++)
+		for (j = 0; j < CFG_RX_MAX_BA_TID_NUM; j++)
+			hrtimer_cancel(&prGlueInfo->arRxBaTimer[i][j].rTimer);
+}
+
+#if CFG_SUPPORT_MULTITHREAD
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief This function is a kernel thread function for servicing the HIF
+*        interrupt: DMA completion, TX done and RX fetch. Received data frames
+*        are handed to the RX NAPI instead of being passed up from here.
+*
+* @param data       data pointer to private data of hif_thread
+*
+* @retval           If the function succeeds, the return value is 0.
+* Otherwise, an error code is returned.
+*
+*/
+/*----------------------------------------------------------------------------*/
+int hif_thread(void *data)
+{
+	struct net_device *dev = data;
+	P_GLUE_INFO_T prGlueInfo = *((P_GLUE_INFO_T *) netdev_priv(dev));
+	P_ADAPTER_T prAdapter = prGlueInfo->prAdapter;
+	int ret = 0;
+
+	current->flags |= PF_NOFREEZE;
+
+	DBGLOG(INIT, INFO, "hif_thread starts running...\n");
+
+	while (TRUE) {
+		if (prGlueInfo->ulFlag & GLUE_FLAG_HALT) {
+			DBGLOG(INIT, INFO, "hif_thread should stop now...\n");
+			break;
+		}
+
+		KAL_WAKE_UNLOCK(prAdapter, &prGlueInfo->rHifThreadWakeLock);
+
+		ret = wait_event_interruptible(prGlueInfo->waitq_hif,
+					       (prGlueInfo->ulFlag & GLUE_FLAG_HIF_PROCESS) != 0);
+
+		KAL_WAKE_LOCK(prAdapter, &prGlueInfo->rHifThreadWakeLock);
+
+		if (prGlueInfo->ulFlag & GLUE_FLAG_HALT) {
+			DBGLOG(INIT, INFO, "<1>hif_thread should stop now...\n");
+			break;
+		}
+
+		if (test_and_clear_bit(GLUE_FLAG_RX_BA_TIMEOUT_BIT, &prGlueInfo->ulFlag)) {
+			mutex_lock(&prGlueInfo->rHifMutex);
+			qmHandleRxBaTimeout(prAdapter);
+			mutex_unlock(&prGlueInfo->rHifMutex);
+		}
+
+		if (!test_and_clear_bit(GLUE_FLAG_INT_BIT, &prGlueInfo->ulFlag))
+			continue;
+
+		mutex_lock(&prGlueInfo->rHifMutex);
+
+		wlanAcquirePowerControl(prAdapter);
+
+		/* the Wi-Fi interrupt is already disabled in the ISR,
+		   so we set the flag only to enable the interrupt later  */
+		prAdapter->fgIsIntEnable = FALSE;
+		TaskIsrCnt++;
+		wlanIST(prAdapter);
+
+		wlanReleasePowerControl(prAdapter);
+
+		mutex_unlock(&prGlueInfo->rHifMutex);
+	}
+
+	KAL_WAKE_UNLOCK(prAdapter, &prGlueInfo->rHifThreadWakeLock);
+
+	DBGLOG(INIT, INFO, "hif_thread stops\n");
+	complete(&prGlueInfo->rHifHaltComp);
+
+	return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief NAPI poll of the wlan netdev, passes the RX packets queued by
+*        kalRxIndicatePkts() to the network stack.
+*
+* @param napi       the RX NAPI embedded in GLUE_INFO_T
+* @param budget     max number of packets to pass up
+*
+* @return number of packets passed up
+*/
+/*----------------------------------------------------------------------------*/
+static int kalRxNapiPoll(struct napi_struct *napi, int budget)
+{
+	P_GLUE_INFO_T prGlueInfo = container_of(napi, struct _GLUE_INFO_T, rRxNapi);
+	struct sk_buff *prSkb;
+	int work = 0;
+
+	while (work < budget) {
+		prSkb = skb_dequeue(&prGlueInfo->rRxNapiQueue);
+		if (!prSkb)
+			break;
+		skb_mark_napi_id(prSkb, napi);
+		napi_gro_receive(napi, prSkb);
+		work++;
+	}
+
+	if (work < budget) {
+		napi_complete(napi);
+		/* a packet may have been queued after we found the queue empty */
+		if (!skb_queue_empty(&prGlueInfo->rRxNapiQueue))
+			napi_schedule(napi);
+	}
+
+	return work;
+}
+
+static void kalRxNapiRemoteSchedule(void *info)
+{
+	P_GLUE_INFO_T prGlueInfo = (P_GLUE_INFO_T) info;
+
+	__napi_schedule(&prGlueInfo->rRxNapi);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Schedule the RX NAPI on a CPU of the RX affinity mask. The CSD is
+*        only sent by the caller which won NAPI_STATE_SCHED, so it is never
+*        reused while still in flight.
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static VOID kalRxNapiSchedule(IN P_GLUE_INFO_T prGlueInfo)
+{
+	struct napi_struct *napi = &prGlueInfo->rRxNapi;
+	int cpu;
+
+	if (!napi_schedule_prep(napi))
+		return;
+
+	cpu = get_cpu();
+	if (!cpumask_test_cpu(cpu, &prGlueInfo->arThreadCpuMask[GLUE_THREAD_RX])) {
+		int target = cpumask_any_and(&prGlueInfo->arThreadCpuMask[GLUE_THREAD_RX], cpu_online_mask);
+
+		if (target < nr_cpu_ids) {
+			smp_call_function_single_async(target, &prGlueInfo->rRxNapiCsd);
+			put_cpu();
+			return;
+		}
+	}
+	put_cpu();
+
+	local_bh_disable();
+	__napi_schedule(napi);
+	local_bh_enable();
+}
+
+#ifdef CONFIG_NET_RX_BUSY_POLL
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief ndo_busy_poll of the wlan netdev, called by a SO_BUSY_POLL socket
+*        waiting for data. The RX NAPI is owned through NAPI_STATE_SCHED
+*        while the queue is drained, so GRO is never run from two CPUs. Only
+*        CPUs of the RX affinity mask may spin.
+*
+* @param napi       the RX NAPI embedded in GLUE_INFO_T
+*
+* @return number of packets passed up, or LL_FLUSH_FAILED / LL_FLUSH_BUSY
+*/
+/*----------------------------------------------------------------------------*/
+int kalRxNapiBusyPoll(struct napi_struct *napi)
+{
+	P_GLUE_INFO_T prGlueInfo = container_of(napi, struct _GLUE_INFO_T, rRxNapi);
+	struct sk_buff *prSkb;
+	int work = 0;
+
+	if (!cpumask_test_cpu(smp_processor_id(), &prGlueInfo->arThreadCpuMask[GLUE_THREAD_RX]))
+		return LL_FLUSH_FAILED;
+	if (!napi_schedule_prep(napi))
+		return LL_FLUSH_BUSY;
+
+	while (work < GLUE_RX_BUSY_POLL_BUDGET) {
+		prSkb = skb_dequeue(&prGlueInfo->rRxNapiQueue);
+		if (!prSkb)
+			break;
+		skb_mark_napi_id(prSkb, napi);
+		napi_gro_receive(napi, prSkb);
+		work++;
+	}
+	napi_gro_flush(napi, false);
+
+	/* never on a poll list, so release ownership without napi_complete() */
+	smp_mb__before_atomic();
+	clear_bit(NAPI_STATE_SCHED, &napi->state);
+	/* a packet queued meanwhile could not schedule the NAPI */
+	if (!skb_queue_empty(&prGlueInfo->rRxNapiQueue))
+		kalRxNapiSchedule(prGlueInfo);
+
+	return work;
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Set up the RX NAPI and the per-thread affinity of the data path.
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalDataPathInit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	int i;
+
+	init_waitqueue_head(&prGlueInfo->waitq_hif);
+	init_completion(&prGlueInfo->rHifHaltComp);
+	mutex_init(&prGlueInfo->rHifMutex);
+
+	skb_queue_head_init(&prGlueInfo->rRxNapiQueue);
+	netif_napi_add(prGlueInfo->prDevHandler, &prGlueInfo->rRxNapi, kalRxNapiPoll, GLUE_RX_NAPI_WEIGHT);
+	prGlueInfo->rRxNapiCsd.func = kalRxNapiRemoteSchedule;
+	prGlueInfo->rRxNapiCsd.info = prGlueInfo;
+
+	for (i = 0; i < GLUE_THREAD_NUM; i++)
+		cpumask_copy(&prGlueInfo->arThreadCpuMask[i], cpu_possible_mask);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Change the CPU affinity of one data path context. The RX mask takes
+*        effect on the next NAPI schedule.
+*
+* @param prGlueInfo     Pointer of GLUE Data Structure
+* @param eThread        the context to move
+* @param prMask         CPUs it may run on
+*
+* @retval 0             success
+* @retval -EINVAL       no online CPU in prMask
+*/
+/*----------------------------------------------------------------------------*/
+INT_32 kalSetThreadAffinity(IN P_GLUE_INFO_T prGlueInfo, IN ENUM_GLUE_THREAD_T eThread,
+			    IN const struct cpumask *prMask)
+{
+	struct task_struct *prThread = NULL;
+
+	if (eThread >= GLUE_THREAD_NUM || !cpumask_intersects(prMask, cpu_online_mask))
+		return -EINVAL;
+
+	if (prMask != &prGlueInfo->arThreadCpuMask[eThread])
+		cpumask_copy(&prGlueInfo->arThreadCpuMask[eThread], prMask);
+
+	if (eThread == GLUE_THREAD_TX)
+		prThread = prGlueInfo->main_thread;
+	else if (eThread == GLUE_THREAD_HIF)
+		prThread = prGlueInfo->hif_thread;
+
+	if (prThread)
+		return set_cpus_allowed_ptr(prThread, prMask);
+
+	return 0;
+}
+#endif /* CFG_SUPPORT_MULTITHREAD */
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief This routine is used to check if card is removed
@@ -4467,5 +5025,56 @@ BOOLEAN kalIsWakeupByWlan(P_ADAPTER_T  prAdapter)
 		WAKE_SRC_CONN2AP is connsys */
 	return !!(spm_get_last_wakeup_src() & WAKE_SRC_CONN2AP);
 }
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief    Account a host wakeup caused by WLAN
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] eReason    What kind of packet woke the host
+* \param[in] ucIpProto  IP protocol of the packet, 0 if not IP
+* \param[in] u2DstPort  TCP/UDP destination port, 0 if none
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalUpdateWakeupStats(IN P_GLUE_INFO_T prGlueInfo,
+			  IN ENUM_WAKEUP_REASON_T eReason, IN UINT_8 ucIpProto, IN UINT_16 u2DstPort)
+{
+	P_GL_WAKEUP_STAT_T prStat;
+	P_GL_WAKEUP_PORT_STAT_T prPort;
+	P_GL_WAKEUP_PORT_STAT_T prVictim = NULL;
+	UINT_32 i;
+
+	if (!prGlueInfo || eReason >= WAKEUP_REASON_NUM)
+		return;
+
+	prStat = &prGlueInfo->rWakeupStat;
+	prStat->au4Reason[eReason]++;
+
+	if (u2DstPort == 0)
+		return;
+
+	for (i = 0; i < GLUE_WAKEUP_PORT_NUM; i++) {
+		prPort = &prStat->arPort[i];
+		if (prPort->u4Count && prPort->ucIpProto == ucIpProto && prPort->u2Port == u2DstPort) {
+			prPort->u4Count++;
+			return;
+		}
+		if (!prVictim || prPort->u4Count < prVictim->u4Count)
+			prVictim = prPort;
+	}
+
+	/* Table full: only a port seen once makes way for a new one */
+	if (prVictim->u4Count > 1) {
+		prStat->u4PortMiss++;
+		return;
+	}
+	if (prVictim->u4Count)
+		prStat->u4PortMiss++;
+	prVictim->ucIpProto = ucIpProto;
+	prVictim->u2Port = u2DstPort;
+	prVictim->u4Count = 1;
+}
 #endif
 
@@ -80,6 +80,9 @@
 #define PROC_NEED_TX_DONE						"TxDoneCfg"
 #define PROC_ROOT_NAME			"wlan"
 #define PROC_CMD_DEBUG_NAME		"cmdDebug"
+#define PROC_CPU_AFFINITY_NAME		"cpuAffinity"
+#define PROC_WAKEUP_STAT_NAME		"wakeStats"
+#define PROC_WAKE_FILTER_NAME		"wakeFilter"
 
 #define PROC_MCR_ACCESS_MAX_USER_INPUT_LEN      20
 #define PROC_RX_STATISTICS_MAX_USER_INPUT_LEN   10
@@ -654,6 +657,240 @@ static const struct file_operations proc_CmdDebug_ops = {
 	.read = procCmdDebug,
 };
 
+#if CFG_SUPPORT_MULTITHREAD
+static const char * const apcThreadName[GLUE_THREAD_NUM] = { "tx", "hif", "rx" };
+
+static ssize_t procCpuAffinityRead(struct file *filp, char __user *buf, size_t count, loff_t *f_pos)
+{
+	P_GLUE_INFO_T prGlueInfo = PDE_DATA(file_inode(filp));
+	char *temp = (char *)&aucProcBuf[0];
+	UINT_32 u4CopySize = 0;
+	int i;
+
+	/* if *f_ops>0, we should return 0 to make cat command exit */
+	if (*f_pos > 0)
+		return 0;
+
+	for (i = 0; i < GLUE_THREAD_NUM; i++) {
+		temp += kalSprintf(temp, "%s ", apcThreadName[i]);
+		temp += cpulist_scnprintf(temp, sizeof(aucProcBuf) - (temp - (char *)aucProcBuf) - 1,
+					  &prGlueInfo->arThreadCpuMask[i]);
+		*temp++ = '\n';
+	}
+	*temp = '\0';
+
+	u4CopySize = kalStrLen(aucProcBuf);
+	if (u4CopySize > count)
+		u4CopySize = count;
+	if (copy_to_user(buf, aucProcBuf, u4CopySize)) {
+		kalPrint("copy to user failed\n");
+		return -EFAULT;
+	}
+
+	*f_pos += u4CopySize;
+	return (ssize_t)u4CopySize;
+}
+
+/* "<tx|hif|rx> <cpulist>", e.g. "rx 4-7" */
+static ssize_t procCpuAffinityWrite(struct file *file, const char *buffer, size_t count, loff_t *data)
+{
+	P_GLUE_INFO_T prGlueInfo = PDE_DATA(file_inode(file));
+	UINT_32 u4CopySize = sizeof(aucProcBuf);
+	cpumask_var_t rMask;
+	char *pcList;
+	int i;
+	int ret = -EINVAL;
+
+	kalMemSet(aucProcBuf, 0, u4CopySize);
+	if (u4CopySize >= count + 1)
+		u4CopySize = count;
+
+	if (copy_from_user(aucProcBuf, buffer, u4CopySize)) {
+		kalPrint("error of copy from user\n");
+		return -EFAULT;
+	}
+	aucProcBuf[u4CopySize] = '\0';
+
+	pcList = kalStrChr((char *)aucProcBuf, ' ');
+	if (!pcList)
+		return -EINVAL;
+	*pcList++ = '\0';
+
+	if (!alloc_cpumask_var(&rMask, GFP_KERNEL))
+		return -ENOMEM;
+
+	for (i = 0; i < GLUE_THREAD_NUM; i++) {
+		if (kalStrCmp((char *)aucProcBuf, apcThreadName[i]) != 0)
+			continue;
+		ret = cpulist_parse(strim(pcList), rMask);
+		if (ret == 0)
+			ret = kalSetThreadAffinity(prGlueInfo, (ENUM_GLUE_THREAD_T) i, rMask);
+		break;
+	}
+
+	free_cpumask_var(rMask);
+	return ret ? ret : count;
+}
+
+static const struct file_operations proc_cpu_affinity_ops = {
+	.owner = THIS_MODULE,
+	.read = procCpuAffinityRead,
+	.write = procCpuAffinityWrite,
+};
+#endif
+
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+static const char * const apcWakeupReasonName[WAKEUP_REASON_NUM] = {
+	"bar", "arp", "mdns", "ssdp", "ipv4_bmcast", "ipv4_tcp", "ipv4_udp", "ipv4_other",
+	"ipv6", "1x", "data_other", "event", "mgmt", "unknown"
+};
+
+static ssize_t procWakeupStatRead(struct file *filp, char __user *buf, size_t count, loff_t *f_pos)
+{
+	P_GLUE_INFO_T prGlueInfo = PDE_DATA(file_inode(filp));
+	P_GL_WAKEUP_STAT_T prStat = &prGlueInfo->rWakeupStat;
+	char *temp = (char *)&aucProcBuf[0];
+	UINT_32 u4CopySize = 0;
+	int i;
+
+	/* if *f_ops>0, we should return 0 to make cat command exit */
+	if (*f_pos > 0)
+		return 0;
+
+	for (i = 0; i < WAKEUP_REASON_NUM; i++)
+		temp += kalSprintf(temp, "%s %u\n", apcWakeupReasonName[i], prStat->au4Reason[i]);
+
+	for (i = 0; i < GLUE_WAKEUP_PORT_NUM; i++) {
+		if (prStat->arPort[i].u4Count == 0)
+			continue;
+		temp += kalSprintf(temp, "%s/%u %u\n",
+				   prStat->arPort[i].ucIpProto == IPPROTO_TCP ? "tcp" : "udp",
+				   prStat->arPort[i].u2Port, prStat->arPort[i].u4Count);
+	}
+	temp += kalSprintf(temp, "port_miss %u\n", prStat->u4PortMiss);
+
+	u4CopySize = kalStrLen(aucProcBuf);
+	if (u4CopySize > count)
+		u4CopySize = count;
+	if (copy_to_user(buf, aucProcBuf, u4CopySize)) {
+		kalPrint("copy to user failed\n");
+		return -EFAULT;
+	}
+
+	*f_pos += u4CopySize;
+	return (ssize_t)u4CopySize;
+}
+
+/* any write clears the counters */
+static ssize_t procWakeupStatWrite(struct file *file, const char *buffer, size_t count, loff_t *data)
+{
+	P_GLUE_INFO_T prGlueInfo = PDE_DATA(file_inode(file));
+
+	kalMemZero(&prGlueInfo->rWakeupStat, sizeof(prGlueInfo->rWakeupStat));
+	return count;
+}
+
+static const struct file_operations proc_wakeup_stat_ops = {
+	.owner = THIS_MODULE,
+	.read = procWakeupStatRead,
+	.write = procWakeupStatWrite,
+};
+#endif
+
+#if CFG_SUPPORT_WAKEUP_FILTER
+static ssize_t procWakeFilterRead(struct file *filp, char __user *buf, size_t count, loff_t *f_pos)
+{
+	P_GLUE_INFO_T prGlueInfo = PDE_DATA(file_inode(filp));
+	P_GL_WAKE_FILTER_T prFilter = &prGlueInfo->rWakeFilter;
+	char *temp = (char *)&aucProcBuf[0];
+	UINT_32 u4CopySize = 0;
+	UINT_32 i;
+
+	/* if *f_ops>0, we should return 0 to make cat command exit */
+	if (*f_pos > 0)
+		return 0;
+
+	temp += kalSprintf(temp, "enable %u\nbroadcast %u\ngroup",
+			   prFilter->fgEnable, prFilter->fgDropBroadcast);
+	for (i = 0; i < prFilter->u4GroupNum; i++)
+		temp += kalSprintf(temp, " %pM", prFilter->aucDropGroup[i]);
+	temp += kalSprintf(temp, "\n");
+
+	u4CopySize = kalStrLen(aucProcBuf);
+	if (u4CopySize > count)
+		u4CopySize = count;
+	if (copy_to_user(buf, aucProcBuf, u4CopySize)) {
+		kalPrint("copy to user failed\n");
+		return -EFAULT;
+	}
+
+	*f_pos += u4CopySize;
+	return (ssize_t)u4CopySize;
+}
+
+/*
+ * "enable <0|1>", "broadcast <0|1>" (1 drops broadcast while suspended) or
+ * "group [<mac> ...]" replacing the multicast groups not to wake for.
+ * Takes effect at the next suspend.
+ */
+static ssize_t procWakeFilterWrite(struct file *file, const char *buffer, size_t count, loff_t *data)
+{
+	P_GLUE_INFO_T prGlueInfo = PDE_DATA(file_inode(file));
+	P_GL_WAKE_FILTER_T prFilter = &prGlueInfo->rWakeFilter;
+	UINT_8 aucGroup[GLUE_WAKE_FILTER_MAX_GROUPS][MAC_ADDR_LEN];
+	UINT_32 u4CopySize = sizeof(aucProcBuf);
+	UINT_32 u4Num = 0;
+	UINT_32 u4Value;
+	char *pcArg, *pcCmd, *pcMac;
+
+	kalMemSet(aucProcBuf, 0, u4CopySize);
+	if (u4CopySize >= count + 1)
+		u4CopySize = count;
+
+	if (copy_from_user(aucProcBuf, buffer, u4CopySize)) {
+		kalPrint("error of copy from user\n");
+		return -EFAULT;
+	}
+	aucProcBuf[u4CopySize] = '\0';
+
+	pcArg = strim((char *)aucProcBuf);
+	pcCmd = strsep(&pcArg, " ");
+
+	if (kalStrCmp(pcCmd, "enable") == 0 || kalStrCmp(pcCmd, "broadcast") == 0) {
+		if (!pcArg || kstrtou32(strim(pcArg), 0, &u4Value))
+			return -EINVAL;
+		if (pcCmd[0] == 'e')
+			prFilter->fgEnable = u4Value ? TRUE : FALSE;
+		else
+			prFilter->fgDropBroadcast = u4Value ? TRUE : FALSE;
+		return count;
+	}
+
+	if (kalStrCmp(pcCmd, "group") != 0)
+		return -EINVAL;
+
+	while ((pcMac = strsep(&pcArg, " ")) != NULL) {
+		if (*pcMac == '\0')
+			continue;
+		if (u4Num == GLUE_WAKE_FILTER_MAX_GROUPS)
+			return -ENOSPC;
+		if (!mac_pton(pcMac, aucGroup[u4Num]) || !is_multicast_ether_addr(aucGroup[u4Num]))
+			return -EINVAL;
+		u4Num++;
+	}
+
+	kalMemCopy(prFilter->aucDropGroup, aucGroup, u4Num * MAC_ADDR_LEN);
+	prFilter->u4GroupNum = u4Num;
+	return count;
+}
+
+static const struct file_operations proc_wake_filter_ops = {
+	.owner = THIS_MODULE,
+	.read = procWakeFilterRead,
+	.write = procWakeFilterWrite,
+};
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief This function create a PROC fs in linux /proc/net subdirectory.
@@ -939,6 +1176,15 @@ INT_32 procRemoveProcfs(VOID)
 	/* remove_proc_entry(pucDevName, init_net.proc_net); */
 	remove_proc_entry(PROC_WLAN_THERMO, gprProcRoot);
 	remove_proc_entry(PROC_CMD_DEBUG_NAME, gprProcRoot);
+#if CFG_SUPPORT_MULTITHREAD
+	remove_proc_entry(PROC_CPU_AFFINITY_NAME, gprProcRoot);
+#endif
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+	remove_proc_entry(PROC_WAKEUP_STAT_NAME, gprProcRoot);
+#endif
+#if CFG_SUPPORT_WAKEUP_FILTER
+	remove_proc_entry(PROC_WAKE_FILTER_NAME, gprProcRoot);
+#endif
 #if CFG_SUPPORT_THERMO_THROTTLING
 	g_prGlueInfo_proc = NULL;
 #endif
@@ -969,6 +1215,33 @@ INT_32 procCreateFsEntry(P_GLUE_INFO_T prGlueInfo)
 		return -1;
 	}
 	proc_set_user(prEntry, KUIDT_INIT(PROC_UID_SHELL), KGIDT_INIT(PROC_GID_WIFI));
+
+#if CFG_SUPPORT_MULTITHREAD
+	prEntry = proc_create_data(PROC_CPU_AFFINITY_NAME, 0664, gprProcRoot, &proc_cpu_affinity_ops, prGlueInfo);
+	if (prEntry == NULL) {
+		kalPrint("Unable to create /proc entry cpuAffinity\n\r");
+		return -1;
+	}
+	proc_set_user(prEntry, KUIDT_INIT(PROC_UID_SHELL), KGIDT_INIT(PROC_GID_WIFI));
+#endif
+
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+	prEntry = proc_create_data(PROC_WAKEUP_STAT_NAME, 0664, gprProcRoot, &proc_wakeup_stat_ops, prGlueInfo);
+	if (prEntry == NULL) {
+		kalPrint("Unable to create /proc entry wakeStats\n\r");
+		return -1;
+	}
+	proc_set_user(prEntry, KUIDT_INIT(PROC_UID_SHELL), KGIDT_INIT(PROC_GID_WIFI));
+#endif
+
+#if CFG_SUPPORT_WAKEUP_FILTER
+	prEntry = proc_create_data(PROC_WAKE_FILTER_NAME, 0664, gprProcRoot, &proc_wake_filter_ops, prGlueInfo);
+	if (prEntry == NULL) {
+		kalPrint("Unable to create /proc entry wakeFilter\n\r");
+		return -1;
+	}
+	proc_set_user(prEntry, KUIDT_INIT(PROC_UID_SHELL), KGIDT_INIT(PROC_GID_WIFI));
+#endif
 	return 0;
 }
 
@@ -414,6 +414,7 @@ VOID glResetHif(GLUE_INFO_T *GlueInfo)
 	HifInfo = &GlueInfo->rHifInfo;
 	if (HifInfo->DmaOps)
 		HifInfo->DmaOps->DmaReset(HifInfo);
+	HifInfo->fgTxDmaPending = FALSE;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1038,11 +1039,43 @@ kalDevPortRead(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, OUT
 /*----------------------------------------------------------------------------*/
 BOOLEAN
 kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN PUINT_8 Buf, IN UINT_32 MaxBufSize)
+{
+	if (kalDevPortWriteAsync(GlueInfo, Port, Size, Buf, MaxBufSize) == FALSE)
+		return FALSE;
+
+	return kalDevPortWriteWait(GlueInfo);
+
+} /* end of kalDevPortWrite() */
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Start to write device I/O port without waiting for the DMA to finish
+*
+*        The buffer must stay untouched until kalDevPortWriteWait() returns.
+*        Non-data ports and PIO mode are still written synchronously.
+*
+* \param[in] GlueInfo   Pointer to the GLUE_INFO_T structure.
+* \param[in] Port       I/O port offset
+* \param[in] Size       Length to be write
+* \param[in] Buf        Pointer to write buffer
+* \param[in] MaxBufSize Length of the buffer valid to be accessed
+*
+* \retval TRUE          operation success
+* \retval FALSE         operation fail
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN
+kalDevPortWriteAsync(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN PUINT_8 Buf,
+		     IN UINT_32 MaxBufSize)
 {
 	GL_HIF_INFO_T *HifInfo;
 	UINT_32 u4HSTCRValue = 0;
 	UINT_32 RegWHLPCR = 0;
 
+	/* only one TX DMA can be in flight */
+	if (kalDevPortWriteWait(GlueInfo) == FALSE)
+		return FALSE;
+
 	/* sanity check */
 	if ((WlanDmaFatalErr == 1) || (fgIsResetting == TRUE) || (HifIsFwOwn(GlueInfo->prAdapter) == TRUE)) {
 		DBGLOG(RX, ERROR, "WlanDmaFatalErr: %d, fgIsResetting: %d, HifIsFwOwn: %d\n",
@@ -1080,11 +1113,6 @@ kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN
 #endif /* MTK_DMA_BUF_MEMCPY_SUP */
 		GL_HIF_DMA_OPS_T *prDmaOps = HifInfo->DmaOps;
 		MTK_WCN_HIF_DMA_CONF DmaConf;
-		UINT_32 LoopCnt;
-		unsigned long PollTimeout;
-#if (CONF_HIF_DMA_INT == 1)
-		INT_32 RtnVal = 0;
-#endif
 
 		/* config GDMA */
 		HIF_DBG_TX(("[WiFi/HIF/DMA] Prepare to send data...\n"));
@@ -1118,7 +1146,71 @@ kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN
 		prDmaOps->DmaConfig(HifInfo, &DmaConf);
 		prDmaOps->DmaStart(HifInfo);
 
+		/* completed by kalDevPortWriteWait() */
+		HifInfo->TxDmaSrc = DmaConf.Src;
+		HifInfo->TxDmaSize = Size;
+		HifInfo->TxDmaRegWHLPCR = RegWHLPCR;
+		HifInfo->TxDmaHSTCR = u4HSTCRValue;
+		HifInfo->fgTxDmaPending = TRUE;
+	} else
+#endif /* CONF_MTK_AHB_DMA */
+	{
+		UINT_32 IdLoop, MaxLoop;
+		UINT_32 *LoopBuf;
+
+		/* PIO mode */
+		MaxLoop = Size >> 2;
+		LoopBuf = (UINT_32 *) Buf;
+
+		HIF_DBG_TX(("[WiFi/HIF/PIO] Prepare to send data (%d 0x%p-0x%p)...\n",
+			    Size, LoopBuf, (((UINT8 *) LoopBuf) + (Size & (~0x03)))));
+
+		if (Size & 0x3)
+			MaxLoop++;
+
+		for (IdLoop = 0; IdLoop < MaxLoop; IdLoop++) {
+			HIF_REG_WRITEL(HifInfo, Port, *LoopBuf);
+			LoopBuf++;
+		}
+
+		if ((RegWHLPCR & WHLPCR_INT_EN_SET) == 1)
+			HIF_REG_WRITEL(HifInfo, MCR_WHLPCR, WHLPCR_INT_EN_SET);
+
+		HIF_DBG_TX(("\n\n"));
+	}
+
+	return TRUE;
+
+} /* end of kalDevPortWriteAsync() */
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Wait for the TX DMA started by kalDevPortWriteAsync() to finish
+*
+* \param[in] GlueInfo   Pointer to the GLUE_INFO_T structure.
+*
+* \retval TRUE          no DMA pending or DMA finished
+* \retval FALSE         DMA fatal error, chip reset triggered
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN kalDevPortWriteWait(IN P_GLUE_INFO_T GlueInfo)
+{
+	GL_HIF_INFO_T *HifInfo;
+
+	ASSERT(GlueInfo);
+	HifInfo = &GlueInfo->rHifInfo;
+
+	if (HifInfo->fgTxDmaPending == FALSE)
+		return TRUE;
+
+#if (CONF_MTK_AHB_DMA == 1)
+	{
+		GL_HIF_DMA_OPS_T *prDmaOps = HifInfo->DmaOps;
+		UINT_32 LoopCnt;
+		unsigned long PollTimeout;
 #if (CONF_HIF_DMA_INT == 1)
+		INT_32 RtnVal = 0;
+
 		RtnVal = wait_event_interruptible_timeout(HifInfo->HifDmaWaitq, (HifInfo->HifDmaWaitFlg != 0), 1000);
 		if (RtnVal <= 0)
 			DBGLOG(TX, ERROR, "fatal error1! reset DMA!\n");
@@ -1131,7 +1223,7 @@ kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN
 		do {
 			if (time_before(jiffies, PollTimeout))
 				continue;
-			DBGLOG(TX, INFO, "TX DMA Timeout, HSTCR: 0x%08x\n", u4HSTCRValue);
+			DBGLOG(TX, INFO, "TX DMA Timeout, HSTCR: 0x%08x\n", HifInfo->TxDmaHSTCR);
 			if (prDmaOps->DmaRegDump != NULL)
 				prDmaOps->DmaRegDump(HifInfo);
 			WlanDmaFatalErr = 1;
@@ -1157,48 +1249,26 @@ kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN
 		AP_DMA_HIF_UNLOCK(HifInfo);
 
 #ifndef MTK_DMA_BUF_MEMCPY_SUP
-		dma_unmap_single(HifInfo->Dev, DmaConf.Src, Size, DMA_TO_DEVICE);
+		dma_unmap_single(HifInfo->Dev, HifInfo->TxDmaSrc, HifInfo->TxDmaSize, DMA_TO_DEVICE);
 #endif /* MTK_DMA_BUF_MEMCPY_SUP */
 
-		if ((RegWHLPCR & WHLPCR_INT_EN_SET) == 1)
+		if ((HifInfo->TxDmaRegWHLPCR & WHLPCR_INT_EN_SET) == 1)
 			HIF_REG_WRITEL(HifInfo, MCR_WHLPCR, WHLPCR_INT_EN_SET);
 
+		HifInfo->fgTxDmaPending = FALSE;
+
 		if (WlanDmaFatalErr) {
 			if (!fgIsResetting)
 				glDoChipReset();
 			return FALSE;
 		}
 		HIF_DBG_TX(("[WiFi/HIF] DMA TX OK!\n"));
-	} else
-#endif /* CONF_MTK_AHB_DMA */
-	{
-		UINT_32 IdLoop, MaxLoop;
-		UINT_32 *LoopBuf;
-
-		/* PIO mode */
-		MaxLoop = Size >> 2;
-		LoopBuf = (UINT_32 *) Buf;
-
-		HIF_DBG_TX(("[WiFi/HIF/PIO] Prepare to send data (%d 0x%p-0x%p)...\n",
-			    Size, LoopBuf, (((UINT8 *) LoopBuf) + (Size & (~0x03)))));
-
-		if (Size & 0x3)
-			MaxLoop++;
-
-		for (IdLoop = 0; IdLoop < MaxLoop; IdLoop++) {
-			HIF_REG_WRITEL(HifInfo, Port, *LoopBuf);
-			LoopBuf++;
-		}
-
-		if ((RegWHLPCR & WHLPCR_INT_EN_SET) == 1)
-			HIF_REG_WRITEL(HifInfo, MCR_WHLPCR, WHLPCR_INT_EN_SET);
-
-		HIF_DBG_TX(("\n\n"));
 	}
+#endif /* CONF_MTK_AHB_DMA */
 
 	return TRUE;
 
-} /* end of kalDevPortWrite() */
+} /* end of kalDevPortWriteWait() */
 
 /*******************************************************************************
 *                       P R I V A T E   F U N C T I O N S
@@ -1244,8 +1314,13 @@ static irqreturn_t HifAhbISR(IN int Irq, IN void *Arg)
 	/* Wake up main thread */
 	set_bit(GLUE_FLAG_INT_BIT, &GlueInfo->ulFlag);
 
+#if CFG_SUPPORT_MULTITHREAD
+	/* interrupts are serviced by hif_thread */
+	wake_up_interruptible(&GlueInfo->waitq_hif);
+#else
 	/* when we got sdio interrupt, we wake up the tx servie thread */
 	wake_up_interruptible(&GlueInfo->waitq);
+#endif
 
 	IsrPassCnt++;
 	return IRQ_HANDLED;
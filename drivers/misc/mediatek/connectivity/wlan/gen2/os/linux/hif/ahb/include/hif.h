@@ -191,6 +191,13 @@ typedef struct _GL_HIF_INFO_T {
 	UINT_8 *DmaRegBaseAddr;	/* DMA register base */
 	GL_HIF_DMA_OPS_T *DmaOps;	/* DMA Operators */
 
+	/* TX DMA started by kalDevPortWriteAsync(), finished by kalDevPortWriteWait() */
+	BOOLEAN fgTxDmaPending;
+	ULONG TxDmaSrc;
+	UINT_32 TxDmaSize;
+	UINT_32 TxDmaRegWHLPCR;
+	UINT_32 TxDmaHSTCR;
+
 #if !defined(CONFIG_MTK_CLKMGR)
 	struct clk *clk_wifi_dma;
 #endif
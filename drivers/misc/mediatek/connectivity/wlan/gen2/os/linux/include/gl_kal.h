@@ -583,6 +583,27 @@ extern ENUM_WMTHWVER_TYPE_T mtk_wcn_wmt_hwver_get(VOID);
 *                             D A T A   T Y P E S
 ********************************************************************************
 */
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+/* what the first packet after a WLAN wakeup of the host was */
+typedef enum _ENUM_WAKEUP_REASON_T {
+	WAKEUP_REASON_BAR = 0,
+	WAKEUP_REASON_ARP,
+	WAKEUP_REASON_MDNS,
+	WAKEUP_REASON_SSDP,
+	WAKEUP_REASON_IPV4_BMCAST,	/* other IPv4 broadcast/multicast */
+	WAKEUP_REASON_IPV4_TCP,
+	WAKEUP_REASON_IPV4_UDP,
+	WAKEUP_REASON_IPV4_OTHER,
+	WAKEUP_REASON_IPV6,
+	WAKEUP_REASON_1X,
+	WAKEUP_REASON_DATA_OTHER,
+	WAKEUP_REASON_EVENT,
+	WAKEUP_REASON_MGMT,
+	WAKEUP_REASON_UNKNOWN,
+	WAKEUP_REASON_NUM
+} ENUM_WAKEUP_REASON_T;
+#endif
+
 typedef enum _ENUM_SPIN_LOCK_CATEGORY_E {
 	SPIN_LOCK_FSM = 0,
 
@@ -1269,6 +1290,12 @@ VOID kalUpdateRxCSUMOffloadParam(IN PVOID pvPacket, IN ENUM_CSUM_RESULT_T eCSUM[
 );
 #endif /* CFG_TCP_IP_CHKSUM_OFFLOAD */
 
+#if CFG_TX_DIRECT_DMA
+PUINT_8 kalTxPushHwHeader(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket, IN UINT_32 u4HdrLen);
+
+VOID kalTxPullHwHeader(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket, IN UINT_32 u4HdrLen);
+#endif
+
 BOOLEAN kalRetrieveNetworkAddress(IN P_GLUE_INFO_T prGlueInfo, IN OUT PARAM_MAC_ADDRESS *prMacAddr);
 
 VOID
@@ -1301,6 +1328,12 @@ BOOLEAN
 kalDevPortWrite(P_GLUE_INFO_T prGlueInfo,
 		IN UINT_16 u2Port, IN UINT_32 u2Len, IN PUINT_8 pucBuf, IN UINT_32 u2ValidInBufSize);
 
+BOOLEAN
+kalDevPortWriteAsync(P_GLUE_INFO_T prGlueInfo,
+		     IN UINT_16 u2Port, IN UINT_32 u2Len, IN PUINT_8 pucBuf, IN UINT_32 u2ValidInBufSize);
+
+BOOLEAN kalDevPortWriteWait(P_GLUE_INFO_T prGlueInfo);
+
 BOOLEAN kalDevWriteWithSdioCmd52(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4Addr, IN UINT_8 ucData);
 
 void kalDevLoopbkAuto(IN GLUE_INFO_T *GlueInfo);
@@ -1337,6 +1370,10 @@ VOID kalHandleAssocInfo(IN P_GLUE_INFO_T prGlueInfo, IN P_EVENT_ASSOC_INFO prAss
 PVOID kalFirmwareImageMapping(IN P_GLUE_INFO_T prGlueInfo, OUT PPVOID ppvMapFileBuf, OUT PUINT_32 pu4FileLength);
 
 VOID kalFirmwareImageUnmapping(IN P_GLUE_INFO_T prGlueInfo, IN PVOID prFwHandle, IN PVOID pvMapFileBuf);
+
+#if CFG_FW_IMAGE_CACHE
+VOID kalFirmwareImageCacheFree(VOID);
+#endif
 #endif
 
 /*----------------------------------------------------------------------------*/
@@ -1515,6 +1552,27 @@ VOID kalSchedScanStopped(IN P_GLUE_INFO_T prGlueInfo);
 
 int tx_thread(void *data);
 
+VOID kalRxBaTimerInit(IN P_GLUE_INFO_T prGlueInfo);
+VOID kalRxBaTimerStart(IN P_GLUE_INFO_T prGlueInfo, IN UINT_8 ucStaRecIdx, IN UINT_8 ucTid, IN UINT_32 u4TimeoutMs);
+VOID kalRxBaTimerStop(IN P_GLUE_INFO_T prGlueInfo, IN UINT_8 ucStaRecIdx, IN UINT_8 ucTid);
+VOID kalRxBaTimerUninit(IN P_GLUE_INFO_T prGlueInfo);
+
+/* RX reorder hole timeout, served from the thread handling the interrupt */
+VOID qmHandleRxBaTimeout(IN P_ADAPTER_T prAdapter);
+
+#if CFG_SUPPORT_MULTITHREAD
+int hif_thread(void *data);
+
+VOID kalDataPathInit(IN P_GLUE_INFO_T prGlueInfo);
+
+INT_32 kalSetThreadAffinity(IN P_GLUE_INFO_T prGlueInfo, IN ENUM_GLUE_THREAD_T eThread,
+			    IN const struct cpumask *prMask);
+
+#ifdef CONFIG_NET_RX_BUSY_POLL
+int kalRxNapiBusyPoll(struct napi_struct *napi);
+#endif
+#endif
+
 VOID kalHifAhbKalWakeLockTimeout(IN P_GLUE_INFO_T prGlueInfo);
 VOID kalMetProfilingStart(IN P_GLUE_INFO_T prGlueInfo, IN struct sk_buff *prSkb);
 VOID kalMetProfilingFinish(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMsduInfo);
@@ -1526,5 +1584,7 @@ UINT_64 kalGetBootTime(void);
 INT_32 kalReadToFile(const PUINT_8 pucPath, PUINT_8 pucData, UINT_32 u4Size, PUINT_32 pu4ReadSize);
 #if CFG_SUPPORT_WAKEUP_REASON_DEBUG
 BOOLEAN kalIsWakeupByWlan(P_ADAPTER_T  prAdapter);
+VOID kalUpdateWakeupStats(IN P_GLUE_INFO_T prGlueInfo,
+			  IN ENUM_WAKEUP_REASON_T eReason, IN UINT_8 ucIpProto, IN UINT_16 u2DstPort);
 #endif
 #endif /* _GL_KAL_H */
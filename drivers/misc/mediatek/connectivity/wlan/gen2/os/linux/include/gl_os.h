@@ -578,6 +578,10 @@
 
 #include <linux/lockdep.h>
 #include <linux/time.h>
+#include <linux/cpumask.h>
+#include <linux/hrtimer.h>
+#include <linux/mutex.h>
+#include <linux/smp.h>
 
 #include <asm/io.h>		/* readw and writew */
 
@@ -637,6 +641,7 @@ extern BOOLEAN fgIsBusAccessFailed;
 #define GLUE_FLAG_FRAME_FILTER      BIT(8)
 #define GLUE_FLAG_FRAME_FILTER_AIS  BIT(9)
 #define GLUE_FLAG_HIF_LOOPBK_AUTO   BIT(10)
+#define GLUE_FLAG_RX_BA_TIMEOUT     BIT(11)
 #define GLUE_FLAG_HALT_BIT          (0)
 #define GLUE_FLAG_INT_BIT           (1)
 #define GLUE_FLAG_OID_BIT           (2)
@@ -648,6 +653,25 @@ extern BOOLEAN fgIsBusAccessFailed;
 #define GLUE_FLAG_FRAME_FILTER_BIT  (8)
 #define GLUE_FLAG_FRAME_FILTER_AIS_BIT  (9)
 #define GLUE_FLAG_HIF_LOOPBK_AUTO_BIT   (10)
+#define GLUE_FLAG_RX_BA_TIMEOUT_BIT     (11)
+
+#if CFG_SUPPORT_MULTITHREAD
+/* events served by hif_thread, everything else is left to tx_thread */
+#define GLUE_FLAG_HIF_PROCESS       (GLUE_FLAG_HALT | GLUE_FLAG_INT | GLUE_FLAG_RX_BA_TIMEOUT)
+#define GLUE_FLAG_MAIN_PROCESS      (~(GLUE_FLAG_INT | GLUE_FLAG_RX_BA_TIMEOUT))
+
+#define GLUE_RX_NAPI_WEIGHT         64
+#define GLUE_RX_BUSY_POLL_BUDGET    8	/* RX packets per ndo_busy_poll call */
+#define GLUE_TX_YIELD_BATCH         32	/* TX packets between checks for a pending interrupt */
+#endif
+
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+#define GLUE_WAKEUP_PORT_NUM        16	/* TCP/UDP destination ports tracked for wakeups */
+#endif
+
+#if CFG_SUPPORT_WAKEUP_FILTER
+#define GLUE_WAKE_FILTER_MAX_GROUPS 8
+#endif
 
 #define GLUE_BOW_KFIFO_DEPTH        (1024)
 /* #define GLUE_BOW_DEVICE_NAME        "MT6620 802.11 AMP" */
@@ -657,6 +681,46 @@ extern BOOLEAN fgIsBusAccessFailed;
 *                             D A T A   T Y P E S
 ********************************************************************************
 */
+#if CFG_SUPPORT_MULTITHREAD
+/* execution contexts of the data path, each with its own CPU affinity */
+typedef enum _ENUM_GLUE_THREAD_T {
+	GLUE_THREAD_TX = 0,	/* tx_thread: OID, command and TX dequeue */
+	GLUE_THREAD_HIF,	/* hif_thread: interrupt, DMA completion and RX fetch */
+	GLUE_THREAD_RX,		/* NAPI poll passing RX packets to the stack */
+	GLUE_THREAD_NUM
+} ENUM_GLUE_THREAD_T;
+#endif
+
+/* RX reorder hole timer of one (STA, TID) BA agreement */
+typedef struct _GL_RX_BA_TIMER_T {
+	struct hrtimer rTimer;
+	struct _GLUE_INFO_T *prGlueInfo;
+} GL_RX_BA_TIMER_T, *P_GL_RX_BA_TIMER_T;
+
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+typedef struct _GL_WAKEUP_PORT_STAT_T {
+	UINT_8 ucIpProto;
+	UINT_16 u2Port;
+	UINT_32 u4Count;
+} GL_WAKEUP_PORT_STAT_T, *P_GL_WAKEUP_PORT_STAT_T;
+
+typedef struct _GL_WAKEUP_STAT_T {
+	UINT_32 au4Reason[WAKEUP_REASON_NUM];
+	GL_WAKEUP_PORT_STAT_T arPort[GLUE_WAKEUP_PORT_NUM];
+	UINT_32 u4PortMiss;	/* port wakeups that found no free slot */
+} GL_WAKEUP_STAT_T, *P_GL_WAKEUP_STAT_T;
+#endif
+
+#if CFG_SUPPORT_WAKEUP_FILTER
+/* RX filter pushed to FW while the host is suspended */
+typedef struct _GL_WAKE_FILTER_T {
+	BOOLEAN fgEnable;
+	BOOLEAN fgDropBroadcast;	/* ARP for our address is still answered by FW ARP offload */
+	UINT_32 u4GroupNum;
+	UINT_8 aucDropGroup[GLUE_WAKE_FILTER_MAX_GROUPS][MAC_ADDR_LEN];	/* multicast groups not to wake for */
+} GL_WAKE_FILTER_T, *P_GL_WAKE_FILTER_T;
+#endif
+
 typedef struct _GL_WPA_INFO_T {
 	UINT_32 u4WpaVersion;
 	UINT_32 u4KeyMgmt;
@@ -873,8 +937,33 @@ struct _GLUE_INFO_T {
 	wait_queue_head_t waitq;
 	struct task_struct *main_thread;
 
+#if CFG_SUPPORT_MULTITHREAD
+	wait_queue_head_t waitq_hif;
+	struct task_struct *hif_thread;
+	struct completion rHifHaltComp;	/* indicate hif thread halt complete */
+	struct mutex rHifMutex;	/* serialize HW access of tx_thread and hif_thread */
+	KAL_WAKE_LOCK_T rHifThreadWakeLock;
+
+	/* RX packets are handed to the stack from a NAPI poll on the wlan netdev */
+	struct napi_struct rRxNapi;
+	struct sk_buff_head rRxNapiQueue;
+	struct call_single_data rRxNapiCsd;	/* kicks the NAPI on another CPU */
+
+	cpumask_t arThreadCpuMask[GLUE_THREAD_NUM];
+#endif
+
 	struct timer_list tickfn;
 
+	/* flush a reorder hole even if no later frame of the BA session arrives */
+	GL_RX_BA_TIMER_T arRxBaTimer[CFG_STA_REC_NUM][CFG_RX_MAX_BA_TID_NUM];
+
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+	GL_WAKEUP_STAT_T rWakeupStat;
+#endif
+#if CFG_SUPPORT_WAKEUP_FILTER
+	GL_WAKE_FILTER_T rWakeFilter;
+#endif
+
 #if CFG_SUPPORT_EXT_CONFIG
 	UINT_16 au2ExtCfg[256];	/* NVRAM data buffer */
 	UINT_32 u4ExtCfgLength;	/* 0 means data is NOT valid */
@@ -12,6 +12,9 @@
 #include <linux/of.h>
 #include <linux/of_address.h>
 #include <linux/of_irq.h>
+#include <linux/dmaengine.h>
+#include <linux/scatterlist.h>
+#include <linux/slab.h>
 #ifdef CONFIG_MTK_GIC
 #include <linux/irqchip/mt-gic.h>
 #endif
@@ -578,10 +581,11 @@ static irqreturn_t gdma1_irq_handler(int irq, void *dev_id)
 	glbsta = readl(DMA_INT_FLAG(i));
 
 	if (glbsta & 0x1) {
+		/* ack first, the callback may start the channel again */
+		mt_reg_sync_writel(DMA_INT_FLAG_CLR_BIT, DMA_INT_FLAG(i));
+
 		if (dma_ctrl[i].isr_cb)
 			dma_ctrl[i].isr_cb(dma_ctrl[i].data);
-
-		mt_reg_sync_writel(DMA_INT_FLAG_CLR_BIT, DMA_INT_FLAG(i));
 	} else {
 		return IRQ_NONE;
 	}
@@ -603,6 +607,389 @@ void mt_reset_gdma_conf(const unsigned int channel)
 		return;
 }
 
+#ifdef CONFIG_MTK_CQDMA_DMAENGINE
+/*
+ * dmaengine provider: DMA_MEMCPY and DMA_SG on the CQDMA channels.
+ *
+ * dma_chan i owns hardware channel i, taken with mt_req_gdma() when a client
+ * allocates it, so the mt_*_gdma() API above still works for the channels
+ * nobody asked dmaengine for. A descriptor is a chain of segments of at most
+ * CQDMA_SEG_MAX bytes. The ISR programs the next segment, or the first one
+ * of the next issued descriptor, right away; completion callbacks run from a
+ * tasklet. The address registers are 32 bits, the device mask says so.
+ */
+#define CQDMA_SEG_MAX	(MAX_TRANSFER_LEN1 & PAGE_MASK)
+
+struct cqdma_seg {
+	u32 src;
+	u32 dst;
+	u32 len;
+};
+
+struct cqdma_desc {
+	struct dma_async_tx_descriptor tx;
+	struct list_head node;
+	unsigned int nr_segs;
+	unsigned int cur;
+	struct cqdma_seg segs[0];
+};
+
+struct cqdma_chan {
+	struct dma_chan chan;
+	int hw;
+	bool busy;
+	spinlock_t lock;
+	struct list_head submitted;
+	struct list_head issued;	/* first one is on the hardware */
+	struct list_head completed;
+	struct list_head unacked;	/* done, client has not acked yet */
+	struct tasklet_struct tasklet;
+};
+
+static struct dma_device cqdma_dma;
+static struct cqdma_chan cqdma_chans[MAX_CQDMA_CHANNELS];
+
+static inline struct cqdma_chan *to_cqdma_chan(struct dma_chan *chan)
+{
+	return container_of(chan, struct cqdma_chan, chan);
+}
+
+static inline struct cqdma_desc *to_cqdma_desc(struct dma_async_tx_descriptor *tx)
+{
+	return container_of(tx, struct cqdma_desc, tx);
+}
+
+static inline bool cqdma_addr_ok(dma_addr_t addr, size_t len)
+{
+	return (u64)addr + len <= (1ULL << 32);
+}
+
+/* called with c->lock held */
+static void cqdma_start_seg(struct cqdma_chan *c, struct cqdma_seg *seg)
+{
+	int ch = c->hw;
+
+	mt_reg_sync_writel(seg->src, DMA_SRC(ch));
+	mt_reg_sync_writel(seg->dst, DMA_DST(ch));
+	mt_reg_sync_writel(seg->len, DMA_LEN1(ch));
+	mt_reg_sync_writel(DMA_START_BIT, DMA_START(ch));
+	c->busy = true;
+}
+
+static void cqdma_chan_isr(void *data)
+{
+	struct cqdma_chan *c = data;
+	struct cqdma_desc *d;
+
+	spin_lock(&c->lock);
+	d = list_first_entry_or_null(&c->issued, struct cqdma_desc, node);
+	if (d && ++d->cur == d->nr_segs) {
+		c->chan.completed_cookie = d->tx.cookie;
+		list_move_tail(&d->node, &c->completed);
+		tasklet_schedule(&c->tasklet);
+		d = list_first_entry_or_null(&c->issued, struct cqdma_desc, node);
+	}
+	if (d)
+		cqdma_start_seg(c, &d->segs[d->cur]);
+	else
+		c->busy = false;
+	spin_unlock(&c->lock);
+}
+
+static void cqdma_free_acked(struct cqdma_chan *c)
+{
+	struct cqdma_desc *d, *n;
+
+	list_for_each_entry_safe(d, n, &c->unacked, node) {
+		if (async_tx_test_ack(&d->tx)) {
+			list_del(&d->node);
+			kfree(d);
+		}
+	}
+}
+
+static void cqdma_tasklet(unsigned long data)
+{
+	struct cqdma_chan *c = (struct cqdma_chan *)data;
+	struct cqdma_desc *d, *n;
+	LIST_HEAD(done);
+
+	spin_lock_irq(&c->lock);
+	list_splice_tail_init(&c->completed, &done);
+	spin_unlock_irq(&c->lock);
+
+	list_for_each_entry_safe(d, n, &done, node) {
+		dma_descriptor_unmap(&d->tx);
+		if (d->tx.callback)
+			d->tx.callback(d->tx.callback_param);
+		dma_run_dependencies(&d->tx);
+		/* async_tx may still chain on it until the client acks */
+		list_move_tail(&d->node, &c->unacked);
+	}
+	cqdma_free_acked(c);
+}
+
+static dma_cookie_t cqdma_tx_submit(struct dma_async_tx_descriptor *tx)
+{
+	struct cqdma_chan *c = to_cqdma_chan(tx->chan);
+	unsigned long flags;
+	dma_cookie_t cookie;
+
+	spin_lock_irqsave(&c->lock, flags);
+	cookie = c->chan.cookie + 1;
+	if (cookie < DMA_MIN_COOKIE)
+		cookie = DMA_MIN_COOKIE;
+	tx->cookie = c->chan.cookie = cookie;
+	list_add_tail(&to_cqdma_desc(tx)->node, &c->submitted);
+	spin_unlock_irqrestore(&c->lock, flags);
+
+	return cookie;
+}
+
+static struct cqdma_desc *cqdma_desc_alloc(struct dma_chan *chan, unsigned int nr_segs,
+					   unsigned long flags)
+{
+	struct cqdma_desc *d;
+
+	d = kzalloc(sizeof(*d) + nr_segs * sizeof(struct cqdma_seg), GFP_NOWAIT);
+	if (!d)
+		return NULL;
+	dma_async_tx_descriptor_init(&d->tx, chan);
+	d->tx.tx_submit = cqdma_tx_submit;
+	d->tx.flags = flags;
+	d->nr_segs = nr_segs;
+	return d;
+}
+
+static struct dma_async_tx_descriptor *cqdma_prep_memcpy(struct dma_chan *chan,
+		dma_addr_t dst, dma_addr_t src, size_t len, unsigned long flags)
+{
+	struct cqdma_desc *d;
+	unsigned int i;
+	size_t n;
+
+	if (!len || !cqdma_addr_ok(src, len) || !cqdma_addr_ok(dst, len))
+		return NULL;
+
+	d = cqdma_desc_alloc(chan, DIV_ROUND_UP(len, CQDMA_SEG_MAX), flags);
+	if (!d)
+		return NULL;
+	for (i = 0; i < d->nr_segs; i++) {
+		n = min_t(size_t, len, CQDMA_SEG_MAX);
+		d->segs[i].src = src;
+		d->segs[i].dst = dst;
+		d->segs[i].len = n;
+		src += n;
+		dst += n;
+		len -= n;
+	}
+	return &d->tx;
+}
+
+/*
+ * Pair up the two lists, cutting where either entry ends or at
+ * CQDMA_SEG_MAX. Only counts when segs is NULL; 0 if an address is out of
+ * reach.
+ */
+static unsigned int cqdma_sg_segs(struct scatterlist *dst_sg, unsigned int dst_nents,
+				  struct scatterlist *src_sg, unsigned int src_nents,
+				  struct cqdma_seg *segs)
+{
+	dma_addr_t dst = sg_dma_address(dst_sg), src = sg_dma_address(src_sg);
+	size_t dst_len = sg_dma_len(dst_sg), src_len = sg_dma_len(src_sg), len;
+	unsigned int n = 0;
+
+	for (;;) {
+		len = min3(dst_len, src_len, (size_t)CQDMA_SEG_MAX);
+		if (len) {
+			if (!cqdma_addr_ok(src, len) || !cqdma_addr_ok(dst, len))
+				return 0;
+			if (segs) {
+				segs[n].src = src;
+				segs[n].dst = dst;
+				segs[n].len = len;
+			}
+			n++;
+		}
+		src += len;
+		src_len -= len;
+		dst += len;
+		dst_len -= len;
+
+		if (!dst_len) {
+			if (!--dst_nents)
+				break;
+			dst_sg = sg_next(dst_sg);
+			dst = sg_dma_address(dst_sg);
+			dst_len = sg_dma_len(dst_sg);
+		}
+		if (!src_len) {
+			if (!--src_nents)
+				break;
+			src_sg = sg_next(src_sg);
+			src = sg_dma_address(src_sg);
+			src_len = sg_dma_len(src_sg);
+		}
+	}
+	return n;
+}
+
+static struct dma_async_tx_descriptor *cqdma_prep_sg(struct dma_chan *chan,
+		struct scatterlist *dst_sg, unsigned int dst_nents,
+		struct scatterlist *src_sg, unsigned int src_nents, unsigned long flags)
+{
+	struct cqdma_desc *d;
+	unsigned int nr_segs;
+
+	if (!dst_nents || !src_nents)
+		return NULL;
+	nr_segs = cqdma_sg_segs(dst_sg, dst_nents, src_sg, src_nents, NULL);
+	if (!nr_segs)
+		return NULL;
+
+	d = cqdma_desc_alloc(chan, nr_segs, flags);
+	if (!d)
+		return NULL;
+	cqdma_sg_segs(dst_sg, dst_nents, src_sg, src_nents, d->segs);
+	return &d->tx;
+}
+
+static void cqdma_issue_pending(struct dma_chan *chan)
+{
+	struct cqdma_chan *c = to_cqdma_chan(chan);
+	struct cqdma_desc *d;
+	unsigned long flags;
+
+	spin_lock_irqsave(&c->lock, flags);
+	list_splice_tail_init(&c->submitted, &c->issued);
+	if (!c->busy) {
+		d = list_first_entry_or_null(&c->issued, struct cqdma_desc, node);
+		if (d)
+			cqdma_start_seg(c, &d->segs[d->cur]);
+	}
+	spin_unlock_irqrestore(&c->lock, flags);
+}
+
+static enum dma_status cqdma_tx_status(struct dma_chan *chan, dma_cookie_t cookie,
+				       struct dma_tx_state *state)
+{
+	dma_cookie_t used = ACCESS_ONCE(chan->cookie);
+	dma_cookie_t last = ACCESS_ONCE(chan->completed_cookie);
+
+	dma_set_tx_state(state, last, used, 0);
+	return dma_async_is_complete(cookie, last, used);
+}
+
+static void cqdma_terminate_all(struct cqdma_chan *c)
+{
+	struct cqdma_desc *d, *n;
+	unsigned long flags;
+	LIST_HEAD(drop);
+
+	spin_lock_irqsave(&c->lock, flags);
+	if (c->busy) {
+		mt_reg_sync_writel(DMA_FLUSH_BIT, DMA_FLUSH(c->hw));
+		while (readl(DMA_START(c->hw)))
+			;
+		mt_reg_sync_writel(DMA_FLUSH_CLR_BIT, DMA_FLUSH(c->hw));
+		mt_reg_sync_writel(DMA_INT_FLAG_CLR_BIT, DMA_INT_FLAG(c->hw));
+		c->busy = false;
+	}
+	list_splice_tail_init(&c->submitted, &drop);
+	list_splice_tail_init(&c->issued, &drop);
+	spin_unlock_irqrestore(&c->lock, flags);
+
+	list_for_each_entry_safe(d, n, &drop, node) {
+		dma_descriptor_unmap(&d->tx);
+		kfree(d);
+	}
+}
+
+static int cqdma_control(struct dma_chan *chan, enum dma_ctrl_cmd cmd, unsigned long arg)
+{
+	if (cmd != DMA_TERMINATE_ALL)
+		return -ENXIO;
+	cqdma_terminate_all(to_cqdma_chan(chan));
+	return 0;
+}
+
+static int cqdma_alloc_chan_resources(struct dma_chan *chan)
+{
+	struct cqdma_chan *c = to_cqdma_chan(chan);
+	struct mt_gdma_conf conf;
+
+	if (mt_req_gdma((DMA_CHAN)c->hw) != c->hw)
+		return -EBUSY;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.iten = 1;
+	conf.burst = DMA_CON_BURST_8BEAT;
+	conf.isr_cb = cqdma_chan_isr;
+	conf.data = c;
+	if (mt_config_gdma(c->hw, &conf, ALL)) {
+		mt_free_gdma(c->hw);
+		return -EIO;
+	}
+	chan->completed_cookie = chan->cookie = DMA_MIN_COOKIE;
+	return 0;
+}
+
+static void cqdma_free_chan_resources(struct dma_chan *chan)
+{
+	struct cqdma_chan *c = to_cqdma_chan(chan);
+	struct cqdma_desc *d, *n;
+
+	cqdma_terminate_all(c);
+	tasklet_kill(&c->tasklet);
+	/* completions the tasklet did not get to are dropped */
+	list_splice_tail_init(&c->completed, &c->unacked);
+	list_for_each_entry_safe(d, n, &c->unacked, node) {
+		list_del(&d->node);
+		kfree(d);
+	}
+	mt_free_gdma(c->hw);
+}
+
+static int cqdma_dmaengine_register(struct platform_device *pdev)
+{
+	struct dma_device *dd = &cqdma_dma;
+	struct cqdma_chan *c;
+	unsigned int i;
+	int ret;
+
+	ret = dma_set_mask_and_coherent(&pdev->dev, DMA_BIT_MASK(32));
+	if (ret)
+		return ret;
+
+	INIT_LIST_HEAD(&dd->channels);
+	dma_cap_set(DMA_MEMCPY, dd->cap_mask);
+	dma_cap_set(DMA_SG, dd->cap_mask);
+	dd->dev = &pdev->dev;
+	dd->device_alloc_chan_resources = cqdma_alloc_chan_resources;
+	dd->device_free_chan_resources = cqdma_free_chan_resources;
+	dd->device_prep_dma_memcpy = cqdma_prep_memcpy;
+	dd->device_prep_dma_sg = cqdma_prep_sg;
+	dd->device_control = cqdma_control;
+	dd->device_tx_status = cqdma_tx_status;
+	dd->device_issue_pending = cqdma_issue_pending;
+
+	for (i = 0; i < nr_cqdma_channel; i++) {
+		c = &cqdma_chans[i];
+		c->hw = i;
+		c->chan.device = dd;
+		spin_lock_init(&c->lock);
+		INIT_LIST_HEAD(&c->submitted);
+		INIT_LIST_HEAD(&c->issued);
+		INIT_LIST_HEAD(&c->completed);
+		INIT_LIST_HEAD(&c->unacked);
+		tasklet_init(&c->tasklet, cqdma_tasklet, (unsigned long)c);
+		list_add_tail(&c->chan.device_node, &dd->channels);
+	}
+
+	return dma_async_device_register(dd);
+}
+#endif
+
 static const struct of_device_id cqdma_of_ids[] = {
 	{ .compatible = "mediatek,mt-cqdma-v1", },
 	{}
@@ -660,6 +1047,11 @@ static int cqdma_probe(struct platform_device *pdev)
 	}
 #endif
 
+#ifdef CONFIG_MTK_CQDMA_DMAENGINE
+	if (cqdma_dmaengine_register(pdev))
+		pr_err("[CQDMA] dmaengine registration failed\n");
+#endif
+
 	return ret;
 }
 
@@ -36,6 +36,16 @@
 #include "../../../../crypto/tcrypt.h"
 #include "../../../../crypto/internal.h"
 #include <linux/proc_fs.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/cpu.h>
+#include <linux/topology.h>
+#include <linux/slab.h>
+#include <linux/random.h>
+#include <linux/lz4.h>
+#include <linux/lz4k.h>
 
 #define TCRYPT_FS_PROC
 /*
@@ -1199,6 +1209,522 @@ out:
 	crypto_free_ablkcipher(tfm);
 }
 
+/*
+ * Benchmark matrix, driven through debugfs:
+ *
+ *   echo "cipher cbc-aes-ce" > /sys/kernel/debug/tcrypt/bench
+ *   cat /sys/kernel/debug/tcrypt/bench
+ *
+ * kind is cipher, hash or aead; the name is a cra_name, or a
+ * cra_driver_name to pick one provider (NEON, CE, offload...). Every size of
+ * bench_sizes runs for bench_ms with 1 up to bench_threads threads, each
+ * bound to its own cpu of one cluster, for every cluster. Requests go
+ * through the async API, so sync and async providers are timed the same
+ * way. A write replaces the table; reading it gives one tab separated row
+ * per (cluster, threads, size).
+ *
+ * kind comp or decomp times the zram compressors, "lz4" or "lz4k", on half
+ * compressible data. lz4k has no crypto_alg, so these call the library
+ * directly; MB/s counts uncompressed bytes.
+ */
+enum bench_kind {
+	BENCH_CIPHER,
+	BENCH_HASH,
+	BENCH_AEAD,
+	BENCH_COMP,
+	BENCH_DECOMP,
+	BENCH_NR_KINDS,
+};
+
+static const char * const bench_kind_name[BENCH_NR_KINDS] = {
+	"cipher", "hash", "aead", "comp", "decomp",
+};
+
+#define BENCH_MAX_ROWS		512
+#define BENCH_MAX_CLUSTERS	4
+#define BENCH_AUTHSIZE		16
+#define BENCH_AAD		16
+
+static u32 bench_sizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536, 0 };
+static unsigned int bench_ms = 200;
+static unsigned int bench_threads = 4;
+
+struct bench_row {
+	enum bench_kind kind;
+	char alg[CRYPTO_MAX_ALG_NAME];
+	char drv[CRYPTO_MAX_ALG_NAME];
+	int cluster;
+	int threads;
+	u32 size;
+	u64 ops;
+	u64 ns;		/* longest thread run time */
+	u64 lat_sum;
+	u64 lat_max;
+	int err;
+};
+
+static struct bench_row *bench_rows;
+static int bench_nr_rows;
+static DEFINE_MUTEX(bench_lock);
+
+struct bench_thread {
+	enum bench_kind kind;
+	const char *alg;
+	u32 size;
+	char drv[CRYPTO_MAX_ALG_NAME];
+	u64 ops;
+	u64 ns;
+	u64 lat_sum;
+	u64 lat_max;
+	int err;
+	struct completion ready;
+	struct completion *go;
+	struct completion done;
+};
+
+static inline int do_one_aead_op(struct aead_request *req, int ret)
+{
+	if (ret == -EINPROGRESS || ret == -EBUSY) {
+		struct tcrypt_result *tr = req->base.data;
+
+		ret = wait_for_completion_interruptible(&tr->completion);
+		if (!ret)
+			ret = tr->err;
+		reinit_completion(&tr->completion);
+	}
+
+	return ret;
+}
+
+struct bench_comp {
+	const char *name;
+	size_t wrkmem;
+	u32 max_size;		/* 0: any */
+	int (*compress)(const u8 *src, size_t len, u8 *dst, size_t *dst_len, void *wrkmem);
+	int (*decompress)(const u8 *src, size_t len, u8 *dst, size_t dst_len);
+};
+
+#if defined(CONFIG_LZ4_COMPRESS) && defined(CONFIG_LZ4_DECOMPRESS)
+static int bench_lz4_decompress(const u8 *src, size_t len, u8 *dst, size_t dst_len)
+{
+	return lz4_decompress_unknownoutputsize(src, len, dst, &dst_len);
+}
+#endif
+
+#ifdef CONFIG_LZ4K
+static int bench_lz4k_decompress(const u8 *src, size_t len, u8 *dst, size_t dst_len)
+{
+	return lz4k_decompress_safe(src, len, dst, &dst_len);
+}
+#endif
+
+static const struct bench_comp bench_comps[] = {
+#if defined(CONFIG_LZ4_COMPRESS) && defined(CONFIG_LZ4_DECOMPRESS)
+	{ "lz4", LZ4_MEM_COMPRESS, 0, lz4_compress, bench_lz4_decompress },
+#endif
+#ifdef CONFIG_LZ4K
+	{ "lz4k", LZ4K_MEM_COMPRESS, 4096, lz4k_compress, bench_lz4k_decompress },
+#endif
+	{ NULL },
+};
+
+static const struct bench_comp *bench_find_comp(const char *name)
+{
+	const struct bench_comp *bc;
+
+	for (bc = bench_comps; bc->name; bc++)
+		if (!strcmp(bc->name, name))
+			return bc;
+	return NULL;
+}
+
+/* random letters, every other 16 byte chunk repeats an earlier one */
+static void bench_fill_comp(u8 *buf, u32 size)
+{
+	struct rnd_state rs;
+	u32 i, j, from;
+
+	prandom_seed_state(&rs, size);
+	for (i = 0; i < size; i += 16) {
+		from = i >= 64 && (i & 16) ? prandom_u32_state(&rs) % (i - 16) : i;
+		for (j = i; j < i + 16 && j < size; j++)
+			buf[j] = from != i ? buf[from + j - i] :
+				 'a' + (prandom_u32_state(&rs) & 15);
+	}
+}
+
+/* key sizes differ per mode (xts takes two keys), try until one fits */
+static int bench_setkey(int (*setkey)(void *tfm, const u8 *key, unsigned int len), void *tfm)
+{
+	static const unsigned int lens[] = { 16, 32, 64 };
+	u8 key[64];
+	int i, ret = -EINVAL;
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = i + 1;
+	for (i = 0; i < ARRAY_SIZE(lens) && ret; i++)
+		ret = setkey(tfm, key, lens[i]);
+	return ret;
+}
+
+static int bench_ablkcipher_setkey(void *tfm, const u8 *key, unsigned int len)
+{
+	crypto_ablkcipher_clear_flags(tfm, ~0);
+	return crypto_ablkcipher_setkey(tfm, key, len);
+}
+
+static int bench_ahash_setkey(void *tfm, const u8 *key, unsigned int len)
+{
+	crypto_ahash_clear_flags(tfm, ~0);
+	return crypto_ahash_setkey(tfm, key, len);
+}
+
+static int bench_aead_setkey(void *tfm, const u8 *key, unsigned int len)
+{
+	crypto_aead_clear_flags(tfm, ~0);
+	return crypto_aead_setkey(tfm, key, len);
+}
+
+static int bench_thread_fn(void *data)
+{
+	struct bench_thread *bt = data;
+	struct crypto_ablkcipher *ctfm = NULL;
+	struct ablkcipher_request *creq = NULL;
+	struct crypto_ahash *htfm = NULL;
+	struct ahash_request *hreq = NULL;
+	struct crypto_aead *atfm = NULL;
+	struct aead_request *areq = NULL;
+	const struct bench_comp *bc = NULL;
+	void *wrkmem = NULL;
+	u8 *cbuf = NULL;
+	size_t clen = 0;
+	struct tcrypt_result tresult;
+	struct scatterlist sg, asg;
+	u8 out[128], iv[MAX_IVLEN], *buf, *assoc;
+	ktime_t start, t0;
+	u64 lat;
+	int ret = -ENOMEM;
+
+	init_completion(&tresult.completion);
+	memset(iv, 0xff, sizeof(iv));
+	buf = kmalloc(bt->size + BENCH_AUTHSIZE + BENCH_AAD, GFP_KERNEL);
+	if (!buf)
+		goto out_ready;
+	memset(buf, 0xff, bt->size + BENCH_AUTHSIZE + BENCH_AAD);
+	assoc = buf + bt->size + BENCH_AUTHSIZE;
+	sg_init_one(&asg, assoc, BENCH_AAD);
+
+	switch (bt->kind) {
+	case BENCH_CIPHER:
+		ctfm = crypto_alloc_ablkcipher(bt->alg, 0, 0);
+		if (IS_ERR(ctfm)) {
+			ret = PTR_ERR(ctfm);
+			ctfm = NULL;
+			goto out_ready;
+		}
+		strlcpy(bt->drv, get_driver_name(crypto_ablkcipher, ctfm), sizeof(bt->drv));
+		ret = bench_setkey(bench_ablkcipher_setkey, ctfm);
+		creq = ablkcipher_request_alloc(ctfm, GFP_KERNEL);
+		if (ret || !creq)
+			goto out_ready;
+		sg_init_one(&sg, buf, bt->size);
+		ablkcipher_request_set_callback(creq, CRYPTO_TFM_REQ_MAY_BACKLOG,
+						tcrypt_complete, &tresult);
+		ablkcipher_request_set_crypt(creq, &sg, &sg, bt->size, iv);
+		break;
+	case BENCH_HASH:
+		htfm = crypto_alloc_ahash(bt->alg, 0, 0);
+		if (IS_ERR(htfm)) {
+			ret = PTR_ERR(htfm);
+			htfm = NULL;
+			goto out_ready;
+		}
+		strlcpy(bt->drv, get_driver_name(crypto_ahash, htfm), sizeof(bt->drv));
+		/* fails with -ENOSYS for unkeyed hashes, that is fine */
+		bench_setkey(bench_ahash_setkey, htfm);
+		ret = crypto_ahash_digestsize(htfm) > sizeof(out) ? -EINVAL : 0;
+		hreq = ahash_request_alloc(htfm, GFP_KERNEL);
+		if (ret || !hreq)
+			goto out_ready;
+		sg_init_one(&sg, buf, bt->size);
+		ahash_request_set_callback(hreq, CRYPTO_TFM_REQ_MAY_BACKLOG,
+					   tcrypt_complete, &tresult);
+		ahash_request_set_crypt(hreq, &sg, out, bt->size);
+		break;
+	case BENCH_AEAD:
+		atfm = crypto_alloc_aead(bt->alg, 0, 0);
+		if (IS_ERR(atfm)) {
+			ret = PTR_ERR(atfm);
+			atfm = NULL;
+			goto out_ready;
+		}
+		strlcpy(bt->drv, get_driver_name(crypto_aead, atfm), sizeof(bt->drv));
+		ret = bench_setkey(bench_aead_setkey, atfm);
+		if (!ret)
+			ret = crypto_aead_setauthsize(atfm, BENCH_AUTHSIZE);
+		areq = aead_request_alloc(atfm, GFP_KERNEL);
+		if (ret || !areq)
+			goto out_ready;
+		sg_init_one(&sg, buf, bt->size + BENCH_AUTHSIZE);
+		aead_request_set_callback(areq, CRYPTO_TFM_REQ_MAY_BACKLOG,
+					  tcrypt_complete, &tresult);
+		aead_request_set_crypt(areq, &sg, &sg, bt->size, iv);
+		aead_request_set_assoc(areq, &asg, BENCH_AAD);
+		break;
+	case BENCH_COMP:
+	case BENCH_DECOMP:
+		bc = bench_find_comp(bt->alg);
+		if (!bc) {
+			ret = -ENOENT;
+			goto out_ready;
+		}
+		strlcpy(bt->drv, bc->name, sizeof(bt->drv));
+		if (bc->max_size && bt->size > bc->max_size) {
+			ret = -EINVAL;
+			goto out_ready;
+		}
+		wrkmem = kzalloc(bc->wrkmem, GFP_KERNEL);
+		cbuf = kmalloc(lz4_compressbound(bt->size) * 2, GFP_KERNEL);
+		if (!wrkmem || !cbuf)
+			goto out_ready;
+		bench_fill_comp(buf, bt->size);
+		/* decomp needs a compressed image, comp checks the size works */
+		clen = lz4_compressbound(bt->size) * 2;
+		ret = bc->compress(buf, bt->size, cbuf, &clen, wrkmem) ? -EINVAL : 0;
+		if (ret)
+			goto out_ready;
+		break;
+	default:
+		ret = -EINVAL;
+		goto out_ready;
+	}
+	ret = 0;
+
+out_ready:
+	bt->err = ret;
+	complete(&bt->ready);
+	if (ret)
+		goto out;
+
+	wait_for_completion(bt->go);
+	start = ktime_get();
+	do {
+		t0 = ktime_get();
+		switch (bt->kind) {
+		case BENCH_CIPHER:
+			ret = do_one_acipher_op(creq, crypto_ablkcipher_encrypt(creq));
+			break;
+		case BENCH_HASH:
+			ret = do_one_ahash_op(hreq, crypto_ahash_digest(hreq));
+			break;
+		case BENCH_COMP:
+			clen = lz4_compressbound(bt->size) * 2;
+			ret = bc->compress(buf, bt->size, cbuf, &clen, wrkmem) ? -EINVAL : 0;
+			break;
+		case BENCH_DECOMP:
+			ret = bc->decompress(cbuf, clen, buf, bt->size) ? -EINVAL : 0;
+			break;
+		default:
+			ret = do_one_aead_op(areq, crypto_aead_encrypt(areq));
+			break;
+		}
+		if (ret)
+			break;
+		lat = ktime_to_ns(ktime_sub(ktime_get(), t0));
+		bt->lat_sum += lat;
+		bt->lat_max = max(bt->lat_max, lat);
+		bt->ops++;
+		cond_resched();
+	} while (ktime_to_ms(ktime_sub(ktime_get(), start)) < bench_ms);
+	bt->ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	bt->err = ret;
+
+out:
+	if (creq)
+		ablkcipher_request_free(creq);
+	if (ctfm)
+		crypto_free_ablkcipher(ctfm);
+	if (hreq)
+		ahash_request_free(hreq);
+	if (htfm)
+		crypto_free_ahash(htfm);
+	if (areq)
+		aead_request_free(areq);
+	if (atfm)
+		crypto_free_aead(atfm);
+	kfree(cbuf);
+	kfree(wrkmem);
+	kfree(buf);
+	complete(&bt->done);
+	return 0;
+}
+
+/* one cell of the matrix: nr threads on the first nr cpus of @cpus */
+static int bench_run_cell(enum bench_kind kind, const char *alg, u32 size,
+			  const struct cpumask *cpus, int nr, struct bench_row *row)
+{
+	struct bench_thread *bts;
+	struct task_struct *tsk;
+	struct completion go;
+	int cpu, i = 0, started = 0;
+
+	bts = kcalloc(nr, sizeof(*bts), GFP_KERNEL);
+	if (!bts)
+		return -ENOMEM;
+	init_completion(&go);
+
+	for_each_cpu(cpu, cpus) {
+		if (i == nr)
+			break;
+		bts[i].kind = kind;
+		bts[i].alg = alg;
+		bts[i].size = size;
+		bts[i].go = &go;
+		init_completion(&bts[i].ready);
+		init_completion(&bts[i].done);
+		tsk = kthread_create(bench_thread_fn, &bts[i], "tcrypt_bench/%d", cpu);
+		if (IS_ERR(tsk))
+			break;
+		kthread_bind(tsk, cpu);
+		wake_up_process(tsk);
+		started++;
+		i++;
+	}
+	for (i = 0; i < started; i++)
+		wait_for_completion(&bts[i].ready);
+	complete_all(&go);
+
+	row->err = started == nr ? 0 : -ECHILD;
+	for (i = 0; i < started; i++) {
+		wait_for_completion(&bts[i].done);
+		if (bts[i].err && !row->err)
+			row->err = bts[i].err;
+		row->ops += bts[i].ops;
+		row->lat_sum += bts[i].lat_sum;
+		row->lat_max = max(row->lat_max, bts[i].lat_max);
+		row->ns = max(row->ns, bts[i].ns);
+	}
+	if (started)
+		strlcpy(row->drv, bts[0].drv, sizeof(row->drv));
+	kfree(bts);
+	return row->err;
+}
+
+static void bench_run(enum bench_kind kind, const char *alg)
+{
+	struct cpumask cluster_cpus[BENCH_MAX_CLUSTERS];
+	struct bench_row *row;
+	int cpu, c, nr, s, err;
+
+	for (c = 0; c < BENCH_MAX_CLUSTERS; c++)
+		cpumask_clear(&cluster_cpus[c]);
+	get_online_cpus();
+	for_each_online_cpu(cpu) {
+		c = topology_physical_package_id(cpu);
+		if (c >= 0 && c < BENCH_MAX_CLUSTERS)
+			cpumask_set_cpu(cpu, &cluster_cpus[c]);
+	}
+	put_online_cpus();
+
+	bench_nr_rows = 0;
+	for (c = 0; c < BENCH_MAX_CLUSTERS; c++) {
+		for (nr = 1; nr <= min_t(int, bench_threads, cpumask_weight(&cluster_cpus[c])); nr++) {
+			for (s = 0; bench_sizes[s]; s++) {
+				if (bench_nr_rows == BENCH_MAX_ROWS)
+					return;
+				row = &bench_rows[bench_nr_rows++];
+				memset(row, 0, sizeof(*row));
+				row->kind = kind;
+				strlcpy(row->alg, alg, sizeof(row->alg));
+				row->cluster = c;
+				row->threads = nr;
+				row->size = bench_sizes[s];
+				err = bench_run_cell(kind, alg, bench_sizes[s], &cluster_cpus[c],
+						     nr, row);
+				/* the algorithm is missing, nothing else will work */
+				if (err == -ENOENT)
+					return;
+			}
+		}
+	}
+}
+
+static ssize_t bench_write(struct file *file, const char __user *ubuf,
+			   size_t count, loff_t *ppos)
+{
+	char buf[CRYPTO_MAX_ALG_NAME + 16], kind[8], name[CRYPTO_MAX_ALG_NAME];
+	size_t len = min(count, sizeof(buf) - 1);
+	int k;
+
+	if (copy_from_user(buf, ubuf, len))
+		return -EFAULT;
+	buf[len] = '\0';
+	if (sscanf(buf, "%7s %63s", kind, name) != 2)
+		return -EINVAL;
+	for (k = 0; k < BENCH_NR_KINDS; k++)
+		if (!strcmp(kind, bench_kind_name[k]))
+			break;
+	if (k == BENCH_NR_KINDS)
+		return -EINVAL;
+
+	mutex_lock(&bench_lock);
+	bench_run(k, name);
+	mutex_unlock(&bench_lock);
+	return count;
+}
+
+static int bench_show(struct seq_file *m, void *v)
+{
+	struct bench_row *row;
+	u64 mbps, avg;
+	int i;
+
+	seq_puts(m, "kind\talg\tdriver\tcluster\tthreads\tsize\tops\tMB/s\tavg_ns\tmax_ns\terr\n");
+	mutex_lock(&bench_lock);
+	for (i = 0; i < bench_nr_rows; i++) {
+		row = &bench_rows[i];
+		mbps = row->ns ? div64_u64(row->ops * row->size * 1000, row->ns) : 0;
+		avg = row->ops ? div64_u64(row->lat_sum, row->ops) : 0;
+		seq_printf(m, "%s\t%s\t%s\t%d\t%d\t%u\t%llu\t%llu\t%llu\t%llu\t%d\n",
+			   bench_kind_name[row->kind], row->alg, row->drv[0] ? row->drv : "-",
+			   row->cluster, row->threads, row->size, row->ops, mbps, avg,
+			   row->lat_max, row->err);
+	}
+	mutex_unlock(&bench_lock);
+	return 0;
+}
+
+static int bench_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, bench_show, NULL);
+}
+
+static const struct file_operations bench_fops = {
+	.open = bench_open,
+	.read = seq_read,
+	.write = bench_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init bench_init(void)
+{
+	struct dentry *dir;
+
+	bench_rows = kcalloc(BENCH_MAX_ROWS, sizeof(*bench_rows), GFP_KERNEL);
+	if (!bench_rows)
+		return -ENOMEM;
+	dir = debugfs_create_dir("tcrypt", NULL);
+	if (!dir || !debugfs_create_file("bench", S_IRUSR | S_IWUSR, dir, NULL, &bench_fops)) {
+		kfree(bench_rows);
+		bench_rows = NULL;
+		return -ENOMEM;
+	}
+	debugfs_create_u32("bench_ms", S_IRUSR | S_IWUSR, dir, &bench_ms);
+	debugfs_create_u32("bench_threads", S_IRUSR | S_IWUSR, dir, &bench_threads);
+	return 0;
+}
+
 static void test_available(void)
 {
 	char **name = check;
@@ -2246,6 +2772,8 @@ static int __init tcrypt_mod_init(void)
 	entry = proc_create("tcrypt", S_IRUGO | S_IWUGO, NULL, &tcrypt_proc_fops); /* Also for userload version. */
 	if (!entry)
 		return -ENOMEM;
+	if (bench_init())
+		pr_warn("tcrypt: no benchmark interface\n");
 	return 0;
 }
 
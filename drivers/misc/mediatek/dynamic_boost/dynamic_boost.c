@@ -23,6 +23,7 @@
 #include <linux/module.h>
 #include <linux/moduleparam.h>
 #include <linux/mutex.h>
+#include <linux/of.h>
 #include <linux/platform_device.h>
 #include <linux/rwsem.h>
 #include <linux/sched.h>
@@ -34,8 +35,11 @@
 #include <mt_hotplug_strategy.h>
 #include <mt_hotplug_strategy_internal.h>
 #include "mt_cpufreq.h"
+#include "mt_vcorefs_manager.h"
 #include <linux/input.h>
 #include <linux/workqueue.h>
+#include <mt-plat/mtk_gpu_utility.h>
+#include <mt-plat/mtk_input_boost.h>
 #include "dynamic_boost.h"
 
 struct boost_state {
@@ -43,32 +47,58 @@ struct boost_state {
 	struct delayed_work work;
 };
 
+/*
+ * Input boost: the CPU mode, GPU floor and vcore OPP requested for an input
+ * burst share one deadline. An input event arms it @timeout_ms ahead, each
+ * presented frame moves it @frame_ms ahead, but never past @max_ms after the
+ * last input event.
+ */
+struct input_boost {
+	int enabled;
+	int prio_mode;
+	int gpu_level;		/* mtk_custom_boost_gpu_freq() scale, 0: no GPU boost */
+	int vcore;		/* request vcore OPPI_PERF while boosted */
+	int timeout_ms;
+	int frame_ms;
+	int max_ms;
+	bool active;
+	unsigned long last_input;
+	unsigned long deadline;
+	struct delayed_work release_work;
+};
+
 struct dynamic_boost {
 	spinlock_t boost_lock;
 	int last_req_mode;
 	wait_queue_head_t wq;
 	struct task_struct *thread;
 	struct boost_state state[PRIO_DEFAULT];
+	struct input_boost ib;
 	atomic_t event;
 };
 
 static struct dynamic_boost dboost;
 
-struct dboost_input_handle {
-	struct input_handle handle;
-	int duration;
-	int prio_mode;
-};
-
 #define MAX_CORES_NUMBER nr_cpu_ids
 #define MAX_FREQUENCY 1
 #define MAX_DURATION 10000
 
+#define INPUT_BOOST_GPU_TOP_LEVEL 0xff	/* clamped to the top OPP by GED */
+
+/* CPU bound late frame: big cores at max frequency for about three frames */
+#define FRAME_BOOST_CPU_MODE PRIO_TWO_BIGS_MAX_FREQ
+#define FRAME_BOOST_CPU_MS 50
+
 static ssize_t dynamic_boost_show(struct device *dev, struct device_attribute *attr, char *buf);
 static ssize_t dynamic_boost_store(struct device *dev, struct device_attribute *attr, const char *buf,
 	size_t n);
 static struct device_attribute dynamic_boost_attr = __ATTR(dynamic_boost, 0750,
 	dynamic_boost_show, dynamic_boost_store);
+static ssize_t input_boost_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t input_boost_store(struct device *dev, struct device_attribute *attr, const char *buf,
+	size_t n);
+static struct device_attribute input_boost_attr = __ATTR(input_boost, 0640,
+	input_boost_show, input_boost_store);
 
 static void dboost_disable_work(struct work_struct *work)
 {
@@ -118,6 +148,111 @@ int set_dynamic_boost(int duration, int prio_mode)
 }
 EXPORT_SYMBOL(set_dynamic_boost);
 
+/******************************************************************************
+ *                         Input boost arbiter                                *
+ ******************************************************************************/
+static void input_boost_release_work(struct work_struct *work)
+{
+	struct input_boost *ib = &dboost.ib;
+	unsigned long flags, now = jiffies;
+	bool released = false;
+
+	spin_lock_irqsave(&dboost.boost_lock, flags);
+	if (ib->active) {
+		if (time_before(now, ib->deadline)) {
+			/* frames kept coming, sleep until the new deadline */
+			mod_delayed_work(system_wq, &ib->release_work, ib->deadline - now);
+		} else {
+			ib->active = false;
+			released = true;
+		}
+	}
+	spin_unlock_irqrestore(&dboost.boost_lock, flags);
+
+	if (released) {
+		atomic_inc(&dboost.event);
+		wake_up(&dboost.wq);
+	}
+}
+
+bool input_boost_kick(void)
+{
+	struct input_boost *ib = &dboost.ib;
+	unsigned long flags, now = jiffies;
+	bool armed = false;
+
+	if (!ib->enabled)
+		return false;
+
+	spin_lock_irqsave(&dboost.boost_lock, flags);
+	ib->last_input = now;
+	if (time_after(now + msecs_to_jiffies(ib->timeout_ms), ib->deadline) || !ib->active)
+		ib->deadline = now + msecs_to_jiffies(ib->timeout_ms);
+	if (!ib->active) {
+		ib->active = true;
+		armed = true;
+		mod_delayed_work(system_wq, &ib->release_work, ib->deadline - now);
+	}
+	spin_unlock_irqrestore(&dboost.boost_lock, flags);
+
+	if (armed) {
+		atomic_inc(&dboost.event);
+		wake_up(&dboost.wq);
+	}
+	return true;
+}
+EXPORT_SYMBOL(input_boost_kick);
+
+/*
+ * Called for every presented frame, so only the deadline is moved here;
+ * input_boost_release_work() picks the new value up when it fires.
+ */
+void input_boost_frame(void)
+{
+	struct input_boost *ib = &dboost.ib;
+	unsigned long flags, deadline;
+
+	if (!ib->active)
+		return;
+
+	spin_lock_irqsave(&dboost.boost_lock, flags);
+	if (ib->active) {
+		deadline = jiffies + msecs_to_jiffies(ib->frame_ms);
+		if (time_after(deadline, ib->last_input + msecs_to_jiffies(ib->max_ms)))
+			deadline = ib->last_input + msecs_to_jiffies(ib->max_ms);
+		if (time_after(deadline, ib->deadline))
+			ib->deadline = deadline;
+	}
+	spin_unlock_irqrestore(&dboost.boost_lock, flags);
+}
+EXPORT_SYMBOL(input_boost_frame);
+
+/*
+ * No GPU or vcore request here: GED only calls this when the GPU finished
+ * in time and the frame was late on the CPU side.
+ */
+void frame_boost_cpu(void)
+{
+	set_dynamic_boost(FRAME_BOOST_CPU_MS, FRAME_BOOST_CPU_MODE);
+}
+EXPORT_SYMBOL(frame_boost_cpu);
+
+/* GPU and vcore requests may sleep, so they are applied from the boost thread */
+static void input_boost_apply(int gpu_level, int vcore)
+{
+	static int cur_gpu_level, cur_vcore;
+
+	if (gpu_level != cur_gpu_level) {
+		mtk_input_boost_gpu_freq(gpu_level);
+		cur_gpu_level = gpu_level;
+	}
+
+	if (vcore != cur_vcore) {
+		vcorefs_request_dvfs_opp(KIR_BOOST, vcore ? OPPI_PERF : OPPI_UNREQ);
+		cur_vcore = vcore;
+	}
+}
+
 static int dboost_dvfs_hotplug_thread(void *ptr)
 {
 	int max_freq, cores_to_set_b, cores_to_set_l;
@@ -127,6 +262,7 @@ static int dboost_dvfs_hotplug_thread(void *ptr)
 
 	while (!kthread_should_stop()) {
 		int i, set_mode = PRIO_DEFAULT;
+		int gpu_level = 0, vcore = 0;
 
 		spin_lock_irqsave(&dboost.boost_lock, flags);
 		for (i = PRIO_DEFAULT - 1; i >= 0; i--) {
@@ -135,8 +271,16 @@ static int dboost_dvfs_hotplug_thread(void *ptr)
 				break;
 			}
 		}
+		if (dboost.ib.active) {
+			if (set_mode == PRIO_DEFAULT || dboost.ib.prio_mode > set_mode)
+				set_mode = dboost.ib.prio_mode;
+			gpu_level = dboost.ib.gpu_level;
+			vcore = dboost.ib.vcore;
+		}
 		spin_unlock_irqrestore(&dboost.boost_lock, flags);
 
+		input_boost_apply(gpu_level, vcore);
+
 		switch (set_mode) {
 		case PRIO_MAX_CORES_MAX_FREQ:
 			cores_to_set_b = num_possible_big_cpus();
@@ -270,11 +414,113 @@ static ssize_t dynamic_boost_store(struct device *dev, struct device_attribute *
 	return n;
 }
 
+static bool input_boost_params_valid(int prio_mode, int gpu_level, int timeout_ms,
+				     int frame_ms, int max_ms)
+{
+	return prio_mode >= 0 && prio_mode < PRIO_RESET && gpu_level >= 0 &&
+	       timeout_ms > 0 && timeout_ms <= MAX_DURATION &&
+	       frame_ms >= 0 && frame_ms <= MAX_DURATION &&
+	       max_ms >= timeout_ms && max_ms <= MAX_DURATION;
+}
+
+/*
+ * Platform defaults, overridden by the optional properties of the
+ * "mediatek,dynamic_boost" node; the input_boost attribute tunes them later.
+ */
+static void input_boost_init_params(struct input_boost *ib)
+{
+	struct device_node *node;
+	u32 enabled = 1, prio_mode = PRIO_TWO_BIGS_TWO_LITTLES_MAX_FREQ;
+	u32 gpu_level = INPUT_BOOST_GPU_TOP_LEVEL, vcore = 1;
+	u32 timeout_ms = 150, frame_ms = 50, max_ms = 1000;
+
+	node = of_find_compatible_node(NULL, NULL, "mediatek,dynamic_boost");
+	if (node) {
+		of_property_read_u32(node, "input_boost_enable", &enabled);
+		of_property_read_u32(node, "input_boost_mode", &prio_mode);
+		of_property_read_u32(node, "input_boost_gpu_level", &gpu_level);
+		of_property_read_u32(node, "input_boost_vcore", &vcore);
+		of_property_read_u32(node, "input_boost_timeout_ms", &timeout_ms);
+		of_property_read_u32(node, "input_boost_frame_ms", &frame_ms);
+		of_property_read_u32(node, "input_boost_max_ms", &max_ms);
+		of_node_put(node);
+
+		if (!input_boost_params_valid(prio_mode, gpu_level, timeout_ms,
+					      frame_ms, max_ms)) {
+			pr_err("dynamic_boost: bad input boost DT parameters, using defaults\n");
+			prio_mode = PRIO_TWO_BIGS_TWO_LITTLES_MAX_FREQ;
+			gpu_level = INPUT_BOOST_GPU_TOP_LEVEL;
+			timeout_ms = 150;
+			frame_ms = 50;
+			max_ms = 1000;
+		}
+	}
+
+	ib->prio_mode = prio_mode;
+	ib->gpu_level = gpu_level;
+	ib->vcore = !!vcore;
+	ib->timeout_ms = timeout_ms;
+	ib->frame_ms = frame_ms;
+	ib->max_ms = max_ms;
+	/* input_boost_kick() may be called by other drivers before this point */
+	smp_wmb();
+	ib->enabled = !!enabled;
+}
+
+static ssize_t input_boost_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct input_boost *ib = &dboost.ib;
+
+	return snprintf(buf, PAGE_SIZE,
+			"enabled: %d\nprio_mode: %d\ngpu_level: %d\nvcore: %d\n"
+			"timeout_ms: %d\nframe_ms: %d\nmax_ms: %d\nactive: %d\n",
+			ib->enabled, ib->prio_mode, ib->gpu_level, ib->vcore,
+			ib->timeout_ms, ib->frame_ms, ib->max_ms, ib->active);
+}
+
+/* "<enabled> <prio_mode> <gpu_level> <vcore> <timeout_ms> <frame_ms> <max_ms>" */
+static ssize_t input_boost_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t n)
+{
+	struct input_boost *ib = &dboost.ib;
+	int enabled, prio_mode, gpu_level, vcore, timeout_ms, frame_ms, max_ms;
+	unsigned long flags;
+
+	if ((n == 0) || (buf == NULL))
+		return -EINVAL;
+	if (sscanf(buf, "%d %d %d %d %d %d %d", &enabled, &prio_mode, &gpu_level, &vcore,
+		   &timeout_ms, &frame_ms, &max_ms) != 7)
+		return -EINVAL;
+	if (!input_boost_params_valid(prio_mode, gpu_level, timeout_ms, frame_ms, max_ms))
+		return -EINVAL;
+
+	spin_lock_irqsave(&dboost.boost_lock, flags);
+	ib->enabled = !!enabled;
+	ib->prio_mode = prio_mode;
+	ib->gpu_level = gpu_level;
+	ib->vcore = !!vcore;
+	ib->timeout_ms = timeout_ms;
+	ib->frame_ms = frame_ms;
+	ib->max_ms = max_ms;
+	/* let a running boost expire on the next check */
+	if (!ib->enabled)
+		ib->deadline = jiffies;
+	spin_unlock_irqrestore(&dboost.boost_lock, flags);
+
+	atomic_inc(&dboost.event);
+	wake_up(&dboost.wq);
+
+	return n;
+}
+
 static int dynamic_boost_probe(struct platform_device *dev)
 {
 	int ret_device_file = 0;
 
 	ret_device_file = device_create_file(&(dev->dev), &dynamic_boost_attr);
+	if (ret_device_file)
+		return ret_device_file;
+
+	ret_device_file = device_create_file(&(dev->dev), &input_boost_attr);
 
 	return ret_device_file;
 }
@@ -296,6 +542,10 @@ int dboost_suspend(struct device *dev)
 		dboost.state[i].active = 0;
 		spin_unlock_irqrestore(&dboost.boost_lock, flags);
 	}
+	cancel_delayed_work_sync(&dboost.ib.release_work);
+	spin_lock_irqsave(&dboost.boost_lock, flags);
+	dboost.ib.active = false;
+	spin_unlock_irqrestore(&dboost.boost_lock, flags);
 	atomic_inc(&dboost.event);
 	wake_up(&dboost.wq);
 	return 0;
@@ -324,54 +574,46 @@ static struct platform_driver dynamic_boost_driver = {
 static void dboost_input_event(struct input_handle *handle, unsigned int type,
 		unsigned int code, int value)
 {
-	struct dboost_input_handle *in = container_of(handle, struct dboost_input_handle, handle);
-
-	if ((type == EV_KEY && code == BTN_TOUCH) ||
-				(type == EV_ABS && code == ABS_MT_TRACKING_ID && value != 0))
-		set_dynamic_boost(in->duration, in->prio_mode);
+	if ((type == EV_KEY && code == BTN_TOUCH && value) ||
+				(type == EV_ABS && code == ABS_MT_TRACKING_ID && value != -1))
+		input_boost_kick();
 }
 
 static int dboost_input_connect(struct input_handler *handler,
 		struct input_dev *dev, const struct input_device_id *id)
 {
-	struct dboost_input_handle *in;
+	struct input_handle *handle;
 	int error;
 
-	in = kzalloc(sizeof(struct dboost_input_handle), GFP_KERNEL);
-	if (!in)
+	handle = kzalloc(sizeof(struct input_handle), GFP_KERNEL);
+	if (!handle)
 		return -ENOMEM;
 
-	in->handle.dev = dev;
-	in->handle.handler = handler;
-	in->handle.name = "dynamic_boost";
-
-	/* TODO: the following parameters should be configured through platform data */
-	in->prio_mode = PRIO_TWO_BIGS_TWO_LITTLES_MAX_FREQ;
-	in->duration = 150;
+	handle->dev = dev;
+	handle->handler = handler;
+	handle->name = "dynamic_boost";
 
-	error = input_register_handle(&in->handle);
+	error = input_register_handle(handle);
 	if (error)
 		goto err2;
 
-	error = input_open_device(&in->handle);
+	error = input_open_device(handle);
 	if (error)
 		goto err1;
 
 	return 0;
 err1:
-	input_unregister_handle(&in->handle);
+	input_unregister_handle(handle);
 err2:
-	kfree(&in->handle);
+	kfree(handle);
 	return error;
 }
 
 static void dboost_input_disconnect(struct input_handle *handle)
 {
-	struct dboost_input_handle *in = container_of(handle, struct dboost_input_handle, handle);
-
 	input_close_device(handle);
 	input_unregister_handle(handle);
-	kfree(in);
+	kfree(handle);
 }
 
 static const struct input_device_id dboost_ids[] = {
@@ -414,6 +656,9 @@ static int __init dynamic_boost_init(void)
 	}
 	init_waitqueue_head(&dboost.wq);
 
+	INIT_DELAYED_WORK(&dboost.ib.release_work, input_boost_release_work);
+	input_boost_init_params(&dboost.ib);
+
 	dboost.thread = kthread_run(dboost_dvfs_hotplug_thread, &dboost, "dynamic_boost");
 	if (IS_ERR(dboost.thread))
 		return -EINVAL;
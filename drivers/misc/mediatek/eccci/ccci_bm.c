@@ -1,4 +1,5 @@
 #include <linux/skbuff.h>
+#include <linux/mm.h>
 #include <linux/wait.h>
 #include <linux/sched.h>
 #include <linux/delay.h>
@@ -23,6 +24,15 @@
 #define SKB_MAGIC_HEADER 0xF333F333
 #define SKB_MAGIC_FOOTER 0xF444F444
 
+/*
+ * pre-filled pools start full (max_len). a pool drained or reloaded again within POOL_GROW_INTERVAL
+ * doubles its fill target; one not reloaded for POOL_SHRINK_INTERVAL halves it, down to 1/POOL_MIN_DIV
+ * of max_len. skbs recycled above the fill target are freed, so an idle pool gives its memory back.
+ */
+#define POOL_MIN_DIV 8
+#define POOL_GROW_INTERVAL (HZ)
+#define POOL_SHRINK_INTERVAL (10 * HZ)
+
 struct ccci_req_queue req_pool;
 struct ccci_skb_queue skb_pool_4K;
 struct ccci_skb_queue skb_pool_1_5K;
@@ -352,7 +362,7 @@ struct sk_buff *ccci_skb_dequeue(struct ccci_skb_queue *queue)
 
 	spin_lock_irqsave(&queue->skb_list.lock, flags);
 	result = __skb_dequeue(&queue->skb_list);
-	if (queue->pre_filled && queue->skb_list.qlen < queue->max_len / RELOAD_TH)
+	if (queue->pre_filled && queue->skb_list.qlen < queue->fill_target / RELOAD_TH)
 		queue_work(pool_reload_work_queue, &queue->reload_work);
 	spin_unlock_irqrestore(&queue->skb_list.lock, flags);
 
@@ -364,7 +374,7 @@ void ccci_skb_enqueue(struct ccci_skb_queue *queue, struct sk_buff *newsk)
 	unsigned long flags;
 
 	spin_lock_irqsave(&queue->skb_list.lock, flags);
-	if (queue->skb_list.qlen < queue->max_len) {
+	if (queue->skb_list.qlen < queue->fill_target) {
 #ifdef CCCI_MEM_BM_DEBUG
 		if (is_in_ccci_skb_pool(newsk)) {
 			CCCI_INF_MSG(-1, BM,
@@ -419,6 +429,8 @@ void ccci_skb_queue_init(struct ccci_skb_queue *queue, unsigned int skb_size, un
 #endif
 	skb_queue_head_init(&queue->skb_list);
 	queue->max_len = max_len;
+	queue->fill_target = max_len;
+	queue->last_reload = jiffies;
 	if (fill_now) {
 		for (i = 0; i < queue->max_len; i++) {
 			struct sk_buff *skb = __alloc_skb_from_kernel(skb_size, GFP_KERNEL);
@@ -512,47 +524,90 @@ void ccci_free_skb(struct sk_buff *skb, DATA_POLICY policy)
 }
 EXPORT_SYMBOL(ccci_free_skb);
 
-static void __4K_reload_work(struct work_struct *work)
+/*
+ * page fragment buffers come from the per-CPU netdev frag cache, whose pages are reused once all skbs
+ * built on them are freed. may return NULL, caller should check.
+ */
+void *ccci_alloc_rx_frag(int pkt_size, char blocking)
 {
-	struct sk_buff *skb;
+	unsigned int frag_size = ccci_rx_frag_size(pkt_size);
+	void *buf;
+	int count = 0;
 
-	CCCI_DBG_MSG(-1, BM, "refill 4KB skb pool\n");
-	while (skb_pool_4K.skb_list.qlen < SKB_POOL_SIZE_4K) {
-		skb = __alloc_skb_from_kernel(SKB_4K, GFP_KERNEL);
-		if (skb)
-			skb_queue_tail(&skb_pool_4K.skb_list, skb);
-		else
-			CCCI_ERR_MSG(-1, BM, "fail to reload 4KB pool\n");
-	}
+	if (pkt_size <= 0 || frag_size > PAGE_SIZE)
+		return NULL;
+ retry:
+	buf = netdev_alloc_frag(frag_size);
+	if (unlikely(!buf) && count++ < 20) {
+		if (blocking)
+			msleep(10);
+		goto retry;
+	}
+	if (unlikely(!buf))
+		CCCI_ERR_MSG(-1, BM, "%ps alloc frag fail, size=%d\n", __builtin_return_address(0), pkt_size);
+	return buf;
 }
+EXPORT_SYMBOL(ccci_alloc_rx_frag);
 
-static void __1_5K_reload_work(struct work_struct *work)
+void ccci_free_rx_frag(void *buf)
+{
+	put_page(virt_to_head_page(buf));
+}
+EXPORT_SYMBOL(ccci_free_rx_frag);
+
+/* buffer is owned by the returned skb, it is untouched if NULL is returned */
+struct sk_buff *ccci_build_rx_skb(void *buf, int pkt_size, int len)
 {
 	struct sk_buff *skb;
 
-	CCCI_DBG_MSG(-1, BM, "refill 1.5KB skb pool\n");
-	while (skb_pool_1_5K.skb_list.qlen < SKB_POOL_SIZE_1_5K) {
-		skb = __alloc_skb_from_kernel(SKB_1_5K, GFP_KERNEL);
-		if (skb)
-			skb_queue_tail(&skb_pool_1_5K.skb_list, skb);
-		else
-			CCCI_ERR_MSG(-1, BM, "fail to reload 1.5KB pool\n");
+	skb = build_skb(buf, ccci_rx_frag_size(pkt_size));
+	if (unlikely(!skb))
+		return NULL;
+	skb_reserve(skb, CCCI_RX_FRAG_HEADROOM);
+	skb_put(skb, len);
+	return skb;
+}
+EXPORT_SYMBOL(ccci_build_rx_skb);
 
+static void __pool_reload(struct ccci_skb_queue *queue, int skb_size)
+{
+	struct sk_buff *skb;
+	unsigned long now = jiffies;
+	unsigned int target = queue->fill_target;
+
+	if (skb_queue_empty(&queue->skb_list) || time_before(now, queue->last_reload + POOL_GROW_INTERVAL))
+		target = min(target * 2, queue->max_len);
+	else if (time_after(now, queue->last_reload + POOL_SHRINK_INTERVAL))
+		target = max(target / 2, queue->max_len / POOL_MIN_DIV);
+	queue->fill_target = target;
+	queue->last_reload = now;
+
+	while (queue->skb_list.qlen < queue->fill_target) {
+		skb = __alloc_skb_from_kernel(skb_size, GFP_KERNEL);
+		if (!skb) {
+			CCCI_ERR_MSG(-1, BM, "fail to reload %d pool\n", skb_size);
+			break;
+		}
+		skb_queue_tail(&queue->skb_list, skb);
 	}
 }
 
-static void __16_reload_work(struct work_struct *work)
+static void __4K_reload_work(struct work_struct *work)
 {
-	struct sk_buff *skb;
+	CCCI_DBG_MSG(-1, BM, "refill 4KB skb pool to %d\n", skb_pool_4K.fill_target);
+	__pool_reload(&skb_pool_4K, SKB_4K);
+}
 
-	CCCI_DBG_MSG(-1, BM, "refill 16B skb pool\n");
-	while (skb_pool_16.skb_list.qlen < SKB_POOL_SIZE_16) {
-		skb = __alloc_skb_from_kernel(SKB_16, GFP_KERNEL);
-		if (skb)
-			skb_queue_tail(&skb_pool_16.skb_list, skb);
-		else
-			CCCI_ERR_MSG(-1, BM, "fail to reload 16B pool\n");
-	}
+static void __1_5K_reload_work(struct work_struct *work)
+{
+	CCCI_DBG_MSG(-1, BM, "refill 1.5KB skb pool to %d\n", skb_pool_1_5K.fill_target);
+	__pool_reload(&skb_pool_1_5K, SKB_1_5K);
+}
+
+static void __16_reload_work(struct work_struct *work)
+{
+	CCCI_DBG_MSG(-1, BM, "refill 16B skb pool to %d\n", skb_pool_16.fill_target);
+	__pool_reload(&skb_pool_16, SKB_16);
 }
 
 /*
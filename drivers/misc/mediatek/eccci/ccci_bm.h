@@ -24,6 +24,14 @@
 #define skb_data_size(x) ((x)->end - (x)->data)
 #endif
 
+/*
+ * page fragment Rx buffer: [headroom][pkt_size for DMA][skb_shared_info], the sk_buff is only
+ * built around it (build_skb) after a packet has been received into the buffer.
+ */
+#define CCCI_RX_FRAG_HEADROOM NET_SKB_PAD
+#define ccci_rx_frag_size(pkt_size) \
+	(SKB_DATA_ALIGN(CCCI_RX_FRAG_HEADROOM + (pkt_size)) + SKB_DATA_ALIGN(sizeof(struct skb_shared_info)))
+
 struct ccci_req_queue {
 	unsigned int magic_header;
 	struct list_head req_list;
@@ -40,6 +48,8 @@ struct ccci_skb_queue {
 	unsigned int max_len;
 	struct work_struct reload_work;
 	unsigned char pre_filled;
+	unsigned int fill_target; /* pre-filled pool: reload level following the traffic, <= max_len */
+	unsigned long last_reload;
 	unsigned int max_history;
 	unsigned int magic_footer;
 };
@@ -47,6 +57,10 @@ struct ccci_skb_queue {
 struct sk_buff *ccci_alloc_skb(int size, char from_pool, char blocking);
 void ccci_free_skb(struct sk_buff *skb, DATA_POLICY policy);
 
+void *ccci_alloc_rx_frag(int pkt_size, char blocking);
+void ccci_free_rx_frag(void *buf);
+struct sk_buff *ccci_build_rx_skb(void *buf, int pkt_size, int len);
+
 struct sk_buff *ccci_skb_dequeue(struct ccci_skb_queue *queue);
 void ccci_skb_enqueue(struct ccci_skb_queue *queue, struct sk_buff *newsk);
 void ccci_skb_queue_init(struct ccci_skb_queue *queue, unsigned int skb_size, unsigned int max_len,
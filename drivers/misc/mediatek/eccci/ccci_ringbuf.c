@@ -3,6 +3,7 @@
 #include <linux/sched.h>
 #include <linux/delay.h>
 #include <linux/module.h>
+#include <linux/io.h>
 #include "ccci_ringbuf.h"
 #include "ccci_debug.h"
 
@@ -16,68 +17,56 @@
 #define CCIF_PKG_HEADER 0xAABBAABB
 #define CCIF_PKG_FOOTER 0xCCDDEEFF
 
-static inline void *rbf_memcpy(void *__dest, __const void *__src, size_t __n)
-{
-	int i = 0;
-	unsigned char *d = (unsigned char *)__dest, *s = (unsigned char *)__src;
-
-	for (i = __n >> 3; i > 0; i--) {
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-	}
-
-	if (__n & 1 << 2) {
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-	}
-
-	if (__n & 1 << 1) {
-		*d++ = *s++;
-		*d++ = *s++;
-	}
-
-	if (__n & 1)
-		*d++ = *s++;
-
-	return __dest;
-}
-
-/* #define rbf_memcpy memcpy */
+/*
+ * rx and tx are each a single-producer/single-consumer ring shared with modem, no lock is taken here
+ * (callers serialize their own side, one reader and one writer per direction):
+ * -producer fills the packet and publishes it by storing write pointer after a write barrier
+ * -consumer loads write pointer, then reads the packet after a read barrier
+ * -consumer finishes reading the packet before it gives the space back by storing read pointer
+ * the other side is modem, so mandatory barriers are used instead of the smp_ ones.
+ *
+ * ring is mapped as device memory, use the io copy helpers which do aligned word access.
+ */
 #define CCIF_RBF_READ(bufaddr, output_addr, read_size, read_pos, buflen)\
 	do {\
 		if (read_pos + read_size < buflen) {\
-			rbf_memcpy((unsigned char *)output_addr,\
+			memcpy_fromio((unsigned char *)output_addr,\
 				(unsigned char *)(bufaddr) + read_pos, read_size);\
 		} else {\
-			rbf_memcpy((unsigned char *)output_addr,\
+			memcpy_fromio((unsigned char *)output_addr,\
 					(unsigned char *)(bufaddr) + read_pos, buflen - read_pos);\
 			output_addr = (unsigned char *)output_addr + buflen - read_pos;\
-			rbf_memcpy((unsigned char *)output_addr, (unsigned char *)(bufaddr),\
+			memcpy_fromio((unsigned char *)output_addr, (unsigned char *)(bufaddr),\
 					read_size - (buflen - read_pos));\
 		} \
 	} while (0)
 #define CCIF_RBF_WRITE(bufaddr, data_addr, data_size, write_pos, buflen)\
 	do {\
 		if (write_pos + data_size < buflen) {\
-			rbf_memcpy((unsigned char *)(bufaddr) + write_pos,\
+			memcpy_toio((unsigned char *)(bufaddr) + write_pos,\
 					(unsigned char *)data_addr, data_size);\
 		} else {\
-			rbf_memcpy((unsigned char *)(bufaddr) + write_pos,\
+			memcpy_toio((unsigned char *)(bufaddr) + write_pos,\
 					(unsigned char *)data_addr ,  buflen - write_pos);\
 			data_addr = (unsigned char *)data_addr + buflen - write_pos;\
-			rbf_memcpy((unsigned char *)(bufaddr), (unsigned char *)data_addr,\
+			memcpy_toio((unsigned char *)(bufaddr), (unsigned char *)data_addr,\
 					data_size - (buflen - write_pos));\
 		} \
 	} while (0)
 
+/* header and footer are 8 byte aligned, so they only wrap if ring length is not */
+static inline void rbf_read_tag(unsigned char *buffer, unsigned int pos, unsigned int length, unsigned int *tag)
+{
+	unsigned char *outptr = (unsigned char *)tag;
+
+	if (likely(pos + 2 * sizeof(unsigned int) <= length)) {
+		tag[0] = *(volatile unsigned int *)(buffer + pos);
+		tag[1] = *(volatile unsigned int *)(buffer + pos + sizeof(unsigned int));
+	} else {
+		CCIF_RBF_READ(buffer, outptr, 2 * sizeof(unsigned int), pos, length);
+	}
+}
+
 static void ccci_ringbuf_dump(int md_id, unsigned char *title,
 			      unsigned char *buffer, unsigned int read,
 			      unsigned int length, int dump_size)
@@ -162,8 +151,8 @@ int ccci_ringbuf_writeable(int md_id, struct ccci_ringbuf *ringbuf, unsigned int
 		CCCI_ERR_MSG(md_id, TAG, "rbwb param error,ringbuf == NULL\n");
 		return -CCCI_RINGBUF_PARAM_ERR;
 	}
-	read = (unsigned int)(ringbuf->tx_control.read);
-	write = (unsigned int)(ringbuf->tx_control.write);
+	read = ACCESS_ONCE(ringbuf->tx_control.read);
+	write = ACCESS_ONCE(ringbuf->tx_control.write);
 	length = (unsigned int)(ringbuf->tx_control.length);
 	if (write_size > length) {
 		CCCI_ERR_MSG(md_id, TAG, "rbwb param error,writesize(%d) > length(%d)\n", write_size, length);
@@ -201,6 +190,8 @@ int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *d
 		return -CCCI_RINGBUF_PARAM_ERR;
 	if (ccci_ringbuf_writeable(md_id, ringbuf, data_len) <= 0)
 		return -CCCI_RINGBUF_NOT_ENOUGH;
+	/* do not overwrite the space before modem's read of it is done */
+	mb();
 	read = (unsigned int)(ringbuf->tx_control.read);
 	write = (unsigned int)(ringbuf->tx_control.write);
 	length = (unsigned int)(ringbuf->tx_control.length);
@@ -227,6 +218,8 @@ int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *d
 		     ringbuf, tx_buffer, ringbuf->tx_control.write, write,
 		     data_len, aligned_data_len, 16, length, ringbuf->tx_control.read);
 
+	/* publish the packet */
+	wmb();
 	ringbuf->tx_control.write = write;
 
 	return data_len;
@@ -234,7 +227,7 @@ int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *d
 
 int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 {
-	unsigned char *rx_buffer, *outptr;
+	unsigned char *rx_buffer;
 	unsigned int read, write, ccci_pkg_len, ccif_pkg_len;
 	unsigned int footer_pos, length;
 	unsigned int header[2] = { 0 };
@@ -246,7 +239,9 @@ int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 		return -CCCI_RINGBUF_PARAM_ERR;
 	}
 	read = (unsigned int)(ringbuf->rx_control.read);
-	write = (unsigned int)(ringbuf->rx_control.write);
+	write = ACCESS_ONCE(ringbuf->rx_control.write);
+	/* packet content is only read after write pointer */
+	rmb();
 	length = (unsigned int)(ringbuf->rx_control.length);
 	rx_buffer = ringbuf->buffer;
 	size = write - read;
@@ -257,8 +252,7 @@ int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 		     "rbrdb:rbf=%p,rx_buf=0x%p,read=%d,write=%d,len=%d\n", ringbuf, rx_buffer, read, write, length);
 	if (size < CCIF_HEADER_LEN + CCIF_FOOTER_LEN + CCCI_HEADER_LEN)
 		return -CCCI_RINGBUF_EMPTY;
-	outptr = (unsigned char *)header;
-	CCIF_RBF_READ(rx_buffer, outptr, CCIF_HEADER_LEN, read, length);
+	rbf_read_tag(rx_buffer, read, length, header);
 	if (header[0] != CCIF_PKG_HEADER) {
 		CCCI_INF_MSG(md_id, TAG,
 			     "rbrdb:rbf=%p,rx_buf=0x%p,read=%d,write=%d,len=%d\n",
@@ -279,8 +273,7 @@ int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 	footer_pos = read + ccif_pkg_len - CCIF_FOOTER_LEN;
 	if (footer_pos >= length)
 		footer_pos -= length;
-	outptr = (unsigned char *)footer;
-	CCIF_RBF_READ(rx_buffer, outptr, CCIF_FOOTER_LEN, footer_pos, length);
+	rbf_read_tag(rx_buffer, footer_pos, length, footer);
 	if (footer[0] != CCIF_PKG_FOOTER || footer[1] != CCIF_PKG_FOOTER) {
 		CCCI_ERR_MSG(md_id, TAG,
 			     "rbrdb:ccif_pkg_len=0x%x,footer_pos=0x%x, footer 0x%x %x!=0xCCDDEEFF CCDDEEFF\n",
@@ -291,14 +284,42 @@ int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 	return ccci_pkg_len;
 }
 
+/*
+ * read-in-place, for a packet already checked by ccci_ringbuf_readable(): point @data to its payload
+ * inside the ring. data stays valid until ccci_ringbuf_move_rpointer(). a payload wrapping around the
+ * end of ring can not be returned in place, -CCCI_RINGBUF_NOT_COMPLETE is returned and the caller
+ * should use ccci_ringbuf_read() instead.
+ */
+int ccci_ringbuf_peek(int md_id, struct ccci_ringbuf *ringbuf, unsigned char **data, int read_size)
+{
+	unsigned int read, length;
+
+	if (ringbuf == NULL || read_size == 0 || data == NULL)
+		return -CCCI_RINGBUF_PARAM_ERR;
+	read = (unsigned int)(ringbuf->rx_control.read);
+	length = (unsigned int)(ringbuf->rx_control.length);
+	/* skip header */
+	read += CCIF_HEADER_LEN;
+	if (read >= length)
+		read -= length;
+	if (read + read_size > length)
+		return -CCCI_RINGBUF_NOT_COMPLETE;
+	*data = ringbuf->buffer + read;
+	return read_size;
+}
+
 int ccci_ringbuf_read(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *buf, int read_size)
 {
-	unsigned int read, write, length;
+	unsigned int read, length;
+	unsigned char *data;
 
 	if (ringbuf == NULL || read_size == 0 || buf == NULL)
 		return -CCCI_RINGBUF_PARAM_ERR;
+	if (ccci_ringbuf_peek(md_id, ringbuf, &data, read_size) == read_size) {
+		memcpy_fromio(buf, data, read_size);
+		return read_size;
+	}
 	read = (unsigned int)(ringbuf->rx_control.read);
-	write = (unsigned int)(ringbuf->rx_control.write);
 	length = (unsigned int)(ringbuf->rx_control.length);
 	/* skip header */
 	read += CCIF_HEADER_LEN;
@@ -321,6 +342,8 @@ void ccci_ringbuf_move_rpointer(int md_id, struct ccci_ringbuf *ringbuf, int rea
 	read = (((read + 7) >> 3) << 3);
 	if (read >= length)
 		read -= length;
+	/* all reads of the packet are done before modem can reuse the space */
+	mb();
 	ringbuf->rx_control.read = read;
 }
 
@@ -24,6 +24,7 @@ struct ccci_ringbuf {
 int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf);
 int ccci_ringbuf_writeable(int md_id, struct ccci_ringbuf *ringbuf, unsigned int write_size);
 struct ccci_ringbuf *ccci_create_ringbuf(int md_id, unsigned char *buf, int buf_size, int rx_size, int tx_size);
+int ccci_ringbuf_peek(int md_id, struct ccci_ringbuf *ringbuf, unsigned char **data, int read_size);
 int ccci_ringbuf_read(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *buf, int read_size);
 int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *data, int data_len);
 void ccci_ringbuf_move_rpointer(int md_id, struct ccci_ringbuf *ringbuf, int read_size);
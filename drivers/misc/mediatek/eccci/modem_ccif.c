@@ -136,23 +136,26 @@ static void md_ccif_dump(unsigned char *title, struct ccci_modem *md)
 
 }
 
-static void md_ccif_sram_rx_work(struct work_struct *work)
+/*
+ * D2H_SRAM carries a bare ccci_header in the CCIF SRAM. It is read in place
+ * from the irq tasklet and handed to its port there, the ports' recv paths
+ * only take irq-safe spinlocks.
+ */
+static void md_ccif_sram_rx(struct ccci_modem *md)
 {
-	struct md_ccif_ctrl *md_ctrl = container_of(work, struct md_ccif_ctrl, ccif_sram_work);
-	struct ccci_modem *md = md_ctrl->rxq[0].modem;
+	struct md_ccif_ctrl *md_ctrl = (struct md_ccif_ctrl *)md->private_data;
 	struct ccci_header *dl_pkg = &md_ctrl->ccif_sram_layout->dl_header;
 	struct ccci_header *ccci_h;
-	struct ccci_request *new_req = NULL;
-	struct ccci_request *req;
+	struct ccci_request *new_req;
 	int pkg_size, ret = 0, retry_cnt = 0;
-	/* md_ccif_dump("md_ccif_sram_rx_work",md); */
+
 	pkg_size = sizeof(struct ccci_header);
-	new_req = ccci_alloc_req(IN, pkg_size, 1, 0);
-	INIT_LIST_HEAD(&new_req->entry);	/* as port will run list_del */
-	if (new_req->skb == NULL) {
-		CCCI_ERR_MSG(md->index, TAG, "md_ccif_sram_rx_work:ccci_alloc_req pkg_size=%d failed\n", pkg_size);
+	new_req = ccci_alloc_req(IN, pkg_size, 0, 0);
+	if (new_req == NULL) {
+		CCCI_ERR_MSG(md->index, TAG, "md_ccif_sram_rx:ccci_alloc_req pkg_size=%d failed\n", pkg_size);
 		return;
 	}
+	INIT_LIST_HEAD(&new_req->entry);	/* as port will run list_del */
 	skb_put(new_req->skb, pkg_size);
 	ccci_h = (struct ccci_header *)new_req->skb->data;
 	ccci_h->data[0] = ccif_read32(&dl_pkg->data[0], 0);
@@ -163,25 +166,19 @@ static void md_ccif_sram_rx_work(struct work_struct *work)
 	if (atomic_cmpxchg(&md->wakeup_src, 1, 0) == 1)
 		CCCI_INF_MSG(md->index, TAG, "CCIF_MD wakeup source:(SRX_IDX/%d)\n", *(((u32 *) ccci_h) + 2));
 
- RETRY:
-	ret = ccci_port_recv_request(md, new_req, new_req->skb);
+	do {
+		ret = ccci_port_recv_request(md, new_req, new_req->skb);
+		if (ret != -CCCI_ERR_PORT_RX_FULL)
+			break;
+		udelay(5);
+	} while (++retry_cnt < 20);
 	CCCI_INF_MSG(md->index, TAG, "Rx msg %x %x %x %x ret=%d\n", ccci_h->data[0], ccci_h->data[1],
 		     *(((u32 *) ccci_h) + 2), ccci_h->reserved, ret);
-	if (ret >= 0 || ret == -CCCI_ERR_DROP_PACKET) {
-		CCCI_INF_MSG(md->index, TAG, "md_ccif_sram_rx_work:ccci_port_recv_request ret=%d\n", ret);
-		/* step forward */
-		req = list_entry(req->entry.next, struct ccci_request, entry);
-	} else {
-		if (retry_cnt > 20) {
-			CCCI_ERR_MSG(md->index, TAG, "md_ccif_sram_rx_work:ccci_port_recv_request ret=%d,retry=%d\n",
-				     ret, retry_cnt);
-			udelay(5);
-			retry_cnt++;
-			goto RETRY;
-		}
+	if (ret == -CCCI_ERR_PORT_RX_FULL) {
+		CCCI_ERR_MSG(md->index, TAG, "md_ccif_sram_rx:ccci_port_recv_request ret=%d,retry=%d\n",
+			     ret, retry_cnt);
 		list_del(&new_req->entry);
 		ccci_free_req(new_req);
-		CCCI_INF_MSG(md->index, TAG, "md_ccif_sram_rx_work:ccci_port_recv_request ret=%d\n", ret);
 	}
 }
 
@@ -408,42 +405,42 @@ static void md_ccif_irq_tasklet(unsigned long data)
 {
 	struct ccci_modem *md = (struct ccci_modem *)data;
 	struct md_ccif_ctrl *md_ctrl = (struct md_ccif_ctrl *)md->private_data;
-	int i;
-
-	CCCI_DBG_MSG(md->index, TAG, "ccif_irq_tasklet1: ch %ld\n", md_ctrl->channel_id);
-	while (md_ctrl->channel_id != 0) {
-		if (md_ctrl->channel_id & (1 << D2H_EXCEPTION_INIT)) {
-			clear_bit(D2H_EXCEPTION_INIT, &md_ctrl->channel_id);
-			md_ccif_exception(md, HIF_EX_INIT);
-		}
-		if (md_ctrl->channel_id & (1 << D2H_EXCEPTION_INIT_DONE)) {
-			clear_bit(D2H_EXCEPTION_INIT_DONE, &md_ctrl->channel_id);
-			md_ccif_exception(md, HIF_EX_INIT_DONE);
-		}
-		if (md_ctrl->channel_id & (1 << D2H_EXCEPTION_CLEARQ_DONE)) {
-			clear_bit(D2H_EXCEPTION_CLEARQ_DONE, &md_ctrl->channel_id);
-			md_ccif_exception(md, HIF_EX_CLEARQ_DONE);
-		}
-		if (md_ctrl->channel_id & (1 << D2H_EXCEPTION_ALLQ_RESET)) {
-			clear_bit(D2H_EXCEPTION_ALLQ_RESET, &md_ctrl->channel_id);
-			md_ccif_exception(md, HIF_EX_ALLQ_RESET);
-		}
-		if (md_ctrl->channel_id & (1 << AP_MD_SEQ_ERROR)) {
-			clear_bit(AP_MD_SEQ_ERROR, &md_ctrl->channel_id);
-			CCCI_ERR_MSG(md->index, TAG, "MD check seq fail\n");
-			md->ops->dump_info(md, DUMP_FLAG_CCIF, NULL, 0);
-		}
-		if (md_ctrl->channel_id & (1 << (D2H_SRAM))) {
-			clear_bit(D2H_SRAM, &md_ctrl->channel_id);
-			schedule_work(&md_ctrl->ccif_sram_work);
-		}
-		for (i = 0; i < QUEUE_NUM; i++) {
-			if (md_ctrl->channel_id & (1 << (i + D2H_RINGQ0))) {
-				clear_bit(i + D2H_RINGQ0, &md_ctrl->channel_id);
+	unsigned long pending;
+	int ch, i;
+
+	/* take what the ISR has latched so far, doorbells rung meanwhile reschedule us */
+	while ((pending = xchg(&md_ctrl->channel_id, 0)) != 0) {
+		CCCI_DBG_MSG(md->index, TAG, "ccif_irq_tasklet: ch %lx\n", pending);
+		for_each_set_bit(ch, &pending, BITS_PER_LONG) {
+			switch (ch) {
+			case D2H_EXCEPTION_INIT:
+				md_ccif_exception(md, HIF_EX_INIT);
+				break;
+			case D2H_EXCEPTION_INIT_DONE:
+				md_ccif_exception(md, HIF_EX_INIT_DONE);
+				break;
+			case D2H_EXCEPTION_CLEARQ_DONE:
+				md_ccif_exception(md, HIF_EX_CLEARQ_DONE);
+				break;
+			case D2H_EXCEPTION_ALLQ_RESET:
+				md_ccif_exception(md, HIF_EX_ALLQ_RESET);
+				break;
+			case AP_MD_SEQ_ERROR:
+				CCCI_ERR_MSG(md->index, TAG, "MD check seq fail\n");
+				md->ops->dump_info(md, DUMP_FLAG_CCIF, NULL, 0);
+				break;
+			case D2H_SRAM:
+				md_ccif_sram_rx(md);
+				break;
+			default:
+				if (ch < D2H_RINGQ0 || ch >= D2H_RINGQ0 + QUEUE_NUM)
+					break;
+				i = ch - D2H_RINGQ0;
 				if (md_ctrl->rxq[i].rx_on_going != 0) {
+					/* the running collect loop picks this doorbell up */
 					CCCI_DBG_MSG(md->index, TAG, "Q%d rx is on-going(%d)2\n", md_ctrl->rxq[i].index,
 						     md_ctrl->rxq[i].rx_on_going);
-					return;
+					break;
 				}
 				if (md->md_state != EXCEPTION && (md->capability & MODEM_CAP_NAPI)
 				    && md_ctrl->rxq[i].napi_port
@@ -453,9 +450,9 @@ static void md_ccif_irq_tasklet(unsigned long data)
 				} else {
 					queue_work(md_ctrl->rxq[i].worker, &md_ctrl->rxq[i].qwork);
 				}
+				break;
 			}
 		}
-		CCCI_DBG_MSG(md->index, TAG, "ccif_irq_tasklet2: ch %ld\n", md_ctrl->channel_id);
 	}
 }
 
@@ -463,14 +460,17 @@ static irqreturn_t md_ccif_isr(int irq, void *data)
 {
 	struct ccci_modem *md = (struct ccci_modem *)data;
 	struct md_ccif_ctrl *md_ctrl = (struct md_ccif_ctrl *)md->private_data;
-	unsigned int ch_id;
+	unsigned long ch_id;
+	int ch;
 	/* disable_irq_nosync(md_ctrl->ccif_irq_id); */
 	/* must ack first, otherwise IRQ will rush in */
 	ch_id = ccif_read32(md_ctrl->ccif_ap_base, APCCIF_RCHNUM);
-	md_ctrl->channel_id |= ch_id;
 	ccif_write32(md_ctrl->ccif_ap_base, APCCIF_ACK, ch_id);
+	/* the tasklet may be draining on another cpu, latch each doorbell atomically */
+	for_each_set_bit(ch, &ch_id, 32)
+		set_bit(ch, &md_ctrl->channel_id);
 	/* enable_irq(md_ctrl->ccif_irq_id); */
-	CCCI_DBG_MSG(md->index, TAG, "MD CCIF IRQ %ld\n", md_ctrl->channel_id);
+	CCCI_DBG_MSG(md->index, TAG, "MD CCIF IRQ %lx\n", ch_id);
 	tasklet_hi_schedule(&md_ctrl->ccif_irq_task);
 
 	return IRQ_HANDLED;
@@ -1139,7 +1139,6 @@ static int md_ccif_probe(struct platform_device *dev)
 	snprintf(md_ctrl->wakelock_name, sizeof(md_ctrl->wakelock_name), "md%d_ccif_trm", md_id + 1);
 	wake_lock_init(&md_ctrl->trm_wake_lock, WAKE_LOCK_SUSPEND, md_ctrl->wakelock_name);
 	tasklet_init(&md_ctrl->ccif_irq_task, md_ccif_irq_tasklet, (unsigned long)md);
-	INIT_WORK(&md_ctrl->ccif_sram_work, md_ccif_sram_rx_work);
 	md_ctrl->channel_id = 0;
 
 	/* register modem */
@@ -1150,6 +1149,7 @@ static int md_ccif_probe(struct platform_device *dev)
 	md_ccif_ring_buf_init(md);
 	/* hoop up to device */
 	dev->dev.platform_data = md;
+	device_enable_async_suspend(&dev->dev);
 
 	return 0;
 }
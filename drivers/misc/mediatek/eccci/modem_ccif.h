@@ -4,6 +4,7 @@
 #include <linux/wakelock.h>
 #include <linux/dmapool.h>
 #include <linux/atomic.h>
+#include <linux/netdevice.h>
 #include <mt-plat/mt_ccci_common.h>
 #include "ccci_config.h"
 #include "ccci_ringbuf.h"
@@ -11,6 +12,13 @@
 
 #define QUEUE_NUM   8
 
+/*
+ * ENABLE_CCIF_RX_NAPI: collect the net Rx queue of the C2K modem in a per-queue NAPI instead of
+ *	the rx work, skbs come from the CCCI pool. same as ENABLE_CLDMA_RX_NAPI, not used if modem
+ *	has MODEM_CAP_NAPI.
+ */
+#define ENABLE_CCIF_RX_NAPI
+
 struct ccif_sram_layout {
 	struct ccci_header dl_header;
 	struct md_query_ap_feature md_rt_data;
@@ -33,6 +41,10 @@ struct md_ccif_queue {
 	wait_queue_head_t req_wq;	/* only for Tx */
 	struct work_struct qwork;
 	struct workqueue_struct *worker;
+#ifdef ENABLE_CCIF_RX_NAPI
+	struct napi_struct napi;
+	unsigned char rx_napi;	/* Rx doorbell is handled by napi */
+#endif
 };
 
 struct md_ccif_ctrl {
@@ -59,6 +71,9 @@ struct md_ccif_ctrl {
 	void __iomem *md_boot_slave_En;
 
 	struct md_hw_info *hw_info;
+#ifdef ENABLE_CCIF_RX_NAPI
+	struct net_device napi_dev;	/* dummy device to host queue napi */
+#endif
 };
 /* always keep this in mind: what if there are more than 1 modems using CLDMA... */
 
@@ -459,7 +459,7 @@ static int ccif_rx_collect(struct md_ccif_queue *queue, int budget,
 			goto OUT;
 		}
 		if (IS_PASS_SKB(md, qno)) {
-			skb = ccci_alloc_skb(pkg_size, 0, blocking);
+			skb = ccci_alloc_skb(pkg_size, 1, blocking);
 			if (skb == NULL) {
 				ret = -ENOMEM;
 				goto OUT;
@@ -592,6 +592,33 @@ static void ccif_rx_work(struct work_struct *work)
 	}
 }
 
+#ifdef ENABLE_CCIF_RX_NAPI
+/*
+ * NAPI poll of the net Rx queue, packets go to ccmni from softirq with pooled skbs like the CLDMA
+ * net queues do. when the pool runs dry or a port is full, the rx work takes over with blocking
+ * allocation.
+ */
+static int ccif_net_rx_poll(struct napi_struct *napi, int budget)
+{
+	struct md_ccif_queue *queue = container_of(napi, struct md_ccif_queue, napi);
+	struct ccci_modem *md = queue->modem;
+	int ret, result = 0;
+
+	/* collect stops at budget + 1 */
+	ret = ccif_rx_collect(queue, budget - 1, 0, &result);
+	if (ret == -EAGAIN && result > 0)
+		return budget;
+	napi_complete(napi);
+	if (ret == -EAGAIN || ret == -ENOMEM || ret == -CCCI_ERR_PORT_RX_FULL)
+		/* no progress: pool empty, port full or the rx work is collecting */
+		queue_work(queue->worker, &queue->qwork);
+	else if (ccci_ringbuf_readable(md->index, queue->ringbuf) > 0)
+		/* the doorbell of a packet written after collect found the ring empty */
+		napi_schedule(napi);
+	return result < budget ? result : budget - 1;
+}
+#endif
+
 static irqreturn_t md_cd_wdt_isr(int irq, void *data)
 {
 	struct ccci_modem *md = (struct ccci_modem *)data;
@@ -797,6 +824,10 @@ static void md_ccif_irq_tasklet(unsigned long data)
 								 rxq
 								 [i].napi_port,
 								 RX_IRQ);
+#ifdef ENABLE_CCIF_RX_NAPI
+				} else if (md->md_state != EXCEPTION && md_ctrl->rxq[i].rx_napi) {
+					napi_schedule(&md_ctrl->rxq[i].napi);
+#endif
 				} else {
 					queue_work(md_ctrl->rxq[i].worker,
 						   &md_ctrl->rxq[i].qwork);
@@ -899,6 +930,16 @@ static int md_ccif_op_init(struct ccci_modem *md)
 		}
 	}
 	ccci_setup_channel_mapping(md);
+#ifdef ENABLE_CCIF_RX_NAPI
+	init_dummy_netdev(&md_ctrl->napi_dev);
+	for (i = 0; i < QUEUE_NUM; i++) {
+		if (!((1 << i) & NET_RX_QUEUE_MASK) || md_ctrl->rxq[i].napi_port)
+			continue;
+		netif_napi_add(&md_ctrl->napi_dev, &md_ctrl->rxq[i].napi, ccif_net_rx_poll, NAPI_POLL_WEIGHT);
+		napi_enable(&md_ctrl->rxq[i].napi);
+		md_ctrl->rxq[i].rx_napi = 1;
+	}
+#endif
 	/*update state */
 	md->md_state = GATED;
 
@@ -978,8 +1019,13 @@ static int md_ccif_op_stop(struct ccci_modem *md, unsigned int timeout)
 		     timeout);
 	ret = md_ccif_power_off(md, timeout);
 	CCCI_INF_MSG(md->index, TAG, "ccif modem is power off done, %d\n", ret);
-	for (idx = 0; idx < QUEUE_NUM; idx++)
+	for (idx = 0; idx < QUEUE_NUM; idx++) {
+#ifdef ENABLE_CCIF_RX_NAPI
+		if (md_ctrl->rxq[idx].rx_napi)
+			napi_synchronize(&md_ctrl->rxq[idx].napi);
+#endif
 		flush_work(&md_ctrl->rxq[idx].qwork);
+	}
 
 	CCCI_INF_MSG(md->index, TAG, "ccif flush_work done, %d\n", ret);
 	md_ccif_reset_queue(md);
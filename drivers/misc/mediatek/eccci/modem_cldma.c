@@ -53,6 +53,8 @@
 #if defined(ENABLE_32K_CLK_LESS)
 #include <mt-plat/mtk_rtc.h>
 #endif
+#include <mt-plat/mt_timer_coalesce.h>
+#include <mt-plat/mt_wq.h>
 
 static unsigned int trace_sample_time = 200000000;
 static int md_cd_ccif_send(struct ccci_modem *md, int channel_id);
@@ -205,6 +207,8 @@ static void cldma_dump_all_gpd(struct ccci_modem *md)
 }
 
 #if TRAFFIC_MONITOR_INTERVAL
+static DEFINE_MT_CTIMER_SRC(md_cd_traffic_ctimer_src, "ccci_traffic", 1000);
+
 void md_cd_traffic_monitor_func(unsigned long data)
 {
 	struct ccci_modem *md = (struct ccci_modem *)data;
@@ -213,6 +217,7 @@ void md_cd_traffic_monitor_func(unsigned long data)
 	unsigned long long port_full = 0;	/* hardcode, port number should not be larger than 64 */
 	unsigned int i;
 
+	mt_ctimer_fired(&md_cd_traffic_ctimer_src);
 	for (i = 0; i < md->port_number; i++) {
 		port = md->ports + i;
 		if (port->flags & PORT_F_RX_FULLED)
@@ -266,6 +271,17 @@ void md_cd_traffic_monitor_func(unsigned long data)
 			md_ctrl->rx_traffic_monitor[2], md_ctrl->rx_traffic_monitor[3],
 			md_ctrl->rx_traffic_monitor[4], md_ctrl->rx_traffic_monitor[5],
 			md_ctrl->rx_traffic_monitor[6], md_ctrl->rx_traffic_monitor[7]);
+#ifdef ENABLE_CLDMA_RX_COALESCE
+	for (i = 0; i < QUEUE_LEN(md_ctrl->rxq); i++) {
+		if (!md_ctrl->rxq[i].rx_napi)
+			continue;
+		CCCI_INF_MSG(md->index, TAG, "net Rx coalesce: rxq%d irq=%u timer=%u rate=%u coal=%d\n", i,
+			     md_ctrl->rxq[i].rx_irq_cnt, md_ctrl->rxq[i].rx_coal_cnt, md_ctrl->rxq[i].rx_rate,
+			     md_ctrl->rxq[i].rx_coal);
+		md_ctrl->rxq[i].rx_irq_cnt = 0;
+		md_ctrl->rxq[i].rx_coal_cnt = 0;
+	}
+#endif
 	CCCI_INF_MSG(md->index, TAG, "net Rx skb queue:%u %u %u / %u %u %u\n",
 			 md_ctrl->rxq[3].skb_list.max_history, md_ctrl->rxq[4].skb_list.max_history,
 			 md_ctrl->rxq[5].skb_list.max_history, md_ctrl->rxq[3].skb_list.skb_list.qlen,
@@ -363,13 +379,46 @@ static void cldma_timeout_timer_func(unsigned long data)
 }
 #endif
 
+/* allocate and map a Rx buffer for @ring: a page fragment on rx_frag ring, otherwise an skb */
+static void *cldma_rx_buf_alloc(struct ccci_modem *md, struct cldma_ring *ring, char from_pool, char blocking,
+				dma_addr_t *dma)
+{
+	struct sk_buff *skb;
+	void *buf;
+
+	if (ring->rx_frag) {
+		buf = ccci_alloc_rx_frag(ring->pkt_size, blocking);
+		if (buf)
+			*dma = dma_map_single(&md->plat_dev->dev, buf + CCCI_RX_FRAG_HEADROOM, ring->pkt_size,
+					      DMA_FROM_DEVICE);
+		return buf;
+	}
+	skb = ccci_alloc_skb(ring->pkt_size, from_pool, blocking);
+	if (skb)
+		*dma = dma_map_single(&md->plat_dev->dev, skb->data, skb_data_size(skb), DMA_FROM_DEVICE);
+	return skb;
+}
+
+static inline void cldma_rx_buf_attach(struct cldma_ring *ring, struct cldma_request *req, void *buf)
+{
+	if (ring->rx_frag)
+		req->rx_buf = buf;
+	else
+		req->skb = buf;
+}
+
+static inline int cldma_rx_req_has_buf(struct cldma_request *req)
+{
+	return req->skb || req->rx_buf;
+}
+
 static int cldma_gpd_rx_refill(struct md_cd_queue *queue)
 {
 	struct ccci_modem *md = queue->modem;
 	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
 	struct cldma_request *req;
 	struct cldma_rgpd *rgpd;
-	struct sk_buff *new_skb = NULL;
+	void *new_buf = NULL;
 	int count = 0;
 	unsigned long flags;
 	char is_net_queue = IS_NET_QUE(md, queue->index);
@@ -377,17 +426,15 @@ static int cldma_gpd_rx_refill(struct md_cd_queue *queue)
 	while (1) {
 		spin_lock_irqsave(&queue->ring_lock, flags);
 		req = queue->rx_refill;
-		if (req->skb != NULL) {
+		if (cldma_rx_req_has_buf(req)) {
 			spin_unlock_irqrestore(&queue->ring_lock, flags);
 			break;
 		}
 		spin_unlock_irqrestore(&queue->ring_lock, flags);
 		/* allocate a new skb outside of lock */
-		new_skb = ccci_alloc_skb(queue->tr_ring->pkt_size, !is_net_queue, 1);
-		if (likely(new_skb)) {
+		new_buf = cldma_rx_buf_alloc(md, queue->tr_ring, !is_net_queue, 1, &req->data_buffer_ptr_saved);
+		if (likely(new_buf)) {
 			rgpd = (struct cldma_rgpd *)req->gpd;
-			req->data_buffer_ptr_saved =
-			    dma_map_single(&md->plat_dev->dev, new_skb->data, skb_data_size(new_skb), DMA_FROM_DEVICE);
 			rgpd->data_buff_bd_ptr = (u32) (req->data_buffer_ptr_saved);
 			rgpd->data_buff_len = 0;
 			/* checksum of GPD */
@@ -397,7 +444,7 @@ static int cldma_gpd_rx_refill(struct md_cd_queue *queue)
 			spin_lock(&md_ctrl->cldma_timeout_lock);
 			cldma_write8(&rgpd->gpd_flags, 0, 0x81);
 			spin_unlock(&md_ctrl->cldma_timeout_lock);
-			req->skb = new_skb;
+			cldma_rx_buf_attach(queue->tr_ring, req, new_buf);
 			spin_unlock_irqrestore(&queue->ring_lock, flags);
 			/* step forward */
 			queue->rx_refill = cldma_ring_step_forward(queue->tr_ring, req);
@@ -558,6 +605,28 @@ static int cldma_gpd_rx_collect(struct md_cd_queue *queue, int budget, int block
 	return count;
 }
 
+static void cldma_net_rx_deliver(struct md_cd_queue *queue, struct sk_buff *skb)
+{
+	struct ccci_modem *md = queue->modem;
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	struct ccci_header *ccci_h = (struct ccci_header *)skb->data;
+
+	/* check wakeup source */
+	if (atomic_cmpxchg(&md->wakeup_src, 1, 0) == 1)
+		CCCI_INF_MSG(md->index, TAG, "CLDMA_MD wakeup source:(%d/%d)\n", queue->index, ccci_h->channel);
+	CCCI_DBG_MSG(md->index, TAG, "recv Rx msg (%x %x %x %x) rxq=%d len=%d\n",
+		     ccci_h->data[0], ccci_h->data[1], *(((u32 *)ccci_h) + 2), ccci_h->reserved, queue->index,
+		     skb->len);
+	/* update log */
+#if TRAFFIC_MONITOR_INTERVAL
+	md_ctrl->rx_traffic_monitor[queue->index]++;
+#endif
+	ccci_dump_log_add(md, IN, (int)queue->index, ccci_h, 0);
+	ccci_channel_update_packet_counter(md, ccci_h);
+
+	ccci_port_recv_request(md, NULL, skb);
+}
+
 /*
  * a no lock version for net queue, as net queue does not support flow control,
  * may be called from workqueue or NAPI context
@@ -570,7 +639,7 @@ static int cldma_gpd_net_rx_collect(struct md_cd_queue *queue, int budget, int b
 	struct cldma_request *req;
 	struct cldma_rgpd *rgpd;
 	struct sk_buff *skb = NULL;
-	struct sk_buff *new_skb = NULL;
+	void *new_buf = NULL;
 #ifdef CLDMA_TRACE
 	unsigned long long port_recv_time = 0;
 	unsigned long long skb_alloc_time = 0;
@@ -591,21 +660,40 @@ static int cldma_gpd_net_rx_collect(struct md_cd_queue *queue, int budget, int b
 #endif
 		req = queue->tr_done;
 		rgpd = (struct cldma_rgpd *)req->gpd;
-		if (!((rgpd->gpd_flags & 0x1) == 0 && req->skb))
+		if (!((rgpd->gpd_flags & 0x1) == 0 && cldma_rx_req_has_buf(req)))
 			break;
-		skb = req->skb;
+		if (req->rx_buf) {
+			/* shared info lies beyond the DMA area, safe to build skb before unmap */
+			skb = ccci_build_rx_skb(req->rx_buf, queue->tr_ring->pkt_size, rgpd->data_buff_len);
+			if (unlikely(!skb)) {
+				/* leave the packet in ring, collect it on next round */
+				*result = NO_SKB;
+				break;
+			}
+			dma_unmap_single(&md->plat_dev->dev, req->data_buffer_ptr_saved, queue->tr_ring->pkt_size,
+					 DMA_FROM_DEVICE);
+			req->rx_buf = NULL;
+		} else {
+			skb = req->skb;
+			req->skb = NULL;
+			/* update skb */
+			dma_unmap_single(&md->plat_dev->dev, req->data_buffer_ptr_saved, skb_data_size(skb),
+					 DMA_FROM_DEVICE);
+			skb_put(skb, rgpd->data_buff_len);
+		}
 		/* mark cldma_request as available */
-		req->skb = NULL;
 		rgpd->data_buff_bd_ptr = 0;
-		/* update skb */
-		dma_unmap_single(&md->plat_dev->dev, req->data_buffer_ptr_saved, skb_data_size(skb), DMA_FROM_DEVICE);
-		skb_put(skb, rgpd->data_buff_len);
 		skb_bytes = skb->len;
 		*rxbytes += skb_bytes;
 		ccci_chk_rx_seq_num(md, (struct ccci_header *)skb->data, queue->index);
 		/* upload skb */
 		if (using_napi) {
 			ccci_port_recv_request(md, NULL, skb);
+#ifdef ENABLE_CLDMA_RX_NAPI
+		} else if (queue->rx_napi) {
+			/* already in softirq of the steered CPU, no need to bounce to push thread */
+			cldma_net_rx_deliver(queue, skb);
+#endif
 		} else {
 			ccci_skb_enqueue(&queue->skb_list, skb);
 			wake_up_all(&queue->rx_wq);
@@ -617,13 +705,10 @@ static int cldma_gpd_net_rx_collect(struct md_cd_queue *queue, int budget, int b
 #endif
 		/* refill */
 		req = queue->rx_refill;
-		if (!req->skb) {
-			new_skb = ccci_alloc_skb(queue->tr_ring->pkt_size, 0, blocking);
-			if (likely(new_skb)) {
+		if (!cldma_rx_req_has_buf(req)) {
+			new_buf = cldma_rx_buf_alloc(md, queue->tr_ring, 0, blocking, &req->data_buffer_ptr_saved);
+			if (likely(new_buf)) {
 				rgpd = (struct cldma_rgpd *)req->gpd;
-				req->data_buffer_ptr_saved =
-				    dma_map_single(&md->plat_dev->dev, new_skb->data, skb_data_size(new_skb),
-									DMA_FROM_DEVICE);
 				rgpd->data_buff_bd_ptr = (u32) (req->data_buffer_ptr_saved);
 				rgpd->data_buff_len = 0;
 				/* checksum of GPD */
@@ -633,7 +718,7 @@ static int cldma_gpd_net_rx_collect(struct md_cd_queue *queue, int budget, int b
 				cldma_write8(&rgpd->gpd_flags, 0, 0x81);
 				spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
 				/* mark cldma_request as available */
-				req->skb = new_skb;
+				cldma_rx_buf_attach(queue->tr_ring, req, new_buf);
 				/* step forward */
 				queue->rx_refill = cldma_ring_step_forward(queue->tr_ring, req);
 			} else {
@@ -670,9 +755,9 @@ static int cldma_net_rx_push_thread(void *arg)
 {
 	struct sk_buff *skb = NULL;
 	struct md_cd_queue *queue = (struct md_cd_queue *)arg;
+#ifdef CCCI_SKB_TRACE
 	struct ccci_modem *md = queue->modem;
-	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
-	struct ccci_header *ccci_h;
+#endif
 	int count = 0;
 	int ret;
 
@@ -692,21 +777,7 @@ static int cldma_net_rx_push_thread(void *arg)
 		skb = ccci_skb_dequeue(&queue->skb_list);
 		if (!skb)
 			continue;
-		ccci_h = (struct ccci_header *)skb->data;
-		/* check wakeup source */
-		if (atomic_cmpxchg(&md->wakeup_src, 1, 0) == 1)
-			CCCI_INF_MSG(md->index, TAG, "CLDMA_MD wakeup source:(%d/%d)\n", queue->index, ccci_h->channel);
-		CCCI_DBG_MSG(md->index, TAG, "recv Rx msg (%x %x %x %x) rxq=%d len=%d\n",
-			     ccci_h->data[0], ccci_h->data[1], *(((u32 *)ccci_h) + 2), ccci_h->reserved, queue->index,
-			     skb->len);
-		/* update log */
-#if TRAFFIC_MONITOR_INTERVAL
-		md_ctrl->rx_traffic_monitor[queue->index]++;
-#endif
-		ccci_dump_log_add(md, IN, (int)queue->index, ccci_h, 0);
-		ccci_channel_update_packet_counter(md, ccci_h);
-
-		ccci_port_recv_request(md, NULL, skb);
+		cldma_net_rx_deliver(queue, skb);
 		count++;
 #ifdef CCCI_SKB_TRACE
 		md->netif_rx_profile[4] = sched_clock() - md->netif_rx_profile[4];
@@ -822,6 +893,113 @@ again:
 #endif
 }
 
+#ifdef ENABLE_CLDMA_RX_COALESCE
+/*
+ * called when NAPI of a net Rx queue completes, return 1 to keep its RX_DONE interrupt masked
+ * and poll again on rx_coal_timer. the rate is sampled on every completion over CLDMA_RX_RATE_WINDOW.
+ */
+static int cldma_rx_coal_check(struct md_cd_queue *queue, int count)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)queue->modem->private_data;
+	unsigned long now = jiffies;
+
+	queue->rx_rate_pkts += count;
+	if (time_after_eq(now, queue->rx_rate_stamp + CLDMA_RX_RATE_WINDOW)) {
+		queue->rx_rate = queue->rx_rate_pkts * HZ / (now - queue->rx_rate_stamp);
+		queue->rx_rate_pkts = 0;
+		queue->rx_rate_stamp = now;
+		if (queue->rx_rate >= md_ctrl->rx_coal_rate)
+			queue->rx_coal = 1;
+		else if (queue->rx_rate < md_ctrl->rx_coal_rate / 2)
+			queue->rx_coal = 0;
+	}
+	/* a timer poll got nothing, burst is over */
+	if (count == 0 || md_ctrl->rx_coal_usecs == 0)
+		queue->rx_coal = 0;
+	return queue->rx_coal;
+}
+
+static enum hrtimer_restart cldma_rx_coal_timer_func(struct hrtimer *timer)
+{
+	struct md_cd_queue *queue = container_of(timer, struct md_cd_queue, rx_coal_timer);
+
+	queue->rx_coal_cnt++;
+	napi_schedule(&queue->napi);
+	return HRTIMER_NORESTART;
+}
+#endif
+
+#ifdef ENABLE_CLDMA_RX_NAPI
+/*
+ * NAPI poll of a net Rx queue. collect and refill are done in one go with atomic allocation, only when
+ * allocation fails we fall back to refill work. RX_DONE interrupt of this queue stays masked until
+ * the ring is drained.
+ */
+static int cldma_net_rx_poll(struct napi_struct *napi, int budget)
+{
+	struct md_cd_queue *queue = container_of(napi, struct md_cd_queue, napi);
+	struct ccci_modem *md = queue->modem;
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	int count, result, rx_bytes, all_clr;
+	unsigned long flags;
+	unsigned int L2RISAR0;
+
+	/* collect returns budget + 1 when it stops for budget */
+	count = queue->tr_ring->handle_rx_done(queue, budget - 1, 0, &result, &rx_bytes);
+	all_clr = (result == UNDER_BUDGET);
+	if (unlikely(result == NO_SKB))
+		queue_work(queue->refill_worker, &queue->cldma_refill_work);
+	if (count > budget)
+		count = budget;
+	if (!all_clr)
+		return budget;
+
+	md_cd_lock_cldma_clock_src(1);
+	L2RISAR0 = cldma_read32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_L2RISAR0);
+	if (L2RISAR0 & CLDMA_BM_INT_DONE & (1 << queue->index)) {
+		/* new packets arrived while we were collecting, poll again */
+		cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_L2RISAR0, (1 << queue->index));
+		md_cd_lock_cldma_clock_src(0);
+		return budget;
+	}
+	napi_complete(napi);
+	spin_lock_irqsave(&md_ctrl->cldma_timeout_lock, flags);
+	if (md_ctrl->rxq_active & (1 << queue->index)) {
+#ifdef ENABLE_CLDMA_RX_COALESCE
+		if (cldma_rx_coal_check(queue, count))
+			hrtimer_start(&queue->rx_coal_timer, ns_to_ktime(md_ctrl->rx_coal_usecs * NSEC_PER_USEC),
+				      HRTIMER_MODE_REL);
+		else
+#endif
+		/* enable RX_DONE interrupt */
+		cldma_write32(md_ctrl->cldma_ap_ao_base, CLDMA_AP_L2RIMCR0, CLDMA_BM_ALL_QUEUE & (1 << queue->index));
+	}
+	spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
+	md_cd_lock_cldma_clock_src(0);
+	return count;
+}
+
+static void cldma_rx_napi_ipi(void *info)
+{
+	struct md_cd_queue *queue = (struct md_cd_queue *)info;
+
+	napi_schedule(&queue->napi);
+}
+
+/*
+ * called from CLDMA ISR with RX_DONE of this queue masked, so there is no other IPI for
+ * this queue in flight and rx_csd is always free here.
+ */
+static void cldma_rx_napi_schedule(struct md_cd_queue *queue)
+{
+	int cpu = ACCESS_ONCE(queue->rx_cpu);
+
+	if (cpu < 0 || cpu == smp_processor_id() || !cpu_online(cpu) ||
+	    smp_call_function_single_async(cpu, &queue->rx_csd))
+		napi_schedule(&queue->napi);
+}
+#endif
+
 /* this function may be called from both workqueue and ISR (timer) */
 static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int blocking, int *result)
 {
@@ -836,6 +1014,8 @@ static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int bl
 	int count = 0;
 	struct sk_buff *skb_free;
 	DATA_POLICY skb_free_p;
+	struct netdev_queue *txq, *bql_txq = NULL;
+	unsigned int bql_pkts = 0, bql_bytes = 0;
 
 	while (1) {
 		spin_lock_irqsave(&queue->ring_lock, flags);
@@ -862,8 +1042,10 @@ static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int bl
 		/* save skb reference */
 		skb_free = req->skb;
 		skb_free_p = req->policy;
+		txq = req->dev_queue;
 		/* mark cldma_request as available */
 		req->skb = NULL;
+		req->dev_queue = NULL;
 		/* step forward */
 		queue->tr_done = cldma_ring_step_forward(queue->tr_ring, req);
 		if (likely(md->capability & MODEM_CAP_TXBUSY_STOP))
@@ -876,11 +1058,26 @@ static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int bl
 			     ccci_h->data[0], ccci_h->data[1], *(((u32 *) ccci_h) + 2), ccci_h->reserved, queue->index,
 			     tgpd->data_buff_len);
 		ccci_channel_update_packet_counter(md, ccci_h);
+		if (txq) {
+			/* report BQL per netdev queue, one call for a run of packets of the same queue */
+			if (txq != bql_txq && bql_pkts) {
+				netdev_tx_completed_queue(bql_txq, bql_pkts, bql_bytes);
+				bql_pkts = bql_bytes = 0;
+			}
+			bql_txq = txq;
+			bql_pkts++;
+			bql_bytes += skb_free->len;
+		}
 		ccci_free_skb(skb_free, skb_free_p);
 #if TRAFFIC_MONITOR_INTERVAL
 		md_ctrl->tx_traffic_monitor[queue->index]++;
 #endif
+		/* budget 0 means no limit */
+		if (budget && count >= budget)
+			break;
 	}
+	if (bql_pkts)
+		netdev_tx_completed_queue(bql_txq, bql_pkts, bql_bytes);
 	if (count)
 		wake_up_nr(&queue->req_wq, count);
 	return count;
@@ -898,6 +1095,8 @@ static int cldma_gpd_tx_collect(struct md_cd_queue *queue, int budget, int block
 	int count = 0;
 	struct sk_buff *skb_free;
 	DATA_POLICY skb_free_p;
+	struct netdev_queue *txq, *bql_txq = NULL;
+	unsigned int bql_pkts = 0, bql_bytes = 0;
 	dma_addr_t dma_free;
 	unsigned int dma_len;
 
@@ -926,8 +1125,10 @@ static int cldma_gpd_tx_collect(struct md_cd_queue *queue, int budget, int block
 		dma_len = tgpd->data_buff_len;
 		skb_free = req->skb;
 		skb_free_p = req->policy;
+		txq = req->dev_queue;
 		/* mark cldma_request as available */
 		req->skb = NULL;
+		req->dev_queue = NULL;
 		/* step forward */
 		queue->tr_done = cldma_ring_step_forward(queue->tr_ring, req);
 		if (likely(md->capability & MODEM_CAP_TXBUSY_STOP))
@@ -951,11 +1152,26 @@ static int cldma_gpd_tx_collect(struct md_cd_queue *queue, int budget, int block
 			     ccci_h->data[0], ccci_h->data[1], *(((u32 *) ccci_h) + 2), ccci_h->reserved, queue->index,
 			     skb_free->len);
 		ccci_channel_update_packet_counter(md, ccci_h);
+		if (txq) {
+			/* report BQL per netdev queue, one call for a run of packets of the same queue */
+			if (txq != bql_txq && bql_pkts) {
+				netdev_tx_completed_queue(bql_txq, bql_pkts, bql_bytes);
+				bql_pkts = bql_bytes = 0;
+			}
+			bql_txq = txq;
+			bql_pkts++;
+			bql_bytes += skb_free->len;
+		}
 		ccci_free_skb(skb_free, skb_free_p);
 #if TRAFFIC_MONITOR_INTERVAL
 		md_ctrl->tx_traffic_monitor[queue->index]++;
 #endif
+		/* budget 0 means no limit */
+		if (budget && count >= budget)
+			break;
 	}
+	if (bql_pkts)
+		netdev_tx_completed_queue(bql_txq, bql_pkts, bql_bytes);
 	if (count)
 		wake_up_nr(&queue->req_wq, count);
 	return count;
@@ -1017,6 +1233,42 @@ static void cldma_tx_done(struct work_struct *work)
 #endif
 }
 
+#ifdef ENABLE_CLDMA_TX_NAPI
+/* NAPI poll of a net Tx queue, TX_DONE interrupt of this queue stays masked until the ring is reclaimed */
+static int cldma_net_tx_poll(struct napi_struct *napi, int budget)
+{
+	struct md_cd_queue *queue = container_of(napi, struct md_cd_queue, napi);
+	struct ccci_modem *md = queue->modem;
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	int result, count;
+#ifndef CLDMA_NO_TX_IRQ
+	unsigned long flags;
+#endif
+
+#if TRAFFIC_MONITOR_INTERVAL
+	md_ctrl->tx_done_last_start_time[queue->index] = local_clock();
+#endif
+	count = queue->tr_ring->handle_tx_done(queue, budget, 0, &result);
+#if TRAFFIC_MONITOR_INTERVAL
+	md_ctrl->tx_done_last_count[queue->index] = count;
+#endif
+	if (count >= budget)
+		return budget;
+
+	napi_complete(napi);
+#ifndef CLDMA_NO_TX_IRQ
+	/* enable TX_DONE interrupt */
+	md_cd_lock_cldma_clock_src(1);
+	spin_lock_irqsave(&md_ctrl->cldma_timeout_lock, flags);
+	if (md_ctrl->txq_active & (1 << queue->index))
+		cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_L2TIMCR0, CLDMA_BM_ALL_QUEUE & (1 << queue->index));
+	spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
+	md_cd_lock_cldma_clock_src(0);
+#endif
+	return count;
+}
+#endif
+
 static void cldma_rx_ring_init(struct ccci_modem *md, struct cldma_ring *ring)
 {
 	int i;
@@ -1028,11 +1280,9 @@ static void cldma_rx_ring_init(struct ccci_modem *md, struct cldma_ring *ring)
 		for (i = 0; i < ring->length; i++) {
 			item = kzalloc(sizeof(struct cldma_request), GFP_KERNEL);
 			item->gpd = dma_pool_alloc(md_ctrl->gpd_dmapool, GFP_KERNEL, &item->gpd_addr);
-			item->skb = ccci_alloc_skb(ring->pkt_size, 1, 1);
+			cldma_rx_buf_attach(ring, item, cldma_rx_buf_alloc(md, ring, 1, 1, &item->data_buffer_ptr_saved));
 			gpd = (struct cldma_rgpd *)item->gpd;
 			memset(gpd, 0, sizeof(struct cldma_rgpd));
-			item->data_buffer_ptr_saved = dma_map_single(&md->plat_dev->dev, item->skb->data,
-								     skb_data_size(item->skb), DMA_FROM_DEVICE);
 			gpd->data_buff_bd_ptr = (u32) (item->data_buffer_ptr_saved);
 			gpd->data_allow_len = ring->pkt_size;
 			gpd->gpd_flags = 0x81;	/* IOC|HWO */
@@ -1155,6 +1405,18 @@ static void cldma_queue_switch_ring(struct md_cd_queue *queue)
 	CCCI_DBG_MSG(md->index, TAG, "queue %d/%d switch ring to %p\n", queue->index, queue->dir, queue->tr_ring);
 }
 
+/*
+ * The modem logger queue has a LITTLE bound workqueue of its own. Data
+ * queues run rx_done on the cluster that handled the interrupt, next to the
+ * network stack work it feeds.
+ */
+static int cldma_queue_rx_work(struct md_cd_queue *queue)
+{
+	if (queue->worker)
+		return queue_work(queue->worker, &queue->cldma_rx_work);
+	return mt_queue_work(MT_WQ_CLUSTER, &queue->cldma_rx_work);
+}
+
 static void cldma_rx_queue_init(struct md_cd_queue *queue)
 {
 	struct ccci_modem *md = queue->modem;
@@ -1165,20 +1427,41 @@ static void cldma_rx_queue_init(struct md_cd_queue *queue)
 	 * CLDMA queue must be work sequentially as wo didn't implement any lock in rx_done or tx_done.
 	 */
 	if ((1 << queue->index) & LOW_PRIORITY_QUEUE) {
-		/* modem logger queue: priority normal */
+		/* modem logger queue: priority normal, kept off the big cores */
 		queue->worker = alloc_workqueue("md%d_rx%d_worker", WQ_UNBOUND | WQ_MEM_RECLAIM, 1,
 						md->index + 1, queue->index);
+		if (queue->worker)
+			mt_wq_bind_little(queue->worker, false);
 		queue->refill_worker = alloc_workqueue("md%d_rx%d_refill_worker", WQ_UNBOUND | WQ_MEM_RECLAIM, 1,
 						       md->index + 1, queue->index);
 	} else {
-		queue->worker = alloc_workqueue("md%d_rx%d_worker", WQ_UNBOUND | WQ_MEM_RECLAIM | WQ_HIGHPRI, 1,
-						md->index + 1, queue->index);
+		/* data queues use MT_WQ_CLUSTER, see cldma_queue_rx_work() */
+		queue->worker = NULL;
 		queue->refill_worker = alloc_workqueue("md%d_rx%d_refill_worker",
 			WQ_UNBOUND | WQ_MEM_RECLAIM | WQ_HIGHPRI, 1, md->index + 1, queue->index);
 	}
 	ccci_skb_queue_init(&queue->skb_list, queue->tr_ring->pkt_size, SKB_RX_QUEUE_MAX_LEN, 0);
 	init_waitqueue_head(&queue->rx_wq);
+#ifdef ENABLE_CLDMA_RX_NAPI
+	if (IS_NET_QUE(md, queue->index) && !(md->capability & MODEM_CAP_NAPI)) {
+		struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+
+		netif_napi_add(&md_ctrl->napi_dev, &queue->napi, cldma_net_rx_poll, NAPI_POLL_WEIGHT);
+		napi_enable(&queue->napi);
+		queue->rx_cpu = -1;
+		queue->rx_csd.func = cldma_rx_napi_ipi;
+		queue->rx_csd.info = queue;
+		queue->rx_napi = 1;
+#ifdef ENABLE_CLDMA_RX_COALESCE
+		hrtimer_init(&queue->rx_coal_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+		queue->rx_coal_timer.function = cldma_rx_coal_timer_func;
+		queue->rx_rate_stamp = jiffies;
+#endif
+	}
+	if (IS_NET_QUE(md, queue->index) && !queue->rx_napi)
+#else
 	if (IS_NET_QUE(md, queue->index))
+#endif
 		queue->rx_thread = kthread_run(cldma_net_rx_push_thread, queue, "cldma_rxq%d", queue->index);
 	CCCI_DBG_MSG(md->index, TAG, "rxq%d work=%p\n", queue->index, &queue->cldma_rx_work);
 }
@@ -1191,7 +1474,19 @@ static void cldma_tx_queue_init(struct md_cd_queue *queue)
 	queue->worker =
 	    alloc_workqueue("md%d_tx%d_worker", WQ_UNBOUND | WQ_MEM_RECLAIM | WQ_HIGHPRI, 1, md->index + 1,
 			    queue->index);
+	/* tx_done only reclaims sent requests */
+	if (queue->worker)
+		mt_wq_bind_little(queue->worker, true);
 	INIT_DELAYED_WORK(&queue->cldma_tx_work, cldma_tx_done);
+#ifdef ENABLE_CLDMA_TX_NAPI
+	if (IS_NET_QUE(md, queue->index)) {
+		struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+
+		netif_napi_add(&md_ctrl->napi_dev, &queue->napi, cldma_net_tx_poll, NAPI_POLL_WEIGHT);
+		napi_enable(&queue->napi);
+		queue->tx_napi = 1;
+	}
+#endif
 	CCCI_DBG_MSG(md->index, TAG, "txq%d work=%p\n", queue->index, &queue->cldma_tx_work);
 #ifdef ENABLE_CLDMA_TIMER
 	init_timer(&queue->timeout_timer);
@@ -1275,6 +1570,12 @@ static void cldma_irq_work_cb(struct ccci_modem *md)
 				/* disable TX_DONE interrupt */
 				cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_L2TIMSR0,
 					      CLDMA_BM_ALL_QUEUE & (1 << i));
+#ifdef ENABLE_CLDMA_TX_NAPI
+				if (md->md_state != EXCEPTION && md_ctrl->txq[i].tx_napi) {
+					napi_schedule(&md_ctrl->txq[i].napi);
+					continue;
+				}
+#endif
 				ret = queue_delayed_work(md_ctrl->txq[i].worker, &md_ctrl->txq[i].cldma_tx_work,
 							 msecs_to_jiffies(10));
 				CCCI_DBG_MSG(md->index, TAG, "qno%d queue_delayed_work=%d\n", i, ret);
@@ -1307,9 +1608,15 @@ static void cldma_irq_work_cb(struct ccci_modem *md)
 				if (md->md_state != EXCEPTION && md_ctrl->rxq[i].napi_port) {
 					md_ctrl->rxq[i].napi_port->ops->md_state_notice(md_ctrl->rxq[i].napi_port,
 							RX_IRQ);
+#ifdef ENABLE_CLDMA_RX_NAPI
+				} else if (md->md_state != EXCEPTION && md_ctrl->rxq[i].rx_napi) {
+#ifdef ENABLE_CLDMA_RX_COALESCE
+					md_ctrl->rxq[i].rx_irq_cnt++;
+#endif
+					cldma_rx_napi_schedule(&md_ctrl->rxq[i]);
+#endif
 				} else {
-					ret = queue_work(md_ctrl->rxq[i].worker,
-									&md_ctrl->rxq[i].cldma_rx_work);
+					ret = cldma_queue_rx_work(&md_ctrl->rxq[i]);
 				}
 			}
 		}
@@ -1432,10 +1739,24 @@ static inline void cldma_stop(struct ccci_modem *md)
 	/* flush work */
 	disable_irq(md_ctrl->cldma_irq_id);
 	flush_work(&md_ctrl->cldma_irq_work);
-	for (i = 0; i < QUEUE_LEN(md_ctrl->txq); i++)
+	for (i = 0; i < QUEUE_LEN(md_ctrl->txq); i++) {
 		flush_delayed_work(&md_ctrl->txq[i].cldma_tx_work);
+#ifdef ENABLE_CLDMA_TX_NAPI
+		if (md_ctrl->txq[i].tx_napi)
+			napi_synchronize(&md_ctrl->txq[i].napi);
+#endif
+	}
 	for (i = 0; i < QUEUE_LEN(md_ctrl->rxq); i++) {
 		flush_work(&md_ctrl->rxq[i].cldma_rx_work);
+#ifdef ENABLE_CLDMA_RX_NAPI
+#ifdef ENABLE_CLDMA_RX_COALESCE
+		/* rxq_active is cleared, poll won't start the timer again */
+		if (md_ctrl->rxq[i].rx_napi)
+			hrtimer_cancel(&md_ctrl->rxq[i].rx_coal_timer);
+#endif
+		if (md_ctrl->rxq[i].rx_napi)
+			napi_synchronize(&md_ctrl->rxq[i].napi);
+#endif
 		flush_work(&md_ctrl->rxq[i].cldma_refill_work);
 	}
 }
@@ -1634,6 +1955,11 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 					cldma_write32(&tgpd->data_buff_bd_ptr, 0, 0);
 				cldma_write16(&tgpd->data_buff_len, 0, 0);
 				if (req->skb) {
+					if (req->dev_queue) {
+						/* never completed by CLDMA, give it back to BQL */
+						netdev_tx_completed_queue(req->dev_queue, 1, req->skb->len);
+						req->dev_queue = NULL;
+					}
 					ccci_free_skb(req->skb, req->policy);
 					req->skb = NULL;
 				}
@@ -1664,7 +1990,7 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 			spin_unlock_irqrestore(&md_ctrl->rxq[i].ring_lock, flags);
 			list_for_each_entry(req, &md_ctrl->rxq[i].tr_ring->gpd_ring, entry) {
 				rgpd = (struct cldma_rgpd *)req->gpd;
-				if (req->skb == NULL) {
+				if (!cldma_rx_req_has_buf(req)) {
 					struct md_cd_queue *queue = &md_ctrl->rxq[i];
 					/*which queue*/
 					CCCI_INF_MSG(md->index, TAG, "skb NULL in Rx queue %d/%d\n",
@@ -1672,10 +1998,8 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 					/*if ((1 << queue->index) & NET_TX_QUEUE_MASK)
 						req->skb = ccci_alloc_skb(queue->tr_ring->pkt_size, 0, 1);
 					else */
-					req->skb = ccci_alloc_skb(queue->tr_ring->pkt_size, 1, 1);
-					req->data_buffer_ptr_saved =
-						dma_map_single(&md->plat_dev->dev, req->skb->data,
-								skb_data_size(req->skb), DMA_FROM_DEVICE);
+					cldma_rx_buf_attach(queue->tr_ring, req,
+						cldma_rx_buf_alloc(md, queue->tr_ring, 1, 1, &req->data_buffer_ptr_saved));
 					rgpd->data_buff_bd_ptr = (u32) (req->data_buffer_ptr_saved);
 					caculate_checksum((char *)rgpd, 0x81);
 				}
@@ -1740,8 +2064,10 @@ static int md_cd_start_queue(struct ccci_modem *md, unsigned char qno, DIRECTION
 			rgpd = (struct cldma_rgpd *)req->gpd;
 			cldma_write8(&rgpd->gpd_flags, 0, 0x81);
 			cldma_write16(&rgpd->data_buff_len, 0, 0);
-			req->skb->len = 0;
-			skb_reset_tail_pointer(req->skb);
+			if (req->skb) {
+				req->skb->len = 0;
+				skb_reset_tail_pointer(req->skb);
+			}
 		}
 		/* enable queue and RX_DONE interrupt */
 		md_cd_lock_cldma_clock_src(1);
@@ -2090,6 +2416,13 @@ static int md_cd_init(struct ccci_modem *md)
 	/* init CLMDA, must before queue init as we set start address there */
 	cldma_sw_init(md);
 	/* init queue */
+#if defined(ENABLE_CLDMA_RX_NAPI) || defined(ENABLE_CLDMA_TX_NAPI)
+	init_dummy_netdev(&md_ctrl->napi_dev);
+#endif
+#ifdef ENABLE_CLDMA_RX_COALESCE
+	md_ctrl->rx_coal_usecs = 200;
+	md_ctrl->rx_coal_rate = 8000;
+#endif
 	for (i = 0; i < QUEUE_LEN(md_ctrl->txq); i++) {
 		md_cd_queue_struct_init(&md_ctrl->txq[i], md, OUT, i);
 		cldma_tx_queue_init(&md_ctrl->txq[i]);
@@ -2145,10 +2478,43 @@ static void md_cd_clear_traffic_data(struct ccci_modem *md)
 }
 #endif
 
+struct md_cd_img_load {
+	struct ccci_modem *md;
+	struct ccci_img_load dsp;
+	struct ccci_img_load armv7;
+	bool dsp_started;
+	bool armv7_started;
+};
+
+/*
+ * The MD check header is parsed: start the DSP and ARMV7 images, which sit at
+ * offsets it gives, while the MD image is still being copied. Only images
+ * placed past the end of the MD image, the copies must not overlap.
+ */
+static void md_cd_start_sub_img(void *data)
+{
+	struct md_cd_img_load *ld = data;
+	struct ccci_modem *md = ld->md;
+	struct ccci_image_info *md_img = &md->img_info[IMG_MD];
+	unsigned int md_end = md_img->size - md_img->tail_length;
+
+	if (md_img->dsp_size != 0 && md_img->dsp_offset != 0xCDCDCDAA && md_img->dsp_offset >= md_end) {
+		md->img_info[IMG_DSP].address = md_img->address + md_img->dsp_offset;
+		ccci_load_firmware_start(&ld->dsp, md->index, &md->img_info[IMG_DSP], &md->plat_dev->dev);
+		ld->dsp_started = true;
+	}
+	if (md_img->arm7_size != 0 && md_img->arm7_offset != 0 && md_img->arm7_offset >= md_end) {
+		md->img_info[IMG_ARMV7].address = md_img->address + md_img->arm7_offset;
+		ccci_load_firmware_start(&ld->armv7, md->index, &md->img_info[IMG_ARMV7], &md->plat_dev->dev);
+		ld->armv7_started = true;
+	}
+}
+
 static int md_cd_start(struct ccci_modem *md)
 {
 	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
 	char img_err_str[IMG_ERR_STR_LEN];
+	struct md_cd_img_load ld = { .md = md };
 	int ret = 0;
 #ifndef ENABLE_CLDMA_AP_SIDE
 	int retry, cldma_on = 0;
@@ -2163,16 +2529,26 @@ static int md_cd_start(struct ccci_modem *md)
 		CCCI_INF_MSG(md->index, TAG, "CLDMA modem is not ready, load it\n");
 		ccci_clear_md_region_protection(md);
 		ccci_clear_dsp_region_protection(md);
-		ret = ccci_load_firmware(md->index, &md->img_info[IMG_MD], img_err_str,
-				md->post_fix, &md->plat_dev->dev);
+		ret = ccci_load_md_firmware(md->index, &md->img_info[IMG_MD], img_err_str,
+				md->post_fix, &md->plat_dev->dev, md_cd_start_sub_img, &ld);
+		if (ld.dsp_started)
+			ccci_load_firmware_wait(&ld.dsp);
+		if (ld.armv7_started)
+			ccci_load_firmware_wait(&ld.armv7);
 		if (ret < 0) {
 			CCCI_ERR_MSG(md->index, TAG, "load MD firmware fail, %s\n", img_err_str);
 			goto out;
 		}
 		if (md->img_info[IMG_MD].dsp_size != 0 && md->img_info[IMG_MD].dsp_offset != 0xCDCDCDAA) {
-			md->img_info[IMG_DSP].address = md->img_info[IMG_MD].address + md->img_info[IMG_MD].dsp_offset;
-			ret = ccci_load_firmware(md->index, &md->img_info[IMG_DSP], img_err_str,
-				md->post_fix, &md->plat_dev->dev);
+			if (ld.dsp_started) {
+				ret = ld.dsp.ret;
+				strncpy(img_err_str, ld.dsp.err_str, IMG_ERR_STR_LEN);
+			} else {
+				md->img_info[IMG_DSP].address =
+					md->img_info[IMG_MD].address + md->img_info[IMG_MD].dsp_offset;
+				ret = ccci_load_firmware(md->index, &md->img_info[IMG_DSP], img_err_str,
+					md->post_fix, &md->plat_dev->dev);
+			}
 			if (ret < 0) {
 				CCCI_ERR_MSG(md->index, TAG, "load DSP firmware fail, %s\n", img_err_str);
 				goto out;
@@ -2189,9 +2565,15 @@ static int md_cd_start(struct ccci_modem *md)
 		CCCI_ERR_MSG(md->index, TAG, "load ARMV7 firmware begin[0x%x]<0x%x>\n",
 			md->img_info[IMG_MD].arm7_size, md->img_info[IMG_MD].arm7_offset);
 		if ((md->img_info[IMG_MD].arm7_size != 0) && (md->img_info[IMG_MD].arm7_offset != 0)) {
-			md->img_info[IMG_ARMV7].address = md->img_info[IMG_MD].address+md->img_info[IMG_MD].arm7_offset;
-			ret = ccci_load_firmware(md->index, &md->img_info[IMG_ARMV7], img_err_str,
-				md->post_fix, &md->plat_dev->dev);
+			if (ld.armv7_started) {
+				ret = ld.armv7.ret;
+				strncpy(img_err_str, ld.armv7.err_str, IMG_ERR_STR_LEN);
+			} else {
+				md->img_info[IMG_ARMV7].address =
+					md->img_info[IMG_MD].address + md->img_info[IMG_MD].arm7_offset;
+				ret = ccci_load_firmware(md->index, &md->img_info[IMG_ARMV7], img_err_str,
+					md->post_fix, &md->plat_dev->dev);
+			}
 			if (ret < 0) {
 				CCCI_ERR_MSG(md->index, TAG, "load ARMV7 firmware fail, %s\n", img_err_str);
 				goto out;
@@ -2624,6 +3006,7 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 	unsigned long flags;
 	unsigned int tx_bytes = 0;
 	DATA_POLICY policy;
+	int more = 0;
 #ifdef CLDMA_TRACE
 	static unsigned long long last_leave_time[CLDMA_TXQ_NUM] = { 0 };
 	static unsigned int sample_time[CLDMA_TXQ_NUM] = { 0 };
@@ -2644,7 +3027,8 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 #if TRAFFIC_MONITOR_INTERVAL
 	if ((jiffies - md_ctrl->traffic_stamp) / HZ >= TRAFFIC_MONITOR_INTERVAL) {
 		md_ctrl->traffic_stamp = jiffies;
-		mod_timer(&md_ctrl->traffic_monitor, jiffies);
+		mod_timer(&md_ctrl->traffic_monitor,
+			mt_ctimer_expires(&md_cd_traffic_ctimer_src, jiffies));
 	}
 #endif
 
@@ -2678,6 +3062,16 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 		wmb();
 		queue->budget--;
 		queue->tr_ring->handle_tx_request(queue, tx_req, skb, policy, ioc_override);
+		if (!req && skb->dev && IS_NET_QUE(md, qno)) {
+			/* network skb, account it to BQL of its netdev queue */
+			tx_req->dev_queue = netdev_get_tx_queue(skb->dev, skb_get_queue_mapping(skb));
+			netdev_tx_sent_queue(tx_req->dev_queue, skb->len);
+			/*
+			 * stack has more skbs for us, delay the doorbell until the last one of this batch,
+			 * as long as there is room in ring and nobody stops the netdev queue.
+			 */
+			more = skb->xmit_more && queue->budget > 0 && !netif_xmit_stopped(tx_req->dev_queue);
+		}
 		/* step forward */
 		queue->tx_xmit = cldma_ring_step_forward(queue->tr_ring, tx_req);
 		spin_unlock_irqrestore(&queue->ring_lock, flags);
@@ -2686,6 +3080,8 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 		md_ctrl->tx_pre_traffic_monitor[queue->index]++;
 #endif
 		ccci_dump_log_add(md, OUT, (int)queue->index, &ccci_h, 0);
+		if (more)
+			goto __EXIT_FUN;
 		/*
 		 * make sure TGPD is ready by here, otherwise there is race conditon between ports over the same queue.
 		 * one port is just setting TGPD, another port may have resumed the queue.
@@ -2810,7 +3206,7 @@ static int md_cd_give_more(struct ccci_modem *md, unsigned char qno)
 	if (qno >= QUEUE_LEN(md_ctrl->rxq))
 		return -CCCI_ERR_INVALID_QUEUE_INDEX;
 	CCCI_DBG_MSG(md->index, TAG, "give more on queue %d work %p\n", qno, &md_ctrl->rxq[qno].cldma_rx_work);
-	ret = queue_work(md_ctrl->rxq[qno].worker, &md_ctrl->rxq[qno].cldma_rx_work);
+	ret = cldma_queue_rx_work(&md_ctrl->rxq[qno]);
 	return 0;
 }
 
@@ -3600,11 +3996,82 @@ static ssize_t md_cd_rxd_store(struct ccci_modem *md, const char *buf, size_t co
 	return count;
 }
 
+#ifdef ENABLE_CLDMA_RX_NAPI
+static ssize_t md_cd_net_rx_cpu_show(struct ccci_modem *md, char *buf)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	int count = 0, i;
+
+	for (i = 0; i < QUEUE_LEN(md_ctrl->rxq); i++) {
+		if (!md_ctrl->rxq[i].rx_napi)
+			continue;
+		count += snprintf(buf + count, 128, "rxq%d: %d\n", i, md_ctrl->rxq[i].rx_cpu);
+	}
+	return count;
+}
+
+/* "<qno> <cpu>", cpu -1 runs Rx of this queue on the CPU taking CLDMA IRQ */
+static ssize_t md_cd_net_rx_cpu_store(struct ccci_modem *md, const char *buf, size_t count)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	int qno, cpu;
+
+	if (sscanf(buf, "%d %d", &qno, &cpu) != 2)
+		return -EINVAL;
+	if (qno < 0 || qno >= QUEUE_LEN(md_ctrl->rxq) || !md_ctrl->rxq[qno].rx_napi)
+		return -EINVAL;
+	if (cpu >= nr_cpu_ids || (cpu >= 0 && !cpu_possible(cpu)))
+		return -EINVAL;
+	md_ctrl->rxq[qno].rx_cpu = cpu < 0 ? -1 : cpu;
+	CCCI_INF_MSG(md->index, TAG, "rxq%d napi on CPU %d\n", qno, md_ctrl->rxq[qno].rx_cpu);
+	return count;
+}
+#endif
+
+#ifdef ENABLE_CLDMA_RX_COALESCE
+static ssize_t md_cd_net_rx_coal_show(struct ccci_modem *md, char *buf)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	int count = 0, i;
+
+	count += snprintf(buf + count, 128, "usecs=%u rate=%u\n", md_ctrl->rx_coal_usecs, md_ctrl->rx_coal_rate);
+	for (i = 0; i < QUEUE_LEN(md_ctrl->rxq); i++) {
+		if (!md_ctrl->rxq[i].rx_napi)
+			continue;
+		count += snprintf(buf + count, 128, "rxq%d: rate=%u coal=%d\n", i, md_ctrl->rxq[i].rx_rate,
+				  md_ctrl->rxq[i].rx_coal);
+	}
+	return count;
+}
+
+/* "<usecs> <rate>", poll interval when coalescing and packets/s to start it, usecs 0 to disable */
+static ssize_t md_cd_net_rx_coal_store(struct ccci_modem *md, const char *buf, size_t count)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	unsigned int usecs, rate;
+
+	if (sscanf(buf, "%u %u", &usecs, &rate) != 2)
+		return -EINVAL;
+	if (usecs > USEC_PER_MSEC * 10 || rate == 0)
+		return -EINVAL;
+	md_ctrl->rx_coal_usecs = usecs;
+	md_ctrl->rx_coal_rate = rate;
+	CCCI_INF_MSG(md->index, TAG, "net Rx coalesce %uus above %u pkt/s\n", usecs, rate);
+	return count;
+}
+#endif
+
 CCCI_MD_ATTR(NULL, dump, 0660, md_cd_dump_show, md_cd_dump_store);
 CCCI_MD_ATTR(NULL, control, 0660, md_cd_control_show, md_cd_control_store);
 CCCI_MD_ATTR(NULL, filter, 0660, md_cd_filter_show, md_cd_filter_store);
 CCCI_MD_ATTR(NULL, parameter, 0660, md_cd_parameter_show, md_cd_parameter_store);
 CCCI_MD_ATTR(NULL, md_rxd, 0660, md_cd_rxd_show, md_cd_rxd_store);
+#ifdef ENABLE_CLDMA_RX_NAPI
+CCCI_MD_ATTR(NULL, net_rx_cpu, 0660, md_cd_net_rx_cpu_show, md_cd_net_rx_cpu_store);
+#endif
+#ifdef ENABLE_CLDMA_RX_COALESCE
+CCCI_MD_ATTR(NULL, net_rx_coal, 0660, md_cd_net_rx_coal_show, md_cd_net_rx_coal_store);
+#endif
 
 static void md_cd_sysfs_init(struct ccci_modem *md)
 {
@@ -3633,6 +4100,18 @@ static void md_cd_sysfs_init(struct ccci_modem *md)
 	ret = sysfs_create_file(&md->kobj, &ccci_md_attr_md_rxd.attr);
 	if (ret)
 		CCCI_ERR_MSG(md->index, TAG, "fail to add sysfs node %s %d\n", ccci_md_attr_md_rxd.attr.name, ret);
+#ifdef ENABLE_CLDMA_RX_NAPI
+	ccci_md_attr_net_rx_cpu.modem = md;
+	ret = sysfs_create_file(&md->kobj, &ccci_md_attr_net_rx_cpu.attr);
+	if (ret)
+		CCCI_ERR_MSG(md->index, TAG, "fail to add sysfs node %s %d\n", ccci_md_attr_net_rx_cpu.attr.name, ret);
+#endif
+#ifdef ENABLE_CLDMA_RX_COALESCE
+	ccci_md_attr_net_rx_coal.modem = md;
+	ret = sysfs_create_file(&md->kobj, &ccci_md_attr_net_rx_coal.attr);
+	if (ret)
+		CCCI_ERR_MSG(md->index, TAG, "fail to add sysfs node %s %d\n", ccci_md_attr_net_rx_coal.attr.name, ret);
+#endif
 
 }
 
@@ -3725,6 +4204,9 @@ static int ccci_modem_probe(struct platform_device *plat_dev)
 		md_ctrl->net_rx_ring[i].length = net_rx_queue_buffer_number[net_rx_ring2queue[i]];
 		md_ctrl->net_rx_ring[i].pkt_size = net_rx_queue_buffer_size[net_rx_ring2queue[i]];
 		md_ctrl->net_rx_ring[i].type = RING_GPD;
+#ifdef CLDMA_NET_RX_FRAG
+		md_ctrl->net_rx_ring[i].rx_frag = ccci_rx_frag_size(md_ctrl->net_rx_ring[i].pkt_size) <= PAGE_SIZE;
+#endif
 		md_ctrl->net_rx_ring[i].handle_rx_done = &cldma_gpd_net_rx_collect;
 		md_ctrl->net_rx_ring[i].handle_rx_refill = &cldma_gpd_rx_refill;
 		cldma_rx_ring_init(md, &md_ctrl->net_rx_ring[i]);
@@ -3764,7 +4246,7 @@ static int ccci_modem_probe(struct platform_device *plat_dev)
 	atomic_set(&md_ctrl->wdt_enabled, 0);
 	INIT_WORK(&md_ctrl->wdt_work, md_cd_wdt_work);
 #if TRAFFIC_MONITOR_INTERVAL
-	init_timer(&md_ctrl->traffic_monitor);
+	init_timer_deferrable(&md_ctrl->traffic_monitor);
 	md_ctrl->traffic_monitor.function = md_cd_traffic_monitor_func;
 	md_ctrl->traffic_monitor.data = (unsigned long)md;
 #endif
@@ -3779,6 +4261,8 @@ static int ccci_modem_probe(struct platform_device *plat_dev)
 	md_cd_sysfs_init(md);
 	/* hook up to device */
 	plat_dev->dev.platform_data = md;
+	/* the dpm callbacks only log, nothing to order against */
+	device_enable_async_suspend(&plat_dev->dev);
 #ifndef FEATURE_FPGA_PORTING
 	/* init CCIF */
 	sram_size = md_ctrl->hw_info->sram_size;
@@ -3896,7 +4380,7 @@ static int __init modem_cd_init(void)
 	return 0;
 }
 
-module_init(modem_cd_init);
+async_device_initcall(modem_cd_init);
 
 MODULE_AUTHOR("Xiao Wang <xiao.wang@mediatek.com>");
 MODULE_DESCRIPTION("CLDMA modem driver v0.1");
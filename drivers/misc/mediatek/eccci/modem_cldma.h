@@ -6,6 +6,7 @@
 #include <linux/timer.h>
 #include <linux/hrtimer.h>
 #include <linux/skbuff.h>
+#include <linux/netdevice.h>
 #include <mt-plat/mt_ccci_common.h>
 
 #include "ccci_config.h"
@@ -31,6 +32,13 @@
  * CLDMA_NO_TX_IRQ: mask all TX interrupts, collect TX_DONE skb when get Rx interrupt or Tx busy.
  * ENABLE_CLDMA_TIMER: use a timer to detect TX packet sent or not. not usable if TX interrupts are masked.
  * CLDMA_NET_TX_BD: use BD to support scatter/gather IO for net device
+ * CLDMA_NET_RX_FRAG: net Rx rings use page fragment buffers, skb is built when a packet is received
+ * ENABLE_CLDMA_RX_NAPI: collect net Rx queues in a per-queue NAPI instead of rx_done work + push thread,
+ *	the NAPI can be steered to another CPU by sysfs net_rx_cpu. not used if modem has MODEM_CAP_NAPI.
+ * ENABLE_CLDMA_TX_NAPI: reclaim net Tx queues in a per-queue NAPI instead of delayed tx_done work
+ * ENABLE_CLDMA_RX_COALESCE: when a net Rx queue runs above rx_coal_rate packets/s, its RX_DONE interrupt
+ *	stays masked after NAPI completes and the queue is polled again rx_coal_usecs later by a hrtimer.
+ *	an empty timer poll or a low rate goes back to interrupts. tuned by sysfs net_rx_coal, needs Rx NAPI.
  */
 #define CHECKSUM_SIZE 0		/* 12 */
 /* #define CLDMA_NO_TX_IRQ */
@@ -38,11 +46,20 @@
 /* #define ENABLE_CLDMA_TIMER */
 #endif
 #define CLDMA_NET_TX_BD
+#define CLDMA_NET_RX_FRAG
+#define ENABLE_CLDMA_RX_NAPI
+#define ENABLE_CLDMA_TX_NAPI
+#ifdef ENABLE_CLDMA_RX_NAPI
+#define ENABLE_CLDMA_RX_COALESCE
+#endif
+#define CLDMA_RX_RATE_WINDOW (HZ / 50)	/* jiffies */
 
 struct cldma_request {
 	void *gpd;		/* virtual address for CPU */
 	dma_addr_t gpd_addr;	/* physical address for DMA */
 	struct sk_buff *skb;
+	void *rx_buf;		/* page fragment Rx buffer, used instead of skb on rx_frag ring */
+	struct netdev_queue *dev_queue;	/* net Tx skb accounted to this queue's BQL */
 	dma_addr_t data_buffer_ptr_saved;
 	struct list_head entry;
 	struct list_head bd;
@@ -71,6 +88,7 @@ struct cldma_ring {
 	int length;		/* number of struct cldma_request */
 	int pkt_size;		/* size of each packet in ring */
 	CLDMA_RING_TYPE type;
+	unsigned char rx_frag;	/* Rx buffers are page fragments, see ccci_alloc_rx_frag() */
 
 	int (*handle_tx_request)(struct md_cd_queue *queue, struct cldma_request *req,
 				  struct sk_buff *skb, DATA_POLICY policy, unsigned int ioc_override);
@@ -141,6 +159,26 @@ struct md_cd_queue {
 
 	wait_queue_head_t rx_wq;
 	struct task_struct *rx_thread;
+#if defined(ENABLE_CLDMA_RX_NAPI) || defined(ENABLE_CLDMA_TX_NAPI)
+	struct napi_struct napi; /* only for network queue */
+#endif
+#ifdef ENABLE_CLDMA_TX_NAPI
+	unsigned char tx_napi; /* Tx_DONE is handled by napi */
+#endif
+#ifdef ENABLE_CLDMA_RX_NAPI
+	unsigned char rx_napi; /* Rx_DONE is handled by napi */
+	int rx_cpu; /* CPU to run napi on, -1 for the CPU taking CLDMA IRQ */
+	struct call_single_data rx_csd;
+#endif
+#ifdef ENABLE_CLDMA_RX_COALESCE
+	struct hrtimer rx_coal_timer;
+	unsigned char rx_coal; /* RX_DONE left masked, polled by rx_coal_timer */
+	unsigned long rx_rate_stamp;
+	unsigned int rx_rate_pkts;
+	unsigned int rx_rate; /* packets/s of last window */
+	unsigned int rx_irq_cnt; /* for traffic monitor */
+	unsigned int rx_coal_cnt;
+#endif
 
 #ifdef ENABLE_CLDMA_TIMER
 	struct timer_list timeout_timer;
@@ -195,6 +233,13 @@ struct md_cd_ctrl {
 	struct cldma_ring net_rx_ring[NET_RXQ_NUM];
 	struct cldma_ring normal_tx_ring[NORMAL_TXQ_NUM];
 	struct cldma_ring normal_rx_ring[NORMAL_RXQ_NUM];
+#if defined(ENABLE_CLDMA_RX_NAPI) || defined(ENABLE_CLDMA_TX_NAPI)
+	struct net_device napi_dev; /* dummy device to host queue napi */
+#endif
+#ifdef ENABLE_CLDMA_RX_COALESCE
+	unsigned int rx_coal_usecs; /* 0 to disable */
+	unsigned int rx_coal_rate;
+#endif
 
 	void __iomem *cldma_ap_ao_base;
 	void __iomem *cldma_md_ao_base;
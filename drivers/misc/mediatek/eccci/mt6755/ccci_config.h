@@ -20,6 +20,7 @@
 #define FEATURE_POLL_MD_EN
 
 #define FEATURE_DHL_LOG_EN
+#define FEATURE_CHAR_RX_RING
 #define FEATURE_MD1MD3_SHARE_MEM
 
 #if 0 /*DEPRECATED */
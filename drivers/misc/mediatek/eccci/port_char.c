@@ -6,6 +6,8 @@
 #include <linux/module.h>
 #include <linux/poll.h>
 #include <linux/uidgid.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
 #include <mt-plat/mt_ccci_common.h>
 #include <mt-plat/mt_boot_common.h>
 #ifdef CONFIG_COMPAT
@@ -30,6 +32,174 @@
 
 #define MAX_QUEUE_LENGTH 32
 
+#ifdef FEATURE_CHAR_RX_RING
+/*
+ * mmap Rx ring, for high volume ports like MD logger.
+ * instead of queuing requests and copying each of them to user in read(), Rx packet is copied into
+ * a vmalloc ring mapped by user and the request is recycled right away. user consumes records by
+ * index and only gets woken up when the ring is filled above its watermark.
+ * the ring is only touched by port_char_recv_req (producer, with rx_req_lock held) and user (consumer),
+ * layout is defined by struct ccci_rx_ring_hdr in mt_ccci_common.h.
+ */
+#define CHAR_RX_RING_MAX_SIZE (4 << 20)
+
+struct char_rx_ring {
+	struct ccci_rx_ring_hdr *hdr;
+	unsigned char *data;
+	unsigned int size;
+	unsigned int head;	/* our own copy of hdr->head, user may scribble the shared one */
+};
+
+static unsigned int char_rx_ring_watermark(struct char_rx_ring *ring)
+{
+	unsigned int wm = ACCESS_ONCE(ring->hdr->watermark);
+
+	if (wm == 0)
+		return 1;
+	return wm > ring->size ? ring->size : wm;
+}
+
+/*
+ * caller should lock with port->rx_req_lock
+ * return 1 if the ring reached its watermark, 0 if queued silently, -ENOSPC if ring is full
+ */
+static int char_rx_ring_queue(struct ccci_port *port, struct char_rx_ring *ring, struct sk_buff *skb)
+{
+	struct ccci_header *ccci_h = (struct ccci_header *)skb->data;
+	struct ccci_rx_ring_rec *rec;
+	unsigned int tail, used, off, rec_len, pad = 0;
+	int skip = 0;
+
+	if (!(port->flags & PORT_F_USER_HEADER))
+		skip = sizeof(struct ccci_header);
+	if (skb->len < skip)
+		return -EINVAL;
+	rec_len = ALIGN(sizeof(*rec) + skb->len - skip, CCCI_RX_RING_ALIGN);
+	if (rec_len > ring->size)
+		return -E2BIG;
+
+	tail = ACCESS_ONCE(ring->hdr->tail);
+	/* read tail before overwriting the space user has released */
+	smp_mb();
+	used = ring->head - tail;
+	if (used > ring->size)
+		return -EINVAL;	/* tail broken by user */
+	off = ring->head & (ring->size - 1);
+	if (off + rec_len > ring->size)
+		pad = ring->size - off;
+	if (used + pad + rec_len > ring->size)
+		return -ENOSPC;
+
+	if (pad) {
+		rec = (struct ccci_rx_ring_rec *)(ring->data + off);
+		rec->len = pad - sizeof(*rec);
+		rec->channel = CCCI_RX_RING_PAD;
+		off = 0;
+	}
+	rec = (struct ccci_rx_ring_rec *)(ring->data + off);
+	rec->len = skb->len - skip;
+	rec->channel = ccci_h->channel;
+	skb_copy_bits(skb, skip, rec + 1, rec->len);
+	/* record must be visible before head moves over it */
+	smp_wmb();
+	ring->head += pad + rec_len;
+	ACCESS_ONCE(ring->hdr->head) = ring->head;
+
+	return (used + pad + rec_len >= char_rx_ring_watermark(ring));
+}
+
+static unsigned int char_rx_ring_poll(struct ccci_port *port)
+{
+	struct char_rx_ring *ring;
+	unsigned int mask = 0, used;
+	unsigned long flags;
+
+	spin_lock_irqsave(&port->rx_req_lock, flags);
+	ring = port->rx_ring;
+	used = ring->head - ACCESS_ONCE(ring->hdr->tail);
+	if (used >= char_rx_ring_watermark(ring))
+		mask |= POLLIN | POLLRDNORM;
+	/* user has released some space, resume the queue we rejected before */
+	if (used < ring->size)
+		ccci_port_ask_more_request(port);
+	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+	return mask;
+}
+
+static int char_rx_ring_setup(struct ccci_port *port, unsigned int size)
+{
+	struct char_rx_ring *ring;
+	struct ccci_request *req, *reqn;
+	unsigned long flags;
+
+	if (port->rx_ch == CCCI_IPC_RX || port->rx_ch == CCCI_RPC_RX)
+		return -EINVAL;
+	if (size < PAGE_SIZE || size > CHAR_RX_RING_MAX_SIZE || (size & (size - 1)))
+		return -EINVAL;
+	if (port->rx_ring)
+		return -EBUSY;
+
+	ring = kzalloc(sizeof(struct char_rx_ring), GFP_KERNEL);
+	if (ring == NULL)
+		return -ENOMEM;
+	ring->hdr = vmalloc_user(CCCI_RX_RING_HDR_SIZE + size);
+	if (ring->hdr == NULL) {
+		kfree(ring);
+		return -ENOMEM;
+	}
+	ring->data = (unsigned char *)ring->hdr + CCCI_RX_RING_HDR_SIZE;
+	ring->size = size;
+	ring->hdr->magic = CCCI_RX_RING_MAGIC;
+	ring->hdr->size = size;
+	ring->hdr->data_offset = CCCI_RX_RING_HDR_SIZE;
+	ring->hdr->watermark = size / 4;
+
+	spin_lock_irqsave(&port->rx_req_lock, flags);
+	/* packets already queued go to the ring first, keep the order */
+	list_for_each_entry_safe(req, reqn, &port->rx_req_list, entry) {
+		if (req->state == PARTIAL_READ || char_rx_ring_queue(port, ring, req->skb) < 0)
+			ring->hdr->dropped++;
+		list_del(&req->entry);
+		port->rx_length--;
+		req->policy = RECYCLE;
+		ccci_free_req(req);
+	}
+	port->rx_ring = ring;
+	ccci_port_ask_more_request(port);
+	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+	CCCI_INF_MSG(port->modem->index, CHAR, "port %s Rx ring %d bytes\n", port->name, size);
+	return 0;
+}
+
+static void char_rx_ring_release(struct ccci_port *port)
+{
+	struct char_rx_ring *ring;
+	unsigned long flags;
+
+	spin_lock_irqsave(&port->rx_req_lock, flags);
+	ring = port->rx_ring;
+	port->rx_ring = NULL;
+	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+	if (ring == NULL)
+		return;
+	CCCI_INF_MSG(port->modem->index, CHAR, "port %s Rx ring released, dropped=%d\n", port->name,
+		     ring->hdr->dropped);
+	/* release is only called after user's mapping is gone, as VMA holds the file */
+	vfree(ring->hdr);
+	kfree(ring);
+}
+
+static int dev_char_mmap(struct file *fp, struct vm_area_struct *vma)
+{
+	struct ccci_port *port = fp->private_data;
+	struct char_rx_ring *ring = port->rx_ring;
+
+	if (ring == NULL || vma->vm_pgoff)
+		return -EINVAL;
+	return remap_vmalloc_range(vma, ring->hdr, 0);
+}
+#endif
+
 static void dev_char_open_check(struct ccci_port *port)
 {
 	if (port->rx_ch == CCCI_FS_RX)
@@ -118,6 +288,9 @@ static int dev_char_close(struct inode *inode, struct file *file)
 	/* 1.3 flush Rx */
 	ccci_port_ask_more_request(port);
 	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+#ifdef FEATURE_CHAR_RX_RING
+	char_rx_ring_release(port);
+#endif
 	CCCI_INF_MSG(port->modem->index, CHAR, "port %s close rx_len=%d empty=%d\n", port->name,
 		     port->rx_length, list_empty(&port->rx_req_list));
 	/* 2. check critical nodes for reset, run close check first,
@@ -164,6 +337,10 @@ static ssize_t dev_char_read(struct file *file, char *buf, size_t count, loff_t
 	int ret = 0, read_len = 0, full_req_done = 0;
 	unsigned long flags = 0;
 
+#ifdef FEATURE_CHAR_RX_RING
+	if (port->rx_ring)
+		return -EINVAL;	/* user should consume from mmap Rx ring */
+#endif
 	/* 1. get incoming request */
 	if (list_empty(&port->rx_req_list)) {
 		if (!(file->f_flags & O_NONBLOCK)) {
@@ -832,6 +1009,22 @@ static long dev_char_ioctl(struct file *file, unsigned int cmd, unsigned long ar
 		;
 		ret = 0;
 		break;
+	case CCCI_IOC_RX_RING_SETUP:
+#ifdef FEATURE_CHAR_RX_RING
+		{
+			unsigned int rx_ring_size;
+
+			if (copy_from_user(&rx_ring_size, (void __user *)arg, sizeof(unsigned int))) {
+				CCCI_INF_MSG(md->index, CHAR, "CCCI_IOC_RX_RING_SETUP: copy_from_user fail\n");
+				ret = -EFAULT;
+			} else {
+				ret = char_rx_ring_setup(port, rx_ring_size);
+			}
+		}
+#else
+		ret = -ENOTTY;
+#endif
+		break;
 	case CCCI_IOC_UPDATE_SIM_SLOT_CFG:
 		if (copy_from_user(&sim_slot_cfg, (void __user *)arg, sizeof(sim_slot_cfg))) {
 			CCCI_INF_MSG(md->index, CHAR, "CCCI_IOC_UPDATE_SIM_SLOT_CFG: copy_from_user fail!\n");
@@ -1009,6 +1202,11 @@ unsigned int dev_char_poll(struct file *fp, struct poll_table_struct *poll)
 	} else {
 		poll_wait(fp, &port->rx_wq, poll);
 		/* TODO: lack of poll wait for Tx */
+#ifdef FEATURE_CHAR_RX_RING
+		if (port->rx_ring)
+			mask |= char_rx_ring_poll(port);
+		else
+#endif
 		if (!list_empty(&port->rx_req_list))
 			mask |= POLLIN | POLLRDNORM;
 		if (port->modem->ops->write_room(port->modem, PORT_TXQ_INDEX(port)) > 0)
@@ -1035,6 +1233,9 @@ static const struct file_operations char_dev_fops = {
 	.compat_ioctl = &dev_char_compat_ioctl,
 #endif
 	.poll = &dev_char_poll,
+#ifdef FEATURE_CHAR_RX_RING
+	.mmap = &dev_char_mmap,
+#endif
 };
 
 static int port_char_init(struct ccci_port *port)
@@ -1112,6 +1313,9 @@ retry_push:
 static int port_char_recv_req(struct ccci_port *port, struct ccci_request *req)
 {
 	unsigned long flags;	/* as we can not tell the context, use spin_lock_irqsafe for safe */
+#ifdef FEATURE_CHAR_RX_RING
+	int ret;
+#endif
 
 	if (!atomic_read(&port->usage_cnt) &&
 		(port->rx_ch != CCCI_UART2_RX && port->rx_ch != CCCI_C2K_AT && port->rx_ch != CCCI_PCM_RX &&
@@ -1128,6 +1332,31 @@ static int port_char_recv_req(struct ccci_port *port, struct ccci_request *req)
 
 	CCCI_DBG_MSG(port->modem->index, CHAR, "recv on %s, len=%d\n", port->name, port->rx_length);
 	spin_lock_irqsave(&port->rx_req_lock, flags);
+#ifdef FEATURE_CHAR_RX_RING
+	if (port->rx_ring) {
+		ret = char_rx_ring_queue(port, port->rx_ring, req->skb);
+		if (ret >= 0) {
+			port->flags &= ~PORT_F_RX_FULLED;
+			spin_unlock_irqrestore(&port->rx_req_lock, flags);
+			list_del(&req->entry);
+			req->policy = RECYCLE;
+			ccci_free_req(req);
+			if (ret) {
+				wake_lock_timeout(&port->rx_wakelock, HZ);
+				wake_up_all(&port->rx_wq);
+			}
+			return 0;
+		}
+		if (ret == -ENOSPC && !(port->flags & PORT_F_ALLOW_DROP)) {
+			port->flags |= PORT_F_RX_FULLED;
+			spin_unlock_irqrestore(&port->rx_req_lock, flags);
+			return -CCCI_ERR_PORT_RX_FULL;
+		}
+		((struct char_rx_ring *)port->rx_ring)->hdr->dropped++;
+		spin_unlock_irqrestore(&port->rx_req_lock, flags);
+		goto drop;
+	}
+#endif
 	if (port->rx_length < port->rx_length_th) {
 		port->flags &= ~PORT_F_RX_FULLED;
 		port->rx_length++;
@@ -531,7 +531,8 @@ static int port_net_init(struct ccci_port *port)
 #endif
 	dev->addr_len = ETH_ALEN;	/* ethernet header size */
 	dev->destructor = free_netdev;
-	dev->hard_header_len += sizeof(struct ccci_header);	/* reserve Tx CCCI header room */
+	/* reserve Tx CCCI header room, kept out of hard_header_len for GRO */
+	dev->needed_headroom += sizeof(struct ccci_header);
 	dev->netdev_ops = &ccmni_netdev_ops;
 
 	temp = netdev_priv(dev);
@@ -619,7 +620,10 @@ static int port_net_recv_skb(struct ccci_port *port, struct sk_buff *skb)
 		skb->mark |= (0x1<<28);
 #endif
 	}
-	skb->ip_summed = CHECKSUM_NONE;
+	if (md->capability & MODEM_CAP_RX_CSUM)
+		skb->ip_summed = CHECKSUM_UNNECESSARY;
+	else
+		skb->ip_summed = CHECKSUM_NONE;
 #ifdef CCCI_SKB_TRACE
 	md->netif_rx_profile[3] = sched_clock();
 #endif
@@ -4,13 +4,27 @@
 #include <linux/delay.h>
 #include <linux/platform_device.h>
 #include <linux/sched.h>
+#include <linux/moduleparam.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
 #include "mach/mt_emi_bm.h"
 #include "mach/mt_mem_bw.h"
+#ifdef CONFIG_MTK_EMI_BWL
+#include "mach/emi_bwl.h"
+#endif
+#include "mt_vcorefs_manager.h"
+#include "mt_dcm.h"
 #include <asm/div64.h>
 
 unsigned long long last_time_ns;
 long long LastWordAllCount = 0;
 
+/* serializes readers that pause and reset the EMI monitor counters */
+static DEFINE_SPINLOCK(mem_bw_lock);
+static bool mem_bw_qos_running;
+static unsigned long long mem_bw_qos_total;
+
 /***********************************************
  * register / unregister g_pGetMemBW CB
  ***********************************************/
@@ -31,14 +45,49 @@ void mt_getmembw_registerCB(getmembw_func pCB)
 }
 EXPORT_SYMBOL(mt_getmembw_registerCB);
 
+/*
+ * Reset all monitor counters and start a new sampling window.
+ * Called with mem_bw_lock held and EMI dcm disabled.
+ */
+static void mem_bw_restart(void)
+{
+	int count;
+	long long value;
+
+	/* stopping EMI monitors will reset all counters */
+	BM_Enable(0);
+
+	value = BM_GetWordAllCount();
+	count = 100;
+	if ((value != 0) && (value > 0xB0000000)) {
+		do {
+			value = BM_GetWordAllCount();
+			if (value != 0) {
+				count--;
+				BM_Enable(1);
+				BM_Enable(0);
+			} else
+				break;
+
+		} while (count > 0);
+	}
+	LastWordAllCount = value;
+
+	/*pr_err("[get_mem_bw]loop count = %d,
+		last_word_all_count = 0x%llx\n", count, LastWordAllCount); */
+
+	/* start EMI monitor counting */
+	BM_Enable(1);
+	last_time_ns = sched_clock();
+}
+
 unsigned long long get_mem_bw(void)
 {
 	unsigned long long throughput;
 	long long WordAllCount;
 	unsigned long long current_time_ns, time_period_ns;
-	int count;
-	long long value;
 	int emi_dcm_disable;
+	unsigned long flags;
 
 #if DISABLE_FLIPPER_FUNC
 	return 0;
@@ -47,6 +96,12 @@ unsigned long long get_mem_bw(void)
 	if (g_pGetMemBW)
 		return g_pGetMemBW();
 
+	/* the QoS sampler owns the counters, hand out its last total */
+	if (ACCESS_ONCE(mem_bw_qos_running))
+		return ACCESS_ONCE(mem_bw_qos_total);
+
+	spin_lock_irqsave(&mem_bw_lock, flags);
+
 	emi_dcm_disable = BM_GetEmiDcm();
 	/* pr_err("[get_mem_bw]emi_dcm_disable = %d\n", emi_dcm_disable); */
 	current_time_ns = sched_clock();
@@ -91,40 +146,265 @@ unsigned long long get_mem_bw(void)
 	WordAllCount_delta = 0x%llx, LastWordAllCount = 0x%llx\n",
 	throughput, WordAllCount, LastWordAllCount); */
 
-	/* stopping EMI monitors will reset all counters */
-	BM_Enable(0);
+	mem_bw_restart();
 
-	value = BM_GetWordAllCount();
-	count = 100;
-	if ((value != 0) && (value > 0xB0000000)) {
-		do {
-			value = BM_GetWordAllCount();
-			if (value != 0) {
-				count--;
-				BM_Enable(1);
-				BM_Enable(0);
-			} else
-				break;
+	/* restore_infra_dcm();*/
+	BM_SetEmiDcm(emi_dcm_disable);
 
-		} while (count > 0);
-	}
-	LastWordAllCount = value;
+	spin_unlock_irqrestore(&mem_bw_lock, flags);
 
-	/*pr_err("[get_mem_bw]loop count = %d,
-		last_word_all_count = 0x%llx\n", count, LastWordAllCount); */
+	/*pr_err("[get_mem_bw]throughput = %llx\n", throughput);*/
 
-	/* start EMI monitor counting */
-	BM_Enable(1);
-	last_time_ns = sched_clock();
+	return throughput;
+}
+
+/***********************************************
+ * EMI bandwidth QoS
+ *
+ * Samples the per-master monitor counters every qos_period_ms and protects
+ * the latency sensitive masters (display/MM and modem) from CPU and GPU
+ * traffic: when their average latency goes above the limit, the matching
+ * EMI bandwidth limiter scenario is enabled, and released again after
+ * qos_release_samples calm samples. The total demand and the DRAM page hit
+ * rate are handed to the vcore DVFS governor, which picks the OPP from them.
+ ***********************************************/
+static const char * const mem_bw_master_name[NR_MEM_BW_MASTER] = {
+	"cpu", "gpu", "mm", "md"
+};
+
+/* word counters set up in mon_kernel_init() */
+static const unsigned int mem_bw_word_counter[NR_MEM_BW_MASTER] = {
+	2, 4, 1, 3
+};
+
+/* latency counter masters m0..m6 (BM_MASTER_* bit order) */
+static const unsigned int mem_bw_lat_master[NR_MEM_BW_MASTER] = {
+	BM_MASTER_AP_MCU1 | BM_MASTER_AP_MCU2,
+	BM_MASTER_GPU1,
+	BM_MASTER_MM1 | BM_MASTER_MM2,
+	BM_MASTER_MD_MCU | BM_MASTER_2G_3G_MDDMA,
+};
+
+struct mem_bw_qos_stat {
+	unsigned int mbps[NR_MEM_BW_MASTER];
+	unsigned int lat[NR_MEM_BW_MASTER];	/* EMI cycles per transaction */
+	unsigned int total_mbps;
+	unsigned int page_hit_pct;
+};
+
+/* toggled through the mem_bw_qos driver attribute */
+static int qos_enable = 1;
+static int qos_period_ms = 50;
+static int qos_release_samples = 10;
+static int qos_mm_lat = 120;
+static int qos_md_lat = 150;
+module_param(qos_period_ms, int, 0644);
+module_param(qos_release_samples, int, 0644);
+module_param(qos_mm_lat, int, 0644);
+module_param(qos_md_lat, int, 0644);
+
+static struct mem_bw_qos_stat mem_bw_qos_stat;
+static bool mem_bw_qos_mm_on, mem_bw_qos_md_on;
+static int mem_bw_qos_calm;
+/* DRAMC page counters are free running, keep the last raw values */
+static unsigned int mem_bw_page_hit, mem_bw_page_miss;
+static DEFINE_MUTEX(mem_bw_qos_lock);
+
+static void mem_bw_qos_work_fn(struct work_struct *work);
+static DECLARE_DEFERRABLE_WORK(mem_bw_qos_work, mem_bw_qos_work_fn);
+
+static void mem_bw_qos_sample(struct mem_bw_qos_stat *stat)
+{
+	unsigned long long period_ns, bytes;
+	unsigned int lat_cyc[NR_MEM_BW_MASTER] = { 0 };
+	unsigned int lat_cnt[NR_MEM_BW_MASTER] = { 0 };
+	int words[NR_MEM_BW_MASTER];
+	unsigned int page_hit, page_miss;
+	int emi_dcm_disable;
+	unsigned long flags;
+	int i, m;
+
+	spin_lock_irqsave(&mem_bw_lock, flags);
+
+	emi_dcm_disable = BM_GetEmiDcm();
+	BM_SetEmiDcm(0xff);	/* disable EMI dcm */
+
+	BM_Pause();
+	period_ns = sched_clock() - last_time_ns;
+	for (i = 0; i < NR_MEM_BW_MASTER; i++)
+		words[i] = BM_GetWordCount(mem_bw_word_counter[i]);
+	for (m = 0; m < 7; m++) {
+		for (i = 0; i < NR_MEM_BW_MASTER; i++) {
+			if (mem_bw_lat_master[i] & (1 << m)) {
+				lat_cyc[i] += BM_GetLatencyCycle(m + 1);
+				lat_cnt[i] += BM_GetLatencyCycle(m + 9);
+			}
+		}
+	}
+	mem_bw_restart();
 
-	/* restore_infra_dcm();*/
 	BM_SetEmiDcm(emi_dcm_disable);
 
-	/*pr_err("[get_mem_bw]throughput = %llx\n", throughput);*/
+	spin_unlock_irqrestore(&mem_bw_lock, flags);
+
+	page_hit = DRAMC_GetPageHitCount(DRAMC_ALL);
+	page_miss = DRAMC_GetPageMissCount(DRAMC_ALL);
+	stat->page_hit_pct = 100;
+	if (page_hit - mem_bw_page_hit + page_miss - mem_bw_page_miss)
+		stat->page_hit_pct = (unsigned long long)
+			(page_hit - mem_bw_page_hit) * 100 /
+			(page_hit - mem_bw_page_hit + page_miss - mem_bw_page_miss);
+	mem_bw_page_hit = page_hit;
+	mem_bw_page_miss = page_miss;
+
+	/* MB/s = words * 8 / (period_ns / 1000) */
+	do_div(period_ns, 1000);
+	stat->total_mbps = 0;
+	for (i = 0; i < NR_MEM_BW_MASTER; i++) {
+		stat->mbps[i] = 0;
+		if (words[i] > 0 && period_ns) {
+			bytes = (unsigned long long)words[i] * 8;
+			do_div(bytes, period_ns);
+			stat->mbps[i] = bytes;
+		}
+		stat->total_mbps += stat->mbps[i];
+		stat->lat[i] = lat_cnt[i] ? lat_cyc[i] / lat_cnt[i] : 0;
+	}
+}
 
-	return throughput;
+/* mem_bw_qos_lock held */
+static void mem_bw_qos_apply(bool mm, bool md)
+{
+#ifdef CONFIG_MTK_EMI_BWL
+	if (mm != mem_bw_qos_mm_on)
+		mtk_mem_bw_ctrl(CON_SCE_VSS,
+				mm ? ENABLE_CON_SCE : DISABLE_CON_SCE);
+	if (md != mem_bw_qos_md_on)
+		mtk_mem_bw_ctrl(CON_SCE_MD_STDALN,
+				md ? ENABLE_CON_SCE : DISABLE_CON_SCE);
+#endif
+
+	mem_bw_qos_mm_on = mm;
+	mem_bw_qos_md_on = md;
+}
+
+static void mem_bw_qos_work_fn(struct work_struct *work)
+{
+	struct mem_bw_qos_stat stat;
+	bool mm, md;
+
+	mutex_lock(&mem_bw_qos_lock);
+
+	if (!mem_bw_qos_running) {
+		mutex_unlock(&mem_bw_qos_lock);
+		return;
+	}
+
+	mem_bw_qos_sample(&stat);
+	mem_bw_qos_stat = stat;
+	ACCESS_ONCE(mem_bw_qos_total) = stat.total_mbps;
+
+	/* a master is only starved if others are competing with it */
+	mm = stat.lat[MEM_BW_MM] > qos_mm_lat &&
+		stat.mbps[MEM_BW_CPU] + stat.mbps[MEM_BW_GPU] >
+		stat.mbps[MEM_BW_MM];
+	md = stat.mbps[MEM_BW_MD] && stat.lat[MEM_BW_MD] > qos_md_lat;
+
+	if (mm || md) {
+		mem_bw_qos_calm = 0;
+		/* engage right away, keep what is already on */
+		mem_bw_qos_apply(mm || mem_bw_qos_mm_on,
+				 md || mem_bw_qos_md_on);
+	} else if (++mem_bw_qos_calm >= qos_release_samples) {
+		mem_bw_qos_apply(false, false);
+	}
+
+	vcorefs_update_bw_demand(stat.total_mbps, stat.page_hit_pct);
+	mt_dcm_update_bw(stat.total_mbps, stat.mbps[MEM_BW_MM]);
+
+	if (qos_enable)
+		queue_delayed_work(system_freezable_power_efficient_wq,
+				   &mem_bw_qos_work,
+				   msecs_to_jiffies(qos_period_ms));
+	else {
+		mem_bw_qos_apply(false, false);
+		vcorefs_stop_bw_demand();
+		mt_dcm_stop_bw();
+		mem_bw_qos_running = false;
+	}
+
+	mutex_unlock(&mem_bw_qos_lock);
+}
+
+static void mem_bw_qos_start(void)
+{
+	mutex_lock(&mem_bw_qos_lock);
+	if (!mem_bw_qos_running) {
+		mem_bw_qos_running = true;
+		mem_bw_qos_calm = 0;
+		queue_delayed_work(system_freezable_power_efficient_wq,
+				   &mem_bw_qos_work,
+				   msecs_to_jiffies(qos_period_ms));
+	}
+	mutex_unlock(&mem_bw_qos_lock);
 }
 
+static ssize_t mem_bw_qos_show(struct device_driver *driver, char *buf)
+{
+	struct mem_bw_qos_stat stat;
+	ssize_t len = 0;
+	int i;
+
+	mutex_lock(&mem_bw_qos_lock);
+	stat = mem_bw_qos_stat;
+	len += snprintf(buf + len, PAGE_SIZE - len,
+			"running=%d mm_prio=%d md_prio=%d\n",
+			mem_bw_qos_running, mem_bw_qos_mm_on,
+			mem_bw_qos_md_on);
+	mutex_unlock(&mem_bw_qos_lock);
+
+	for (i = 0; i < NR_MEM_BW_MASTER; i++)
+		len += snprintf(buf + len, PAGE_SIZE - len,
+				"%s: %u MB/s, latency %u cycles\n",
+				mem_bw_master_name[i], stat.mbps[i],
+				stat.lat[i]);
+	len += snprintf(buf + len, PAGE_SIZE - len,
+			"total: %u MB/s, page hit %u%%\n",
+			stat.total_mbps, stat.page_hit_pct);
+
+	return len;
+}
+
+static ssize_t mem_bw_qos_store(struct device_driver *driver,
+				const char *buf, size_t count)
+{
+	int val;
+
+	if (kstrtoint(buf, 10, &val))
+		return -EINVAL;
+
+	qos_enable = !!val;
+	if (qos_enable)
+		mem_bw_qos_start();
+
+	return count;
+}
+
+DRIVER_ATTR(mem_bw_qos, 0644, mem_bw_qos_show, mem_bw_qos_store);
+
+/*
+ * Per-master bandwidth of the last QoS sample in MB/s, for telemetry.
+ * Returns 0 when the QoS sampler is not running.
+ */
+unsigned int get_mem_bw_master(int master)
+{
+	if (master < 0 || master >= NR_MEM_BW_MASTER)
+		return 0;
+
+	return ACCESS_ONCE(mem_bw_qos_stat.mbps[master]);
+}
+EXPORT_SYMBOL(get_mem_bw_master);
+
 static int mem_bw_suspend_callback(struct device *dev)
 {
 	/*pr_err("[get_mem_bw]mem_bw_suspend_callback\n");*/
@@ -208,7 +488,15 @@ static int __init mon_kernel_init(void)
 	if (ret) {
 		pr_err("fail to register mem_bw driver @ %s()\n", __func__);
 		platform_device_unregister(&mt_mem_bw_pdev);
+		goto out;
 	}
+
+	if (driver_create_file(&mt_mem_bw_pdrv.driver,
+			       &driver_attr_mem_bw_qos))
+		pr_err("fail to create mem_bw_qos sysfs file\n");
+
+	if (qos_enable)
+		mem_bw_qos_start();
 out:
 	return ret;
 }
@@ -37,6 +37,7 @@
 #include "disp_lowpower.h"
 #include "display_recorder.h"
 #include "extd_info.h"
+#include "primary_display.h"
 
 int ext_disp_use_cmdq;
 int ext_disp_use_m4u;
@@ -733,6 +734,76 @@ static unsigned int cmdqDdpResetEng(uint64_t engineFlag)
 }
 */
 
+/*
+ * Zero-copy mirror: with direct_mirror set, the frames the primary path
+ * writes out through WDMA in decouple mirror mode are scanned out by RDMA1
+ * as they are, without a round trip through user space. There is no scaler
+ * on this path, so only frames of the external timing's size are taken;
+ * other sizes keep going through user space and MDP.
+ */
+static int direct_mirror;
+module_param(direct_mirror, int, 0644);
+
+/* wdma fence of the mirror frame RDMA1 is scanning out */
+static unsigned int mirror_fence_idx;
+
+static int _ext_disp_mirror_release(unsigned long fence_idx)
+{
+	if (fence_idx)
+		primary_display_release_mirror_fence(fence_idx);
+
+	return 0;
+}
+
+static int _ext_disp_mirror_frame(disp_mem_output_config *out)
+{
+	disp_ddp_path_config *data_config;
+	RDMA_CONFIG_STRUCT *rdma;
+
+	if (!direct_mirror || !ext_disp_cmdq_enabled() || _should_config_ovl_input())
+		return -1;
+
+	if (out->w != extd_lcm_params.dpi.width || out->h != extd_lcm_params.dpi.height)
+		return -1;
+
+	_ext_disp_path_lock();
+
+	if ((pgc->state != EXTD_INIT && pgc->state != EXTD_RESUME) ||
+	    DISP_SESSION_DEV(pgc->session) != DEV_MHL + 1) {
+		_ext_disp_path_unlock();
+		return -1;
+	}
+
+	data_config = dpmgr_path_get_last_config(pgc->dpmgr_handle);
+	rdma = &data_config->rdma_config;
+	rdma->idx = out->buff_idx;
+	rdma->address = out->addr;
+	rdma->pitch = out->pitch;
+	rdma->inputFormat = out->fmt;
+	rdma->security = out->security;
+	rdma->width = out->w;
+	rdma->height = out->h;
+	rdma->dst_x = 0;
+	rdma->dst_y = 0;
+	rdma->dst_w = extd_lcm_params.dpi.width;
+	rdma->dst_h = extd_lcm_params.dpi.height;
+	data_config->rdma_dirty = 1;
+	pgc->need_trigger_overlay = 1;
+
+	memcpy(&(data_config->dispif_config), &extd_lcm_params, sizeof(LCM_PARAMS));
+	dpmgr_path_config(pgc->dpmgr_handle, data_config, pgc->cmdq_handle_config);
+
+	/* the previous frame is free once RDMA1 has latched this one */
+	_ext_disp_trigger(0, _ext_disp_mirror_release, mirror_fence_idx);
+	mirror_fence_idx = out->buff_idx;
+	pgc->state = EXTD_RESUME;
+
+	_ext_disp_path_unlock();
+
+	MMProfileLogEx(ddp_mmp_get_events()->Extd_State, MMProfileFlagPulse, Trigger, out->buff_idx);
+	return 0;
+}
+
 void ext_disp_probe(void)
 {
 	EXT_DISP_FUNC();
@@ -825,6 +896,8 @@ int ext_disp_init(char *lcm_name, unsigned int session)
 	mutex_init(&(pgc->vsync_lock));
 	pgc->state = EXTD_INIT;
 	pgc->ovl_req_state = EXTD_OVL_NO_REQ;
+	mirror_fence_idx = 0;
+	primary_display_register_mirror_client(_ext_disp_mirror_frame);
  done:
 
 	_ext_disp_path_unlock();
@@ -839,6 +912,8 @@ int ext_disp_deinit(unsigned int session)
 {
 	EXT_DISP_FUNC();
 
+	primary_display_register_mirror_client(NULL);
+
 	_ext_disp_path_lock();
 
 	if (pgc->state == EXTD_DEINIT)
@@ -853,6 +928,9 @@ int ext_disp_deinit(unsigned int session)
 	cmdqRecDestroy(pgc->cmdq_handle_config);
 	cmdqRecDestroy(pgc->cmdq_handle_trigger);
 
+	_ext_disp_mirror_release(mirror_fence_idx);
+	mirror_fence_idx = 0;
+
 	pgc->state = EXTD_DEINIT;
 
  deinit_exit:
@@ -72,12 +72,36 @@ typedef struct GED_DVFS_FREQ_DATA_TAG
     unsigned long ulFreq;    
 }GED_DVFS_FREQ_DATA;
 
+/*
+ * Per GPU context busy time, one record per live context. Counters are
+ * cumulative since the context was created; readers diff two snapshots.
+ * ui64BusyUs sums the job slot time of the context, so jobs running on
+ * several slots at once count once per slot.
+ */
+typedef struct GED_DVFS_CTX_UTIL_TAG
+{
+    int32_t  i32Pid;
+    int32_t  i32Tgid;
+    uint32_t ui32CtxID;
+    uint32_t ui32Jobs;
+    uint64_t ui64BusyUs;
+}GED_DVFS_CTX_UTIL;
+
+#define GED_DVFS_CTX_UTIL_VERSION 1
+#define GED_DVFS_CTX_UTIL_MAX 64
+
 
 bool ged_dvfs_cal_gpu_utilization(unsigned int* pui32Loading , unsigned int* pui32Block,unsigned int* pui32Idle);
 void ged_dvfs_cal_gpu_utilization_force(void);
 
+/* fills up to i32Max records, returns how many were filled */
+int ged_dvfs_get_gpu_ctx_util(GED_DVFS_CTX_UTIL* psUtil, int i32Max);
+
 void ged_dvfs_run(unsigned long t, long phase, unsigned long ul3DFenceDoneTime);
 
+/* a 3D fence submitted at ulSubmit_us signaled at ulDone_us */
+void ged_dvfs_frame_done(unsigned long ulSubmit_us, unsigned long ulDone_us);
+
 void ged_dvfs_set_tuning_mode(GED_DVFS_TUNING_MODE eMode);
 GED_DVFS_TUNING_MODE ged_dvfs_get_tuning_mode(void);
 
@@ -85,6 +109,9 @@ void ged_dvfs_vsync_offset_event_switch(GED_DVFS_VSYNC_OFFSET_SWITCH_CMD eEvent,
 void ged_dvfs_vsync_offset_level_set(int i32level);
 int ged_dvfs_vsync_offset_level_get(void);
 
+/* display refresh rate, sets the vsync period used as the DVFS window */
+void set_target_fps(int i32FPS);
+
 unsigned int ged_dvfs_get_gpu_loading(void);
 unsigned int ged_dvfs_get_gpu_blocking(void);
 unsigned int ged_dvfs_get_gpu_idle(void);
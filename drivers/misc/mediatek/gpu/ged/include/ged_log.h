@@ -17,6 +17,8 @@ typedef enum GED_LOG_BUF_TYPE_TAG
     GED_LOG_BUF_TYPE_RINGBUFFER,
     GED_LOG_BUF_TYPE_QUEUEBUFFER,
     GED_LOG_BUF_TYPE_QUEUEBUFFER_AUTO_INCREASE,
+    /* ring buffer, lines staged per CPU and formatted when read */
+    GED_LOG_BUF_TYPE_RINGBUFFER_DEFERRED,
 } GED_LOG_BUF_TYPE;
 
 GED_LOG_BUF_HANDLE ged_log_buf_alloc(int i32MaxLineCount, int i32MaxBufferSizeByte, GED_LOG_BUF_TYPE eType, const char* pszName, const char* pszNodeName);
@@ -6,5 +6,6 @@
 GED_ERROR ged_monitor_3D_fence_add(int fence_fd);
 void ged_monitor_3D_fence_notify(void);
 unsigned long ged_monitor_3D_fence_done_time(void);
+unsigned long ged_monitor_3D_fence_pending_since(void);
 
 #endif
@@ -8,6 +8,7 @@
 
 #include <trace/events/mtk_events.h>
 #include <mt-plat/mtk_gpu_utility.h>
+#include <mt-plat/mtk_input_boost.h>
 
 #include <asm/siginfo.h>
 #include <linux/sched.h>
@@ -30,6 +31,12 @@
 	#define GED_DVFS_SKIP_ROUNDS 3 */
 #define GED_DVFS_SKIP_ROUNDS 3
 
+/* frame deadline policy: number of frames kept to predict the next one, and
+ * how many vsync periods without a finished frame before falling back to the
+ * loading based policy */
+#define GED_DVFS_DEADLINE_HISTORY 8
+#define GED_DVFS_DEADLINE_STALE_PERIODS 4
+
 extern GED_LOG_BUF_HANDLE ghLogBuf_DVFS;
 extern GED_LOG_BUF_HANDLE ghLogBuf_ged_srv;
 
@@ -51,6 +58,8 @@ static unsigned int  g_bottom_freq_id;
 
 static unsigned int  g_cust_upbound_freq_id;
 
+static unsigned int  g_input_boost_freq_id;
+
 #endif
 
 static unsigned int  g_computed_freq_id = 0;
@@ -87,6 +96,21 @@ static int g_VsyncOffsetLevel = 0;
 
 static int g_probe_pid=GED_NO_UM_SERVICE;
 
+static unsigned int gpu_dvfs_deadline = 1;
+static unsigned int gpu_dvfs_deadline_margin = 10; // percent of vsync period
+static unsigned int gpu_dvfs_cpu_boost = 1; // boost the CPU for CPU bound late frames
+static unsigned int gpu_late_frame_cpu = 0;
+static unsigned int gpu_late_frame_gpu = 0;
+
+#ifdef GED_DVFS_ENABLE
+// GPU cycles (render us * MHz) of the last frames, oldest overwritten first
+static unsigned long g_aulFrameCycles[GED_DVFS_DEADLINE_HISTORY];
+static unsigned int g_ui32FrameHead = 0;
+static unsigned int g_ui32FrameCount = 0;
+static unsigned long g_ulLastFrameDone_us = 0;
+static unsigned long g_ulLastFrameSubmit_us = 0;
+#endif
+
 
 
 typedef void (*gpufreq_input_boost_notify)(unsigned int );
@@ -98,6 +122,7 @@ extern void (*mtk_set_bottom_gpu_freq_fp)(unsigned int);
 extern unsigned int (*mtk_get_bottom_gpu_freq_fp)(void);
 extern unsigned int (*mtk_custom_get_gpu_freq_level_count_fp)(void);
 extern void (*mtk_custom_boost_gpu_freq_fp)(unsigned int ui32FreqLevel);
+extern void (*mtk_input_boost_gpu_freq_fp)(unsigned int ui32FreqLevel);
 extern void (*mtk_custom_upbound_gpu_freq_fp)(unsigned int ui32FreqLevel);
 extern unsigned int (*mtk_get_custom_boost_gpu_freq_fp)(void);
 extern unsigned int (*mtk_get_custom_upbound_gpu_freq_fp)(void);
@@ -180,6 +205,19 @@ bool ged_dvfs_cal_gpu_utilization(unsigned int* pui32Loading , unsigned int* pui
     return false;
 }
 
+//-----------------------------------------------------------------------------
+int (*ged_dvfs_get_gpu_ctx_util_fp)(GED_DVFS_CTX_UTIL* psUtil, int i32Max) = NULL;
+EXPORT_SYMBOL(ged_dvfs_get_gpu_ctx_util_fp);
+
+int ged_dvfs_get_gpu_ctx_util(GED_DVFS_CTX_UTIL* psUtil, int i32Max)
+{
+    if (NULL != ged_dvfs_get_gpu_ctx_util_fp)
+    {
+        return ged_dvfs_get_gpu_ctx_util_fp(psUtil, i32Max);
+    }
+    return 0;
+}
+
 //-----------------------------------------------------------------------------
 // void (*ged_dvfs_gpu_freq_commit_fp)(unsigned long ui32NewFreqID)
 // call back function
@@ -206,6 +244,10 @@ bool ged_dvfs_gpu_freq_commit(unsigned long ui32NewFreqID, GED_DVFS_COMMIT_TYPE
         {
             ui32NewFreqID = g_cust_boost_freq_id;
         }
+        if (ui32NewFreqID > g_input_boost_freq_id)
+        {
+            ui32NewFreqID = g_input_boost_freq_id;
+        }
 
         // up bound
         if (ui32NewFreqID < g_cust_upbound_freq_id)
@@ -408,6 +450,16 @@ GED_ERROR ged_dvfs_um_commit( unsigned long gpu_tar_freq, bool bFallback)
             ged_monitor_3D_fence_set_disable(GED_FALSE);
 
 
+#ifdef GED_DVFS_ENABLE
+    // the deadline policy owns the frequency while frames are coming in
+    if (ged_dvfs_deadline_fresh(g_ulCalResetTS_us))
+    {
+        g_ulWorkingPeriod_us = 0;
+        mutex_unlock(&gsDVFSLock);
+        return GED_OK;
+    }
+#endif
+
     ged_log_buf_print(ghLogBuf_DVFS, "[GED_K] rdy to commit (%u)",ui32NewFreqID);
 
     g_computed_freq_id = ui32NewFreqID;
@@ -509,6 +561,196 @@ static bool ged_dvfs_policy(
 }
 
 
+#ifdef GED_DVFS_ENABLE
+static unsigned long ged_dvfs_deadline_budget(void)
+{
+    return g_ulvsync_period * (100 - gpu_dvfs_deadline_margin) / 100;
+}
+
+static unsigned long ged_dvfs_deadline_predict(void)
+{
+    unsigned long ulSum = 0;
+    unsigned long ulMax = 0;
+    unsigned int i;
+
+    for (i = 0; i < g_ui32FrameCount; i++)
+    {
+        ulSum += g_aulFrameCycles[i];
+        if (g_aulFrameCycles[i] > ulMax)
+        {
+            ulMax = g_aulFrameCycles[i];
+        }
+    }
+
+    // halfway between mean and worst case, games alternate light and heavy frames
+    return (ulSum / g_ui32FrameCount + ulMax) / 2;
+}
+
+// lowest OPP whose predicted render time still fits the budget
+static unsigned int ged_dvfs_deadline_pick(unsigned long ulCycles)
+{
+    int i32MaxLevel = (int)(mt_gpufreq_get_dvfs_table_num() - 1);
+    unsigned long ulBudget_us = ged_dvfs_deadline_budget();
+    unsigned long ulFreqMHz;
+    int i;
+
+    for (i = i32MaxLevel; i > 0; i--)
+    {
+        ulFreqMHz = mt_gpufreq_get_freq_by_idx(i) / 1000;
+        if (ulFreqMHz && ulCycles / ulFreqMHz <= ulBudget_us)
+        {
+            break;
+        }
+    }
+
+    return (unsigned int)i;
+}
+
+static bool ged_dvfs_deadline_fresh(unsigned long t)
+{
+    if (0 == gpu_dvfs_deadline || 0 == g_ui32FrameCount || 0 == t)
+    {
+        return false;
+    }
+
+    return t - g_ulLastFrameDone_us <= GED_DVFS_DEADLINE_STALE_PERIODS * g_ulvsync_period;
+}
+
+/*
+ * Called on vsync. Returns false when there is no recent frame history, so
+ * the caller keeps using the loading based policy (UI idle, video, ...).
+ */
+static bool ged_dvfs_deadline_policy(unsigned long t, unsigned int* pui32NewFreqID)
+{
+    unsigned int ui32CurFreqID = mt_gpufreq_get_cur_freq_index();
+    unsigned long ulPendingSince = ged_monitor_3D_fence_pending_since();
+    unsigned long ulCycles;
+    unsigned long ulPending_us;
+
+    if (!ged_dvfs_deadline_fresh(t))
+    {
+        return false;
+    }
+
+    ulCycles = ged_dvfs_deadline_predict();
+
+    // a frame still rendering already used this much, it must finish in time
+    if (ulPendingSince && t > ulPendingSince)
+    {
+        if (ulPendingSince < g_ulLastFrameDone_us)
+        {
+            ulPendingSince = g_ulLastFrameDone_us;
+        }
+        ulPending_us = t - ulPendingSince;
+        if (ulPending_us * (mt_gpufreq_get_freq_by_idx(ui32CurFreqID) / 1000) > ulCycles)
+        {
+            ulCycles = ulPending_us * (mt_gpufreq_get_freq_by_idx(ui32CurFreqID) / 1000);
+        }
+    }
+
+    *pui32NewFreqID = ged_dvfs_deadline_pick(ulCycles);
+
+    ged_log_buf_print(ghLogBuf_DVFS, "[GED_K] deadline: cycles=%lu budget=%lu idx=%u",
+        ulCycles, ged_dvfs_deadline_budget(), *pui32NewFreqID);
+
+    return true;
+}
+#endif
+
+void ged_dvfs_frame_done(unsigned long ulSubmit_us, unsigned long ulDone_us)
+{
+#ifdef GED_DVFS_ENABLE
+    unsigned int ui32CurFreqID;
+    unsigned int ui32NewFreqID;
+    unsigned long ulStart_us;
+    unsigned long ulRender_us;
+    unsigned long ulInterval_us;
+    bool bLate;
+
+    mutex_lock(&gsDVFSLock);
+
+    /*
+     * Late frame: done more than a vsync period after the previous one, but
+     * not so long after that the animation had simply stopped. Classified
+     * by where the time went, see below.
+     */
+    bLate = g_ulLastFrameDone_us && ulDone_us > g_ulLastFrameDone_us &&
+        ulDone_us - g_ulLastFrameDone_us > g_ulvsync_period &&
+        ulDone_us - g_ulLastFrameDone_us <= GED_DVFS_DEADLINE_STALE_PERIODS * g_ulvsync_period;
+    ulInterval_us = g_ulLastFrameSubmit_us && ulSubmit_us > g_ulLastFrameSubmit_us ?
+        ulSubmit_us - g_ulLastFrameSubmit_us : 0;
+    if (ulSubmit_us > g_ulLastFrameSubmit_us)
+    {
+        g_ulLastFrameSubmit_us = ulSubmit_us;
+    }
+
+    // frames queue behind each other, count only the time this one was on the GPU
+    ulStart_us = ulSubmit_us > g_ulLastFrameDone_us ? ulSubmit_us : g_ulLastFrameDone_us;
+    if (ulDone_us <= ulStart_us)
+    {
+        goto EXIT_ged_dvfs_frame_done;
+    }
+
+    ulRender_us = ulDone_us - ulStart_us;
+    if (ulRender_us > 1000000)
+    {
+        ulRender_us = 1000000;
+    }
+
+    ui32CurFreqID = mt_gpufreq_get_cur_freq_index();
+    g_aulFrameCycles[g_ui32FrameHead] = ulRender_us * (mt_gpufreq_get_freq_by_idx(ui32CurFreqID) / 1000);
+    g_ui32FrameHead = (g_ui32FrameHead + 1) % GED_DVFS_DEADLINE_HISTORY;
+    if (g_ui32FrameCount < GED_DVFS_DEADLINE_HISTORY)
+    {
+        g_ui32FrameCount++;
+    }
+
+    /*
+     * GPU bound: the GPU itself took longer than the budget.
+     * CPU bound: the GPU was in time but the frame was submitted more than
+     * a vsync period after the previous one, RenderThread is the bottleneck
+     * and a GPU boost would only burn power.
+     */
+    if (bLate && ulRender_us <= ged_dvfs_deadline_budget() && ulInterval_us > g_ulvsync_period)
+    {
+        gpu_late_frame_cpu++;
+        ged_log_buf_print(ghLogBuf_DVFS, "[GED_K] late frame, CPU bound (interval=%lu us, render=%lu us)",
+            ulInterval_us, ulRender_us);
+        if (gpu_dvfs_cpu_boost)
+        {
+            frame_boost_cpu();
+        }
+        goto EXIT_ged_dvfs_frame_done;
+    }
+
+    if (bLate && ulRender_us > ged_dvfs_deadline_budget())
+    {
+        gpu_late_frame_gpu++;
+    }
+
+    // frame missed its budget: raise now instead of waiting for the next vsync
+    if (gpu_dvfs_deadline && gpu_dvfs_enable && 0 == g_iSkipCount &&
+        ulRender_us > ged_dvfs_deadline_budget())
+    {
+        ui32NewFreqID = ged_dvfs_deadline_pick(ged_dvfs_deadline_predict());
+        if (ui32NewFreqID < ui32CurFreqID)
+        {
+            ged_log_buf_print(ghLogBuf_DVFS, "[GED_K] deadline: frame at risk (%lu us), idx=%u",
+                ulRender_us, ui32NewFreqID);
+            g_computed_freq_id = ui32NewFreqID;
+            ged_dvfs_gpu_freq_commit(ui32NewFreqID, GED_DVFS_DEFAULT_COMMIT);
+        }
+    }
+
+EXIT_ged_dvfs_frame_done:
+    if (ulDone_us > g_ulLastFrameDone_us)
+    {
+        g_ulLastFrameDone_us = ulDone_us;
+    }
+    mutex_unlock(&gsDVFSLock);
+#endif
+}
+
 static void ged_dvfs_freq_input_boostCB(unsigned int ui32BoostFreqID)
 {
 #ifdef GED_DVFS_ENABLE
@@ -571,7 +813,11 @@ void ged_dvfs_boost_gpu_freq(void)
     {
 		GED_LOGE("%s", __func__);
     }
-    ged_dvfs_freq_input_boostCB(0);
+    // the input boost arbiter raises the GPU together with CPU and vcore
+    // and holds it until frames stop, see ged_dvfs_input_boost_gpu_freq();
+    // without it (or with it disabled) keep GED's own touch boost
+    if (!input_boost_kick())
+        ged_dvfs_freq_input_boostCB(0);
 }
 
 #ifdef GED_DVFS_ENABLE
@@ -608,6 +854,35 @@ static void ged_dvfs_set_bottom_gpu_freq(unsigned int ui32FreqLevel)
 }
 
 
+static void ged_dvfs_input_boost_gpu_freq(unsigned int ui32FreqLevel)
+{
+    unsigned int ui32MaxLevel;
+
+    if (gpu_debug_enable)
+    {
+		GED_LOGE("%s: freq = %d", __func__ ,ui32FreqLevel);
+    }
+
+    ui32MaxLevel = mt_gpufreq_get_dvfs_table_num() - 1;
+    if (ui32MaxLevel < ui32FreqLevel)
+    {
+        ui32FreqLevel = ui32MaxLevel;
+    }
+
+    mutex_lock(&gsDVFSLock);
+
+    // 0 => The highest frequency
+    // table_num - 1 => The lowest frequency
+    g_input_boost_freq_id = ui32MaxLevel - ui32FreqLevel;
+
+    if (g_input_boost_freq_id < mt_gpufreq_get_cur_freq_index())
+    {
+        ged_dvfs_gpu_freq_commit(g_input_boost_freq_id, GED_DVFS_INPUT_BOOST_COMMIT);
+    }
+
+    mutex_unlock(&gsDVFSLock);
+}
+
 static unsigned int ged_dvfs_get_gpu_freq_level_count(void)
 {
 
@@ -759,6 +1034,14 @@ void ged_dvfs_run(unsigned long t, long phase, unsigned long ul3DFenceDoneTime)
         g_ulCalResetTS_us = t;
         bError=ged_dvfs_cal_gpu_utilization(&gpu_loading, &gpu_block, &gpu_idle);
 
+#ifdef GED_DVFS_ENABLE
+        if (ged_dvfs_deadline_policy(t, &g_ui32FreqIDFromPolicy))
+        {
+            g_computed_freq_id = g_ui32FreqIDFromPolicy;
+            ged_dvfs_gpu_freq_commit(g_ui32FreqIDFromPolicy, GED_DVFS_DEFAULT_COMMIT);
+        }
+        else
+#endif
 #ifdef GED_DVFS_UM_CAL        
         if(GED_DVFS_FALLBACK==phase) // timer-based DVFS use only
 #endif             
@@ -969,6 +1252,8 @@ GED_ERROR ged_dvfs_system_init()
     g_cust_upbound_freq_id = 0;
     gpu_cust_upbound_freq = mt_gpufreq_get_freq_by_idx(g_cust_upbound_freq_id);
 
+    g_input_boost_freq_id = mt_gpufreq_get_dvfs_table_num() - 1;
+
 
     
 // GPU HAL fp mount	
@@ -979,6 +1264,7 @@ GED_ERROR ged_dvfs_system_init()
 	mtk_get_bottom_gpu_freq_fp = ged_dvfs_get_bottom_gpu_freq;
 	mtk_custom_get_gpu_freq_level_count_fp = ged_dvfs_get_gpu_freq_level_count;
 	mtk_custom_boost_gpu_freq_fp = ged_dvfs_custom_boost_gpu_freq;
+	mtk_input_boost_gpu_freq_fp = ged_dvfs_input_boost_gpu_freq;
 	mtk_custom_upbound_gpu_freq_fp = ged_dvfs_custom_ceiling_gpu_freq;
 	mtk_get_custom_boost_gpu_freq_fp = ged_dvfs_get_custom_boost_gpu_freq;
 	mtk_get_custom_upbound_gpu_freq_fp = ged_dvfs_get_custom_ceiling_gpu_freq;
@@ -1009,5 +1295,10 @@ module_param(gpu_debug_enable, uint, 0644);
 module_param(gpu_bottom_freq, uint, 0644);
 module_param(gpu_cust_boost_freq, uint, 0644);
 module_param(gpu_cust_upbound_freq, uint, 0644);
+module_param(gpu_dvfs_deadline, uint, 0644);
+module_param(gpu_dvfs_deadline_margin, uint, 0644);
+module_param(gpu_dvfs_cpu_boost, uint, 0644);
+module_param(gpu_late_frame_cpu, uint, 0444);
+module_param(gpu_late_frame_gpu, uint, 0444);
 #endif	
 
@@ -29,6 +29,7 @@ static struct dentry* gpsDvfsCurFreqEntry = NULL;
 static struct dentry* gpsDvfsPreFreqEntry = NULL;
 static struct dentry* gpsDvfsGpuUtilizationEntry = NULL;
 static struct dentry* gpsFpsUpperBoundEntry = NULL;
+static struct dentry* gpsDvfsGpuCtxUtilizationEntry = NULL;
 
 int tokenizer(char* pcSrc, int i32len, int* pi32IndexArray, int i32NumToken)
 {
@@ -709,6 +710,77 @@ static struct seq_operations gsDvfs_gpu_util_ReadOps =
 };
 //-----------------------------------------------------------------------------
 
+/*
+ * Binary: a GED_DVFS_CTX_UTIL_HEADER followed by ui32Count GED_DVFS_CTX_UTIL
+ * records, native endian.
+ */
+typedef struct GED_DVFS_CTX_UTIL_HEADER_TAG
+{
+    uint32_t ui32Version;
+    uint32_t ui32Count;
+    uint64_t ui64TimestampNs;
+}GED_DVFS_CTX_UTIL_HEADER;
+
+static void* ged_dvfs_gpu_ctx_util_seq_start(struct seq_file *psSeqFile, loff_t *puiPosition)
+{
+    if (0 == *puiPosition)
+    {
+        return SEQ_START_TOKEN;
+    }
+
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+static void ged_dvfs_gpu_ctx_util_seq_stop(struct seq_file *psSeqFile, void *pvData)
+{
+
+}
+//-----------------------------------------------------------------------------
+static void* ged_dvfs_gpu_ctx_util_seq_next(struct seq_file *psSeqFile, void *pvData, loff_t *puiPosition)
+{
+    return NULL;
+}
+//-----------------------------------------------------------------------------
+static int ged_dvfs_gpu_ctx_util_seq_show(struct seq_file *psSeqFile, void *pvData)
+{
+    GED_DVFS_CTX_UTIL_HEADER sHeader;
+    GED_DVFS_CTX_UTIL* psUtil;
+    int i32Count;
+
+    if (pvData == NULL)
+    {
+        return 0;
+    }
+
+    psUtil = (GED_DVFS_CTX_UTIL*)ged_alloc(sizeof(GED_DVFS_CTX_UTIL) * GED_DVFS_CTX_UTIL_MAX);
+    if (!psUtil)
+    {
+        return -ENOMEM;
+    }
+
+    i32Count = ged_dvfs_get_gpu_ctx_util(psUtil, GED_DVFS_CTX_UTIL_MAX);
+
+    sHeader.ui32Version = GED_DVFS_CTX_UTIL_VERSION;
+    sHeader.ui32Count = i32Count;
+    sHeader.ui64TimestampNs = ged_get_time();
+
+    seq_write(psSeqFile, &sHeader, sizeof(sHeader));
+    seq_write(psSeqFile, psUtil, sizeof(GED_DVFS_CTX_UTIL) * i32Count);
+
+    ged_free(psUtil, sizeof(GED_DVFS_CTX_UTIL) * GED_DVFS_CTX_UTIL_MAX);
+
+    return 0;
+}
+//-----------------------------------------------------------------------------
+static struct seq_operations gsDvfs_gpu_ctx_util_ReadOps = 
+{
+    .start = ged_dvfs_gpu_ctx_util_seq_start,
+    .stop = ged_dvfs_gpu_ctx_util_seq_stop,
+    .next = ged_dvfs_gpu_ctx_util_seq_next,
+    .show = ged_dvfs_gpu_ctx_util_seq_show,
+};
+//-----------------------------------------------------------------------------
+
 static uint32_t _fps_upper_bound = 60;
 
 static void *ged_fps_ub_seq_start(struct seq_file *seq, loff_t *pos)
@@ -888,6 +960,16 @@ GED_ERROR ged_hal_init(void)
             NULL,
             &gpsDvfsGpuUtilizationEntry);
 
+     /* Get per context GPU busy time (binary) */
+
+        err = ged_debugFS_create_entry(
+            "gpu_ctx_utilization",
+            gpsHALDir,
+            &gsDvfs_gpu_ctx_util_ReadOps,
+            NULL,
+            NULL,
+            &gpsDvfsGpuCtxUtilizationEntry);
+
 	/* Get FPS upper bound */
 	err = ged_debugFS_create_entry(
 			"fps_upper_bound",
@@ -925,6 +1007,7 @@ void ged_hal_exit(void)
     ged_debugFS_remove_entry(gpsDvfsCurFreqEntry);
     ged_debugFS_remove_entry(gpsDvfsPreFreqEntry);
     ged_debugFS_remove_entry(gpsDvfsGpuUtilizationEntry);
+    ged_debugFS_remove_entry(gpsDvfsGpuCtxUtilizationEntry);
     ged_debugFS_remove_entry_dir(gpsHALDir);
 }
 //-----------------------------------------------------------------------------
@@ -1,50 +1,67 @@
 #include "ged_base.h"
 #include "ged_hashtable.h"
-#include <linux/hashtable.h>
-
+#include <linux/jhash.h>
+#include <linux/mutex.h>
+#include <linux/rhashtable.h>
+
+/*
+ * Lookups run under rcu_read_lock() only, insert/remove/set are serialized
+ * by gsHashTableLock. The bucket array grows and shrinks with the number of
+ * nodes (rhashtable), so the bits passed to ged_hashtable_create() are only
+ * the initial size.
+ */
 typedef struct GED_HASHTABLE_TAG
 {
-    unsigned int        ui32Bits;
-    unsigned int        ui32Length;
+    struct rhashtable   sHT;
     unsigned int        ui32CurrentID;
     unsigned int        ui32Count;
-    struct hlist_head*  psHashTable;
 } GED_HASHTABLE;
 
 typedef struct GED_HASHNODE_TAG
 {
     unsigned int        ui32ID;
     void*               pvoid;
-    struct hlist_node   sNode;
+    struct rhash_head   sNode;
 } GED_HASHNODE;
 
 #define GED_HASHTABLE_INIT_ID 1234 // 0 = invalid
+#define GED_HASHTABLE_MAX_BITS 20
+
+static DEFINE_MUTEX(gsHashTableLock);
 
-void* __ged_hashtable_find(struct hlist_head *head, unsigned int ui32ID)
+#ifdef CONFIG_PROVE_LOCKING
+static int ged_hashtable_lock_is_held(void)
 {
-    GED_HASHNODE* psHN;
-    hlist_for_each_entry_rcu(psHN, head, sNode) 
-    {
-        if (psHN->ui32ID == ui32ID)
-        {
-            return psHN;
-        }
-    }
-    return NULL;
+#ifdef CONFIG_LOCKDEP
+    if (debug_locks)
+        return lockdep_is_held(&gsHashTableLock);
+#endif
+    return 1;
 }
+#endif
 
-static int ged_hash(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
+static GED_HASHNODE* __ged_hashtable_find(GED_HASHTABLE* psHT, unsigned int ui32ID)
 {
-    GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
-    return hash_32(ui32ID, psHT->ui32Bits);
+    return (GED_HASHNODE*)rhashtable_lookup(&psHT->sHT, &ui32ID);
 }
 
 GED_HASHTABLE_HANDLE ged_hashtable_create(unsigned int ui32Bits)
 {
     GED_HASHTABLE* psHT;
-    unsigned int i;
+    struct rhashtable_params sParams = {
+        .head_offset = offsetof(GED_HASHNODE, sNode),
+        .key_offset = offsetof(GED_HASHNODE, ui32ID),
+        .key_len = sizeof(unsigned int),
+        .hashfn = jhash,
+        .max_shift = GED_HASHTABLE_MAX_BITS,
+        .grow_decision = rht_grow_above_75,
+        .shrink_decision = rht_shrink_below_30,
+#ifdef CONFIG_PROVE_LOCKING
+        .mutex_is_held = ged_hashtable_lock_is_held,
+#endif
+    };
 
-    if (ui32Bits > 20)
+    if (ui32Bits > GED_HASHTABLE_MAX_BITS)
     {
         // 1048576 slots !?
         // Need to check the necessary
@@ -54,21 +71,16 @@ GED_HASHTABLE_HANDLE ged_hashtable_create(unsigned int ui32Bits)
     psHT = (GED_HASHTABLE*)ged_alloc(sizeof(GED_HASHTABLE));
     if (psHT)
     {
-        psHT->ui32Bits = ui32Bits;
-        psHT->ui32Length = 1 << ui32Bits;
         psHT->ui32CurrentID = GED_HASHTABLE_INIT_ID; // 0 = invalid
-        psHT->psHashTable = (struct hlist_head*)ged_alloc(psHT->ui32Length * sizeof(struct hlist_head));
-        if (psHT->psHashTable)
+        psHT->ui32Count = 0;
+        sParams.nelem_hint = (1 << ui32Bits) * 3 / 4;
+        if (0 == rhashtable_init(&psHT->sHT, &sParams))
         {
-            for (i = 0; i < psHT->ui32Length; i++)
-            {
-                INIT_HLIST_HEAD(&psHT->psHashTable[i]);
-            }
             return (GED_HASHTABLE_HANDLE)psHT;
         }
+        ged_free(psHT, sizeof(GED_HASHTABLE));
     }
 
-    ged_hashtable_destroy(psHT);
     return NULL;
 }
 
@@ -77,36 +89,25 @@ void ged_hashtable_destroy(GED_HASHTABLE_HANDLE hHashTable)
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     if (psHT)
     {
-        int i = 0;
-        while(psHT->ui32Count > 0)
-        {
-            unsigned int ui32ID = 0;
-            GED_HASHNODE* psHN;
-            // get one to be freed
-            for (;i < psHT->ui32Length; i++)
-            {
-                struct hlist_head *head = &psHT->psHashTable[i];
-                hlist_for_each_entry_rcu(psHN, head, sNode) 
-                {
-                    ui32ID = psHN->ui32ID;
-                    break;
-                }
-                if (0 < ui32ID)
-                {
-                    break;
-                }
-            }
+        const struct bucket_table *tbl;
+        GED_HASHNODE *psHN, *psNext;
+        size_t i;
+
+        mutex_lock(&gsHashTableLock);
 
-            if (i >= psHT->ui32Length)
+        tbl = rht_dereference(psHT->sHT.tbl, &psHT->sHT);
+        for (i = 0; i < tbl->size; i++)
+        {
+            rht_for_each_entry_safe(psHN, psNext, tbl->buckets[i], &psHT->sHT, sNode)
             {
-                break;
+                ged_free(psHN, sizeof(GED_HASHNODE));
             }
-
-            ged_hashtable_remove(psHT, ui32ID);
         }
 
+        mutex_unlock(&gsHashTableLock);
+
         /* free the hash table */
-        ged_free(psHT->psHashTable, psHT->ui32Length * sizeof(struct hlist_head));
+        rhashtable_destroy(&psHT->sHT);
         ged_free(psHT, sizeof(GED_HASHTABLE));
     }
 }
@@ -115,103 +116,131 @@ GED_ERROR ged_hashtable_insert(GED_HASHTABLE_HANDLE hHashTable, void* pvoid, uns
 {
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     GED_HASHNODE* psHN = NULL;
-    unsigned int ui32Hash, ui32ID;
+    unsigned int ui32ID;
 
     if ((!psHT) || (!pui32ID))
     {
         return GED_ERROR_INVALID_PARAMS;
     }
 
+    psHN = (GED_HASHNODE*)ged_alloc(sizeof(GED_HASHNODE));
+    if (!psHN)
+    {
+        return GED_ERROR_OOM;
+    }
+
+    mutex_lock(&gsHashTableLock);
+
     ui32ID = psHT->ui32CurrentID + 1;
     while(1)
     {
-        ui32Hash = ged_hash(psHT, ui32ID);
-        psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
-        if (psHN != NULL)
+        if (ui32ID == 0)//skip the value 0
         {
-            ui32ID++;
-            if (ui32ID == 0)//skip the value 0
-            {
-                ui32ID = 1;
-            }
-            if (ui32ID == psHT->ui32CurrentID)
-            {
-                return GED_ERROR_FAIL;
-            }
+            ui32ID = 1;
         }
-        else
+        if (__ged_hashtable_find(psHT, ui32ID) == NULL)
         {
             break;
         }
+        ui32ID++;
+        if (ui32ID == psHT->ui32CurrentID)
+        {
+            mutex_unlock(&gsHashTableLock);
+            ged_free(psHN, sizeof(GED_HASHNODE));
+            return GED_ERROR_FAIL;
+        }
     };
 
-    psHN = (GED_HASHNODE*)ged_alloc(sizeof(GED_HASHNODE));
-    if (psHN)
-    {
-        psHN->pvoid = pvoid;
-        psHN->ui32ID = ui32ID;
-        psHT->ui32CurrentID = ui32ID;
-        *pui32ID = ui32ID;
-        hlist_add_head_rcu(&psHN->sNode, &psHT->psHashTable[ui32Hash]);
-        psHT->ui32Count += 1;
-        return GED_OK;
-    }
+    psHN->pvoid = pvoid;
+    psHN->ui32ID = ui32ID;
+    psHT->ui32CurrentID = ui32ID;
+    *pui32ID = ui32ID;
+    rhashtable_insert(&psHT->sHT, &psHN->sNode, GFP_KERNEL);
+    psHT->ui32Count += 1;
+
+    mutex_unlock(&gsHashTableLock);
 
-    return GED_ERROR_OOM;
+    return GED_OK;
 }
 
+/*
+ * Returns after all lookups that could still see the node are done, so the
+ * caller may free the object it pointed to.
+ */
 void ged_hashtable_remove(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
 {
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     if (psHT)
     {
-        unsigned int ui32Hash = ged_hash(psHT, ui32ID);
-        GED_HASHNODE* psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
+        GED_HASHNODE* psHN;
+
+        mutex_lock(&gsHashTableLock);
+        psHN = __ged_hashtable_find(psHT, ui32ID);
         if (psHN)
         {
-            hlist_del_rcu(&psHN->sNode);
-            synchronize_rcu();
-            ged_free(psHN, sizeof(GED_HASHNODE));
+            rhashtable_remove(&psHT->sHT, &psHN->sNode, GFP_KERNEL);
             psHT->ui32Count -= 1;
         }
+        mutex_unlock(&gsHashTableLock);
+
+        if (psHN)
+        {
+            synchronize_rcu_expedited();
+            ged_free(psHN, sizeof(GED_HASHNODE));
+        }
     }
 }
 
+/*
+ * The returned object is only guaranteed to stay alive inside the caller's
+ * rcu_read_lock() section; owners that need it longer keep a reference count
+ * in the object and take it before leaving the section.
+ */
 void* ged_hashtable_find(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
 {
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
+    void* pvoid = NULL;
+
     if (psHT)
     {
-        unsigned int ui32Hash = ged_hash(psHT, ui32ID);
-        GED_HASHNODE* psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
+        GED_HASHNODE* psHN;
+
+        rcu_read_lock();
+        psHN = __ged_hashtable_find(psHT, ui32ID);
         if (psHN)
         {
-            return psHN->pvoid;
+            pvoid = ACCESS_ONCE(psHN->pvoid);
         }
+        rcu_read_unlock();
 #ifdef GED_DEBUG
-        if (ui32ID != 0)
+        if (!psHN && ui32ID != 0)
         {
-            GED_LOGE("ged_hashtable_find: ui32ID=%u ui32Hash=%u psHN=%p\n", ui32ID, ui32Hash, psHN);
+            GED_LOGE("ged_hashtable_find: ui32ID=%u not found\n", ui32ID);
         }
 #endif
     }
-    return NULL;
+    return pvoid;
 }
 
 GED_ERROR ged_hashtable_set(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID, void* pvoid)
 {
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
+    GED_ERROR err = GED_ERROR_INVALID_PARAMS;
+
     if (psHT)
     {
-        unsigned int ui32Hash = ged_hash(psHT, ui32ID);
-        GED_HASHNODE* psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
+        GED_HASHNODE* psHN;
+
+        mutex_lock(&gsHashTableLock);
+        psHN = __ged_hashtable_find(psHT, ui32ID);
         if (psHN)
         {
-            psHN->pvoid = pvoid;
-            return GED_OK;
+            ACCESS_ONCE(psHN->pvoid) = pvoid;
+            err = GED_OK;
         }
+        mutex_unlock(&gsHashTableLock);
     }
 
-    return GED_ERROR_INVALID_PARAMS;
+    return err;
 }
 
@@ -9,6 +9,9 @@
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
 #include <linux/rtc.h>
+#include <linux/percpu.h>
+#include <linux/workqueue.h>
+#include <mt-plat/mt_wq.h>
 
 #include "ged_base.h"
 #include "ged_log.h"
@@ -26,8 +29,36 @@ enum
     GED_LOG_ATTR_QUEUEBUFFER    = 0x2,
     /* increase buffersize when buffer is full */
     GED_LOG_ATTR_AUTO_INCREASE  = 0x4,
+    /* stage binary records per CPU, format them when merged */
+    GED_LOG_ATTR_DEFERRED       = 0x8,
 };
 
+/*
+ * Deferred buffers: the print path only stores the format pointer and the
+ * vbin_printf() packed arguments into a per CPU staging ring. The records
+ * are formatted into the shared ring when it is read, or from a work once a
+ * staging ring is half full. Formats must be string literals.
+ */
+#define GED_LOG_DEFER_RECORDS   64
+#define GED_LOG_DEFER_ARGS      32 /* u32 words */
+
+typedef struct GED_LOG_DEFER_REC_TAG
+{
+    long long   time;
+    const char  *fmt;
+    int         attrs;
+    u32         aui32Args[GED_LOG_DEFER_ARGS];
+} GED_LOG_DEFER_REC;
+
+typedef struct GED_LOG_DEFER_CPU_TAG
+{
+    /* only contended by the merge, never by other CPUs logging */
+    spinlock_t          sLock;
+    unsigned int        ui32Head;
+    unsigned int        ui32Tail;
+    GED_LOG_DEFER_REC   asRec[GED_LOG_DEFER_RECORDS];
+} GED_LOG_DEFER_CPU;
+
 typedef struct GED_LOG_BUF_LINE_TAG
 {
     int         offset;
@@ -65,6 +96,14 @@ typedef struct GED_LOG_BUF_TAG
 
     unsigned int        ui32HashNodeID;
 
+    /* handle users in flight, ged_log_buf_free() waits for them */
+    atomic_t            i32Ref;
+
+    GED_LOG_DEFER_CPU __percpu *psDefer;
+    spinlock_t          sMergeLock;
+    struct work_struct  sMergeWork;
+    unsigned int        ui32Dropped;
+
 } GED_LOG_BUF;
 
 typedef struct GED_LOG_LISTEN_TAG
@@ -92,24 +131,42 @@ static struct dentry* gpsGEDLogBufsDir = NULL;
 
 static GED_HASHTABLE_HANDLE ghHashTable = NULL;
 
+static DECLARE_WAIT_QUEUE_HEAD(gsGEDLogBufRefWQ);
+
 //-----------------------------------------------------------------------------
 //
 //  GED Log Buf
 //
 //-----------------------------------------------------------------------------
+/* takes a reference, drop it with ged_log_buf_put_ref() */
 static GED_LOG_BUF* ged_log_buf_from_handle(GED_LOG_BUF_HANDLE hLogBuf)
 {
-    return ged_hashtable_find(ghHashTable, (unsigned int)hLogBuf);
+    GED_LOG_BUF *psGEDLogBuf;
+
+    rcu_read_lock();
+    psGEDLogBuf = ged_hashtable_find(ghHashTable, (unsigned int)hLogBuf);
+    if (psGEDLogBuf && !atomic_inc_not_zero(&psGEDLogBuf->i32Ref))
+    {
+        psGEDLogBuf = NULL;
+    }
+    rcu_read_unlock();
+
+    return psGEDLogBuf;
 }
 
-static GED_ERROR __ged_log_buf_vprint(GED_LOG_BUF *psGEDLogBuf, const char *fmt, va_list args, int attrs)
+static void ged_log_buf_put_ref(GED_LOG_BUF *psGEDLogBuf)
+{
+    if (psGEDLogBuf && atomic_dec_and_test(&psGEDLogBuf->i32Ref))
+    {
+        wake_up_all(&gsGEDLogBufRefWQ);
+    }
+}
+
+static GED_ERROR __ged_log_buf_vprint_at(GED_LOG_BUF *psGEDLogBuf, long long time, const char *fmt, va_list args, int attrs)
 {
     int buf_n;
     int len;
 
-    if (!psGEDLogBuf)
-        return GED_OK;
-
     spin_lock_irqsave(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
 
     /* if OOM */
@@ -164,7 +221,7 @@ static GED_ERROR __ged_log_buf_vprint(GED_LOG_BUF *psGEDLogBuf, const char *fmt,
     if (attrs & GED_LOG_ATTR_TIME)
     {
         psGEDLogBuf->psLine[psGEDLogBuf->i32LineCurrent].tattrs = GED_LOG_ATTR_TIME;
-        psGEDLogBuf->psLine[psGEDLogBuf->i32LineCurrent].time = ged_get_time();
+        psGEDLogBuf->psLine[psGEDLogBuf->i32LineCurrent].time = time;
     }
 
     /* record the user time */
@@ -225,13 +282,169 @@ static GED_ERROR __ged_log_buf_vprint(GED_LOG_BUF *psGEDLogBuf, const char *fmt,
     return GED_OK;
 }
 
+static GED_ERROR __ged_log_buf_print_at(GED_LOG_BUF *psGEDLogBuf, long long time, int attrs, const char *fmt, ...)
+{
+    va_list args;
+    GED_ERROR err;
+
+    va_start(args, fmt);
+    err = __ged_log_buf_vprint_at(psGEDLogBuf, time, fmt, args, attrs);
+    va_end(args);
+
+    return err;
+}
+
+#ifdef CONFIG_BINARY_PRINTF
+static GED_ERROR __ged_log_buf_defer(GED_LOG_BUF *psGEDLogBuf, const char *fmt, va_list args, int attrs)
+{
+    GED_LOG_DEFER_CPU *psCPU;
+    GED_LOG_DEFER_REC *psRec;
+    unsigned long ulIRQFlags;
+    unsigned int ui32Count;
+
+    psCPU = get_cpu_ptr(psGEDLogBuf->psDefer);
+    spin_lock_irqsave(&psCPU->sLock, ulIRQFlags);
+
+    ui32Count = psCPU->ui32Head - psCPU->ui32Tail;
+    if (ui32Count >= GED_LOG_DEFER_RECORDS)
+    {
+        psGEDLogBuf->ui32Dropped++;
+        spin_unlock_irqrestore(&psCPU->sLock, ulIRQFlags);
+        put_cpu_ptr(psGEDLogBuf->psDefer);
+        return GED_ERROR_OOM;
+    }
+
+    psRec = &psCPU->asRec[psCPU->ui32Head % GED_LOG_DEFER_RECORDS];
+    psRec->time = ged_get_time();
+    psRec->fmt = fmt;
+    psRec->attrs = attrs & ~GED_LOG_ATTR_DEFERRED;
+    if (vbin_printf(psRec->aui32Args, GED_LOG_DEFER_ARGS, fmt, args) > GED_LOG_DEFER_ARGS)
+    {
+        /* arguments truncated, bstr_printf() would read past them */
+        psRec->fmt = NULL;
+    }
+    psCPU->ui32Head++;
+
+    spin_unlock_irqrestore(&psCPU->sLock, ulIRQFlags);
+    put_cpu_ptr(psGEDLogBuf->psDefer);
+
+    if (ui32Count + 1 == GED_LOG_DEFER_RECORDS / 2)
+    {
+        mt_queue_work(MT_WQ_LITTLE, &psGEDLogBuf->sMergeWork);
+    }
+
+    return GED_OK;
+}
+
+/* move the staged records of all CPUs into the shared ring, oldest first */
+static void __ged_log_buf_merge(GED_LOG_BUF *psGEDLogBuf)
+{
+    GED_LOG_DEFER_CPU *psCPU;
+    GED_LOG_DEFER_REC sRec;
+    unsigned long ulMergeFlags, ulIRQFlags;
+    char acText[256];
+    long long oldest;
+    int cpu, pick;
+
+    spin_lock_irqsave(&psGEDLogBuf->sMergeLock, ulMergeFlags);
+
+    for (;;)
+    {
+        pick = -1;
+        oldest = 0;
+        for_each_possible_cpu(cpu)
+        {
+            psCPU = per_cpu_ptr(psGEDLogBuf->psDefer, cpu);
+            spin_lock_irqsave(&psCPU->sLock, ulIRQFlags);
+            if (psCPU->ui32Head != psCPU->ui32Tail)
+            {
+                long long t = psCPU->asRec[psCPU->ui32Tail % GED_LOG_DEFER_RECORDS].time;
+                if (pick < 0 || t < oldest)
+                {
+                    pick = cpu;
+                    oldest = t;
+                }
+            }
+            spin_unlock_irqrestore(&psCPU->sLock, ulIRQFlags);
+        }
+
+        if (pick < 0)
+            break;
+
+        psCPU = per_cpu_ptr(psGEDLogBuf->psDefer, pick);
+        spin_lock_irqsave(&psCPU->sLock, ulIRQFlags);
+        sRec = psCPU->asRec[psCPU->ui32Tail % GED_LOG_DEFER_RECORDS];
+        psCPU->ui32Tail++;
+        spin_unlock_irqrestore(&psCPU->sLock, ulIRQFlags);
+
+        if (sRec.fmt)
+            bstr_printf(acText, sizeof(acText), sRec.fmt, sRec.aui32Args);
+        else
+            snprintf(acText, sizeof(acText), "(log arguments too long)");
+
+        __ged_log_buf_print_at(psGEDLogBuf, sRec.time, sRec.attrs, "%s", acText);
+    }
+
+    spin_unlock_irqrestore(&psGEDLogBuf->sMergeLock, ulMergeFlags);
+}
+
+static void __ged_log_buf_discard(GED_LOG_BUF *psGEDLogBuf)
+{
+    GED_LOG_DEFER_CPU *psCPU;
+    unsigned long ulIRQFlags;
+    int cpu;
+
+    for_each_possible_cpu(cpu)
+    {
+        psCPU = per_cpu_ptr(psGEDLogBuf->psDefer, cpu);
+        spin_lock_irqsave(&psCPU->sLock, ulIRQFlags);
+        psCPU->ui32Tail = psCPU->ui32Head;
+        spin_unlock_irqrestore(&psCPU->sLock, ulIRQFlags);
+    }
+}
+#else
+static GED_ERROR __ged_log_buf_defer(GED_LOG_BUF *psGEDLogBuf, const char *fmt, va_list args, int attrs)
+{
+    return __ged_log_buf_vprint_at(psGEDLogBuf, ged_get_time(), fmt, args, attrs);
+}
+
+static void __ged_log_buf_merge(GED_LOG_BUF *psGEDLogBuf)
+{
+}
+
+static void __ged_log_buf_discard(GED_LOG_BUF *psGEDLogBuf)
+{
+}
+#endif
+
+static void ged_log_buf_merge_work(struct work_struct *psWork)
+{
+    GED_LOG_BUF *psGEDLogBuf = container_of(psWork, GED_LOG_BUF, sMergeWork);
+
+    __ged_log_buf_merge(psGEDLogBuf);
+}
+
+static GED_ERROR __ged_log_buf_vprint(GED_LOG_BUF *psGEDLogBuf, const char *fmt, va_list args, int attrs)
+{
+    if (!psGEDLogBuf)
+        return GED_OK;
+
+    /* user time, pid and tid are only known in the caller's context */
+    if ((attrs & GED_LOG_ATTR_DEFERRED) && !(attrs & GED_LOG_ATTR_TIME_TPT))
+        return __ged_log_buf_defer(psGEDLogBuf, fmt, args, attrs);
+
+    return __ged_log_buf_vprint_at(psGEDLogBuf, ged_get_time(), fmt, args, attrs & ~GED_LOG_ATTR_DEFERRED);
+}
+
 static GED_ERROR __ged_log_buf_print(GED_LOG_BUF *psGEDLogBuf, const char *fmt, ...)
 {
     va_list args;
     GED_ERROR err;
 
+    /* fmt is a copy of user data here, it cannot be staged */
     va_start(args, fmt);
-    err = __ged_log_buf_vprint(psGEDLogBuf, fmt, args, psGEDLogBuf->attrs | GED_LOG_ATTR_TIME);
+    err = __ged_log_buf_vprint(psGEDLogBuf, fmt, args,
+            (psGEDLogBuf->attrs & ~GED_LOG_ATTR_DEFERRED) | GED_LOG_ATTR_TIME);
     va_end(args);
 
     return err;
@@ -367,12 +580,26 @@ static int ged_log_buf_seq_show(struct seq_file *psSeqFile, void *pvData)
     {
         int i;
 
+        if (psGEDLogBuf->attrs & GED_LOG_ATTR_DEFERRED)
+        {
+            __ged_log_buf_merge(psGEDLogBuf);
+        }
+
         spin_lock_irqsave(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
 
         if (psGEDLogBuf->acName[0] != '\0')
         {
-            seq_printf(psSeqFile, "---------- %s (%d/%d) ----------\n",
-                    psGEDLogBuf->acName, psGEDLogBuf->i32BufferCurrent, psGEDLogBuf->i32BufferSize);
+            if (psGEDLogBuf->ui32Dropped)
+            {
+                seq_printf(psSeqFile, "---------- %s (%d/%d, %u dropped) ----------\n",
+                        psGEDLogBuf->acName, psGEDLogBuf->i32BufferCurrent, psGEDLogBuf->i32BufferSize,
+                        psGEDLogBuf->ui32Dropped);
+            }
+            else
+            {
+                seq_printf(psSeqFile, "---------- %s (%d/%d) ----------\n",
+                        psGEDLogBuf->acName, psGEDLogBuf->i32BufferCurrent, psGEDLogBuf->i32BufferSize);
+            }
         }
 
         if (psGEDLogBuf->attrs & GED_LOG_ATTR_RINGBUFFER)
@@ -449,12 +676,46 @@ GED_LOG_BUF_HANDLE ged_log_buf_alloc(
         case GED_LOG_BUF_TYPE_QUEUEBUFFER_AUTO_INCREASE:
             psGEDLogBuf->attrs = GED_LOG_ATTR_QUEUEBUFFER | GED_LOG_ATTR_AUTO_INCREASE;
             break;
+        case GED_LOG_BUF_TYPE_RINGBUFFER_DEFERRED:
+            psGEDLogBuf->attrs = GED_LOG_ATTR_RINGBUFFER;
+#ifdef CONFIG_BINARY_PRINTF
+            psGEDLogBuf->attrs |= GED_LOG_ATTR_DEFERRED;
+#endif
+            break;
+    }
+
+    psGEDLogBuf->psDefer = NULL;
+    psGEDLogBuf->ui32Dropped = 0;
+    spin_lock_init(&psGEDLogBuf->sMergeLock);
+    INIT_WORK(&psGEDLogBuf->sMergeWork, ged_log_buf_merge_work);
+    if (psGEDLogBuf->attrs & GED_LOG_ATTR_DEFERRED)
+    {
+        int cpu;
+
+        psGEDLogBuf->psDefer = alloc_percpu(GED_LOG_DEFER_CPU);
+        if (NULL == psGEDLogBuf->psDefer)
+        {
+            /* still usable, just formatted on the print path */
+            psGEDLogBuf->attrs &= ~GED_LOG_ATTR_DEFERRED;
+        }
+        else
+        {
+            for_each_possible_cpu(cpu)
+            {
+                GED_LOG_DEFER_CPU *psCPU = per_cpu_ptr(psGEDLogBuf->psDefer, cpu);
+                spin_lock_init(&psCPU->sLock);
+                psCPU->ui32Head = 0;
+                psCPU->ui32Tail = 0;
+            }
+        }
     }
 
     psGEDLogBuf->i32MemorySize = i32MaxBufferSizeByte + sizeof(GED_LOG_BUF_LINE) * i32MaxLineCount;
     psGEDLogBuf->pMemory = ged_alloc(psGEDLogBuf->i32MemorySize);
     if (NULL == psGEDLogBuf->pMemory)
     {
+        if (psGEDLogBuf->psDefer)
+            free_percpu(psGEDLogBuf->psDefer);
         ged_free(psGEDLogBuf, sizeof(GED_LOG_BUF));
         GED_LOGE("ged: failed to allocate log buf!\n");
         return (GED_LOG_BUF_HANDLE)0;
@@ -468,6 +729,7 @@ GED_LOG_BUF_HANDLE ged_log_buf_alloc(
     psGEDLogBuf->i32BufferCurrent = 0;
 
     psGEDLogBuf->psEntry = NULL;
+    atomic_set(&psGEDLogBuf->i32Ref, 1);
     spin_lock_init(&psGEDLogBuf->sSpinLock);
     psGEDLogBuf->acName[0] = '\0';
     psGEDLogBuf->acNodeName[0] = '\0';
@@ -539,6 +801,7 @@ GED_ERROR ged_log_buf_resize(
 
     if ((NULL == psGEDLogBuf) || (i32NewMaxLineCount <= 0) || (i32NewMaxBufferSizeByte <= 0))
     {
+        ged_log_buf_put_ref(psGEDLogBuf);
         return GED_ERROR_INVALID_PARAMS;
     }
 
@@ -546,6 +809,7 @@ GED_ERROR ged_log_buf_resize(
     pNewMemory = ged_alloc(i32NewMemorySize);
     if (NULL == pNewMemory)
     {
+        ged_log_buf_put_ref(psGEDLogBuf);
         return GED_ERROR_OOM;
     }
 
@@ -576,6 +840,7 @@ GED_ERROR ged_log_buf_resize(
 
     spin_unlock_irqrestore(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
     ged_free(pOldMemory, i32OldMemorySize);
+    ged_log_buf_put_ref(psGEDLogBuf);
 
     return GED_OK;
 }
@@ -622,6 +887,8 @@ GED_ERROR ged_log_buf_ignore_lines(GED_LOG_BUF_HANDLE hLogBuf, int n)
         }
     }
 
+    ged_log_buf_put_ref(psGEDLogBuf);
+
     return GED_OK;
 }
 
@@ -723,17 +990,29 @@ void ged_log_buf_free(GED_LOG_BUF_HANDLE hLogBuf)
     GED_LOG_BUF *psGEDLogBuf = ged_log_buf_from_handle(hLogBuf);
     if (psGEDLogBuf)
     {
+        /* no lookup can find it after this returns */
         ged_hashtable_remove(ghHashTable, psGEDLogBuf->ui32HashNodeID);
 
         write_lock_bh(&gsGEDLogBufList.sLock);
         list_del(&psGEDLogBuf->sList);
         write_unlock_bh(&gsGEDLogBufList.sLock);
 
+        /* drop ours and the initial one, then wait for printers in flight */
+        ged_log_buf_put_ref(psGEDLogBuf);
+        ged_log_buf_put_ref(psGEDLogBuf);
+        wait_event(gsGEDLogBufRefWQ, 0 == atomic_read(&psGEDLogBuf->i32Ref));
+
         if (psGEDLogBuf->psEntry)
         {
             ged_debugFS_remove_entry(psGEDLogBuf->psEntry);
         }
 
+        if (psGEDLogBuf->psDefer)
+        {
+            cancel_work_sync(&psGEDLogBuf->sMergeWork);
+            free_percpu(psGEDLogBuf->psDefer);
+        }
+
         ged_free(psGEDLogBuf->pMemory, psGEDLogBuf->i32MemorySize);
         ged_free(psGEDLogBuf, sizeof(GED_LOG_BUF));
 
@@ -750,10 +1029,13 @@ GED_ERROR ged_log_buf_print(GED_LOG_BUF_HANDLE hLogBuf, const char *fmt, ...)
     if (hLogBuf)
     {
         psGEDLogBuf = ged_log_buf_from_handle(hLogBuf);
-
-        va_start(args, fmt);
-        err = __ged_log_buf_vprint(psGEDLogBuf, fmt, args, psGEDLogBuf->attrs);
-        va_end(args);
+        if (psGEDLogBuf)
+        {
+            va_start(args, fmt);
+            err = __ged_log_buf_vprint(psGEDLogBuf, fmt, args, psGEDLogBuf->attrs);
+            va_end(args);
+            ged_log_buf_put_ref(psGEDLogBuf);
+        }
     }
 
     return GED_OK;
@@ -767,13 +1049,16 @@ GED_ERROR ged_log_buf_print2(GED_LOG_BUF_HANDLE hLogBuf, int i32LogAttrs, const
     if (hLogBuf)
     {
         psGEDLogBuf = ged_log_buf_from_handle(hLogBuf);
+        if (psGEDLogBuf)
+        {
+            /* clear reserved attrs */
+            i32LogAttrs &= ~0xff; 
 
-        /* clear reserved attrs */
-        i32LogAttrs &= ~0xff; 
-
-        va_start(args, fmt);
-        err = __ged_log_buf_vprint(psGEDLogBuf, fmt, args, psGEDLogBuf->attrs | i32LogAttrs);
-        va_end(args);
+            va_start(args, fmt);
+            err = __ged_log_buf_vprint(psGEDLogBuf, fmt, args, psGEDLogBuf->attrs | i32LogAttrs);
+            va_end(args);
+            ged_log_buf_put_ref(psGEDLogBuf);
+        }
     }
 
     return GED_OK;
@@ -785,6 +1070,12 @@ GED_ERROR ged_log_buf_reset(GED_LOG_BUF_HANDLE hLogBuf)
     if (psGEDLogBuf)
     {
         int i;
+
+        if (psGEDLogBuf->attrs & GED_LOG_ATTR_DEFERRED)
+        {
+            __ged_log_buf_discard(psGEDLogBuf);
+        }
+
         spin_lock_irqsave(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
 
         psGEDLogBuf->i32LineCurrent = 0;
@@ -795,6 +1086,7 @@ GED_ERROR ged_log_buf_reset(GED_LOG_BUF_HANDLE hLogBuf)
         }
 
         spin_unlock_irqrestore(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
+        ged_log_buf_put_ref(psGEDLogBuf);
     }
 
     return GED_OK;
@@ -976,7 +1268,10 @@ void ged_log_system_exit(void)
 int ged_log_buf_write(GED_LOG_BUF_HANDLE hLogBuf, const char __user *pszBuffer, int i32Count)
 {
     GED_LOG_BUF *psGEDLogBuf = ged_log_buf_from_handle(hLogBuf);
-    return __ged_log_buf_write(psGEDLogBuf, pszBuffer, i32Count);
+    int cnt = __ged_log_buf_write(psGEDLogBuf, pszBuffer, i32Count);
+
+    ged_log_buf_put_ref(psGEDLogBuf);
+    return cnt;
 }
 
 EXPORT_SYMBOL(ged_log_buf_alloc);
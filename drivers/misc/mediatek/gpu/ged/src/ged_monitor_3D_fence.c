@@ -11,6 +11,7 @@
 #endif
 
 #include <mt-plat/mtk_gpu_utility.h>
+#include <mt-plat/mt_wq.h>
 #include <trace/events/gpu.h>
 #ifdef GED_DVFS_ENABLE
 #include <mt_gpufreq.h>
@@ -30,6 +31,7 @@ static unsigned int ged_monitor_3D_fence_debug = 0;
 static unsigned int ged_monitor_3D_fence_disable = 0;
 static unsigned int ged_monitor_3D_fence_systrace = 0;
 static unsigned long g_ul3DFenceDoneTime = 0;
+static unsigned long g_ul3DFencePendingSince = 0;
 
 
 extern bool mtk_get_bottom_gpu_freq(unsigned int *pui32FreqLevel);
@@ -44,6 +46,8 @@ typedef struct GED_MONITOR_3D_FENCE_TAG
     struct sync_fence_waiter    sSyncWaiter;
 	struct work_struct          sWork;
     struct sync_fence*          psSyncFence;
+    unsigned long               ulSubmitTime;
+    unsigned long               ulDoneTime;
 } GED_MONITOR_3D_FENCE;
 
 static void ged_sync_cb(struct sync_fence *fence, struct sync_fence_waiter *waiter)
@@ -59,10 +63,11 @@ static void ged_sync_cb(struct sync_fence *fence, struct sync_fence_waiter *wait
     ged_monitor_3D_fence_notify();
     ged_dvfs_cal_gpu_utilization_force();
 	psMonitor = GED_CONTAINER_OF(waiter, GED_MONITOR_3D_FENCE, sSyncWaiter);
+    psMonitor->ulDoneTime = (unsigned long)t;
     
     ged_log_buf_print(ghLogBuf_DVFS, "[-] ged_monitor_3D_fence_done (ts=%llu) %p", t, psMonitor->psSyncFence);
     
-    schedule_work(&psMonitor->sWork);
+    mt_queue_work(MT_WQ_CLUSTER, &psMonitor->sWork);
 }
 
 static void ged_monitor_3D_fence_work_cb(struct work_struct *psWork)
@@ -74,8 +79,14 @@ static void ged_monitor_3D_fence_work_cb(struct work_struct *psWork)
     ged_log_buf_print(ghLogBuf_GED, "ged_monitor_3D_fence_work_cb");
 #endif
 
+	psMonitor = GED_CONTAINER_OF(psWork, GED_MONITOR_3D_FENCE, sWork);
+
+    ged_dvfs_frame_done(psMonitor->ulSubmitTime, psMonitor->ulDoneTime);
+
     if (atomic_sub_return(1, &g_i32Count) < 1)
     {
+        g_ul3DFencePendingSince = 0;
+
         if (0 == ged_monitor_3D_fence_disable)
         {
             unsigned int uiFreqLevelID;
@@ -100,13 +111,17 @@ static void ged_monitor_3D_fence_work_cb(struct work_struct *psWork)
             }
         }
     }
+    else
+    {
+        // the next queued frame starts rendering when this one is done
+        g_ul3DFencePendingSince = psMonitor->ulDoneTime;
+    }
 
     if (ged_monitor_3D_fence_debug > 0)
     {
         GED_LOGI("[-]3D fences count = %d\n", atomic_read(&g_i32Count));
     }
 
-	psMonitor = GED_CONTAINER_OF(psWork, GED_MONITOR_3D_FENCE, sWork);
     sync_fence_put(psMonitor->psSyncFence);
     ged_free(psMonitor, sizeof(GED_MONITOR_3D_FENCE));
 }
@@ -140,6 +155,8 @@ GED_ERROR ged_monitor_3D_fence_add(int fence_fd)
     sync_fence_waiter_init(&psMonitor->sSyncWaiter, ged_sync_cb);
     INIT_WORK(&psMonitor->sWork, ged_monitor_3D_fence_work_cb);
     psMonitor->psSyncFence = sync_fence_fdget(fence_fd);
+    psMonitor->ulSubmitTime = (unsigned long)t;
+    psMonitor->ulDoneTime = 0;
     if (NULL == psMonitor->psSyncFence)
     {
         ged_free(psMonitor, sizeof(GED_MONITOR_3D_FENCE));
@@ -166,6 +183,10 @@ GED_ERROR ged_monitor_3D_fence_add(int fence_fd)
     else if (0 == err)
     {
         int iCount = atomic_add_return (1, &g_i32Count);
+        if (1 == iCount)
+        {
+            g_ul3DFencePendingSince = (unsigned long)t;
+        }
         if (iCount > 1)
         {
             if (0 == ged_monitor_3D_fence_disable)
@@ -209,6 +230,11 @@ GED_ERROR ged_monitor_3D_fence_add(int fence_fd)
     return GED_OK;
 }
 
+unsigned long ged_monitor_3D_fence_pending_since()
+{
+    return g_ul3DFencePendingSince;
+}
+
 void ged_monitor_3D_fence_set_disable(GED_BOOL bFlag)
 {
     if(bFlag!=ged_monitor_3D_fence_disable)
@@ -387,6 +387,40 @@ void mtk_gpu_dvfs_commit(unsigned long ui32NewFreqID, GED_DVFS_COMMIT_TYPE eComm
 		
 }
 ///
+
+/// MTK_GED {
+int mtk_gpu_get_ctx_util(GED_DVFS_CTX_UTIL *psUtil, int i32Max)
+{
+	struct kbase_device *kbdev = gpsMaliData;
+	struct kbasep_kctx_list_element *element;
+	unsigned long flags;
+	int i = 0;
+
+	if (!kbdev)
+		return 0;
+
+	mutex_lock(&kbdev->kctx_list_lock);
+	list_for_each_entry(element, &kbdev->kctx_list, link) {
+		struct kbase_context *kctx = element->kctx;
+
+		if (i >= i32Max)
+			break;
+
+		psUtil[i].i32Pid = kctx->pid;
+		psUtil[i].i32Tgid = kctx->tgid;
+		psUtil[i].ui32CtxID = kctx->id;
+		spin_lock_irqsave(&kbdev->js_data.runpool_irq.lock, flags);
+		psUtil[i].ui32Jobs = kctx->mtk_gpu_jobs;
+		psUtil[i].ui64BusyUs = kctx->mtk_gpu_busy_us;
+		spin_unlock_irqrestore(&kbdev->js_data.runpool_irq.lock, flags);
+		i++;
+	}
+	mutex_unlock(&kbdev->kctx_list_lock);
+
+	return i;
+}
+/// }
+
 #ifdef CONFIG_MALI_MIPE_ENABLED
 static void kbase_create_timeline_objects(struct kbase_context *kctx)
 {
@@ -3646,6 +3680,7 @@ static int kbase_common_device_remove(struct kbase_device *kbdev);
 extern void (*ged_dvfs_cal_gpu_utilization_fp)(unsigned int* pui32Loading , unsigned int* pui32Block,unsigned int* pui32Idle);
 extern void (*ged_dvfs_gpu_freq_commit_fp)(unsigned long ui32NewFreqID, GED_DVFS_COMMIT_TYPE eCommitType, int* pbCommited);
 extern unsigned int (*mtk_get_gpu_power_loading_fp)(void);
+extern int (*ged_dvfs_get_gpu_ctx_util_fp)(GED_DVFS_CTX_UTIL *psUtil, int i32Max);
 /// }
 
 static int kbase_platform_device_probe(struct platform_device *pdev)
@@ -3803,6 +3838,7 @@ static int kbase_platform_device_probe(struct platform_device *pdev)
 /// MTK_GED {	
    ged_dvfs_cal_gpu_utilization_fp = MTKCalGpuUtilization;
    ged_dvfs_gpu_freq_commit_fp = mtk_gpu_dvfs_commit;
+   ged_dvfs_get_gpu_ctx_util_fp = mtk_gpu_get_ctx_util;
 ///}
 #endif
 
@@ -1201,6 +1201,11 @@ struct kbase_context {
 	struct list_head completed_jobs;
 	/* Number of work items currently pending on job_done_wq */
 	atomic_t work_count;
+
+	/* MTK: job slot time and jobs completed on HW, protected by
+	 * js_data.runpool_irq.lock */
+	u64 mtk_gpu_busy_us;
+	u32 mtk_gpu_jobs;
 };
 
 enum kbase_reg_access_type {
@@ -1115,6 +1115,10 @@ bool jd_submit_atom(struct kbase_context *kctx,
 	return ret;
 }
 
+/* MTK: atoms copied from user space, and submitted under one hold of
+ * jctx->lock, per round of kbase_jd_submit */
+#define KBASE_JD_SUBMIT_BATCH 8
+
 #ifdef BASE_LEGACY_UK6_SUPPORT
 int kbase_jd_submit(struct kbase_context *kctx,
 		const struct kbase_uk_job_submit *submit_data,
@@ -1130,6 +1134,9 @@ int kbase_jd_submit(struct kbase_context *kctx,
 	bool need_to_try_schedule_context = false;
 	struct kbase_device *kbdev;
 	void __user *user_addr;
+	base_jd_atom_v2 batch[KBASE_JD_SUBMIT_BATCH];
+	int batch_idx = 0, batch_len = 0;
+	bool locked = false;
 
 	/*
 	 * kbase_jd_submit isn't expected to fail and so all errors with the jobs
@@ -1168,6 +1175,10 @@ int kbase_jd_submit(struct kbase_context *kctx,
 			struct base_jd_atom_v2_uk6 user_atom_v6;
 			base_jd_dep_type dep_types[2] = {BASE_JD_DEP_TYPE_DATA, BASE_JD_DEP_TYPE_DATA};
 
+			if (locked) {
+				mutex_unlock(&jctx->lock);
+				locked = false;
+			}
 			if (copy_from_user(&user_atom_v6, user_addr,
 					sizeof(user_atom_v6))) {
 				err = -EINVAL;
@@ -1203,20 +1214,35 @@ int kbase_jd_submit(struct kbase_context *kctx,
 			user_atom.atom_number = user_atom_v6.atom_number;
 			user_atom.prio = user_atom_v6.prio;
 			user_atom.device_nr = user_atom_v6.device_nr;
+
+			user_addr = (void __user *)((uintptr_t) user_addr + submit_data->stride);
 		} else {
 #endif /* BASE_LEGACY_UK6_SUPPORT */
-		if (copy_from_user(&user_atom, user_addr, sizeof(user_atom)) != 0) {
-			err = -EINVAL;
-			KBASE_TIMELINE_ATOMS_IN_FLIGHT(kctx, atomic_sub_return(submit_data->nr_atoms - i, &kctx->timeline.jd_atoms_in_flight));
-			break;
+		/* Refill the batch; the stride was checked to be sizeof(base_jd_atom_v2) */
+		if (batch_idx == batch_len) {
+			batch_len = min_t(int, submit_data->nr_atoms - i, KBASE_JD_SUBMIT_BATCH);
+			batch_idx = 0;
+
+			if (locked) {
+				mutex_unlock(&jctx->lock);
+				locked = false;
+			}
+			if (copy_from_user(batch, user_addr, batch_len * sizeof(batch[0])) != 0) {
+				err = -EINVAL;
+				KBASE_TIMELINE_ATOMS_IN_FLIGHT(kctx, atomic_sub_return(submit_data->nr_atoms - i, &kctx->timeline.jd_atoms_in_flight));
+				break;
+			}
+			user_addr = (void __user *)((uintptr_t) user_addr + batch_len * submit_data->stride);
 		}
+		user_atom = batch[batch_idx++];
 #ifdef BASE_LEGACY_UK6_SUPPORT
 		}
 #endif /* BASE_LEGACY_UK6_SUPPORT */
 
-		user_addr = (void __user *)((uintptr_t) user_addr + submit_data->stride);
-
-		mutex_lock(&jctx->lock);
+		if (!locked) {
+			mutex_lock(&jctx->lock);
+			locked = true;
+		}
 #ifndef compiletime_assert
 #define compiletime_assert_defined
 #define compiletime_assert(x, msg) do { switch (0) { case 0: case (x):; } } \
@@ -1239,6 +1265,7 @@ while (false)
 			 * complete
 			 */
 			mutex_unlock(&jctx->lock);
+			locked = false;
 
 			/* This thread will wait for the atom to complete. Due
 			 * to thread scheduling we are not sure that the other
@@ -1258,6 +1285,7 @@ while (false)
 				return 0;
 			}
 			mutex_lock(&jctx->lock);
+			locked = true;
 		}
 
 		need_to_try_schedule_context |=
@@ -1267,9 +1295,10 @@ while (false)
 		 * (ie. being reset or replaying jobs).
 		 */
 		kbase_disjoint_event_potential(kbdev);
+	}
 
+	if (locked)
 		mutex_unlock(&jctx->lock);
-	}
 
 	if (need_to_try_schedule_context)
 		kbase_js_sched_all(kbdev);
@@ -2802,6 +2802,10 @@ void kbase_js_complete_atom(struct kbase_jd_atom *katom, ktime_t *end_timestamp)
 		/* Round up time spent to the minimum timer resolution */
 		if (microseconds_spent < KBASEP_JS_TICK_RESOLUTION_US)
 			microseconds_spent = KBASEP_JS_TICK_RESOLUTION_US;
+
+		/* MTK: per context accounting for GED */
+		kctx->mtk_gpu_busy_us += microseconds_spent;
+		kctx->mtk_gpu_jobs++;
 	}
 
 	/* Log the result of the job (completion status, and time spent). */
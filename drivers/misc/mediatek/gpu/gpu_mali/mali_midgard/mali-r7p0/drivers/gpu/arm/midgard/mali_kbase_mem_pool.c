@@ -23,6 +23,7 @@
 #include <linux/shrinker.h>
 #include <linux/atomic.h>
 #include <linux/version.h>
+#include <mt-plat/mt_page_pool.h>
 
 /* Backwards compatibility with kernels using the old carveout allocator */
 int __init kbase_carveout_mem_reserve(phys_addr_t size)
@@ -177,7 +178,10 @@ static struct page *kbase_mem_pool_alloc_page(struct kbase_mem_pool *pool)
 		gfp |= __GFP_NORETRY;
 	}
 
-	p = alloc_page(gfp);
+	/* Pages from the shared pool are zeroed already */
+	p = mt_page_pool_get(0);
+	if (!p)
+		p = alloc_page(gfp);
 	if (!p)
 		return NULL;
 
@@ -209,6 +213,26 @@ static void kbase_mem_pool_free_page(struct kbase_mem_pool *pool,
 	pool_dbg(pool, "freed page to kernel\n");
 }
 
+/* Frees a page no pool here has room for, via the shared page pool if
+ * that takes it, so the ION heaps can reuse it */
+static void kbase_mem_pool_release_page(struct kbase_mem_pool *pool,
+		struct page *p)
+{
+	struct device *dev = pool->kbdev->dev;
+
+	dma_unmap_page(dev, kbase_dma_addr(p), PAGE_SIZE, DMA_BIDIRECTIONAL);
+	kbase_clear_dma_addr(p);
+
+	if (mt_page_pool_put(p)) {
+		pool_dbg(pool, "released page to shared pool\n");
+		return;
+	}
+
+	__free_page(p);
+
+	pool_dbg(pool, "freed page to kernel\n");
+}
+
 static size_t kbase_mem_pool_shrink_locked(struct kbase_mem_pool *pool,
 		size_t nr_to_shrink)
 {
@@ -360,9 +384,10 @@ int kbase_mem_pool_init(struct kbase_mem_pool *pool,
 void kbase_mem_pool_term(struct kbase_mem_pool *pool)
 {
 	struct kbase_mem_pool *next_pool = pool->next_pool;
-	struct page *p;
+	struct page *p, *tmp;
 	size_t nr_to_spill = 0;
 	LIST_HEAD(spill_list);
+	LIST_HEAD(free_list);
 	int i;
 
 	pool_dbg(pool, "terminate()\n");
@@ -386,13 +411,18 @@ void kbase_mem_pool_term(struct kbase_mem_pool *pool)
 	}
 
 	while (!kbase_mem_pool_is_empty(pool)) {
-		/* Free remaining pages to kernel */
+		/* Release remaining pages once the lock is dropped */
 		p = kbase_mem_pool_remove_locked(pool);
-		kbase_mem_pool_free_page(pool, p);
+		list_add(&p->lru, &free_list);
 	}
 
 	kbase_mem_pool_unlock(pool);
 
+	list_for_each_entry_safe(p, tmp, &free_list, lru) {
+		list_del_init(&p->lru);
+		kbase_mem_pool_release_page(pool, p);
+	}
+
 	if (next_pool && nr_to_spill) {
 		/* Add new page list to next_pool */
 		kbase_mem_pool_add_list(next_pool, &spill_list, nr_to_spill);
@@ -442,7 +472,7 @@ void kbase_mem_pool_free(struct kbase_mem_pool *pool, struct page *p,
 		kbase_mem_pool_spill(next_pool, p);
 	} else {
 		/* Free page */
-		kbase_mem_pool_free_page(pool, p);
+		kbase_mem_pool_release_page(pool, p);
 	}
 }
 
@@ -566,7 +596,7 @@ void kbase_mem_pool_free_pages(struct kbase_mem_pool *pool, size_t nr_pages,
 			continue;
 
 		p = phys_to_page(pages[i]);
-		kbase_mem_pool_free_page(pool, p);
+		kbase_mem_pool_release_page(pool, p);
 		pages[i] = 0;
 	}
 
@@ -386,8 +386,15 @@ static inline int kbase_atomic_sub_pages(int num_pages, atomic_t *used_pages)
 
 /*
  * Max size for kbdev memory pool (in pages)
+ *
+ * With the shared GPU/multimedia page pool (mt-plat/mt_page_pool.h) that
+ * pool takes the place of the kbdev pool, which then keeps no pages.
  */
+#ifdef CONFIG_ION_SHARED_POOL
+#define KBASE_MEM_POOL_MAX_SIZE_KBDEV 0
+#else
 #define KBASE_MEM_POOL_MAX_SIZE_KBDEV (SZ_64M >> PAGE_SHIFT)
+#endif
 
 /*
  * Max size for kctx memory pool (in pages)
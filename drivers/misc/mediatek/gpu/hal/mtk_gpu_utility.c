@@ -246,6 +246,22 @@ EXPORT_SYMBOL(mtk_custom_boost_gpu_freq);
 
 //-----------------------------------------------------------------------------
 
+void (*mtk_input_boost_gpu_freq_fp)(unsigned int ui32FreqLevel) = NULL;
+EXPORT_SYMBOL(mtk_input_boost_gpu_freq_fp);
+
+bool mtk_input_boost_gpu_freq(unsigned int ui32FreqLevel)
+{
+    if (NULL != mtk_input_boost_gpu_freq_fp)
+    {
+        mtk_input_boost_gpu_freq_fp(ui32FreqLevel);
+        return true;
+    }
+    return false;
+}
+EXPORT_SYMBOL(mtk_input_boost_gpu_freq);
+
+//-----------------------------------------------------------------------------
+
 void (*mtk_custom_upbound_gpu_freq_fp)(unsigned int ui32FreqLevel) = NULL;
 EXPORT_SYMBOL(mtk_custom_upbound_gpu_freq_fp);
 
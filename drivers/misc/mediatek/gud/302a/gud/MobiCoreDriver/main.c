@@ -34,6 +34,7 @@
 #include <linux/mm.h>
 #include <linux/mman.h>
 #include <linux/completion.h>
+#include <linux/delay.h>
 #include <linux/fdtable.h>
 #include <linux/cdev.h>
 #ifdef CONFIG_OF
@@ -104,6 +105,14 @@ static struct sock *__get_socket(struct file *filp)
 /* MobiCore interrupt context data */
 struct mc_context ctx;
 
+/*
+ * When the daemon comes back for events that are already pending, wait this
+ * long before reporting them so a burst is handled in one pass. 0 is off.
+ */
+static unsigned int ssiq_coalesce_us;
+module_param(ssiq_coalesce_us, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(ssiq_coalesce_us, "SSIQ coalescing delay under load");
+
 /* Get process context from file pointer */
 static struct mc_instance *get_instance(struct file *file)
 {
@@ -1154,7 +1163,8 @@ static long mc_fd_admin_ioctl(struct file *file, unsigned int cmd,
 static ssize_t mc_fd_read(struct file *file, char *buffer, size_t buffer_len,
 			  loff_t *pos)
 {
-	int ret = 0, ssiq_counter;
+	int ret = 0;
+	bool pending;
 	struct mc_instance *instance = get_instance(file);
 
 	if (WARN(!instance, "No instance data available"))
@@ -1174,35 +1184,32 @@ static ssize_t mc_fd_read(struct file *file, char *buffer, size_t buffer_len,
 		return -EINVAL;
 	}
 
-	for (;;) {
-		if (wait_for_completion_interruptible(&ctx.isr_comp)) {
-			MCDRV_DBG_VERBOSE(mcd, "read interrupted");
-			return -ERESTARTSYS;
-		}
-
-		ssiq_counter = atomic_read(&ctx.isr_counter);
-		MCDRV_DBG_VERBOSE(mcd, "ssiq_counter=%i, ctx.counter=%i",
-				  ssiq_counter, ctx.evt_counter);
-
-		if (ssiq_counter != ctx.evt_counter) {
-			/* read data and exit loop without error */
-			ctx.evt_counter = ssiq_counter;
-			ret = 0;
-			break;
-		}
-
-		/* end loop if non-blocking */
+	pending = atomic_read(&ctx.isr_counter) != ctx.evt_counter;
+	if (!pending) {
+		/* nothing pending and non-blocking */
 		if (file->f_flags & O_NONBLOCK) {
 			MCDRV_DBG_ERROR(mcd, "non-blocking read");
 			return -EAGAIN;
 		}
 
-		if (signal_pending(current)) {
-			MCDRV_DBG_VERBOSE(mcd, "received signal.");
+		if (wait_event_interruptible(ctx.isr_wq,
+			atomic_read(&ctx.isr_counter) != ctx.evt_counter)) {
+			MCDRV_DBG_VERBOSE(mcd, "read interrupted");
 			return -ERESTARTSYS;
 		}
+	} else if (ssiq_coalesce_us) {
+		/*
+		 * The daemon is back while events are still queued, so they
+		 * arrive faster than it drains them: let more accumulate and
+		 * scan the notification queue once for all of them.
+		 */
+		usleep_range(ssiq_coalesce_us, ssiq_coalesce_us + 50);
 	}
 
+	/* all interrupts since the last read are reported as one event */
+	ctx.evt_counter = atomic_read(&ctx.isr_counter);
+	MCDRV_DBG_VERBOSE(mcd, "ctx.counter=%i", ctx.evt_counter);
+
 	/* read data and exit loop */
 	ret = copy_to_user(buffer, &ctx.evt_counter, sizeof(unsigned int));
 
@@ -1359,7 +1366,6 @@ static int mc_fd_admin_open(struct inode *inode, struct file *file)
 	ctx.daemon_inst = instance;
 	ctx.daemon = current;
 	instance->admin = true;
-	init_completion(&ctx.isr_comp);
 	/* init ssiq event counter */
 	ctx.evt_counter = atomic_read(&(ctx.isr_counter));
 
@@ -1413,8 +1419,10 @@ static irqreturn_t mc_ssiq_isr(int intr, void *context)
 	/* increment interrupt event counter */
 	atomic_inc(&(ctx.isr_counter));
 
-	/* signal the daemon */
-	complete(&ctx.isr_comp);
+	/* signal the daemon, unless it is busy and will see the counter anyway */
+	smp_mb__after_atomic();
+	if (waitqueue_active(&ctx.isr_wq))
+		wake_up_interruptible(&ctx.isr_wq);
 #ifdef MC_MEM_TRACES
 	mobicore_log_read();
 #endif
@@ -1551,7 +1559,7 @@ static int __init mobicore_init(void)
 	if (ret)
 		goto error;
 
-	init_completion(&ctx.isr_comp);
+	init_waitqueue_head(&ctx.isr_wq);
 
 	/* initialize event counter for signaling of an IRQ to zero */
 	atomic_set(&ctx.isr_counter, 0);
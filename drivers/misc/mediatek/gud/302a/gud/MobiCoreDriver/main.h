@@ -65,8 +65,8 @@ struct mc_context {
 	struct mc_buffer	mci_base;
 	/* MobiCore MCP buffer */
 	struct mc_mcp_buffer	*mcp;
-	/* event completion */
-	struct completion	isr_comp;
+	/* daemon waits here for the isr counter to move */
+	wait_queue_head_t	isr_wq;
 	/* isr event counter */
 	unsigned int		evt_counter;
 	atomic_t		isr_counter;
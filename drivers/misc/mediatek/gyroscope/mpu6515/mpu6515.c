@@ -676,13 +676,14 @@ static int MPU6515_FIFOConfig(struct i2c_client *client, u8 clk)
 static int MPU6515_ReadFifoData(struct i2c_client *client, s16 *data, int *datalen)
 {
 	struct mpu6515_i2c_data *obj = i2c_get_clientdata(client);
-	u8 buf[MPU6515_DATA_LEN] = { 0 };
+	u8 burst[MPU6515_FIFO_BURST];
+	u8 *buf = burst;
 	s16 tmp1[MPU6515_AXES_NUM] = { 0 };
 	s16 tmp2[MPU6515_AXES_NUM] = { 0 };
 	int err = 0;
 	u8 tmp = 0;
 	int packet_cnt = 0;
-	int i;
+	int i, n = 0;
 
 	GYRO_FUN();
 
@@ -721,19 +722,23 @@ static int MPU6515_ReadFifoData(struct i2c_client *client, s16 *data, int *datal
 
 	/* Within +-5% range: timing_tolerance * packet_thresh=0.05*75 */
 	if (packet_cnt && (abs(packet_thresh - packet_cnt) < 4)) {
-		/* read data in FIFO */
+		/* read data in FIFO, as many packets per transfer as fit in one burst */
 		for (i = 0; i < packet_cnt; i++) {
+			if (0 == n) {
+				n = min(packet_cnt - i, MPU6515_FIFO_BURST / MPU6515_DATA_LEN);
 #ifdef MPU6515_ACCESS_BY_GSE_I2C
-			if (MPU6515_hwmsen_read_block(MPU6515_REG_FIFO_DATA, buf, MPU6515_DATA_LEN))
+				err = MPU6515_hwmsen_read_fifo(burst, n * MPU6515_DATA_LEN);
 #else
-			if (hwmsen_read_block(client, MPU6515_REG_FIFO_DATA, buf, MPU6515_DATA_LEN))
+				err = hwmsen_read_block(client, MPU6515_REG_FIFO_DATA, burst, MPU6515_DATA_LEN);
+				n = 1;
 #endif
-				{
+				if (err) {
 					GYRO_ERR("MPU6515 read data from FIFO error: %d\n", err);
 					return -2;
-			} else {
-				GYRO_LOG("MPU6515 read Data of diff address from FIFO OK !\n");
+				}
+				buf = burst;
 			}
+			n--;
 
 			tmp1[MPU6515_AXIS_X] =
 			    (s16) ((buf[MPU6515_AXIS_X * 2 + 1]) | (buf[MPU6515_AXIS_X * 2] << 8));
@@ -753,6 +758,7 @@ static int MPU6515_ReadFifoData(struct i2c_client *client, s16 *data, int *datal
 			data[3 * i + MPU6515_AXIS_X] = tmp2[MPU6515_AXIS_X];
 			data[3 * i + MPU6515_AXIS_Y] = tmp2[MPU6515_AXIS_Y];
 			data[3 * i + MPU6515_AXIS_Z] = tmp2[MPU6515_AXIS_Z];
+			buf += MPU6515_DATA_LEN;
 
 			GYRO_LOG("gyro FIFO packet[%d]:[%04X %04X %04X] => [%5d %5d %5d]\n", i,
 				 data[3 * i + MPU6515_AXIS_X], data[3 * i + MPU6515_AXIS_Y],
@@ -572,14 +572,47 @@ static int batch_release(struct inode *node, struct file *fp)
 	return 0;
 }
 /*----------------------------------------------------------------------------*/
+/* spread the samples of a sensor evenly between its last and current fifo read */
+static void batch_fill_timestamp(struct hwm_sensor_data *data)
+{
+	struct batch_timestamp_info *pt;
+	int handle = data->sensor;
+
+	if (batch_context_obj->dev_list.data_dev[handle].is_timestamp_supported == 0) {
+		pt = &batch_context_obj->timestamp_info[handle];
+		data->time = pt->end_t - pt->start_t;
+		if (pt->total_count == 0)
+			BATCH_ERR("pt->total_count == 0\n");
+		else
+			do_div(data->time, pt->total_count);
+
+		if (data->time > (int64_t)batch_context_obj->dev_list
+				.data_dev[handle].samplingPeriodMs*1100000) {
+			data->time = pt->end_t - (int64_t)
+				batch_context_obj->dev_list.data_dev[handle]
+				.samplingPeriodMs*1100000*(pt->total_count-1);
+			BATCH_LOG("FIFO wrapper around1, %lld, %lld, %lld\n",
+					(int64_t)batch_context_obj->dev_list.data_dev[handle]
+					.samplingPeriodMs, (int64_t)pt->total_count,
+					(int64_t)batch_context_obj->dev_list.data_dev[handle]
+					.samplingPeriodMs*1100000*(pt->total_count-1));
+			BATCH_LOG("FIFO wrapper around2, %lld, %lld, %lld\n", pt->start_t,
+					data->time, pt->end_t);
+		} else
+				data->time += pt->start_t;
+
+		pt->start_t = data->time;
+	}
+	data->sensor = IDToSensorType(handle);
+}
+/*----------------------------------------------------------------------------*/
 static long batch_unlocked_ioctl(struct file *fp, unsigned int cmd, unsigned long arg)
 {
 	void __user *argp = (void __user *)arg;
 	struct batch_trans_data batch_sensors_data;
 	int i;
 	int err;
-	struct batch_timestamp_info *pt;
-	int handle;
+	int count;
 
 	if (batch_context_obj == NULL) {
 		BATCH_ERR("null pointer!!\n");
@@ -596,40 +629,31 @@ static long batch_unlocked_ioctl(struct file *fp, unsigned int cmd, unsigned lon
 		/* BATCH_ERR("BATCH_IO_GET_SENSORS_DATA1, %d, %d, %d!!\n", batch_sensors_data.numOfDataReturn,
 		*batch_sensors_data.numOfDataLeft, batch_context_obj->numOfDataLeft); */
 
-		for (i = 0; i < batch_context_obj->numOfDataLeft && i < batch_sensors_data.numOfDataReturn; i++) {
-			err = batch_context_obj->dev_list.data_dev[ID_SENSOR_MAX_HANDLE]
-				.get_data(0, &batch_sensors_data.data[i]);
-			if (err)
-				BATCH_ERR("BATCH_IO_GET_SENSORS_DATA err = %d\n", err);
-			else {
-				handle = batch_sensors_data.data[i].sensor;
-
-				if (batch_context_obj->dev_list.data_dev[handle].is_timestamp_supported == 0) {
-					pt = &batch_context_obj->timestamp_info[handle];
-					batch_sensors_data.data[i].time = pt->end_t - pt->start_t;
-					if (pt->total_count == 0)
-						BATCH_ERR("pt->total_count == 0\n");
-					else
-						do_div(batch_sensors_data.data[i].time, pt->total_count);
-
-					if (batch_sensors_data.data[i].time > (int64_t)batch_context_obj->dev_list
-							.data_dev[handle].samplingPeriodMs*1100000) {
-						batch_sensors_data.data[i].time = pt->end_t - (int64_t)
-							batch_context_obj->dev_list.data_dev[handle]
-							.samplingPeriodMs*1100000*(pt->total_count-1);
-						BATCH_LOG("FIFO wrapper around1, %lld, %lld, %lld\n",
-								(int64_t)batch_context_obj->dev_list.data_dev[handle]
-								.samplingPeriodMs, (int64_t)pt->total_count,
-								(int64_t)batch_context_obj->dev_list.data_dev[handle]
-								.samplingPeriodMs*1100000*(pt->total_count-1));
-						BATCH_LOG("FIFO wrapper around2, %lld, %lld, %lld\n", pt->start_t,
-								batch_sensors_data.data[i].time, pt->end_t);
-					} else
-							batch_sensors_data.data[i].time += pt->start_t;
-
-					pt->start_t = batch_sensors_data.data[i].time;
-				}
-				batch_sensors_data.data[i].sensor = IDToSensorType(handle);
+		if (batch_context_obj->dev_list.data_dev[ID_SENSOR_MAX_HANDLE].get_data_bulk != NULL) {
+			/* drain the whole request from the hub fifo in one pass */
+			count = min(batch_context_obj->numOfDataLeft, batch_sensors_data.numOfDataReturn);
+			count = min_t(int, count, MAX_BATCH_DATA_PER_QUREY);
+			err = 0;
+			if (count > 0)
+				err = batch_context_obj->dev_list.data_dev[ID_SENSOR_MAX_HANDLE]
+					.get_data_bulk(batch_sensors_data.data, count);
+			if (err < 0) {
+				BATCH_ERR("BATCH_IO_GET_SENSORS_DATA bulk err = %d\n", err);
+				err = 0;
+			}
+			/* fifo ran dry before the count from get_fifo_status, nothing left */
+			if (err < count)
+				batch_context_obj->numOfDataLeft = err;
+			for (i = 0; i < err; i++)
+				batch_fill_timestamp(&batch_sensors_data.data[i]);
+		} else {
+			for (i = 0; i < batch_context_obj->numOfDataLeft && i < batch_sensors_data.numOfDataReturn; i++) {
+				err = batch_context_obj->dev_list.data_dev[ID_SENSOR_MAX_HANDLE]
+					.get_data(0, &batch_sensors_data.data[i]);
+				if (err)
+					BATCH_ERR("BATCH_IO_GET_SENSORS_DATA err = %d\n", err);
+				else
+					batch_fill_timestamp(&batch_sensors_data.data[i]);
 			}
 		}
 
@@ -769,6 +793,7 @@ int batch_register_data_path(int handle, struct batch_data_path *data)
 		cxt->dev_list.data_dev[handle].get_data = data->get_data;
 		cxt->dev_list.data_dev[handle].flags = data->flags;
 		cxt->dev_list.data_dev[handle].get_fifo_status = data->get_fifo_status;
+		cxt->dev_list.data_dev[handle].get_data_bulk = data->get_data_bulk;
 		/* cxt ->dev_list.data_dev[handle].is_batch_supported = data->is_batch_supported; */
 		return 0;
 	}
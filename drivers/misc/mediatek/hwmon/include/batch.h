@@ -75,6 +75,8 @@ struct batch_data_path {
 	int (*get_data)(int handle, struct hwm_sensor_data *data);
 	int (*get_fifo_status)(int *len, int *status, char *reserved,
 		struct batch_timestamp_info *p_batch_timestampe_info);
+	/* optional: copy up to count fifo events at once, return value: number of events copied */
+	int (*get_data_bulk)(struct hwm_sensor_data *data, int count);
 	int samplingPeriodMs;
 	int maxBatchReportLatencyMs;/* report latency for every sensor */
 	int flags;/* reserved */
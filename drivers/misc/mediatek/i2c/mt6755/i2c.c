@@ -1020,20 +1020,50 @@ err:
 	return ret;
 }
 
+/*
+ * Take (on) or drop an extra reference on the bus clocks so they stay up
+ * across several messages instead of being gated after each one.
+ */
+static void mt_i2c_clock_hold(struct mt_i2c_t *i2c, bool dma, bool on)
+{
+	bool dma_en = i2c->dma_en;
+
+	i2c->dma_en = dma;
+	if (on)
+		mt_i2c_clock_enable(i2c);
+	else
+		mt_i2c_clock_disable(i2c);
+	i2c->dma_en = dma_en;
+}
+
 static s32 mt_i2c_do_transfer(struct mt_i2c_t *i2c, struct mt_i2c_msg *msgs, s32 num)
 {
 	s32 ret = 0;
 	s32 left_num = num;
+	bool hold = num > 1;
+	bool hold_dma = false;
+	s32 i;
+
+	if (hold) {
+		for (i = 0; i < num; i++)
+			if (msgs[i].ext_flag & I2C_DMA_FLAG)
+				hold_dma = true;
+		mt_i2c_clock_hold(i2c, hold_dma, true);
+	}
 
 	while (left_num--) {
 		ret = mt_i2c_start_xfer(i2c, msgs++);
 		if (ret < 0) {
 			if (ret != -EINVAL_I2C)	/*We never try again when the param is invalid */
-				return -EAGAIN;
-			else
-				return -EINVAL_I2C;
+				ret = -EAGAIN;
+			break;
 		}
 	}
+
+	if (hold)
+		mt_i2c_clock_hold(i2c, hold_dma, false);
+	if (ret < 0)
+		return ret;
 	/*the return value is number of executed messages */
 	return num;
 }
@@ -1264,6 +1294,120 @@ int mtk_i2c_master_recv(const struct i2c_client *client,
 }
 EXPORT_SYMBOL(mtk_i2c_master_recv);
 
+#ifdef CONFIG_MTK_I2C_EXTENSION
+/*
+ * One write-then-read (WRRD) transaction: the register address goes out and
+ * the data comes back with a repeated start and a single controller setup.
+ * Anything larger than the FIFO goes through the adapter's DMA buffer.
+ * Caller holds i2c->mutex.
+ */
+static int _mtk_i2c_write_read(struct mt_i2c_t *i2c, const struct i2c_client *client,
+			       const u8 *wbuf, u16 wlen, u8 *rbuf, u16 rlen)
+{
+	struct mt_i2c_msg msg;
+	u8 fifo_buf[I2C_FIFO_SIZE];
+	bool dma = wlen > I2C_FIFO_SIZE || rlen > I2C_FIFO_SIZE;
+	u8 *buf = dma ? i2c->dma_buf.vaddr : fifo_buf;
+	s32 ret = 0;
+	s32 retry;
+
+	if (!wlen || !rlen || wlen > 0xFF || rlen > 0xFF)
+		return -EINVAL;
+
+	msg.addr = client->addr;
+	msg.flags = client->flags & I2C_M_TEN;
+	msg.len = wlen | (rlen << 8);
+	msg.timing = client->timing;
+	msg.ext_flag = (client->ext_flag & ~(I2C_DMA_FLAG | I2C_WR_FLAG | I2C_RS_FLAG))
+	    | I2C_WR_FLAG | I2C_RS_FLAG;
+	if (dma) {
+		msg.ext_flag |= I2C_DMA_FLAG;
+		msg.buf = (u8 *) mt_i2c_bus_to_virt(i2c->dma_buf.paddr);
+	} else {
+		msg.buf = fifo_buf;
+	}
+
+	for (retry = 0; retry < i2c->adap.retries; retry++) {
+		/* tx and rx share the buffer, refill it on every attempt */
+		memcpy(buf, wbuf, wlen);
+		ret = mt_i2c_do_transfer(i2c, &msg, 1);
+		if (ret != -EAGAIN)
+			break;
+		if (retry < i2c->adap.retries - 1)
+			udelay(100);
+	}
+
+	if (ret == -EAGAIN)
+		return -EREMOTEIO;
+	if (ret < 0)
+		return ret;
+	memcpy(rbuf, buf, rlen);
+	return rlen;
+}
+
+/**
+ * mtk_i2c_write_read - write a register address and read back its data
+ * @client: Handle to slave device
+ * @wbuf: Bytes to write (usually the register address)
+ * @wlen: Number of bytes to write, at most 255
+ * @rbuf: Where to store data read from slave
+ * @rlen: Number of bytes to read, at most 255
+ *
+ * Uses client->timing and client->ext_flag for speed and controller flags.
+ * Returns negative errno, or else the number of bytes read.
+ */
+int mtk_i2c_write_read(const struct i2c_client *client,
+		       const u8 *wbuf, u16 wlen, u8 *rbuf, u16 rlen)
+{
+	struct mt_i2c_t *i2c = i2c_get_adapdata(client->adapter);
+	int ret;
+
+	mutex_lock(&i2c->mutex);
+	ret = _mtk_i2c_write_read(i2c, client, wbuf, wlen, rbuf, rlen);
+	mutex_unlock(&i2c->mutex);
+
+	return ret;
+}
+EXPORT_SYMBOL(mtk_i2c_write_read);
+
+/**
+ * mtk_i2c_write_read_batch - run several write-then-read transactions
+ * @client: Handle to slave device
+ * @req: Array of transactions
+ * @num: Number of entries in @req
+ *
+ * For polling a set of registers: the adapter is locked once and its clocks
+ * stay enabled until the last transaction is done.
+ * Returns negative errno, or else the number of completed transactions.
+ */
+int mtk_i2c_write_read_batch(const struct i2c_client *client,
+			     struct mtk_i2c_wrrd *req, int num)
+{
+	struct mt_i2c_t *i2c = i2c_get_adapdata(client->adapter);
+	bool dma = false;
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < num; i++)
+		if (req[i].wlen > I2C_FIFO_SIZE || req[i].rlen > I2C_FIFO_SIZE)
+			dma = true;
+
+	mutex_lock(&i2c->mutex);
+	mt_i2c_clock_hold(i2c, dma, true);
+	for (i = 0; i < num; i++) {
+		ret = _mtk_i2c_write_read(i2c, client, req[i].wbuf, req[i].wlen,
+					  req[i].rbuf, req[i].rlen);
+		if (ret < 0)
+			break;
+	}
+	mt_i2c_clock_hold(i2c, dma, false);
+	mutex_unlock(&i2c->mutex);
+
+	return (ret < 0) ? ret : num;
+}
+EXPORT_SYMBOL(mtk_i2c_write_read_batch);
+#endif
+
 #ifdef I2C_DRIVER_IN_KERNEL
 static s32 _i2c_deal_result_3dcamera(struct mt_i2c_t *i2c, struct mt_i2c_msg *msg)
 {
@@ -389,6 +389,8 @@ static kal_uint16 read_cmos_sensor(kal_uint32 addr)
 }
 
 #define write_cmos_sensor(addr, para) iWriteReg((u16) addr , (u32) para , 1,  imgsensor.i2c_write_id)
+#define table_write_cmos_sensor(table) \
+	iTableWriteReg(table, ARRAY_SIZE(table), imgsensor.i2c_write_id)
 
 static kal_uint32 imx214_ATR(UINT16 DarkLimit, UINT16 OverExp)
 {
@@ -747,361 +749,409 @@ static void night_mode(kal_bool enable)
 /*No Need to implement this function*/
 }	/*	night_mode	*/
 
+static const kal_uint16 imx214_init_setting[] = {
+	0x0136, 0x18,
+	0x0137, 0x00,
+
+	0x0101, 0x00,
+	0x0105, 0x01,
+	0x0106, 0x01,
+	0x4550, 0x02,
+	0x4601, 0x00,
+	0x4642, 0x05,
+	0x6276, 0x00,
+	0x900E, 0x06,
+	0xA802, 0x90,
+	0xA803, 0x11,
+	0xA804, 0x62,
+	0xA805, 0x77,
+	0xA806, 0xAE,
+	0xA807, 0x34,
+	0xA808, 0xAE,
+	0xA809, 0x35,
+	0xA80A, 0x62,
+	0xA80B, 0x83,
+	0xAE33, 0x00,
+
+	0x4174, 0x00,
+	0x4175, 0x11,
+	0x4612, 0x29,
+	0x461B, 0x12,
+	0x461F, 0x06,
+	0x4635, 0x07,
+	0x4637, 0x30,
+	0x463F, 0x18,
+	0x4641, 0x0D,
+	0x465B, 0x12,
+	0x465F, 0x11,
+	0x4663, 0x11,
+	0x4667, 0x0F,
+	0x466F, 0x0F,
+	0x470E, 0x09,
+	0x4909, 0xAB,
+	0x490B, 0x95,
+	0x4915, 0x5D,
+	0x4A5F, 0xFF,
+	0x4A61, 0xFF,
+	0x4A73, 0x62,
+	0x4A85, 0x00,
+	0x4A87, 0xFF,
+	0x583C, 0x04,
+	0x620E, 0x04,
+	0x6EB2, 0x01,
+	0x6EB3, 0x00,
+	0x9300, 0x02,
+
+	0x3001, 0x07,
+	0x6D12, 0x3F,
+	0x6D13, 0xFF,
+	0x9344, 0x03,
+	0x9706, 0x10,
+	0x9707, 0x03,
+	0x9708, 0x03,
+	0x9E04, 0x01,
+	0x9E05, 0x00,
+	0x9E0C, 0x01,
+	0x9E0D, 0x02,
+	0x9E24, 0x00,
+	0x9E25, 0x8C,
+	0x9E26, 0x00,
+	0x9E27, 0x94,
+	0x9E28, 0x00,
+	0x9E29, 0x96,
+	//write_cmos_sensor(0x5041,0x00);//no embedded data
+
+	0x69DB, 0x01,
+	0x6957, 0x01,
+	0x6987, 0x17,
+	0x698A, 0x03,
+	0x698B, 0x03,
+	0x0B8E, 0x01,
+	0x0B8F, 0x00,
+	0x0B90, 0x01,
+	0x0B91, 0x00,
+	0x0B92, 0x01,
+	0x0B93, 0x00,
+	0x0B94, 0x01,
+	0x0B95, 0x00,
+	0x6E50, 0x00,
+	0x6E51, 0x32,
+	0x9340, 0x00,
+	0x9341, 0x3C,
+	0x9342, 0x03,
+	0x9343, 0xFF,
+	0x0101, 0x03,
+};
+
 static void sensor_init(void)
 {
 	LOG_INF("E\n");
     //init setting
-    write_cmos_sensor(0x0136,0x18);
-    write_cmos_sensor(0x0137,0x00);
-
-    write_cmos_sensor(0x0101,0x00);
-    write_cmos_sensor(0x0105,0x01);
-    write_cmos_sensor(0x0106,0x01);
-    write_cmos_sensor(0x4550,0x02);
-    write_cmos_sensor(0x4601,0x00);
-    write_cmos_sensor(0x4642,0x05);
-    write_cmos_sensor(0x6276,0x00);
-    write_cmos_sensor(0x900E,0x06);
-    write_cmos_sensor(0xA802,0x90);
-    write_cmos_sensor(0xA803,0x11);
-    write_cmos_sensor(0xA804,0x62);
-    write_cmos_sensor(0xA805,0x77);
-    write_cmos_sensor(0xA806,0xAE);
-    write_cmos_sensor(0xA807,0x34);
-    write_cmos_sensor(0xA808,0xAE);
-    write_cmos_sensor(0xA809,0x35);
-    write_cmos_sensor(0xA80A,0x62);
-    write_cmos_sensor(0xA80B,0x83);
-    write_cmos_sensor(0xAE33,0x00);
-
-    write_cmos_sensor(0x4174,0x00);
-    write_cmos_sensor(0x4175,0x11);
-    write_cmos_sensor(0x4612,0x29);
-    write_cmos_sensor(0x461B,0x12);
-    write_cmos_sensor(0x461F,0x06);
-    write_cmos_sensor(0x4635,0x07);
-    write_cmos_sensor(0x4637,0x30);
-    write_cmos_sensor(0x463F,0x18);
-    write_cmos_sensor(0x4641,0x0D);
-    write_cmos_sensor(0x465B,0x12);
-    write_cmos_sensor(0x465F,0x11);
-    write_cmos_sensor(0x4663,0x11);
-    write_cmos_sensor(0x4667,0x0F);
-    write_cmos_sensor(0x466F,0x0F);
-    write_cmos_sensor(0x470E,0x09);
-    write_cmos_sensor(0x4909,0xAB);
-    write_cmos_sensor(0x490B,0x95);
-    write_cmos_sensor(0x4915,0x5D);
-    write_cmos_sensor(0x4A5F,0xFF);
-    write_cmos_sensor(0x4A61,0xFF);
-    write_cmos_sensor(0x4A73,0x62);
-    write_cmos_sensor(0x4A85,0x00);
-    write_cmos_sensor(0x4A87,0xFF);
-    write_cmos_sensor(0x583C,0x04);
-    write_cmos_sensor(0x620E,0x04);
-    write_cmos_sensor(0x6EB2,0x01);
-    write_cmos_sensor(0x6EB3,0x00);
-    write_cmos_sensor(0x9300,0x02);
-
-    write_cmos_sensor(0x3001,0x07);
-    write_cmos_sensor(0x6D12,0x3F);
-    write_cmos_sensor(0x6D13,0xFF);
-    write_cmos_sensor(0x9344,0x03);
-    write_cmos_sensor(0x9706,0x10);
-    write_cmos_sensor(0x9707,0x03);
-    write_cmos_sensor(0x9708,0x03);
-    write_cmos_sensor(0x9E04,0x01);
-    write_cmos_sensor(0x9E05,0x00);
-    write_cmos_sensor(0x9E0C,0x01);
-    write_cmos_sensor(0x9E0D,0x02);
-    write_cmos_sensor(0x9E24,0x00);
-    write_cmos_sensor(0x9E25,0x8C);
-    write_cmos_sensor(0x9E26,0x00);
-    write_cmos_sensor(0x9E27,0x94);
-    write_cmos_sensor(0x9E28,0x00);
-    write_cmos_sensor(0x9E29,0x96);
-    //write_cmos_sensor(0x5041,0x00);//no embedded data
-
-    write_cmos_sensor(0x69DB,0x01);
-    write_cmos_sensor(0x6957,0x01);
-    write_cmos_sensor(0x6987,0x17);
-    write_cmos_sensor(0x698A,0x03);
-    write_cmos_sensor(0x698B,0x03);
-    write_cmos_sensor(0x0B8E,0x01);
-    write_cmos_sensor(0x0B8F,0x00);
-    write_cmos_sensor(0x0B90,0x01);
-    write_cmos_sensor(0x0B91,0x00);
-    write_cmos_sensor(0x0B92,0x01);
-    write_cmos_sensor(0x0B93,0x00);
-    write_cmos_sensor(0x0B94,0x01);
-    write_cmos_sensor(0x0B95,0x00);
-    write_cmos_sensor(0x6E50,0x00);
-    write_cmos_sensor(0x6E51,0x32);
-    write_cmos_sensor(0x9340,0x00);
-    write_cmos_sensor(0x9341,0x3C);
-    write_cmos_sensor(0x9342,0x03);
-    write_cmos_sensor(0x9343,0xFF);
-    write_cmos_sensor(0x0101,0x03);
+    table_write_cmos_sensor(imx214_init_setting);
 }	/*	sensor_init  */
 
 
+static const kal_uint16 imx214_preview_setting[] = {
+	0x0100, 0x00,
+	0x0114, 0x03,
+	0x0220, 0x00,
+	0x0221, 0x11,
+	0x0222, 0x01,
+	0x0340, 0x08,
+	0x0341, 0x3E,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x01,
+	0x0901, 0x22,
+	0x0902, 0x02,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x08,
+	0x034D, 0x38,
+	0x034E, 0x06,
+	0x034F, 0x18,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x08,
+	0x040D, 0x38,
+	0x040E, 0x06,
+	0x040F, 0x18,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x64,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x0C,
+	0x0821, 0x80,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x06,
+	0x3A04, 0x68,
+	0x3A05, 0x01,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+
+	0x30B4, 0x00,
+
+	0x3A02, 0xFF,
+
+	0x3011, 0x00,
+	0x3013, 0x00,
+
+	0x0202, 0x08,
+	0x0203, 0x34,
+	0x0224, 0x01,
+	0x0225, 0xF4,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
 static void preview_setting(void)
 {
 	//Preview 2104*1560 30fps 24M MCLK 4lane 608Mbps/lane
 	// preview 30.01fps
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x00);
-    write_cmos_sensor(0x0221,0x11);
-    write_cmos_sensor(0x0222,0x01);
-    write_cmos_sensor(0x0340,0x08);
-    write_cmos_sensor(0x0341,0x3E);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x01);
-    write_cmos_sensor(0x0901,0x22);
-    write_cmos_sensor(0x0902,0x02);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x08);
-    write_cmos_sensor(0x034D,0x38);
-    write_cmos_sensor(0x034E,0x06);
-    write_cmos_sensor(0x034F,0x18);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x08);
-    write_cmos_sensor(0x040D,0x38);
-    write_cmos_sensor(0x040E,0x06);
-    write_cmos_sensor(0x040F,0x18);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x64);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x0C);
-    write_cmos_sensor(0x0821,0x80);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x06);
-    write_cmos_sensor(0x3A04,0x68);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0xFF);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x00);
-
-    write_cmos_sensor(0x0202,0x08);
-    write_cmos_sensor(0x0203,0x34);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0xF4);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-
-    write_cmos_sensor(0x0138,0x01);
-    write_cmos_sensor(0x0100,0x01);
+    table_write_cmos_sensor(imx214_preview_setting);
 }   /*  preview_setting  */
 
+static const kal_uint16 imx214_preview_HDR_setting[] = {
+	0x0100, 0x00,
+	0x0114, 0x03,
+	0x0220, 0x21,
+	0x0221, 0x22,
+	0x0222, 0x08,
+	0x0340, 0x08,
+	0x0341, 0x3E,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x08,
+	0x034D, 0x38,
+	0x034E, 0x06,
+	0x034F, 0x18,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x08,
+	0x040D, 0x38,
+	0x040E, 0x06,
+	0x040F, 0x18,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x64,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x0C,
+	0x0821, 0x80,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x06,
+	0x3A04, 0xE8,
+	0x3A05, 0x01,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+
+	0x30B4, 0x00,
+
+	0x3A02, 0x06,
+
+	0x3011, 0x00,
+	0x3013, 0x01,
+
+	0x0202, 0x08,
+	0x0203, 0x34,
+	0x0224, 0x01,
+	0x0225, 0x06,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+	//mHDR  relation setting
+	0x3010, 0x00,
+	0x6D3A, 0x00, // 0: 16X16, 1:8X8
+	0x3011, 0x00,
+	0x3013, 0x01, // STATS output Enable
+	0x5068, 0x35,
+	0x5069, 0x01,
+	0x30C2, 0x00,
+	0x30C3, 0x40,
+	0x610A, 0x08,
+	//[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
+	//[5]:0 auto, 1:direct
+	0x0220, 0x21,
+	// hdr binning mode
+	0x0221, 0x22,
+	//LE/SE ration 1,2,4,8
+	0x0222, 0x08,
+};
+
+static const kal_uint16 imx214_preview_HDR_setting2[] = {
+	0x9313, 0x40,
+	0x9318, 0x0C,
+	0x9319, 0x00,
+	0x9344, 0x00,
+	0x9348, 0x01,
+	0x9349, 0xC2,
+	0x934A, 0x2,
+	0x934B, 0xE4,
+	0x934E, 0x0,
+};
+
+static const kal_uint16 imx214_preview_HDR_setting3[] = {
+	0x934F, 0xC7, // RATIO: 8
+
+	0x9354, 0x01,
+	0x9355, 0x80,
+	0x9356, 0x2,
+	0x9357, 0x1C,
+
+	// General
+	0x6939, 0x3,
+	0x693b, 0x3,
+	0x4550, 0x2,
+	0x6227, 0x11,
+};
+
+static const kal_uint16 imx214_preview_HDR_setting4[] = {
+	0x30b2, 0x01,
+	0x30b3, 0x01,
+	0x30b4, 0x01,
+	0x30b5, 0x01,
+	0x30b6, 0x01,
+	0x30b7, 0x01,
+	0x30b8, 0x01,
+	0x30b9, 0x01,
+	0x30ba, 0x01,
+	0x30bb, 0x01,
+	0x30bc, 0x01,
+};
+
+static const kal_uint16 imx214_preview_HDR_setting5[] = {
+	0x30b2, 0x00,
+	0x30b3, 0x00,
+	0x30b4, 0x00,
+	0x30b5, 0x00,
+	0x30b6, 0x00,
+	0x30b7, 0x00,
+	0x30b8, 0x00,
+	0x30b9, 0x00,
+	0x30ba, 0x00,
+	0x30bb, 0x00,
+	0x30bc, 0x00,
+};
+
 static void preview_setting_HDR(void)
 {
     LOG_INF("preview_setting_mHDR\n");
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x21);
-    write_cmos_sensor(0x0221,0x22);
-    write_cmos_sensor(0x0222,0x08);
-    write_cmos_sensor(0x0340,0x08);
-    write_cmos_sensor(0x0341,0x3E);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x00);
-    write_cmos_sensor(0x0901,0x00);
-    write_cmos_sensor(0x0902,0x00);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x08);
-    write_cmos_sensor(0x034D,0x38);
-    write_cmos_sensor(0x034E,0x06);
-    write_cmos_sensor(0x034F,0x18);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x08);
-    write_cmos_sensor(0x040D,0x38);
-    write_cmos_sensor(0x040E,0x06);
-    write_cmos_sensor(0x040F,0x18);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x64);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x0C);
-    write_cmos_sensor(0x0821,0x80);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x06);
-    write_cmos_sensor(0x3A04,0xE8);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0x06);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01);
-
-    write_cmos_sensor(0x0202,0x08);
-    write_cmos_sensor(0x0203,0x34);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0x06);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-    //mHDR  relation setting
-    write_cmos_sensor(0x3010,0x00);
-    write_cmos_sensor(0x6D3A,0x00); // 0: 16X16, 1:8X8
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01); // STATS output Enable
-    write_cmos_sensor(0x5068,0x35);
-    write_cmos_sensor(0x5069,0x01);
-    write_cmos_sensor(0x30C2,0x00);
-    write_cmos_sensor(0x30C3,0x40);
-    write_cmos_sensor(0x610A,0x08);
-    //[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
-    //[5]:0 auto, 1:direct
-    write_cmos_sensor(0x0220,0x21);
-    // hdr binning mode
-    write_cmos_sensor(0x0221,0x22);
-    //LE/SE ration 1,2,4,8
-    write_cmos_sensor(0x0222,0x08);
+    table_write_cmos_sensor(imx214_preview_HDR_setting);
     //ATR
     imx214_ATR(3,3);
 #if 0
     /*
     *   FAE PROVIDIE
     */
-    write_cmos_sensor(0x9313,0x40);
-    write_cmos_sensor(0x9318,0x0C);
-    write_cmos_sensor(0x9319,0x00);
-    write_cmos_sensor(0x9344,0x00);
-    write_cmos_sensor(0x9348,0x01);
-    write_cmos_sensor(0x9349,0xC2);
-    write_cmos_sensor(0x934A,0x2);
-    write_cmos_sensor(0x934B,0xE4);
-    write_cmos_sensor(0x934E,0x0);
+    table_write_cmos_sensor(imx214_preview_HDR_setting2);
 
     /*
     *   DIFF for RATIO:1 & 8
     */
     //write_cmos_sensor(0x934F,0x47);  // RATIO: 1
-    write_cmos_sensor(0x934F,0xC7);  // RATIO: 8
-
-    write_cmos_sensor(0x9354,0x01);
-    write_cmos_sensor(0x9355,0x80);
-    write_cmos_sensor(0x9356,0x2);
-    write_cmos_sensor(0x9357,0x1C);
-
-    // General
-    write_cmos_sensor(0x6939,0x3);
-    write_cmos_sensor(0x693b,0x3);
-    write_cmos_sensor(0x4550,0x2);
-    write_cmos_sensor(0x6227,0x11);
+    table_write_cmos_sensor(imx214_preview_HDR_setting3);
 #endif
     /*
     *   END OF FAE PROVIDIE
@@ -1109,31 +1159,11 @@ static void preview_setting_HDR(void)
     // Normal: 0x00, ZigZag: 0x01
     if(imgsensor.ihdr_mode == 9)
     {
-        write_cmos_sensor(0x30b2,0x01);
-        write_cmos_sensor(0x30b3,0x01);
-        write_cmos_sensor(0x30b4,0x01);
-        write_cmos_sensor(0x30b5,0x01);
-        write_cmos_sensor(0x30b6,0x01);
-        write_cmos_sensor(0x30b7,0x01);
-        write_cmos_sensor(0x30b8,0x01);
-        write_cmos_sensor(0x30b9,0x01);
-        write_cmos_sensor(0x30ba,0x01);
-        write_cmos_sensor(0x30bb,0x01);
-        write_cmos_sensor(0x30bc,0x01);
+        table_write_cmos_sensor(imx214_preview_HDR_setting4);
     }
     else
     {
-        write_cmos_sensor(0x30b2,0x00);
-        write_cmos_sensor(0x30b3,0x00);
-        write_cmos_sensor(0x30b4,0x00);
-        write_cmos_sensor(0x30b5,0x00);
-        write_cmos_sensor(0x30b6,0x00);
-        write_cmos_sensor(0x30b7,0x00);
-        write_cmos_sensor(0x30b8,0x00);
-        write_cmos_sensor(0x30b9,0x00);
-        write_cmos_sensor(0x30ba,0x00);
-        write_cmos_sensor(0x30bb,0x00);
-        write_cmos_sensor(0x30bc,0x00);
+        table_write_cmos_sensor(imx214_preview_HDR_setting5);
     }
 
     write_cmos_sensor(0x0138,0x01);
@@ -1142,6 +1172,306 @@ static void preview_setting_HDR(void)
 
 }	/*	preview_setting  */
 
+static const kal_uint16 imx214_capture_setting[] = {
+	0x0100, 0x00,
+	0x0114, 0x03,
+	0x0220, 0x00,
+	0x0221, 0x11,
+	0x0222, 0x01,
+	0x0340, 0x0C,
+	0x0341, 0x58,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x96,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x12,
+	0x0821, 0xC0,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x09,
+	0x3A04, 0x20,
+	0x3A05, 0x01,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+
+	0x30B4, 0x00,
+
+	0x3A02, 0xff,
+
+	0x3011, 0x00,
+	0x3013, 0x01,
+
+	0x0202, 0x0C,
+	0x0203, 0x4E,
+	0x0224, 0x01,
+	0x0225, 0xF4,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
+static const kal_uint16 imx214_capture_setting2[] = {
+	0x0100, 0x00,
+
+	0x0114, 0x03,
+	0x0220, 0x00,
+	0x0221, 0x11,
+	0x0222, 0x01,
+	0x0340, 0x0C,
+	0x0341, 0x94,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x79,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x0F,
+	0x0821, 0x20,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x08,
+	0x3A04, 0xC0,
+	0x3A05, 0x02,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+	0x30B4, 0x00,
+	0x3A02, 0xFF,
+	0x3013, 0x00,
+	0x0202, 0x0C,
+	0x0203, 0x8A,
+	0x0224, 0x01,
+	0x0225, 0xF4,
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
+static const kal_uint16 imx214_capture_setting3[] = {
+	0x0100, 0x00,
+
+	0x0114, 0x03,
+	0x0220, 0x00,
+	0x0221, 0x11,
+	0x0222, 0x01,
+	0x0340, 0x0C,
+	0x0341, 0x94,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x4c,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x09,
+	0x0821, 0x80,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x08,
+	0x3A04, 0xC0,
+	0x3A05, 0x02,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+	0x30B4, 0x00,
+	0x3A02, 0xFF,
+	0x3013, 0x00,
+	0x0202, 0x0C,
+	0x0203, 0x8A,
+	0x0224, 0x01,
+	0x0225, 0xF4,
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
 static void capture_setting(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
@@ -1151,667 +1481,399 @@ static void capture_setting(kal_uint16 currefps)
     if(currefps==300)
     {
         // full size 30.33ps
-        write_cmos_sensor(0x0100,0x00);
-        write_cmos_sensor(0x0114,0x03);
-        write_cmos_sensor(0x0220,0x00);
-        write_cmos_sensor(0x0221,0x11);
-        write_cmos_sensor(0x0222,0x01);
-        write_cmos_sensor(0x0340,0x0C);
-        write_cmos_sensor(0x0341,0x58);
-        write_cmos_sensor(0x0342,0x13);
-        write_cmos_sensor(0x0343,0x90);
-        write_cmos_sensor(0x0344,0x00);
-        write_cmos_sensor(0x0345,0x00);
-        write_cmos_sensor(0x0346,0x00);
-        write_cmos_sensor(0x0347,0x00);
-        write_cmos_sensor(0x0348,0x10);
-        write_cmos_sensor(0x0349,0x6F);
-        write_cmos_sensor(0x034A,0x0C);
-        write_cmos_sensor(0x034B,0x2F);
-        write_cmos_sensor(0x0381,0x01);
-        write_cmos_sensor(0x0383,0x01);
-        write_cmos_sensor(0x0385,0x01);
-        write_cmos_sensor(0x0387,0x01);
-        write_cmos_sensor(0x0900,0x00);
-        write_cmos_sensor(0x0901,0x00);
-        write_cmos_sensor(0x0902,0x00);
-        write_cmos_sensor(0x3000,0x35);
-        write_cmos_sensor(0x3054,0x01);
-        write_cmos_sensor(0x305C,0x11);
-
-        write_cmos_sensor(0x0112,0x0A);
-        write_cmos_sensor(0x0113,0x0A);
-        write_cmos_sensor(0x034C,0x10);
-        write_cmos_sensor(0x034D,0x70);
-        write_cmos_sensor(0x034E,0x0C);
-        write_cmos_sensor(0x034F,0x30);
-        write_cmos_sensor(0x0401,0x00);
-        write_cmos_sensor(0x0404,0x00);
-        write_cmos_sensor(0x0405,0x10);
-        write_cmos_sensor(0x0408,0x00);
-        write_cmos_sensor(0x0409,0x00);
-        write_cmos_sensor(0x040A,0x00);
-        write_cmos_sensor(0x040B,0x00);
-        write_cmos_sensor(0x040C,0x10);
-        write_cmos_sensor(0x040D,0x70);
-        write_cmos_sensor(0x040E,0x0C);
-        write_cmos_sensor(0x040F,0x30);
-
-        write_cmos_sensor(0x0301,0x05);
-        write_cmos_sensor(0x0303,0x02);
-        write_cmos_sensor(0x0305,0x03);
-        write_cmos_sensor(0x0306,0x00);
-        write_cmos_sensor(0x0307,0x96);
-        write_cmos_sensor(0x0309,0x0A);
-        write_cmos_sensor(0x030B,0x01);
-        write_cmos_sensor(0x0310,0x00);
-
-        write_cmos_sensor(0x0820,0x12);
-        write_cmos_sensor(0x0821,0xC0);
-        write_cmos_sensor(0x0822,0x00);
-        write_cmos_sensor(0x0823,0x00);
-
-        write_cmos_sensor(0x3A03,0x09);
-        write_cmos_sensor(0x3A04,0x20);
-        write_cmos_sensor(0x3A05,0x01);
-
-        write_cmos_sensor(0x0B06,0x01);
-        write_cmos_sensor(0x30A2,0x00);
-
-        write_cmos_sensor(0x30B4,0x00);
-
-        write_cmos_sensor(0x3A02,0xff);
-
-        write_cmos_sensor(0x3011,0x00);
-        write_cmos_sensor(0x3013,0x01);
-
-        write_cmos_sensor(0x0202,0x0C);
-        write_cmos_sensor(0x0203,0x4E);
-        write_cmos_sensor(0x0224,0x01);
-        write_cmos_sensor(0x0225,0xF4);
-
-        write_cmos_sensor(0x0204,0x00);
-        write_cmos_sensor(0x0205,0x00);
-        write_cmos_sensor(0x020E,0x01);
-        write_cmos_sensor(0x020F,0x00);
-        write_cmos_sensor(0x0210,0x01);
-        write_cmos_sensor(0x0211,0x00);
-        write_cmos_sensor(0x0212,0x01);
-        write_cmos_sensor(0x0213,0x00);
-        write_cmos_sensor(0x0214,0x01);
-        write_cmos_sensor(0x0215,0x00);
-        write_cmos_sensor(0x0216,0x00);
-        write_cmos_sensor(0x0217,0x00);
-
-        write_cmos_sensor(0x4170,0x00);
-        write_cmos_sensor(0x4171,0x10);
-        write_cmos_sensor(0x4176,0x00);
-        write_cmos_sensor(0x4177,0x3C);
-        write_cmos_sensor(0xAE20,0x04);
-        write_cmos_sensor(0xAE21,0x5C);
-
-        write_cmos_sensor(0x0138,0x01);
-        write_cmos_sensor(0x0100,0x01);
+        table_write_cmos_sensor(imx214_capture_setting);
 
     }
     else if(currefps==240){
         // full siez 24pfs
-        write_cmos_sensor(0x0100,0x00);
-
-        write_cmos_sensor(0x0114,0x03);
-        write_cmos_sensor(0x0220,0x00);
-        write_cmos_sensor(0x0221,0x11);
-        write_cmos_sensor(0x0222,0x01);
-        write_cmos_sensor(0x0340,0x0C);
-        write_cmos_sensor(0x0341,0x94);
-        write_cmos_sensor(0x0342,0x13);
-        write_cmos_sensor(0x0343,0x90);
-        write_cmos_sensor(0x0344,0x00);
-        write_cmos_sensor(0x0345,0x00);
-        write_cmos_sensor(0x0346,0x00);
-        write_cmos_sensor(0x0347,0x00);
-        write_cmos_sensor(0x0348,0x10);
-        write_cmos_sensor(0x0349,0x6F);
-        write_cmos_sensor(0x034A,0x0C);
-        write_cmos_sensor(0x034B,0x2F);
-        write_cmos_sensor(0x0381,0x01);
-        write_cmos_sensor(0x0383,0x01);
-        write_cmos_sensor(0x0385,0x01);
-        write_cmos_sensor(0x0387,0x01);
-        write_cmos_sensor(0x0900,0x00);
-        write_cmos_sensor(0x0901,0x00);
-        write_cmos_sensor(0x0902,0x00);
-        write_cmos_sensor(0x3000,0x35);
-        write_cmos_sensor(0x3054,0x01);
-        write_cmos_sensor(0x305C,0x11);
-
-        write_cmos_sensor(0x0112,0x0A);
-        write_cmos_sensor(0x0113,0x0A);
-        write_cmos_sensor(0x034C,0x10);
-        write_cmos_sensor(0x034D,0x70);
-        write_cmos_sensor(0x034E,0x0C);
-        write_cmos_sensor(0x034F,0x30);
-        write_cmos_sensor(0x0401,0x00);
-        write_cmos_sensor(0x0404,0x00);
-        write_cmos_sensor(0x0405,0x10);
-        write_cmos_sensor(0x0408,0x00);
-        write_cmos_sensor(0x0409,0x00);
-        write_cmos_sensor(0x040A,0x00);
-        write_cmos_sensor(0x040B,0x00);
-        write_cmos_sensor(0x040C,0x10);
-        write_cmos_sensor(0x040D,0x70);
-        write_cmos_sensor(0x040E,0x0C);
-        write_cmos_sensor(0x040F,0x30);
-
-        write_cmos_sensor(0x0301,0x05);
-        write_cmos_sensor(0x0303,0x02);
-        write_cmos_sensor(0x0305,0x03);
-        write_cmos_sensor(0x0306,0x00);
-        write_cmos_sensor(0x0307,0x79);
-        write_cmos_sensor(0x0309,0x0A);
-        write_cmos_sensor(0x030B,0x01);
-        write_cmos_sensor(0x0310,0x00);
-
-        write_cmos_sensor(0x0820,0x0F);
-        write_cmos_sensor(0x0821,0x20);
-        write_cmos_sensor(0x0822,0x00);
-        write_cmos_sensor(0x0823,0x00);
-
-        write_cmos_sensor(0x3A03,0x08);
-        write_cmos_sensor(0x3A04,0xC0);
-        write_cmos_sensor(0x3A05,0x02);
-
-        write_cmos_sensor(0x0B06,0x01);
-        write_cmos_sensor(0x30A2,0x00);
-        write_cmos_sensor(0x30B4,0x00);
-        write_cmos_sensor(0x3A02,0xFF);
-        write_cmos_sensor(0x3013,0x00);
-        write_cmos_sensor(0x0202,0x0C);
-        write_cmos_sensor(0x0203,0x8A);
-        write_cmos_sensor(0x0224,0x01);
-        write_cmos_sensor(0x0225,0xF4);
-        write_cmos_sensor(0x0204,0x00);
-        write_cmos_sensor(0x0205,0x00);
-        write_cmos_sensor(0x020E,0x01);
-        write_cmos_sensor(0x020F,0x00);
-        write_cmos_sensor(0x0210,0x01);
-        write_cmos_sensor(0x0211,0x00);
-        write_cmos_sensor(0x0212,0x01);
-        write_cmos_sensor(0x0213,0x00);
-        write_cmos_sensor(0x0214,0x01);
-        write_cmos_sensor(0x0215,0x00);
-        write_cmos_sensor(0x0216,0x00);
-        write_cmos_sensor(0x0217,0x00);
-        write_cmos_sensor(0x4170,0x00);
-        write_cmos_sensor(0x4171,0x10);
-        write_cmos_sensor(0x4176,0x00);
-        write_cmos_sensor(0x4177,0x3C);
-        write_cmos_sensor(0xAE20,0x04);
-        write_cmos_sensor(0xAE21,0x5C);
-
-        write_cmos_sensor(0x0138,0x01);
-        write_cmos_sensor(0x0100,0x01);
+        table_write_cmos_sensor(imx214_capture_setting2);
     }
     else{
         // full siez 15pfs
-        write_cmos_sensor(0x0100,0x00);
-
-        write_cmos_sensor(0x0114,0x03);
-        write_cmos_sensor(0x0220,0x00);
-        write_cmos_sensor(0x0221,0x11);
-        write_cmos_sensor(0x0222,0x01);
-        write_cmos_sensor(0x0340,0x0C);
-        write_cmos_sensor(0x0341,0x94);
-        write_cmos_sensor(0x0342,0x13);
-        write_cmos_sensor(0x0343,0x90);
-        write_cmos_sensor(0x0344,0x00);
-        write_cmos_sensor(0x0345,0x00);
-        write_cmos_sensor(0x0346,0x00);
-        write_cmos_sensor(0x0347,0x00);
-        write_cmos_sensor(0x0348,0x10);
-        write_cmos_sensor(0x0349,0x6F);
-        write_cmos_sensor(0x034A,0x0C);
-        write_cmos_sensor(0x034B,0x2F);
-        write_cmos_sensor(0x0381,0x01);
-        write_cmos_sensor(0x0383,0x01);
-        write_cmos_sensor(0x0385,0x01);
-        write_cmos_sensor(0x0387,0x01);
-        write_cmos_sensor(0x0900,0x00);
-        write_cmos_sensor(0x0901,0x00);
-        write_cmos_sensor(0x0902,0x00);
-        write_cmos_sensor(0x3000,0x35);
-        write_cmos_sensor(0x3054,0x01);
-        write_cmos_sensor(0x305C,0x11);
-
-        write_cmos_sensor(0x0112,0x0A);
-        write_cmos_sensor(0x0113,0x0A);
-        write_cmos_sensor(0x034C,0x10);
-        write_cmos_sensor(0x034D,0x70);
-        write_cmos_sensor(0x034E,0x0C);
-        write_cmos_sensor(0x034F,0x30);
-        write_cmos_sensor(0x0401,0x00);
-        write_cmos_sensor(0x0404,0x00);
-        write_cmos_sensor(0x0405,0x10);
-        write_cmos_sensor(0x0408,0x00);
-        write_cmos_sensor(0x0409,0x00);
-        write_cmos_sensor(0x040A,0x00);
-        write_cmos_sensor(0x040B,0x00);
-        write_cmos_sensor(0x040C,0x10);
-        write_cmos_sensor(0x040D,0x70);
-        write_cmos_sensor(0x040E,0x0C);
-        write_cmos_sensor(0x040F,0x30);
-
-        write_cmos_sensor(0x0301,0x05);
-        write_cmos_sensor(0x0303,0x02);
-        write_cmos_sensor(0x0305,0x03);
-        write_cmos_sensor(0x0306,0x00);
-        write_cmos_sensor(0x0307,0x4c);
-        write_cmos_sensor(0x0309,0x0A);
-        write_cmos_sensor(0x030B,0x01);
-        write_cmos_sensor(0x0310,0x00);
-
-        write_cmos_sensor(0x0820,0x09);
-        write_cmos_sensor(0x0821,0x80);
-        write_cmos_sensor(0x0822,0x00);
-        write_cmos_sensor(0x0823,0x00);
-
-        write_cmos_sensor(0x3A03,0x08);
-        write_cmos_sensor(0x3A04,0xC0);
-        write_cmos_sensor(0x3A05,0x02);
-
-        write_cmos_sensor(0x0B06,0x01);
-        write_cmos_sensor(0x30A2,0x00);
-        write_cmos_sensor(0x30B4,0x00);
-        write_cmos_sensor(0x3A02,0xFF);
-        write_cmos_sensor(0x3013,0x00);
-        write_cmos_sensor(0x0202,0x0C);
-        write_cmos_sensor(0x0203,0x8A);
-        write_cmos_sensor(0x0224,0x01);
-        write_cmos_sensor(0x0225,0xF4);
-        write_cmos_sensor(0x0204,0x00);
-        write_cmos_sensor(0x0205,0x00);
-        write_cmos_sensor(0x020E,0x01);
-        write_cmos_sensor(0x020F,0x00);
-        write_cmos_sensor(0x0210,0x01);
-        write_cmos_sensor(0x0211,0x00);
-        write_cmos_sensor(0x0212,0x01);
-        write_cmos_sensor(0x0213,0x00);
-        write_cmos_sensor(0x0214,0x01);
-        write_cmos_sensor(0x0215,0x00);
-        write_cmos_sensor(0x0216,0x00);
-        write_cmos_sensor(0x0217,0x00);
-        write_cmos_sensor(0x4170,0x00);
-        write_cmos_sensor(0x4171,0x10);
-        write_cmos_sensor(0x4176,0x00);
-        write_cmos_sensor(0x4177,0x3C);
-        write_cmos_sensor(0xAE20,0x04);
-        write_cmos_sensor(0xAE21,0x5C);
-
-        write_cmos_sensor(0x0138,0x01);
-        write_cmos_sensor(0x0100,0x01);
+        table_write_cmos_sensor(imx214_capture_setting3);
     }
 }
 
+static const kal_uint16 imx214_normal_video_setting[] = {
+	0x0100, 0x00,
+	0x0114, 0x03,
+	0x0220, 0x00,
+	0x0221, 0x11,
+	0x0222, 0x01,
+	0x0340, 0x0C,
+	0x0341, 0x58,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x96,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x12,
+	0x0821, 0xC0,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x09,
+	0x3A04, 0x20,
+	0x3A05, 0x01,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+
+	0x30B4, 0x00,
+
+	0x3A02, 0xff,
+
+	0x3011, 0x00,
+	0x3013, 0x01,
+
+	0x0202, 0x0C,
+	0x0203, 0x4E,
+	0x0224, 0x01,
+	0x0225, 0xF4,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
 static void normal_video_setting(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
     // full size 30.33ps
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x00);
-    write_cmos_sensor(0x0221,0x11);
-    write_cmos_sensor(0x0222,0x01);
-    write_cmos_sensor(0x0340,0x0C);
-    write_cmos_sensor(0x0341,0x58);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x00);
-    write_cmos_sensor(0x0901,0x00);
-    write_cmos_sensor(0x0902,0x00);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x10);
-    write_cmos_sensor(0x034D,0x70);
-    write_cmos_sensor(0x034E,0x0C);
-    write_cmos_sensor(0x034F,0x30);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x10);
-    write_cmos_sensor(0x040D,0x70);
-    write_cmos_sensor(0x040E,0x0C);
-    write_cmos_sensor(0x040F,0x30);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x96);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x12);
-    write_cmos_sensor(0x0821,0xC0);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x09);
-    write_cmos_sensor(0x3A04,0x20);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0xff);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01);
-
-    write_cmos_sensor(0x0202,0x0C);
-    write_cmos_sensor(0x0203,0x4E);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0xF4);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-
-    write_cmos_sensor(0x0138,0x01);
-    write_cmos_sensor(0x0100,0x01);
+    table_write_cmos_sensor(imx214_normal_video_setting);
 
 }
 
+static const kal_uint16 imx214_fullsize_HDR_setting[] = {
+	0x0100, 0x00,
+	0x0114, 0x03,
+	0x0220, 0x21,
+	0x0221, 0x11,
+	0x0222, 0x08,
+	0x0340, 0x0C,
+	0x0341, 0x58,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x96,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x12,
+	0x0821, 0xC0,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x3A03, 0x08,
+	0x3A04, 0x90,
+	0x3A05, 0x01,
+
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+
+	0x30B4, 0x00,
+
+	0x3A02, 0x06,
+
+	0x3011, 0x00,
+	0x3013, 0x01,
+
+	0x0202, 0x0C,
+	0x0203, 0x4E,
+	0x0224, 0x01,
+	0x0225, 0x89,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+	//mHDR  relation setting
+	0x3010, 0x00,
+	0x6D3A, 0x00, // 0: 16X16, 1:8X8
+	0x3011, 0x00,
+	0x3013, 0x01, // STATS output Enable
+	0x5068, 0x35,
+	0x5069, 0x01,
+	0x30C2, 0x00,
+	0x30C3, 0x40,
+	0x610A, 0x08,
+	//[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
+	//[5]:0 auto, 1:direct
+	0x0220, 0x21,
+	// hdr binning mode
+	0x0221, 0x11,
+	//LE/SE ration 1,2,4,8
+	0x0222, 0x08,
+};
+
+static const kal_uint16 imx214_fullsize_HDR_setting2[] = {
+	0x30b2, 0x01,
+	0x30b3, 0x01,
+	0x30b4, 0x01,
+	0x30b5, 0x01,
+	0x30b6, 0x01,
+	0x30b7, 0x01,
+	0x30b8, 0x01,
+	0x30b9, 0x01,
+	0x30ba, 0x01,
+	0x30bb, 0x01,
+	0x30bc, 0x01,
+};
+
+static const kal_uint16 imx214_fullsize_HDR_setting3[] = {
+	0x30b2, 0x00,
+	0x30b3, 0x00,
+	0x30b4, 0x00,
+	0x30b5, 0x00,
+	0x30b6, 0x00,
+	0x30b7, 0x00,
+	0x30b8, 0x00,
+	0x30b9, 0x00,
+	0x30ba, 0x00,
+	0x30bb, 0x00,
+	0x30bc, 0x00,
+};
+
 static void fullsize_setting_HDR(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
     // full size 30.33ps
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x21);
-    write_cmos_sensor(0x0221,0x11);
-    write_cmos_sensor(0x0222,0x08);
-    write_cmos_sensor(0x0340,0x0C);
-    write_cmos_sensor(0x0341,0x58);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x00);
-    write_cmos_sensor(0x0901,0x00);
-    write_cmos_sensor(0x0902,0x00);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x10);
-    write_cmos_sensor(0x034D,0x70);
-    write_cmos_sensor(0x034E,0x0C);
-    write_cmos_sensor(0x034F,0x30);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x10);
-    write_cmos_sensor(0x040D,0x70);
-    write_cmos_sensor(0x040E,0x0C);
-    write_cmos_sensor(0x040F,0x30);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x96);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x12);
-    write_cmos_sensor(0x0821,0xC0);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x08);
-    write_cmos_sensor(0x3A04,0x90);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0x06);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01);
-
-    write_cmos_sensor(0x0202,0x0C);
-    write_cmos_sensor(0x0203,0x4E);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0x89);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-    //mHDR  relation setting
-    write_cmos_sensor(0x3010,0x00);
-    write_cmos_sensor(0x6D3A,0x00); // 0: 16X16, 1:8X8
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01); // STATS output Enable
-    write_cmos_sensor(0x5068,0x35);
-    write_cmos_sensor(0x5069,0x01);
-    write_cmos_sensor(0x30C2,0x00);
-    write_cmos_sensor(0x30C3,0x40);
-    write_cmos_sensor(0x610A,0x08);
-    //[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
-    //[5]:0 auto, 1:direct
-    write_cmos_sensor(0x0220,0x21);
-    // hdr binning mode
-    write_cmos_sensor(0x0221,0x11);
-    //LE/SE ration 1,2,4,8
-    write_cmos_sensor(0x0222,0x08);
+    table_write_cmos_sensor(imx214_fullsize_HDR_setting);
     //ATR
     imx214_ATR(3,3);
 
     // Normal: 0x00, ZigZag: 0x01
     if(imgsensor.ihdr_mode == 9)
     {
-        write_cmos_sensor(0x30b2,0x01);
-        write_cmos_sensor(0x30b3,0x01);
-        write_cmos_sensor(0x30b4,0x01);
-        write_cmos_sensor(0x30b5,0x01);
-        write_cmos_sensor(0x30b6,0x01);
-        write_cmos_sensor(0x30b7,0x01);
-        write_cmos_sensor(0x30b8,0x01);
-        write_cmos_sensor(0x30b9,0x01);
-        write_cmos_sensor(0x30ba,0x01);
-        write_cmos_sensor(0x30bb,0x01);
-        write_cmos_sensor(0x30bc,0x01);
+        table_write_cmos_sensor(imx214_fullsize_HDR_setting2);
     }
     else
     {
-        write_cmos_sensor(0x30b2,0x00);
-        write_cmos_sensor(0x30b3,0x00);
-        write_cmos_sensor(0x30b4,0x00);
-        write_cmos_sensor(0x30b5,0x00);
-        write_cmos_sensor(0x30b6,0x00);
-        write_cmos_sensor(0x30b7,0x00);
-        write_cmos_sensor(0x30b8,0x00);
-        write_cmos_sensor(0x30b9,0x00);
-        write_cmos_sensor(0x30ba,0x00);
-        write_cmos_sensor(0x30bb,0x00);
-        write_cmos_sensor(0x30bc,0x00);
+        table_write_cmos_sensor(imx214_fullsize_HDR_setting3);
     }
     write_cmos_sensor(0x0138,0x01);
     write_cmos_sensor(0x0100,0x01);
 
 }
 
+static const kal_uint16 imx214_hs_video_setting[] = {
+	0x0100, 0x00,
+	0x0114, 0x03,
+	0x0220, 0x00,
+	0x0221, 0x11,
+	0x0222, 0x01,
+	0x0340, 0x05,
+	0x0341, 0x08,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x01,
+	0x0347, 0x78,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0A,
+	0x034B, 0xB7,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x01,
+	0x0901, 0x22,
+	0x0902, 0x02,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x08,
+	0x034D, 0x38,
+	0x034E, 0x04,
+	0x034F, 0xA0,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x08,
+	0x040D, 0x38,
+	0x040E, 0x04,
+	0x040F, 0xA0,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x79, //79
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+
+	0x0820, 0x0F, //0F
+	0x0821, 0x20, // 20
+	0x0822, 0x00,
+	0x0823, 0x00,
+	0x3A03, 0x06,
+	0x3A04, 0x68,
+	0x3A05, 0x01,
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+	0x30B4, 0x00,
+	0x3A02, 0xFF,
+	0x3013, 0x00,
+	0x0202, 0x04,
+	0x0203, 0xFE,
+	0x0224, 0x01,
+	0x0225, 0xF4,
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
 static void hs_video_setting(void)
 {
 	LOG_INF("E\n");
 	//1080p 60fps
-	write_cmos_sensor(0x0100,0x00);
-	write_cmos_sensor(0x0114,0x03);
-	write_cmos_sensor(0x0220,0x00);
-	write_cmos_sensor(0x0221,0x11);
-	write_cmos_sensor(0x0222,0x01);
-	write_cmos_sensor(0x0340,0x05);
-	write_cmos_sensor(0x0341,0x08);
-	write_cmos_sensor(0x0342,0x13);
-	write_cmos_sensor(0x0343,0x90);
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x01);
-	write_cmos_sensor(0x0347,0x78);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0A);
-	write_cmos_sensor(0x034B,0xB7);
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x01);
-	write_cmos_sensor(0x0900,0x01);
-	write_cmos_sensor(0x0901,0x22);
-	write_cmos_sensor(0x0902,0x02);
-	write_cmos_sensor(0x3000,0x35);
-	write_cmos_sensor(0x3054,0x01);
-	write_cmos_sensor(0x305C,0x11);
-
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x034C,0x08);
-	write_cmos_sensor(0x034D,0x38);
-	write_cmos_sensor(0x034E,0x04);
-	write_cmos_sensor(0x034F,0xA0);
-	write_cmos_sensor(0x0401,0x00);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x10);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x08);
-	write_cmos_sensor(0x040D,0x38);
-	write_cmos_sensor(0x040E,0x04);
-	write_cmos_sensor(0x040F,0xA0);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x03);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0x79);//79
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x0310,0x00);
-
-	write_cmos_sensor(0x0820,0x0F);//0F
-	write_cmos_sensor(0x0821,0x20);// 20
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-	write_cmos_sensor(0x3A03,0x06);
-	write_cmos_sensor(0x3A04,0x68);
-	write_cmos_sensor(0x3A05,0x01);
-	write_cmos_sensor(0x0B06,0x01);
-	write_cmos_sensor(0x30A2,0x00);
-	write_cmos_sensor(0x30B4,0x00);
-	write_cmos_sensor(0x3A02,0xFF);
-	write_cmos_sensor(0x3013,0x00);
-	write_cmos_sensor(0x0202,0x04);
-	write_cmos_sensor(0x0203,0xFE);
-	write_cmos_sensor(0x0224,0x01);
-	write_cmos_sensor(0x0225,0xF4);
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
-	write_cmos_sensor(0x0210,0x01);
-	write_cmos_sensor(0x0211,0x00);
-	write_cmos_sensor(0x0212,0x01);
-	write_cmos_sensor(0x0213,0x00);
-	write_cmos_sensor(0x0214,0x01);
-	write_cmos_sensor(0x0215,0x00);
-	write_cmos_sensor(0x0216,0x00);
-	write_cmos_sensor(0x0217,0x00);
-	write_cmos_sensor(0x4170,0x00);
-	write_cmos_sensor(0x4171,0x10);
-	write_cmos_sensor(0x4176,0x00);
-	write_cmos_sensor(0x4177,0x3C);
-	write_cmos_sensor(0xAE20,0x04);
-	write_cmos_sensor(0xAE21,0x5C);
-
-	write_cmos_sensor(0x0138,0x01);
-      write_cmos_sensor(0x0100,0x01);
+	table_write_cmos_sensor(imx214_hs_video_setting);
 
 }
 
@@ -1821,99 +1883,103 @@ static void slim_video_setting(void)
 	hs_video_setting();
 }
 #if 0
+static const kal_uint16 imx214_vhdr_setting[] = {
+	0x0114, 0x03,
+	0x0220, 0x21,
+	0x0221, 0x22,
+	0x0222, 0x10,
+	0x0340, 0x06,
+	0x0341, 0x68,
+	0x0342, 0x13,
+	0x0343, 0x90,
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x01,
+	0x0347, 0x78,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0A,
+	0x034B, 0xB7,
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x00,
+	0x0902, 0x00,
+	0x3000, 0x35,
+	0x3054, 0x01,
+	0x305C, 0x11,
+
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x034C, 0x08,
+	0x034D, 0x38,
+	0x034E, 0x04,
+	0x034F, 0xA0,
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x08,
+	0x040D, 0x38,
+	0x040E, 0x04,
+	0x040F, 0xA0,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x03,
+	0x0306, 0x00,
+	0x0307, 0x4D,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x0310, 0x00,
+	0x0820, 0x09,
+	0x0821, 0xA0,
+	0x0822, 0x00,
+	0x0823, 0x00,
+	0x3A03, 0x06,
+	0x3A04, 0xE8,
+	0x3A05, 0x01,
+	0x0B06, 0x01,
+	0x30A2, 0x00,
+	0x30B4, 0x00,
+	0x3A02, 0x06,
+	0x3013, 0x01,
+	0x0202, 0x06,
+	0x0203, 0x5E,
+	0x0224, 0x00,
+	0x0225, 0xCB,
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+	0x0210, 0x01,
+	0x0211, 0x00,
+	0x0212, 0x01,
+	0x0213, 0x00,
+	0x0214, 0x01,
+	0x0215, 0x00,
+	0x0216, 0x00,
+	0x0217, 0x00,
+	0x4170, 0x00,
+	0x4171, 0x10,
+	0x4176, 0x00,
+	0x4177, 0x3C,
+	0xAE20, 0x04,
+	0xAE21, 0x5C,
+
+	0x0138, 0x01,
+	0x0100, 0x01,
+};
+
 static void vhdr_setting(void)
 {
      	LOG_INF("E\n");
-write_cmos_sensor(0x0114,0x03);
-write_cmos_sensor(0x0220,0x21);
-write_cmos_sensor(0x0221,0x22);
-write_cmos_sensor(0x0222,0x10);
-write_cmos_sensor(0x0340,0x06);
-write_cmos_sensor(0x0341,0x68);
-write_cmos_sensor(0x0342,0x13);
-write_cmos_sensor(0x0343,0x90);
-write_cmos_sensor(0x0344,0x00);
-write_cmos_sensor(0x0345,0x00);
-write_cmos_sensor(0x0346,0x01);
-write_cmos_sensor(0x0347,0x78);
-write_cmos_sensor(0x0348,0x10);
-write_cmos_sensor(0x0349,0x6F);
-write_cmos_sensor(0x034A,0x0A);
-write_cmos_sensor(0x034B,0xB7);
-write_cmos_sensor(0x0381,0x01);
-write_cmos_sensor(0x0383,0x01);
-write_cmos_sensor(0x0385,0x01);
-write_cmos_sensor(0x0387,0x01);
-write_cmos_sensor(0x0900,0x00);
-write_cmos_sensor(0x0901,0x00);
-write_cmos_sensor(0x0902,0x00);
-write_cmos_sensor(0x3000,0x35);
-write_cmos_sensor(0x3054,0x01);
-write_cmos_sensor(0x305C,0x11);
-
-write_cmos_sensor(0x0112,0x0A);
-write_cmos_sensor(0x0113,0x0A);
-write_cmos_sensor(0x034C,0x08);
-write_cmos_sensor(0x034D,0x38);
-write_cmos_sensor(0x034E,0x04);
-write_cmos_sensor(0x034F,0xA0);
-write_cmos_sensor(0x0401,0x00);
-write_cmos_sensor(0x0404,0x00);
-write_cmos_sensor(0x0405,0x10);
-write_cmos_sensor(0x0408,0x00);
-write_cmos_sensor(0x0409,0x00);
-write_cmos_sensor(0x040A,0x00);
-write_cmos_sensor(0x040B,0x00);
-write_cmos_sensor(0x040C,0x08);
-write_cmos_sensor(0x040D,0x38);
-write_cmos_sensor(0x040E,0x04);
-write_cmos_sensor(0x040F,0xA0);
-
-write_cmos_sensor(0x0301,0x05);
-write_cmos_sensor(0x0303,0x02);
-write_cmos_sensor(0x0305,0x03);
-write_cmos_sensor(0x0306,0x00);
-write_cmos_sensor(0x0307,0x4D);
-write_cmos_sensor(0x0309,0x0A);
-write_cmos_sensor(0x030B,0x01);
-write_cmos_sensor(0x0310,0x00);
-write_cmos_sensor(0x0820,0x09);
-write_cmos_sensor(0x0821,0xA0);
-write_cmos_sensor(0x0822,0x00);
-write_cmos_sensor(0x0823,0x00);
-write_cmos_sensor(0x3A03,0x06);
-write_cmos_sensor(0x3A04,0xE8);
-write_cmos_sensor(0x3A05,0x01);
-write_cmos_sensor(0x0B06,0x01);
-write_cmos_sensor(0x30A2,0x00);
-write_cmos_sensor(0x30B4,0x00);
-write_cmos_sensor(0x3A02,0x06);
-write_cmos_sensor(0x3013,0x01);
-write_cmos_sensor(0x0202,0x06);
-write_cmos_sensor(0x0203,0x5E);
-write_cmos_sensor(0x0224,0x00);
-write_cmos_sensor(0x0225,0xCB);
-write_cmos_sensor(0x0204,0x00);
-write_cmos_sensor(0x0205,0x00);
-write_cmos_sensor(0x020E,0x01);
-write_cmos_sensor(0x020F,0x00);
-write_cmos_sensor(0x0210,0x01);
-write_cmos_sensor(0x0211,0x00);
-write_cmos_sensor(0x0212,0x01);
-write_cmos_sensor(0x0213,0x00);
-write_cmos_sensor(0x0214,0x01);
-write_cmos_sensor(0x0215,0x00);
-write_cmos_sensor(0x0216,0x00);
-write_cmos_sensor(0x0217,0x00);
-write_cmos_sensor(0x4170,0x00);
-write_cmos_sensor(0x4171,0x10);
-write_cmos_sensor(0x4176,0x00);
-write_cmos_sensor(0x4177,0x3C);
-write_cmos_sensor(0xAE20,0x04);
-write_cmos_sensor(0xAE21,0x5C);
-
-write_cmos_sensor(0x0138,0x01);
-write_cmos_sensor(0x0100,0x01);
+table_write_cmos_sensor(imx214_vhdr_setting);
 
 }
 #endif
@@ -514,6 +514,8 @@ static kal_uint16 read_cmos_sensor(kal_uint32 addr)
 }
 
 #define write_cmos_sensor(addr, para) iWriteReg((u16) addr , (u32) para , 1,  imgsensor.i2c_write_id)
+#define table_write_cmos_sensor(table) \
+	iTableWriteReg(table, ARRAY_SIZE(table), imgsensor.i2c_write_id)
 
 
 extern bool read_imx258_eeprom( kal_uint16 addr, BYTE* data, kal_uint32 size);
@@ -928,501 +930,512 @@ static void night_mode(kal_bool enable)
 }	/*	night_mode	*/
 
 	/*	preview_setting  */
+static const kal_uint16 imx258_imagequality_setting[] = {
+	0x94C7, 0xFF,
+	0x94C8, 0xFF,
+	0x94C9, 0xFF,
+	0x95C7, 0xFF,
+	0x95C8, 0xFF,
+	0x95C9, 0xFF,
+	0x94C4, 0x3F,
+	0x94C5, 0x3F,
+	0x94C6, 0x3F,
+	0x95C4, 0x3F,
+	0x95C5, 0x3F,
+	0x95C6, 0x3F,
+	0x94C1, 0x02,
+	0x94C2, 0x02,
+	0x94C3, 0x02,
+	0x95C1, 0x02,
+	0x95C2, 0x02,
+	0x95C3, 0x02,
+	0x94BE, 0x0C,
+	0x94BF, 0x0C,
+	0x94C0, 0x0C,
+	0x95BE, 0x0C,
+	0x95BF, 0x0C,
+	0x95C0, 0x0C,
+	0x94D0, 0x74,
+	0x94D1, 0x74,
+	0x94D2, 0x74,
+	0x95D0, 0x74,
+	0x95D1, 0x74,
+	0x95D2, 0x74,
+	0x94CD, 0x2E,
+	0x94CE, 0x2E,
+	0x94CF, 0x2E,
+	0x95CD, 0x2E,
+	0x95CE, 0x2E,
+	0x95CF, 0x2E,
+	0x94CA, 0x4C,
+	0x94CB, 0x4C,
+	0x94CC, 0x4C,
+	0x95CA, 0x4C,
+	0x95CB, 0x4C,
+	0x95CC, 0x4C,
+	0x900E, 0x32,
+	0x94E2, 0xFF,
+	0x94E3, 0xFF,
+	0x94E4, 0xFF,
+	0x95E2, 0xFF,
+	0x95E3, 0xFF,
+	0x95E4, 0xFF,
+	0x94DF, 0x6E,
+	0x94E0, 0x6E,
+	0x94E1, 0x6E,
+	0x95DF, 0x6E,
+	0x95E0, 0x6E,
+	0x95E1, 0x6E,
+	0x7FCC, 0x01,
+	0x7B78, 0x00,
+
+	//modify at 2015/10/21
+	0x9401, 0x35,
+	0x9403, 0x23,
+	0x9405, 0x23,
+	0x9406, 0x00,
+	0x9407, 0x31,
+	0x9408, 0x00,
+	0x9409, 0x1B,
+	0x940A, 0x00,
+	0x940B, 0x15,
+	0x940D, 0x3F,
+	0x940F, 0x3F,
+	0x9411, 0x3F,
+	0x9413, 0x64,
+	0x9415, 0x64,
+	0x9417, 0x64,
+	0x941D, 0x34,
+	0x941F, 0x01,
+	0x9421, 0x01,
+	0x9423, 0x01,
+	0x9425, 0x23,
+	0x9427, 0x23,
+	0x9429, 0x23,
+	0x942B, 0x2F,
+	0x942D, 0x1A,
+	0x942F, 0x14,
+	0x9431, 0x3F,
+	0x9433, 0x3F,
+	0x9435, 0x3F,
+	0x9437, 0x6B,
+	0x9439, 0x7C,
+	0x943B, 0x81,
+	0x9443, 0x0F,
+	0x9445, 0x0F,
+	0x9447, 0x0F,
+	0x9449, 0x0F,
+	0x944B, 0x0F,
+	0x944D, 0x0F,
+	0x944F, 0x1E,
+	0x9451, 0x0F,
+	0x9453, 0x0B,
+	0x9455, 0x28,
+	0x9457, 0x13,
+	0x9459, 0x0C,
+	0x945D, 0x00,
+	0x945E, 0x00,
+	0x945F, 0x00,
+	0x946D, 0x00,
+	0x946F, 0x10,
+	0x9471, 0x10,
+	0x9473, 0x40,
+	0x9475, 0x2E,
+	0x9477, 0x10,
+	0x9478, 0x0A,
+	0x947B, 0xE0,
+	0x947C, 0xE0,
+	0x947D, 0xE0,
+	0x947E, 0xE0,
+	0x947F, 0xE0,
+	0x9480, 0xE0,
+	0x9483, 0x14,
+	0x9485, 0x14,
+	0x9487, 0x14,
+	0x9501, 0x35,
+	0x9503, 0x14,
+	0x9505, 0x14,
+	0x9507, 0x31,
+	0x9509, 0x1B,
+	0x950B, 0x15,
+	0x950D, 0x1E,
+	0x950F, 0x1E,
+	0x9511, 0x1E,
+	0x9513, 0x64,
+	0x9515, 0x64,
+	0x9517, 0x64,
+	0x951D, 0x34,
+	0x951F, 0x01,
+	0x9521, 0x01,
+	0x9523, 0x01,
+	0x9525, 0x14,
+	0x9527, 0x14,
+	0x9529, 0x14,
+	0x952B, 0x2F,
+	0x952D, 0x1A,
+	0x952F, 0x14,
+	0x9531, 0x1E,
+	0x9533, 0x1E,
+	0x9535, 0x1E,
+	0x9537, 0x6B,
+	0x9539, 0x7C,
+	0x953B, 0x81,
+	0x9543, 0x0F,
+	0x9545, 0x0F,
+	0x9547, 0x0F,
+	0x9549, 0x0F,
+	0x954B, 0x0F,
+	0x954D, 0x0F,
+	0x954F, 0x15,
+	0x9551, 0x0B,
+	0x9553, 0x08,
+	0x9555, 0x1C,
+	0x9557, 0x0D,
+	0x9559, 0x08,
+	0x955D, 0x00,
+	0x955E, 0x00,
+	0x955F, 0x00,
+	0x956D, 0x00,
+	0x956F, 0x10,
+	0x9571, 0x10,
+	0x9573, 0x40,
+	0x9575, 0x2E,
+	0x9577, 0x10,
+	0x9578, 0x0A,
+	0x957B, 0xE0,
+	0x957C, 0xE0,
+	0x957D, 0xE0,
+	0x957E, 0xE0,
+	0x957F, 0xE0,
+	0x9580, 0xE0,
+	0x9583, 0x14,
+	0x9585, 0x14,
+	0x9587, 0x14,
+	0x7F78, 0x00,
+	0x7F89, 0x00,
+	0x7F93, 0x00,
+	0x924B, 0x1B,
+	0x924C, 0x0A,
+	0x9304, 0x04,
+	0x9315, 0x04,
+	0x9250, 0x50,
+	0x9251, 0x3C,
+	0x9252, 0x14,
+	0x94DC, 0x20,
+	0x94DD, 0x20,
+	0x94DE, 0x20,
+	0x95DC, 0x20,
+	0x95DD, 0x20,
+	0x95DE, 0x20,
+	0x7FB0, 0x00,
+	0x9010, 0x3E,
+};
+
+static const kal_uint16 imx258_imagequality_setting2[] = {
+	0x94C7, 0xFF,
+	0x94C8, 0xFF,
+	0x94C9, 0xFF,
+	0x95C7, 0xFF,
+	0x95C8, 0xFF,
+	0x95C9, 0xFF,
+	0x94C4, 0x3F,
+	0x94C5, 0x3F,
+	0x94C6, 0x3F,
+	0x95C4, 0x3F,
+
+	0x95C5, 0x3F,
+	0x95C6, 0x3F,
+	0x94C1, 0x02,
+	0x94C2, 0x02,
+	0x94C3, 0x02,
+	0x95C1, 0x02,
+	0x95C2, 0x02,
+	0x95C3, 0x02,
+	0x94BE, 0x0C,
+	0x94BF, 0x0C,
+	0x94C0, 0x0C,
+	0x95BE, 0x0C,
+	0x95BF, 0x0C,
+	0x95C0, 0x0C,
+	0x94D0, 0x74,
+	0x94D1, 0x74,
+	0x94D2, 0x74,
+	0x95D0, 0x74,
+	0x95D1, 0x74,
+	0x95D2, 0x74,
+	0x94CD, 0x16,
+	0x94CE, 0x16,
+	0x94CF, 0x16,
+	0x95CD, 0x16,
+	0x95CE, 0x16,
+	0x95CF, 0x16,
+	0x94CA, 0x28,
+	0x94CB, 0x28,
+	0x94CC, 0x28,
+	0x95CA, 0x28,
+	0x95CB, 0x28,
+	0x95CC, 0x28,
+	0x900E, 0x32,
+	0x94E2, 0xFF,
+	0x94E3, 0xFF,
+	0x94E4, 0xFF,
+	0x95E2, 0xFF,
+	0x95E3, 0xFF,
+	0x95E4, 0xFF,
+	0x94DF, 0x6E,
+	0x94E0, 0x6E,
+	0x94E1, 0x6E,
+	0x95DF, 0x6E,
+	0x95E0, 0x6E,
+	0x95E1, 0x6E,
+	0x7FCC, 0x01,
+	0x7B78, 0x00,
+	0x9401, 0x35,
+	0x9403, 0x23,
+	0x9405, 0x23,
+	0x9406, 0x00,
+	0x9407, 0x31,
+	0x9408, 0x00,
+	0x9409, 0x1B,
+	0x940A, 0x00,
+	0x940B, 0x15,
+	0x940D, 0x3F,
+	0x940F, 0x3F,
+	0x9411, 0x3F,
+	0x9413, 0x64,
+	0x9415, 0x64,
+	0x9417, 0x64,
+	0x941D, 0x34,
+	0x941F, 0x01,
+	0x9421, 0x01,
+	0x9423, 0x01,
+	0x9425, 0x23,
+	0x9427, 0x23,
+	0x9429, 0x23,
+	0x942B, 0x2F,
+	0x942D, 0x1A,
+	0x942F, 0x14,
+	0x9431, 0x3F,
+	0x9433, 0x3F,
+	0x9435, 0x3F,
+	0x9437, 0x6B,
+	0x9439, 0x7C,
+	0x943B, 0x81,
+	0x9443, 0x0F,
+	0x9445, 0x0F,
+	0x9447, 0x0F,
+	0x9449, 0x0F,
+	0x944B, 0x0F,
+	0x944D, 0x0F,
+	0x944F, 0x1E,
+	0x9451, 0x0F,
+	0x9453, 0x0B,
+	0x9455, 0x28,
+	0x9457, 0x13,
+	0x9459, 0x0C,
+	0x945D, 0x00,
+	0x945E, 0x00,
+	0x945F, 0x00,
+	0x946D, 0x00,
+	0x946F, 0x10,
+	0x9471, 0x10,
+	0x9473, 0x40,
+	0x9475, 0x2E,
+	0x9477, 0x10,
+	0x9478, 0x0A,
+	0x947B, 0xE0,
+	0x947C, 0xE0,
+	0x947D, 0xE0,
+	0x947E, 0xE0,
+	0x947F, 0xE0,
+	0x9480, 0xE0,
+	0x9483, 0x14,
+	0x9485, 0x14,
+	0x9487, 0x14,
+	0x9501, 0x35,
+	0x9503, 0x14,
+	0x9505, 0x14,
+	0x9507, 0x31,
+	0x9509, 0x1B,
+	0x950B, 0x15,
+	0x950D, 0x1E,
+	0x950F, 0x1E,
+	0x9511, 0x1E,
+	0x9513, 0x64,
+	0x9515, 0x64,
+	0x9517, 0x64,
+	0x951D, 0x34,
+	0x951F, 0x01,
+	0x9521, 0x01,
+	0x9523, 0x01,
+	0x9525, 0x14,
+	0x9527, 0x14,
+	0x9529, 0x14,
+	0x952B, 0x2F,
+	0x952D, 0x1A,
+	0x952F, 0x14,
+	0x9531, 0x1E,
+	0x9533, 0x1E,
+	0x9535, 0x1E,
+	0x9537, 0x6B,
+	0x9539, 0x7C,
+	0x953B, 0x81,
+	0x9543, 0x0F,
+	0x9545, 0x0F,
+	0x9547, 0x0F,
+	0x9549, 0x0F,
+	0x954B, 0x0F,
+	0x954D, 0x0F,
+	0x954F, 0x15,
+	0x9551, 0x0B,
+	0x9553, 0x08,
+	0x9555, 0x1C,
+	0x9557, 0x0D,
+	0x9559, 0x08,
+	0x955D, 0x00,
+	0x955E, 0x00,
+	0x955F, 0x00,
+	0x956D, 0x00,
+	0x956F, 0x10,
+	0x9571, 0x10,
+	0x9573, 0x40,
+	0x9575, 0x2E,
+	0x9577, 0x10,
+	0x9578, 0x0A,
+	0x957B, 0xE0,
+	0x957C, 0xE0,
+	0x957D, 0xE0,
+	0x957E, 0xE0,
+	0x957F, 0xE0,
+	0x9580, 0xE0,
+	0x9583, 0x14,
+	0x9585, 0x14,
+	0x9587, 0x14,
+	0x7F78, 0x00,
+	0x7F89, 0x00,
+	0x7F93, 0x00,
+	0x924B, 0x1B,
+	0x924C, 0x0A,
+	0x9304, 0x04,
+	0x9315, 0x04,
+	0x9250, 0x50,
+	0x9251, 0x3C,
+	0x9252, 0x14,
+	0x7B5F, 0x01,
+	0x94DC, 0x20,
+	0x94DD, 0x20,
+	0x94DE, 0x20,
+	0x95DC, 0x20,
+	0x95DD, 0x20,
+	0x95DE, 0x20,
+	0x7FB0, 0x01,
+	0x9010, 0x48,
+	0x9419, 0x50,
+	0x941B, 0x50,
+	0x9519, 0x50,
+	0x951B, 0x50,
+
+	0xD000, 0x00,
+	0xD001, 0x18,
+	0xD002, 0x00,
+	0xD003, 0x18,
+	0xD004, 0x10,
+	0xD005, 0x57,
+	0xD006, 0x0C,
+	0xD007, 0x17,
+	0xD00A, 0x01,
+	0xD00B, 0x02,
+	0xD00D, 0x06,
+	0xD00E, 0x05,
+	0xD00F, 0x01,
+	0xD011, 0x06,
+	0xD012, 0x07,
+	0xD013, 0x01,
+	0xD015, 0x05,
+	0xD016, 0x0C,
+	0xD017, 0x02,
+	0xD019, 0x05,
+	0xD01A, 0x0E,
+	0xD01B, 0x02,
+	0xD01D, 0x0E,
+	0xD01E, 0x15,
+	0xD01F, 0x02,
+	0xD021, 0x0E,
+	0xD022, 0x17,
+	0xD023, 0x02,
+	0xD025, 0x0D,
+	0xD026, 0x1C,
+	0xD027, 0x01,
+	0xD029, 0x0D,
+	0xD02A, 0x1E,
+	0xD02B, 0x01,
+};
+
 static void imx258_ImageQuality_Setting(void)
 {
 	if(imx258_type == IMX258_HDR_TYPE)
 	{
-		write_cmos_sensor(0x94C7,0xFF);
-		write_cmos_sensor(0x94C8,0xFF);
-		write_cmos_sensor(0x94C9,0xFF);
-		write_cmos_sensor(0x95C7,0xFF);
-		write_cmos_sensor(0x95C8,0xFF);
-		write_cmos_sensor(0x95C9,0xFF);
-		write_cmos_sensor(0x94C4,0x3F);
-		write_cmos_sensor(0x94C5,0x3F);
-		write_cmos_sensor(0x94C6,0x3F);
-		write_cmos_sensor(0x95C4,0x3F);
-		write_cmos_sensor(0x95C5,0x3F);
-		write_cmos_sensor(0x95C6,0x3F);
-		write_cmos_sensor(0x94C1,0x02);
-		write_cmos_sensor(0x94C2,0x02);
-		write_cmos_sensor(0x94C3,0x02);
-		write_cmos_sensor(0x95C1,0x02);
-		write_cmos_sensor(0x95C2,0x02);
-		write_cmos_sensor(0x95C3,0x02);
-		write_cmos_sensor(0x94BE,0x0C);
-		write_cmos_sensor(0x94BF,0x0C);
-		write_cmos_sensor(0x94C0,0x0C);
-		write_cmos_sensor(0x95BE,0x0C);
-		write_cmos_sensor(0x95BF,0x0C);
-		write_cmos_sensor(0x95C0,0x0C);
-		write_cmos_sensor(0x94D0,0x74);
-		write_cmos_sensor(0x94D1,0x74);
-		write_cmos_sensor(0x94D2,0x74);
-		write_cmos_sensor(0x95D0,0x74);
-		write_cmos_sensor(0x95D1,0x74);
-		write_cmos_sensor(0x95D2,0x74);
-		write_cmos_sensor(0x94CD,0x2E);
-		write_cmos_sensor(0x94CE,0x2E);
-		write_cmos_sensor(0x94CF,0x2E);
-		write_cmos_sensor(0x95CD,0x2E);
-		write_cmos_sensor(0x95CE,0x2E);
-		write_cmos_sensor(0x95CF,0x2E);
-		write_cmos_sensor(0x94CA,0x4C);
-		write_cmos_sensor(0x94CB,0x4C);
-		write_cmos_sensor(0x94CC,0x4C);
-		write_cmos_sensor(0x95CA,0x4C);
-		write_cmos_sensor(0x95CB,0x4C);
-		write_cmos_sensor(0x95CC,0x4C);
-		write_cmos_sensor(0x900E,0x32);
-		write_cmos_sensor(0x94E2,0xFF);
-		write_cmos_sensor(0x94E3,0xFF);
-		write_cmos_sensor(0x94E4,0xFF);
-		write_cmos_sensor(0x95E2,0xFF);
-		write_cmos_sensor(0x95E3,0xFF);
-		write_cmos_sensor(0x95E4,0xFF);
-		write_cmos_sensor(0x94DF,0x6E);
-		write_cmos_sensor(0x94E0,0x6E);
-		write_cmos_sensor(0x94E1,0x6E);
-		write_cmos_sensor(0x95DF,0x6E);
-		write_cmos_sensor(0x95E0,0x6E);
-		write_cmos_sensor(0x95E1,0x6E);
-		write_cmos_sensor(0x7FCC,0x01);
-		write_cmos_sensor(0x7B78,0x00);
-
-		//modify at 2015/10/21
-		write_cmos_sensor(0x9401,0x35);
-		write_cmos_sensor(0x9403,0x23);
-		write_cmos_sensor(0x9405,0x23);
-		write_cmos_sensor(0x9406,0x00);
-		write_cmos_sensor(0x9407,0x31);
-		write_cmos_sensor(0x9408,0x00);
-		write_cmos_sensor(0x9409,0x1B);
-		write_cmos_sensor(0x940A,0x00);
-		write_cmos_sensor(0x940B,0x15);
-		write_cmos_sensor(0x940D,0x3F);
-		write_cmos_sensor(0x940F,0x3F);
-		write_cmos_sensor(0x9411,0x3F);
-		write_cmos_sensor(0x9413,0x64);
-		write_cmos_sensor(0x9415,0x64);
-		write_cmos_sensor(0x9417,0x64);
-		write_cmos_sensor(0x941D,0x34);
-		write_cmos_sensor(0x941F,0x01);
-		write_cmos_sensor(0x9421,0x01);
-		write_cmos_sensor(0x9423,0x01);
-		write_cmos_sensor(0x9425,0x23);
-		write_cmos_sensor(0x9427,0x23);
-		write_cmos_sensor(0x9429,0x23);
-		write_cmos_sensor(0x942B,0x2F);
-		write_cmos_sensor(0x942D,0x1A);
-		write_cmos_sensor(0x942F,0x14);
-		write_cmos_sensor(0x9431,0x3F);
-		write_cmos_sensor(0x9433,0x3F);
-		write_cmos_sensor(0x9435,0x3F);
-		write_cmos_sensor(0x9437,0x6B);
-		write_cmos_sensor(0x9439,0x7C);
-		write_cmos_sensor(0x943B,0x81);
-		write_cmos_sensor(0x9443,0x0F);
-		write_cmos_sensor(0x9445,0x0F);
-		write_cmos_sensor(0x9447,0x0F);
-		write_cmos_sensor(0x9449,0x0F);
-		write_cmos_sensor(0x944B,0x0F);
-		write_cmos_sensor(0x944D,0x0F);
-		write_cmos_sensor(0x944F,0x1E);
-		write_cmos_sensor(0x9451,0x0F);
-		write_cmos_sensor(0x9453,0x0B);
-		write_cmos_sensor(0x9455,0x28);
-		write_cmos_sensor(0x9457,0x13);
-		write_cmos_sensor(0x9459,0x0C);
-		write_cmos_sensor(0x945D,0x00);
-		write_cmos_sensor(0x945E,0x00);
-		write_cmos_sensor(0x945F,0x00);
-		write_cmos_sensor(0x946D,0x00);
-		write_cmos_sensor(0x946F,0x10);
-		write_cmos_sensor(0x9471,0x10);
-		write_cmos_sensor(0x9473,0x40);
-		write_cmos_sensor(0x9475,0x2E);
-		write_cmos_sensor(0x9477,0x10);
-		write_cmos_sensor(0x9478,0x0A);
-		write_cmos_sensor(0x947B,0xE0);
-		write_cmos_sensor(0x947C,0xE0);
-		write_cmos_sensor(0x947D,0xE0);
-		write_cmos_sensor(0x947E,0xE0);
-		write_cmos_sensor(0x947F,0xE0);
-		write_cmos_sensor(0x9480,0xE0);
-		write_cmos_sensor(0x9483,0x14);
-		write_cmos_sensor(0x9485,0x14);
-		write_cmos_sensor(0x9487,0x14);
-		write_cmos_sensor(0x9501,0x35);
-		write_cmos_sensor(0x9503,0x14);
-		write_cmos_sensor(0x9505,0x14);
-		write_cmos_sensor(0x9507,0x31);
-		write_cmos_sensor(0x9509,0x1B);
-		write_cmos_sensor(0x950B,0x15);
-		write_cmos_sensor(0x950D,0x1E);
-		write_cmos_sensor(0x950F,0x1E);
-		write_cmos_sensor(0x9511,0x1E);
-		write_cmos_sensor(0x9513,0x64);
-		write_cmos_sensor(0x9515,0x64);
-		write_cmos_sensor(0x9517,0x64);
-		write_cmos_sensor(0x951D,0x34);
-		write_cmos_sensor(0x951F,0x01);
-		write_cmos_sensor(0x9521,0x01);
-		write_cmos_sensor(0x9523,0x01);
-		write_cmos_sensor(0x9525,0x14);
-		write_cmos_sensor(0x9527,0x14);
-		write_cmos_sensor(0x9529,0x14);
-		write_cmos_sensor(0x952B,0x2F);
-		write_cmos_sensor(0x952D,0x1A);
-		write_cmos_sensor(0x952F,0x14);
-		write_cmos_sensor(0x9531,0x1E);
-		write_cmos_sensor(0x9533,0x1E);
-		write_cmos_sensor(0x9535,0x1E);
-		write_cmos_sensor(0x9537,0x6B);
-		write_cmos_sensor(0x9539,0x7C);
-		write_cmos_sensor(0x953B,0x81);
-		write_cmos_sensor(0x9543,0x0F);
-		write_cmos_sensor(0x9545,0x0F);
-		write_cmos_sensor(0x9547,0x0F);
-		write_cmos_sensor(0x9549,0x0F);
-		write_cmos_sensor(0x954B,0x0F);
-		write_cmos_sensor(0x954D,0x0F);
-		write_cmos_sensor(0x954F,0x15);
-		write_cmos_sensor(0x9551,0x0B);
-		write_cmos_sensor(0x9553,0x08);
-		write_cmos_sensor(0x9555,0x1C);
-		write_cmos_sensor(0x9557,0x0D);
-		write_cmos_sensor(0x9559,0x08);
-		write_cmos_sensor(0x955D,0x00);
-		write_cmos_sensor(0x955E,0x00);
-		write_cmos_sensor(0x955F,0x00);
-		write_cmos_sensor(0x956D,0x00);
-		write_cmos_sensor(0x956F,0x10);
-		write_cmos_sensor(0x9571,0x10);
-		write_cmos_sensor(0x9573,0x40);
-		write_cmos_sensor(0x9575,0x2E);
-		write_cmos_sensor(0x9577,0x10);
-		write_cmos_sensor(0x9578,0x0A);
-		write_cmos_sensor(0x957B,0xE0);
-		write_cmos_sensor(0x957C,0xE0);
-		write_cmos_sensor(0x957D,0xE0);
-		write_cmos_sensor(0x957E,0xE0);
-		write_cmos_sensor(0x957F,0xE0);
-		write_cmos_sensor(0x9580,0xE0);
-		write_cmos_sensor(0x9583,0x14);
-		write_cmos_sensor(0x9585,0x14);
-		write_cmos_sensor(0x9587,0x14);
-		write_cmos_sensor(0x7F78,0x00);
-		write_cmos_sensor(0x7F89,0x00);
-		write_cmos_sensor(0x7F93,0x00);
-		write_cmos_sensor(0x924B,0x1B);
-		write_cmos_sensor(0x924C,0x0A);
-		write_cmos_sensor(0x9304,0x04);
-		write_cmos_sensor(0x9315,0x04);
-		write_cmos_sensor(0x9250,0x50);
-		write_cmos_sensor(0x9251,0x3C);
-		write_cmos_sensor(0x9252,0x14);
-		write_cmos_sensor(0x94DC,0x20);
-		write_cmos_sensor(0x94DD,0x20);
-		write_cmos_sensor(0x94DE,0x20);
-		write_cmos_sensor(0x95DC,0x20);
-		write_cmos_sensor(0x95DD,0x20);
-		write_cmos_sensor(0x95DE,0x20);
-		write_cmos_sensor(0x7FB0,0x00);
-		write_cmos_sensor(0x9010,0x3E);
+		table_write_cmos_sensor(imx258_imagequality_setting);
 	}
 	else if(imx258_type == IMX258_BINNING_TYPE)
 	{
-		write_cmos_sensor(0x94C7,0xFF);
-		write_cmos_sensor(0x94C8,0xFF);
-		write_cmos_sensor(0x94C9,0xFF);
-		write_cmos_sensor(0x95C7,0xFF);
-		write_cmos_sensor(0x95C8,0xFF);
-		write_cmos_sensor(0x95C9,0xFF);
-		write_cmos_sensor(0x94C4,0x3F);
-		write_cmos_sensor(0x94C5,0x3F);
-		write_cmos_sensor(0x94C6,0x3F);
-		write_cmos_sensor(0x95C4,0x3F);
-
-		write_cmos_sensor(0x95C5,0x3F);
-		write_cmos_sensor(0x95C6,0x3F);
-		write_cmos_sensor(0x94C1,0x02);
-		write_cmos_sensor(0x94C2,0x02);
-		write_cmos_sensor(0x94C3,0x02);
-		write_cmos_sensor(0x95C1,0x02);
-		write_cmos_sensor(0x95C2,0x02);
-		write_cmos_sensor(0x95C3,0x02);
-		write_cmos_sensor(0x94BE,0x0C);
-		write_cmos_sensor(0x94BF,0x0C);
-		write_cmos_sensor(0x94C0,0x0C);
-		write_cmos_sensor(0x95BE,0x0C);
-		write_cmos_sensor(0x95BF,0x0C);
-		write_cmos_sensor(0x95C0,0x0C);
-		write_cmos_sensor(0x94D0,0x74);
-		write_cmos_sensor(0x94D1,0x74);
-		write_cmos_sensor(0x94D2,0x74);
-		write_cmos_sensor(0x95D0,0x74);
-		write_cmos_sensor(0x95D1,0x74);
-		write_cmos_sensor(0x95D2,0x74);
-		write_cmos_sensor(0x94CD,0x16);
-		write_cmos_sensor(0x94CE,0x16);
-		write_cmos_sensor(0x94CF,0x16);
-		write_cmos_sensor(0x95CD,0x16);
-		write_cmos_sensor(0x95CE,0x16);
-		write_cmos_sensor(0x95CF,0x16);
-		write_cmos_sensor(0x94CA,0x28);
-		write_cmos_sensor(0x94CB,0x28);
-		write_cmos_sensor(0x94CC,0x28);
-		write_cmos_sensor(0x95CA,0x28);
-		write_cmos_sensor(0x95CB,0x28);
-		write_cmos_sensor(0x95CC,0x28);
-		write_cmos_sensor(0x900E,0x32);
-		write_cmos_sensor(0x94E2,0xFF);
-		write_cmos_sensor(0x94E3,0xFF);
-		write_cmos_sensor(0x94E4,0xFF);
-		write_cmos_sensor(0x95E2,0xFF);
-		write_cmos_sensor(0x95E3,0xFF);
-		write_cmos_sensor(0x95E4,0xFF);
-		write_cmos_sensor(0x94DF,0x6E);
-		write_cmos_sensor(0x94E0,0x6E);
-		write_cmos_sensor(0x94E1,0x6E);
-		write_cmos_sensor(0x95DF,0x6E);
-		write_cmos_sensor(0x95E0,0x6E);
-		write_cmos_sensor(0x95E1,0x6E);
-		write_cmos_sensor(0x7FCC,0x01);
-		write_cmos_sensor(0x7B78,0x00);
-		write_cmos_sensor(0x9401,0x35);
-		write_cmos_sensor(0x9403,0x23);
-		write_cmos_sensor(0x9405,0x23);
-		write_cmos_sensor(0x9406,0x00);
-		write_cmos_sensor(0x9407,0x31);
-		write_cmos_sensor(0x9408,0x00);
-		write_cmos_sensor(0x9409,0x1B);
-		write_cmos_sensor(0x940A,0x00);
-		write_cmos_sensor(0x940B,0x15);
-		write_cmos_sensor(0x940D,0x3F);
-		write_cmos_sensor(0x940F,0x3F);
-		write_cmos_sensor(0x9411,0x3F);
-		write_cmos_sensor(0x9413,0x64);
-		write_cmos_sensor(0x9415,0x64);
-		write_cmos_sensor(0x9417,0x64);
-		write_cmos_sensor(0x941D,0x34);
-		write_cmos_sensor(0x941F,0x01);
-		write_cmos_sensor(0x9421,0x01);
-		write_cmos_sensor(0x9423,0x01);
-		write_cmos_sensor(0x9425,0x23);
-		write_cmos_sensor(0x9427,0x23);
-		write_cmos_sensor(0x9429,0x23);
-		write_cmos_sensor(0x942B,0x2F);
-		write_cmos_sensor(0x942D,0x1A);
-		write_cmos_sensor(0x942F,0x14);
-		write_cmos_sensor(0x9431,0x3F);
-		write_cmos_sensor(0x9433,0x3F);
-		write_cmos_sensor(0x9435,0x3F);
-		write_cmos_sensor(0x9437,0x6B);
-		write_cmos_sensor(0x9439,0x7C);
-		write_cmos_sensor(0x943B,0x81);
-		write_cmos_sensor(0x9443,0x0F);
-		write_cmos_sensor(0x9445,0x0F);
-		write_cmos_sensor(0x9447,0x0F);
-		write_cmos_sensor(0x9449,0x0F);
-		write_cmos_sensor(0x944B,0x0F);
-		write_cmos_sensor(0x944D,0x0F);
-		write_cmos_sensor(0x944F,0x1E);
-		write_cmos_sensor(0x9451,0x0F);
-		write_cmos_sensor(0x9453,0x0B);
-		write_cmos_sensor(0x9455,0x28);
-		write_cmos_sensor(0x9457,0x13);
-		write_cmos_sensor(0x9459,0x0C);
-		write_cmos_sensor(0x945D,0x00);
-		write_cmos_sensor(0x945E,0x00);
-		write_cmos_sensor(0x945F,0x00);
-		write_cmos_sensor(0x946D,0x00);
-		write_cmos_sensor(0x946F,0x10);
-		write_cmos_sensor(0x9471,0x10);
-		write_cmos_sensor(0x9473,0x40);
-		write_cmos_sensor(0x9475,0x2E);
-		write_cmos_sensor(0x9477,0x10);
-		write_cmos_sensor(0x9478,0x0A);
-		write_cmos_sensor(0x947B,0xE0);
-		write_cmos_sensor(0x947C,0xE0);
-		write_cmos_sensor(0x947D,0xE0);
-		write_cmos_sensor(0x947E,0xE0);
-		write_cmos_sensor(0x947F,0xE0);
-		write_cmos_sensor(0x9480,0xE0);
-		write_cmos_sensor(0x9483,0x14);
-		write_cmos_sensor(0x9485,0x14);
-		write_cmos_sensor(0x9487,0x14);
-		write_cmos_sensor(0x9501,0x35);
-		write_cmos_sensor(0x9503,0x14);
-		write_cmos_sensor(0x9505,0x14);
-		write_cmos_sensor(0x9507,0x31);
-		write_cmos_sensor(0x9509,0x1B);
-		write_cmos_sensor(0x950B,0x15);
-		write_cmos_sensor(0x950D,0x1E);
-		write_cmos_sensor(0x950F,0x1E);
-		write_cmos_sensor(0x9511,0x1E);
-		write_cmos_sensor(0x9513,0x64);
-		write_cmos_sensor(0x9515,0x64);
-		write_cmos_sensor(0x9517,0x64);
-		write_cmos_sensor(0x951D,0x34);
-		write_cmos_sensor(0x951F,0x01);
-		write_cmos_sensor(0x9521,0x01);
-		write_cmos_sensor(0x9523,0x01);
-		write_cmos_sensor(0x9525,0x14);
-		write_cmos_sensor(0x9527,0x14);
-		write_cmos_sensor(0x9529,0x14);
-		write_cmos_sensor(0x952B,0x2F);
-		write_cmos_sensor(0x952D,0x1A);
-		write_cmos_sensor(0x952F,0x14);
-		write_cmos_sensor(0x9531,0x1E);
-		write_cmos_sensor(0x9533,0x1E);
-		write_cmos_sensor(0x9535,0x1E);
-		write_cmos_sensor(0x9537,0x6B);
-		write_cmos_sensor(0x9539,0x7C);
-		write_cmos_sensor(0x953B,0x81);
-		write_cmos_sensor(0x9543,0x0F);
-		write_cmos_sensor(0x9545,0x0F);
-		write_cmos_sensor(0x9547,0x0F);
-		write_cmos_sensor(0x9549,0x0F);
-		write_cmos_sensor(0x954B,0x0F);
-		write_cmos_sensor(0x954D,0x0F);
-		write_cmos_sensor(0x954F,0x15);
-		write_cmos_sensor(0x9551,0x0B);
-		write_cmos_sensor(0x9553,0x08);
-		write_cmos_sensor(0x9555,0x1C);
-		write_cmos_sensor(0x9557,0x0D);
-		write_cmos_sensor(0x9559,0x08);
-		write_cmos_sensor(0x955D,0x00);
-		write_cmos_sensor(0x955E,0x00);
-		write_cmos_sensor(0x955F,0x00);
-		write_cmos_sensor(0x956D,0x00);
-		write_cmos_sensor(0x956F,0x10);
-		write_cmos_sensor(0x9571,0x10);
-		write_cmos_sensor(0x9573,0x40);
-		write_cmos_sensor(0x9575,0x2E);
-		write_cmos_sensor(0x9577,0x10);
-		write_cmos_sensor(0x9578,0x0A);
-		write_cmos_sensor(0x957B,0xE0);
-		write_cmos_sensor(0x957C,0xE0);
-		write_cmos_sensor(0x957D,0xE0);
-		write_cmos_sensor(0x957E,0xE0);
-		write_cmos_sensor(0x957F,0xE0);
-		write_cmos_sensor(0x9580,0xE0);
-		write_cmos_sensor(0x9583,0x14);
-		write_cmos_sensor(0x9585,0x14);
-		write_cmos_sensor(0x9587,0x14);
-		write_cmos_sensor(0x7F78,0x00);
-		write_cmos_sensor(0x7F89,0x00);
-		write_cmos_sensor(0x7F93,0x00);
-		write_cmos_sensor(0x924B,0x1B);
-		write_cmos_sensor(0x924C,0x0A);
-		write_cmos_sensor(0x9304,0x04);
-		write_cmos_sensor(0x9315,0x04);
-		write_cmos_sensor(0x9250,0x50);
-		write_cmos_sensor(0x9251,0x3C);
-		write_cmos_sensor(0x9252,0x14);
-		write_cmos_sensor(0x7B5F,0x01);
-		write_cmos_sensor(0x94DC,0x20);
-		write_cmos_sensor(0x94DD,0x20);
-		write_cmos_sensor(0x94DE,0x20);
-		write_cmos_sensor(0x95DC,0x20);
-		write_cmos_sensor(0x95DD,0x20);
-		write_cmos_sensor(0x95DE,0x20);
-		write_cmos_sensor(0x7FB0,0x01);
-		write_cmos_sensor(0x9010,0x48);
-		write_cmos_sensor(0x9419,0x50);
-		write_cmos_sensor(0x941B,0x50);
-		write_cmos_sensor(0x9519,0x50);
-		write_cmos_sensor(0x951B,0x50);
-
-			
-		write_cmos_sensor(0xD000,0x00);
-		write_cmos_sensor(0xD001,0x18);
-		write_cmos_sensor(0xD002,0x00);
-		write_cmos_sensor(0xD003,0x18);
-		write_cmos_sensor(0xD004,0x10);
-		write_cmos_sensor(0xD005,0x57);
-		write_cmos_sensor(0xD006,0x0C);
-		write_cmos_sensor(0xD007,0x17);
-		write_cmos_sensor(0xD00A,0x01);
-		write_cmos_sensor(0xD00B,0x02);
-		write_cmos_sensor(0xD00D,0x06);
-		write_cmos_sensor(0xD00E,0x05);
-		write_cmos_sensor(0xD00F,0x01);
-		write_cmos_sensor(0xD011,0x06);
-		write_cmos_sensor(0xD012,0x07);
-		write_cmos_sensor(0xD013,0x01);
-		write_cmos_sensor(0xD015,0x05);
-		write_cmos_sensor(0xD016,0x0C);
-		write_cmos_sensor(0xD017,0x02);
-		write_cmos_sensor(0xD019,0x05);
-		write_cmos_sensor(0xD01A,0x0E);
-		write_cmos_sensor(0xD01B,0x02);
-		write_cmos_sensor(0xD01D,0x0E);
-		write_cmos_sensor(0xD01E,0x15);
-		write_cmos_sensor(0xD01F,0x02);
-		write_cmos_sensor(0xD021,0x0E);
-		write_cmos_sensor(0xD022,0x17);
-		write_cmos_sensor(0xD023,0x02);
-		write_cmos_sensor(0xD025,0x0D);
-		write_cmos_sensor(0xD026,0x1C);
-		write_cmos_sensor(0xD027,0x01);
-		write_cmos_sensor(0xD029,0x0D);
-		write_cmos_sensor(0xD02A,0x1E);
-		write_cmos_sensor(0xD02B,0x01);
+		table_write_cmos_sensor(imx258_imagequality_setting2);
 	}
 }
 
 
+static const kal_uint16 imx258_init_setting[] = {
+	0x0136, 0x18,
+	0x0137, 0x00,
+
+	0x3051, 0x00,
+	0x6B11, 0xCF,
+	0x7FF0, 0x08,
+	0x7FF1, 0x0F,
+	0x7FF2, 0x08,
+	0x7FF3, 0x1B,
+	0x7FF4, 0x23,
+	0x7FF5, 0x60,
+	0x7FF6, 0x00,
+	0x7FF7, 0x01,
+	0x7FF8, 0x00,
+	0x7FF9, 0x78,
+	0x7FFA, 0x01,
+	0x7FFB, 0x00,
+	0x7FFC, 0x00,
+	0x7FFD, 0x00,
+	0x7FFE, 0x00,
+	0x7FFF, 0x03,
+	0x7F76, 0x03,
+	0x7F77, 0xFE,
+	0x7FA8, 0x03,
+	0x7FA9, 0xFE,
+	0x7B24, 0x81,
+	0x7B25, 0x01,
+	0x6564, 0x07,
+	0x6B0D, 0x41,
+	0x653D, 0x04,
+	0x6B05, 0x8C,
+	0x6B06, 0xF9,
+	0x6B08, 0x65,
+	0x6B09, 0xFC,
+	0x6B0A, 0xCF,
+	0x6B0B, 0xD2,
+	0x6700, 0x0E,
+	0x6707, 0x0E,
+	0x9104, 0x00,
+	0x7421, 0x1C,
+	0x7423, 0xD7,
+	0x5F04, 0x00,
+	0x5F05, 0xED,
+};
+
 static void sensor_init(void)
 {
 	LOG_INF("E\n");
 	//init setting
 	//imx258
-	write_cmos_sensor(0x0136,0x18);
-	write_cmos_sensor(0x0137,0x00);
-
-	write_cmos_sensor(0x3051,0x00);
-	write_cmos_sensor(0x6B11,0xCF);
-	write_cmos_sensor(0x7FF0,0x08);
-	write_cmos_sensor(0x7FF1,0x0F);
-	write_cmos_sensor(0x7FF2,0x08);
-	write_cmos_sensor(0x7FF3,0x1B);
-	write_cmos_sensor(0x7FF4,0x23);
-	write_cmos_sensor(0x7FF5,0x60);
-	write_cmos_sensor(0x7FF6,0x00);
-	write_cmos_sensor(0x7FF7,0x01);
-	write_cmos_sensor(0x7FF8,0x00);
-	write_cmos_sensor(0x7FF9,0x78);
-	write_cmos_sensor(0x7FFA,0x01);
-	write_cmos_sensor(0x7FFB,0x00);
-	write_cmos_sensor(0x7FFC,0x00);
-	write_cmos_sensor(0x7FFD,0x00);
-	write_cmos_sensor(0x7FFE,0x00);
-	write_cmos_sensor(0x7FFF,0x03);
-	write_cmos_sensor(0x7F76,0x03);
-	write_cmos_sensor(0x7F77,0xFE);
-	write_cmos_sensor(0x7FA8,0x03);
-	write_cmos_sensor(0x7FA9,0xFE);
-	write_cmos_sensor(0x7B24,0x81);
-	write_cmos_sensor(0x7B25,0x01);
-	write_cmos_sensor(0x6564,0x07);
-	write_cmos_sensor(0x6B0D,0x41);
-	write_cmos_sensor(0x653D,0x04);
-	write_cmos_sensor(0x6B05,0x8C);
-	write_cmos_sensor(0x6B06,0xF9);
-	write_cmos_sensor(0x6B08,0x65);
-	write_cmos_sensor(0x6B09,0xFC);
-	write_cmos_sensor(0x6B0A,0xCF);
-	write_cmos_sensor(0x6B0B,0xD2);
-	write_cmos_sensor(0x6700,0x0E);
-	write_cmos_sensor(0x6707,0x0E);
-	write_cmos_sensor(0x9104,0x00);
-	write_cmos_sensor(0x7421,0x1C);
-	write_cmos_sensor(0x7423,0xD7);
-	write_cmos_sensor(0x5F04,0x00);
-	write_cmos_sensor(0x5F05,0xED);
+	table_write_cmos_sensor(imx258_init_setting);
 
 	imx258_ImageQuality_Setting();
 
@@ -1434,83 +1447,87 @@ static void sensor_init(void)
 	write_cmos_sensor(0x0100,0x00);
 }	/*	sensor_init  */
 
+static const kal_uint16 imx258_preview_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0x6C,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x0A,
+	0x0821, 0x20,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x06,
+	0x0341, 0x4E,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x03,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x01,
+	0x0404, 0x00,
+	0x0405, 0x20,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x06,
+	0x040F, 0x18,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x08,
+	0x034D, 0x34,
+	0x034E, 0x06,
+	0x034F, 0x18,
+
+	0x0202, 0x06,
+	0x0203, 0x44,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+};
+
 static void preview_setting(void)
 {
 	LOG_INF("preview E\n");
     write_cmos_sensor(0x0100,0x00);
 	mdelay(10);
 
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x0114,0x03);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x04);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0x6C);
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x030D,0x02);
-	write_cmos_sensor(0x030E,0x00);
-	write_cmos_sensor(0x030F,0xD8);
-	write_cmos_sensor(0x0310,0x00);
-	write_cmos_sensor(0x0820,0x0A);
-	write_cmos_sensor(0x0821,0x20);
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-
-	write_cmos_sensor(0x0342,0x14);
-	write_cmos_sensor(0x0343,0xE8);
-
-	write_cmos_sensor(0x0340,0x06);
-	write_cmos_sensor(0x0341,0x4E);
-
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x00);
-	write_cmos_sensor(0x0347,0x00);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0C);
-	write_cmos_sensor(0x034B,0x2F);
-
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x03);
-	write_cmos_sensor(0x0900,0x00);
-	write_cmos_sensor(0x0901,0x11);
-	write_cmos_sensor(0x0902,0x00);
-
-	write_cmos_sensor(0x0401,0x01);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x20);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x10);
-	write_cmos_sensor(0x040D,0x70);
-	write_cmos_sensor(0x040E,0x06);
-	write_cmos_sensor(0x040F,0x18);
-	write_cmos_sensor(0x3038,0x00);
-	write_cmos_sensor(0x303A,0x00);
-	write_cmos_sensor(0x303B,0x10);
-	write_cmos_sensor(0x300D,0x00);
-
-	write_cmos_sensor(0x034C,0x08);
-	write_cmos_sensor(0x034D,0x34);
-	write_cmos_sensor(0x034E,0x06);
-	write_cmos_sensor(0x034F,0x18);
-
-	write_cmos_sensor(0x0202,0x06);
-	write_cmos_sensor(0x0203,0x44);
-
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
+	table_write_cmos_sensor(imx258_preview_setting);
 
 	if(imx258_type == IMX258_HDR_TYPE)
 	{
@@ -1531,6 +1548,234 @@ static void preview_setting(void)
 
 }
 
+static const kal_uint16 imx258_capture_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0x6C,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x0A,
+	0x0821, 0x20,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x0C,
+	0x0341, 0x9C,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+
+	0x0202, 0x0C,
+	0x0203, 0x92,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+
+	0x7BCD, 0x00,
+};
+
+static const kal_uint16 imx258_capture_setting2[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0xAD,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x10,
+	0x0821, 0x38,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x0C,
+	0x0341, 0x9C,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+
+	0x0202, 0x0C,
+	0x0203, 0x92,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+
+	0x7BCD, 0x00,
+};
+
+static const kal_uint16 imx258_capture_setting3[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0xD8,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x14,
+	0x0821, 0x40,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x0C,
+	0x0341, 0x9C,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+
+	0x0202, 0x0C,
+	0x0203, 0x92,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+
+	0x7BCD, 0x00,
+};
+
 static void capture_setting(kal_uint16 curretfps, kal_uint8  pdaf_mode)
 {
 	LOG_INF("capture E\n");
@@ -1541,79 +1786,7 @@ static void capture_setting(kal_uint16 curretfps, kal_uint8  pdaf_mode)
 		write_cmos_sensor(0x0100,0x00);
 		mdelay(10);
 
-		write_cmos_sensor(0x0112,0x0A);
-		write_cmos_sensor(0x0113,0x0A);
-		write_cmos_sensor(0x0114,0x03);
-
-		write_cmos_sensor(0x0301,0x05);
-		write_cmos_sensor(0x0303,0x02);
-		write_cmos_sensor(0x0305,0x04);
-		write_cmos_sensor(0x0306,0x00);
-		write_cmos_sensor(0x0307,0x6C);
-		write_cmos_sensor(0x0309,0x0A);
-		write_cmos_sensor(0x030B,0x01);
-		write_cmos_sensor(0x030D,0x02);
-		write_cmos_sensor(0x030E,0x00);
-		write_cmos_sensor(0x030F,0xD8);
-		write_cmos_sensor(0x0310,0x00);
-		write_cmos_sensor(0x0820,0x0A);
-		write_cmos_sensor(0x0821,0x20);
-		write_cmos_sensor(0x0822,0x00);
-		write_cmos_sensor(0x0823,0x00);
-
-		write_cmos_sensor(0x0342,0x14);
-		write_cmos_sensor(0x0343,0xE8);
-
-		write_cmos_sensor(0x0340,0x0C);
-		write_cmos_sensor(0x0341,0x9C);
-
-		write_cmos_sensor(0x0344,0x00);
-		write_cmos_sensor(0x0345,0x00);
-		write_cmos_sensor(0x0346,0x00);
-		write_cmos_sensor(0x0347,0x00);
-		write_cmos_sensor(0x0348,0x10);
-		write_cmos_sensor(0x0349,0x6F);
-		write_cmos_sensor(0x034A,0x0C);
-		write_cmos_sensor(0x034B,0x2F);
-
-		write_cmos_sensor(0x0381,0x01);
-		write_cmos_sensor(0x0383,0x01);
-		write_cmos_sensor(0x0385,0x01);
-		write_cmos_sensor(0x0387,0x01);
-		write_cmos_sensor(0x0900,0x00);
-		write_cmos_sensor(0x0901,0x11);
-		write_cmos_sensor(0x0902,0x00);
-
-		write_cmos_sensor(0x0401,0x00);
-		write_cmos_sensor(0x0404,0x00);
-		write_cmos_sensor(0x0405,0x10);
-		write_cmos_sensor(0x0408,0x00);
-		write_cmos_sensor(0x0409,0x00);
-		write_cmos_sensor(0x040A,0x00);
-		write_cmos_sensor(0x040B,0x00);
-		write_cmos_sensor(0x040C,0x10);
-		write_cmos_sensor(0x040D,0x70);
-		write_cmos_sensor(0x040E,0x0C);
-		write_cmos_sensor(0x040F,0x30);
-		write_cmos_sensor(0x3038,0x00);
-		write_cmos_sensor(0x303A,0x00);
-		write_cmos_sensor(0x303B,0x10);
-		write_cmos_sensor(0x300D,0x00);
-
-		write_cmos_sensor(0x034C,0x10);
-		write_cmos_sensor(0x034D,0x70);
-		write_cmos_sensor(0x034E,0x0C);
-		write_cmos_sensor(0x034F,0x30);
-
-		write_cmos_sensor(0x0202,0x0C);
-		write_cmos_sensor(0x0203,0x92);
-
-		write_cmos_sensor(0x0204,0x00);
-		write_cmos_sensor(0x0205,0x00);
-		write_cmos_sensor(0x020E,0x01);
-		write_cmos_sensor(0x020F,0x00);
-
-		write_cmos_sensor(0x7BCD,0x00);
+		table_write_cmos_sensor(imx258_capture_setting);
 
 
 		if(pdaf_mode == 1) {
@@ -1639,79 +1812,7 @@ static void capture_setting(kal_uint16 curretfps, kal_uint8  pdaf_mode)
 		write_cmos_sensor(0x0100,0x00);
 		mdelay(10);
 
-		write_cmos_sensor(0x0112,0x0A);
-		write_cmos_sensor(0x0113,0x0A);
-		write_cmos_sensor(0x0114,0x03);
-
-		write_cmos_sensor(0x0301,0x05);
-		write_cmos_sensor(0x0303,0x02);
-		write_cmos_sensor(0x0305,0x04);
-		write_cmos_sensor(0x0306,0x00);
-		write_cmos_sensor(0x0307,0xAD);
-		write_cmos_sensor(0x0309,0x0A);
-		write_cmos_sensor(0x030B,0x01);
-		write_cmos_sensor(0x030D,0x02);
-		write_cmos_sensor(0x030E,0x00);
-		write_cmos_sensor(0x030F,0xD8);
-		write_cmos_sensor(0x0310,0x00);
-		write_cmos_sensor(0x0820,0x10);
-		write_cmos_sensor(0x0821,0x38);
-		write_cmos_sensor(0x0822,0x00);
-		write_cmos_sensor(0x0823,0x00);
-
-		write_cmos_sensor(0x0342,0x14);
-		write_cmos_sensor(0x0343,0xE8);
-
-		write_cmos_sensor(0x0340,0x0C);
-		write_cmos_sensor(0x0341,0x9C);
-
-		write_cmos_sensor(0x0344,0x00);
-		write_cmos_sensor(0x0345,0x00);
-		write_cmos_sensor(0x0346,0x00);
-		write_cmos_sensor(0x0347,0x00);
-		write_cmos_sensor(0x0348,0x10);
-		write_cmos_sensor(0x0349,0x6F);
-		write_cmos_sensor(0x034A,0x0C);
-		write_cmos_sensor(0x034B,0x2F);
-
-		write_cmos_sensor(0x0381,0x01);
-		write_cmos_sensor(0x0383,0x01);
-		write_cmos_sensor(0x0385,0x01);
-		write_cmos_sensor(0x0387,0x01);
-		write_cmos_sensor(0x0900,0x00);
-		write_cmos_sensor(0x0901,0x11);
-		write_cmos_sensor(0x0902,0x00);
-
-		write_cmos_sensor(0x0401,0x00);
-		write_cmos_sensor(0x0404,0x00);
-		write_cmos_sensor(0x0405,0x10);
-		write_cmos_sensor(0x0408,0x00);
-		write_cmos_sensor(0x0409,0x00);
-		write_cmos_sensor(0x040A,0x00);
-		write_cmos_sensor(0x040B,0x00);
-		write_cmos_sensor(0x040C,0x10);
-		write_cmos_sensor(0x040D,0x70);
-		write_cmos_sensor(0x040E,0x0C);
-		write_cmos_sensor(0x040F,0x30);
-		write_cmos_sensor(0x3038,0x00);
-		write_cmos_sensor(0x303A,0x00);
-		write_cmos_sensor(0x303B,0x10);
-		write_cmos_sensor(0x300D,0x00);
-
-		write_cmos_sensor(0x034C,0x10);
-		write_cmos_sensor(0x034D,0x70);
-		write_cmos_sensor(0x034E,0x0C);
-		write_cmos_sensor(0x034F,0x30);
-
-		write_cmos_sensor(0x0202,0x0C);
-		write_cmos_sensor(0x0203,0x92);
-
-		write_cmos_sensor(0x0204,0x00);
-		write_cmos_sensor(0x0205,0x00);
-		write_cmos_sensor(0x020E,0x01);
-		write_cmos_sensor(0x020F,0x00);
-
-		write_cmos_sensor(0x7BCD,0x00);
+		table_write_cmos_sensor(imx258_capture_setting2);
 
 
 		if(pdaf_mode == 1) {
@@ -1738,79 +1839,7 @@ static void capture_setting(kal_uint16 curretfps, kal_uint8  pdaf_mode)
 		write_cmos_sensor(0x0100,0x00);
 		mdelay(10);
 
-		write_cmos_sensor(0x0112,0x0A);
-		write_cmos_sensor(0x0113,0x0A);
-		write_cmos_sensor(0x0114,0x03);
-
-		write_cmos_sensor(0x0301,0x05);
-		write_cmos_sensor(0x0303,0x02);
-		write_cmos_sensor(0x0305,0x04);
-		write_cmos_sensor(0x0306,0x00);
-		write_cmos_sensor(0x0307,0xD8);
-		write_cmos_sensor(0x0309,0x0A);
-		write_cmos_sensor(0x030B,0x01);
-		write_cmos_sensor(0x030D,0x02);
-		write_cmos_sensor(0x030E,0x00);
-		write_cmos_sensor(0x030F,0xD8);
-		write_cmos_sensor(0x0310,0x00);
-		write_cmos_sensor(0x0820,0x14);
-		write_cmos_sensor(0x0821,0x40);
-		write_cmos_sensor(0x0822,0x00);
-		write_cmos_sensor(0x0823,0x00);
-
-		write_cmos_sensor(0x0342,0x14);
-		write_cmos_sensor(0x0343,0xE8);
-
-		write_cmos_sensor(0x0340,0x0C);
-		write_cmos_sensor(0x0341,0x9C);
-
-		write_cmos_sensor(0x0344,0x00);
-		write_cmos_sensor(0x0345,0x00);
-		write_cmos_sensor(0x0346,0x00);
-		write_cmos_sensor(0x0347,0x00);
-		write_cmos_sensor(0x0348,0x10);
-		write_cmos_sensor(0x0349,0x6F);
-		write_cmos_sensor(0x034A,0x0C);
-		write_cmos_sensor(0x034B,0x2F);
-
-		write_cmos_sensor(0x0381,0x01);
-		write_cmos_sensor(0x0383,0x01);
-		write_cmos_sensor(0x0385,0x01);
-		write_cmos_sensor(0x0387,0x01);
-		write_cmos_sensor(0x0900,0x00);
-		write_cmos_sensor(0x0901,0x11);
-		write_cmos_sensor(0x0902,0x00);
-
-		write_cmos_sensor(0x0401,0x00);
-		write_cmos_sensor(0x0404,0x00);
-		write_cmos_sensor(0x0405,0x10);
-		write_cmos_sensor(0x0408,0x00);
-		write_cmos_sensor(0x0409,0x00);
-		write_cmos_sensor(0x040A,0x00);
-		write_cmos_sensor(0x040B,0x00);
-		write_cmos_sensor(0x040C,0x10);
-		write_cmos_sensor(0x040D,0x70);
-		write_cmos_sensor(0x040E,0x0C);
-		write_cmos_sensor(0x040F,0x30);
-		write_cmos_sensor(0x3038,0x00);
-		write_cmos_sensor(0x303A,0x00);
-		write_cmos_sensor(0x303B,0x10);
-		write_cmos_sensor(0x300D,0x00);
-
-		write_cmos_sensor(0x034C,0x10);
-		write_cmos_sensor(0x034D,0x70);
-		write_cmos_sensor(0x034E,0x0C);
-		write_cmos_sensor(0x034F,0x30);
-
-		write_cmos_sensor(0x0202,0x0C);
-		write_cmos_sensor(0x0203,0x92);
-
-		write_cmos_sensor(0x0204,0x00);
-		write_cmos_sensor(0x0205,0x00);
-		write_cmos_sensor(0x020E,0x01);
-		write_cmos_sensor(0x020F,0x00);
-
-		write_cmos_sensor(0x7BCD,0x00);
+		table_write_cmos_sensor(imx258_capture_setting3);
 
 
 		if(pdaf_mode == 1) {
@@ -1834,94 +1863,98 @@ static void capture_setting(kal_uint16 curretfps, kal_uint8  pdaf_mode)
 	}
 }
 #if 0
+static const kal_uint16 imx258_PIP24fps_capture_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0xAD,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x10,
+	0x0821, 0x38,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x0C,
+	0x0341, 0x9C,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+
+	0x0202, 0x0C,
+	0x0203, 0x92,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+
+	0x94DC, 0x20,
+	0x94DD, 0x20,
+	0x94DE, 0x20,
+	0x95DC, 0x20,
+	0x95DD, 0x20,
+	0x95DE, 0x20,
+	0x7FB0, 0x00,
+	0x9010, 0x3E,
+
+	0x3030, 0x00,
+};
+
 static void PIP24fps_capture_setting()
 {
 	LOG_INF("PIP24fps capture E\n");
 	write_cmos_sensor(0x0100,0x00);
 	mdelay(10);
 
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x0114,0x03);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x04);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0xAD);
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x030D,0x02);
-	write_cmos_sensor(0x030E,0x00);
-	write_cmos_sensor(0x030F,0xD8);
-	write_cmos_sensor(0x0310,0x00);
-	write_cmos_sensor(0x0820,0x10);
-	write_cmos_sensor(0x0821,0x38);
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-
-	write_cmos_sensor(0x0342,0x14);
-	write_cmos_sensor(0x0343,0xE8);
-
-	write_cmos_sensor(0x0340,0x0C);
-	write_cmos_sensor(0x0341,0x9C);
-
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x00);
-	write_cmos_sensor(0x0347,0x00);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0C);
-	write_cmos_sensor(0x034B,0x2F);
-
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x01);
-	write_cmos_sensor(0x0900,0x00);
-	write_cmos_sensor(0x0901,0x11);
-	write_cmos_sensor(0x0902,0x00);
-
-	write_cmos_sensor(0x0401,0x00);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x10);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x10);
-	write_cmos_sensor(0x040D,0x70);
-	write_cmos_sensor(0x040E,0x0C);
-	write_cmos_sensor(0x040F,0x30);
-	write_cmos_sensor(0x3038,0x00);
-	write_cmos_sensor(0x303A,0x00);
-	write_cmos_sensor(0x303B,0x10);
-	write_cmos_sensor(0x300D,0x00);
-
-	write_cmos_sensor(0x034C,0x10);
-	write_cmos_sensor(0x034D,0x70);
-	write_cmos_sensor(0x034E,0x0C);
-	write_cmos_sensor(0x034F,0x30);
-
-	write_cmos_sensor(0x0202,0x0C);
-	write_cmos_sensor(0x0203,0x92);
-
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
-
-	write_cmos_sensor(0x94DC,0x20);
-	write_cmos_sensor(0x94DD,0x20);
-	write_cmos_sensor(0x94DE,0x20);
-	write_cmos_sensor(0x95DC,0x20);
-	write_cmos_sensor(0x95DD,0x20);
-	write_cmos_sensor(0x95DE,0x20);
-	write_cmos_sensor(0x7FB0,0x00);
-	write_cmos_sensor(0x9010,0x3E);
-
-	write_cmos_sensor(0x3030,0x00);
+	table_write_cmos_sensor(imx258_PIP24fps_capture_setting);
 	LOG_INF("0x3030=%d",read_cmos_sensor(0x3030));
 	write_cmos_sensor(0x3032,0x00);
 	write_cmos_sensor(0x0220,0x00);
@@ -1932,94 +1965,98 @@ static void PIP24fps_capture_setting()
 }
 
 
+static const kal_uint16 imx258_PIP15fps_capture_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0x6C,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x0A,
+	0x0821, 0x20,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x0C,
+	0x0341, 0x9C,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+
+	0x0202, 0x0C,
+	0x0203, 0x92,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+
+	0x94DC, 0x20,
+	0x94DD, 0x20,
+	0x94DE, 0x20,
+	0x95DC, 0x20,
+	0x95DD, 0x20,
+	0x95DE, 0x20,
+	0x7FB0, 0x00,
+	0x9010, 0x3E,
+
+	0x3030, 0x00,
+};
+
 static void PIP15fps_capture_setting()
 {
 	LOG_INF("PIP15fps capture E\n");
 	write_cmos_sensor(0x0100,0x00);
 	mdelay(10);
 
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x0114,0x03);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x04);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0x6C);
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x030D,0x02);
-	write_cmos_sensor(0x030E,0x00);
-	write_cmos_sensor(0x030F,0xD8);
-	write_cmos_sensor(0x0310,0x00);
-	write_cmos_sensor(0x0820,0x0A);
-	write_cmos_sensor(0x0821,0x20);
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-
-	write_cmos_sensor(0x0342,0x14);
-	write_cmos_sensor(0x0343,0xE8);
-
-	write_cmos_sensor(0x0340,0x0C);
-	write_cmos_sensor(0x0341,0x9C);
-
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x00);
-	write_cmos_sensor(0x0347,0x00);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0C);
-	write_cmos_sensor(0x034B,0x2F);
-
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x01);
-	write_cmos_sensor(0x0900,0x00);
-	write_cmos_sensor(0x0901,0x11);
-	write_cmos_sensor(0x0902,0x00);
-
-	write_cmos_sensor(0x0401,0x00);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x10);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x10);
-	write_cmos_sensor(0x040D,0x70);
-	write_cmos_sensor(0x040E,0x0C);
-	write_cmos_sensor(0x040F,0x30);
-	write_cmos_sensor(0x3038,0x00);
-	write_cmos_sensor(0x303A,0x00);
-	write_cmos_sensor(0x303B,0x10);
-	write_cmos_sensor(0x300D,0x00);
-
-	write_cmos_sensor(0x034C,0x10);
-	write_cmos_sensor(0x034D,0x70);
-	write_cmos_sensor(0x034E,0x0C);
-	write_cmos_sensor(0x034F,0x30);
-
-	write_cmos_sensor(0x0202,0x0C);
-	write_cmos_sensor(0x0203,0x92);
-
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
-
-	write_cmos_sensor(0x94DC,0x20);
-	write_cmos_sensor(0x94DD,0x20);
-	write_cmos_sensor(0x94DE,0x20);
-	write_cmos_sensor(0x95DC,0x20);
-	write_cmos_sensor(0x95DD,0x20);
-	write_cmos_sensor(0x95DE,0x20);
-	write_cmos_sensor(0x7FB0,0x00);
-	write_cmos_sensor(0x9010,0x3E);
-
-	write_cmos_sensor(0x3030,0x00);
+	table_write_cmos_sensor(imx258_PIP15fps_capture_setting);
 	LOG_INF("0x3030=%d",read_cmos_sensor(0x3030));
 	write_cmos_sensor(0x3032,0x00);
 	write_cmos_sensor(0x0220,0x00);
@@ -2029,6 +2066,91 @@ static void PIP15fps_capture_setting()
 
 }
 #endif
+static const kal_uint16 imx258_normal_video_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0xD8,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x14,
+	0x0821, 0x40,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x0C,
+};
+
+static const kal_uint16 imx258_normal_video_setting2[] = {
+	0x0341, 0x98,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x00,
+	0x0901, 0x11,
+	0x0902, 0x00,
+
+	0x0401, 0x00,
+	0x0404, 0x00,
+	0x0405, 0x10,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x0C,
+	0x040F, 0x30,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x10,
+	0x034D, 0x70,
+	0x034E, 0x0C,
+	0x034F, 0x30,
+
+	0x0202, 0x0C,
+};
+
+static const kal_uint16 imx258_normal_video_setting3[] = {
+	0x0203, 0x8E,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+
+	0x7BCD, 0x00,
+
+	0x3030, 0x01,
+	0x3032, 0x01,
+};
+
 static void normal_video_setting(kal_uint16 currefps, kal_uint8  pdaf_mode)
 {
 	LOG_INF("normal video E\n");
@@ -2036,88 +2158,15 @@ static void normal_video_setting(kal_uint16 currefps, kal_uint8  pdaf_mode)
 	write_cmos_sensor(0x0100,0x00);
 	mdelay(10);
 
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x0114,0x03);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x04);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0xD8);
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x030D,0x02);
-	write_cmos_sensor(0x030E,0x00);
-	write_cmos_sensor(0x030F,0xD8);
-	write_cmos_sensor(0x0310,0x00);
-	write_cmos_sensor(0x0820,0x14);
-	write_cmos_sensor(0x0821,0x40);
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-
-	write_cmos_sensor(0x0342,0x14);
-	write_cmos_sensor(0x0343,0xE8);
-
-	write_cmos_sensor(0x0340,0x0C);
+	table_write_cmos_sensor(imx258_normal_video_setting);
 	if(imx258_type == IMX258_HDR_TYPE)
 		write_cmos_sensor(0x0341,0x9C);
 	else if(imx258_type == IMX258_BINNING_TYPE)
-		write_cmos_sensor(0x0341,0x98);
-
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x00);
-	write_cmos_sensor(0x0347,0x00);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0C);
-	write_cmos_sensor(0x034B,0x2F);
-
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x01);
-	write_cmos_sensor(0x0900,0x00);
-	write_cmos_sensor(0x0901,0x11);
-	write_cmos_sensor(0x0902,0x00);
-
-	write_cmos_sensor(0x0401,0x00);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x10);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x10);
-	write_cmos_sensor(0x040D,0x70);
-	write_cmos_sensor(0x040E,0x0C);
-	write_cmos_sensor(0x040F,0x30);
-	write_cmos_sensor(0x3038,0x00);
-	write_cmos_sensor(0x303A,0x00);
-	write_cmos_sensor(0x303B,0x10);
-	write_cmos_sensor(0x300D,0x00);
-
-	write_cmos_sensor(0x034C,0x10);
-	write_cmos_sensor(0x034D,0x70);
-	write_cmos_sensor(0x034E,0x0C);
-	write_cmos_sensor(0x034F,0x30);
-
-	write_cmos_sensor(0x0202,0x0C);
+		table_write_cmos_sensor(imx258_normal_video_setting2);
 	if(imx258_type == IMX258_HDR_TYPE)
 		write_cmos_sensor(0x0203,0x92);
 	else if(imx258_type == IMX258_BINNING_TYPE)
-		write_cmos_sensor(0x0203,0x8E);
-
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
-
-	write_cmos_sensor(0x7BCD,0x00);
-
-	write_cmos_sensor(0x3030,0x01);
-	write_cmos_sensor(0x3032,0x01);
+		table_write_cmos_sensor(imx258_normal_video_setting3);
 
 	if(imgsensor.ihdr_en == 1)
 	{
@@ -2135,6 +2184,80 @@ static void normal_video_setting(kal_uint16 currefps, kal_uint8  pdaf_mode)
 	mdelay(10);
 
 }
+static const kal_uint16 imx258_hs_video_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0xD8, //0xc8  //PLL_IVT_MPY[7:0]
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x14, //0x12   //Output Date rate[31:24]
+	0x0821, 0x40, //0xc0  //Output Date rate[23:16]
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x03, //0x02
+	0x0341, 0x2C, //0xEA
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00, //0x02
+	0x0347, 0x00, //0x50
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C, //0x09
+	0x034B, 0x2F, //0xCF
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01, //0x03
+	0x0387, 0x01, //0x03
+	0x0900, 0x01,
+	0x0901, 0x14, //0x12
+	//write_cmos_sensor(0x0902,0x02);
+
+	0x0401, 0x01,
+	0x0404, 0x00,
+	0x0405, 0x40,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x03, //0x02
+	0x040F, 0x0C, //0x80
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00, //0x01
+
+	0x034C, 0x04,
+	0x034D, 0x18,
+	0x034E, 0x03, //0x01
+	0x034F, 0x0C, //0xE0
+
+	0x0202, 0x03, //0x02
+	0x0203, 0x22, //0xE0
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+};
+
 static void hs_video_setting(void)
 {
 	LOG_INF("hs_video E\n");
@@ -2142,77 +2265,7 @@ static void hs_video_setting(void)
 	write_cmos_sensor(0x0100,0x00);
 	mdelay(10);
 
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x0114,0x03);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x04);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0xD8);//0xc8  //PLL_IVT_MPY[7:0]
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x030D,0x02);
-	write_cmos_sensor(0x030E,0x00);
-	write_cmos_sensor(0x030F,0xD8);
-	write_cmos_sensor(0x0310,0x00);
-	write_cmos_sensor(0x0820,0x14);//0x12   //Output Date rate[31:24]
-	write_cmos_sensor(0x0821,0x40);//0xc0  //Output Date rate[23:16]
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-
-	write_cmos_sensor(0x0342,0x14);
-	write_cmos_sensor(0x0343,0xE8);
-
-	write_cmos_sensor(0x0340,0x03);//0x02
-	write_cmos_sensor(0x0341,0x2C);//0xEA
-
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x00);//0x02
-	write_cmos_sensor(0x0347,0x00);//0x50
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0C);//0x09
-	write_cmos_sensor(0x034B,0x2F);//0xCF
-
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);//0x03
-	write_cmos_sensor(0x0387,0x01);//0x03
-	write_cmos_sensor(0x0900,0x01);
-	write_cmos_sensor(0x0901,0x14);//0x12
-	//write_cmos_sensor(0x0902,0x02);
-
-	write_cmos_sensor(0x0401,0x01);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x40);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x10);
-	write_cmos_sensor(0x040D,0x70);
-	write_cmos_sensor(0x040E,0x03);//0x02
-	write_cmos_sensor(0x040F,0x0C);//0x80
-	write_cmos_sensor(0x3038,0x00);
-	write_cmos_sensor(0x303A,0x00);
-	write_cmos_sensor(0x303B,0x10);
-	write_cmos_sensor(0x300D,0x00);//0x01
-
-	write_cmos_sensor(0x034C,0x04);
-	write_cmos_sensor(0x034D,0x18);
-	write_cmos_sensor(0x034E,0x03);//0x01
-	write_cmos_sensor(0x034F,0x0C);//0xE0
-
-	write_cmos_sensor(0x0202,0x03);//0x02
-	write_cmos_sensor(0x0203,0x22);//0xE0
-
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
+	table_write_cmos_sensor(imx258_hs_video_setting);
 
 	if(imx258_type == IMX258_HDR_TYPE)
 	{
@@ -2235,83 +2288,87 @@ static void hs_video_setting(void)
 
 }
 
+static const kal_uint16 imx258_slim_video_setting[] = {
+	0x0112, 0x0A,
+	0x0113, 0x0A,
+	0x0114, 0x03,
+
+	0x0301, 0x05,
+	0x0303, 0x02,
+	0x0305, 0x04,
+	0x0306, 0x00,
+	0x0307, 0x6C,
+	0x0309, 0x0A,
+	0x030B, 0x01,
+	0x030D, 0x02,
+	0x030E, 0x00,
+	0x030F, 0xD8,
+	0x0310, 0x00,
+	0x0820, 0x0A,
+	0x0821, 0x20,
+	0x0822, 0x00,
+	0x0823, 0x00,
+
+	0x0342, 0x14,
+	0x0343, 0xE8,
+
+	0x0340, 0x06,
+	0x0341, 0x4E,
+
+	0x0344, 0x00,
+	0x0345, 0x00,
+	0x0346, 0x00,
+	0x0347, 0x00,
+	0x0348, 0x10,
+	0x0349, 0x6F,
+	0x034A, 0x0C,
+	0x034B, 0x2F,
+
+	0x0381, 0x01,
+	0x0383, 0x01,
+	0x0385, 0x01,
+	0x0387, 0x01,
+	0x0900, 0x01,
+	0x0901, 0x12,
+	0x0902, 0x02,
+
+	0x0401, 0x01,
+	0x0404, 0x00,
+	0x0405, 0x20,
+	0x0408, 0x00,
+	0x0409, 0x00,
+	0x040A, 0x00,
+	0x040B, 0x00,
+	0x040C, 0x10,
+	0x040D, 0x70,
+	0x040E, 0x06,
+	0x040F, 0x18,
+	0x3038, 0x00,
+	0x303A, 0x00,
+	0x303B, 0x10,
+	0x300D, 0x00,
+
+	0x034C, 0x08,
+	0x034D, 0x34,
+	0x034E, 0x06,
+	0x034F, 0x18,
+
+	0x0202, 0x06,
+	0x0203, 0x44,
+
+	0x0204, 0x00,
+	0x0205, 0x00,
+	0x020E, 0x01,
+	0x020F, 0x00,
+};
+
 static void slim_video_setting(void)
 {
 	LOG_INF("slim video E\n");
     write_cmos_sensor(0x0100,0x00);
 	mdelay(10);
 
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x0114,0x03);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x04);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0x6C);
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x030D,0x02);
-	write_cmos_sensor(0x030E,0x00);
-	write_cmos_sensor(0x030F,0xD8);
-	write_cmos_sensor(0x0310,0x00);
-	write_cmos_sensor(0x0820,0x0A);
-	write_cmos_sensor(0x0821,0x20);
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-
-	write_cmos_sensor(0x0342,0x14);
-	write_cmos_sensor(0x0343,0xE8);
-
-	write_cmos_sensor(0x0340,0x06);
-	write_cmos_sensor(0x0341,0x4E);
-
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x00);
-	write_cmos_sensor(0x0347,0x00);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0C);
-	write_cmos_sensor(0x034B,0x2F);
-
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x01);
-	write_cmos_sensor(0x0900,0x01);
-	write_cmos_sensor(0x0901,0x12);
-	write_cmos_sensor(0x0902,0x02);
-
-	write_cmos_sensor(0x0401,0x01);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x20);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x10);
-	write_cmos_sensor(0x040D,0x70);
-	write_cmos_sensor(0x040E,0x06);
-	write_cmos_sensor(0x040F,0x18);
-	write_cmos_sensor(0x3038,0x00);
-	write_cmos_sensor(0x303A,0x00);
-	write_cmos_sensor(0x303B,0x10);
-	write_cmos_sensor(0x300D,0x00);
-
-	write_cmos_sensor(0x034C,0x08);
-	write_cmos_sensor(0x034D,0x34);
-	write_cmos_sensor(0x034E,0x06);
-	write_cmos_sensor(0x034F,0x18);
-
-	write_cmos_sensor(0x0202,0x06);
-	write_cmos_sensor(0x0203,0x44);
-
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
+	table_write_cmos_sensor(imx258_slim_video_setting);
 
 	if(imx258_type == IMX258_HDR_TYPE)
 	{
@@ -11,6 +11,7 @@
 #include <linux/dma-mapping.h>
 #include <linux/module.h>
 #include <linux/seq_file.h>
+#include <linux/ktime.h>
 #include <sync_write.h>
 #include <linux/types.h>
 #include "kd_camera_hw.h"
@@ -226,6 +227,10 @@ SENSOR_FUNCTION_STRUCT *g_pInvokeSensorFunc[KDIMGSENSOR_MAX_INVOKE_DRIVERS] = {N
 /* static char g_invokeSensorNameStr[KDIMGSENSOR_MAX_INVOKE_DRIVERS][32] = {KDIMGSENSOR_NOSENSOR,KDIMGSENSOR_NOSENSOR}; */
 CAMERA_DUAL_CAMERA_SENSOR_ENUM g_invokeSocketIdx[KDIMGSENSOR_MAX_INVOKE_DRIVERS] = {DUAL_CAMERA_NONE_SENSOR, DUAL_CAMERA_NONE_SENSOR};
 char g_invokeSensorNameStr[KDIMGSENSOR_MAX_INVOKE_DRIVERS][32] = {KDIMGSENSOR_NOSENSOR, KDIMGSENSOR_NOSENSOR};
+/* power on + SensorOpen and last SensorControl latency, driver/camsensor_timing */
+static s64 g_sensorOpenUs[KDIMGSENSOR_MAX_INVOKE_DRIVERS];
+static s64 g_sensorCtrlUs[KDIMGSENSOR_MAX_INVOKE_DRIVERS];
+static MSDK_SCENARIO_ID_ENUM g_sensorCtrlScenario[KDIMGSENSOR_MAX_INVOKE_DRIVERS];
 /* static int g_SensorExistStatus[3]={0,0,0}; */
 static wait_queue_head_t kd_sensor_wait_queue;
 bool setExpGainDoneFlag = 0;
@@ -640,6 +645,61 @@ int iBurstWriteReg(u8 *pData, u32 bytes, u16 i2cId) {
     return  iBurstWriteReg_multi(pData, bytes, i2cId, bytes);
 }
 
+/*******************************************************************************
+* iTableWriteReg
+********************************************************************************/
+/*
+ * Write a table of {addr, data} pairs of a sensor with 16-bit addresses and
+ * 8-bit registers. A run of at least TABLE_BURST_MIN consecutive addresses
+ * goes out as one auto-increment write, the address followed by all the
+ * data bytes; the other registers are packed 3 bytes each into one DMA
+ * transfer of many messages. Table order is kept, so a mode table costs a
+ * few dozen I2C transfers instead of one per register.
+ */
+#define TABLE_BURST_MIN      4
+#define TABLE_SINGLE_LEN     (MAX_CMD_LEN / 3 * 3)
+int iTableWriteReg(const u16 *para, u32 len, u16 i2cId)
+{
+    u8 single[TABLE_SINGLE_LEN];
+    u8 burst[MAX_CMD_LEN];
+    u32 i = 0, k, run, nsingle = 0;
+    int ret = 0;
+
+    while (i + 1 < len) {
+    run = 1;
+    while (i + 2 * run + 1 < len && run < MAX_CMD_LEN - 2 &&
+           para[i + 2 * run] == (u16)(para[i] + run))
+        run++;
+
+    if (run >= TABLE_BURST_MIN) {
+        if (nsingle) {
+        ret |= iBurstWriteReg_multi(single, nsingle, i2cId, 3);
+        nsingle = 0;
+        }
+        burst[0] = (u8)(para[i] >> 8);
+        burst[1] = (u8)(para[i] & 0xFF);
+        for (k = 0; k < run; k++)
+        burst[2 + k] = (u8)para[i + 2 * k + 1];
+        ret |= iBurstWriteReg_multi(burst, run + 2, i2cId, run + 2);
+    } else {
+        for (k = 0; k < run; k++) {
+        single[nsingle++] = (u8)(para[i + 2 * k] >> 8);
+        single[nsingle++] = (u8)(para[i + 2 * k] & 0xFF);
+        single[nsingle++] = (u8)para[i + 2 * k + 1];
+        if (nsingle == TABLE_SINGLE_LEN) {
+            ret |= iBurstWriteReg_multi(single, nsingle, i2cId, 3);
+            nsingle = 0;
+        }
+        }
+    }
+    i += 2 * run;
+    }
+    if (nsingle)
+    ret |= iBurstWriteReg_multi(single, nsingle, i2cId, 3);
+
+    return ret ? -1 : 0;
+}
+
 
 /*******************************************************************************
 * iMultiWriteReg
@@ -731,6 +791,7 @@ kd_MultiSensorOpen(void)
 {
 MUINT32 ret = ERROR_NONE;
 MINT32 i = 0;
+ktime_t start;
 
     KD_MULTI_FUNCTION_ENTRY();
     /* from hear to tail */
@@ -739,6 +800,7 @@ MINT32 i = 0;
     for (i = (KDIMGSENSOR_MAX_INVOKE_DRIVERS-1); i >= KDIMGSENSOR_INVOKE_DRIVER_0; i--) {
     if (g_bEnableDriver[i] && g_pInvokeSensorFunc[i]) {
         if (0 != (g_CurrentSensorIdx & g_invokeSocketIdx[i])) {
+        start = ktime_get();
         /* turn on power */
         ret = kdCISModulePowerOn((CAMERA_DUAL_CAMERA_SENSOR_ENUM)g_invokeSocketIdx[i], (char *)g_invokeSensorNameStr[i], true, CAMERA_HW_DRVNAME1);
         if (ERROR_NONE != ret) {
@@ -787,6 +849,7 @@ MINT32 i = 0;
         PK_ERR("SensorOpen");
         return ret;
         }
+        g_sensorOpenUs[i] = ktime_us_delta(ktime_get(), start);
         /* set i2c slave ID */
         /* SensorOpen() will reset i2c slave ID */
         /* KD_SET_I2C_SLAVE_ID(i,g_invokeSocketIdx[i],IMGSENSOR_SET_I2C_ID_FORCE); */
@@ -928,6 +991,7 @@ MSDK_SENSOR_CONFIG_STRUCT *pSensorConfigData)
 {
     MUINT32 ret = ERROR_NONE;
     u32 i = 0;
+    ktime_t start;
     KD_MULTI_FUNCTION_ENTRY();
     for (i = KDIMGSENSOR_INVOKE_DRIVER_0; i < KDIMGSENSOR_MAX_INVOKE_DRIVERS; i++) {
     if (g_bEnableDriver[i] && g_pInvokeSensorFunc[i]) {
@@ -966,11 +1030,14 @@ MSDK_SENSOR_CONFIG_STRUCT *pSensorConfigData)
         g_pInvokeSensorFunc[i]->ScenarioId = ScenarioId;
         memcpy(&g_pInvokeSensorFunc[i]->imageWindow, pImageWindow, sizeof(ACDK_SENSOR_EXPOSURE_WINDOW_STRUCT));
         memcpy(&g_pInvokeSensorFunc[i]->sensorConfigData, pSensorConfigData, sizeof(ACDK_SENSOR_CONFIG_STRUCT));
+        start = ktime_get();
         ret = g_pInvokeSensorFunc[i]->SensorControl(ScenarioId, pImageWindow, pSensorConfigData);
         if (ERROR_NONE != ret) {
         PK_ERR("ERR:SensorControl(), i =%d\n", i);
         return ret;
         }
+        g_sensorCtrlUs[i] = ktime_us_delta(ktime_get(), start);
+        g_sensorCtrlScenario[i] = ScenarioId;
     }
     }
     }
@@ -4362,6 +4429,31 @@ static  struct file_operations fcamera_proc_fopsReturnId = {
     .read  = seq_read,
 };
 
+/* Sensor open and mode switch latency */
+static int subsys_camera_timing_read(struct seq_file *m, void *v)
+{
+    int i;
+
+    seq_printf(m, "%-32s %10s %8s %10s\n", "sensor", "open_us", "scenario", "ctrl_us");
+    for (i = KDIMGSENSOR_INVOKE_DRIVER_0; i < KDIMGSENSOR_MAX_INVOKE_DRIVERS; i++)
+        seq_printf(m, "%-32s %10lld %8d %10lld\n", g_invokeSensorNameStr[i],
+               g_sensorOpenUs[i], g_sensorCtrlScenario[i], g_sensorCtrlUs[i]);
+    return 0;
+};
+
+static int proc_camera_timing_open(struct inode *inode, struct file *file)
+{
+    return single_open(file, subsys_camera_timing_read, NULL);
+};
+
+static  struct file_operations fcamera_proc_fopsTiming = {
+    .owner = THIS_MODULE,
+    .open  = proc_camera_timing_open,
+    .read  = seq_read,
+    .llseek = seq_lseek,
+    .release = single_release,
+};
+
 /*=======================================================================
   * CAMERA_HW_i2C_init()
   *=======================================================================*/
@@ -4423,6 +4515,8 @@ static int __init CAMERA_HW_i2C_init(void)
     memset(mtk_cid_name,0,camera_info_size);
     proc_create("driver/camsensorid", 0, NULL, &fcamera_proc_fopsReturnId);
 
+    proc_create("driver/camsensor_timing", 0, NULL, &fcamera_proc_fopsTiming);
+
 #else
     /* Register proc file for main sensor register debug */
     prEntry = create_proc_entry("driver/camsensor", 0, NULL);
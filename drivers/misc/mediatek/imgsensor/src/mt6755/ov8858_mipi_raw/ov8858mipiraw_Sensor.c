@@ -222,6 +222,9 @@ static void write_cmos_sensor(kal_uint32 addr, kal_uint32 para)
 	iWriteRegI2C(pu_send_cmd, 3, imgsensor.i2c_write_id);
 }
 
+#define table_write_cmos_sensor(table) \
+	iTableWriteReg(table, ARRAY_SIZE(table), imgsensor.i2c_write_id)
+
 static void set_dummy(void)
 {
 	LOG_INF("dummyline = %d, dummypixels = %d \n", imgsensor.dummy_line, imgsensor.dummy_pixel);
@@ -528,6 +531,343 @@ static void night_mode(kal_bool enable)
 {
 /*No Need to implement this function*/
 }	/*	night_mode	*/
+static const kal_uint16 ov8858_init_setting[] = {
+	0x100, 0x00,
+	0x302, 0x1e,
+	0x303, 0x00,
+	0x304, 0x03,
+	0x30e, 0x02,
+	0x30f, 0x04,
+	0x312, 0x03,
+	0x31e, 0x0c,
+	0x3600, 0x00,
+	0x3601, 0x00,
+	0x3602, 0x00,
+	0x3603, 0x00,
+	0x3604, 0x22,
+	0x3605, 0x20,
+	0x3606, 0x00,
+	0x3607, 0x20,
+	0x3608, 0x11,
+	0x3609, 0x28,
+	0x360a, 0x00,
+	0x360b, 0x05,
+	0x360c, 0xd4,
+	0x360d, 0x40,
+	0x360e, 0x0c,
+	0x360f, 0x20,
+	0x3610, 0x07,
+	0x3611, 0x20,
+	0x3612, 0x88,
+	0x3613, 0x80,
+	0x3614, 0x58,
+	0x3615, 0x00,
+	0x3616, 0x4a,
+	0x3617, 0x40, //90
+	0x3618, 0x5a,
+	0x3619, 0x70,
+	0x361a, 0x99,
+	0x361b, 0x0a,
+	0x361c, 0x07,
+	0x361d, 0x00,
+	0x361e, 0x00,
+	0x361f, 0x00,
+	0x3638, 0xff,
+	0x3633, 0x0f,
+	0x3634, 0x0f,
+	0x3635, 0x0f,
+	0x3636, 0x12,
+	0x3645, 0x13,
+	0x3646, 0x83,
+	0x364a, 0x07,
+	0x3015, 0x00,
+	0x3018, 0x32, //32 : 2LANE , 72 : 4lane
+	0x3020, 0x93,
+	0x3022, 0x01,
+};
+
+static const kal_uint16 ov8858_init_setting2[] = {
+	0x3034, 0x00,
+	0x3106, 0x01,
+	0x3305, 0xf1,
+	0x3308, 0x00,
+	0x3309, 0x28,
+	0x330a, 0x00,
+	0x330b, 0x20,
+	0x330c, 0x00,
+	0x330d, 0x00,
+	0x330e, 0x00,
+	0x330f, 0x40,
+	0x3307, 0x04,
+	0x3500, 0x00,
+	0x3501, 0x4d,
+	0x3502, 0x40,
+	0x3503, 0x80,
+	0x3505, 0x80,
+	0x3508, 0x02,
+	0x3509, 0x00,
+	0x350c, 0x00,
+	0x350d, 0x80,
+	0x3510, 0x00,
+	0x3511, 0x02,
+	0x3512, 0x00,
+	0x3700, 0x18,
+	0x3701, 0x0c,
+	0x3702, 0x28,
+	0x3703, 0x19,
+	0x3704, 0x14,
+	0x3705, 0x00,
+	0x3706, 0x82,
+	0x3707, 0x04,
+	0x3708, 0x24,
+	0x3709, 0x33,
+	0x370a, 0x01,
+	0x370b, 0x82,
+	0x370c, 0x04,
+	0x3718, 0x12,
+	0x3719, 0x31,
+	0x3712, 0x42,
+	0x3714, 0x24,
+	0x371e, 0x19,
+	0x371f, 0x40,
+	0x3720, 0x05,
+	0x3721, 0x05,
+	0x3724, 0x06,
+	0x3725, 0x01,
+	0x3726, 0x06,
+	0x3728, 0x05,
+	0x3729, 0x02,
+	0x372a, 0x03,
+	0x372b, 0x53,
+	0x372c, 0xa3,
+	0x372d, 0x53,
+	0x372e, 0x06,
+	0x372f, 0x10,
+	0x3730, 0x01,
+	0x3731, 0x06,
+	0x3732, 0x14,
+	0x3733, 0x10,
+	0x3734, 0x40,
+	0x3736, 0x20,
+	0x373a, 0x05,
+	0x373b, 0x06,
+	0x373c, 0x0a,
+	0x373e, 0x03,
+	0x3750, 0x0a,
+	0x3751, 0x0e,
+	0x3755, 0x10,
+	0x3758, 0x00,
+	0x3759, 0x4c,
+	0x375a, 0x06,
+	0x375b, 0x13,
+	0x375c, 0x20,
+	0x375d, 0x02,
+	0x375e, 0x00,
+	0x375f, 0x14,
+	0x3768, 0x22,
+	0x3769, 0x44,
+	0x376a, 0x44,
+	0x3761, 0x00,
+	0x3762, 0x00,
+	0x3763, 0x00,
+	0x3766, 0xff,
+	0x376b, 0x00,
+	0x3772, 0x23,
+	0x3773, 0x02,
+	0x3774, 0x16,
+	0x3775, 0x12,
+	0x3776, 0x04,
+	0x3777, 0x00,
+	0x3778, 0x17,
+	0x37a0, 0x44,
+	0x37a1, 0x3d,
+	0x37a2, 0x3d,
+	0x37a3, 0x00,
+	0x37a4, 0x00,
+	0x37a5, 0x00,
+	0x37a6, 0x00,
+	0x37a7, 0x44,
+	0x37a8, 0x4c,
+	0x37a9, 0x4c,
+	0x3760, 0x00,
+	0x376f, 0x01,
+	0x37aa, 0x44,
+	0x37ab, 0x2e,
+	0x37ac, 0x2e,
+	0x37ad, 0x33,
+	0x37ae, 0x0d,
+	0x37af, 0x0d,
+	0x37b0, 0x00,
+	0x37b1, 0x00,
+	0x37b2, 0x00,
+	0x37b3, 0x42,
+	0x37b4, 0x42,
+	0x37b5, 0x31,
+	0x37b6, 0x00,
+	0x37b7, 0x00,
+	0x37b8, 0x00,
+	0x37b9, 0xff,
+	0x3800, 0x00,
+	0x3801, 0x0c,
+	0x3802, 0x00,
+	0x3803, 0x0c,
+	0x3804, 0x0c,
+	0x3805, 0xd3,
+	0x3806, 0x09,
+	0x3807, 0xa3,
+	0x3808, 0x06,
+	0x3809, 0x60,
+	0x380a, 0x04,
+	0x380b, 0xc8,
+	0x380c, 0x07,
+	0x380d, 0x88,
+	0x380e, 0x04,
+	0x380f, 0xdc,
+	0x3810, 0x00,
+	0x3811, 0x04,
+	0x3813, 0x02,
+	0x3814, 0x03,
+	0x3815, 0x01,
+	0x3820, 0x00, //mirror
+	0x3821, 0x67, //flip //0x67
+	0x382a, 0x03,
+	0x382b, 0x01,
+	0x3830, 0x08,
+	0x3836, 0x02,
+	0x3837, 0x18,
+	0x3841, 0xff,
+	0x3846, 0x48,
+	0x3d85, 0x16,
+	0x3d8c, 0x73,
+	0x3d8d, 0xde,
+	0x3f08, 0x08,
+	0x3f0a, 0x00,
+	0x4000, 0xf1,
+	0x4001, 0x10,
+	0x4005, 0x10,
+	0x4002, 0x27,
+	0x4009, 0x81,
+	0x400b, 0x0c,
+	0x4011, 0x20, //add
+	0x401b, 0x00,
+	0x401d, 0x00,
+	0x4020, 0x00,
+	0x4021, 0x04,
+	0x4022, 0x06,
+	0x4023, 0x00,
+	0x4024, 0x0f,
+	0x4025, 0x2a,
+	0x4026, 0x0f,
+	0x4027, 0x2b,
+	0x4028, 0x00,
+	0x4029, 0x02,
+	0x402a, 0x04,
+	0x402b, 0x04,
+	0x402c, 0x00,
+	0x402d, 0x02,
+	0x402e, 0x04,
+	0x402f, 0x04,
+	0x401f, 0x00,
+	0x4034, 0x3f,
+	0x403d, 0x04,
+	0x4300, 0xff,
+	0x4301, 0x00,
+	0x4302, 0x0f,
+	0x4316, 0x00,
+	0x4500, 0x58,
+	0x4503, 0x18,
+	0x4600, 0x00,
+	0x4601, 0xcb,
+
+	0x4800, 0x24, // MIPI line sync enable
+
+	0x481f, 0x32,
+	0x4837, 0x16,
+	0x4850, 0x10,
+	0x4851, 0x32,
+	0x4b00, 0x2a,
+	0x4b0d, 0x00,
+	0x4d00, 0x04,
+	0x4d01, 0x18,
+	0x4d02, 0xc3,
+	0x4d03, 0xff,
+	0x4d04, 0xff,
+	0x4d05, 0xff,
+	0x5000, 0x7e,
+	0x5001, 0x01,
+	0x5002, 0x08,
+	0x5003, 0x20,
+	0x5046, 0x12,
+	0x5780, 0x3e,
+	0x5781, 0x0f,
+	0x5782, 0x44,
+	0x5783, 0x02,
+	0x5784, 0x01,
+	0x5785, 0x00,
+	0x5786, 0x00,
+	0x5787, 0x04,
+	0x5788, 0x02,
+	0x5789, 0x0f,
+	0x578a, 0xfd,
+	0x578b, 0xf5,
+	0x578c, 0xf5,
+	0x578d, 0x03,
+	0x578e, 0x08,
+	0x578f, 0x0c,
+	0x5790, 0x08,
+	0x5791, 0x04,
+	0x5792, 0x00,
+	0x5793, 0x52,
+	0x5794, 0xa3,
+	0x5871, 0x0d,
+	0x5870, 0x18,
+	0x586e, 0x10,
+	0x586f, 0x08,
+	0x58f8, 0x3d, //add
+	0x5901, 0x00,
+	0x5b00, 0x02,
+	0x5b01, 0x10,
+	0x5b02, 0x03,
+	0x5b03, 0xcf,
+	0x5b05, 0x6c,
+	0x5e00, 0x00,
+	0x5e01, 0x41,
+	0x382d, 0x7f,
+	0x4825, 0x3a,
+	0x4826, 0x40,
+	0x4808, 0x25,
+	0x3763, 0x18,
+	0x3768, 0xcc,
+	0x470b, 0x28,
+	0x4202, 0x00,
+	0x400d, 0x10,
+	0x4040, 0x07, //04
+	0x403e, 0x08, //04
+	0x4041, 0xc6,
+	0x3007, 0x80,
+	0x400a, 0x01,
+};
+
+static const kal_uint16 ov8858_init_setting3[] = {
+	0x4009, 0x83,
+	0x4020, 0x00,
+	0x4021, 0x04,
+	0x4022, 0x04,
+	0x4023, 0xb9,
+	0x4024, 0x05,
+	0x4025, 0x2a,
+	0x4026, 0x05,
+	0x4027, 0x2b,
+	0x4028, 0x00,
+	0x4029, 0x02,
+	0x402a, 0x04,
+	0x402b, 0x04,
+	0x402c, 0x02,
+	0x402d, 0x02,
+	0x402e, 0x08,
+	0x402f, 0x02,
+};
+
 static void sensor_init(void)
 {
 	LOG_INF("E\n");
@@ -536,340 +876,15 @@ static void sensor_init(void)
 	//XVCLK=24Mhz, SCLK=72Mhz, MIPI 720Mbps, DACCLK=180Mhz
 	write_cmos_sensor(0x103 , 0x01);
 	mdelay(5);
-	write_cmos_sensor(0x100 , 0x00);
-	write_cmos_sensor(0x302 , 0x1e);
-	write_cmos_sensor(0x303 , 0x00);
-	write_cmos_sensor(0x304 , 0x03);
-	write_cmos_sensor(0x30e , 0x02);
-	write_cmos_sensor(0x30f , 0x04);
-	write_cmos_sensor(0x312 , 0x03);
-	write_cmos_sensor(0x31e , 0x0c);
-	write_cmos_sensor(0x3600, 0x00);
-	write_cmos_sensor(0x3601, 0x00);
-	write_cmos_sensor(0x3602, 0x00);
-	write_cmos_sensor(0x3603, 0x00);
-	write_cmos_sensor(0x3604, 0x22);
-	write_cmos_sensor(0x3605, 0x20);
-	write_cmos_sensor(0x3606, 0x00);
-	write_cmos_sensor(0x3607, 0x20);
-	write_cmos_sensor(0x3608, 0x11);
-	write_cmos_sensor(0x3609, 0x28);
-	write_cmos_sensor(0x360a, 0x00);
-	write_cmos_sensor(0x360b, 0x05);
-	write_cmos_sensor(0x360c, 0xd4);
-	write_cmos_sensor(0x360d, 0x40);
-	write_cmos_sensor(0x360e, 0x0c);
-	write_cmos_sensor(0x360f, 0x20);
-	write_cmos_sensor(0x3610, 0x07);
-	write_cmos_sensor(0x3611, 0x20);
-	write_cmos_sensor(0x3612, 0x88);
-	write_cmos_sensor(0x3613, 0x80);
-	write_cmos_sensor(0x3614, 0x58);
-	write_cmos_sensor(0x3615, 0x00);
-	write_cmos_sensor(0x3616, 0x4a);
-	write_cmos_sensor(0x3617, 0x40); //90
-	write_cmos_sensor(0x3618, 0x5a);
-	write_cmos_sensor(0x3619, 0x70);
-	write_cmos_sensor(0x361a, 0x99);
-	write_cmos_sensor(0x361b, 0x0a);
-	write_cmos_sensor(0x361c, 0x07);
-	write_cmos_sensor(0x361d, 0x00);
-	write_cmos_sensor(0x361e, 0x00);
-	write_cmos_sensor(0x361f, 0x00);
-	write_cmos_sensor(0x3638, 0xff);
-	write_cmos_sensor(0x3633, 0x0f);
-	write_cmos_sensor(0x3634, 0x0f);
-	write_cmos_sensor(0x3635, 0x0f);
-	write_cmos_sensor(0x3636, 0x12);
-	write_cmos_sensor(0x3645, 0x13);
-	write_cmos_sensor(0x3646, 0x83);
-	write_cmos_sensor(0x364a, 0x07);
-	write_cmos_sensor(0x3015, 0x00);
-	write_cmos_sensor(0x3018, 0x32); //32 : 2LANE , 72 : 4lane
-	write_cmos_sensor(0x3020, 0x93);
-	write_cmos_sensor(0x3022, 0x01);
+	table_write_cmos_sensor(ov8858_init_setting);
 if ( bm == FACTORY_BOOT || bm == ATE_FACTORY_BOOT ){
 		write_cmos_sensor(0x3031, 0x0a);
 }else {
 	write_cmos_sensor(0x3031, 0x08);
 }
-	write_cmos_sensor(0x3034, 0x00);
-	write_cmos_sensor(0x3106, 0x01);
-	write_cmos_sensor(0x3305, 0xf1);
-	write_cmos_sensor(0x3308, 0x00);
-	write_cmos_sensor(0x3309, 0x28);
-	write_cmos_sensor(0x330a, 0x00);
-	write_cmos_sensor(0x330b, 0x20);
-	write_cmos_sensor(0x330c, 0x00);
-	write_cmos_sensor(0x330d, 0x00);
-	write_cmos_sensor(0x330e, 0x00);
-	write_cmos_sensor(0x330f, 0x40);
-	write_cmos_sensor(0x3307, 0x04);
-	write_cmos_sensor(0x3500, 0x00);
-	write_cmos_sensor(0x3501, 0x4d);
-	write_cmos_sensor(0x3502, 0x40);
-	write_cmos_sensor(0x3503, 0x80);
-	write_cmos_sensor(0x3505, 0x80);
-	write_cmos_sensor(0x3508, 0x02);
-	write_cmos_sensor(0x3509, 0x00);
-	write_cmos_sensor(0x350c, 0x00);
-	write_cmos_sensor(0x350d, 0x80);
-	write_cmos_sensor(0x3510, 0x00);
-	write_cmos_sensor(0x3511, 0x02);
-	write_cmos_sensor(0x3512, 0x00);
-	write_cmos_sensor(0x3700, 0x18);
-	write_cmos_sensor(0x3701, 0x0c);
-	write_cmos_sensor(0x3702, 0x28);
-	write_cmos_sensor(0x3703, 0x19);
-	write_cmos_sensor(0x3704, 0x14);
-	write_cmos_sensor(0x3705, 0x00);
-	write_cmos_sensor(0x3706, 0x82);
-	write_cmos_sensor(0x3707, 0x04);
-	write_cmos_sensor(0x3708, 0x24);
-	write_cmos_sensor(0x3709, 0x33);
-	write_cmos_sensor(0x370a, 0x01);
-	write_cmos_sensor(0x370b, 0x82);
-	write_cmos_sensor(0x370c, 0x04);
-	write_cmos_sensor(0x3718, 0x12);
-	write_cmos_sensor(0x3719, 0x31);
-	write_cmos_sensor(0x3712, 0x42);
-	write_cmos_sensor(0x3714, 0x24);
-	write_cmos_sensor(0x371e, 0x19);
-	write_cmos_sensor(0x371f, 0x40);
-	write_cmos_sensor(0x3720, 0x05);
-	write_cmos_sensor(0x3721, 0x05);
-	write_cmos_sensor(0x3724, 0x06);
-	write_cmos_sensor(0x3725, 0x01);
-	write_cmos_sensor(0x3726, 0x06);
-	write_cmos_sensor(0x3728, 0x05);
-	write_cmos_sensor(0x3729, 0x02);
-	write_cmos_sensor(0x372a, 0x03);
-	write_cmos_sensor(0x372b, 0x53);
-	write_cmos_sensor(0x372c, 0xa3);
-	write_cmos_sensor(0x372d, 0x53);
-	write_cmos_sensor(0x372e, 0x06);
-	write_cmos_sensor(0x372f, 0x10);
-	write_cmos_sensor(0x3730, 0x01);
-	write_cmos_sensor(0x3731, 0x06);
-	write_cmos_sensor(0x3732, 0x14);
-	write_cmos_sensor(0x3733, 0x10);
-	write_cmos_sensor(0x3734, 0x40);
-	write_cmos_sensor(0x3736, 0x20);
-	write_cmos_sensor(0x373a, 0x05);
-	write_cmos_sensor(0x373b, 0x06);
-	write_cmos_sensor(0x373c, 0x0a);
-	write_cmos_sensor(0x373e, 0x03);
-	write_cmos_sensor(0x3750, 0x0a);
-	write_cmos_sensor(0x3751, 0x0e);
-	write_cmos_sensor(0x3755, 0x10);
-	write_cmos_sensor(0x3758, 0x00);
-	write_cmos_sensor(0x3759, 0x4c);
-	write_cmos_sensor(0x375a, 0x06);
-	write_cmos_sensor(0x375b, 0x13);
-	write_cmos_sensor(0x375c, 0x20);
-	write_cmos_sensor(0x375d, 0x02);
-	write_cmos_sensor(0x375e, 0x00);
-	write_cmos_sensor(0x375f, 0x14);
-	write_cmos_sensor(0x3768, 0x22);
-	write_cmos_sensor(0x3769, 0x44);
-	write_cmos_sensor(0x376a, 0x44);
-	write_cmos_sensor(0x3761, 0x00);
-	write_cmos_sensor(0x3762, 0x00);
-	write_cmos_sensor(0x3763, 0x00);
-	write_cmos_sensor(0x3766, 0xff);
-	write_cmos_sensor(0x376b, 0x00);
-	write_cmos_sensor(0x3772, 0x23);
-	write_cmos_sensor(0x3773, 0x02);
-	write_cmos_sensor(0x3774, 0x16);
-	write_cmos_sensor(0x3775, 0x12);
-	write_cmos_sensor(0x3776, 0x04);
-	write_cmos_sensor(0x3777, 0x00);
-	write_cmos_sensor(0x3778, 0x17);
-	write_cmos_sensor(0x37a0, 0x44);
-	write_cmos_sensor(0x37a1, 0x3d);
-	write_cmos_sensor(0x37a2, 0x3d);
-	write_cmos_sensor(0x37a3, 0x00);
-	write_cmos_sensor(0x37a4, 0x00);
-	write_cmos_sensor(0x37a5, 0x00);
-	write_cmos_sensor(0x37a6, 0x00);
-	write_cmos_sensor(0x37a7, 0x44);
-	write_cmos_sensor(0x37a8, 0x4c);
-	write_cmos_sensor(0x37a9, 0x4c);
-	write_cmos_sensor(0x3760, 0x00);
-	write_cmos_sensor(0x376f, 0x01);
-	write_cmos_sensor(0x37aa, 0x44);
-	write_cmos_sensor(0x37ab, 0x2e);
-	write_cmos_sensor(0x37ac, 0x2e);
-	write_cmos_sensor(0x37ad, 0x33);
-	write_cmos_sensor(0x37ae, 0x0d);
-	write_cmos_sensor(0x37af, 0x0d);
-	write_cmos_sensor(0x37b0, 0x00);
-	write_cmos_sensor(0x37b1, 0x00);
-	write_cmos_sensor(0x37b2, 0x00);
-	write_cmos_sensor(0x37b3, 0x42);
-	write_cmos_sensor(0x37b4, 0x42);
-	write_cmos_sensor(0x37b5, 0x31);
-	write_cmos_sensor(0x37b6, 0x00);
-	write_cmos_sensor(0x37b7, 0x00);
-	write_cmos_sensor(0x37b8, 0x00);
-	write_cmos_sensor(0x37b9, 0xff);
-	write_cmos_sensor(0x3800, 0x00);
-	write_cmos_sensor(0x3801, 0x0c);
-	write_cmos_sensor(0x3802, 0x00);
-	write_cmos_sensor(0x3803, 0x0c);
-	write_cmos_sensor(0x3804, 0x0c);
-	write_cmos_sensor(0x3805, 0xd3);
-	write_cmos_sensor(0x3806, 0x09);
-	write_cmos_sensor(0x3807, 0xa3);
-	write_cmos_sensor(0x3808, 0x06);
-	write_cmos_sensor(0x3809, 0x60);
-	write_cmos_sensor(0x380a, 0x04);
-	write_cmos_sensor(0x380b, 0xc8);
-	write_cmos_sensor(0x380c, 0x07);
-	write_cmos_sensor(0x380d, 0x88);
-	write_cmos_sensor(0x380e, 0x04);
-	write_cmos_sensor(0x380f, 0xdc);
-	write_cmos_sensor(0x3810, 0x00);
-	write_cmos_sensor(0x3811, 0x04);
-	write_cmos_sensor(0x3813, 0x02);
-	write_cmos_sensor(0x3814, 0x03);
-	write_cmos_sensor(0x3815, 0x01);
-	write_cmos_sensor(0x3820, 0x00); //mirror
-	write_cmos_sensor(0x3821, 0x67); //flip //0x67
-	write_cmos_sensor(0x382a, 0x03);
-	write_cmos_sensor(0x382b, 0x01);
-	write_cmos_sensor(0x3830, 0x08);
-	write_cmos_sensor(0x3836, 0x02);
-	write_cmos_sensor(0x3837, 0x18);
-	write_cmos_sensor(0x3841, 0xff);
-	write_cmos_sensor(0x3846, 0x48);
-	write_cmos_sensor(0x3d85, 0x16);
-	write_cmos_sensor(0x3d8c, 0x73);
-	write_cmos_sensor(0x3d8d, 0xde);
-	write_cmos_sensor(0x3f08, 0x08);
-	write_cmos_sensor(0x3f0a, 0x00);
-	write_cmos_sensor(0x4000, 0xf1);
-	write_cmos_sensor(0x4001, 0x10);
-	write_cmos_sensor(0x4005, 0x10);
-	write_cmos_sensor(0x4002, 0x27);
-	write_cmos_sensor(0x4009, 0x81);
-	write_cmos_sensor(0x400b, 0x0c);
-	write_cmos_sensor(0x4011, 0x20); //add
-	write_cmos_sensor(0x401b, 0x00);
-	write_cmos_sensor(0x401d, 0x00);
-	write_cmos_sensor(0x4020, 0x00);
-	write_cmos_sensor(0x4021, 0x04);
-	write_cmos_sensor(0x4022, 0x06);
-	write_cmos_sensor(0x4023, 0x00);
-	write_cmos_sensor(0x4024, 0x0f);
-	write_cmos_sensor(0x4025, 0x2a);
-	write_cmos_sensor(0x4026, 0x0f);
-	write_cmos_sensor(0x4027, 0x2b);
-	write_cmos_sensor(0x4028, 0x00);
-	write_cmos_sensor(0x4029, 0x02);
-	write_cmos_sensor(0x402a, 0x04);
-	write_cmos_sensor(0x402b, 0x04);
-	write_cmos_sensor(0x402c, 0x00);
-	write_cmos_sensor(0x402d, 0x02);
-	write_cmos_sensor(0x402e, 0x04);
-	write_cmos_sensor(0x402f, 0x04);
-	write_cmos_sensor(0x401f, 0x00);
-	write_cmos_sensor(0x4034, 0x3f);
-	write_cmos_sensor(0x403d, 0x04);
-	write_cmos_sensor(0x4300, 0xff);
-	write_cmos_sensor(0x4301, 0x00);
-	write_cmos_sensor(0x4302, 0x0f);
-	write_cmos_sensor(0x4316, 0x00);
-	write_cmos_sensor(0x4500, 0x58);
-	write_cmos_sensor(0x4503, 0x18);
-	write_cmos_sensor(0x4600, 0x00);
-	write_cmos_sensor(0x4601, 0xcb);
-
-	write_cmos_sensor(0x4800, 0x24); // MIPI line sync enable
-
-	write_cmos_sensor(0x481f, 0x32);
-	write_cmos_sensor(0x4837, 0x16);
-	write_cmos_sensor(0x4850, 0x10);
-	write_cmos_sensor(0x4851, 0x32);
-	write_cmos_sensor(0x4b00, 0x2a);
-	write_cmos_sensor(0x4b0d, 0x00);
-	write_cmos_sensor(0x4d00, 0x04);
-	write_cmos_sensor(0x4d01, 0x18);
-	write_cmos_sensor(0x4d02, 0xc3);
-	write_cmos_sensor(0x4d03, 0xff);
-	write_cmos_sensor(0x4d04, 0xff);
-	write_cmos_sensor(0x4d05, 0xff);
-	write_cmos_sensor(0x5000, 0x7e);
-	write_cmos_sensor(0x5001, 0x01);
-	write_cmos_sensor(0x5002, 0x08);
-	write_cmos_sensor(0x5003, 0x20);
-	write_cmos_sensor(0x5046, 0x12);
-	write_cmos_sensor(0x5780, 0x3e);
-	write_cmos_sensor(0x5781, 0x0f);
-	write_cmos_sensor(0x5782, 0x44);
-	write_cmos_sensor(0x5783, 0x02);
-	write_cmos_sensor(0x5784, 0x01);
-	write_cmos_sensor(0x5785, 0x00);
-	write_cmos_sensor(0x5786, 0x00);
-	write_cmos_sensor(0x5787, 0x04);
-	write_cmos_sensor(0x5788, 0x02);
-	write_cmos_sensor(0x5789, 0x0f);
-	write_cmos_sensor(0x578a, 0xfd);
-	write_cmos_sensor(0x578b, 0xf5);
-	write_cmos_sensor(0x578c, 0xf5);
-	write_cmos_sensor(0x578d, 0x03);
-	write_cmos_sensor(0x578e, 0x08);
-	write_cmos_sensor(0x578f, 0x0c);
-	write_cmos_sensor(0x5790, 0x08);
-	write_cmos_sensor(0x5791, 0x04);
-	write_cmos_sensor(0x5792, 0x00);
-	write_cmos_sensor(0x5793, 0x52);
-	write_cmos_sensor(0x5794, 0xa3);
-	write_cmos_sensor(0x5871, 0x0d);
-	write_cmos_sensor(0x5870, 0x18);
-	write_cmos_sensor(0x586e, 0x10);
-	write_cmos_sensor(0x586f, 0x08);
-	write_cmos_sensor(0x58f8, 0x3d); //add
-	write_cmos_sensor(0x5901, 0x00);
-	write_cmos_sensor(0x5b00, 0x02);
-	write_cmos_sensor(0x5b01, 0x10);
-	write_cmos_sensor(0x5b02, 0x03);
-	write_cmos_sensor(0x5b03, 0xcf);
-	write_cmos_sensor(0x5b05, 0x6c);
-	write_cmos_sensor(0x5e00, 0x00);
-	write_cmos_sensor(0x5e01, 0x41);
-	write_cmos_sensor(0x382d, 0x7f);
-	write_cmos_sensor(0x4825, 0x3a);
-	write_cmos_sensor(0x4826, 0x40);
-	write_cmos_sensor(0x4808, 0x25);
-	write_cmos_sensor(0x3763, 0x18);
-	write_cmos_sensor(0x3768, 0xcc);
-	write_cmos_sensor(0x470b, 0x28);
-	write_cmos_sensor(0x4202, 0x00);
-	write_cmos_sensor(0x400d, 0x10);
-	write_cmos_sensor(0x4040, 0x07); //04
-	write_cmos_sensor(0x403e, 0x08); //04
-	write_cmos_sensor(0x4041, 0xc6);
-	write_cmos_sensor(0x3007, 0x80);
-	write_cmos_sensor(0x400a, 0x01);
+	table_write_cmos_sensor(ov8858_init_setting2);
 	/*
-	write_cmos_sensor(0x4009, 0x83);
-	write_cmos_sensor(0x4020, 0x00);
-	write_cmos_sensor(0x4021, 0x04);
-	write_cmos_sensor(0x4022, 0x04);
-	write_cmos_sensor(0x4023, 0xb9);
-	write_cmos_sensor(0x4024, 0x05);
-	write_cmos_sensor(0x4025, 0x2a);
-	write_cmos_sensor(0x4026, 0x05);
-	write_cmos_sensor(0x4027, 0x2b);
-	write_cmos_sensor(0x4028, 0x00);
-	write_cmos_sensor(0x4029, 0x02);
-	write_cmos_sensor(0x402a, 0x04);
-	write_cmos_sensor(0x402b, 0x04);
-	write_cmos_sensor(0x402c, 0x02);
-	write_cmos_sensor(0x402d, 0x02);
-	write_cmos_sensor(0x402e, 0x08);
-	write_cmos_sensor(0x402f, 0x02);
+	table_write_cmos_sensor(ov8858_init_setting3);
 	*/
 //	write_cmos_sensor(0x100 , 0x01);
 
@@ -877,6 +892,109 @@ if ( bm == FACTORY_BOOT || bm == ATE_FACTORY_BOOT ){
 }	/*	sensor_init  */
 
 
+static const kal_uint16 ov8858_preview_setting[] = {
+	0x0302, 0x1e,
+	0x030e, 0x00,
+	0x0312, 0x01,
+	0x3015, 0x01,
+	0x3501, 0x4d,
+	0x3502, 0x40,
+	0x3700, 0x30,
+	0x3701, 0x18,
+	0x3702, 0x50,
+	0x3703, 0x32,
+	0x3704, 0x28,
+	0x3707, 0x08,
+	0x3708, 0x48,
+	0x3709, 0x66,
+	0x370c, 0x07,
+	0x3718, 0x14,
+	0x3712, 0x44,
+	0x371e, 0x31,
+	0x371f, 0x7f,
+	0x3720, 0x0a,
+	0x3721, 0x0a,
+	0x3724, 0x0c,
+	0x3725, 0x02,
+	0x3726, 0x0c,
+	0x3728, 0x0a,
+	0x3729, 0x03,
+	0x372a, 0x06,
+	0x372b, 0xa6,
+	0x372c, 0xa6,
+	0x372d, 0xa6,
+	0x372e, 0x0c,
+	0x372f, 0x20,
+	0x3730, 0x02,
+	0x3731, 0x0c,
+	0x3732, 0x28,
+	0x3736, 0x30,
+	0x373a, 0x0a,
+	0x373b, 0x0b,
+	0x373c, 0x14,
+	0x373e, 0x06,
+	0x375a, 0x0c,
+	0x375b, 0x26,
+	0x375d, 0x04,
+	0x375f, 0x28,
+	0x3768, 0xcc,
+	0x3769, 0x44,
+	0x376a, 0x44,
+	0x3772, 0x46,
+	0x3773, 0x04,
+	0x3774, 0x2c,
+	0x3775, 0x13,
+	0x3776, 0x08,
+	0x3778, 0x17,
+	0x37a0, 0x88,
+	0x37a1, 0x7a,
+	0x37a2, 0x7a,
+	0x37a7, 0x88,
+	0x37a8, 0x98,
+	0x37a9, 0x98,
+	0x37aa, 0x88,
+	0x37ab, 0x5c,
+	0x37ac, 0x5c,
+	0x37ad, 0x55,
+	0x37ae, 0x19,
+	0x37af, 0x19,
+	0x37b3, 0x84,
+	0x37b4, 0x84,
+	0x37b5, 0x60,
+	0x3808, 0x06,
+	0x3809, 0x60,
+	0x380a, 0x04,
+	0x380b, 0xc8,
+	0x380c, 0x07,
+	0x380d, 0x88,
+	0x380e, 0x09,
+	0x380f, 0xb8,
+	0x3814, 0x03,
+	0x3821, 0x67,
+	0x382a, 0x03,
+	0x382b, 0x01,
+	0x3830, 0x08,
+	0x3836, 0x02,
+	0x3f08, 0x10,
+	0x4001, 0x10,
+	0x4022, 0x06,
+	0x4023, 0x00,
+	0x4025, 0x2a,
+	0x4027, 0x2b,
+	0x402a, 0x04,
+	0x402b, 0x04,
+	0x402e, 0x04,
+	0x402f, 0x04,
+	0x4600, 0x00,
+	0x4601, 0xcb,
+	0x4837, 0x16,
+	0x5901, 0x00,
+	0x382d, 0x7f,
+	0x3031, 0x08, /* 8 bits */
+	0x4316, 0x00, /* DPCM off */
+	0x0100, 0x01,
+};
+
 static void preview_setting(void)
 {
 	LOG_INF("E\n");
@@ -885,110 +1003,318 @@ static void preview_setting(void)
 //;XVCLK=24Mhz, SCLK=72Mhz, MIPI 720Mbps, DACCLK=180Mhz, Tline = 8.925926us
 	write_cmos_sensor(0x0100, 0x00);
 	mdelay(5);
-	write_cmos_sensor(0x0302, 0x1e);
-	write_cmos_sensor(0x030e, 0x00);
-	write_cmos_sensor(0x0312, 0x01);
-	write_cmos_sensor(0x3015, 0x01);
-	write_cmos_sensor(0x3501, 0x4d);
-	write_cmos_sensor(0x3502, 0x40);
-	write_cmos_sensor(0x3700, 0x30);
-	write_cmos_sensor(0x3701, 0x18);
-	write_cmos_sensor(0x3702, 0x50);
-	write_cmos_sensor(0x3703, 0x32);
-	write_cmos_sensor(0x3704, 0x28);
-	write_cmos_sensor(0x3707, 0x08);
-	write_cmos_sensor(0x3708, 0x48);
-	write_cmos_sensor(0x3709, 0x66);
-	write_cmos_sensor(0x370c, 0x07);
-	write_cmos_sensor(0x3718, 0x14);
-	write_cmos_sensor(0x3712, 0x44);
-	write_cmos_sensor(0x371e, 0x31);
-	write_cmos_sensor(0x371f, 0x7f);
-	write_cmos_sensor(0x3720, 0x0a);
-	write_cmos_sensor(0x3721, 0x0a);
-	write_cmos_sensor(0x3724, 0x0c);
-	write_cmos_sensor(0x3725, 0x02);
-	write_cmos_sensor(0x3726, 0x0c);
-	write_cmos_sensor(0x3728, 0x0a);
-	write_cmos_sensor(0x3729, 0x03);
-	write_cmos_sensor(0x372a, 0x06);
-	write_cmos_sensor(0x372b, 0xa6);
-	write_cmos_sensor(0x372c, 0xa6);
-	write_cmos_sensor(0x372d, 0xa6);
-	write_cmos_sensor(0x372e, 0x0c);
-	write_cmos_sensor(0x372f, 0x20);
-	write_cmos_sensor(0x3730, 0x02);
-	write_cmos_sensor(0x3731, 0x0c);
-	write_cmos_sensor(0x3732, 0x28);
-	write_cmos_sensor(0x3736, 0x30);
-	write_cmos_sensor(0x373a, 0x0a);
-	write_cmos_sensor(0x373b, 0x0b);
-	write_cmos_sensor(0x373c, 0x14);
-	write_cmos_sensor(0x373e, 0x06);
-	write_cmos_sensor(0x375a, 0x0c);
-	write_cmos_sensor(0x375b, 0x26);
-	write_cmos_sensor(0x375d, 0x04);
-	write_cmos_sensor(0x375f, 0x28);
-	write_cmos_sensor(0x3768, 0xcc);
-	write_cmos_sensor(0x3769, 0x44);
-	write_cmos_sensor(0x376a, 0x44);
-	write_cmos_sensor(0x3772, 0x46);
-	write_cmos_sensor(0x3773, 0x04);
-	write_cmos_sensor(0x3774, 0x2c);
-	write_cmos_sensor(0x3775, 0x13);
-	write_cmos_sensor(0x3776, 0x08);
-	write_cmos_sensor(0x3778, 0x17);
-	write_cmos_sensor(0x37a0, 0x88);
-	write_cmos_sensor(0x37a1, 0x7a);
-	write_cmos_sensor(0x37a2, 0x7a);
-	write_cmos_sensor(0x37a7, 0x88);
-	write_cmos_sensor(0x37a8, 0x98);
-	write_cmos_sensor(0x37a9, 0x98);
-	write_cmos_sensor(0x37aa, 0x88);
-	write_cmos_sensor(0x37ab, 0x5c);
-	write_cmos_sensor(0x37ac, 0x5c);
-	write_cmos_sensor(0x37ad, 0x55);
-	write_cmos_sensor(0x37ae, 0x19);
-	write_cmos_sensor(0x37af, 0x19);
-	write_cmos_sensor(0x37b3, 0x84);
-	write_cmos_sensor(0x37b4, 0x84);
-	write_cmos_sensor(0x37b5, 0x60);
-	write_cmos_sensor(0x3808, 0x06);
-	write_cmos_sensor(0x3809, 0x60);
-	write_cmos_sensor(0x380a, 0x04);
-	write_cmos_sensor(0x380b, 0xc8);
-	write_cmos_sensor(0x380c, 0x07);
-	write_cmos_sensor(0x380d, 0x88);
-	write_cmos_sensor(0x380e, 0x09);
-	write_cmos_sensor(0x380f, 0xb8);
-	write_cmos_sensor(0x3814, 0x03);
-	write_cmos_sensor(0x3821, 0x67);
-	write_cmos_sensor(0x382a, 0x03);
-	write_cmos_sensor(0x382b, 0x01);
-	write_cmos_sensor(0x3830, 0x08);
-	write_cmos_sensor(0x3836, 0x02);
-	write_cmos_sensor(0x3f08, 0x10);
-	write_cmos_sensor(0x4001, 0x10);
-	write_cmos_sensor(0x4022, 0x06);
-	write_cmos_sensor(0x4023, 0x00);
-	write_cmos_sensor(0x4025, 0x2a);
-	write_cmos_sensor(0x4027, 0x2b);
-	write_cmos_sensor(0x402a, 0x04);
-	write_cmos_sensor(0x402b, 0x04);
-	write_cmos_sensor(0x402e, 0x04);
-	write_cmos_sensor(0x402f, 0x04);
-	write_cmos_sensor(0x4600, 0x00);
-	write_cmos_sensor(0x4601, 0xcb);
-	write_cmos_sensor(0x4837, 0x16);
-	write_cmos_sensor(0x5901, 0x00);
-	write_cmos_sensor(0x382d, 0x7f);
-	write_cmos_sensor(0x3031, 0x08);/* 8 bits */
-	write_cmos_sensor(0x4316, 0x00);/* DPCM off */
-	write_cmos_sensor(0x0100, 0x01);
+	table_write_cmos_sensor(ov8858_preview_setting);
 	mdelay(10);
 
 }	/*	preview_setting  */
 
+static const kal_uint16 ov8858_capture_setting[] = {
+	0x0100, 0x00,
+	0x0302, 0x2e,
+	0x030e, 0x00,
+	0x0312, 0x01,
+	0x3015, 0x01,
+	0x3501, 0x9a,
+	0x3502, 0x20,
+	0x3700, 0x30,
+	0x3701, 0x18,
+	0x3702, 0x50,
+	0x3703, 0x32,
+	0x3704, 0x28,
+	0x3707, 0x08,
+	0x3708, 0x48,
+	0x3709, 0x66,
+	0x370c, 0x07,
+	0x3718, 0x14,
+	0x3712, 0x44,
+	0x371e, 0x31,
+	0x371f, 0x7f,
+	0x3720, 0x0a,
+	0x3721, 0x0a,
+	0x3724, 0x0c,
+	0x3725, 0x02,
+	0x3726, 0x0c,
+	0x3728, 0x0a,
+	0x3729, 0x03,
+	0x372a, 0x06,
+	0x372b, 0xa6,
+	0x372c, 0xa6,
+	0x372d, 0xa6,
+	0x372e, 0x0c,
+	0x372f, 0x20,
+	0x3730, 0x02,
+	0x3731, 0x0c,
+	0x3732, 0x28,
+	0x3736, 0x30,
+	0x373a, 0x0a,
+	0x373b, 0x0b,
+	0x373c, 0x14,
+	0x373e, 0x06,
+	0x375a, 0x0c,
+	0x375b, 0x26,
+	0x375d, 0x04,
+	0x375f, 0x28,
+	0x3768, 0xcc,
+	0x3769, 0x44,
+	0x376a, 0x44,
+	0x3772, 0x46,
+	0x3773, 0x04,
+	0x3774, 0x2c,
+	0x3775, 0x13,
+	0x3776, 0x08,
+	0x3778, 0x17,
+	0x37a0, 0x88,
+	0x37a1, 0x7a,
+	0x37a2, 0x7a,
+	0x37a7, 0x88,
+	0x37a8, 0x98,
+	0x37a9, 0x98,
+	0x37aa, 0x88,
+	0x37ab, 0x5c,
+	0x37ac, 0x5c,
+	0x37ad, 0x55,
+	0x37ae, 0x19,
+	0x37af, 0x19,
+	0x37b3, 0x84,
+	0x37b4, 0x84,
+	0x37b5, 0x60,
+	0x3808, 0x0c,
+	0x3809, 0xc0,
+	0x380a, 0x09,
+	0x380b, 0x90,
+	0x380c, 0x07,
+	0x380d, 0xa4,
+	0x380e, 0x09,
+	0x380f, 0xe2,
+	0x3814, 0x01,
+	0x3821, 0x46,
+	0x382a, 0x01,
+	0x382b, 0x01,
+	0x3830, 0x06,
+	0x3836, 0x01,
+	0x3f08, 0x10,
+	0x4001, 0x00,
+	0x4022, 0x0c,
+	0x4023, 0x60,
+	0x4025, 0x36,
+	0x4027, 0x37,
+	0x402a, 0x04,
+	0x402b, 0x08,
+	0x402e, 0x04,
+	0x402f, 0x08,
+	0x4600, 0x01,
+	0x4601, 0x97,
+	0x4837, 0x0e,
+	0x5901, 0x00,
+	0x382d, 0xff,
+	0x3031, 0x08,
+};
+
+static const kal_uint16 ov8858_capture_setting2[] = {
+	0x0302, 0x1e,
+	0x030e, 0x02,
+	0x0312, 0x03,
+	0x3015, 0x00,
+	0x3501, 0x9a,
+	0x3502, 0x20,
+	0x3700, 0x18,
+	0x3701, 0x0c,
+	0x3702, 0x28,
+	0x3703, 0x19,
+	0x3704, 0x14,
+	0x3707, 0x04,
+	0x3708, 0x24,
+	0x3709, 0x33,
+	0x370c, 0x04,
+	0x3718, 0x12,
+	0x3712, 0x42,
+	0x371e, 0x19,
+	0x371f, 0x40,
+	0x3720, 0x05,
+	0x3721, 0x05,
+	0x3724, 0x06,
+	0x3725, 0x01,
+	0x3726, 0x06,
+	0x3728, 0x05,
+	0x3729, 0x02,
+	0x372a, 0x03,
+	0x372b, 0x53,
+	0x372c, 0xa3,
+	0x372d, 0x53,
+	0x372e, 0x06,
+	0x372f, 0x10,
+	0x3730, 0x01,
+	0x3731, 0x06,
+	0x3732, 0x14,
+	0x3736, 0x20,
+	0x373a, 0x05,
+	0x373b, 0x06,
+	0x373c, 0x0a,
+	0x373e, 0x03,
+	0x375a, 0x06,
+	0x375b, 0x13,
+	0x375d, 0x02,
+	0x375f, 0x14,
+	0x3768, 0xcc,
+	0x3769, 0x44,
+	0x376a, 0x44,
+	0x3772, 0x23,
+	0x3773, 0x02,
+	0x3774, 0x16,
+	0x3775, 0x12,
+	0x3776, 0x04,
+	0x3778, 0x1a,
+	0x37a0, 0x44,
+	0x37a1, 0x3d,
+	0x37a2, 0x3d,
+	0x37a7, 0x44,
+	0x37a8, 0x4c,
+	0x37a9, 0x4c,
+	0x37aa, 0x44,
+	0x37ab, 0x2e,
+	0x37ac, 0x2e,
+	0x37ad, 0x33,
+	0x37ae, 0x0d,
+	0x37af, 0x0d,
+	0x37b3, 0x42,
+	0x37b4, 0x42,
+	0x37b5, 0x31,
+	0x3808, 0x0c,
+	0x3809, 0xc0,
+	0x380a, 0x09,
+	0x380b, 0x90,
+	0x380c, 0x07,
+	0x380d, 0x94,
+	0x380e, 0x09,
+	0x380f, 0xaa,
+	0x3814, 0x01,
+	0x3821, 0x46,
+	0x382a, 0x01,
+	0x382b, 0x01,
+	0x3830, 0x06,
+	0x3836, 0x01,
+	0x3f08, 0x08,
+	0x4001, 0x00,
+	0x4022, 0x0c,
+	0x4023, 0x60,
+	0x4025, 0x36,
+	0x4027, 0x37,
+	0x402a, 0x04,
+	0x402b, 0x08,
+	0x402e, 0x04,
+	0x402f, 0x08,
+	0x4600, 0x01,
+	0x4601, 0x97,
+	0x4837, 0x10,
+	0x5901, 0x00,
+	0x382d, 0xff,
+
+	0x3031, 0x08,
+};
+
+static const kal_uint16 ov8858_capture_setting3[] = {
+	0x0100, 0x00,
+	0x0302, 0x2e,
+	0x030e, 0x00,
+	0x0312, 0x01,
+	0x3015, 0x01,
+	0x3501, 0x9a,
+	0x3502, 0x20,
+	0x3700, 0x30,
+	0x3701, 0x18,
+	0x3702, 0x50,
+	0x3703, 0x32,
+	0x3704, 0x28,
+	0x3707, 0x08,
+	0x3708, 0x48,
+	0x3709, 0x66,
+	0x370c, 0x07,
+	0x3718, 0x14,
+	0x3712, 0x44,
+	0x371e, 0x31,
+	0x371f, 0x7f,
+	0x3720, 0x0a,
+	0x3721, 0x0a,
+	0x3724, 0x0c,
+	0x3725, 0x02,
+	0x3726, 0x0c,
+	0x3728, 0x0a,
+	0x3729, 0x03,
+	0x372a, 0x06,
+	0x372b, 0xa6,
+	0x372c, 0xa6,
+	0x372d, 0xa6,
+	0x372e, 0x0c,
+	0x372f, 0x20,
+	0x3730, 0x02,
+	0x3731, 0x0c,
+	0x3732, 0x28,
+	0x3736, 0x30,
+	0x373a, 0x0a,
+	0x373b, 0x0b,
+	0x373c, 0x14,
+	0x373e, 0x06,
+	0x375a, 0x0c,
+	0x375b, 0x26,
+	0x375d, 0x04,
+	0x375f, 0x28,
+	0x3768, 0xcc,
+	0x3769, 0x44,
+	0x376a, 0x44,
+	0x3772, 0x46,
+	0x3773, 0x04,
+	0x3774, 0x2c,
+	0x3775, 0x13,
+	0x3776, 0x08,
+	0x3778, 0x17,
+	0x37a0, 0x88,
+	0x37a1, 0x7a,
+	0x37a2, 0x7a,
+	0x37a7, 0x88,
+	0x37a8, 0x98,
+	0x37a9, 0x98,
+	0x37aa, 0x88,
+	0x37ab, 0x5c,
+	0x37ac, 0x5c,
+	0x37ad, 0x55,
+	0x37ae, 0x19,
+	0x37af, 0x19,
+	0x37b3, 0x84,
+	0x37b4, 0x84,
+	0x37b5, 0x60,
+	0x3808, 0x0c,
+	0x3809, 0xc0,
+	0x380a, 0x09,
+	0x380b, 0x90,
+	0x380c, 0x09,
+	0x380d, 0x28,
+	0x380e, 0x09,
+	0x380f, 0xfc,
+	0x3814, 0x01,
+	0x3821, 0x46,
+	0x382a, 0x01,
+	0x382b, 0x01,
+	0x3830, 0x06,
+	0x3836, 0x01,
+	0x3f08, 0x10,
+	0x4001, 0x00,
+	0x4022, 0x0c,
+	0x4023, 0x60,
+	0x4025, 0x36,
+	0x4027, 0x37,
+	0x402a, 0x04,
+	0x402b, 0x08,
+	0x402e, 0x04,
+	0x402f, 0x08,
+	0x4600, 0x01,
+	0x4601, 0x97,
+	0x4837, 0x0d,
+	0x5901, 0x00,
+	0x382d, 0xff,
+
+	0x3031, 0x08,
+};
+
 static void capture_setting(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
@@ -998,105 +1324,7 @@ static void capture_setting(kal_uint16 currefps)
 //;;MIPI=1.25Gbps/lane, SysClk=144Mhz,Dac Clock=360Mhz
 //;;1940x2556x30
 //100 99 3264 2448 ; Resolution
-    write_cmos_sensor(0x0100, 0x00);
-    write_cmos_sensor(0x0302, 0x2e);
-    write_cmos_sensor(0x030e, 0x00);
-    write_cmos_sensor(0x0312, 0x01);
-    write_cmos_sensor(0x3015, 0x01);
-    write_cmos_sensor(0x3501, 0x9a);
-    write_cmos_sensor(0x3502, 0x20);
-    write_cmos_sensor(0x3700, 0x30);
-    write_cmos_sensor(0x3701, 0x18);
-    write_cmos_sensor(0x3702, 0x50);
-    write_cmos_sensor(0x3703, 0x32);
-    write_cmos_sensor(0x3704, 0x28);
-    write_cmos_sensor(0x3707, 0x08);
-    write_cmos_sensor(0x3708, 0x48);
-    write_cmos_sensor(0x3709, 0x66);
-    write_cmos_sensor(0x370c, 0x07);
-    write_cmos_sensor(0x3718, 0x14);
-    write_cmos_sensor(0x3712, 0x44);
-    write_cmos_sensor(0x371e, 0x31);
-    write_cmos_sensor(0x371f, 0x7f);
-    write_cmos_sensor(0x3720, 0x0a);
-    write_cmos_sensor(0x3721, 0x0a);
-    write_cmos_sensor(0x3724, 0x0c);
-    write_cmos_sensor(0x3725, 0x02);
-    write_cmos_sensor(0x3726, 0x0c);
-    write_cmos_sensor(0x3728, 0x0a);
-    write_cmos_sensor(0x3729, 0x03);
-    write_cmos_sensor(0x372a, 0x06);
-    write_cmos_sensor(0x372b, 0xa6);
-    write_cmos_sensor(0x372c, 0xa6);
-    write_cmos_sensor(0x372d, 0xa6);
-    write_cmos_sensor(0x372e, 0x0c);
-    write_cmos_sensor(0x372f, 0x20);
-    write_cmos_sensor(0x3730, 0x02);
-    write_cmos_sensor(0x3731, 0x0c);
-    write_cmos_sensor(0x3732, 0x28);
-    write_cmos_sensor(0x3736, 0x30);
-    write_cmos_sensor(0x373a, 0x0a);
-    write_cmos_sensor(0x373b, 0x0b);
-    write_cmos_sensor(0x373c, 0x14);
-    write_cmos_sensor(0x373e, 0x06);
-    write_cmos_sensor(0x375a, 0x0c);
-    write_cmos_sensor(0x375b, 0x26);
-    write_cmos_sensor(0x375d, 0x04);
-    write_cmos_sensor(0x375f, 0x28);
-    write_cmos_sensor(0x3768, 0xcc);
-    write_cmos_sensor(0x3769, 0x44);
-    write_cmos_sensor(0x376a, 0x44);
-    write_cmos_sensor(0x3772, 0x46);
-    write_cmos_sensor(0x3773, 0x04);
-    write_cmos_sensor(0x3774, 0x2c);
-    write_cmos_sensor(0x3775, 0x13);
-    write_cmos_sensor(0x3776, 0x08);
-    write_cmos_sensor(0x3778, 0x17);
-    write_cmos_sensor(0x37a0, 0x88);
-    write_cmos_sensor(0x37a1, 0x7a);
-    write_cmos_sensor(0x37a2, 0x7a);
-    write_cmos_sensor(0x37a7, 0x88);
-    write_cmos_sensor(0x37a8, 0x98);
-    write_cmos_sensor(0x37a9, 0x98);
-    write_cmos_sensor(0x37aa, 0x88);
-    write_cmos_sensor(0x37ab, 0x5c);
-    write_cmos_sensor(0x37ac, 0x5c);
-    write_cmos_sensor(0x37ad, 0x55);
-    write_cmos_sensor(0x37ae, 0x19);
-    write_cmos_sensor(0x37af, 0x19);
-    write_cmos_sensor(0x37b3, 0x84);
-    write_cmos_sensor(0x37b4, 0x84);
-    write_cmos_sensor(0x37b5, 0x60);
-    write_cmos_sensor(0x3808, 0x0c);
-    write_cmos_sensor(0x3809, 0xc0);
-    write_cmos_sensor(0x380a, 0x09);
-    write_cmos_sensor(0x380b, 0x90);
-    write_cmos_sensor(0x380c, 0x07);
-    write_cmos_sensor(0x380d, 0xa4);
-    write_cmos_sensor(0x380e, 0x09);
-	write_cmos_sensor(0x380f, 0xe2);
-    write_cmos_sensor(0x3814, 0x01);
-    write_cmos_sensor(0x3821, 0x46);
-    write_cmos_sensor(0x382a, 0x01);
-    write_cmos_sensor(0x382b, 0x01);
-    write_cmos_sensor(0x3830, 0x06);
-    write_cmos_sensor(0x3836, 0x01);
-    write_cmos_sensor(0x3f08, 0x10);
-    write_cmos_sensor(0x4001, 0x00);
-    write_cmos_sensor(0x4022, 0x0c);
-    write_cmos_sensor(0x4023, 0x60);
-    write_cmos_sensor(0x4025, 0x36);
-    write_cmos_sensor(0x4027, 0x37);
-    write_cmos_sensor(0x402a, 0x04);
-    write_cmos_sensor(0x402b, 0x08);
-    write_cmos_sensor(0x402e, 0x04);
-    write_cmos_sensor(0x402f, 0x08);
-    write_cmos_sensor(0x4600, 0x01);
-    write_cmos_sensor(0x4601, 0x97);
-    write_cmos_sensor(0x4837, 0x0e);
-    write_cmos_sensor(0x5901, 0x00);
-    write_cmos_sensor(0x382d, 0xff);
-    write_cmos_sensor(0x3031, 0x08);
+    table_write_cmos_sensor(ov8858_capture_setting);
 	if ( bm == FACTORY_BOOT || bm == ATE_FACTORY_BOOT )
 		write_cmos_sensor(0x4316, 0x01);//DPCM
 	else
@@ -1112,105 +1340,7 @@ static void capture_setting(kal_uint16 currefps)
 
   write_cmos_sensor(0x0100, 0x00);
 	mdelay(5);  //PLEASE test and remove it; Pengtao
-  write_cmos_sensor(0x0302, 0x1e);
-  write_cmos_sensor(0x030e, 0x02);
-  write_cmos_sensor(0x0312, 0x03);
-  write_cmos_sensor(0x3015, 0x00);
-  write_cmos_sensor(0x3501, 0x9a);
-  write_cmos_sensor(0x3502, 0x20);
-  write_cmos_sensor(0x3700, 0x18);
-  write_cmos_sensor(0x3701, 0x0c);
-  write_cmos_sensor(0x3702, 0x28);
-  write_cmos_sensor(0x3703, 0x19);
-  write_cmos_sensor(0x3704, 0x14);
-  write_cmos_sensor(0x3707, 0x04);
-  write_cmos_sensor(0x3708, 0x24);
-  write_cmos_sensor(0x3709, 0x33);
-  write_cmos_sensor(0x370c, 0x04);
-  write_cmos_sensor(0x3718, 0x12);
-  write_cmos_sensor(0x3712, 0x42);
-  write_cmos_sensor(0x371e, 0x19);
-  write_cmos_sensor(0x371f, 0x40);
-  write_cmos_sensor(0x3720, 0x05);
-  write_cmos_sensor(0x3721, 0x05);
-  write_cmos_sensor(0x3724, 0x06);
-  write_cmos_sensor(0x3725, 0x01);
-  write_cmos_sensor(0x3726, 0x06);
-  write_cmos_sensor(0x3728, 0x05);
-  write_cmos_sensor(0x3729, 0x02);
-  write_cmos_sensor(0x372a, 0x03);
-  write_cmos_sensor(0x372b, 0x53);
-  write_cmos_sensor(0x372c, 0xa3);
-  write_cmos_sensor(0x372d, 0x53);
-  write_cmos_sensor(0x372e, 0x06);
-  write_cmos_sensor(0x372f, 0x10);
-  write_cmos_sensor(0x3730, 0x01);
-  write_cmos_sensor(0x3731, 0x06);
-  write_cmos_sensor(0x3732, 0x14);
-  write_cmos_sensor(0x3736, 0x20);
-  write_cmos_sensor(0x373a, 0x05);
-  write_cmos_sensor(0x373b, 0x06);
-  write_cmos_sensor(0x373c, 0x0a);
-  write_cmos_sensor(0x373e, 0x03);
-  write_cmos_sensor(0x375a, 0x06);
-  write_cmos_sensor(0x375b, 0x13);
-  write_cmos_sensor(0x375d, 0x02);
-  write_cmos_sensor(0x375f, 0x14);
-  write_cmos_sensor(0x3768, 0xcc);
-  write_cmos_sensor(0x3769, 0x44);
-  write_cmos_sensor(0x376a, 0x44);
-  write_cmos_sensor(0x3772, 0x23);
-  write_cmos_sensor(0x3773, 0x02);
-  write_cmos_sensor(0x3774, 0x16);
-  write_cmos_sensor(0x3775, 0x12);
-  write_cmos_sensor(0x3776, 0x04);
-  write_cmos_sensor(0x3778, 0x1a);
-  write_cmos_sensor(0x37a0, 0x44);
-  write_cmos_sensor(0x37a1, 0x3d);
-  write_cmos_sensor(0x37a2, 0x3d);
-  write_cmos_sensor(0x37a7, 0x44);
-  write_cmos_sensor(0x37a8, 0x4c);
-  write_cmos_sensor(0x37a9, 0x4c);
-  write_cmos_sensor(0x37aa, 0x44);
-  write_cmos_sensor(0x37ab, 0x2e);
-  write_cmos_sensor(0x37ac, 0x2e);
-  write_cmos_sensor(0x37ad, 0x33);
-  write_cmos_sensor(0x37ae, 0x0d);
-  write_cmos_sensor(0x37af, 0x0d);
-  write_cmos_sensor(0x37b3, 0x42);
-  write_cmos_sensor(0x37b4, 0x42);
-  write_cmos_sensor(0x37b5, 0x31);
-  write_cmos_sensor(0x3808, 0x0c);
-  write_cmos_sensor(0x3809, 0xc0);
-  write_cmos_sensor(0x380a, 0x09);
-  write_cmos_sensor(0x380b, 0x90);
-  write_cmos_sensor(0x380c, 0x07);
-  write_cmos_sensor(0x380d, 0x94);
-  write_cmos_sensor(0x380e, 0x09);
-  write_cmos_sensor(0x380f, 0xaa);
-  write_cmos_sensor(0x3814, 0x01);
-  write_cmos_sensor(0x3821, 0x46);
-  write_cmos_sensor(0x382a, 0x01);
-  write_cmos_sensor(0x382b, 0x01);
-  write_cmos_sensor(0x3830, 0x06);
-  write_cmos_sensor(0x3836, 0x01);
-  write_cmos_sensor(0x3f08, 0x08);
-  write_cmos_sensor(0x4001, 0x00);
-  write_cmos_sensor(0x4022, 0x0c);
-  write_cmos_sensor(0x4023, 0x60);
-  write_cmos_sensor(0x4025, 0x36);
-  write_cmos_sensor(0x4027, 0x37);
-  write_cmos_sensor(0x402a, 0x04);
-  write_cmos_sensor(0x402b, 0x08);
-  write_cmos_sensor(0x402e, 0x04);
-  write_cmos_sensor(0x402f, 0x08);
-  write_cmos_sensor(0x4600, 0x01);
-  write_cmos_sensor(0x4601, 0x97);
-  write_cmos_sensor(0x4837, 0x10);
-  write_cmos_sensor(0x5901, 0x00);
-  write_cmos_sensor(0x382d, 0xff);
-
-  write_cmos_sensor(0x3031, 0x08);
+  table_write_cmos_sensor(ov8858_capture_setting2);
  	if ( bm == FACTORY_BOOT || bm == ATE_FACTORY_BOOT )
 		write_cmos_sensor(0x4316, 0x01);//DPCM
 	else
@@ -1223,106 +1353,7 @@ static void capture_setting(kal_uint16 currefps)
 // ;;MIPI=1.104Gbps/lane, SysClk=144Mhz,Dac Clock=360Mhz
 // ;;2344x2556x24
 // 100 99 3264 2448 ; Resolution
-  write_cmos_sensor(0x0100, 0x00);
-  write_cmos_sensor(0x0302, 0x2e);
-  write_cmos_sensor(0x030e, 0x00);
-  write_cmos_sensor(0x0312, 0x01);
-  write_cmos_sensor(0x3015, 0x01);
-  write_cmos_sensor(0x3501, 0x9a);
-  write_cmos_sensor(0x3502, 0x20);
-  write_cmos_sensor(0x3700, 0x30);
-  write_cmos_sensor(0x3701, 0x18);
-  write_cmos_sensor(0x3702, 0x50);
-  write_cmos_sensor(0x3703, 0x32);
-  write_cmos_sensor(0x3704, 0x28);
-  write_cmos_sensor(0x3707, 0x08);
-  write_cmos_sensor(0x3708, 0x48);
-  write_cmos_sensor(0x3709, 0x66);
-  write_cmos_sensor(0x370c, 0x07);
-  write_cmos_sensor(0x3718, 0x14);
-  write_cmos_sensor(0x3712, 0x44);
-  write_cmos_sensor(0x371e, 0x31);
-  write_cmos_sensor(0x371f, 0x7f);
-  write_cmos_sensor(0x3720, 0x0a);
-  write_cmos_sensor(0x3721, 0x0a);
-  write_cmos_sensor(0x3724, 0x0c);
-  write_cmos_sensor(0x3725, 0x02);
-  write_cmos_sensor(0x3726, 0x0c);
-  write_cmos_sensor(0x3728, 0x0a);
-  write_cmos_sensor(0x3729, 0x03);
-  write_cmos_sensor(0x372a, 0x06);
-  write_cmos_sensor(0x372b, 0xa6);
-  write_cmos_sensor(0x372c, 0xa6);
-  write_cmos_sensor(0x372d, 0xa6);
-  write_cmos_sensor(0x372e, 0x0c);
-  write_cmos_sensor(0x372f, 0x20);
-  write_cmos_sensor(0x3730, 0x02);
-  write_cmos_sensor(0x3731, 0x0c);
-  write_cmos_sensor(0x3732, 0x28);
-  write_cmos_sensor(0x3736, 0x30);
-  write_cmos_sensor(0x373a, 0x0a);
-  write_cmos_sensor(0x373b, 0x0b);
-  write_cmos_sensor(0x373c, 0x14);
-  write_cmos_sensor(0x373e, 0x06);
-  write_cmos_sensor(0x375a, 0x0c);
-  write_cmos_sensor(0x375b, 0x26);
-  write_cmos_sensor(0x375d, 0x04);
-  write_cmos_sensor(0x375f, 0x28);
-  write_cmos_sensor(0x3768, 0xcc);
-  write_cmos_sensor(0x3769, 0x44);
-  write_cmos_sensor(0x376a, 0x44);
-  write_cmos_sensor(0x3772, 0x46);
-  write_cmos_sensor(0x3773, 0x04);
-  write_cmos_sensor(0x3774, 0x2c);
-  write_cmos_sensor(0x3775, 0x13);
-  write_cmos_sensor(0x3776, 0x08);
-  write_cmos_sensor(0x3778, 0x17);
-  write_cmos_sensor(0x37a0, 0x88);
-  write_cmos_sensor(0x37a1, 0x7a);
-  write_cmos_sensor(0x37a2, 0x7a);
-  write_cmos_sensor(0x37a7, 0x88);
-  write_cmos_sensor(0x37a8, 0x98);
-  write_cmos_sensor(0x37a9, 0x98);
-  write_cmos_sensor(0x37aa, 0x88);
-  write_cmos_sensor(0x37ab, 0x5c);
-  write_cmos_sensor(0x37ac, 0x5c);
-  write_cmos_sensor(0x37ad, 0x55);
-  write_cmos_sensor(0x37ae, 0x19);
-  write_cmos_sensor(0x37af, 0x19);
-  write_cmos_sensor(0x37b3, 0x84);
-  write_cmos_sensor(0x37b4, 0x84);
-  write_cmos_sensor(0x37b5, 0x60);
-  write_cmos_sensor(0x3808, 0x0c);
-  write_cmos_sensor(0x3809, 0xc0);
-  write_cmos_sensor(0x380a, 0x09);
-  write_cmos_sensor(0x380b, 0x90);
-  write_cmos_sensor(0x380c, 0x09);
-  write_cmos_sensor(0x380d, 0x28);
-  write_cmos_sensor(0x380e, 0x09);
-  write_cmos_sensor(0x380f, 0xfc);
-  write_cmos_sensor(0x3814, 0x01);
-  write_cmos_sensor(0x3821, 0x46);
-  write_cmos_sensor(0x382a, 0x01);
-  write_cmos_sensor(0x382b, 0x01);
-  write_cmos_sensor(0x3830, 0x06);
-  write_cmos_sensor(0x3836, 0x01);
-  write_cmos_sensor(0x3f08, 0x10);
-  write_cmos_sensor(0x4001, 0x00);
-  write_cmos_sensor(0x4022, 0x0c);
-  write_cmos_sensor(0x4023, 0x60);
-  write_cmos_sensor(0x4025, 0x36);
-  write_cmos_sensor(0x4027, 0x37);
-  write_cmos_sensor(0x402a, 0x04);
-  write_cmos_sensor(0x402b, 0x08);
-  write_cmos_sensor(0x402e, 0x04);
-  write_cmos_sensor(0x402f, 0x08);
-  write_cmos_sensor(0x4600, 0x01);
-  write_cmos_sensor(0x4601, 0x97);
-  write_cmos_sensor(0x4837, 0x0d);
-  write_cmos_sensor(0x5901, 0x00);
-  write_cmos_sensor(0x382d, 0xff);
-
-  write_cmos_sensor(0x3031, 0x08);
+  table_write_cmos_sensor(ov8858_capture_setting3);
   if ( bm == FACTORY_BOOT || bm == ATE_FACTORY_BOOT )
 	  write_cmos_sensor(0x4316, 0x01);//DPCM
   else
@@ -1340,6 +1371,108 @@ static void normal_video_setting(kal_uint16 currefps)
 	LOG_INF("E! video just has 30fps preview size setting ,NOT HAS 24FPS SETTING!\n");
   preview_setting();
 }
+static const kal_uint16 ov8858_hs_video_setting[] = {
+	0x0100, 0x00,
+	0x0302, 0x1e,
+	0x030e, 0x00,
+	0x0312, 0x01,
+	0x3015, 0x01,
+	0x3501, 0x20,
+	0x3502, 0x00,
+	0x3700, 0x30,
+	0x3701, 0x18,
+	0x3702, 0x50,
+	0x3703, 0x32,
+	0x3704, 0x28,
+	0x3707, 0x08,
+	0x3708, 0x48,
+	0x3709, 0x66,
+	0x370c, 0x07,
+	0x3718, 0x14,
+	0x3712, 0x44,
+	0x371e, 0x31,
+	0x371f, 0x7f,
+	0x3720, 0x0a,
+	0x3721, 0x0a,
+	0x3724, 0x0c,
+	0x3725, 0x02,
+	0x3726, 0x0c,
+	0x3728, 0x0a,
+	0x3729, 0x03,
+	0x372a, 0x06,
+	0x372b, 0xa6,
+	0x372c, 0xa6,
+	0x372d, 0xa6,
+	0x372e, 0x0c,
+	0x372f, 0x20,
+	0x3730, 0x02,
+	0x3731, 0x0c,
+	0x3732, 0x28,
+	0x3736, 0x30,
+	0x373a, 0x0a,
+	0x373b, 0x0b,
+	0x373c, 0x14,
+	0x373e, 0x06,
+	0x375a, 0x0c,
+	0x375b, 0x26,
+	0x375d, 0x04,
+	0x375f, 0x28,
+	0x3768, 0x00,
+	0x3769, 0xc0,
+	0x376a, 0x42,
+	0x3772, 0x46,
+	0x3773, 0x04,
+	0x3774, 0x2c,
+	0x3775, 0x13,
+	0x3776, 0x08,
+	0x3778, 0x17,
+	0x37a0, 0x88,
+	0x37a1, 0x7a,
+	0x37a2, 0x7a,
+	0x37a7, 0x88,
+	0x37a8, 0x98,
+	0x37a9, 0x98,
+	0x37aa, 0x88,
+	0x37ab, 0x5c,
+	0x37ac, 0x5c,
+	0x37ad, 0x55,
+	0x37ae, 0x19,
+	0x37af, 0x19,
+	0x37b3, 0x84,
+	0x37b4, 0x84,
+	0x37b5, 0x60,
+	0x3808, 0x02,
+	0x3809, 0x80,
+	0x380a, 0x01,
+	0x380b, 0xe0,
+	0x380c, 0x09,
+	0x380d, 0x02,
+	0x380e, 0x02,
+	0x380f, 0x08,
+	0x3814, 0x03,
+	0x3821, 0x6f,
+	0x382a, 0x05,
+	0x382b, 0x03,
+	0x3830, 0x0c,
+	0x3836, 0x02,
+	0x3f08, 0x10,
+	0x4001, 0x10,
+	0x4022, 0x02,
+	0x4023, 0x20,
+	0x4025, 0xe0,
+	0x4027, 0x5f,
+	0x402a, 0x02,
+	0x402b, 0x04,
+	0x402e, 0x02,
+	0x402f, 0x04,
+	0x4600, 0x00,
+	0x4601, 0x4f,
+	0x4837, 0x16,
+	0x5901, 0x04,
+	0x382d, 0x7f,
+	0x0100, 0x01,
+};
+
 static void hs_video_setting(void)
 {
 	LOG_INF("E\n");
@@ -1347,105 +1480,7 @@ static void hs_video_setting(void)
 //;;MIPI=720Mbps, SysClk=144Mhz,Dac Clock=360Mhz
 //;;2306x520x120
 //100 99 640 480
-    write_cmos_sensor(0x0100, 0x00);
-    write_cmos_sensor(0x0302, 0x1e);
-    write_cmos_sensor(0x030e, 0x00);
-    write_cmos_sensor(0x0312, 0x01);
-    write_cmos_sensor(0x3015, 0x01);
-    write_cmos_sensor(0x3501, 0x20);
-    write_cmos_sensor(0x3502, 0x00);
-    write_cmos_sensor(0x3700, 0x30);
-    write_cmos_sensor(0x3701, 0x18);
-    write_cmos_sensor(0x3702, 0x50);
-    write_cmos_sensor(0x3703, 0x32);
-    write_cmos_sensor(0x3704, 0x28);
-    write_cmos_sensor(0x3707, 0x08);
-    write_cmos_sensor(0x3708, 0x48);
-    write_cmos_sensor(0x3709, 0x66);
-    write_cmos_sensor(0x370c, 0x07);
-    write_cmos_sensor(0x3718, 0x14);
-    write_cmos_sensor(0x3712, 0x44);
-    write_cmos_sensor(0x371e, 0x31);
-    write_cmos_sensor(0x371f, 0x7f);
-    write_cmos_sensor(0x3720, 0x0a);
-    write_cmos_sensor(0x3721, 0x0a);
-    write_cmos_sensor(0x3724, 0x0c);
-    write_cmos_sensor(0x3725, 0x02);
-    write_cmos_sensor(0x3726, 0x0c);
-    write_cmos_sensor(0x3728, 0x0a);
-    write_cmos_sensor(0x3729, 0x03);
-    write_cmos_sensor(0x372a, 0x06);
-    write_cmos_sensor(0x372b, 0xa6);
-    write_cmos_sensor(0x372c, 0xa6);
-    write_cmos_sensor(0x372d, 0xa6);
-    write_cmos_sensor(0x372e, 0x0c);
-    write_cmos_sensor(0x372f, 0x20);
-    write_cmos_sensor(0x3730, 0x02);
-    write_cmos_sensor(0x3731, 0x0c);
-    write_cmos_sensor(0x3732, 0x28);
-    write_cmos_sensor(0x3736, 0x30);
-    write_cmos_sensor(0x373a, 0x0a);
-    write_cmos_sensor(0x373b, 0x0b);
-    write_cmos_sensor(0x373c, 0x14);
-    write_cmos_sensor(0x373e, 0x06);
-    write_cmos_sensor(0x375a, 0x0c);
-    write_cmos_sensor(0x375b, 0x26);
-    write_cmos_sensor(0x375d, 0x04);
-    write_cmos_sensor(0x375f, 0x28);
-    write_cmos_sensor(0x3768, 0x00);
-    write_cmos_sensor(0x3769, 0xc0);
-    write_cmos_sensor(0x376a, 0x42);
-    write_cmos_sensor(0x3772, 0x46);
-    write_cmos_sensor(0x3773, 0x04);
-    write_cmos_sensor(0x3774, 0x2c);
-    write_cmos_sensor(0x3775, 0x13);
-    write_cmos_sensor(0x3776, 0x08);
-    write_cmos_sensor(0x3778, 0x17);
-    write_cmos_sensor(0x37a0, 0x88);
-    write_cmos_sensor(0x37a1, 0x7a);
-    write_cmos_sensor(0x37a2, 0x7a);
-    write_cmos_sensor(0x37a7, 0x88);
-    write_cmos_sensor(0x37a8, 0x98);
-    write_cmos_sensor(0x37a9, 0x98);
-    write_cmos_sensor(0x37aa, 0x88);
-    write_cmos_sensor(0x37ab, 0x5c);
-    write_cmos_sensor(0x37ac, 0x5c);
-    write_cmos_sensor(0x37ad, 0x55);
-    write_cmos_sensor(0x37ae, 0x19);
-    write_cmos_sensor(0x37af, 0x19);
-    write_cmos_sensor(0x37b3, 0x84);
-    write_cmos_sensor(0x37b4, 0x84);
-    write_cmos_sensor(0x37b5, 0x60);
-    write_cmos_sensor(0x3808, 0x02);
-    write_cmos_sensor(0x3809, 0x80);
-    write_cmos_sensor(0x380a, 0x01);
-    write_cmos_sensor(0x380b, 0xe0);
-    write_cmos_sensor(0x380c, 0x09);
-    write_cmos_sensor(0x380d, 0x02);
-    write_cmos_sensor(0x380e, 0x02);
-    write_cmos_sensor(0x380f, 0x08);
-    write_cmos_sensor(0x3814, 0x03);
-    write_cmos_sensor(0x3821, 0x6f);
-    write_cmos_sensor(0x382a, 0x05);
-    write_cmos_sensor(0x382b, 0x03);
-    write_cmos_sensor(0x3830, 0x0c);
-    write_cmos_sensor(0x3836, 0x02);
-    write_cmos_sensor(0x3f08, 0x10);
-    write_cmos_sensor(0x4001, 0x10);
-    write_cmos_sensor(0x4022, 0x02);
-    write_cmos_sensor(0x4023, 0x20);
-    write_cmos_sensor(0x4025, 0xe0);
-    write_cmos_sensor(0x4027, 0x5f);
-    write_cmos_sensor(0x402a, 0x02);
-    write_cmos_sensor(0x402b, 0x04);
-    write_cmos_sensor(0x402e, 0x02);
-    write_cmos_sensor(0x402f, 0x04);
-    write_cmos_sensor(0x4600, 0x00);
-    write_cmos_sensor(0x4601, 0x4f);
-    write_cmos_sensor(0x4837, 0x16);
-    write_cmos_sensor(0x5901, 0x04);
-    write_cmos_sensor(0x382d, 0x7f);
-    write_cmos_sensor(0x0100, 0x01);
+    table_write_cmos_sensor(ov8858_hs_video_setting);
 }
 
 static void slim_video_setting(void)
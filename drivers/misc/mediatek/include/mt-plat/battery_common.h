@@ -361,6 +361,7 @@ extern unsigned char bat_is_kpoc(void);
 extern void wake_up_bat(void);
 extern void wake_up_bat2(void);
 extern void wake_up_bat3(void);
+extern void wake_up_bat_event(void);
 
 extern unsigned long BAT_Get_Battery_Voltage(int polling_mode);
 extern void mt_battery_charging_algorithm(void);
@@ -373,6 +374,7 @@ extern PMU_STATUS do_jeita_state_machine(void);
 #define wake_up_bat()			do {} while (0)
 #define wake_up_bat2()			do {} while (0)
 #define wake_up_bat3()			do {} while (0)
+#define wake_up_bat_event()		do {} while (0)
 
 
 #define BAT_Get_Battery_Voltage(polling_mode)	({ 0; })
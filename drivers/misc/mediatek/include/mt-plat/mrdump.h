@@ -31,6 +31,8 @@
 #define MRDUMP_FS_EXT4 2
 
 #define MRDUMP_GO_DUMP "MRDUMP04"
+/* an lk that also reads mrdump_dump_hint */
+#define MRDUMP_GO_DUMP_HINT "MRDUMP05"
 
 typedef uint32_t arm32_gregset_t[18];
 typedef uint64_t aarch64_gregset_t[34];
@@ -72,11 +74,38 @@ struct mrdump_machdesc {
 	uint32_t output_lbaooo;
 };
 
+#define MRDUMP_COMP_NONE 0
+#define MRDUMP_COMP_LZ4 1
+
+#define MRDUMP_HINT_SKIP_FREE 0x1	/* skip_bitmap is valid for this crash */
+#define MRDUMP_HINT_SKIP_ZERO 0x2	/* lk may leave out pages reading all zero */
+
+/*
+ * How lk should write the full dump. Placed after the crash record so an
+ * MRDUMP04 lk finds everything else where it was; only filled in when lk
+ * reported MRDUMP_GO_DUMP_HINT.
+ *
+ * skip_bitmap holds one bit per pfn from skip_pfn_start, a set bit is a
+ * page that was free in the buddy allocator or a per-cpu list when the
+ * kernel crashed and need not be dumped.
+ */
+struct mrdump_dump_hint {
+	uint32_t flags;
+	uint32_t compress;	/* MRDUMP_COMP_* */
+	uint32_t nr_streams;	/* independently compressed streams */
+	uint32_t pad;
+
+	uint64_t skip_bitmap;	/* physical address */
+	uint64_t skip_pfn_start;
+	uint64_t skip_nr_pfns;
+};
+
 struct mrdump_control_block {
 	char sig[8];
 
 	struct mrdump_machdesc machdesc;
 	struct mrdump_crash_record crash_record;
+	struct mrdump_dump_hint hint;
 };
 
 /* NOTE!! any change to this struct should be compatible in aed */
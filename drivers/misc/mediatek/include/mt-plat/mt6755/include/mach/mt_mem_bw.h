@@ -8,4 +8,15 @@ extern void mt_getmembw_registerCB(getmembw_func pCB);
 
 unsigned long long get_mem_bw(void);
 
+/* masters sampled by the EMI bandwidth QoS */
+enum {
+	MEM_BW_CPU,
+	MEM_BW_GPU,
+	MEM_BW_MM,
+	MEM_BW_MD,
+	NR_MEM_BW_MASTER
+};
+
+unsigned int get_mem_bw_master(int master);
+
 #endif  /* !__MT_MEM_BW_H__ */
@@ -39,6 +39,11 @@ struct hpf {
 	unsigned long loading_cpu;
 	unsigned long loading_gpu;
 	unsigned long loading_flash;
+
+	/* reported by kicker_pbm_by_demand(), 0: use the estimate above */
+	unsigned long demand_md1;
+	unsigned long demand_md3;
+	unsigned long demand_flash;
 };
 
 struct mrp {
@@ -233,6 +238,11 @@ extern void kicker_pbm_by_md(enum pbm_kicker kicker, bool status);
 extern void kicker_pbm_by_cpu(unsigned int loading, int core, int voltage);
 extern void kicker_pbm_by_gpu(bool status, unsigned int loading, int voltage);
 extern void kicker_pbm_by_flash(bool status);
+extern void kicker_pbm_by_demand(enum pbm_kicker kicker, unsigned int mw);
+
+/* emergency frequency caps for consumer peaks, 0: no cap */
+extern unsigned int mt_pbm_get_emerg_cpu_khz(int cluster);
+extern unsigned int mt_pbm_get_emerg_gpu_khz(void);
 
 extern void init_md_section_level(enum pbm_kicker);
 
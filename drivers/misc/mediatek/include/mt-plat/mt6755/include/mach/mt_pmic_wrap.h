@@ -4,10 +4,30 @@
 /* #include <linux/smp.h> */
 #include <linux/types.h>
 #include <linux/device.h>
+#include <linux/workqueue.h>
+
+/* see mt-plat/mt_pmic_wrap.h */
+struct pwrap_op {
+	u32 write;
+	u32 adr;
+	u32 wdata;
+	u32 mask;
+	u32 *rdata;
+};
+
+struct pwrap_batch_req {
+	struct pwrap_op *ops;
+	int nr;
+	s32 ret;
+	void (*done)(struct pwrap_batch_req *req);
+	struct work_struct work;
+};
+
 struct mt_pmic_wrap_driver {
 
 	struct device_driver driver;
 	s32 (*wacs2_hal)(u32 write, u32 adr, u32 wdata, u32 *rdata);
+	s32 (*batch_hal)(struct pwrap_op *ops, int nr);
 	s32 (*show_hal)(char *buf);
 	s32 (*store_hal)(const char *buf, size_t count);
 	s32 (*suspend)(void);
@@ -16,12 +36,15 @@ struct mt_pmic_wrap_driver {
 typedef enum {
 	PWRAP_READ	= 0,
 	PWRAP_WRITE	= 1,
+	PWRAP_UPDATE	= 2,
 } PWRAP_OPS;
 
 /* ------external API for pmic_wrap user-------------------------------------------------- */
 s32 pwrap_read(u32 adr, u32 *rdata);
 s32 pwrap_write(u32 adr, u32  wdata);
 s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata);
+s32 pwrap_batch(struct pwrap_op *ops, int nr);
+void pwrap_batch_async(struct pwrap_batch_req *req);
 /*_____________ROME only_____________________________________________*/
 /********************************************************************/
 /* return value : EINT_STA: [0]: CPU IRQ status in MT6331 */
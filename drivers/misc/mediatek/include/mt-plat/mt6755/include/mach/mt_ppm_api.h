@@ -93,6 +93,7 @@ extern void mt_ppm_ptpod_policy_deactivate(void);
 extern void mt_ppm_hica_update_algo_data(unsigned int cur_loads,
 					unsigned int cur_nr_heavy_task, unsigned int cur_tlp);
 extern int mt_ppm_main(void);
+extern int mt_ppm_get_cur_limit(unsigned int cluster, struct ppm_client_limit *limit);
 
 /* MET */
 void mt_set_ppm_state_registerCB(met_set_ppm_state_funcMET pCB);
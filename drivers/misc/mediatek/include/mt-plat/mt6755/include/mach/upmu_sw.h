@@ -33,7 +33,8 @@ typedef enum LOW_BATTERY_PRIO_TAG {
 	LOW_BATTERY_PRIO_FLASHLIGHT = 5,
 	LOW_BATTERY_PRIO_VIDEO = 6,
 	LOW_BATTERY_PRIO_WIFI = 7,
-	LOW_BATTERY_PRIO_BACKLIGHT = 8
+	LOW_BATTERY_PRIO_BACKLIGHT = 8,
+	LOW_BATTERY_PRIO_BATTERY = 9
 } LOW_BATTERY_PRIO;
 
 extern void (*low_battery_callback)(LOW_BATTERY_LEVEL);
@@ -0,0 +1,34 @@
+#ifndef __MT_CACHE_SYNC_H__
+#define __MT_CACHE_SYNC_H__
+
+#include <linux/scatterlist.h>
+
+/*
+ * Cache maintenance of DMA buffers by range (arch/arm64/mm/mt_innercache.c).
+ *
+ * Drivers describe what they need synced as ranges and mt_cache_sync()
+ * picks how: by VA over each range on the calling cpu, or one set/way
+ * flush of L1 on every cpu and L2 once per cluster when the ranges add up
+ * to more than that costs. The costs are measured at boot and the choices
+ * are counted in /sys/kernel/debug/mt_cache_sync.
+ *
+ * A range is either @size bytes at kernel VA @start (@table NULL), or
+ * @size bytes at byte offset @start into the buffer described by @table,
+ * whose pages must be in the linear map.
+ */
+enum mt_cache_sync_op {
+	MT_CACHE_SYNC_CLEAN,		/* cpu wrote, device reads */
+	MT_CACHE_SYNC_INVALIDATE,	/* device wrote, cpu reads */
+	MT_CACHE_SYNC_FLUSH,
+};
+
+struct mt_cache_range {
+	struct sg_table *table;
+	unsigned long start;
+	unsigned long size;
+	enum mt_cache_sync_op op;
+};
+
+extern int mt_cache_sync(const struct mt_cache_range *r, int nr);
+
+#endif /* __MT_CACHE_SYNC_H__ */
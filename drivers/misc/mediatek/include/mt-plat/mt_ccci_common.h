@@ -3,6 +3,8 @@
 #include <asm/io.h>
 #include <asm/setup.h>
 #include <linux/device.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
 /*
  * all code owned by CCCI should use modem index starts from ZERO
  */
@@ -384,6 +386,37 @@ enum{
 #define CCCI_IOC_SET_HEADER				_IO(CCCI_IOC_MAGIC,  112) /* emcs_va */
 #define CCCI_IOC_CLR_HEADER				_IO(CCCI_IOC_MAGIC,  113) /* emcs_va */
 #define CCCI_IOC_DL_TRAFFIC_CONTROL		_IOW(CCCI_IOC_MAGIC, 119, unsigned int) /* mdlogger */
+#define CCCI_IOC_RX_RING_SETUP			_IOW(CCCI_IOC_MAGIC, 120, unsigned int) /* mdlogger */
+
+/*
+ * mmap Rx ring of a char port, set up by CCCI_IOC_RX_RING_SETUP with the size of the data area
+ * (power of 2) and then mapped with mmap(size + CCCI_RX_RING_HDR_SIZE) at offset 0.
+ * head is written by kernel and tail by user, both are free-running byte counters over the data
+ * area starting at data_offset. Each record is a ccci_rx_ring_rec followed by len bytes of payload,
+ * padded to CCCI_RX_RING_ALIGN; a record with channel CCCI_RX_RING_PAD only skips to the ring start.
+ * poll() reports POLLIN once (head - tail) reaches watermark, user may change watermark at any time,
+ * and should call poll() after moving tail so that a stalled Rx queue can be resumed.
+ */
+#define CCCI_RX_RING_MAGIC		0x52524343	/* "CCRR" */
+#define CCCI_RX_RING_HDR_SIZE		4096
+#define CCCI_RX_RING_ALIGN		8
+#define CCCI_RX_RING_PAD		0xFFFFFFFF
+
+struct ccci_rx_ring_hdr {
+	unsigned int magic;
+	unsigned int size;
+	unsigned int data_offset;
+	unsigned int watermark;	/* user */
+	unsigned int head;	/* kernel */
+	unsigned int tail;	/* user */
+	unsigned int dropped;	/* kernel */
+	unsigned int reserved;
+};
+
+struct ccci_rx_ring_rec {
+	unsigned int len;
+	unsigned int channel;
+};
 
 #define CCCI_IPC_MAGIC 'P' /* only for IPC user */
 /* CCCI == EEMCS */
@@ -684,6 +717,7 @@ enum {
 	MODEM_CAP_NAPI = (1<<0),
 	MODEM_CAP_TXBUSY_STOP = (1<<1),
 	MODEM_CAP_SGIO = (1<<2),
+	MODEM_CAP_RX_CSUM = (1<<3), /* modem verified L4 checksum of DL packets */
 	/*bit16-bit31: for modem capability only related with ccmni driver*/
 	MODEM_CAP_CCMNI_DISABLE = (1<<16),
 	MODEM_CAP_DATA_ACK_DVD = (1<<17),
@@ -691,6 +725,7 @@ enum {
 	MODEM_CAP_CCMNI_IRAT = (1<<19),
 	MODEM_CAP_WORLD_PHONE = (1<<20),
 	MODEM_CAP_CCMNI_MQ = (1<<21), /* it must depend on DATA ACK DEVIDE feature */
+	MODEM_CAP_CCMNI_RAWIP = (1<<22), /* no fake ethernet header on ccmni */
 };
 
 /* AP<->MD messages on control or system channel */
@@ -833,6 +868,18 @@ struct ccci_dev_cfg {
 	unsigned int capability;
 };
 
+/* an image loaded by a worker, see ccci_load_firmware_start() */
+struct ccci_img_load {
+	int md_id;
+	struct ccci_image_info *img;
+	struct device *dev;
+	char post_fix[IMG_POSTFIX_LEN];
+	char err_str[IMG_ERR_STR_LEN];
+	int ret;
+	struct work_struct work;
+	struct completion done;
+};
+
 typedef int (*get_status_func_t)(int, char*, int);
 typedef int (*boot_md_func_t)(int);
 
@@ -969,6 +1016,17 @@ int set_modem_support_cap(int md_id, int new_val); /* Export by ccci util */
 char *ccci_get_md_info_str(int md_id); /* Export by ccci util */
 /* Export by ccci util */
 int ccci_load_firmware(int md_id, void *img_inf, char img_err_str[], char post_fix[], struct device *dev);
+/*
+ * Same as ccci_load_firmware(), calling @hdr_ready once the check header is
+ * parsed and before the image is copied, so that images placed by that
+ * header can be started with ccci_load_firmware_start() beside the copy.
+ */
+int ccci_load_md_firmware(int md_id, void *img_inf, char img_err_str[], char post_fix[], struct device *dev,
+			  void (*hdr_ready)(void *data), void *data);
+/* @load lives on the caller's stack until ccci_load_firmware_wait() */
+void ccci_load_firmware_start(struct ccci_img_load *load, int md_id, struct ccci_image_info *img,
+			      struct device *dev);
+int ccci_load_firmware_wait(struct ccci_img_load *load);
 int get_md_resv_mem_info(int md_id, phys_addr_t *r_rw_base, unsigned int *r_rw_size,
 					phys_addr_t *srw_base, unsigned int *srw_size); /* Export by ccci util */
 int get_md1_md3_resv_smem_info(int md_id, phys_addr_t *rw_base, unsigned int *rw_size);
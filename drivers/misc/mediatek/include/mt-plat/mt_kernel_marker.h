@@ -0,0 +1,47 @@
+#ifndef __MT_KERNEL_MARKER_H__
+#define __MT_KERNEL_MARKER_H__
+
+/*
+ * Systrace markers from kernel code (kernel/trace/mtk_trace.c).
+ *
+ * A marker is recorded as a fixed size mtk_events:tracing_mark_write
+ * event carrying an id for its name, so recording one costs no string
+ * formatting. Names are interned on first use and listed in the tracing
+ * file kernel_marker_names. The trace file prints the events as
+ * "tracing_mark_write: B|tgid|name", the same way as markers written by
+ * user space, so systrace reads them unchanged. While the event is
+ * disabled, or when the name table is full, markers are written as
+ * text as before.
+ *
+ * mt_kernel_trace_*() record only while kernel_marker_on is set.
+ * mt_kernel_marker_write() records regardless, for drivers with their
+ * own switch. @type is the systrace marker type: 'B' and 'E' begin and
+ * end a slice, 'C' sets a counter, 'S' and 'F' begin and end an async
+ * slice with @value as its cookie. Counters written from interrupt
+ * context are attributed to tgid -1.
+ */
+#ifdef CONFIG_MTK_KERNEL_MARKER
+extern void mt_kernel_marker_write(char type, const char *name, int value);
+extern void mt_kernel_trace_begin(char *name);
+extern void mt_kernel_trace_counter(char *name, int count);
+extern void mt_kernel_trace_end(void);
+#else
+static inline void mt_kernel_marker_write(char type, const char *name,
+					  int value)
+{
+}
+
+static inline void mt_kernel_trace_begin(char *name)
+{
+}
+
+static inline void mt_kernel_trace_counter(char *name, int count)
+{
+}
+
+static inline void mt_kernel_trace_end(void)
+{
+}
+#endif
+
+#endif /* __MT_KERNEL_MARKER_H__ */
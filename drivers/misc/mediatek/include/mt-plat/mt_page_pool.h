@@ -0,0 +1,38 @@
+#ifndef __MT_PAGE_POOL_H__
+#define __MT_PAGE_POOL_H__
+
+#include <linux/mm_types.h>
+#include <linux/types.h>
+
+/*
+ * Page pool shared by the GPU and multimedia drivers
+ * (drivers/staging/android/ion/ion_page_pool.c).
+ *
+ * The uncached page pools of the ION system and multimedia heaps are one
+ * pool per order, and the GPU driver takes pages from and gives idle
+ * pages back to the same pools instead of keeping a cache of its own.
+ * Pages in the pools are zeroed and clean to memory, and are reclaimed
+ * by a single shrinker.
+ *
+ * mt_page_pool_get() never allocates, it returns NULL when the pool of
+ * @order is empty. mt_page_pool_put() zeroes the page into the pool of
+ * its order, or returns false when there is no such pool or the pools
+ * hold ion_page_pool.shared_pool_max_kb already; the caller frees the
+ * page then. Pages must not be mapped for DMA by the caller any more.
+ */
+#ifdef CONFIG_ION_SHARED_POOL
+extern struct page *mt_page_pool_get(unsigned int order);
+extern bool mt_page_pool_put(struct page *page);
+#else
+static inline struct page *mt_page_pool_get(unsigned int order)
+{
+	return NULL;
+}
+
+static inline bool mt_page_pool_put(struct page *page)
+{
+	return false;
+}
+#endif
+
+#endif /* __MT_PAGE_POOL_H__ */
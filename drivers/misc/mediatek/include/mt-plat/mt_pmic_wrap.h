@@ -3,14 +3,42 @@
 
 #include <linux/types.h>
 #include <linux/device.h>
+#include <linux/workqueue.h>
 
 #define PWRAP_READ 0
 #define PWRAP_WRITE 1
+#define PWRAP_UPDATE 2
+
+/*
+ * One access of a pwrap_batch(). PWRAP_UPDATE reads @adr, replaces the bits
+ * in @mask with those of @wdata and writes it back without another access
+ * in between; @rdata, when set, gets the value read.
+ */
+struct pwrap_op {
+	u32 write;
+	u32 adr;
+	u32 wdata;
+	u32 mask;
+	u32 *rdata;
+};
+
+/*
+ * pwrap_batch_async() runs @ops in process context on a LITTLE cpu and
+ * calls @done with @ret set; the request must stay around until then.
+ */
+struct pwrap_batch_req {
+	struct pwrap_op *ops;
+	int nr;
+	s32 ret;
+	void (*done)(struct pwrap_batch_req *req);
+	struct work_struct work;
+};
 
 struct mt_pmic_wrap_driver {
 
 	struct device_driver driver;
 	s32 (*wacs2_hal)(u32 write, u32 adr, u32 wdata, u32 *rdata);
+	s32 (*batch_hal)(struct pwrap_op *ops, int nr);
 	s32 (*show_hal)(char *buf);
 	s32 (*store_hal)(const char *buf, size_t count);
 
@@ -23,6 +51,8 @@ s32 pwrap_read(u32 adr, u32 *rdata);
 s32 pwrap_write(u32 adr, u32 wdata);
 
 s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata);
+s32 pwrap_batch(struct pwrap_op *ops, int nr);
+void pwrap_batch_async(struct pwrap_batch_req *req);
 /*_____________ROME only_____________________________________________*/
 /********************************************************************/
 /* return value : EINT_STA: [0]: CPU IRQ status in MT6331 */
@@ -0,0 +1,50 @@
+#ifndef __MT_TIMER_COALESCE_H__
+#define __MT_TIMER_COALESCE_H__
+
+#include <linux/list.h>
+#include <linux/atomic.h>
+
+/*
+ * Coalescing of periodic driver timers (spm_v2/mt_timer_coalesce.c).
+ *
+ * A driver describes each of its timers with a struct mt_ctimer_src and a
+ * slack, the time the timer may fire late. mt_ctimer_expires() moves an
+ * expiry onto the next shared wake window boundary when that is within the
+ * slack, else onto a multiple of the slack, so timers of unrelated drivers
+ * expire on the same tick. The window is larger with the screen off.
+ * mt_ctimer_fired(), called first thing in the handler, counts the expiries
+ * per source for /sys/kernel/debug/mt_ctimer.
+ *
+ *	static DEFINE_MT_CTIMER_SRC(foo_src, "foo", 500);
+ *	...
+ *	mod_timer(&foo_timer, mt_ctimer_expires(&foo_src, jiffies + HZ));
+ */
+struct mt_ctimer_src {
+	const char *name;
+	unsigned int slack_ms;
+
+	/* private */
+	struct list_head link;
+	atomic_long_t nr_fired;
+	atomic_long_t nr_idle_fired;	/* fired on an idle cpu */
+};
+
+#define DEFINE_MT_CTIMER_SRC(var, _name, _slack_ms)		\
+	struct mt_ctimer_src var = {				\
+		.name = _name,					\
+		.slack_ms = _slack_ms,				\
+		.link = LIST_HEAD_INIT(var.link),		\
+	}
+
+#if defined(CONFIG_ARCH_MT6755) || defined(CONFIG_ARCH_MT6797)
+extern unsigned long mt_ctimer_expires(struct mt_ctimer_src *src, unsigned long expires);
+extern void mt_ctimer_fired(struct mt_ctimer_src *src);
+#else
+static inline unsigned long mt_ctimer_expires(struct mt_ctimer_src *src, unsigned long expires)
+{
+	return expires;
+}
+static inline void mt_ctimer_fired(struct mt_ctimer_src *src) { }
+#endif
+
+#endif /* __MT_TIMER_COALESCE_H__ */
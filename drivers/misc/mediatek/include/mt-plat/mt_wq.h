@@ -0,0 +1,37 @@
+#ifndef __MT_WQ_H__
+#define __MT_WQ_H__
+
+#include <linux/workqueue.h>
+
+/*
+ * Cluster aware deferred work (sched/mt_wq.c).
+ *
+ * MT_WQ_LITTLE work runs on the LITTLE cpus only. It is meant for
+ * background work whose latency does not matter, and it never wakes a
+ * big core from idle.
+ *
+ * MT_WQ_CLUSTER work runs at high priority on the cluster of the cpu
+ * that queued it. It is meant for work that follows an interrupt or a
+ * request and wants to run where that cpu's caches are, without
+ * waking another cluster.
+ *
+ * A driver that needs a workqueue of its own (ordering, rescuer) keeps
+ * it and calls mt_wq_bind_little() on it after alloc_workqueue(). The
+ * workqueue must be WQ_UNBOUND and must not be ordered.
+ *
+ * /sys/kernel/debug/mt_wq shows, for each cluster, how much work was
+ * queued through these helpers and how much unbound work it executed.
+ */
+enum mt_wq_class {
+	MT_WQ_LITTLE,
+	MT_WQ_CLUSTER,
+	NR_MT_WQ_CLASSES,
+};
+
+extern bool mt_queue_work(enum mt_wq_class cls, struct work_struct *work);
+extern bool mt_queue_delayed_work(enum mt_wq_class cls, struct delayed_work *dwork,
+				  unsigned long delay);
+extern int mt_wq_bind_little(struct workqueue_struct *wq, bool highpri);
+extern const struct cpumask *mt_little_cpumask(void);
+
+#endif /* __MT_WQ_H__ */
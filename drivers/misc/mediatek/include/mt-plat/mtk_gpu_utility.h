@@ -35,6 +35,9 @@ bool mtk_custom_upbound_gpu_freq(unsigned int ui32FreqLevel);
 bool mtk_get_custom_boost_gpu_freq(unsigned int *pui32FreqLevel);
 bool mtk_get_custom_upbound_gpu_freq(unsigned int *pui32FreqLevel);
 
+/* floor held by the input boost arbiter, same scale as above, 0 => release */
+bool mtk_input_boost_gpu_freq(unsigned int ui32FreqLevel);
+
 bool mtk_dump_gpu_memory_usage(void);
 #ifdef __cplusplus
 }
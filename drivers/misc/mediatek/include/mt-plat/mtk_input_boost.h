@@ -0,0 +1,35 @@
+#ifndef __MTK_INPUT_BOOST_H__
+#define __MTK_INPUT_BOOST_H__
+
+#include <linux/types.h>
+
+/*
+ * Input-to-frame boost arbiter (dynamic_boost driver).
+ *
+ * One input event raises the CPU core/frequency, GPU and vcore requests
+ * together under a single release deadline; every frame presented on the
+ * primary display while the boost is held pushes that deadline out, so the
+ * boost lasts until the UI stops producing frames.
+ */
+#ifdef CONFIG_MTK_DYNAMIC_BOOST
+/*
+ * An input event was seen; safe from atomic context. Returns false when the
+ * arbiter is disabled, so the caller should boost on its own.
+ */
+extern bool input_boost_kick(void);
+
+/* a frame was presented on the primary display; safe from atomic context */
+extern void input_boost_frame(void);
+
+/*
+ * A frame was late because the CPU side produced it too slowly; raises the
+ * big cores only, for a few frames. Safe from atomic context.
+ */
+extern void frame_boost_cpu(void);
+#else
+static inline bool input_boost_kick(void) { return false; }
+static inline void input_boost_frame(void) { }
+static inline void frame_boost_cpu(void) { }
+#endif
+
+#endif /* __MTK_INPUT_BOOST_H__ */
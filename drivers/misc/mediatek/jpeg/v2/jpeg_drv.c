@@ -698,15 +698,222 @@ static int jpeg_dec_ioctl(unsigned int cmd, unsigned long arg, struct file *file
 }
 #endif				/* JPEG_DEC_DRIVER */
 
+/* program one encode job, the caller checked the encoder is owned */
+static int jpeg_enc_config_hw(JPEG_ENC_DRV_IN *cfgEnc)
+{
+	unsigned int ret;
+
+	/* 0. reset */
+	jpeg_drv_enc_reset();
+
+	/* 1. set src config */
+	/* memset(&src_cfg, 0, sizeof(JpegDrvEncSrcCfg)); */
+
+	/* src_cfg.luma_addr = cfgEnc->srcBufferAddr; */
+	/* if (cfgEnc->encFormat == NV12 || cfgEnc->encFormat == NV21) */
+	/* { */
+	/* unsigned int srcChromaAddr = cfgEnc->srcChromaAddr; */
+	/* srcChromaAddr = TO_CEIL(srcChromaAddr, 128);    //((srcChromaAddr+127)&~127); */
+	/* src_cfg.chroma_addr = srcChromaAddr; */
+	/* } */
+	/*  */
+	/* src_cfg.width = cfgEnc->encWidth; */
+	/* src_cfg.height = cfgEnc->encHeight; */
+	/* src_cfg.yuv_format = cfgEnc->encFormat; */
+
+	/* 1. set src config */
+	JPEG_MSG("[JPEGDRV]SRC_IMG: %x %x, DU:%x, fmt:%x!!\n", cfgEnc->encWidth,
+		 cfgEnc->encHeight, cfgEnc->totalEncDU, cfgEnc->encFormat);
+
+	ret =
+	    jpeg_drv_enc_set_src_image(cfgEnc->encWidth, cfgEnc->encHeight, cfgEnc->encFormat,
+				       cfgEnc->totalEncDU);
+	if (ret == 0) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce image failed\n");
+		return -EFAULT;
+	}
+
+	/* 2. set src buffer info */
+	JPEG_MSG("[JPEGDRV]SRC_BUF: addr %x, %x, stride %x, %x!!\n", cfgEnc->srcBufferAddr,
+		 cfgEnc->srcChromaAddr, cfgEnc->imgStride, cfgEnc->memStride);
+
+	ret =
+	    jpeg_drv_enc_set_src_buf(cfgEnc->encFormat, cfgEnc->imgStride, cfgEnc->memStride,
+				     cfgEnc->srcBufferAddr, cfgEnc->srcChromaAddr);
+	if (ret == 0) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce buffer failed\n");
+		return -EFAULT;
+	}
+
+	/* if (0 == jpeg_drv_enc_src_cfg(src_cfg)) */
+	/* { */
+	/* JPEG_MSG("JPEG Encoder src cfg failed\n"); */
+	/* return -EFAULT; */
+	/* } */
+
+	/* 3. set dst buffer info */
+	JPEG_MSG("[JPEGDRV]DST_BUF: addr:%x, size:%x, ofs:%x, mask:%x!!\n",
+		 cfgEnc->dstBufferAddr, cfgEnc->dstBufferSize, cfgEnc->dstBufAddrOffset,
+		 cfgEnc->dstBufAddrOffsetMask);
+
+	ret =
+	    jpeg_drv_enc_set_dst_buff(cfgEnc->dstBufferAddr, cfgEnc->dstBufferSize,
+				      cfgEnc->dstBufAddrOffset, cfgEnc->dstBufAddrOffsetMask);
+	if (ret == 0) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder set dst buffer failed\n");
+		return -EFAULT;
+	}
+	/* memset(&dst_cfg, 0, sizeof(JpegDrvEncDstCfg)); */
+	/*  */
+	/* dst_cfg.dst_addr = cfgEnc->dstBufferAddr; */
+	/* dst_cfg.dst_size = cfgEnc->dstBufferSize; */
+	/* dst_cfg.exif_en = cfgEnc->enableEXIF; */
+	/*  */
+	/*  */
+	/* if (0 == jpeg_drv_enc_dst_buff(dst_cfg)) */
+	/* return -EFAULT; */
+
+	/* 4 .set ctrl config */
+	JPEG_MSG("[JPEGDRV]ENC_CFG: exif:%d, q:%d, DRI:%d !!\n", cfgEnc->enableEXIF,
+		 cfgEnc->encQuality, cfgEnc->restartInterval);
+
+	jpeg_drv_enc_ctrl_cfg(cfgEnc->enableEXIF, cfgEnc->encQuality, cfgEnc->restartInterval);
+
+	/* memset(&ctrl_cfg, 0, sizeof(JpegDrvEncCtrlCfg)); */
+	/*  */
+	/* ctrl_cfg.quality = cfgEnc->encQuality; */
+	/* ctrl_cfg.gmc_disable = cfgEnc->disableGMC; */
+	/* ctrl_cfg.restart_interval = cfgEnc->restartInterval; */
+	/*  */
+
+	return 0;
+}
+
+/* wait for the running encode job, returns the HW result code */
+static unsigned int jpeg_enc_wait_hw(long timeout_ms, unsigned int *file_size)
+{
+	long timeout_jiff;
+	unsigned int jpeg_enc_wait_timeout = 0;
+	unsigned int ret;
+
+	jpeg_enc_wait_timeout = 0xFFFFFF;
+
+#ifdef FPGA_VERSION
+
+	do {
+		_jpeg_enc_int_status = REG_JPEG_ENC_INTERRUPT_STATUS;
+		jpeg_enc_wait_timeout--;
+	} while (_jpeg_enc_int_status == 0 && jpeg_enc_wait_timeout > 0);
+
+	if (jpeg_enc_wait_timeout == 0)
+		JPEG_MSG("JPEG Encoder timeout\n");
+
+	ret = jpeg_drv_enc_get_result(file_size);
+
+	JPEG_MSG("Result : %d, Size : %u, addres : 0x%x\n", ret, *file_size,
+		 ioread32(JPEG_ENC_BASE + 0x120));
+
+	if (_jpeg_enc_int_status != 1)
+		jpeg_drv_enc_dump_reg();
+
+	/* polled, so nobody acked ENC_DONE yet */
+	IMG_REG_WRITE(0, REG_ADDR_JPEG_ENC_INTERRUPT_STATUS);
+#else
+
+	/* set timeout */
+	timeout_jiff = timeout_ms * HZ / 1000;
+	JPEG_MSG("[JPEGDRV]JPEG Encoder Time Jiffies : %ld\n", timeout_jiff);
+
+	if (jpeg_isr_enc_lisr() < 0) {
+		wait_event_interruptible_timeout(enc_wait_queue, _jpeg_enc_int_status,
+						 timeout_jiff);
+		JPEG_MSG("[JPEGDRV]JPEG Encoder Wait done !!\n");
+	} else {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder already done !!\n");
+	}
+
+	ret = jpeg_drv_enc_get_result(file_size);
+
+	JPEG_MSG("[JPEGDRV]Result : %d, Size : %u!!\n", ret, *file_size);
+	if (ret != 0) {
+		jpeg_drv_enc_dump_reg();
+
+		jpeg_drv_enc_warm_reset();
+	}
+#endif
+
+	/* consumed; the next job of a batch must not see this one's ENC_DONE */
+	_jpeg_enc_int_status = 0;
+
+	return ret;
+}
+
+/*
+ * Run a list of encode jobs back to back in one call, so burst shots and
+ * thumbnails pay one syscall and no user space wakeup per image. A failed
+ * job is reported in its result and the batch goes on with the next one.
+ */
+static int jpeg_enc_batch(unsigned long arg)
+{
+	JPEG_ENC_DRV_BATCH batch;
+	JPEG_ENC_DRV_IN cfgEnc;
+	JPEG_ENC_BATCH_RESULT res;
+	JPEG_ENC_DRV_IN __user *jobs;
+	JPEG_ENC_BATCH_RESULT __user *results;
+	unsigned int i;
+	int err = 0;
+
+	if (copy_from_user(&batch, (void *)arg, sizeof(JPEG_ENC_DRV_BATCH))) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder : Copy from user error\n");
+		return -EFAULT;
+	}
+	if (batch.count == 0 || batch.count > JPEG_ENC_BATCH_MAX) {
+		JPEG_WRN("JPEG Encoder batch count %u out of range\n", batch.count);
+		return -EINVAL;
+	}
+
+	jobs = (JPEG_ENC_DRV_IN __user *)(unsigned long)batch.jobs;
+	results = (JPEG_ENC_BATCH_RESULT __user *)(unsigned long)batch.results;
+
+	for (i = 0; i < batch.count; i++) {
+		if (signal_pending(current)) {
+			err = -ERESTARTSYS;
+			break;
+		}
+		if (copy_from_user(&cfgEnc, &jobs[i], sizeof(JPEG_ENC_DRV_IN))) {
+			err = -EFAULT;
+			break;
+		}
+
+		memset(&res, 0, sizeof(res));
+		if (jpeg_enc_config_hw(&cfgEnc)) {
+			res.result = JPEG_ENC_BATCH_CFG_ERR;
+		} else {
+			jpeg_drv_enc_start();
+			res.result = jpeg_enc_wait_hw(batch.timeout, &res.fileSize);
+			res.cycleCount = jpeg_drv_enc_get_cycle_count();
+		}
+
+		if (copy_to_user(&results[i], &res, sizeof(res))) {
+			err = -EFAULT;
+			break;
+		}
+	}
+
+	batch.done = i;
+	if (copy_to_user((void *)arg, &batch, sizeof(JPEG_ENC_DRV_BATCH)))
+		return -EFAULT;
+
+	return (i > 0) ? 0 : err;
+}
+
 static int jpeg_enc_ioctl(unsigned int cmd, unsigned long arg, struct file *file)
 {
 	int retValue;
 	/* unsigned int decResult; */
 
-	long timeout_jiff;
 	unsigned int file_size, enc_result_code;
 	/* unsigned int _jpeg_enc_int_status; */
-	unsigned int jpeg_enc_wait_timeout = 0;
 	unsigned int cycle_count;
 	unsigned int ret;
 
@@ -769,88 +976,8 @@ static int jpeg_enc_ioctl(unsigned int cmd, unsigned long arg, struct file *file
 			return -EFAULT;
 		}
 
-		/* 0. reset */
-		jpeg_drv_enc_reset();
-
-		/* 1. set src config */
-		/* memset(&src_cfg, 0, sizeof(JpegDrvEncSrcCfg)); */
-
-		/* src_cfg.luma_addr = cfgEnc.srcBufferAddr; */
-		/* if (cfgEnc.encFormat == NV12 || cfgEnc.encFormat == NV21) */
-		/* { */
-		/* unsigned int srcChromaAddr = cfgEnc.srcChromaAddr; */
-		/* srcChromaAddr = TO_CEIL(srcChromaAddr, 128);    //((srcChromaAddr+127)&~127); */
-		/* src_cfg.chroma_addr = srcChromaAddr; */
-		/* } */
-		/*  */
-		/* src_cfg.width = cfgEnc.encWidth; */
-		/* src_cfg.height = cfgEnc.encHeight; */
-		/* src_cfg.yuv_format = cfgEnc.encFormat; */
-
-		/* 1. set src config */
-		JPEG_MSG("[JPEGDRV]SRC_IMG: %x %x, DU:%x, fmt:%x!!\n", cfgEnc.encWidth,
-			 cfgEnc.encHeight, cfgEnc.totalEncDU, cfgEnc.encFormat);
-
-		ret =
-		    jpeg_drv_enc_set_src_image(cfgEnc.encWidth, cfgEnc.encHeight, cfgEnc.encFormat,
-					       cfgEnc.totalEncDU);
-		if (ret == 0) {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce image failed\n");
-			return -EFAULT;
-		}
-
-		/* 2. set src buffer info */
-		JPEG_MSG("[JPEGDRV]SRC_BUF: addr %x, %x, stride %x, %x!!\n", cfgEnc.srcBufferAddr,
-			 cfgEnc.srcChromaAddr, cfgEnc.imgStride, cfgEnc.memStride);
-
-		ret =
-		    jpeg_drv_enc_set_src_buf(cfgEnc.encFormat, cfgEnc.imgStride, cfgEnc.memStride,
-					     cfgEnc.srcBufferAddr, cfgEnc.srcChromaAddr);
-		if (ret == 0) {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce buffer failed\n");
-			return -EFAULT;
-		}
-
-		/* if (0 == jpeg_drv_enc_src_cfg(src_cfg)) */
-		/* { */
-		/* JPEG_MSG("JPEG Encoder src cfg failed\n"); */
-		/* return -EFAULT; */
-		/* } */
-
-		/* 3. set dst buffer info */
-		JPEG_MSG("[JPEGDRV]DST_BUF: addr:%x, size:%x, ofs:%x, mask:%x!!\n",
-			 cfgEnc.dstBufferAddr, cfgEnc.dstBufferSize, cfgEnc.dstBufAddrOffset,
-			 cfgEnc.dstBufAddrOffsetMask);
-
-		ret =
-		    jpeg_drv_enc_set_dst_buff(cfgEnc.dstBufferAddr, cfgEnc.dstBufferSize,
-					      cfgEnc.dstBufAddrOffset, cfgEnc.dstBufAddrOffsetMask);
-		if (ret == 0) {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder set dst buffer failed\n");
+		if (jpeg_enc_config_hw(&cfgEnc))
 			return -EFAULT;
-		}
-		/* memset(&dst_cfg, 0, sizeof(JpegDrvEncDstCfg)); */
-		/*  */
-		/* dst_cfg.dst_addr = cfgEnc.dstBufferAddr; */
-		/* dst_cfg.dst_size = cfgEnc.dstBufferSize; */
-		/* dst_cfg.exif_en = cfgEnc.enableEXIF; */
-		/*  */
-		/*  */
-		/* if (0 == jpeg_drv_enc_dst_buff(dst_cfg)) */
-		/* return -EFAULT; */
-
-		/* 4 .set ctrl config */
-		JPEG_MSG("[JPEGDRV]ENC_CFG: exif:%d, q:%d, DRI:%d !!\n", cfgEnc.enableEXIF,
-			 cfgEnc.encQuality, cfgEnc.restartInterval);
-
-		jpeg_drv_enc_ctrl_cfg(cfgEnc.enableEXIF, cfgEnc.encQuality, cfgEnc.restartInterval);
-
-		/* memset(&ctrl_cfg, 0, sizeof(JpegDrvEncCtrlCfg)); */
-		/*  */
-		/* ctrl_cfg.quality = cfgEnc.encQuality; */
-		/* ctrl_cfg.gmc_disable = cfgEnc.disableGMC; */
-		/* ctrl_cfg.restart_interval = cfgEnc.restartInterval; */
-		/*  */
 		break;
 
 	case JPEG_ENC_IOCTL_START:
@@ -883,49 +1010,7 @@ static int jpeg_enc_ioctl(unsigned int cmd, unsigned long arg, struct file *file
 			return -EFAULT;
 		}
 
-		/* TODO:    ENC_DONE in REG_JPEG_ENC_INTERRUPT_STATUS need to set to 0 after read. */
-		jpeg_enc_wait_timeout = 0xFFFFFF;
-
-#ifdef FPGA_VERSION
-
-		do {
-			_jpeg_enc_int_status = REG_JPEG_ENC_INTERRUPT_STATUS;
-			jpeg_enc_wait_timeout--;
-		} while (_jpeg_enc_int_status == 0 && jpeg_enc_wait_timeout > 0);
-
-		if (jpeg_enc_wait_timeout == 0)
-			JPEG_MSG("JPEG Encoder timeout\n");
-
-		ret = jpeg_drv_enc_get_result(&file_size);
-
-		JPEG_MSG("Result : %d, Size : %u, addres : 0x%x\n", ret, file_size,
-			 ioread32(JPEG_ENC_BASE + 0x120));
-
-		if (_jpeg_enc_int_status != 1)
-			jpeg_drv_enc_dump_reg();
-#else
-
-		/* set timeout */
-		timeout_jiff = enc_result.timeout * HZ / 1000;
-		JPEG_MSG("[JPEGDRV]JPEG Encoder Time Jiffies : %ld\n", timeout_jiff);
-
-		if (jpeg_isr_enc_lisr() < 0) {
-			wait_event_interruptible_timeout(enc_wait_queue, _jpeg_enc_int_status,
-							 timeout_jiff);
-			JPEG_MSG("[JPEGDRV]JPEG Encoder Wait done !!\n");
-		} else {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder already done !!\n");
-		}
-
-		ret = jpeg_drv_enc_get_result(&file_size);
-
-		JPEG_MSG("[JPEGDRV]Result : %d, Size : %u!!\n", ret, file_size);
-		if (ret != 0) {
-			jpeg_drv_enc_dump_reg();
-
-			jpeg_drv_enc_warm_reset();
-		}
-#endif
+		ret = jpeg_enc_wait_hw(enc_result.timeout, &file_size);
 
 		cycle_count = jpeg_drv_enc_get_cycle_count();
 
@@ -943,6 +1028,18 @@ static int jpeg_enc_ioctl(unsigned int cmd, unsigned long arg, struct file *file
 		}
 		break;
 
+	case JPEG_ENC_IOCTL_BATCH:
+		if (*pStatus != JPEG_ENC_PROCESS) {
+			JPEG_WRN("Permission Denied! This process can not access encoder");
+			return -EFAULT;
+		}
+		if (enc_status == 0) {
+			JPEG_WRN("Encoder status is available, HOW COULD THIS HAPPEN ??");
+			*pStatus = 0;
+			return -EFAULT;
+		}
+		return jpeg_enc_batch(arg);
+
 	case JPEG_ENC_IOCTL_DEINIT:
 		/*JPEG_MSG("[JPEGDRV][IOCTL] JPEG Encoder Deinit!!\n");*/
 		/* copy input parameters */
@@ -1141,6 +1238,7 @@ static long compat_jpeg_ioctl(struct file *filp, unsigned int cmd, unsigned long
 	case JPEG_DEC_IOCTL_RESUME:
 	case JPEG_DEC_IOCTL_FLUSH_CMDQ:
 	case JPEG_ENC_IOCTL_CONFIG:
+	case JPEG_ENC_IOCTL_BATCH:
 		return filp->f_op->unlocked_ioctl(filp, cmd, (unsigned long)compat_ptr(arg));
 
 	default:
@@ -1169,6 +1267,7 @@ static long jpeg_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned lo
 	case JPEG_ENC_IOCTL_WAIT:
 	case JPEG_ENC_IOCTL_DEINIT:
 	case JPEG_ENC_IOCTL_START:
+	case JPEG_ENC_IOCTL_BATCH:
 		return jpeg_enc_ioctl(cmd, arg, file);
 	default:
 		break;
@@ -535,6 +535,30 @@ typedef struct {
 } JPEG_ENC_DRV_OUT;
 
 
+/* per job output of JPEG_ENC_IOCTL_BATCH */
+typedef struct {
+	unsigned int result;
+	unsigned int fileSize;
+	unsigned int cycleCount;
+
+} JPEG_ENC_BATCH_RESULT;
+
+#define JPEG_ENC_BATCH_MAX	64
+/* JPEG_ENC_BATCH_RESULT.result when the job could not be programmed */
+#define JPEG_ENC_BATCH_CFG_ERR	0xFF
+
+/* user pointers are carried as u64 so 32 and 64 bit callers share the layout */
+typedef struct {
+	unsigned long long jobs;	/* JPEG_ENC_DRV_IN[count] */
+	unsigned long long results;	/* JPEG_ENC_BATCH_RESULT[count] */
+	unsigned int count;
+	unsigned int timeout;		/* per job, in ms */
+	unsigned int done;		/* out: jobs run, including failed ones */
+	unsigned int reserved;
+
+} JPEG_ENC_DRV_BATCH;
+
+
 typedef struct {
 	unsigned long startAddr;	/* In : */
 	unsigned long size;
@@ -635,6 +659,7 @@ typedef struct {
 #define JPEG_ENC_IOCTL_WARM_RESET   _IO(JPEG_IOCTL_MAGIC, 20)
 #define JPEG_ENC_IOCTL_DUMP_REG     _IO(JPEG_IOCTL_MAGIC, 21)
 #define JPEG_ENC_IOCTL_RW_REG       _IO(JPEG_IOCTL_MAGIC, 22)
+#define JPEG_ENC_IOCTL_BATCH        _IOWR(JPEG_IOCTL_MAGIC, 23, JPEG_ENC_DRV_BATCH)
 
 #ifdef CONFIG_COMPAT
 
@@ -390,112 +390,113 @@ int mt_led_set_pwm(int pwm_num, struct nled_setting *led)
 }
 
 /************************ led breath function*****************************/
-/*************************************************************************
-//func is to swtich to breath mode from PWM mode of ISINK
-//para: enable: 1 : breath mode; 0: PWM mode;
-*************************************************************************/
-#if 0
-static int led_switch_breath_pmic(enum mt65xx_led_pmic pmic_type,
-				  struct nled_setting *led, int enable)
+/*
+ * ISINK breath mode: the PMIC ramps the sink current up (TR1 then TR2),
+ * holds it (TON), ramps it down (TF1 then TF2) and stays dark (TOFF) on its
+ * own, so a fading notification LED costs no cpu wakeup per step. The
+ * selectors are looked up once from delay_on/delay_off when the blink is set.
+ */
+static int nled_breath;
+module_param(nled_breath, int, 0644);
+MODULE_PARM_DESC(nled_breath, "fade ISINK notification LED blinks in PMIC breath mode");
+
+#define BREATH_SEL_NUM 16
+/* breath segment length in ms of each TR1/TR2/TF1/TF2/TON selector */
+static const int breath_time_array[BREATH_SEL_NUM] = {
+	123, 338, 523, 707, 926, 1107, 1291, 1507,
+	1691, 1876, 2091, 2276, 2460, 2676, 2860, 3075
+};
+
+/* TOFF selector, in ms */
+static const int breath_off_array[BREATH_SEL_NUM] = {
+	246, 677, 1046, 1417, 1845, 2214, 2583, 2954,
+	3390, 3756, 4126, 4552, 4898, 5366, 5718, 6185
+};
+
+struct isink_breath_regs {
+	PMU_FLAGS_LIST_ENUM mode;
+	PMU_FLAGS_LIST_ENUM step;
+	PMU_FLAGS_LIST_ENUM tr1;
+	PMU_FLAGS_LIST_ENUM tr2;
+	PMU_FLAGS_LIST_ENUM tf1;
+	PMU_FLAGS_LIST_ENUM tf2;
+	PMU_FLAGS_LIST_ENUM ton;
+	PMU_FLAGS_LIST_ENUM toff;
+	PMU_FLAGS_LIST_ENUM ck_pdn;
+	PMU_FLAGS_LIST_ENUM ck_sel;
+	PMU_FLAGS_LIST_ENUM en;
+};
+
+#define ISINK_BREATH_REGS(ch) {						\
+	PMIC_ISINK_CH##ch##_MODE, PMIC_ISINK_CH##ch##_STEP,		\
+	PMIC_ISINK_BREATH##ch##_TR1_SEL, PMIC_ISINK_BREATH##ch##_TR2_SEL,	\
+	PMIC_ISINK_BREATH##ch##_TF1_SEL, PMIC_ISINK_BREATH##ch##_TF2_SEL,	\
+	PMIC_ISINK_BREATH##ch##_TON_SEL, PMIC_ISINK_BREATH##ch##_TOFF_SEL,	\
+	PMIC_RG_DRV_ISINK##ch##_CK_PDN, PMIC_RG_DRV_ISINK##ch##_CK_CKSEL,	\
+	PMIC_ISINK_CH##ch##_EN }
+
+/* NLED_ISINK0..3 are wired to ISINK channels 0, 1, 4 and 5 */
+static const struct isink_breath_regs isink_breath[] = {
+	ISINK_BREATH_REGS(0),
+	ISINK_BREATH_REGS(1),
+	ISINK_BREATH_REGS(4),
+	ISINK_BREATH_REGS(5),
+};
+
+static int find_breath_index(const int *array, int time_ms)
 {
-	/* int time_index = 0; */
-	/* int duty = 0; */
-	LEDS_DEBUG("led_blink_pmic: pmic_type=%d\n", pmic_type);
+	int i;
 
-	if ((pmic_type != MT65XX_LED_PMIC_NLED_ISINK0
-	     && pmic_type != MT65XX_LED_PMIC_NLED_ISINK1
-	     && pmic_type != MT65XX_LED_PMIC_NLED_ISINK2
-	     && pmic_type != MT65XX_LED_PMIC_NLED_ISINK3)
-	    || led->nled_mode != NLED_BLINK) {
-		return -1;
-	}
-	if (1 == enable) {
-		switch (pmic_type) {
-		case MT65XX_LED_PMIC_NLED_ISINK0:
-			pmic_set_register_value(PMIC_ISINK_CH0_MODE, ISINK_BREATH_MODE);
-			pmic_set_register_value(PMIC_ISINK_CH0_STEP, ISINK_3);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TRF_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TR1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TR2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TF1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TF2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TON_SEL, 0x02);
-			pmic_set_register_value(PMIC_ISINK_BREATH0_TOFF_SEL, 0x03);
-			pmic_set_register_value(PMIC_ISINK_DIM0_DUTY, 15);
-			pmic_set_register_value(PMIC_ISINK_DIM0_FSEL, 11);
-			/* pmic_set_register_value(PMIC_ISINK_CH0_EN,NLED_ON); */
-			break;
-		case MT65XX_LED_PMIC_NLED_ISINK1:
-			pmic_set_register_value(PMIC_ISINK_CH1_MODE, ISINK_BREATH_MODE);
-			pmic_set_register_value(PMIC_ISINK_CH1_STEP, ISINK_3);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TRF_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TR1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TR2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TF1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TF2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TON_SEL, 0x02);
-			pmic_set_register_value(PMIC_ISINK_BREATH1_TOFF_SEL, 0x03);
-			pmic_set_register_value(PMIC_ISINK_DIM1_DUTY, 15);
-			pmic_set_register_value(PMIC_ISINK_DIM1_FSEL, 11);
-			/* pmic_set_register_value(PMIC_ISINK_CH1_EN,NLED_ON); */
-			break;
-		case MT65XX_LED_PMIC_NLED_ISINK2:
-			pmic_set_register_value(PMIC_ISINK_CH4_MODE, ISINK_BREATH_MODE);
-			pmic_set_register_value(PMIC_ISINK_CH4_STEP, ISINK_3);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TRF_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TR1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TR2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TF1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TF2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TON_SEL, 0x02);
-			pmic_set_register_value(PMIC_ISINK_BREATH4_TOFF_SEL, 0x03);
-			pmic_set_register_value(PMIC_ISINK_DIM4_DUTY, 15);
-			pmic_set_register_value(PMIC_ISINK_DIM4_FSEL, 11);
-			/* pmic_set_register_value(PMIC_ISINK_CH4_EN,NLED_ON); */
-			break;
-		case MT65XX_LED_PMIC_NLED_ISINK3:
-			pmic_set_register_value(PMIC_ISINK_CH5_MODE, ISINK_BREATH_MODE);
-			pmic_set_register_value(PMIC_ISINK_CH5_STEP, ISINK_3);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TRF_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TR1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TR2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TF1_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TF2_SEL, 0x04);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TON_SEL, 0x02);
-			pmic_set_register_value(PMIC_ISINK_BREATH5_TOFF_SEL, 0x03);
-			pmic_set_register_value(PMIC_ISINK_DIM5_DUTY, 15);
-			pmic_set_register_value(PMIC_ISINK_DIM5_FSEL, 11);
-			/* pmic_set_register_value(PMIC_ISINK_CH5_EN,NLED_ON); */
-			break;
-		default:
-			break;
-		}
-	} else {
-		switch (pmic_type) {
-		case MT65XX_LED_PMIC_NLED_ISINK0:
-			pmic_set_register_value(PMIC_ISINK_CH0_MODE,
-						ISINK_PWM_MODE);
-			break;
-		case MT65XX_LED_PMIC_NLED_ISINK1:
-			pmic_set_register_value(PMIC_ISINK_CH1_MODE,
-						ISINK_PWM_MODE);
-			break;
-		case MT65XX_LED_PMIC_NLED_ISINK2:
-			pmic_set_register_value(PMIC_ISINK_CH4_MODE,
-						ISINK_PWM_MODE);
-			break;
-		case MT65XX_LED_PMIC_NLED_ISINK3:
-			pmic_set_register_value(PMIC_ISINK_CH5_MODE,
-						ISINK_PWM_MODE);
-			break;
-		default:
-			break;
-		}
+	for (i = 0; i < BREATH_SEL_NUM - 1; i++) {
+		if (time_ms <= array[i])
+			return i;
 	}
-	return 0;
-
+	return BREATH_SEL_NUM - 1;
 }
+
+/*
+ * A quarter of the on time rises, a quarter falls, the rest holds; each
+ * ramp is split evenly over its two segments. Returns -1 when the blink is
+ * too short to fade, the caller then keeps the square PWM blink.
+ */
+static int led_breath_pmic(enum mt65xx_led_pmic pmic_type,
+			   struct nled_setting *led)
+{
+#ifdef CONFIG_MTK_PMIC
+	const struct isink_breath_regs *regs;
+	int ramp, tr, ton, toff;
+
+	if (pmic_type < MT65XX_LED_PMIC_NLED_ISINK0
+	    || pmic_type > MT65XX_LED_PMIC_NLED_ISINK3
+	    || led->nled_mode != NLED_BLINK
+	    || led->blink_on_time < 4 * breath_time_array[0])
+		return -1;
+
+	ramp = led->blink_on_time / 4;
+	tr = find_breath_index(breath_time_array, ramp / 2);
+	ton = find_breath_index(breath_time_array, led->blink_on_time - 2 * ramp);
+	toff = find_breath_index(breath_off_array, led->blink_off_time);
+	LEDS_DEBUG("led_breath_pmic: pmic_type=%d tr=%d ton=%d toff=%d\n",
+		   pmic_type, tr, ton, toff);
+
+	regs = &isink_breath[pmic_type - MT65XX_LED_PMIC_NLED_ISINK0];
+	pmic_set_register_value(PMIC_RG_DRV_32K_CK_PDN, 0x0);	/* Disable power down */
+	pmic_set_register_value(regs->ck_pdn, 0);
+	pmic_set_register_value(regs->ck_sel, 0);
+	pmic_set_register_value(regs->mode, ISINK_BREATH_MODE);
+	pmic_set_register_value(regs->step, led->blink_level);
+	pmic_set_register_value(regs->tr1, tr);
+	pmic_set_register_value(regs->tr2, tr);
+	pmic_set_register_value(regs->tf1, tr);
+	pmic_set_register_value(regs->tf2, tr);
+	pmic_set_register_value(regs->ton, ton);
+	pmic_set_register_value(regs->toff, toff);
+	pmic_set_register_value(regs->en, NLED_ON);
+	return 0;
+#else
+	return -1;
 #endif
+}
 
 #define PMIC_PERIOD_NUM 8
 /* 100 * period, ex: 0.01 Hz -> 0.01 * 100 = 1 */
@@ -533,6 +534,8 @@ int mt_led_blink_pmic(enum mt65xx_led_pmic pmic_type, struct nled_setting *led)
 
 	LEDS_DEBUG("LED blink on time = %d offtime = %d\n",
 		   led->blink_on_time, led->blink_off_time);
+	if (nled_breath && led_breath_pmic(pmic_type, led) == 0)
+		return 0;
 	time_index =
 	    find_time_index_pmic(led->blink_on_time + led->blink_off_time);
 	LEDS_DEBUG("LED index is %d  freqsel=%d\n", time_index,
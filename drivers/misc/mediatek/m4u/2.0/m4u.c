@@ -17,6 +17,7 @@
 #include <linux/slab.h>
 #include <linux/timer.h>
 #include <mt-plat/sync_write.h>
+#include <mt-plat/mt_cache_sync.h>
 #include <mach/mt_clkmgr.h>
 #include <mach/irqs.h>
 #include <asm/cacheflush.h>
@@ -25,6 +26,7 @@
 #include <linux/dma-direction.h>
 #include <asm/page.h>
 #include <linux/proc_fs.h>
+#include <linux/workqueue.h>
 
 #include "m4u_priv.h"
 #include "m4u.h"
@@ -82,6 +84,70 @@ static int m4u_buf_show(void *priv, unsigned int mva_start, unsigned int mva_end
 }
 
 
+/* page table entries currently used by each port's buffers, by entry size */
+static unsigned int gM4uPortPgsizeCnt[M4U_PORT_NR][M4U_PGSIZE_NR];
+static DEFINE_SPINLOCK(gM4uPortPgsizeLock);
+
+static void m4u_port_pgsize_update(M4U_PORT_ID port, const unsigned int *pgsize_cnt, int add)
+{
+	unsigned long flags;
+	int i;
+
+	if (port < 0 || port >= M4U_PORT_NR)
+		return;
+
+	spin_lock_irqsave(&gM4uPortPgsizeLock, flags);
+	for (i = 0; i < M4U_PGSIZE_NR; i++) {
+		if (add)
+			gM4uPortPgsizeCnt[port][i] += pgsize_cnt[i];
+		else
+			gM4uPortPgsizeCnt[port][i] -= pgsize_cnt[i];
+	}
+	spin_unlock_irqrestore(&gM4uPortPgsizeLock, flags);
+}
+
+/*
+ * TLB miss estimate per port: a sequential pass over a buffer walks every
+ * entry once, so entries per MB mapped is the expected number of main TLB
+ * misses per MB accessed (256 when everything is 4K mapped).
+ */
+int m4u_dump_port_pgsize(struct seq_file *seq)
+{
+	static const unsigned int pgsize_kb[M4U_PGSIZE_NR] = { 4, 64, 1024, 16384 };
+	unsigned int cnt[M4U_PGSIZE_NR];
+	unsigned long long kb, entries;
+	unsigned long flags;
+	M4U_PERF_COUNT perf;
+	int port, i;
+
+	M4U_PRINT_LOG_OR_SEQ(seq, "port                     4K     64K    1M     16M    mapped(KB)  miss/MB(est)\n");
+	for (port = 0; port < M4U_PORT_NR; port++) {
+		spin_lock_irqsave(&gM4uPortPgsizeLock, flags);
+		memcpy(cnt, gM4uPortPgsizeCnt[port], sizeof(cnt));
+		spin_unlock_irqrestore(&gM4uPortPgsizeLock, flags);
+
+		kb = 0;
+		entries = 0;
+		for (i = 0; i < M4U_PGSIZE_NR; i++) {
+			kb += (unsigned long long)cnt[i] * pgsize_kb[i];
+			entries += cnt[i];
+		}
+		if (!entries)
+			continue;
+
+		M4U_PRINT_LOG_OR_SEQ(seq, "%-24s %-6u %-6u %-6u %-6u %-11llu %llu\n",
+				     m4u_get_port_name(port), cnt[M4U_PGSIZE_4K], cnt[M4U_PGSIZE_64K],
+				     cnt[M4U_PGSIZE_1M], cnt[M4U_PGSIZE_16M], kb,
+				     div64_u64(entries * 1024 + kb - 1, kb));
+	}
+
+	m4u_get_perf_counter(0, 0, &perf);
+	M4U_PRINT_LOG_OR_SEQ(seq, "m4u0 monitor: trans=%u, main_miss=%u, pfh_miss=%u\n",
+			     perf.transaction_cnt, perf.main_tlb_miss_cnt, perf.pfh_tlb_miss_cnt);
+
+	return 0;
+}
+
 int m4u_dump_buf_info(struct seq_file *seq)
 {
 
@@ -589,6 +655,92 @@ int m4u_destroy_sgtable(struct sg_table *table)
 
 /* #define __M4U_MAP_MVA_TO_KERNEL_FOR_DEBUG__ */
 
+/*
+ * lazy TLB invalidation on dealloc: the page table is cleared at once but the
+ * buffer info is parked on gM4uLazyFreeList with its mva still allocated, and
+ * only after one batched range invalidate covering all parked buffers is the
+ * mva given back to the allocator. Keeping the buffer info until then keeps
+ * mva_get_priv() valid for the parked ranges.
+ * A batch is flushed when M4U_LAZY_FREE_MAX_NR buffers or M4U_LAZY_FREE_MAX_SIZE
+ * bytes are pending, M4U_LAZY_FREE_DELAY_MS after the first one was parked,
+ * or when an mva allocation fails.
+ */
+#define M4U_LAZY_FREE_MAX_NR	32
+#define M4U_LAZY_FREE_MAX_SIZE	(64 * SZ_1M)
+#define M4U_LAZY_FREE_DELAY_MS	10
+
+static LIST_HEAD(gM4uLazyFreeList);
+static unsigned int gM4uLazyFreeNr;
+static unsigned int gM4uLazyFreeSize;
+static DEFINE_MUTEX(gM4uLazyFreeMutex);
+
+static void m4u_lazy_free_work_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(gM4uLazyFreeWork, m4u_lazy_free_work_fn);
+
+/* invalidate the TLB once for all parked buffers, then release their mva.
+ * returns the number of buffers released.
+ */
+static int m4u_lazy_free_flush(void)
+{
+	m4u_buf_info_t *pMvaInfo, *pNext;
+	LIST_HEAD(flush_list);
+	unsigned int start = ~0U, end = 0;
+	int nr;
+
+	mutex_lock(&gM4uLazyFreeMutex);
+	list_splice_init(&gM4uLazyFreeList, &flush_list);
+	nr = gM4uLazyFreeNr;
+	gM4uLazyFreeNr = 0;
+	gM4uLazyFreeSize = 0;
+	mutex_unlock(&gM4uLazyFreeMutex);
+
+	if (!nr)
+		return 0;
+
+	list_for_each_entry(pMvaInfo, &flush_list, link) {
+		start = min(start, pMvaInfo->mva_align);
+		end = max(end, pMvaInfo->mva_align + pMvaInfo->size_align - 1);
+	}
+
+	/* ranges in between may still be mapped, invalidating them is harmless */
+	pMvaInfo = list_first_entry(&flush_list, m4u_buf_info_t, link);
+	m4u_flush_tlb_range(m4u_get_domain_by_port(pMvaInfo->port), start, end);
+
+	list_for_each_entry_safe(pMvaInfo, pNext, &flush_list, link) {
+		list_del(&pMvaInfo->link);
+		if (m4u_do_mva_free(pMvaInfo->mva, pMvaInfo->size))
+			m4u_aee_print("%s: do_mva_free fail, mva=0x%x, size=0x%x\n", __func__,
+				      pMvaInfo->mva, pMvaInfo->size);
+		m4u_free_buf_info(pMvaInfo);
+	}
+
+	M4ULOG_LOW("%s: %d buffers, tlb 0x%x-0x%x\n", __func__, nr, start, end);
+	return nr;
+}
+
+static void m4u_lazy_free_work_fn(struct work_struct *work)
+{
+	m4u_lazy_free_flush();
+}
+
+/* park an unmapped buffer, its mva and buffer info are released by m4u_lazy_free_flush() */
+static void m4u_lazy_free_add(m4u_buf_info_t *pMvaInfo)
+{
+	int flush_now;
+
+	mutex_lock(&gM4uLazyFreeMutex);
+	list_add_tail(&pMvaInfo->link, &gM4uLazyFreeList);
+	gM4uLazyFreeNr++;
+	gM4uLazyFreeSize += pMvaInfo->size_align;
+	flush_now = gM4uLazyFreeNr >= M4U_LAZY_FREE_MAX_NR || gM4uLazyFreeSize >= M4U_LAZY_FREE_MAX_SIZE;
+	if (!flush_now && gM4uLazyFreeNr == 1)
+		schedule_delayed_work(&gM4uLazyFreeWork, msecs_to_jiffies(M4U_LAZY_FREE_DELAY_MS));
+	mutex_unlock(&gM4uLazyFreeMutex);
+
+	if (flush_now)
+		m4u_lazy_free_flush();
+}
+
 int m4u_alloc_mva(m4u_client_t *client, M4U_PORT_ID port,
 		  unsigned long va, struct sg_table *sg_table,
 		  unsigned int size, unsigned int prot, unsigned int flags, unsigned int *pMva)
@@ -635,6 +787,14 @@ int m4u_alloc_mva(m4u_client_t *client, M4U_PORT_ID port,
 	else
 		mva = m4u_do_mva_alloc(va, size, pMvaInfo);
 
+	/* the space may be parked for lazy TLB invalidation, flush and retry */
+	if (mva == 0 && m4u_lazy_free_flush() > 0) {
+		if (flags & M4U_FLAGS_FIX_MVA)
+			mva = m4u_do_mva_alloc_fix(*pMva, size, pMvaInfo);
+		else
+			mva = m4u_do_mva_alloc(va, size, pMvaInfo);
+	}
+
 	if (mva == 0) {
 		m4u_aee_print("alloc mva fail: larb=%d,module=%s,size=%d\n",
 				m4u_port_2_larb_id(port), m4u_get_port_name(port), size);
@@ -650,11 +810,12 @@ int m4u_alloc_mva(m4u_client_t *client, M4U_PORT_ID port,
 	size_align = PAGE_ALIGN(mva + size - mva_align);
 
 	ret = m4u_map_sgtable(m4u_get_domain_by_port(port), mva_align, sg_table,
-			size_align, pMvaInfo->prot);
+			size_align, pMvaInfo->prot, pMvaInfo->pgsize_cnt);
 	if (ret < 0) {
 		M4UMSG("error to map sgtable\n");
 		goto err2;
 	}
+	m4u_port_pgsize_update(port, pMvaInfo->pgsize_cnt, 1);
 
 	pMvaInfo->mva = mva;
 	pMvaInfo->mva_align = mva_align;
@@ -770,7 +931,8 @@ int m4u_dealloc_mva_sg(int eModuleID, struct sg_table *sg_table,
 int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 {
 	m4u_buf_info_t *pMvaInfo;
-	int ret, is_err = 0;
+	m4u_domain_t *domain = m4u_get_domain_by_port(port);
+	int ret, is_err = 0, lazy = 1;
 	unsigned int size;
 
 	MMProfileLogEx(M4U_MMP_Events[M4U_MMP_DEALLOC_MVA], MMProfileFlagStart, port, mva);
@@ -790,15 +952,21 @@ int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 		   m4u_port_2_larb_id(port), m4u_get_port_name(port), mva, pMvaInfo->size);
 
 #ifdef M4U_TEE_SERVICE_ENABLE
-	if (pMvaInfo->flags & M4U_FLAGS_SEC_SHAREABLE)
+	if (pMvaInfo->flags & M4U_FLAGS_SEC_SHAREABLE) {
 		m4u_unmap_nonsec_buffer(mva, pMvaInfo->size);
+		lazy = 0;
+	}
 #endif
 
-	ret = m4u_unmap(m4u_get_domain_by_port(port), pMvaInfo->mva_align, pMvaInfo->size_align);
+	if (lazy)
+		ret = m4u_unmap_lazy(domain, pMvaInfo->mva_align, pMvaInfo->size_align);
+	else
+		ret = m4u_unmap(domain, pMvaInfo->mva_align, pMvaInfo->size_align);
 	if (ret) {
 		is_err = 1;
 		M4UMSG("m4u_unmap fail\n");
 	}
+	m4u_port_pgsize_update(pMvaInfo->port, pMvaInfo->pgsize_cnt, 0);
 
 	if (0 != pMvaInfo->va) {
 		/* non ion buffer*/
@@ -809,10 +977,13 @@ int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 		}
 	}
 
-	ret = m4u_do_mva_free(mva, pMvaInfo->size);
-	if (ret) {
-		is_err = 1;
-		M4UMSG("do_mva_free fail\n");
+	/* a lazily unmapped mva is released by m4u_lazy_free_flush() */
+	if (!lazy) {
+		ret = m4u_do_mva_free(mva, pMvaInfo->size);
+		if (ret) {
+			is_err = 1;
+			M4UMSG("do_mva_free fail\n");
+		}
 	}
 
 	if (pMvaInfo->va) {	/* buffer is allocated by va */
@@ -845,7 +1016,10 @@ int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 	}
 #endif
 
-	m4u_free_buf_info(pMvaInfo);
+	if (lazy)
+		m4u_lazy_free_add(pMvaInfo);
+	else
+		m4u_free_buf_info(pMvaInfo);
 
 	MMProfileLogEx(M4U_MMP_Events[M4U_MMP_DEALLOC_MVA], MMProfileFlagEnd, size, mva);
 
@@ -982,7 +1156,16 @@ int m4u_cache_sync_by_range(unsigned long va, unsigned int size,
 	if (va < PAGE_OFFSET) {	/* from user space */
 		ret = __m4u_cache_sync_user(va, size, sync_type);
 	} else {
-		ret = __m4u_cache_sync_kernel((void *)va, size, sync_type);
+		struct mt_cache_range range = {
+			.table = NULL,
+			.start = va,
+			.size = size,
+			.op = sync_type == M4U_CACHE_CLEAN_BY_RANGE ? MT_CACHE_SYNC_CLEAN :
+			      sync_type == M4U_CACHE_INVALID_BY_RANGE ? MT_CACHE_SYNC_INVALIDATE :
+			      MT_CACHE_SYNC_FLUSH,
+		};
+
+		ret = mt_cache_sync(&range, 1);
 	}
 
 #ifdef CONFIG_OUTER_CACHE
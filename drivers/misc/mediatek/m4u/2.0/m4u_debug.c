@@ -365,7 +365,7 @@ static int m4u_debug_set(void *data, u64 val)
 		sg_alloc_table(sg_table, page_num, GFP_KERNEL);
 		for_each_sg(sg_table->sgl, sg, sg_table->nents, i)
 			sg_set_page(sg, page + i, PAGE_SIZE, 0);
-		m4u_map_sgtable(domain, mva, sg_table, page_num * PAGE_SIZE, M4U_PROT_WRITE | M4U_PROT_READ);
+		m4u_map_sgtable(domain, mva, sg_table, page_num * PAGE_SIZE, M4U_PROT_WRITE | M4U_PROT_READ, NULL);
 		m4u_dump_pgtable(domain, NULL);
 		m4u_unmap(domain, mva, page_num * PAGE_SIZE);
 		m4u_dump_pgtable(domain, NULL);
@@ -390,7 +390,8 @@ static int m4u_debug_set(void *data, u64 val)
 			sg_dma_len(sg) = page_size;
 		}
 
-		m4u_map_sgtable(domain, mva, sg_table, page_num * page_size, M4U_PROT_WRITE | M4U_PROT_READ);
+		m4u_map_sgtable(domain, mva, sg_table, page_num * page_size, M4U_PROT_WRITE | M4U_PROT_READ,
+				NULL);
 		m4u_dump_pgtable(domain, NULL);
 		m4u_unmap(domain, mva, page_num * page_size);
 		m4u_dump_pgtable(domain, NULL);
@@ -413,7 +414,8 @@ static int m4u_debug_set(void *data, u64 val)
 			sg_dma_address(sg) = page_size * (i + 1);
 			sg_dma_len(sg) = page_size;
 		}
-		m4u_map_sgtable(domain, mva, sg_table, page_num * page_size, M4U_PROT_WRITE | M4U_PROT_READ);
+		m4u_map_sgtable(domain, mva, sg_table, page_num * page_size, M4U_PROT_WRITE | M4U_PROT_READ,
+				NULL);
 		m4u_dump_pgtable(domain, NULL);
 		m4u_unmap(domain, mva, page_num * page_size);
 		m4u_dump_pgtable(domain, NULL);
@@ -436,7 +438,8 @@ static int m4u_debug_set(void *data, u64 val)
 			sg_dma_address(sg) = page_size * (i + 1);
 			sg_dma_len(sg) = page_size;
 		}
-		m4u_map_sgtable(domain, mva, sg_table, page_num * page_size, M4U_PROT_WRITE | M4U_PROT_READ);
+		m4u_map_sgtable(domain, mva, sg_table, page_num * page_size, M4U_PROT_WRITE | M4U_PROT_READ,
+				NULL);
 		m4u_dump_pgtable(domain, NULL);
 		m4u_unmap(domain, mva, page_num * page_size);
 		m4u_dump_pgtable(domain, NULL);
@@ -456,7 +459,7 @@ static int m4u_debug_set(void *data, u64 val)
 		sg_dma_address(sg) = 0x4000;
 		sg_dma_len(sg) = size;
 
-		m4u_map_sgtable(domain, mva, sg_table, size, M4U_PROT_WRITE | M4U_PROT_READ);
+		m4u_map_sgtable(domain, mva, sg_table, size, M4U_PROT_WRITE | M4U_PROT_READ, NULL);
 		m4u_dump_pgtable(domain, NULL);
 		m4u_unmap(domain, mva, size);
 		m4u_dump_pgtable(domain, NULL);
@@ -1350,6 +1353,40 @@ const struct file_operations m4u_debug_mva_fops = {
 	.release = seq_release,
 };
 
+int m4u_debug_port_pgsize_show(struct seq_file *s, void *unused)
+{
+	return m4u_dump_port_pgsize(s);
+}
+
+int m4u_debug_port_pgsize_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, m4u_debug_port_pgsize_show, inode->i_private);
+}
+
+const struct file_operations m4u_debug_port_pgsize_fops = {
+	.open = m4u_debug_port_pgsize_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = seq_release,
+};
+
+int m4u_debug_mva_stat_show(struct seq_file *s, void *unused)
+{
+	return m4u_mvaGraph_stat(s);
+}
+
+int m4u_debug_mva_stat_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, m4u_debug_mva_stat_show, inode->i_private);
+}
+
+const struct file_operations m4u_debug_mva_stat_fops = {
+	.open = m4u_debug_mva_stat_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = seq_release,
+};
+
 int m4u_debug_buf_show(struct seq_file *s, void *unused)
 {
 	m4u_dump_buf_info(s);
@@ -1452,6 +1489,15 @@ int m4u_debug_init(struct m4u_device *m4u_dev)
 	if (IS_ERR_OR_NULL(debug_file))
 		M4UMSG("m4u: failed to create debug files 9.\n");
 
+	debug_file = debugfs_create_file("mva_stat", 0444, m4u_dev->debug_root, domain, &m4u_debug_mva_stat_fops);
+	if (IS_ERR_OR_NULL(debug_file))
+		M4UMSG("m4u: failed to create debug files 10.\n");
+
+	debug_file = debugfs_create_file("port_pgsize", 0444, m4u_dev->debug_root, domain,
+					 &m4u_debug_port_pgsize_fops);
+	if (IS_ERR_OR_NULL(debug_file))
+		M4UMSG("m4u: failed to create debug files 11.\n");
+
 
 	return 0;
 }
@@ -1,3 +1,4 @@
+#include <linux/bitops.h>
 #include <linux/spinlock.h>
 #include "m4u_priv.h"
 
@@ -23,6 +24,89 @@ static short mvaGraph[MVA_MAX_BLOCK_NR + 1];
 static void *mvaInfoGraph[MVA_MAX_BLOCK_NR + 1];
 static DEFINE_SPINLOCK(gMvaGraph_lock);
 
+/*
+ * segregated free lists: every free region head in mvaGraph is linked into
+ * the list of its size class, class c holding regions of [2^c, 2^(c+1)) blocks.
+ * index 0 is never free, so it terminates the lists.
+ */
+#define MVA_FREE_CLASS_NR	12	/* 4095 blocks max */
+#define MVA_FREE_SCAN_MAX	8	/* fit search in the request's own class */
+#define MVA_FREE_CLASS(nr)	(fls(nr) - 1)
+
+static short mvaFreeNext[MVA_MAX_BLOCK_NR + 1];
+static short mvaFreePrev[MVA_MAX_BLOCK_NR + 1];
+static short mvaFreeHead[MVA_FREE_CLASS_NR];
+static unsigned long mvaFreeClassMap;	/* bit c set: class c not empty */
+
+static struct {
+	unsigned int alloc_cnt;
+	unsigned int alloc_fail_cnt;
+	unsigned int free_cnt;
+	unsigned int merge_cnt;
+	unsigned int split_cnt;
+} mvaStat;
+
+/* caller holds gMvaGraph_lock, mvaGraph[index] is the free region head */
+static void mva_free_list_add(short index)
+{
+	int c = MVA_FREE_CLASS(MVA_GET_NR(index));
+
+	mvaFreePrev[index] = 0;
+	mvaFreeNext[index] = mvaFreeHead[c];
+	if (mvaFreeHead[c])
+		mvaFreePrev[mvaFreeHead[c]] = index;
+	mvaFreeHead[c] = index;
+	__set_bit(c, &mvaFreeClassMap);
+}
+
+/* must be called before mvaGraph[index] is changed */
+static void mva_free_list_del(short index)
+{
+	int c = MVA_FREE_CLASS(MVA_GET_NR(index));
+	short prev = mvaFreePrev[index], next = mvaFreeNext[index];
+
+	if (prev)
+		mvaFreeNext[prev] = next;
+	else
+		mvaFreeHead[c] = next;
+	if (next)
+		mvaFreePrev[next] = prev;
+	if (!mvaFreeHead[c])
+		__clear_bit(c, &mvaFreeClassMap);
+
+	mvaFreeNext[index] = 0;
+	mvaFreePrev[index] = 0;
+}
+
+/*
+ * find a free region of at least nr blocks.
+ * a few regions of nr's own class are tried first so exact-ish fits do not
+ * break up large regions; otherwise the head of the smallest larger class
+ * always fits. The own class is only scanned completely when nothing larger
+ * is left.
+ */
+static short mva_free_list_find(short nr)
+{
+	int c = MVA_FREE_CLASS(nr);
+	int larger;
+	int scan = 0;
+	short index;
+
+	larger = find_next_bit(&mvaFreeClassMap, MVA_FREE_CLASS_NR, c + 1);
+
+	for (index = mvaFreeHead[c]; index; index = mvaFreeNext[index]) {
+		if (MVA_GET_NR(index) >= nr)
+			return index;
+		if (larger < MVA_FREE_CLASS_NR && ++scan >= MVA_FREE_SCAN_MAX)
+			break;
+	}
+
+	if (larger < MVA_FREE_CLASS_NR)
+		return mvaFreeHead[larger];
+
+	return 0;
+}
+
 void m4u_mvaGraph_init(void *priv_reserve)
 {
 	unsigned long irq_flags;
@@ -37,6 +121,13 @@ void m4u_mvaGraph_init(void *priv_reserve)
 	mvaGraph[MVA_MAX_BLOCK_NR] = MVA_MAX_BLOCK_NR;
 	mvaInfoGraph[MVA_MAX_BLOCK_NR] = priv_reserve;
 
+	memset(mvaFreeNext, 0, sizeof(mvaFreeNext));
+	memset(mvaFreePrev, 0, sizeof(mvaFreePrev));
+	memset(mvaFreeHead, 0, sizeof(mvaFreeHead));
+	mvaFreeClassMap = 0;
+	memset(&mvaStat, 0, sizeof(mvaStat));
+	mva_free_list_add(1);
+
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 }
 
@@ -100,6 +191,45 @@ void m4u_mvaGraph_dump(void)
 	M4ULOG_HIGH("[M4U_K] mva alloc dump done=========================<\n");
 }
 
+int m4u_mvaGraph_stat(struct seq_file *seq)
+{
+	unsigned int cls_cnt[MVA_FREE_CLASS_NR] = { 0 };
+	unsigned int cls_blocks[MVA_FREE_CLASS_NR] = { 0 };
+	unsigned int total_free = 0, largest = 0, frag_pct = 0;
+	unsigned long irq_flags;
+	short index;
+	int c;
+
+	spin_lock_irqsave(&gMvaGraph_lock, irq_flags);
+	for (c = 0; c < MVA_FREE_CLASS_NR; c++) {
+		for (index = mvaFreeHead[c]; index; index = mvaFreeNext[index]) {
+			cls_cnt[c]++;
+			cls_blocks[c] += MVA_GET_NR(index);
+			if (MVA_GET_NR(index) > largest)
+				largest = MVA_GET_NR(index);
+		}
+		total_free += cls_blocks[c];
+	}
+	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
+
+	/* share of free space not usable by one allocation of the largest size */
+	if (total_free)
+		frag_pct = 100 - largest * 100 / total_free;
+
+	M4U_PRINT_LOG_OR_SEQ(seq, "[M4U_K] mva allocator stat (unit: blocks of 0x%x bytes)\n", MVA_BLOCK_SIZE);
+	M4U_PRINT_LOG_OR_SEQ(seq, "alloc: %u, alloc fail: %u, free: %u, split: %u, merge: %u\n",
+			     mvaStat.alloc_cnt, mvaStat.alloc_fail_cnt, mvaStat.free_cnt,
+			     mvaStat.split_cnt, mvaStat.merge_cnt);
+	M4U_PRINT_LOG_OR_SEQ(seq, "free: %u, largest free: %u, fragmentation: %u%%\n",
+			     total_free, largest, frag_pct);
+	M4U_PRINT_LOG_OR_SEQ(seq, "class  blocks       regions  free_blocks\n");
+	for (c = 0; c < MVA_FREE_CLASS_NR; c++)
+		M4U_PRINT_LOG_OR_SEQ(seq, "%5d  %4d-%-4d    %7u  %11u\n", c, 1 << c,
+				     min((2 << c) - 1, MVA_MAX_BLOCK_NR), cls_cnt[c], cls_blocks[c]);
+
+	return 0;
+}
+
 void *mva_get_priv_ext(unsigned int mva)
 {
 	void *priv = NULL;
@@ -217,10 +347,10 @@ unsigned int m4u_do_mva_alloc(unsigned long va, unsigned int size, void *priv)
 	spin_lock_irqsave(&gMvaGraph_lock, irq_flags);
 
 	/* ----------------------------------------------- */
-	/* find first match free region */
-	for (s = 1; (s < (MVA_MAX_BLOCK_NR + 1)) && (mvaGraph[s] < nr); s += (mvaGraph[s] & MVA_BLOCK_NR_MASK))
-		;
-	if (s > MVA_MAX_BLOCK_NR) {
+	/* find a fitting free region from the size class lists */
+	s = (nr > 0 && nr <= MVA_MAX_BLOCK_NR) ? mva_free_list_find(nr) : 0;
+	if (s == 0) {
+		mvaStat.alloc_fail_cnt++;
 		spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 		M4UMSG("mva_alloc error: no available MVA region for %d blocks!\n", nr);
 		MMProfileLogEx(M4U_MMP_Events[M4U_MMP_M4U_ERROR], MMProfileFlagPulse, size, s);
@@ -230,6 +360,7 @@ unsigned int m4u_do_mva_alloc(unsigned long va, unsigned int size, void *priv)
 	/* ----------------------------------------------- */
 	/* alloc a mva region */
 	end = s + mvaGraph[s] - 1;
+	mva_free_list_del(s);
 
 	if (unlikely(nr == mvaGraph[s])) {
 		MVA_SET_BUSY(s);
@@ -247,7 +378,11 @@ unsigned int m4u_do_mva_alloc(unsigned long va, unsigned int size, void *priv)
 
 		mvaInfoGraph[s] = priv;
 		mvaInfoGraph[new_end] = priv;
+
+		mva_free_list_add(new_start);
+		mvaStat.split_cnt++;
 	}
+	mvaStat.alloc_cnt++;
 
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 
@@ -296,6 +431,7 @@ unsigned int m4u_do_mva_alloc_fix(unsigned int mva, unsigned int size, void *pri
 	/* carveout startIdx~startIdx+nr-1 out of region_start */
 	endIdx = startIdx + nr - 1;
 	region_end = region_start + MVA_GET_NR(region_start) - 1;
+	mva_free_list_del(region_start);
 
 	if (startIdx == region_start && endIdx == region_end) {
 		MVA_SET_BUSY(startIdx);
@@ -322,6 +458,13 @@ unsigned int m4u_do_mva_alloc_fix(unsigned int mva, unsigned int size, void *pri
 	mvaInfoGraph[startIdx] = priv;
 	mvaInfoGraph[endIdx] = priv;
 
+	/* the pieces left before/after the fixed region stay free */
+	if (startIdx != region_start)
+		mva_free_list_add(region_start);
+	if (endIdx != region_end)
+		mva_free_list_add(endIdx + 1);
+	mvaStat.alloc_cnt++;
+
 out:
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 
@@ -367,6 +510,8 @@ int m4u_do_mva_free(unsigned int mva, unsigned int size)
 	/* -------------------------------- */
 	/* merge with followed region */
 	if ((endIdx + 1 <= MVA_MAX_BLOCK_NR) && (!MVA_IS_BUSY(endIdx + 1))) {
+		mva_free_list_del(endIdx + 1);
+		mvaStat.merge_cnt++;
 		nr += mvaGraph[endIdx + 1];
 		mvaGraph[endIdx] = 0;
 		mvaGraph[endIdx + 1] = 0;
@@ -376,6 +521,8 @@ int m4u_do_mva_free(unsigned int mva, unsigned int size)
 	if ((startIdx - 1 > 0) && (!MVA_IS_BUSY(startIdx - 1))) {
 		int pre_nr = mvaGraph[startIdx - 1];
 
+		mva_free_list_del(startIdx - pre_nr);
+		mvaStat.merge_cnt++;
 		mvaGraph[startIdx] = 0;
 		mvaGraph[startIdx - 1] = 0;
 		startIdx -= pre_nr;
@@ -385,6 +532,8 @@ int m4u_do_mva_free(unsigned int mva, unsigned int size)
 	/* set region flags */
 	mvaGraph[startIdx] = nr;
 	mvaGraph[startIdx + nr - 1] = nr;
+	mva_free_list_add(startIdx);
+	mvaStat.free_cnt++;
 
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 
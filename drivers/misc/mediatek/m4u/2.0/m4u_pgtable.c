@@ -693,23 +693,31 @@ err_out:
 
 /* notes: both iova & paddr should be aligned. */
 static inline int m4u_map_phys_align(m4u_domain_t *m4u_domain, unsigned int iova,
-				     unsigned long paddr, unsigned int size, unsigned int prot)
+				     unsigned long paddr, unsigned int size, unsigned int prot,
+				     unsigned int *pgsize_cnt)
 {
-	int ret;
+	int ret, idx;
 
-	if (size == SZ_16M)
+	if (size == SZ_16M) {
 		ret = m4u_map_16M(m4u_domain, iova, paddr, prot);
-	else if (size == SZ_1M)
+		idx = M4U_PGSIZE_16M;
+	} else if (size == SZ_1M) {
 		ret = m4u_map_1M(m4u_domain, iova, paddr, prot);
-	else if (size == SZ_64K)
+		idx = M4U_PGSIZE_1M;
+	} else if (size == SZ_64K) {
 		ret = m4u_map_64K(m4u_domain, iova, paddr, prot);
-	else if (size == SZ_4K)
+		idx = M4U_PGSIZE_64K;
+	} else if (size == SZ_4K) {
 		ret = m4u_map_4K(m4u_domain, iova, paddr, prot);
-	else {
+		idx = M4U_PGSIZE_4K;
+	} else {
 		m4u_aee_print("%s: fail size=0x%x\n", __func__, size);
 		return -1;
 	}
 
+	if (!ret && pgsize_cnt)
+		pgsize_cnt[idx]++;
+
 	return ret;
 }
 
@@ -727,8 +735,9 @@ static inline int m4u_map_phys_align(m4u_domain_t *m4u_domain, unsigned int iova
 * @see     refer to kernel/drivers/iommu/iommu.c iommu_map()
 * @author K Zhang      @date 2013/11/19
 ************************************************************/
-int m4u_map_phys_range(m4u_domain_t *m4u_domain, unsigned int iova,
-		       unsigned long paddr, unsigned int size, unsigned int prot)
+static int __m4u_map_phys_range(m4u_domain_t *m4u_domain, unsigned int iova,
+				unsigned long paddr, unsigned int size, unsigned int prot,
+				unsigned int *pgsize_cnt)
 {
 	unsigned int min_pagesz;
 	int ret = 0;
@@ -794,7 +803,7 @@ int m4u_map_phys_range(m4u_domain_t *m4u_domain, unsigned int iova,
 			pgsize = SZ_16M;
 #endif
 
-		ret = m4u_map_phys_align(m4u_domain, iova, paddr, pgsize, prot);
+		ret = m4u_map_phys_align(m4u_domain, iova, paddr, pgsize, prot, pgsize_cnt);
 		if (ret)
 			break;
 
@@ -809,12 +818,46 @@ int m4u_map_phys_range(m4u_domain_t *m4u_domain, unsigned int iova,
 	return ret;
 }
 
+int m4u_map_phys_range(m4u_domain_t *m4u_domain, unsigned int iova,
+		       unsigned long paddr, unsigned int size, unsigned int prot)
+{
+	return __m4u_map_phys_range(m4u_domain, iova, paddr, size, prot, NULL);
+}
+
+/* map one physically contiguous run gathered from the sg_table */
+static int m4u_map_sg_run(m4u_domain_t *m4u_domain, unsigned int mva,
+			  dma_addr_t pa, unsigned int len, unsigned int prot, unsigned int *pgsize_cnt)
+{
+	int ret;
+
+	if (len == SZ_4K) {	/* lone page, skip the page size search */
+		ret = m4u_map_4K(m4u_domain, mva, pa, prot);
+		if (!ret && pgsize_cnt)
+			pgsize_cnt[M4U_PGSIZE_4K]++;
+		return ret;
+	}
+
+	return __m4u_map_phys_range(m4u_domain, mva, pa, len, prot, pgsize_cnt);
+}
+
+/***********************************************************/
+/** map a sg_table to mva.
+* @param   pgsize_cnt   -- if not NULL, number of 4K/64K/1M/16M entries
+*                          used is added to it, indexed by M4U_PGSIZE_*
+*
+* @remark  physically contiguous sg entries (e.g. pages of one high-order
+*          ION chunk) are merged into a run first, so the run can be mapped
+*          with the largest entries its mva/pa alignment allows.
+************************************************************/
 int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
-		    struct sg_table *sg_table, unsigned int size, unsigned int prot)
+		    struct sg_table *sg_table, unsigned int size, unsigned int prot,
+		    unsigned int *pgsize_cnt)
 {
-	int i, ret;
+	int i, ret = 0;
 	struct scatterlist *sg;
 	unsigned int map_mva = mva, map_end = mva + size;
+	dma_addr_t run_pa = 0;
+	unsigned int run_len = 0;
 
 	prot = m4u_prot_fixup(prot);
 
@@ -831,26 +874,40 @@ int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
 			len = sg->length;
 #endif
 
-		M4ULOG_LOW("%s: for_each_sg i: %d, len: %d, mva: 0x%x\n", __func__, i, len, map_mva);
+		M4ULOG_LOW("%s: for_each_sg i: %d, len: %d, mva: 0x%x\n", __func__, i, len, map_mva + run_len);
 
-		if (map_mva + len > map_end) {
-			M4UMSG("%s: map_mva(0x%x)+len(0x%x)>end(0x%x)\n", __func__, map_mva, len, map_end);
+		if (map_mva + run_len + len > map_end) {
+			M4UMSG("%s: map_mva(0x%x)+len(0x%x)>end(0x%x)\n", __func__, map_mva + run_len, len, map_end);
 			break;
 		}
-		if (len == SZ_4K) {	/* for most cases */
-			ret = m4u_map_4K(m4u_domain, map_mva, pa, prot);
-		} else {
-			ret = m4u_map_phys_range(m4u_domain, map_mva, pa, len, prot);
+
+		/* extend the current run while the next entry follows it physically */
+		if (run_len && pa == run_pa + run_len) {
+			run_len += len;
+			continue;
 		}
 
-		if (ret) {
-			M4UMSG("%s: ret: %d, i: %d, sg->dma: 0x%lx, sg->phy: 0x%lx, sg->offset: 0x%x\n",
-					__func__, ret, i, (unsigned long)sg_dma_address(sg),
-					(unsigned long)sg_phys(sg), sg->offset);
-			goto err_out;
-		} else {
-			map_mva += len;
+		if (run_len) {
+			ret = m4u_map_sg_run(m4u_domain, map_mva, run_pa, run_len, prot, pgsize_cnt);
+			if (ret)
+				break;
+			map_mva += run_len;
 		}
+
+		run_pa = pa;
+		run_len = len;
+	}
+
+	if (!ret && run_len) {
+		ret = m4u_map_sg_run(m4u_domain, map_mva, run_pa, run_len, prot, pgsize_cnt);
+		if (!ret)
+			map_mva += run_len;
+	}
+
+	if (ret) {
+		M4UMSG("%s: ret: %d, mva: 0x%x, pa: 0x%lx, len: 0x%x\n",
+				__func__, ret, map_mva, (unsigned long)run_pa, run_len);
+		goto err_out;
 	}
 
 	if (map_mva < map_end) {
@@ -894,7 +951,7 @@ int m4u_check_free_pte(m4u_domain_t *domain, imu_pgd_t *pgd)
 	}
 }
 
-int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size)
+static int __m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size, int flush_tlb)
 {
 	imu_pgd_t *pgd;
 	int i, ret;
@@ -944,12 +1001,31 @@ int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size)
 		}
 	}
 
-	m4u_invalid_tlb_by_range(domain, start, end_plus_1 - 1);
+	if (flush_tlb)
+		m4u_invalid_tlb_by_range(domain, start, end_plus_1 - 1);
 
 	write_unlock_domain(domain);
 	return 0;
 }
 
+int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size)
+{
+	return __m4u_unmap(domain, mva, size, 1);
+}
+
+/* clear the page table only, caller must m4u_flush_tlb_range() before the mva is reused */
+int m4u_unmap_lazy(m4u_domain_t *domain, unsigned int mva, unsigned int size)
+{
+	return __m4u_unmap(domain, mva, size, 0);
+}
+
+void m4u_flush_tlb_range(m4u_domain_t *domain, unsigned int mva_start, unsigned int mva_end)
+{
+	write_lock_domain(domain);
+	m4u_invalid_tlb_by_range(domain, mva_start, mva_end);
+	write_unlock_domain(domain);
+}
+
 int m4u_debug_pgtable_show(struct seq_file *s, void *unused)
 {
 	m4u_dump_pgtable(s->private, s);
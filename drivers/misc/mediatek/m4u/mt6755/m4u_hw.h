@@ -173,6 +173,7 @@ static inline int larb_port_2_m4u_port(int larb, int larb_port)
 	return M4U_PORT_UNKNOWN;
 }
 
+void m4u_get_perf_counter(int m4u_index, int m4u_slave_id, M4U_PERF_COUNT *pM4U_perf_count);
 void m4u_print_perf_counter(int m4u_index, int m4u_slave_id, const char *msg);
 int m4u_dump_reg(int m4u_index, unsigned int start);
 void smi_common_clock_on(void);
@@ -112,6 +112,15 @@ typedef struct {
 	unsigned int pgsize_bitmap;
 } m4u_domain_t;
 
+/* page table entry sizes, index of the pgsize_cnt arrays */
+enum {
+	M4U_PGSIZE_4K,
+	M4U_PGSIZE_64K,
+	M4U_PGSIZE_1M,
+	M4U_PGSIZE_16M,
+	M4U_PGSIZE_NR
+};
+
 typedef struct {
 	struct list_head link;
 	unsigned long va;
@@ -126,6 +135,7 @@ typedef struct {
 	unsigned int size_align;
 	int seq_id;
 	unsigned long mapped_kernel_va_for_debug;
+	unsigned int pgsize_cnt[M4U_PGSIZE_NR];
 } m4u_buf_info_t;
 
 typedef struct _M4U_MAU {
@@ -150,6 +160,7 @@ typedef int (mva_buf_fn_t)(void *priv, unsigned int mva_start, unsigned int mva_
 void m4u_mvaGraph_init(void *priv_reserve);
 void m4u_mvaGraph_dump_raw(void);
 void m4u_mvaGraph_dump(void);
+int m4u_mvaGraph_stat(struct seq_file *seq);
 void *mva_get_priv_ext(unsigned int mva);
 int mva_foreach_priv(mva_buf_fn_t *fn, void *data);
 void *mva_get_priv(unsigned int mva);
@@ -196,9 +207,13 @@ extern int gM4U_4G_DRAM_Mode;
 /* ================================= */
 /* ==== define in m4u.c     ===== */
 int m4u_dump_buf_info(struct seq_file *seq);
+int m4u_dump_port_pgsize(struct seq_file *seq);
 int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
-		    struct sg_table *sg_table, unsigned int size, unsigned int prot);
+		    struct sg_table *sg_table, unsigned int size, unsigned int prot,
+		    unsigned int *pgsize_cnt);
 int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size);
+int m4u_unmap_lazy(m4u_domain_t *domain, unsigned int mva, unsigned int size);
+void m4u_flush_tlb_range(m4u_domain_t *domain, unsigned int mva_start, unsigned int mva_end);
 
 
 void m4u_get_pgd(m4u_client_t *client, M4U_PORT_ID port, void **pgd_va, void **pgd_pa, unsigned int *size);
@@ -6,6 +6,10 @@
 #include <linux/printk.h>
 #include <linux/init.h>
 #include <linux/rwlock.h>
+#include <linux/mm.h>
+#include <linux/vmstat.h>
+#include <linux/jiffies.h>
+#include <linux/moduleparam.h>
 
 /* Trigger method for screen on/off */
 #ifdef CONFIG_HAS_EARLYSUSPEND
@@ -46,6 +50,26 @@ static int get_cma_aligned;			/* in PAGE_SIZE order */
 static int get_cma_num;				/* Number of allocation */
 static unsigned long get_cma_size;		/* in PAGES */
 static struct page **cma_aligned_pages;
+static int memory_lowpower_event;		/* new action to take */
+
+/*
+ * Prestaging -
+ * While the screen is on and free memory is plentiful, the task takes the
+ * aligned chunks of lowpower cma one by one, every prestage_sec seconds.
+ * Taking a chunk migrates the movable pages in it out to the non-PASR part
+ * of DRAM, and holding it keeps new movable allocations from landing there,
+ * so screen-off only has to collect what is left. Chunks are given back
+ * when reclaim runs (see the shrinker below) and prestaging then backs off.
+ * 0 disables it. Only used with aligned allocation (PASR).
+ */
+static unsigned int prestage_sec;
+static unsigned int prestage_free_pct = 20;	/* keep this % of RAM free */
+static bool prestage_release;
+static unsigned long prestage_hold_off;
+#define PRESTAGE_BACKOFF	(60 * HZ)
+
+module_param(prestage_sec, uint, S_IRUGO | S_IWUSR);
+module_param(prestage_free_pct, uint, S_IRUGO | S_IWUSR);
 
 /*
  * Set aligned allocation -
@@ -286,6 +310,9 @@ static void go_to_screenon(void)
 	/* Release pages */
 	release_memory();
 
+	/* Don't prestage right away at screen-on */
+	prestage_hold_off = jiffies + PRESTAGE_BACKOFF;
+
 out:
 	MLPT_END_PROFILE();
 	MLPT_PRINT("%s:-\n", __func__);
@@ -381,6 +408,100 @@ static void go_to_screenidle(void)
 	MLPT_PRINT("%s:-\n", __func__);
 }
 
+/* Number of held aligned chunks, they are always at the head of the array */
+static int prestage_held(void)
+{
+	int i = 0;
+
+	while (i < get_cma_num && cma_aligned_pages[i] != NULL)
+		++i;
+
+	return i;
+}
+
+/* Prestage one chunk if possible, return how long to sleep */
+static long memory_lowpower_prestage(void)
+{
+	long next = msecs_to_jiffies(prestage_sec * MSEC_PER_SEC);
+	unsigned long reserve;
+	struct page *page;
+	int held;
+
+	/* Only with the screen on */
+	if (!prestage_sec || cma_aligned_pages == NULL ||
+			!IS_ACTION_SCREENON(memory_lowpower_action) ||
+			!MlpsScreenOn(&memory_lowpower_state)) {
+		prestage_release = false;
+		return MAX_SCHEDULE_TIMEOUT;
+	}
+
+	/* Under memory pressure - give all prestaged chunks back */
+	if (prestage_release) {
+		prestage_release = false;
+		MLPT_PRINT("%s: release %d chunks\n", __func__, prestage_held());
+		release_memory();
+		prestage_hold_off = jiffies + PRESTAGE_BACKOFF;
+		return PRESTAGE_BACKOFF;
+	}
+
+	if (time_before(jiffies, prestage_hold_off))
+		return prestage_hold_off - jiffies;
+
+	held = prestage_held();
+	if (held >= get_cma_num)
+		return MAX_SCHEDULE_TIMEOUT;
+
+	reserve = get_cma_size + totalram_pages / 100 * prestage_free_pct;
+	if (global_page_state(NR_FREE_PAGES) < reserve)
+		return next;
+
+	/* Migration failed (pinned pages?) - try later */
+	if (get_memory_lowpower_cma_aligned(get_cma_size, get_cma_aligned, &page)) {
+		prestage_hold_off = jiffies + PRESTAGE_BACKOFF;
+		return PRESTAGE_BACKOFF;
+	}
+
+	MLPT_PRINT("%s: PFN[%lu] prestaged for [%d]\n", __func__, page_to_pfn(page), held);
+	insert_buffer(page, held);
+
+	return next;
+}
+
+static unsigned long memory_lowpower_shrink_count(struct shrinker *s, struct shrink_control *sc)
+{
+	if (!prestage_sec || cma_aligned_pages == NULL ||
+			!IS_ACTION_SCREENON(memory_lowpower_action))
+		return 0;
+
+	return prestage_held() * get_cma_size;
+}
+
+/* Don't touch the chunks here, let the task release them */
+static unsigned long memory_lowpower_shrink_scan(struct shrinker *s, struct shrink_control *sc)
+{
+	if (!prestage_release) {
+		prestage_release = true;
+		wake_up_process(memory_lowpower_task);
+	}
+
+	return SHRINK_STOP;
+}
+
+static struct shrinker memory_lowpower_shrinker = {
+	.count_objects = memory_lowpower_shrink_count,
+	.scan_objects = memory_lowpower_shrink_scan,
+	.seeks = DEFAULT_SEEKS,
+};
+
+/* Ask the task to take a new action */
+static void memory_lowpower_kick(enum power_state action)
+{
+	memory_lowpower_action = action;
+	smp_wmb();
+	memory_lowpower_event = 1;
+	wake_up_process(memory_lowpower_task);
+}
+
 /*
  * Main entry for memory lowpower operations -
  * No set_freezable(), no try_to_freeze().
@@ -388,6 +509,7 @@ static void go_to_screenidle(void)
 static int memory_lowpower_entry(void *p)
 {
 	enum power_state current_action = MLP_INIT;
+	long timeout;
 
 	/* Call freezer_do_not_count to skip me */
 	freezer_do_not_count();
@@ -396,27 +518,34 @@ static int memory_lowpower_entry(void *p)
 	do {
 		/* Start running */
 		set_current_state(TASK_RUNNING);
-		do {
-			/* Take proper actions */
-			current_action = memory_lowpower_action;
-			switch (current_action) {
-			case MLP_SCREENON:
-				go_to_screenon();
-				break;
-			case MLP_SCREENOFF:
-				go_to_screenoff();
-				break;
-			case MLP_SCREENIDLE:
-				go_to_screenidle();
-				break;
-			default:
-				MLPT_PRINT("%s: Invalid action[%d]\n", __func__, current_action);
-			}
-		} while (current_action != memory_lowpower_action);
+		/* Only on a new screen event, not on prestage timeouts */
+		while (xchg(&memory_lowpower_event, 0)) {
+			do {
+				/* Take proper actions */
+				current_action = memory_lowpower_action;
+				switch (current_action) {
+				case MLP_SCREENON:
+					go_to_screenon();
+					break;
+				case MLP_SCREENOFF:
+					go_to_screenoff();
+					break;
+				case MLP_SCREENIDLE:
+					go_to_screenidle();
+					break;
+				default:
+					MLPT_PRINT("%s: Invalid action[%d]\n", __func__, current_action);
+				}
+			} while (current_action != memory_lowpower_action);
+		}
+
+		/* Steer movable pages away while the screen is on */
+		timeout = memory_lowpower_prestage();
 
 		/* Schedule me */
 		set_current_state(TASK_INTERRUPTIBLE);
-		schedule();
+		if (!memory_lowpower_event && !prestage_release)
+			schedule_timeout(timeout);
 	} while (1);
 
 	return 0;
@@ -428,19 +557,13 @@ static int memory_lowpower_entry(void *p)
 static void memory_lowpower_early_suspend(struct early_suspend *h)
 {
 	MLPT_PRINT("%s: SCREENOFF!\n", __func__);
-	memory_lowpower_action = MLP_SCREENOFF;
-
-	/* Wake up task */
-	wake_up_process(memory_lowpower_task);
+	memory_lowpower_kick(MLP_SCREENOFF);
 }
 
 static void memory_lowpower_late_resume(struct early_suspend *h)
 {
 	MLPT_PRINT("%s: SCREENON!\n", __func__);
-	memory_lowpower_action = MLP_SCREENON;
-
-	/* Wake up task */
-	wake_up_process(memory_lowpower_task);
+	memory_lowpower_kick(MLP_SCREENON);
 }
 
 static struct early_suspend early_suspend_descriptor = {
@@ -460,12 +583,10 @@ static int memory_lowpower_fb_event(struct notifier_block *notifier, unsigned lo
 	case FB_EVENT_BLANK:
 		if (new_status == 0) {
 			MLPT_PRINT("%s: SCREENON!\n", __func__);
-			memory_lowpower_action = MLP_SCREENON;
-			wake_up_process(memory_lowpower_task);
+			memory_lowpower_kick(MLP_SCREENON);
 		} else {
 			MLPT_PRINT("%s: SCREENOFF!\n", __func__);
-			memory_lowpower_action = MLP_SCREENOFF;
-			wake_up_process(memory_lowpower_task);
+			memory_lowpower_kick(MLP_SCREENOFF);
 		}
 	}
 
@@ -518,6 +639,9 @@ int __init memory_lowpower_task_init(void)
 	SetMlpsInit(&memory_lowpower_state);
 	SetMlpsScreenOn(&memory_lowpower_state);
 
+	/* Give prestaged chunks back under memory pressure */
+	register_shrinker(&memory_lowpower_shrinker);
+
 out:
 	MLPT_PRINT("%s: memory_power_state[%lu]\n", __func__, memory_lowpower_state);
 	return ret;
@@ -14,6 +14,8 @@
 #include <linux/uaccess.h>
 #include <linux/init.h>
 #include <linux/mutex.h>
+#include <linux/slab.h>
+#include <linux/workqueue.h>
 #include <asm/page.h>
 #include <asm-generic/memory_model.h>
 
@@ -154,6 +156,29 @@ static struct SSVP_Region _svpregs[__MAX_NR_SSVPSUBS];
 
 #define _TUI_MBSIZE CONFIG_MTK_TUI_RAM_SIZE
 
+/*
+ * The SVP region is taken from CMA in chunks, not in one cma_alloc. A page
+ * that can not be migrated then only retries its own chunk, chunks can be
+ * held ahead of time (svp_prestage_mb) so going secure only has to migrate
+ * the rest, and a deferrable worker migrates the free chunks out now and
+ * then (svp_precompact_sec) so the region is mostly clean when DRM playback
+ * starts. The chunks are allocated in address order and always add up to
+ * the same contiguous range handed to secmem.
+ */
+#define SSVP_CHUNK_ORDER	10	/* 4 MiB */
+#define SSVP_CHUNK_PAGES	(1UL << SSVP_CHUNK_ORDER)
+
+static struct page **_svp_chunks;
+static unsigned long _svp_nr_chunks;
+static unsigned long _svp_chunks_held;
+static unsigned long _svp_compact_cursor;
+
+static unsigned int svp_prestage_mb;
+static unsigned int svp_precompact_sec;
+
+static void svp_prestage_func(struct work_struct *work);
+static DECLARE_DEFERRABLE_WORK(_svp_prestage_work, svp_prestage_func);
+
 static int memory_ssvp_init(struct reserved_mem *rmem)
 {
 	int ret;
@@ -333,6 +358,146 @@ static const struct file_operations tui_cma_fops = {
 	.write =    tui_cma_write,
 };
 
+static unsigned long svp_chunk_pages(unsigned long i)
+{
+	return min(SSVP_CHUNK_PAGES,
+		   _svpregs[SSVP_SUB_SVP].count - i * SSVP_CHUNK_PAGES);
+}
+
+/* memory_ssvp_mutex held */
+static bool svp_chunk_get(unsigned long i)
+{
+	unsigned long n = svp_chunk_pages(i);
+	unsigned long pfn = ssvp_cma.base_pfn + _svpregs[SSVP_SUB_SVP].start +
+			    i * SSVP_CHUNK_PAGES;
+	struct page *page;
+
+	if (_svp_chunks[i])
+		return true;
+
+	page = cma_alloc(ssvp_cma.cma, n,
+			 n == SSVP_CHUNK_PAGES ? SSVP_CHUNK_ORDER : 0);
+	if (!page)
+		return false;
+
+	/* cma_alloc moves on when a range is busy, that is not our chunk */
+	if (page_to_pfn(page) != pfn) {
+		cma_release(ssvp_cma.cma, page, n);
+		return false;
+	}
+
+	_svp_chunks[i] = page;
+	_svp_chunks_held++;
+	svp_usage_count += n;
+	return true;
+}
+
+/* memory_ssvp_mutex held */
+static void svp_chunk_put(unsigned long i)
+{
+	unsigned long n = svp_chunk_pages(i);
+
+	if (!_svp_chunks[i])
+		return;
+
+	cma_release(ssvp_cma.cma, _svp_chunks[i], n);
+	_svp_chunks[i] = NULL;
+	_svp_chunks_held--;
+	svp_usage_count -= n;
+}
+
+/* memory_ssvp_mutex held, true once every chunk is held */
+static bool svp_chunks_get_all(void)
+{
+	unsigned long i;
+	bool all = true;
+
+	for (i = 0; i < _svp_nr_chunks; i++)
+		if (!svp_chunk_get(i))
+			all = false;
+
+	return all;
+}
+
+static unsigned long svp_prestage_target(void)
+{
+	unsigned long n = ((unsigned long)svp_prestage_mb * SZ_1M >> PAGE_SHIFT) /
+			  SSVP_CHUNK_PAGES;
+
+	return min(n, _svp_nr_chunks);
+}
+
+/* memory_ssvp_mutex held, drop the chunks above the prestage target */
+static void svp_chunks_trim(void)
+{
+	unsigned long i, keep = svp_prestage_target();
+
+	for (i = _svp_nr_chunks; i > keep; i--)
+		svp_chunk_put(i - 1);
+}
+
+static void svp_prestage_kick(unsigned long delay)
+{
+	if (_svp_chunks)
+		mod_delayed_work(system_freezable_wq, &_svp_prestage_work, delay);
+}
+
+static void svp_prestage_func(struct work_struct *work)
+{
+	unsigned long i, target, delay = 0;
+
+	mutex_lock(&memory_ssvp_mutex);
+
+	if (_svpregs[SSVP_SUB_SVP].state != SVP_STATE_ON)
+		goto out;
+
+	target = svp_prestage_target();
+	if (_svp_chunks_held > target)
+		svp_chunks_trim();
+
+	/* one chunk per run, migrating a chunk is not cheap */
+	for (i = 0; i < target; i++) {
+		if (!_svp_chunks[i]) {
+			svp_chunk_get(i);
+			delay = HZ;
+			goto out;
+		}
+	}
+
+	if (svp_precompact_sec && target < _svp_nr_chunks) {
+		/* migrate one free chunk out and give it back */
+		if (_svp_compact_cursor < target || _svp_compact_cursor >= _svp_nr_chunks)
+			_svp_compact_cursor = target;
+		if (svp_chunk_get(_svp_compact_cursor))
+			svp_chunk_put(_svp_compact_cursor);
+		_svp_compact_cursor++;
+		delay = svp_precompact_sec * HZ;
+	}
+
+out:
+	mutex_unlock(&memory_ssvp_mutex);
+
+	if (delay)
+		svp_prestage_kick(delay);
+}
+
+static int svp_prestage_param_set(const char *val, const struct kernel_param *kp)
+{
+	int ret = param_set_uint(val, kp);
+
+	if (!ret)
+		svp_prestage_kick(0);
+	return ret;
+}
+
+static const struct kernel_param_ops svp_prestage_param_ops = {
+	.set = svp_prestage_param_set,
+	.get = param_get_uint,
+};
+
+module_param_cb(svp_prestage_mb, &svp_prestage_param_ops, &svp_prestage_mb, 0644);
+module_param_cb(svp_precompact_sec, &svp_prestage_param_ops, &svp_precompact_sec, 0644);
+
 static int __svp_region_online(void)
 {
 	int retval = 0;
@@ -349,15 +514,16 @@ static int __svp_region_online(void)
 /*		retb = dma_release_from_contiguous(cma_dev,
 			_svpregs[SSVP_SUB_SVP].page, _svpregs[SSVP_SUB_SVP].count);
 */
-		retb = cma_release(ssvp_cma.cma, _svpregs[SSVP_SUB_SVP].page, _svpregs[SSVP_SUB_SVP].count);
-		if (retb == true) {
-			svp_usage_count -= _svpregs[SSVP_SUB_SVP].count;
-		}
+		mutex_lock(&memory_ssvp_mutex);
+		svp_chunks_trim();
+		mutex_unlock(&memory_ssvp_mutex);
+		retb = true;
 #endif
 
 		if (retb == true) {
 			_svpregs[SSVP_SUB_SVP].page = NULL;
 			_svpregs[SSVP_SUB_SVP].state = SVP_STATE_ON;
+			svp_prestage_kick(0);
 		}
 	} else {
 		retval = -EBUSY;
@@ -592,21 +758,29 @@ int svp_region_offline(phys_addr_t *pa, unsigned long *size)
 /*		page = dma_alloc_from_contiguous_start(cma_dev,
 					_svpregs[SSVP_SUB_SVP].start, _svpregs[SSVP_SUB_SVP].count, 0);*/
 		_svp_onlinewait_tries = 0;
-		pr_info("[SSVP-ALLOCATION]: start\n");
-
-		page = cma_alloc(ssvp_cma.cma, _svpregs[SSVP_SUB_SVP].count, 0);
-		pr_info("[SSVP-ALLOCATION]: retry: %d\n", _svp_onlinewait_tries);
-
-		while (!page && _svp_onlinewait_tries < 20) {
-			msleep(100);
-			page = cma_alloc(ssvp_cma.cma, _svpregs[SSVP_SUB_SVP].count, 0);
-			pr_info("[SSVP-ALLOCATION]: retry: %d\n", _svp_onlinewait_tries);
-			++_svp_onlinewait_tries;
+		pr_info("[SSVP-ALLOCATION]: start, %lu/%lu chunks held\n",
+				_svp_chunks_held, _svp_nr_chunks);
+
+		cancel_delayed_work_sync(&_svp_prestage_work);
+		page = NULL;
+		if (_svp_chunks) {
+			/* a retry only migrates the chunks still missing */
+			mutex_lock(&memory_ssvp_mutex);
+			while (!svp_chunks_get_all() && _svp_onlinewait_tries < 20) {
+				mutex_unlock(&memory_ssvp_mutex);
+				msleep(100);
+				pr_info("[SSVP-ALLOCATION]: retry: %d, %lu/%lu chunks held\n",
+						_svp_onlinewait_tries, _svp_chunks_held, _svp_nr_chunks);
+				++_svp_onlinewait_tries;
+				mutex_lock(&memory_ssvp_mutex);
+			}
+			if (_svp_chunks_held == _svp_nr_chunks)
+				page = _svp_chunks[0];
+			else
+				svp_chunks_trim();
+			mutex_unlock(&memory_ssvp_mutex);
 		}
 		pr_info("[SSVP-ALLOCATION]: end\n");
-		if (page) {
-			svp_usage_count += _svpregs[SSVP_SUB_SVP].count;
-		}
 #endif
 
 		if (page) {
@@ -630,6 +804,7 @@ int svp_region_offline(phys_addr_t *pa, unsigned long *size)
 					_svpregs[SSVP_SUB_SVP].count << PAGE_SHIFT);
 		} else {
 			_svpregs[SSVP_SUB_SVP].state = SVP_STATE_ON;
+			svp_prestage_kick(HZ);
 			retval = -EAGAIN;
 		}
 	} else {
@@ -863,6 +1038,10 @@ static int memory_ssvp_show(struct seq_file *m, void *v)
 
 	seq_printf(m, "cma usage: %lu\n", svp_usage_count);
 
+	seq_printf(m, "svp chunks: %lu/%lu held, %lu pages each, prestage %u MB, precompact %u s\n",
+			_svp_chunks_held, _svp_nr_chunks, SSVP_CHUNK_PAGES,
+			svp_prestage_mb, svp_precompact_sec);
+
 	return 0;
 }
 
@@ -944,6 +1123,16 @@ static int __init memory_ssvp_debug_init(void)
 			__func__, __LINE__, _svpregs[SSVP_SUB_SVP].start,
 			_svpregs[SSVP_SUB_SVP].count);
 
+#ifndef CONFIG_MTK_MEMORY_SSVP_WRAP
+	if (_svpregs[SSVP_SUB_SVP].count) {
+		_svp_nr_chunks = DIV_ROUND_UP(_svpregs[SSVP_SUB_SVP].count, SSVP_CHUNK_PAGES);
+		_svp_chunks = kcalloc(_svp_nr_chunks, sizeof(*_svp_chunks), GFP_KERNEL);
+		if (!_svp_chunks)
+			_svp_nr_chunks = 0;
+		svp_prestage_kick(0);
+	}
+#endif
+
 	proc_create("tui_region", 0, NULL, &tui_cma_fops);
 
 	if (!procfs_entry)
@@ -25,6 +25,12 @@
 
 #include <mt-plat/sync_write.h>
 
+#ifdef MJC_ASYNC_JOB_SUPPORT
+#include <linux/workqueue.h>
+#include <cmdq_record.h>
+#include "mtk_sync.h"
+#endif
+
 #ifdef CONFIG_MTK_CLKMGR
 #include "mach/mt_clkmgr.h"
 #else
@@ -446,6 +452,12 @@ static int mjc_release(struct inode *pInode, struct file *pFile)
 {
 	MJCDBG("mjc_release() pid = %d\n", current->pid);
 
+#ifdef MJC_ASYNC_JOB_SUPPORT
+	/* queued jobs still need the clocks */
+	if (gMjcJobWQ)
+		flush_workqueue(gMjcJobWQ);
+#endif
+
 	m4u_unregister_fault_callback(M4U_PORT_MJC_MV_RD);
 	m4u_unregister_fault_callback(M4U_PORT_MJC_MV_WR);
 	m4u_unregister_fault_callback(M4U_PORT_MJC_DMA_RD);
@@ -474,6 +486,261 @@ static int mjc_release(struct inode *pInode, struct file *pFile)
 	return 0;
 }
 
+/*****************************************************************************
+ * FUNCTION
+ *    _mjc_LockHW
+ * DESCRIPTION
+ *    Wait for the previous user of the HW to get its frame done interrupt,
+ *    then enable the interrupt for the caller.
+ * PARAMETERS
+ *    None.
+ * RETURNS
+ *    0 on success, -1 when the HW stayed busy.
+ ****************************************************************************/
+static int _mjc_LockHW(void)
+{
+	int ret = 0;
+	int u4FirstUse;
+	unsigned long ulFlags;
+
+	spin_lock_irqsave(&HWLock, ulFlags);
+	if (grHWLockContext.rEvent.u4TimeoutMs == 0xFFFFFFFF) {
+		grHWLockContext.rEvent.u4TimeoutMs = 1;
+		u4FirstUse = 1;
+	} else {
+		u4FirstUse = 0;
+	}
+	spin_unlock_irqrestore(&HWLock, ulFlags);
+
+	/* MJCDBG("mjc_ioctl() MJC_LOCKHW start + tid = %d (%d)\n", current->pid,
+	   grHWLockContext.rEvent.u4TimeoutMs); */
+	if (u4FirstUse == 1) {
+		_mjc_WaitEvent(&(grHWLockContext.rEvent));
+		spin_lock_irqsave(&HWLock, ulFlags);
+		grHWLockContext.rEvent.u4TimeoutMs = 1000;
+		spin_unlock_irqrestore(&HWLock, ulFlags);
+	} else {
+		ret = _mjc_WaitEvent(&(grHWLockContext.rEvent));
+	}
+	/* MJCDBG("mjc_ioctl() MJC_LOCKHW end + tid = %d (%d)\n", current->pid,
+	   grHWLockContext.rEvent.u4TimeoutMs); */
+
+	if (ret == 1) {
+		MJCMSG("[ERROR] mjc_ioctl() MJC_LOCKHW HW has been usaged\n");
+		return -1;
+	}
+	/* Gary todo */
+	enable_irq(gi4IrqID);
+
+	return 0;
+}
+
+/*****************************************************************************
+ * FUNCTION
+ *    _mjc_WaitIsr
+ * DESCRIPTION
+ *    Wait for the frame done interrupt. On timeout the HW is released and
+ *    the interrupt disabled again.
+ * PARAMETERS
+ *    u4TimeoutMs : [IN] timeout in ms.
+ * RETURNS
+ *    0 on success, -2 on timeout.
+ ****************************************************************************/
+static int _mjc_WaitIsr(unsigned int u4TimeoutMs)
+{
+	int ret;
+	unsigned long ulFlags;
+
+	MJCDBG(" isrevent timeout setting (%x, %x)\n", grContext.rEvent.u4TimeoutMs,
+	       u4TimeoutMs);
+	spin_lock_irqsave(&ContextLock, ulFlags);
+	grContext.rEvent.u4TimeoutMs = u4TimeoutMs;
+	spin_unlock_irqrestore(&ContextLock, ulFlags);
+	/* MJCDBG(" new isrevent timeout =%x\n", grContext.rEvent.u4TimeoutMs); */
+
+	ret = _mjc_WaitEvent(&(grContext.rEvent));
+	MJCDBG("mjc_ioctl() waitdone MJC_WAITISR TID:%d, ret:%d\n", current->pid, ret);
+
+	if (ret != 0) {
+		MJCMSG("[ERROR] mjc_ioctl() MJC_WAITISR TimeOut\n");
+		spin_lock_irqsave(&HWLock, ulFlags);
+		_mjc_SetEvent(&(grHWLockContext.rEvent));
+		spin_unlock_irqrestore(&HWLock, ulFlags);
+
+		disable_irq_nosync(gi4IrqID);
+
+		return -2;
+	}
+
+	return 0;
+}
+
+#ifdef MJC_ASYNC_JOB_SUPPORT
+/*****************************************************************************
+ * Fence based async job
+ *
+ * Jobs run one at a time, in submit order, on an ordered workqueue, so the
+ * out fences are points on a single "mjc" timeline and each finished job,
+ * done or failed, advances it by one. No user thread blocks on the HW, and
+ * a caller queueing more than mjc_async_depth jobs waits for a free slot.
+ ****************************************************************************/
+static unsigned int mjc_async_depth = 2;
+module_param(mjc_async_depth, uint, 0444);
+
+typedef struct {
+	MJC_IOCTL_ASYNC_JOB_T rJob;
+	struct sync_fence *prInFence;
+	struct work_struct rWork;
+} MJC_ASYNC_JOB_CONTEXT_T;
+
+static struct workqueue_struct *gMjcJobWQ;
+static struct sw_sync_timeline *gMjcTimeline;
+static unsigned int gu4MjcJobQueued;	/* mutex : MjcJobLock */
+static DEFINE_MUTEX(MjcJobLock);
+static atomic_t gMjcJobPending = ATOMIC_INIT(0);
+static DECLARE_WAIT_QUEUE_HEAD(gMjcJobWaitQueue);
+
+/* issue the register writes from GCE, the last one triggers the frame */
+static int _mjc_async_trigger(MJC_IOCTL_ASYNC_JOB_T *prJob)
+{
+	cmdqRecHandle hRec;
+	unsigned int i;
+	int ret;
+
+	ret = cmdqRecCreate(CMDQ_SCENARIO_KERNEL_CONFIG_GENERAL, &hRec);
+	if (ret < 0)
+		return ret;
+
+	cmdqRecReset(hRec);
+	for (i = 0; i < prJob->u4RegCount; i++)
+		cmdqRecWrite(hRec, prJob->rReg[i].reg, prJob->rReg[i].val, prJob->rReg[i].mask);
+	ret = cmdqRecFlush(hRec);
+	cmdqRecDestroy(hRec);
+
+	return ret;
+}
+
+static void mjc_async_job_work(struct work_struct *prWork)
+{
+	MJC_ASYNC_JOB_CONTEXT_T *prCtx = container_of(prWork, MJC_ASYNC_JOB_CONTEXT_T, rWork);
+	int ret = 0;
+
+	if (prCtx->prInFence)
+		ret = sync_fence_wait(prCtx->prInFence, prCtx->rJob.u4TimeoutMs);
+
+	if (ret < 0) {
+		MJCMSG("[ERROR] mjc async job input fence wait fail, ret = %d\n", ret);
+	} else if (_mjc_LockHW() == 0) {
+		ret = _mjc_async_trigger(&prCtx->rJob);
+		if (ret < 0) {
+			MJCMSG("[ERROR] mjc async job trigger fail, ret = %d\n", ret);
+			/* no frame done will come, release the HW */
+			spin_lock_irq(&HWLock);
+			_mjc_SetEvent(&(grHWLockContext.rEvent));
+			spin_unlock_irq(&HWLock);
+			disable_irq(gi4IrqID);
+		} else {
+			_mjc_WaitIsr(prCtx->rJob.u4TimeoutMs);
+		}
+	}
+
+	timeline_inc(gMjcTimeline, 1);
+
+	if (prCtx->prInFence)
+		sync_fence_put(prCtx->prInFence);
+	kfree(prCtx);
+
+	atomic_dec(&gMjcJobPending);
+	wake_up(&gMjcJobWaitQueue);
+}
+
+static long mjc_async_job_queue(void __user *prArg)
+{
+	MJC_ASYNC_JOB_CONTEXT_T *prCtx;
+	MJC_IOCTL_ASYNC_JOB_T *prJob;
+	struct fence_data data;
+	unsigned int i;
+	long ret;
+
+	if (gMjcJobWQ == NULL || gMjcTimeline == NULL)
+		return -ENODEV;
+
+	prCtx = kzalloc(sizeof(MJC_ASYNC_JOB_CONTEXT_T), GFP_KERNEL);
+	if (prCtx == NULL)
+		return -ENOMEM;
+	prJob = &prCtx->rJob;
+
+	if (copy_from_user(prJob, prArg, sizeof(MJC_IOCTL_ASYNC_JOB_T))) {
+		MJCMSG("[ERROR] mjc_ioctl() MJC_ASYNC_JOB copy_from_user fail\n");
+		ret = -EFAULT;
+		goto err_free;
+	}
+
+	if (sizeof(MJC_IOCTL_ASYNC_JOB_T) != prJob->u4StructSize ||
+	    prJob->u4RegCount > MJC_ASYNC_REG_NUM) {
+		MJCMSG("[ERROR] mjc_ioctl() MJC_ASYNC_JOB invalid job (size:%d, regs:%d)\n",
+		       prJob->u4StructSize, prJob->u4RegCount);
+		ret = -EINVAL;
+		goto err_free;
+	}
+
+	for (i = 0; i < prJob->u4RegCount; i++) {
+		if (prJob->rReg[i].reg >= (gu1PaReg + gu1PaSize) || prJob->rReg[i].reg < gu1PaReg) {
+			MJCMSG("[ERROR] MJC_ASYNC_JOB, addr invalid, addr=0x%x\n",
+			       prJob->rReg[i].reg);
+			ret = -EINVAL;
+			goto err_free;
+		}
+	}
+
+	if (prJob->i4InFenceFd >= 0) {
+		prCtx->prInFence = sync_fence_fdget(prJob->i4InFenceFd);
+		if (prCtx->prInFence == NULL) {
+			ret = -EINVAL;
+			goto err_free;
+		}
+	}
+
+	ret = wait_event_interruptible(gMjcJobWaitQueue,
+				       atomic_add_unless(&gMjcJobPending, 1, mjc_async_depth));
+	if (ret)
+		goto err_put;
+
+	INIT_WORK(&prCtx->rWork, mjc_async_job_work);
+
+	mutex_lock(&MjcJobLock);
+	memset(&data, 0, sizeof(data));
+	data.value = gu4MjcJobQueued + 1;
+	strncpy(data.name, "mjc_job", sizeof(data.name) - 1);
+	ret = fence_create(gMjcTimeline, &data);
+	if (ret < 0) {
+		mutex_unlock(&MjcJobLock);
+		atomic_dec(&gMjcJobPending);
+		wake_up(&gMjcJobWaitQueue);
+		goto err_put;
+	}
+	gu4MjcJobQueued++;
+	/* the fence exists now, the job must run to signal it */
+	queue_work(gMjcJobWQ, &prCtx->rWork);
+	mutex_unlock(&MjcJobLock);
+
+	if (copy_to_user(&((MJC_IOCTL_ASYNC_JOB_T __user *)prArg)->i4OutFenceFd, &data.fence,
+			 sizeof(data.fence))) {
+		MJCMSG("[ERROR] mjc_ioctl() MJC_ASYNC_JOB copy_to_user fail\n");
+		return -EFAULT;
+	}
+
+	return 0;
+
+err_put:
+	if (prCtx->prInFence)
+		sync_fence_put(prCtx->prInFence);
+err_free:
+	kfree(prCtx);
+	return ret;
+}
+#endif
+
 /*****************************************************************************
  * FUNCTION
  *    mjc_ioctl
@@ -487,9 +754,7 @@ static int mjc_release(struct inode *pInode, struct file *pFile)
 static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4arg)
 {
 	int ret = 0;
-	int u4FirstUse;
 	unsigned long ulAdd;
-	unsigned long ulFlags;
 
 	MJC_IOCTL_LOCK_HW_T rLockHW;
 	MJC_IOCTL_ISR_T rIsr;
@@ -520,34 +785,8 @@ static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4ar
 				return -1;
 			}
 
-			spin_lock_irqsave(&HWLock, ulFlags);
-			if (grHWLockContext.rEvent.u4TimeoutMs == 0xFFFFFFFF) {
-				grHWLockContext.rEvent.u4TimeoutMs = 1;
-				u4FirstUse = 1;
-			} else {
-				u4FirstUse = 0;
-			}
-			spin_unlock_irqrestore(&HWLock, ulFlags);
-
-			/* MJCDBG("mjc_ioctl() MJC_LOCKHW start + tid = %d (%d)\n", current->pid,
-			   grHWLockContext.rEvent.u4TimeoutMs); */
-			if (u4FirstUse == 1) {
-				_mjc_WaitEvent(&(grHWLockContext.rEvent));
-				spin_lock_irqsave(&HWLock, ulFlags);
-				grHWLockContext.rEvent.u4TimeoutMs = 1000;
-				spin_unlock_irqrestore(&HWLock, ulFlags);
-			} else {
-				ret = _mjc_WaitEvent(&(grHWLockContext.rEvent));
-			}
-			/* MJCDBG("mjc_ioctl() MJC_LOCKHW end + tid = %d (%d)\n", current->pid,
-			   grHWLockContext.rEvent.u4TimeoutMs); */
-
-			if (ret == 1) {
-				MJCMSG("[ERROR] mjc_ioctl() MJC_LOCKHW HW has been usaged\n");
+			if (_mjc_LockHW() != 0)
 				return -1;
-			}
-			/* Gary todo */
-			enable_irq(gi4IrqID);
 
 			MJCDBG("- mjc_ioctl() MJC_LOCKHW + tid = %d\n", current->pid);
 		}
@@ -569,27 +808,9 @@ static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4ar
 				return -1;
 			}
 
-			MJCDBG(" isrevent timeout setting (%x, %x)\n", grContext.rEvent.u4TimeoutMs,
-			       rIsr.u4TimeoutMs);
-			spin_lock_irqsave(&ContextLock, ulFlags);
-			grContext.rEvent.u4TimeoutMs = rIsr.u4TimeoutMs;
-			spin_unlock_irqrestore(&ContextLock, ulFlags);
-			/* MJCDBG(" new isrevent timeout =%x\n", grContext.rEvent.u4TimeoutMs); */
-
-			ret = _mjc_WaitEvent(&(grContext.rEvent));
-			MJCDBG("mjc_ioctl() waitdone MJC_WAITISR TID:%d, ret:%d\n", current->pid,
-			       ret);
-
-			if (ret != 0) {
-				MJCMSG("[ERROR] mjc_ioctl() MJC_WAITISR TimeOut\n");
-				spin_lock_irqsave(&HWLock, ulFlags);
-				_mjc_SetEvent(&(grHWLockContext.rEvent));
-				spin_unlock_irqrestore(&HWLock, ulFlags);
-
-				disable_irq_nosync(gi4IrqID);
-
-				return -2;
-			}
+			ret = _mjc_WaitIsr(rIsr.u4TimeoutMs);
+			if (ret != 0)
+				return ret;
 		}
 		break;
 
@@ -764,6 +985,14 @@ static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4ar
 		}
 		break;
 
+#ifdef MJC_ASYNC_JOB_SUPPORT
+	case MJC_ASYNC_JOB:
+		{
+			MJCDBG("mjc_ioctl() MJC_ASYNC_JOB + tid = %d\n", current->pid);
+			return mjc_async_job_queue((void __user *)u4arg);
+		}
+#endif
+
 	default:
 		MJCMSG("[ERROR] mjc_ioctl() No such command 0x%x!!\n", u4cmd);
 		break;
@@ -927,6 +1156,13 @@ static int mjc_probe(struct platform_device *pDev)
 	}
 	disable_irq(gi4IrqID);
 
+#ifdef MJC_ASYNC_JOB_SUPPORT
+	gMjcJobWQ = alloc_ordered_workqueue("mjc_job", WQ_HIGHPRI);
+	gMjcTimeline = timeline_create("mjc");
+	if (gMjcJobWQ == NULL || gMjcTimeline == NULL)
+		MJCMSG("[ERROR] mjc_probe() async job setup fail\n");
+#endif
+
 #ifndef CONFIG_MTK_CLKMGR
 	clk_MM_SMI_COMMON = devm_clk_get(&pDev->dev, "smi-common");
 	if (IS_ERR(clk_MM_SMI_COMMON)) {
@@ -1033,6 +1269,17 @@ static int mjc_remove(struct platform_device *pdev)
 
 	/* memory allocated in probe function don't free. */
 
+#ifdef MJC_ASYNC_JOB_SUPPORT
+	if (gMjcJobWQ) {
+		destroy_workqueue(gMjcJobWQ);
+		gMjcJobWQ = NULL;
+	}
+	if (gMjcTimeline) {
+		timeline_destroy(gMjcTimeline);
+		gMjcTimeline = NULL;
+	}
+#endif
+
 	spin_lock_irqsave(&ContextLock, ulFlags);
 	_mjc_CloseEvent(&(grContext.rEvent));
 	spin_unlock_irqrestore(&ContextLock, ulFlags);
@@ -51,6 +51,29 @@ typedef struct {
 	unsigned long ulRegPSize;
 } MJC_IOCTL_REG_INFO_T;
 
+/*
+ * Async job: once i4InFenceFd (-1 for none) signals, the rReg writes are
+ * issued through CMDQ, the last one being the MJC trigger. i4OutFenceFd is
+ * returned and signals when the frame done interrupt comes, or the job
+ * failed or timed out. Fixed size fields, so 32-bit callers share the layout.
+ */
+#define MJC_ASYNC_REG_NUM 16
+
+typedef struct {
+	unsigned int reg;	/* physical address */
+	unsigned int val;
+	unsigned int mask;
+} MJC_ASYNC_REG_T;
+
+typedef struct {
+	unsigned int u4StructSize;
+	int i4InFenceFd;
+	int i4OutFenceFd;
+	unsigned int u4TimeoutMs;
+	unsigned int u4RegCount;
+	MJC_ASYNC_REG_T rReg[MJC_ASYNC_REG_NUM];
+} MJC_IOCTL_ASYNC_JOB_T;
+
 #define MJC_IOC_MAGIC    'N'
 
 #define MJC_LOCKHW                           _IOW(MJC_IOC_MAGIC, 0x00, MJC_IOCTL_LOCK_HW_T)
@@ -61,5 +84,6 @@ typedef struct {
 #define MJC_CLEAR_REG_TBL                   _IOW(MJC_IOC_MAGIC, 0x05, int)
 #define MJC_SOURCE_CLK                      _IOW(MJC_IOC_MAGIC, 0x06, MJC_IOCTL_SRC_CLK_T)
 #define MJC_REG_INFO                      _IOW(MJC_IOC_MAGIC, 0x07, MJC_IOCTL_REG_INFO_T)
+#define MJC_ASYNC_JOB                     _IOWR(MJC_IOC_MAGIC, 0x08, MJC_IOCTL_ASYNC_JOB_T)
 
 #endif				/* __MJC_KERNEL_DRIVER_H__ */
@@ -22,6 +22,7 @@
 
 #ifdef COLLECT_GPU_MEMINFO
 #include <mt-plat/mtk_gpu_utility.h>
+#include <mt-plat/mt_timer_coalesce.h>
 #endif
 
 #ifdef CONFIG_ZRAM
@@ -96,6 +97,18 @@
 #define MLOG_TRIGGER_LMK    1
 #define MLOG_TRIGGER_LTK    2
 
+#define MLOG_NR_MEMINFO     11
+#define MLOG_NR_VMSTAT      4
+#define MLOG_NR_BUDDY       (2 * MAX_ORDER)
+#define MLOG_NR_PROC        6	/* adj, rss, rswap, swpin, swpout, fmflt */
+#define MLOG_NR_GLOBAL      (MLOG_NR_MEMINFO + MLOG_NR_VMSTAT + MLOG_NR_BUDDY)
+
+#define MLOG_FIELD(filter, bit, val)	\
+	do {				\
+		if ((filter) & (bit))	\
+			v[n++] = (val);	\
+	} while (0)
+
 static uint meminfo_filter = M_FILTER_ALL;
 static uint vmstat_filter = V_FILTER_ALL;
 static uint proc_filter = P_FILTER_ALL;
@@ -114,6 +127,48 @@ static int limit_pid = -1;
 
 static struct timer_list mlog_timer;
 static unsigned long timer_intval = HZ;
+static DEFINE_MT_CTIMER_SRC(mlog_ctimer_src, "mlog", 500);
+
+/*
+ * Binary mode, see mlog_logger.h for the record layout. mlog_buffer is used
+ * as a byte ring holding whole records, mlog_start/mlog_end count bytes.
+ * Records are built in mlog_bin_rec under mlog_bin_lock, which also guards
+ * the previous values the deltas are taken against.
+ */
+#define MLOG_BIN_SIZE       sizeof(mlog_buffer)
+#define MLOG_BIN(idx)       (((u8 *)mlog_buffer)[(idx) & (MLOG_BIN_SIZE - 1)])
+#define MLOG_BIN_REC_MAX    8192
+#define MLOG_BIN_MAX_PROCS  128
+/* worst case of one listed process: pid and fields as 10 byte varints */
+#define MLOG_BIN_PROC_MAX   ((1 + MLOG_NR_PROC) * 10)
+
+struct mlog_bin_proc {
+	pid_t pid;
+	int bucket;		/* lowmem_adj_bucket() when last listed */
+	unsigned int seq;	/* sample that last visited it */
+	unsigned long rss;	/* kB when last listed */
+	unsigned long v[MLOG_NR_PROC];
+};
+
+static uint bin_mode;
+static uint bin_key_intval = 60;	/* samples between keyframes */
+static uint proc_rss_delta = 1024;	/* kB of RSS change that lists a process again */
+
+static DEFINE_SPINLOCK(mlog_bin_lock);
+static u8 mlog_bin_rec[MLOG_BIN_REC_MAX];
+static unsigned int mlog_bin_len;
+static unsigned int mlog_bin_seq;
+static unsigned int mlog_bin_key_seq;
+static unsigned long mlog_bin_time;
+static unsigned long mlog_bin_prev[MLOG_NR_GLOBAL];
+static struct mlog_bin_proc mlog_bin_procs[MLOG_BIN_MAX_PROCS];
+static int mlog_bin_nr_procs;
+static int mlog_bin_listed;
+static bool mlog_bin_trunc;
+static bool mlog_bin_need_key = true;	/* under mlogbuf_lock */
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+static struct task_struct *mlog_bin_tasks[MLOG_BIN_MAX_PROCS];
+#endif
 
 static const char **strfmt_list;
 static int strfmt_idx;
@@ -174,14 +229,11 @@ static void mlog_reset_format(void)
 
 	spin_lock_bh(&mlogbuf_lock);
 
-	if (meminfo_filter)
-		meminfo_filter = M_FILTER_ALL;
-	if (vmstat_filter)
-		vmstat_filter = V_FILTER_ALL;
-	if (buddyinfo_filter)
-		buddyinfo_filter = B_FILTER_ALL;
-	if (proc_filter)
-		proc_filter = P_FILTER_ALL;
+	/* only the fields that are selected get logged */
+	meminfo_filter &= M_FILTER_ALL;
+	vmstat_filter &= V_FILTER_ALL;
+	buddyinfo_filter &= B_FILTER_ALL;
+	proc_filter &= P_FILTER_ALL;
 
 	/* calc len */
 	len = 4;		/* id, type, sec, nanosec */
@@ -190,7 +242,7 @@ static void mlog_reset_format(void)
 	len += hweight32(vmstat_filter);
 
 	/* buddyinfo */
-	len += (2 * MAX_ORDER);
+	len += hweight32(buddyinfo_filter) * MAX_ORDER;
 
 	if (proc_filter) {
 		len++;		/* PID */
@@ -230,7 +282,7 @@ static void mlog_reset_format(void)
 		int i, j;
 
 		/* normal and high zone */
-		for (i = 0; i < 2; ++i) {
+		for (i = 0; i < hweight32(buddyinfo_filter); ++i) {
 			strfmt_list[len++] = order_start_str;
 			for (j = 0; j < MAX_ORDER - 2; ++j)
 				strfmt_list[len++] = order_middle_str;
@@ -244,7 +296,8 @@ static void mlog_reset_format(void)
 
 		strfmt_proc = len;
 		strfmt_list[len++] = pid_str;	/* PID */
-		strfmt_list[len++] = adj_str;	/* ADJ */
+		if (proc_filter & P_ADJ)
+			strfmt_list[len++] = adj_str;	/* ADJ */
 		for (i = 0; i < hweight32(proc_filter & (P_FMT_SIZE)); ++i)
 			strfmt_list[len++] = mem_size_str;
 		for (i = 0; i < hweight32(proc_filter & (P_FMT_COUNT)); ++i)
@@ -298,10 +351,10 @@ int mlog_print_fmt(struct seq_file *m)
 	if (vmstat_filter & V_PGANFAULT)
 		seq_puts(m, "   anflt");
 
-	if (buddyinfo_filter) {
+	if (buddyinfo_filter & B_NORMAL)
 		seq_puts(m, "   [normal]");
+	if (buddyinfo_filter & B_HIGH)
 		seq_puts(m, "   [high]");
-	}
 
 	if (proc_filter) {
 		seq_puts(m, " [pid]");
@@ -326,6 +379,7 @@ static void mlog_reset_buffer(void)
 {
 	spin_lock_bh(&mlogbuf_lock);
 	mlog_end = mlog_start = 0;
+	mlog_bin_need_key = true;
 	spin_unlock_bh(&mlogbuf_lock);
 
 	MLOG_PRINTK("[mlog] reset buffer\n");
@@ -335,7 +389,7 @@ static void mlog_reset_buffer(void)
 #define mtkpasr_show_page_reserved(void) (0)
 #endif
 
-static void mlog_meminfo(void)
+static int mlog_meminfo(unsigned long *v)
 {
 	unsigned long memfree;
 	unsigned long swapfree;
@@ -347,6 +401,7 @@ static void mlog_meminfo(void)
 	unsigned long active, inactive;
 	unsigned long shmem;
 	unsigned long ion = 0;
+	int n = 0;
 
 	memfree = P2K(global_page_state(NR_FREE_PAGES) + mtkpasr_show_page_reserved());
 	swapfree = P2K(atomic_long_read(&nr_swap_pages));
@@ -358,9 +413,9 @@ static void mlog_meminfo(void)
 	*/
 
 #ifdef COLLECT_GPU_MEMINFO
-	if (mtk_get_gpu_memory_usage(&gpuuse))
+	if ((meminfo_filter & M_GPUUSE) && mtk_get_gpu_memory_usage(&gpuuse))
 		gpuuse = B2K(gpuuse);
-	if (mtk_get_gpu_page_cache(&gpu_page_cache))
+	if ((meminfo_filter & M_GPU_PAGE_CACHE) && mtk_get_gpu_page_cache(&gpu_page_cache))
 		gpu_page_cache = B2K(gpu_page_cache);
 #endif
 
@@ -377,50 +432,45 @@ static void mlog_meminfo(void)
 	shmem = P2K(global_page_state(NR_SHMEM));
 
 #ifdef CONFIG_MTK_ION
-	ion = B2K((unsigned long)ion_mm_heap_total_memory());
+	if (meminfo_filter & M_ION)
+		ion = B2K((unsigned long)ion_mm_heap_total_memory());
 #endif
 
-	spin_lock_bh(&mlogbuf_lock);
-	mlog_emit_32(memfree);
-	mlog_emit_32(swapfree);
-	mlog_emit_32(cached);
-	mlog_emit_32(gpuuse);
-	mlog_emit_32(gpu_page_cache);
-	mlog_emit_32(mlock);
-	mlog_emit_32(zram);
-	mlog_emit_32(active);
-	mlog_emit_32(inactive);
-	mlog_emit_32(shmem);
-	mlog_emit_32(ion);
-	spin_unlock_bh(&mlogbuf_lock);
+	MLOG_FIELD(meminfo_filter, M_MEMFREE, memfree);
+	MLOG_FIELD(meminfo_filter, M_SWAPFREE, swapfree);
+	MLOG_FIELD(meminfo_filter, M_CACHED, cached);
+	MLOG_FIELD(meminfo_filter, M_GPUUSE, gpuuse);
+	MLOG_FIELD(meminfo_filter, M_GPU_PAGE_CACHE, gpu_page_cache);
+	MLOG_FIELD(meminfo_filter, M_MLOCK, mlock);
+	MLOG_FIELD(meminfo_filter, M_ZRAM, zram);
+	MLOG_FIELD(meminfo_filter, M_ACTIVE, active);
+	MLOG_FIELD(meminfo_filter, M_INACTIVE, inactive);
+	MLOG_FIELD(meminfo_filter, M_SHMEM, shmem);
+	MLOG_FIELD(meminfo_filter, M_ION, ion);
+	return n;
 }
 
-static void mlog_vmstat(void)
+static int mlog_vmstat(unsigned long *v)
 {
-	int cpu;
-	unsigned long v[NR_VM_EVENT_ITEMS];
-
-	memset(v, 0, NR_VM_EVENT_ITEMS * sizeof(unsigned long));
+	int cpu, n = 0;
+	unsigned long pswpin = 0, pswpout = 0, pgfmfault = 0;
 
 	for_each_online_cpu(cpu) {
 		struct vm_event_state *this = &per_cpu(vm_event_states, cpu);
 
-		v[PSWPIN] += this->event[PSWPIN];
-		v[PSWPOUT] += this->event[PSWPOUT];
-		v[PGFMFAULT] += this->event[PGFMFAULT];
+		pswpin += this->event[PSWPIN];
+		pswpout += this->event[PSWPOUT];
+		pgfmfault += this->event[PGFMFAULT];
 	}
 
-	spin_lock_bh(&mlogbuf_lock);
-	mlog_emit_32(v[PSWPIN]);
-	mlog_emit_32(v[PSWPOUT]);
-	mlog_emit_32(v[PGFMFAULT]);
-
-	mlog_emit_32(0);
-	spin_unlock_bh(&mlogbuf_lock);
+	MLOG_FIELD(vmstat_filter, V_PSWPIN, pswpin);
+	MLOG_FIELD(vmstat_filter, V_PSWPOUT, pswpout);
+	MLOG_FIELD(vmstat_filter, V_PGFMFAULT, pgfmfault);
+	MLOG_FIELD(vmstat_filter, V_PGANFAULT, 0);
+	return n;
 }
 
-/* static void mlog_buddyinfo(void) */
-void mlog_buddyinfo(void)
+static int mlog_buddyinfo(unsigned long *v)
 {
 	int i;
 	struct zone *zone;
@@ -429,6 +479,7 @@ void mlog_buddyinfo(void)
 	int zone_nr = 0;
 	unsigned long normal_nr_free[MAX_ORDER] = {0};
 	unsigned long high_nr_free[MAX_ORDER] = {0};
+	int n = 0;
 
 	for_each_online_node(i) {
 		pg_data_t *pgdat = NODE_DATA(i);
@@ -466,17 +517,13 @@ void mlog_buddyinfo(void)
 
 #endif
 
-	spin_lock_bh(&mlogbuf_lock);
-
 	for (order = 0; order < MAX_ORDER; ++order)
-		mlog_emit_32(normal_nr_free[order]);
-
+		MLOG_FIELD(buddyinfo_filter, B_NORMAL, normal_nr_free[order]);
 
 	for (order = 0; order < MAX_ORDER; ++order)
-		mlog_emit_32(high_nr_free[order]);
+		MLOG_FIELD(buddyinfo_filter, B_HIGH, high_nr_free[order]);
 
-
-	spin_unlock_bh(&mlogbuf_lock);
+	return n;
 }
 
 struct task_struct *find_trylock_task_mm(struct task_struct *t)
@@ -500,84 +547,68 @@ static short lowmem_oom_score_adj_to_oom_adj(short oom_score_adj)
 		return ((oom_score_adj * -OOM_DISABLE * 10) / OOM_SCORE_ADJ_MAX + 5) / 10;	/* round */
 }
 
-static void mlog_procinfo(void)
+static int mlog_oom_adj(struct task_struct *p)
 {
-	struct task_struct *tsk;
-
-	rcu_read_lock();
-	for_each_process(tsk) {
-		int oom_score_adj;
-		const struct cred *cred = NULL;
-		struct task_struct *real_parent;
-		struct task_struct *p;
-		pid_t ppid;
-		struct task_struct *t;
-		unsigned long swap_in, swap_out, fm_flt, min_flt, maj_flt;
-		unsigned long rss;
-		unsigned long rswap;
-
-		if (tsk->flags & PF_KTHREAD)
-			continue;
-
-		p = find_trylock_task_mm(tsk);
-		if (!p)
-			continue;
-
-		if (!p->signal)
-			goto unlock_continue;
-
 #ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_AUTODETECT_OOM_ADJ_VALUES
-		oom_score_adj = lowmem_oom_score_adj_to_oom_adj(p->signal->oom_score_adj);
+	return lowmem_oom_score_adj_to_oom_adj(p->signal->oom_score_adj);
 #else
-		oom_score_adj = p->signal->oom_adj;
+	return p->signal->oom_adj;
 #endif
+}
 
-		if (max_adj < oom_score_adj || oom_score_adj < min_adj)
-			goto unlock_continue;
+/* called under rcu_read_lock() with @p task_lock'ed */
+static bool mlog_proc_wanted(struct task_struct *p, int oom_adj)
+{
+	const struct cred *cred;
+	struct task_struct *real_parent;
+	bool wanted = false;
 
-		if (limit_pid != -1 && p->pid != limit_pid)
-			goto unlock_continue;
+	if (max_adj < oom_adj || oom_adj < min_adj)
+		return false;
 
-		cred = get_task_cred(p);
-		if (!cred)
-			goto unlock_continue;
+	if (limit_pid != -1 && p->pid != limit_pid)
+		return false;
 
 	/*
 	 * 1. mediaserver is a suspect in many ANR/FLM cases.
 	 * 2. procesname is "mediaserver" not "/system/bin/mediaserver"
 	 */
 	if (strncmp("mediaserver", p->comm, TASK_COMM_LEN) == 0)
-		goto collect_proc_mem_info;
+		return true;
 
-		/* skip root user */
-		if (__kuid_val(cred->uid) == AID_ROOT)
-			goto unlock_continue;
+	cred = get_task_cred(p);
+	if (!cred)
+		return false;
 
-		real_parent = rcu_dereference(p->real_parent);
-		if (!real_parent)
-			goto unlock_continue;
+	/* skip root user */
+	if (__kuid_val(cred->uid) == AID_ROOT)
+		goto out;
 
-		ppid = real_parent->pid;
-		/* skip non java proc (parent is init) */
-		if (ppid == 1)
-			goto unlock_continue;
+	/* skip non java proc (parent is init) */
+	real_parent = rcu_dereference(p->real_parent);
+	if (!real_parent || real_parent->pid == 1)
+		goto out;
 
-		if (oom_score_adj == -16) {
-			/* only keep system server */
-			if (__kuid_val(cred->uid) != AID_SYSTEM)
-				goto unlock_continue;
-		}
+	/* only keep system server */
+	if (oom_adj == -16 && __kuid_val(cred->uid) != AID_SYSTEM)
+		goto out;
+
+	wanted = true;
+out:
+	put_cred(cred);
+	return wanted;
+}
 
-collect_proc_mem_info:
-		/* reset data */
-		swap_in = swap_out = fm_flt = min_flt = maj_flt = 0;
+static int mlog_proc_fields(struct task_struct *p, int oom_adj, unsigned long *v)
+{
+	unsigned long swap_in = 0, swap_out = 0, fm_flt = 0;
+	struct task_struct *t;
+	int n = 0;
 
-		/* all threads */
+	/* all threads, only walked when a counter is selected */
+	if (proc_filter & P_FMT_COUNT) {
 		t = p;
 		do {
-			/* min_flt += t->min_flt; */
-			/* maj_flt += t->maj_flt; */
-
 			fm_flt += t->fm_flt;
 #ifdef CONFIG_SWAP
 			swap_in += t->swap_in;
@@ -590,71 +621,335 @@ collect_proc_mem_info:
 				break;
 #endif
 #endif
-
 		} while (t != p);
+	}
 
-		/* emit log */
-		rss = P2K(get_mm_rss(p->mm));
-		rswap = P2K(get_mm_counter(p->mm, MM_SWAPENTS));
+	MLOG_FIELD(proc_filter, P_ADJ, oom_adj);
+	MLOG_FIELD(proc_filter, P_RSS, P2K(get_mm_rss(p->mm)));
+	MLOG_FIELD(proc_filter, P_RSWAP, P2K(get_mm_counter(p->mm, MM_SWAPENTS)));
+	MLOG_FIELD(proc_filter, P_SWPIN, swap_in);
+	MLOG_FIELD(proc_filter, P_SWPOUT, swap_out);
+	MLOG_FIELD(proc_filter, P_FMFAULT, fm_flt);
+	return n;
+}
 
-		spin_lock_bh(&mlogbuf_lock);
-		mlog_emit_32(p->pid);
-		mlog_emit_32(oom_score_adj);
-		mlog_emit_32(rss);
-		mlog_emit_32(rswap);
-		mlog_emit_32(swap_in);
-		mlog_emit_32(swap_out);
-		mlog_emit_32(fm_flt);
-		/* mlog_emit_32(min_flt); */
-		/* mlog_emit_32(maj_flt); */
-		spin_unlock_bh(&mlogbuf_lock);
+static void mlog_emit_array(const unsigned long *v, int n)
+{
+	int i;
 
- unlock_continue:
-		if (cred)
-			put_cred(cred);
+	spin_lock_bh(&mlogbuf_lock);
+	/* bin_mode was switched on under us, the ring holds records now */
+	if (!bin_mode) {
+		for (i = 0; i < n; i++)
+			mlog_emit_32(v[i]);
+	}
+	spin_unlock_bh(&mlogbuf_lock);
+}
+
+static void mlog_procinfo(void)
+{
+	struct task_struct *tsk;
+
+	rcu_read_lock();
+	for_each_process(tsk) {
+		unsigned long v[1 + MLOG_NR_PROC];
+		struct task_struct *p;
+		int oom_adj, n;
+
+		if (tsk->flags & PF_KTHREAD)
+			continue;
+
+		p = find_trylock_task_mm(tsk);
+		if (!p)
+			continue;
+
+		if (!p->signal)
+			goto unlock_continue;
+
+		oom_adj = mlog_oom_adj(p);
+		if (!mlog_proc_wanted(p, oom_adj))
+			goto unlock_continue;
+
+		v[0] = p->pid;
+		n = 1 + mlog_proc_fields(p, oom_adj, v + 1);
+		mlog_emit_array(v, n);
 
+ unlock_continue:
 		task_unlock(p);
 	}
 	rcu_read_unlock();
+}
+
+static void mlog_bin_put(unsigned long v)
+{
+	while (v >= 0x80) {
+		mlog_bin_rec[mlog_bin_len++] = v | 0x80;
+		v >>= 7;
+	}
+	mlog_bin_rec[mlog_bin_len++] = v;
+}
+
+/* zigzag so that small negative deltas stay short too */
+static void mlog_bin_put_delta(unsigned long v, unsigned long prev)
+{
+	long d = v - prev;
+
+	mlog_bin_put(((unsigned long)d << 1) ^ (d >> (BITS_PER_LONG - 1)));
+}
+
+static unsigned int mlog_bin_rec_len(unsigned int idx)
+{
+	return MLOG_BIN(idx) | MLOG_BIN(idx + 1) << 8;
+}
+
+static struct mlog_bin_proc *mlog_bin_proc_find(pid_t pid)
+{
+	int i;
+
+	for (i = 0; i < mlog_bin_nr_procs; i++) {
+		if (mlog_bin_procs[i].pid == pid)
+			return &mlog_bin_procs[i];
+	}
+	return NULL;
+}
+
+/* a free slot, else one of a process not visited by this sample */
+static struct mlog_bin_proc *mlog_bin_proc_alloc(void)
+{
+	int i;
+
+	if (mlog_bin_nr_procs < MLOG_BIN_MAX_PROCS)
+		return &mlog_bin_procs[mlog_bin_nr_procs++];
+	for (i = 0; i < MLOG_BIN_MAX_PROCS; i++) {
+		if (mlog_bin_procs[i].seq != mlog_bin_seq)
+			return &mlog_bin_procs[i];
+	}
+	return NULL;
+}
+
+/*
+ * List @tsk if it is new or its oom_score_adj bucket or RSS moved since it
+ * was last listed; the thread walk for its counters is only done then.
+ */
+static void mlog_bin_proc(struct task_struct *tsk)
+{
+	unsigned long v[MLOG_NR_PROC];
+	struct mlog_bin_proc *c;
+	struct task_struct *p;
+	unsigned long rss, drss;
+	int oom_adj, bucket, i, n;
+
+	if (tsk->flags & PF_KTHREAD)
+		return;
+
+	p = find_trylock_task_mm(tsk);
+	if (!p)
+		return;
+
+	if (!p->signal)
+		goto unlock;
+
+	oom_adj = mlog_oom_adj(p);
+	if (!mlog_proc_wanted(p, oom_adj))
+		goto unlock;
+
+	bucket = lowmem_adj_bucket(p->signal->oom_score_adj);
+	rss = P2K(get_mm_rss(p->mm));
+	c = mlog_bin_proc_find(p->pid);
+	if (c) {
+		c->seq = mlog_bin_seq;
+		drss = rss > c->rss ? rss - c->rss : c->rss - rss;
+		if (c->bucket == bucket && drss < proc_rss_delta)
+			goto unlock;
+	}
+
+	if (mlog_bin_len + MLOG_BIN_PROC_MAX > MLOG_BIN_REC_MAX) {
+		mlog_bin_trunc = true;
+		goto unlock;
+	}
+
+	n = mlog_proc_fields(p, oom_adj, v);
+	mlog_bin_put((unsigned long)p->pid << 1 | !c);
+	for (i = 0; i < n; i++)
+		mlog_bin_put_delta(v[i], c ? c->v[i] : 0);
+	mlog_bin_listed++;
+
+	if (!c) {
+		c = mlog_bin_proc_alloc();
+		if (!c)
+			goto unlock;
+		c->pid = p->pid;
+		c->seq = mlog_bin_seq;
+	}
+	c->bucket = bucket;
+	c->rss = rss;
+	memcpy(c->v, v, sizeof(v));
+
+ unlock:
+	task_unlock(p);
+}
+
+static void mlog_bin_procinfo(void)
+{
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	int i, n;
+
+	/*
+	 * Processes that never had their oom_score_adj written are not in the
+	 * LMK index; none of them passes mlog_proc_wanted() but mediaserver.
+	 */
+	n = lowmem_adj_snapshot(mlog_bin_tasks, MLOG_BIN_MAX_PROCS,
+				OOM_SCORE_ADJ_MIN, OOM_SCORE_ADJ_MAX);
+	rcu_read_lock();
+	for (i = 0; i < n; i++)
+		mlog_bin_proc(mlog_bin_tasks[i]);
+	rcu_read_unlock();
+	for (i = 0; i < n; i++)
+		put_task_struct(mlog_bin_tasks[i]);
+#else
+	struct task_struct *tsk;
+
+	rcu_read_lock();
+	for_each_process(tsk)
+		mlog_bin_proc(tsk);
+	rcu_read_unlock();
+#endif
+}
+
+/* append mlog_bin_rec to the ring, called with mlog_bin_lock held */
+static void mlog_bin_commit(bool key)
+{
+	bool dropped = false;
+	unsigned int i;
+
+	spin_lock_bh(&mlogbuf_lock);
+	if (!bin_mode || (mlog_bin_need_key && !key))
+		goto out;
+
+	while (mlog_end - mlog_start + mlog_bin_len > MLOG_BIN_SIZE) {
+		mlog_start += mlog_bin_rec_len(mlog_start);
+		dropped = true;
+	}
+	if (dropped) {
+		/* the deltas that followed a dropped record lost their base */
+		while (mlog_start != mlog_end && !(MLOG_BIN(mlog_start + 2) & MLOG_BIN_KEY))
+			mlog_start += mlog_bin_rec_len(mlog_start);
+		if (mlog_start == mlog_end && !key) {
+			mlog_bin_need_key = true;
+			goto out;
+		}
+	}
+
+	for (i = 0; i < mlog_bin_len; i++)
+		MLOG_BIN(mlog_end + i) = mlog_bin_rec[i];
+	mlog_end += mlog_bin_len;
+	if (key)
+		mlog_bin_need_key = false;
+out:
+	spin_unlock_bh(&mlogbuf_lock);
+}
+
+static void mlog_bin_sample(int type, unsigned long long t)
+{
+	unsigned long v[MLOG_NR_GLOBAL];
+	unsigned int nr_pos;
+	unsigned long ms;
+	int i, n = 0;
+	bool key;
+
+	do_div(t, NSEC_PER_MSEC);
+	ms = t;
+
+	spin_lock_bh(&mlog_bin_lock);
+	mlog_bin_seq++;
+	key = ACCESS_ONCE(mlog_bin_need_key) ||
+		mlog_bin_seq - mlog_bin_key_seq >= bin_key_intval;
+	if (key) {
+		mlog_bin_key_seq = mlog_bin_seq;
+		mlog_bin_nr_procs = 0;
+		memset(mlog_bin_prev, 0, sizeof(mlog_bin_prev));
+	}
+	mlog_bin_len = MLOG_BIN_HDR_LEN;
+	mlog_bin_listed = 0;
+	mlog_bin_trunc = false;
+
+	mlog_bin_put(type);
+	mlog_bin_put(key ? ms : ms - mlog_bin_time);
+	mlog_bin_time = ms;
+	if (key) {
+		mlog_bin_put(meminfo_filter);
+		mlog_bin_put(vmstat_filter);
+		mlog_bin_put(buddyinfo_filter);
+		mlog_bin_put(proc_filter);
+		mlog_bin_put(MAX_ORDER);
+	}
+
+	if (meminfo_filter)
+		n += mlog_meminfo(v + n);
+	if (vmstat_filter)
+		n += mlog_vmstat(v + n);
+	if (buddyinfo_filter)
+		n += mlog_buddyinfo(v + n);
+	for (i = 0; i < n; i++) {
+		mlog_bin_put_delta(v[i], mlog_bin_prev[i]);
+		mlog_bin_prev[i] = v[i];
+	}
+
+	nr_pos = mlog_bin_len;
+	mlog_bin_len += 2;
+	if (proc_filter)
+		mlog_bin_procinfo();
+
+	mlog_bin_rec[nr_pos] = mlog_bin_listed;
+	mlog_bin_rec[nr_pos + 1] = mlog_bin_listed >> 8;
+	mlog_bin_rec[0] = mlog_bin_len;
+	mlog_bin_rec[1] = mlog_bin_len >> 8;
+	mlog_bin_rec[2] = (key ? MLOG_BIN_KEY : 0) | (mlog_bin_trunc ? MLOG_BIN_TRUNC : 0);
 
+	mlog_bin_commit(key);
+	spin_unlock_bh(&mlog_bin_lock);
 }
 
 void mlog(int type)
 {
 	/* unsigned long flag; */
+	unsigned long v[4 + MLOG_NR_GLOBAL];
 	unsigned long microsec_rem;
 	unsigned long long t = local_clock();
+	int n = 0;
 #ifdef PROFILE_MLOG_OVERHEAD
 	unsigned long long t1 = t;
 #endif
 	/* MLOG_PRINTK("[mlog] log %d %d %d\n", meminfo_filter, vmstat_filter, proc_filter); */
 
+	if (bin_mode) {
+		mlog_bin_sample(type, t);
+		goto out;
+	}
+
 	/* time stamp */
 	microsec_rem = do_div(t, 1000000000);
 
-	/* spin_lock_irqsave(&mlogbuf_lock, flag); */
-
-	spin_lock_bh(&mlogbuf_lock);
-	mlog_emit_32(MLOG_ID);	/* tag for correct start point */
-	mlog_emit_32(type);
-	mlog_emit_32((unsigned long)t);
-	mlog_emit_32(microsec_rem / 1000);
-	spin_unlock_bh(&mlogbuf_lock);
+	v[n++] = MLOG_ID;	/* tag for correct start point */
+	v[n++] = type;
+	v[n++] = (unsigned long)t;
+	v[n++] = microsec_rem / 1000;
 
 	/* memory log */
 	if (meminfo_filter)
-		mlog_meminfo();
+		n += mlog_meminfo(v + n);
 	if (vmstat_filter)
-		mlog_vmstat();
+		n += mlog_vmstat(v + n);
 
 	if (buddyinfo_filter)
-		mlog_buddyinfo();
+		n += mlog_buddyinfo(v + n);
+
+	mlog_emit_array(v, n);
 
 	if (proc_filter)
 		mlog_procinfo();
 
-	/* spin_unlock_irqrestore(&mlogbuf_lock, flag); */
-
+out:
 	if (waitqueue_active(&mlog_wait))
 		wake_up_interruptible(&mlog_wait);
 
@@ -668,6 +963,8 @@ void mlog_doopen(void)
 {
 	spin_lock_bh(&mlogbuf_lock);
 	strfmt_idx = 0;
+	/* a new reader has no base for the deltas, give it a keyframe */
+	mlog_bin_need_key = true;
 	spin_unlock_bh(&mlogbuf_lock);
 }
 
@@ -676,6 +973,43 @@ int mlog_unread(void)
 	return mlog_end - mlog_start;
 }
 
+/* whole records only, as many as fit in @len */
+static int mlog_doread_bin(char __user *buf, size_t len)
+{
+	unsigned int n = 0, rlen;
+	int error;
+	u8 *kbuf;
+
+	len = min_t(size_t, len, 2 * MLOG_BIN_REC_MAX);
+	kbuf = kmalloc(len, GFP_KERNEL);
+	if (!kbuf)
+		return -ENOMEM;
+
+	error = wait_event_interruptible(mlog_wait, (mlog_start - mlog_end));
+	if (error)
+		goto out;
+
+	spin_lock_bh(&mlogbuf_lock);
+	while (mlog_start != mlog_end) {
+		rlen = mlog_bin_rec_len(mlog_start);
+		if (n + rlen > len)
+			break;
+		for (; rlen; rlen--)
+			kbuf[n++] = MLOG_BIN(mlog_start++);
+	}
+	spin_unlock_bh(&mlogbuf_lock);
+
+	if (!n)
+		error = -EINVAL;
+	else if (copy_to_user(buf, kbuf, n))
+		error = -EFAULT;
+	else
+		error = n;
+out:
+	kfree(kbuf);
+	return error;
+}
+
 int mlog_doread(char __user *buf, size_t len)
 {
 	unsigned i;
@@ -684,6 +1018,8 @@ int mlog_doread(char __user *buf, size_t len)
 
 	if (!buf || len < 0)
 		goto out;
+	if (bin_mode)
+		return mlog_doread_bin(buf, len);
 	error = 0;
 	if (!len)
 		goto out;
@@ -746,9 +1082,10 @@ int mlog_doread(char __user *buf, size_t len)
 
 static void mlog_timer_handler(unsigned long data)
 {
+	mt_ctimer_fired(&mlog_ctimer_src);
 	mlog(MLOG_TRIGGER_TIMER);
 
-	mod_timer(&mlog_timer, round_jiffies(jiffies + timer_intval));
+	mod_timer(&mlog_timer, mt_ctimer_expires(&mlog_ctimer_src, jiffies + timer_intval));
 }
 
 static void mlog_init_logger(void)
@@ -757,7 +1094,8 @@ static void mlog_init_logger(void)
 	mlog_reset_format();
 	mlog_reset_buffer();
 
-	setup_timer(&mlog_timer, mlog_timer_handler, 0);
+	/* nothing to log while every cpu is idle */
+	__setup_timer(&mlog_timer, mlog_timer_handler, 0, TIMER_DEFERRABLE);
 	mlog_timer.expires = jiffies + timer_intval;
 
 	add_timer(&mlog_timer);
@@ -785,6 +1123,8 @@ static void __exit mlog_exit(void)
 module_param(min_adj, int, S_IRUGO | S_IWUSR);
 module_param(max_adj, int, S_IRUGO | S_IWUSR);
 module_param(limit_pid, int, S_IRUGO | S_IWUSR);
+module_param(bin_key_intval, uint, S_IRUGO | S_IWUSR);
+module_param(proc_rss_delta, uint, S_IRUGO | S_IWUSR);
 
 static int do_filter_handler(const char *val, const struct kernel_param *kp)
 {
@@ -827,6 +1167,10 @@ param_check_uint(proc_filter, &proc_filter);
 module_param_cb(proc_filter, &param_ops_change_filter, &proc_filter, S_IRUGO | S_IWUSR);
 __MODULE_PARM_TYPE(proc_filter, uint);
 
+param_check_uint(bin_mode, &bin_mode);
+module_param_cb(bin_mode, &param_ops_change_filter, &bin_mode, S_IRUGO | S_IWUSR);
+__MODULE_PARM_TYPE(bin_mode, uint);
+
 param_check_ulong(timer_intval, &timer_intval);
 module_param_cb(timer_intval, &param_ops_change_time_intval, &timer_intval, S_IRUGO | S_IWUSR);
 __MODULE_PARM_TYPE(timer_intval, ulong);
@@ -3,4 +3,25 @@
 
 extern void mlog_init_procfs(void);
 
+/*
+ * bin_mode=1: /proc/mlog returns whole records of
+ *   u8 len[2] (little endian, these 3 bytes included), u8 flags,
+ * followed by LEB128 varints:
+ *   type
+ *   time in ms, absolute on a keyframe, else delta to the previous record
+ *   keyframe only: meminfo_filter, vmstat_filter, buddyinfo_filter,
+ *     proc_filter, MAX_ORDER
+ *   one zigzag delta per selected global field, in /proc/mlog_fmt order
+ *   u8 nr_procs[2] (little endian)
+ *   per process: pid << 1 | fresh, one zigzag delta per selected proc field
+ * Deltas are taken against the previous value of the same field, against 0
+ * on a keyframe or for a fresh process. Only processes that are new or whose
+ * oom_score_adj bucket or RSS moved are listed, the others keep their last
+ * values; a keyframe lists them all and resets the decoder's table. Decoding
+ * starts at the first keyframe.
+ */
+#define MLOG_BIN_HDR_LEN    3
+#define MLOG_BIN_KEY        (1 << 0)
+#define MLOG_BIN_TRUNC      (1 << 1)	/* process list cut short */
+
 #endif
@@ -29,6 +29,7 @@
 
 #include <linux/ftrace_event.h>
 #include <linux/bug.h>
+#include <mt-plat/mt_kernel_marker.h>
 
 #define MMPROFILE_INTERNAL
 #include <mmprofile_internal.h>
@@ -600,36 +601,22 @@ static int MMProfileRegisterStaticEvents(int sync)
 
 /* the MMP_TRACING is defined only when CONFIG_TRACING is defined and we enable mmp to trace its API. */
 #ifdef MMP_TRACING
-static unsigned long __read_mostly tracing_mark_write_addr;
-static inline void __mt_update_tracing_mark_write_addr(void)
-{
-	if (unlikely(0 == tracing_mark_write_addr))
-		tracing_mark_write_addr = kallsyms_lookup_name("tracing_mark_write");
-}
-
 static inline void mmp_kernel_trace_begin(char *name)
 {
-	if (mmp_trace_log_on) {
-		__mt_update_tracing_mark_write_addr();
-		event_trace_printk(tracing_mark_write_addr, "B|%d|%s\n", current->tgid, name);
-	}
+	if (mmp_trace_log_on)
+		mt_kernel_marker_write('B', name, 0);
 }
 
 static inline void mmp_kernel_trace_counter(char *name, int count)
 {
-	if (mmp_trace_log_on) {
-		__mt_update_tracing_mark_write_addr();
-		event_trace_printk(tracing_mark_write_addr,
-			"C|%d|%s|%d\n", in_interrupt() ? -1 : current->tgid, name, count);
-	}
+	if (mmp_trace_log_on)
+		mt_kernel_marker_write('C', name, count);
 }
 
 static inline void mmp_kernel_trace_end(void)
 {
-	if (mmp_trace_log_on) {
-		__mt_update_tracing_mark_write_addr();
-		event_trace_printk(tracing_mark_write_addr, "E\n");
-	}
+	if (mmp_trace_log_on)
+		mt_kernel_marker_write('E', NULL, 0);
 }
 #else
 static inline void mmp_kernel_trace_begin(char *name)
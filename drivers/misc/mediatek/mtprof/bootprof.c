@@ -6,8 +6,11 @@
 #include <linux/moduleparam.h>
 #include <asm/uaccess.h>
 #include <linux/printk.h>
+#include <linux/async.h>
+#include <linux/device.h>
 
 #include "internal.h"
+#include "mt_evtlog.h"
 #include <mt_cpufreq.h>
 
 #define BOOT_STR_SIZE 128
@@ -22,7 +25,43 @@ struct boot_log_struct {
 	char event[BOOT_STR_SIZE];
 } mt_bootprof[BOOT_LOG_NUM];
 
-static int boot_log_count;
+/*
+ * initcalls slower than initcall_thresh_ms, kept sorted by start time so
+ * async initcalls show up as overlapping ranges
+ */
+#define BOOT_INITCALL_NUM 64
+
+struct boot_initcall_struct {
+	u64 start;
+	u64 end;
+	initcall_t fn;
+	pid_t pid;
+	bool async;
+} mt_boot_initcall[BOOT_INITCALL_NUM];
+
+/*
+ * device PM callbacks of the last suspend/resume slower than pm_thresh_ms,
+ * sorted the same way so async suspend/resume shows up as overlapping ranges
+ */
+#define BOOT_PM_NUM 64
+#define BOOT_PM_DEV_LEN 32
+
+struct boot_pm_struct {
+	u64 start;
+	u64 end;
+	char dev[BOOT_PM_DEV_LEN];
+	const char *info;
+	pid_t pid;
+	bool async;
+} mt_boot_pm[BOOT_PM_NUM];
+
+static atomic_t boot_log_idx = ATOMIC_INIT(0);
+static int boot_initcall_count;
+static DEFINE_SPINLOCK(boot_initcall_lock);
+static unsigned int bootprof_initcall_thresh_ms = 5;
+static int boot_pm_count;
+static DEFINE_SPINLOCK(boot_pm_lock);
+static unsigned int bootprof_pm_thresh_ms = 5;
 static DEFINE_MUTEX(mt_bootprof_lock);
 static int mt_bootprof_enabled;
 static int bootprof_lk_t, bootprof_pl_t;
@@ -31,24 +70,95 @@ int boot_finish = 0;
 
 module_param_named(pl_t, bootprof_pl_t, int, S_IRUGO | S_IWUSR);
 module_param_named(lk_t, bootprof_lk_t, int, S_IRUGO | S_IWUSR);
+module_param_named(initcall_thresh_ms, bootprof_initcall_thresh_ms, uint, S_IRUGO | S_IWUSR);
+module_param_named(pm_thresh_ms, bootprof_pm_thresh_ms, uint, S_IRUGO | S_IWUSR);
+
+static inline int boot_log_count(void)
+{
+	return min(atomic_read(&boot_log_idx), BOOT_LOG_NUM);
+}
 
+/* slots are claimed atomically, so this may be called from any context */
 void log_boot(char *str)
 {
 	unsigned long long ts;
+	int i;
 
 	if (0 == mt_bootprof_enabled)
 		return;
 	ts = sched_clock();
 	pr_err("BOOTPROF:%10Ld.%06ld:%s\n", nsec_high(ts), nsec_low(ts), str);
-	if (boot_log_count >= BOOT_LOG_NUM) {
+	i = atomic_inc_return(&boot_log_idx) - 1;
+	mt_evtlog(MT_EVT_BOOT, i, 0);
+	if (i >= BOOT_LOG_NUM) {
 		pr_err("[BOOTPROF] not enuough bootprof buffer\n");
 		return;
 	}
-	mutex_lock(&mt_bootprof_lock);
-	mt_bootprof[boot_log_count].timestamp = ts;
-	strcpy((char *)&mt_bootprof[boot_log_count].event, str);
-	boot_log_count++;
-	mutex_unlock(&mt_bootprof_lock);
+	mt_bootprof[i].timestamp = ts;
+	strlcpy(mt_bootprof[i].event, str, BOOT_STR_SIZE);
+}
+
+void bootprof_initcall(initcall_t fn, unsigned long long ts)
+{
+	unsigned long long te = sched_clock();
+	unsigned long flags;
+	int i;
+
+	mt_evtlog(MT_EVT_INITCALL, (unsigned long)fn, te - ts);
+	if (boot_finish || te - ts < (u64)bootprof_initcall_thresh_ms * NSEC_PER_MSEC)
+		return;
+
+	spin_lock_irqsave(&boot_initcall_lock, flags);
+	if (boot_initcall_count >= BOOT_INITCALL_NUM) {
+		spin_unlock_irqrestore(&boot_initcall_lock, flags);
+		return;
+	}
+	for (i = boot_initcall_count; i > 0 && mt_boot_initcall[i - 1].start > ts; i--)
+		mt_boot_initcall[i] = mt_boot_initcall[i - 1];
+	mt_boot_initcall[i].start = ts;
+	mt_boot_initcall[i].end = te;
+	mt_boot_initcall[i].fn = fn;
+	mt_boot_initcall[i].pid = current->pid;
+	mt_boot_initcall[i].async = current_is_async();
+	boot_initcall_count++;
+	spin_unlock_irqrestore(&boot_initcall_lock, flags);
+}
+
+/* a new system suspend starts, forget the previous one */
+void bootprof_pm_begin(void)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&boot_pm_lock, flags);
+	boot_pm_count = 0;
+	spin_unlock_irqrestore(&boot_pm_lock, flags);
+}
+
+/* @info must be a string literal, it is kept until the next suspend */
+void bootprof_pm_dev(struct device *dev, const char *info, unsigned long long ts)
+{
+	unsigned long long te = sched_clock();
+	unsigned long flags;
+	int i;
+
+	if (te - ts < (u64)bootprof_pm_thresh_ms * NSEC_PER_MSEC)
+		return;
+
+	spin_lock_irqsave(&boot_pm_lock, flags);
+	if (boot_pm_count >= BOOT_PM_NUM) {
+		spin_unlock_irqrestore(&boot_pm_lock, flags);
+		return;
+	}
+	for (i = boot_pm_count; i > 0 && mt_boot_pm[i - 1].start > ts; i--)
+		mt_boot_pm[i] = mt_boot_pm[i - 1];
+	mt_boot_pm[i].start = ts;
+	mt_boot_pm[i].end = te;
+	strlcpy(mt_boot_pm[i].dev, dev_name(dev), BOOT_PM_DEV_LEN);
+	mt_boot_pm[i].info = info;
+	mt_boot_pm[i].pid = current->pid;
+	mt_boot_pm[i].async = current_is_async();
+	boot_pm_count++;
+	spin_unlock_irqrestore(&boot_pm_lock, flags);
 }
 
 static void bootup_finish(void)
@@ -128,7 +238,7 @@ static int mt_bootprof_show(struct seq_file *m, void *v)
 	SEQ_printf(m, "%10Ld.%06ld : ON\n",
 		   nsec_high(timestamp_on), nsec_low(timestamp_on));
 
-	for (i = 0; i < boot_log_count; i++) {
+	for (i = 0; i < boot_log_count(); i++) {
 		SEQ_printf(m, "%10Ld.%06ld : %s\n",
 			   nsec_high(mt_bootprof[i].timestamp), nsec_low(mt_bootprof[i].timestamp),
 			   mt_bootprof[i].event);
@@ -137,6 +247,34 @@ static int mt_bootprof_show(struct seq_file *m, void *v)
 	SEQ_printf(m, "%10Ld.%06ld : OFF\n",
 		   nsec_high(timestamp_off), nsec_low(timestamp_off));
 	SEQ_printf(m, "----------------------------------------\n");
+
+	SEQ_printf(m, "initcalls >= %ums (start - end, msec, A=async, pid)\n",
+		   bootprof_initcall_thresh_ms);
+	for (i = 0; i < boot_initcall_count; i++) {
+		struct boot_initcall_struct *ic = &mt_boot_initcall[i];
+
+		SEQ_printf(m, "%10Ld.%06ld - %10Ld.%06ld %6Ld.%06ld %c %5d : %pf\n",
+			   nsec_high(ic->start), nsec_low(ic->start),
+			   nsec_high(ic->end), nsec_low(ic->end),
+			   nsec_high(ic->end - ic->start), nsec_low(ic->end - ic->start),
+			   ic->async ? 'A' : ' ', ic->pid, ic->fn);
+	}
+	SEQ_printf(m, "----------------------------------------\n");
+
+	SEQ_printf(m, "last suspend/resume device callbacks >= %ums (start - end, msec, A=async, pid)\n",
+		   bootprof_pm_thresh_ms);
+	spin_lock_irq(&boot_pm_lock);
+	for (i = 0; i < boot_pm_count; i++) {
+		struct boot_pm_struct *pm = &mt_boot_pm[i];
+
+		SEQ_printf(m, "%10Ld.%06ld - %10Ld.%06ld %6Ld.%06ld %c %5d : %s %s\n",
+			   nsec_high(pm->start), nsec_low(pm->start),
+			   nsec_high(pm->end), nsec_low(pm->end),
+			   nsec_high(pm->end - pm->start), nsec_low(pm->end - pm->start),
+			   pm->async ? 'A' : ' ', pm->pid, pm->dev, pm->info ? pm->info : "");
+	}
+	spin_unlock_irq(&boot_pm_lock);
+	SEQ_printf(m, "----------------------------------------\n");
 	return 0;
 }
 
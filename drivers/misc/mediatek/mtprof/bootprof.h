@@ -2,10 +2,26 @@
   boot logger: drivers/misc/mtprof/bootprof
   interface: /proc/bootprof
 */
+#include <linux/init.h>
+
+struct device;
+
 #ifdef CONFIG_SCHEDSTATS
 extern void log_boot(char *str);
+extern void bootprof_initcall(initcall_t fn, unsigned long long ts);
+extern void bootprof_pm_begin(void);
+extern void bootprof_pm_dev(struct device *dev, const char *info, unsigned long long ts);
 #else
 static inline void log_boot(char *str)
 {
 }
+static inline void bootprof_initcall(initcall_t fn, unsigned long long ts)
+{
+}
+static inline void bootprof_pm_begin(void)
+{
+}
+static inline void bootprof_pm_dev(struct device *dev, const char *info, unsigned long long ts)
+{
+}
 #endif
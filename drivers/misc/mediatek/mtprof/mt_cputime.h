@@ -7,10 +7,12 @@ int mtproc_counts(void);
 extern void save_mtproc_info(struct task_struct *p, unsigned long long ts);
 extern void end_mtproc_info(struct task_struct *p);
 extern void mt_cputime_switch(int on);
+extern void mt_cputime_opp_account(struct task_struct *p, cputime_t cputime);
 #else
 static inline void
 save_mtproc_info(struct task_struct *p, unsigned long long ts) {};
 static inline void end_mtproc_info(struct task_struct *p) {};
 static inline void mt_cputime_switch(int on) {};
+static inline void mt_cputime_opp_account(struct task_struct *p, cputime_t cputime) {};
 #endif
 
@@ -0,0 +1,122 @@
+#include <linux/sched.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+#include <linux/fs.h>
+#include <linux/debugfs.h>
+#include <linux/log2.h>
+
+#include "mt_evtlog.h"
+
+/*
+ * Per-CPU flight recorder of fixed size binary records. A producer only
+ * touches its own cpu's ring with local irqs off, so no lock is needed and
+ * the cost is a sched_clock() and one cache line write; the oldest record
+ * is overwritten when the ring wraps.
+ */
+static struct mt_evtlog_hdr *evt_hdr;
+static unsigned int evtlog_recs = 2048;
+static bool evtlog_enable = true;
+
+module_param_named(evtlog_recs, evtlog_recs, uint, S_IRUGO);
+module_param_named(evtlog_enable, evtlog_enable, bool, S_IRUGO | S_IWUSR);
+
+static inline struct mt_evtlog_rec *evt_rec(int cpu, u64 idx)
+{
+	return (struct mt_evtlog_rec *)((char *)evt_hdr + evt_hdr->data_offset) +
+		(size_t)cpu * evt_hdr->nr_recs + (idx & (evt_hdr->nr_recs - 1));
+}
+
+void mt_evtlog(u32 id, u64 a0, u64 a1)
+{
+	struct mt_evtlog_rec *r;
+	unsigned long flags;
+	u64 head;
+	int cpu;
+
+	if (!evtlog_enable || !evt_hdr)
+		return;
+
+	local_irq_save(flags);
+	cpu = smp_processor_id();
+	head = evt_hdr->cpu[cpu].head;
+	r = evt_rec(cpu, head);
+	r->ts = sched_clock();
+	r->id = id;
+	r->pid = current->pid;
+	r->a0 = a0;
+	r->a1 = a1;
+	/* record is complete before the reader can see the new head */
+	smp_wmb();
+	ACCESS_ONCE(evt_hdr->cpu[cpu].head) = head + 1;
+	local_irq_restore(flags);
+}
+EXPORT_SYMBOL(mt_evtlog);
+
+static size_t evtlog_size(void)
+{
+	return evt_hdr->data_offset +
+		(size_t)evt_hdr->nr_cpus * evt_hdr->nr_recs * sizeof(struct mt_evtlog_rec);
+}
+
+static ssize_t mt_evtlog_read(struct file *filp, char __user *ubuf, size_t cnt, loff_t *ppos)
+{
+	return simple_read_from_buffer(ubuf, cnt, ppos, evt_hdr, evtlog_size());
+}
+
+static int mt_evtlog_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+	return remap_vmalloc_range(vma, evt_hdr, vma->vm_pgoff);
+}
+
+static const struct file_operations mt_evtlog_fops = {
+	.open = simple_open,
+	.read = mt_evtlog_read,
+	.mmap = mt_evtlog_mmap,
+	.llseek = default_llseek,
+};
+
+/* early so boot events and most initcalls are caught */
+static int __init init_mt_evtlog(void)
+{
+	struct mt_evtlog_hdr *hdr;
+	unsigned int nr_recs;
+	size_t hdr_size;
+
+	nr_recs = clamp_t(unsigned int, evtlog_recs, 64, 65536);
+	nr_recs = rounddown_pow_of_two(nr_recs);
+	hdr_size = PAGE_ALIGN(sizeof(*hdr) + nr_cpu_ids * sizeof(struct mt_evtlog_cpu));
+
+	hdr = vmalloc_user(hdr_size + (size_t)nr_cpu_ids * nr_recs * sizeof(struct mt_evtlog_rec));
+	if (!hdr)
+		return -ENOMEM;
+	hdr->magic = MT_EVTLOG_MAGIC;
+	hdr->version = MT_EVTLOG_VERSION;
+	hdr->rec_size = sizeof(struct mt_evtlog_rec);
+	hdr->nr_cpus = nr_cpu_ids;
+	hdr->nr_recs = nr_recs;
+	hdr->data_offset = hdr_size;
+	smp_wmb();
+	evt_hdr = hdr;
+	return 0;
+}
+early_initcall(init_mt_evtlog);
+
+static int __init init_mt_evtlog_debugfs(void)
+{
+	struct dentry *dir;
+
+	if (!evt_hdr)
+		return 0;
+	dir = debugfs_create_dir("mtprof", NULL);
+	if (!dir)
+		return -ENOMEM;
+	if (!debugfs_create_file("evtlog", 0444, dir, NULL, &mt_evtlog_fops))
+		return -ENOMEM;
+	return 0;
+}
+device_initcall(init_mt_evtlog_debugfs);
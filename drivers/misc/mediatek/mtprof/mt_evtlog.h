@@ -0,0 +1,66 @@
+/*
+  binary event log: drivers/misc/mediatek/mtprof/mt_evtlog.c
+  interface: /sys/kernel/debug/mtprof/evtlog (read or mmap)
+  decoder: tools/mtprof/mt_evtdump.c, keep the layout below in sync
+*/
+#ifndef __MT_EVTLOG_H__
+#define __MT_EVTLOG_H__
+
+#include <linux/types.h>
+
+#define MT_EVTLOG_MAGIC		0x4556544d	/* "MTVE" */
+#define MT_EVTLOG_VERSION	1
+
+/* ISR..STIMER follow the order of mt_event_type in sched_monitor.c */
+enum mt_evt_id {
+	MT_EVT_BOOT = 1,	/* a0: index in /proc/bootprof */
+	MT_EVT_INITCALL,	/* a0: initcall, a1: duration ns */
+	MT_EVT_ISR,		/* a0: irq, a1: duration ns */
+	MT_EVT_SOFTIRQ,		/* a0: softirq nr, a1: duration ns */
+	MT_EVT_TASKLET,		/* a0: func, a1: duration ns */
+	MT_EVT_HRTIMER,		/* a0: func, a1: duration ns */
+	MT_EVT_STIMER,		/* a0: func, a1: duration ns */
+};
+
+struct mt_evtlog_rec {
+	__u64 ts;		/* sched_clock() */
+	__u32 id;
+	__u32 pid;
+	__u64 a0;
+	__u64 a1;
+};
+
+/* one cache line per cpu so the producers do not share lines */
+struct mt_evtlog_cpu {
+	__u64 head;		/* records written so far, slot is head % nr_recs */
+	__u64 pad[7];
+};
+
+/*
+ * The mapping starts with this header page, followed by nr_cpus rings of
+ * nr_recs records each at data_offset. A reader copies the records it
+ * wants and re-reads head: anything older than head - nr_recs + 1 may have
+ * been overwritten while it was copying.
+ */
+struct mt_evtlog_hdr {
+	__u32 magic;
+	__u16 version;
+	__u16 rec_size;
+	__u32 nr_cpus;
+	__u32 nr_recs;
+	__u32 data_offset;
+	__u32 pad[11];
+	struct mt_evtlog_cpu cpu[0];
+};
+
+#ifdef __KERNEL__
+#ifdef CONFIG_SCHEDSTATS
+extern void mt_evtlog(u32 id, u64 a0, u64 a1);
+#else
+static inline void mt_evtlog(u32 id, u64 a0, u64 a1)
+{
+}
+#endif
+#endif
+
+#endif /* __MT_EVTLOG_H__ */
@@ -0,0 +1,567 @@
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
+#include <linux/ktime.h>
+#include <linux/random.h>
+#include <linux/fs.h>
+#include <linux/bio.h>
+#include <linux/blkdev.h>
+#ifdef CONFIG_MTK_ION
+#include <ion.h>
+#include <ion_priv.h>
+#include <mtk/mtk_ion.h>
+#endif
+#ifdef CONFIG_MTK_M4U
+#include "m4u.h"
+#endif
+#ifdef CONFIG_MTK_CMDQ
+#include "cmdq_record.h"
+#endif
+#ifdef CONFIG_SW_SYNC
+#include <sw_sync.h>
+#endif
+#ifdef CONFIG_LZO_COMPRESS
+#include <linux/lzo.h>
+#endif
+#ifdef CONFIG_LZ4_COMPRESS
+#include <linux/lz4.h>
+#endif
+#ifdef CONFIG_LZ4K
+#include <linux/lz4k.h>
+#endif
+
+/*
+ * Latency benchmarks of the multimedia paths, one table for all of them so
+ * that vendor drops can be compared:
+ *
+ *   echo all > /sys/kernel/debug/mt_perfbench/run
+ *   cat /sys/kernel/debug/mt_perfbench/run
+ *
+ * or the name of one bench instead of all. Each measured operation is
+ * timed on its own, iters times (debugfs u32 next to run), on the writing
+ * cpu; pin the writer with taskset to compare clusters. A write replaces
+ * the table. The table is tab separated, one row per (bench, param), with
+ * the 50th, 90th and 99th percentile and the maximum in ns; its column
+ * set is fixed by the version line, tools/mtprof/perfbench.sh compares two
+ * of them. A bench whose driver is not built is absent, one that fails
+ * has its errno in err.
+ */
+#define PB_VERSION	1
+#define PB_MAX_ROWS	64
+
+struct pb_row {
+	char bench[16];
+	char param[24];
+	u32 n;
+	u32 p50, p90, p99, max;
+	int err;
+};
+
+struct pb_stat {
+	u32 *ns;
+	u32 n, cap;
+};
+
+struct pb_bench {
+	const char *name;
+	void (*run)(void);
+};
+
+static unsigned int iters = 1000;
+static char *blkdev = "/dev/block/mmcblk0";
+module_param(blkdev, charp, 0644);
+MODULE_PARM_DESC(blkdev, "block device of the 4K random read bench");
+
+static struct pb_row *pb_rows;
+static int pb_nr_rows;
+static DEFINE_MUTEX(pb_lock);
+
+static int pb_stat_init(struct pb_stat *st)
+{
+	st->n = 0;
+	st->cap = max(iters, 1U);
+	st->ns = vmalloc(st->cap * sizeof(*st->ns));
+	return st->ns ? 0 : -ENOMEM;
+}
+
+static void pb_stat_add(struct pb_stat *st, ktime_t t0)
+{
+	u64 ns = ktime_to_ns(ktime_sub(ktime_get(), t0));
+
+	if (st->n < st->cap)
+		st->ns[st->n++] = min_t(u64, ns, U32_MAX);
+}
+
+static int pb_cmp_u32(const void *a, const void *b)
+{
+	u32 x = *(const u32 *)a, y = *(const u32 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* adds the row of st and forgets the samples, st can be reused */
+static void pb_emit(const char *bench, const char *param, struct pb_stat *st, int err)
+{
+	struct pb_row *row;
+
+	if (pb_nr_rows == PB_MAX_ROWS)
+		return;
+	row = &pb_rows[pb_nr_rows++];
+	memset(row, 0, sizeof(*row));
+	strlcpy(row->bench, bench, sizeof(row->bench));
+	strlcpy(row->param, param, sizeof(row->param));
+	row->err = err;
+	if (st && st->n) {
+		sort(st->ns, st->n, sizeof(*st->ns), pb_cmp_u32, NULL);
+		row->n = st->n;
+		row->p50 = st->ns[(st->n - 1) * 50 / 100];
+		row->p90 = st->ns[(st->n - 1) * 90 / 100];
+		row->p99 = st->ns[(st->n - 1) * 99 / 100];
+		row->max = st->ns[st->n - 1];
+	}
+	if (st)
+		st->n = 0;
+}
+
+static const u32 pb_buf_sizes[] = { SZ_4K, SZ_64K, SZ_1M, SZ_8M, 0 };
+
+static const char *pb_size_name(u32 size, char *buf, size_t len)
+{
+	if (size >= SZ_1M)
+		snprintf(buf, len, "%uM", size >> 20);
+	else
+		snprintf(buf, len, "%uK", size >> 10);
+	return buf;
+}
+
+#ifdef CONFIG_MTK_ION
+static const struct {
+	const char *name;
+	unsigned int id;
+} pb_ion_heaps[] = {
+	{ "system_contig", ION_HEAP_TYPE_SYSTEM_CONTIG },
+	{ "mm", ION_HEAP_TYPE_MULTIMEDIA },
+};
+
+static void pb_ion(void)
+{
+	struct pb_stat alloc = { NULL }, release = { NULL };
+	struct ion_client *client;
+	struct ion_handle *handle;
+	char param[24], sz[8];
+	ktime_t t0;
+	int h, s, err;
+	u32 i;
+
+	if (!g_ion_device) {
+		pb_emit("ion_alloc", "-", NULL, -ENODEV);
+		return;
+	}
+	client = ion_client_create(g_ion_device, "mt_perfbench");
+	if (IS_ERR_OR_NULL(client)) {
+		pb_emit("ion_alloc", "-", NULL, -ENODEV);
+		return;
+	}
+	if (pb_stat_init(&alloc) || pb_stat_init(&release))
+		goto out;
+
+	for (h = 0; h < ARRAY_SIZE(pb_ion_heaps); h++) {
+		for (s = 0; pb_buf_sizes[s]; s++) {
+			snprintf(param, sizeof(param), "%s/%s", pb_ion_heaps[h].name,
+				 pb_size_name(pb_buf_sizes[s], sz, sizeof(sz)));
+			err = 0;
+			for (i = 0; i < alloc.cap; i++) {
+				t0 = ktime_get();
+				handle = ion_alloc(client, pb_buf_sizes[s], PAGE_SIZE,
+						   1 << pb_ion_heaps[h].id, 0);
+				if (IS_ERR_OR_NULL(handle)) {
+					err = handle ? PTR_ERR(handle) : -ENOMEM;
+					break;
+				}
+				pb_stat_add(&alloc, t0);
+				t0 = ktime_get();
+				ion_free(client, handle);
+				pb_stat_add(&release, t0);
+				cond_resched();
+			}
+			pb_emit("ion_alloc", param, &alloc, err);
+			pb_emit("ion_free", param, &release, err);
+		}
+	}
+out:
+	vfree(alloc.ns);
+	vfree(release.ns);
+	ion_client_destroy(client);
+}
+#endif
+
+#ifdef CONFIG_MTK_M4U
+static void pb_m4u(void)
+{
+	struct pb_stat map = { NULL }, unmap = { NULL };
+	m4u_client_t *client;
+	unsigned int mva;
+	char sz[8];
+	void *va;
+	ktime_t t0;
+	int s, err;
+	u32 i;
+
+	client = m4u_create_client();
+	if (IS_ERR_OR_NULL(client)) {
+		pb_emit("m4u_map", "-", NULL, -ENODEV);
+		return;
+	}
+	if (pb_stat_init(&map) || pb_stat_init(&unmap))
+		goto out;
+
+	for (s = 0; pb_buf_sizes[s]; s++) {
+		va = vmalloc(pb_buf_sizes[s]);
+		if (!va) {
+			pb_emit("m4u_map", pb_size_name(pb_buf_sizes[s], sz, sizeof(sz)), NULL, -ENOMEM);
+			continue;
+		}
+		err = 0;
+		for (i = 0; i < map.cap; i++) {
+			t0 = ktime_get();
+			err = m4u_alloc_mva(client, M4U_PORT_DISP_OVL0, (unsigned long)va, NULL,
+					    pb_buf_sizes[s], M4U_PROT_READ | M4U_PROT_WRITE, 0, &mva);
+			if (err)
+				break;
+			pb_stat_add(&map, t0);
+			t0 = ktime_get();
+			m4u_dealloc_mva(client, M4U_PORT_DISP_OVL0, mva);
+			pb_stat_add(&unmap, t0);
+			cond_resched();
+		}
+		vfree(va);
+		pb_size_name(pb_buf_sizes[s], sz, sizeof(sz));
+		pb_emit("m4u_map", sz, &map, err);
+		pb_emit("m4u_unmap", sz, &unmap, err);
+	}
+out:
+	vfree(map.ns);
+	vfree(unmap.ns);
+	m4u_destroy_client(client);
+}
+#endif
+
+#ifdef CONFIG_MTK_CMDQ
+/* an empty record is the submit, GCE end of command and wake up path only */
+static void pb_cmdq(void)
+{
+	struct pb_stat flush;
+	cmdqRecHandle handle;
+	ktime_t t0;
+	int err;
+	u32 i;
+
+	if (pb_stat_init(&flush)) {
+		pb_emit("cmdq_flush", "debug", NULL, -ENOMEM);
+		return;
+	}
+	err = cmdqRecCreate(CMDQ_SCENARIO_DEBUG, &handle);
+	if (err)
+		goto out;
+	for (i = 0; i < flush.cap; i++) {
+		cmdqRecReset(handle);
+		t0 = ktime_get();
+		err = cmdqRecFlush(handle);
+		if (err)
+			break;
+		pb_stat_add(&flush, t0);
+	}
+	cmdqRecDestroy(handle);
+out:
+	pb_emit("cmdq_flush", "debug", &flush, err);
+	vfree(flush.ns);
+}
+#endif
+
+#ifdef CONFIG_SW_SYNC
+/* merge of two fences, then the signal that releases both */
+static void pb_fence(void)
+{
+	struct pb_stat merge = { NULL }, signal = { NULL };
+	struct sw_sync_timeline *tl;
+	struct sync_fence *a, *b, *m;
+	struct sync_pt *pt;
+	ktime_t t0;
+	int err = 0;
+	u32 i;
+
+	tl = sw_sync_timeline_create("mt_perfbench");
+	if (!tl) {
+		pb_emit("fence_merge", "sw_sync", NULL, -ENOMEM);
+		return;
+	}
+	if (pb_stat_init(&merge) || pb_stat_init(&signal)) {
+		err = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < merge.cap; i++) {
+		a = b = NULL;
+		pt = sw_sync_pt_create(tl, tl->value + 1);
+		if (pt)
+			a = sync_fence_create("pb_a", pt);
+		pt = sw_sync_pt_create(tl, tl->value + 2);
+		if (pt)
+			b = sync_fence_create("pb_b", pt);
+		if (!a || !b) {
+			err = -ENOMEM;
+			if (a)
+				sync_fence_put(a);
+			break;
+		}
+
+		t0 = ktime_get();
+		m = sync_fence_merge("pb_m", a, b);
+		if (m)
+			pb_stat_add(&merge, t0);
+		t0 = ktime_get();
+		sw_sync_timeline_inc(tl, 2);
+		pb_stat_add(&signal, t0);
+
+		if (m)
+			sync_fence_put(m);
+		sync_fence_put(a);
+		sync_fence_put(b);
+		if (!m) {
+			err = -ENOMEM;
+			break;
+		}
+	}
+out:
+	pb_emit("fence_merge", "sw_sync", &merge, err);
+	pb_emit("fence_signal", "sw_sync", &signal, err);
+	vfree(merge.ns);
+	vfree(signal.ns);
+	sync_timeline_destroy(&tl->obj);
+}
+#endif
+
+/* the zram backends on one page, the data half compressible */
+struct pb_comp {
+	const char *name;
+	size_t wrkmem;
+	int (*compress)(const u8 *src, size_t len, u8 *dst, size_t *dst_len, void *wrkmem);
+	int (*decompress)(const u8 *src, size_t len, u8 *dst, size_t *dst_len);
+};
+
+#ifdef CONFIG_LZ4_COMPRESS
+static int pb_lz4_decompress(const u8 *src, size_t len, u8 *dst, size_t *dst_len)
+{
+	return lz4_decompress_unknownoutputsize(src, len, dst, dst_len);
+}
+#endif
+
+static const struct pb_comp pb_comps[] = {
+#ifdef CONFIG_LZO_COMPRESS
+	{ "lzo", LZO1X_1_MEM_COMPRESS, lzo1x_1_compress, lzo1x_decompress_safe },
+#endif
+#ifdef CONFIG_LZ4_COMPRESS
+	{ "lz4", LZ4_MEM_COMPRESS, lz4_compress, pb_lz4_decompress },
+#endif
+#ifdef CONFIG_LZ4K
+	{ "lz4k", LZ4K_MEM_COMPRESS, lz4k_compress, lz4k_decompress_safe },
+#endif
+	{ NULL },
+};
+
+static void pb_zram(void)
+{
+	const struct pb_comp *pc;
+	struct pb_stat comp = { NULL }, decomp = { NULL };
+	u8 *page, *cbuf, *wrkmem;
+	size_t clen, dlen;
+	ktime_t t0;
+	int err;
+	u32 i;
+
+	page = (u8 *)__get_free_page(GFP_KERNEL);
+	cbuf = kmalloc(2 * PAGE_SIZE, GFP_KERNEL);
+	if (!page || !cbuf || pb_stat_init(&comp) || pb_stat_init(&decomp)) {
+		pb_emit("zram_comp", "-", NULL, -ENOMEM);
+		goto out;
+	}
+	for (i = 0; i < PAGE_SIZE; i += 32) {
+		prandom_bytes(page + i, 16);
+		memset(page + i + 16, 0, 16);
+	}
+
+	for (pc = pb_comps; pc->name; pc++) {
+		wrkmem = kzalloc(pc->wrkmem, GFP_KERNEL);
+		if (!wrkmem) {
+			pb_emit("zram_comp", pc->name, NULL, -ENOMEM);
+			continue;
+		}
+		err = 0;
+		for (i = 0; i < comp.cap; i++) {
+			clen = 2 * PAGE_SIZE;
+			t0 = ktime_get();
+			err = pc->compress(page, PAGE_SIZE, cbuf, &clen, wrkmem) ? -EINVAL : 0;
+			if (err)
+				break;
+			pb_stat_add(&comp, t0);
+			dlen = PAGE_SIZE;
+			t0 = ktime_get();
+			err = pc->decompress(cbuf, clen, page, &dlen) ? -EINVAL : 0;
+			if (err)
+				break;
+			pb_stat_add(&decomp, t0);
+		}
+		kfree(wrkmem);
+		pb_emit("zram_comp", pc->name, &comp, err);
+		pb_emit("zram_decomp", pc->name, &decomp, err);
+	}
+out:
+	vfree(comp.ns);
+	vfree(decomp.ns);
+	kfree(cbuf);
+	free_page((unsigned long)page);
+}
+
+/* 4K reads at random 4K aligned offsets, straight to the block layer */
+static void pb_blk(void)
+{
+	struct block_device *bdev;
+	struct pb_stat rd = { NULL };
+	struct page *page;
+	struct bio *bio;
+	u64 blocks;
+	ktime_t t0;
+	int err = 0;
+	u32 i;
+
+	bdev = blkdev_get_by_path(blkdev, FMODE_READ, NULL);
+	if (IS_ERR(bdev)) {
+		pb_emit("blk_read_4k", "-", NULL, PTR_ERR(bdev));
+		return;
+	}
+	page = alloc_page(GFP_KERNEL);
+	blocks = min_t(u64, i_size_read(bdev->bd_inode) >> 12, U32_MAX);
+	if (!page || !blocks || pb_stat_init(&rd)) {
+		pb_emit("blk_read_4k", kbasename(blkdev), NULL, -ENOMEM);
+		goto out;
+	}
+
+	for (i = 0; i < rd.cap; i++) {
+		bio = bio_alloc(GFP_KERNEL, 1);
+		if (!bio) {
+			err = -ENOMEM;
+			break;
+		}
+		bio->bi_bdev = bdev;
+		bio->bi_iter.bi_sector = (sector_t)(prandom_u32() % (u32)blocks) << 3;
+		bio_add_page(bio, page, PAGE_SIZE, 0);
+		t0 = ktime_get();
+		err = submit_bio_wait(READ_SYNC, bio);
+		bio_put(bio);
+		if (err)
+			break;
+		pb_stat_add(&rd, t0);
+	}
+	pb_emit("blk_read_4k", kbasename(blkdev), &rd, err);
+out:
+	vfree(rd.ns);
+	if (page)
+		__free_page(page);
+	blkdev_put(bdev, FMODE_READ);
+}
+
+static const struct pb_bench pb_benches[] = {
+#ifdef CONFIG_MTK_ION
+	{ "ion", pb_ion },
+#endif
+#ifdef CONFIG_MTK_M4U
+	{ "m4u", pb_m4u },
+#endif
+#ifdef CONFIG_MTK_CMDQ
+	{ "cmdq", pb_cmdq },
+#endif
+#ifdef CONFIG_SW_SYNC
+	{ "fence", pb_fence },
+#endif
+	{ "zram", pb_zram },
+	{ "blk", pb_blk },
+};
+
+static ssize_t pb_write(struct file *file, const char __user *ubuf,
+			size_t count, loff_t *ppos)
+{
+	char name[16];
+	size_t len = min(count, sizeof(name) - 1);
+	bool all;
+	int i, nr = 0;
+
+	if (copy_from_user(name, ubuf, len))
+		return -EFAULT;
+	name[len] = '\0';
+	strim(name);
+	all = !strcmp(name, "all");
+
+	mutex_lock(&pb_lock);
+	pb_nr_rows = 0;
+	for (i = 0; i < ARRAY_SIZE(pb_benches); i++) {
+		if (!all && strcmp(name, pb_benches[i].name))
+			continue;
+		pb_benches[i].run();
+		nr++;
+	}
+	mutex_unlock(&pb_lock);
+	return nr ? count : -ENOENT;
+}
+
+static int pb_show(struct seq_file *m, void *v)
+{
+	struct pb_row *row;
+	int i;
+
+	seq_printf(m, "# mt_perfbench %d\n", PB_VERSION);
+	seq_puts(m, "bench\tparam\tn\tp50_ns\tp90_ns\tp99_ns\tmax_ns\terr\n");
+	mutex_lock(&pb_lock);
+	for (i = 0; i < pb_nr_rows; i++) {
+		row = &pb_rows[i];
+		seq_printf(m, "%s\t%s\t%u\t%u\t%u\t%u\t%u\t%d\n", row->bench, row->param,
+			   row->n, row->p50, row->p90, row->p99, row->max, row->err);
+	}
+	mutex_unlock(&pb_lock);
+	return 0;
+}
+
+static int pb_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pb_show, NULL);
+}
+
+static const struct file_operations pb_fops = {
+	.open = pb_open,
+	.read = seq_read,
+	.write = pb_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init pb_init(void)
+{
+	struct dentry *dir;
+
+	pb_rows = kcalloc(PB_MAX_ROWS, sizeof(*pb_rows), GFP_KERNEL);
+	if (!pb_rows)
+		return -ENOMEM;
+	dir = debugfs_create_dir("mt_perfbench", NULL);
+	if (!dir || !debugfs_create_file("run", S_IRUSR | S_IWUSR, dir, NULL, &pb_fops)) {
+		kfree(pb_rows);
+		pb_rows = NULL;
+		return -ENOMEM;
+	}
+	debugfs_create_u32("iters", S_IRUSR | S_IWUSR, dir, &iters);
+	return 0;
+}
+late_initcall(pb_init);
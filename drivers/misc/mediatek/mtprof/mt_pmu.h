@@ -0,0 +1,14 @@
+#include <linux/sched.h>
+
+/* slots of task_struct::mtk_pmu */
+enum mt_pmu_idx {
+	MT_PMU_CYCLES,
+	MT_PMU_INSTR,
+	MT_PMU_L2_REFILL,
+	MT_PMU_MEM_STALL,
+};
+
+#ifdef CONFIG_MTPROF_PMU
+/* mtk_pmu_membound at or above this keeps a task off big, 0: off */
+extern unsigned int mt_pmu_membound_thresh;
+#endif
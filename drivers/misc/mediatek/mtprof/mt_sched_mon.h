@@ -52,6 +52,8 @@ extern void mt_trace_sft_end(void *func);
 extern void mt_save_irq_counts(int action);
 extern void mt_trace_rqlock_start(raw_spinlock_t *lock);
 extern void mt_trace_rqlock_end(raw_spinlock_t *lock);
+extern unsigned int mt_irq_load(int cpu);
+extern bool mt_irq_overloaded(int cpu);
 #else
 static inline void mt_trace_ISR_start(int id) {};
 static inline void mt_trace_ISR_end(int id) {};
@@ -66,6 +68,8 @@ static inline void mt_trace_sft_end(void *func) {};
 static inline void mt_save_irq_counts(int action) {};
 static inline void mt_trace_rqlock_start(raw_spinlock_t *lock) {};
 static inline void mt_trace_rqlock_end(raw_spinlock_t *lock) {};
+static inline unsigned int mt_irq_load(int cpu) { return 0; };
+static inline bool mt_irq_overloaded(int cpu) { return false; };
 #endif
 
 extern spinlock_t mt_irq_count_lock;
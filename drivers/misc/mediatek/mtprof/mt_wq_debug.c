@@ -6,6 +6,10 @@
 #include <linux/workqueue.h>
 #include <linux/module.h>
 #include <linux/proc_fs.h>
+#include <linux/sched.h>
+#include <linux/hash.h>
+#include <linux/log2.h>
+#include <linux/vmalloc.h>
 
 struct pool_workqueue;
 #include <trace/events/workqueue.h>
@@ -18,6 +22,64 @@ struct pool_workqueue;
 
 static unsigned int wq_tracing;
 
+/*
+ * Work profiler: queue-to-execute latency and execution time per work
+ * function and worker pool, in per-cpu log2(usec) histograms, plus the
+ * worst single works. The pool is taken from the kworker name, the
+ * workqueue itself is not reachable from the tracepoints outside of
+ * kernel/workqueue.c.
+ */
+#define WQ_PROF_HIST_NR		20	/* 1us .. 512ms+ */
+#define WQ_PROF_FUNC_NR		128	/* per cpu */
+#define WQ_PROF_PEND_NR		1024
+#define WQ_PROF_RUN_NR		64
+#define WQ_PROF_TOP_NR		16
+#define WQ_PROF_POOL_LEN	16
+
+struct wq_prof_stat {
+	void *func;
+	char pool[WQ_PROF_POOL_LEN];
+	u32 count;
+	u32 lat_count;		/* works whose queueing was seen */
+	u64 lat_sum, lat_max;
+	u64 exec_sum, exec_max;
+	u32 lat_hist[WQ_PROF_HIST_NR];
+	u32 exec_hist[WQ_PROF_HIST_NR];
+};
+
+/* queued, not yet started */
+struct wq_prof_pend {
+	struct work_struct *work;
+	u64 ts;
+};
+
+/* being executed by a worker */
+struct wq_prof_run {
+	struct task_struct *task;
+	void *func;
+	u64 start;
+	u64 lat;
+	bool has_lat;
+};
+
+struct wq_prof_top {
+	void *func;
+	char pool[WQ_PROF_POOL_LEN];
+	u64 lat;
+	u64 exec;
+	u64 ts;
+};
+
+static bool wq_prof_enabled;
+static DEFINE_RAW_SPINLOCK(wq_prof_lock);
+static DEFINE_MUTEX(wq_prof_mutex);
+static struct wq_prof_stat *wq_prof_stats[NR_CPUS];
+static struct wq_prof_pend wq_prof_pend[WQ_PROF_PEND_NR];
+static struct wq_prof_run wq_prof_run[WQ_PROF_RUN_NR];
+static struct wq_prof_top wq_prof_top_lat[WQ_PROF_TOP_NR];
+static struct wq_prof_top wq_prof_top_exec[WQ_PROF_TOP_NR];
+static u32 wq_prof_lost;
+
 static void probe_execute_work(void *ignore, struct work_struct *work)
 {
 	pr_debug("execute start work=%p func=%pf\n",
@@ -44,6 +106,325 @@ probe_queue_work(void *ignore, unsigned int req_cpu, struct pool_workqueue *pwq,
 		 (void *)work, (void *)work->func, req_cpu);
 }
 
+static void prof_queue_work(void *ignore, unsigned int req_cpu, struct pool_workqueue *pwq,
+			    struct work_struct *work)
+{
+	struct wq_prof_pend *p = &wq_prof_pend[hash_ptr(work, ilog2(WQ_PROF_PEND_NR))];
+	unsigned long flags;
+
+	raw_spin_lock_irqsave(&wq_prof_lock, flags);
+	if (p->work && p->work != work)
+		wq_prof_lost++;
+	p->work = work;
+	p->ts = sched_clock();
+	raw_spin_unlock_irqrestore(&wq_prof_lock, flags);
+}
+
+static void prof_execute_start(void *ignore, struct work_struct *work)
+{
+	struct wq_prof_pend *p = &wq_prof_pend[hash_ptr(work, ilog2(WQ_PROF_PEND_NR))];
+	struct wq_prof_run *r = &wq_prof_run[hash_ptr(current, ilog2(WQ_PROF_RUN_NR))];
+	u64 now = sched_clock();
+	unsigned long flags;
+
+	raw_spin_lock_irqsave(&wq_prof_lock, flags);
+	if (r->task && r->task != current)
+		wq_prof_lost++;
+	r->task = current;
+	r->func = work->func;
+	r->start = now;
+	r->lat = 0;
+	r->has_lat = false;
+	if (p->work == work) {
+		r->lat = now - p->ts;
+		r->has_lat = true;
+		p->work = NULL;
+	}
+	raw_spin_unlock_irqrestore(&wq_prof_lock, flags);
+}
+
+static inline int wq_prof_bucket(u64 ns)
+{
+	u64 us = ns >> 10;
+
+	return us ? min(ilog2(us) + 1, WQ_PROF_HIST_NR - 1) : 0;
+}
+
+/* kworker/1:2H -> kworker/1H, kworker/u16:3 -> kworker/u16, rescuers keep their name */
+static void wq_prof_pool_name(char *pool)
+{
+	const char *comm = current->comm;
+	int len = strlen(comm);
+	char *colon;
+
+	strlcpy(pool, comm, WQ_PROF_POOL_LEN);
+	colon = strchr(pool, ':');
+	if (colon && strncmp(comm, "kworker/", 8) == 0) {
+		*colon = '\0';
+		if (comm[len - 1] == 'H')
+			strlcat(pool, "H", WQ_PROF_POOL_LEN);
+	}
+}
+
+static void wq_prof_top_add(struct wq_prof_top *top, u64 val, bool by_lat,
+			    const struct wq_prof_run *r, const char *pool, u64 exec)
+{
+	int i, min = 0;
+
+	for (i = 1; i < WQ_PROF_TOP_NR; i++) {
+		if ((by_lat ? top[i].lat : top[i].exec) < (by_lat ? top[min].lat : top[min].exec))
+			min = i;
+	}
+	if (val <= (by_lat ? top[min].lat : top[min].exec))
+		return;
+	top[min].func = r->func;
+	strlcpy(top[min].pool, pool, WQ_PROF_POOL_LEN);
+	top[min].lat = r->lat;
+	top[min].exec = exec;
+	top[min].ts = r->start;
+}
+
+static void prof_execute_end(void *ignore, struct work_struct *work)
+{
+	struct wq_prof_run *r = &wq_prof_run[hash_ptr(current, ilog2(WQ_PROF_RUN_NR))];
+	struct wq_prof_run run;
+	struct wq_prof_stat *stats, *st = NULL;
+	char pool[WQ_PROF_POOL_LEN];
+	unsigned long flags;
+	u64 exec;
+	int i, h;
+
+	raw_spin_lock_irqsave(&wq_prof_lock, flags);
+	if (r->task != current) {
+		raw_spin_unlock_irqrestore(&wq_prof_lock, flags);
+		return;
+	}
+	run = *r;
+	r->task = NULL;
+	raw_spin_unlock_irqrestore(&wq_prof_lock, flags);
+
+	exec = sched_clock() - run.start;
+	wq_prof_pool_name(pool);
+
+	/* a worker does not switch cpu while the tracepoint runs, the stats are this cpu's */
+	stats = wq_prof_stats[raw_smp_processor_id()];
+	if (!stats)
+		return;
+	h = hash_ptr(run.func, ilog2(WQ_PROF_FUNC_NR));
+	for (i = 0; i < WQ_PROF_FUNC_NR; i++) {
+		st = &stats[(h + i) & (WQ_PROF_FUNC_NR - 1)];
+		if (st->func == NULL) {
+			st->func = run.func;
+			strlcpy(st->pool, pool, WQ_PROF_POOL_LEN);
+			break;
+		}
+		if (st->func == run.func && !strcmp(st->pool, pool))
+			break;
+	}
+	if (i == WQ_PROF_FUNC_NR) {
+		wq_prof_lost++;
+		return;
+	}
+	st->count++;
+	st->exec_sum += exec;
+	st->exec_max = max(st->exec_max, exec);
+	st->exec_hist[wq_prof_bucket(exec)]++;
+	if (run.has_lat) {
+		st->lat_count++;
+		st->lat_sum += run.lat;
+		st->lat_max = max(st->lat_max, run.lat);
+		st->lat_hist[wq_prof_bucket(run.lat)]++;
+	}
+
+	raw_spin_lock_irqsave(&wq_prof_lock, flags);
+	wq_prof_top_add(wq_prof_top_lat, run.lat, true, &run, pool, exec);
+	wq_prof_top_add(wq_prof_top_exec, exec, false, &run, pool, exec);
+	raw_spin_unlock_irqrestore(&wq_prof_lock, flags);
+}
+
+static void wq_prof_switch(bool on)
+{
+	if (on == wq_prof_enabled)
+		return;
+	if (on) {
+		register_trace_workqueue_queue_work(prof_queue_work, NULL);
+		register_trace_workqueue_execute_start(prof_execute_start, NULL);
+		register_trace_workqueue_execute_end(prof_execute_end, NULL);
+	} else {
+		unregister_trace_workqueue_queue_work(prof_queue_work, NULL);
+		unregister_trace_workqueue_execute_start(prof_execute_start, NULL);
+		unregister_trace_workqueue_execute_end(prof_execute_end, NULL);
+		tracepoint_synchronize_unregister();
+	}
+	wq_prof_enabled = on;
+}
+
+static void wq_prof_reset(void)
+{
+	bool on = wq_prof_enabled;
+	int cpu;
+
+	wq_prof_switch(false);
+	for_each_possible_cpu(cpu) {
+		if (wq_prof_stats[cpu])
+			memset(wq_prof_stats[cpu], 0, WQ_PROF_FUNC_NR * sizeof(struct wq_prof_stat));
+	}
+	memset(wq_prof_pend, 0, sizeof(wq_prof_pend));
+	memset(wq_prof_run, 0, sizeof(wq_prof_run));
+	memset(wq_prof_top_lat, 0, sizeof(wq_prof_top_lat));
+	memset(wq_prof_top_exec, 0, sizeof(wq_prof_top_exec));
+	wq_prof_lost = 0;
+	wq_prof_switch(on);
+}
+
+static void wq_prof_merge(struct wq_prof_stat *dst, const struct wq_prof_stat *src)
+{
+	int i;
+
+	dst->count += src->count;
+	dst->lat_count += src->lat_count;
+	dst->lat_sum += src->lat_sum;
+	dst->exec_sum += src->exec_sum;
+	dst->lat_max = max(dst->lat_max, src->lat_max);
+	dst->exec_max = max(dst->exec_max, src->exec_max);
+	for (i = 0; i < WQ_PROF_HIST_NR; i++) {
+		dst->lat_hist[i] += src->lat_hist[i];
+		dst->exec_hist[i] += src->exec_hist[i];
+	}
+}
+
+static void wq_prof_show_stat(struct seq_file *m, const struct wq_prof_stat *st)
+{
+	int i;
+
+	SEQ_printf(m, " %8u %8llu %8llu %8llu %8llu\n", st->count,
+		   st->lat_count ? div_u64(st->lat_sum, st->lat_count) >> 10 : 0, st->lat_max >> 10,
+		   div_u64(st->exec_sum, st->count) >> 10, st->exec_max >> 10);
+	SEQ_printf(m, "    lat:");
+	for (i = 0; i < WQ_PROF_HIST_NR; i++)
+		SEQ_printf(m, " %u", st->lat_hist[i]);
+	SEQ_printf(m, "\n    exe:");
+	for (i = 0; i < WQ_PROF_HIST_NR; i++)
+		SEQ_printf(m, " %u", st->exec_hist[i]);
+	SEQ_printf(m, "\n");
+}
+
+static void wq_prof_show_top(struct seq_file *m, const char *title, const struct wq_prof_top *top)
+{
+	int i;
+
+	SEQ_printf(m, "%s (lat us, exec us, start):\n", title);
+	for (i = 0; i < WQ_PROF_TOP_NR; i++) {
+		if (top[i].func == NULL)
+			continue;
+		SEQ_printf(m, "  %8llu %8llu %10Ld.%06ld %-16s %pf\n",
+			   top[i].lat >> 10, top[i].exec >> 10,
+			   nsec_high(top[i].ts), nsec_low(top[i].ts), top[i].pool, top[i].func);
+	}
+}
+
+MT_DEBUG_ENTRY(wq_prof);
+static int mt_wq_prof_show(struct seq_file *m, void *v)
+{
+	struct wq_prof_stat *all, *pools;
+	int n = 0, npool = 0;
+	int cpu, i, j;
+
+	mutex_lock(&wq_prof_mutex);
+	SEQ_printf(m, "wq profiler %s, lost %u (echo 1/0/reset > wq_prof)\n",
+		   wq_prof_enabled ? "on" : "off", wq_prof_lost);
+
+	all = vzalloc(nr_cpu_ids * WQ_PROF_FUNC_NR * sizeof(*all));
+	pools = vzalloc(nr_cpu_ids * WQ_PROF_FUNC_NR * sizeof(*pools));
+	if (!all || !pools)
+		goto out;
+
+	/* fold the cpus together, by function+pool and by pool */
+	for_each_possible_cpu(cpu) {
+		const struct wq_prof_stat *stats = wq_prof_stats[cpu];
+
+		if (!stats)
+			continue;
+		for (i = 0; i < WQ_PROF_FUNC_NR; i++) {
+			struct wq_prof_stat st = stats[i];
+
+			if (st.func == NULL || st.count == 0)
+				continue;
+			for (j = 0; j < n; j++)
+				if (all[j].func == st.func && !strcmp(all[j].pool, st.pool))
+					break;
+			if (j == n) {
+				all[n].func = st.func;
+				strlcpy(all[n].pool, st.pool, WQ_PROF_POOL_LEN);
+				n++;
+			}
+			wq_prof_merge(&all[j], &st);
+
+			for (j = 0; j < npool; j++)
+				if (!strcmp(pools[j].pool, st.pool))
+					break;
+			if (j == npool) {
+				strlcpy(pools[npool].pool, st.pool, WQ_PROF_POOL_LEN);
+				npool++;
+			}
+			wq_prof_merge(&pools[j], &st);
+		}
+	}
+
+	SEQ_printf(m, "histograms: log2(us) buckets, <1us, 1us, 2us, 4us, ...\n");
+	SEQ_printf(m, "\n[pool] count lat_avg lat_max exec_avg exec_max (us)\n");
+	for (i = 0; i < npool; i++) {
+		SEQ_printf(m, "%-16s", pools[i].pool);
+		wq_prof_show_stat(m, &pools[i]);
+	}
+	SEQ_printf(m, "\n[func pool] count lat_avg lat_max exec_avg exec_max (us)\n");
+	for (i = 0; i < n; i++) {
+		SEQ_printf(m, "%pf %s", all[i].func, all[i].pool);
+		wq_prof_show_stat(m, &all[i]);
+	}
+	SEQ_printf(m, "\n");
+	wq_prof_show_top(m, "worst latency", wq_prof_top_lat);
+	wq_prof_show_top(m, "worst execution", wq_prof_top_exec);
+out:
+	vfree(all);
+	vfree(pools);
+	mutex_unlock(&wq_prof_mutex);
+	return 0;
+}
+
+static ssize_t
+mt_wq_prof_write(struct file *filp, const char *ubuf, size_t cnt, loff_t *data)
+{
+	char buf[16];
+	int cpu;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+	buf[cnt] = '\0';
+
+	mutex_lock(&wq_prof_mutex);
+	if (!strncmp(buf, "reset", 5)) {
+		wq_prof_reset();
+	} else if (buf[0] == '1') {
+		for_each_possible_cpu(cpu) {
+			if (wq_prof_stats[cpu])
+				continue;
+			wq_prof_stats[cpu] = vzalloc(WQ_PROF_FUNC_NR * sizeof(struct wq_prof_stat));
+			if (!wq_prof_stats[cpu]) {
+				mutex_unlock(&wq_prof_mutex);
+				return -ENOMEM;
+			}
+		}
+		wq_prof_switch(true);
+	} else if (buf[0] == '0') {
+		wq_prof_switch(false);
+	}
+	mutex_unlock(&wq_prof_mutex);
+	return cnt;
+}
+
 static void print_help(struct seq_file *m)
 {
 
@@ -141,6 +522,9 @@ static int __init init_wq_debug(void)
 	struct proc_dir_entry *pe;
 
 	pe = proc_create("mtprof/wq_enable_logs", 0664, NULL, &mt_wq_log_fops);
+	if (!pe)
+		return -ENOMEM;
+	pe = proc_create("mtprof/wq_prof", 0664, NULL, &mt_wq_prof_fops);
 	if (!pe)
 		return -ENOMEM;
 	return 0;
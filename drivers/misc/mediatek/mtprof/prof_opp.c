@@ -0,0 +1,201 @@
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/proc_fs.h>
+#include <linux/sched.h>
+#include <linux/cpufreq.h>
+#include <linux/topology.h>
+#include <linux/uaccess.h>
+#include "internal.h"
+#include "mt_cputime.h"
+
+#ifdef CONFIG_MTPROF_CPUTIME
+/*
+ * Per-task cputime at each (cluster, OPP) pair.
+ *
+ * The tick accounting adds its cputime to the slot of the OPP the cpu runs
+ * at, which a cpufreq transition notifier keeps per cpu, so the cost is one
+ * add per tick and nothing at context switch. OPP index is the position in
+ * the cluster's cpufreq table, the same index mt_cpufreq uses for its
+ * power/voltage tables.
+ *
+ * /proc/mtprof/cputime_opp is a binary snapshot: struct mt_opp_hdr, then
+ * nr_recs struct mt_opp_rec, one per live thread with any time recorded.
+ * Time of threads that already exited is not kept, sample before and after
+ * the window of interest.
+ */
+#define MT_OPP_MAGIC	0x504f544d	/* "MTOP" */
+#define MT_OPP_VERSION	1
+
+struct mt_opp_hdr {
+	u32 magic;
+	u16 version;
+	u16 rec_size;
+	u16 nr_clusters;
+	u16 nr_opps;
+	u32 nr_recs;
+	u32 freq_khz[MTK_OPP_CLUSTER_NR][MTK_OPP_NR];	/* 0: no such OPP */
+};
+
+struct mt_opp_rec {
+	u32 pid;
+	u32 tgid;
+	char comm[TASK_COMM_LEN];
+	u64 time_us[MTK_OPP_CLUSTER_NR][MTK_OPP_NR];
+};
+
+struct mt_opp_snapshot {
+	size_t size;
+	char data[0];
+};
+
+static DEFINE_PER_CPU(int, mt_opp_idx) = -1;
+
+void mt_cputime_opp_account(struct task_struct *p, cputime_t cputime)
+{
+	int cpu = task_cpu(p);
+	int cluster = topology_physical_package_id(cpu);
+	int idx = per_cpu(mt_opp_idx, cpu);
+
+	if (idx < 0 || cluster < 0 || cluster >= MTK_OPP_CLUSTER_NR)
+		return;
+	p->mtk_opp_time[cluster][idx] += (__force u32)cputime;
+}
+
+static int mt_opp_freq_to_idx(unsigned int cpu, unsigned int khz)
+{
+	struct cpufreq_frequency_table *tbl = cpufreq_frequency_get_table(cpu);
+	int i;
+
+	if (!tbl)
+		return -1;
+	for (i = 0; i < MTK_OPP_NR && tbl[i].frequency != CPUFREQ_TABLE_END; i++) {
+		if (tbl[i].frequency == khz)
+			return i;
+	}
+	return -1;
+}
+
+static int mt_opp_cpufreq_notifier(struct notifier_block *nb, unsigned long val, void *data)
+{
+	struct cpufreq_freqs *freqs = data;
+
+	if (val == CPUFREQ_POSTCHANGE)
+		per_cpu(mt_opp_idx, freqs->cpu) = mt_opp_freq_to_idx(freqs->cpu, freqs->new);
+	return NOTIFY_OK;
+}
+
+static struct notifier_block mt_opp_cpufreq_nb = {
+	.notifier_call = mt_opp_cpufreq_notifier,
+};
+
+static void mt_opp_fill_hdr(struct mt_opp_hdr *hdr, u32 nr_recs)
+{
+	struct cpufreq_frequency_table *tbl;
+	int cpu, cluster, i;
+
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->magic = MT_OPP_MAGIC;
+	hdr->version = MT_OPP_VERSION;
+	hdr->rec_size = sizeof(struct mt_opp_rec);
+	hdr->nr_clusters = MTK_OPP_CLUSTER_NR;
+	hdr->nr_opps = MTK_OPP_NR;
+	hdr->nr_recs = nr_recs;
+	for_each_possible_cpu(cpu) {
+		cluster = topology_physical_package_id(cpu);
+		if (cluster < 0 || cluster >= MTK_OPP_CLUSTER_NR || hdr->freq_khz[cluster][0])
+			continue;
+		tbl = cpufreq_frequency_get_table(cpu);
+		for (i = 0; tbl && i < MTK_OPP_NR && tbl[i].frequency != CPUFREQ_TABLE_END; i++) {
+			if (tbl[i].frequency != CPUFREQ_ENTRY_INVALID)
+				hdr->freq_khz[cluster][i] = tbl[i].frequency;
+		}
+	}
+}
+
+static bool mt_opp_task_has_time(struct task_struct *p)
+{
+	int c, i;
+
+	for (c = 0; c < MTK_OPP_CLUSTER_NR; c++)
+		for (i = 0; i < MTK_OPP_NR; i++)
+			if (p->mtk_opp_time[c][i])
+				return true;
+	return false;
+}
+
+static int mt_cputime_opp_open(struct inode *inode, struct file *file)
+{
+	struct mt_opp_snapshot *snap;
+	struct mt_opp_rec *rec;
+	struct task_struct *g, *p;
+	int nr = 0, max, c, i;
+
+	/* threads created between the count and the copy are left out */
+	max = nr_threads + 64;
+	snap = vzalloc(sizeof(*snap) + sizeof(struct mt_opp_hdr) + max * sizeof(struct mt_opp_rec));
+	if (!snap)
+		return -ENOMEM;
+	rec = (struct mt_opp_rec *)(snap->data + sizeof(struct mt_opp_hdr));
+
+	rcu_read_lock();
+	do_each_thread(g, p) {
+		if (nr >= max)
+			goto done;
+		if (!mt_opp_task_has_time(p))
+			continue;
+		rec->pid = p->pid;
+		rec->tgid = p->tgid;
+		get_task_comm(rec->comm, p);
+		for (c = 0; c < MTK_OPP_CLUSTER_NR; c++)
+			for (i = 0; i < MTK_OPP_NR; i++)
+				rec->time_us[c][i] = cputime_to_usecs(
+					(__force cputime_t)ACCESS_ONCE(p->mtk_opp_time[c][i]));
+		rec++;
+		nr++;
+	} while_each_thread(g, p);
+done:
+	rcu_read_unlock();
+
+	mt_opp_fill_hdr((struct mt_opp_hdr *)snap->data, nr);
+	snap->size = sizeof(struct mt_opp_hdr) + nr * sizeof(struct mt_opp_rec);
+	file->private_data = snap;
+	return 0;
+}
+
+static ssize_t mt_cputime_opp_read(struct file *file, char __user *ubuf, size_t cnt, loff_t *ppos)
+{
+	struct mt_opp_snapshot *snap = file->private_data;
+
+	return simple_read_from_buffer(ubuf, cnt, ppos, snap->data, snap->size);
+}
+
+static int mt_cputime_opp_release(struct inode *inode, struct file *file)
+{
+	vfree(file->private_data);
+	return 0;
+}
+
+static const struct file_operations mt_cputime_opp_fops = {
+	.open = mt_cputime_opp_open,
+	.read = mt_cputime_opp_read,
+	.llseek = default_llseek,
+	.release = mt_cputime_opp_release,
+};
+
+static int __init init_mt_cputime_opp(void)
+{
+	unsigned int cpu, khz;
+
+	cpufreq_register_notifier(&mt_opp_cpufreq_nb, CPUFREQ_TRANSITION_NOTIFIER);
+	/* OPPs set before the notifier was there */
+	for_each_online_cpu(cpu) {
+		khz = cpufreq_quick_get(cpu);
+		if (khz)
+			per_cpu(mt_opp_idx, cpu) = mt_opp_freq_to_idx(cpu, khz);
+	}
+	if (!proc_create("mtprof/cputime_opp", 0444, NULL, &mt_cputime_opp_fops))
+		return -ENOMEM;
+	return 0;
+}
+late_initcall(init_mt_cputime_opp);
+#endif
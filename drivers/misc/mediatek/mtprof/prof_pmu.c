@@ -0,0 +1,248 @@
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/perf_event.h>
+#include <linux/cpu.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/sched.h>
+#include <trace/events/sched.h>
+#include "internal.h"
+#include "mt_pmu.h"
+
+/*
+ * Per-task PMU counts.
+ *
+ * Each cpu has one pinned kernel counter per event, counting all the time.
+ * At context switch the counters are read and the deltas since the last
+ * switch go to the task switched out, so the cost is four counter reads per
+ * switch and no counter reprogramming. The events fit the Cortex-A53 PMU
+ * (cycle counter plus 6) without multiplexing, leaving counters for perf.
+ *
+ * The memory stall event defaults to A53 0xE7, cycles the pipeline waits on
+ * a load miss; A53 has no STALL_BACKEND. Set stall_event before enabling
+ * for another core.
+ */
+#define MT_PMU_MIN_CYCLES	100000	/* shorter slices do not move membound */
+
+static const char * const mt_pmu_name[MTK_PMU_NR] = {
+	"cycles", "instr", "l2_refill", "mem_stall",
+};
+
+static DEFINE_PER_CPU(struct perf_event *, mt_pmu_ev[MTK_PMU_NR]);
+static DEFINE_PER_CPU(u64, mt_pmu_last[MTK_PMU_NR]);
+static DEFINE_MUTEX(mt_pmu_lock);
+static bool mt_pmu_on;
+
+static bool enable = true;
+static unsigned int stall_event = 0xe7;
+unsigned int mt_pmu_membound_thresh;
+
+static void mt_pmu_attr(struct perf_event_attr *attr, int idx)
+{
+	memset(attr, 0, sizeof(*attr));
+	attr->size = sizeof(*attr);
+	attr->pinned = 1;
+	switch (idx) {
+	case MT_PMU_CYCLES:
+		attr->type = PERF_TYPE_HARDWARE;
+		attr->config = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case MT_PMU_INSTR:
+		attr->type = PERF_TYPE_HARDWARE;
+		attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case MT_PMU_L2_REFILL:
+		attr->type = PERF_TYPE_RAW;
+		attr->config = 0x17;	/* L2D_CACHE_REFILL */
+		break;
+	case MT_PMU_MEM_STALL:
+		attr->type = PERF_TYPE_RAW;
+		attr->config = stall_event;
+		break;
+	}
+}
+
+static u64 mt_pmu_read(struct perf_event *ev)
+{
+	if (!ev || ev->state != PERF_EVENT_STATE_ACTIVE)
+		return 0;
+	ev->pmu->read(ev);
+	return local64_read(&ev->count);
+}
+
+/* under the rq lock with irqs off */
+static void mt_pmu_switch(void *ignore, struct task_struct *prev, struct task_struct *next)
+{
+	u64 d[MTK_PMU_NR], v;
+	u32 ratio;
+	int i;
+
+	for (i = 0; i < MTK_PMU_NR; i++) {
+		v = mt_pmu_read(__this_cpu_read(mt_pmu_ev[i]));
+		d[i] = v - __this_cpu_read(mt_pmu_last[i]);
+		__this_cpu_write(mt_pmu_last[i], v);
+		prev->mtk_pmu[i] += d[i];
+	}
+
+	if (d[MT_PMU_CYCLES] < MT_PMU_MIN_CYCLES)
+		return;
+	ratio = min_t(u64, div64_u64(d[MT_PMU_MEM_STALL] << 10, d[MT_PMU_CYCLES]), 1024);
+	prev->mtk_pmu_membound = (prev->mtk_pmu_membound * 3 + ratio) >> 2;
+}
+
+static void mt_pmu_cpu_start(int cpu)
+{
+	struct perf_event_attr attr;
+	struct perf_event *ev;
+	int i;
+
+	for (i = 0; i < MTK_PMU_NR; i++) {
+		mt_pmu_attr(&attr, i);
+		ev = perf_event_create_kernel_counter(&attr, cpu, NULL, NULL, NULL);
+		if (IS_ERR(ev)) {
+			pr_warn("[mtprof] pmu: %s on cpu%d: %ld\n", mt_pmu_name[i], cpu, PTR_ERR(ev));
+			ev = NULL;
+		}
+		/* counts from creation to the first switch go to that task */
+		per_cpu(mt_pmu_last[i], cpu) = 0;
+		smp_wmb();
+		per_cpu(mt_pmu_ev[i], cpu) = ev;
+	}
+}
+
+static void mt_pmu_cpu_stop(int cpu)
+{
+	struct perf_event *ev[MTK_PMU_NR];
+	int i;
+
+	for (i = 0; i < MTK_PMU_NR; i++) {
+		ev[i] = per_cpu(mt_pmu_ev[i], cpu);
+		per_cpu(mt_pmu_ev[i], cpu) = NULL;
+	}
+	/* the probe runs with preemption off */
+	synchronize_sched();
+	for (i = 0; i < MTK_PMU_NR; i++) {
+		if (ev[i])
+			perf_event_release_kernel(ev[i]);
+	}
+}
+
+static int mt_pmu_cpu_notify(struct notifier_block *nb, unsigned long action, void *hcpu)
+{
+	int cpu = (long)hcpu;
+
+	mutex_lock(&mt_pmu_lock);
+	if (mt_pmu_on) {
+		switch (action & ~CPU_TASKS_FROZEN) {
+		case CPU_ONLINE:
+		case CPU_DOWN_FAILED:
+			mt_pmu_cpu_start(cpu);
+			break;
+		case CPU_DOWN_PREPARE:
+			mt_pmu_cpu_stop(cpu);
+			break;
+		}
+	}
+	mutex_unlock(&mt_pmu_lock);
+	return NOTIFY_OK;
+}
+
+static struct notifier_block mt_pmu_cpu_nb = {
+	.notifier_call = mt_pmu_cpu_notify,
+};
+
+static void mt_pmu_switch_on(bool on)
+{
+	int cpu;
+
+	get_online_cpus();
+	mutex_lock(&mt_pmu_lock);
+	if (on == mt_pmu_on)
+		goto out;
+	if (on) {
+		for_each_online_cpu(cpu)
+			mt_pmu_cpu_start(cpu);
+		if (register_trace_sched_switch(mt_pmu_switch, NULL)) {
+			pr_err("[mtprof] pmu: can not hook sched_switch\n");
+			for_each_online_cpu(cpu)
+				mt_pmu_cpu_stop(cpu);
+			goto out;
+		}
+	} else {
+		unregister_trace_sched_switch(mt_pmu_switch, NULL);
+		tracepoint_synchronize_unregister();
+		for_each_online_cpu(cpu)
+			mt_pmu_cpu_stop(cpu);
+	}
+	mt_pmu_on = on;
+out:
+	mutex_unlock(&mt_pmu_lock);
+	put_online_cpus();
+}
+
+static int mt_pmu_enable_set(const char *val, const struct kernel_param *kp)
+{
+	int ret = param_set_bool(val, kp);
+
+	if (!ret && system_state == SYSTEM_RUNNING)
+		mt_pmu_switch_on(enable);
+	return ret;
+}
+
+static const struct kernel_param_ops mt_pmu_enable_ops = {
+	.set = mt_pmu_enable_set,
+	.get = param_get_bool,
+};
+
+module_param_cb(enable, &mt_pmu_enable_ops, &enable, 0644);
+module_param(stall_event, uint, 0644);
+module_param_named(membound_thresh, mt_pmu_membound_thresh, uint, 0644);
+
+static int mt_pmu_show(struct seq_file *m, void *v)
+{
+	struct task_struct *g, *p;
+	u64 c[MTK_PMU_NR];
+	u32 ipc;
+	int i;
+
+	SEQ_printf(m, "%6s %6s %-16s %14s %14s %12s %14s %5s %8s\n",
+		   "pid", "tgid", "comm", "cycles", "instr", "l2_refill", "mem_stall",
+		   "ipc", "membound");
+	rcu_read_lock();
+	do_each_thread(g, p) {
+		for (i = 0; i < MTK_PMU_NR; i++)
+			c[i] = ACCESS_ONCE(p->mtk_pmu[i]);
+		if (!c[MT_PMU_CYCLES])
+			continue;
+		ipc = div64_u64(c[MT_PMU_INSTR] * 100, c[MT_PMU_CYCLES]);
+		SEQ_printf(m, "%6d %6d %-16s %14llu %14llu %12llu %14llu %2u.%02u %8u\n",
+			   p->pid, p->tgid, p->comm, c[MT_PMU_CYCLES], c[MT_PMU_INSTR],
+			   c[MT_PMU_L2_REFILL], c[MT_PMU_MEM_STALL], ipc / 100, ipc % 100,
+			   p->mtk_pmu_membound);
+	} while_each_thread(g, p);
+	rcu_read_unlock();
+	return 0;
+}
+
+static int mt_pmu_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mt_pmu_show, NULL);
+}
+
+static const struct file_operations mt_pmu_fops = {
+	.open = mt_pmu_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init init_mt_pmu(void)
+{
+	register_cpu_notifier(&mt_pmu_cpu_nb);
+	if (enable)
+		mt_pmu_switch_on(true);
+	if (!proc_create("mtprof/pmu", 0444, NULL, &mt_pmu_fops))
+		return -ENOMEM;
+	return 0;
+}
+late_initcall(init_mt_pmu);
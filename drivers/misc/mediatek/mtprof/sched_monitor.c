@@ -17,8 +17,11 @@
 
 #include <mt-plat/aee.h>
 #include <linux/stacktrace.h>
+#include <linux/workqueue.h>
+#include <linux/topology.h>
 #include "mt_sched_mon.h"
 #include "internal.h"
+#include "mt_evtlog.h"
 
 static unsigned int WARN_ISR_DUR;
 static unsigned int WARN_SOFTIRQ_DUR;
@@ -95,6 +98,7 @@ static void event_duration_check(struct sched_block_event *b)
 	unsigned long long t_dur;
 
 	t_dur = b->last_te - b->last_ts;
+	mt_evtlog(MT_EVT_ISR + b->type - evt_ISR, b->last_event, t_dur);
 	switch (b->type) {
 	case evt_ISR:
 		if (t_dur > WARN_ISR_DUR) {
@@ -207,6 +211,85 @@ static void reset_event_count(struct sched_block_event *b)
 	b->cur_count = 0;
 }
 
+/*
+ * Time spent per IRQ line and per softirq vector, and the interrupt load of
+ * each cpu: the share of recent irq_load_window_ns windows it spent in
+ * hardirq or softirq context, out of 1024, as an average that gives the
+ * last window a weight of 1/4. A cpu at or above irq_overload_thresh is
+ * overloaded: HMP placement keeps latency sensitive tasks off it and, with
+ * irq_balance set, its heaviest balanceable IRQ is moved to the least
+ * loaded cpu of its cluster once a second.
+ */
+struct mt_irq_time {
+	u64 time;		/* ns */
+	u32 count;
+	u32 max;		/* ns */
+	u32 recent;		/* ns since the last balance pass */
+};
+
+struct mt_irq_time_stat {
+	struct mt_irq_time irqs[MAX_NR_IRQS];
+	struct mt_irq_time softirqs[NR_SOFTIRQS];
+};
+
+struct mt_irq_load {
+	u64 window_start;
+	u64 busy;		/* ns in the current window */
+	u64 nested;		/* hardirq ns within the running softirq */
+	unsigned int avg;	/* out of 1024 */
+};
+
+static DEFINE_PER_CPU(struct mt_irq_time_stat, irq_time_mon);
+static DEFINE_PER_CPU(struct mt_irq_load, irq_load_mon);
+
+static unsigned int irq_load_window_ns = 8000000;
+static unsigned int irq_overload_thresh = 256;
+static bool irq_balance;
+
+static void mt_irq_time_add(struct mt_irq_time *t, u64 dur)
+{
+	t->time += dur;
+	t->count++;
+	t->recent += dur;
+	if (dur > t->max)
+		t->max = dur;
+}
+
+static void mt_irq_load_add(struct mt_irq_load *l, u64 now, u64 dur)
+{
+	u64 window = max(irq_load_window_ns, 1000000U);
+	u64 elapsed = now - l->window_start;
+	unsigned int ratio, n;
+
+	l->busy += dur;
+	if (elapsed < window)
+		return;
+
+	ratio = min_t(u64, div64_u64(l->busy << 10, elapsed), 1024);
+	/* windows that passed without an interrupt end count with the same ratio */
+	n = min_t(u64, div64_u64(elapsed, window), 4);
+	while (n--)
+		l->avg = (l->avg * 3 + ratio) >> 2;
+	l->window_start = now;
+	l->busy = 0;
+}
+
+unsigned int mt_irq_load(int cpu)
+{
+	struct mt_irq_load *l = &per_cpu(irq_load_mon, cpu);
+	u64 window = max(irq_load_window_ns, 1000000U);
+
+	/* no interrupt ended there for a while */
+	if (sched_clock() - ACCESS_ONCE(l->window_start) > 4 * window)
+		return 0;
+	return ACCESS_ONCE(l->avg);
+}
+
+bool mt_irq_overloaded(int cpu)
+{
+	return irq_overload_thresh && mt_irq_load(cpu) >= irq_overload_thresh;
+}
+
 /* ISR monitor */
 void mt_trace_ISR_start(int irq)
 {
@@ -224,6 +307,8 @@ void mt_trace_ISR_start(int irq)
 void mt_trace_ISR_end(int irq)
 {
 	struct sched_block_event *b;
+	struct mt_irq_load *l;
+	u64 dur;
 
 	b = &__raw_get_cpu_var(ISR_mon);
 
@@ -236,6 +321,14 @@ void mt_trace_ISR_end(int irq)
 	event_duration_check(b);
 	aee_rr_rec_last_irq_exit(smp_processor_id(), irq, b->last_te);
 
+	dur = b->last_te - b->last_ts;
+	if (irq >= 0 && irq < MAX_NR_IRQS)
+		mt_irq_time_add(&__raw_get_cpu_var(irq_time_mon).irqs[irq], dur);
+	l = &__raw_get_cpu_var(irq_load_mon);
+	if (__raw_get_cpu_var(SoftIRQ_mon).cur_ts)
+		l->nested += dur;
+	mt_irq_load_add(l, b->last_te, dur);
+
 	/* reset HRTimer function counter */
 	b = &__raw_get_cpu_var(hrt_mon);
 	reset_event_count(b);
@@ -258,6 +351,8 @@ void mt_trace_SoftIRQ_start(int sq_num)
 void mt_trace_SoftIRQ_end(int sq_num)
 {
 	struct sched_block_event *b;
+	struct mt_irq_load *l;
+	u64 dur;
 
 	b = &__raw_get_cpu_var(SoftIRQ_mon);
 
@@ -269,6 +364,15 @@ void mt_trace_SoftIRQ_end(int sq_num)
 	b->cur_ts = 0;
 	event_duration_check(b);
 
+	/* hardirqs that came in meanwhile are accounted already */
+	l = &__raw_get_cpu_var(irq_load_mon);
+	dur = b->last_te - b->last_ts;
+	dur -= min(dur, l->nested);
+	l->nested = 0;
+	if (sq_num >= 0 && sq_num < NR_SOFTIRQS)
+		mt_irq_time_add(&__raw_get_cpu_var(irq_time_mon).softirqs[sq_num], dur);
+	mt_irq_load_add(l, b->last_te, dur);
+
 	/* reset soft timer function counter */
 	b = &__raw_get_cpu_var(sft_mon);
 	reset_event_count(b);
@@ -685,6 +789,136 @@ void MT_trace_hardirqs_off(void)
 EXPORT_SYMBOL(MT_trace_hardirqs_off);
 
 
+#ifdef CONFIG_MT_SCHED_MONITOR
+static void mt_irq_balance_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(mt_irq_balance_work, mt_irq_balance_fn);
+
+static void mt_irq_balance_cpu(int cpu)
+{
+	struct mt_irq_time *t = per_cpu(irq_time_mon, cpu).irqs;
+	struct irq_desc *desc;
+	unsigned int load, min_load = mt_irq_load(cpu);
+	int irq, curr, heavy = 0, target = -1;
+	u32 heavy_ns = 0;
+
+	for (irq = 1; irq < nr_irqs && irq < MAX_NR_IRQS; irq++) {
+		if (t[irq].recent <= heavy_ns)
+			continue;
+		desc = irq_to_desc(irq);
+		if (!desc || !irqd_can_balance(&desc->irq_data) || !irq_can_set_affinity(irq))
+			continue;
+		heavy = irq;
+		heavy_ns = t[irq].recent;
+	}
+	if (!heavy)
+		return;
+
+	for_each_cpu_and(curr, topology_core_cpumask(cpu), cpu_online_mask) {
+		load = mt_irq_load(curr);
+		if (load < min_load) {
+			min_load = load;
+			target = curr;
+		}
+	}
+	if (target < 0 || min_load >= irq_overload_thresh)
+		return;
+
+	if (!irq_set_affinity(heavy, cpumask_of(target)))
+		pr_info("[mtprof] CPU#%d irq load %u, IRQ[%d:%s] moved to CPU#%d\n",
+			cpu, mt_irq_load(cpu), heavy, isr_name(heavy), target);
+}
+
+static void mt_irq_balance_fn(struct work_struct *work)
+{
+	int cpu, irq;
+
+	for_each_online_cpu(cpu) {
+		if (mt_irq_overloaded(cpu))
+			mt_irq_balance_cpu(cpu);
+	}
+	/* racy against the cpus adding to it, good enough for picking a line */
+	for_each_possible_cpu(cpu) {
+		for (irq = 0; irq < MAX_NR_IRQS; irq++)
+			per_cpu(irq_time_mon, cpu).irqs[irq].recent = 0;
+	}
+
+	if (irq_balance)
+		schedule_delayed_work(&mt_irq_balance_work, HZ);
+}
+
+static int mt_irq_balance_set(const char *val, const struct kernel_param *kp)
+{
+	int ret = param_set_bool(val, kp);
+
+	if (!ret && irq_balance)
+		schedule_delayed_work(&mt_irq_balance_work, HZ);
+	return ret;
+}
+
+static const struct kernel_param_ops mt_irq_balance_ops = {
+	.set = mt_irq_balance_set,
+	.get = param_get_bool,
+};
+
+module_param(irq_load_window_ns, uint, 0644);
+module_param(irq_overload_thresh, uint, 0644);
+module_param_cb(irq_balance, &mt_irq_balance_ops, &irq_balance, 0644);
+
+MT_DEBUG_ENTRY(irq_time);
+static void mt_irq_time_sum(struct mt_irq_time *sum, bool softirq, int nr)
+{
+	struct mt_irq_time *t;
+	int cpu;
+
+	memset(sum, 0, sizeof(*sum));
+	for_each_possible_cpu(cpu) {
+		t = softirq ? &per_cpu(irq_time_mon, cpu).softirqs[nr] :
+			&per_cpu(irq_time_mon, cpu).irqs[nr];
+		sum->time += t->time;
+		sum->count += t->count;
+		sum->max = max(sum->max, t->max);
+	}
+}
+
+static int mt_irq_time_show(struct seq_file *m, void *v)
+{
+	struct mt_irq_time sum;
+	int cpu, nr;
+
+	SEQ_printf(m, "=== irq load (out of 1024, overloaded at %u) ===\n", irq_overload_thresh);
+	for_each_online_cpu(cpu)
+		SEQ_printf(m, "CPU#%d: %4u%s\n", cpu, mt_irq_load(cpu),
+			   mt_irq_overloaded(cpu) ? " overloaded" : "");
+
+	SEQ_printf(m, "\n%4s %10s %16s %10s %s\n", "irq", "count", "time(ms)", "max(us)", "name");
+	for (nr = 0; nr < nr_irqs && nr < MAX_NR_IRQS; nr++) {
+		mt_irq_time_sum(&sum, false, nr);
+		if (!sum.count)
+			continue;
+		SEQ_printf(m, "%4d %10u %9lld.%06lu %10u %s\n", nr, sum.count,
+			   nsec_high(sum.time), nsec_low(sum.time), sum.max / 1000, isr_name(nr));
+	}
+
+	SEQ_printf(m, "\n%-8s %10s %16s %10s\n", "softirq", "count", "time(ms)", "max(us)");
+	for (nr = 0; nr < NR_SOFTIRQS; nr++) {
+		mt_irq_time_sum(&sum, true, nr);
+		SEQ_printf(m, "%-8s %10u %9lld.%06lu %10u\n", softirq_to_name[nr], sum.count,
+			   nsec_high(sum.time), nsec_low(sum.time), sum.max / 1000);
+	}
+	return 0;
+}
+
+/* any write clears the counters */
+static ssize_t mt_irq_time_write(struct file *filp, const char *ubuf, size_t cnt, loff_t *data)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		memset(&per_cpu(irq_time_mon, cpu), 0, sizeof(struct mt_irq_time_stat));
+	return cnt;
+}
+#endif
+
 /* --------------------------------------------------- */
 /*                     Define Proc entry               */
 /* --------------------------------------------------- */
@@ -870,6 +1104,9 @@ static int __init init_mtsched_mon(void)
 	pe = proc_create("mtmon/sched_mon_duration_PREEMPT", 0664, NULL, &mt_sched_monitor_PREEMPT_DUR_fops);
 	if (!pe)
 		return -ENOMEM;
+	pe = proc_create("mtmon/irq_time", 0664, NULL, &mt_irq_time_fops);
+	if (!pe)
+		return -ENOMEM;
 #endif
 	return 0;
 }
@@ -951,6 +951,24 @@ static int musb_gadget_queue(struct usb_ep *ep, struct usb_request *req, gfp_t g
 		goto cleanup;
 	}
 
+#ifdef USE_SSUSB_QMU
+	/* rx requests take one gpd, tx requests one per GPD_TX_CHUNK_SIZE */
+	request->gpd_left = 0;
+	if (!request->tx && request->request.length > GPD_BUF_SIZE) {
+		status = -EINVAL;
+	} else if (request->tx && (qmu_tx_gpd_used(musb_ep) +
+				   DIV_ROUND_UP(request->request.length, GPD_TX_CHUNK_SIZE)
+				   > MAX_GPD_NUM - 1)) {
+		status = -EBUSY;
+	}
+	if (status) {
+		qmu_printk(K_ERR, "%s %s len %d does not fit the gpd ring\n", __func__,
+			   ep->name, request->request.length);
+		unmap_dma_buffer(request, musb);
+		goto cleanup;
+	}
+#endif
+
 	/* add request to the list */
 	list_add_tail(&request->list, &musb_ep->req_list);
 
@@ -973,12 +991,8 @@ static int musb_gadget_queue(struct usb_ep *ep, struct usb_request *req, gfp_t g
 			if (request->request.length > 0) {
 				u32 txcsr;
 
-				_ex_mu3d_hal_insert_transfer_gpd(request->epnum, USB_TX,
-								 request->request.dma,
-								 request->request.length, true,
-								 true, false,
-								 ((request->request.zero ==
-								   1) ? 1 : 0), ep->maxpacket);
+				qmu_insert_tx_request(request, ep->maxpacket,
+						      ((request->request.zero == 1) ? 1 : 0));
 
 				/*Enable Tx_DMAREQEN */
 				txcsr = USB_ReadCsr32(U3D_TX1CSR0, request->epnum) | TX_DMAREQEN;
@@ -61,6 +61,7 @@ struct musb_request {
 	u8 tx;			/* endpoint direction */
 	u8 epnum;
 	enum buffer_map_state map_state;
+	u32 gpd_left;		/* qmu: tx gpds of this request not done yet */
 };
 
 static inline struct musb_request *to_musb_request(struct usb_request *req)
@@ -8,6 +8,42 @@
 #include "mu3d_hal_hw.h"
 #include "ssusb_qmu.h"
 
+/*
+ * Gpds still held by the tx requests queued on this endpoint. The ring has
+ * MAX_GPD_NUM entries and one of them is always the empty end marker.
+ */
+u32 qmu_tx_gpd_used(struct musb_ep *musb_ep)
+{
+	struct musb_request *req;
+	u32 used = 0;
+
+	list_for_each_entry(req, &musb_ep->req_list, list)
+		used += req->gpd_left;
+
+	return used;
+}
+
+/*
+ * Put a tx request on the gpd ring, GPD_TX_CHUNK_SIZE bytes per gpd. Only
+ * the last gpd interrupts and carries the zlp flag; qmu_done_tx() gives the
+ * request back when gpd_left drops to zero.
+ */
+void qmu_insert_tx_request(struct musb_request *req, u32 maxp, u8 zlp)
+{
+	dma_addr_t buf = req->request.dma;
+	u32 left = req->request.length;
+	u32 len;
+
+	req->gpd_left = DIV_ROUND_UP(left, GPD_TX_CHUNK_SIZE);
+	while (left) {
+		len = min_t(u32, left, GPD_TX_CHUNK_SIZE);
+		left -= len;
+		_ex_mu3d_hal_insert_transfer_gpd(req->epnum, USB_TX, buf, len, true,
+						 (left == 0), false, (left == 0) ? zlp : 0, maxp);
+		buf += len;
+	}
+}
+
 /* Sanity CR check in */
 /*
     1. Find the last gpd HW has executed and update Tx_gpd_last[]
@@ -82,6 +118,12 @@ void qmu_done_tx(struct musb *musb, u8 ep_num, unsigned long flags)
 		request = &req->request;
 
 		Tx_gpd_last[ep_num] = gpd;
+		/* a long request is only done with its last gpd */
+		if (req->gpd_left > 1) {
+			req->gpd_left--;
+			continue;
+		}
+		req->gpd_left = 0;
 		musb_g_giveback(musb_ep, request, 0);
 		req = next_request(musb_ep);
 		if (req != NULL)
@@ -382,6 +424,7 @@ void qmu_error_recovery(unsigned long data)
 					u32 txcsr;
 
 					if (is_len_err == true) {
+						request->gpd_left = 1;
 						_ex_mu3d_hal_insert_transfer_gpd(request->epnum,
 										 USB_TX,
 										 request->
@@ -393,18 +436,11 @@ void qmu_error_recovery(unsigned long data)
 										 musb_ep->
 										 end_point.maxpacket);
 					} else {
-						_ex_mu3d_hal_insert_transfer_gpd(request->epnum,
-										 USB_TX,
-										 request->
-										 request.dma,
-										 request->
-										 request.length,
-										 true, true, false,
-										 ((musb_ep->type ==
-										   USB_ENDPOINT_XFER_ISOC)
-										  ? 0 : 1),
-										 musb_ep->
-										 end_point.maxpacket);
+						qmu_insert_tx_request(request,
+								      musb_ep->end_point.maxpacket,
+								      ((musb_ep->type ==
+									USB_ENDPOINT_XFER_ISOC)
+								       ? 0 : 1));
 					}
 
 					/*Enable Tx_DMAREQEN */
@@ -8,10 +8,15 @@
 #undef EXTERN
 #define EXTERN
 
+struct musb_ep;
+struct musb_request;
+
 /* Sanity CR check in */
 void qmu_done_tasklet(unsigned long data);
 void qmu_error_recovery(unsigned long data);
 void qmu_exception_interrupt(struct musb *musb, DEV_UINT32 wQmuVal);
+u32 qmu_tx_gpd_used(struct musb_ep *musb_ep);
+void qmu_insert_tx_request(struct musb_request *req, u32 maxp, u8 zlp);
 
 #endif
 #endif
@@ -604,8 +604,11 @@ TGPD *_ex_mu3d_hal_prepare_tx_gpd(TGPD *gpd, dma_addr_t pBuf, DEV_UINT32 data_le
 	/*Default: bps=false */
 	TGPD_CLR_FORMAT_BPS(gpd);
 
-	/*Default: ioc=true */
-	TGPD_SET_FORMAT_IOC(gpd);
+	/*Default: ioc=true, cleared on all but the last gpd of a multi-gpd request */
+	if (ioc)
+		TGPD_SET_FORMAT_IOC(gpd);
+	else
+		TGPD_CLR_FORMAT_IOC(gpd);
 
 	/*Get the next GPD */
 	Tx_gpd_end[ep_num] = get_gpd(USB_TX, ep_num);
@@ -90,6 +90,8 @@ struct qmu_desc_map {
 #endif
 /* DVT- */
 #define GPD_BUF_SIZE 65532
+/* tx requests are cut into gpds of this size, a packet multiple at any maxp */
+#define GPD_TX_CHUNK_SIZE 32768
 #define BD_BUF_SIZE 32768	/* set to half of 64K of max size */
 
 #define IS_BDP 1
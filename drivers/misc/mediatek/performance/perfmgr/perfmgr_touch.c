@@ -13,6 +13,7 @@
 #include <linux/input.h>
 
 #include <linux/platform_device.h>
+#include <mt-plat/mtk_input_boost.h>
 #include "perfmgr.h"
 
 /*--------------------------------------------*/
@@ -228,6 +229,12 @@ static void dbs_input_event(struct input_handle *handle, unsigned int type,
 		tboost.touch_event = value;
 		spin_unlock_irqrestore(&tboost.touch_lock, flags);
 
+#if defined(CONFIG_MTK_DYNAMIC_BOOST) && !defined(CONFIG_TOUCH_BOOST)
+		/* CPU/GPU/vcore boost is owned by the dynamic_boost arbiter */
+		if (value)
+			input_boost_kick();
+#endif
+
 		atomic_inc(&tboost.event);
 		wake_up(&tboost.wq);
 	}
@@ -664,11 +664,8 @@ void mt_pmic_wrap_eint_clr(int offset)
 /* Parameter : */
 /* Return : */
 /* -------------------------------------------------------- */
-#ifdef PMIC_WRAP_KERNEL_DRIVER
-static s32 pwrap_wacs2_hal(u32 write, u32 adr, u32 wdata, u32 *rdata)
-#else
-s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata)
-#endif
+/* one WACS2 transaction, the caller holds wrp_lock */
+static s32 _pwrap_wacs2_cmd(u32 write, u32 adr, u32 wdata, u32 *rdata)
 {
 	/* u64 wrap_access_time=0x0; */
 	u32 reg_rdata = 0;
@@ -676,9 +673,6 @@ s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata)
 	u32 wacs_adr = 0;
 	u32 wacs_cmd = 0;
 	u32 return_value = 0;
-#ifdef PMIC_WRAP_KERNEL_DRIVER
-	unsigned long flags = 0;
-#endif
 
 	/* Check argument validation */
 	if ((write & ~(0x1)) != 0)
@@ -688,10 +682,6 @@ s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata)
 	if ((wdata & ~(0xffff)) != 0)
 		return E_PWR_INVALID_WDAT;
 
-#ifdef PMIC_WRAP_KERNEL_DRIVER
-	spin_lock_irqsave(&wrp_lock, flags);
-#endif
-
 	/* Check IDLE & INIT_DONE in advance */
 	return_value =
 	    wait_for_state_idle(wait_for_fsm_idle, TIMEOUT_WAIT_IDLE, PMIC_WRAP_WACS2_RDATA,
@@ -726,6 +716,22 @@ s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata)
 	}
 
 FAIL:
+	return return_value;
+}
+
+#ifdef PMIC_WRAP_KERNEL_DRIVER
+static s32 pwrap_wacs2_hal(u32 write, u32 adr, u32 wdata, u32 *rdata)
+#else
+s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata)
+#endif
+{
+	u32 return_value = 0;
+#ifdef PMIC_WRAP_KERNEL_DRIVER
+	unsigned long flags = 0;
+
+	spin_lock_irqsave(&wrp_lock, flags);
+#endif
+	return_value = _pwrap_wacs2_cmd(write, adr, wdata, rdata);
 #ifdef PMIC_WRAP_KERNEL_DRIVER
 	spin_unlock_irqrestore(&wrp_lock, flags);
 #endif
@@ -737,6 +743,57 @@ FAIL:
 	return return_value;
 }
 
+#ifdef PMIC_WRAP_KERNEL_DRIVER
+/*
+ * Ops of a batch are issued back to back with wrp_lock held, at most
+ * PWRAP_BATCH_BURST of them per hold so that a long batch still lets
+ * interrupts in between bursts.
+ */
+#define PWRAP_BATCH_BURST	8
+
+static s32 _pwrap_op(struct pwrap_op *op)
+{
+	u32 rdata = 0;
+	s32 ret;
+
+	if (op->write != PWRAP_UPDATE)
+		return _pwrap_wacs2_cmd(op->write, op->adr, op->wdata, op->rdata);
+
+	ret = _pwrap_wacs2_cmd(PWRAP_READ, op->adr, 0, &rdata);
+	if (ret)
+		return ret;
+	if (op->rdata)
+		*op->rdata = rdata;
+	rdata = (rdata & ~op->mask) | (op->wdata & op->mask);
+	return _pwrap_wacs2_cmd(PWRAP_WRITE, op->adr, rdata, NULL);
+}
+
+static s32 pwrap_batch_hal(struct pwrap_op *ops, int nr)
+{
+	unsigned long flags = 0;
+	s32 return_value = 0;
+	int i = 0, end;
+
+	while (i < nr) {
+		end = min(i + PWRAP_BATCH_BURST, nr);
+		spin_lock_irqsave(&wrp_lock, flags);
+		for (; i < end; i++) {
+			return_value = _pwrap_op(&ops[i]);
+			if (return_value != 0)
+				break;
+		}
+		spin_unlock_irqrestore(&wrp_lock, flags);
+		if (return_value != 0) {
+			PWRAPLOG("pwrap_batch op %d adr=0x%x fail,return_value=%d\n", i,
+				 ops[i].adr, return_value);
+			return return_value;
+		}
+	}
+
+	return 0;
+}
+#endif
+
 /* ****************************************************************************** */
 /* --internal API for pwrap_init------------------------------------------------- */
 /* ****************************************************************************** */
@@ -1890,6 +1947,9 @@ static int __init pwrap_hal_init(void)
 	mt_wrp->store_hal = mt_pwrap_store_hal;
 	mt_wrp->show_hal = mt_pwrap_show_hal;
 	mt_wrp->wacs2_hal = pwrap_wacs2_hal;
+#ifndef PMIC_WRAP_NO_PMIC
+	mt_wrp->batch_hal = pwrap_batch_hal;
+#endif
 
 	if (is_pwrap_init_done() == 0) {
 #ifdef PMIC_WRAP_NO_PMIC
@@ -17,6 +17,7 @@
 #include <linux/timer.h>
 #include <mt_pmic_wrap.h>
 #include <linux/syscore_ops.h>
+#include <mt-plat/mt_wq.h>
 
 #define PMIC_WRAP_DEVICE "pmic_wrap"
 #define VERSION     "Revision"
@@ -66,6 +67,59 @@ s32 pwrap_write(u32 adr, u32 wdata)
 	return pwrap_wacs2(PWRAP_WRITE, adr, wdata, 0);
 }
 EXPORT_SYMBOL(pwrap_write);
+
+/*
+ * Runs @nr accesses in order, stopping at the first that fails. The
+ * platform HAL issues them in bursts under a single hold of its lock;
+ * without one they go through wacs2_hal one by one.
+ */
+s32 pwrap_batch(struct pwrap_op *ops, int nr)
+{
+	u32 rdata;
+	s32 ret;
+	int i;
+
+	if (mt_wrp.batch_hal != NULL)
+		return mt_wrp.batch_hal(ops, nr);
+
+	for (i = 0; i < nr; i++) {
+		if (ops[i].write != PWRAP_UPDATE) {
+			ret = pwrap_wacs2(ops[i].write, ops[i].adr, ops[i].wdata, ops[i].rdata);
+		} else {
+			ret = pwrap_wacs2(PWRAP_READ, ops[i].adr, 0, &rdata);
+			if (ret == 0 && ops[i].rdata)
+				*ops[i].rdata = rdata;
+			if (ret == 0)
+				ret = pwrap_wacs2(PWRAP_WRITE, ops[i].adr,
+						  (rdata & ~ops[i].mask) | (ops[i].wdata & ops[i].mask),
+						  NULL);
+		}
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
+EXPORT_SYMBOL(pwrap_batch);
+
+static void pwrap_batch_work(struct work_struct *work)
+{
+	struct pwrap_batch_req *req = container_of(work, struct pwrap_batch_req, work);
+
+	req->ret = pwrap_batch(req->ops, req->nr);
+	req->done(req);
+}
+
+/*
+ * The wrapper only raises its interrupt on errors, not when a WACS2 access
+ * completes, so the asynchronous variant completes from a LITTLE cpu work
+ * item instead and leaves the submitter free to go on.
+ */
+void pwrap_batch_async(struct pwrap_batch_req *req)
+{
+	INIT_WORK(&req->work, pwrap_batch_work);
+	mt_queue_work(MT_WQ_LITTLE, &req->work);
+}
+EXPORT_SYMBOL(pwrap_batch_async);
 /********************************************************************/
 /********************************************************************/
 /* return value : EINT_STA: [0]: CPU IRQ status in PMIC1 */
@@ -8,6 +8,7 @@
 #include <mach/mt_battery_meter.h>
 #include <mach/mt_pmic.h>
 #include <mt-plat/battery_meter.h>
+#include <mt-plat/mt_pmic_wrap.h>
 
 
 
@@ -249,6 +250,17 @@ static unsigned int fg_get_data_ready_status(void)
 
 	return temp_val;
 }
+
+/* both halves of the latched FG_CAR in one pmic wrapper burst */
+static int fg_read_car(unsigned int *car_18_03, unsigned int *car_34_19)
+{
+	struct pwrap_op ops[] = {
+		{ .write = PWRAP_READ, .adr = MT6351_PMIC_FG_CAR_18_03_ADDR, .rdata = car_18_03 },
+		{ .write = PWRAP_READ, .adr = MT6351_PMIC_FG_CAR_34_19_ADDR, .rdata = car_34_19 },
+	};
+
+	return pwrap_batch(ops, ARRAY_SIZE(ops));
+}
 #endif
 
 static signed int fgauge_read_current(void *data);
@@ -563,6 +575,7 @@ signed int fgauge_set_columb_interrupt_internal(void *data, int reset)
 	unsigned int car = *(unsigned int *) (data);
 	unsigned int ret = 0;
 	signed int value32_CAR;
+	unsigned int car_18_03 = 0, car_34_19 = 0;
 
 	bm_print(BM_LOG_FULL, "fgauge_set_columb_interrupt_internal car=%d\n", car);
 
@@ -628,15 +641,15 @@ signed int fgauge_set_columb_interrupt_internal(void *data, int reset)
 //(3)    Read FG_CURRENT_OUT[28:14]
 //(4)    Read FG_CURRENT_OUT[31]
 */
-	value32_CAR = (pmic_get_register_value(MT6351_PMIC_FG_CAR_18_03));
-	value32_CAR |= ((pmic_get_register_value(MT6351_PMIC_FG_CAR_34_19)) & 0xffff) << 16;
+	fg_read_car(&car_18_03, &car_34_19);
+	value32_CAR = car_18_03;
+	value32_CAR |= (car_34_19 & 0xffff) << 16;
 
-	uvalue32_CAR_MSB = (pmic_get_register_value(MT6351_PMIC_FG_CAR_34_19) & 0x8000) >> 15;
+	uvalue32_CAR_MSB = (car_34_19 & 0x8000) >> 15;
 
 	bm_print(BM_LOG_CRTI,
 		"[fgauge_set_columb_interrupt] FG_CAR = 0x%x   uvalue32_CAR_MSB:0x%x 0x%x 0x%x\r\n",
-		uvalue32_CAR, uvalue32_CAR_MSB, (pmic_get_register_value(MT6351_PMIC_FG_CAR_18_03)),
-		(pmic_get_register_value(MT6351_PMIC_FG_CAR_34_19)));
+		uvalue32_CAR, uvalue32_CAR_MSB, car_18_03, car_34_19);
 
 
 	/*restore use_chip_trim_value() */
@@ -692,6 +705,7 @@ static signed int fgauge_read_columb_internal(void *data, int reset, int precise
 	unsigned int uvalue32_CAR = 0;
 	unsigned int uvalue32_CAR_MSB = 0;
 	signed int dvalue_CAR = 0;
+	unsigned int car_18_03 = 0, car_34_19 = 0;
 	int m = 0;
 	long long Temp_Value = 0;
 	unsigned int ret = 0;
@@ -725,10 +739,11 @@ static signed int fgauge_read_columb_internal(void *data, int reset, int precise
 //(4)    Read FG_CURRENT_OUT[31]
 */
 
-	uvalue32_CAR = (pmic_get_register_value(MT6351_PMIC_FG_CAR_18_03)) >> 11;
-	uvalue32_CAR |= ((pmic_get_register_value(MT6351_PMIC_FG_CAR_34_19)) & 0x0FFF) << 5;
+	fg_read_car(&car_18_03, &car_34_19);
+	uvalue32_CAR = car_18_03 >> 11;
+	uvalue32_CAR |= (car_34_19 & 0x0FFF) << 5;
 
-	uvalue32_CAR_MSB = (pmic_get_register_value(MT6351_PMIC_FG_CAR_34_19) & 0x8000) >> 15;
+	uvalue32_CAR_MSB = (car_34_19 & 0x8000) >> 15;
 
 	bm_print(BM_LOG_FULL, "[fgauge_read_columb_internal] FG_CAR = 0x%x\r\n",
 		 uvalue32_CAR);
@@ -415,32 +415,23 @@ unsigned int pmic_config_interface(unsigned int RegNum, unsigned int val, unsign
 	unsigned int return_value = 0;
 
 #if defined(CONFIG_PMIC_HW_ACCESS_EN)
-	unsigned int pmic_reg = 0;
-	unsigned int rdata;
+	struct pwrap_op op = {
+		.write = PWRAP_UPDATE,
+		.adr = RegNum,
+		.wdata = val << SHIFT,
+		.mask = MASK << SHIFT,
+	};
 
 	if ((pmic_suspend_state == true) && irqs_disabled())
 		return pmic_config_interface_nolock(RegNum, val, MASK, SHIFT);
 
 	mutex_lock(&pmic_access_mutex);
 
-	/*1. mt_read_byte(RegNum, &pmic_reg);*/
-	return_value = pwrap_wacs2(0, (RegNum), 0, &rdata);
-	pmic_reg = rdata;
-	if (return_value != 0) {
-		PMICLOG("[pmic_config_interface] Reg[%x]= pmic_wrap read data fail\n", RegNum);
-		mutex_unlock(&pmic_access_mutex);
-		return return_value;
-	}
-	/*PMICLOG"[pmic_config_interface] Reg[%x]=0x%x\n", RegNum, pmic_reg);*/
-
-	pmic_reg &= ~(MASK << SHIFT);
-	pmic_reg |= (val << SHIFT);
-
-	/*2. mt_write_byte(RegNum, pmic_reg);*/
+	/*1. read, modify and write RegNum in one wrapper lock hold*/
 	pmic_config_interface_buck_vsleep_check(RegNum, val, MASK, SHIFT);
-	return_value = pwrap_wacs2(1, (RegNum), pmic_reg, &rdata);
+	return_value = pwrap_batch(&op, 1);
 	if (return_value != 0) {
-		PMICLOG("[pmic_config_interface] Reg[%x]= pmic_wrap read data fail\n", RegNum);
+		PMICLOG("[pmic_config_interface] Reg[%x]= pmic_wrap update data fail\n", RegNum);
 		mutex_unlock(&pmic_access_mutex);
 		return return_value;
 	}
@@ -502,30 +493,20 @@ unsigned int pmic_config_interface_nolock(unsigned int RegNum, unsigned int val,
 	unsigned int return_value = 0;
 
 #if defined(CONFIG_PMIC_HW_ACCESS_EN)
-	unsigned int pmic_reg = 0;
-	unsigned int rdata;
+	struct pwrap_op op = {
+		.write = PWRAP_UPDATE,
+		.adr = RegNum,
+		.wdata = val << SHIFT,
+		.mask = MASK << SHIFT,
+	};
 
     /* pmic wrapper has spinlock protection. pmic do not to do it again */
 
-	/*1. mt_read_byte(RegNum, &pmic_reg); */
-	return_value = pwrap_wacs2(0, (RegNum), 0, &rdata);
-	pmic_reg = rdata;
-	if (return_value != 0) {
-		PMICLOG("[pmic_config_interface] Reg[%x]= pmic_wrap read data fail\n", RegNum);
-		mutex_unlock(&pmic_access_mutex);
-		return return_value;
-	}
-	/*PMICLOG"[pmic_config_interface] Reg[%x]=0x%x\n", RegNum, pmic_reg); */
-
-	pmic_reg &= ~(MASK << SHIFT);
-	pmic_reg |= (val << SHIFT);
-
-	/*2. mt_write_byte(RegNum, pmic_reg); */
+	/*1. read, modify and write RegNum in one wrapper lock hold */
 	pmic_config_interface_buck_vsleep_check(RegNum, val, MASK, SHIFT);
-	return_value = pwrap_wacs2(1, (RegNum), pmic_reg, &rdata);
+	return_value = pwrap_batch(&op, 1);
 	if (return_value != 0) {
-		PMICLOG("[pmic_config_interface] Reg[%x]= pmic_wrap read data fail\n", RegNum);
-		mutex_unlock(&pmic_access_mutex);
+		PMICLOG("[pmic_config_interface] Reg[%x]= pmic_wrap update data fail\n", RegNum);
 		return return_value;
 	}
 	/*PMICLOG"[pmic_config_interface] write Reg[%x]=0x%x\n", RegNum, pmic_reg); */
@@ -2,6 +2,7 @@
 #include <linux/proc_fs.h>
 #include <linux/topology.h>
 #include <linux/seq_file.h>
+#include <linux/sched/energy.h>
 
 #define MAX_LONG_SIZE 24
 
@@ -159,12 +160,44 @@ static ssize_t cpus_per_cluster_show(struct kobject *kobj,
 }
 static struct kobj_attribute cpus_per_cluster_attr = __ATTR_RO(cpus_per_cluster);
 
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+/*
+ * energy_model attribute
+ */
+static ssize_t energy_model_show(struct kobject *kobj,
+		struct kobj_attribute *attr, char *buf)
+{
+	const struct cluster_energy *ce;
+	int i, j, len = 0;
+
+	rcu_read_lock_sched();
+	for (i = 0; i < arch_get_nr_clusters(); i++) {
+		ce = sched_cluster_energy(i);
+		if (!ce)
+			continue;
+
+		len += snprintf(buf + len, PAGE_SIZE - len - 1, "cluster%d: idle %lu uW\n",
+				i, ce->idle_power);
+		for (j = 0; j < ce->nr_cap_states; j++)
+			len += snprintf(buf + len, PAGE_SIZE - len - 1, "  cap %4lu power %7lu uW\n",
+					ce->cap_states[j].cap, ce->cap_states[j].power);
+	}
+	rcu_read_unlock_sched();
+
+	return len;
+}
+static struct kobj_attribute energy_model_attr = __ATTR_RO(energy_model);
+#endif
+
 static struct attribute *cputopo_attrs[] = {
 	&nr_clusters_attr.attr,
 	&is_big_little_attr.attr,
 	&is_multi_cluster_attr.attr,
 	&glbinfo_attr.attr,
 	&cpus_per_cluster_attr.attr,
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+	&energy_model_attr.attr,
+#endif
 	NULL,
 };
 
@@ -0,0 +1,192 @@
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/cpumask.h>
+#include <linux/workqueue.h>
+#include <linux/percpu.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/topology.h>
+#include <trace/events/workqueue.h>
+
+#include <mt-plat/mt_wq.h>
+
+/*
+ * Workqueue classes of mt_wq.h: one unbound workqueue limited to the
+ * LITTLE cpus, and one high priority unbound workqueue per cluster.
+ * Until they are set up, or if they cannot be, work falls back to
+ * system_unbound_wq and to the per-cpu system_highpri_wq.
+ */
+#define MT_WQ_MAX_CLUSTERS	4
+
+static struct cpumask mt_little_mask;
+static struct workqueue_struct *mt_little_wq;
+static struct workqueue_struct *mt_cluster_wq[MT_WQ_MAX_CLUSTERS];
+static int mt_wq_nr_clusters;
+
+struct mt_wq_stats {
+	unsigned long queued[NR_MT_WQ_CLASSES];	/* queued from this cpu */
+	unsigned long exec;			/* works run on this cpu */
+	unsigned long exec_unbound;		/* of which by unbound workers */
+};
+
+static DEFINE_PER_CPU(struct mt_wq_stats, mt_wq_stats);
+static atomic_t mt_wq_nr_bound;
+
+static const char * const mt_wq_class_names[NR_MT_WQ_CLASSES] = {
+	[MT_WQ_LITTLE] = "little",
+	[MT_WQ_CLUSTER] = "cluster",
+};
+
+const struct cpumask *mt_little_cpumask(void)
+{
+	return &mt_little_mask;
+}
+EXPORT_SYMBOL(mt_little_cpumask);
+
+static struct workqueue_struct *mt_wq_pick(enum mt_wq_class cls)
+{
+	int cluster;
+
+	if (cls == MT_WQ_LITTLE)
+		return mt_little_wq ? mt_little_wq : system_unbound_wq;
+
+	cluster = arch_get_cluster_id(raw_smp_processor_id());
+	if (cluster >= 0 && cluster < mt_wq_nr_clusters && mt_cluster_wq[cluster])
+		return mt_cluster_wq[cluster];
+	return system_highpri_wq;
+}
+
+bool mt_queue_work(enum mt_wq_class cls, struct work_struct *work)
+{
+	if (!queue_work(mt_wq_pick(cls), work))
+		return false;
+	this_cpu_inc(mt_wq_stats.queued[cls]);
+	return true;
+}
+EXPORT_SYMBOL(mt_queue_work);
+
+bool mt_queue_delayed_work(enum mt_wq_class cls, struct delayed_work *dwork,
+			   unsigned long delay)
+{
+	if (!queue_delayed_work(mt_wq_pick(cls), dwork, delay))
+		return false;
+	this_cpu_inc(mt_wq_stats.queued[cls]);
+	return true;
+}
+EXPORT_SYMBOL(mt_queue_delayed_work);
+
+int mt_wq_bind_little(struct workqueue_struct *wq, bool highpri)
+{
+	struct workqueue_attrs *attrs;
+	int ret;
+
+	attrs = alloc_workqueue_attrs(GFP_KERNEL);
+	if (!attrs)
+		return -ENOMEM;
+	cpumask_copy(attrs->cpumask, &mt_little_mask);
+	if (highpri)
+		attrs->nice = MIN_NICE;
+	ret = apply_workqueue_attrs(wq, attrs);
+	free_workqueue_attrs(attrs);
+	if (!ret)
+		atomic_inc(&mt_wq_nr_bound);
+	return ret;
+}
+EXPORT_SYMBOL(mt_wq_bind_little);
+
+static void mt_wq_execute_start(void *ignore, struct work_struct *work)
+{
+	this_cpu_inc(mt_wq_stats.exec);
+	/* per-cpu workers are bound to one cpu, unbound ones may roam */
+	if (current->nr_cpus_allowed > 1)
+		this_cpu_inc(mt_wq_stats.exec_unbound);
+}
+
+static int mt_wq_show(struct seq_file *m, void *v)
+{
+	struct cpumask cpus;
+	struct mt_wq_stats sum;
+	struct mt_wq_stats *st;
+	char buf[32];
+	int cluster, cpu, i;
+
+	cpulist_scnprintf(buf, sizeof(buf), &mt_little_mask);
+	seq_printf(m, "little cpus: %s, bound workqueues: %d\n", buf,
+		   atomic_read(&mt_wq_nr_bound));
+	seq_printf(m, "%-8s %12s %12s %12s %12s\n", "cluster",
+		   "q_little", "q_cluster", "exec", "exec_unbound");
+
+	for (cluster = 0; cluster < arch_get_nr_clusters(); cluster++) {
+		memset(&sum, 0, sizeof(sum));
+		arch_get_cluster_cpus(&cpus, cluster);
+		for_each_cpu(cpu, &cpus) {
+			st = per_cpu_ptr(&mt_wq_stats, cpu);
+			for (i = 0; i < NR_MT_WQ_CLASSES; i++)
+				sum.queued[i] += st->queued[i];
+			sum.exec += st->exec;
+			sum.exec_unbound += st->exec_unbound;
+		}
+		seq_printf(m, "%-8d %12lu %12lu %12lu %12lu\n", cluster,
+			   sum.queued[MT_WQ_LITTLE], sum.queued[MT_WQ_CLUSTER],
+			   sum.exec, sum.exec_unbound);
+	}
+
+	return 0;
+}
+
+static int mt_wq_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mt_wq_show, NULL);
+}
+
+static const struct file_operations mt_wq_fops = {
+	.open = mt_wq_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init mt_wq_init(void)
+{
+	struct workqueue_attrs *attrs;
+	unsigned int cpu;
+	int i;
+
+	for_each_possible_cpu(cpu)
+		if (arch_cpu_is_little(cpu))
+			cpumask_set_cpu(cpu, &mt_little_mask);
+	if (cpumask_empty(&mt_little_mask))
+		cpumask_copy(&mt_little_mask, cpu_possible_mask);
+
+	attrs = alloc_workqueue_attrs(GFP_KERNEL);
+	if (!attrs)
+		return -ENOMEM;
+
+	mt_little_wq = alloc_workqueue("mt_little", WQ_UNBOUND | WQ_MEM_RECLAIM, 0);
+	if (mt_little_wq) {
+		cpumask_copy(attrs->cpumask, &mt_little_mask);
+		if (apply_workqueue_attrs(mt_little_wq, attrs))
+			pr_warn("mt_wq: cannot bind mt_little\n");
+	}
+
+	/* applied attrs replace the ones WQ_HIGHPRI set up */
+	attrs->nice = MIN_NICE;
+	mt_wq_nr_clusters = min(arch_get_nr_clusters(), MT_WQ_MAX_CLUSTERS);
+	for (i = 0; i < mt_wq_nr_clusters; i++) {
+		mt_cluster_wq[i] = alloc_workqueue("mt_cluster%d",
+						   WQ_UNBOUND | WQ_MEM_RECLAIM | WQ_HIGHPRI,
+						   0, i);
+		if (!mt_cluster_wq[i])
+			continue;
+		arch_get_cluster_cpus(attrs->cpumask, i);
+		if (apply_workqueue_attrs(mt_cluster_wq[i], attrs))
+			pr_warn("mt_wq: cannot bind mt_cluster%d\n", i);
+	}
+	free_workqueue_attrs(attrs);
+
+	register_trace_workqueue_execute_start(mt_wq_execute_start, NULL);
+	debugfs_create_file("mt_wq", 0444, NULL, NULL, &mt_wq_fops);
+	return 0;
+}
+core_initcall(mt_wq_init);
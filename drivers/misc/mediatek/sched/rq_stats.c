@@ -336,13 +336,17 @@ unsigned int sched_get_nr_heavy_task_by_threshold(int cluster_id, unsigned int t
 	arch_get_cluster_cpus(&cls_cpus, cluster_id);
 
 	for_each_cpu_mask(cpu, cls_cpus) {
+#ifndef CONFIG_MTK_SCHED_TASK_DEMAND
 		unsigned long cur_cap;
 		unsigned long max_cap;
 		int delta = SCHED_CAPACITY_SCALE*5/100;
+#endif
 		if (likely(!cpu_online(cpu)))
 			continue;
+#ifndef CONFIG_MTK_SCHED_TASK_DEMAND
 		cur_cap = topology_cur_cpu_capacity(cpu);
 		max_cap = topology_max_cpu_capacity(cpu);
+#endif
 		raw_spin_lock_irqsave(&cpu_rq(cpu)->lock, flags);
 		list_for_each_entry(p, &cpu_rq(cpu)->cfs_tasks, se.group_node) {
 			is_heavy = 0;
@@ -350,6 +354,17 @@ unsigned int sched_get_nr_heavy_task_by_threshold(int cluster_id, unsigned int t
 			if (task_low_priority(p->prio))
 				continue;
 #endif
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+			/*
+			 * windowed demand is already frequency invariant, a task
+			 * is heavy if it would keep this cpu busy at max freq
+			 */
+			if (p->ravg.demand * SCHED_CAPACITY_SCALE >=
+			    threshold * cpu_rq(cpu)->cpu_capacity_orig) {
+				count++;
+				__trace_out(1, cpu, p);
+			}
+#else
 			if (p->se.avg.loadwop_avg_contrib >= threshold) {
 				if ((cur_cap * SCHED_CAPACITY_SCALE) >= max_cap * (threshold-delta))
 					is_heavy = 1;
@@ -358,6 +373,7 @@ unsigned int sched_get_nr_heavy_task_by_threshold(int cluster_id, unsigned int t
 				count += is_heavy ? 1 : 0;
 				__trace_out(is_heavy, cpu, p);
 			}
+#endif
 		}
 		raw_spin_unlock_irqrestore(&cpu_rq(cpu)->lock, flags);
 	}
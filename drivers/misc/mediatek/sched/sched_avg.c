@@ -18,6 +18,7 @@
 #include <linux/hrtimer.h>
 #include <linux/sched.h>
 #include <linux/math64.h>
+#include <linux/irq_work.h>
 
 static DEFINE_PER_CPU(u64, nr_prod_sum);
 static DEFINE_PER_CPU(u64, last_time);
@@ -26,6 +27,76 @@ static DEFINE_PER_CPU(unsigned long, iowait_prod_sum);
 static DEFINE_PER_CPU(spinlock_t, nr_lock) = __SPIN_LOCK_UNLOCKED(nr_lock);
 static u64 last_get_time;
 
+/*
+ * Runqueue length events for the hotplug strategy.
+ *
+ * A runqueue crossing nr_event_rq_length is noticed under rq->lock where
+ * the consumer can not be woken directly, so events are latched in
+ * nr_event_pending and delivered from an irq_work. Length events are
+ * rate limited to one per NR_EVENT_MIN_INTERVAL_NS system wide.
+ */
+#define NR_EVENT_MIN_INTERVAL_NS	(4 * NSEC_PER_MSEC)
+
+static sched_nr_event_fn nr_event_fn;
+static unsigned int nr_event_rq_length = UINT_MAX;
+static unsigned long nr_event_pending;
+static u64 nr_event_last;
+
+static void sched_nr_event_work(struct irq_work *work)
+{
+	sched_nr_event_fn fn = ACCESS_ONCE(nr_event_fn);
+	unsigned long events = xchg(&nr_event_pending, 0);
+
+	if (fn && events)
+		fn(events);
+}
+
+static struct irq_work nr_event_work = {
+	.func = sched_nr_event_work,
+};
+
+/**
+ * sched_nr_event
+ * @event: SCHED_NR_EVENT_* bit to raise
+ * @return: N/A
+ *
+ * Latch @event and kick the registered callback. Safe under rq->lock.
+ */
+void sched_nr_event(int event)
+{
+	if (!ACCESS_ONCE(nr_event_fn))
+		return;
+
+	/* already latched, the irq_work is on its way */
+	if (test_and_set_bit(event, &nr_event_pending))
+		return;
+
+	irq_work_queue(&nr_event_work);
+}
+EXPORT_SYMBOL(sched_nr_event);
+
+/**
+ * sched_nr_event_register
+ * @fn: callback, NULL to unregister
+ * @rq_length: runqueue length that raises SCHED_NR_EVENT_RQ_LENGTH, 0 disables
+ * @return: 0 on success, -EBUSY if another callback is registered
+ *
+ * Calling it again with the same @fn only updates @rq_length.
+ */
+int sched_nr_event_register(sched_nr_event_fn fn, unsigned int rq_length)
+{
+	if (fn && nr_event_fn && nr_event_fn != fn)
+		return -EBUSY;
+
+	nr_event_rq_length = rq_length ? rq_length : UINT_MAX;
+	ACCESS_ONCE(nr_event_fn) = fn;
+	if (!fn)
+		irq_work_sync(&nr_event_work);
+
+	return 0;
+}
+EXPORT_SYMBOL(sched_nr_event_register);
+
 /**
  * sched_get_nr_running_avg
  * @return: Average nr_running and iowait value since last poll.
@@ -131,5 +202,12 @@ void sched_update_nr_prod(int cpu, unsigned long nr_running, int inc)
 	per_cpu(nr_prod_sum, cpu) += nr_running * diff;
 	per_cpu(iowait_prod_sum, cpu) += nr_iowait_cpu(cpu) * diff;
 	spin_unlock_irqrestore(&per_cpu(nr_lock, cpu), flags);
+
+	if (inc > 0 && nr_running < nr_event_rq_length &&
+	    nr_running + inc >= nr_event_rq_length &&
+	    curr_time - ACCESS_ONCE(nr_event_last) >= NR_EVENT_MIN_INTERVAL_NS) {
+		ACCESS_ONCE(nr_event_last) = curr_time;
+		sched_nr_event(SCHED_NR_EVENT_RQ_LENGTH);
+	}
 }
 EXPORT_SYMBOL(sched_update_nr_prod);
@@ -174,7 +174,12 @@ static int SCP_sensorHub_ReadChipInfo(char *buf, int bufsize)
 	return 0;
 }
 
-static int SCP_sensorHub_ReadSensorData(int handle, struct hwm_sensor_data *sensorData)
+/*
+ * Copy up to count events out of the DRAM FIFO the hub fills. The semaphore,
+ * cache maintenance and rp write back are done once for the whole run instead
+ * of once per event. Returns the number of events copied or a negative error.
+ */
+static int SCP_sensorHub_ReadSensorDataBulk(struct hwm_sensor_data *sensorData, int count)
 {
 	struct SCP_sensorHub_data *obj = obj_data;
 	char *pStart, *pEnd, *pNext;
@@ -183,11 +188,12 @@ static int SCP_sensorHub_ReadSensorData(int handle, struct hwm_sensor_data *sens
 	int offset;
 	int fifo_usage;
 	int err;
+	int n = 0;
 
 	if (SCP_TRC_FUN == atomic_read(&(obj_data->trace)))
 		SCP_FUN();
 
-	if (NULL == sensorData)
+	if (NULL == sensorData || count <= 0)
 		return -1;
 
 	err = SCP_sensorHub_get_scp_semaphore();
@@ -233,28 +239,38 @@ static int SCP_sensorHub_ReadSensorData(int handle, struct hwm_sensor_data *sens
 		return -6;
 	}
 
-	pNext = rp + offsetof(struct SCP_sensorData,
-				  data) + ((struct SCP_sensorData *)rp)->dataLength;
-	pNext = (char *)((((unsigned long)pNext + 3) >> 2) << 2);
+	while (rp != wp && n < count) {
+		pNext = rp + offsetof(struct SCP_sensorData,
+					  data) + ((struct SCP_sensorData *)rp)->dataLength;
+		pNext = (char *)((((unsigned long)pNext + 3) >> 2) << 2);
+
+		if (SCP_TRC_BATCH_DETAIL & atomic_read(&(obj_data->trace)))
+			SCP_LOG("dataLength = %d, pNext = %p, rp = %p, wp = %p\n",
+				((struct SCP_sensorData *)rp)->dataLength, pNext, rp, wp);
 
-	if (SCP_TRC_BATCH_DETAIL & atomic_read(&(obj_data->trace)))
-		SCP_LOG("dataLength = %d, pNext = %p, rp = %p, wp = %p\n",
-			((struct SCP_sensorData *)rp)->dataLength, pNext, rp, wp);
-
-	if (((struct SCP_sensorData *)rp)->dataLength != 6
-		   && ((struct SCP_sensorData *)rp)->dataLength != 8)
-		SCP_ERR("Wrong dataLength = %d\n",
-		((struct SCP_sensorData *)rp)->dataLength);
-
-	if (pNext < pEnd) {
-		memcpy((char *)&curData, rp, pNext - rp);
-		rp = pNext;
-	} else {
-		memcpy(&curData, rp, pEnd - rp);
-		offset = (int)(pEnd - rp);
-		memcpy((char *)&curData + offset, pStart, pNext - pEnd);
-		offset = (int)(pNext - pEnd);
-		rp = pStart + offset;
+		if (((struct SCP_sensorData *)rp)->dataLength != 6
+			   && ((struct SCP_sensorData *)rp)->dataLength != 8)
+			SCP_ERR("Wrong dataLength = %d\n",
+			((struct SCP_sensorData *)rp)->dataLength);
+
+		if (pNext < pEnd) {
+			memcpy((char *)&curData, rp, pNext - rp);
+			rp = pNext;
+		} else {
+			memcpy(&curData, rp, pEnd - rp);
+			offset = (int)(pEnd - rp);
+			memcpy((char *)&curData + offset, pStart, pNext - pEnd);
+			offset = (int)(pNext - pEnd);
+			rp = pStart + offset;
+		}
+
+		sensorData[n].sensor = curData.sensorType;
+		sensorData[n].value_divide = 1000;	/* need to check */
+		sensorData[n].status = SENSOR_STATUS_ACCURACY_MEDIUM;
+		sensorData[n].values[0] = curData.data[0];
+		sensorData[n].values[1] = curData.data[1];
+		sensorData[n].values[2] = curData.data[2];
+		n++;
 	}
 
 	obj->SCP_sensorFIFO->rp = (int)(rp - pStart);
@@ -263,13 +279,6 @@ static int SCP_sensorHub_ReadSensorData(int handle, struct hwm_sensor_data *sens
 	if (err < 0)
 			SCP_ERR("release_scp_semaphore fail : %d\n", err);
 
-	sensorData->sensor = curData.sensorType;
-	sensorData->value_divide = 1000;	/* need to check */
-	sensorData->status = SENSOR_STATUS_ACCURACY_MEDIUM;
-	sensorData->values[0] = curData.data[0];
-	sensorData->values[1] = curData.data[1];
-	sensorData->values[2] = curData.data[2];
-
 	if (rp <= wp)
 		fifo_usage = (int)(wp - rp);
 	else
@@ -278,11 +287,22 @@ static int SCP_sensorHub_ReadSensorData(int handle, struct hwm_sensor_data *sens
 	fifo_usage = (fifo_usage * 100) / obj->SCP_sensorFIFO->FIFOSize;
 
 	if (SCP_TRC_BATCH_DETAIL & atomic_read(&(obj_data->trace)))
-		SCP_LOG("rp = %p, wp = %p, fifo_usage = %d%%\n", rp, wp, fifo_usage);
+		SCP_LOG("rp = %p, wp = %p, fifo_usage = %d%%, read = %d\n", rp, wp, fifo_usage, n);
 
 	if (fifo_usage < 50)
 		atomic_set(&obj->disable_fifo_full_notify, 0);
 
+	return n;
+}
+
+static int SCP_sensorHub_ReadSensorData(int handle, struct hwm_sensor_data *sensorData)
+{
+	int err;
+
+	err = SCP_sensorHub_ReadSensorDataBulk(sensorData, 1);
+	if (err < 0)
+		return err;
+
 	return 0;
 }
 
@@ -734,6 +754,14 @@ static int SCP_sensorHub_get_data(int handle, struct hwm_sensor_data *sensorData
 	return SCP_sensorHub_ReadSensorData(handle, sensorData);
 }
 
+static int SCP_sensorHub_get_data_bulk(struct hwm_sensor_data *sensorData, int count)
+{
+	if (SCP_TRC_FUN == atomic_read(&(obj_data->trace)))
+		SCP_FUN();
+
+	return SCP_sensorHub_ReadSensorDataBulk(sensorData, count);
+}
+
 static int SCP_sensorHub_get_fifo_status(int *dataLen, int *status, char *reserved,
 					 struct batch_timestamp_info *p_batch_timestampe_info)
 {
@@ -1430,6 +1458,7 @@ static int SCP_sensorHub_probe(void)
 
 	data.get_data = SCP_sensorHub_get_data;
 	data.get_fifo_status = SCP_sensorHub_get_fifo_status;
+	data.get_data_bulk = SCP_sensorHub_get_data_bulk;
 	data.is_batch_supported = 1;
 	err = batch_register_data_path(ID_SENSOR_MAX_HANDLE, &data);
 	if (err) {
@@ -38,6 +38,7 @@ extern unsigned int DISP_GetScreenHeight(void);
 #define MMDVFS_EVENT_UI_IDLE_EXIT 3
 
 #define MMDVFS_CLIENT_ID_ISP 0
+#define MMDVFS_CLIENT_ID_DISP 1
 
 typedef int (*clk_switch_cb)(int ori_mmsys_clk_mode, int update_mmsys_clk_mode);
 
@@ -58,6 +59,7 @@ extern int is_mmdvfs_freq_mux_disabled(void);
 extern int is_force_max_mmsys_clk(void);
 extern int is_force_camera_hpm(void);
 extern int is_mmdvfs_disabled(void);
+extern int is_mmdvfs_bw_model_enabled(void);
 
 
 #ifdef MMDVFS_STANDALONE
@@ -86,7 +88,7 @@ extern int primary_display_switch_mode_for_mmdvfs(int sess_mode, unsigned int se
 
 enum {
 	MMDVFS_CAM_MON_SCEN = SMI_BWC_SCEN_CNT, MMDVFS_SCEN_MHL, MMDVFS_SCEN_MJC, MMDVFS_SCEN_DISP,
-	MMDVFS_SCEN_VP_HIGH_RESOLUTION , MMDVFS_SCEN_COUNT
+	MMDVFS_SCEN_VP_HIGH_RESOLUTION, MMDVFS_SCEN_BW_MODEL, MMDVFS_SCEN_COUNT
 };
 
 /* Backward compatible */
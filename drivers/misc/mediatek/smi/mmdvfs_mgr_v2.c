@@ -3,6 +3,10 @@
 #include <linux/jiffies.h>
 #include <linux/workqueue.h>
 #include <linux/mtk_gpu_utility.h>
+#include <linux/moduleparam.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/sched.h>
 
 #include <aee.h>
 #include <mt_smi.h>
@@ -113,6 +117,56 @@ static unsigned int g_mmdvfs_concurrency;
 static MTK_SMI_BWC_MM_INFO *g_mmdvfs_info;
 static MTK_MMDVFS_CMD g_mmdvfs_cmd;
 
+/*
+ * Bandwidth model
+ *
+ * Instead of the worst case step of each scenario table, estimate the DRAM
+ * bandwidth and the pixel rate of every active scenario from its actual
+ * resolution, fps and format, add them up and pick the lowest vcore step
+ * and mmsys clock that cover the combination. The result is applied as the
+ * MMDVFS_SCEN_BW_MODEL scenario.
+ */
+#define MMDVFS_BW_MODEL_SCEN_MASK ((1 << SMI_BWC_SCEN_VR) | (1 << SMI_BWC_SCEN_VR_SLOW) | \
+	(1 << SMI_BWC_SCEN_ICFP) | (1 << SMI_BWC_SCEN_VENC) | (1 << SMI_BWC_SCEN_WFD) | \
+	(1 << MMDVFS_SCEN_MHL))
+#define MMDVFS_BW_MODEL_CAM_MASK ((1 << SMI_BWC_SCEN_VR) | (1 << SMI_BWC_SCEN_VR_SLOW) | \
+	(1 << SMI_BWC_SCEN_ICFP))
+
+/* bytes per pixel x 100 */
+#define MMDVFS_BPP_RAW10	125
+#define MMDVFS_BPP_YUV420	150
+#define MMDVFS_BPP_RGBA	400
+
+#define MMDVFS_DEFAULT_FPS	30
+#define MMDVFS_DISP_FPS	60
+#define MMDVFS_BW_TRACE_NUM	32
+
+/* MM share of the LPM DRAM bandwidth before HPM is needed, in MB/s */
+static unsigned int mmdvfs_bw_hpm_mbps = 2400;
+/* pixel rate the medium (286MHz) mmsys clock sustains, in Mpixel/s */
+static unsigned int mmdvfs_bw_medium_mpps = 230;
+module_param(mmdvfs_bw_hpm_mbps, uint, S_IRUGO | S_IWUSR);
+module_param(mmdvfs_bw_medium_mpps, uint, S_IRUGO | S_IWUSR);
+
+typedef struct {
+	unsigned int mbps;	/* DRAM bandwidth */
+	unsigned int mpps;	/* pixel rate of the busiest engine */
+} mmdvfs_bw_req_struct;
+
+typedef struct {
+	unsigned long long ts;
+	unsigned int active;
+	mmdvfs_bw_req_struct req;
+	mmdvfs_voltage_enum step;
+	int mmsys_clk;
+} mmdvfs_bw_trace_struct;
+
+/* protected by scen_lock */
+static unsigned int g_mmdvfs_bw_active;
+static int g_mmdvfs_bw_clk = MMSYS_CLK_MEDIUM;
+static mmdvfs_bw_trace_struct g_mmdvfs_bw_trace[MMDVFS_BW_TRACE_NUM];
+static unsigned int g_mmdvfs_bw_trace_idx;
+
 /* mmdvfs timer for monitor gpu loading */
 typedef struct {
 	/* linux timer */
@@ -319,6 +373,10 @@ static mmdvfs_voltage_enum determine_current_mmsys_clk(void)
 			case SMI_BWC_SCEN_ICFP:
 				final_clk = MMSYS_CLK_HIGH;
 				break;
+			case MMDVFS_SCEN_BW_MODEL:
+				if (g_mmdvfs_bw_clk == MMSYS_CLK_HIGH)
+					final_clk = MMSYS_CLK_HIGH;
+				break;
 			default:
 				break;
 			}
@@ -328,6 +386,205 @@ static mmdvfs_voltage_enum determine_current_mmsys_clk(void)
 	return final_clk;
 }
 
+static int mmdvfs_is_bw_modeled(unsigned int scenario)
+{
+	return is_mmdvfs_bw_model_enabled() && scenario < 32 &&
+		(MMDVFS_BW_MODEL_SCEN_MASK & (1 << scenario));
+}
+
+/* pixels x fps x bpp / 100, in MB/s */
+static unsigned int mmdvfs_bw_mbps(unsigned int pixels, unsigned int fps, unsigned int bpp)
+{
+	return (unsigned int)div_u64((unsigned long long)pixels * fps * bpp, 100 * 1000000);
+}
+
+static unsigned int mmdvfs_bw_mpps(unsigned int pixels, unsigned int fps)
+{
+	return (unsigned int)div_u64((unsigned long long)pixels * fps, 1000000);
+}
+
+static void mmdvfs_bw_estimate(unsigned int active, MTK_MMDVFS_CMD *cmd,
+mmdvfs_bw_req_struct *req)
+{
+	unsigned int lcd_size = DISP_GetScreenWidth() * DISP_GetScreenHeight();
+	unsigned int venc_size = g_mmdvfs_info->video_record_size[0] *
+		g_mmdvfs_info->video_record_size[1];
+	unsigned int tv_size = g_mmdvfs_info->tv_out_size[0] * g_mmdvfs_info->tv_out_size[1];
+	unsigned int fps = g_mmdvfs_info->fps ? g_mmdvfs_info->fps : MMDVFS_DEFAULT_FPS;
+	unsigned int sensor_fps = cmd->sensor_fps ? cmd->sensor_fps : fps;
+
+	/* primary display scanning out one full screen layer */
+	req->mbps = mmdvfs_bw_mbps(lcd_size, MMDVFS_DISP_FPS, MMDVFS_BPP_RGBA);
+	req->mpps = mmdvfs_bw_mpps(lcd_size, MMDVFS_DISP_FPS);
+
+	if (active & MMDVFS_BW_MODEL_CAM_MASK) {
+		unsigned int isp_mpps = mmdvfs_bw_mpps(cmd->sensor_size, sensor_fps);
+
+		/* raw written by the sensor interface and read back by the ISP */
+		req->mbps += 2 * mmdvfs_bw_mbps(cmd->sensor_size, sensor_fps, MMDVFS_BPP_RAW10);
+		/* preview written by the ISP and read by the display */
+		req->mbps += 2 * mmdvfs_bw_mbps(lcd_size, sensor_fps, MMDVFS_BPP_YUV420);
+		/* extra full size passes */
+		if (cmd->camera_mode & (MMDVFS_CAMERA_MODE_FLAG_VFB | MMDVFS_CAMERA_MODE_FLAG_EIS_2_0))
+			req->mbps += 2 * mmdvfs_bw_mbps(cmd->sensor_size, sensor_fps, MMDVFS_BPP_YUV420);
+		/* two sensors or two exposures through the same ISP */
+		if (cmd->camera_mode & (MMDVFS_CAMERA_MODE_FLAG_PIP | MMDVFS_CAMERA_MODE_FLAG_STEREO |
+			MMDVFS_CAMERA_MODE_FLAG_IVHDR)) {
+			req->mbps += 2 * mmdvfs_bw_mbps(cmd->sensor_size, sensor_fps, MMDVFS_BPP_RAW10);
+			isp_mpps *= 2;
+		}
+		req->mpps = max(req->mpps, isp_mpps);
+	}
+
+	if (active & (1 << SMI_BWC_SCEN_VENC)) {
+		unsigned int venc_fps = (active & (1 << SMI_BWC_SCEN_VR_SLOW)) ? sensor_fps : fps;
+
+		/* source read, reference read and reconstruction write */
+		req->mbps += 3 * mmdvfs_bw_mbps(venc_size, venc_fps, MMDVFS_BPP_YUV420);
+		req->mpps = max(req->mpps, mmdvfs_bw_mpps(venc_size, venc_fps));
+	}
+
+	if (active & (1 << SMI_BWC_SCEN_WFD)) {
+		/* screen composed to yuv, then encoded */
+		req->mbps += mmdvfs_bw_mbps(lcd_size, MMDVFS_DEFAULT_FPS, MMDVFS_BPP_RGBA);
+		req->mbps += 4 * mmdvfs_bw_mbps(lcd_size, MMDVFS_DEFAULT_FPS, MMDVFS_BPP_YUV420);
+	}
+
+	if (active & (1 << MMDVFS_SCEN_MHL)) {
+		unsigned int size = tv_size ? tv_size : lcd_size;
+
+		req->mbps += 2 * mmdvfs_bw_mbps(size, MMDVFS_DISP_FPS, MMDVFS_BPP_RGBA);
+		req->mpps = max(req->mpps, mmdvfs_bw_mpps(size, MMDVFS_DISP_FPS));
+	}
+}
+
+static void mmdvfs_bw_decide(unsigned int active, mmdvfs_bw_req_struct *req,
+mmdvfs_voltage_enum *step, int *mmsys_clk)
+{
+	*step = MMDVFS_VOLTAGE_LOW;
+	*mmsys_clk = MMSYS_CLK_MEDIUM;
+
+	if (req->mpps > mmdvfs_bw_medium_mpps ||
+		((active & MMDVFS_BW_MODEL_CAM_MASK) && is_force_max_mmsys_clk()))
+		*mmsys_clk = MMSYS_CLK_HIGH;
+
+	/* the high mmsys clock is only allowed in HPM */
+	if (req->mbps > mmdvfs_bw_hpm_mbps || *mmsys_clk == MMSYS_CLK_HIGH)
+		*step = MMDVFS_VOLTAGE_HIGH;
+}
+
+/* fill the unset fields of cmd with the last values reported */
+static void mmdvfs_bw_merge_cmd(MTK_MMDVFS_CMD *merged, MTK_MMDVFS_CMD *cmd)
+{
+	*merged = g_mmdvfs_cmd;
+	if (cmd == NULL)
+		return;
+
+	if (cmd->sensor_size)
+		merged->sensor_size = cmd->sensor_size;
+	if (cmd->sensor_fps)
+		merged->sensor_fps = cmd->sensor_fps;
+	if (cmd->camera_mode != MMDVFS_CAMERA_MODE_FLAG_DEFAULT)
+		merged->camera_mode = cmd->camera_mode;
+}
+
+static mmdvfs_voltage_enum mmdvfs_bw_query(MTK_SMI_BWC_SCEN scenario, MTK_MMDVFS_CMD *cmd)
+{
+	MTK_MMDVFS_CMD merged;
+	mmdvfs_bw_req_struct req;
+	mmdvfs_voltage_enum step;
+	unsigned int active;
+	int mmsys_clk;
+
+	mmdvfs_bw_merge_cmd(&merged, cmd);
+
+	spin_lock(&g_mmdvfs_mgr->scen_lock);
+	active = g_mmdvfs_bw_active | (1 << scenario);
+	spin_unlock(&g_mmdvfs_mgr->scen_lock);
+
+	mmdvfs_bw_estimate(active, &merged, &req);
+	mmdvfs_bw_decide(active, &req, &step, &mmsys_clk);
+
+	return step;
+}
+
+static int mmdvfs_bw_model_update(void)
+{
+	mmdvfs_bw_req_struct req;
+	mmdvfs_bw_trace_struct *trace;
+	mmdvfs_voltage_enum step;
+	unsigned int active;
+	int mmsys_clk;
+
+	spin_lock(&g_mmdvfs_mgr->scen_lock);
+	active = g_mmdvfs_bw_active;
+	spin_unlock(&g_mmdvfs_mgr->scen_lock);
+
+	mmdvfs_bw_estimate(active, &g_mmdvfs_cmd, &req);
+	mmdvfs_bw_decide(active, &req, &step, &mmsys_clk);
+
+	spin_lock(&g_mmdvfs_mgr->scen_lock);
+	g_mmdvfs_bw_clk = mmsys_clk;
+	trace = &g_mmdvfs_bw_trace[g_mmdvfs_bw_trace_idx++ % MMDVFS_BW_TRACE_NUM];
+	trace->ts = sched_clock();
+	trace->active = active;
+	trace->req = req;
+	trace->step = step;
+	trace->mmsys_clk = mmsys_clk;
+	spin_unlock(&g_mmdvfs_mgr->scen_lock);
+
+	MMDVFSMSG("bw model active:0x%x,bw:%u MB/s,pixel:%u MP/s,step:%d,clk:%d\n",
+	active, req.mbps, req.mpps, step, mmsys_clk);
+
+	return mmdvfs_set_step_with_mmsys_clk(MMDVFS_SCEN_BW_MODEL, step, mmsys_clk);
+}
+
+static void mmdvfs_bw_model_set_active(unsigned int scenario, int active)
+{
+	spin_lock(&g_mmdvfs_mgr->scen_lock);
+	if (active)
+		g_mmdvfs_bw_active |= (1 << scenario);
+	else
+		g_mmdvfs_bw_active &= ~(1 << scenario);
+	spin_unlock(&g_mmdvfs_mgr->scen_lock);
+}
+
+static int mmdvfs_bw_trace_show(struct seq_file *m, void *v)
+{
+	mmdvfs_bw_trace_struct trace[MMDVFS_BW_TRACE_NUM];
+	unsigned int idx, i;
+
+	spin_lock(&g_mmdvfs_mgr->scen_lock);
+	memcpy(trace, g_mmdvfs_bw_trace, sizeof(trace));
+	idx = g_mmdvfs_bw_trace_idx;
+	spin_unlock(&g_mmdvfs_mgr->scen_lock);
+
+	seq_printf(m, "model:%d hpm_mbps:%u medium_mpps:%u\n", is_mmdvfs_bw_model_enabled(),
+	mmdvfs_bw_hpm_mbps, mmdvfs_bw_medium_mpps);
+	seq_puts(m, "time(ns) active bw(MB/s) pixel(MP/s) step clk\n");
+
+	for (i = (idx > MMDVFS_BW_TRACE_NUM) ? idx - MMDVFS_BW_TRACE_NUM : 0; i < idx; i++) {
+		mmdvfs_bw_trace_struct *t = &trace[i % MMDVFS_BW_TRACE_NUM];
+
+		seq_printf(m, "%llu 0x%x %u %u %d %d\n", t->ts, t->active, t->req.mbps,
+		t->req.mpps, t->step, t->mmsys_clk);
+	}
+
+	return 0;
+}
+
+static int mmdvfs_bw_trace_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mmdvfs_bw_trace_show, NULL);
+}
+
+static const struct file_operations mmdvfs_bw_trace_fops = {
+	.open = mmdvfs_bw_trace_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 
 static void mmdvfs_update_cmd(MTK_MMDVFS_CMD *cmd)
 {
@@ -783,6 +1040,8 @@ void mmdvfs_handle_cmd(MTK_MMDVFS_CMD *cmd)
 		if (!(g_mmdvfs_concurrency & (1 << cmd->scen))) {
 			MMDVFSMSG("invalid set scen %d\n", cmd->scen);
 			cmd->ret = -1;
+		} else if (mmdvfs_is_bw_modeled(cmd->scen)) {
+			cmd->ret = mmdvfs_bw_model_update();
 		} else {
 			cmd->ret = mmdvfs_set_step_with_mmsys_clk(cmd->scen,
 			mmdvfs_query(cmd->scen, cmd), mmsys_clk_query(cmd->scen, cmd));
@@ -791,7 +1050,12 @@ void mmdvfs_handle_cmd(MTK_MMDVFS_CMD *cmd)
 
 	case MTK_MMDVFS_CMD_TYPE_QUERY: { /* query with some parameters */
 		{
-			mmdvfs_voltage_enum query_voltage = mmdvfs_query(cmd->scen, cmd);
+			mmdvfs_voltage_enum query_voltage;
+
+			if (mmdvfs_is_bw_modeled(cmd->scen))
+				query_voltage = mmdvfs_bw_query(cmd->scen, cmd);
+			else
+				query_voltage = mmdvfs_query(cmd->scen, cmd);
 
 			mmdvfs_voltage_enum current_voltage =	mmdvfs_get_current_step();
 
@@ -833,6 +1097,12 @@ void mmdvfs_notify_scenario_exit(MTK_SMI_BWC_SCEN scen)
 	if ((scen == SMI_BWC_SCEN_VR) || (scen == SMI_BWC_SCEN_VR_SLOW) || (scen == SMI_BWC_SCEN_ICFP))
 		mmdvfs_start_cam_monitor(scen, 8);
 
+	if (mmdvfs_is_bw_modeled(scen)) {
+		mmdvfs_bw_model_set_active(scen, 0);
+		mmdvfs_bw_model_update();
+		return;
+	}
+
 	/* reset scenario voltage to default when it exits */
 	mmdvfs_set_step(scen, mmdvfs_get_default_step());
 }
@@ -866,6 +1136,14 @@ void mmdvfs_notify_scenario_enter(MTK_SMI_BWC_SCEN scen)
 	if ((scen == SMI_BWC_SCEN_VR) || (scen == SMI_BWC_SCEN_VR_SLOW) || (scen == SMI_BWC_SCEN_ICFP))
 		mmdvfs_start_cam_monitor(scen, 8);
 
+	if (mmdvfs_is_bw_modeled(scen)) {
+		if (scen == SMI_BWC_SCEN_WFD)
+			g_mmdvfs_mgr->is_wfd_enable = 1;
+		mmdvfs_bw_model_set_active(scen, 1);
+		mmdvfs_bw_model_update();
+		return;
+	}
+
 	switch (scen) {
 	case SMI_BWC_SCEN_VENC:
 		if (g_mmdvfs_concurrency & (1 << SMI_BWC_SCEN_VR))
@@ -921,6 +1199,8 @@ void mmdvfs_init(MTK_SMI_BWC_MM_INFO *info)
 
 	g_mmdvfs_info = info;
 
+	debugfs_create_file("mmdvfs_trace", S_IRUGO, NULL, NULL, &mmdvfs_bw_trace_fops);
+
 #ifdef MMDVFS_GPU_MONITOR_ENABLE
 	mmdvfs_init_gpu_monitor(&g_mmdvfs_mgr->gpu_monitor);
 #endif /* MMDVFS_GPU_MONITOR_ENABLE */
@@ -930,6 +1210,12 @@ void mmdvfs_mhl_enable(int enable)
 {
 	g_mmdvfs_mgr->is_mhl_enable = enable;
 
+	if (mmdvfs_is_bw_modeled(MMDVFS_SCEN_MHL)) {
+		mmdvfs_bw_model_set_active(MMDVFS_SCEN_MHL, enable);
+		mmdvfs_bw_model_update();
+		return;
+	}
+
 	if (enable)
 		mmdvfs_set_step(MMDVFS_SCEN_MHL, get_ext_disp_step(mmdvfs_get_lcd_resolution()));
 	else
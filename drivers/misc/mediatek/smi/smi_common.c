@@ -10,6 +10,9 @@
 #include <linux/mm.h>
 #include <linux/vmalloc.h>
 #include <linux/slab.h>
+#include <linux/delay.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include <aee.h>
 
 /* Define SMI_INTERNAL_CCF_SUPPORT when CCF needs to be enabled */
@@ -54,6 +57,10 @@
 #include "smi_debug.h"
 #include "smi_info_util.h"
 #include "smi_configuration.h"
+#include "smi_config_util.h"
+#ifdef CONFIG_MTK_CMDQ
+#include "cmdq_record.h"
+#endif
 #if defined(MMDVFS_HOOK)
 #include "mmdvfs_mgr.h"
 #endif
@@ -248,6 +255,8 @@ static unsigned short int *larb_port_backup[SMI_LARB_NR] = { larb0_port_backup,
 #endif
 
 static unsigned long gSMIBaseAddrs[SMI_REG_REGION_MAX];
+/* physical bases, for the profile writes done by GCE */
+static unsigned long gSMIBasePAs[SMI_REG_REGION_MAX];
 
 /* SMI COMMON register list to be backuped */
 #if defined(SMI_EV)
@@ -306,7 +315,16 @@ static unsigned int force_camera_hpm;
 static unsigned int bus_optimization;
 static unsigned int enable_bw_optimization;
 static unsigned int smi_profile = SMI_BWC_SCEN_NORMAL;
+/* profile each larb takes its settings from, see smi_bwc_config() */
+static int smi_larb_profile[SMI_LARB_NR];
+/* apply profile changes through CMDQ between two display frames */
+static unsigned int profile_cmdq = 1;
+/* monitor window per port for the larb bandwidth statistics */
+static unsigned int bw_sample_ms = 10;
+static DEFINE_MUTEX(smi_profile_mutex);
+static struct smi_reg_write smi_profile_regs[SMI_PROFILE_REG_MAX];
 static unsigned int disable_mmdvfs;
+static unsigned int enable_mmdvfs_bw_model = 1;
 
 
 static unsigned int *pLarbRegBackUp[SMI_LARB_NR];
@@ -1201,13 +1219,62 @@ void smi_bus_optimization_unprepare(int optimization_larbs)
 }
 
 
-void smi_bus_optimization(int optimization_larbs, int smi_profile)
+#ifdef CONFIG_MTK_CMDQ
+extern int primary_display_is_video_mode(void);
+extern int primary_display_is_sleepd(void);
+
+/*
+ * Write the profile from GCE once the current display frame is done, so a
+ * frame is never fetched half with the old and half with the new settings.
+ */
+static int smi_bus_regs_write_cmdq(struct smi_reg_write *regs, int num)
 {
+	cmdqRecHandle handle;
 	int i = 0;
+	int ret = 0;
+
+	if (!profile_cmdq || primary_display_is_sleepd() || !gSMIBasePAs[SMI_COMMON_REG_INDX])
+		return -1;
+
+	ret = cmdqRecCreate(CMDQ_SCENARIO_KERNEL_CONFIG_GENERAL, &handle);
+	if (ret)
+		return ret;
+
+	cmdqRecReset(handle);
+	if (primary_display_is_video_mode())
+		cmdqRecWaitNoClear(handle, CMDQ_EVENT_DISP_RDMA0_EOF);
+	else
+		cmdqRecWaitNoClear(handle, CMDQ_SYNC_TOKEN_STREAM_EOF);
+
+	for (i = 0; i < num; i++)
+		cmdqRecWrite(handle, gSMIBasePAs[regs[i].region] + regs[i].offset, regs[i].value, ~0);
+
+	ret = cmdqRecFlush(handle);
+	cmdqRecDestroy(handle);
+	return ret;
+}
+#else
+static int smi_bus_regs_write_cmdq(struct smi_reg_write *regs, int num)
+{
+	return -1;
+}
+#endif
+
+/*
+ * larb_profile gives the profile each larb takes its settings from, NULL for
+ * smi_profile on all larbs. Only a change of larb_profile is synced to the
+ * display frames, the settings at boot are written right away.
+ */
+void smi_bus_optimization(int optimization_larbs, int smi_profile, const int *larb_profile)
+{
+	struct SMI_SETTING *larb_settings[SMI_LARB_NR];
+	int i = 0;
+	int num = 0;
 
 	for (i = 0; i < SMI_LARB_NR; i++) {
 		int larb_mask = 1 << i;
 
+		larb_settings[i] = smi_profile_config[larb_profile ? larb_profile[i] : smi_profile].setting;
 		if (optimization_larbs & larb_mask) {
 			SMIDBG(1, "enable clock%d\n", i);
 			larb_clock_enable(i, 1);
@@ -1223,8 +1290,10 @@ void smi_bus_optimization(int optimization_larbs, int smi_profile)
 		if (smi_debug_level)
 			smi_dumpDebugMsg();
 
-		smi_bus_regs_setting(optimization_larbs, smi_profile,
-			smi_profile_config[smi_profile].setting);
+		num = smi_bus_regs_compose(optimization_larbs, smi_profile_config[smi_profile].setting,
+			larb_settings, smi_profile_regs, SMI_PROFILE_REG_MAX);
+		if (!larb_profile || smi_bus_regs_write_cmdq(smi_profile_regs, num))
+			smi_bus_regs_write(smi_profile_regs, num);
 
 		SMIDBG(1, "dump register after setting\n");
 		if (smi_debug_level)
@@ -1243,12 +1312,41 @@ void smi_bus_optimization(int optimization_larbs, int smi_profile)
 	}
 }
 
+/* larbs of the engines a scenario is tuned for */
+static unsigned int smi_scen_larbs(MTK_SMI_BWC_SCEN scen)
+{
+	switch (scen) {
+	case SMI_BWC_SCEN_MM_GPU:
+		return SMI_DBG_DISPSYS;
+	case SMI_BWC_SCEN_ICFP:
+	case SMI_BWC_SCEN_VSS:
+	case SMI_BWC_SCEN_VR_SLOW:
+	case SMI_BWC_SCEN_VR:
+		return SMI_DBG_IMGSYS | SMI_DBG_VENC;
+	case SMI_BWC_SCEN_VP:
+	case SMI_BWC_SCEN_SWDEC_VP:
+		return SMI_DBG_VDEC;
+	case SMI_BWC_SCEN_VENC:
+		return SMI_DBG_VENC;
+	default:
+		return 0;
+	}
+}
+
+/* concurrent scenarios, most demanding first */
+static const MTK_SMI_BWC_SCEN smi_scen_priority[] = {
+	SMI_BWC_SCEN_MM_GPU, SMI_BWC_SCEN_ICFP, SMI_BWC_SCEN_VSS, SMI_BWC_SCEN_VR_SLOW,
+	SMI_BWC_SCEN_VR, SMI_BWC_SCEN_VP, SMI_BWC_SCEN_SWDEC_VP, SMI_BWC_SCEN_VENC
+};
+
 static int smi_bwc_config(MTK_SMI_BWC_CONFIG *p_conf, unsigned int *pu4LocalCnt)
 {
 	int i;
+	int larb;
 	int result = 0;
 	unsigned int u4Concurrency = 0;
 	int bus_optimization_sync = bus_optimization;
+	int larb_profile[SMI_LARB_NR];
 	MTK_SMI_BWC_SCEN eFinalScen;
 	static MTK_SMI_BWC_SCEN ePreviousFinalScen = SMI_BWC_SCEN_CNT;
 
@@ -1328,40 +1426,56 @@ static int smi_bwc_config(MTK_SMI_BWC_CONFIG *p_conf, unsigned int *pu4LocalCnt)
 		mmdvfs_notify_scenario_concurrency(u4Concurrency);
 #endif
 
-	if ((1 << SMI_BWC_SCEN_MM_GPU) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_MM_GPU;
-	else if ((1 << SMI_BWC_SCEN_ICFP) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_ICFP;
-	else if ((1 << SMI_BWC_SCEN_VSS) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_VSS;
-	else if ((1 << SMI_BWC_SCEN_VR_SLOW) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_VR_SLOW;
-	else if ((1 << SMI_BWC_SCEN_VR) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_VR;
-	else if ((1 << SMI_BWC_SCEN_VP) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_VP;
-	else if ((1 << SMI_BWC_SCEN_SWDEC_VP) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_SWDEC_VP;
-	else if ((1 << SMI_BWC_SCEN_VENC) & u4Concurrency)
-		eFinalScen = SMI_BWC_SCEN_VENC;
-	else
-		eFinalScen = SMI_BWC_SCEN_NORMAL;
+	eFinalScen = SMI_BWC_SCEN_NORMAL;
+	for (i = 0; i < ARRAY_SIZE(smi_scen_priority); i++) {
+		if ((1 << smi_scen_priority[i]) & u4Concurrency) {
+			eFinalScen = smi_scen_priority[i];
+			break;
+		}
+	}
 
-	if (ePreviousFinalScen != eFinalScen) {
-		ePreviousFinalScen = eFinalScen;
-	} else {
+	/*
+	 * Each larb follows the most demanding active scenario tuned for its
+	 * engine, so concurrent use cases (recording during a video call) keep
+	 * the settings of every engine, not only those of the top scenario.
+	 */
+	for (larb = 0; larb < SMI_LARB_NR; larb++) {
+		larb_profile[larb] = eFinalScen;
+		for (i = 0; i < ARRAY_SIZE(smi_scen_priority); i++) {
+			if (((1 << smi_scen_priority[i]) & u4Concurrency) &&
+			    (smi_scen_larbs(smi_scen_priority[i]) & (1 << larb))) {
+				larb_profile[larb] = smi_scen_priority[i];
+				break;
+			}
+		}
+	}
+
+	if (ePreviousFinalScen == eFinalScen &&
+	    !memcmp(larb_profile, smi_larb_profile, sizeof(larb_profile))) {
 		SMIMSG("Scen equal%d,don't change\n", eFinalScen);
 		spin_unlock(&g_SMIInfo.SMI_lock);
 		smi_bus_optimization_unprepare(bus_optimization_sync);
 		return 0;
 	}
 
+	ePreviousFinalScen = eFinalScen;
 	smi_profile = eFinalScen;
-	smi_bus_optimization(bus_optimization_sync, eFinalScen);
-	SMIMSG("[SMI_PROFILE]: %d\n", eFinalScen);
-
+	memcpy(smi_larb_profile, larb_profile, sizeof(larb_profile));
+	spin_unlock(&g_SMIInfo.SMI_lock);
 
+	/*
+	 * Applying waits for the display frame, so it is done out of the
+	 * spinlock; concurrent callers are serialized and the latest profile wins.
+	 */
+	mutex_lock(&smi_profile_mutex);
+	spin_lock(&g_SMIInfo.SMI_lock);
+	eFinalScen = smi_profile;
+	memcpy(larb_profile, smi_larb_profile, sizeof(larb_profile));
 	spin_unlock(&g_SMIInfo.SMI_lock);
+	smi_bus_optimization(bus_optimization_sync, eFinalScen, larb_profile);
+	mutex_unlock(&smi_profile_mutex);
+	SMIMSG("[SMI_PROFILE]: %d\n", eFinalScen);
+
 	smi_bus_optimization_unprepare(bus_optimization_sync);
 	ovl_limit_uevent(smi_profile, g_smi_bwc_mm_info.hw_ovl_limit);
 
@@ -1435,7 +1549,7 @@ int smi_common_init(void)
 
 	/* apply init setting after kernel boot */
 	smi_bus_optimization_prepare(bus_optimization);
-	smi_bus_optimization(bus_optimization, SMI_BWC_SCEN_NORMAL);
+	smi_bus_optimization(bus_optimization, SMI_BWC_SCEN_NORMAL, NULL);
 	smi_bus_optimization_unprepare(bus_optimization);
 
 	/* After clock callback registration, it will restore incorrect value because backup is not called. */
@@ -1691,12 +1805,78 @@ void register_base_dump(void)
 	}
 }
 
+/*
+ * Per larb bandwidth: each port is watched by the larb monitor for
+ * bw_sample_ms in turn, the larb total is the sum of its ports.
+ */
+static int smi_bw_show(struct seq_file *m, void *v)
+{
+	static DEFINE_MUTEX(smi_bw_mutex);
+	int larb = 0;
+	int port = 0;
+
+	seq_printf(m, "profile %d, larb profiles:", smi_profile);
+	for (larb = 0; larb < SMI_LARB_NR; larb++)
+		seq_printf(m, " %d", smi_larb_profile[larb]);
+	seq_puts(m, "\n");
+
+	if (!enable_bw_optimization || !bw_sample_ms)
+		return 0;
+
+	mutex_lock(&smi_bw_mutex);
+	for (larb = 0; larb < SMI_LARB_NR; larb++) {
+		unsigned long base = gLarbBaseAddr[larb];
+		u64 total = 0;
+
+		if (!base || !(bus_optimization & (1 << larb)))
+			continue;
+
+		larb_clock_prepare(larb, 1);
+		larb_clock_enable(larb, 1);
+		for (port = 0; port < larb_port_num[larb]; port++) {
+			u64 kbps;
+
+			M4U_WriteReg32(base, SMI_LARB_MON_CLR, 1);
+			M4U_WriteReg32(base, SMI_LARB_MON_CLR, 0);
+			M4U_WriteReg32(base, SMI_LARB_MON_PORT, port);
+			M4U_WriteReg32(base, SMI_LARB_MON_EN, 1);
+			msleep(bw_sample_ms);
+			M4U_WriteReg32(base, SMI_LARB_MON_EN, 0);
+
+			kbps = div_u64((u64)M4U_ReadReg32(base, SMI_LARB_MON_BYTE_CNT) * 1000,
+				       bw_sample_ms * 1024);
+			if (kbps)
+				seq_printf(m, "larb%d port%d: %llu KB/s\n", larb, port, kbps);
+			total += kbps;
+		}
+		larb_clock_disable(larb, 1);
+		larb_clock_unprepare(larb, 1);
+
+		seq_printf(m, "larb%d: %llu KB/s\n", larb, total);
+	}
+	mutex_unlock(&smi_bw_mutex);
+	return 0;
+}
+
+static int smi_bw_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, smi_bw_show, NULL);
+}
+
+static const struct file_operations smi_bw_fops = {
+	.open = smi_bw_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static struct class *pSmiClass;
 
 static int smi_probe(struct platform_device *pdev)
 {
 
 	int i;
+	struct resource res;
 
 	static unsigned int smi_probe_cnt;
 	struct device *smiDevice = NULL;
@@ -1737,6 +1917,8 @@ static int smi_probe(struct platform_device *pdev)
 			}
 			/* Record the register base in global variable */
 			gSMIBaseAddrs[i] = (unsigned long)(smi_dev->regs[i]);
+			if (!of_address_to_resource(pdev->dev.of_node, i, &res))
+				gSMIBasePAs[i] = res.start;
 			SMIMSG("DT, i=%d, region=%s, map_addr=0x%p, reg_pa=0x%lx\n", i,
 			       smi_get_region_name(i), smi_dev->regs[i], get_register_base(i));
 
@@ -1868,6 +2050,7 @@ static int smi_probe(struct platform_device *pdev)
 	SMIDBG(1, "before smi_common_init, smi_prepare_count=%d, smi_enable_count=%d\n",
 	 smi_prepare_count, smi_enable_count);
 	smi_common_init();
+	debugfs_create_file("smi_bw", S_IRUGO, NULL, NULL, &smi_bw_fops);
 	SMIDBG(1, "after smi_common_init, smi_prepare_count=%d, smi_enable_count=%d\n",
 	 smi_prepare_count, smi_enable_count);
 
@@ -2229,6 +2412,11 @@ int is_mmdvfs_disabled(void)
 }
 
 
+int is_mmdvfs_bw_model_enabled(void)
+{
+	return enable_mmdvfs_bw_model;
+}
+
 int is_mmdvfs_freq_hopping_disabled(void)
 {
 	return disable_freq_hopping;
@@ -2280,6 +2468,7 @@ static void smi_driver_setting(void)
 }
 
 module_param_named(disable_mmdvfs, disable_mmdvfs, uint, S_IRUGO | S_IWUSR);
+module_param_named(enable_mmdvfs_bw_model, enable_mmdvfs_bw_model, uint, S_IRUGO | S_IWUSR);
 module_param_named(disable_freq_hopping, disable_freq_hopping, uint, S_IRUGO | S_IWUSR);
 module_param_named(disable_freq_mux, disable_freq_mux, uint, S_IRUGO | S_IWUSR);
 module_param_named(force_max_mmsys_clk, force_max_mmsys_clk, uint, S_IRUGO | S_IWUSR);
@@ -2289,6 +2478,8 @@ module_param_named(wifi_disp_transaction, wifi_disp_transaction, uint, S_IRUGO |
 module_param_named(bus_optimization, bus_optimization, uint, S_IRUGO | S_IWUSR);
 module_param_named(enable_ioctl, enable_ioctl, uint, S_IRUGO | S_IWUSR);
 module_param_named(enable_bw_optimization, enable_bw_optimization, uint, S_IRUGO | S_IWUSR);
+module_param_named(profile_cmdq, profile_cmdq, uint, S_IRUGO | S_IWUSR);
+module_param_named(bw_sample_ms, bw_sample_ms, uint, S_IRUGO | S_IWUSR);
 
 module_exit(smi_exit);
 
@@ -41,3 +41,88 @@ int smi_bus_regs_setting(int larb_id, int profile, struct SMI_SETTING *settings)
 	}
 	return 0;
 }
+
+static int smi_common_l1arb_larb(unsigned int offset)
+{
+	int i = 0;
+
+	for (i = 0 ; i < SMI_LARB_NR ; ++i) {
+		if (smi_common_l1arb_offset[i] == offset)
+			return i;
+	}
+	return -1;
+}
+
+static void smi_common_setting_find(struct SMI_SETTING *settings, unsigned int offset, int *value)
+{
+	int i = 0;
+
+	for (i = 0 ; i < settings->smi_common_reg_num ; ++i) {
+		if (settings->smi_common_setting_vals[i].offset == offset) {
+			*value = settings->smi_common_setting_vals[i].value;
+			return;
+		}
+	}
+}
+
+/*
+ * Compose the writes of a profile per larb: larb n and its L1ARB register in
+ * SMI common take the values of larb_settings[n] (settings when NULL or empty),
+ * the other SMI common registers those of settings. Returns the number of
+ * writes put in regs.
+ */
+int smi_bus_regs_compose(int larb_id, struct SMI_SETTING *settings,
+	struct SMI_SETTING **larb_settings, struct smi_reg_write *regs, int max)
+{
+	int i = 0;
+	int j = 0;
+	int num = 0;
+
+	if (!settings || !larb_id || settings->smi_common_reg_num == 0)
+		return 0;
+
+	for (i = 0 ; i < settings->smi_common_reg_num && num < max ; ++i) {
+		unsigned int offset = settings->smi_common_setting_vals[i].offset;
+		int value = settings->smi_common_setting_vals[i].value;
+		int larb = smi_common_l1arb_larb(offset);
+
+		if (larb >= 0 && larb_settings && larb_settings[larb] &&
+		    larb_settings[larb]->smi_common_reg_num)
+			smi_common_setting_find(larb_settings[larb], offset, &value);
+
+		regs[num].region = 0;
+		regs[num].offset = offset;
+		regs[num].value = value;
+		num++;
+	}
+
+	for (i = 0 ; i < SMI_LARB_NR ; ++i) {
+		struct SMI_SETTING *larb_setting = settings;
+
+		if (!(larb_id & (1 << i)))
+			continue;
+
+		if (larb_settings && larb_settings[i] && larb_settings[i]->smi_common_reg_num)
+			larb_setting = larb_settings[i];
+
+		for (j = 0 ; j < larb_setting->smi_larb_reg_num[i] && num < max ; ++j) {
+			regs[num].region = i + 1;
+			regs[num].offset = larb_setting->smi_larb_setting_vals[i][j].offset;
+			regs[num].value = larb_setting->smi_larb_setting_vals[i][j].value;
+			num++;
+		}
+	}
+	return num;
+}
+
+void smi_bus_regs_write(struct smi_reg_write *regs, int num)
+{
+	int i = 0;
+
+	for (i = 0 ; i < num ; ++i) {
+		if (regs[i].region)
+			M4U_WriteReg32(gLarbBaseAddr[regs[i].region - 1], regs[i].offset, regs[i].value);
+		else
+			M4U_WriteReg32(SMI_COMMON_EXT_BASE, regs[i].offset, regs[i].value);
+	}
+}
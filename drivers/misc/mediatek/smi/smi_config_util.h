@@ -3,5 +3,17 @@
 
 extern unsigned long gLarbBaseAddr[SMI_LARB_NR];
 
+/* one register write of a composed profile, region 0 is SMI common, larb n is n + 1 */
+struct smi_reg_write {
+	unsigned int region;
+	unsigned int offset;
+	unsigned int value;
+};
+
+#define SMI_PROFILE_REG_MAX 256
+
+extern int smi_bus_regs_compose(int larb_id, struct SMI_SETTING *settings,
+	struct SMI_SETTING **larb_settings, struct smi_reg_write *regs, int max);
+extern void smi_bus_regs_write(struct smi_reg_write *regs, int num);
 
 #endif
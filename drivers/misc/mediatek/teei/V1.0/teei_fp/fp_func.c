@@ -86,6 +86,10 @@ static int fp_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 		fp_cid = *((unsigned int *)(arg));
 		/*[4-7] is fuction id*/
 		fp_fid = *((unsigned int *)(arg + 4));
+		if (args_len > FP_SIZE - 16) {
+			up(&fp_api_lock);
+			return -EINVAL;
+		}
 #ifdef FP_DEBUG
 		printk("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
 		printk("invoke fp cmd CMD_FP_CMD: arg's address is %x, args's length %d\n", (unsigned int)arg, args_len);
@@ -104,10 +108,11 @@ static int fp_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 			return -EFAULT;
 		}
 
-		Flush_Dcache_By_Area((unsigned long)fp_buff_addr,
-				fp_buff_addr + FP_SIZE);
-		/*send command data to TEEI*/
-		send_fp_command(FP_DRIVER_ID);
+		/*
+		 * send command data to TEEI, only the header and args are
+		 * flushed, not the whole FP_SIZE buffer
+		 */
+		send_fp_command(args_len + 16);
 #ifdef FP_DEBUG
 		printk("back from TEEI try copy share mem to user \n");
 		printk("result in share memory %d  \n", *((unsigned int *)fp_buff_addr));
@@ -3355,7 +3355,9 @@ int __send_fp_command(unsigned long share_memory_size)
 	/* down(&boot_sema); */
 
 	set_fp_command(share_memory_size);
-	Flush_Dcache_By_Area((unsigned long)fp_buff_addr, fp_buff_addr + FP_BUFF_SIZE);
+	if (share_memory_size > FP_BUFF_SIZE)
+		share_memory_size = FP_BUFF_SIZE;
+	Flush_Dcache_By_Area((unsigned long)fp_buff_addr, fp_buff_addr + share_memory_size);
 	/* Flush_Dcache_By_Area((unsigned long)vfs_flush_address, vfs_flush_address + VFS_SIZE); */
 
 #if 0
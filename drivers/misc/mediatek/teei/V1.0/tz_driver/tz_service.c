@@ -1345,12 +1345,20 @@ static irqreturn_t nt_switch_irq_handler(void)
 				if (NULL == command)
 					return IRQ_NONE;
 
-				/* Get the semaphore */
-				cmd_sema = (struct semaphore *)(command->teei_sema);
-
-				/* Up the semaphore */
-				up(cmd_sema);
-				up(&smc_lock);
+				/*
+				 * One notification may carry several responses,
+				 * complete every command queued in the T->NT NQ
+				 * so none waits for the next switch IRQ.
+				 */
+				do {
+					/* Get the semaphore */
+					cmd_sema = (struct semaphore *)(command->teei_sema);
+
+					/* Up the semaphore */
+					up(cmd_sema);
+					up(&smc_lock);
+					command = get_response_smc_cmd();
+				} while (command != NULL);
 			}
 
 			return IRQ_HANDLED;
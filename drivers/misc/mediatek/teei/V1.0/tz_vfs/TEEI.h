@@ -61,4 +61,5 @@ union TEEI_vfs_response {
 };
 
 extern char *daulOS_VFS_share_mem;
+extern char *vfs_flush_address;
 extern char *daulOS_VFS_write_share_mem;
@@ -19,6 +19,15 @@
 #define MEM_CLEAR	0x1
 #define VFS_MAJOR	253
 
+/*
+ * Zero copy mode: the daemon mmap()s the VFS shared buffer, VFS_CMD_WAIT
+ * blocks until the TEE posts a command and returns its cmd_size, the daemon
+ * does its I/O in the mapping and VFS_CMD_DONE(length) hands the response
+ * back. read()/write() keep working for daemons that do not map.
+ */
+#define VFS_CMD_WAIT	_IO('V', 0x10)
+#define VFS_CMD_DONE	_IO('V', 0x11)
+
 static int vfs_major = VFS_MAJOR;
 static struct class *driver_class;
 static dev_t devno;
@@ -48,6 +57,9 @@ EXPORT_SYMBOL_GPL(VFS_wr_comp);
 
 struct vfs_dev *vfs_devp = NULL;
 
+/* the command sits in the boot-time buffer, not in the mapped one */
+static bool vfs_bounce;
+
 int tz_vfs_open(struct inode *inode, struct file *filp)
 {
 	filp->private_data = vfs_devp;
@@ -60,12 +72,65 @@ int tz_vfs_release(struct inode *inode, struct file *filp)
 	return 0;
 }
 
+static long tz_vfs_wait_cmd(void)
+{
+	struct TEEI_vfs_command *vfs_p = NULL;
+	int ret = 0;
+
+	ret = wait_for_completion_interruptible(&VFS_rd_comp);
+	if (ret == -ERESTARTSYS) {
+		complete(&global_down_lock);
+		return ret;
+	}
+
+	/*
+	 * Commands sent while soter boots use another buffer, copy those
+	 * into the mapped one; the rest are already in place.
+	 */
+	vfs_bounce = (daulOS_VFS_share_mem != vfs_flush_address);
+	if (vfs_bounce)
+		memcpy(vfs_flush_address, daulOS_VFS_share_mem, VFS_SIZE);
+
+	vfs_p = (struct TEEI_vfs_command *)vfs_flush_address;
+	return vfs_p->cmd_size;
+}
+
+static long tz_vfs_done_cmd(unsigned long length)
+{
+	if (length > VFS_SIZE)
+		return -EINVAL;
+
+	if (vfs_bounce)
+		memcpy(daulOS_VFS_share_mem, vfs_flush_address, length);
+	Flush_Dcache_By_Area((unsigned long)daulOS_VFS_share_mem,
+			(unsigned long)daulOS_VFS_share_mem + length);
+
+#ifdef VFS_RDWR_SEM
+	up(&VFS_wr_sem);
+#else
+	complete(&VFS_wr_comp);
+#endif
+	return 0;
+}
+
 static long tz_vfs_ioctl(struct file *filp,
 			unsigned int cmd, unsigned long arg)
 {
 	struct vfs_dev *dev = filp->private_data;
 
 	switch (cmd) {
+#ifndef VFS_RDWR_SEM
+	case VFS_CMD_WAIT:
+		if (!vfs_flush_address)
+			return -ENODEV;
+		return tz_vfs_wait_cmd();
+
+	case VFS_CMD_DONE:
+		if (!vfs_flush_address)
+			return -ENODEV;
+		return tz_vfs_done_cmd(arg);
+#endif
+
 	case MEM_CLEAR:
 		if (down_interruptible(&dev->sem))
 			return -ERESTARTSYS;
@@ -144,6 +209,21 @@ int cpu_id = raw_smp_processor_id();
 	return 0;
 }
 
+static int tz_vfs_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	unsigned long size = vma->vm_end - vma->vm_start;
+
+	if (!vfs_flush_address)
+		return -ENODEV;
+	if (vma->vm_pgoff != 0 || size > VFS_SIZE)
+		return -EINVAL;
+
+	/* same cacheable attributes as the kernel linear map */
+	return remap_pfn_range(vma, vma->vm_start,
+			virt_to_phys(vfs_flush_address) >> PAGE_SHIFT,
+			size, vma->vm_page_prot);
+}
+
 static loff_t tz_vfs_llseek(struct file *filp, loff_t offset, int orig)
 {
 	loff_t ret = 0;
@@ -192,6 +272,7 @@ static const struct file_operations vfs_fops = {
 	.llseek =		tz_vfs_llseek,
 	.read =			tz_vfs_read,
 	.write =		tz_vfs_write,
+	.mmap =			tz_vfs_mmap,
 	.unlocked_ioctl = tz_vfs_ioctl,
 #ifdef CONFIG_COMPAT
 	.compat_ioctl   = tz_vfs_ioctl,
@@ -17,6 +17,7 @@
 #include <tscpu_settings.h>
 #include <mt-plat/aee.h>
 #include <linux/uidgid.h>
+#include <linux/jiffies.h>
 
 #ifdef ATM_USES_PPM
 #include "mach/mt_ppm_api.h"
@@ -87,6 +88,7 @@ static int GPU_L_H_TRIP = 80, GPU_L_L_TRIP = 40;
    1: ATMv2 (FTL)
    2: CPU_GPU_Weight ATM v2
    3: Precise Power Budgeting + Hybrid Power Budgeting
+   4: PID power allocator with Tj slope prediction
 */
 static int tscpu_atm = 1;
 static int tt_ratio_high_rise = 1;
@@ -120,6 +122,20 @@ static int phpb_theta_max = 4;
 static int tj_stable_range = 1000;
 static int tj_jump_threshold = 4000;
 
+/*
+ * PID power allocator (tscpu_atm 4). Tj is extrapolated pid_horizon_ms ahead
+ * from its slope and the error against TARGET_TJ drives the total budget:
+ *   Pt = P_sustainable + Kp * err + Ki * sum(err) - Kd * dTj/dt
+ * Gains are mW per degreeC (Kd: mW per degreeC/s). The budget is then split
+ * between CPU and GPU in proportion to what each currently asks for.
+ */
+static int pid_k_po = 100;	/* Kp while predicted Tj is over target */
+static int pid_k_pu = 50;	/* Kp while predicted Tj is under target */
+static int pid_k_i = 10;
+static int pid_k_d = 20;
+static int pid_i_cutoff = 5000;	/* only integrate when |err| is within this, mC */
+static int pid_horizon_ms = 500;
+
 #if 0
 #define MAX_GPU_POWER_SMA_LEN	(32)
 static unsigned int gpu_power_sma_len = 1;
@@ -697,6 +713,116 @@ static int _adaptive_power_ppb(long prev_temp, long curr_temp, unsigned int gpu_
 
 	return 0;
 }
+
+/* split total_power between CPU and GPU by what each currently requests */
+static int pid_allocate(int total_power, unsigned int gpu_loading)
+{
+	static int cpu_power, gpu_power;
+	int last_cpu_power = cpu_power, last_gpu_power = gpu_power;
+	int cpu_req, gpu_req;
+
+	g_total_power = total_power;
+
+	if (total_power == 0) {
+		cpu_power = gpu_power = 0;
+		return P_adaptive(0, 0);
+	}
+
+#ifdef ATM_USES_PPM
+	/* PPM's power table already folds leakage at the current Tj in */
+	cpu_req = (int) mt_ppm_thermal_get_cur_power();
+#else
+	cpu_req = MAXIMUM_CPU_POWER;
+#endif
+	cpu_req = clamp(cpu_req, MINIMUM_CPU_POWER, MAXIMUM_CPU_POWER);
+
+	/* a busy GPU asks for more than it burns now, an idle one for less */
+	gpu_req = _get_current_gpu_power();
+	if (GPU_L_H_TRIP > 0)
+		gpu_req = gpu_req * (int) gpu_loading / GPU_L_H_TRIP;
+	gpu_req = clamp(gpu_req, MINIMUM_GPU_POWER, MAXIMUM_GPU_POWER);
+
+	gpu_power = total_power * gpu_req / (cpu_req + gpu_req);
+	gpu_power = clamp(gpu_power, MINIMUM_GPU_POWER, MAXIMUM_GPU_POWER);
+	cpu_power = clamp(total_power - gpu_power, MINIMUM_CPU_POWER, MAXIMUM_CPU_POWER);
+	/* hand back what CPU could not use */
+	gpu_power = clamp(total_power - cpu_power, MINIMUM_GPU_POWER, MAXIMUM_GPU_POWER);
+
+	if (cpu_power != last_cpu_power)
+		set_adaptive_cpu_power_limit(cpu_power);
+
+	/* +1: choose OPP with power "<=" limit */
+	if (gpu_power != last_gpu_power)
+		set_adaptive_gpu_power_limit(gpu_power + 1);
+
+	tscpu_dprintk("%s Pt %d req %d/%d cpu %d, gpu %d\n", __func__,
+		      total_power, cpu_req, gpu_req, cpu_power, gpu_power);
+
+	return 0;
+}
+
+static int _adaptive_power_pid(long prev_temp, long curr_temp, unsigned int gpu_loading)
+{
+	static int triggered, i_term, slope;
+	static unsigned long last_jiffies;
+	int dt_ms, raw_slope, predict_temp, err, p_term, d_term, total_power;
+
+	dt_ms = jiffies_to_msecs(jiffies - last_jiffies);
+	last_jiffies = jiffies;
+
+	if (cl_dev_adp_cpu_state_active != 1) {
+		if (triggered) {
+			triggered = 0;
+			tscpu_dprintk("%s Tp %ld, Tc %ld exit\n", __func__, prev_temp, curr_temp);
+			return pid_allocate(0, 0);
+		}
+#if THERMAL_HEADROOM
+		if (thp_max_cpu_power != 0)
+			set_adaptive_cpu_power_limit((unsigned int) MAX(thp_max_cpu_power, MINIMUM_CPU_POWER));
+		else
+			set_adaptive_cpu_power_limit(0);
+#endif
+		return 0;
+	}
+
+	/* Tj slope in mC/s, lightly filtered; stale after a long gap */
+	if (!triggered || dt_ms <= 0 || dt_ms > 1000) {
+		slope = 0;
+	} else {
+		raw_slope = (int) (curr_temp - prev_temp) * 1000 / dt_ms;
+		slope = (slope * 3 + raw_slope) / 4;
+	}
+
+	predict_temp = (int) curr_temp + slope * pid_horizon_ms / 1000;
+	err = TARGET_TJ - predict_temp;
+
+	if (!triggered) {
+		triggered = 1;
+		/* bumpless entry: start from what is drawn right now */
+		i_term = get_total_curr_power() - FIRST_STEP_TOTAL_POWER_BUDGET;
+	} else if (abs(err) < pid_i_cutoff) {
+		i_term += pid_k_i * err / 1000;
+	}
+
+	p_term = ((err < 0) ? pid_k_po : pid_k_pu) * err / 1000;
+	d_term = -pid_k_d * slope / 1000;
+
+	total_power = FIRST_STEP_TOTAL_POWER_BUDGET + p_term + i_term + d_term;
+
+	/* anti-windup: keep the integral inside what the output can reach */
+	if (total_power > MAXIMUM_TOTAL_POWER) {
+		i_term -= total_power - MAXIMUM_TOTAL_POWER;
+		total_power = MAXIMUM_TOTAL_POWER;
+	} else if (total_power < MINIMUM_TOTAL_POWER) {
+		i_term += MINIMUM_TOTAL_POWER - total_power;
+		total_power = MINIMUM_TOTAL_POWER;
+	}
+
+	tscpu_dprintk("%s Tc %ld, Tpred %d, TTJ %d, P %d I %d D %d, Pt %d\n", __func__,
+		      curr_temp, predict_temp, TARGET_TJ, p_term, i_term, d_term, total_power);
+
+	return pid_allocate(total_power, gpu_loading);
+}
 #endif
 
 static int _adaptive_power(long prev_temp, long curr_temp, unsigned int gpu_loading)
@@ -1296,6 +1422,8 @@ static ssize_t tscpu_write_atm(struct file *file, const char __user *buffer, siz
 #if PRECISE_HYBRID_POWER_BUDGET
 		if (tscpu_atm == 3)
 			_adaptive_power_calc = _adaptive_power_ppb;
+		else if (tscpu_atm == 4)
+			_adaptive_power_calc = _adaptive_power_pid;
 		else
 			_adaptive_power_calc = _adaptive_power;
 #endif
@@ -1560,6 +1688,50 @@ exit:
 	return ret;
 }
 
+static int tscpu_read_pid(struct seq_file *m, void *v)
+{
+	seq_printf(m, "Kp over %d\n", pid_k_po);
+	seq_printf(m, "Kp under %d\n", pid_k_pu);
+	seq_printf(m, "Ki %d\n", pid_k_i);
+	seq_printf(m, "Kd %d\n", pid_k_d);
+	seq_printf(m, "I cutoff %d\n", pid_i_cutoff);
+	seq_printf(m, "horizon ms %d\n", pid_horizon_ms);
+
+	return 0;
+}
+
+static ssize_t tscpu_write_pid(struct file *file, const char __user *buffer, size_t count,
+			       loff_t *data)
+{
+	char desc[128];
+	int len = 0;
+	int k_po, k_pu, k_i, k_d, i_cutoff, horizon;
+
+	len = (count < (sizeof(desc) - 1)) ? count : (sizeof(desc) - 1);
+	if (copy_from_user(desc, buffer, len))
+		return 0;
+
+	desc[len] = '\0';
+
+	if (sscanf(desc, "%d %d %d %d %d %d", &k_po, &k_pu, &k_i, &k_d, &i_cutoff, &horizon) == 6) {
+		if (k_po < 0 || k_pu < 0 || k_i < 0 || k_d < 0 || i_cutoff < 0 ||
+		    horizon < 0 || horizon > 5000)
+			goto bad;
+
+		pid_k_po = k_po;
+		pid_k_pu = k_pu;
+		pid_k_i = k_i;
+		pid_k_d = k_d;
+		pid_i_cutoff = i_cutoff;
+		pid_horizon_ms = horizon;
+
+		return count;
+	}
+bad:
+	tscpu_dprintk("%s bad argument\n", __func__);
+	return -EINVAL;
+}
+
 static void phpb_params_init(void)
 {
 	phpb_params[PHPB_PARAM_CPU].tt = 40;
@@ -1667,6 +1839,20 @@ static const struct file_operations mtktscpu_phpb_fops = {
 	.write = tscpu_write_phpb,
 	.release = single_release,
 };
+
+static int tscpu_pid_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, tscpu_read_pid, NULL);
+}
+
+static const struct file_operations mtktscpu_pid_fops = {
+	.owner = THIS_MODULE,
+	.open = tscpu_pid_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.write = tscpu_write_pid,
+	.release = single_release,
+};
 #endif
 #endif				/* CPT_ADAPTIVE_AP_COOLER */
 
@@ -1680,6 +1866,10 @@ static void phpb_init(struct proc_dir_entry *mtktscpu_dir)
 	entry = proc_create("clphpb", S_IRUGO | S_IWUSR, mtktscpu_dir, &mtktscpu_phpb_fops);
 	if (entry)
 		proc_set_user(entry, uid, gid);
+
+	entry = proc_create("clpid", S_IRUGO | S_IWUSR, mtktscpu_dir, &mtktscpu_pid_fops);
+	if (entry)
+		proc_set_user(entry, uid, gid);
 }
 #endif
 
@@ -13,7 +13,10 @@
 #include <linux/kernel.h>
 #include <linux/types.h>
 #include <linux/device.h>
-#include <linux/workqueue.h>
+#include <linux/kthread.h>
+#include <linux/sched.h>
+#include <linux/wait.h>
+#include <linux/rtpm_prio.h>
 
 #include "timed_output.h"
 
@@ -76,14 +79,27 @@ do {	\
 /******************************************************************************
 Global Definations
 ******************************************************************************/
-static struct workqueue_struct *vibrator_queue;
-static struct work_struct vibrator_work;
+/*
+ * The PMIC write behind vibr_Enable_HW() takes a mutex, so the hrtimer only
+ * flips vibe_state and wakes a dedicated RT thread which applies it. This
+ * keeps on/off edges within a scheduler wakeup of the timer instead of
+ * behind whatever else is queued on a workqueue.
+ */
+static struct task_struct *vibrator_task;
+static DECLARE_WAIT_QUEUE_HEAD(vibrator_wq);
+static atomic_t vibrator_pending = ATOMIC_INIT(0);
 static struct hrtimer vibe_timer;
 static spinlock_t vibe_lock;
 static int vibe_state;
 static int ldo_state;
 static int shutdown_flag;
 
+/* on/off pattern in ms, even steps on, odd steps off */
+#define VIB_PATTERN_MAX		32
+static unsigned int vibe_pattern[VIB_PATTERN_MAX];
+static int vibe_pattern_len;
+static int vibe_pattern_step;
+
 static int vibr_Enable(void)
 {
 	if (!ldo_state) {
@@ -102,7 +118,7 @@ static int vibr_Disable(void)
 	return 0;
 }
 
-static void update_vibrator(struct work_struct *work)
+static void update_vibrator(void)
 {
 	if (!vibe_state)
 		vibr_Disable();
@@ -110,6 +126,32 @@ static void update_vibrator(struct work_struct *work)
 		vibr_Enable();
 }
 
+/* safe from hrtimer context */
+static void vibrator_kick(void)
+{
+	atomic_set(&vibrator_pending, 1);
+	wake_up(&vibrator_wq);
+}
+
+static int vibrator_thread(void *arg)
+{
+	struct sched_param param = {.sched_priority = RTPM_PRIO_VIBRATOR };
+
+	sched_setscheduler(current, SCHED_FIFO, &param);
+
+	while (!kthread_should_stop()) {
+		wait_event(vibrator_wq, atomic_read(&vibrator_pending) || kthread_should_stop());
+		if (atomic_xchg(&vibrator_pending, 0))
+			update_vibrator();
+	}
+	return 0;
+}
+
+static ktime_t vibrator_ms_to_ktime(unsigned int ms)
+{
+	return ktime_set(ms / 1000, (ms % 1000) * 1000000);
+}
+
 static int vibrator_get_time(struct timed_output_dev *dev)
 {
 	if (hrtimer_active(&vibe_timer)) {
@@ -133,6 +175,7 @@ static void vibrator_enable(struct timed_output_dev *dev, int value)
 	spin_lock_irqsave(&vibe_lock, flags);
 	while (hrtimer_cancel(&vibe_timer))
 		VIB_DEBUG("vibrator_enable: try to cancel hrtimer\n");
+	vibe_pattern_len = 0;
 
 	if (value == 0 || shutdown_flag == 1) {
 		VIB_DEBUG("vibrator_enable: shutdown_flag = %d\n",
@@ -152,23 +195,69 @@ static void vibrator_enable(struct timed_output_dev *dev, int value)
 
 		value = (value > 15000 ? 15000 : value);
 		vibe_state = 1;
-		hrtimer_start(&vibe_timer,
-			      ktime_set(value / 1000, (value % 1000) * 1000000),
+		hrtimer_start(&vibe_timer, vibrator_ms_to_ktime(value),
 			      HRTIMER_MODE_REL);
 	}
 	spin_unlock_irqrestore(&vibe_lock, flags);
 	VIB_DEBUG("vibrator_enable: vibrator start: %d\n", value);
-	queue_work(vibrator_queue, &vibrator_work);
+	vibrator_kick();
 }
 
+/*
+ * Pattern fields are only written with the timer cancelled, so the
+ * callback reads them without vibe_lock (vibrator_enable() holds that
+ * lock across hrtimer_cancel()).
+ */
 static enum hrtimer_restart vibrator_timer_func(struct hrtimer *timer)
 {
+	while (vibe_pattern_step + 1 < vibe_pattern_len) {
+		vibe_pattern_step++;
+		/* skip zero length steps */
+		if (!vibe_pattern[vibe_pattern_step])
+			continue;
+		vibe_state = !(vibe_pattern_step & 1);
+		vibrator_kick();
+		hrtimer_forward_now(timer, vibrator_ms_to_ktime(vibe_pattern[vibe_pattern_step]));
+		return HRTIMER_RESTART;
+	}
+
+	vibe_pattern_len = 0;
 	vibe_state = 0;
 	VIB_DEBUG("vibrator_timer_func: vibrator will disable\n");
-	queue_work(vibrator_queue, &vibrator_work);
+	vibrator_kick();
 	return HRTIMER_NORESTART;
 }
 
+/*
+ * Play an on/off pattern: "on_ms off_ms on_ms ...", at most VIB_PATTERN_MAX
+ * steps and 15 s in total. Writing "0" or a new timed_output value stops it.
+ */
+static void vibrator_play_pattern(unsigned int *pattern, int len)
+{
+	unsigned long flags;
+	int step;
+
+	spin_lock_irqsave(&vibe_lock, flags);
+	while (hrtimer_cancel(&vibe_timer))
+		VIB_DEBUG("vibrator_play_pattern: try to cancel hrtimer\n");
+
+	vibe_pattern_len = 0;
+	vibe_state = 0;
+	/* first non-empty step */
+	for (step = 0; step < len && !pattern[step]; step++)
+		;
+	if (step < len && shutdown_flag == 0) {
+		memcpy(vibe_pattern, pattern, len * sizeof(*pattern));
+		vibe_pattern_len = len;
+		vibe_pattern_step = step;
+		vibe_state = !(step & 1);
+		hrtimer_start(&vibe_timer, vibrator_ms_to_ktime(pattern[step]),
+			      HRTIMER_MODE_REL);
+	}
+	spin_unlock_irqrestore(&vibe_lock, flags);
+	vibrator_kick();
+}
+
 static struct timed_output_dev mtk_vibrator = {
 	.name = "vibrator",
 	.get_time = vibrator_get_time,
@@ -235,6 +324,31 @@ static ssize_t store_vibr_on(struct device *dev, struct device_attribute *attr,
 
 static DEVICE_ATTR(vibr_on, 0220, NULL, store_vibr_on);
 
+static ssize_t store_vibr_pattern(struct device *dev, struct device_attribute *attr,
+				  const char *buf, size_t size)
+{
+	unsigned int pattern[VIB_PATTERN_MAX];
+	unsigned int total = 0;
+	const char *p = buf;
+	int len = 0;
+	int n;
+
+	while (len < VIB_PATTERN_MAX && sscanf(p, "%u%n", &pattern[len], &n) == 1) {
+		total += pattern[len];
+		if (pattern[len] > 15000 || total > 15000)
+			return -EINVAL;
+		p += n;
+		len++;
+	}
+	if (len == 0)
+		return -EINVAL;
+
+	vibrator_play_pattern(pattern, len);
+	return size;
+}
+
+static DEVICE_ATTR(vibr_pattern, 0220, NULL, store_vibr_pattern);
+
 /******************************************************************************
  * vib_mod_init
  *
@@ -267,12 +381,12 @@ static int vib_mod_init(void)
 		return ret;
 	}
 
-	vibrator_queue = create_singlethread_workqueue(VIB_DEVICE);
-	if (!vibrator_queue) {
-		VIB_DEBUG("Unable to create workqueue\n");
+	vibrator_task = kthread_run(vibrator_thread, NULL, VIB_DEVICE);
+	if (IS_ERR(vibrator_task)) {
+		VIB_DEBUG("Unable to create vibrator thread\n");
+		vibrator_task = NULL;
 		return -ENODATA;
 	}
-	INIT_WORK(&vibrator_work, update_vibrator);
 
 	spin_lock_init(&vibe_lock);
 	shutdown_flag = 0;
@@ -293,6 +407,10 @@ static int vib_mod_init(void)
 	if (ret)
 		VIB_DEBUG("device_create_file vibr_on fail!\n");
 
+	ret = device_create_file(mtk_vibrator.dev, &dev_attr_vibr_pattern);
+	if (ret)
+		VIB_DEBUG("device_create_file vibr_pattern fail!\n");
+
 	VIB_DEBUG("vib_mod_init Done\n");
 
 	return RSUCCESS;
@@ -319,8 +437,8 @@ static void vib_mod_exit(void)
 {
 	VIB_DEBUG("MediaTek MTK vibrator driver unregister, version %s\n",
 		  VERSION);
-	if (vibrator_queue)
-		destroy_workqueue(vibrator_queue);
+	if (vibrator_task)
+		kthread_stop(vibrator_task);
 	VIB_DEBUG("vib_mod_exit Done\n");
 }
 
@@ -278,6 +278,16 @@ int disp_pwm_set_backlight(disp_pwm_id_t id, int level_1024)
 
 static volatile int g_pwm_duplicate_count;
 
+/*
+ * Large backlight jumps (screen on, user slider) can be left to the PWM
+ * gradual stepping instead of a ramp of per-frame writes: the new level is
+ * programmed once and the hardware walks CON_1 to it. Per-frame AAL updates
+ * stay below the threshold and land directly. Enabled by "fade:1".
+ */
+#define PWM_GRAD_FADE_THRESHOLD 64
+#define PWM_GRAD_FADE_VALUE ((1 << 16) | (1 << 8) | 1)
+static int g_pwm_grad_fade;
+
 static void disp_pwm_log(int level_1024, int log_type)
 {
 	int i;
@@ -362,6 +372,10 @@ int disp_pwm_set_backlight_cmdq(disp_pwm_id_t id, int level_1024, void *cmdq)
 		level_1024 = disp_pwm_level_remap(id, level_1024);
 
 		reg_base = pwm_get_reg_base(id);
+		if (g_pwm_grad_fade)
+			DISP_REG_SET(cmdq, reg_base + DISP_PWM_GRAD_OFF,
+				     (old_pwm > 0 && level_1024 > 0 && abs_diff > PWM_GRAD_FADE_THRESHOLD) ?
+				     PWM_GRAD_FADE_VALUE : 0);
 		DISP_REG_MASK(cmdq, reg_base + DISP_PWM_CON_1_OFF, level_1024 << 16, 0x1fff << 16);
 
 		if (level_1024 > 0)
@@ -481,16 +495,16 @@ static void disp_pwm_test_source(const char *cmd)
 
 static void disp_pwm_test_grad(const char *cmd)
 {
-	const unsigned long reg_grad = pwm_get_reg_base(DISP_PWM0) + 0x18;
+	const unsigned long reg_grad = pwm_get_reg_base(DISP_PWM0) + DISP_PWM_GRAD_OFF;
 
 	switch (cmd[0]) {
 	case 'H':
-		DISP_REG_SET(NULL, reg_grad, (1 << 16) | (1 << 8) | 1);
+		DISP_REG_SET(NULL, reg_grad, PWM_GRAD_FADE_VALUE);
 		disp_pwm_set_backlight(DISP_PWM0, 1023);
 		break;
 
 	case 'L':
-		DISP_REG_SET(NULL, reg_grad, (1 << 16) | (1 << 8) | 1);
+		DISP_REG_SET(NULL, reg_grad, PWM_GRAD_FADE_VALUE);
 		disp_pwm_set_backlight(DISP_PWM0, 40);
 		break;
 
@@ -645,6 +659,11 @@ void disp_pwm_test(const char *cmd, char *debug_output)
 		disp_pwm_test_div(cmd + 4);
 	} else if (strncmp(cmd, "grad:", 5) == 0) {
 		disp_pwm_test_grad(cmd + 5);
+	} else if (strncmp(cmd, "fade:", 5) == 0) {
+		g_pwm_grad_fade = (cmd[5] == '1');
+		if (!g_pwm_grad_fade)
+			DISP_REG_SET(NULL, reg_base + DISP_PWM_GRAD_OFF, 0);
+		PWM_NOTICE("gradual fade = %d", g_pwm_grad_fade);
 	} else if (strncmp(cmd, "dbg:", 4) == 0) {
 		disp_pwm_enable_debug(cmd + 4);
 	} else if (strncmp(cmd, "set:", 4) == 0) {
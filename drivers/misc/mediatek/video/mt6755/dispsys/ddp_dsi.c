@@ -3024,11 +3024,42 @@ static void DSI_PHY_CLK_LP_PerLine_config(DISP_MODULE_ENUM module, cmdqRecHandle
 
 }
 
+static inline int ddp_dsi_partial_active(disp_ddp_path_config *config)
+{
+	struct disp_rect *roi = &config->ovl_partial_roi;
+
+	return roi->width && roi->height &&
+	    (roi->width != _dsi_context[0].lcm_width || roi->height != _dsi_context[0].lcm_height);
+}
+
+/*
+ * Partial update on a command mode panel: shrink the packet size to the roi
+ * and move the panel's column/page window onto it. lcm_width/lcm_height keep
+ * the full panel size so path start still opens the whole window.
+ */
+static void ddp_dsi_config_partial(DISP_MODULE_ENUM module, disp_ddp_path_config *config,
+				   void *cmdq)
+{
+	LCM_DSI_PARAMS *dsi_config = &(config->dispif_config.dsi);
+	struct disp_rect *roi = &config->ovl_partial_roi;
+
+	if (dsi_config->mode != CMD_MODE || module != DISP_MODULE_DSI0)
+		return;
+
+	DISPDBG("dsi partial roi (%d,%d,%d,%d)\n", roi->x, roi->y, roi->width, roi->height);
+	DSI_PS_Control(module, cmdq, dsi_config, roi->width, roi->height);
+	DSI_Send_ROI(module, cmdq, roi->x, roi->y, roi->width, roi->height);
+}
+
 int ddp_dsi_config(DISP_MODULE_ENUM module, disp_ddp_path_config *config, void *cmdq)
 {
 	int i = 0;
 	LCM_DSI_PARAMS *dsi_config = &(config->dispif_config.dsi);
 
+	if (config->ovl_partial_dirty && config->ovl_partial_roi.width &&
+	    config->ovl_partial_roi.height)
+		ddp_dsi_config_partial(module, config, cmdq);
+
 	if (!config->dst_dirty) {
 		if (atomic_read(&PMaster_enable) == 0)
 			return 0;
@@ -3038,8 +3069,10 @@ int ddp_dsi_config(DISP_MODULE_ENUM module, disp_ddp_path_config *config, void *
 
 	for (i = DSI_MODULE_BEGIN(module); i <= DSI_MODULE_END(module); i++) {
 		_copy_dsi_params(dsi_config, &(_dsi_context[i].dsi_params));
-		_dsi_context[i].lcm_width = config->dst_w;
-		_dsi_context[i].lcm_height = config->dst_h;
+		if (!ddp_dsi_partial_active(config)) {
+			_dsi_context[i].lcm_width = config->dst_w;
+			_dsi_context[i].lcm_height = config->dst_h;
+		}
 		_dump_dsi_params(&(_dsi_context[i].dsi_params));
 		if (dsi_config->mode != CMD_MODE) {
 			/* not enable TE in vdo mode */
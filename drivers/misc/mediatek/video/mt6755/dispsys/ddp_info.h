@@ -232,6 +232,14 @@ typedef struct {
 
 } disp_idlemgr_context;
 
+/* partial update region, in panel coordinates */
+struct disp_rect {
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
 typedef struct {
 	/* for ovl */
 	bool ovl_dirty;
@@ -248,6 +256,13 @@ typedef struct {
 	unsigned int lcm_bpp;
 	unsigned int dst_w;
 	unsigned int dst_h;
+	/*
+	 * partial update: when ovl_partial_roi is non-empty and matches
+	 * dst_w/dst_h, OVL layers are clipped to it and DSI sends only this
+	 * window. ovl_partial_dirty asks DSI to reprogram the panel window.
+	 */
+	bool ovl_partial_dirty;
+	struct disp_rect ovl_partial_roi;
 	unsigned int fps;
 	golden_setting_context *p_golden_setting_context;
 	void *path_handle;
@@ -1146,6 +1146,7 @@ disp_ddp_path_config *dpmgr_path_get_last_config(disp_path_handle dp_handle)
 	handle->last_config.rdma_dirty = 0;
 	handle->last_config.wdma_dirty = 0;
 	handle->last_config.dst_dirty = 0;
+	handle->last_config.ovl_partial_dirty = 0;
 	handle->last_config.ovl_layer_dirty = 0;
 	handle->last_config.ovl_layer_scanned = 0;
 	return &handle->last_config;
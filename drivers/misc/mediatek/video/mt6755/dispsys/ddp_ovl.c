@@ -745,11 +745,48 @@ static int setup_ovl_sec(DISP_MODULE_ENUM module, void *handle, int is_engine_se
 	return 0;
 }
 
+static inline int ovl_partial_active(disp_ddp_path_config *pConfig)
+{
+	struct disp_rect *roi = &pConfig->ovl_partial_roi;
+
+	return roi->width && roi->height &&
+	    roi->width == pConfig->dst_w && roi->height == pConfig->dst_h;
+}
+
+/*
+ * Clip a layer to the partial update roi and move it into roi coordinates.
+ * OVL does no scaling, so the source window shifts by the same amount as
+ * the destination. Returns -1 if the layer does not intersect the roi.
+ */
+static int ovl_layer_clip_to_roi(OVL_CONFIG_STRUCT *cfg, struct disp_rect *roi,
+				 OVL_CONFIG_STRUCT *out)
+{
+	int left = max_t(int, cfg->dst_x, roi->x);
+	int top = max_t(int, cfg->dst_y, roi->y);
+	int right = min_t(int, cfg->dst_x + cfg->dst_w, roi->x + roi->width);
+	int bottom = min_t(int, cfg->dst_y + cfg->dst_h, roi->y + roi->height);
+
+	if (left >= right || top >= bottom)
+		return -1;
+
+	*out = *cfg;
+	out->src_x += left - cfg->dst_x;
+	out->src_y += top - cfg->dst_y;
+	out->dst_x = left - roi->x;
+	out->dst_y = top - roi->y;
+	out->dst_w = right - left;
+	out->dst_h = bottom - top;
+
+	return 0;
+}
+
 static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, void *handle)
 {
 	int enabled_layers = 0;
 	int has_sec_layer = 0;
 	int local_layer, global_layer, layer_id;
+	int partial = ovl_partial_active(pConfig);
+	OVL_CONFIG_STRUCT clip_cfg;
 
 	if (pConfig->dst_dirty)
 		ovl_roi(module, pConfig->dst_w, pConfig->dst_h, gOVLBackground, handle);
@@ -785,6 +822,11 @@ static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 			continue;
 		if (ovl_check_input_param(ovl_cfg))
 			continue;
+		if (partial) {
+			if (ovl_layer_clip_to_roi(ovl_cfg, &pConfig->ovl_partial_roi, &clip_cfg))
+				continue;
+			ovl_cfg = &clip_cfg;
+		}
 
 		print_layer_config_args(module, local_layer, ovl_cfg);
 		ovl_layer_config(module, local_layer, has_sec_layer, ovl_cfg, handle);
@@ -39,6 +39,7 @@
 #include "disp_session.h"
 #include "ddp_mmp.h"
 #include <linux/ftrace_event.h>
+#include <mt-plat/mt_kernel_marker.h>
 
 unsigned int gCapturePriLayerEnable = 0;
 unsigned int gCaptureWdmaLayerEnable = 0;
@@ -472,37 +473,19 @@ void dprec_logger_event_init(dprec_logger_event *p, char *name, uint32_t level,
 
 #ifdef CONFIG_TRACING
 
-static unsigned long __read_mostly tracing_mark_write_addr;
-static inline void __mt_update_tracing_mark_write_addr(void)
-{
-	if (unlikely(0 == tracing_mark_write_addr))
-		tracing_mark_write_addr = kallsyms_lookup_name("tracing_mark_write");
-}
-
 static inline void mmp_kernel_trace_begin(char *name)
 {
-	__mt_update_tracing_mark_write_addr();
-	preempt_disable();
-	event_trace_printk(tracing_mark_write_addr, "B|%d|%s\n", current->tgid, name);
-	preempt_enable();
-
+	mt_kernel_marker_write('B', name, 0);
 }
 
 static inline void mmp_kernel_trace_counter(char *name, int count)
 {
-	__mt_update_tracing_mark_write_addr();
-	preempt_disable();
-	event_trace_printk(tracing_mark_write_addr, "C|%d|%s|%d\n",
-			   in_interrupt() ? -1 : current->tgid, name, count);
-	preempt_enable();
+	mt_kernel_marker_write('C', name, count);
 }
 
 static inline void mmp_kernel_trace_end(void)
 {
-	__mt_update_tracing_mark_write_addr();
-	preempt_disable();
-	event_trace_printk(tracing_mark_write_addr, "E\n");
-	preempt_enable();
+	mt_kernel_marker_write('E', NULL, 0);
 }
 
 void dprec_logger_frame_seq_begin(unsigned int session_id, unsigned frm_sequence)
@@ -516,11 +499,8 @@ void dprec_logger_frame_seq_begin(unsigned int session_id, unsigned frm_sequence
 	}
 
 	if (dprec_met_info[device_type].begin_frm_seq != frm_sequence) {
-		__mt_update_tracing_mark_write_addr();
-		preempt_disable();
-		event_trace_printk(tracing_mark_write_addr, "S|%d|%s|%d\n", current->tgid,
-				   dprec_met_info[device_type].log_name, frm_sequence);
-		preempt_enable();
+		mt_kernel_marker_write('S', dprec_met_info[device_type].log_name,
+				       frm_sequence);
 		dprec_met_info[device_type].begin_frm_seq = frm_sequence;
 	}
 }
@@ -536,11 +516,8 @@ void dprec_logger_frame_seq_end(unsigned int session_id, unsigned frm_sequence)
 	}
 
 	if (dprec_met_info[device_type].end_frm_seq != frm_sequence) {
-		__mt_update_tracing_mark_write_addr();
-		preempt_disable();
-		event_trace_printk(tracing_mark_write_addr, "F|%d|%s|%d\n", current->tgid,
-				   dprec_met_info[device_type].log_name, frm_sequence);
-		preempt_enable();
+		mt_kernel_marker_write('F', dprec_met_info[device_type].log_name,
+				       frm_sequence);
 		dprec_met_info[device_type].end_frm_seq = frm_sequence;
 	}
 }
@@ -557,6 +534,158 @@ void dprec_logger_frame_seq_end(unsigned int session_id, unsigned frm_sequence)
 }
 #endif
 
+/* only the most recent frames can still be pending, bound the lookups */
+#define DPREC_FRAME_PENDING_MAX 16
+
+static DEFINE_SPINLOCK(dprec_frame_lock);
+static dprec_frame_record dprec_frame_ring[DPREC_FRAME_RECORD_NUM];
+static unsigned int dprec_frame_wr;
+static unsigned int dprec_frame_cnt;
+static unsigned long long dprec_frame_vsync_ts;
+
+static dprec_frame_record *_dprec_frame_recent(unsigned int back)
+{
+	if (back >= dprec_frame_cnt)
+		return NULL;
+
+	return &dprec_frame_ring[(dprec_frame_wr + DPREC_FRAME_RECORD_NUM - 1 - back) %
+				 DPREC_FRAME_RECORD_NUM];
+}
+
+static dprec_frame_record *_dprec_frame_find(unsigned int seq)
+{
+	dprec_frame_record *rec;
+	unsigned int i;
+
+	for (i = 0; i < DPREC_FRAME_PENDING_MAX; i++) {
+		rec = _dprec_frame_recent(i);
+		if (!rec)
+			break;
+		if (rec->seq == seq && !rec->ts[DPREC_FRAME_STAGE_RELEASE])
+			return rec;
+	}
+
+	return NULL;
+}
+
+static void _dprec_frame_finish(dprec_frame_record *rec)
+{
+	unsigned long long total, delta, max_delta = 0;
+	int i;
+
+	total = rec->ts[DPREC_FRAME_STAGE_RELEASE] - rec->ts[DPREC_FRAME_STAGE_CFG];
+	rec->cause = DPREC_FRAME_CAUSE_NONE;
+	if (total > DPREC_FRAME_DEADLINE_US) {
+		for (i = DPREC_FRAME_STAGE_CFG; i < DPREC_FRAME_STAGE_RELEASE; i++) {
+			if (!rec->ts[i] || !rec->ts[i + 1])
+				continue;
+			delta = rec->ts[i + 1] - rec->ts[i];
+			if (delta > max_delta) {
+				max_delta = delta;
+				/* stage deltas map 1:1 onto the cause enum */
+				rec->cause = DPREC_FRAME_CAUSE_CONFIG + i;
+			}
+		}
+	}
+
+#ifdef CONFIG_TRACING
+	if (_control.systrace) {
+		mmp_kernel_trace_counter("disp_frame_latency_us", (int)total);
+		mmp_kernel_trace_counter("disp_frame_late_cause", rec->cause);
+	}
+#endif
+}
+
+void dprec_frame_begin(unsigned int seq)
+{
+	dprec_frame_record *rec;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dprec_frame_lock, flags);
+	rec = &dprec_frame_ring[dprec_frame_wr];
+	memset(rec, 0, sizeof(*rec));
+	rec->seq = seq;
+	rec->ts[DPREC_FRAME_STAGE_CFG] = get_current_time_us();
+	dprec_frame_wr = (dprec_frame_wr + 1) % DPREC_FRAME_RECORD_NUM;
+	if (dprec_frame_cnt < DPREC_FRAME_RECORD_NUM)
+		dprec_frame_cnt++;
+	spin_unlock_irqrestore(&dprec_frame_lock, flags);
+}
+
+void dprec_frame_stage(unsigned int seq, DPREC_FRAME_STAGE stage)
+{
+	dprec_frame_record *rec;
+	unsigned long flags;
+
+	if (stage >= DPREC_FRAME_STAGE_NUM)
+		return;
+
+	spin_lock_irqsave(&dprec_frame_lock, flags);
+	if (stage == DPREC_FRAME_STAGE_VSYNC) {
+		/* vsync is not tied to a frame, it is applied on release */
+		dprec_frame_vsync_ts = get_current_time_us();
+	} else {
+		rec = _dprec_frame_find(seq);
+		if (rec && !rec->ts[stage])
+			rec->ts[stage] = get_current_time_us();
+	}
+	spin_unlock_irqrestore(&dprec_frame_lock, flags);
+}
+
+/*
+ * The present fence timeline signals every fence up to @seq at once, so all
+ * pending frames at or before @seq are released here.
+ */
+void dprec_frame_release(unsigned int seq)
+{
+	dprec_frame_record *rec;
+	unsigned long long now;
+	unsigned long flags;
+	unsigned int i;
+
+	spin_lock_irqsave(&dprec_frame_lock, flags);
+	now = get_current_time_us();
+	for (i = 0; i < DPREC_FRAME_PENDING_MAX; i++) {
+		rec = _dprec_frame_recent(i);
+		if (!rec)
+			break;
+		if (rec->ts[DPREC_FRAME_STAGE_RELEASE] || (int)(rec->seq - seq) > 0)
+			continue;
+
+		if (dprec_frame_vsync_ts >= rec->ts[DPREC_FRAME_STAGE_CFG])
+			rec->ts[DPREC_FRAME_STAGE_VSYNC] = dprec_frame_vsync_ts;
+		rec->ts[DPREC_FRAME_STAGE_RELEASE] = now;
+		_dprec_frame_finish(rec);
+	}
+	spin_unlock_irqrestore(&dprec_frame_lock, flags);
+}
+
+int dprec_frame_record_get(char *buf, int len)
+{
+	dprec_frame_record_header *header = (dprec_frame_record_header *)buf;
+	dprec_frame_record *out;
+	unsigned long flags;
+	unsigned int i, start;
+
+	if (!buf || len < (int)DPREC_FRAME_RECORD_BUF_SIZE)
+		return 0;
+
+	header->magic = DPREC_FRAME_RECORD_MAGIC;
+	header->version = DPREC_FRAME_RECORD_VERSION;
+	header->record_size = sizeof(dprec_frame_record);
+	out = (dprec_frame_record *)(header + 1);
+
+	spin_lock_irqsave(&dprec_frame_lock, flags);
+	header->record_num = dprec_frame_cnt;
+	start = (dprec_frame_wr + DPREC_FRAME_RECORD_NUM - dprec_frame_cnt) %
+		DPREC_FRAME_RECORD_NUM;
+	for (i = 0; i < dprec_frame_cnt; i++)
+		out[i] = dprec_frame_ring[(start + i) % DPREC_FRAME_RECORD_NUM];
+	spin_unlock_irqrestore(&dprec_frame_lock, flags);
+
+	return sizeof(*header) + header->record_num * sizeof(dprec_frame_record);
+}
+
 void dprec_start(dprec_logger_event *event, unsigned int val1, unsigned int val2)
 {
 	dprec_logger *l;
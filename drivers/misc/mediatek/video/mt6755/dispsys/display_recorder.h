@@ -139,6 +139,52 @@ typedef enum {
 
 
 #define DPREC_ERROR_LOG_BUFFER_LENGTH (1024*8)
+
+/*
+ * Per-frame composition latency record. Each frame is stamped at config
+ * entry, input setup, HW trigger, the vsync it was shown at and the present
+ * fence release. Records are exported as a fixed-size binary ring through
+ * debugfs (header followed by records, oldest first).
+ */
+typedef enum {
+	DPREC_FRAME_STAGE_CFG = 0,
+	DPREC_FRAME_STAGE_INPUT,
+	DPREC_FRAME_STAGE_FLUSH,
+	DPREC_FRAME_STAGE_VSYNC,
+	DPREC_FRAME_STAGE_RELEASE,
+	DPREC_FRAME_STAGE_NUM
+} DPREC_FRAME_STAGE;
+
+/* stage that contributed most to a frame exceeding the deadline */
+typedef enum {
+	DPREC_FRAME_CAUSE_NONE = 0,
+	DPREC_FRAME_CAUSE_CONFIG,	/* cfg -> input: buffer/fence preparation */
+	DPREC_FRAME_CAUSE_FLUSH,	/* input -> flush: waiting for trigger */
+	DPREC_FRAME_CAUSE_VSYNC,	/* flush -> vsync: HW or TE late */
+	DPREC_FRAME_CAUSE_RELEASE	/* vsync -> release: fence signal late */
+} DPREC_FRAME_CAUSE;
+
+#define DPREC_FRAME_RECORD_MAGIC	0x44465254	/* "DFRT" */
+#define DPREC_FRAME_RECORD_VERSION	1
+#define DPREC_FRAME_RECORD_NUM		256
+#define DPREC_FRAME_DEADLINE_US		33333
+
+typedef struct {
+	uint32_t seq;
+	uint32_t cause;
+	uint64_t ts[DPREC_FRAME_STAGE_NUM];	/* us, 0 if stage not reached */
+} dprec_frame_record;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t record_num;
+} dprec_frame_record_header;
+
+#define DPREC_FRAME_RECORD_BUF_SIZE \
+	(sizeof(dprec_frame_record_header) + \
+	 DPREC_FRAME_RECORD_NUM * sizeof(dprec_frame_record))
 extern unsigned int gCapturePriLayerEnable;
 extern unsigned int gCaptureWdmaLayerEnable;
 extern unsigned int gCaptureRdmaLayerEnable;
@@ -187,6 +233,10 @@ int dprec_mmp_dump_wdma_layer(void *wdma_layer, unsigned int wdma_num);
 int dprec_mmp_dump_rdma_layer(void *wdma_layer, unsigned int wdma_num);
 void dprec_logger_frame_seq_begin(unsigned int session_id, unsigned frm_sequence);
 void dprec_logger_frame_seq_end(unsigned int session_id, unsigned frm_sequence);
+void dprec_frame_begin(unsigned int seq);
+void dprec_frame_stage(unsigned int seq, DPREC_FRAME_STAGE stage);
+void dprec_frame_release(unsigned int seq);
+int dprec_frame_record_get(char *buf, int len);
 int dprec_mmp_dump_ovl_layer(OVL_CONFIG_STRUCT *ovl_layer, unsigned int l,
 			     unsigned int session /*1:primary, 2:external, 3:memory */);
 
@@ -687,6 +687,22 @@ static ssize_t kick_read(struct file *file, char __user *ubuf, size_t count, lof
 static const struct file_operations kickidle_fops = {
 	.read = kick_read,
 };
+
+static char frame_rec_buffer[DPREC_FRAME_RECORD_BUF_SIZE];
+static int frame_rec_size;
+
+static ssize_t frame_rec_read(struct file *file, char __user *ubuf, size_t count, loff_t *ppos)
+{
+	/* snapshot once per read pass so a partial read stays consistent */
+	if (*ppos == 0)
+		frame_rec_size = dprec_frame_record_get(frame_rec_buffer, sizeof(frame_rec_buffer));
+
+	return simple_read_from_buffer(ubuf, count, ppos, frame_rec_buffer, frame_rec_size);
+}
+
+static const struct file_operations frame_rec_fops = {
+	.read = frame_rec_read,
+};
 void DBG_Init(void)
 {
 	struct dentry *d_folder;
@@ -695,6 +711,7 @@ void DBG_Init(void)
 	d_folder = debugfs_create_dir("displowpower", NULL);
 	if (d_folder)
 		d_file = debugfs_create_file("kickdump", S_IFREG | S_IRUGO, d_folder, NULL, &kickidle_fops);
+	debugfs_create_file("disp_frame", S_IFREG | S_IRUGO, NULL, NULL, &frame_rec_fops);
 
 
 }
@@ -115,6 +115,9 @@ const char *disp_helper_option_string[DISP_OPT_NUM] = {
 	"DISP_OPT_RDMA_UNDERFLOW_AEE",
 	"DISP_OPT_GMO_OPTIMIZE",
 	"DISP_OPT_CV_BYSUSPEND",
+	"DISP_OPT_PARTIAL_UPDATE",
+	"DISP_OPT_PARTIAL_UPDATE_THRESHOLD",
+	"DISP_OPT_DYNAMIC_FPS",
 };
 
 
@@ -339,6 +342,12 @@ void disp_helper_option_init(void)
 	disp_helper_set_option(DISP_OPT_GMO_OPTIMIZE, 0);
 	disp_helper_set_option(DISP_OPT_CV_BYSUSPEND, 1);
 	disp_helper_set_option(DISP_OPT_DYNAMIC_DEBUG, 0);
+	/* cmd mode only: send just the dirty band of lines over DSI */
+	disp_helper_set_option(DISP_OPT_PARTIAL_UPDATE, 1);
+	/* fall back to full update above this percentage of the panel */
+	disp_helper_set_option(DISP_OPT_PARTIAL_UPDATE_THRESHOLD, 60);
+	/* lower panel refresh to content fps, needs lcm_drv->adjust_fps */
+	disp_helper_set_option(DISP_OPT_DYNAMIC_FPS, 1);
 }
 
 int disp_helper_get_option_list(char *stringbuf, int buf_len)
@@ -42,6 +42,9 @@ typedef enum {
 	DISP_OPT_RDMA_UNDERFLOW_AEE,
 	DISP_OPT_GMO_OPTIMIZE,
 	DISP_OPT_CV_BYSUSPEND,
+	DISP_OPT_PARTIAL_UPDATE,
+	DISP_OPT_PARTIAL_UPDATE_THRESHOLD,
+	DISP_OPT_DYNAMIC_FPS,
 	DISP_OPT_NUM
 } DISP_HELPER_OPT;
 
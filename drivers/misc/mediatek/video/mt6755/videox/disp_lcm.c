@@ -458,6 +458,28 @@ int disp_lcm_set_backlight(disp_lcm_handle *plcm, void *handle, int level)
 	return ret;
 }
 
+int disp_lcm_is_support_adjust_fps(disp_lcm_handle *plcm)
+{
+	if (_is_lcm_inited(plcm) && plcm->drv->adjust_fps)
+		return 1;
+
+	return 0;
+}
+
+int disp_lcm_adjust_fps(disp_lcm_handle *plcm, void *handle, int fps)
+{
+	LCM_DRIVER *lcm_drv = NULL;
+
+	DISPFUNC();
+	if (!disp_lcm_is_support_adjust_fps(plcm)) {
+		DISPERR("lcm_drv->adjust_fps is null\n");
+		return -1;
+	}
+
+	lcm_drv = plcm->drv;
+	return lcm_drv->adjust_fps(handle, fps, plcm->params);
+}
+
 int disp_lcm_ioctl(disp_lcm_handle *plcm, LCM_IOCTL ioctl, unsigned int arg)
 {
 	return 0;
@@ -31,6 +31,8 @@ int disp_lcm_esd_recover(disp_lcm_handle *plcm);
 int disp_lcm_suspend(disp_lcm_handle *plcm);
 int disp_lcm_resume(disp_lcm_handle *plcm);
 int disp_lcm_set_backlight(disp_lcm_handle *plcm, void *handle, int level);
+int disp_lcm_is_support_adjust_fps(disp_lcm_handle *plcm);
+int disp_lcm_adjust_fps(disp_lcm_handle *plcm, void *handle, int fps);
 int disp_lcm_read_fb(disp_lcm_handle *plcm);
 int disp_lcm_ioctl(disp_lcm_handle *plcm, LCM_IOCTL ioctl, unsigned int arg);
 int disp_lcm_is_video_mode(disp_lcm_handle *plcm);
@@ -58,6 +58,9 @@ static atomic_t idlemgr_task_wakeup = ATOMIC_INIT(1);
 #define MMSYS_CLK_HIGH (1)
 #define MMSYS_CLK_MEDIUM (2)
 
+#define MMDVFS_CLIENT_ID_DISP (1)
+extern int mmdvfs_register_mmclk_switch_cb(int (*notify_cb)(int, int), int mmdvfs_client_id);
+
 /* Local API */
 /*********************************************************************************************************************/
 static int _primary_path_idlemgr_monitor_thread(void *data);
@@ -580,6 +583,8 @@ void _primary_display_enable_mmsys_clk(void)
 	data_config->dst_dirty = 1;
 	data_config->ovl_dirty = 1;
 	data_config->rdma_dirty = 1;
+	/* path start reopens the full panel window */
+	primary_display_partial_reset(data_config);
 	dpmgr_path_config(primary_get_dpmgr_handle(), data_config, NULL);
 
 	if (primary_display_is_decouple_mode()) {
@@ -938,6 +943,14 @@ int primary_display_lowpower_init(void)
 		/* callback with lock or without lock ??? */
 		;/*register_mmclk_switch_cb(primary_display_switch_mmsys_clk, _switch_mmsys_clk);*/
 
+	/*
+	 * mmdvfs hops the mmsys clock between medium and high from its own
+	 * context; follow with the rdma golden setting through cmdq so it is
+	 * applied at a frame boundary.
+	 */
+	if (disp_helper_get_option(DISP_OPT_DYNAMIC_RDMA_GOLDEN_SETTING))
+		mmdvfs_register_mmclk_switch_cb(primary_display_switch_mmsys_clk, MMDVFS_CLIENT_ID_DISP);
+
 	/* cmd mode always enable share sram */
 	if (disp_helper_get_option(DISP_OPT_SHARE_SRAM))
 		enter_share_sram(CMDQ_SYNC_RESOURCE_WROT0);
@@ -541,6 +541,7 @@ int primary_display_esd_recovery(void)
 {
 	DISP_STATUS ret = DISP_STATUS_OK;
 	LCM_PARAMS *lcm_param = NULL;
+	disp_ddp_path_config *data_config;
 
 	DISPFUNC();
 	dprec_logger_start(DPREC_LOGGER_ESD_RECOVERY, 0, 0);
@@ -595,6 +596,14 @@ int primary_display_esd_recovery(void)
 	DISPCHECK("[ESD]lcm force init[end]\n");
 	MMProfileLogEx(ddp_mmp_get_events()->esd_recovery_t, MMProfileFlagPulse, 0, 8);
 
+	primary_display_dfps_reset();
+
+	/* panel GRAM is lost, leave partial update before restarting */
+	data_config = dpmgr_path_get_last_config(primary_get_dpmgr_handle());
+	primary_display_partial_reset(data_config);
+	if (data_config->ovl_partial_dirty)
+		dpmgr_path_config(primary_get_dpmgr_handle(), data_config, CMDQ_DISABLE);
+
 	DISPDBG("[ESD]start dpmgr path[begin]\n");
 	dpmgr_path_start(primary_get_dpmgr_handle(), CMDQ_DISABLE);
 	DISPCHECK("[ESD]start dpmgr path[end]\n");
@@ -2341,6 +2341,8 @@ static int mtkfb_probe(struct device *dev)
 	fbdev->fb_info = fbi;
 	fbdev->dev = dev;
 	dev_set_drvdata(dev, fbdev);
+	/* panel power is handled on fb blank, nothing here to order against */
+	device_enable_async_suspend(dev);
 
 	DISPCHECK("mtkfb_probe: fb_pa = 0x%pa\n", &fb_base);
 
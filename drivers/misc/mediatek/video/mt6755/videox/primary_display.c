@@ -23,6 +23,7 @@
 #include <cust_eint.h>
 #endif
 #include "mt-plat/mt_smi.h"
+#include <mt-plat/mtk_input_boost.h>
 #include "m4u.h"
 #include <mt-plat/aee.h>
 #include "mt_vcorefs_manager.h"
@@ -74,6 +75,7 @@
 #include "disp_lowpower.h"
 #include "disp_recovery.h"
 #include "mt_spm_sodi_cmdq.h"
+#include "ged_dvfs.h"
 
 #define FRM_UPDATE_SEQ_CACHE_NUM (DISP_INTERNAL_BUFFER_COUNT+1)
 
@@ -694,6 +696,90 @@ static int fps_monitor_thread(void *data)
 #endif
 /*********************** fps calculate finish *********************************/
 
+/*********************** dynamic fps ******************************************/
+/*
+ * Follow content fps with the panel refresh rate. The new rate is pushed by
+ * lcm_drv->adjust_fps into the frame config handle, so it takes effect at
+ * the frame boundary together with the next frame. Going up is immediate,
+ * going down waits DFPS_DOWN_HOLD stable frames.
+ */
+static const unsigned int dfps_levels[] = { 45, 30 };
+#define DFPS_DOWN_HOLD	30
+
+static unsigned int dfps_cur;	/* current refresh in Hz, 0 = lcm default */
+static unsigned int dfps_down_cnt;
+
+static void _primary_dfps_notify(unsigned int fps)
+{
+	disp_ddp_path_config *data_config = dpmgr_path_get_last_config_notclear(pgc->dpmgr_handle);
+
+	/* rdma golden setting follows the next rdma config */
+	data_config->fps = fps * 100;
+	set_target_fps(fps);
+	MMProfileLogEx(ddp_mmp_get_events()->fps_set, MMProfileFlagPulse, fps, 0xdf);
+}
+
+static unsigned int _primary_dfps_pick(unsigned int content_fps, unsigned int base)
+{
+	unsigned int target = base;
+	int i;
+
+	/* keep 10% headroom over content fps */
+	for (i = 0; i < ARRAY_SIZE(dfps_levels); i++) {
+		if (dfps_levels[i] < base && content_fps * 11 <= dfps_levels[i] * 10)
+			target = dfps_levels[i];
+	}
+
+	return target;
+}
+
+/* notes: primary lock should be held when call this func */
+static void _primary_dfps_check(cmdqRecHandle cmdq_handle)
+{
+	unsigned int base = pgc->lcm_fps / 100;
+	unsigned int cur = dfps_cur ? dfps_cur : base;
+	unsigned int fps = 0, target;
+	int stable = 0;
+
+	if (!disp_helper_get_option(DISP_OPT_DYNAMIC_FPS) ||
+	    !disp_lcm_is_support_adjust_fps(pgc->plcm))
+		return;
+	/* the dsi side config handle is owned by the decouple worker */
+	if (primary_display_is_decouple_mode() || !cmdq_handle)
+		return;
+
+	fps_ctx_get_fps(&primary_fps_ctx, &fps, &stable);
+	target = stable ? _primary_dfps_pick(fps, base) : base;
+
+	if (target == cur) {
+		dfps_down_cnt = 0;
+		return;
+	}
+	if (target < cur && ++dfps_down_cnt < DFPS_DOWN_HOLD)
+		return;
+	dfps_down_cnt = 0;
+
+	if (disp_lcm_adjust_fps(pgc->plcm, cmdq_handle, target)) {
+		DISPERR("dfps: lcm refuse %d -> %d fps\n", cur, target);
+		return;
+	}
+
+	DISPMSG("dfps: %d -> %d fps, content %d\n", cur, target, fps);
+	dfps_cur = target;
+	_primary_dfps_notify(target);
+}
+
+/* panel init restores its default refresh rate */
+void primary_display_dfps_reset(void)
+{
+	dfps_down_cnt = 0;
+	if (!dfps_cur)
+		return;
+
+	dfps_cur = 0;
+	_primary_dfps_notify(pgc->lcm_fps / 100);
+}
+
 /*********************** idle manager *****************************************/
 int primary_display_get_debug_state(char *stringbuf, int buf_len)
 {
@@ -1433,11 +1519,8 @@ static void directlink_path_add_memory(WDMA_CONFIG_STRUCT *p_wdma, DISP_MODULE_E
 
 	pconfig = dpmgr_path_get_last_config(pgc->dpmgr_handle);
 	pconfig->wdma_config = *p_wdma;
-
-	if (disp_helper_get_option(DISP_OPT_DECOUPLE_MODE_USE_RGB565)) {
-		pconfig->wdma_config.outputFormat = UFMT_RGB565;
-		pconfig->wdma_config.dstPitch = pconfig->wdma_config.srcWidth * 2;
-	}
+	/* capture and the decouple path behind it need the full frame */
+	primary_display_partial_reset(pconfig);
 
 	pconfig->wdma_dirty = 1;
 	ret = dpmgr_path_config(pgc->dpmgr_handle, pconfig, cmdq_handle);
@@ -2040,10 +2123,35 @@ static disp_internal_buffer_info *allocat_decouple_buffer(int size)
 	return buf_info;
 }
 
+/*
+ * Format of the decouple (ovl->wdma->dram->rdma) buffer. Every DC frame is
+ * written and read back once, so RGB565 cuts that EMI traffic by a third.
+ * It is lossless for 16bpp panels and used for them automatically; other
+ * panels only get it when DISP_OPT_DECOUPLE_MODE_USE_RGB565 trades color
+ * depth for bandwidth.
+ */
+static enum UNIFIED_COLOR_FMT _decouple_buffer_fmt(void)
+{
+	LCM_PARAMS *lcm_param = disp_lcm_get_params(pgc->plcm);
+
+	if (disp_helper_get_option(DISP_OPT_DECOUPLE_MODE_USE_RGB565))
+		return UFMT_RGB565;
+
+	if (lcm_param) {
+		if (lcm_param->type == LCM_TYPE_DSI &&
+		    lcm_param->dsi.data_format.format == LCM_DSI_FORMAT_RGB565)
+			return UFMT_RGB565;
+		if (lcm_param->type == LCM_TYPE_DPI && lcm_param->dpi.format == LCM_DPI_FORMAT_RGB565)
+			return UFMT_RGB565;
+	}
+
+	return UFMT_RGB888;
+}
+
 static int init_decouple_buffers(void)
 {
 	int i = 0;
-	enum UNIFIED_COLOR_FMT fmt = UFMT_RGB888;
+	enum UNIFIED_COLOR_FMT fmt = _decouple_buffer_fmt();
 	int height = disp_helper_get_option(DISP_OPT_FAKE_LCM_HEIGHT);
 	int width = disp_helper_get_option(DISP_OPT_FAKE_LCM_WIDTH);
 	int Bpp = UFMT_GET_Bpp(fmt);
@@ -2091,7 +2199,7 @@ static int _allocate_dc_buffer(void)
 {
 	int ret = 0;
 	int i = 0;
-	enum UNIFIED_COLOR_FMT fmt = UFMT_RGB888;
+	enum UNIFIED_COLOR_FMT fmt = _decouple_buffer_fmt();
 	int height = disp_helper_get_option(DISP_OPT_FAKE_LCM_HEIGHT);
 	int width = disp_helper_get_option(DISP_OPT_FAKE_LCM_WIDTH);
 	int Bpp = UFMT_GET_Bpp(fmt);
@@ -2346,6 +2454,7 @@ int _trigger_ovl_to_memory(disp_path_handle disp_handle,
 	rdma_pitch_sec = mem_config.pitch | (mem_config.security << 30);
 	cmdqRecBackupUpdateSlot(cmdq_handle, pgc->rdma_buff_info, 1, rdma_pitch_sec);
 	cmdqRecBackupUpdateSlot(cmdq_handle, pgc->rdma_buff_info, 2, (unsigned int)mem_config.fmt);
+	cmdqRecBackupUpdateSlot(cmdq_handle, pgc->rdma_buff_info, 3, mem_config.w | (mem_config.h << 16));
 
 	cmdqRecFlushAsyncCallback(cmdq_handle, callback, data);
 	cmdqRecReset(cmdq_handle);
@@ -2384,6 +2493,7 @@ static int _disp_primary_path_check_trigger(void *data)
 
 	if (disp_helper_get_option(DISP_OPT_USE_CMDQ)) {
 		cmdqRecHandle handle = NULL;
+		int built_mode = -1;
 
 		ret = cmdqRecCreate(CMDQ_SCENARIO_PRIMARY_DISP, &handle);
 
@@ -2398,9 +2508,14 @@ static int _disp_primary_path_check_trigger(void *data)
 
 			if (pgc->state == DISP_ALIVE) {
 				primary_display_idlemgr_kick((char *)__func__, 0);
-				cmdqRecReset(handle);
-				_cmdq_insert_wait_frame_done_token_mira(handle);
-				_cmdq_set_config_handle_dirty_mira(handle);
+				/* the trigger sequence only depends on the mode, keep it */
+				/* finalized and flush it again instead of rebuilding */
+				if (built_mode != primary_display_is_video_mode()) {
+					cmdqRecReset(handle);
+					_cmdq_insert_wait_frame_done_token_mira(handle);
+					_cmdq_set_config_handle_dirty_mira(handle);
+					built_mode = primary_display_is_video_mode();
+				}
 				_cmdq_flush_config_handle_mira(handle, 0);
 			}
 
@@ -2527,6 +2642,62 @@ static int _wdma_fence_release_callback(unsigned long userdata)
 	return 0;
 }
 
+/*
+ * Decouple mirror: the external display can scan out the WDMA output buffer
+ * directly instead of user space posting it to the external session (and
+ * copying or scaling it there). The client gets the buffer when WDMA is done
+ * and returns 0 if it took the frame; it then owns the output fence and
+ * hands it back with primary_display_release_mirror_fence() once its path
+ * no longer reads the buffer.
+ */
+static PRIMARY_DISPLAY_MIRROR_CB mirror_client;
+
+int primary_display_register_mirror_client(PRIMARY_DISPLAY_MIRROR_CB cb)
+{
+	if (cb && mirror_client)
+		return -EBUSY;
+	mirror_client = cb;
+	return 0;
+}
+
+void primary_display_release_mirror_fence(unsigned int fence_idx)
+{
+	int layer = disp_sync_get_output_timeline_id();
+
+	mtkfb_release_fence(primary_session_id, layer, fence_idx);
+	MMProfileLogEx(ddp_mmp_get_events()->primary_wdma_fence_release, MMProfileFlagPulse, layer,
+		       fence_idx);
+}
+
+static int _mirror_client_take_frame(void)
+{
+	PRIMARY_DISPLAY_MIRROR_CB cb = ACCESS_ONCE(mirror_client);
+	disp_mem_output_config out;
+	uint32_t val;
+
+	if (!cb || primary_get_sess_mode() != DISP_SESSION_DECOUPLE_MIRROR_MODE)
+		return -1;
+
+	memset(&out, 0, sizeof(out));
+	cmdqBackupReadSlot(pgc->cur_config_fence, disp_sync_get_output_timeline_id(),
+			   &out.buff_idx);
+	cmdqBackupReadSlot(pgc->rdma_buff_info, 0, &val);
+	out.addr = val;
+	cmdqBackupReadSlot(pgc->rdma_buff_info, 1, &val);
+	out.pitch = val & ~(3 << 30);
+	out.security = val >> 30;
+	cmdqBackupReadSlot(pgc->rdma_buff_info, 2, &val);
+	out.fmt = val;
+	cmdqBackupReadSlot(pgc->rdma_buff_info, 3, &val);
+	out.w = val & 0xffff;
+	out.h = val >> 16;
+
+	if (!out.addr || !out.buff_idx)
+		return -1;
+
+	return cb(&out);
+}
+
 static int _Interface_fence_release_callback(unsigned long userdata)
 {
 	int layer = disp_sync_get_output_interface_timeline_id();
@@ -2713,7 +2884,9 @@ static int _ovl_wdma_fence_release_callback(unsigned long userdata)
 	int ret = 0;
 
 	ret = _ovl_fence_release_callback(userdata);
-	ret |= _wdma_fence_release_callback(userdata);
+	/* a mirror client that took the frame releases the wdma fence itself */
+	if (_mirror_client_take_frame() != 0)
+		ret |= _wdma_fence_release_callback(userdata);
 
 #ifdef UPDATE_RDMA_CONFIG_USING_CMDQ_CALLBACK
 	ret |= decouple_update_rdma_config();
@@ -2887,6 +3060,7 @@ static int _present_fence_release_worker_thread(void *data)
 		} else {
 			dpmgr_wait_event(pgc->dpmgr_handle, DISP_PATH_EVENT_IF_VSYNC);
 			/* dpmgr_wait_event(pgc->dpmgr_handle, DISP_PATH_EVENT_FRAME_DONE); */
+			dprec_frame_stage(gPresentFenceIndex, DPREC_FRAME_STAGE_VSYNC);
 		}
 
 		timeline_id = disp_sync_get_present_timeline_id();
@@ -2906,6 +3080,9 @@ static int _present_fence_release_worker_thread(void *data)
 				     disp_session_mode_spy(primary_session_id),
 				     DISP_SESSION_DEV(primary_session_id), timeline_id,
 				     gPresentFenceIndex);
+			/* a new frame reached the panel, keep an input boost alive */
+			input_boost_frame();
+			dprec_frame_release(gPresentFenceIndex);
 		}
 		MMProfileLogEx(ddp_mmp_get_events()->present_fence_release, MMProfileFlagPulse,
 			       gPresentFenceIndex, fence_increment);
@@ -2999,7 +3176,7 @@ int primary_display_init(char *lcm_name, unsigned int lcm_fps, int is_lcm_inited
 	init_cmdq_slots(&(pgc->ovl_config_time), 3, 0);
 	init_cmdq_slots(&(pgc->cur_config_fence), DISP_SESSION_TIMELINE_COUNT, 0);
 	init_cmdq_slots(&(pgc->subtractor_when_free), DISP_SESSION_TIMELINE_COUNT, 0);
-	init_cmdq_slots(&(pgc->rdma_buff_info), 3, 0);
+	init_cmdq_slots(&(pgc->rdma_buff_info), 4, 0);
 	init_cmdq_slots(&(pgc->ovl_status_info), 4, 0);
 
 	mutex_init(&(pgc->capture_lock));
@@ -3651,6 +3828,7 @@ int primary_display_resume(void)
 
 		data_config->fps = pgc->lcm_fps;
 		data_config->dst_dirty = 1;
+		primary_display_partial_reset(data_config);
 
 		/* disable all ovl layers to show black screen */
 		/* note that if WFD is connected, we may miss the black setting before the last suspend */
@@ -3678,6 +3856,7 @@ int primary_display_resume(void)
 
 	DISPDBG("[POWER]lcm resume[begin]\n");
 	disp_lcm_resume(pgc->plcm);
+	primary_display_dfps_reset();
 	DISPCHECK("[POWER]lcm resume[end]\n");
 
 	MMProfileLogEx(ddp_mmp_get_events()->primary_resume, MMProfileFlagPulse, 0, 4);
@@ -4224,6 +4403,169 @@ static int can_bypass_ovl(disp_ddp_path_config *data_config, int *bypass_layer_i
 	return 1;
 }
 
+/*
+ * Partial update for command mode panels.
+ *
+ * The dirty region of a frame is the union of the old and new rectangles of
+ * every layer whose buffer or geometry changed. It is widened to full panel
+ * width and aligned to PARTIAL_ROI_ALIGN lines, so only OVL clipping, the
+ * PQ/RDMA sizes and the DSI packet height/window change; if it still covers
+ * more than DISP_OPT_PARTIAL_UPDATE_THRESHOLD percent of the panel the frame
+ * is sent in full.
+ */
+#define PARTIAL_ROI_ALIGN 16
+
+/* set when panel GRAM may not hold the last frame, next frame goes full */
+static int primary_partial_force_full;
+
+static void _primary_partial_join(struct disp_rect *roi, OVL_CONFIG_STRUCT *layer)
+{
+	int right, bottom;
+
+	if (!layer->layer_en || !layer->dst_w || !layer->dst_h)
+		return;
+
+	if (!roi->width || !roi->height) {
+		roi->x = layer->dst_x;
+		roi->y = layer->dst_y;
+		roi->width = layer->dst_w;
+		roi->height = layer->dst_h;
+		return;
+	}
+
+	right = max_t(int, roi->x + roi->width, layer->dst_x + layer->dst_w);
+	bottom = max_t(int, roi->y + roi->height, layer->dst_y + layer->dst_h);
+	roi->x = min_t(int, roi->x, layer->dst_x);
+	roi->y = min_t(int, roi->y, layer->dst_y);
+	roi->width = right - roi->x;
+	roi->height = bottom - roi->y;
+}
+
+static int _primary_partial_layer_changed(OVL_CONFIG_STRUCT *old, OVL_CONFIG_STRUCT *new)
+{
+	if (old->layer_en != new->layer_en)
+		return 1;
+	if (!new->layer_en)
+		return 0;
+	/* without a fence index the buffer content may change under us */
+	if (new->source == OVL_LAYER_SOURCE_MEM && new->buff_idx == (unsigned int)-1)
+		return 1;
+
+	return old->addr != new->addr || old->buff_idx != new->buff_idx ||
+	    old->source != new->source || old->fmt != new->fmt ||
+	    old->src_x != new->src_x || old->src_y != new->src_y ||
+	    old->src_pitch != new->src_pitch ||
+	    old->dst_x != new->dst_x || old->dst_y != new->dst_y ||
+	    old->dst_w != new->dst_w || old->dst_h != new->dst_h ||
+	    old->keyEn != new->keyEn || old->key != new->key ||
+	    old->aen != new->aen || old->alpha != new->alpha ||
+	    old->sur_aen != new->sur_aen || old->src_alpha != new->src_alpha ||
+	    old->dst_alpha != new->dst_alpha || old->security != new->security;
+}
+
+static int _primary_partial_eligible(int bypass)
+{
+	LCM_PARAMS *lcm_param = disp_lcm_get_params(pgc->plcm);
+
+#if defined(CONFIG_MTK_LCM_PHYSICAL_ROTATION_HW) || defined(CONFIG_MTK_OD_SUPPORT)
+	/* roi would need mirroring / OD compares against a full frame */
+	return 0;
+#endif
+	if (!disp_helper_get_option(DISP_OPT_PARTIAL_UPDATE))
+		return 0;
+	if (primary_display_is_video_mode() || primary_display_is_decouple_mode() ||
+	    primary_display_is_mirror_mode())
+		return 0;
+	if (bypass || pgc->session_mode != DISP_SESSION_DIRECT_LINK_MODE)
+		return 0;
+	if (!lcm_param || lcm_param->type != LCM_TYPE_DSI || lcm_param->dsi.ufoe_enable)
+		return 0;
+	/* assert layer is drawn outside of frame config */
+	if (is_DAL_Enabled())
+		return 0;
+
+	return 1;
+}
+
+static void _primary_partial_set_roi(disp_ddp_path_config *data_config, struct disp_rect *roi)
+{
+	struct disp_rect *cur = &data_config->ovl_partial_roi;
+
+	if (cur->x == roi->x && cur->y == roi->y &&
+	    cur->width == roi->width && cur->height == roi->height &&
+	    data_config->dst_w == roi->width && data_config->dst_h == roi->height)
+		return;
+
+	DISPDBG("partial roi (%d,%d,%d,%d) -> (%d,%d,%d,%d)\n",
+		cur->x, cur->y, cur->width, cur->height,
+		roi->x, roi->y, roi->width, roi->height);
+
+	*cur = *roi;
+	data_config->dst_w = roi->width;
+	data_config->dst_h = roi->height;
+	data_config->dst_dirty = 1;
+	data_config->ovl_dirty = 1;
+	data_config->ovl_partial_dirty = 1;
+}
+
+/*
+ * Restore a full frame window on @data_config. Callers that reconfigure or
+ * restart the path outside of frame config (resume, idle exit, ESD, mode
+ * switch capture) call this before dpmgr_path_config().
+ */
+void primary_display_partial_reset(disp_ddp_path_config *data_config)
+{
+	struct disp_rect full;
+
+	primary_partial_force_full = 1;
+	if (!data_config->ovl_partial_roi.width || !data_config->ovl_partial_roi.height)
+		return;
+
+	full.x = 0;
+	full.y = 0;
+	full.width = disp_helper_get_option(DISP_OPT_FAKE_LCM_WIDTH);
+	full.height = disp_helper_get_option(DISP_OPT_FAKE_LCM_HEIGHT);
+	_primary_partial_set_roi(data_config, &full);
+}
+
+static void _primary_partial_update(disp_ddp_path_config *data_config, struct disp_rect *dirty,
+				    int bypass)
+{
+	int full_w = disp_helper_get_option(DISP_OPT_FAKE_LCM_WIDTH);
+	int full_h = disp_helper_get_option(DISP_OPT_FAKE_LCM_HEIGHT);
+	int threshold = disp_helper_get_option(DISP_OPT_PARTIAL_UPDATE_THRESHOLD);
+	struct disp_rect roi;
+	int top, bottom;
+
+	if (!_primary_partial_eligible(bypass) || primary_partial_force_full) {
+		primary_display_partial_reset(data_config);
+		primary_partial_force_full = 0;
+		return;
+	}
+
+	top = clamp(dirty->y, 0, full_h);
+	bottom = clamp(dirty->y + dirty->height, 0, full_h);
+	if (!dirty->width || !dirty->height || top >= bottom) {
+		/* nothing changed, still send one small band to keep the frame flowing */
+		top = 0;
+		bottom = PARTIAL_ROI_ALIGN;
+	}
+
+	top = round_down(top, PARTIAL_ROI_ALIGN);
+	bottom = min(round_up(bottom, PARTIAL_ROI_ALIGN), full_h);
+
+	roi.x = 0;
+	roi.y = top;
+	roi.width = full_w;
+	roi.height = bottom - top;
+	if (roi.height * 100 > full_h * threshold) {
+		roi.y = 0;
+		roi.height = full_h;
+	}
+
+	_primary_partial_set_roi(data_config, &roi);
+}
+
 static int _config_ovl_input(struct disp_frame_cfg_t *cfg,
 			     disp_path_handle disp_handle, cmdqRecHandle cmdq_handle)
 {
@@ -4232,6 +4574,8 @@ static int _config_ovl_input(struct disp_frame_cfg_t *cfg,
 	int max_layer_id_configed = 0;
 	int bypass, bypass_layer_id = 0;
 	int overlap_layers;
+	struct disp_rect dirty = { 0 };
+	OVL_CONFIG_STRUCT old_cfg;
 
 #ifdef DEBUG_OVL_CONFIG_TIME
 	cmdqRecBackupRegisterToSlot(cmdq_handle, pgc->ovl_config_time, 0, 0x10008028);
@@ -4252,7 +4596,12 @@ static int _config_ovl_input(struct disp_frame_cfg_t *cfg,
 		} else {
 			DISPMSG("set AEE layer %d\n", layer);
 		}
+		old_cfg = *ovl_cfg;
 		_convert_disp_input_to_ovl(ovl_cfg, input_cfg);
+		if (_primary_partial_layer_changed(&old_cfg, ovl_cfg)) {
+			_primary_partial_join(&dirty, &old_cfg);
+			_primary_partial_join(&dirty, ovl_cfg);
+		}
 
 		dprec_logger_start(DPREC_LOGGER_PRIMARY_CONFIG,
 				   ovl_cfg->layer | (ovl_cfg->layer_en << 16), ovl_cfg->addr);
@@ -4302,6 +4651,10 @@ static int _config_ovl_input(struct disp_frame_cfg_t *cfg,
 
 	/* check bypass ovl */
 	bypass = can_bypass_ovl(data_config, &bypass_layer_id);
+
+	/* before any mode switch, which expects a full frame window */
+	_primary_partial_update(data_config, &dirty, bypass);
+
 	if (bypass) {
 		/* switch to rdma mode */
 		if (pgc->session_mode == DISP_SESSION_DIRECT_LINK_MODE) {
@@ -4483,6 +4836,11 @@ int primary_display_frame_cfg(struct disp_frame_cfg_t *cfg)
 	int ret = 0;
 	disp_session_sync_info *session_info = disp_get_session_sync_info_for_debug(cfg->session_id);
 	dprec_logger_event *input_event, *output_event, *trigger_event;
+	/* frames are tracked by present fence, which is what releases them */
+	int track_frame = (cfg->present_fence_idx != (unsigned int)-1);
+
+	if (track_frame)
+		dprec_frame_begin(cfg->present_fence_idx);
 
 	if (session_info) {
 		input_event = &session_info->event_setinput;
@@ -4498,6 +4856,10 @@ int primary_display_frame_cfg(struct disp_frame_cfg_t *cfg)
 	dprec_start(input_event, cfg->overlap_layer_num, cfg->input_layer_num);
 	primary_frame_cfg_input(cfg);
 	dprec_done(input_event, 0, 0);
+	if (pgc->state != DISP_SLEPT)
+		_primary_dfps_check(pgc->cmdq_handle_config);
+	if (track_frame)
+		dprec_frame_stage(cfg->present_fence_idx, DPREC_FRAME_STAGE_INPUT);
 
 	if (cfg->output_en) {
 		dprec_start(output_event, cfg->output_cfg.buff_idx, 0);
@@ -4516,6 +4878,8 @@ int primary_display_frame_cfg(struct disp_frame_cfg_t *cfg)
 		primary_display_update_present_fence(cfg->present_fence_idx);
 
 	primary_display_trigger_nolock(0, NULL, 0);
+	if (track_frame)
+		dprec_frame_stage(cfg->present_fence_idx, DPREC_FRAME_STAGE_FLUSH);
 
 	dprec_done(trigger_event, 0, 0);
 
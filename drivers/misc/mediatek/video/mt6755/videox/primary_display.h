@@ -166,6 +166,7 @@ typedef struct _opt_backup {
 } OPT_BACKUP;
 
 typedef int (*PRIMARY_DISPLAY_CALLBACK) (unsigned int user_data);
+typedef int (*PRIMARY_DISPLAY_MIRROR_CB) (disp_mem_output_config *out);
 
 int primary_display_init(char *lcm_name, unsigned int lcm_fps, int is_lcm_inited);
 int primary_display_config(unsigned long pa, unsigned long mva);
@@ -209,6 +210,8 @@ void _cmdq_start_trigger_loop(void);
 void *primary_get_ovl2mem_handle(void);
 int primary_display_is_decouple_mode(void);
 int primary_display_is_mirror_mode(void);
+int primary_display_register_mirror_client(PRIMARY_DISPLAY_MIRROR_CB cb);
+void primary_display_release_mirror_fence(unsigned int fence_idx);
 unsigned int primary_display_get_option(const char *option);
 CMDQ_SWITCH primary_display_cmdq_enabled(void);
 int primary_display_switch_cmdq_cpu(CMDQ_SWITCH use_cmdq);
@@ -223,6 +226,8 @@ void primary_display_reset(void);
 void primary_display_esd_check_enable(int enable);
 int primary_display_config_input_multiple(disp_session_input_config *session_input);
 int primary_display_frame_cfg(struct disp_frame_cfg_t *cfg);
+void primary_display_partial_reset(disp_ddp_path_config *data_config);
+void primary_display_dfps_reset(void);
 int primary_display_force_set_vsync_fps(unsigned int fps);
 unsigned int primary_display_get_fps(void);
 unsigned int primary_display_get_fps_nolock(void);
@@ -23,6 +23,8 @@
 #include <linux/semaphore.h>
 #include <mt-plat/dma.h>
 #include <linux/delay.h>
+#include <linux/slab.h>
+#include <linux/list.h>
 #include "mt-plat/sync_write.h"
 
 #ifndef CONFIG_MTK_CLKMGR
@@ -122,6 +124,15 @@ static VAL_UINT32_T gLockTimeOutCount;
 
 static VAL_UINT32_T gu4VdecLockThreadId;
 
+/*
+ * Real-time instances (VCODEC_SET_INST_PRIO) waiting in VCODEC_LOCKHW. While
+ * any is pending a free HW lock is left for it; normal instances park on
+ * VcodecRTDrainWq until the count drops back to zero.
+ */
+static atomic_t gDecRTWaiters = ATOMIC_INIT(0);
+static atomic_t gEncRTWaiters = ATOMIC_INIT(0);
+static DECLARE_WAIT_QUEUE_HEAD(VcodecRTDrainWq);
+
 /* #define VCODEC_DEBUG */
 #ifdef VCODEC_DEBUG
 #undef VCODEC_DEBUG
@@ -512,10 +523,95 @@ static irqreturn_t video_intr_dlr2(int irq, void *dev_id)
 	return IRQ_HANDLED;
 }
 
+/*
+ * Non-cached working buffers are not returned to dma_free_coherent() when a
+ * session frees them but kept in NcBufPool, so the next session with the same
+ * profile gets them back without a CMA migration. The pool is bounded by
+ * ncbuf_pool_kb and drained by the shrinker under memory pressure.
+ */
+struct vcodec_ncbuf {
+	struct list_head list;
+	VAL_VOID_T *pvKva;
+	dma_addr_t rPa;
+	VAL_ULONG_T u4Size;
+};
+
+static unsigned int ncbuf_pool_kb = 16384;
+module_param(ncbuf_pool_kb, uint, S_IRUGO | S_IWUSR);
+
+static DEFINE_MUTEX(NcBufLock);
+static LIST_HEAD(NcBufInUse);			/* mutex : NcBufLock */
+static LIST_HEAD(NcBufPool);			/* mutex : NcBufLock */
+static VAL_ULONG_T gu4NcBufPoolBytes;		/* mutex : NcBufLock */
+
+/* reuse a pooled buffer of at least size bytes, at most 1/4 larger */
+static struct vcodec_ncbuf *vcodec_ncbuf_pool_get(VAL_ULONG_T u4Size)
+{
+	struct vcodec_ncbuf *buf, *best = NULL;
+
+	list_for_each_entry(buf, &NcBufPool, list) {
+		if (buf->u4Size < u4Size || buf->u4Size > u4Size + (u4Size >> 2))
+			continue;
+		if (!best || buf->u4Size < best->u4Size)
+			best = buf;
+		if (best->u4Size == u4Size)
+			break;
+	}
+	if (best) {
+		list_del(&best->list);
+		gu4NcBufPoolBytes -= best->u4Size;
+	}
+
+	return best;
+}
+
+static VAL_ULONG_T vcodec_ncbuf_pool_trim(VAL_ULONG_T u4Target)
+{
+	struct vcodec_ncbuf *buf;
+	VAL_ULONG_T u4Freed = 0;
+
+	while (gu4NcBufPoolBytes > u4Target && !list_empty(&NcBufPool)) {
+		/* oldest entries sit at the tail */
+		buf = list_last_entry(&NcBufPool, struct vcodec_ncbuf, list);
+		list_del(&buf->list);
+		gu4NcBufPoolBytes -= buf->u4Size;
+		u4Freed += buf->u4Size;
+		dma_free_coherent(0, buf->u4Size, buf->pvKva, buf->rPa);
+		kfree(buf);
+	}
+
+	return u4Freed;
+}
+
+static unsigned long vcodec_ncbuf_shrink_count(struct shrinker *s, struct shrink_control *sc)
+{
+	return gu4NcBufPoolBytes >> PAGE_SHIFT;
+}
+
+static unsigned long vcodec_ncbuf_shrink_scan(struct shrinker *s, struct shrink_control *sc)
+{
+	VAL_ULONG_T u4Want = sc->nr_to_scan << PAGE_SHIFT;
+	VAL_ULONG_T u4Freed;
+
+	if (!mutex_trylock(&NcBufLock))
+		return SHRINK_STOP;
+	u4Freed = vcodec_ncbuf_pool_trim(gu4NcBufPoolBytes > u4Want ? gu4NcBufPoolBytes - u4Want : 0);
+	mutex_unlock(&NcBufLock);
+
+	return u4Freed >> PAGE_SHIFT;
+}
+
+static struct shrinker vcodec_ncbuf_shrinker = {
+	.count_objects = vcodec_ncbuf_shrink_count,
+	.scan_objects = vcodec_ncbuf_shrink_scan,
+	.seeks = DEFAULT_SEEKS,
+};
+
 static long vcodec_alloc_non_cache_buffer(unsigned long arg)
 {
 	VAL_UINT8_T *user_data_addr;
 	VAL_MEMORY_T rTempMem;
+	struct vcodec_ncbuf *buf;
 	VAL_LONG_T ret;
 
 	MODULE_MFV_LOGE("VCODEC_ALLOC_NON_CACHE_BUFFER + tid = %d\n", current->pid);
@@ -527,12 +623,34 @@ static long vcodec_alloc_non_cache_buffer(unsigned long arg)
 		return -EFAULT;
 	}
 
-	rTempMem.u4ReservedSize /*kernel va*/ =
-		(VAL_ULONG_T)dma_alloc_coherent(0, rTempMem.u4MemSize, (dma_addr_t *)&rTempMem.pvMemPa, GFP_KERNEL);
-	if ((0 == rTempMem.u4ReservedSize) || (0 == rTempMem.pvMemPa)) {
-		MODULE_MFV_LOGE("[ERROR] dma_alloc_coherent fail in VCODEC_ALLOC_NON_CACHE_BUFFER\n");
-		return -EFAULT;
+	mutex_lock(&NcBufLock);
+	buf = vcodec_ncbuf_pool_get(PAGE_ALIGN(rTempMem.u4MemSize));
+	mutex_unlock(&NcBufLock);
+	if (buf) {
+		/* previous session's data must not leak into this one */
+		memset(buf->pvKva, 0, buf->u4Size);
+	} else {
+		buf = kzalloc(sizeof(*buf), GFP_KERNEL);
+		if (!buf) {
+			MODULE_MFV_LOGE("[ERROR] kzalloc fail in VCODEC_ALLOC_NON_CACHE_BUFFER\n");
+			return -ENOMEM;
+		}
+		buf->u4Size = PAGE_ALIGN(rTempMem.u4MemSize);
+		buf->pvKva = dma_alloc_coherent(0, buf->u4Size, &buf->rPa, GFP_KERNEL);
+		if ((NULL == buf->pvKva) || (0 == buf->rPa)) {
+			MODULE_MFV_LOGE("[ERROR] dma_alloc_coherent fail in VCODEC_ALLOC_NON_CACHE_BUFFER\n");
+			if (buf->pvKva)
+				dma_free_coherent(0, buf->u4Size, buf->pvKva, buf->rPa);
+			kfree(buf);
+			return -EFAULT;
+		}
 	}
+	mutex_lock(&NcBufLock);
+	list_add(&buf->list, &NcBufInUse);
+	mutex_unlock(&NcBufLock);
+
+	rTempMem.u4ReservedSize /*kernel va*/ = (VAL_ULONG_T)buf->pvKva;
+	rTempMem.pvMemPa = (VAL_VOID_T *)(VAL_ULONG_T)buf->rPa;
 
 	MODULE_MFV_LOGD("[VCODEC] kernel va = 0x%lx, kernel pa = 0x%lx, memory size = %lu\n",
 		 (VAL_ULONG_T)rTempMem.u4ReservedSize,
@@ -559,6 +677,7 @@ static long vcodec_free_non_cache_buffer(unsigned long arg)
 {
 	VAL_UINT8_T *user_data_addr;
 	VAL_MEMORY_T rTempMem;
+	struct vcodec_ncbuf *buf, *found = NULL;
 	VAL_LONG_T ret;
 
 	MODULE_MFV_LOGE("VCODEC_FREE_NON_CACHE_BUFFER + tid = %d\n", current->pid);
@@ -570,7 +689,25 @@ static long vcodec_free_non_cache_buffer(unsigned long arg)
 		return -EFAULT;
 	}
 
-	dma_free_coherent(0, rTempMem.u4MemSize, (void *)rTempMem.u4ReservedSize, (dma_addr_t)rTempMem.pvMemPa);
+	mutex_lock(&NcBufLock);
+	list_for_each_entry(buf, &NcBufInUse, list) {
+		if (buf->rPa == (dma_addr_t)(VAL_ULONG_T)rTempMem.pvMemPa &&
+		    buf->pvKva == (VAL_VOID_T *)rTempMem.u4ReservedSize) {
+			found = buf;
+			break;
+		}
+	}
+	if (!found) {
+		mutex_unlock(&NcBufLock);
+		MODULE_MFV_LOGE("[ERROR] VCODEC_FREE_NON_CACHE_BUFFER, unknown buffer pa 0x%lx\n",
+			 (VAL_ULONG_T)rTempMem.pvMemPa);
+		return -EFAULT;
+	}
+	list_del(&found->list);
+	list_add(&found->list, &NcBufPool);
+	gu4NcBufPoolBytes += found->u4Size;
+	vcodec_ncbuf_pool_trim((VAL_ULONG_T)ncbuf_pool_kb << 10);
+	mutex_unlock(&NcBufLock);
 
 	/* mutex_lock(&NonCacheMemoryListLock); */
 	/* Free_NonCacheMemoryList(rTempMem.u4ReservedSize, (VAL_UINT32_T)rTempMem.pvMemPa); */
@@ -650,7 +787,30 @@ static long vcodec_lockhw_enc_fail(VAL_HW_LOCK_T rHWLock, VAL_UINT32_T FirstUseE
 	return 0;
 }
 
-static long vcodec_lockhw(unsigned long arg)
+static VAL_BOOL_T vcodec_is_dec_type(VAL_DRIVER_TYPE_T eDriverType)
+{
+	return (eDriverType == VAL_DRIVER_TYPE_MP4_DEC ||
+		eDriverType == VAL_DRIVER_TYPE_HEVC_DEC ||
+		eDriverType == VAL_DRIVER_TYPE_H264_DEC ||
+		eDriverType == VAL_DRIVER_TYPE_MP1_MP2_DEC ||
+		eDriverType == VAL_DRIVER_TYPE_VC1_DEC ||
+		eDriverType == VAL_DRIVER_TYPE_VC1_ADV_DEC ||
+		eDriverType == VAL_DRIVER_TYPE_VP8_DEC) ? VAL_TRUE : VAL_FALSE;
+}
+
+/*
+ * A normal instance found the HW lock free while a real-time one is queued:
+ * pass the wakeup on so the real-time waiter sees it, then stay out of the
+ * way until no real-time waiter is left.
+ */
+static VAL_VOID_T vcodec_yield_to_rt(VAL_EVENT_T *prHWLockEvent, atomic_t *prRTWaiters)
+{
+	eVideoSetEvent(prHWLockEvent, sizeof(VAL_EVENT_T));
+	wait_event_interruptible_timeout(VcodecRTDrainWq, atomic_read(prRTWaiters) == 0,
+					 msecs_to_jiffies(1000));
+}
+
+static long vcodec_lockhw(unsigned long arg, VAL_BOOL_T bRealTime)
 {
 	VAL_UINT8_T *user_data_addr;
 	VAL_HW_LOCK_T rHWLock;
@@ -732,6 +892,11 @@ static long vcodec_lockhw(unsigned long arg)
 			}
 
 			mutex_lock(&VdecHWLock);
+			if (grVcodecDecHWLock.pvHandle == 0 && !bRealTime && atomic_read(&gDecRTWaiters) > 0) {
+				mutex_unlock(&VdecHWLock);
+				vcodec_yield_to_rt(&DecHWLockEvent, &gDecRTWaiters);
+				continue;
+			}
 			if (grVcodecDecHWLock.pvHandle == 0) { /* No one holds dec hw lock now */
 				gu4VdecLockThreadId = current->pid;
 				grVcodecDecHWLock.pvHandle =
@@ -851,6 +1016,12 @@ static long vcodec_lockhw(unsigned long arg)
 			}
 
 			mutex_lock(&VencHWLock);
+			if (grVcodecEncHWLock.pvHandle == 0 && !bRealTime && atomic_read(&gEncRTWaiters) > 0 &&
+			    rHWLock.u4TimeoutMs != 0) {
+				mutex_unlock(&VencHWLock);
+				vcodec_yield_to_rt(&EncHWLockEvent, &gEncRTWaiters);
+				continue;
+			}
 			if (grVcodecEncHWLock.pvHandle == 0) { /* No process use HW, so current process can use HW */
 				if (rHWLock.eDriverType == VAL_DRIVER_TYPE_H264_ENC ||
 				    rHWLock.eDriverType == VAL_DRIVER_TYPE_HEVC_ENC ||
@@ -955,22 +1126,34 @@ static long vcodec_lockhw(unsigned long arg)
 	return 0;
 }
 
-static long vcodec_unlockhw(unsigned long arg)
+static long vcodec_lockhw_prio(struct file *file, unsigned long arg)
 {
-	VAL_UINT8_T *user_data_addr;
 	VAL_HW_LOCK_T rHWLock;
-	VAL_RESULT_T eValRet;
+	atomic_t *prRTWaiters;
 	VAL_LONG_T ret;
 
-	MODULE_MFV_LOGD("VCODEC_UNLOCKHW + tid = %d\n", current->pid);
+	if ((VAL_ULONG_T)file->private_data != VCODEC_INST_PRIO_REALTIME)
+		return vcodec_lockhw(arg, VAL_FALSE);
 
-	user_data_addr = (VAL_UINT8_T *)arg;
-	ret = copy_from_user(&rHWLock, user_data_addr, sizeof(VAL_HW_LOCK_T));
+	ret = copy_from_user(&rHWLock, (VAL_UINT8_T *)arg, sizeof(VAL_HW_LOCK_T));
 	if (ret) {
-		MODULE_MFV_LOGE("[ERROR] VCODEC_UNLOCKHW, copy_from_user failed: %lu\n", ret);
+		MODULE_MFV_LOGE("[ERROR] VCODEC_LOCKHW, copy_from_user failed: %lu\n", ret);
 		return -EFAULT;
 	}
 
+	prRTWaiters = vcodec_is_dec_type(rHWLock.eDriverType) ? &gDecRTWaiters : &gEncRTWaiters;
+	atomic_inc(prRTWaiters);
+	ret = vcodec_lockhw(arg, VAL_TRUE);
+	if (atomic_dec_and_test(prRTWaiters))
+		wake_up_interruptible(&VcodecRTDrainWq);
+
+	return ret;
+}
+
+static long vcodec_unlockhw_inst(VAL_HW_LOCK_T rHWLock)
+{
+	VAL_RESULT_T eValRet;
+
 	MODULE_MFV_LOGD("VCODEC_UNLOCKHW eDriverType = %d\n", rHWLock.eDriverType);
 	eValRet = VAL_RESULT_INVALID_ISR;
 	if (rHWLock.eDriverType == VAL_DRIVER_TYPE_MP4_DEC ||
@@ -1036,6 +1219,28 @@ static long vcodec_unlockhw(unsigned long arg)
 		return -EFAULT;
 	}
 
+	return 0;
+}
+
+static long vcodec_unlockhw(unsigned long arg)
+{
+	VAL_UINT8_T *user_data_addr;
+	VAL_HW_LOCK_T rHWLock;
+	VAL_LONG_T ret;
+
+	MODULE_MFV_LOGD("VCODEC_UNLOCKHW + tid = %d\n", current->pid);
+
+	user_data_addr = (VAL_UINT8_T *)arg;
+	ret = copy_from_user(&rHWLock, user_data_addr, sizeof(VAL_HW_LOCK_T));
+	if (ret) {
+		MODULE_MFV_LOGE("[ERROR] VCODEC_UNLOCKHW, copy_from_user failed: %lu\n", ret);
+		return -EFAULT;
+	}
+
+	ret = vcodec_unlockhw_inst(rHWLock);
+	if (ret)
+		return ret;
+
 	MODULE_MFV_LOGD("VCODEC_UNLOCKHW - tid = %d\n", current->pid);
 
 	return 0;
@@ -1137,6 +1342,36 @@ static long vcodec_waitisr(unsigned long arg)
 	return 0;
 }
 
+/*
+ * VCODEC_WAITISR followed by VCODEC_UNLOCKHW in one call, so the next queued
+ * instance gets the HW as soon as the frame is done instead of after another
+ * round trip. On a wait failure the lock is kept for the caller to recover.
+ */
+static long vcodec_waitisr_unlockhw(unsigned long arg)
+{
+	VAL_ISR_T val_isr;
+	VAL_HW_LOCK_T rHWLock;
+	VAL_LONG_T ret;
+
+	ret = vcodec_waitisr(arg);
+	if (ret)
+		return ret;
+
+	ret = copy_from_user(&val_isr, (VAL_UINT8_T *)arg, sizeof(VAL_ISR_T));
+	if (ret) {
+		MODULE_MFV_LOGE("[ERROR] VCODEC_WAITISR_UNLOCKHW, copy_from_user failed: %lu\n", ret);
+		return -EFAULT;
+	}
+
+	memset(&rHWLock, 0, sizeof(VAL_HW_LOCK_T));
+	rHWLock.pvHandle = val_isr.pvHandle;
+	rHWLock.u4HandleSize = val_isr.u4HandleSize;
+	rHWLock.eDriverType = val_isr.eDriverType;
+	rHWLock.bSecureInst = VAL_FALSE;
+
+	return vcodec_unlockhw_inst(rHWLock);
+}
+
 static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 {
 	VAL_LONG_T ret;
@@ -1262,7 +1497,7 @@ static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned
 
 	case VCODEC_LOCKHW:
 	{
-		ret = vcodec_lockhw(arg);
+		ret = vcodec_lockhw_prio(file, arg);
 		if (ret) {
 			MODULE_MFV_LOGE("[ERROR] VCODEC_LOCKHW failed! %lu\n", ret);
 			return -EFAULT;
@@ -1356,6 +1591,35 @@ static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned
 	}
 	break;
 
+	case VCODEC_WAITISR_UNLOCKHW:
+	{
+		ret = vcodec_waitisr_unlockhw(arg);
+		if (ret) {
+			MODULE_MFV_LOGE("[ERROR] VCODEC_WAITISR_UNLOCKHW failed! %lu\n", ret);
+			return -EFAULT;
+		}
+	}
+	break;
+
+	case VCODEC_SET_INST_PRIO:
+	{
+		VAL_UINT32_T u4Prio;
+
+		user_data_addr = (VAL_UINT8_T *)arg;
+		ret = copy_from_user(&u4Prio, user_data_addr, sizeof(VAL_UINT32_T));
+		if (ret) {
+			MODULE_MFV_LOGE("[ERROR] VCODEC_SET_INST_PRIO, copy_from_user failed: %lu\n", ret);
+			return -EFAULT;
+		}
+		if (u4Prio != VCODEC_INST_PRIO_NORMAL && u4Prio != VCODEC_INST_PRIO_REALTIME) {
+			MODULE_MFV_LOGE("[ERROR] VCODEC_SET_INST_PRIO, invalid prio %u\n", u4Prio);
+			return -EINVAL;
+		}
+		file->private_data = (VAL_VOID_T *)(VAL_ULONG_T)u4Prio;
+		MODULE_MFV_LOGD("VCODEC_SET_INST_PRIO %u tid = %d\n", u4Prio, current->pid);
+	}
+	break;
+
 	case VCODEC_INITHWLOCK:
 	{
 		MODULE_MFV_LOGE("VCODEC_INITHWLOCK [EMPTY] + - tid = %d\n", current->pid);
@@ -1881,6 +2145,7 @@ static long vcodec_unlocked_compat_ioctl(struct file *file, unsigned int cmd, un
 	break;
 
 	case VCODEC_WAITISR:
+	case VCODEC_WAITISR_UNLOCKHW:
 	{
 		COMPAT_VAL_ISR_T __user *data32;
 		VAL_ISR_T __user *data;
@@ -1895,7 +2160,7 @@ static long vcodec_unlocked_compat_ioctl(struct file *file, unsigned int cmd, un
 		if (err)
 			return err;
 
-		ret = file->f_op->unlocked_ioctl(file, VCODEC_WAITISR, (unsigned long)data);
+		ret = file->f_op->unlocked_ioctl(file, cmd, (unsigned long)data);
 
 		err = compat_copy_struct(VAL_ISR_TYPE, COPY_TO_USER, (void *)data32, (void *)data);
 
@@ -2391,6 +2656,8 @@ static int __init vcodec_driver_init(void)
 		MODULE_MFV_LOGE("[VCODEC][ERROR] create enc isr event error\n");
 	}
 
+	register_shrinker(&vcodec_ncbuf_shrinker);
+
 	MODULE_MFV_LOGD("vcodec_driver_init Done\n");
 
 #ifdef CONFIG_MTK_HIBERNATION
@@ -2416,6 +2683,11 @@ static void __exit vcodec_driver_exit(void)
 	cdev_del(vcodec_cdev);
 	unregister_chrdev_region(vcodec_devno, 1);
 
+	unregister_shrinker(&vcodec_ncbuf_shrinker);
+	mutex_lock(&NcBufLock);
+	vcodec_ncbuf_pool_trim(0);
+	mutex_unlock(&NcBufLock);
+
 	/* [TODO] iounmap the following? */
 #if 0
 	iounmap((void *)KVA_VENC_IRQ_STATUS_ADDR);
@@ -40,6 +40,12 @@
 #define VCODEC_SET_CPU_OPP_LIMIT       _IOW(MFV_IOC_MAGIC, 0x32, unsigned int) /* VAL_VCODEC_CPU_OPP_LIMIT_T * */
 #define VCODEC_UNLOCKHW                _IOW(MFV_IOC_MAGIC, 0x33, unsigned int) /* VAL_HW_LOCK_T * */
 #define VCODEC_MB                      _IOW(MFV_IOC_MAGIC, 0x34, unsigned int) /* VAL_UINT32_T * */
+#define VCODEC_SET_INST_PRIO           _IOW(MFV_IOC_MAGIC, 0x35, unsigned int) /* VAL_UINT32_T * */
+#define VCODEC_WAITISR_UNLOCKHW        _IOW(MFV_IOC_MAGIC, 0x36, unsigned int) /* VAL_ISR_T * */
+
+/* VCODEC_SET_INST_PRIO values, kept per opened file */
+#define VCODEC_INST_PRIO_NORMAL        0
+#define VCODEC_INST_PRIO_REALTIME      1
 
 
 /* #define MFV_GET_CACHECTRLADDR_CMD  _IOR(MFV_IOC_MAGIC, 0x06, int) */
@@ -78,6 +78,8 @@ MODULE_ALIAS("mmc:block");
 #define INAND_CMD38_ARG_SECTRIM2 0x88
 #define MMC_BLK_TIMEOUT_MS  (10 * 60 * 1000)        /* 10 minute timeout */
 #define MMC_SANITIZE_REQ_TIMEOUT 240000
+/* largest read that io_poll lets the host complete by polling */
+#define MMC_BLK_POLL_MAX_BYTES	(16 * 1024)
 #define MMC_EXTRACT_INDEX_FROM_ARG(x) ((x & 0x00FF0000) >> 16)
 
 #define mmc_req_rel_wr(req)	(((req->cmd_flags & REQ_FUA) || \
@@ -136,6 +138,12 @@ struct mmc_blk_data {
 	unsigned int	part_curr;
 	struct device_attribute force_ro;
 	struct device_attribute power_ro_lock;
+	struct device_attribute io_poll_attr;
+	unsigned int	io_poll;	/* ask the host to poll small reads */
+	struct device_attribute flush_stats_attr;
+	unsigned long	flush_cnt;	/* cache flushes sent to the card */
+	u64		flush_us;
+	u32		flush_max_us;
 #ifdef MTK_BKOPS_IDLE_MAYA
 	struct device_attribute bkops_check_threshold;
 #endif
@@ -157,6 +165,53 @@ static inline int mmc_blk_part_switch(struct mmc_card *card,
 				      struct mmc_blk_data *md);
 static int get_card_status(struct mmc_card *card, u32 *status, int retries);
 
+#ifdef CONFIG_MMC_BLOCK_MQ
+/* a read the host was asked to poll for, see mmc_blk_rw_rq_prep() */
+static bool mmc_blk_polled_req(struct request *req)
+{
+	struct mmc_queue *mq = req->q->queuedata;
+	struct mmc_blk_data *md = mq->data;
+
+	return ACCESS_ONCE(md->io_poll) && rq_data_dir(req) == READ &&
+	       blk_rq_bytes(req) <= MMC_BLK_POLL_MAX_BYTES;
+}
+#endif
+
+/*
+ * With CONFIG_MMC_BLOCK_MQ the requests come from a blk-mq queue and are
+ * completed through blk-mq instead of the request_fn completion path.
+ * A whole request goes through blk_mq_complete_request(), so that its
+ * end_io work runs where rq_affinity says; polled reads are ended right
+ * here, by the thread that waited for them.
+ */
+static bool mmc_blk_end_request(struct request *req, int error,
+				unsigned int nr_bytes)
+{
+#ifdef CONFIG_MMC_BLOCK_MQ
+	if (nr_bytes >= blk_rq_bytes(req) && !mmc_blk_polled_req(req)) {
+		req->errors = error;
+		blk_mq_complete_request(req);
+		return false;
+	}
+
+	if (blk_update_request(req, error, nr_bytes))
+		return true;
+
+	__blk_mq_end_request(req, error);
+	return false;
+#else
+	return blk_end_request(req, error, nr_bytes);
+#endif
+}
+
+static void mmc_blk_end_request_all(struct request *req, int error)
+{
+	bool pending;
+
+	pending = mmc_blk_end_request(req, error, blk_rq_bytes(req));
+	BUG_ON(pending);
+}
+
 static inline void mmc_blk_clear_packed(struct mmc_queue_req *mqrq)
 {
 	struct mmc_packed *packed = mqrq->packed;
@@ -198,6 +253,9 @@ static void mmc_blk_put(struct mmc_blk_data *md)
 	if (md->usage == 0) {
 		int devidx = mmc_get_devidx(md->disk);
 		blk_cleanup_queue(md->queue.queue);
+#ifdef CONFIG_MMC_BLOCK_MQ
+		blk_mq_free_tag_set(&md->queue.tag_set);
+#endif
 
 		__clear_bit(devidx, dev_use);
 
@@ -305,6 +363,63 @@ out:
 	return ret;
 }
 
+static ssize_t io_poll_show(struct device *dev, struct device_attribute *attr,
+			    char *buf)
+{
+	int ret;
+	struct mmc_blk_data *md = mmc_blk_get(dev_to_disk(dev));
+
+	ret = snprintf(buf, PAGE_SIZE, "%u\n", ACCESS_ONCE(md->io_poll));
+	mmc_blk_put(md);
+	return ret;
+}
+
+/* "flushes total_us max_us elided", any write clears the card side */
+static ssize_t flush_stats_show(struct device *dev, struct device_attribute *attr,
+				char *buf)
+{
+	int ret;
+	struct mmc_blk_data *md = mmc_blk_get(dev_to_disk(dev));
+
+	ret = snprintf(buf, PAGE_SIZE, "%lu %llu %u %lu\n", md->flush_cnt,
+		       md->flush_us, md->flush_max_us,
+		       md->queue.queue->flush_elided);
+	mmc_blk_put(md);
+	return ret;
+}
+
+static ssize_t flush_stats_store(struct device *dev,
+				 struct device_attribute *attr,
+				 const char *buf, size_t count)
+{
+	struct mmc_blk_data *md = mmc_blk_get(dev_to_disk(dev));
+
+	md->flush_cnt = 0;
+	md->flush_us = 0;
+	md->flush_max_us = 0;
+	mmc_blk_put(md);
+	return count;
+}
+
+static ssize_t io_poll_store(struct device *dev, struct device_attribute *attr,
+			     const char *buf, size_t count)
+{
+	int ret;
+	char *end;
+	struct mmc_blk_data *md = mmc_blk_get(dev_to_disk(dev));
+	unsigned long set = simple_strtoul(buf, &end, 0);
+	if (end == buf) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ACCESS_ONCE(md->io_poll) = !!set;
+	ret = count;
+out:
+	mmc_blk_put(md);
+	return ret;
+}
+
 #ifdef MTK_BKOPS_IDLE_MAYA
 static ssize_t bkops_check_threshold_show(struct device *dev,
 				  struct device_attribute *attr, char *buf)
@@ -1300,7 +1415,7 @@ out:
 		goto retry;
 	if (!err)
 		mmc_blk_reset_success(md, type);
-	blk_end_request(req, err, blk_rq_bytes(req));
+	mmc_blk_end_request(req, err, blk_rq_bytes(req));
 
 	return err ? 0 : 1;
 }
@@ -1367,7 +1482,7 @@ out_retry:
 	if (!err)
 		mmc_blk_reset_success(md, type);
 out:
-	blk_end_request(req, err, blk_rq_bytes(req));
+	mmc_blk_end_request(req, err, blk_rq_bytes(req));
 
 	return err ? 0 : 1;
 }
@@ -1376,13 +1491,20 @@ static int mmc_blk_issue_flush(struct mmc_queue *mq, struct request *req)
 {
 	struct mmc_blk_data *md = mq->data;
 	struct mmc_card *card = md->queue.card;
+	ktime_t start = ktime_get();
+	u32 us;
 	int ret = 0;
 
 	ret = mmc_flush_cache(card);
 	if (ret)
 		ret = -EIO;
 
-	blk_end_request_all(req, ret);
+	us = ktime_us_delta(ktime_get(), start);
+	md->flush_cnt++;
+	md->flush_us += us;
+	md->flush_max_us = max(md->flush_max_us, us);
+
+	mmc_blk_end_request_all(req, ret);
 
 	return ret ? 0 : 1;
 }
@@ -1663,6 +1785,13 @@ static void mmc_blk_rw_rq_prep(struct mmc_queue_req *mqrq,
 	if (rq_data_dir(req) == READ) {
 		brq->cmd.opcode = readcmd;
 		brq->data.flags |= MMC_DATA_READ;
+		/*
+		 * Small reads are mostly page faults somebody is blocked on;
+		 * let the host spin for their completion instead of sleeping.
+		 */
+		if (ACCESS_ONCE(md->io_poll) &&
+		    blk_rq_bytes(req) <= MMC_BLK_POLL_MAX_BYTES)
+			brq->data.flags |= MMC_DATA_POLL;
 		if (brq->mrq.stop)
 			brq->stop.flags = MMC_RSP_SPI_R1 | MMC_RSP_R1 |
 					MMC_CMD_AC;
@@ -1974,11 +2103,11 @@ static int mmc_blk_cmd_err(struct mmc_blk_data *md, struct mmc_card *card,
 
 		blocks = mmc_sd_num_wr_blocks(card);
 		if (blocks != (u32)-1) {
-			ret = blk_end_request(req, 0, blocks << 9);
+			ret = mmc_blk_end_request(req, 0, blocks << 9);
 		}
 	} else {
 		if (!mmc_packed_cmd(mq_rq->cmd_type))
-			ret = blk_end_request(req, 0, brq->data.bytes_xfered);
+			ret = mmc_blk_end_request(req, 0, brq->data.bytes_xfered);
 	}
 	return ret;
 }
@@ -2007,7 +2136,7 @@ static int mmc_blk_end_packed_req(struct mmc_queue_req *mq_rq)
 			return ret;
 		}
 		list_del_init(&prq->queuelist);
-		blk_end_request(prq, 0, blk_rq_bytes(prq));
+		mmc_blk_end_request(prq, 0, blk_rq_bytes(prq));
 		i++;
 	}
 
@@ -2025,7 +2154,7 @@ static void mmc_blk_abort_packed_req(struct mmc_queue_req *mq_rq)
 	while (!list_empty(&packed->list)) {
 		prq = list_entry_rq(packed->list.next);
 		list_del_init(&prq->queuelist);
-		blk_end_request(prq, -EIO, blk_rq_bytes(prq));
+		mmc_blk_end_request(prq, -EIO, blk_rq_bytes(prq));
 	}
 
 	mmc_blk_clear_packed(mq_rq);
@@ -2544,7 +2673,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 				ret = mmc_blk_end_packed_req(mq_rq);
 				break;
 			} else {
-				ret = blk_end_request(req, 0,
+				ret = mmc_blk_end_request(req, 0,
 						brq->data.bytes_xfered);
 			}
 
@@ -2600,7 +2729,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 			 * time, so we only reach here after trying to
 			 * read a single sector.
 			 */
-			ret = blk_end_request(req, -EIO,
+			ret = mmc_blk_end_request(req, -EIO,
 						brq->data.blksz);
 			if (!ret)
 				goto start_new_req;
@@ -2643,7 +2772,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 		if (mmc_card_removed(card))
 			req->cmd_flags |= REQ_QUIET;
 		while (ret)
-			ret = blk_end_request(req, -EIO,
+			ret = mmc_blk_end_request(req, -EIO,
 					blk_rq_cur_bytes(req));
 	}
 
@@ -2651,7 +2780,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 	if (rqc) {
 		if (mmc_card_removed(card)) {
 			rqc->cmd_flags |= REQ_QUIET;
-			blk_end_request_all(rqc, -EIO);
+			mmc_blk_end_request_all(rqc, -EIO);
 		} else {
 			/*
 			 * If current request is packed, it needs to put back.
@@ -2694,7 +2823,7 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 	ret = mmc_blk_part_switch(card, md);
 	if (ret) {
 		if (req) {
-			blk_end_request_all(req, -EIO);
+			mmc_blk_end_request_all(req, -EIO);
 		}
 		ret = 0;
 		goto out;
@@ -2741,6 +2870,197 @@ out:
 	return ret;
 }
 
+#if defined(CONFIG_MMC_BLOCK_MQ) && defined(CONFIG_MTK_EMMC_CQ_SUPPORT)
+static int mmc_blk_cmdq_err_check(struct mmc_card *card,
+				  struct mmc_async_req *areq)
+{
+	struct mmc_queue_req *mq_mrq = container_of(areq, struct mmc_queue_req,
+						    mmc_active);
+	struct mmc_blk_request *brq = &mq_mrq->brq;
+	struct request *req = mq_mrq->req;
+
+	/*
+	 * Transfer errors are retried by the task queue threads of the core,
+	 * only the R1 status of the task and the amount of data are left.
+	 */
+	if (brq->cmd.resp[0] & CMD_ERRORS) {
+		pr_err("%s: task %d failed, status = %#x\n",
+		       req->rq_disk->disk_name, req->tag, brq->cmd.resp[0]);
+		return MMC_BLK_ABORT;
+	}
+
+	if (blk_rq_bytes(req) != brq->data.bytes_xfered)
+		return MMC_BLK_PARTIAL;
+
+	return MMC_BLK_SUCCESS;
+}
+
+/*
+ * Build the task for @mqrq: CMD44 (task parameters) and CMD45 (start
+ * address) go in mrq_que, CMD46/CMD47 and the data in mrq.
+ */
+static void mmc_blk_cmdq_rw_prep(struct mmc_queue_req *mqrq,
+				 struct mmc_card *card,
+				 struct mmc_queue *mq,
+				 unsigned int task_id)
+{
+	struct mmc_blk_request *brq = &mqrq->brq;
+	struct request *req = mqrq->req;
+	struct mmc_blk_data *md = mq->data;
+	bool read = rq_data_dir(req) == READ;
+	bool do_rel_wr = ((req->cmd_flags & REQ_FUA) ||
+			  (req->cmd_flags & REQ_META)) && !read &&
+		(md->flags & MMC_BLK_REL_WR);
+
+	memset(brq, 0, sizeof(struct mmc_blk_request));
+
+	brq->data.blksz = 512;
+	brq->data.blocks = blk_rq_sectors(req);
+	brq->data.flags = read ? MMC_DATA_READ : MMC_DATA_WRITE;
+	mmc_set_data_timeout(&brq->data, card);
+	brq->data.sg = mqrq->sg;
+	brq->data.sg_len = mmc_queue_map_sg(mq, mqrq);
+
+	brq->sbc.opcode = MMC_SET_QUEUE_CONTEXT;
+	brq->sbc.arg = brq->data.blocks | (task_id << 16) |
+		(read ? (1 << 30) : 0) |
+		(do_rel_wr ? (1 << 31) : 0);
+	brq->sbc.flags = MMC_RSP_R1 | MMC_CMD_AC;
+
+	brq->que.opcode = MMC_QUEUE_READ_ADDRESS;
+	brq->que.arg = blk_rq_pos(req);
+	if (!mmc_card_blockaddr(card))
+		brq->que.arg <<= 9;
+	brq->que.flags = MMC_RSP_R1 | MMC_CMD_AC;
+
+	brq->mrq_que.sbc = &brq->sbc;
+	brq->mrq_que.cmd = &brq->que;
+	brq->mrq_que.areq = &mqrq->mmc_active;
+
+	brq->cmd.opcode = read ? MMC_READ_REQUESTED_QUEUE :
+		MMC_WRITE_REQUESTED_QUEUE;
+	brq->cmd.arg = task_id << 16;
+	brq->cmd.flags = MMC_RSP_SPI_R1 | MMC_RSP_R1 | MMC_CMD_ADTC;
+
+	brq->mrq.cmd = &brq->cmd;
+	brq->mrq.data = &brq->data;
+	brq->mrq.areq = &mqrq->mmc_active;
+
+	mqrq->mmc_active.mrq = &brq->mrq;
+	mqrq->mmc_active.mrq_que = &brq->mrq_que;
+	mqrq->mmc_active.cmdq_en = true;
+	mqrq->mmc_active.err_check = mmc_blk_cmdq_err_check;
+
+	mmc_queue_bounce_pre(mqrq);
+}
+
+/*
+ * Called from blk-mq dispatch with mq->mq_lock held: put the request in
+ * the task queue of the card, using its blk-mq tag as task id. The task
+ * queue threads of the core take it from there.
+ */
+static int mmc_blk_cmdq_issue_rq(struct mmc_queue *mq, struct request *req)
+{
+	struct mmc_queue_req *mqrq = blk_mq_rq_to_pdu(req);
+	struct mmc_card *card = mq->card;
+	struct mmc_host *host = card->host;
+	unsigned int task_id = req->tag;
+
+	if ((blk_rq_sectors(req) & 0x07) &&
+	    (card->ext_csd.data_sector_size == 4096)) {
+		pr_err("%s: Transfer size is not 4KB sector size aligned\n",
+		       req->rq_disk->disk_name);
+		return -EINVAL;
+	}
+
+	BUG_ON(task_id >= card->ext_csd.cmdq_depth || host->areq_que[task_id]);
+
+	mqrq->req = req;
+	mmc_blk_cmdq_rw_prep(mqrq, card, mq, task_id);
+
+	host->areq_que[task_id] = &mqrq->mmc_active;
+	atomic_inc(&host->areq_cnt);
+
+	mmc_start_req(host, &mqrq->mmc_active, NULL);
+	if (mqrq->brq.que.error) {
+		/* not queued, the card is gone */
+		host->areq_que[task_id] = NULL;
+		if (atomic_dec_and_test(&host->areq_cnt))
+			wake_up(&mq->cmdq_wait);
+		return mqrq->brq.que.error;
+	}
+
+	return 0;
+}
+
+/*
+ * Completion of a task, called by the task queue data thread of the core
+ * once the transfer is done and err_check() has run.
+ */
+int mmc_blk_end_queued_req(struct mmc_host *host,
+	struct mmc_async_req *areq, int index, int status)
+{
+	struct mmc_queue_req *mq_rq = container_of(areq, struct mmc_queue_req,
+						   mmc_active);
+	struct request *req = mq_rq->req;
+	struct mmc_queue *mq = container_of(req->q->tag_set, struct mmc_queue,
+					    tag_set);
+	int err = 0;
+
+	mmc_queue_bounce_post(mq_rq);
+
+	if (status != MMC_BLK_SUCCESS) {
+		pr_err("%s: task %d ended with status %d, %u of %u bytes\n",
+		       req->rq_disk->disk_name, index, status,
+		       mq_rq->brq.data.bytes_xfered, blk_rq_bytes(req));
+		err = -EIO;
+	}
+
+	host->areq_que[index] = NULL;
+	req->errors = err;
+	blk_mq_complete_request(req);
+
+	mq->cmdq_stamp = jiffies;
+	if (atomic_dec_and_test(&host->areq_cnt)) {
+		wake_up(&mq->cmdq_wait);
+		wake_up_process(mq->thread);
+	}
+
+	return 0;
+}
+
+/* mmcqd claims the host and selects the area on behalf of the tasks */
+static int mmc_blk_cmdq_claim(struct mmc_queue *mq)
+{
+	struct mmc_blk_data *md = mq->data;
+	struct mmc_card *card = mq->card;
+	int err;
+
+	mmc_get_card(card);
+#ifdef MTK_BKOPS_IDLE_MAYA
+	if (card->ext_csd.bkops_en)
+		mmc_stop_bkops(card);
+#endif
+
+	err = mmc_blk_part_switch(card, md);
+	if (err)
+		mmc_put_card(card);
+
+	return err;
+}
+
+static void mmc_blk_cmdq_release(struct mmc_queue *mq)
+{
+	struct mmc_card *card = mq->card;
+
+	mmc_put_card(card);
+#ifdef MTK_BKOPS_IDLE_MAYA
+	if (mmc_card_need_bkops(card))
+		mmc_start_bkops(card, false);
+#endif
+}
+#endif
+
 static inline int mmc_blk_readonly(struct mmc_card *card)
 {
 	return mmc_card_readonly(card) ||
@@ -2832,6 +3152,15 @@ static struct mmc_blk_data *mmc_blk_alloc_req(struct mmc_card *card,
 
 	md->queue.issue_fn = mmc_blk_issue_rq;
 	md->queue.data = md;
+#if defined(CONFIG_MMC_BLOCK_MQ) && defined(CONFIG_MTK_EMMC_CQ_SUPPORT)
+	if (card->ext_csd.cmdq_support &&
+	    area_type == MMC_BLK_DATA_AREA_MAIN &&
+	    !md->queue.mqrq[0].bounce_buf) {
+		md->queue.cmdq_issue_fn = mmc_blk_cmdq_issue_rq;
+		md->queue.cmdq_claim_fn = mmc_blk_cmdq_claim;
+		md->queue.cmdq_release_fn = mmc_blk_cmdq_release;
+	}
+#endif
 
 	md->disk->major	= MMC_BLOCK_MAJOR;
 	md->disk->first_minor = devidx * perdev_minors;
@@ -2884,8 +3213,13 @@ static struct mmc_blk_data *mmc_blk_alloc_req(struct mmc_card *card,
 	     card->ext_csd.rel_sectors)) {
 		md->flags |= MMC_BLK_REL_WR;
 		blk_queue_flush(md->queue.queue, REQ_FLUSH | REQ_FUA);
+	} else if (mmc_card_mmc(card) && card->ext_csd.cache_size > 0) {
+		/* no FUA without reliable write, but the cache still needs flushes */
+		blk_queue_flush(md->queue.queue, REQ_FLUSH);
 	}
 
+#ifndef CONFIG_MMC_BLOCK_MQ
+	/* packing pulls the following requests with blk_fetch_request() */
 	if (mmc_card_mmc(card) &&
 	    (area_type == MMC_BLK_DATA_AREA_MAIN) &&
 	    (md->flags & MMC_BLK_CMD23) &&
@@ -2893,6 +3227,7 @@ static struct mmc_blk_data *mmc_blk_alloc_req(struct mmc_card *card,
 		if (!mmc_packed_init(&md->queue, card))
 			md->flags |= MMC_BLK_PACKED_CMD;
 	}
+#endif
 
 	return md;
 
@@ -2999,6 +3334,10 @@ static void mmc_blk_remove_req(struct mmc_blk_data *md)
 			mmc_packed_clean(&md->queue);
 		if (md->disk->flags & GENHD_FL_UP) {
 			device_remove_file(disk_to_dev(md->disk), &md->force_ro);
+			device_remove_file(disk_to_dev(md->disk),
+					   &md->io_poll_attr);
+			device_remove_file(disk_to_dev(md->disk),
+					   &md->flush_stats_attr);
 			if ((md->area_type & MMC_BLK_DATA_AREA_BOOT) &&
 					card->ext_csd.boot_ro_lockable)
 				device_remove_file(disk_to_dev(md->disk),
@@ -3039,6 +3378,24 @@ static int mmc_add_disk(struct mmc_blk_data *md)
 	if (ret)
 		goto force_ro_fail;
 
+	md->io_poll_attr.show = io_poll_show;
+	md->io_poll_attr.store = io_poll_store;
+	sysfs_attr_init(&md->io_poll_attr.attr);
+	md->io_poll_attr.attr.name = "io_poll";
+	md->io_poll_attr.attr.mode = S_IRUGO | S_IWUSR;
+	ret = device_create_file(disk_to_dev(md->disk), &md->io_poll_attr);
+	if (ret)
+		goto io_poll_fail;
+
+	md->flush_stats_attr.show = flush_stats_show;
+	md->flush_stats_attr.store = flush_stats_store;
+	sysfs_attr_init(&md->flush_stats_attr.attr);
+	md->flush_stats_attr.attr.name = "flush_stats";
+	md->flush_stats_attr.attr.mode = S_IRUGO | S_IWUSR;
+	ret = device_create_file(disk_to_dev(md->disk), &md->flush_stats_attr);
+	if (ret)
+		goto flush_stats_fail;
+
 	if ((md->area_type & MMC_BLK_DATA_AREA_BOOT) &&
 	     card->ext_csd.boot_ro_lockable) {
 		umode_t mode;
@@ -3077,6 +3434,10 @@ bkops_check_threshold_fails:
 	device_remove_file(disk_to_dev(md->disk), &md->power_ro_lock);
 #endif
 power_ro_lock_fail:
+	device_remove_file(disk_to_dev(md->disk), &md->flush_stats_attr);
+flush_stats_fail:
+	device_remove_file(disk_to_dev(md->disk), &md->io_poll_attr);
+io_poll_fail:
 	device_remove_file(disk_to_dev(md->disk), &md->force_ro);
 force_ro_fail:
 	del_gendisk(md->disk);
@@ -46,10 +46,152 @@ static int mmc_prep_request(struct request_queue *q, struct request *req)
 	return BLKPREP_OK;
 }
 
+#ifdef CONFIG_MMC_BLOCK_MQ
+/* keep the host claimed this long once the task queue has drained */
+#define MMC_CMDQ_LINGER		msecs_to_jiffies(5)
+
+static inline int mmc_queue_cmdq_tasks(struct mmc_queue *mq)
+{
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	return atomic_read(&mq->card->host->areq_cnt);
+#else
+	return 0;
+#endif
+}
+
+static struct request *mmc_queue_fetch_request(struct mmc_queue *mq)
+{
+	struct request *req;
+
+	spin_lock_irq(&mq->mq_lock);
+	set_current_state(TASK_INTERRUPTIBLE);
+	req = list_first_entry_or_null(&mq->mq_list, struct request,
+				       queuelist);
+	if (req)
+		list_del_init(&req->queuelist);
+	mq->mqrq_cur->req = req;
+	spin_unlock_irq(&mq->mq_lock);
+
+	return req;
+}
+
+/*
+ * Claim the host for the task queue once dispatch asked for it, and hand
+ * it back when the task queue has been idle for MMC_CMDQ_LINGER or when
+ * somebody else waits for the host. Returns true if it did either.
+ */
+static bool mmc_queue_cmdq_work(struct mmc_queue *mq)
+{
+	struct mmc_host *host = mq->card->host;
+	bool claim = false, release = false;
+
+	if (!mq->cmdq_claim_fn)
+		return false;
+
+	spin_lock_irq(&mq->mq_lock);
+	if (!mq->cmdq_owned) {
+		claim = mq->cmdq_wanted;
+	} else if (!mmc_queue_cmdq_tasks(mq) &&
+		   (waitqueue_active(&host->wq) ||
+		    time_after_eq(jiffies, mq->cmdq_stamp + MMC_CMDQ_LINGER))) {
+		mq->cmdq_owned = false;
+		release = true;
+	}
+	spin_unlock_irq(&mq->mq_lock);
+
+	if (!claim && !release)
+		return false;
+
+	set_current_state(TASK_RUNNING);
+	if (release) {
+		mq->cmdq_release_fn(mq);
+		return true;
+	}
+
+	if (mq->cmdq_claim_fn(mq)) {
+		pr_err("%s: cannot claim host for command queue, using mmcqd\n",
+		       mmc_card_name(mq->card));
+		mq->flags |= MMC_QUEUE_CMDQ_OFF;
+		claim = false;
+	}
+
+	spin_lock_irq(&mq->mq_lock);
+	mq->cmdq_owned = claim;
+	mq->cmdq_wanted = false;
+	mq->cmdq_stamp = jiffies;
+	spin_unlock_irq(&mq->mq_lock);
+
+	blk_mq_start_stopped_hw_queues(mq->queue, true);
+	return true;
+}
+
+static long mmc_queue_cmdq_linger(struct mmc_queue *mq)
+{
+	if (mq->cmdq_owned && !mmc_queue_cmdq_tasks(mq))
+		return MMC_CMDQ_LINGER;
+
+	return MAX_SCHEDULE_TIMEOUT;
+}
+
+/* dispatch may have backed off while mmcqd was busy */
+static void mmc_queue_cmdq_restart(struct mmc_queue *mq)
+{
+	if (mq->cmdq_issue_fn && !(mq->flags & MMC_QUEUE_SUSPENDED))
+		blk_mq_start_stopped_hw_queues(mq->queue, true);
+}
+
+/*
+ * Stop task dispatch, wait for the outstanding tasks and give the host
+ * back. Called with thread_sem held, so mmcqd is not running.
+ */
+static void mmc_queue_cmdq_drain(struct mmc_queue *mq)
+{
+	bool owned;
+
+	if (!mq->cmdq_claim_fn)
+		return;
+
+	spin_lock_irq(&mq->mq_lock);
+	owned = mq->cmdq_owned;
+	mq->cmdq_owned = false;
+	spin_unlock_irq(&mq->mq_lock);
+
+	wait_event(mq->cmdq_wait, !mmc_queue_cmdq_tasks(mq));
+	if (owned)
+		mq->cmdq_release_fn(mq);
+}
+#else
+static struct request *mmc_queue_fetch_request(struct mmc_queue *mq)
+{
+	struct request_queue *q = mq->queue;
+	struct request *req;
+
+	spin_lock_irq(q->queue_lock);
+	set_current_state(TASK_INTERRUPTIBLE);
+	req = blk_fetch_request(q);
+	mq->mqrq_cur->req = req;
+	spin_unlock_irq(q->queue_lock);
+
+	return req;
+}
+
+static inline bool mmc_queue_cmdq_work(struct mmc_queue *mq)
+{
+	return false;
+}
+
+static inline long mmc_queue_cmdq_linger(struct mmc_queue *mq)
+{
+	return MAX_SCHEDULE_TIMEOUT;
+}
+
+static inline void mmc_queue_cmdq_restart(struct mmc_queue *mq) { }
+static inline void mmc_queue_cmdq_drain(struct mmc_queue *mq) { }
+#endif
+
 static int mmc_queue_thread(void *d)
 {
 	struct mmc_queue *mq = d;
-	struct request_queue *q = mq->queue;
 #ifdef MTK_BKOPS_IDLE_MAYA
 	struct mmc_card *card = mq->card;
 #endif
@@ -62,11 +204,7 @@ static int mmc_queue_thread(void *d)
 		struct mmc_queue_req *tmp;
 		unsigned int cmd_flags = 0;
 
-		spin_lock_irq(q->queue_lock);
-		set_current_state(TASK_INTERRUPTIBLE);
-		req = blk_fetch_request(q);
-		mq->mqrq_cur->req = req;
-		spin_unlock_irq(q->queue_lock);
+		req = mmc_queue_fetch_request(mq);
 
 		if (req || mq->mqrq_prev->req) {
 			set_current_state(TASK_RUNNING);
@@ -92,46 +230,37 @@ static int mmc_queue_thread(void *d)
 			tmp = mq->mqrq_prev;
 			mq->mqrq_prev = mq->mqrq_cur;
 			mq->mqrq_cur = tmp;
+			mmc_queue_cmdq_restart(mq);
 		} else {
 			if (kthread_should_stop()) {
 				set_current_state(TASK_RUNNING);
 				break;
 			}
+			if (mmc_queue_cmdq_work(mq))
+				continue;
 #ifdef MTK_BKOPS_IDLE_MAYA
 			mmc_start_delayed_bkops(card);
 #endif
 			up(&mq->thread_sem);
-			schedule();
+			schedule_timeout(mmc_queue_cmdq_linger(mq));
 			down(&mq->thread_sem);
 		}
 	} while (1);
+	mmc_queue_cmdq_drain(mq);
 	up(&mq->thread_sem);
 
 	return 0;
 }
 
 /*
- * Generic MMC request handler.  This is called for any queue on a
- * particular host.  When the host is not busy, we look for a request
- * on any queue on this host, and attempt to issue it.  This may
- * not be the queue we were asked to process.
+ * Let mmcqd know a new request is queued: wake it up, or stop it waiting
+ * for the previous request to complete.
  */
-static void mmc_request_fn(struct request_queue *q)
+static void mmc_queue_kick(struct mmc_queue *mq)
 {
-	struct mmc_queue *mq = q->queuedata;
-	struct request *req;
+	struct mmc_context_info *cntx = &mq->card->host->context_info;
 	unsigned long flags;
-	struct mmc_context_info *cntx;
-
-	if (!mq) {
-		while ((req = blk_fetch_request(q)) != NULL) {
-			req->cmd_flags |= REQ_QUIET;
-			__blk_end_request_all(req, -EIO);
-		}
-		return;
-	}
 
-	cntx = &mq->card->host->context_info;
 	if (!mq->mqrq_cur->req && mq->mqrq_prev->req) {
 		/*
 		 * New MMC request arrived when MMC thread may be
@@ -148,6 +277,30 @@ static void mmc_request_fn(struct request_queue *q)
 		wake_up_process(mq->thread);
 }
 
+#ifndef CONFIG_MMC_BLOCK_MQ
+/*
+ * Generic MMC request handler.  This is called for any queue on a
+ * particular host.  When the host is not busy, we look for a request
+ * on any queue on this host, and attempt to issue it.  This may
+ * not be the queue we were asked to process.
+ */
+static void mmc_request_fn(struct request_queue *q)
+{
+	struct mmc_queue *mq = q->queuedata;
+	struct request *req;
+
+	if (!mq) {
+		while ((req = blk_fetch_request(q)) != NULL) {
+			req->cmd_flags |= REQ_QUIET;
+			__blk_end_request_all(req, -EIO);
+		}
+		return;
+	}
+
+	mmc_queue_kick(mq);
+}
+#endif
+
 static struct scatterlist *mmc_alloc_sg(int sg_len, int *err)
 {
 	struct scatterlist *sg;
@@ -163,6 +316,184 @@ static struct scatterlist *mmc_alloc_sg(int sg_len, int *err)
 	return sg;
 }
 
+#ifdef CONFIG_MMC_BLOCK_MQ
+#define MMC_QUEUE_MQ_DEPTH	2	/* mqrq_cur and mqrq_prev */
+
+static bool mmc_queue_cmdq_rq(struct mmc_queue *mq, struct request *req)
+{
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	return mq->cmdq_issue_fn && mq->card->ext_csd.cmdq_mode_en &&
+		!(mq->flags & MMC_QUEUE_CMDQ_OFF) &&
+		!(req->cmd_flags & MMC_REQ_SPECIAL_MASK);
+#else
+	return false;
+#endif
+}
+
+/*
+ * blk-mq dispatch. R/w requests of a command queue capable area are put in
+ * the task queue of the card right here, with the blk-mq tag as task id;
+ * everything else is handed to mmcqd.
+ */
+static int mmc_queue_rq(struct blk_mq_hw_ctx *hctx, struct request *req,
+			bool last)
+{
+	struct mmc_queue *mq = req->q->queuedata;
+	unsigned long flags;
+	int ret;
+
+	if (!mq) {
+		req->cmd_flags |= REQ_QUIET;
+		return BLK_MQ_RQ_QUEUE_ERROR;
+	}
+
+	if (mmc_prep_request(req->q, req) != BLKPREP_OK)
+		return BLK_MQ_RQ_QUEUE_ERROR;
+
+	if (!mmc_queue_cmdq_rq(mq, req)) {
+		blk_mq_start_request(req);
+		spin_lock_irqsave(&mq->mq_lock, flags);
+		list_add_tail(&req->queuelist, &mq->mq_list);
+		mmc_queue_kick(mq);
+		spin_unlock_irqrestore(&mq->mq_lock, flags);
+		return BLK_MQ_RQ_QUEUE_OK;
+	}
+
+	spin_lock_irqsave(&mq->mq_lock, flags);
+	if (!mq->cmdq_owned || !list_empty(&mq->mq_list) ||
+	    mq->mqrq_cur->req || mq->mqrq_prev->req ||
+	    waitqueue_active(&mq->card->host->wq)) {
+		/*
+		 * mmcqd has to claim the host first, finish the requests
+		 * ahead of this one or hand the host over to whoever waits
+		 * for it. It restarts the queue once that is done.
+		 */
+		mq->cmdq_wanted = true;
+		blk_mq_stop_hw_queue(hctx);
+		spin_unlock_irqrestore(&mq->mq_lock, flags);
+		wake_up_process(mq->thread);
+		return BLK_MQ_RQ_QUEUE_BUSY;
+	}
+
+	blk_mq_start_request(req);
+	ret = mq->cmdq_issue_fn(mq, req);
+	mq->cmdq_wanted = false;
+	mq->cmdq_stamp = jiffies;
+	spin_unlock_irqrestore(&mq->mq_lock, flags);
+
+	return ret ? BLK_MQ_RQ_QUEUE_ERROR : BLK_MQ_RQ_QUEUE_OK;
+}
+
+static int mmc_init_request(void *data, struct request *req,
+			    unsigned int hctx_idx, unsigned int request_idx,
+			    unsigned int numa_node)
+{
+	struct mmc_queue *mq = data;
+	struct mmc_queue_req *mqrq = blk_mq_rq_to_pdu(req);
+	int ret;
+
+	memset(mqrq, 0, sizeof(*mqrq));
+	mqrq->sg = mmc_alloc_sg(mq->card->host->max_segs, &ret);
+
+	return ret;
+}
+
+static void mmc_exit_request(void *data, struct request *req,
+			     unsigned int hctx_idx, unsigned int request_idx)
+{
+	struct mmc_queue_req *mqrq = blk_mq_rq_to_pdu(req);
+
+	kfree(mqrq->sg);
+	mqrq->sg = NULL;
+}
+
+/* end_io work of a request, run on the cpu rq_affinity picked */
+static void mmc_mq_complete(struct request *req)
+{
+	blk_mq_end_request(req, req->errors);
+}
+
+static struct blk_mq_ops mmc_mq_ops = {
+	.queue_rq	= mmc_queue_rq,
+	.map_queue	= blk_mq_map_queue,
+	.complete	= mmc_mq_complete,
+	.init_request	= mmc_init_request,
+	.exit_request	= mmc_exit_request,
+};
+
+static unsigned int mmc_queue_depth(struct mmc_card *card)
+{
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	if (card->ext_csd.cmdq_support && card->ext_csd.cmdq_depth)
+		return min_t(unsigned int, card->ext_csd.cmdq_depth,
+			     EMMC_MAX_QUEUE_DEPTH);
+#endif
+	return MMC_QUEUE_MQ_DEPTH;
+}
+
+static int mmc_mq_init_queue(struct mmc_queue *mq, struct mmc_card *card)
+{
+	struct blk_mq_tag_set *set = &mq->tag_set;
+	struct request_queue *q;
+	int ret;
+
+	spin_lock_init(&mq->mq_lock);
+	INIT_LIST_HEAD(&mq->mq_list);
+	init_waitqueue_head(&mq->cmdq_wait);
+
+	memset(set, 0, sizeof(*set));
+	set->ops = &mmc_mq_ops;
+	set->nr_hw_queues = 1;
+	set->queue_depth = mmc_queue_depth(card);
+	set->cmd_size = sizeof(struct mmc_queue_req);
+	set->numa_node = NUMA_NO_NODE;
+	set->flags = BLK_MQ_F_SHOULD_MERGE | BLK_MQ_F_SG_MERGE;
+	set->driver_data = mq;
+
+	ret = blk_mq_alloc_tag_set(set);
+	if (ret)
+		return ret;
+
+	q = blk_mq_init_queue(set);
+	if (IS_ERR(q)) {
+		blk_mq_free_tag_set(set);
+		return PTR_ERR(q);
+	}
+
+	/* rq_affinity 3: end requests in the submitter's cluster */
+	queue_flag_set_unlocked(QUEUE_FLAG_SAME_CLUSTER, q);
+
+	mq->queue = q;
+	return 0;
+}
+#endif
+
+static void mmc_queue_stop(struct request_queue *q)
+{
+#ifdef CONFIG_MMC_BLOCK_MQ
+	blk_mq_stop_hw_queues(q);
+#else
+	unsigned long flags;
+
+	spin_lock_irqsave(q->queue_lock, flags);
+	blk_stop_queue(q);
+	spin_unlock_irqrestore(q->queue_lock, flags);
+#endif
+}
+
+static void mmc_queue_start(struct request_queue *q)
+{
+#ifdef CONFIG_MMC_BLOCK_MQ
+	blk_mq_start_stopped_hw_queues(q, true);
+#else
+	unsigned long flags;
+
+	spin_lock_irqsave(q->queue_lock, flags);
+	blk_start_queue(q);
+	spin_unlock_irqrestore(q->queue_lock, flags);
+#endif
+}
+
 static void mmc_queue_setup_discard(struct request_queue *q,
 				    struct mmc_card *card)
 {
@@ -206,15 +537,23 @@ int mmc_init_queue(struct mmc_queue *mq, struct mmc_card *card,
 		limit = (u64)dma_max_pfn(mmc_dev(host)) << PAGE_SHIFT;
 
 	mq->card = card;
+#ifdef CONFIG_MMC_BLOCK_MQ
+	ret = mmc_mq_init_queue(mq, card);
+	if (ret)
+		return ret;
+#else
 	mq->queue = blk_init_queue(mmc_request_fn, lock);
 	if (!mq->queue)
 		return -ENOMEM;
+#endif
 
 	mq->mqrq_cur = mqrq_cur;
 	mq->mqrq_prev = mqrq_prev;
 	mq->queue->queuedata = mq;
 
+#ifndef CONFIG_MMC_BLOCK_MQ
 	blk_queue_prep_rq(mq->queue, mmc_prep_request);
+#endif
 	queue_flag_set_unlocked(QUEUE_FLAG_NONROT, mq->queue);
 	queue_flag_clear_unlocked(QUEUE_FLAG_ADD_RANDOM, mq->queue);
 	if (mmc_can_erase(card))
@@ -321,6 +660,9 @@ int mmc_init_queue(struct mmc_queue *mq, struct mmc_card *card,
 	mqrq_prev->bounce_buf = NULL;
 
 	blk_cleanup_queue(mq->queue);
+#ifdef CONFIG_MMC_BLOCK_MQ
+	blk_mq_free_tag_set(&mq->tag_set);
+#endif
 	return ret;
 }
 
@@ -330,6 +672,10 @@ void mmc_cleanup_queue(struct mmc_queue *mq)
 	unsigned long flags;
 	struct mmc_queue_req *mqrq_cur = mq->mqrq_cur;
 	struct mmc_queue_req *mqrq_prev = mq->mqrq_prev;
+#ifdef CONFIG_MMC_BLOCK_MQ
+	struct request *req;
+	LIST_HEAD(list);
+#endif
 
 	/* Make sure the queue isn't suspended, as that will deadlock */
 	mmc_queue_resume(mq);
@@ -338,10 +684,25 @@ void mmc_cleanup_queue(struct mmc_queue *mq)
 	kthread_stop(mq->thread);
 
 	/* Empty the queue */
+#ifdef CONFIG_MMC_BLOCK_MQ
+	spin_lock_irqsave(&mq->mq_lock, flags);
+	q->queuedata = NULL;
+	list_splice_init(&mq->mq_list, &list);
+	spin_unlock_irqrestore(&mq->mq_lock, flags);
+
+	while (!list_empty(&list)) {
+		req = list_first_entry(&list, struct request, queuelist);
+		list_del_init(&req->queuelist);
+		req->cmd_flags |= REQ_QUIET;
+		blk_mq_end_request(req, -EIO);
+	}
+	blk_mq_start_stopped_hw_queues(q, true);
+#else
 	spin_lock_irqsave(q->queue_lock, flags);
 	q->queuedata = NULL;
 	blk_start_queue(q);
 	spin_unlock_irqrestore(q->queue_lock, flags);
+#endif
 
 	kfree(mqrq_cur->bounce_sg);
 	mqrq_cur->bounce_sg = NULL;
@@ -418,17 +779,13 @@ void mmc_packed_clean(struct mmc_queue *mq)
  */
 void mmc_queue_suspend(struct mmc_queue *mq)
 {
-	struct request_queue *q = mq->queue;
-	unsigned long flags;
-
 	if (!(mq->flags & MMC_QUEUE_SUSPENDED)) {
 		mq->flags |= MMC_QUEUE_SUSPENDED;
 
-		spin_lock_irqsave(q->queue_lock, flags);
-		blk_stop_queue(q);
-		spin_unlock_irqrestore(q->queue_lock, flags);
+		mmc_queue_stop(mq->queue);
 
 		down(&mq->thread_sem);
+		mmc_queue_cmdq_drain(mq);
 	}
 }
 
@@ -438,17 +795,12 @@ void mmc_queue_suspend(struct mmc_queue *mq)
  */
 void mmc_queue_resume(struct mmc_queue *mq)
 {
-	struct request_queue *q = mq->queue;
-	unsigned long flags;
-
 	if (mq->flags & MMC_QUEUE_SUSPENDED) {
 		mq->flags &= ~MMC_QUEUE_SUSPENDED;
 
 		up(&mq->thread_sem);
 
-		spin_lock_irqsave(q->queue_lock, flags);
-		blk_start_queue(q);
-		spin_unlock_irqrestore(q->queue_lock, flags);
+		mmc_queue_start(mq->queue);
 	}
 }
 
@@ -1,6 +1,10 @@
 #ifndef MMC_QUEUE_H
 #define MMC_QUEUE_H
 
+#ifdef CONFIG_MMC_BLOCK_MQ
+#include <linux/blk-mq.h>
+#endif
+
 #define MMC_REQ_SPECIAL_MASK	(REQ_DISCARD | REQ_FLUSH)
 
 struct request;
@@ -12,6 +16,10 @@ struct mmc_blk_request {
 	struct mmc_command	cmd;
 	struct mmc_command	stop;
 	struct mmc_data		data;
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	struct mmc_request	mrq_que;	/* CMD44 + CMD45 of the task */
+	struct mmc_command	que;
+#endif
 };
 
 enum mmc_packed_type {
@@ -50,6 +58,7 @@ struct mmc_queue {
 	unsigned int		flags;
 #define MMC_QUEUE_SUSPENDED	(1 << 0)
 #define MMC_QUEUE_NEW_REQUEST	(1 << 1)
+#define MMC_QUEUE_CMDQ_OFF	(1 << 2)
 
 	int			(*issue_fn)(struct mmc_queue *, struct request *);
 	void			*data;
@@ -57,6 +66,26 @@ struct mmc_queue {
 	struct mmc_queue_req	mqrq[2];
 	struct mmc_queue_req	*mqrq_cur;
 	struct mmc_queue_req	*mqrq_prev;
+#ifdef CONFIG_MMC_BLOCK_MQ
+	struct blk_mq_tag_set	tag_set;
+	spinlock_t		mq_lock;	/* mq_list and cmdq state */
+	struct list_head	mq_list;	/* requests for mmcqd */
+
+	/*
+	 * Command queue dispatch, set up by the block driver for the
+	 * queues whose r/w requests can go to the card task queue.
+	 * cmdq_issue_fn is called from blk-mq dispatch under mq_lock and
+	 * must not sleep; claim/release run from mmcqd.
+	 */
+	int			(*cmdq_issue_fn)(struct mmc_queue *,
+						 struct request *);
+	int			(*cmdq_claim_fn)(struct mmc_queue *);
+	void			(*cmdq_release_fn)(struct mmc_queue *);
+	bool			cmdq_owned;	/* host claimed for tasks */
+	bool			cmdq_wanted;	/* a task waits for the claim */
+	unsigned long		cmdq_stamp;	/* last task activity */
+	wait_queue_head_t	cmdq_wait;	/* task queue drained */
+#endif
 };
 
 extern int mmc_init_queue(struct mmc_queue *, struct mmc_card *, spinlock_t *,
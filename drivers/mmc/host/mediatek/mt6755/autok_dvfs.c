@@ -3,6 +3,9 @@
 #include <linux/buffer_head.h>
 #include <linux/delay.h>
 #include <linux/fs.h>
+#include <linux/mutex.h>
+#include <linux/slab.h>
+#include <linux/workqueue.h>
 
 #include "autok_dvfs.h"
 
@@ -11,6 +14,12 @@
 
 #define SDIO_AUTOK_DIFF_MARGIN      3
 
+#define MSDC_AUTOK_RES_PATH         "/data/msdc_autok_res"
+#define MSDC_AUTOK_RES_MAGIC        0x4b545541      /* "AUTK" */
+#define MSDC_AUTOK_RES_NUM          8
+#define MSDC_AUTOK_RES_RETRY        30
+#define MSDC_AUTOK_RES_RETRY_DELAY  (10 * HZ)
+
 u8 sdio_autok_res[2][TUNING_PARAM_COUNT];
 u8 emmc_autok_res[2][TUNING_PARAM_COUNT];
 u8 sd_autok_res[2][TUNING_PARAM_COUNT];
@@ -239,6 +248,286 @@ void sdio_set_vcorefs_sram(int vcore, int done, struct msdc_host *host)
 		vcorefs_set_sram_data(0, 0x55AA55AA);
 }
 
+/*
+ * eMMC/SD autok result cache.
+ *
+ * A sweep result is kept per (card CID, vcore level, timing), so that the
+ * re-tunings the core asks for on every ios change, resume and re-init and
+ * the vcore level changes just write the known parameters back. The table
+ * is also kept in MSDC_AUTOK_RES_PATH; it is loaded and written from a work
+ * item, never from the tuning context, since the file lives on the eMMC
+ * itself. The file is not available yet when the eMMC is initialized at
+ * boot; it serves later initializations (SD insertion, re-init after an
+ * error) once the data partition is mounted.
+ *
+ * A CRC error is the validation: the re-tuning it triggers is always a full
+ * sweep (see host->autok_res_distrust) whose result replaces the entry.
+ */
+struct msdc_autok_res_entry {
+	u32 cid[4];
+	u8 valid;
+	u8 vcore;
+	u8 timing;
+	u8 res[TUNING_PARAM_COUNT];
+};
+
+struct msdc_autok_res_file {
+	u32 magic;
+	u32 param_count;
+	u32 csum;
+	struct msdc_autok_res_entry entry[MSDC_AUTOK_RES_NUM];
+};
+
+static struct msdc_autok_res_entry autok_res_tbl[MSDC_AUTOK_RES_NUM];
+static int autok_res_next;
+static bool autok_res_loaded;
+static bool autok_res_dirty;
+static int autok_res_retry = MSDC_AUTOK_RES_RETRY;
+static DEFINE_MUTEX(autok_res_lock);
+
+static void msdc_autok_res_work_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(autok_res_work, msdc_autok_res_work_fn);
+
+int msdc_autok_vcore(void)
+{
+	return (vcorefs_get_curr_opp() == OPPI_PERF) ?
+		AUTOK_VCORE_HIGH : AUTOK_VCORE_LOW;
+}
+
+static bool msdc_autok_timing_tuned(u8 timing)
+{
+	return timing == MMC_TIMING_MMC_HS400 ||
+	       timing == MMC_TIMING_MMC_HS200 ||
+	       timing == MMC_TIMING_UHS_SDR104 ||
+	       timing == MMC_TIMING_UHS_SDR50;
+}
+
+static struct msdc_autok_res_entry *msdc_autok_res_find(const u32 *cid,
+	int vcore, u8 timing)
+{
+	int i;
+
+	for (i = 0; i < MSDC_AUTOK_RES_NUM; i++) {
+		struct msdc_autok_res_entry *e = &autok_res_tbl[i];
+
+		if (e->valid && e->vcore == vcore && e->timing == timing &&
+		    !memcmp(e->cid, cid, sizeof(e->cid)))
+			return e;
+	}
+
+	return NULL;
+}
+
+static u32 msdc_autok_res_csum(struct msdc_autok_res_file *f)
+{
+	u8 *p = (u8 *)f->entry;
+	u32 sum = 0;
+	int i;
+
+	for (i = 0; i < sizeof(f->entry); i++)
+		sum = (sum << 1 | sum >> 31) ^ p[i];
+
+	return sum;
+}
+
+/* the levels need different parameters: check them on every request */
+static void msdc_autok_res_update_dvfs(struct msdc_host *host, u8 timing)
+{
+	struct msdc_autok_res_entry *h, *l;
+
+	h = msdc_autok_res_find(host->autok_cid, AUTOK_VCORE_HIGH, timing);
+	l = msdc_autok_res_find(host->autok_cid, AUTOK_VCORE_LOW, timing);
+	host->autok_res_dvfs = h && l && memcmp(h->res, l->res, sizeof(h->res));
+}
+
+static void msdc_autok_res_load(void)
+{
+	struct msdc_autok_res_file *f;
+	struct file *filp;
+	int i;
+
+	filp = msdc_file_open(MSDC_AUTOK_RES_PATH, O_RDONLY, 0644);
+	if (filp == NULL)
+		return;
+
+	f = kmalloc(sizeof(*f), GFP_KERNEL);
+	if (!f) {
+		filp_close(filp, NULL);
+		return;
+	}
+
+	if (msdc_file_read(filp, 0, (u8 *)f, sizeof(*f)) == sizeof(*f) &&
+	    f->magic == MSDC_AUTOK_RES_MAGIC &&
+	    f->param_count == TUNING_PARAM_COUNT &&
+	    f->csum == msdc_autok_res_csum(f)) {
+		mutex_lock(&autok_res_lock);
+		/* what was tuned in this boot is newer than the file */
+		for (i = 0; i < MSDC_AUTOK_RES_NUM; i++) {
+			struct msdc_autok_res_entry *e = &f->entry[i];
+
+			if (!e->valid || msdc_autok_res_find(e->cid, e->vcore,
+							     e->timing))
+				continue;
+			autok_res_tbl[autok_res_next] = *e;
+			autok_res_next = (autok_res_next + 1) %
+				MSDC_AUTOK_RES_NUM;
+		}
+		mutex_unlock(&autok_res_lock);
+		pr_err("msdc autok results loaded\n");
+	} else {
+		pr_err("msdc autok results file invalid, ignored\n");
+	}
+	autok_res_loaded = true;
+
+	kfree(f);
+	filp_close(filp, NULL);
+}
+
+static int msdc_autok_res_sync(void)
+{
+	struct msdc_autok_res_file *f;
+	struct file *filp;
+	int ret = -1;
+
+	filp = msdc_file_open(MSDC_AUTOK_RES_PATH, O_CREAT | O_WRONLY, 0644);
+	if (filp == NULL)
+		return ret;
+
+	f = kzalloc(sizeof(*f), GFP_KERNEL);
+	if (!f) {
+		filp_close(filp, NULL);
+		return ret;
+	}
+
+	mutex_lock(&autok_res_lock);
+	memcpy(f->entry, autok_res_tbl, sizeof(f->entry));
+	autok_res_dirty = false;
+	mutex_unlock(&autok_res_lock);
+	f->magic = MSDC_AUTOK_RES_MAGIC;
+	f->param_count = TUNING_PARAM_COUNT;
+	f->csum = msdc_autok_res_csum(f);
+
+	if (msdc_file_write(filp, 0, (u8 *)f, sizeof(*f)) == sizeof(*f))
+		ret = 0;
+	vfs_fsync(filp, 0);
+
+	kfree(f);
+	filp_close(filp, NULL);
+
+	return ret;
+}
+
+static void msdc_autok_res_work_fn(struct work_struct *work)
+{
+	if (!autok_res_loaded)
+		msdc_autok_res_load();
+
+	if (autok_res_loaded && !autok_res_dirty)
+		return;
+
+	/* a file that could be written but not read did not exist yet */
+	if (autok_res_dirty && !msdc_autok_res_sync()) {
+		autok_res_loaded = true;
+		return;
+	}
+
+	/* the data partition is not mounted yet */
+	if (autok_res_retry-- > 0)
+		schedule_delayed_work(&autok_res_work,
+				      MSDC_AUTOK_RES_RETRY_DELAY);
+}
+
+/*
+ * Write the stored result of the current card, vcore level and timing to
+ * the host, and to @out if not NULL. Returns 0 when a result was applied,
+ * -1 when a sweep is needed.
+ */
+int msdc_autok_res_apply(struct msdc_host *host, u8 *out)
+{
+	struct msdc_autok_res_entry *e;
+	u8 timing = host->mmc->ios.timing;
+	int vcore = msdc_autok_vcore();
+	u8 res[TUNING_PARAM_COUNT];
+
+	if (!msdc_autok_timing_tuned(timing))
+		return -1;
+	/* the offline TX tuning sets registers a result does not hold */
+	if (do_autok_offline_tune_tx)
+		return -1;
+
+	mutex_lock(&autok_res_lock);
+	e = msdc_autok_res_find(host->autok_cid, vcore, timing);
+	if (e)
+		memcpy(res, e->res, sizeof(res));
+	msdc_autok_res_update_dvfs(host, timing);
+	mutex_unlock(&autok_res_lock);
+
+	if (!e) {
+		if (!autok_res_loaded)
+			schedule_delayed_work(&autok_res_work, 0);
+		return -1;
+	}
+
+	if (timing == MMC_TIMING_MMC_HS400)
+		autok_init_hs400(host);
+	else if (timing == MMC_TIMING_MMC_HS200)
+		autok_init_hs200(host);
+	else
+		autok_init_sdr104(host);
+	autok_tuning_parameter_init(host, res);
+	host->autok_vcore = vcore;
+	if (out)
+		memcpy(out, res, sizeof(res));
+
+	return 0;
+}
+
+/* keep the result of a full sweep done at the current vcore level */
+void msdc_autok_res_store(struct msdc_host *host, u8 *res)
+{
+	struct msdc_autok_res_entry *e;
+	u8 timing = host->mmc->ios.timing;
+	int vcore = msdc_autok_vcore();
+
+	if (!msdc_autok_timing_tuned(timing))
+		return;
+
+	mutex_lock(&autok_res_lock);
+	e = msdc_autok_res_find(host->autok_cid, vcore, timing);
+	if (!e) {
+		e = &autok_res_tbl[autok_res_next];
+		autok_res_next = (autok_res_next + 1) % MSDC_AUTOK_RES_NUM;
+		memcpy(e->cid, host->autok_cid, sizeof(e->cid));
+		e->vcore = vcore;
+		e->timing = timing;
+		e->valid = 1;
+	}
+	memcpy(e->res, res, sizeof(e->res));
+	msdc_autok_res_update_dvfs(host, timing);
+	autok_res_dirty = true;
+	mutex_unlock(&autok_res_lock);
+
+	host->autok_vcore = vcore;
+	autok_res_retry = MSDC_AUTOK_RES_RETRY;
+	schedule_delayed_work(&autok_res_work, 0);
+}
+
+/* the registers no longer match the stored result (partial tuning) */
+void msdc_autok_res_drop(struct msdc_host *host)
+{
+	struct msdc_autok_res_entry *e;
+
+	mutex_lock(&autok_res_lock);
+	e = msdc_autok_res_find(host->autok_cid, msdc_autok_vcore(),
+				host->mmc->ios.timing);
+	if (e) {
+		e->valid = 0;
+		autok_res_dirty = true;
+	}
+	host->autok_res_dvfs = false;
+	mutex_unlock(&autok_res_lock);
+}
+
 /* For backward compatible, remove later */
 int wait_sdio_autok_ready(void *data)
 {
@@ -33,5 +33,10 @@ extern void sdio_unreq_vcore(struct work_struct *work);
 extern void sdio_set_vcore_performance(struct msdc_host *host, u32 enable);
 void sdio_set_vcorefs_sram(int vcore, int done, struct msdc_host *host);
 
+extern int msdc_autok_vcore(void);
+extern int msdc_autok_res_apply(struct msdc_host *host, u8 *res);
+extern void msdc_autok_res_store(struct msdc_host *host, u8 *res);
+extern void msdc_autok_res_drop(struct msdc_host *host);
+
 #endif /* _AUTOK_DVFS_H_ */
 
@@ -42,6 +42,9 @@
 #define MSDC_DMA_ADDR_DEBUG
 /*#define MSDC_HQA*/
 
+/* complete small eMMC reads by spinning on MSDC_INT (see MMC_DATA_POLL) */
+#define MSDC_HYBRID_POLL
+
 #define MTK_MSDC_USE_CMD23
 #if defined(CONFIG_MTK_EMMC_CACHE) && defined(MTK_MSDC_USE_CMD23)
 #define MTK_MSDC_USE_CACHE
@@ -461,6 +464,18 @@ struct msdc_host {
 	struct work_struct	work_tune; /* new thread tune */
 	struct mmc_request	*mrq_tune; /* backup host->mrq */
 #endif
+
+	u32                     autok_cid[4];   /* CID seen in CMD2 */
+	int                     autok_vcore;    /* level the params are for */
+	bool                    autok_res_dvfs; /* levels need other params */
+	bool                    autok_res_distrust; /* CRC error, full sweep */
+
+#ifdef MSDC_HYBRID_POLL
+	bool                    poll_xfer;      /* data INTs held off, polled */
+	u64                     poll_start_ns;  /* DMA start of a pollable read */
+	u64                     poll_end_ns;    /* end of the spin budget */
+	u32                     poll_avg_ns;    /* learned completion time */
+#endif
 };
 
 enum {
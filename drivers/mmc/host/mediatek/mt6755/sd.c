@@ -53,6 +53,7 @@
 
 #ifdef CONFIG_MTK_AEE_FEATURE
 #include <mt-plat/aee.h>
+#include <mt-plat/mt_wq.h>
 #endif
 
 #ifdef CONFIG_MTK_HIBERNATION
@@ -1836,6 +1837,10 @@ static u32 msdc_command_resp_polling(struct msdc_host *host,
 			*rsp++ = MSDC_READ32(SDC_RESP2);
 			*rsp++ = MSDC_READ32(SDC_RESP1);
 			*rsp++ = MSDC_READ32(SDC_RESP0);
+			/* key of the stored autok results of this card */
+			if (cmd->opcode == MMC_ALL_SEND_CID)
+				memcpy(host->autok_cid, cmd->resp,
+					sizeof(host->autok_cid));
 			break;
 		default: /* Response types 1, 3, 4, 5, 6, 7(1b) */
 			*rsp = MSDC_READ32(SDC_RESP0);
@@ -2521,6 +2526,88 @@ check_fifo_end:
 	return data->error;
 }
 
+#ifdef MSDC_HYBRID_POLL
+/*
+ * Hybrid polling of small eMMC reads.
+ *
+ * The block driver tags the reads of a queue that has io_poll set with
+ * MMC_DATA_POLL. For those the data interrupts are left disabled when the
+ * DMA is started and the issuing thread spins on MSDC_INT, the same way
+ * msdc_command_resp_polling() waits for the command response, for a little
+ * longer than such a read has recently taken. A clean XFER_COMPL seen while
+ * spinning is completed right there, without the interrupt and the wakeup
+ * of the waiter. On a data error or when the budget runs out the data
+ * interrupts are enabled again; a status that is already pending raises
+ * the interrupt at once and msdc_irq() finishes the request as usual.
+ *
+ * The completion time is learned from every pollable read, polled or not,
+ * so polling switches itself off while the card is slower than
+ * msdc_poll_max_us and back on once it is fast again.
+ */
+static unsigned int msdc_poll_max_us = 50;
+module_param_named(poll_max_us, msdc_poll_max_us, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(poll_max_us, "Longest spin for a polled eMMC read (us)");
+
+static void msdc_poll_account(struct msdc_host *host, u64 delta_ns)
+{
+	u64 cap = 4ULL * msdc_poll_max_us * NSEC_PER_USEC;
+	u32 avg = host->poll_avg_ns;
+
+	/* one GC stall of the card must not switch polling off for long */
+	if (delta_ns > cap)
+		delta_ns = cap;
+
+	if (!avg)
+		avg = (u32)delta_ns;
+	else
+		avg = avg - (avg >> 3) + ((u32)delta_ns >> 3);
+	host->poll_avg_ns = avg;
+}
+
+static u64 msdc_poll_budget_ns(struct msdc_host *host)
+{
+	u64 max = (u64)msdc_poll_max_us * NSEC_PER_USEC;
+	u64 budget;
+
+	if (!host->poll_avg_ns)
+		return max;
+
+	/* a quarter of slack over the learned completion time */
+	budget = host->poll_avg_ns + (host->poll_avg_ns >> 2);
+	if (budget > max)
+		return 0;
+
+	return budget;
+}
+
+/* decide, with host->lock held and right before the DMA start */
+static void msdc_poll_prepare(struct msdc_host *host, struct mmc_data *data)
+{
+	u64 budget;
+
+	host->poll_xfer = false;
+	host->poll_start_ns = 0;
+
+	if (!(data->flags & MMC_DATA_POLL) || !(data->flags & MMC_DATA_READ))
+		return;
+	/* the polled completion does not handle AUTOCMD12 responses */
+	if ((host->hw->host_function != MSDC_EMMC) ||
+	    (host->autocmd & MSDC_AUTOCMD12))
+		return;
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	if (host->mmc->card && host->mmc->card->ext_csd.cmdq_mode_en)
+		return;
+#endif
+
+	host->poll_start_ns = ktime_get_ns();
+	budget = msdc_poll_budget_ns(host);
+	if (budget) {
+		host->poll_end_ns = host->poll_start_ns + budget;
+		host->poll_xfer = true;
+	}
+}
+#endif
+
 static void msdc_dma_start(struct msdc_host *host)
 {
 	void __iomem *base = host->base;
@@ -2532,7 +2619,12 @@ static void msdc_dma_start(struct msdc_host *host)
 			| MSDC_INT_ACMDRDY;
 	MSDC_SET_FIELD(MSDC_DMA_CTRL, MSDC_DMA_CTRL_START, 1);
 
+#ifdef MSDC_HYBRID_POLL
+	if (!host->poll_xfer)
+		MSDC_SET_BIT32(MSDC_INTEN, wints);
+#else
 	MSDC_SET_BIT32(MSDC_INTEN, wints);
+#endif
 
 	N_MSG(DMA, "DMA start");
 	/* Schedule delayed work to check if data0 keeps busy */
@@ -2540,7 +2632,7 @@ static void msdc_dma_start(struct msdc_host *host)
 		host->write_timeout_ms = min_t(u32, max_t(u32,
 			host->data->blocks * 500,
 			host->data->timeout_ns / 1000000), 10 * 1000);
-		schedule_delayed_work(&host->write_timeout,
+		mt_queue_delayed_work(MT_WQ_LITTLE, &host->write_timeout,
 			msecs_to_jiffies(host->write_timeout_ms));
 		N_MSG(DMA, "DMA Data Busy Timeout:%u ms, schedule_delayed_work",
 			host->write_timeout_ms);
@@ -2583,6 +2675,41 @@ static void msdc_dma_stop(struct msdc_host *host)
 	N_MSG(DMA, "DMA stop");
 }
 
+#ifdef MSDC_HYBRID_POLL
+/*
+ * Spin for the end of a polled read, without host->lock. Returns 1 when the
+ * transfer completed cleanly while spinning, the caller then finishes it
+ * the way msdc_irq() would; 0 when it has been handed back to msdc_irq().
+ */
+static int msdc_poll_xfer_done(struct msdc_host *host)
+{
+	void __iomem *base = host->base;
+	u32 wints = MSDC_INTEN_XFER_COMPL | MSDC_INTEN_DATTMO
+		| MSDC_INTEN_DATCRCERR;
+	u32 datsts = MSDC_INT_DATCRCERR | MSDC_INT_DATTMO;
+	u32 intsts;
+
+	do {
+		intsts = MSDC_READ32(MSDC_INT);
+		if (intsts & (MSDC_INT_XFER_COMPL | datsts))
+			break;
+		cpu_relax();
+	} while (ktime_get_ns() < host->poll_end_ns);
+
+	host->poll_xfer = false;
+
+	if ((intsts & MSDC_INT_XFER_COMPL) && !(intsts & datsts)) {
+		MSDC_WRITE32(MSDC_INT, MSDC_INT_XFER_COMPL);
+		msdc_poll_account(host, ktime_get_ns() - host->poll_start_ns);
+		host->poll_start_ns = 0;
+		return 1;
+	}
+
+	MSDC_SET_BIT32(MSDC_INTEN, wints);
+	return 0;
+}
+#endif
+
 /* calc checksum */
 static u8 msdc_dma_calcs(u8 *buf, u32 len)
 {
@@ -2863,6 +2990,7 @@ int msdc_rw_cmd_dma(struct mmc_host *mmc, struct mmc_command *cmd,
 	void __iomem *base = host->base;
 	int map_sg = 0;
 	int dir;
+	int polled = 0;
 
 	msdc_dma_on();  /* enable DMA mode first!! */
 
@@ -2885,10 +3013,20 @@ int msdc_rw_cmd_dma(struct mmc_host *mmc, struct mmc_command *cmd,
 	/* for read, the data coming too fast, then CRC error
 	   start DMA no business with CRC. */
 	msdc_dma_setup(host, &host->dma, data->sg, data->sg_len);
+#ifdef MSDC_HYBRID_POLL
+	msdc_poll_prepare(host, data);
+#endif
 	msdc_dma_start(host);
 
 	spin_unlock(&host->lock);
-	if (!wait_for_completion_timeout(&host->xfer_done, DAT_TIMEOUT)) {
+#ifdef MSDC_HYBRID_POLL
+	if (host->poll_xfer && msdc_poll_xfer_done(host)) {
+		data->bytes_xfered = host->dma.xfersz;
+		polled = 1;
+	}
+#endif
+	if (!polled &&
+	    !wait_for_completion_timeout(&host->xfer_done, DAT_TIMEOUT)) {
 		ERR_MSG("XXX CMD<%d> ARG<0x%x> wait xfer_done<%d> timeout!!",
 			cmd->opcode, cmd->arg, data->blocks * data->blksz);
 
@@ -3489,6 +3627,7 @@ static int tune_cmdq_cmdrsp(struct mmc_host *mmc,
 
 			ERR_MSG("get card status, err = %d", err);
 #ifdef MSDC_AUTOK_ON_ERROR
+			host->autok_res_distrust = true;
 			if (msdc_execute_tuning(mmc, MMC_SEND_STATUS)) {
 				ERR_MSG("failed to updata cmd para");
 				return 1;
@@ -3686,6 +3825,11 @@ static void msdc_post_req(struct mmc_host *mmc, struct mmc_request *mrq,
 
 }
 
+#ifdef MSDC_HYBRID_POLL
+static void msdc_irq_data_complete(struct msdc_host *host,
+	struct mmc_data *data, int error);
+#endif
+
 static int msdc_do_request_async(struct mmc_host *mmc, struct mmc_request *mrq)
 {
 	struct msdc_host *host = mmc_priv(mmc);
@@ -3798,6 +3942,9 @@ static int msdc_do_request_async(struct mmc_host *mmc, struct mmc_request *mrq)
 	mmc->is_data_dma = 1;
 #endif
 
+#ifdef MSDC_HYBRID_POLL
+	msdc_poll_prepare(host, data);
+#endif
 	msdc_dma_start(host);
 	/*ERR_MSG("0.Power cycle enable(%d)",host->power_cycle_enable);*/
 
@@ -3826,6 +3973,17 @@ static int msdc_do_request_async(struct mmc_host *mmc, struct mmc_request *mrq)
 	msdc_update_cache_flush_status(host, mrq, data, 1);
 #endif
 
+#ifdef MSDC_HYBRID_POLL
+	/* the request is handed to the core exactly as msdc_irq() would */
+	if (host->poll_xfer && msdc_poll_xfer_done(host)) {
+#ifdef CONFIG_CMDQ_CMD_DAT_PARALLEL
+		mmc->is_data_dma = 0;
+#endif
+		data->bytes_xfered = host->dma.xfersz;
+		msdc_irq_data_complete(host, data, 0);
+	}
+#endif
+
 	return 0;
 
 
@@ -4475,6 +4633,7 @@ static void msdc_async_tune(struct work_struct *work)
 int msdc_execute_tuning(struct mmc_host *mmc, u32 opcode)
 {
 	struct msdc_host *host = mmc_priv(mmc);
+	u8 *res;
 
 	host->legacy_tuning_in_progress = true;
 	/*host->async_tuning_in_progress = true;*/
@@ -4486,9 +4645,17 @@ int msdc_execute_tuning(struct mmc_host *mmc, u32 opcode)
 	if (host->hw->host_function == MSDC_SD) {
 		if (mmc->ios.timing == MMC_TIMING_UHS_SDR104 ||
 		    mmc->ios.timing == MMC_TIMING_UHS_SDR50) {
-			if (host->is_autok_done == 0) {
-				pr_err("[AUTOK]SD Autok\n");
-				autok_execute_tuning(host, sd_autok_res[AUTOK_VCORE_HIGH]);
+			if (host->is_autok_done == 0 || host->autok_res_distrust) {
+				if (host->autok_res_distrust ||
+				    msdc_autok_res_apply(host,
+					sd_autok_res[AUTOK_VCORE_HIGH])) {
+					pr_err("[AUTOK]SD Autok\n");
+					autok_execute_tuning(host, sd_autok_res[AUTOK_VCORE_HIGH]);
+					msdc_autok_res_store(host,
+						sd_autok_res[AUTOK_VCORE_HIGH]);
+				} else {
+					pr_err("[AUTOK]SD stored result\n");
+				}
 				host->is_autok_done = 1;
 			} else {
 				autok_init_sdr104(host);
@@ -4504,17 +4671,29 @@ int msdc_execute_tuning(struct mmc_host *mmc, u32 opcode)
 			if (opcode == MMC_SEND_STATUS) {
 				pr_err("[AUTOK]eMMC HS200 Tune CMD only\n");
 				hs200_execute_tuning_cmd(host, NULL);
-			} else {
+				msdc_autok_res_drop(host);
+			} else if (host->autok_res_distrust ||
+				   msdc_autok_res_apply(host, NULL)) {
+				res = emmc_autok_res[msdc_autok_vcore()];
 				pr_err("[AUTOK]eMMC HS200 Tune\n");
-				hs200_execute_tuning(host, NULL);
+				hs200_execute_tuning(host, res);
+				msdc_autok_res_store(host, res);
+			} else {
+				pr_err("[AUTOK]eMMC HS200 stored result\n");
 			}
 		} else if (mmc->ios.timing == MMC_TIMING_MMC_HS400) {
 			if (opcode == MMC_SEND_STATUS) {
 				pr_err("[AUTOK]eMMC HS400 Tune CMD only\n");
 				hs400_execute_tuning_cmd(host, NULL);
-			} else {
+				msdc_autok_res_drop(host);
+			} else if (host->autok_res_distrust ||
+				   msdc_autok_res_apply(host, NULL)) {
+				res = emmc_autok_res[msdc_autok_vcore()];
 				pr_err("[AUTOK]eMMC HS400 Tune\n");
-				hs400_execute_tuning(host, NULL);
+				hs400_execute_tuning(host, res);
+				msdc_autok_res_store(host, res);
+			} else {
+				pr_err("[AUTOK]eMMC HS400 stored result\n");
 			}
 		}
 	} else if (host->hw->host_function == MSDC_SDIO) {
@@ -4594,12 +4773,35 @@ int msdc_execute_tuning(struct mmc_host *mmc, u32 opcode)
 	host->legacy_tuning_in_progress = false;
 	host->legacy_tuning_done = true;
 	host->first_tune_done = 1;
+	host->autok_res_distrust = false;
 
 	msdc_gate_clock(host, 1);
 
 	return 0;
 }
 
+/*
+ * The vcore level changed since the parameters were written and the stored
+ * results of the two levels differ: switch to the other result right away
+ * instead of waiting for the CRC error that would retune.
+ */
+static void msdc_autok_follow_vcore(struct msdc_host *host)
+{
+	if (!host->autok_res_dvfs)
+		return;
+#ifdef CONFIG_CMDQ_CMD_DAT_PARALLEL
+	/* not under a transfer that is using the current parameters */
+	if (host->mmc->is_data_dma)
+		return;
+#endif
+	if (host->autok_vcore == msdc_autok_vcore())
+		return;
+
+	msdc_ungate_clock(host);
+	msdc_autok_res_apply(host, NULL);
+	msdc_gate_clock(host, 1);
+}
+
 static void msdc_ops_request(struct mmc_host *mmc, struct mmc_request *mrq)
 {
 	struct mmc_data *data;
@@ -4619,11 +4821,14 @@ static void msdc_ops_request(struct mmc_host *mmc, struct mmc_request *mrq)
 	if (data)
 		host_cookie = data->host_cookie;
 
+	msdc_autok_follow_vcore(host);
+
 	/* Asyn only support  DMA and asyc CMD flow */
 	if (msdc_use_async_dma(host_cookie)) {
 		#if defined(MSDC_AUTOK_ON_ERROR)
 		if (!host->async_tuning_in_progress &&
 		    !host->async_tuning_done) {
+			host->autok_res_distrust = true;
 #ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
 			if (host->mmc->card->ext_csd.cmdq_mode_en)
 				ERR_MSG("[%s][ERROR] CMDQ on, not support async tuning",
@@ -4659,6 +4864,7 @@ static void msdc_ops_request(struct mmc_host *mmc, struct mmc_request *mrq)
 	} else {
 		if (!host->legacy_tuning_in_progress
 		 && !host->legacy_tuning_done) {
+			host->autok_res_distrust = true;
 			if (mmc->ios.timing == MMC_TIMING_UHS_SDR104 ||
 			    mmc->ios.timing == MMC_TIMING_UHS_SDR50) {
 				msdc_execute_tuning(mmc,
@@ -5396,6 +5602,14 @@ skip_cmd_interrupts:
 
 done:   /* Finished data transfer */
 	data->bytes_xfered = host->dma.xfersz;
+#ifdef MSDC_HYBRID_POLL
+	/* a pollable read that ended up here still teaches the budget */
+	if (host->poll_start_ns) {
+		msdc_poll_account(host,
+			ktime_get_ns() - host->poll_start_ns);
+		host->poll_start_ns = 0;
+	}
+#endif
 	msdc_irq_data_complete(host, data, 0);
 	return IRQ_HANDLED;
 
@@ -5825,6 +6039,8 @@ static int msdc_drv_probe(struct platform_device *pdev)
 		mmc->pm_flags |= MMC_PM_KEEP_POWER;
 
 	platform_set_drvdata(pdev, mmc);
+	/* hosts only depend on their own clocks; cards wait for us as children */
+	device_enable_async_suspend(&pdev->dev);
 
 #ifdef CONFIG_MTK_HIBERNATION
 	if (pdev->id == 1)
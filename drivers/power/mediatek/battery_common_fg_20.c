@@ -229,6 +229,30 @@ static struct hrtimer battery_kthread_timer;
 kal_bool g_battery_soc_ready = KAL_FALSE;
 unsigned char fg_ipoh_reset;
 
+/*
+ * Event driven sampling: with no charger and the SOC not moving, the routine
+ * period doubles from BAT_TASK_PERIOD up to bat_idle_period seconds. The
+ * coulomb counter interrupt (armed at 1% of Qmax), the low battery interrupt
+ * and charger events wake the thread in between and drop the period back.
+ */
+static unsigned int bat_idle_period = 160;
+module_param(bat_idle_period, uint, 0644);
+static unsigned int bat_period = BAT_TASK_PERIOD;
+
+enum bat_wake_src {
+	BAT_WAKE_TIMER,
+	BAT_WAKE_REQUEST,
+	BAT_WAKE_FG_INT,
+	BAT_WAKE_LBAT,
+	BAT_WAKE_RESUME,
+	NR_BAT_WAKE_SRC,
+};
+
+static const char * const bat_wake_src_name[NR_BAT_WAKE_SRC] = {
+	"timer", "request", "fg_int", "lbat", "resume",
+};
+static unsigned long bat_wakeups[NR_BAT_WAKE_SRC];
+
 #ifdef CONFIG_CHARGER_QNS
 /* Battery type name */
 #define BATTERY_TYPE_NAME_SEND "1298-9239"
@@ -479,6 +503,8 @@ void wake_up_bat(void)
 
 	chr_wake_up_bat = KAL_TRUE;
 	bat_routine_thread_timeout = KAL_TRUE;
+	bat_period = BAT_TASK_PERIOD;
+	bat_wakeups[BAT_WAKE_REQUEST]++;
 	battery_meter_reset_sleep_time();
 
 	if (!Is_In_IPOH)
@@ -1711,6 +1737,24 @@ static ssize_t store_Charger_Type(struct device *dev, struct device_attribute *a
 
 static DEVICE_ATTR(Charger_Type, 0664, show_Charger_Type, store_Charger_Type);
 
+static ssize_t show_Battery_Wakeups(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct timespec uptime;
+	unsigned long hours;
+	int i, len = 0;
+
+	get_monotonic_boottime(&uptime);
+	hours = uptime.tv_sec / 3600 ? uptime.tv_sec / 3600 : 1;
+
+	len += sprintf(buf + len, "period %u s, idle period %u s\n", bat_period, bat_idle_period);
+	for (i = 0; i < NR_BAT_WAKE_SRC; i++)
+		len += sprintf(buf + len, "%-8s %lu (%lu/h)\n", bat_wake_src_name[i],
+			       bat_wakeups[i], bat_wakeups[i] / hours);
+	return len;
+}
+
+static DEVICE_ATTR(Battery_Wakeups, 0444, show_Battery_Wakeups, NULL);
+
 
 
 
@@ -3399,12 +3443,29 @@ void BAT_thread(void)
 	mt_kpoc_power_off_check();
 }
 
+/* stretch the period while nothing changes, see bat_idle_period */
+static void bat_update_period(void)
+{
+	static signed int pre_soc = -1;
+
+	if (BMT_status.charger_exist == KAL_FALSE && BMT_status.UI_SOC == pre_soc &&
+	    BMT_status.bat_vol > VBAT_LOW_POWER_WAKEUP) {
+		if (bat_period < bat_idle_period) {
+			battery_meter_arm_columb_interrupt();
+			bat_period = min(bat_period * 2, bat_idle_period);
+		}
+	} else {
+		bat_period = BAT_TASK_PERIOD;
+	}
+	pre_soc = BMT_status.UI_SOC;
+}
+
 /* ///////////////////////////////////////////////////////////////////////////////////////// */
 /* // Internal API */
 /* ///////////////////////////////////////////////////////////////////////////////////////// */
 int bat_routine_thread(void *x)
 {
-	ktime_t ktime = ktime_set(3, 0);	/* 10s, 10* 1000 ms */
+	unsigned int first_period = 3;
 
 	/* Run on a process content */
 	while (1) {
@@ -3412,8 +3473,10 @@ int bat_routine_thread(void *x)
 		mutex_lock(&bat_mutex);
 
 		if (((chargin_hw_init_done == KAL_TRUE) && (battery_suspended == KAL_FALSE))
-		    || ((chargin_hw_init_done == KAL_TRUE) && (chr_wake_up_bat == KAL_TRUE)))
+		    || ((chargin_hw_init_done == KAL_TRUE) && (chr_wake_up_bat == KAL_TRUE))) {
 			BAT_thread();
+			bat_update_period();
+		}
 
 		if (chr_wake_up_bat == KAL_TRUE)
 			chr_wake_up_bat = KAL_FALSE;
@@ -3426,8 +3489,10 @@ int bat_routine_thread(void *x)
 		wait_event(bat_routine_wq, (bat_routine_thread_timeout == KAL_TRUE));
 
 		bat_routine_thread_timeout = KAL_FALSE;
-		hrtimer_start(&battery_kthread_timer, ktime, HRTIMER_MODE_REL);
-		ktime = ktime_set(BAT_TASK_PERIOD, 0);	/* 10s, 10* 1000 ms */
+		/* bat_period as left by the last run, or reset by an event since */
+		hrtimer_start(&battery_kthread_timer,
+			      ktime_set(first_period ? first_period : bat_period, 0), HRTIMER_MODE_REL);
+		first_period = 0;
 		if (chr_wake_up_bat == KAL_TRUE && g_smartbook_update != 1) {
 			/* for charger plug in/ out */
 #if defined(CONFIG_MTK_DUAL_INPUT_CHARGER_SUPPORT)
@@ -3458,6 +3523,22 @@ void bat_thread_wakeup(void)
 	wake_up(&bat_routine_wq);
 }
 
+/* coulomb counter threshold crossed: sample now and at the short period again */
+void wake_up_bat_event(void)
+{
+	bat_period = BAT_TASK_PERIOD;
+	bat_wakeups[BAT_WAKE_FG_INT]++;
+	bat_thread_wakeup();
+}
+EXPORT_SYMBOL(wake_up_bat_event);
+
+static void bat_low_battery_cb(LOW_BATTERY_LEVEL level)
+{
+	bat_period = BAT_TASK_PERIOD;
+	bat_wakeups[BAT_WAKE_LBAT]++;
+	bat_thread_wakeup();
+}
+
 int bat_update_thread(void *x)
 {
 	/* Run on a process content */
@@ -3817,6 +3898,7 @@ void charger_hv_detect_sw_workaround_init(void)
 
 enum hrtimer_restart battery_kthread_hrtimer_func(struct hrtimer *timer)
 {
+	bat_wakeups[BAT_WAKE_TIMER]++;
 	bat_thread_wakeup();
 
 	return HRTIMER_NORESTART;
@@ -4432,6 +4514,7 @@ static int battery_probe(struct platform_device *dev)
 		ret_device_file = device_create_file(&(dev->dev), &dev_attr_FG_SW_CoulombCounter);
 		ret_device_file = device_create_file(&(dev->dev), &dev_attr_Charging_CallState);
 		ret_device_file = device_create_file(&(dev->dev), &dev_attr_Charger_Type);
+		ret_device_file = device_create_file(&(dev->dev), &dev_attr_Battery_Wakeups);
 		ret_device_file = device_create_file(&(dev->dev), &dev_attr_Pump_Express);
 
 	}
@@ -4469,6 +4552,7 @@ static int battery_probe(struct platform_device *dev)
 	battery_kthread_hrtimer_init();
 
 	kthread_run(bat_routine_thread, NULL, "bat_routine_thread");
+	register_low_battery_notify(&bat_low_battery_cb, LOW_BATTERY_PRIO_BATTERY);
 	kthread_run(bat_update_thread, NULL, "bat_update_thread");
 	battery_log(BAT_LOG_CRTI, "[battery_probe] battery kthread init done\n");
 
@@ -4529,7 +4613,7 @@ static void battery_timer_resume(void)
 		return 0;
 #endif
 
-	ktime = ktime_set(BAT_TASK_PERIOD, 0);	/* 10s, 10* 1000 ms */
+	ktime = ktime_set(bat_period, 0);
 	hvtime = ktime_set(0, BAT_MS_TO_NS(2000));
 
 	get_monotonic_boottime(&bat_time_after_sleep);
@@ -4540,6 +4624,7 @@ static void battery_timer_resume(void)
 
 	if (is_pcm_timer_trigger == KAL_TRUE || bat_spm_timeout || battery_meter_get_low_battery_interrupt_status()) {
 		mutex_lock(&bat_mutex);
+		bat_wakeups[BAT_WAKE_RESUME]++;
 		battery_meter_reset_sleep_time();
 		BAT_thread();
 		mutex_unlock(&bat_mutex);
@@ -3864,6 +3864,7 @@ void fg_bat_int_handler(void)
 		    fg_bat_int_coulomb);
 
 	reset_fg_bat_int = KAL_TRUE;
+	wake_up_bat_event();
 	if (bat_is_charger_exist() == KAL_FALSE) {
 		battery_log(BAT_LOG_CRTI, "wake up user space >>\n");
 		/* self_correct_dod_scheme(duration_time); */
@@ -3884,6 +3885,18 @@ signed int battery_meter_set_columb_interrupt(unsigned int val)
 
 #endif
 
+/* interrupt once 1% of Qmax has gone through the coulomb counter */
+void battery_meter_arm_columb_interrupt(void)
+{
+#if defined(FG_BAT_INT) && defined(SOC_BY_HW_FG) && !defined(CONFIG_POWER_EXT)
+	if (reset_fg_bat_int == KAL_TRUE) {
+		battery_meter_ctrl(BATTERY_METER_CMD_GET_HW_FG_CAR_ACT, &fg_bat_int_coulomb_pre);
+		battery_meter_set_columb_interrupt(batt_meter_cust_data.q_max_pos_25 / 100);
+		reset_fg_bat_int = KAL_FALSE;
+	}
+#endif
+}
+
 
 static int battery_meter_probe(struct platform_device *dev)
 {
@@ -4019,12 +4032,9 @@ static int battery_meter_suspend(struct platform_device *dev, pm_message_t state
 #if defined(CONFIG_POWER_EXT)
 #elif defined(SOC_BY_HW_FG)
 	if (reset_fg_bat_int == KAL_TRUE) {
-		battery_meter_ctrl(BATTERY_METER_CMD_GET_HW_FG_CAR_ACT, &fg_bat_int_coulomb_pre);
 		bm_notice("[battery_meter_suspend]enable battery_meter_set_columb_interrupt %d\n",
 			  batt_meter_cust_data.q_max_pos_25);
-		battery_meter_set_columb_interrupt(batt_meter_cust_data.q_max_pos_25 / 100);
-		/*battery_meter_set_columb_interrupt(1); */
-		reset_fg_bat_int = KAL_FALSE;
+		battery_meter_arm_columb_interrupt();
 	} else {
 		bm_notice
 		    ("[battery_meter_suspend]do not enable battery_meter_set_columb_interrupt %d\n",
@@ -5,6 +5,7 @@
 #include <linux/errno.h>
 #include <linux/spi/spi.h>
 #include <linux/workqueue.h>
+#include <linux/timer.h>
 #include <linux/dma-mapping.h>
 #include <linux/platform_device.h>
 #include <linux/interrupt.h>
@@ -47,12 +48,6 @@
 #if (defined(CONFIG_MTK_FPGA))
 #define  CONFIG_MT_SPI_FPGA_ENABLE
 #endif
-/* auto select transfer mode */
-/* #define SPI_AUTO_SELECT_MODE */
-#ifdef SPI_AUTO_SELECT_MODE
-#define SPI_DATA_SIZE 16
-#endif
-
 /* open base log out */
 /* #define SPI_DEBUG */
 
@@ -65,6 +60,9 @@
 
 #define PACKET_SIZE 0x400
 
+/* clock, pins and wakelock stay on this long after the queue empties */
+#define SPI_IDLE_OFF_MS 5
+
 #define SPI_FIFO_SIZE 32
 /* #define FIFO_TX 0 */
 /* #define FIFO_RX 1 */
@@ -91,6 +89,15 @@ struct mt_spi_t {
 
 	spinlock_t lock;
 	struct list_head queue;
+	struct timer_list idle_timer;
+	bool powered;
+
+	/* a whole pause mode message sent as one transfer, see mt_spi_chain_len() */
+	struct spi_transfer chain_xfer;
+	void *chain_tx;
+	void *chain_rx;
+	dma_addr_t chain_tx_dma;
+	dma_addr_t chain_rx_dma;
 #if !defined(CONFIG_MTK_CLKMGR)
 	struct clk *clk_main;	/* main clock for spi bus */
 #endif				/* !defined(CONFIG_MTK_LEGACY) */
@@ -520,12 +527,23 @@ static int is_pause_mode(struct spi_message *msg)
 	return conf->pause;
 }
 
-static int is_fifo_read(struct spi_message *msg)
+/*
+ * A FIFO mode device still gets DMA for a transfer that does not fit the
+ * FIFO, so e.g. a sensor frame is read in one transfer instead of a train
+ * of SPI_FIFO_SIZE byte messages.
+ */
+static u8 spi_xfer_mode(struct mt_chip_conf *conf, struct spi_transfer *xfer)
 {
-	struct mt_chip_conf *conf;
+	if (conf->com_mod == FIFO_TRANSFER && xfer->len > SPI_FIFO_SIZE)
+		return DMA_TRANSFER;
+	return conf->com_mod;
+}
 
-	conf = (struct mt_chip_conf *)msg->state;
-	return (conf->com_mod == FIFO_TRANSFER) || (conf->com_mod == OTHER1);
+static int is_fifo_read(struct spi_message *msg, struct spi_transfer *xfer)
+{
+	u8 mode = spi_xfer_mode((struct mt_chip_conf *)msg->state, xfer);
+
+	return (mode == FIFO_TRANSFER) || (mode == OTHER1);
 }
 
 static int is_interrupt_enable(struct mt_spi_t *ms)
@@ -741,9 +759,74 @@ static void reset_spi(struct mt_spi_t *ms)
 
 }
 
+/* the chain transfer is not on the message's list, it is the whole message */
 static inline int is_last_xfer(struct spi_message *msg, struct spi_transfer *xfer)
 {
-	return msg->transfers.prev == &xfer->transfer_list;
+	return list_empty(&xfer->transfer_list) || msg->transfers.prev == &xfer->transfer_list;
+}
+
+/*
+ * A pause mode message keeps CS asserted from its first to its last
+ * transfer, so its transfers can go out back to back as one: copied into
+ * the chain buffers and sent with one start and one interrupt instead of a
+ * pause/resume round trip per transfer. Returns the total length, or 0 if
+ * the message has to go transfer by transfer.
+ */
+static unsigned int mt_spi_chain_len(struct mt_spi_t *ms, struct spi_message *msg)
+{
+	struct mt_chip_conf *conf = (struct mt_chip_conf *)msg->state;
+	struct spi_transfer *xfer;
+	unsigned int len = 0;
+
+	if (!ms->chain_tx || !conf->pause || msg->is_dma_mapped)
+		return 0;
+	if (conf->com_mod != FIFO_TRANSFER && conf->com_mod != DMA_TRANSFER)
+		return 0;
+	if (list_is_singular(&msg->transfers))
+		return 0;
+
+	list_for_each_entry(xfer, &msg->transfers, transfer_list) {
+		if (xfer->cs_change || xfer->delay_usecs)
+			return 0;
+		len += xfer->len;
+		if (len > PACKET_SIZE)
+			return 0;
+	}
+	return len;
+}
+
+static void mt_spi_chain_pack(struct mt_spi_t *ms, struct spi_message *msg, unsigned int len)
+{
+	struct spi_transfer *xfer;
+	u8 *tx = ms->chain_tx;
+
+	list_for_each_entry(xfer, &msg->transfers, transfer_list) {
+		if (xfer->tx_buf)
+			memcpy(tx, xfer->tx_buf, xfer->len);
+		else
+			memset(tx, 0, xfer->len);
+		tx += xfer->len;
+	}
+
+	INIT_LIST_HEAD(&ms->chain_xfer.transfer_list);
+	ms->chain_xfer.tx_buf = ms->chain_tx;
+	ms->chain_xfer.rx_buf = ms->chain_rx;
+	ms->chain_xfer.tx_dma = ms->chain_tx_dma;
+	ms->chain_xfer.rx_dma = ms->chain_rx_dma;
+	ms->chain_xfer.len = len;
+	ms->cur_transfer = &ms->chain_xfer;
+}
+
+static void mt_spi_chain_unpack(struct mt_spi_t *ms, struct spi_message *msg)
+{
+	struct spi_transfer *xfer;
+	u8 *rx = ms->chain_rx;
+
+	list_for_each_entry(xfer, &msg->transfers, transfer_list) {
+		if (xfer->rx_buf)
+			memcpy(xfer->rx_buf, rx, xfer->len);
+		rx += xfer->len;
+	}
 }
 
 static int transfer_dma_mapping(struct mt_spi_t *ms, u8 mode, struct spi_transfer *xfer)
@@ -835,9 +918,6 @@ static int mt_spi_next_xfer(struct mt_spi_t *ms, struct spi_message *msg)
 	u8 mode, cnt, i;
 	int ret = 0;
 	char xfer_rec[32];
-#ifdef SPI_AUTO_SELECT_MODE
-	u32 reg_val = 0;
-#endif
 
 	if (unlikely(!ms)) {
 		dev_err(&msg->spi->dev, "master wrapper is invalid\n");
@@ -860,22 +940,8 @@ static int mt_spi_next_xfer(struct mt_spi_t *ms, struct spi_message *msg)
 		ret = -EINVAL;
 		goto fail;
 	}
-#ifdef SPI_AUTO_SELECT_MODE
-	if (ms->cur_transfer.len > SPI_DATA_SIZE) {
-		chip_config->com_mod = DMA_TRANSFER;
-		pr_warn("SPI auto select DMA mode\n");
-		reg_val = spi_readl(ms, SPI_CMD_REG);
-		reg_val |= ((1 << SPI_CMD_TX_DMA_OFFSET) | (1 << SPI_CMD_RX_DMA_OFFSET));
-		spi_writel(ms, SPI_CMD_REG, reg_val);
-		pr_warn("SPI auto select CMD = 0x%x\n", spi_readl(ms, SPI_CMD_REG));
-	} else {
-		pr_warn("SPI auto select do nothing\n");
-	}
-#endif
-
-	mode = chip_config->com_mod;
-
 	xfer = ms->cur_transfer;
+	mode = spi_xfer_mode(chip_config, xfer);
 
 	SPI_DBG("start xfer 0x%p, mode %d, len %u\n", xfer, mode, xfer->len);
 
@@ -1003,16 +1069,32 @@ static void mt_spi_msg_done(struct mt_spi_t *ms, struct spi_message *msg, int st
 	/* continue if needed */
 	if (list_empty(&ms->queue)) {
 		SPI_DBG("All msg is completion.\n\n");
-		/* clock and gpio reset */
-		spi_gpio_reset(ms);
+		/* stay powered for back to back messages, see mt_spi_idle_timeout() */
+		mod_timer(&ms->idle_timer, jiffies + msecs_to_jiffies(SPI_IDLE_OFF_MS));
+	} else
+		mt_spi_next_message(ms);
+}
+
+static void mt_spi_power_down(struct mt_spi_t *ms)
+{
+	/* clock and gpio reset */
+	spi_gpio_reset(ms);
 #ifndef SPI_TRUSTONIC_TEE_SUPPORT
-		disable_clk(ms);
+	disable_clk(ms);
 #endif
-		/* schedule_work(&mt_spi_msgdone_workqueue);//disable clock */
+	wake_unlock(&ms->wk_lock);
+	ms->powered = false;
+}
 
-		wake_unlock(&ms->wk_lock);
-	} else
-		mt_spi_next_message(ms);
+static void mt_spi_idle_timeout(unsigned long data)
+{
+	struct mt_spi_t *ms = (struct mt_spi_t *)data;
+	unsigned long flags;
+
+	spin_lock_irqsave(&ms->lock, flags);
+	if (ms->powered && !ms->cur_transfer)
+		mt_spi_power_down(ms);
+	spin_unlock_irqrestore(&ms->lock, flags);
 }
 
 static void mt_spi_next_message(struct mt_spi_t *ms)
@@ -1020,6 +1102,7 @@ static void mt_spi_next_message(struct mt_spi_t *ms)
 	struct spi_message *msg;
 	struct mt_chip_conf *chip_config;
 	char msg_addr[32];
+	unsigned int chain_len;
 
 	msg = list_entry(ms->queue.next, struct spi_message, queue);
 	chip_config = (struct mt_chip_conf *)msg->state;
@@ -1039,6 +1122,9 @@ static void mt_spi_next_message(struct mt_spi_t *ms)
 
 	SPI_DBG("start transfer message:0x%p\n", msg);
 	ms->cur_transfer = list_entry(msg->transfers.next, struct spi_transfer, transfer_list);
+	chain_len = mt_spi_chain_len(ms, msg);
+	if (chain_len)
+		mt_spi_chain_pack(ms, msg, chain_len);
 #if 0
 	/* clock and gpio set */
 	spi_gpio_set(ms);
@@ -1062,6 +1148,7 @@ static int mt_spi_transfer(struct spi_device *spidev, struct spi_message *msg)
 	struct mt_chip_conf *chip_config;
 	unsigned long flags;
 	char msg_addr[32];
+	bool chain;
 
 	master = spidev->master;
 	ms = spi_master_get_devdata(master);
@@ -1093,6 +1180,7 @@ static int mt_spi_transfer(struct spi_device *spidev, struct spi_message *msg)
 
 	chip_config = (struct mt_chip_conf *)spidev->controller_data;
 	msg->state = chip_config;
+	chain = mt_spi_chain_len(ms, msg) != 0;
 
 	list_for_each_entry(xfer, &msg->transfers, transfer_list) {
 		if (!((xfer->tx_buf || xfer->rx_buf) && xfer->len)) {
@@ -1110,8 +1198,11 @@ static int mt_spi_transfer(struct spi_device *spidev, struct spi_message *msg)
 		 * platforms supported by this driver, we would need to clean
 		 * up mappings for previously-mapped transfers.
 		 */
-		if ((!msg->is_dma_mapped)) {
-			if (transfer_dma_mapping(ms, chip_config->com_mod, xfer) < 0)
+		if (chain) {
+			/* sent from the chain buffers, nothing to map */
+			xfer->tx_dma = xfer->rx_dma = INVALID_DMA_ADDRESS;
+		} else if ((!msg->is_dma_mapped)) {
+			if (transfer_dma_mapping(ms, spi_xfer_mode(chip_config, xfer), xfer) < 0)
 				return -ENOMEM;
 		}
 	}
@@ -1129,12 +1220,12 @@ static int mt_spi_transfer(struct spi_device *spidev, struct spi_message *msg)
 	list_add_tail(&msg->queue, &ms->queue);
 	SPI_DBG("add msg %p to queue\n", msg);
 	if (!ms->cur_transfer) {
-		wake_lock(&ms->wk_lock);
-		spi_gpio_set(ms);
-
-		/* enable_clk(); */
-
-		enable_clk(ms);
+		if (!ms->powered) {
+			wake_lock(&ms->wk_lock);
+			spi_gpio_set(ms);
+			enable_clk(ms);
+			ms->powered = true;
+		}
 
 		mt_spi_next_message(ms);
 
@@ -1180,7 +1271,7 @@ static irqreturn_t mt_spi_interrupt(int irq, void *dev_id)
 	}
 
 	chip_config = (struct mt_chip_conf *)msg->state;
-	mode = chip_config->com_mod;
+	mode = spi_xfer_mode(chip_config, xfer);
 	/* clear the interrupt status bits by reading the register */
 	/* reg_val = spi_readl(ms,SPI_STATUS0_REG); */
 	/* SPI_DBG("xfer:0x%p interrupt status:%x\n", xfer,reg_val & 0x3); */
@@ -1188,7 +1279,7 @@ static irqreturn_t mt_spi_interrupt(int irq, void *dev_id)
 	if ((reg_val & 0x03) == 0)
 		goto out;
 
-	if (!msg->is_dma_mapped)
+	if (!msg->is_dma_mapped && xfer != &ms->chain_xfer)
 		transfer_dma_unmapping(ms, ms->cur_transfer);
 
 	if (is_pause_mode(msg)) {
@@ -1199,7 +1290,7 @@ static irqreturn_t mt_spi_interrupt(int irq, void *dev_id)
 	} else
 		ms->running = IDLE;
 
-	if (is_fifo_read(msg) && xfer->rx_buf) {
+	if (is_fifo_read(msg, xfer) && xfer->rx_buf) {
 		cnt = (xfer->len % 4) ? (xfer->len / 4 + 1) : (xfer->len / 4);
 		for (i = 0; i < cnt; i++) {
 			reg_val = spi_readl(ms, SPI_RX_DATA_REG);	/* get the data from rx */
@@ -1207,6 +1298,8 @@ static irqreturn_t mt_spi_interrupt(int irq, void *dev_id)
 			*((u32 *) xfer->rx_buf + i) = reg_val;
 		}
 	}
+	if (xfer == &ms->chain_xfer)
+		mt_spi_chain_unpack(ms, msg);
 
 	msg->actual_length += xfer->len;
 
@@ -1559,6 +1652,14 @@ static int __init mt_spi_probe(struct platform_device *pdev)
 
 	spin_lock_init(&ms->lock);
 	INIT_LIST_HEAD(&ms->queue);
+	setup_timer(&ms->idle_timer, mt_spi_idle_timeout, (unsigned long)ms);
+	ms->powered = false;
+
+	/* without the chain buffers every message goes transfer by transfer */
+	ms->chain_tx = dmam_alloc_coherent(&pdev->dev, PACKET_SIZE, &ms->chain_tx_dma, GFP_KERNEL);
+	ms->chain_rx = dmam_alloc_coherent(&pdev->dev, PACKET_SIZE, &ms->chain_rx_dma, GFP_KERNEL);
+	if (!ms->chain_rx)
+		ms->chain_tx = NULL;
 
 	SPI_INFO(&pdev->dev, "Controller at 0x%p (irq %d)\n", ms->regs, irq);
 #ifdef CONFIG_OF
@@ -1637,6 +1738,9 @@ static int __exit mt_spi_remove(struct platform_device *pdev)
 	ms->cur_transfer = NULL;
 	ms->running = IDLE;
 
+	del_timer_sync(&ms->idle_timer);
+	if (ms->powered)
+		mt_spi_power_down(ms);
 	reset_spi(ms);
 
 	free_irq(ms->irq, master);
@@ -1651,9 +1755,17 @@ static int mt_spi_suspend(struct platform_device *pdev, pm_message_t message)
 	 * then wait for interrupt complete. */
 	struct mt_spi_t *ms;
 	struct spi_master *master = platform_get_drvdata(pdev);
+	unsigned long flags;
 
 	ms = spi_master_get_devdata(master);
 
+	/* drop the idle grace period, the clock must be off to unprepare it */
+	del_timer_sync(&ms->idle_timer);
+	spin_lock_irqsave(&ms->lock, flags);
+	if (ms->powered && !ms->cur_transfer)
+		mt_spi_power_down(ms);
+	spin_unlock_irqrestore(&ms->lock, flags);
+
 #if !defined(CONFIG_MTK_CLKMGR)
 	/*
 	 * unprepare the clock source
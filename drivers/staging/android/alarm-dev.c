@@ -28,6 +28,9 @@
 #include <linux/uaccess.h>
 #include <linux/rtc.h>
 #include <linux/alarmtimer.h>
+#include <linux/cred.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include "android_alarm.h"
 #include <linux/ioctl.h>
 #define LOG_MYTAG	"Power/Alarm"
@@ -39,6 +42,10 @@
 static int debug_mask = ANDROID_ALARM_PRINT_INFO;
 module_param_named(debug_mask, debug_mask, int, S_IRUGO | S_IWUSR | S_IWGRP);
 
+/* window of wakeup alarms that did not set one with ANDROID_ALARM_SET_WINDOW */
+static unsigned int batch_window_ms;
+module_param_named(batch_window_ms, batch_window_ms, uint, S_IRUGO | S_IWUSR | S_IWGRP);
+
 #define alarm_dbg(debug_level_mask, fmt, args...)				\
 do {									\
 	if (debug_mask & ANDROID_ALARM_PRINT_##debug_level_mask)	\
@@ -63,10 +70,42 @@ struct devalarm {
 		struct alarm alrm;
 	} u;
 	enum android_alarm_type type;
+	ktime_t expires;	/* requested time */
+	ktime_t window;		/* may fire this much after expires */
+	bool batched;		/* programmed together with the other wakeup type */
+	uid_t uid;		/* who set it */
 };
 
 static struct devalarm alarms[ANDROID_ALARM_TYPE_COUNT];
 
+/* Per-uid counts of wakeup alarms, the last slot takes the overflow */
+#define ALARM_UID_STATS	16
+
+static struct alarm_uid_stat {
+	uid_t uid;
+	u32 nr_set;
+	u32 nr_wakeup;
+	u32 nr_batched;		/* wakeups shared with another alarm */
+} alarm_uid_stats[ALARM_UID_STATS];
+static int alarm_uid_nr;
+
+/* called with alarm_slock held */
+static struct alarm_uid_stat *alarm_uid_stat(uid_t uid)
+{
+	int i;
+
+	for (i = 0; i < alarm_uid_nr; i++) {
+		if (alarm_uid_stats[i].uid == uid)
+			return &alarm_uid_stats[i];
+	}
+	if (alarm_uid_nr < ALARM_UID_STATS - 1) {
+		alarm_uid_stats[alarm_uid_nr].uid = uid;
+		return &alarm_uid_stats[alarm_uid_nr++];
+	}
+	alarm_uid_stats[ALARM_UID_STATS - 1].uid = (uid_t)-1;
+	return &alarm_uid_stats[ALARM_UID_STATS - 1];
+}
+
 
 static int is_wakeup(enum android_alarm_type type)
 {
@@ -99,6 +138,52 @@ static void devalarm_cancel(struct devalarm *alrm)
 		hrtimer_cancel(&alrm->u.hrt);
 }
 
+static ktime_t devalarm_window(struct devalarm *alrm)
+{
+	if (alrm->window.tv64)
+		return alrm->window;
+	return ms_to_ktime(batch_window_ms);
+}
+
+/*
+ * Program the enabled wakeup alarms. When the windows of the RTC and the
+ * ELAPSED_REALTIME wakeup alarms overlap, both are set to the start of the
+ * overlap so the device wakes up once for the two; otherwise each is set to
+ * its requested time. Called with alarm_slock held.
+ */
+static void devalarm_batch(void)
+{
+	struct devalarm *rtc = &alarms[ANDROID_ALARM_RTC_WAKEUP];
+	struct devalarm *elapsed = &alarms[ANDROID_ALARM_ELAPSED_REALTIME_WAKEUP];
+	bool rtc_on = alarm_enabled & ANDROID_ALARM_RTC_WAKEUP_MASK;
+	bool elapsed_on = alarm_enabled & ANDROID_ALARM_ELAPSED_REALTIME_WAKEUP_MASK;
+	ktime_t offs, rtc_exp, start;
+
+	rtc->batched = false;
+	elapsed->batched = false;
+
+	if (rtc_on && elapsed_on) {
+		/* compare on CLOCK_BOOTTIME */
+		offs = ktime_sub(ktime_get_real(), ktime_get_boottime());
+		rtc_exp = ktime_sub(rtc->expires, offs);
+		if (ktime_compare(rtc_exp, ktime_add(elapsed->expires, devalarm_window(elapsed))) <= 0 &&
+		    ktime_compare(elapsed->expires, ktime_add(rtc_exp, devalarm_window(rtc))) <= 0) {
+			start = ktime_compare(rtc_exp, elapsed->expires) > 0 ? rtc_exp : elapsed->expires;
+			alarm_dbg(INFO, "batch wakeup alarms at %lld\n", ktime_to_ns(start));
+			devalarm_start(rtc, ktime_add(start, offs));
+			devalarm_start(elapsed, start);
+			rtc->batched = true;
+			elapsed->batched = true;
+			return;
+		}
+	}
+
+	if (rtc_on)
+		devalarm_start(rtc, rtc->expires);
+	if (elapsed_on)
+		devalarm_start(elapsed, elapsed->expires);
+}
+
 void alarm_set_power_on(struct timespec new_pwron_time, bool logo)
 {
 	unsigned long pwron_time;
@@ -159,6 +244,9 @@ static void alarm_clear(enum android_alarm_type alarm_type,
 			__pm_relax(&alarm_wake_lock);
 	}
 	alarm_enabled &= ~alarm_type_mask;
+	/* the other wakeup alarm no longer has to wait for this one */
+	if (is_wakeup(alarm_type))
+		devalarm_batch();
 	spin_unlock_irqrestore(&alarm_slock, flags);
 
 }
@@ -180,10 +268,31 @@ static void alarm_set(enum android_alarm_type alarm_type,
 
 	spin_lock_irqsave(&alarm_slock, flags);
 	alarm_enabled |= alarm_type_mask;
-	devalarm_start(&alarms[alarm_type], timespec_to_ktime(*ts));
+	alarms[alarm_type].expires = timespec_to_ktime(*ts);
+	alarms[alarm_type].uid = from_kuid(&init_user_ns, current_uid());
+	if (is_wakeup(alarm_type)) {
+		alarm_uid_stat(alarms[alarm_type].uid)->nr_set++;
+		devalarm_batch();
+	} else
+		devalarm_start(&alarms[alarm_type], alarms[alarm_type].expires);
 	spin_unlock_irqrestore(&alarm_slock, flags);
 }
 
+static int alarm_set_window(enum android_alarm_type alarm_type,
+							struct timespec *ts)
+{
+	unsigned long flags;
+
+	if (alarm_type >= ANDROID_ALARM_TYPE_COUNT || !timespec_valid(ts))
+		return -EINVAL;
+
+	spin_lock_irqsave(&alarm_slock, flags);
+	alarms[alarm_type].window = timespec_to_ktime(*ts);
+	spin_unlock_irqrestore(&alarm_slock, flags);
+
+	return 0;
+}
+
 static int alarm_wait(void)
 {
 	unsigned long flags;
@@ -327,6 +436,9 @@ static long alarm_do_ioctl(struct file *file, unsigned int cmd,
 	case ANDROID_ALARM_SET_RTC:
 		rv = alarm_set_rtc(ts);
 		break;
+	case ANDROID_ALARM_SET_WINDOW(0):
+		rv = alarm_set_window(alarm_type, ts);
+		break;
 	case ANDROID_ALARM_GET_TIME(0):
 		rv = alarm_get_time(alarm_type, ts);
 		break;
@@ -356,6 +468,7 @@ static long alarm_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 	case ANDROID_ALARM_SET(0):
 	case ANDROID_ALARM_SET_RTC:
 	case ANDROID_ALARM_SET_IPO(0):
+	case ANDROID_ALARM_SET_WINDOW(0):
 		if (copy_from_user(&ts, (void __user *)arg, sizeof(ts)))
 			return -EFAULT;
 		break;
@@ -398,6 +511,7 @@ static long alarm_compat_ioctl(struct file *file, unsigned int cmd,
 	case ANDROID_ALARM_SET_COMPAT(0):
 	case ANDROID_ALARM_SET_RTC_COMPAT:
 	case ANDROID_ALARM_SET_IPO_COMPAT(0):
+	case ANDROID_ALARM_SET_WINDOW_COMPAT(0):
 		if (compat_get_timespec(&ts, (void __user *)arg))
 			return -EFAULT;
 		/* fall through */
@@ -482,6 +596,13 @@ static void devalarm_triggered(struct devalarm *alarm)
 	alarm_dbg(INT, "%s: type %d\n", __func__, alarm->type);
 	spin_lock_irqsave(&alarm_slock, flags);
 	if (alarm_enabled & alarm_type_mask) {
+		if (is_wakeup(alarm->type)) {
+			struct alarm_uid_stat *stat = alarm_uid_stat(alarm->uid);
+
+			stat->nr_wakeup++;
+			if (alarm->batched)
+				stat->nr_batched++;
+		}
 		__pm_wakeup_event(&alarm_wake_lock, 5000); /* 5secs */
 		alarm_enabled &= ~alarm_type_mask;
 		alarm_pending |= alarm_type_mask;
@@ -527,6 +648,41 @@ static struct miscdevice alarm_device = {
 	.fops = &alarm_fops,
 };
 
+static int alarm_stats_show(struct seq_file *m, void *v)
+{
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&alarm_slock, flags);
+	seq_printf(m, "window ms: rtc_wakeup %lld, elapsed_wakeup %lld\n",
+		   ktime_to_ms(devalarm_window(&alarms[ANDROID_ALARM_RTC_WAKEUP])),
+		   ktime_to_ms(devalarm_window(&alarms[ANDROID_ALARM_ELAPSED_REALTIME_WAKEUP])));
+	seq_printf(m, "%10s %8s %8s %8s\n", "uid", "set", "wakeup", "batched");
+	for (i = 0; i < ALARM_UID_STATS; i++) {
+		struct alarm_uid_stat *stat = &alarm_uid_stats[i];
+
+		if (!stat->nr_set && !stat->nr_wakeup)
+			continue;
+		seq_printf(m, "%10d %8u %8u %8u\n", (int)stat->uid,
+			   stat->nr_set, stat->nr_wakeup, stat->nr_batched);
+	}
+	spin_unlock_irqrestore(&alarm_slock, flags);
+
+	return 0;
+}
+
+static int alarm_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, alarm_stats_show, NULL);
+}
+
+static const struct file_operations alarm_stats_fops = {
+	.open = alarm_stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static int __init alarm_dev_init(void)
 {
 	int err;
@@ -554,6 +710,7 @@ static int __init alarm_dev_init(void)
 	}
 
 	wakeup_source_init(&alarm_wake_lock, "alarm");
+	debugfs_create_file("alarm_stats", S_IRUGO, NULL, NULL, &alarm_stats_fops);
 	return 0;
 }
 
@@ -69,6 +69,8 @@ enum android_alarm_return_flags {
 #define ANDROID_ALARM_SET_AND_WAIT_IPO(type)    ALARM_IOW(9, type, struct timespec)
 #define ANDROID_ALARM_GET_POWER_ON_IPO          _IOR('a', 10, struct rtc_wkalrm)
 #define ANDROID_ALARM_WAIT_IPO                  _IO('a', 11)
+/* Let alarms of this type fire up to this much late, to batch wakeups */
+#define ANDROID_ALARM_SET_WINDOW(type)          ALARM_IOW(12, type, struct timespec)
 
 extern struct rtc_device *alarmtimer_get_rtcdev(void);
 
@@ -85,6 +87,8 @@ extern struct rtc_device *alarmtimer_get_rtcdev(void);
 							struct compat_timespec)
 #define ANDROID_ALARM_SET_AND_WAIT_IPO_COMPAT(type)		ALARM_IOW(9, type, \
 							struct compat_timespec)
+#define ANDROID_ALARM_SET_WINDOW_COMPAT(type)	ALARM_IOW(12, type, \
+							struct compat_timespec)
 #define ANDROID_ALARM_IOCTL_NR(cmd)		(_IOC_NR(cmd) & ((1<<4)-1))
 #define ANDROID_ALARM_COMPAT_TO_NORM(cmd)  \
 				ALARM_IOW(ANDROID_ALARM_IOCTL_NR(cmd), \
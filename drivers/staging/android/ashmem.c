@@ -30,6 +30,9 @@
 #include <linux/personality.h>
 #include <linux/bitops.h>
 #include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/kref.h>
+#include <linux/workqueue.h>
 #include <linux/shmem_fs.h>
 #include "ashmem.h"
 
@@ -44,9 +47,12 @@
  * @file:		The shmem-based backing file
  * @size:		The size of the mapping, in bytes
  * @prot_masks:		The allowed protection bits, as vm_flags
+ * @lock:		Protects all of the above
+ * @ref:		Held by the open file and by the purge worker
  *
  * The lifecycle of this structure is from our parent file's open() until
- * its release(). It is also protected by 'ashmem_mutex'
+ * its release() and the end of any purge in flight. It is protected by
+ * its own 'lock'
  *
  * Warning: Mappings do NOT pin this structure; It dies on close()
  */
@@ -56,19 +62,23 @@ struct ashmem_area {
 	struct file *file;
 	size_t size;
 	unsigned long prot_mask;
+	struct mutex lock;
+	struct kref ref;
 };
 
 /**
  * struct ashmem_range - A range of unpinned/evictable pages
- * @lru:	         The entry in the LRU list
+ * @lru:	         The entry in the LRU list, or in the purge list
  * @unpinned:	         The entry in its area's unpinned list
  * @asma:	         The associated anonymous shared memory area.
  * @pgstart:	         The starting page (inclusive)
  * @pgend:	         The ending page (inclusive)
  * @purged:	         The purge status (ASHMEM_NOT or ASHMEM_WAS_PURGED)
+ * @pending:	         Picked by the shrinker, waiting for the purge worker
  *
  * The lifecycle of this structure is from unpin to pin.
- * It is protected by 'ashmem_mutex'
+ * It is protected by its area's 'lock'; @lru and @pending are also
+ * protected by 'ashmem_lru_lock'
  */
 struct ashmem_range {
 	struct list_head lru;
@@ -77,24 +87,35 @@ struct ashmem_range {
 	size_t pgstart;
 	size_t pgend;
 	unsigned int purged;
+	unsigned int pending;
 };
 
-/* LRU list of unpinned pages, protected by ashmem_mutex */
+/*
+ * LRU list of unpinned pages, least recently unpinned first, and the
+ * ranges the shrinker took off it for the purge worker. Both are
+ * protected by ashmem_lru_lock.
+ */
 static LIST_HEAD(ashmem_lru_list);
+static LIST_HEAD(ashmem_purge_list);
 
 /**
  * long lru_count - The count of pages on our LRU list.
  *
- * This is protected by ashmem_mutex.
+ * This is protected by ashmem_lru_lock.
  */
 static unsigned long lru_count;
 
 /**
- * ashmem_mutex - protects the list of and each individual ashmem_area
+ * ashmem_lru_lock - protects the LRU and purge lists
  *
- * Lock Ordering: ashmex_mutex -> i_mutex -> i_alloc_sem
+ * Lock Ordering: asma->lock -> ashmem_lru_lock
+ *		  asma->lock -> i_mutex -> i_alloc_sem
  */
-static DEFINE_MUTEX(ashmem_mutex);
+static DEFINE_SPINLOCK(ashmem_lru_lock);
+
+static struct workqueue_struct *ashmem_purge_wq;
+static void ashmem_purge_work_fn(struct work_struct *work);
+static DECLARE_WORK(ashmem_purge_work, ashmem_purge_work_fn);
 
 static struct kmem_cache *ashmem_area_cachep __read_mostly;
 static struct kmem_cache *ashmem_range_cachep __read_mostly;
@@ -103,7 +124,7 @@ static struct kmem_cache *ashmem_range_cachep __read_mostly;
 	((range)->pgend - (range)->pgstart + 1)
 
 #define range_on_lru(range) \
-	((range)->purged == ASHMEM_NOT_PURGED)
+	((range)->purged == ASHMEM_NOT_PURGED && !(range)->pending)
 
 #define page_range_subsumes_range(range, start, end) \
 	(((range)->pgstart >= (start)) && ((range)->pgend <= (end)))
@@ -126,13 +147,21 @@ static struct kmem_cache *ashmem_range_cachep __read_mostly;
 /**
  * lru_add() - Adds a range of memory to the LRU list
  * @range:     The memory range being added.
+ * @age_of:    A range on the LRU list that @range is as old as, or NULL
  *
- * The range is first added to the end (tail) of the LRU list.
+ * The range is added to the end (tail) of the LRU list, i.e. as the most
+ * recently unpinned one, or right after @age_of.
  * After this, the size of the range is added to @lru_count
+ *
+ * Caller must hold ashmem_lru_lock.
  */
-static inline void lru_add(struct ashmem_range *range)
+static inline void lru_add(struct ashmem_range *range,
+			   struct ashmem_range *age_of)
 {
-	list_add_tail(&range->lru, &ashmem_lru_list);
+	if (age_of)
+		list_add(&range->lru, &age_of->lru);
+	else
+		list_add_tail(&range->lru, &ashmem_lru_list);
 	lru_count += range_size(range);
 }
 
@@ -142,6 +171,8 @@ static inline void lru_add(struct ashmem_range *range)
  *
  * The range is first deleted from the LRU list.
  * After this, the size of the range is removed from @lru_count
+ *
+ * Caller must hold ashmem_lru_lock.
  */
 static inline void lru_del(struct ashmem_range *range)
 {
@@ -149,20 +180,42 @@ static inline void lru_del(struct ashmem_range *range)
 	lru_count -= range_size(range);
 }
 
+/**
+ * range_cancel_purge() - Takes a range back from the purge worker
+ * @range:     The range about to be pinned or changed
+ *
+ * A range the shrinker picked but the worker did not purge yet goes back
+ * to the cold end of the LRU list. The worker purges under the area lock,
+ * so with that lock held a range is either pending or purged, never in
+ * between.
+ */
+static void range_cancel_purge(struct ashmem_range *range)
+{
+	spin_lock(&ashmem_lru_lock);
+	if (range->pending) {
+		range->pending = 0;
+		list_move(&range->lru, &ashmem_lru_list);
+		lru_count += range_size(range);
+	}
+	spin_unlock(&ashmem_lru_lock);
+}
+
 /**
  * range_alloc() - Allocates and initializes a new ashmem_range structure
  * @asma:	   The associated ashmem_area
  * @prev_range:	   The previous ashmem_range in the sorted asma->unpinned list
+ * @age_of:	   The range the new one was split from, or NULL if just unpinned
  * @purged:	   Initial purge status (ASMEM_NOT_PURGED or ASHMEM_WAS_PURGED)
  * @start:	   The starting page (inclusive)
  * @end:	   The ending page (inclusive)
  *
- * This function is protected by ashmem_mutex.
+ * This function is protected by asma->lock.
  *
  * Return: 0 if successful, or -ENOMEM if there is an error
  */
 static int range_alloc(struct ashmem_area *asma,
-		       struct ashmem_range *prev_range, unsigned int purged,
+		       struct ashmem_range *prev_range,
+		       struct ashmem_range *age_of, unsigned int purged,
 		       size_t start, size_t end)
 {
 	struct ashmem_range *range;
@@ -178,8 +231,10 @@ static int range_alloc(struct ashmem_area *asma,
 
 	list_add_tail(&range->unpinned, &prev_range->unpinned);
 
+	spin_lock(&ashmem_lru_lock);
 	if (range_on_lru(range))
-		lru_add(range);
+		lru_add(range, age_of && range_on_lru(age_of) ? age_of : NULL);
+	spin_unlock(&ashmem_lru_lock);
 
 	return 0;
 }
@@ -191,8 +246,12 @@ static int range_alloc(struct ashmem_area *asma,
 static void range_del(struct ashmem_range *range)
 {
 	list_del(&range->unpinned);
-	if (range_on_lru(range))
+	spin_lock(&ashmem_lru_lock);
+	if (range->pending)
+		list_del(&range->lru);
+	else if (range_on_lru(range))
 		lru_del(range);
+	spin_unlock(&ashmem_lru_lock);
 	kmem_cache_free(ashmem_range_cachep, range);
 }
 
@@ -213,11 +272,13 @@ static inline void range_shrink(struct ashmem_range *range,
 {
 	size_t pre = range_size(range);
 
+	spin_lock(&ashmem_lru_lock);
 	range->pgstart = start;
 	range->pgend = end;
 
 	if (range_on_lru(range))
 		lru_count -= pre - range_size(range);
+	spin_unlock(&ashmem_lru_lock);
 }
 
 /**
@@ -246,11 +307,22 @@ static int ashmem_open(struct inode *inode, struct file *file)
 	INIT_LIST_HEAD(&asma->unpinned_list);
 	memcpy(asma->name, ASHMEM_NAME_PREFIX, ASHMEM_NAME_PREFIX_LEN);
 	asma->prot_mask = PROT_MASK;
+	mutex_init(&asma->lock);
+	kref_init(&asma->ref);
 	file->private_data = asma;
 
 	return 0;
 }
 
+static void ashmem_area_free(struct kref *ref)
+{
+	struct ashmem_area *asma = container_of(ref, struct ashmem_area, ref);
+
+	if (asma->file)
+		fput(asma->file);
+	kmem_cache_free(ashmem_area_cachep, asma);
+}
+
 /**
  * ashmem_release() - Releases an Anonymous Shared Memory structure
  * @ignored:	      The backing file's Index Node(?) - It is ignored here.
@@ -264,14 +336,12 @@ static int ashmem_release(struct inode *ignored, struct file *file)
 	struct ashmem_area *asma = file->private_data;
 	struct ashmem_range *range, *next;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned)
 		range_del(range);
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 
-	if (asma->file)
-		fput(asma->file);
-	kmem_cache_free(ashmem_area_cachep, asma);
+	kref_put(&asma->ref, ashmem_area_free);
 
 	return 0;
 }
@@ -291,7 +361,7 @@ static ssize_t ashmem_read(struct file *file, char __user *buf,
 	struct ashmem_area *asma = file->private_data;
 	int ret = 0;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 
 	/* If size is not set, or set to 0, always return EOF. */
 	if (asma->size == 0)
@@ -302,7 +372,7 @@ static ssize_t ashmem_read(struct file *file, char __user *buf,
 		goto out_unlock;
 	}
 
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 
 	/*
 	 * asma and asma->file are used outside the lock here.  We assume
@@ -318,7 +388,7 @@ static ssize_t ashmem_read(struct file *file, char __user *buf,
 	return ret;
 
 out_unlock:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 	return ret;
 }
 
@@ -327,7 +397,7 @@ static loff_t ashmem_llseek(struct file *file, loff_t offset, int origin)
 	struct ashmem_area *asma = file->private_data;
 	int ret;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 
 	if (asma->size == 0) {
 		ret = -EINVAL;
@@ -347,7 +417,7 @@ static loff_t ashmem_llseek(struct file *file, loff_t offset, int origin)
 	file->f_pos = asma->file->f_pos;
 
 out:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 	return ret;
 }
 
@@ -363,7 +433,7 @@ static int ashmem_mmap(struct file *file, struct vm_area_struct *vma)
 	struct ashmem_area *asma = file->private_data;
 	int ret = 0;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 
 	/* user needs to SET_SIZE before mapping */
 	if (unlikely(!asma->size)) {
@@ -405,7 +475,7 @@ static int ashmem_mmap(struct file *file, struct vm_area_struct *vma)
 	}
 
 out:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 	return ret;
 }
 
@@ -419,9 +489,10 @@ out:
  * Return value is the number of objects freed or -1 if we cannot
  * proceed without risk of deadlock (due to gfp_mask).
  *
- * We approximate LRU via least-recently-unpinned, jettisoning unpinned partial
- * chunks of ashmem regions LRU-wise one-at-a-time until we hit 'nr_to_scan'
- * pages freed.
+ * We approximate LRU via least-recently-unpinned, handing unpinned partial
+ * chunks of ashmem regions LRU-wise to the purge worker until we hit
+ * 'nr_to_scan' pages. The hole punching itself is done by the worker, so
+ * reclaim neither waits for it nor blocks pin/unpin of unrelated areas.
  */
 static unsigned long
 ashmem_shrink_scan(struct shrinker *shrink, struct shrink_control *sc)
@@ -429,31 +500,71 @@ ashmem_shrink_scan(struct shrinker *shrink, struct shrink_control *sc)
 	struct ashmem_range *range, *next;
 	unsigned long freed = 0;
 
-	/* We might recurse into filesystem code, so bail out if necessary */
-	if (!(sc->gfp_mask & __GFP_FS))
-		return SHRINK_STOP;
-
-	if (!mutex_trylock(&ashmem_mutex))
-		return -1;
-
+	spin_lock(&ashmem_lru_lock);
 	list_for_each_entry_safe(range, next, &ashmem_lru_list, lru) {
-		loff_t start = range->pgstart * PAGE_SIZE;
-		loff_t end = (range->pgend + 1) * PAGE_SIZE;
-
-		range->asma->file->f_op->fallocate(range->asma->file,
-				FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
-				start, end - start);
-		range->purged = ASHMEM_WAS_PURGED;
 		lru_del(range);
+		range->pending = 1;
+		list_add_tail(&range->lru, &ashmem_purge_list);
 
 		freed += range_size(range);
 		if (--sc->nr_to_scan <= 0)
 			break;
 	}
-	mutex_unlock(&ashmem_mutex);
+	spin_unlock(&ashmem_lru_lock);
+
+	if (freed)
+		queue_work(ashmem_purge_wq, &ashmem_purge_work);
 	return freed;
 }
 
+/*
+ * ashmem_purge_work_fn - punch out what the shrinker picked, one area at a
+ * time and under that area's lock only.
+ */
+static void ashmem_purge_work_fn(struct work_struct *work)
+{
+	for (;;) {
+		struct ashmem_range *range, *next;
+		struct ashmem_area *asma;
+
+		spin_lock(&ashmem_lru_lock);
+		if (list_empty(&ashmem_purge_list)) {
+			spin_unlock(&ashmem_lru_lock);
+			break;
+		}
+		/* its ranges are still listed, so the area is not released yet */
+		asma = list_first_entry(&ashmem_purge_list, struct ashmem_range,
+					lru)->asma;
+		kref_get(&asma->ref);
+		spin_unlock(&ashmem_lru_lock);
+
+		mutex_lock(&asma->lock);
+		list_for_each_entry_safe(range, next, &asma->unpinned_list,
+					 unpinned) {
+			loff_t start = range->pgstart * PAGE_SIZE;
+			loff_t end = (range->pgend + 1) * PAGE_SIZE;
+
+			spin_lock(&ashmem_lru_lock);
+			if (!range->pending) {
+				spin_unlock(&ashmem_lru_lock);
+				continue;
+			}
+			range->pending = 0;
+			list_del(&range->lru);
+			spin_unlock(&ashmem_lru_lock);
+
+			asma->file->f_op->fallocate(asma->file,
+					FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+					start, end - start);
+			range->purged = ASHMEM_WAS_PURGED;
+		}
+		mutex_unlock(&asma->lock);
+
+		kref_put(&asma->ref, ashmem_area_free);
+		cond_resched();
+	}
+}
+
 static unsigned long
 ashmem_shrink_count(struct shrinker *shrink, struct shrink_control *sc)
 {
@@ -479,7 +590,7 @@ static int set_prot_mask(struct ashmem_area *asma, unsigned long prot)
 {
 	int ret = 0;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 
 	/* the user can only remove, not add, protection bits */
 	if (unlikely((asma->prot_mask & prot) != prot)) {
@@ -494,7 +605,7 @@ static int set_prot_mask(struct ashmem_area *asma, unsigned long prot)
 	asma->prot_mask = prot;
 
 out:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 	return ret;
 }
 
@@ -505,10 +616,10 @@ static int set_name(struct ashmem_area *asma, void __user *name)
 	char local_name[ASHMEM_NAME_LEN];
 
 	/*
-	 * Holding the ashmem_mutex while doing a copy_from_user might cause
+	 * Holding the asma->lock while doing a copy_from_user might cause
 	 * an data abort which would try to access mmap_sem. If another
 	 * thread has invoked ashmem_mmap then it will be holding the
-	 * semaphore and will be waiting for ashmem_mutex, there by leading to
+	 * semaphore and will be waiting for asma->lock, there by leading to
 	 * deadlock. We'll release the mutex  and take the name to a local
 	 * variable that does not need protection and later copy the local
 	 * variable to the structure member with lock held.
@@ -518,14 +629,14 @@ static int set_name(struct ashmem_area *asma, void __user *name)
 		return len;
 	if (len == ASHMEM_NAME_LEN)
 		local_name[ASHMEM_NAME_LEN - 1] = '\0';
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 	/* cannot change an existing mapping's name */
 	if (unlikely(asma->file))
 		ret = -EINVAL;
 	else
 		strcpy(asma->name + ASHMEM_NAME_PREFIX_LEN, local_name);
 
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 	return ret;
 }
 
@@ -541,7 +652,7 @@ static int get_name(struct ashmem_area *asma, void __user *name)
 	 */
 	char local_name[ASHMEM_NAME_LEN];
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 	if (asma->name[ASHMEM_NAME_PREFIX_LEN] != '\0') {
 
 		/*
@@ -554,7 +665,7 @@ static int get_name(struct ashmem_area *asma, void __user *name)
 		len = sizeof(ASHMEM_NAME_DEF);
 		memcpy(local_name, ASHMEM_NAME_DEF, len);
 	}
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 
 	/*
 	 * Now we are just copying from the stack variable to userland
@@ -569,7 +680,7 @@ static int get_name(struct ashmem_area *asma, void __user *name)
  * ashmem_pin - pin the given ashmem region, returning whether it was
  * previously purged (ASHMEM_WAS_PURGED) or not (ASHMEM_NOT_PURGED).
  *
- * Caller must hold ashmem_mutex.
+ * Caller must hold asma->lock.
  */
 static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 {
@@ -597,6 +708,7 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 		 *    create a new range for the other side.
 		 */
 		if (page_range_in_range(range, pgstart, pgend)) {
+			range_cancel_purge(range);
 			ret |= range->purged;
 
 			/* Case #1: Easy. Just nuke the whole thing. */
@@ -622,7 +734,7 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 			 * more complicated, we allocate a new range for the
 			 * second half and adjust the first chunk's endpoint.
 			 */
-			range_alloc(asma, range, range->purged,
+			range_alloc(asma, range, range, range->purged,
 				    pgend + 1, range->pgend);
 			range_shrink(range, range->pgstart, pgstart - 1);
 			break;
@@ -635,7 +747,7 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 /*
  * ashmem_unpin - unpin the given range of pages. Returns zero on success.
  *
- * Caller must hold ashmem_mutex.
+ * Caller must hold asma->lock.
  */
 static int ashmem_unpin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 {
@@ -663,14 +775,14 @@ restart:
 		}
 	}
 
-	return range_alloc(asma, range, purged, pgstart, pgend);
+	return range_alloc(asma, range, NULL, purged, pgstart, pgend);
 }
 
 /*
  * ashmem_get_pin_status - Returns ASHMEM_IS_UNPINNED if _any_ pages in the
  * given interval are unpinned and ASHMEM_IS_PINNED otherwise.
  *
- * Caller must hold ashmem_mutex.
+ * Caller must hold asma->lock.
  */
 static int ashmem_get_pin_status(struct ashmem_area *asma, size_t pgstart,
 				 size_t pgend)
@@ -719,7 +831,7 @@ static int ashmem_pin_unpin(struct ashmem_area *asma, unsigned long cmd,
 	pgstart = pin.offset / PAGE_SIZE;
 	pgend = pgstart + (pin.len / PAGE_SIZE) - 1;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->lock);
 
 	switch (cmd) {
 	case ASHMEM_PIN:
@@ -733,7 +845,7 @@ static int ashmem_pin_unpin(struct ashmem_area *asma, unsigned long cmd,
 		break;
 	}
 
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->lock);
 
 	return ret;
 }
@@ -781,6 +893,7 @@ static long ashmem_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 			ret = ashmem_shrink_count(&ashmem_shrinker, &sc);
 			nodes_setall(sc.nodes_to_scan);
 			ashmem_shrink_scan(&ashmem_shrinker, &sc);
+			flush_work(&ashmem_purge_work);
 		}
 		break;
 	}
@@ -845,6 +958,14 @@ static int __init ashmem_init(void)
 		return -ENOMEM;
 	}
 
+	/* purging is what frees memory under pressure */
+	ashmem_purge_wq = alloc_workqueue("ashmem_purge",
+					  WQ_UNBOUND | WQ_MEM_RECLAIM, 1);
+	if (unlikely(!ashmem_purge_wq)) {
+		pr_err("failed to create purge workqueue\n");
+		return -ENOMEM;
+	}
+
 	ret = misc_register(&ashmem_misc);
 	if (unlikely(ret)) {
 		pr_err("failed to register misc device!\n");
@@ -863,6 +984,7 @@ static void __exit ashmem_exit(void)
 	int ret;
 
 	unregister_shrinker(&ashmem_shrinker);
+	destroy_workqueue(ashmem_purge_wq);
 
 	ret = misc_deregister(&ashmem_misc);
 	if (unlikely(ret))
@@ -22,12 +22,14 @@
 #include <linux/file.h>
 #include <linux/freezer.h>
 #include <linux/fs.h>
+#include <linux/hash.h>
 #include <linux/list.h>
 #include <linux/miscdevice.h>
 #include <linux/mm.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
 #include <linux/nsproxy.h>
+#include <linux/percpu.h>
 #include <linux/poll.h>
 #include <linux/debugfs.h>
 #include <linux/rbtree.h>
@@ -136,7 +138,6 @@ static const struct file_operations binder_##name##_fops = { \
 	.release = single_release, \
 }
 
-#ifdef BINDER_MONITOR
 #define BINDER_DEBUG_SETTING_ENTRY(name) \
 static int binder_##name##_open(struct inode *inode, struct file *file) \
 { \
@@ -151,7 +152,6 @@ static const struct file_operations binder_##name##_fops = { \
 	.llseek = seq_lseek, \
 	.release = single_release, \
 }
-#endif
 
 /*LCH add, for binder pages leakage debug*/
 #ifdef CONFIG_MT_ENG_BUILD
@@ -204,6 +204,67 @@ module_param_named(debug_mask, binder_debug_mask, uint, S_IWUSR | S_IRUGO);
 static bool binder_debug_no_lock;
 module_param_named(proc_no_lock, binder_debug_no_lock, bool, S_IWUSR | S_IRUGO);
 
+/*
+ * The first prealloc_kb of every binder mmap is populated at mmap time and
+ * stays mapped until the process goes away, so transactions landing there
+ * never allocate or map pages under binder_main_lock.
+ */
+static uint binder_prealloc_kb = 16;
+module_param_named(prealloc_kb, binder_prealloc_kb, uint, S_IWUSR | S_IRUGO);
+
+/*
+ * Small buffers inside the preallocated area are rounded up to a power of
+ * two size class and, when freed, parked on a per class list instead of
+ * being merged back into free_buffers. The next transaction of that class
+ * takes one off the list without touching the rbtree.
+ */
+#define BINDER_BUF_CLASS_MIN_SHIFT	6	/* 64 bytes */
+#define BINDER_BUF_CLASS_COUNT		6	/* up to 2K */
+#define BINDER_BUF_CLASS_SIZE(c)	((size_t)1 << (BINDER_BUF_CLASS_MIN_SHIFT + (c)))
+#define BINDER_BUF_CACHE_MAX		16	/* buffers parked per class */
+
+/*
+ * Queue oneway transactions on a node's async_todo by sender priority
+ * instead of arrival. Work from the same sending process keeps its order.
+ */
+static bool binder_async_prio_order = true;
+module_param_named(async_prio_order, binder_async_prio_order, bool, S_IWUSR | S_IRUGO);
+
+/*
+ * Reply latency of synchronous transactions, bucketed per (caller proc,
+ * callee proc, code) in small per-CPU tables and read back in binary from
+ * debugfs "latency". Unlike BINDER_MONITOR this is cheap enough for user
+ * builds: one clock read at send and one table update at reply. Slots of
+ * a proc are dropped when it dies and any write to "latency" empties the
+ * tables, so a reader collects windows with read-then-write.
+ */
+static bool binder_latency_stats = true;
+module_param_named(latency_stats, binder_latency_stats, bool, S_IWUSR | S_IRUGO);
+
+#define BINDER_LAT_VERSION	1
+#define BINDER_LAT_BUCKETS	16	/* log2(us): [0] < 1us ... [15] >= 16ms */
+#define BINDER_LAT_SLOT_BITS	6
+#define BINDER_LAT_SLOTS	(1 << BINDER_LAT_SLOT_BITS)
+#define BINDER_LAT_PROBE	4
+
+struct binder_lat_slot {
+	pid_t caller;		/* 0: slot unused */
+	pid_t callee;
+	uint32_t code;
+	uint32_t count[BINDER_LAT_BUCKETS];
+	uint64_t total_us;
+};
+
+struct binder_lat_header {
+	uint32_t version;
+	uint32_t buckets;
+	uint32_t slot_size;	/* bytes per record that follows */
+	uint32_t dropped;	/* replies that found no free slot */
+};
+
+static DEFINE_PER_CPU(struct binder_lat_slot[BINDER_LAT_SLOTS], binder_lat);
+static DEFINE_PER_CPU(uint32_t, binder_lat_dropped);
+
 static DECLARE_WAIT_QUEUE_HEAD(binder_user_error_wait);
 static int binder_stop_on_user_error;
 
@@ -420,8 +481,11 @@ struct binder_ref {
 
 struct binder_buffer {
 	struct list_head entry;	/* free and allocated entries by address */
-	struct rb_node rb_node;	/* free entry by size or allocated entry */
+	union {
+		struct rb_node rb_node;	/* free entry by size or allocated entry */
 							/* by address */
+		struct list_head cache_entry;	/* parked in proc->buf_cache */
+	};
 	unsigned free:1;
 	unsigned allow_user_free:1;
 	unsigned async_transaction:1;
@@ -472,6 +536,9 @@ struct binder_proc {
 	struct rb_root free_buffers;
 	struct rb_root allocated_buffers;
 	size_t free_async_space;
+	size_t prealloc_size;	/* head of buffer kept mapped, see prealloc_kb */
+	struct list_head buf_cache[BINDER_BUF_CLASS_COUNT];
+	int buf_cache_count[BINDER_BUF_CLASS_COUNT];
 
 	struct page **pages;
 	size_t buffer_size;
@@ -540,11 +607,14 @@ struct binder_transaction {
 	long priority;
 	long saved_priority;
 	kuid_t sender_euid;
+	pid_t sender_pid;	/* binder_proc pid, keeps oneway order per sender */
+	u64 start_ns;		/* send time, for the latency histogram */
 #ifdef RT_PRIO_INHERIT
 	unsigned long rt_prio:16;
 	unsigned long policy:16;
 	unsigned long saved_rt_prio:16;
 	unsigned long saved_policy:16;
+	pid_t saved_tid;	/* thread whose policy saved_* hold */
 #endif
 #ifdef BINDER_MONITOR
 	struct timespec timestamp;
@@ -1444,6 +1514,10 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 	binder_debug(BINDER_DEBUG_BUFFER_ALLOC,
 		     "%d: %s pages %p-%p\n", proc->pid, allocate ? "allocate" : "free", start, end);
 
+	/* pages of the preallocated head are only released with the proc */
+	if (start < proc->buffer + proc->prealloc_size)
+		start = proc->buffer + proc->prealloc_size;
+
 	if (end <= start)
 		return 0;
 
@@ -1545,16 +1619,42 @@ err_no_vma:
 	return -ENOMEM;
 }
 
+static int binder_buf_class(size_t size)
+{
+	int c;
+
+	for (c = 0; c < BINDER_BUF_CLASS_COUNT; c++)
+		if (size <= BINDER_BUF_CLASS_SIZE(c))
+			return c;
+	return -1;
+}
+
+static struct binder_buffer *binder_buf_cache_get(struct binder_proc *proc, int c)
+{
+	struct binder_buffer *buffer;
+
+	if (list_empty(&proc->buf_cache[c]))
+		return NULL;
+	buffer = list_first_entry(&proc->buf_cache[c], struct binder_buffer, cache_entry);
+	list_del(&buffer->cache_entry);
+	proc->buf_cache_count[c]--;
+	binder_insert_allocated_buffer(proc, buffer);
+	return buffer;
+}
+
+static int binder_buf_cache_flush(struct binder_proc *proc);
+
 static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 					      size_t data_size, size_t offsets_size, int is_async)
 {
-	struct rb_node *n = proc->free_buffers.rb_node;
+	struct rb_node *n;
 	struct binder_buffer *buffer;
 	size_t buffer_size;
-	struct rb_node *best_fit = NULL;
+	struct rb_node *best_fit;
 	void *has_page_addr;
 	void *end_page_addr;
-	size_t size;
+	size_t size, alloc_size;
+	int cls;
 #ifdef MTK_BINDER_DEBUG
 	size_t proc_max_size;
 #endif
@@ -1597,15 +1697,29 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 		return NULL;
 	}
 
+	alloc_size = size;
+	cls = proc->prealloc_size ? binder_buf_class(size) : -1;
+	if (cls >= 0) {
+		buffer = binder_buf_cache_get(proc, cls);
+		if (buffer) {
+			buffer_size = binder_buffer_size(proc, buffer);
+			goto got_buffer;
+		}
+		alloc_size = BINDER_BUF_CLASS_SIZE(cls);
+	}
+
+retry:
+	n = proc->free_buffers.rb_node;
+	best_fit = NULL;
 	while (n) {
 		buffer = rb_entry(n, struct binder_buffer, rb_node);
 		BUG_ON(!buffer->free);
 		buffer_size = binder_buffer_size(proc, buffer);
 
-		if (size < buffer_size) {
+		if (alloc_size < buffer_size) {
 			best_fit = n;
 			n = n->rb_left;
-		} else if (size > buffer_size)
+		} else if (alloc_size > buffer_size)
 			n = n->rb_right;
 		else {
 			best_fit = n;
@@ -1622,6 +1736,11 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 		}
 	}
 #endif
+	/* parked buffers and class rounding must not make a transaction fail */
+	if (best_fit == NULL && (binder_buf_cache_flush(proc) || alloc_size != size)) {
+		alloc_size = size;
+		goto retry;
+	}
 	if (best_fit == NULL) {
 		pr_err("%d: binder_alloc_buf size %zd failed, no address space\n", proc->pid, size);
 #ifdef BINDER_MONITOR
@@ -1636,14 +1755,14 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 
 	binder_debug(BINDER_DEBUG_BUFFER_ALLOC,
 		     "%d: binder_alloc_buf size %zd got buffer %p size %zd\n",
-		     proc->pid, size, buffer, buffer_size);
+		     proc->pid, alloc_size, buffer, buffer_size);
 
 	has_page_addr = (void *)(((uintptr_t) buffer->data + buffer_size) & PAGE_MASK);
 	if (n == NULL) {
-		if (size + sizeof(struct binder_buffer) + 4 >= buffer_size)
-			buffer_size = size;	/* no room for other buffers */
+		if (alloc_size + sizeof(struct binder_buffer) + 4 >= buffer_size)
+			buffer_size = alloc_size;	/* no room for other buffers */
 		else
-			buffer_size = size + sizeof(struct binder_buffer);
+			buffer_size = alloc_size + sizeof(struct binder_buffer);
 	}
 	end_page_addr = (void *)PAGE_ALIGN((uintptr_t) buffer->data + buffer_size);
 	if (end_page_addr > has_page_addr)
@@ -1656,13 +1775,14 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 	rb_erase(best_fit, &proc->free_buffers);
 	buffer->free = 0;
 	binder_insert_allocated_buffer(proc, buffer);
-	if (buffer_size != size) {
-		struct binder_buffer *new_buffer = (void *)buffer->data + size;
+	if (buffer_size != alloc_size) {
+		struct binder_buffer *new_buffer = (void *)buffer->data + alloc_size;
 
 		list_add(&new_buffer->entry, &buffer->entry);
 		new_buffer->free = 1;
 		binder_insert_free_buffer(proc, new_buffer);
 	}
+got_buffer:
 	binder_debug(BINDER_DEBUG_BUFFER_ALLOC,
 		     "%d: binder_alloc_buf size %zd got %p\n", proc->pid, size, buffer);
 	buffer->data_size = data_size;
@@ -1732,6 +1852,51 @@ static void binder_delete_free_buffer(struct binder_proc *proc, struct binder_bu
 	}
 }
 
+static void binder_merge_free_buf(struct binder_proc *proc,
+				  struct binder_buffer *buffer, size_t buffer_size);
+
+/*
+ * Park a freed buffer on its size class list. Only buffers that lie wholly
+ * in the preallocated head qualify, so no page ever needs releasing for them.
+ */
+static int binder_buf_cache_put(struct binder_proc *proc,
+				struct binder_buffer *buffer, size_t buffer_size)
+{
+	int c;
+
+	if ((void *)buffer->data + buffer_size > proc->buffer + proc->prealloc_size)
+		return 0;
+	for (c = BINDER_BUF_CLASS_COUNT - 1; c >= 0; c--)
+		if (buffer_size >= BINDER_BUF_CLASS_SIZE(c))
+			break;
+	if (c < 0 || buffer_size >= 2 * BINDER_BUF_CLASS_SIZE(c) ||
+	    proc->buf_cache_count[c] >= BINDER_BUF_CACHE_MAX)
+		return 0;
+	list_add(&buffer->cache_entry, &proc->buf_cache[c]);
+	proc->buf_cache_count[c]++;
+	return 1;
+}
+
+/* give every parked buffer back to free_buffers, returns how many */
+static int binder_buf_cache_flush(struct binder_proc *proc)
+{
+	struct binder_buffer *buffer;
+	int c, flushed = 0;
+
+	for (c = 0; c < BINDER_BUF_CLASS_COUNT; c++) {
+		while (!list_empty(&proc->buf_cache[c])) {
+			buffer = list_first_entry(&proc->buf_cache[c],
+						  struct binder_buffer, cache_entry);
+			list_del(&buffer->cache_entry);
+			proc->buf_cache_count[c]--;
+			binder_merge_free_buf(proc, buffer,
+					      binder_buffer_size(proc, buffer));
+			flushed++;
+		}
+	}
+	return flushed;
+}
+
 static void binder_free_buf(struct binder_proc *proc, struct binder_buffer *buffer)
 {
 	size_t size, buffer_size;
@@ -1762,11 +1927,20 @@ static void binder_free_buf(struct binder_proc *proc, struct binder_buffer *buff
 			     proc->pid, size, proc->free_async_space);
 	}
 
+	rb_erase(&buffer->rb_node, &proc->allocated_buffers);
+	if (binder_buf_cache_put(proc, buffer, buffer_size))
+		return;
+	binder_merge_free_buf(proc, buffer, buffer_size);
+}
+
+/* return a buffer that is in neither rbtree to free_buffers */
+static void binder_merge_free_buf(struct binder_proc *proc,
+				  struct binder_buffer *buffer, size_t buffer_size)
+{
 	binder_update_page_range(proc, 0,
 				 (void *)PAGE_ALIGN((uintptr_t) buffer->data),
 				 (void
 				  *)(((uintptr_t) buffer->data + buffer_size) & PAGE_MASK), NULL);
-	rb_erase(&buffer->rb_node, &proc->allocated_buffers);
 	buffer->free = 1;
 	if (!list_is_last(&buffer->entry, &proc->buffers)) {
 		struct binder_buffer *next = list_entry(buffer->entry.next,
@@ -2235,6 +2409,105 @@ static void mt_sched_setscheduler_nocheck(struct task_struct *p, int policy,
 }
 #endif
 
+static void binder_latency_record(struct binder_transaction *t, pid_t callee)
+{
+	struct binder_lat_slot *slots, *slot;
+	unsigned long flags;
+	u64 latency_us;
+	u32 key;
+	int i, bucket;
+
+	if (!t->start_ns)
+		return;
+	latency_us = div_u64(ktime_get_ns() - t->start_ns, NSEC_PER_USEC);
+	trace_binder_transaction_latency(t, callee, latency_us);
+	if (!binder_latency_stats)
+		return;
+
+	bucket = latency_us ? fls64(latency_us) : 0;
+	if (bucket >= BINDER_LAT_BUCKETS)
+		bucket = BINDER_LAT_BUCKETS - 1;
+	key = hash_32(t->sender_pid ^ (callee << 16) ^ t->code, BINDER_LAT_SLOT_BITS);
+
+	/* irqs off: binder_lat_clear() runs from IPI on this CPU */
+	local_irq_save(flags);
+	slots = *this_cpu_ptr(&binder_lat);
+	for (i = 0; i < BINDER_LAT_PROBE; i++) {
+		slot = &slots[(key + i) & (BINDER_LAT_SLOTS - 1)];
+		if (!slot->caller) {
+			slot->caller = t->sender_pid;
+			slot->callee = callee;
+			slot->code = t->code;
+		} else if (slot->caller != t->sender_pid || slot->callee != callee ||
+			   slot->code != t->code) {
+			continue;
+		}
+		slot->count[bucket]++;
+		slot->total_us += latency_us;
+		break;
+	}
+	if (i == BINDER_LAT_PROBE)
+		__this_cpu_inc(binder_lat_dropped);
+	local_irq_restore(flags);
+}
+
+/*
+ * Empty this CPU's slots of proc @info, or all of them for 0. A live key
+ * probing past a freed slot may take it again and show up twice, which
+ * readers already sum like the per-CPU duplicates.
+ */
+static void binder_lat_clear(void *info)
+{
+	pid_t pid = (pid_t)(long)info;
+	struct binder_lat_slot *slots = *this_cpu_ptr(&binder_lat);
+	int i;
+
+	for (i = 0; i < BINDER_LAT_SLOTS; i++) {
+		if (!slots[i].caller)
+			continue;
+		if (!pid || slots[i].caller == pid || slots[i].callee == pid)
+			memset(&slots[i], 0, sizeof(slots[i]));
+	}
+	if (!pid)
+		__this_cpu_write(binder_lat_dropped, 0);
+}
+
+/* kernel prio scale, lower is more urgent */
+static int binder_transaction_prio(struct binder_transaction *t)
+{
+#ifdef RT_PRIO_INHERIT
+	if (t->policy == SCHED_FIFO || t->policy == SCHED_RR)
+		return MAX_RT_PRIO - 1 - t->rt_prio;
+#endif
+	return NICE_TO_PRIO(t->priority);
+}
+
+/*
+ * Put a oneway transaction on node->async_todo behind everything at least
+ * as urgent, but never ahead of earlier work from its own sender.
+ */
+static void binder_enqueue_async(struct binder_node *node,
+				 struct binder_transaction *t)
+{
+	struct binder_work *w;
+	struct binder_transaction *q;
+	int prio = binder_transaction_prio(t);
+
+	if (!binder_async_prio_order) {
+		list_add_tail(&t->work.entry, &node->async_todo);
+		return;
+	}
+	list_for_each_entry_reverse(w, &node->async_todo, entry) {
+		q = container_of(w, struct binder_transaction, work);
+		if (q->sender_pid == t->sender_pid ||
+		    binder_transaction_prio(q) <= prio) {
+			list_add(&t->work.entry, &w->entry);
+			return;
+		}
+	}
+	list_add(&t->work.entry, &node->async_todo);
+}
+
 #ifdef BINDER_MONITOR
 /* binder_update_transaction_time - update read/exec done time for transaction
 ** step:
@@ -2383,10 +2656,10 @@ static void binder_transaction(struct binder_proc *proc,
 #endif
 		binder_set_nice(in_reply_to->saved_priority);
 #ifdef RT_PRIO_INHERIT
+		/* drop the inherited policy now, not when the looper next idles */
 		if (rt_task(current)
 		    && (MAX_RT_PRIO != in_reply_to->saved_rt_prio)
-		    && !(thread->looper & (BINDER_LOOPER_STATE_REGISTERED |
-					   BINDER_LOOPER_STATE_ENTERED))) {
+		    && in_reply_to->saved_tid == current->pid) {
 			struct sched_param param = {
 				.sched_priority = in_reply_to->saved_rt_prio,
 			};
@@ -2438,6 +2711,7 @@ static void binder_transaction(struct binder_proc *proc,
 			goto err_dead_binder;
 		}
 		target_proc = target_thread->proc;
+		binder_latency_record(in_reply_to, proc->pid);
 #ifdef BINDER_MONITOR
 		e->service[0] = '\0';
 #endif
@@ -2578,6 +2852,8 @@ static void binder_transaction(struct binder_proc *proc,
 	else
 		t->from = NULL;
 	t->sender_euid = task_euid(proc->tsk);
+	t->sender_pid = proc->pid;
+	t->start_ns = binder_latency_stats ? ktime_get_ns() : 0;
 	t->to_proc = target_proc;
 	t->to_thread = target_thread;
 	t->code = tr->code;
@@ -2587,6 +2863,7 @@ static void binder_transaction(struct binder_proc *proc,
 	t->rt_prio = current->rt_priority;
 	t->policy = current->policy;
 	t->saved_rt_prio = MAX_RT_PRIO;
+	t->saved_tid = 0;
 #endif
 
 	trace_binder_transaction(reply, t, target_node);
@@ -2858,7 +3135,10 @@ static void binder_transaction(struct binder_proc *proc,
 			target_node->has_async_transaction = 1;
 	}
 	t->work.type = BINDER_WORK_TRANSACTION;
-	list_add_tail(&t->work.entry, target_list);
+	if (target_node && target_list == &target_node->async_todo)
+		binder_enqueue_async(target_node, t);
+	else
+		list_add_tail(&t->work.entry, target_list);
 	tcomplete->type = BINDER_WORK_TRANSACTION_COMPLETE;
 	list_add_tail(&tcomplete->entry, &thread->todo);
 #ifdef RT_PRIO_INHERIT
@@ -2894,6 +3174,7 @@ static void binder_transaction(struct binder_proc *proc,
 
 				t->saved_rt_prio = tsk->rt_priority;
 				t->saved_policy = tsk->policy;
+				t->saved_tid = tsk->pid;
 				mt_sched_setscheduler_nocheck(tsk, t->policy, &param);
 #ifdef BINDER_MONITOR
 				if (log_disable & BINDER_RT_LOG_ENABLE) {
@@ -3707,6 +3988,7 @@ retry:
 
 				t->saved_rt_prio = current->rt_priority;
 				t->saved_policy = current->policy;
+				t->saved_tid = current->pid;
 				mt_sched_setscheduler_nocheck(current, t->policy, &param);
 #ifdef BINDER_MONITOR
 				if (log_disable & BINDER_RT_LOG_ENABLE) {
@@ -4247,6 +4529,8 @@ static int binder_mmap(struct file *filp, struct vm_area_struct *vma)
 	struct binder_proc *proc = filp->private_data;
 	const char *failure_string;
 	struct binder_buffer *buffer;
+	size_t prealloc_size;
+	int i;
 
 	if (proc->tsk != current)
 		return -EINVAL;
@@ -4307,11 +4591,20 @@ static int binder_mmap(struct file *filp, struct vm_area_struct *vma)
 	vma->vm_ops = &binder_vm_ops;
 	vma->vm_private_data = proc;
 
-	if (binder_update_page_range(proc, 1, proc->buffer, proc->buffer + PAGE_SIZE, vma)) {
+	prealloc_size = PAGE_ALIGN((size_t)binder_prealloc_kb * SZ_1K);
+	if (prealloc_size < PAGE_SIZE)
+		prealloc_size = PAGE_SIZE;
+	if (prealloc_size > proc->buffer_size)
+		prealloc_size = proc->buffer_size;
+	if (binder_update_page_range(proc, 1, proc->buffer,
+				     proc->buffer + prealloc_size, vma)) {
 		ret = -ENOMEM;
 		failure_string = "alloc small buf";
 		goto err_alloc_small_buf_failed;
 	}
+	proc->prealloc_size = prealloc_size;
+	for (i = 0; i < BINDER_BUF_CLASS_COUNT; i++)
+		INIT_LIST_HEAD(&proc->buf_cache[i]);
 	buffer = proc->buffer;
 	INIT_LIST_HEAD(&proc->buffers);
 	list_add(&buffer->entry, &proc->buffers);
@@ -4513,6 +4806,9 @@ static void binder_deferred_release(struct binder_proc *proc)
 
 	hlist_del(&proc->proc_node);
 
+	if (binder_latency_stats)
+		on_each_cpu(binder_lat_clear, (void *)(long)proc->pid, 1);
+
 	if (binder_context_mgr_node && binder_context_mgr_node->proc == proc) {
 		binder_debug(BINDER_DEBUG_DEAD_BINDER,
 			     "%s: %d context_mgr_node gone\n", __func__, proc->pid);
@@ -5487,6 +5783,41 @@ static int binder_page_used_show(struct seq_file *s, void *p)
 BINDER_DEBUG_ENTRY(page_used);
 #endif
 
+/*
+ * Binary: a binder_lat_header, then one binder_lat_slot per used slot of
+ * every CPU. The same (caller, callee, code) may appear once per CPU.
+ */
+static int binder_latency_show(struct seq_file *s, void *p)
+{
+	struct binder_lat_header hdr = {
+		.version = BINDER_LAT_VERSION,
+		.buckets = BINDER_LAT_BUCKETS,
+		.slot_size = sizeof(struct binder_lat_slot),
+	};
+	struct binder_lat_slot *slots;
+	int cpu, i;
+
+	for_each_possible_cpu(cpu)
+		hdr.dropped += per_cpu(binder_lat_dropped, cpu);
+	seq_write(s, &hdr, sizeof(hdr));
+	for_each_possible_cpu(cpu) {
+		slots = per_cpu(binder_lat, cpu);
+		for (i = 0; i < BINDER_LAT_SLOTS; i++)
+			if (slots[i].caller)
+				seq_write(s, &slots[i], sizeof(slots[i]));
+	}
+	return 0;
+}
+
+static ssize_t binder_latency_write(struct file *filp, const char __user *ubuf,
+				    size_t cnt, loff_t *ppos)
+{
+	on_each_cpu(binder_lat_clear, NULL, 1);
+	return cnt;
+}
+
+BINDER_DEBUG_SETTING_ENTRY(latency);
+
 BINDER_DEBUG_ENTRY(state);
 BINDER_DEBUG_ENTRY(stats);
 BINDER_DEBUG_ENTRY(transactions);
@@ -5568,6 +5899,9 @@ static int __init binder_init(void)
 				    binder_debugfs_dir_entry_root,
 				    &binder_timeout_log_t, &binder_timeout_log_fops);
 #endif
+		debugfs_create_file("latency",
+				    (S_IRUGO | S_IWUSR),
+				    binder_debugfs_dir_entry_root, NULL, &binder_latency_fops);
 #ifdef MTK_BINDER_PAGE_USED_RECORD
 		debugfs_create_file("page_used",
 				    S_IRUGO,
@@ -144,6 +144,29 @@ TRACE_EVENT(binder_transaction_received,
 	TP_printk("transaction=%d", __entry->debug_id)
 );
 
+TRACE_EVENT(binder_transaction_latency,
+	TP_PROTO(struct binder_transaction *t, int to_proc, u64 latency_us),
+	TP_ARGS(t, to_proc, latency_us),
+
+	TP_STRUCT__entry(
+		__field(int, debug_id)
+		__field(int, from_proc)
+		__field(int, to_proc)
+		__field(unsigned int, code)
+		__field(u64, latency_us)
+	),
+	TP_fast_assign(
+		__entry->debug_id = t->debug_id;
+		__entry->from_proc = t->sender_pid;
+		__entry->to_proc = to_proc;
+		__entry->code = t->code;
+		__entry->latency_us = latency_us;
+	),
+	TP_printk("transaction=%d from_proc=%d to_proc=%d code=0x%x latency_us=%llu",
+		  __entry->debug_id, __entry->from_proc, __entry->to_proc,
+		  __entry->code, __entry->latency_us)
+);
+
 TRACE_EVENT(binder_transaction_node_to_ref,
 	TP_PROTO(struct binder_transaction *t, struct binder_node *node,
 		 struct binder_ref *ref),
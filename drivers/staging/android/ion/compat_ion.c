@@ -75,6 +75,17 @@ struct compat_ion_sys_client_name {
 	char name[ION_MM_DBG_NAME_LEN];
 };
 
+/* only 32 bit members: same layout as struct ion_sys_cache_sync_batch_param */
+struct compat_ion_sys_cache_sync_batch_param {
+	compat_uint_t count;
+	struct {
+		compat_int_t handle;
+		compat_uint_t offset;
+		compat_uint_t size;
+		compat_uint_t sync_type;
+	} range[ION_CACHE_SYNC_BATCH_MAX];
+};
+
 struct compat_ion_sys_get_client_param {
 	compat_uint_t client;
 };
@@ -87,6 +98,7 @@ struct compat_ion_sys_data {
 		struct compat_ion_sys_get_client_param get_client_param;
 		struct compat_ion_sys_client_name client_name_param;
 		struct compat_ion_dma_param dma_param;
+		struct compat_ion_sys_cache_sync_batch_param cache_sync_batch_param;
 	};
 };
 
@@ -584,6 +596,12 @@ static int compat_get_ion_sys_data(
 		err |= compat_get_ion_sys_dma_op_param(&data32->dma_param, &data->dma_param);
 		break;
 	}
+	case ION_SYS_CACHE_SYNC_BATCH:
+	{
+		err |= copy_in_user(&data->cache_sync_batch_param, &data32->cache_sync_batch_param,
+				sizeof(data->cache_sync_batch_param)) ? -EFAULT : 0;
+		break;
+	}
 	}
 
 	return err;
@@ -29,6 +29,7 @@
 #include <linux/mm.h>
 #include <linux/mm_types.h>
 #include <linux/rbtree.h>
+#include <linux/rcupdate.h>
 #include <linux/slab.h>
 #include <linux/seq_file.h>
 #include <linux/uaccess.h>
@@ -414,7 +415,18 @@ static void ion_handle_destroy(struct kref *kref)
 	handle->buffer = NULL;
 	handle->client = NULL;
 
-	kfree(handle);
+	/* ion_handle_get_by_id() may still look at the refcount */
+	kfree_rcu(handle, rcu);
+}
+
+/* kref_put_mutex() release: entered with client->lock held, drops it */
+static void ion_handle_destroy_unlock(struct kref *kref)
+{
+	struct ion_handle *handle = container_of(kref, struct ion_handle, ref);
+	struct ion_client *client = handle->client;
+
+	ion_handle_destroy(kref);
+	mutex_unlock(&client->lock);
 }
 
 struct ion_buffer *ion_handle_buffer(struct ion_handle *handle)
@@ -430,13 +442,10 @@ static void ion_handle_get(struct ion_handle *handle)
 static int ion_handle_put(struct ion_handle *handle)
 {
 	struct ion_client *client = handle->client;
-	int ret;
 
-	mutex_lock(&client->lock);
-	ret = kref_put(&handle->ref, ion_handle_destroy);
-	mutex_unlock(&client->lock);
-
-	return ret;
+	/* only the last reference needs client->lock */
+	return kref_put_mutex(&handle->ref, ion_handle_destroy_unlock,
+			      &client->lock);
 }
 
 static struct ion_handle *ion_handle_lookup(struct ion_client *client,
@@ -462,11 +471,15 @@ static struct ion_handle *ion_handle_get_by_id(struct ion_client *client,
 {
 	struct ion_handle *handle;
 
-	mutex_lock(&client->lock);
+	/*
+	 * client->lock is only taken to add and remove handles. A handle
+	 * found here may already be on its way out, then its refcount is 0.
+	 */
+	rcu_read_lock();
 	handle = idr_find(&client->idr, id);
-	if (handle)
-		ion_handle_get(handle);
-	mutex_unlock(&client->lock);
+	if (handle && !kref_get_unless_zero(&handle->ref))
+		handle = NULL;
+	rcu_read_unlock();
 
 	return handle ? handle : ERR_PTR(-EINVAL);
 }
@@ -478,6 +491,20 @@ static bool ion_handle_validate(struct ion_client *client,
 	return idr_find(&client->idr, handle->id) == handle;
 }
 
+/* lockless ion_handle_validate(), the handle is only usable if it returns true */
+static bool ion_handle_validate_get(struct ion_client *client,
+				    struct ion_handle *handle)
+{
+	bool valid;
+
+	rcu_read_lock();
+	valid = idr_find(&client->idr, handle->id) == handle &&
+		kref_get_unless_zero(&handle->ref);
+	rcu_read_unlock();
+
+	return valid;
+}
+
 static int ion_handle_add(struct ion_client *client, struct ion_handle *handle)
 {
 	int id;
@@ -627,9 +654,7 @@ int ion_phys(struct ion_client *client, struct ion_handle *handle,
 	MMProfileLogEx(ION_MMP_Events[PROFILE_GET_PHYS], MMProfileFlagStart,
 		(unsigned long)client, (unsigned long)handle);
 
-	mutex_lock(&client->lock);
-	if (!ion_handle_validate(client, handle)) {
-		mutex_unlock(&client->lock);
+	if (!ion_handle_validate_get(client, handle)) {
 		IONMSG("%s invalid handle pass to phys.\n", __func__);
 		return -EINVAL;
 	}
@@ -639,13 +664,13 @@ int ion_phys(struct ion_client *client, struct ion_handle *handle,
 	if (!buffer->heap->ops->phys) {
 		pr_err("%s: ion_phys is not implemented by this heap.\n",
 		       __func__);
-		mutex_unlock(&client->lock);
+		ion_handle_put(handle);
 		return -ENODEV;
 	}
-	mutex_unlock(&client->lock);
 	ret = buffer->heap->ops->phys(buffer->heap, buffer, addr, len);
 
 	MMProfileLogEx(ION_MMP_Events[PROFILE_GET_PHYS], MMProfileFlagEnd, buffer->size, *addr);
+	ion_handle_put(handle);
 
 	return ret;
 }
@@ -1898,17 +1923,13 @@ struct ion_handle *ion_drv_get_handle(struct ion_client *client, int user_handle
 			return ERR_PTR(-EINVAL);
 		}
 
-		mutex_lock(&client->lock);
-		if (!ion_handle_validate(client, handle)) {
+		if (!ion_handle_validate_get(client, handle)) {
 			IONMSG("%s handle invalid, handle=0x%p\n", __func__, handle);
-			mutex_unlock(&client->lock);
 			return ERR_PTR(-EINVAL);
 		}
-		ion_handle_get(handle);
-		mutex_unlock(&client->lock);
 	} else {
 		handle = ion_handle_get_by_id(client, user_handle);
-		if (!handle) {
+		if (IS_ERR(handle)) {
 			IONMSG("%s handle invalid, handle_id=%d\n", __func__, user_handle);
 			return ERR_PTR(-EINVAL);
 		}
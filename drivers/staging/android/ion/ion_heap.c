@@ -22,6 +22,7 @@
 #include <linux/sched.h>
 #include <linux/scatterlist.h>
 #include <linux/vmalloc.h>
+#include <mt-plat/mt_wq.h>
 #include "mtk/mtk_ion.h"
 #include "ion.h"
 #include "ion_priv.h"
@@ -283,6 +284,7 @@ int ion_heap_init_deferred_free(struct ion_heap *heap)
 		return PTR_ERR_OR_ZERO(heap->task);
 	}
 	sched_setscheduler(heap->task, SCHED_IDLE, &param);
+	set_cpus_allowed_ptr(heap->task, mt_little_cpumask());
 	return 0;
 }
 
@@ -18,15 +18,33 @@
 #include <linux/dma-mapping.h>
 #include <linux/err.h>
 #include <linux/fs.h>
+#include <linux/highmem.h>
 #include <linux/list.h>
 #include <linux/module.h>
 #include <linux/slab.h>
 #include <linux/swap.h>
+#include <mt-plat/mt_page_pool.h>
 #include "ion_priv.h"
 
-static void *ion_page_pool_alloc_pages(struct ion_page_pool *pool)
+/* how long the prefill stays away from a pool after it got shrunk */
+#define ION_POOL_FILL_BACKOFF	(5 * HZ)
+
+#ifdef CONFIG_ION_SHARED_POOL
+#define ION_SHARED_POOL_ORDERS	9
+
+/* one pool per order, set once and kept for good */
+static struct ion_page_pool *shared_pools[ION_SHARED_POOL_ORDERS];
+static DEFINE_MUTEX(shared_pools_lock);
+
+/* cap on the pools for pages given back through mt_page_pool_put() */
+static unsigned int shared_pool_max_kb = 64 * 1024;
+module_param(shared_pool_max_kb, uint, S_IRUGO | S_IWUSR);
+#endif
+
+static void *ion_page_pool_alloc_pages(struct ion_page_pool *pool,
+				       gfp_t gfp_mask)
 {
-	struct page *page = alloc_pages(pool->gfp_mask, pool->order);
+	struct page *page = alloc_pages(gfp_mask, pool->order);
 
 	if (!page)
 		return NULL;
@@ -76,12 +94,10 @@ static struct page *ion_page_pool_remove(struct ion_page_pool *pool, bool high)
 	return page;
 }
 
-struct page *ion_page_pool_alloc(struct ion_page_pool *pool)
+static struct page *ion_page_pool_take(struct ion_page_pool *pool)
 {
 	struct page *page = NULL;
 
-	BUG_ON(!pool);
-
 	mutex_lock(&pool->mutex);
 	if (pool->high_count)
 		page = ion_page_pool_remove(pool, true);
@@ -89,8 +105,18 @@ struct page *ion_page_pool_alloc(struct ion_page_pool *pool)
 		page = ion_page_pool_remove(pool, false);
 	mutex_unlock(&pool->mutex);
 
+	return page;
+}
+
+struct page *ion_page_pool_alloc(struct ion_page_pool *pool)
+{
+	struct page *page;
+
+	BUG_ON(!pool);
+
+	page = ion_page_pool_take(pool);
 	if (!page)
-		page = ion_page_pool_alloc_pages(pool);
+		page = ion_page_pool_alloc_pages(pool, pool->gfp_mask);
 
 	return page;
 }
@@ -121,8 +147,8 @@ static int ion_page_pool_total(struct ion_page_pool *pool, bool high)
 	return count << pool->order;
 }
 
-int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
-				int nr_to_scan)
+static int __ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
+				  int nr_to_scan)
 {
 	int freed;
 	bool high;
@@ -135,6 +161,8 @@ int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
 	if (nr_to_scan == 0)
 		return ion_page_pool_total(pool, high);
 
+	pool->shrink_stamp = jiffies;
+
 	for (freed = 0; freed < nr_to_scan; freed++) {
 		struct page *page;
 
@@ -154,6 +182,50 @@ int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
 	return freed;
 }
 
+int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
+				int nr_to_scan)
+{
+	/* shared pools are left to ion_shared_pool_shrinker */
+	if (pool->shared)
+		return 0;
+
+	return __ion_page_pool_shrink(pool, gfp_mask, nr_to_scan);
+}
+
+#ifdef CONFIG_ION_POOL_PREFILL
+int ion_page_pool_fill(struct ion_page_pool *pool, int nr_pages)
+{
+	/* pool->gfp_mask carries __GFP_ZERO, but no reclaim on behalf of a pool */
+	gfp_t gfp_mask = (pool->gfp_mask | __GFP_NORETRY | __GFP_NOWARN |
+			  __GFP_NO_KSWAPD) & ~__GFP_WAIT;
+	int added = 0;
+
+	for (;;) {
+		struct page *page;
+		int count;
+
+		if (time_before(jiffies,
+				pool->shrink_stamp + ION_POOL_FILL_BACKOFF))
+			break;
+
+		mutex_lock(&pool->mutex);
+		count = (pool->high_count + pool->low_count) << pool->order;
+		mutex_unlock(&pool->mutex);
+		if (count >= nr_pages)
+			break;
+
+		page = ion_page_pool_alloc_pages(pool, gfp_mask);
+		if (!page)
+			break;
+		ion_page_pool_add(pool, page);
+		added += 1 << pool->order;
+		cond_resched();
+	}
+
+	return added;
+}
+#endif
+
 struct ion_page_pool *ion_page_pool_create(gfp_t gfp_mask, unsigned int order)
 {
 	struct ion_page_pool *pool = kmalloc(sizeof(struct ion_page_pool),
@@ -168,19 +240,158 @@ struct ion_page_pool *ion_page_pool_create(gfp_t gfp_mask, unsigned int order)
 	INIT_LIST_HEAD(&pool->high_items);
 	pool->gfp_mask = gfp_mask | __GFP_COMP;
 	pool->order = order;
+	pool->shared = false;
 	mutex_init(&pool->mutex);
 	plist_node_init(&pool->list, order);
+	pool->shrink_stamp = jiffies - ION_POOL_FILL_BACKOFF;
 
 	return pool;
 }
 
 void ion_page_pool_destroy(struct ion_page_pool *pool)
 {
+	if (pool->shared)
+		return;
 	kfree(pool);
 }
 
+#ifdef CONFIG_ION_SHARED_POOL
+/*
+ * The uncached pools of the system and multimedia heaps, and the pages
+ * other drivers hand over through mt_page_pool_put(), all live in one pool
+ * per order. Every page in them is zeroed and clean to memory. Only
+ * ion_shared_pool_shrinker shrinks them; the heap shrinkers skip them.
+ */
+struct ion_page_pool *ion_page_pool_get_shared(gfp_t gfp_mask,
+					       unsigned int order)
+{
+	struct ion_page_pool *pool;
+
+	if (order >= ION_SHARED_POOL_ORDERS)
+		return ion_page_pool_create(gfp_mask, order);
+
+	mutex_lock(&shared_pools_lock);
+	pool = shared_pools[order];
+	if (!pool) {
+		/* the first user's gfp_mask is used when the pool is empty */
+		pool = ion_page_pool_create(gfp_mask, order);
+		if (pool) {
+			pool->shared = true;
+			shared_pools[order] = pool;
+		}
+	}
+	mutex_unlock(&shared_pools_lock);
+
+	return pool;
+}
+
+static struct ion_page_pool *ion_shared_pool(unsigned int order)
+{
+	if (order >= ION_SHARED_POOL_ORDERS)
+		return NULL;
+
+	return ACCESS_ONCE(shared_pools[order]);
+}
+
+static unsigned long ion_shared_pool_pages(void)
+{
+	unsigned long total = 0;
+	int i;
+
+	for (i = 0; i < ION_SHARED_POOL_ORDERS; i++) {
+		struct ion_page_pool *pool = ion_shared_pool(i);
+
+		if (pool)
+			total += (pool->high_count + pool->low_count) << i;
+	}
+
+	return total;
+}
+
+struct page *mt_page_pool_get(unsigned int order)
+{
+	struct ion_page_pool *pool = ion_shared_pool(order);
+
+	if (!pool)
+		return NULL;
+
+	return ion_page_pool_take(pool);
+}
+EXPORT_SYMBOL(mt_page_pool_get);
+
+bool mt_page_pool_put(struct page *page)
+{
+	unsigned int order = compound_order(page);
+	struct ion_page_pool *pool = ion_shared_pool(order);
+	int i;
+
+	if (!pool)
+		return false;
+	if (ion_shared_pool_pages() >=
+	    shared_pool_max_kb >> (PAGE_SHIFT - 10))
+		return false;
+
+	for (i = 0; i < (1 << order); i++)
+		clear_highpage(page + i);
+	ion_pages_sync_for_device(NULL, page, PAGE_SIZE << order,
+						DMA_BIDIRECTIONAL);
+	ion_page_pool_add(pool, page);
+
+	return true;
+}
+EXPORT_SYMBOL(mt_page_pool_put);
+
+static unsigned long ion_shared_pool_count(struct shrinker *shrinker,
+					   struct shrink_control *sc)
+{
+	unsigned long total = 0;
+	int i;
+
+	for (i = 0; i < ION_SHARED_POOL_ORDERS; i++) {
+		struct ion_page_pool *pool = ion_shared_pool(i);
+
+		if (pool)
+			total += __ion_page_pool_shrink(pool, sc->gfp_mask, 0);
+	}
+
+	return total;
+}
+
+static unsigned long ion_shared_pool_scan(struct shrinker *shrinker,
+					  struct shrink_control *sc)
+{
+	unsigned long freed = 0;
+	int i;
+
+	/* largest orders first, they give back the most per page */
+	for (i = ION_SHARED_POOL_ORDERS - 1; i >= 0; i--) {
+		struct ion_page_pool *pool = ion_shared_pool(i);
+		int nr;
+
+		if (freed >= sc->nr_to_scan)
+			break;
+		if (!pool)
+			continue;
+
+		nr = DIV_ROUND_UP(sc->nr_to_scan - freed, 1 << i);
+		freed += __ion_page_pool_shrink(pool, sc->gfp_mask, nr) << i;
+	}
+
+	return freed;
+}
+
+static struct shrinker ion_shared_pool_shrinker = {
+	.count_objects = ion_shared_pool_count,
+	.scan_objects = ion_shared_pool_scan,
+	.seeks = DEFAULT_SEEKS,
+};
+#endif
+
 static int __init ion_page_pool_init(void)
 {
+#ifdef CONFIG_ION_SHARED_POOL
+	register_shrinker(&ion_shared_pool_shrinker);
+#endif
 	return 0;
 }
 
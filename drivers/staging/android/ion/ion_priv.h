@@ -107,9 +107,12 @@ struct ion_handle_debug {
  * @node:		node in the client's handle rbtree
  * @kmap_cnt:		count of times this client has mapped to kernel
  * @id:			client-unique id allocated by client->idr
+ * @rcu:		handles are freed after a grace period
  *
  * Modifications to node, map_cnt or mapping should be protected by the
  * lock in the client.  Other fields are never changed after initialization.
+ * Lookups by id may run under rcu_read_lock() only, and must take their
+ * reference with kref_get_unless_zero().
  */
 struct ion_handle {
 	struct kref ref;
@@ -118,6 +121,7 @@ struct ion_handle {
 	struct rb_node node;
 	unsigned int kmap_cnt;
 	int id;
+	struct rcu_head rcu;
 #if ION_RUNTIME_DEBUGGER
 	struct ion_handle_debug dbg; /* add by K for debug */
 #endif
@@ -462,6 +466,9 @@ int ion_device_destroy_heaps(struct ion_device *dev, int need_lock);
  * @gfp_mask:		gfp_mask to use from alloc
  * @order:		order of pages in the pool
  * @list:		plist node for list of pools
+ * @shrink_stamp:	jiffies of the last shrink, holds off prefill
+ * @shared:		one of the shared per-order pools, see
+ *			ion_page_pool_get_shared()
  *
  * Allows you to keep a pool of pre allocated pages to use from your heap.
  * Keeping a pool of pages that is ready for dma, ie any cached mapping have
@@ -477,6 +484,8 @@ struct ion_page_pool {
 	gfp_t gfp_mask;
 	unsigned int order;
 	struct plist_node list;
+	unsigned long shrink_stamp;
+	bool shared;
 };
 
 struct ion_page_pool *ion_page_pool_create(gfp_t gfp_mask, unsigned int order);
@@ -485,6 +494,25 @@ struct page *ion_page_pool_alloc(struct ion_page_pool *);
 void ion_page_pool_free(struct ion_page_pool *, struct page *);
 void ion_page_pool_free_immediate(struct ion_page_pool *, struct page *);
 
+/** ion_page_pool_get_shared - the pool of @order shared by all heaps
+ * @gfp_mask:		gfp_mask to use from alloc, if the pool is created
+ * @order:		order of pages in the pool
+ *
+ * The pool also backs mt_page_pool_get()/put() for the GPU driver. It is
+ * shrunk by its own shrinker, ion_page_pool_shrink() leaves it alone, and
+ * ion_page_pool_destroy() does not free it.
+ */
+#ifdef CONFIG_ION_SHARED_POOL
+struct ion_page_pool *ion_page_pool_get_shared(gfp_t gfp_mask,
+					       unsigned int order);
+#else
+static inline struct ion_page_pool *ion_page_pool_get_shared(gfp_t gfp_mask,
+							     unsigned int order)
+{
+	return ion_page_pool_create(gfp_mask, order);
+}
+#endif
+
 #ifdef CONFIG_ION_POOL_CACHE_POLICY
 static inline void ion_page_pool_alloc_set_cache_policy
 				(struct ion_page_pool *pool,
@@ -525,6 +553,24 @@ static inline void ion_page_pool_free_set_cache_policy
 int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
 			  int nr_to_scan);
 
+/** ion_page_pool_fill - tops the pool up with pre-zeroed pages
+ * @pool:		the pool
+ * @nr_pages:		pool size to fill up to, in pages
+ *
+ * Meant for a background worker: never enters reclaim, and does nothing
+ * for a while after the shrinker took pages from the pool.
+ *
+ * returns the number of pages added
+ */
+#ifdef CONFIG_ION_POOL_PREFILL
+int ion_page_pool_fill(struct ion_page_pool *pool, int nr_pages);
+#else
+static inline int ion_page_pool_fill(struct ion_page_pool *pool, int nr_pages)
+{
+	return 0;
+}
+#endif
+
 /**
  * ion_pages_sync_for_device - cache flush pages for use with the specified
  *                             device
@@ -19,10 +19,13 @@
 #include <linux/err.h>
 #include <linux/highmem.h>
 #include <linux/mm.h>
+#include <linux/moduleparam.h>
 #include <linux/scatterlist.h>
 #include <linux/seq_file.h>
 #include <linux/slab.h>
 #include <linux/vmalloc.h>
+#include <linux/workqueue.h>
+#include <mt-plat/mt_wq.h>
 #include "ion.h"
 #include "ion_priv.h"
 
@@ -47,11 +50,43 @@ static inline unsigned int order_to_size(int order)
 	return PAGE_SIZE << order;
 }
 
+#ifdef CONFIG_ION_POOL_PREFILL
+/* per order (orders[]) pool size, in KB, kept filled with zeroed pages */
+static unsigned int prefill_kb[] = {8192, 4096, 1024};
+module_param_array(prefill_kb, uint, NULL, S_IRUGO | S_IWUSR);
+#endif
+
 struct ion_system_heap {
 	struct ion_heap heap;
+#ifdef CONFIG_ION_POOL_PREFILL
+	struct work_struct fill_work;
+#endif
 	struct ion_page_pool *pools[0];
 };
 
+#ifdef CONFIG_ION_POOL_PREFILL
+static void ion_system_heap_fill(struct work_struct *work)
+{
+	struct ion_system_heap *sys_heap = container_of(work,
+							struct ion_system_heap,
+							fill_work);
+	int i;
+
+	for (i = 0; i < num_orders; i++)
+		ion_page_pool_fill(sys_heap->pools[i],
+				   prefill_kb[i] >> (PAGE_SHIFT - 10));
+}
+
+static inline void ion_system_heap_kick_fill(struct ion_system_heap *sys_heap)
+{
+	mt_queue_work(MT_WQ_LITTLE, &sys_heap->fill_work);
+}
+#else
+static inline void ion_system_heap_kick_fill(struct ion_system_heap *sys_heap)
+{
+}
+#endif
+
 static struct page *alloc_buffer_page(struct ion_system_heap *heap,
 				      struct ion_buffer *buffer,
 				      unsigned long order)
@@ -167,6 +202,7 @@ static int ion_system_heap_allocate(struct ion_heap *heap,
 	}
 
 	buffer->priv_virt = table;
+	ion_system_heap_kick_fill(sys_heap);
 	return 0;
 
 free_table:
@@ -280,13 +316,17 @@ struct ion_heap *ion_system_heap_create(struct ion_platform_heap *unused)
 
 		if (orders[i] > 4)
 			gfp_flags = high_order_gfp_flags;
-		pool = ion_page_pool_create(gfp_flags, orders[i]);
+		pool = ion_page_pool_get_shared(gfp_flags, orders[i]);
 		if (!pool)
 			goto destroy_pools;
 		heap->pools[i] = pool;
 	}
 
 	heap->heap.debug_show = ion_system_heap_debug_show;
+#ifdef CONFIG_ION_POOL_PREFILL
+	INIT_WORK(&heap->fill_work, ion_system_heap_fill);
+#endif
+	ion_system_heap_kick_fill(heap);
 	return &heap->heap;
 
 destroy_pools:
@@ -303,6 +343,9 @@ void ion_system_heap_destroy(struct ion_heap *heap)
 							heap);
 	int i;
 
+#ifdef CONFIG_ION_POOL_PREFILL
+	cancel_work_sync(&sys_heap->fill_work);
+#endif
 	for (i = 0; i < num_orders; i++)
 		ion_page_pool_destroy(sys_heap->pools[i]);
 	kfree(sys_heap);
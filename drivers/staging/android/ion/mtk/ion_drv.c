@@ -25,10 +25,12 @@
 #include <linux/export.h>
 #include <mmprofile.h>
 #include <linux/vmalloc.h>
+#include <linux/moduleparam.h>
 #include "ion_profile.h"
 #include <linux/debugfs.h>
 #include "ion_priv.h"
 #include "ion_drv_priv.h"
+#include <mt-plat/mt_cache_sync.h>
 #include "mtk/mtk_ion.h"
 #include "mtk/ion_drv.h"
 
@@ -51,39 +53,6 @@ EXPORT_SYMBOL(g_ion_device);
 #define dmac_flush_range __dma_flush_range
 #endif
 
-static int __ion_cache_sync_kernel(unsigned long start, size_t size,
-		ION_CACHE_SYNC_TYPE sync_type) {
-	unsigned long end = start + size;
-
-	start = (start / L1_CACHE_BYTES * L1_CACHE_BYTES);
-	size = (end - start + L1_CACHE_BYTES - 1) / L1_CACHE_BYTES * L1_CACHE_BYTES;
-	/* L1 cache sync */
-	if ((sync_type == ION_CACHE_CLEAN_BY_RANGE)) {
-		MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_CLEAN_RANGE],
-				MMProfileFlagStart, size, 0);
-		/* IONMSG("[ion_sys_cache_sync]: ION cache clean by range. start=0x%08X size=0x%08X\n",
-		 * start, size); */
-		dmac_map_area((void *) start, size, DMA_TO_DEVICE);
-		MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_CLEAN_RANGE], MMProfileFlagEnd, size, 0);
-	} else if ((sync_type == ION_CACHE_INVALID_BY_RANGE)) {
-		MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_INVALID_RANGE],
-				MMProfileFlagStart, size, 0);
-		/* IONMSG("[ion_sys_cache_sync]: ION cache invalid by range. start=0x%08X size=0x%08X\n",
-		 * start, size); */
-		dmac_unmap_area((void *) start, size, DMA_FROM_DEVICE);
-		MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_INVALID_RANGE], MMProfileFlagEnd, size, 0);
-	} else if ((sync_type == ION_CACHE_FLUSH_BY_RANGE)) {
-		MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_FLUSH_RANGE],
-				MMProfileFlagStart, size, 0);
-		/* IONMSG("[ion_sys_cache_sync]: ION cache flush by range. start=0x%08X size=0x%08X\n",
-		 * start, size); */
-		dmac_flush_range((void *) start, (void *) (start + size - 1));
-		MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_FLUSH_RANGE], MMProfileFlagEnd, size, 0);
-	}
-
-	return 0;
-}
-
 static struct vm_struct *cache_map_vm_struct;
 static int ion_cache_sync_init(void)
 {
@@ -115,13 +84,24 @@ static void ion_cache_unmap_page_va(unsigned long va)
 /* lock to protect cache_map_vm_struct */
 static DEFINE_MUTEX(gIon_cache_sync_user_lock);
 
+static enum mt_cache_sync_op ion_cache_sync_op(ION_CACHE_SYNC_TYPE sync_type)
+{
+	if (sync_type == ION_CACHE_CLEAN_BY_RANGE)
+		return MT_CACHE_SYNC_CLEAN;
+	if (sync_type == ION_CACHE_INVALID_BY_RANGE)
+		return MT_CACHE_SYNC_INVALIDATE;
+	return MT_CACHE_SYNC_FLUSH;
+}
+
 static long ion_sys_cache_sync(struct ion_client *client,
 		ion_sys_cache_sync_param_t *pParam, int from_kernel) {
+	long ret = 0;
+
 	ION_FUNC_ENTER;
 	if (pParam->sync_type < ION_CACHE_CLEAN_ALL) {
 		/* By range operation */
-		unsigned long start = -1;
 		struct ion_handle *kernel_handle;
+		struct mt_cache_range range;
 
 		kernel_handle = ion_drv_get_handle(client, pParam->handle,
 				pParam->kernel_handle, from_kernel);
@@ -130,99 +110,11 @@ static long ion_sys_cache_sync(struct ion_client *client,
 			return -EINVAL;
 		}
 
-		{
-			struct ion_buffer *buffer;
-			struct scatterlist *sg;
-			int i, j;
-			struct sg_table *table = NULL;
-			int npages = 0;
-
-			mutex_lock(&client->lock);
-			/*if (!ion_handle_validate(client, kernel_handle)) {
-			 pr_err("%s: invalid handle.\n", __func__);
-			 mutex_unlock(&client->lock);
-			 return -EINVAL;
-			 }
-			 */
-			buffer = kernel_handle->buffer;
-
-			table = buffer->sg_table;
-			npages = PAGE_ALIGN(buffer->size) / PAGE_SIZE;
-
-			mutex_lock(&gIon_cache_sync_user_lock);
-
-			if (!cache_map_vm_struct) {
-				IONMSG(" error: cache_map_vm_struct is NULL, retry\n");
-				ion_cache_sync_init();
-			}
-
-			if (!cache_map_vm_struct) {
-				IONMSG("error: cache_map_vm_struct is NULL, no vmalloc area\n");
-				mutex_unlock(&gIon_cache_sync_user_lock);
-				mutex_unlock(&client->lock);
-				return -ENOMEM;
-			}
-
-			for_each_sg(table->sgl, sg, table->nents, i) {
-				int npages_this_entry = PAGE_ALIGN(sg->length) / PAGE_SIZE;
-				struct page *page = sg_page(sg);
-
-				BUG_ON(i >= npages);
-				for (j = 0; j < npages_this_entry; j++) {
-					start = (unsigned long) ion_cache_map_page_va(page++);
-
-					if (IS_ERR_OR_NULL((void *) start)) {
-						IONMSG("cannot do cache sync: ret=%lu\n", start);
-						mutex_unlock(&gIon_cache_sync_user_lock);
-						mutex_unlock(&client->lock);
-						return -EFAULT;
-					}
-
-					__ion_cache_sync_kernel(start, PAGE_SIZE, pParam->sync_type);
-
-					ion_cache_unmap_page_va(start);
-				}
-			}
-
-			mutex_unlock(&gIon_cache_sync_user_lock);
-			mutex_unlock(&client->lock);
-		}
-
-#if 0
-		size_t size = 0;
-		unsigned long end, page_num, page_start;
-
-		/* Cache line align */
-		end = start + size;
-		start = (start / L1_CACHE_BYTES * L1_CACHE_BYTES);
-		size = (end - start + L1_CACHE_BYTES - 1) / L1_CACHE_BYTES * L1_CACHE_BYTES;
-		page_num = ((start&(~PAGE_MASK))+size+(~PAGE_MASK))>>PAGE_ORDER;
-		page_start = start & PAGE_MASK;
-
-		/* L2 cache sync */
-		/* printk("[ion_sys_cache_sync]: page_start=0x%08X, page_num=%d\n", page_start, page_num); */
-		for (i = 0; i < page_num; i++, page_start += DEFAULT_PAGE_SIZE) {
-			phys_addr_t phys_addr;
-
-			if (page_start >= VMALLOC_START && page_start <= VMALLOC_END) {
-				ppage = vmalloc_to_page((void *)page_start);
-				if (!ppage) {
-					IONMSG("[ion_sys_cache_sync]: Cannot get vmalloc page. addr=0x%08X\n",
-							page_start);
-					ion_unmap_kernel(client, pParam->handle);
-					return -EFAULT;
-				}
-				phys_addr = page_to_phys(ppage);
-			} else
-				phys_addr = virt_to_phys((void *)page_start);
-			if (pParam->sync_type == ION_CACHE_CLEAN_BY_RANGE)
-				outer_clean_range(phys_addr, phys_addr+DEFAULT_PAGE_SIZE);
-			else if (pParam->sync_type == ION_CACHE_INVALID_BY_RANGE)
-				outer_inv_range(phys_addr, phys_addr+DEFAULT_PAGE_SIZE);
-			else if (pParam->sync_type == ION_CACHE_FLUSH_BY_RANGE)
-				outer_flush_range(phys_addr, phys_addr+DEFAULT_PAGE_SIZE);
-		}
-#endif
+		range.table = kernel_handle->buffer->sg_table;
+		range.start = 0;
+		range.size = kernel_handle->buffer->size;
+		range.op = ion_cache_sync_op(pParam->sync_type);
+		ret = mt_cache_sync(&range, 1);
 
 		ion_drv_put_kernel_handle(kernel_handle);
 	} else {
@@ -249,7 +141,7 @@ static long ion_sys_cache_sync(struct ion_client *client,
 		}
 	}
 	ION_FUNC_LEAVE;
-	return 0;
+	return ret;
 }
 
 int ion_sys_copy_client_name(const char *src, char *dst)
@@ -282,7 +174,6 @@ long ion_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from
 		return -EINVAL;
 	}
 
-	mutex_lock(&client->lock);
 	buffer = kernel_handle->buffer;
 
 	table = buffer->sg_table;
@@ -298,7 +189,7 @@ long ion_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from
 	if (!cache_map_vm_struct) {
 		IONMSG("error: cache_map_vm_struct is NULL, no vmalloc area\n");
 		mutex_unlock(&gIon_cache_sync_user_lock);
-		mutex_unlock(&client->lock);
+		ion_drv_put_kernel_handle(kernel_handle);
 		return -ENOMEM;
 	}
 
@@ -313,7 +204,7 @@ long ion_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from
 			if (IS_ERR_OR_NULL((void *)start)) {
 				IONMSG("cannot do cache sync: ret=%lu\n", start);
 				mutex_unlock(&gIon_cache_sync_user_lock);
-				mutex_unlock(&client->lock);
+				ion_drv_put_kernel_handle(kernel_handle);
 				return -EFAULT;
 			}
 
@@ -327,7 +218,6 @@ long ion_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from
 	}
 
 	mutex_unlock(&gIon_cache_sync_user_lock);
-	mutex_unlock(&client->lock);
 
 	ion_drv_put_kernel_handle(kernel_handle);
 
@@ -363,6 +253,95 @@ void ion_cache_flush_all(void)
 	MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_FLUSH_ALL], MMProfileFlagEnd, 1, 1);
 }
 
+struct ion_cache_sync_req {
+	struct ion_buffer *buffer;
+	unsigned long start;
+	unsigned long end;
+	ION_CACHE_SYNC_TYPE sync_type;
+};
+
+/*
+ * Sync the ranges of several buffers at once: overlapping ranges of the
+ * same buffer are merged (a flush where their types differ) and handed to
+ * mt_cache_sync() together, so it decides on the merged total.
+ */
+static long ion_sys_cache_sync_batch(struct ion_client *client,
+		ion_sys_cache_sync_batch_param_t *pParam)
+{
+	struct ion_handle *handles[ION_CACHE_SYNC_BATCH_MAX];
+	struct ion_cache_sync_req req[ION_CACHE_SYNC_BATCH_MAX], tmp;
+	struct mt_cache_range ranges[ION_CACHE_SYNC_BATCH_MAX];
+	unsigned int count = pParam->count;
+	int i, j, n = 0;
+	long ret = 0;
+
+	if (!count || count > ION_CACHE_SYNC_BATCH_MAX)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		ion_sys_cache_sync_range_t *range = &pParam->range[i];
+		struct ion_handle *kernel_handle;
+		struct ion_buffer *buffer;
+
+		if (range->sync_type >= ION_CACHE_CLEAN_ALL) {
+			ret = -EINVAL;
+			goto out;
+		}
+
+		kernel_handle = ion_drv_get_handle(client, range->handle, NULL, 0);
+		if (IS_ERR(kernel_handle)) {
+			pr_err("ion cache sync batch fail!\n");
+			ret = -EINVAL;
+			goto out;
+		}
+		handles[n++] = kernel_handle;
+
+		buffer = kernel_handle->buffer;
+		if (range->offset >= buffer->size) {
+			ret = -EINVAL;
+			goto out;
+		}
+		req[i].buffer = buffer;
+		req[i].start = range->offset;
+		req[i].end = (!range->size || range->size > buffer->size - range->offset) ?
+			buffer->size : range->offset + range->size;
+		req[i].sync_type = range->sync_type;
+	}
+
+	/* order by buffer and start, then merge in place */
+	for (i = 1; i < n; i++) {
+		tmp = req[i];
+		for (j = i; j > 0 && (req[j - 1].buffer > tmp.buffer ||
+		     (req[j - 1].buffer == tmp.buffer && req[j - 1].start > tmp.start)); j--)
+			req[j] = req[j - 1];
+		req[j] = tmp;
+	}
+
+	for (i = 0, j = 0; i < n; i++) {
+		if (j && req[j - 1].buffer == req[i].buffer && req[i].start <= req[j - 1].end) {
+			req[j - 1].end = max(req[j - 1].end, req[i].end);
+			if (req[j - 1].sync_type != req[i].sync_type)
+				req[j - 1].sync_type = ION_CACHE_FLUSH_BY_RANGE;
+			continue;
+		}
+		req[j] = req[i];
+		j++;
+	}
+
+	for (i = 0; i < j; i++) {
+		ranges[i].table = req[i].buffer->sg_table;
+		ranges[i].start = req[i].start;
+		ranges[i].size = req[i].end - req[i].start;
+		ranges[i].op = ion_cache_sync_op(req[i].sync_type);
+	}
+	ret = mt_cache_sync(ranges, j);
+
+out:
+	for (i = 0; i < n; i++)
+		ion_drv_put_kernel_handle(handles[i]);
+	return ret;
+}
+
 static long ion_sys_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from_kernel)
 {
 	long ret = 0;
@@ -399,6 +378,9 @@ static long ion_sys_ioctl(struct ion_client *client, unsigned int cmd,
 	case ION_SYS_CACHE_SYNC:
 		ret = ion_sys_cache_sync(client, &Param.cache_sync_param, from_kernel);
 		break;
+	case ION_SYS_CACHE_SYNC_BATCH:
+		ret = ion_sys_cache_sync_batch(client, &Param.cache_sync_batch_param);
+		break;
 	case ION_SYS_GET_PHYS:
 	{
 		struct ion_handle *kernel_handle;
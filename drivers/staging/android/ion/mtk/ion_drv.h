@@ -28,6 +28,7 @@ typedef enum {
 	ION_SYS_SET_HANDLE_BACKTRACE,
 	ION_SYS_SET_CLIENT_NAME,
 	ION_SYS_DMA_OP,
+	ION_SYS_CACHE_SYNC_BATCH,
 } ION_SYS_CMDS;
 
 typedef enum {
@@ -53,6 +54,21 @@ typedef struct ion_sys_cache_sync_param {
 	ION_CACHE_SYNC_TYPE sync_type;
 } ion_sys_cache_sync_param_t;
 
+/* ranges of one ION_SYS_CACHE_SYNC_BATCH, e.g. the planes of one frame */
+#define ION_CACHE_SYNC_BATCH_MAX 4
+
+typedef struct ion_sys_cache_sync_range {
+	ion_user_handle_t handle;
+	unsigned int offset;
+	unsigned int size;	/* 0: up to the end of the buffer */
+	ION_CACHE_SYNC_TYPE sync_type;	/* a *_BY_RANGE type */
+} ion_sys_cache_sync_range_t;
+
+typedef struct ion_sys_cache_sync_batch_param {
+	unsigned int count;
+	ion_sys_cache_sync_range_t range[ION_CACHE_SYNC_BATCH_MAX];
+} ion_sys_cache_sync_batch_param_t;
+
 typedef enum {
 	ION_DMA_MAP_AREA,
 	ION_DMA_UNMAP_AREA,
@@ -121,6 +137,7 @@ typedef struct ion_sys_data {
 		ion_sys_client_name_t client_name_param;
 		ion_sys_record_t record_param;
 		ion_sys_dma_param_t dma_param;
+		ion_sys_cache_sync_batch_param_t cache_sync_batch_param;
 	};
 } ion_sys_data_t;
 
@@ -182,6 +199,7 @@ long ion_kernel_ioctl(struct ion_client *client, unsigned int cmd, unsigned long
 struct ion_handle *ion_drv_get_handle(struct ion_client *client, int user_handle,
 					struct ion_handle *kernel_handle, int from_kernel);
 int ion_drv_put_kernel_handle(void *kernel_handle);
+void ion_cache_flush_all(void);
 
 /**
  * ion_mm_heap_total_memory() - get mm heap total buffer size.
@@ -12,6 +12,9 @@
 #include <mmprofile.h>
 #include <linux/debugfs.h>
 #include <linux/kthread.h>
+#include <linux/moduleparam.h>
+#include <linux/workqueue.h>
+#include <mt-plat/mt_wq.h>
 #include "mtk/mtk_ion.h"
 #include "ion_profile.h"
 #include "ion_drv_priv.h"
@@ -30,6 +33,9 @@ typedef struct {
 	ion_mm_buf_debug_info_t dbg_info;
 	ion_mm_sf_buf_info_t sf_buf_info;
 	ion_mm_buf_destroy_callback_t *destroy_fn;
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	int recycled;	/* MVA inherited from the buffer cache, not yet configured */
+#endif
 } ion_mm_buffer_info;
 
 #define ION_FUNC_ENTER  /* MMProfileLogMetaString(MMP_ION_DEBUG, MMProfileFlagStart, __func__); */
@@ -66,12 +72,47 @@ static unsigned int order_to_size(int order)
 	return PAGE_SIZE << order;
 }
 
+#ifdef CONFIG_ION_POOL_PREFILL
+/* per order (orders[]) uncached pool size, in KB, kept filled with zeroed pages */
+static unsigned int prefill_kb[] = { 16384, 4096 };
+module_param_array(prefill_kb, uint, NULL, S_IRUGO | S_IWUSR);
+#endif
+
 struct ion_system_heap {
 	struct ion_heap heap;
 	struct ion_page_pool **pools;
 	struct ion_page_pool **cached_pools;
+#ifdef CONFIG_ION_POOL_PREFILL
+	struct work_struct fill_work;
+#endif
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	struct mutex cache_lock;
+	struct list_head cache;		/* most recently freed first */
+	size_t cache_size;
+	struct delayed_work cache_work;
+#endif
 };
 
+#ifdef CONFIG_ION_POOL_PREFILL
+static void ion_mm_heap_fill(struct work_struct *work)
+{
+	struct ion_system_heap *sys_heap = container_of(work, struct ion_system_heap, fill_work);
+	int i;
+
+	for (i = 0; i < num_orders; i++)
+		ion_page_pool_fill(sys_heap->pools[i], prefill_kb[i] >> (PAGE_SHIFT - 10));
+}
+
+static inline void ion_mm_heap_kick_fill(struct ion_system_heap *sys_heap)
+{
+	mt_queue_work(MT_WQ_LITTLE, &sys_heap->fill_work);
+}
+#else
+static inline void ion_mm_heap_kick_fill(struct ion_system_heap *sys_heap)
+{
+}
+#endif
+
 struct page_info {
 	struct page *page;
 	unsigned int order;
@@ -123,6 +164,201 @@ static void free_buffer_page(struct ion_system_heap *heap,
 	}
 }
 
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+/*
+ * Recently freed buffers, kept with their sg_table and, unless secure,
+ * their M4U mapping, so a camera/video pipeline reallocating the same
+ * size and flags gets them back without the page allocator or the
+ * IOMMU. Pages are zeroed at free time as for the page pools.
+ */
+static unsigned int cache_max_kb = 64 * 1024;
+module_param(cache_max_kb, uint, S_IRUGO | S_IWUSR);
+static unsigned int cache_ttl_ms = 3000;
+module_param(cache_ttl_ms, uint, S_IRUGO | S_IWUSR);
+static bool cache_mva = true;
+module_param(cache_mva, bool, S_IRUGO | S_IWUSR);
+
+struct ion_mm_cache_entry {
+	struct list_head list;
+	struct sg_table *table;
+	ion_mm_buffer_info *info;
+	size_t size;
+	unsigned long flags;
+	unsigned long stamp;
+};
+
+static bool ion_mm_cache_wanted(struct ion_buffer *buffer)
+{
+	return buffer->size <= (size_t)cache_max_kb * 1024 &&
+		!(buffer->private_flags & ION_PRIV_FLAG_SHRINKER_FREE);
+}
+
+static void ion_mm_cache_free_entry(struct ion_mm_cache_entry *e)
+{
+	struct scatterlist *sg;
+	int i;
+
+	if (e->info->MVA)
+		m4u_dealloc_mva_sg(e->info->eModuleID, e->table, e->size, e->info->MVA);
+	kfree(e->info);
+
+	for_each_sg(e->table->sgl, sg, e->table->nents, i)
+		__free_pages(sg_page(sg), get_order(sg->length));
+	sg_free_table(e->table);
+	kfree(e->table);
+	kfree(e);
+}
+
+/* drop entries from the cold end until @keep bytes are left; returns pages dropped */
+static unsigned long ion_mm_cache_trim(struct ion_system_heap *heap, size_t keep,
+		unsigned long older_than)
+{
+	struct ion_mm_cache_entry *e, *tmp;
+	LIST_HEAD(victims);
+	unsigned long freed = 0;
+
+	mutex_lock(&heap->cache_lock);
+	list_for_each_entry_safe_reverse(e, tmp, &heap->cache, list) {
+		if (heap->cache_size <= keep &&
+		    (!older_than || time_after(e->stamp, older_than)))
+			break;
+		list_move(&e->list, &victims);
+		heap->cache_size -= e->size;
+	}
+	mutex_unlock(&heap->cache_lock);
+
+	list_for_each_entry_safe(e, tmp, &victims, list) {
+		freed += PAGE_ALIGN(e->size) >> PAGE_SHIFT;
+		ion_mm_cache_free_entry(e);
+	}
+
+	return freed;
+}
+
+static void ion_mm_cache_expire(struct work_struct *work)
+{
+	struct ion_system_heap *heap = container_of(to_delayed_work(work),
+			struct ion_system_heap, cache_work);
+	unsigned long ttl = msecs_to_jiffies(cache_ttl_ms);
+
+	ion_mm_cache_trim(heap, (size_t)cache_max_kb * 1024, jiffies - ttl);
+
+	mutex_lock(&heap->cache_lock);
+	if (!list_empty(&heap->cache))
+		schedule_delayed_work(&heap->cache_work, ttl);
+	mutex_unlock(&heap->cache_lock);
+}
+
+/* called at release time: the mapping outlives the handle, its users must not */
+static void ion_mm_cache_release_info(struct ion_buffer *buffer)
+{
+	ion_mm_buffer_info *pBufferInfo = (ion_mm_buffer_info *) buffer->priv_virt;
+
+	if (!pBufferInfo)
+		return;
+
+	mutex_lock(&(pBufferInfo->lock));
+	if ((pBufferInfo->destroy_fn) && (pBufferInfo->MVA))
+		pBufferInfo->destroy_fn(buffer, pBufferInfo->MVA);
+	pBufferInfo->destroy_fn = NULL;
+
+	if ((!cache_mva || pBufferInfo->security) && (pBufferInfo->eModuleID != -1) &&
+	    (pBufferInfo->MVA)) {
+		m4u_dealloc_mva_sg(pBufferInfo->eModuleID, buffer->sg_table, buffer->size,
+				pBufferInfo->MVA);
+		pBufferInfo->MVA = 0;
+	}
+	mutex_unlock(&(pBufferInfo->lock));
+}
+
+/* takes over the (zeroed) pages and mapping of @buffer; false if it must be freed */
+static bool ion_mm_cache_put(struct ion_system_heap *heap, struct ion_buffer *buffer)
+{
+	struct ion_mm_cache_entry *e;
+
+	if (!ion_mm_cache_wanted(buffer) || !buffer->priv_virt)
+		return false;
+
+	e = kmalloc(sizeof(*e), GFP_KERNEL);
+	if (!e)
+		return false;
+
+	ion_mm_cache_release_info(buffer);
+	e->table = buffer->sg_table;
+	e->info = buffer->priv_virt;
+	e->size = buffer->size;
+	e->flags = buffer->flags;
+	e->stamp = jiffies;
+	buffer->priv_virt = NULL;
+
+	ion_mm_cache_trim(heap, (size_t)cache_max_kb * 1024 - e->size, 0);
+
+	mutex_lock(&heap->cache_lock);
+	list_add(&e->list, &heap->cache);
+	heap->cache_size += e->size;
+	mutex_unlock(&heap->cache_lock);
+
+	schedule_delayed_work(&heap->cache_work, msecs_to_jiffies(cache_ttl_ms));
+
+	return true;
+}
+
+static bool ion_mm_cache_get(struct ion_system_heap *heap, struct ion_buffer *buffer,
+		unsigned long size, unsigned long flags)
+{
+	struct ion_mm_cache_entry *e, *found = NULL;
+	ion_mm_buffer_info *pBufferInfo;
+
+	mutex_lock(&heap->cache_lock);
+	list_for_each_entry(e, &heap->cache, list) {
+		if (e->size == size && e->flags == flags) {
+			list_del(&e->list);
+			heap->cache_size -= e->size;
+			found = e;
+			break;
+		}
+	}
+	mutex_unlock(&heap->cache_lock);
+
+	if (!found)
+		return false;
+
+	pBufferInfo = found->info;
+	memset(&pBufferInfo->dbg_info, 0, sizeof(pBufferInfo->dbg_info));
+	strncpy((pBufferInfo->dbg_info.dbg_name), "nothing", ION_MM_DBG_NAME_LEN);
+	memset(&pBufferInfo->sf_buf_info, 0, sizeof(pBufferInfo->sf_buf_info));
+	pBufferInfo->pVA = 0;
+	pBufferInfo->recycled = pBufferInfo->MVA != 0;
+	if (!pBufferInfo->MVA)
+		pBufferInfo->eModuleID = -1;
+
+	buffer->sg_table = found->table;
+	buffer->priv_virt = pBufferInfo;
+	kfree(found);
+
+	return true;
+}
+
+/*
+ * First ION_MM_CONFIG_BUFFER of a recycled buffer: keep the inherited
+ * mapping if it was made for the same port and attributes, remap otherwise.
+ */
+static void ion_mm_cache_config(struct ion_buffer *buffer, ion_mm_buffer_info *pBufferInfo,
+		int eModuleID, unsigned int security, unsigned int coherent)
+{
+	pBufferInfo->recycled = 0;
+	if (pBufferInfo->eModuleID == eModuleID && pBufferInfo->security == security &&
+	    pBufferInfo->coherent == coherent)
+		return;
+
+	m4u_dealloc_mva_sg(pBufferInfo->eModuleID, buffer->sg_table, buffer->size, pBufferInfo->MVA);
+	pBufferInfo->MVA = 0;
+	pBufferInfo->eModuleID = eModuleID;
+	pBufferInfo->security = security;
+	pBufferInfo->coherent = coherent;
+}
+#endif
+
 static struct page_info *alloc_largest_available(struct ion_system_heap *heap,
 		struct ion_buffer *buffer, unsigned long size, unsigned int max_order) {
 	struct page *page;
@@ -182,6 +418,13 @@ static int ion_mm_heap_allocate(struct ion_heap *heap,
 		return -ENOMEM;
 	}
 
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	if (ion_mm_cache_get(sys_heap, buffer, size, flags)) {
+		mm_heap_total_memory += size;
+		return 0;
+	}
+#endif
+
 	INIT_LIST_HEAD(&pages);
 	while (size_remaining > 0) {
 		info = alloc_largest_available(sys_heap, buffer, size_remaining,
@@ -238,6 +481,7 @@ static int ion_mm_heap_allocate(struct ion_heap *heap,
 	buffer->priv_virt = pBufferInfo;
 
 	mm_heap_total_memory += size;
+	ion_mm_heap_kick_fill(sys_heap);
 
 	return 0;
 err1:
@@ -301,6 +545,11 @@ void ion_mm_heap_free(struct ion_buffer *buffer)
 	if (!(buffer->private_flags & ION_PRIV_FLAG_SHRINKER_FREE))
 		ion_heap_buffer_zero(buffer);
 
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	if (ion_mm_cache_put(sys_heap, buffer))
+		return;
+#endif
+
 	ion_mm_heap_free_bufferInfo(buffer);
 
 	for_each_sg(table->sgl, sg, table->nents, i)
@@ -326,6 +575,17 @@ static int ion_mm_heap_shrink(struct ion_heap *heap, gfp_t gfp_mask, int nr_to_s
 
 	sys_heap = container_of(heap, struct ion_system_heap, heap);
 
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	/* recycled buffers go first, they hold MVA space as well */
+	if (nr_to_scan == 0) {
+		nr_total += sys_heap->cache_size >> PAGE_SHIFT;
+	} else {
+		nr_total += ion_mm_cache_trim(sys_heap, 0, 0);
+		if (nr_total >= nr_to_scan)
+			return nr_total;
+	}
+#endif
+
 	for (i = 0; i < num_orders; i++) {
 		struct ion_page_pool *pool = sys_heap->pools[i];
 
@@ -373,6 +633,13 @@ static int ion_mm_heap_phys(struct ion_heap *heap, struct ion_buffer *buffer,
 
 void ion_mm_heap_add_freelist(struct ion_buffer *buffer)
 {
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	/* keep the info, and the mapping if allowed, for ion_mm_cache_put() */
+	if (ion_mm_cache_wanted(buffer)) {
+		ion_mm_cache_release_info(buffer);
+		return;
+	}
+#endif
 	ion_mm_heap_free_bufferInfo(buffer);
 }
 
@@ -391,6 +658,9 @@ int ion_mm_heap_pool_total(struct ion_heap *heap)
 		pool = sys_heap->cached_pools[i];
 		total += (pool->high_count + pool->low_count) * (1 << pool->order);
 	}
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	total += sys_heap->cache_size >> PAGE_SHIFT;
+#endif
 
 	return total;
 }
@@ -434,6 +704,9 @@ static int ion_mm_heap_debug_show(struct ion_heap *heap, struct seq_file *s, voi
 				"%d order %u lowmem pages in cached_pool = %lu total\n",
 				pool->low_count, pool->order, (1 << pool->order) * PAGE_SIZE * pool->low_count);
 	}
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	ION_PRINT_LOG_OR_SEQ(s, "mm_heap buffer cache total_size=0x%zx\n", sys_heap->cache_size);
+#endif
 	if (heap->flags & ION_HEAP_FLAG_DEFER_FREE)
 		ION_PRINT_LOG_OR_SEQ(s, "mm_heap_freelist total_size=0x%zu\n", ion_heap_freelist_size(heap));
 	else
@@ -670,7 +943,7 @@ struct ion_heap *ion_mm_heap_create(struct ion_platform_heap *unused)
 
 		if (orders[i] > 0)
 			gfp_flags = high_order_gfp_flags;
-		pool = ion_page_pool_create(gfp_flags, orders[i]);
+		pool = ion_page_pool_get_shared(gfp_flags, orders[i]);
 		if (!pool)
 			goto err_create_pool;
 		heap->pools[i] = pool;
@@ -682,6 +955,15 @@ struct ion_heap *ion_mm_heap_create(struct ion_platform_heap *unused)
 	}
 
 	heap->heap.debug_show = ion_mm_heap_debug_show;
+#ifdef CONFIG_ION_POOL_PREFILL
+	INIT_WORK(&heap->fill_work, ion_mm_heap_fill);
+#endif
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	mutex_init(&heap->cache_lock);
+	INIT_LIST_HEAD(&heap->cache);
+	INIT_DELAYED_WORK(&heap->cache_work, ion_mm_cache_expire);
+#endif
+	ion_mm_heap_kick_fill(heap);
 	return &heap->heap;
 
 err_create_pool:
@@ -707,6 +989,13 @@ void ion_mm_heap_destroy(struct ion_heap *heap)
 	*sys_heap = container_of(heap, struct ion_system_heap, heap);
 	int i;
 
+#ifdef CONFIG_ION_POOL_PREFILL
+	cancel_work_sync(&sys_heap->fill_work);
+#endif
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+	cancel_delayed_work_sync(&sys_heap->cache_work);
+	ion_mm_cache_trim(sys_heap, 0, 0);
+#endif
 	for (i = 0; i < num_orders; i++)
 		ion_page_pool_destroy(sys_heap->pools[i]);
 	kfree(sys_heap->pools);
@@ -778,6 +1067,13 @@ long ion_mm_ioctl(struct ion_client *client, unsigned int cmd, unsigned long arg
 					pBufferInfo->eModuleID = Param.config_buffer_param.eModuleID;
 					pBufferInfo->security = Param.config_buffer_param.security;
 					pBufferInfo->coherent = Param.config_buffer_param.coherent;
+#ifdef CONFIG_ION_MM_BUFFER_CACHE
+				} else if (pBufferInfo->recycled) {
+					ion_mm_cache_config(buffer, pBufferInfo,
+							Param.config_buffer_param.eModuleID,
+							Param.config_buffer_param.security,
+							Param.config_buffer_param.coherent);
+#endif
 				} else {
 					if (pBufferInfo->security
 							!= Param.config_buffer_param.security
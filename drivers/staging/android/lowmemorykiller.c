@@ -43,6 +43,20 @@
 #include <linux/notifier.h>
 #include <linux/freezer.h>
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+#include <linux/hashtable.h>
+#include <linux/slab.h>
+#include <trace/events/sched.h>
+#endif
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+#include <linux/kthread.h>
+#include <linux/poll.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <trace/events/vmscan.h>
+#endif
+
 #if defined(CONFIG_MTK_AEE_FEATURE) && defined(CONFIG_MT_ENG_BUILD)
 #include <mt-plat/aee.h>
 #include <disp_assert_layer.h>
@@ -110,6 +124,71 @@ static int total_low_ratio = 1;
 static struct task_struct *lowmem_deathpending;
 static unsigned long lowmem_deathpending_timeout;
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+/*
+ * Victim index: processes are kept in oom_score_adj buckets updated on every
+ * adj write, with their RSS cached and refreshed lazily at selection time,
+ * so picking a victim only looks at the highest populated bucket instead of
+ * walking the task list.
+ */
+/* 32 buckets of 64 oom_score_adj each, see lowmem_adj_bucket() in oom.h */
+#define LOWMEM_ADJ_BUCKETS	\
+	(((OOM_SCORE_ADJ_MAX - OOM_SCORE_ADJ_MIN) >> LOWMEM_ADJ_BUCKET_SHIFT) + 1)
+#define LOWMEM_ADJ_BATCH	64	/* candidates evaluated per bucket */
+#define LOWMEM_RSS_TTL		(HZ / 4)	/* cached tasksize lifetime */
+
+struct lowmem_adj_entry {
+	struct task_struct *task;	/* thread group leader, no reference */
+	short oom_score_adj;
+	int tasksize;			/* rss (+ swap) in pages, cached */
+	unsigned long rss_stamp;	/* jiffies of the last refresh */
+	struct hlist_node hnode;	/* lowmem_adj_hash */
+	struct list_head node;		/* lowmem_adj_buckets[] */
+};
+
+static DEFINE_HASHTABLE(lowmem_adj_hash, 8);
+static struct list_head lowmem_adj_buckets[LOWMEM_ADJ_BUCKETS];
+static DECLARE_BITMAP(lowmem_adj_nonempty, LOWMEM_ADJ_BUCKETS);
+static DEFINE_SPINLOCK(lowmem_adj_lock);
+
+static void lowmem_adj_untrack(struct task_struct *task);
+#endif
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+/*
+ * Pressure mode: direct reclaim stall time is accounted per zone from the
+ * vmscan tracepoints and reported by /proc/lowmemorykiller_pressure, whose
+ * poll() returns POLLPRI once the stalled share of a window crosses
+ * pressure_threshold. Victims are taken from the adj index and kills are
+ * issued by the "lowmemorykiller" kthread instead of the task that entered
+ * reclaim.
+ */
+static bool lowmem_pressure_mode = true;
+static uint32_t lowmem_pressure_threshold = 10;		/* % of window stalled */
+static uint32_t lowmem_pressure_window_ms = 1000;
+
+struct lowmem_zone_pressure {
+	u64 window_start;	/* ns */
+	u64 window_stall;	/* ns stalled in the current window */
+	u64 total_stall;	/* ns */
+	unsigned int level;	/* % of the last window spent stalled */
+	bool signaled;		/* event already sent in the current window */
+};
+
+static struct lowmem_zone_pressure lowmem_zone_pressure[MAX_NR_ZONES];
+static DEFINE_SPINLOCK(lowmem_pressure_lock);
+static atomic_t lowmem_pressure_events = ATOMIC_INIT(0);
+static DECLARE_WAIT_QUEUE_HEAD(lowmem_pressure_wait);
+
+#define LOWMEM_KILL_RECLAIM	0	/* free/file pages below minfree */
+#define LOWMEM_KILL_STALL	1	/* reclaim stall above threshold */
+
+static struct task_struct *lowmem_killer;
+static unsigned long lowmem_kill_request;
+static gfp_t lowmem_kill_gfp = GFP_KERNEL;
+static DECLARE_WAIT_QUEUE_HEAD(lowmem_kill_wait);
+#endif
+
 #define lowmem_print(level, x...)			\
 	do {						\
 		if (lowmem_debug_level >= (level))	\
@@ -128,8 +207,16 @@ task_notify_func(struct notifier_block *self, unsigned long val, void *data)
 {
 	struct task_struct *task = data;
 
-	if (task == lowmem_deathpending)
+	if (task == lowmem_deathpending) {
 		lowmem_deathpending = NULL;
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+		wake_up(&lowmem_kill_wait);
+#endif
+	}
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	lowmem_adj_untrack(task);
+#endif
 
 	return NOTIFY_DONE;
 }
@@ -148,59 +235,30 @@ static unsigned long lowmem_count(struct shrinker *s,
 		global_page_state(NR_INACTIVE_FILE);
 }
 
-static unsigned long lowmem_scan(struct shrinker *s, struct shrink_control *sc)
+/*
+ * Find the lowest oom_score_adj that has to be killed for the current amount
+ * of free and file pages, or OOM_SCORE_ADJ_MAX + 1 if memory is not low.
+ */
+static short lowmem_min_score_adj(gfp_t gfp_mask, int *ofree, int *ofile,
+				  int *ominfree)
 {
-	struct task_struct *tsk;
-	struct task_struct *selected = NULL;
-	unsigned long rem = 0;
-	int tasksize;
 	int i;
 	short min_score_adj = OOM_SCORE_ADJ_MAX + 1;
 	int minfree = 0;
-	int selected_tasksize = 0;
-	short selected_oom_score_adj;
 	int array_size = ARRAY_SIZE(lowmem_adj);
 	int other_free = global_page_state(NR_FREE_PAGES) - totalreserve_pages;
 	int other_file = global_page_state(NR_FILE_PAGES) -
 						global_page_state(NR_SHMEM) -
 						total_swapcache_pages();
-
-	int print_extra_info = 0;
-	static unsigned long lowmem_print_extra_info_timeout;
-
 #ifdef CONFIG_MTK_GMO_RAM_OPTIMIZE
 	int other_anon = global_page_state(NR_INACTIVE_ANON) - global_page_state(NR_ACTIVE_ANON);
 #endif
-#ifdef CONFIG_MT_ENG_BUILD
-	/* dump memory info when framework low memory*/
-	int pid_dump = -1; /* process which need to be dump */
-	/* int pid_sec_mem = -1; */
-	int max_mem = 0;
-	static int pid_flm_warn = -1;
-	static unsigned long flm_warn_timeout;
-	int log_offset = 0, log_ret;
-#endif /* CONFIG_MT_ENG_BUILD*/
-	/*
-	* If we already have a death outstanding, then
-	* bail out right away; indicating to vmscan
-	* that we have nothing further to offer on
-	* this pass.
-	*
-	*/
-	if (lowmem_deathpending &&
-	    time_before_eq(jiffies, lowmem_deathpending_timeout))
-		return SHRINK_STOP;
 
 	/* Subtract CMA free pages from other_free if this is an unmovable page allocation */
 	if (IS_ENABLED(CONFIG_CMA))
-		if (!(sc->gfp_mask & __GFP_MOVABLE))
+		if (!(gfp_mask & __GFP_MOVABLE))
 			other_free -= global_page_state(NR_FREE_CMA_PAGES);
 
-	if (!spin_trylock(&lowmem_shrink_lock)) {
-		lowmem_print(4, "lowmem_shrink lock failed\n");
-		return SHRINK_STOP;
-	}
-
 	/* Let other_free be positive or zero */
 	if (other_free < 0) {
 		/* lowmem_print(1, "Original other_free [%d] is too low!\n", other_free); */
@@ -241,6 +299,358 @@ static unsigned long lowmem_scan(struct shrinker *s, struct shrink_control *sc)
 	}
 #endif
 
+	*ofree = other_free;
+	*ofile = other_file;
+	*ominfree = minfree;
+
+	return min_score_adj;
+}
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+static struct lowmem_adj_entry *lowmem_adj_lookup(struct task_struct *task)
+{
+	struct lowmem_adj_entry *e;
+
+	hash_for_each_possible(lowmem_adj_hash, e, hnode, (unsigned long)task)
+		if (e->task == task)
+			return e;
+
+	return NULL;
+}
+
+static void __lowmem_adj_link(struct lowmem_adj_entry *e)
+{
+	int b = lowmem_adj_bucket(e->oom_score_adj);
+
+	list_add_tail(&e->node, &lowmem_adj_buckets[b]);
+	set_bit(b, lowmem_adj_nonempty);
+}
+
+static void __lowmem_adj_unlink(struct lowmem_adj_entry *e)
+{
+	int b = lowmem_adj_bucket(e->oom_score_adj);
+
+	list_del(&e->node);
+	if (list_empty(&lowmem_adj_buckets[b]))
+		clear_bit(b, lowmem_adj_nonempty);
+}
+
+/*
+ * Called from /proc/<pid>/oom_score_adj and oom_adj writes with task_lock
+ * and siglock of @task held, and for every new process at fork and exec.
+ * A process is tracked from then until its thread group leader is freed.
+ */
+void lowmem_adj_track(struct task_struct *task)
+{
+	struct task_struct *leader = task->group_leader;
+	struct lowmem_adj_entry *e, *new = NULL;
+	unsigned long flags;
+
+	if (leader->flags & PF_KTHREAD)
+		return;
+
+again:
+	spin_lock_irqsave(&lowmem_adj_lock, flags);
+	e = lowmem_adj_lookup(leader);
+	if (e) {
+		__lowmem_adj_unlink(e);
+	} else if (new) {
+		e = new;
+		new = NULL;
+		e->task = leader;
+		e->tasksize = 0;
+		e->rss_stamp = jiffies - LOWMEM_RSS_TTL;
+		hash_add(lowmem_adj_hash, &e->hnode, (unsigned long)leader);
+	}
+	if (e) {
+		e->oom_score_adj = task->signal->oom_score_adj;
+		__lowmem_adj_link(e);
+	}
+	spin_unlock_irqrestore(&lowmem_adj_lock, flags);
+
+	if (!e && !new) {
+		new = kmalloc(sizeof(*new), GFP_ATOMIC);
+		if (new)
+			goto again;
+	}
+	kfree(new);
+}
+
+/* children inherit their adj at fork without any adj write */
+static void lowmem_adj_fork(void *ignore, struct task_struct *parent,
+			    struct task_struct *child)
+{
+	if (thread_group_leader(child))
+		lowmem_adj_track(child);
+}
+
+/* user mode helpers were kernel threads when they forked */
+static void lowmem_adj_exec(void *ignore, struct task_struct *p,
+			    pid_t old_pid, struct linux_binprm *bprm)
+{
+	lowmem_adj_track(p);
+}
+
+static void __init lowmem_adj_index_init(void)
+{
+	struct task_struct *tsk;
+	int i;
+
+	for (i = 0; i < LOWMEM_ADJ_BUCKETS; i++)
+		INIT_LIST_HEAD(&lowmem_adj_buckets[i]);
+
+	if (register_trace_sched_process_fork(lowmem_adj_fork, NULL) ||
+	    register_trace_sched_process_exec(lowmem_adj_exec, NULL))
+		pr_err("failed to hook fork/exec, adj index misses inherited adj\n");
+
+	/* processes that started before the hooks */
+	rcu_read_lock();
+	for_each_process(tsk) {
+		task_lock(tsk);
+		lowmem_adj_track(tsk);
+		task_unlock(tsk);
+	}
+	rcu_read_unlock();
+}
+
+static void lowmem_adj_untrack(struct task_struct *task)
+{
+	struct lowmem_adj_entry *e;
+	unsigned long flags;
+
+	if (task->group_leader != task)
+		return;
+
+	spin_lock_irqsave(&lowmem_adj_lock, flags);
+	e = lowmem_adj_lookup(task);
+	if (e) {
+		__lowmem_adj_unlink(e);
+		hash_del(&e->hnode);
+	}
+	spin_unlock_irqrestore(&lowmem_adj_lock, flags);
+
+	kfree(e);
+}
+
+/*
+ * Fill @tasks with up to @max tracked processes whose oom_score_adj is
+ * within [@min_score_adj, @max_score_adj], bucket by bucket from the lowest,
+ * and return how many were stored. Each task is returned with a reference
+ * held that the caller drops with put_task_struct(). Used by mlog to sample
+ * the processes LMK cares about without walking the task list.
+ */
+int lowmem_adj_snapshot(struct task_struct **tasks, int max,
+			short min_score_adj, short max_score_adj)
+{
+	struct lowmem_adj_entry *e;
+	unsigned long flags;
+	int b, n = 0;
+
+	spin_lock_irqsave(&lowmem_adj_lock, flags);
+	for (b = lowmem_adj_bucket(min_score_adj);
+	     b <= lowmem_adj_bucket(max_score_adj) && n < max; b++) {
+		if (!test_bit(b, lowmem_adj_nonempty))
+			continue;
+		list_for_each_entry(e, &lowmem_adj_buckets[b], node) {
+			if (e->oom_score_adj < min_score_adj ||
+			    e->oom_score_adj > max_score_adj)
+				continue;
+			/* being freed, task_notify_func is waiting for us */
+			if (!atomic_inc_not_zero(&e->task->usage))
+				continue;
+			tasks[n] = e->task;
+			if (++n == max)
+				break;
+		}
+	}
+	spin_unlock_irqrestore(&lowmem_adj_lock, flags);
+
+	return n;
+}
+
+/*
+ * Return the rss (+ swap) of @e's process in pages, refreshing the cached
+ * value once it is older than LOWMEM_RSS_TTL, 0 if it has no mm anymore or
+ * -EBUSY if it is dying. The caller holds a reference on e->task, which
+ * keeps @e alive.
+ */
+static int lowmem_adj_tasksize(struct lowmem_adj_entry *e)
+{
+	struct task_struct *p;
+	int tasksize;
+
+	if (time_before(jiffies, e->rss_stamp + LOWMEM_RSS_TTL)) {
+		if (test_tsk_thread_flag(e->task, TIF_MEMDIE) &&
+		    time_before_eq(jiffies, lowmem_deathpending_timeout))
+			return -EBUSY;
+		return e->tasksize;
+	}
+
+	p = find_lock_task_mm(e->task);
+	if (!p)
+		return 0;
+
+	if (test_tsk_thread_flag(p, TIF_MEMDIE) &&
+	    time_before_eq(jiffies, lowmem_deathpending_timeout)) {
+		task_unlock(p);
+		return -EBUSY;
+	}
+
+	tasksize = get_mm_rss(p->mm);
+#ifdef CONFIG_ZRAM
+	tasksize += get_mm_counter(p->mm, MM_SWAPENTS);
+#endif
+	task_unlock(p);
+
+	/* racy against another selector, both store a fresh value */
+	e->tasksize = tasksize;
+	e->rss_stamp = jiffies;
+
+	return tasksize;
+}
+
+/*
+ * Pick the victim from the highest populated bucket at or above
+ * @min_score_adj that holds one: highest oom_score_adj first, then largest
+ * RSS (+ swap). @skip_pid is never selected. Returns the thread group leader
+ * with a reference held, NULL if there is none, or ERR_PTR(-EBUSY) while a
+ * previous victim is still dying.
+ */
+static struct task_struct *lowmem_adj_select(short min_score_adj,
+					     pid_t skip_pid, int other_file,
+					     int *selected_tasksize,
+					     short *selected_adj)
+{
+	struct lowmem_adj_entry *batch[LOWMEM_ADJ_BATCH];
+	struct lowmem_adj_entry *selected = NULL;
+	struct lowmem_adj_entry *e;
+	unsigned long flags;
+	bool dying = false;
+	int b, i, n;
+
+	for (b = LOWMEM_ADJ_BUCKETS - 1;
+	     b >= lowmem_adj_bucket(min_score_adj) && !selected && !dying; b--) {
+		if (!test_bit(b, lowmem_adj_nonempty))
+			continue;
+
+		n = 0;
+		spin_lock_irqsave(&lowmem_adj_lock, flags);
+		list_for_each_entry(e, &lowmem_adj_buckets[b], node) {
+			if (e->oom_score_adj < min_score_adj)
+				continue;
+			if (e->task->pid == skip_pid)
+				continue;
+			/* being freed, task_notify_func is waiting for us */
+			if (!atomic_inc_not_zero(&e->task->usage))
+				continue;
+			batch[n] = e;
+			if (++n == LOWMEM_ADJ_BATCH)
+				break;
+		}
+		spin_unlock_irqrestore(&lowmem_adj_lock, flags);
+
+		for (i = 0; i < n; i++) {
+			short adj = batch[i]->oom_score_adj;
+			int tasksize;
+
+			if (dying)
+				goto next;
+
+			if (selected && adj < *selected_adj)
+				goto next;
+
+			tasksize = lowmem_adj_tasksize(batch[i]);
+			if (tasksize == -EBUSY) {
+				dying = true;
+				goto next;
+			}
+			if (tasksize <= 0)
+				goto next;
+			if (selected && adj == *selected_adj &&
+			    tasksize <= *selected_tasksize)
+				goto next;
+#ifdef CONFIG_MTK_GMO_RAM_OPTIMIZE
+			/* if cached > 30MB, don't kill ub:secureRandom while its adj is 9 */
+			if (!strcmp(batch[i]->task->comm, "ub:secureRandom") &&
+			    (REVERT_ADJ(adj) == 9) && (other_file > 30*256))
+				goto next;
+#endif
+			if (selected)
+				put_task_struct(selected->task);
+			selected = batch[i];
+			*selected_tasksize = tasksize;
+			*selected_adj = adj;
+			continue;
+next:
+			put_task_struct(batch[i]->task);
+		}
+	}
+
+	if (dying) {
+		if (selected)
+			put_task_struct(selected->task);
+		return ERR_PTR(-EBUSY);
+	}
+
+	return selected ? selected->task : NULL;
+}
+#endif
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+static unsigned long lowmem_pressure_scan(struct shrink_control *sc);
+#endif
+
+static unsigned long lowmem_scan(struct shrinker *s, struct shrink_control *sc)
+{
+	struct task_struct *tsk;
+	struct task_struct *selected = NULL;
+	unsigned long rem = 0;
+	int tasksize;
+	short min_score_adj;
+	int minfree = 0;
+	int selected_tasksize = 0;
+	short selected_oom_score_adj;
+	int other_free, other_file;
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	bool selected_ref = false;
+#endif
+
+	int print_extra_info = 0;
+	static unsigned long lowmem_print_extra_info_timeout;
+
+#ifdef CONFIG_MT_ENG_BUILD
+	/* dump memory info when framework low memory*/
+	int pid_dump = -1; /* process which need to be dump */
+	/* int pid_sec_mem = -1; */
+	int max_mem = 0;
+	static int pid_flm_warn = -1;
+	static unsigned long flm_warn_timeout;
+	int log_offset = 0, log_ret;
+#endif /* CONFIG_MT_ENG_BUILD*/
+	/*
+	* If we already have a death outstanding, then
+	* bail out right away; indicating to vmscan
+	* that we have nothing further to offer on
+	* this pass.
+	*
+	*/
+	if (lowmem_deathpending &&
+	    time_before_eq(jiffies, lowmem_deathpending_timeout))
+		return SHRINK_STOP;
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+	if (lowmem_pressure_mode)
+		return lowmem_pressure_scan(sc);
+#endif
+
+	if (!spin_trylock(&lowmem_shrink_lock)) {
+		lowmem_print(4, "lowmem_shrink lock failed\n");
+		return SHRINK_STOP;
+	}
+
+	min_score_adj = lowmem_min_score_adj(sc->gfp_mask, &other_free,
+					     &other_file, &minfree);
+
 	lowmem_print(3, "lowmem_scan %lu, %x, ofree %d %d, ma %hd\n",
 			sc->nr_to_scan, sc->gfp_mask, other_free,
 			other_file, min_score_adj);
@@ -290,6 +700,44 @@ static unsigned long lowmem_scan(struct shrinker *s, struct shrink_control *sc)
 	}
 
 	rcu_read_lock();
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	/* the candidate dump and the FLM warning below still walk every task */
+	if (!print_extra_info) {
+		pid_t skip_pid = -1;
+
+#ifdef CONFIG_MT_ENG_BUILD
+		if (time_before_eq(jiffies, flm_warn_timeout))
+			skip_pid = pid_flm_warn;
+#endif
+		tsk = lowmem_adj_select(min_score_adj, skip_pid, other_file,
+					&selected_tasksize,
+					&selected_oom_score_adj);
+		if (IS_ERR(tsk)) {
+			rcu_read_unlock();
+			spin_unlock(&lowmem_shrink_lock);
+			return SHRINK_STOP;
+		}
+		if (tsk) {
+			selected = find_lock_task_mm(tsk);
+			if (selected) {
+				get_task_struct(selected);
+				selected_ref = true;
+				task_unlock(selected);
+			}
+			put_task_struct(tsk);
+		}
+#if defined(CONFIG_MTK_AEE_FEATURE) && defined(CONFIG_MT_ENG_BUILD)
+		if (selected && selected_oom_score_adj <= lowmem_kernel_warn_adj) {
+			put_task_struct(selected);
+			selected_ref = false;
+			selected = NULL;
+			selected_tasksize = 0;
+			selected_oom_score_adj = min_score_adj;
+		} else
+#endif
+		goto select_done;
+	}
+#endif
 	for_each_process(tsk) {
 		struct task_struct *p;
 		short oom_score_adj;
@@ -417,6 +865,10 @@ log_again:
 			     p->comm, p->pid, REVERT_ADJ(oom_score_adj), oom_score_adj, tasksize);
 	}
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+select_done:
+#endif
+
 #ifdef CONFIG_MT_ENG_BUILD
 	if (log_offset > 0)
 		lowmem_print(1, "\n%s", lmk_log_buf);
@@ -516,6 +968,11 @@ log_again:
 		rem += selected_tasksize;
 	}
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	if (selected_ref)
+		put_task_struct(selected);
+#endif
+
 	lowmem_print(4, "lowmem_scan %lu, %x, return %lu\n",
 		     sc->nr_to_scan, sc->gfp_mask, rem);
 	rcu_read_unlock();
@@ -523,6 +980,255 @@ log_again:
 	return rem;
 }
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+static void lowmem_kill_wake(int reason)
+{
+	if (!test_and_set_bit(reason, &lowmem_kill_request))
+		wake_up(&lowmem_kill_wait);
+}
+
+static unsigned long lowmem_pressure_scan(struct shrink_control *sc)
+{
+	int other_free, other_file, minfree;
+
+	if (lowmem_min_score_adj(sc->gfp_mask, &other_free, &other_file,
+				 &minfree) > OOM_SCORE_ADJ_MAX)
+		return 0;
+
+	lowmem_kill_gfp = sc->gfp_mask;
+	lowmem_kill_wake(LOWMEM_KILL_RECLAIM);
+
+	return SHRINK_STOP;
+}
+
+static void lowmem_pressure_kill(unsigned long reason)
+{
+	struct task_struct *selected, *p;
+	int other_free, other_file, minfree;
+	int selected_tasksize = 0;
+	short min_score_adj, selected_oom_score_adj;
+	int array_size = ARRAY_SIZE(lowmem_adj);
+	long cache_size, cache_limit, free;
+
+	min_score_adj = lowmem_min_score_adj(lowmem_kill_gfp, &other_free,
+					     &other_file, &minfree);
+
+	/* stalls alone only reclaim the least important level */
+	if (lowmem_adj_size < array_size)
+		array_size = lowmem_adj_size;
+	if (lowmem_minfree_size < array_size)
+		array_size = lowmem_minfree_size;
+	if ((reason & BIT(LOWMEM_KILL_STALL)) && array_size > 0 &&
+	    min_score_adj > lowmem_adj[array_size - 1])
+		min_score_adj = lowmem_adj[array_size - 1];
+
+	if (min_score_adj > OOM_SCORE_ADJ_MAX)
+		return;
+
+	spin_lock(&lowmem_shrink_lock);
+	selected_oom_score_adj = min_score_adj;
+	selected = lowmem_adj_select(min_score_adj, -1, other_file,
+				     &selected_tasksize,
+				     &selected_oom_score_adj);
+	if (IS_ERR_OR_NULL(selected)) {
+		spin_unlock(&lowmem_shrink_lock);
+		return;
+	}
+
+	p = find_lock_task_mm(selected);
+	put_task_struct(selected);
+	if (!p) {
+		spin_unlock(&lowmem_shrink_lock);
+		return;
+	}
+	get_task_struct(p);
+	task_unlock(p);
+
+	cache_size = other_file * (long)(PAGE_SIZE / 1024);
+	cache_limit = minfree * (long)(PAGE_SIZE / 1024);
+	free = other_free * (long)(PAGE_SIZE / 1024);
+	trace_lowmemory_kill(p, cache_size, cache_limit, free);
+	lowmem_print(1, "Killing '%s' (%d), adj %d, score_adj %hd,\n"
+			"   to free %ldkB because\n"
+			"   cache %ldkB is below limit %ldkB for oom_score_adj %hd%s\n"
+			"   Free memory is %ldkB above reserved\n",
+		     p->comm, p->pid,
+		     REVERT_ADJ(selected_oom_score_adj),
+		     selected_oom_score_adj,
+		     selected_tasksize * (long)(PAGE_SIZE / 1024),
+		     cache_size, cache_limit,
+		     min_score_adj,
+		     (reason & BIT(LOWMEM_KILL_STALL)) ? " (reclaim stall)" : "",
+		     free);
+	lowmem_deathpending = p;
+	lowmem_deathpending_timeout = jiffies + HZ;
+	set_tsk_thread_flag(p, TIF_MEMDIE);
+	spin_unlock(&lowmem_shrink_lock);
+
+	send_sig(SIGKILL, p, 0);
+	put_task_struct(p);
+}
+
+static int lowmem_kill_thread(void *data)
+{
+	struct sched_param param = { .sched_priority = MAX_RT_PRIO - 2 };
+
+	sched_setscheduler_nocheck(current, SCHED_FIFO, &param);
+
+	while (!kthread_should_stop()) {
+		unsigned long reason;
+
+		wait_event_interruptible(lowmem_kill_wait,
+					 lowmem_kill_request || kthread_should_stop());
+
+		/* one kill at a time, re-evaluate once the victim is gone */
+		if (lowmem_deathpending &&
+		    time_before_eq(jiffies, lowmem_deathpending_timeout)) {
+			wait_event_timeout(lowmem_kill_wait, !lowmem_deathpending,
+					   lowmem_deathpending_timeout - jiffies);
+			continue;
+		}
+
+		reason = xchg(&lowmem_kill_request, 0);
+		if (reason)
+			lowmem_pressure_kill(reason);
+	}
+
+	return 0;
+}
+
+static void lowmem_pressure_account(int zid, u64 now, u64 stall)
+{
+	struct lowmem_zone_pressure *zp = &lowmem_zone_pressure[zid];
+	u64 window = (u64)lowmem_pressure_window_ms * NSEC_PER_MSEC;
+	unsigned long flags;
+	bool event = false;
+
+	if (!window)
+		return;
+
+	spin_lock_irqsave(&lowmem_pressure_lock, flags);
+	if (now - zp->window_start >= window) {
+		if (zp->window_start)
+			zp->level = div64_u64(zp->window_stall * 100,
+					      now - zp->window_start);
+		zp->window_start = now;
+		zp->window_stall = 0;
+		zp->signaled = false;
+	}
+	zp->window_stall += stall;
+	zp->total_stall += stall;
+	if (!zp->signaled &&
+	    zp->window_stall * 100 >= window * lowmem_pressure_threshold) {
+		zp->signaled = true;
+		event = true;
+	}
+	spin_unlock_irqrestore(&lowmem_pressure_lock, flags);
+
+	if (event) {
+		atomic_inc(&lowmem_pressure_events);
+		wake_up_interruptible(&lowmem_pressure_wait);
+		if (lowmem_pressure_mode)
+			lowmem_kill_wake(LOWMEM_KILL_STALL);
+	}
+}
+
+static void lowmem_reclaim_begin(void *data, int order, int may_writepage,
+				 gfp_t gfp_flags)
+{
+	struct reclaim_state *rs = current->reclaim_state;
+
+	if (!rs)
+		return;
+
+	rs->stall_start = ktime_get_ns();
+	rs->stall_zone = gfp_zone(gfp_flags);
+}
+
+static void lowmem_reclaim_end(void *data, unsigned long nr_reclaimed)
+{
+	struct reclaim_state *rs = current->reclaim_state;
+	u64 now;
+
+	if (!rs || !rs->stall_start)
+		return;
+
+	now = ktime_get_ns();
+	lowmem_pressure_account(rs->stall_zone, now, now - rs->stall_start);
+	rs->stall_start = 0;
+}
+
+static int lowmem_pressure_show(struct seq_file *m, void *v)
+{
+	struct zone *zone;
+	unsigned long flags;
+
+	m->private = (void *)(long)atomic_read(&lowmem_pressure_events);
+
+	for_each_populated_zone(zone) {
+		struct lowmem_zone_pressure *zp = &lowmem_zone_pressure[zone_idx(zone)];
+		unsigned int level;
+		u64 window_stall, total_stall;
+
+		spin_lock_irqsave(&lowmem_pressure_lock, flags);
+		level = zp->level;
+		window_stall = zp->window_stall;
+		total_stall = zp->total_stall;
+		spin_unlock_irqrestore(&lowmem_pressure_lock, flags);
+
+		seq_printf(m, "%-8s level %u%% window %llums total %llums\n",
+			   zone->name, level,
+			   div64_u64(window_stall, NSEC_PER_MSEC),
+			   div64_u64(total_stall, NSEC_PER_MSEC));
+	}
+
+	return 0;
+}
+
+static int lowmem_pressure_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, lowmem_pressure_show,
+			   (void *)(long)atomic_read(&lowmem_pressure_events));
+}
+
+/* POLLPRI once a new pressure event happened since the last read */
+static unsigned int lowmem_pressure_poll(struct file *file, poll_table *wait)
+{
+	struct seq_file *m = file->private_data;
+
+	poll_wait(file, &lowmem_pressure_wait, wait);
+
+	if ((long)m->private != atomic_read(&lowmem_pressure_events))
+		return POLLIN | POLLRDNORM | POLLPRI;
+
+	return 0;
+}
+
+static const struct file_operations lowmem_pressure_fops = {
+	.open		= lowmem_pressure_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.poll		= lowmem_pressure_poll,
+	.release	= single_release,
+};
+
+static void __init lowmem_pressure_init(void)
+{
+	if (register_trace_mm_vmscan_direct_reclaim_begin(lowmem_reclaim_begin, NULL) ||
+	    register_trace_mm_vmscan_direct_reclaim_end(lowmem_reclaim_end, NULL))
+		pr_err("failed to hook direct reclaim, no stall tracking\n");
+
+	proc_create("lowmemorykiller_pressure", S_IRUGO, NULL, &lowmem_pressure_fops);
+
+	lowmem_killer = kthread_run(lowmem_kill_thread, NULL, "lowmemorykiller");
+	if (IS_ERR(lowmem_killer)) {
+		pr_err("failed to start killer thread, pressure mode off\n");
+		lowmem_killer = NULL;
+		lowmem_pressure_mode = false;
+	}
+}
+#endif
+
 static struct shrinker lowmem_shrinker = {
 	.scan_objects = lowmem_scan,
 	.count_objects = lowmem_count,
@@ -540,6 +1246,12 @@ static int __init lowmem_init(void)
 #endif
 
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	lowmem_adj_index_init();
+#endif
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+	lowmem_pressure_init();
+#endif
 	task_free_register(&task_nb);
 	register_shrinker(&lowmem_shrinker);
 
@@ -753,6 +1465,11 @@ module_param_cb(flm_warn_adj, &flm_warn_adj_ops, &lowmem_kernel_warn_adj, S_IRUG
 module_param_named(debug_adj, lowmem_debug_adj, short, S_IRUGO | S_IWUSR);
 #endif
 module_param_named(candidate_log, enable_candidate_log, uint, S_IRUGO | S_IWUSR);
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+module_param_named(pressure_mode, lowmem_pressure_mode, bool, S_IRUGO | S_IWUSR);
+module_param_named(pressure_threshold, lowmem_pressure_threshold, uint, S_IRUGO | S_IWUSR);
+module_param_named(pressure_window_ms, lowmem_pressure_window_ms, uint, S_IRUGO | S_IWUSR);
+#endif
 
 late_initcall(lowmem_init);
 module_exit(lowmem_exit);
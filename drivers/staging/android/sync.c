@@ -23,6 +23,7 @@
 #include <linux/sched.h>
 #include <linux/seq_file.h>
 #include <linux/slab.h>
+#include <linux/sort.h>
 #include <linux/uaccess.h>
 #include <linux/anon_inodes.h>
 
@@ -104,19 +105,27 @@ EXPORT_SYMBOL(sync_timeline_destroy);
 void sync_timeline_signal(struct sync_timeline *obj)
 {
 	unsigned long flags;
-	LIST_HEAD(signaled_pts);
 	struct sync_pt *pt, *next;
+	int visited = 0;
+	u64 start;
 
 	trace_sync_timeline(obj);
 
 	spin_lock_irqsave(&obj->child_list_lock, flags);
+	start = ktime_get_ns();
 
+	/*
+	 * Points do not signal in seqno order (sw_sync signals on the value
+	 * user space picked), so every active point is checked.
+	 */
 	list_for_each_entry_safe(pt, next, &obj->active_list_head,
 				 active_list) {
+		visited++;
 		if (fence_is_signaled_locked(&pt->base))
 			list_del_init(&pt->active_list);
 	}
 
+	sync_debug_signal_stat(visited, ktime_get_ns() - start);
 	spin_unlock_irqrestore(&obj->child_list_lock, flags);
 }
 EXPORT_SYMBOL(sync_timeline_signal);
@@ -308,10 +317,73 @@ struct sync_fence *sync_fence_merge(const char *name,
 	fence->num_fences = i;
 
 	sync_fence_debug_add(fence);
+	sync_debug_merge_stat(2);
 	return fence;
 }
 EXPORT_SYMBOL(sync_fence_merge);
 
+/* by context, then latest seqno first */
+static int sync_pt_cmp(const void *a, const void *b)
+{
+	const struct fence *pt_a = *(const struct fence **)a;
+	const struct fence *pt_b = *(const struct fence **)b;
+
+	if (pt_a->context != pt_b->context)
+		return pt_a->context < pt_b->context ? -1 : 1;
+	if (pt_a->seqno == pt_b->seqno)
+		return 0;
+	return pt_a->seqno - pt_b->seqno <= INT_MAX ? -1 : 1;
+}
+
+struct sync_fence *sync_fence_merge_n(const char *name,
+				      struct sync_fence **fences, int n)
+{
+	struct sync_fence *fence = NULL;
+	struct fence **pts;
+	int num_pts = 0, num_fences;
+	int i, j;
+
+	for (i = 0; i < n; i++)
+		num_pts += fences[i]->num_fences;
+
+	pts = kmalloc_array(num_pts, sizeof(*pts), GFP_KERNEL);
+	if (pts == NULL)
+		return NULL;
+
+	for (i = 0, num_pts = 0; i < n; i++)
+		for (j = 0; j < fences[i]->num_fences; j++)
+			pts[num_pts++] = fences[i]->cbs[j].sync_pt;
+
+	sort(pts, num_pts, sizeof(*pts), sync_pt_cmp, NULL);
+
+	/* keep one sync_pt per timeline, the first is the latest */
+	for (i = j = 0; i < num_pts; i++)
+		if (j == 0 || pts[i]->context != pts[j - 1]->context)
+			pts[j++] = pts[i];
+	num_fences = j;
+
+	fence = sync_fence_alloc(offsetof(struct sync_fence, cbs[num_fences]),
+				 name);
+	if (fence == NULL)
+		goto out;
+
+	atomic_set(&fence->status, num_fences);
+
+	for (i = j = 0; j < num_fences; j++)
+		sync_fence_add_pt(fence, &i, pts[j]);
+
+	if (num_fences > i)
+		atomic_sub(num_fences - i, &fence->status);
+	fence->num_fences = i;
+
+	sync_fence_debug_add(fence);
+	sync_debug_merge_stat(n);
+out:
+	kfree(pts);
+	return fence;
+}
+EXPORT_SYMBOL(sync_fence_merge_n);
+
 int sync_fence_wake_up_wq(wait_queue_t *curr, unsigned mode,
 				 int wake_flags, void *key)
 {
@@ -616,6 +688,84 @@ err_put_fd:
 	return err;
 }
 
+static long sync_fence_ioctl_merge_n(struct sync_fence *fence,
+				     unsigned long arg)
+{
+	int fd = get_unused_fd_flags(O_CLOEXEC);
+	int err, i, n = 0;
+	struct sync_fence **fences = NULL;
+	struct sync_fence *merged;
+	struct sync_merge_n_data data;
+	__s32 *fds = NULL;
+
+	if (fd < 0)
+		return fd;
+
+	if (copy_from_user(&data, (void __user *)arg, sizeof(data))) {
+		err = -EFAULT;
+		goto err_put_fd;
+	}
+
+	if (data.num_fds == 0 || data.num_fds > SYNC_MERGE_N_MAX) {
+		err = -EINVAL;
+		goto err_put_fd;
+	}
+
+	fds = kmalloc_array(data.num_fds, sizeof(*fds), GFP_KERNEL);
+	fences = kmalloc_array(data.num_fds + 1, sizeof(*fences), GFP_KERNEL);
+	if (fds == NULL || fences == NULL) {
+		err = -ENOMEM;
+		goto err_free;
+	}
+
+	if (copy_from_user(fds, (void __user *)(uintptr_t)data.fds,
+			   data.num_fds * sizeof(*fds))) {
+		err = -EFAULT;
+		goto err_free;
+	}
+
+	fences[n++] = fence;
+	for (i = 0; i < data.num_fds; i++) {
+		fences[n] = sync_fence_fdget(fds[i]);
+		if (fences[n] == NULL) {
+			err = -ENOENT;
+			goto err_put_fences;
+		}
+		n++;
+	}
+
+	data.name[sizeof(data.name) - 1] = '\0';
+	merged = sync_fence_merge_n(data.name, fences, n);
+	if (merged == NULL) {
+		err = -ENOMEM;
+		goto err_put_fences;
+	}
+
+	data.fence = fd;
+	if (copy_to_user((void __user *)arg, &data, sizeof(data))) {
+		err = -EFAULT;
+		sync_fence_put(merged);
+		goto err_put_fences;
+	}
+
+	sync_fence_install(merged, fd);
+	for (i = 1; i < n; i++)
+		sync_fence_put(fences[i]);
+	kfree(fences);
+	kfree(fds);
+	return 0;
+
+err_put_fences:
+	for (i = 1; i < n; i++)
+		sync_fence_put(fences[i]);
+err_free:
+	kfree(fences);
+	kfree(fds);
+err_put_fd:
+	put_unused_fd(fd);
+	return err;
+}
+
 static int sync_fill_pt_info(struct fence *fence, void *data, int size)
 {
 	struct sync_pt_info *info = data;
@@ -715,6 +865,9 @@ static long sync_fence_ioctl(struct file *file, unsigned int cmd,
 	case SYNC_IOC_FENCE_INFO:
 		return sync_fence_ioctl_fence_info(fence, arg);
 
+	case SYNC_IOC_MERGE_N:
+		return sync_fence_ioctl_merge_n(fence, arg);
+
 	default:
 		return -ENOTTY;
 	}
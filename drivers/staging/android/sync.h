@@ -270,6 +270,18 @@ struct sync_fence *sync_fence_create(const char *name, struct sync_pt *pt);
 struct sync_fence *sync_fence_merge(const char *name,
 				    struct sync_fence *a, struct sync_fence *b);
 
+/**
+ * sync_fence_merge_n() - merge any number of fences
+ * @name:	name of new fence
+ * @fences:	fences to merge
+ * @n:		number of entries in @fences
+ *
+ * Creates a new fence which contains the latest sync_pt of every timeline
+ * found in @fences, in one allocation.  The @fences remain valid.
+ */
+struct sync_fence *sync_fence_merge_n(const char *name,
+				      struct sync_fence **fences, int n);
+
 /**
  * sync_fence_fdget() - get a fence from an fd
  * @fd:		fd referencing a fence
@@ -342,6 +354,8 @@ extern void sync_timeline_debug_remove(struct sync_timeline *obj);
 extern void sync_fence_debug_add(struct sync_fence *fence);
 extern void sync_fence_debug_remove(struct sync_fence *fence);
 extern void sync_dump(void);
+extern void sync_debug_merge_stat(int num_fences);
+extern void sync_debug_signal_stat(int visited, u64 hold_ns);
 
 #else
 # define sync_timeline_debug_add(obj)
@@ -349,6 +363,8 @@ extern void sync_dump(void);
 # define sync_fence_debug_add(fence)
 # define sync_fence_debug_remove(fence)
 # define sync_dump()
+# define sync_debug_merge_stat(num_fences)
+# define sync_debug_signal_stat(visited, hold_ns)
 #endif
 int sync_fence_wake_up_wq(wait_queue_t *curr, unsigned mode,
 				 int wake_flags, void *key);
@@ -251,9 +251,70 @@ static const struct file_operations sync_debugfs_fops = {
 	.release        = single_release,
 };
 
+/*
+ * Merge sizes (number of input fences, log2 buckets) and how long
+ * sync_timeline_signal() holds the timeline lock and how many points it
+ * looks at per call.
+ */
+#define SYNC_MERGE_HIST	7	/* 2, 3-4, 5-8, 9-16, 17-32, 33-64, more */
+
+static atomic_t sync_merge_hist[SYNC_MERGE_HIST];
+static atomic64_t sync_signal_count;
+static atomic64_t sync_signal_visited;
+static atomic64_t sync_signal_hold_ns;
+static u64 sync_signal_hold_max_ns;
+
+void sync_debug_merge_stat(int num_fences)
+{
+	int bucket = num_fences > 1 ? fls(num_fences - 1) - 1 : 0;
+
+	if (bucket >= SYNC_MERGE_HIST)
+		bucket = SYNC_MERGE_HIST - 1;
+	atomic_inc(&sync_merge_hist[bucket]);
+}
+
+void sync_debug_signal_stat(int visited, u64 hold_ns)
+{
+	atomic64_inc(&sync_signal_count);
+	atomic64_add(visited, &sync_signal_visited);
+	atomic64_add(hold_ns, &sync_signal_hold_ns);
+	if (hold_ns > sync_signal_hold_max_ns)
+		sync_signal_hold_max_ns = hold_ns;
+}
+
+static int sync_stats_show(struct seq_file *s, void *unused)
+{
+	int i;
+
+	seq_puts(s, "merge fences:");
+	for (i = 0; i < SYNC_MERGE_HIST - 1; i++)
+		seq_printf(s, " <=%d:%d", 2 << i, atomic_read(&sync_merge_hist[i]));
+	seq_printf(s, " >%d:%d", 1 << i, atomic_read(&sync_merge_hist[i]));
+	seq_puts(s, "\n");
+	seq_printf(s, "signal calls:%lld visited:%lld hold_ns:%lld hold_max_ns:%llu\n",
+		   (long long)atomic64_read(&sync_signal_count),
+		   (long long)atomic64_read(&sync_signal_visited),
+		   (long long)atomic64_read(&sync_signal_hold_ns),
+		   sync_signal_hold_max_ns);
+	return 0;
+}
+
+static int sync_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sync_stats_show, inode->i_private);
+}
+
+static const struct file_operations sync_stats_fops = {
+	.open           = sync_stats_open,
+	.read           = seq_read,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
 static __init int sync_debugfs_init(void)
 {
 	debugfs_create_file("sync", S_IRUGO, NULL, NULL, &sync_debugfs_fops);
+	debugfs_create_file("sync_stats", S_IRUGO, NULL, NULL, &sync_stats_fops);
 	return 0;
 }
 late_initcall(sync_debugfs_init);
@@ -26,6 +26,22 @@ struct sync_merge_data {
 	__s32	fence; /* fd on newly created fence */
 };
 
+/**
+ * struct sync_merge_n_data - data passed to the n-way merge ioctl
+ * @fds:	user pointer to an array of __s32 fence fds
+ * @num_fds:	number of fds in @fds, at most SYNC_MERGE_N_MAX
+ * @name:	name of new fence
+ * @fence:	returns the fd of the new fence to userspace
+ */
+struct sync_merge_n_data {
+	__u64	fds;
+	__u32	num_fds;
+	char	name[32];
+	__s32	fence;
+};
+
+#define SYNC_MERGE_N_MAX	64
+
 /**
  * struct sync_pt_info - detailed sync_pt information
  * @len:		length of sync_pt_info including any driver_data
@@ -94,4 +110,14 @@ struct sync_fence_info_data {
 #define SYNC_IOC_FENCE_INFO	_IOWR(SYNC_IOC_MAGIC, 2,\
 	struct sync_fence_info_data)
 
+/**
+ * DOC: SYNC_IOC_MERGE_N - merge many fences at once
+ *
+ * Takes a struct sync_merge_n_data.  Creates a new fence containing the
+ * sync_pts of the calling fd and of every fd in sync_merge_n_data.fds, keeping
+ * only the latest sync_pt of each timeline.  Returns the new fence's fd in
+ * sync_merge_n_data.fence
+ */
+#define SYNC_IOC_MERGE_N	_IOWR(SYNC_IOC_MAGIC, 8, struct sync_merge_n_data)
+
 #endif /* _UAPI_LINUX_SYNC_H */
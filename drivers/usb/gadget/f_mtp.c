@@ -58,6 +58,28 @@
 #define RX_REQ_MAX 2
 #define INTR_REQ_MAX 5
 
+/* upper bounds for the request size/count module parameters */
+#define MTP_TX_REQ_LEN_MAX         131072
+#define MTP_RX_REQ_LEN_MAX         32768
+#define MTP_TX_REQS_MAX            6
+
+/*
+ * Bulk request sizes, picked up at bind time. Larger requests cut the
+ * number of completions (and vfs calls) per file; if the buffers can not
+ * be allocated we fall back to MTP_BULK_BUFFER_SIZE.
+ */
+static unsigned int mtp_tx_req_len = MTP_TX_REQ_LEN_MAX;
+module_param(mtp_tx_req_len, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(mtp_tx_req_len, "MTP IN request buffer size");
+
+static unsigned int mtp_tx_reqs = TX_REQ_MAX;
+module_param(mtp_tx_reqs, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(mtp_tx_reqs, "number of MTP IN requests");
+
+static unsigned int mtp_rx_req_len = MTP_RX_REQ_LEN_MAX;
+module_param(mtp_rx_req_len, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(mtp_rx_req_len, "MTP OUT request buffer size");
+
 /* ID for Microsoft MTP OS String */
 #define MTP_OS_STRING_ID   0xEE
 
@@ -137,6 +159,8 @@ struct mtp_dev {
 	wait_queue_head_t intr_wq;
 	struct usb_request *rx_req[RX_REQ_MAX];
 	int rx_done;
+	unsigned tx_req_len;
+	unsigned rx_req_len;
 
 	/* for processing MTP_SEND_FILE, MTP_RECEIVE_FILE and
 	 * MTP_SEND_FILE_WITH_HEADER ioctls on a work queue
@@ -789,16 +813,31 @@ static int mtp_create_bulk_endpoints(struct mtp_dev *dev,
 	ep->driver_data = dev;		/* claim the endpoint */
 	dev->ep_intr = ep;
 
+	dev->tx_req_len = clamp_t(unsigned, mtp_tx_req_len,
+			MTP_BULK_BUFFER_SIZE, MTP_TX_REQ_LEN_MAX);
+	dev->rx_req_len = clamp_t(unsigned, mtp_rx_req_len,
+			MTP_BULK_BUFFER_SIZE, MTP_RX_REQ_LEN_MAX);
+	/* OUT requests must stay a multiple of maxpacket */
+	dev->rx_req_len = rounddown(dev->rx_req_len, 1024);
+
 	/* now allocate requests for our endpoints */
-	for (i = 0; i < TX_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_in, MTP_BULK_BUFFER_SIZE);
+	for (i = 0; i < clamp_t(unsigned, mtp_tx_reqs, 1, MTP_TX_REQS_MAX); i++) {
+		req = mtp_request_new(dev->ep_in, dev->tx_req_len);
+		if (!req && i == 0 && dev->tx_req_len > MTP_BULK_BUFFER_SIZE) {
+			dev->tx_req_len = MTP_BULK_BUFFER_SIZE;
+			req = mtp_request_new(dev->ep_in, dev->tx_req_len);
+		}
 		if (!req)
 			goto fail;
 		req->complete = mtp_complete_in;
 		mtp_req_put(dev, &dev->tx_idle, req);
 	}
 	for (i = 0; i < RX_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_out, MTP_BULK_BUFFER_SIZE);
+		req = mtp_request_new(dev->ep_out, dev->rx_req_len);
+		if (!req && i == 0 && dev->rx_req_len > MTP_BULK_BUFFER_SIZE) {
+			dev->rx_req_len = MTP_BULK_BUFFER_SIZE;
+			req = mtp_request_new(dev->ep_out, dev->rx_req_len);
+		}
 		if (!req)
 			goto fail;
 		req->complete = mtp_complete_out;
@@ -879,7 +918,7 @@ static ssize_t mtp_read(struct file *fp, char __user *buf,
 
 	DBG(cdev, "mtp_read(%zu)\n", count);
 
-	if (count > MTP_BULK_BUFFER_SIZE)
+	if (count > dev->rx_req_len)
 		return -EINVAL;
 
 	if (dev->epOut_halt) {
@@ -1060,8 +1099,8 @@ static ssize_t mtp_write(struct file *fp, const char __user *buf,
 			break;
 		}
 
-		if (count > MTP_BULK_BUFFER_SIZE)
-			xfer = MTP_BULK_BUFFER_SIZE;
+		if (count > dev->tx_req_len)
+			xfer = dev->tx_req_len;
 		else
 			xfer = count;
 		if (xfer && copy_from_user(req->buf, buf, xfer)) {
@@ -1168,8 +1207,8 @@ static void send_file_work(struct work_struct *data)
 			break;
 		}
 
-		if (count > MTP_BULK_BUFFER_SIZE)
-			xfer = MTP_BULK_BUFFER_SIZE;
+		if (count > dev->tx_req_len)
+			xfer = dev->tx_req_len;
 		else
 			xfer = count;
 
@@ -1310,8 +1349,8 @@ static void receive_file_work(struct work_struct *data)
 			read_req = dev->rx_req[cur_buf];
 			cur_buf = (cur_buf + 1) % RX_REQ_MAX;
 
-			read_req->length = (count > MTP_BULK_BUFFER_SIZE
-					? MTP_BULK_BUFFER_SIZE : count);
+			read_req->length = (count > dev->rx_req_len
+					? dev->rx_req_len : count);
 
 
 		/* This might be modified TBD,
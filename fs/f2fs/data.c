@@ -766,6 +766,40 @@ static int f2fs_read_data_pages(struct file *file,
 	return mpage_readpages(mapping, pages, nr_pages, get_data_block);
 }
 
+/*
+ * Learn the temperature of a regular file from how its blocks are written:
+ * each overwrite of an existing block heats it up and each newly allocated
+ * block cools it down. Once the overwrites lead by hot_rewrite_blocks the
+ * file is marked hot in i_advise, so its data goes to the hot data log from
+ * then on, also after the inode is reloaded; an equal lead of appends
+ * cools it again. Files the user marked cold by extension stay cold.
+ */
+static void update_file_temperature(struct inode *inode, bool rewrite)
+{
+	struct f2fs_inode_info *fi = F2FS_I(inode);
+	int thresh = F2FS_I_SB(inode)->hot_rewrite_blocks;
+
+	if (!thresh || !S_ISREG(inode->i_mode) || file_is_cold(inode))
+		return;
+
+	if (rewrite) {
+		if (fi->i_heat < thresh)
+			fi->i_heat++;
+		if (fi->i_heat >= thresh && !file_is_hot(inode)) {
+			file_set_hot(inode);
+			mark_inode_dirty(inode);
+		}
+	} else if (file_is_hot(inode)) {
+		if (fi->i_heat > -thresh)
+			fi->i_heat--;
+		if (fi->i_heat <= -thresh) {
+			file_clear_hot(inode);
+			fi->i_heat = 0;
+			mark_inode_dirty(inode);
+		}
+	}
+}
+
 int do_write_data_page(struct page *page, struct f2fs_io_info *fio)
 {
 	struct inode *inode = page->mapping->host;
@@ -786,6 +820,10 @@ int do_write_data_page(struct page *page, struct f2fs_io_info *fio)
 
 	set_page_writeback(page);
 
+	/* blocks moved by GC are not written by the user */
+	if (!is_cold_data(page))
+		update_file_temperature(inode, old_blkaddr != NEW_ADDR);
+
 	/*
 	 * If current allocation needs SSR,
 	 * it had better in-place writes for updated data.
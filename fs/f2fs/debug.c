@@ -77,6 +77,23 @@ static void update_general_status(struct f2fs_sb_info *sbi)
 		si->segment_count[i] = sbi->segment_count[i];
 		si->block_count[i] = sbi->block_count[i];
 	}
+
+	for (i = 0; i < NR_CURSEG_TYPE; i++)
+		si->log_blks[i] = sbi->log_block_count[i];
+	for (i = 0; i < NR_FSYNC_TYPE; i++)
+		si->fsync_count[i] = sbi->fsync_count[i];
+	for (i = 0; i < NR_FSYNC_LAT; i++)
+		si->fsync_lat[i] = sbi->fsync_lat[i];
+
+	if (SM_I(sbi)->dcc_info) {
+		struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+
+		si->discard_pending = dcc->nr_pending;
+		si->discard_entries = dcc->nr_entries;
+		si->discard_cmds = dcc->issued_cmds;
+		si->discard_blks = dcc->issued_blocks;
+		si->discard_dropped = dcc->dropped_blocks;
+	}
 }
 
 /*
@@ -174,6 +191,7 @@ get_cache:
 static int stat_show(struct seq_file *s, void *v)
 {
 	struct f2fs_stat_info *si;
+	unsigned int alloc_blks, user_blks, waf;
 	int i = 0;
 	int j;
 
@@ -241,6 +259,14 @@ static int stat_show(struct seq_file *s, void *v)
 		seq_printf(s, "Try to move %d blocks\n", si->tot_blks);
 		seq_printf(s, "  - data blocks : %d\n", si->data_blks);
 		seq_printf(s, "  - node blocks : %d\n", si->node_blks);
+		seq_printf(s, "  - cleaning cost : %d blocks per segment\n",
+			   si->tot_segs ? si->tot_blks / si->tot_segs : 0);
+		seq_printf(s, "\nDiscard: %u blocks pending in %u ranges\n",
+			   si->discard_pending, si->discard_entries);
+		seq_printf(s, "  - issued: %u cmds, %llu blocks\n",
+			   si->discard_cmds, si->discard_blks);
+		seq_printf(s, "  - dropped: %llu blocks\n",
+			   si->discard_dropped);
 		seq_printf(s, "\nExtent Hit Ratio: %d / %d\n",
 			   si->hit_ext, si->total_ext);
 		seq_puts(s, "\nBalancing F2FS Async:\n");
@@ -273,6 +299,27 @@ static int stat_show(struct seq_file *s, void *v)
 			   si->block_count[SSR], si->segment_count[SSR]);
 		seq_printf(s, "LFS: %u blocks in %u segments\n",
 			   si->block_count[LFS], si->segment_count[LFS]);
+		seq_printf(s, "Data blocks: hot %u, warm %u, cold %u\n",
+			   si->log_blks[CURSEG_HOT_DATA],
+			   si->log_blks[CURSEG_WARM_DATA],
+			   si->log_blks[CURSEG_COLD_DATA]);
+
+		/* every block GC moves is written once more */
+		alloc_blks = si->block_count[LFS] + si->block_count[SSR];
+		user_blks = alloc_blks > si->tot_blks ?
+				alloc_blks - si->tot_blks : 0;
+		waf = user_blks ? div_u64((u64)alloc_blks * 100, user_blks) : 0;
+		seq_printf(s, "WAF: %u.%02u (user: %u, GC: %d blocks)\n",
+			   waf / 100, waf % 100, user_blks, si->tot_blks);
+		seq_printf(s, "\nfsync: none %u, flush %u, node %u, cp %u\n",
+			   si->fsync_count[FSYNC_NONE],
+			   si->fsync_count[FSYNC_FLUSH],
+			   si->fsync_count[FSYNC_NODE],
+			   si->fsync_count[FSYNC_CP]);
+		seq_puts(s, "  - latency(ms):");
+		for (j = 0; j < NR_FSYNC_LAT - 1; j++)
+			seq_printf(s, " <%u: %u", 1 << j, si->fsync_lat[j]);
+		seq_printf(s, " >=%u: %u\n", 1 << j, si->fsync_lat[j]);
 
 		/* segment usage info */
 		update_sit_info(si->sbi);
@@ -19,6 +19,7 @@
 #include <linux/magic.h>
 #include <linux/kobject.h>
 #include <linux/sched.h>
+#include <linux/ktime.h>
 
 #ifdef CONFIG_F2FS_CHECK_FS
 #define f2fs_bug_on(sbi, condition)	BUG_ON(condition)
@@ -246,9 +247,15 @@ struct extent_info {
  */
 #define FADVISE_COLD_BIT	0x01
 #define FADVISE_LOST_PINO_BIT	0x02
+#define FADVISE_HOT_BIT		0x04
 
 #define DEF_DIR_LEVEL		0
 
+/* for hot/cold data separation */
+#define F2FS_MAX_USER_EXTENSION	16	/* # of sysfs hot/cold extensions */
+#define DEF_HOT_REWRITE_BLOCKS	64	/* overwrites that make a file hot */
+#define DEF_MMAP_RA_MAX_KB	512	/* largest learned mmap readahead window */
+
 struct f2fs_inode_info {
 	struct inode vfs_inode;		/* serve a vfs inode */
 	unsigned long i_flags;		/* keep an inode flags for ioctl */
@@ -257,6 +264,9 @@ struct f2fs_inode_info {
 	unsigned int i_current_depth;	/* use only in directory structure */
 	unsigned int i_pino;		/* parent inode number */
 	umode_t i_acl_mode;		/* keep file acl mode temporarily */
+	int i_heat;			/* overwrites minus appends, see data.c */
+	pgoff_t i_ra_last;		/* page of the last major mmap fault */
+	unsigned int i_ra_pages;	/* learned mmap readahead window, see file.c */
 
 	/* Use below internally in f2fs*/
 	unsigned long flags;		/* use to pass per-file flags */
@@ -385,6 +395,26 @@ struct flush_cmd_control {
 	struct llist_node *dispatch_list;	/* list for command dispatch */
 };
 
+/*
+ * Discards of invalidated ranges are queued at checkpoint time, merged,
+ * and sent from a low priority thread whenever the device is idle.
+ */
+struct discard_cmd_control {
+	struct task_struct *f2fs_issue_discard;	/* discard thread */
+	wait_queue_head_t discard_wait_queue;	/* waiting queue for wake-up */
+	wait_queue_head_t discard_done_queue;	/* waiting for issue_* range */
+	struct mutex discard_mutex;		/* protects the fields below */
+	struct list_head pend_list;		/* ranges sorted by blkaddr */
+	unsigned int nr_pending;		/* # of blocks in pend_list */
+	unsigned int nr_entries;		/* # of ranges in pend_list */
+	unsigned long queue_time;		/* jiffies of oldest pending */
+	block_t issue_start;			/* range being sent */
+	unsigned int issue_len;
+	unsigned int issued_cmds;		/* # of discard commands sent */
+	unsigned long long issued_blocks;	/* # of blocks discarded */
+	unsigned long long dropped_blocks;	/* reallocated before sent */
+};
+
 struct f2fs_sm_info {
 	struct sit_info *sit_info;		/* whole segment information */
 	struct free_segmap_info *free_info;	/* free segment information */
@@ -417,11 +447,25 @@ struct f2fs_sm_info {
 	/* for flush command control */
 	struct flush_cmd_control *cmd_control_info;
 
+	/* for discard command control */
+	struct discard_cmd_control *dcc_info;
+
 };
 
 /*
  * For superblock
  */
+/* what an fsync had to do to make the file durable, for the stats */
+enum {
+	FSYNC_NONE,		/* nothing was written since the last one */
+	FSYNC_FLUSH,		/* in-place updates, cache flush only */
+	FSYNC_NODE,		/* roll-forward: fsync-marked dnodes */
+	FSYNC_CP,		/* fell back to a checkpoint */
+	NR_FSYNC_TYPE,
+};
+
+#define NR_FSYNC_LAT		10	/* < 1ms, < 2ms, ... >= 256ms */
+
 /*
  * COUNT_TYPE for monitoring
  *
@@ -548,6 +592,16 @@ struct f2fs_sb_info {
 	/* maximum # of trials to find a victim segment for SSR and GC */
 	unsigned int max_victim_search;
 
+	/* for hot/cold data separation */
+	struct rw_semaphore ext_rwsem;		/* protect the lists below */
+	__u8 hot_ext[F2FS_MAX_USER_EXTENSION][8];	/* hot extensions */
+	__u8 cold_ext[F2FS_MAX_USER_EXTENSION][8];	/* extra cold ones */
+	int hot_ext_count, cold_ext_count;
+	unsigned int hot_rewrite_blocks;	/* 0 disables the learning */
+
+	/* for mmap readahead learning */
+	unsigned int mmap_ra_max_kb;		/* 0 disables the learning */
+
 	/*
 	 * for stat information.
 	 * one is for the LFS mode, and the other is for the SSR mode.
@@ -560,6 +614,9 @@ struct f2fs_sb_info {
 	int inline_inode;			/* # of inline_data inodes */
 	int bg_gc;				/* background gc calls */
 	unsigned int n_dirty_dirs;		/* # of dir inodes */
+	unsigned int log_block_count[NR_CURSEG_TYPE];	/* blocks per log */
+	unsigned int fsync_count[NR_FSYNC_TYPE];	/* fsync calls by path */
+	unsigned int fsync_lat[NR_FSYNC_LAT];		/* fsync latency */
 #endif
 	unsigned int last_victim[2];		/* last victim segment # */
 	spinlock_t stat_lock;			/* lock for stat operations */
@@ -1307,6 +1364,7 @@ void refresh_sit_entry(struct f2fs_sb_info *, block_t, block_t);
 void clear_prefree_segments(struct f2fs_sb_info *);
 void release_discard_addrs(struct f2fs_sb_info *);
 void discard_next_dnode(struct f2fs_sb_info *, block_t);
+void f2fs_flush_discards(struct f2fs_sb_info *);
 int npages_for_summary_flush(struct f2fs_sb_info *);
 void allocate_new_segments(struct f2fs_sb_info *);
 int f2fs_trim_fs(struct f2fs_sb_info *, struct fstrim_range *);
@@ -1420,6 +1478,11 @@ struct f2fs_stat_info {
 
 	unsigned int segment_count[2];
 	unsigned int block_count[2];
+	unsigned int log_blks[NR_CURSEG_TYPE];
+	unsigned int fsync_count[NR_FSYNC_TYPE];
+	unsigned int fsync_lat[NR_FSYNC_LAT];
+	unsigned int discard_pending, discard_entries, discard_cmds;
+	unsigned long long discard_blks, discard_dropped;
 	unsigned base_mem, cache_mem;
 };
 
@@ -1450,6 +1513,21 @@ static inline struct f2fs_stat_info *F2FS_STAT(struct f2fs_sb_info *sbi)
 		((sbi)->segment_count[(curseg)->alloc_type]++)
 #define stat_inc_block_count(sbi, curseg)				\
 		((sbi)->block_count[(curseg)->alloc_type]++)
+#define stat_inc_log_block_count(sbi, type)				\
+		((sbi)->log_block_count[type]++)
+
+/* fsync latency histogram: bucket i counts calls under 2^i ms */
+static inline void stat_inc_fsync(struct f2fs_sb_info *sbi, int type,
+						ktime_t start)
+{
+	s64 us = ktime_us_delta(ktime_get(), start);
+	int i = 0;
+
+	while (i < NR_FSYNC_LAT - 1 && us >= (USEC_PER_MSEC << i))
+		i++;
+	sbi->fsync_count[type]++;
+	sbi->fsync_lat[i]++;
+}
 
 #define stat_inc_seg_count(sbi, type)					\
 	do {								\
@@ -1494,6 +1572,8 @@ void f2fs_destroy_root_stats(void);
 #define stat_dec_inline_inode(inode)
 #define stat_inc_seg_type(sbi, curseg)
 #define stat_inc_block_count(sbi, curseg)
+#define stat_inc_log_block_count(sbi, type)
+#define stat_inc_fsync(sbi, type, start)	((void)(start))
 #define stat_inc_seg_count(si, type)
 #define stat_inc_tot_blk_count(si, blks)
 #define stat_inc_data_blk_count(si, blks)
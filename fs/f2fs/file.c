@@ -88,8 +88,50 @@ out:
 	return block_page_mkwrite_return(err);
 }
 
+/*
+ * Learn a readahead window for mmapped files from their major faults. A
+ * fault past the previous one but within one window of it means the file
+ * is walked in order (dex/odex verification, relocating a library), so the
+ * window doubles, up to mmap_ra_max_kb; a fault anywhere else halves it.
+ * The window is kept in the inode, so every mapping and later open of the
+ * file starts with it, and filemap_fault() reads around the faulting page
+ * with it in large requests. Cached neighbours are mapped by
+ * filemap_map_pages(), the fault-around.
+ */
+static int f2fs_filemap_fault(struct vm_area_struct *vma, struct vm_fault *vmf)
+{
+	struct file *file = vma->vm_file;
+	struct inode *inode = file_inode(file);
+	struct f2fs_inode_info *fi = F2FS_I(inode);
+	unsigned int limit = F2FS_I_SB(inode)->mmap_ra_max_kb >> (PAGE_CACHE_SHIFT - 10);
+	unsigned int base = inode->i_mapping->backing_dev_info->ra_pages;
+	unsigned int win = ACCESS_ONCE(fi->i_ra_pages);
+	pgoff_t last;
+	int ret;
+
+	if (!limit || !base || (vma->vm_flags & VM_RAND_READ))
+		return filemap_fault(vma, vmf);
+
+	if (win > file->f_ra.ra_pages)
+		file->f_ra.ra_pages = win;
+
+	ret = filemap_fault(vma, vmf);
+	if (!(ret & VM_FAULT_MAJOR))
+		return ret;
+
+	last = ACCESS_ONCE(fi->i_ra_last);
+	win = max(win, base);
+	if (vmf->pgoff > last && vmf->pgoff <= last + win)
+		win = min(win * 2, max(limit, base));
+	else
+		win /= 2;
+	fi->i_ra_pages = win > base ? win : 0;
+	fi->i_ra_last = vmf->pgoff;
+	return ret;
+}
+
 static const struct vm_operations_struct f2fs_file_vm_ops = {
-	.fault		= filemap_fault,
+	.fault		= f2fs_filemap_fault,
 	.map_pages	= filemap_map_pages,
 	.page_mkwrite	= f2fs_vm_page_mkwrite,
 	.remap_pages	= generic_file_remap_pages,
@@ -142,6 +184,8 @@ int f2fs_sync_file(struct file *file, loff_t start, loff_t end, int datasync)
 	nid_t ino = inode->i_ino;
 	int ret = 0;
 	bool need_cp = false;
+	int fsync_type = FSYNC_NONE;
+	ktime_t start_time = ktime_get();
 	struct writeback_control wbc = {
 		.sync_mode = WB_SYNC_ALL,
 		.nr_to_write = LONG_MAX,
@@ -179,8 +223,10 @@ int f2fs_sync_file(struct file *file, loff_t start, loff_t end, int datasync)
 		f2fs_put_page(i, 0);
 
 		if (is_inode_flag_set(fi, FI_UPDATE_WRITE) ||
-				exist_written_data(sbi, ino, UPDATE_INO))
+				exist_written_data(sbi, ino, UPDATE_INO)) {
+			fsync_type = FSYNC_FLUSH;
 			goto flush_out;
+		}
 		goto out;
 	}
 go_write:
@@ -198,6 +244,8 @@ go_write:
 	if (need_cp) {
 		nid_t pino;
 
+		fsync_type = FSYNC_CP;
+
 		/* all the dirty node pages should be flushed for POR */
 		ret = f2fs_sync_fs(inode->i_sb, 1);
 
@@ -216,6 +264,7 @@ go_write:
 			up_write(&fi->i_sem);
 		}
 	} else {
+		fsync_type = FSYNC_NODE;
 sync_nodes:
 		sync_node_pages(sbi, ino, &wbc);
 
@@ -240,6 +289,8 @@ flush_out:
 		ret = f2fs_issue_flush(F2FS_I_SB(inode));
 	}
 out:
+	if (!ret)
+		stat_inc_fsync(sbi, fsync_type, start_time);
 	trace_f2fs_sync_file_exit(inode, need_cp, datasync, ret);
 	return ret;
 }
@@ -32,6 +32,7 @@ static int gc_thread_func(void *data)
 	struct f2fs_gc_kthread *gc_th = sbi->gc_thread;
 	wait_queue_head_t *wq = &sbi->gc_thread->gc_wait_queue_head;
 	long wait_ms;
+	bool boost;
 
 	wait_ms = gc_th->min_sleep_time;
 
@@ -40,11 +41,14 @@ static int gc_thread_func(void *data)
 			continue;
 		else
 			wait_event_interruptible_timeout(*wq,
-						kthread_should_stop(),
+						kthread_should_stop() ||
+						gc_th->gc_wake,
 						msecs_to_jiffies(wait_ms));
 		if (kthread_should_stop())
 			break;
 
+		gc_th->gc_wake = 0;
+
 		if (sbi->sb->s_writers.frozen >= SB_FREEZE_WRITE) {
 			wait_ms = increase_sleep_time(gc_th, wait_ms);
 			continue;
@@ -63,19 +67,32 @@ static int gc_thread_func(void *data)
 		 * invalidated soon after by user update or deletion.
 		 * So, I'd like to wait some time to collect dirty segments.
 		 */
+		boost = gc_th->gc_urgent || need_bg_gc_boost(sbi);
+
+		/*
+		 * When boosted, come back every urgent_sleep_time even if the
+		 * disk is busy now: the slices are kept short, so it is the
+		 * idle windows between foreground bursts we are after.
+		 */
+		if (boost)
+			wait_ms = gc_th->urgent_sleep_time;
+
 		if (!mutex_trylock(&sbi->gc_mutex))
 			continue;
 
 		if (!is_idle(sbi)) {
-			wait_ms = increase_sleep_time(gc_th, wait_ms);
+			if (!boost)
+				wait_ms = increase_sleep_time(gc_th, wait_ms);
 			mutex_unlock(&sbi->gc_mutex);
 			continue;
 		}
 
-		if (has_enough_invalid_blocks(sbi))
-			wait_ms = decrease_sleep_time(gc_th, wait_ms);
-		else
-			wait_ms = increase_sleep_time(gc_th, wait_ms);
+		if (!boost) {
+			if (has_enough_invalid_blocks(sbi))
+				wait_ms = decrease_sleep_time(gc_th, wait_ms);
+			else
+				wait_ms = increase_sleep_time(gc_th, wait_ms);
+		}
 
 		stat_inc_bggc_count(sbi);
 
@@ -109,6 +126,10 @@ int start_gc_thread(struct f2fs_sb_info *sbi)
 	gc_th->no_gc_sleep_time = DEF_GC_THREAD_NOGC_SLEEP_TIME;
 
 	gc_th->gc_idle = 0;
+	gc_th->gc_urgent = 0;
+	gc_th->gc_wake = 0;
+	gc_th->urgent_sleep_time = DEF_GC_THREAD_URGENT_SLEEP_TIME;
+	gc_th->slice_time = DEF_GC_THREAD_SLICE_TIME;
 
 	sbi->gc_thread = gc_th;
 	init_waitqueue_head(&sbi->gc_thread->gc_wait_queue_head);
@@ -142,6 +163,9 @@ static int select_gc_type(struct f2fs_gc_kthread *gc_th, int gc_type)
 			gc_mode = GC_CB;
 		else if (gc_th->gc_idle == 2)
 			gc_mode = GC_GREEDY;
+	} else if (gc_th && gc_th->gc_urgent) {
+		/* reclaim as much space as possible per slice */
+		gc_mode = GC_GREEDY;
 	}
 	return gc_mode;
 }
@@ -686,6 +710,23 @@ static void do_garbage_collect(struct f2fs_sb_info *sbi, unsigned int segno,
 	f2fs_put_page(sum_page, 1);
 }
 
+/*
+ * A boosted background pass keeps cleaning sections until its time slice
+ * is used up or foreground I/O shows up on the disk.
+ */
+static bool bg_gc_more(struct f2fs_sb_info *sbi, unsigned long slice_end)
+{
+	struct f2fs_gc_kthread *gc_th = sbi->gc_thread;
+
+	if (!gc_th)
+		return false;
+	if (!gc_th->gc_urgent && !need_bg_gc_boost(sbi))
+		return false;
+	if (time_after_eq(jiffies, slice_end))
+		return false;
+	return is_idle(sbi);
+}
+
 int f2fs_gc(struct f2fs_sb_info *sbi)
 {
 	struct list_head ilist;
@@ -693,11 +734,15 @@ int f2fs_gc(struct f2fs_sb_info *sbi)
 	int gc_type = BG_GC;
 	int nfree = 0;
 	int ret = -1;
+	unsigned long slice_end = jiffies;
 	struct cp_control cpc = {
 		.reason = CP_SYNC,
 	};
 
 	INIT_LIST_HEAD(&ilist);
+	if (sbi->gc_thread)
+		slice_end = jiffies +
+			msecs_to_jiffies(sbi->gc_thread->slice_time);
 gc_more:
 	if (unlikely(!(sbi->sb->s_flags & MS_ACTIVE)))
 		goto stop;
@@ -718,8 +763,15 @@ gc_more:
 		ra_meta_pages(sbi, GET_SUM_BLOCK(sbi, segno), sbi->segs_per_sec,
 								META_SSA);
 
-	for (i = 0; i < sbi->segs_per_sec; i++)
+	for (i = 0; i < sbi->segs_per_sec; i++) {
+		/*
+		 * a background pass gives way to foreground I/O; what is
+		 * left of the section is picked up again by a later pass.
+		 */
+		if (gc_type == BG_GC && i && !is_idle(sbi))
+			break;
 		do_garbage_collect(sbi, segno + i, &ilist, gc_type);
+	}
 
 	if (gc_type == FG_GC) {
 		sbi->cur_victim_sec = NULL_SEGNO;
@@ -730,6 +782,9 @@ gc_more:
 	if (has_not_enough_free_secs(sbi, nfree))
 		goto gc_more;
 
+	if (gc_type == BG_GC && bg_gc_more(sbi, slice_end))
+		goto gc_more;
+
 	if (gc_type == FG_GC)
 		write_checkpoint(sbi, &cpc);
 stop:
@@ -16,6 +16,8 @@
 #define DEF_GC_THREAD_MIN_SLEEP_TIME	30000	/* milliseconds */
 #define DEF_GC_THREAD_MAX_SLEEP_TIME	60000
 #define DEF_GC_THREAD_NOGC_SLEEP_TIME	300000	/* wait 5 min */
+#define DEF_GC_THREAD_URGENT_SLEEP_TIME	500	/* 500 ms */
+#define DEF_GC_THREAD_SLICE_TIME	50	/* ms of cleaning per wakeup */
 #define LIMIT_INVALID_BLOCK	40 /* percentage over total user space */
 #define LIMIT_FREE_BLOCK	40 /* percentage over invalid + free space */
 
@@ -33,6 +35,18 @@ struct f2fs_gc_kthread {
 
 	/* for changing gc mode */
 	unsigned int gc_idle;
+
+	/*
+	 * set by userspace while the device is charging or the screen is
+	 * off: clean greedily every urgent_sleep_time as long as the disk
+	 * stays idle, so that foreground GC is not needed later on.
+	 */
+	unsigned int gc_urgent;
+	unsigned int urgent_sleep_time;
+	unsigned int gc_wake;
+
+	/* upper bound of one background cleaning pass */
+	unsigned int slice_time;
 };
 
 struct inode_entry {
@@ -101,10 +115,31 @@ static inline bool has_enough_invalid_blocks(struct f2fs_sb_info *sbi)
 	return false;
 }
 
+/*
+ * Free sections are within one reserved area of the foreground GC
+ * threshold: clean in the background now rather than stalling a writer
+ * in f2fs_balance_fs() soon.
+ */
+static inline bool need_bg_gc_boost(struct f2fs_sb_info *sbi)
+{
+	int node_secs = get_blocktype_secs(sbi, F2FS_DIRTY_NODES);
+	int dent_secs = get_blocktype_secs(sbi, F2FS_DIRTY_DENTS);
+
+	return free_sections(sbi) <= (node_secs + 2 * dent_secs +
+					2 * reserved_sections(sbi));
+}
+
 static inline int is_idle(struct f2fs_sb_info *sbi)
 {
 	struct block_device *bdev = sbi->sb->s_bdev;
 	struct request_queue *q = bdev_get_queue(bdev);
 	struct request_list *rl = &q->root_rl;
+
+	/*
+	 * root_rl is not used by blk-mq queues, the in-flight count of the
+	 * whole disk covers both and also sees I/O to other partitions.
+	 */
+	if (part_in_flight(&bdev->bd_disk->part0))
+		return 0;
 	return !(rl->count[BLK_RW_SYNC]) && !(rl->count[BLK_RW_ASYNC]);
 }
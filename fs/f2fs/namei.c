@@ -82,21 +82,38 @@ static int is_multimedia_file(const unsigned char *s, const char *sub)
 }
 
 /*
- * Set multimedia files as cold files for hot/cold data separation
+ * Set multimedia files as cold files for hot/cold data separation, and the
+ * files matching the hot extensions set through sysfs as hot files
  */
-static inline void set_cold_files(struct f2fs_sb_info *sbi, struct inode *inode,
-		const unsigned char *name)
+static inline void set_file_temperature(struct f2fs_sb_info *sbi,
+		struct inode *inode, const unsigned char *name)
 {
 	int i;
 	__u8 (*extlist)[8] = sbi->raw_super->extension_list;
 
 	int count = le32_to_cpu(sbi->raw_super->extension_count);
+
+	down_read(&sbi->ext_rwsem);
+	for (i = 0; i < sbi->hot_ext_count; i++) {
+		if (is_multimedia_file(name, sbi->hot_ext[i])) {
+			file_set_hot(inode);
+			goto out;
+		}
+	}
+	for (i = 0; i < sbi->cold_ext_count; i++) {
+		if (is_multimedia_file(name, sbi->cold_ext[i])) {
+			file_set_cold(inode);
+			goto out;
+		}
+	}
 	for (i = 0; i < count; i++) {
 		if (is_multimedia_file(name, extlist[i])) {
 			file_set_cold(inode);
 			break;
 		}
 	}
+out:
+	up_read(&sbi->ext_rwsem);
 }
 
 static int f2fs_create(struct inode *dir, struct dentry *dentry, umode_t mode,
@@ -114,7 +131,7 @@ static int f2fs_create(struct inode *dir, struct dentry *dentry, umode_t mode,
 		return PTR_ERR(inode);
 
 	if (!test_opt(sbi, DISABLE_EXT_IDENTIFY))
-		set_cold_files(sbi, inode, dentry->d_name.name);
+		set_file_temperature(sbi, inode, dentry->d_name.name);
 
 	inode->i_op = &f2fs_file_inode_operations;
 	inode->i_fop = &f2fs_file_operations;
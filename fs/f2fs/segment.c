@@ -14,6 +14,7 @@
 #include <linux/blkdev.h>
 #include <linux/prefetch.h>
 #include <linux/kthread.h>
+#include <linux/freezer.h>
 #include <linux/vmalloc.h>
 #include <linux/swap.h>
 
@@ -441,6 +442,299 @@ void discard_next_dnode(struct f2fs_sb_info *sbi, block_t blkaddr)
 	}
 }
 
+/*
+ * Add [blkstart, blkstart + blklen) to the pending ranges, merging it with
+ * the ranges it touches or overlaps. Ranges are mostly queued in ascending
+ * order, so the sorted list is searched from its tail.
+ */
+static void __insert_discard_range(struct discard_cmd_control *dcc,
+				block_t blkstart, block_t blklen)
+{
+	struct list_head *head = &dcc->pend_list;
+	struct discard_entry *entry, *prev = NULL, *next;
+	block_t end = blkstart + blklen;
+
+	list_for_each_entry_reverse(entry, head, list) {
+		if (entry->blkaddr <= blkstart) {
+			prev = entry;
+			break;
+		}
+	}
+
+	if (list_empty(head))
+		dcc->queue_time = jiffies;
+
+	if (prev && prev->blkaddr + prev->len >= blkstart) {
+		block_t prev_end = prev->blkaddr + prev->len;
+
+		if (end > prev_end) {
+			dcc->nr_pending += end - prev_end;
+			prev->len = end - prev->blkaddr;
+		}
+		entry = prev;
+	} else {
+		entry = f2fs_kmem_cache_alloc(discard_entry_slab, GFP_NOFS);
+		INIT_LIST_HEAD(&entry->list);
+		entry->blkaddr = blkstart;
+		entry->len = blklen;
+		list_add(&entry->list, prev ? &prev->list : head);
+		dcc->nr_pending += blklen;
+		dcc->nr_entries++;
+	}
+
+	/* swallow the following ranges the merged one reaches */
+	while (!list_is_last(&entry->list, head)) {
+		block_t cur_end = entry->blkaddr + entry->len;
+		block_t next_end;
+
+		next = list_next_entry(entry, list);
+		if (next->blkaddr > cur_end)
+			break;
+
+		next_end = next->blkaddr + next->len;
+		dcc->nr_pending -= min(cur_end, next_end) - next->blkaddr;
+		if (next_end > cur_end)
+			entry->len = next_end - entry->blkaddr;
+
+		list_del(&next->list);
+		kmem_cache_free(discard_entry_slab, next);
+		dcc->nr_entries--;
+	}
+}
+
+static void f2fs_queue_discard(struct f2fs_sb_info *sbi,
+				block_t blkstart, block_t blklen)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+
+	if (!dcc) {
+		f2fs_issue_discard(sbi, blkstart, blklen);
+		return;
+	}
+
+	mutex_lock(&dcc->discard_mutex);
+	__insert_discard_range(dcc, blkstart, blklen);
+	mutex_unlock(&dcc->discard_mutex);
+}
+
+static inline bool __discard_in_flight(struct discard_cmd_control *dcc,
+					block_t start, block_t end)
+{
+	return dcc->issue_len && dcc->issue_start < end &&
+			dcc->issue_start + dcc->issue_len > start;
+}
+
+/*
+ * The segment is about to be written again: its pending discards are
+ * pointless now and must not be sent after the new data, and a discard
+ * already in flight there has to complete first.
+ */
+static void f2fs_wait_discard(struct f2fs_sb_info *sbi, unsigned int segno)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	struct discard_entry *entry, *this;
+	block_t start, end;
+
+	if (!dcc)
+		return;
+
+	start = START_BLOCK(sbi, segno);
+	end = start + sbi->blocks_per_seg;
+
+	mutex_lock(&dcc->discard_mutex);
+	list_for_each_entry_safe(entry, this, &dcc->pend_list, list) {
+		block_t e_end = entry->blkaddr + entry->len;
+
+		if (e_end <= start)
+			continue;
+		if (entry->blkaddr >= end)
+			break;
+
+		if (entry->blkaddr < start && e_end > end) {
+			struct discard_entry *tail;
+
+			tail = f2fs_kmem_cache_alloc(discard_entry_slab,
+								GFP_NOFS);
+			INIT_LIST_HEAD(&tail->list);
+			tail->blkaddr = end;
+			tail->len = e_end - end;
+			list_add(&tail->list, &entry->list);
+			dcc->nr_entries++;
+
+			entry->len = start - entry->blkaddr;
+			dcc->nr_pending -= end - start;
+			dcc->dropped_blocks += end - start;
+			break;
+		} else if (entry->blkaddr < start) {
+			entry->len = start - entry->blkaddr;
+			dcc->nr_pending -= e_end - start;
+			dcc->dropped_blocks += e_end - start;
+		} else if (e_end > end) {
+			entry->len = e_end - end;
+			entry->blkaddr = end;
+			dcc->nr_pending -= end - start;
+			dcc->dropped_blocks += end - start;
+		} else {
+			dcc->nr_pending -= entry->len;
+			dcc->dropped_blocks += entry->len;
+			list_del(&entry->list);
+			kmem_cache_free(discard_entry_slab, entry);
+			dcc->nr_entries--;
+		}
+	}
+
+	while (__discard_in_flight(dcc, start, end)) {
+		mutex_unlock(&dcc->discard_mutex);
+		wait_event(dcc->discard_done_queue,
+				!__discard_in_flight(dcc, start, end));
+		mutex_lock(&dcc->discard_mutex);
+	}
+	mutex_unlock(&dcc->discard_mutex);
+}
+
+/*
+ * Send at most one section from the head of the pending ranges, so that
+ * neither foreground I/O nor a writer waiting in f2fs_wait_discard() is
+ * held up by one huge discard. Returns false once nothing is pending.
+ */
+static bool __issue_discard_chunk(struct f2fs_sb_info *sbi)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	struct discard_entry *entry;
+	block_t start;
+	unsigned int len;
+
+	mutex_lock(&dcc->discard_mutex);
+	while (dcc->issue_len) {
+		mutex_unlock(&dcc->discard_mutex);
+		wait_event(dcc->discard_done_queue, !dcc->issue_len);
+		mutex_lock(&dcc->discard_mutex);
+	}
+
+	if (list_empty(&dcc->pend_list)) {
+		mutex_unlock(&dcc->discard_mutex);
+		return false;
+	}
+
+	entry = list_first_entry(&dcc->pend_list, struct discard_entry, list);
+	start = entry->blkaddr;
+	len = min_t(unsigned int, entry->len,
+			sbi->blocks_per_seg * sbi->segs_per_sec);
+
+	entry->blkaddr += len;
+	entry->len -= len;
+	if (!entry->len) {
+		list_del(&entry->list);
+		kmem_cache_free(discard_entry_slab, entry);
+		dcc->nr_entries--;
+	}
+	dcc->nr_pending -= len;
+	dcc->issue_start = start;
+	dcc->issue_len = len;
+	mutex_unlock(&dcc->discard_mutex);
+
+	f2fs_issue_discard(sbi, start, len);
+
+	mutex_lock(&dcc->discard_mutex);
+	dcc->issue_len = 0;
+	dcc->issued_cmds++;
+	dcc->issued_blocks += len;
+	mutex_unlock(&dcc->discard_mutex);
+
+	wake_up_all(&dcc->discard_done_queue);
+	return true;
+}
+
+/* send everything pending right away, e.g. for FITRIM or at umount */
+void f2fs_flush_discards(struct f2fs_sb_info *sbi)
+{
+	if (!SM_I(sbi)->dcc_info)
+		return;
+
+	while (__issue_discard_chunk(sbi))
+		cond_resched();
+}
+
+static bool discard_should_defer(struct f2fs_sb_info *sbi)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	struct block_device *bdev = sbi->sb->s_bdev;
+
+	if (dcc->nr_pending > DISCARD_MAX_PENDING)
+		return false;
+	if (time_after(jiffies, dcc->queue_time + DISCARD_MAX_DELAY * HZ))
+		return false;
+	return part_in_flight(&bdev->bd_disk->part0);
+}
+
+static int issue_discard_thread(void *data)
+{
+	struct f2fs_sb_info *sbi = data;
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	wait_queue_head_t *q = &dcc->discard_wait_queue;
+
+	set_user_nice(current, MAX_NICE);
+
+	do {
+		if (try_to_freeze())
+			continue;
+
+		wait_event_interruptible(*q,
+			kthread_should_stop() || dcc->nr_pending);
+		if (kthread_should_stop())
+			break;
+
+		/* let foreground I/O go first */
+		if (discard_should_defer(sbi)) {
+			schedule_timeout_interruptible(
+				msecs_to_jiffies(DISCARD_IDLE_INTERVAL));
+			continue;
+		}
+
+		__issue_discard_chunk(sbi);
+	} while (!kthread_should_stop());
+	return 0;
+}
+
+static int create_discard_cmd_control(struct f2fs_sb_info *sbi)
+{
+	dev_t dev = sbi->sb->s_bdev->bd_dev;
+	struct discard_cmd_control *dcc;
+	int err = 0;
+
+	dcc = kzalloc(sizeof(struct discard_cmd_control), GFP_KERNEL);
+	if (!dcc)
+		return -ENOMEM;
+	init_waitqueue_head(&dcc->discard_wait_queue);
+	init_waitqueue_head(&dcc->discard_done_queue);
+	mutex_init(&dcc->discard_mutex);
+	INIT_LIST_HEAD(&dcc->pend_list);
+	SM_I(sbi)->dcc_info = dcc;
+	dcc->f2fs_issue_discard = kthread_run(issue_discard_thread, sbi,
+				"f2fs_discard-%u:%u", MAJOR(dev), MINOR(dev));
+	if (IS_ERR(dcc->f2fs_issue_discard)) {
+		err = PTR_ERR(dcc->f2fs_issue_discard);
+		kfree(dcc);
+		SM_I(sbi)->dcc_info = NULL;
+		return err;
+	}
+
+	return err;
+}
+
+static void destroy_discard_cmd_control(struct f2fs_sb_info *sbi)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+
+	if (!dcc)
+		return;
+
+	kthread_stop(dcc->f2fs_issue_discard);
+	f2fs_flush_discards(sbi);
+	kfree(dcc);
+	SM_I(sbi)->dcc_info = NULL;
+}
+
 static void add_discard_addrs(struct f2fs_sb_info *sbi, struct cp_control *cpc)
 {
 	struct list_head *head = &SM_I(sbi)->discard_list;
@@ -540,6 +834,7 @@ static void set_prefree_as_free_segments(struct f2fs_sb_info *sbi)
 
 void clear_prefree_segments(struct f2fs_sb_info *sbi)
 {
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
 	struct list_head *head = &(SM_I(sbi)->discard_list);
 	struct discard_entry *entry, *this;
 	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
@@ -564,18 +859,22 @@ void clear_prefree_segments(struct f2fs_sb_info *sbi)
 		if (!test_opt(sbi, DISCARD))
 			continue;
 
-		f2fs_issue_discard(sbi, START_BLOCK(sbi, start),
+		f2fs_queue_discard(sbi, START_BLOCK(sbi, start),
 				(end - start) << sbi->log_blocks_per_seg);
 	}
 	mutex_unlock(&dirty_i->seglist_lock);
 
-	/* send small discards */
+	/* queue small discards */
 	list_for_each_entry_safe(entry, this, head, list) {
-		f2fs_issue_discard(sbi, entry->blkaddr, entry->len);
+		f2fs_queue_discard(sbi, entry->blkaddr, entry->len);
 		list_del(&entry->list);
 		SM_I(sbi)->nr_discards -= entry->len;
 		kmem_cache_free(discard_entry_slab, entry);
 	}
+
+	/* the checkpoint does not wait for them, the discard thread sends */
+	if (dcc && dcc->nr_pending)
+		wake_up(&dcc->discard_wait_queue);
 }
 
 static bool __mark_sit_entry_dirty(struct f2fs_sb_info *sbi, unsigned int segno)
@@ -865,6 +1164,7 @@ static void new_curseg(struct f2fs_sb_info *sbi, int type, bool new_sec)
 		dir = ALLOC_RIGHT;
 
 	get_new_segment(sbi, &segno, new_sec, dir);
+	f2fs_wait_discard(sbi, segno);
 	curseg->next_segno = segno;
 	reset_curseg(sbi, type, 1);
 	curseg->alloc_type = LFS;
@@ -917,6 +1217,7 @@ static void change_curseg(struct f2fs_sb_info *sbi, int type, bool reuse)
 	write_sum_page(sbi, curseg->sum_blk,
 				GET_SUM_BLOCK(sbi, curseg->segno));
 	__set_test_and_inuse(sbi, new_segno);
+	f2fs_wait_discard(sbi, new_segno);
 
 	mutex_lock(&dirty_i->seglist_lock);
 	__remove_dirty_segment(sbi, new_segno, PRE);
@@ -1019,6 +1320,9 @@ int f2fs_trim_fs(struct f2fs_sb_info *sbi, struct fstrim_range *range)
 
 	/* do checkpoint to issue discard commands safely */
 	write_checkpoint(sbi, &cpc);
+
+	/* FITRIM returns once the trimmed ranges reached the device */
+	f2fs_flush_discards(sbi);
 out:
 	range->len = cpc.trimmed << sbi->log_blocksize;
 	return 0;
@@ -1045,7 +1349,8 @@ static int __get_segment_type_4(struct page *page, enum page_type p_type)
 	if (p_type == DATA) {
 		struct inode *inode = page->mapping->host;
 
-		if (S_ISDIR(inode->i_mode))
+		if (S_ISDIR(inode->i_mode) ||
+		    (file_is_hot(inode) && !is_cold_data(page)))
 			return CURSEG_HOT_DATA;
 		else
 			return CURSEG_COLD_DATA;
@@ -1066,10 +1371,16 @@ static int __get_segment_type_6(struct page *page, enum page_type p_type)
 			return CURSEG_HOT_DATA;
 		else if (is_cold_data(page) || file_is_cold(inode))
 			return CURSEG_COLD_DATA;
+		else if (file_is_hot(inode))
+			return CURSEG_HOT_DATA;
 		else
 			return CURSEG_WARM_DATA;
 	} else {
-		if (IS_DNODE(page))
+		/*
+		 * the xattr node of a file goes along with its dnodes, so that
+		 * it is found on the node chain written by fsync.
+		 */
+		if (IS_DNODE(page) || f2fs_has_xattr_block(ofs_of_node(page)))
 			return is_cold_node(page) ? CURSEG_WARM_NODE :
 						CURSEG_HOT_NODE;
 		else
@@ -1115,6 +1426,7 @@ void allocate_data_block(struct f2fs_sb_info *sbi, struct page *page,
 	__refresh_next_blkoff(sbi, curseg);
 
 	stat_inc_block_count(sbi, curseg);
+	stat_inc_log_block_count(sbi, type);
 
 	if (!__has_curseg_space(sbi, type))
 		sit_i->s_ops->allocate_segment(sbi, type, false);
@@ -2074,6 +2386,12 @@ int build_segment_manager(struct f2fs_sb_info *sbi)
 			return err;
 	}
 
+	if (blk_queue_discard(bdev_get_queue(sbi->sb->s_bdev))) {
+		err = create_discard_cmd_control(sbi);
+		if (err)
+			return err;
+	}
+
 	err = build_sit_info(sbi);
 	if (err)
 		return err;
@@ -2184,6 +2502,7 @@ void destroy_segment_manager(struct f2fs_sb_info *sbi)
 	if (!sm_info)
 		return;
 	destroy_flush_cmd_control(sbi);
+	destroy_discard_cmd_control(sbi);
 	destroy_dirty_segmap(sbi);
 	destroy_curseg(sbi);
 	destroy_free_segmap(sbi);
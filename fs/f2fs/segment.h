@@ -16,6 +16,14 @@
 
 #define DEF_RECLAIM_PREFREE_SEGMENTS	5	/* 5% over total segments */
 
+/*
+ * background discard: poll interval while the device is busy, and the
+ * age/amount of pending discards after which idle is not waited for
+ */
+#define DISCARD_IDLE_INTERVAL		100	/* ms */
+#define DISCARD_MAX_DELAY		10	/* seconds */
+#define DISCARD_MAX_PENDING		65536	/* blocks, 256MB */
+
 /* L: Logical segment # in volume, R: Relative segment # in main area */
 #define GET_L2R_SEGNO(free_i, segno)	(segno - free_i->start_segno)
 #define GET_R2L_SEGNO(free_i, segno)	(segno + free_i->start_segno)
@@ -138,6 +138,93 @@ static ssize_t f2fs_sbi_store(struct f2fs_attr *a,
 	if (ret < 0)
 		return ret;
 	*ui = t;
+
+	/* let the gc thread pick up a boost request right away */
+	if (!strcmp(a->attr.name, "gc_urgent") && t && sbi->gc_thread) {
+		sbi->gc_thread->gc_wake = 1;
+		wake_up_interruptible_all(&sbi->gc_thread->gc_wait_queue_head);
+	}
+	return count;
+}
+
+static ssize_t f2fs_ext_list_show(struct f2fs_attr *a,
+			struct f2fs_sb_info *sbi, char *buf)
+{
+	ssize_t len = 0;
+	int i;
+
+	down_read(&sbi->ext_rwsem);
+	for (i = 0; i < sbi->hot_ext_count; i++)
+		len += snprintf(buf + len, PAGE_SIZE - len, "[h]%.8s\n",
+				sbi->hot_ext[i]);
+	for (i = 0; i < sbi->cold_ext_count; i++)
+		len += snprintf(buf + len, PAGE_SIZE - len, "[c]%.8s\n",
+				sbi->cold_ext[i]);
+	up_read(&sbi->ext_rwsem);
+
+	return len;
+}
+
+static int __remove_ext(__u8 (*list)[8], int *count, const char *ext)
+{
+	int i;
+
+	for (i = 0; i < *count; i++) {
+		if (strncmp(list[i], ext, 8))
+			continue;
+		memmove(list[i], list[i + 1], (*count - i - 1) * 8);
+		(*count)--;
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * "[h]ext" adds a hot extension, "[c]ext" or "ext" a cold one on top of
+ * the list in the superblock, "!ext" removes one. Only files created
+ * afterwards are affected.
+ */
+static ssize_t f2fs_ext_list_store(struct f2fs_attr *a,
+			struct f2fs_sb_info *sbi,
+			const char *buf, size_t count)
+{
+	__u8 (*list)[8] = sbi->cold_ext;
+	int *nr = &sbi->cold_ext_count;
+	bool remove = false;
+	char ext[9];
+	size_t len;
+
+	buf = skip_spaces(buf);
+	if (*buf == '!') {
+		remove = true;
+		buf++;
+	} else if (!strncmp(buf, "[h]", 3)) {
+		list = sbi->hot_ext;
+		nr = &sbi->hot_ext_count;
+		buf += 3;
+	} else if (!strncmp(buf, "[c]", 3)) {
+		buf += 3;
+	}
+
+	len = strcspn(buf, " \n");
+	if (!len || len > 8)
+		return -EINVAL;
+	memset(ext, 0, sizeof(ext));
+	memcpy(ext, buf, len);
+
+	down_write(&sbi->ext_rwsem);
+	/* an extension is either hot or cold */
+	__remove_ext(sbi->hot_ext, &sbi->hot_ext_count, ext);
+	__remove_ext(sbi->cold_ext, &sbi->cold_ext_count, ext);
+	if (!remove) {
+		if (*nr >= F2FS_MAX_USER_EXTENSION) {
+			up_write(&sbi->ext_rwsem);
+			return -ENOSPC;
+		}
+		memcpy(list[(*nr)++], ext, 8);
+	}
+	up_write(&sbi->ext_rwsem);
+
 	return count;
 }
 
@@ -186,6 +273,10 @@ F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_min_sleep_time, min_sleep_time);
 F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_max_sleep_time, max_sleep_time);
 F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_no_gc_sleep_time, no_gc_sleep_time);
 F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_idle, gc_idle);
+F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_urgent, gc_urgent);
+F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_urgent_sleep_time,
+							urgent_sleep_time);
+F2FS_RW_ATTR(GC_THREAD, f2fs_gc_kthread, gc_slice_time, slice_time);
 F2FS_RW_ATTR(SM_INFO, f2fs_sm_info, reclaim_segments, rec_prefree_segments);
 F2FS_RW_ATTR(SM_INFO, f2fs_sm_info, max_small_discards, max_discards);
 F2FS_RW_ATTR(SM_INFO, f2fs_sm_info, ipu_policy, ipu_policy);
@@ -194,6 +285,10 @@ F2FS_RW_ATTR(SM_INFO, f2fs_sm_info, min_fsync_blocks, min_fsync_blocks);
 F2FS_RW_ATTR(NM_INFO, f2fs_nm_info, ram_thresh, ram_thresh);
 F2FS_RW_ATTR(F2FS_SBI, f2fs_sb_info, max_victim_search, max_victim_search);
 F2FS_RW_ATTR(F2FS_SBI, f2fs_sb_info, dir_level, dir_level);
+F2FS_RW_ATTR(F2FS_SBI, f2fs_sb_info, hot_rewrite_blocks, hot_rewrite_blocks);
+F2FS_RW_ATTR(F2FS_SBI, f2fs_sb_info, mmap_ra_max_kb, mmap_ra_max_kb);
+F2FS_ATTR_OFFSET(F2FS_SBI, extension_list, 0644,
+		f2fs_ext_list_show, f2fs_ext_list_store, 0);
 
 #define ATTR_LIST(name) (&f2fs_attr_##name.attr)
 static struct attribute *f2fs_attrs[] = {
@@ -201,6 +296,9 @@ static struct attribute *f2fs_attrs[] = {
 	ATTR_LIST(gc_max_sleep_time),
 	ATTR_LIST(gc_no_gc_sleep_time),
 	ATTR_LIST(gc_idle),
+	ATTR_LIST(gc_urgent),
+	ATTR_LIST(gc_urgent_sleep_time),
+	ATTR_LIST(gc_slice_time),
 	ATTR_LIST(reclaim_segments),
 	ATTR_LIST(max_small_discards),
 	ATTR_LIST(ipu_policy),
@@ -209,6 +307,9 @@ static struct attribute *f2fs_attrs[] = {
 	ATTR_LIST(max_victim_search),
 	ATTR_LIST(dir_level),
 	ATTR_LIST(ram_thresh),
+	ATTR_LIST(hot_rewrite_blocks),
+	ATTR_LIST(mmap_ra_max_kb),
+	ATTR_LIST(extension_list),
 	NULL,
 };
 
@@ -873,6 +974,10 @@ static void init_sb_info(struct f2fs_sb_info *sbi)
 
 	sbi->dir_level = DEF_DIR_LEVEL;
 	sbi->need_fsck = false;
+
+	init_rwsem(&sbi->ext_rwsem);
+	sbi->hot_rewrite_blocks = DEF_HOT_REWRITE_BLOCKS;
+	sbi->mmap_ra_max_kb = DEF_MMAP_RA_MAX_KB;
 }
 
 /*
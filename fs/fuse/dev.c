@@ -314,15 +314,31 @@ static u64 fuse_get_unique(struct fuse_conn *fc)
 
 static void queue_request(struct fuse_conn *fc, struct fuse_req *req)
 {
+	struct list_head *head = &fc->pending;
+	wait_queue_head_t *waitq = &fc->waitq;
+
 	req->in.h.len = sizeof(struct fuse_in_header) +
 		len_args(req->in.numargs, (struct fuse_arg *) req->in.args);
-	list_add_tail(&req->list, &fc->pending);
+	if (fc->nr_chan) {
+		struct fuse_chan *ch;
+
+		ch = &fc->chan[raw_smp_processor_id() % FUSE_MAX_CHANNELS];
+		/*
+		 * Only hand it to the channel of this cpu if its reader is
+		 * idle, otherwise any reader may take it from fc->pending.
+		 */
+		if (ch->file && waitqueue_active(&ch->waitq)) {
+			head = &ch->pending;
+			waitq = &ch->waitq;
+		}
+	}
+	list_add_tail(&req->list, head);
 	req->state = FUSE_REQ_PENDING;
 	if (!req->waiting) {
 		req->waiting = 1;
 		atomic_inc(&fc->num_waiting);
 	}
-	wake_up(&fc->waitq);
+	wake_up(waitq);
 	kill_fasync(&fc->fasync, SIGIO, POLL_IN);
 }
 
@@ -691,6 +707,26 @@ static void fuse_copy_init(struct fuse_copy_state *cs, struct fuse_conn *fc,
 	cs->nr_segs = nr_segs;
 }
 
+/* Like fuse_copy_init(), but start 'skip' bytes into the buffer */
+static void fuse_copy_init_at(struct fuse_copy_state *cs,
+			      struct fuse_conn *fc, int write,
+			      const struct iovec *iov, unsigned long nr_segs,
+			      size_t skip)
+{
+	while (nr_segs && skip >= iov->iov_len) {
+		skip -= iov->iov_len;
+		iov++;
+		nr_segs--;
+	}
+	fuse_copy_init(cs, fc, write, iov, nr_segs);
+	if (nr_segs && skip) {
+		cs->seglen = iov->iov_len - skip;
+		cs->addr = (unsigned long) iov->iov_base + skip;
+		cs->iov++;
+		cs->nr_segs--;
+	}
+}
+
 /* Unmap and put previous page of userspace buffer */
 static void fuse_copy_finish(struct fuse_copy_state *cs)
 {
@@ -1035,21 +1071,55 @@ static int forget_pending(struct fuse_conn *fc)
 	return fc->forget_list_head.next != NULL;
 }
 
-static int request_pending(struct fuse_conn *fc)
+static int request_pending(struct fuse_conn *fc, struct fuse_chan *ch)
 {
 	return !list_empty(&fc->pending) || !list_empty(&fc->interrupts) ||
-		forget_pending(fc);
+		forget_pending(fc) || (ch && !list_empty(&ch->pending));
 }
 
-/* Wait until a request is available on the pending list */
-static void request_wait(struct fuse_conn *fc)
+/* Channel read by a cloned device file, called with fc->lock held */
+static struct fuse_chan *fuse_dev_chan(struct fuse_conn *fc,
+				       struct file *file)
+{
+	int i;
+
+	if (!fc->nr_chan)
+		return NULL;
+
+	for (i = 0; i < FUSE_MAX_CHANNELS; i++)
+		if (fc->chan[i].file == file)
+			return &fc->chan[i];
+
+	return NULL;
+}
+
+/*
+ * Give the requests queued on a channel back to all readers, when the
+ * reader of the channel went away without taking them
+ */
+static void fuse_chan_flush(struct fuse_conn *fc, struct fuse_chan *ch)
+{
+	if (!list_empty(&ch->pending)) {
+		list_splice_tail_init(&ch->pending, &fc->pending);
+		wake_up(&fc->waitq);
+	}
+}
+
+/*
+ * Wait until a request is available on the pending list.  The reader
+ * of a channel waits for both its own and the shared queue.
+ */
+static void request_wait(struct fuse_conn *fc, struct fuse_chan *ch)
 __releases(fc->lock)
 __acquires(fc->lock)
 {
 	DECLARE_WAITQUEUE(wait, current);
+	DECLARE_WAITQUEUE(chan_wait, current);
 
 	add_wait_queue_exclusive(&fc->waitq, &wait);
-	while (fc->connected && !request_pending(fc)) {
+	if (ch)
+		add_wait_queue_exclusive(&ch->waitq, &chan_wait);
+	while (fc->connected && !request_pending(fc, ch)) {
 		set_current_state(TASK_INTERRUPTIBLE);
 		if (signal_pending(current))
 			break;
@@ -1059,6 +1129,8 @@ __acquires(fc->lock)
 		spin_lock(&fc->lock);
 	}
 	set_current_state(TASK_RUNNING);
+	if (ch)
+		remove_wait_queue(&ch->waitq, &chan_wait);
 	remove_wait_queue(&fc->waitq, &wait);
 }
 
@@ -1222,45 +1294,66 @@ __releases(fc->lock)
  * was an error during the copying then it's finished by calling
  * request_end().  Otherwise add it to the processing list, and set
  * the 'sent' flag.
+ *
+ * With 'more' set this is a further request of a batched read: it
+ * doesn't block, and returns -EAGAIN if the next request doesn't fit
+ * in the rest of the buffer, leaving it queued for the next read.
  */
 static ssize_t fuse_dev_do_read(struct fuse_conn *fc, struct file *file,
-				struct fuse_copy_state *cs, size_t nbytes)
+				struct fuse_copy_state *cs, size_t nbytes,
+				bool more)
 {
 	int err;
 	struct fuse_req *req;
 	struct fuse_in *in;
+	struct fuse_chan *ch;
+	struct list_head *head;
 	unsigned reqsize;
 
  restart:
 	spin_lock(&fc->lock);
+	ch = fuse_dev_chan(fc, file);
 	err = -EAGAIN;
-	if ((file->f_flags & O_NONBLOCK) && fc->connected &&
-	    !request_pending(fc))
+	if ((more || (file->f_flags & O_NONBLOCK)) && fc->connected &&
+	    !request_pending(fc, ch))
 		goto err_unlock;
 
-	request_wait(fc);
+	request_wait(fc, ch);
 	err = -ENODEV;
 	if (!fc->connected)
 		goto err_unlock;
 	err = -ERESTARTSYS;
-	if (!request_pending(fc))
+	if (!request_pending(fc, ch))
 		goto err_unlock;
 
-	if (!list_empty(&fc->interrupts)) {
+	head = (ch && !list_empty(&ch->pending)) ? &ch->pending :
+		&fc->pending;
+
+	if (more) {
+		/* only batch up regular requests that fit */
+		err = -EAGAIN;
+		if (list_empty(head))
+			goto err_unlock;
+		req = list_entry(head->next, struct fuse_req, list);
+		if (req->in.h.len > nbytes)
+			goto err_unlock;
+	}
+
+	if (!more && !list_empty(&fc->interrupts)) {
 		req = list_entry(fc->interrupts.next, struct fuse_req,
 				 intr_entry);
 		return fuse_read_interrupt(fc, cs, nbytes, req);
 	}
 
-	if (forget_pending(fc)) {
-		if (list_empty(&fc->pending) || fc->forget_batch-- > 0)
+	if (!more && forget_pending(fc)) {
+		if (list_empty(head) || fc->forget_batch-- > 0)
 			return fuse_read_forget(fc, cs, nbytes);
 
 		if (fc->forget_batch <= -8)
 			fc->forget_batch = 16;
 	}
 
-	req = list_entry(fc->pending.next, struct fuse_req, list);
+	req = list_entry(head->next, struct fuse_req, list);
 	req->state = FUSE_REQ_READING;
 	list_move(&req->list, &fc->io);
 
@@ -1305,6 +1398,8 @@ static ssize_t fuse_dev_do_read(struct fuse_conn *fc, struct file *file,
 	return reqsize;
 
  err_unlock:
+	if (err == -ERESTARTSYS && ch)
+		fuse_chan_flush(fc, ch);
 	spin_unlock(&fc->lock);
 	return err;
 }
@@ -1315,12 +1410,28 @@ static ssize_t fuse_dev_read(struct kiocb *iocb, const struct iovec *iov,
 	struct fuse_copy_state cs;
 	struct file *file = iocb->ki_filp;
 	struct fuse_conn *fc = fuse_get_conn(file);
+	size_t nbytes = iov_length(iov, nr_segs);
+	ssize_t ret, total;
+
 	if (!fc)
 		return -EPERM;
 
 	fuse_copy_init(&cs, fc, 1, iov, nr_segs);
 
-	return fuse_dev_do_read(fc, file, &cs, iov_length(iov, nr_segs));
+	total = fuse_dev_do_read(fc, file, &cs, nbytes, false);
+	if (total <= 0 || !fc->batch)
+		return total;
+
+	/* Pack the requests already queued behind the first one */
+	while (nbytes - total >= sizeof(struct fuse_in_header)) {
+		fuse_copy_init_at(&cs, fc, 1, iov, nr_segs, total);
+		ret = fuse_dev_do_read(fc, file, &cs, nbytes - total, true);
+		if (ret <= 0)
+			break;
+		total += ret;
+	}
+
+	return total;
 }
 
 static ssize_t fuse_dev_splice_read(struct file *in, loff_t *ppos,
@@ -1343,7 +1454,7 @@ static ssize_t fuse_dev_splice_read(struct file *in, loff_t *ppos,
 	fuse_copy_init(&cs, fc, 1, NULL, 0);
 	cs.pipebufs = bufs;
 	cs.pipe = pipe;
-	ret = fuse_dev_do_read(fc, in, &cs, len);
+	ret = fuse_dev_do_read(fc, in, &cs, len, false);
 	if (ret < 0)
 		goto out;
 
@@ -1823,8 +1934,14 @@ static int copy_out_args(struct fuse_copy_state *cs, struct fuse_out *out,
  * it from the list and copy the rest of the buffer to the request.
  * The request is finished by calling request_end()
  */
+/*
+ * Write a single reply or notification.  If 'msglen' is given the
+ * buffer may hold further replies: the length of this one is stored
+ * there once its header checked out.
+ */
 static ssize_t fuse_dev_do_write(struct fuse_conn *fc,
-				 struct fuse_copy_state *cs, size_t nbytes)
+				 struct fuse_copy_state *cs, size_t nbytes,
+				 unsigned *msglen)
 {
 	int err;
 	struct fuse_req *req;
@@ -1838,7 +1955,11 @@ static ssize_t fuse_dev_do_write(struct fuse_conn *fc,
 		goto err_finish;
 
 	err = -EINVAL;
-	if (oh.len != nbytes)
+	if (msglen) {
+		if (oh.len < sizeof(oh) || oh.len > nbytes)
+			goto err_finish;
+		nbytes = *msglen = oh.len;
+	} else if (oh.len != nbytes)
 		goto err_finish;
 
 	/*
@@ -1922,12 +2043,33 @@ static ssize_t fuse_dev_write(struct kiocb *iocb, const struct iovec *iov,
 {
 	struct fuse_copy_state cs;
 	struct fuse_conn *fc = fuse_get_conn(iocb->ki_filp);
+	size_t nbytes = iov_length(iov, nr_segs);
+	ssize_t ret, total;
+	unsigned len;
+
 	if (!fc)
 		return -EPERM;
 
 	fuse_copy_init(&cs, fc, 0, iov, nr_segs);
 
-	return fuse_dev_do_write(fc, &cs, iov_length(iov, nr_segs));
+	if (!fc->batch)
+		return fuse_dev_do_write(fc, &cs, nbytes, NULL);
+
+	/*
+	 * Replies are packed back to back.  A reply for a request that
+	 * went away is skipped like it would be on its own; a malformed
+	 * header ends the batch.
+	 */
+	for (total = 0; total < nbytes; total += len) {
+		if (total)
+			fuse_copy_init_at(&cs, fc, 0, iov, nr_segs, total);
+		len = 0;
+		ret = fuse_dev_do_write(fc, &cs, nbytes - total, &len);
+		if (ret < 0 && !len)
+			return total ? total : ret;
+	}
+
+	return total;
 }
 
 static ssize_t fuse_dev_splice_write(struct pipe_inode_info *pipe,
@@ -1997,7 +2139,7 @@ static ssize_t fuse_dev_splice_write(struct pipe_inode_info *pipe,
 	if (flags & SPLICE_F_MOVE)
 		cs.move_pages = 1;
 
-	ret = fuse_dev_do_write(fc, &cs, len);
+	ret = fuse_dev_do_write(fc, &cs, len, NULL);
 
 	for (idx = 0; idx < nbuf; idx++) {
 		struct pipe_buffer *buf = &bufs[idx];
@@ -2012,15 +2154,22 @@ static unsigned fuse_dev_poll(struct file *file, poll_table *wait)
 {
 	unsigned mask = POLLOUT | POLLWRNORM;
 	struct fuse_conn *fc = fuse_get_conn(file);
+	struct fuse_chan *ch;
 	if (!fc)
 		return POLLERR;
 
 	poll_wait(file, &fc->waitq, wait);
 
+	spin_lock(&fc->lock);
+	ch = fuse_dev_chan(fc, file);
+	spin_unlock(&fc->lock);
+	if (ch)
+		poll_wait(file, &ch->waitq, wait);
+
 	spin_lock(&fc->lock);
 	if (!fc->connected)
 		mask = POLLERR;
-	else if (request_pending(fc))
+	else if (request_pending(fc, ch))
 		mask |= POLLIN | POLLRDNORM;
 	spin_unlock(&fc->lock);
 
@@ -2086,8 +2235,13 @@ static void end_queued_requests(struct fuse_conn *fc)
 __releases(fc->lock)
 __acquires(fc->lock)
 {
+	int i;
+
 	fc->max_background = UINT_MAX;
 	flush_bg_queue(fc);
+	for (i = 0; i < FUSE_MAX_CHANNELS; i++)
+		if (fc->chan[i].file)
+			end_requests(fc, &fc->chan[i].pending);
 	end_requests(fc, &fc->pending);
 	end_requests(fc, &fc->processing);
 	while (forget_pending(fc))
@@ -2151,6 +2305,20 @@ int fuse_dev_release(struct inode *inode, struct file *file)
 	struct fuse_conn *fc = fuse_get_conn(file);
 	if (fc) {
 		spin_lock(&fc->lock);
+		if (fc->dev_clones) {
+			struct fuse_chan *ch = fuse_dev_chan(fc, file);
+
+			/* the connection lives on while other fds are open */
+			if (ch) {
+				fuse_chan_flush(fc, ch);
+				ch->file = NULL;
+				fc->nr_chan--;
+			}
+			fc->dev_clones--;
+			spin_unlock(&fc->lock);
+			fuse_conn_put(fc);
+			return 0;
+		}
 		fc->connected = 0;
 		fc->blocked = 0;
 		fc->initialized = 1;
@@ -2165,6 +2333,83 @@ int fuse_dev_release(struct inode *inode, struct file *file)
 }
 EXPORT_SYMBOL_GPL(fuse_dev_release);
 
+static int fuse_dev_clone(struct fuse_conn *fc, struct file *new)
+{
+	int i;
+	int err = -ENODEV;
+
+	spin_lock(&fc->lock);
+	if (!fc->connected)
+		goto out;
+
+	err = -EINVAL;
+	if (new->private_data)
+		goto out;
+
+	/* if all channels are taken the clone only reads the shared queue */
+	for (i = 0; i < FUSE_MAX_CHANNELS; i++) {
+		struct fuse_chan *ch = &fc->chan[i];
+
+		if (!ch->file) {
+			ch->file = new;
+			INIT_LIST_HEAD(&ch->pending);
+			init_waitqueue_head(&ch->waitq);
+			fc->nr_chan++;
+			break;
+		}
+	}
+	fc->dev_clones++;
+	new->private_data = fuse_conn_get(fc);
+	err = 0;
+ out:
+	spin_unlock(&fc->lock);
+	return err;
+}
+
+static long fuse_dev_ioctl(struct file *file, unsigned int cmd,
+			   unsigned long arg)
+{
+	struct fuse_conn *fc;
+	struct file *old;
+	u32 val;
+	int err;
+
+	switch (cmd) {
+	case FUSE_DEV_IOC_CLONE:
+		if (get_user(val, (u32 __user *) arg))
+			return -EFAULT;
+
+		old = fget(val);
+		if (!old)
+			return -EINVAL;
+
+		/* only another /dev/fuse fd of a mounted connection */
+		err = -EINVAL;
+		fc = NULL;
+		if (old->f_op == file->f_op)
+			fc = fuse_get_conn(old);
+		if (fc)
+			err = fuse_dev_clone(fc, file);
+		fput(old);
+		return err;
+
+	case FUSE_DEV_IOC_BATCH:
+		fc = fuse_get_conn(file);
+		if (!fc)
+			return -EPERM;
+
+		if (get_user(val, (u32 __user *) arg))
+			return -EFAULT;
+
+		spin_lock(&fc->lock);
+		fc->batch = !!val;
+		spin_unlock(&fc->lock);
+		return 0;
+	}
+
+	return -ENOTTY;
+}
+
 static int fuse_dev_fasync(int fd, struct file *file, int on)
 {
 	struct fuse_conn *fc = fuse_get_conn(file);
@@ -2187,6 +2432,8 @@ const struct file_operations fuse_dev_operations = {
 	.poll		= fuse_dev_poll,
 	.release	= fuse_dev_release,
 	.fasync		= fuse_dev_fasync,
+	.unlocked_ioctl	= fuse_dev_ioctl,
+	.compat_ioctl	= fuse_dev_ioctl,
 };
 EXPORT_SYMBOL_GPL(fuse_dev_operations);
 
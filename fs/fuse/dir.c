@@ -7,6 +7,7 @@
 */
 
 #include "fuse_i.h"
+#include "fuse_passthrough.h"
 
 #include <linux/pagemap.h>
 #include <linux/file.h>
@@ -1840,6 +1841,9 @@ static int fuse_getattr(struct vfsmount *mnt, struct dentry *entry,
 	if (!fuse_allow_current_process(fc))
 		return -EACCES;
 
+	if (!fuse_passthrough_getattr(inode, stat))
+		return 0;
+
 	return fuse_update_attributes(inode, stat, NULL, NULL);
 }
 
@@ -561,6 +561,7 @@ void fuse_finish_open(struct inode *inode, struct file *file)
 	}
 	if ((file->f_mode & FMODE_WRITE) && fc->writeback_cache)
 		fuse_link_write_file(file);
+	fuse_passthrough_attach(inode, ff);
 }
 
 int fuse_open_common(struct inode *inode, struct file *file, bool isdir)
@@ -621,7 +622,7 @@ void fuse_release_common(struct file *file, int opcode)
 	if (unlikely(!ff))
 		return;
 
-	fuse_passthrough_release(ff);
+	fuse_passthrough_release(file_inode(file), ff);
 
 	req = ff->reserved_req;
 	fuse_prepare_release(ff, file->f_flags, opcode);
@@ -873,6 +874,11 @@ out:
 static int fuse_fsync(struct file *file, loff_t start, loff_t end,
 		      int datasync)
 {
+	struct fuse_file *ff = file->private_data;
+
+	if (ff && ff->passthrough_enabled && ff->passthrough_filp)
+		return fuse_passthrough_fsync(file, start, end, datasync);
+
 	return fuse_fsync_common(file, start, end, datasync, 0);
 }
 
@@ -1296,6 +1302,31 @@ static ssize_t fuse_file_read_iter(struct kiocb *iocb, struct iov_iter *to)
 	return ret_val;
 }
 
+static ssize_t fuse_file_splice_read(struct file *in, loff_t *ppos,
+				     struct pipe_inode_info *pipe,
+				     size_t len, unsigned int flags)
+{
+	struct fuse_file *ff = in->private_data;
+
+	if (ff && ff->passthrough_enabled && ff->passthrough_filp)
+		return fuse_passthrough_splice_read(in, ppos, pipe, len, flags);
+
+	return generic_file_splice_read(in, ppos, pipe, len, flags);
+}
+
+static ssize_t fuse_file_splice_write(struct pipe_inode_info *pipe,
+				      struct file *out, loff_t *ppos,
+				      size_t len, unsigned int flags)
+{
+	struct fuse_file *ff = out->private_data;
+
+	if (ff && ff->passthrough_enabled && ff->passthrough_filp)
+		return fuse_passthrough_splice_write(pipe, out, ppos, len,
+						     flags);
+
+	return iter_file_splice_write(pipe, out, ppos, len, flags);
+}
+
 static void fuse_write_fill(struct fuse_req *req, struct fuse_file *ff,
 			    loff_t pos, size_t count)
 {
@@ -2461,6 +2492,10 @@ static const struct vm_operations_struct fuse_file_vm_ops = {
 static int fuse_file_mmap(struct file *file, struct vm_area_struct *vma)
 {
 	struct fuse_file *ff = file->private_data;
+
+	if (ff->passthrough_enabled && ff->passthrough_filp)
+		return fuse_passthrough_mmap(file, vma);
+
 	ff->passthrough_enabled = 0;
 	if ((vma->vm_flags & VM_SHARED) && (vma->vm_flags & VM_MAYWRITE))
 		fuse_link_write_file(file);
@@ -3395,7 +3430,8 @@ static const struct file_operations fuse_file_operations = {
 	.fsync		= fuse_fsync,
 	.lock		= fuse_file_lock,
 	.flock		= fuse_file_flock,
-	.splice_read	= generic_file_splice_read,
+	.splice_read	= fuse_file_splice_read,
+	.splice_write	= fuse_file_splice_write,
 	.unlocked_ioctl	= fuse_file_ioctl,
 	.compat_ioctl	= fuse_file_compat_ioctl,
 	.poll		= fuse_file_poll,
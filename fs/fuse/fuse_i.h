@@ -109,6 +109,13 @@ struct fuse_inode {
 
 	/** Miscellaneous bits describing inode state */
 	unsigned long state;
+
+	/** Lower file of one of the open passthrough files, used to
+	 * answer getattr without the daemon.  Protected by fc->lock */
+	struct file *passthrough_filp;
+
+	/** Number of open passthrough files.  Protected by fc->lock */
+	unsigned passthrough_count;
 };
 
 /** FUSE inode state bits */
@@ -161,6 +168,9 @@ struct fuse_file {
 	/* the read write file */
 	struct file *passthrough_filp;
 	bool passthrough_enabled;
+
+	/* counted in fuse_inode->passthrough_count */
+	bool passthrough_attached;
 };
 
 /** One input argument of a request */
@@ -373,6 +383,26 @@ struct fuse_req {
 	struct file *passthrough_filp;
 };
 
+/** Maximum number of per-cpu device channels */
+#define FUSE_MAX_CHANNELS 8
+
+/**
+ * A request channel of a cloned /dev/fuse file.  Requests submitted
+ * on a cpu while the reader of that cpu's channel is idle are queued
+ * here, so the daemon thread serving that cpu picks them up without
+ * waking the other readers.
+ */
+struct fuse_chan {
+	/** The device file reading this channel, NULL if unused */
+	struct file *file;
+
+	/** Requests queued to this channel */
+	struct list_head pending;
+
+	/** The reader of the channel is waiting on this */
+	wait_queue_head_t waitq;
+};
+
 /**
  * A Fuse connection.
  *
@@ -410,6 +440,18 @@ struct fuse_conn {
 	/** The list of pending requests */
 	struct list_head pending;
 
+	/** Channels of the cloned device files, indexed by submitting cpu */
+	struct fuse_chan chan[FUSE_MAX_CHANNELS];
+
+	/** Number of channels in use */
+	unsigned nr_chan;
+
+	/** Device files attached with FUSE_DEV_IOC_CLONE */
+	unsigned dev_clones;
+
+	/** Several requests per read() and replies per write() */
+	unsigned batch:1;
+
 	/** The list of requests being processed */
 	struct list_head processing;
 
@@ -117,11 +117,176 @@ ssize_t fuse_passthrough_write_iter(struct kiocb *iocb, struct iov_iter *from)
 	return fuse_passthrough_read_write_iter(iocb, from, 1);
 }
 
-void fuse_passthrough_release(struct fuse_file *ff)
+ssize_t fuse_passthrough_splice_read(struct file *in, loff_t *ppos,
+				     struct pipe_inode_info *pipe,
+				     size_t len, unsigned int flags)
 {
+	struct fuse_file *ff = in->private_data;
+	struct file *passthrough_filp = ff->passthrough_filp;
+	ssize_t ret_val;
+
+	if (!passthrough_filp->f_op->splice_read)
+		return -EINVAL;
+
+	/* lock passthrough file to prevent it from being released */
+	get_file(passthrough_filp);
+	ret_val = passthrough_filp->f_op->splice_read(passthrough_filp, ppos,
+						      pipe, len, flags);
+	if (ret_val >= 0)
+		fsstack_copy_attr_atime(file_inode(in),
+					file_inode(passthrough_filp));
+	fput(passthrough_filp);
+
+	return ret_val;
+}
+
+ssize_t fuse_passthrough_splice_write(struct pipe_inode_info *pipe,
+				      struct file *out, loff_t *ppos,
+				      size_t len, unsigned int flags)
+{
+	struct fuse_file *ff = out->private_data;
+	struct file *passthrough_filp = ff->passthrough_filp;
+	struct inode *fuse_inode = file_inode(out);
+	struct inode *passthrough_inode = file_inode(passthrough_filp);
+	ssize_t ret_val;
+
+	if (!passthrough_filp->f_op->splice_write)
+		return -EINVAL;
+
+	get_file(passthrough_filp);
+	ret_val = passthrough_filp->f_op->splice_write(pipe, passthrough_filp,
+						       ppos, len, flags);
+	if (ret_val >= 0) {
+		fsstack_copy_inode_size(fuse_inode, passthrough_inode);
+		fsstack_copy_attr_times(fuse_inode, passthrough_inode);
+	}
+	fput(passthrough_filp);
+
+	return ret_val;
+}
+
+/*
+ * Map the lower file instead: page faults are then served by the lower
+ * filesystem from its own page cache, which is also the one passthrough
+ * read/write use, so the mapping stays coherent with them.
+ */
+int fuse_passthrough_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct fuse_file *ff = file->private_data;
+	struct file *passthrough_filp = ff->passthrough_filp;
+	int ret_val;
+
+	if (!passthrough_filp->f_op->mmap)
+		return -ENODEV;
+
+	if (WARN_ON(file != vma->vm_file))
+		return -EIO;
+
+	vma->vm_file = get_file(passthrough_filp);
+	ret_val = passthrough_filp->f_op->mmap(passthrough_filp, vma);
+	if (ret_val) {
+		/* the caller puts the file it passed in on error */
+		vma->vm_file = file;
+		fput(passthrough_filp);
+		return ret_val;
+	}
+
+	/* the vma holds the lower file from now on */
+	fput(file);
+	fsstack_copy_attr_atime(file_inode(file),
+				file_inode(passthrough_filp));
+
+	return 0;
+}
+
+int fuse_passthrough_fsync(struct file *file, loff_t start, loff_t end,
+			   int datasync)
+{
+	struct fuse_file *ff = file->private_data;
+	struct file *passthrough_filp = ff->passthrough_filp;
+	int ret_val;
+
+	get_file(passthrough_filp);
+	ret_val = vfs_fsync_range(passthrough_filp, start, end, datasync);
+	fput(passthrough_filp);
+
+	return ret_val;
+}
+
+void fuse_passthrough_attach(struct inode *inode, struct fuse_file *ff)
+{
+	struct fuse_conn *fc = get_fuse_conn(inode);
+	struct fuse_inode *fi = get_fuse_inode(inode);
+
+	if (!ff->passthrough_filp)
+		return;
+
+	spin_lock(&fc->lock);
+	if (!fi->passthrough_filp)
+		fi->passthrough_filp = get_file(ff->passthrough_filp);
+	fi->passthrough_count++;
+	ff->passthrough_attached = 1;
+	spin_unlock(&fc->lock);
+}
+
+/*
+ * While a passthrough file is open the lower inode is the authority for
+ * size, blocks and times: take them from there instead of sending
+ * GETATTR. Ownership and mode are the ones the daemon last reported.
+ * The lower inode is read directly, as the read/write paths do, since
+ * the caller has no permission on the daemon's files itself.
+ */
+int fuse_passthrough_getattr(struct inode *inode, struct kstat *stat)
+{
+	struct fuse_conn *fc = get_fuse_conn(inode);
+	struct fuse_inode *fi = get_fuse_inode(inode);
+	struct file *passthrough_filp;
+	struct inode *passthrough_inode;
+
+	spin_lock(&fc->lock);
+	passthrough_filp = fi->passthrough_filp;
+	if (passthrough_filp)
+		get_file(passthrough_filp);
+	spin_unlock(&fc->lock);
+
+	if (!passthrough_filp)
+		return -ENOENT;
+
+	passthrough_inode = file_inode(passthrough_filp);
+	fsstack_copy_inode_size(inode, passthrough_inode);
+	fsstack_copy_attr_times(inode, passthrough_inode);
+	if (stat) {
+		generic_fillattr(inode, stat);
+		stat->mode = fi->orig_i_mode;
+		stat->ino = fi->orig_ino;
+		stat->blocks = passthrough_inode->i_blocks;
+	}
+	fput(passthrough_filp);
+
+	return 0;
+}
+
+void fuse_passthrough_release(struct inode *inode, struct fuse_file *ff)
+{
+	struct fuse_conn *fc = get_fuse_conn(inode);
+	struct fuse_inode *fi = get_fuse_inode(inode);
+	struct file *inode_filp = NULL;
+
 	if (!(ff->passthrough_filp))
 		return;
 
+	if (ff->passthrough_attached) {
+		spin_lock(&fc->lock);
+		if (!--fi->passthrough_count) {
+			inode_filp = fi->passthrough_filp;
+			fi->passthrough_filp = NULL;
+		}
+		spin_unlock(&fc->lock);
+		ff->passthrough_attached = 0;
+		if (inode_filp)
+			fput(inode_filp);
+	}
+
 	/* Release the passthrough file. */
 	fput(ff->passthrough_filp);
 	ff->passthrough_filp = NULL;
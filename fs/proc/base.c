@@ -898,6 +898,7 @@ static ssize_t oom_adj_write(struct file *file, const char __user *buf,
 
 	task->signal->oom_score_adj = oom_adj;
 	trace_oom_score_adj_update(task);
+	lowmem_adj_track(task);
 err_sighand:
 	unlock_task_sighand(task, &flags);
 err_task_lock:
@@ -986,6 +987,7 @@ static ssize_t oom_score_adj_write(struct file *file, const char __user *buf,
 	if (has_capability_noaudit(current, CAP_SYS_RESOURCE))
 		task->signal->oom_score_adj_min = (short)oom_score_adj;
 	trace_oom_score_adj_update(task);
+	lowmem_adj_track(task);
 
 err_sighand:
 	unlock_task_sighand(task, &flags);
@@ -497,7 +497,51 @@ out:
 	return 0;
 }
 
+#ifdef CONFIG_SQUASHFS_FILE_DIRECT
+/*
+ * Readahead straight into the page cache, one datablock at a time, with
+ * all blocks but the last decompressed in parallel. Tail-end fragments,
+ * sparse blocks and blocks that cannot be set up go through readpage.
+ */
+static int squashfs_readpages(struct file *file, struct address_space *mapping,
+	struct list_head *pages, unsigned nr_pages)
+{
+	struct inode *inode = mapping->host;
+	struct squashfs_sb_info *msblk = inode->i_sb->s_fs_info;
+	int shift = msblk->block_log - PAGE_CACHE_SHIFT;
+	int file_end = i_size_read(inode) >> msblk->block_log;
+	struct page *page, *last;
+	int index, bsize;
+	u64 block;
+
+	while (!list_empty(pages)) {
+		page = list_entry(pages->prev, struct page, lru);
+		last = list_entry(pages->next, struct page, lru);
+		index = page->index >> shift;
+
+		if (index < file_end || squashfs_i(inode)->fragment_block ==
+						SQUASHFS_INVALID_BLK) {
+			block = 0;
+			bsize = read_blocklist(inode, index, &block);
+			if (bsize > 0 && !squashfs_readahead_block(inode, block,
+					bsize, pages, last->index >> shift != index))
+				continue;
+		}
+
+		list_del(&page->lru);
+		if (!add_to_page_cache_lru(page, mapping, page->index,
+								GFP_KERNEL))
+			squashfs_readpage(file, page);
+		page_cache_release(page);
+	}
+
+	return 0;
+}
+#endif
 
 const struct address_space_operations squashfs_aops = {
-	.readpage = squashfs_readpage
+	.readpage = squashfs_readpage,
+#ifdef CONFIG_SQUASHFS_FILE_DIRECT
+	.readpages = squashfs_readpages,
+#endif
 };
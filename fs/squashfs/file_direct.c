@@ -13,6 +13,7 @@
 #include <linux/string.h>
 #include <linux/pagemap.h>
 #include <linux/mutex.h>
+#include <linux/workqueue.h>
 
 #include "squashfs_fs.h"
 #include "squashfs_fs_sb.h"
@@ -20,8 +21,10 @@
 #include "squashfs.h"
 #include "page_actor.h"
 
-static int squashfs_read_cache(struct page *target_page, u64 block, int bsize,
-	int pages, struct page **page);
+static int squashfs_read_cache(struct inode *i, struct page *target_page,
+	u64 block, int bsize, int pages, struct page **page);
+static int squashfs_read_pages(struct inode *inode, struct page *target_page,
+	u64 block, int bsize, int pages, struct page **page);
 
 /* Read separately compressed datablock directly into page cache */
 int squashfs_readpage_block(struct page *target_page, u64 block, int bsize)
@@ -34,10 +37,8 @@ int squashfs_readpage_block(struct page *target_page, u64 block, int bsize)
 	int mask = (1 << (msblk->block_log - PAGE_CACHE_SHIFT)) - 1;
 	int start_index = target_page->index & ~mask;
 	int end_index = start_index | mask;
-	int i, n, pages, missing_pages, bytes, res = -ENOMEM;
+	int i, n, pages, res;
 	struct page **page;
-	struct squashfs_page_actor *actor;
-	void *pageaddr;
 
 	if (end_index > file_end)
 		end_index = file_end;
@@ -46,34 +47,166 @@ int squashfs_readpage_block(struct page *target_page, u64 block, int bsize)
 
 	page = kmalloc_array(pages, sizeof(void *), GFP_KERNEL);
 	if (page == NULL)
-		return res;
-
-	/*
-	 * Create a "page actor" which will kmap and kunmap the
-	 * page cache pages appropriately within the decompressor
-	 */
-	actor = squashfs_page_actor_init_special(page, pages, 0);
-	if (actor == NULL)
-		goto out;
+		return -ENOMEM;
 
 	/* Try to grab all the pages covered by the Squashfs block */
-	for (missing_pages = 0, i = 0, n = start_index; i < pages; i++, n++) {
+	for (i = 0, n = start_index; i < pages; i++, n++) {
 		page[i] = (n == target_page->index) ? target_page :
 			grab_cache_page_nowait(target_page->mapping, n);
 
-		if (page[i] == NULL) {
-			missing_pages++;
-			continue;
-		}
-
-		if (PageUptodate(page[i])) {
+		if (page[i] && PageUptodate(page[i])) {
 			unlock_page(page[i]);
 			page_cache_release(page[i]);
 			page[i] = NULL;
-			missing_pages++;
 		}
 	}
 
+	res = squashfs_read_pages(inode, target_page, block, bsize, pages,
+								page);
+	kfree(page);
+	return res;
+}
+
+/*
+ * Readahead of several datablocks: every block of the window but the
+ * last is decompressed by a worker, so that the reads and the percpu
+ * decompressor streams of the blocks run in parallel while the caller
+ * reads the last one itself.
+ */
+struct squashfs_ra_block {
+	struct work_struct work;
+	struct inode *inode;
+	u64 block;
+	int bsize;
+	int pages;
+	struct page *page[0];
+};
+
+static struct workqueue_struct *squashfs_read_wq;
+
+static void squashfs_ra_block_read(struct squashfs_ra_block *ra)
+{
+	squashfs_read_pages(ra->inode, NULL, ra->block, ra->bsize, ra->pages,
+								ra->page);
+	kfree(ra);
+}
+
+static void squashfs_ra_block_work(struct work_struct *work)
+{
+	squashfs_ra_block_read(container_of(work, struct squashfs_ra_block,
+								work));
+}
+
+/*
+ * Read the datablock covering the page at the tail of the readahead list
+ * @pages. The readahead pages of the block are moved into the page cache
+ * and the rest of it is grabbed, as squashfs_readpage_block() does. With
+ * @async the block is handed to squashfs_read_wq. Returns -ENOMEM, with
+ * @pages untouched, when the block could not be set up.
+ */
+int squashfs_readahead_block(struct inode *inode, u64 block, int bsize,
+	struct list_head *pages, bool async)
+{
+	struct squashfs_sb_info *msblk = inode->i_sb->s_fs_info;
+	struct address_space *mapping = inode->i_mapping;
+	struct page *page = list_entry(pages->prev, struct page, lru);
+	int file_end = (i_size_read(inode) - 1) >> PAGE_CACHE_SHIFT;
+	int mask = (1 << (msblk->block_log - PAGE_CACHE_SHIFT)) - 1;
+	int start_index = page->index & ~mask;
+	int end_index = start_index | mask;
+	struct squashfs_ra_block *ra;
+	int i, n;
+
+	if (end_index > file_end)
+		end_index = file_end;
+
+	ra = kzalloc(sizeof(*ra) + (end_index - start_index + 1) *
+					sizeof(struct page *), GFP_KERNEL);
+	if (ra == NULL)
+		return -ENOMEM;
+
+	ra->inode = inode;
+	ra->block = block;
+	ra->bsize = bsize;
+	ra->pages = end_index - start_index + 1;
+
+	while (!list_empty(pages)) {
+		page = list_entry(pages->prev, struct page, lru);
+		if (page->index > end_index)
+			break;
+
+		list_del(&page->lru);
+		if (add_to_page_cache_lru(page, mapping, page->index,
+								GFP_KERNEL)) {
+			page_cache_release(page);
+			continue;
+		}
+		ra->page[page->index - start_index] = page;
+	}
+
+	for (n = 0, i = 0; i < ra->pages; i++) {
+		if (ra->page[i] == NULL) {
+			ra->page[i] = grab_cache_page_nowait(mapping,
+							start_index + i);
+			if (ra->page[i] && PageUptodate(ra->page[i])) {
+				unlock_page(ra->page[i]);
+				page_cache_release(ra->page[i]);
+				ra->page[i] = NULL;
+			}
+		}
+		if (ra->page[i])
+			n++;
+	}
+
+	/* everything is cached or being read by somebody else */
+	if (n == 0) {
+		kfree(ra);
+		return 0;
+	}
+
+	if (async && squashfs_read_wq) {
+		INIT_WORK(&ra->work, squashfs_ra_block_work);
+		queue_work(squashfs_read_wq, &ra->work);
+	} else
+		squashfs_ra_block_read(ra);
+
+	return 0;
+}
+
+int __init squashfs_readahead_init(void)
+{
+	/* parallel reads only pay off with a decompressor per thread */
+	if (squashfs_max_decompressors() == 1)
+		return 0;
+
+	squashfs_read_wq = alloc_workqueue("squashfs_read",
+					   WQ_UNBOUND | WQ_HIGHPRI, 0);
+	return squashfs_read_wq ? 0 : -ENOMEM;
+}
+
+void squashfs_readahead_exit(void)
+{
+	if (squashfs_read_wq)
+		destroy_workqueue(squashfs_read_wq);
+}
+
+/*
+ * Decompress the datablock into the @pages page cache pages of @page. A
+ * NULL entry is a page that is uptodate or that could not be grabbed.
+ * All pages but @target_page are unlocked and released; @target_page, if
+ * any, is left to the caller on error.
+ */
+static int squashfs_read_pages(struct inode *inode, struct page *target_page,
+	u64 block, int bsize, int pages, struct page **page)
+{
+	int i, missing_pages, bytes, res = -ENOMEM;
+	struct squashfs_page_actor *actor;
+	void *pageaddr;
+
+	for (missing_pages = 0, i = 0; i < pages; i++)
+		if (page[i] == NULL)
+			missing_pages++;
+
 	if (missing_pages) {
 		/*
 		 * Couldn't get one or more pages, this page has either
@@ -82,16 +215,25 @@ int squashfs_readpage_block(struct page *target_page, u64 block, int bsize)
 		 * squashfs_readpage also trying to grab them.  Fall back to
 		 * using an intermediate buffer.
 		 */
-		res = squashfs_read_cache(target_page, block, bsize, pages,
-								page);
+		res = squashfs_read_cache(inode, target_page, block, bsize,
+								pages, page);
 		if (res < 0)
 			goto mark_errored;
 
-		goto out;
+		return res;
 	}
 
+	/*
+	 * Create a "page actor" which will kmap and kunmap the
+	 * page cache pages appropriately within the decompressor
+	 */
+	actor = squashfs_page_actor_init_special(page, pages, 0);
+	if (actor == NULL)
+		goto mark_errored;
+
 	/* Decompress directly into the page cache buffers */
 	res = squashfs_read_data(inode->i_sb, block, bsize, NULL, actor);
+	kfree(actor);
 	if (res < 0)
 		goto mark_errored;
 
@@ -112,9 +254,6 @@ int squashfs_readpage_block(struct page *target_page, u64 block, int bsize)
 			page_cache_release(page[i]);
 	}
 
-	kfree(actor);
-	kfree(page);
-
 	return 0;
 
 mark_errored:
@@ -130,17 +269,13 @@ mark_errored:
 		page_cache_release(page[i]);
 	}
 
-out:
-	kfree(actor);
-	kfree(page);
 	return res;
 }
 
 
-static int squashfs_read_cache(struct page *target_page, u64 block, int bsize,
-	int pages, struct page **page)
+static int squashfs_read_cache(struct inode *i, struct page *target_page,
+	u64 block, int bsize, int pages, struct page **page)
 {
-	struct inode *i = target_page->mapping->host;
 	struct squashfs_cache_entry *buffer = squashfs_get_datablock(i->i_sb,
 						 block, bsize);
 	int bytes = buffer->length, res = buffer->error, n, offset = 0;
@@ -73,6 +73,12 @@ void squashfs_copy_cache(struct page *, struct squashfs_cache_entry *, int,
 /* file_xxx.c */
 extern int squashfs_readpage_block(struct page *, u64, int);
 
+/* file_direct.c */
+extern int squashfs_readahead_block(struct inode *, u64, int,
+				struct list_head *, bool);
+extern int squashfs_readahead_init(void);
+extern void squashfs_readahead_exit(void);
+
 /* id.c */
 extern int squashfs_get_id(struct super_block *, unsigned int, unsigned int *);
 extern __le64 *squashfs_read_id_index_table(struct super_block *, u64, u64,
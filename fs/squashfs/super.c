@@ -444,8 +444,19 @@ static int __init init_squashfs_fs(void)
 	if (err)
 		return err;
 
+#ifdef CONFIG_SQUASHFS_FILE_DIRECT
+	err = squashfs_readahead_init();
+	if (err) {
+		destroy_inodecache();
+		return err;
+	}
+#endif
+
 	err = register_filesystem(&squashfs_fs_type);
 	if (err) {
+#ifdef CONFIG_SQUASHFS_FILE_DIRECT
+		squashfs_readahead_exit();
+#endif
 		destroy_inodecache();
 		return err;
 	}
@@ -459,6 +470,9 @@ static int __init init_squashfs_fs(void)
 static void __exit exit_squashfs_fs(void)
 {
 	unregister_filesystem(&squashfs_fs_type);
+#ifdef CONFIG_SQUASHFS_FILE_DIRECT
+	squashfs_readahead_exit();
+#endif
 	destroy_inodecache();
 }
 
@@ -499,6 +499,11 @@ struct request_queue {
 	 */
 	unsigned long		queue_flags;
 
+	/*
+	 * requests completed on each cpu, see completion_cpus in sysfs
+	 */
+	unsigned long __percpu	*comp_cpu_count;
+
 	/*
 	 * ida allocated id for this queue.  Used to index queues from
 	 * ioctx.
@@ -587,6 +592,9 @@ struct request_queue {
 	unsigned int		flush_flags;
 	unsigned int		flush_not_queueable:1;
 	struct blk_flush_queue	*fq;
+	/* write completions, a flush with none since the last one is elided */
+	atomic_long_t		flush_write_seq;
+	unsigned long		flush_elided;
 
 	struct list_head	requeue_list;
 	spinlock_t		requeue_lock;
@@ -639,6 +647,7 @@ struct request_queue {
 #define QUEUE_FLAG_INIT_DONE   20	/* queue is initialized */
 #define QUEUE_FLAG_NO_SG_MERGE 21	/* don't attempt to merge SG segments*/
 #define QUEUE_FLAG_SG_GAPS     22	/* queue doesn't support SG gaps */
+#define QUEUE_FLAG_SAME_CLUSTER 23	/* complete in the submitter's cluster */
 
 #define QUEUE_FLAG_DEFAULT	((1 << QUEUE_FLAG_IO_STAT) |		\
 				 (1 << QUEUE_FLAG_STACKABLE)	|	\
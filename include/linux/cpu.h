@@ -226,6 +226,11 @@ extern void cpu_hotplug_enable(void);
 #define __unregister_hotcpu_notifier(nb)	__unregister_cpu_notifier(nb)
 void clear_tasks_mm_cpumask(int cpu);
 int cpu_down(unsigned int cpu);
+#ifdef CONFIG_CPU_ISOLATION
+extern int cpu_isolate_set(const struct cpumask *mask);
+extern int cpu_up_by_mask(const struct cpumask *mask);
+extern int cpu_down_by_mask(const struct cpumask *mask);
+#endif
 
 #else		/* CONFIG_HOTPLUG_CPU */
 
@@ -44,6 +44,8 @@ extern int nr_cpu_ids;
  *     cpu_present_mask - has bit 'cpu' set iff cpu is populated
  *     cpu_online_mask  - has bit 'cpu' set iff cpu available to scheduler
  *     cpu_active_mask  - has bit 'cpu' set iff cpu available to migration
+ *     cpu_isolate_mask - has bit 'cpu' set iff cpu is online but takes no
+ *                        new tasks (CONFIG_CPU_ISOLATION)
  *
  *  If !CONFIG_HOTPLUG_CPU, present == possible, and active == online.
  *
@@ -81,6 +83,13 @@ extern const struct cpumask *const cpu_online_mask;
 extern const struct cpumask *const cpu_present_mask;
 extern const struct cpumask *const cpu_active_mask;
 
+#ifdef CONFIG_CPU_ISOLATION
+extern const struct cpumask *const cpu_isolate_mask;
+#define cpu_isolated(cpu)	cpumask_test_cpu((cpu), cpu_isolate_mask)
+#else
+#define cpu_isolated(cpu)	((void)(cpu), 0)
+#endif
+
 #if NR_CPUS > 1
 #define num_online_cpus()	cpumask_weight(cpu_online_mask)
 #define num_possible_cpus()	cpumask_weight(cpu_possible_mask)
@@ -79,6 +79,20 @@ extern int i2c_master_send(const struct i2c_client *client, const char *buf,
 			   int count);
 extern int i2c_master_recv(const struct i2c_client *client, char *buf,
 			   int count);
+#ifdef CONFIG_MTK_I2C_EXTENSION
+/* Write-then-read in one controller transaction, DMA above the FIFO size */
+struct mtk_i2c_wrrd {
+	const u8 *wbuf;
+	u16 wlen;
+	u8 *rbuf;
+	u16 rlen;
+};
+
+extern int mtk_i2c_write_read(const struct i2c_client *client,
+			      const u8 *wbuf, u16 wlen, u8 *rbuf, u16 rlen);
+extern int mtk_i2c_write_read_batch(const struct i2c_client *client,
+				    struct mtk_i2c_wrrd *req, int num);
+#endif
 
 /* Transfer num messages.
  */
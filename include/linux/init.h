@@ -143,6 +143,7 @@ typedef void (*ctor_fn_t)(void);
 
 /* Defined in init/main.c */
 extern int do_one_initcall(initcall_t fn);
+extern int async_initcall_schedule(initcall_t fn);
 extern char __initdata boot_command_line[];
 extern char *saved_command_line;
 extern unsigned int reset_devices;
@@ -227,6 +228,21 @@ extern bool initcall_debug;
 #define late_initcall(fn)		__define_initcall(fn, 7)
 #define late_initcall_sync(fn)		__define_initcall(fn, 7s)
 
+/*
+ * async_device_initcall() - device initcall run from the async pool
+ *
+ * For drivers whose only dependencies are on earlier initcall levels (and
+ * DT/supplies that -EPROBE_DEFER handles): fn runs concurrently with the
+ * rest of the device level and is waited for before late initcalls start.
+ * Nothing in the device level may depend on fn having completed.
+ */
+#define async_device_initcall(fn)				\
+	static int __init __async_initcall_##fn(void)		\
+	{							\
+		return async_initcall_schedule(fn);		\
+	}							\
+	device_initcall(__async_initcall_##fn)
+
 #define __initcall(fn) device_initcall(fn)
 
 #define __exitcall(fn) \
@@ -319,6 +335,7 @@ void __init parse_early_options(char *cmdline);
 #define device_initcall_sync(fn)	module_init(fn)
 #define late_initcall(fn)		module_init(fn)
 #define late_initcall_sync(fn)		module_init(fn)
+#define async_device_initcall(fn)	module_init(fn)
 
 #define console_initcall(fn)		module_init(fn)
 #define security_initcall(fn)		module_init(fn)
@@ -1383,6 +1383,10 @@ enum netdev_priv_flags {
  *	@real_num_tx_queues: 	Number of TX queues currently active in device
  *	@qdisc:			Root qdisc from userspace point of view
  *	@tx_queue_len:		Max frames per queue allowed
+ *	@tsq_limit:		Bytes a TCP socket may have below it in qdisc/device
+ *				queues, 0 to use sysctl tcp_limit_output_bytes
+ *	@tcp_pacing:		TCP paces its sockets to sk_pacing_rate by itself
+ *				on this device, for deep buffered links without fq
  *	@tx_global_lock: 	XXX: need comments on this one
  *
  *	@xps_maps:	XXX: need comments on this one
@@ -1609,6 +1613,8 @@ struct net_device {
 	unsigned int		real_num_tx_queues;
 	struct Qdisc		*qdisc;
 	unsigned long		tx_queue_len;
+	unsigned int		tsq_limit;
+	unsigned char		tcp_pacing;
 	spinlock_t		tx_global_lock;
 
 #ifdef CONFIG_XPS
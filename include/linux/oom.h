@@ -92,6 +92,19 @@ static inline bool oom_gfp_allowed(gfp_t gfp_mask)
 
 extern struct task_struct *find_lock_task_mm(struct task_struct *p);
 
+/* LMK victim index groups processes by oom_score_adj in buckets of 64 */
+#define LOWMEM_ADJ_BUCKET_SHIFT	6
+#define lowmem_adj_bucket(adj)	\
+	(((adj) - OOM_SCORE_ADJ_MIN) >> LOWMEM_ADJ_BUCKET_SHIFT)
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+extern void lowmem_adj_track(struct task_struct *task);
+extern int lowmem_adj_snapshot(struct task_struct **tasks, int max,
+			       short min_score_adj, short max_score_adj);
+#else
+static inline void lowmem_adj_track(struct task_struct *task) { }
+#endif
+
 /* sysctls */
 extern int sysctl_oom_dump_tasks;
 extern int sysctl_oom_kill_allocating_task;
@@ -1071,6 +1071,8 @@ extern void wake_up_if_idle(int cpu);
 struct hmp_domain {
 	struct cpumask cpus;
 	struct cpumask possible_cpus;
+	/* cpus currently running their idle task, see hmp_idle_enter() */
+	struct cpumask idle_cpus;
 	struct list_head hmp_domains;
 };
 
@@ -1081,6 +1083,21 @@ struct hmp_statisic {
 };
 #endif /* CONFIG_HMP_TRACER */
 #endif /* CONFIG_SCHED_HMP */
+
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+/*
+ * Core-count events raised by the scheduler for the kernel space hotplug
+ * strategy, passed to the registered callback as a bitmask. The callback
+ * runs from irq_work context and must not sleep.
+ */
+#define SCHED_NR_EVENT_RQ_LENGTH	0	/* a runqueue reached the length threshold */
+#define SCHED_NR_EVENT_HMP_UP		1	/* a heavy task found no big cpu to run on */
+
+typedef void (*sched_nr_event_fn)(unsigned long events);
+
+extern int sched_nr_event_register(sched_nr_event_fn fn, unsigned int rq_length);
+extern void sched_nr_event(int event);
+#endif /* CONFIG_MTK_SCHED_RQAVG_KS */
 #else /* CONFIG_SMP */
 
 struct sched_domain_attr;
@@ -1242,6 +1259,7 @@ struct sched_rt_entity {
 	unsigned long timeout;
 	unsigned long watchdog_stamp;
 	unsigned int time_slice;
+	u64 wake_stamp;		/* rq clock of the last wakeup, until it runs */
 
 	struct sched_rt_entity *back;
 #ifdef CONFIG_RT_GROUP_SCHED
@@ -1253,6 +1271,24 @@ struct sched_rt_entity {
 #endif
 };
 
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+#define RAVG_HIST_SIZE		5
+
+/*
+ * Windowed demand of a task. Execution time is scaled by the current
+ * capacity of the cpu (cpu capacity * cur freq / max freq), so a window
+ * compares across clusters and OPPs.
+ */
+struct ravg {
+	u64 window_start;			/* window curr_window accounts to */
+	u32 curr_window;			/* scaled ns run in that window */
+	u32 sum_history[RAVG_HIST_SIZE];	/* previous windows, newest first */
+	u32 demand;				/* max(newest, average), capacity units */
+	u32 rq_demand;				/* what rq->cumulative_demand holds for us */
+	unsigned char queued;
+};
+#endif
+
 struct sched_dl_entity {
 	struct rb_node	rb_node;
 
@@ -1377,6 +1413,18 @@ struct task_struct {
 	struct sched_rt_entity rt;
 #ifdef CONFIG_CGROUP_SCHED
 	struct task_group *sched_task_group;
+#endif
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	/* clamp buckets (min, max) accounted on the rq while enqueued */
+	unsigned char uclamp_bucket[2];
+	unsigned char uclamp_queued;
+#endif
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+	struct ravg ravg;
+#endif
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	/* SCHED_FLAG_LATENCY_SENSITIVE, written under p->pi_lock and rq->lock */
+	unsigned char latency_sensitive;
 #endif
 	struct sched_dl_entity dl;
 
@@ -1493,6 +1541,18 @@ struct task_struct {
 	cputime_t utime, stime, utimescaled, stimescaled;
 	cputime_t gtime;
 	unsigned long long cpu_power;
+#ifdef CONFIG_MTPROF_CPUTIME
+	/* cputime per (cluster, OPP index), see mtprof/prof_opp.c */
+#define MTK_OPP_CLUSTER_NR	2
+#define MTK_OPP_NR		16
+	u32 mtk_opp_time[MTK_OPP_CLUSTER_NR][MTK_OPP_NR];
+#endif
+#ifdef CONFIG_MTPROF_PMU
+	/* PMU counts while running, see mtprof/prof_pmu.c */
+#define MTK_PMU_NR		4
+	u64 mtk_pmu[MTK_PMU_NR];
+	u16 mtk_pmu_membound;	/* memory stall share of cycles, /1024 */
+#endif
 #ifndef CONFIG_VIRT_CPU_ACCOUNTING_NATIVE
 	struct cputime prev_cputime;
 #endif
@@ -2356,6 +2416,14 @@ extern int sched_setscheduler_nocheck(struct task_struct *, int,
 				      const struct sched_param *);
 extern int sched_setattr(struct task_struct *,
 			 const struct sched_attr *);
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+extern bool task_io_foreground(struct task_struct *p);
+#else
+static inline bool task_io_foreground(struct task_struct *p)
+{
+	return false;
+}
+#endif
 extern struct task_struct *idle_task(int cpu);
 /**
  * is_idle_task - is the specified task an idle task?
@@ -0,0 +1,49 @@
+#ifndef _SCHED_ENERGY_H
+#define _SCHED_ENERGY_H
+
+#include <linux/cpumask.h>
+
+#define SCHED_ENERGY_MAX_CAP_STATES	16
+
+/*
+ * One operating point of a cpu: compute capacity (same scale as
+ * capacity_orig_of(), i.e. the biggest cpu at its highest OPP is
+ * SCHED_CAPACITY_SCALE) and the power (uW) one busy cpu consumes there.
+ */
+struct capacity_state {
+	unsigned long cap;
+	unsigned long power;
+};
+
+/*
+ * Energy model of one cluster. cap_states[] is sorted by ascending
+ * capacity. idle_power is what an online but idle cpu of the cluster
+ * burns (leakage at the lowest OPP voltage).
+ */
+struct cluster_energy {
+	struct cpumask cpus;
+	int nr_cap_states;
+	struct capacity_state cap_states[SCHED_ENERGY_MAX_CAP_STATES];
+	unsigned long idle_power;
+};
+
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+extern int sched_energy_register(int cluster, const struct cpumask *cpus,
+				 const struct capacity_state *states,
+				 int nr_states, unsigned long idle_power);
+extern const struct cluster_energy *sched_cluster_energy(int cluster);
+#else
+static inline int sched_energy_register(int cluster, const struct cpumask *cpus,
+					const struct capacity_state *states,
+					int nr_states, unsigned long idle_power)
+{
+	return -ENOSYS;
+}
+
+static inline const struct cluster_energy *sched_cluster_energy(int cluster)
+{
+	return NULL;
+}
+#endif
+
+#endif /* _SCHED_ENERGY_H */
@@ -116,6 +116,10 @@ typedef struct {
  */
 struct reclaim_state {
 	unsigned long reclaimed_slab;
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_PRESSURE
+	u64 stall_start;	/* ns, direct reclaim entry */
+	int stall_zone;		/* highest zone of the allocation */
+#endif
 };
 
 #ifdef __KERNEL__
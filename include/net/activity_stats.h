@@ -16,10 +16,22 @@
 #ifndef __activity_stats_h
 #define __activity_stats_h
 
+#include <linux/ktime.h>
+
+struct sock;
+
 #ifdef CONFIG_NET_ACTIVITY_STATS
 void activity_stats_update(void);
+#define activity_stats_sock_start() ktime_get()
+void activity_stats_sock_xfer(struct sock *sk, ktime_t start, int ret,
+			      bool tx);
+void activity_stats_sock_release(struct sock *sk);
 #else
 #define activity_stats_update(void) {}
+#define activity_stats_sock_start() ktime_set(0, 0)
+static inline void activity_stats_sock_xfer(struct sock *sk, ktime_t start,
+					    int ret, bool tx) {}
+static inline void activity_stats_sock_release(struct sock *sk) {}
 #endif
 
 #endif /* _NET_ACTIVITY_STATS_H */
@@ -63,6 +63,7 @@ struct unix_sock {
 #define UNIX_GC_CANDIDATE	0
 #define UNIX_GC_MAYBE_CYCLE	1
 	struct socket_wq	peer_wq;
+	struct sk_buff_head	skb_cache;	/* sent skbs handed back */
 };
 #define unix_sk(__sk) ((struct unix_sock *)__sk)
 
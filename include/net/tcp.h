@@ -1611,6 +1611,28 @@ static inline bool tcp_stream_memory_free(const struct sock *sk)
 	return notsent_bytes < tcp_notsent_lowat(tp);
 }
 
+/* per device TSQ limit, used instead of sysctl_tcp_limit_output_bytes in tcp_write_xmit() */
+static inline unsigned int tcp_tsq_limit(const struct sock *sk)
+{
+	const struct dst_entry *dst = __sk_dst_get((struct sock *)sk);
+
+	if (dst && dst->dev && dst->dev->tsq_limit)
+		return dst->dev->tsq_limit;
+	return sysctl_tcp_limit_output_bytes;
+}
+
+/*
+ * The device asks TCP to pace to sk_pacing_rate by itself, as there is no
+ * fq qdisc doing it below.
+ */
+static inline bool tcp_needs_internal_pacing(const struct sock *sk)
+{
+	const struct dst_entry *dst = __sk_dst_get((struct sock *)sk);
+
+	return dst && dst->dev && dst->dev->tcp_pacing &&
+	       sk->sk_pacing_rate != ~0U;
+}
+
 /* MTK_NET_CHANGES */
 extern void tcp_v4_reset_connections_by_uid(struct uid_err uid_e);
 extern void tcp_v4_handle_retrans_time_by_uid(struct uid_err uid_e);
@@ -105,6 +105,41 @@ TRACE_EVENT(gpu_freq,
 	TP_printk("frequency=%lu", (unsigned long)__entry->frequency)
 );
 
+#ifdef CONFIG_MTK_KERNEL_MARKER
+struct trace_seq;
+const char *mt_kernel_marker_print(struct trace_seq *p, char type, int tgid,
+				   int id, int value);
+
+/*
+ * Kernel systrace marker, mt-plat/mt_kernel_marker.h. The name is an id
+ * into the table in kernel/trace/mtk_trace.c, printed the way systrace
+ * reads the user space trace_marker.
+ */
+TRACE_EVENT(tracing_mark_write,
+
+	TP_PROTO(char type, int tgid, int id, int value),
+
+	TP_ARGS(type, tgid, id, value),
+
+	TP_STRUCT__entry(
+		__field(char,	type)
+		__field(int,	tgid)
+		__field(int,	id)
+		__field(int,	value)
+	),
+
+	TP_fast_assign(
+		__entry->type = type;
+		__entry->tgid = tgid;
+		__entry->id = id;
+		__entry->value = value;
+	),
+
+	TP_printk("%s", mt_kernel_marker_print(p, __entry->type,
+		__entry->tgid, __entry->id, __entry->value))
+);
+#endif
+
 #endif /* _TRACE_MTK_EVENTS_H */
 /* This part must be outside protection */
 #include <trace/define_trace.h>
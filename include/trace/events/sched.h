@@ -878,6 +878,68 @@ TRACE_EVENT(sched_hmp_migrate,
 			__entry->dest, __entry->force)
 );
 
+/*
+ * Tracepoint for the cpu chosen for an RT task by its placement cost
+ */
+TRACE_EVENT(sched_rt_select_cpu,
+
+	TP_PROTO(struct task_struct *tsk, int prev_cpu, int target, unsigned long cost),
+
+	TP_ARGS(tsk, prev_cpu, target, cost),
+
+	TP_STRUCT__entry(
+		__array(char, comm, TASK_COMM_LEN)
+		__field(pid_t, pid)
+		__field(int, prio)
+		__field(int, prev_cpu)
+		__field(int, target)
+		__field(unsigned long, cost)
+	),
+
+	TP_fast_assign(
+		memcpy(__entry->comm, tsk->comm, TASK_COMM_LEN);
+		__entry->pid		= tsk->pid;
+		__entry->prio		= tsk->prio;
+		__entry->prev_cpu	= prev_cpu;
+		__entry->target		= target;
+		__entry->cost		= cost;
+	),
+
+	TP_printk("comm=%s pid=%d prio=%d prev_cpu=%d target=%d cost=%lu",
+			__entry->comm, __entry->pid, __entry->prio,
+			__entry->prev_cpu, __entry->target, __entry->cost)
+);
+
+/*
+ * Tracepoint for the time from an RT task's wakeup until it is picked
+ */
+TRACE_EVENT(sched_rt_wakeup_latency,
+
+	TP_PROTO(struct task_struct *tsk, int cpu, u64 latency),
+
+	TP_ARGS(tsk, cpu, latency),
+
+	TP_STRUCT__entry(
+		__array(char, comm, TASK_COMM_LEN)
+		__field(pid_t, pid)
+		__field(int, prio)
+		__field(int, cpu)
+		__field(u64, latency)
+	),
+
+	TP_fast_assign(
+		memcpy(__entry->comm, tsk->comm, TASK_COMM_LEN);
+		__entry->pid		= tsk->pid;
+		__entry->prio		= tsk->prio;
+		__entry->cpu		= cpu;
+		__entry->latency	= latency;
+	),
+
+	TP_printk("comm=%s pid=%d prio=%d cpu=%d latency=%llu ns",
+			__entry->comm, __entry->pid, __entry->prio,
+			__entry->cpu, (unsigned long long)__entry->latency)
+);
+
 /*
  * sched: tracepoint for showing tracked load contribution.
  */
@@ -0,0 +1,60 @@
+/*
+ * Per-interface, per-uid socket statistics exported by net/activity_stats.c
+ * over the "ACT_STATS" generic netlink family.
+ *
+ * ACTIVITY_STATS_CMD_GET is a dump request; every reply message carries one
+ * ACTIVITY_STATS_A_SOCK attribute holding a struct activity_sock_stats.
+ * ACTIVITY_STATS_CMD_RESET (CAP_NET_ADMIN) clears the table.
+ */
+
+#ifndef _UAPI_LINUX_ACTIVITY_STATS_H
+#define _UAPI_LINUX_ACTIVITY_STATS_H
+
+#include <linux/types.h>
+
+#define ACTIVITY_STATS_GENL_NAME	"ACT_STATS"
+#define ACTIVITY_STATS_GENL_VERSION	1
+
+/*
+ * Latency buckets are powers of two in microseconds: bucket 0 counts calls
+ * under 1us, bucket n counts calls in [2^(n-1), 2^n) us, and the last bucket
+ * is open ended.
+ */
+#define ACTIVITY_STATS_LAT_BUCKETS	16
+
+/* Buffer occupancy buckets are eighths of sk_sndbuf / sk_rcvbuf. */
+#define ACTIVITY_STATS_OCC_BUCKETS	8
+
+#define ACTIVITY_STATS_IFNAMSIZ		16
+
+struct activity_sock_stats {
+	__u32	ifindex;	/* 0 when the socket has no route yet */
+	__u32	uid;
+	char	ifname[ACTIVITY_STATS_IFNAMSIZ];
+	__u64	tx_bytes;
+	__u64	rx_bytes;
+	__u64	tx_calls;
+	__u64	rx_calls;
+	__u64	tcp_retrans;	/* accounted when the socket is released */
+	__u32	tx_lat[ACTIVITY_STATS_LAT_BUCKETS];	/* time in sendmsg */
+	__u32	rx_lat[ACTIVITY_STATS_LAT_BUCKETS];	/* time in recvmsg */
+	__u32	sndbuf_occ[ACTIVITY_STATS_OCC_BUCKETS];	/* after sendmsg */
+	__u32	rcvbuf_occ[ACTIVITY_STATS_OCC_BUCKETS];	/* after recvmsg */
+};
+
+enum {
+	ACTIVITY_STATS_CMD_UNSPEC,
+	ACTIVITY_STATS_CMD_GET,
+	ACTIVITY_STATS_CMD_RESET,
+	__ACTIVITY_STATS_CMD_MAX,
+};
+#define ACTIVITY_STATS_CMD_MAX (__ACTIVITY_STATS_CMD_MAX - 1)
+
+enum {
+	ACTIVITY_STATS_A_UNSPEC,
+	ACTIVITY_STATS_A_SOCK,		/* struct activity_sock_stats */
+	__ACTIVITY_STATS_A_MAX,
+};
+#define ACTIVITY_STATS_A_MAX (__ACTIVITY_STATS_A_MAX - 1)
+
+#endif /* _UAPI_LINUX_ACTIVITY_STATS_H */
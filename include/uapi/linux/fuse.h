@@ -756,4 +756,11 @@ struct fuse_notify_retrieve_in {
 	uint64_t	dummy4;
 };
 
+/* Device ioctls: */
+#define FUSE_DEV_IOC_MAGIC		229
+/* attach the device fd to the connection of the /dev/fuse fd passed in */
+#define FUSE_DEV_IOC_CLONE		_IOR(FUSE_DEV_IOC_MAGIC, 0, uint32_t)
+/* non-zero: several requests per read and several replies per write */
+#define FUSE_DEV_IOC_BATCH		_IOW(FUSE_DEV_IOC_MAGIC, 1, uint32_t)
+
 #endif /* _LINUX_FUSE_H */
@@ -788,9 +788,11 @@ int __init_or_module do_one_initcall(initcall_t fn)
 	int count = preempt_count();
 	int ret;
 	char msgbuf[64];
+	unsigned long long ts;
 
 	if (initcall_blacklisted(fn))
 		return -EPERM;
+	ts = sched_clock();
 #if defined(CONFIG_MT_ENG_BUILD)
 	ret = do_one_initcall_debug(fn);
 #else
@@ -810,10 +812,41 @@ int __init_or_module do_one_initcall(initcall_t fn)
 		local_irq_enable();
 	}
 	WARN(msgbuf[0], "initcall %pF returned with %s\n", fn, msgbuf);
+	bootprof_initcall(fn, ts);
 
 	return ret;
 }
 
+/*
+ * async_device_initcall() support: the initcalls are queued on their own
+ * domain and waited for at the end of the level that queued them, so the
+ * level boundary stays a barrier for them and nothing else has to wait.
+ * "initcall_async=0" runs them inline again.
+ */
+static ASYNC_DOMAIN_EXCLUSIVE(initcall_async_domain);
+static bool initcall_async __initdata = true;
+
+static int __init initcall_async_setup(char *str)
+{
+	return strtobool(str, &initcall_async) == 0;
+}
+__setup("initcall_async=", initcall_async_setup);
+
+static void __init async_initcall_run(void *data, async_cookie_t cookie)
+{
+	do_one_initcall((initcall_t)data);
+}
+
+int __init async_initcall_schedule(initcall_t fn)
+{
+	if (!initcall_async)
+		return do_one_initcall(fn);
+
+	async_schedule_domain(async_initcall_run, (void *)fn,
+			      &initcall_async_domain);
+	return 0;
+}
+
 
 extern initcall_t __initcall_start[];
 extern initcall_t __initcall0_start[];
@@ -863,6 +896,8 @@ static void __init do_initcall_level(int level)
 
 	for (fn = initcall_levels[level]; fn < initcall_levels[level+1]; fn++)
 		do_one_initcall(*fn);
+
+	async_synchronize_full_domain(&initcall_async_domain);
 }
 
 static void __init do_initcalls(void)
@@ -16,6 +16,9 @@
 #include <linux/sched/rt.h>
 #include <linux/sched/deadline.h>
 #include <linux/timer.h>
+#include <linux/moduleparam.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
 
 #include "rtmutex_common.h"
 
@@ -1086,6 +1089,126 @@ void rt_mutex_adjust_pi(struct task_struct *task)
 				   next_lock, NULL, task);
 }
 
+#ifdef CONFIG_SMP
+/*
+ * Adaptive spinning: the top waiter of a lock whose owner is running on
+ * another cpu spins for up to spin_max_ns before going to sleep, because
+ * the owner (boosted by now) is likely to drop the lock sooner than a
+ * sleep/wakeup round trip takes. PI futex hand-offs between RT threads go
+ * through here as well. The outcomes are counted in /proc/rt_mutex_spin.
+ */
+static unsigned int spin_max_ns = 20000;
+module_param(spin_max_ns, uint, 0644);
+
+struct rt_mutex_spin_stats {
+	unsigned long spins;		/* spins started */
+	unsigned long released;		/* owner let go of the lock */
+	unsigned long owner_slept;	/* owner went off its cpu */
+	unsigned long timeout;		/* spin_max_ns or need_resched */
+	unsigned long sleeps;		/* waits that ended in schedule() */
+};
+
+static DEFINE_PER_CPU(struct rt_mutex_spin_stats, rt_mutex_spin_stats);
+
+#define rt_mutex_spin_stat_inc(field)	this_cpu_inc(rt_mutex_spin_stats.field)
+
+/*
+ * Spin while @owner holds @lock and runs. Returns true when the lock
+ * changed hands and the caller should try to take it rather than sleep.
+ * Like mutex_spin_on_owner(), @owner is only dereferenced under RCU after
+ * checking it still owns the lock.
+ */
+static bool rt_mutex_spin_on_owner(struct rt_mutex *lock,
+				   struct task_struct *owner)
+{
+	u64 deadline;
+	bool ret = false;
+
+	if (!owner || !spin_max_ns)
+		return false;
+
+	rt_mutex_spin_stat_inc(spins);
+	deadline = local_clock() + spin_max_ns;
+	rcu_read_lock();
+	for (;;) {
+		if (rt_mutex_owner(lock) != owner) {
+			rt_mutex_spin_stat_inc(released);
+			ret = true;
+			break;
+		}
+		barrier();
+		if (!owner->on_cpu) {
+			rt_mutex_spin_stat_inc(owner_slept);
+			break;
+		}
+		if (need_resched() || local_clock() > deadline) {
+			rt_mutex_spin_stat_inc(timeout);
+			break;
+		}
+		cpu_relax_lowlatency();
+	}
+	rcu_read_unlock();
+
+	return ret;
+}
+
+#ifdef CONFIG_PROC_FS
+static int rt_mutex_spin_show(struct seq_file *m, void *v)
+{
+	struct rt_mutex_spin_stats sum = { 0 };
+	struct rt_mutex_spin_stats *st;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		st = per_cpu_ptr(&rt_mutex_spin_stats, cpu);
+		sum.spins += st->spins;
+		sum.released += st->released;
+		sum.owner_slept += st->owner_slept;
+		sum.timeout += st->timeout;
+		sum.sleeps += st->sleeps;
+	}
+
+	seq_printf(m, "spin_max_ns: %u\n", spin_max_ns);
+	seq_printf(m, "spins:       %lu\n", sum.spins);
+	seq_printf(m, "released:    %lu\n", sum.released);
+	seq_printf(m, "owner_slept: %lu\n", sum.owner_slept);
+	seq_printf(m, "timeout:     %lu\n", sum.timeout);
+	seq_printf(m, "sleeps:      %lu\n", sum.sleeps);
+	return 0;
+}
+
+static int rt_mutex_spin_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, rt_mutex_spin_show, NULL);
+}
+
+static const struct file_operations proc_rt_mutex_spin_operations = {
+	.open		= rt_mutex_spin_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static int __init rt_mutex_spin_proc_init(void)
+{
+	proc_create("rt_mutex_spin", S_IRUSR, NULL, &proc_rt_mutex_spin_operations);
+	return 0;
+}
+device_initcall(rt_mutex_spin_proc_init);
+#endif /* CONFIG_PROC_FS */
+
+#else /* !CONFIG_SMP */
+
+#define rt_mutex_spin_stat_inc(field)	do { } while (0)
+
+static inline bool rt_mutex_spin_on_owner(struct rt_mutex *lock,
+					  struct task_struct *owner)
+{
+	return false;
+}
+
+#endif /* CONFIG_SMP */
+
 /**
  * __rt_mutex_slowlock() - Perform the wait-wake-try-to-take loop
  * @lock:		 the rt_mutex to take
@@ -1101,6 +1224,7 @@ __rt_mutex_slowlock(struct rt_mutex *lock, int state,
 		    struct hrtimer_sleeper *timeout,
 		    struct rt_mutex_waiter *waiter)
 {
+	struct task_struct *owner;
 	int ret = 0;
 
 	for (;;) {
@@ -1122,11 +1246,19 @@ __rt_mutex_slowlock(struct rt_mutex *lock, int state,
 				break;
 		}
 
+		/* only the top waiter would get the lock when it is released */
+		owner = NULL;
+		if (rt_mutex_top_waiter(lock) == waiter)
+			owner = rt_mutex_owner(lock);
+
 		raw_spin_unlock(&lock->wait_lock);
 
 		debug_rt_mutex_print_deadlock(waiter);
 
-		schedule_rt_mutex(lock);
+		if (!rt_mutex_spin_on_owner(lock, owner)) {
+			rt_mutex_spin_stat_inc(sleeps);
+			schedule_rt_mutex(lock);
+		}
 
 		raw_spin_lock(&lock->wait_lock);
 		set_current_state(state);
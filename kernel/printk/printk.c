@@ -45,6 +45,7 @@
 #include <linux/rculist.h>
 #include <linux/poll.h>
 #include <linux/irq_work.h>
+#include <linux/kthread.h>
 #include <linux/utsname.h>
 #include <mt-plat/aee.h>
 #include <linux/ctype.h>
@@ -1637,6 +1638,42 @@ static int console_trylock_for_printk(void)
 	return 1;
 }
 
+/*
+ * Console offload: printk() only stores the record and wakes printk_kthread,
+ * which pushes the backlog to the consoles, so a log storm no longer keeps
+ * the caller spinning on a slow UART with interrupts off. Early boot,
+ * shutdown and oopses/panics still print synchronously.
+ */
+static struct task_struct *printk_kthread;
+static bool printk_offload = true;
+module_param_named(console_offload, printk_offload, bool, S_IRUGO | S_IWUSR);
+
+static inline bool printk_offload_console(void)
+{
+	return printk_offload && printk_kthread && !oops_in_progress &&
+		system_state == SYSTEM_RUNNING;
+}
+
+/*
+ * printk() may be called with rq->lock or p->pi_lock held (scheduler
+ * warnings), so the kthread is woken from an irq_work, never directly.
+ */
+static void printk_kthread_wake_func(struct irq_work *irq_work)
+{
+	wake_up_process(printk_kthread);
+}
+
+static DEFINE_PER_CPU(struct irq_work, printk_kthread_work) = {
+	.func = printk_kthread_wake_func,
+};
+
+static void printk_kthread_kick(void)
+{
+	preempt_disable();
+	irq_work_queue(this_cpu_ptr(&printk_kthread_work));
+	preempt_enable();
+}
+
 int printk_delay_msec __read_mostly;
 
 static inline void printk_delay(void)
@@ -1921,7 +1958,9 @@ asmlinkage int vprintk_emit(int facility, int level,
 	local_irq_restore(flags);
 
 	/* If called from the scheduler, we can not call up(). */
-	if (!in_sched) {
+	if (!in_sched && printk_offload_console()) {
+		printk_kthread_kick();
+	} else if (!in_sched) {
 		lockdep_off();
 		/*
 		 * Disable preemption to avoid being preempted while holding
@@ -2873,9 +2912,37 @@ int unregister_console(struct console *console)
 }
 EXPORT_SYMBOL(unregister_console);
 
+static int printk_kthread_func(void *data)
+{
+	bool pending;
+
+	set_user_nice(current, 10);
+	for (;;) {
+		set_current_state(TASK_INTERRUPTIBLE);
+		raw_spin_lock_irq(&logbuf_lock);
+		pending = console_seq != log_next_seq;
+		raw_spin_unlock_irq(&logbuf_lock);
+		if (!pending)
+			schedule();
+		__set_current_state(TASK_RUNNING);
+
+		/*
+		 * Same as a printk() caller: do not get preempted with
+		 * console_sem held, an oops on another cpu must be able to
+		 * take it and flush.
+		 */
+		console_lock();
+		preempt_disable();
+		console_unlock();
+		preempt_enable();
+	}
+	return 0;
+}
+
 static int __init printk_late_init(void)
 {
 	struct console *con;
+	struct task_struct *tsk;
 #ifdef CONFIG_MT_ENG_BUILD
 #ifdef CONFIG_LOG_TOO_MUCH_WARNING
 	struct proc_dir_entry *entry;
@@ -2887,6 +2954,12 @@ static int __init printk_late_init(void)
 		}
 	}
 	hotcpu_notifier(console_cpu_notify, 0);
+
+	tsk = kthread_run(printk_kthread_func, NULL, "printk");
+	if (IS_ERR(tsk))
+		pr_err("printk: failed to create printk thread, console output stays synchronous\n");
+	else
+		printk_kthread = tsk;
 #ifdef CONFIG_MT_ENG_BUILD
 #ifdef CONFIG_LOG_TOO_MUCH_WARNING
 	entry = proc_create("log_much", 0444, NULL, &log_much_ops);
@@ -2916,7 +2989,9 @@ static void wake_up_klogd_work_func(struct irq_work *irq_work)
 
 	if (pending & PRINTK_PENDING_OUTPUT) {
 		/* If trylock fails, someone else is doing the printing */
-		if (console_trylock())
+		if (printk_offload_console())
+			wake_up_process(printk_kthread);
+		else if (console_trylock())
 			console_unlock();
 	}
 
@@ -2929,6 +2929,30 @@ static int synchronize_sched_expedited_cpu_stop(void *data)
 	return 0;
 }
 
+/*
+ * Return the CPUs that synchronize_sched_expedited() needs to stop: the
+ * online CPUs minus those in dyntick-idle, which are in an extended
+ * quiescent state already and would only be woken up for nothing.  The
+ * current CPU is kept so that the mask is never empty.  Falls back to
+ * cpu_online_mask if there was no memory for @cm.
+ */
+static const struct cpumask *sync_sched_exp_cpus(struct cpumask *cm)
+{
+	int cpu;
+
+	if (!cm)
+		return cpu_online_mask;
+	cpumask_copy(cm, cpu_online_mask);
+	for_each_cpu(cpu, cm) {
+		struct rcu_dynticks *rdtp = &per_cpu(rcu_dynticks, cpu);
+
+		if (cpu != raw_smp_processor_id() &&
+		    !(atomic_add_return(0, &rdtp->dynticks) & 0x1))
+			cpumask_clear_cpu(cpu, cm);
+	}
+	return cm;
+}
+
 /**
  * synchronize_sched_expedited - Brute-force RCU-sched grace period
  *
@@ -2960,8 +2984,11 @@ static int synchronize_sched_expedited_cpu_stop(void *data)
  * doing our work for us.
  *
  * If we fail too many times in a row, we fall back to synchronize_sched().
+ *
+ * CPUs that are idle are not stopped, see sync_sched_exp_cpus(), so an
+ * expedited grace period does not wake up a sleeping cluster.
  */
-void synchronize_sched_expedited(void)
+static void __synchronize_sched_expedited(struct cpumask *cm)
 {
 	long firstsnap, s, snap;
 	int trycount = 0;
@@ -3001,7 +3028,7 @@ void synchronize_sched_expedited(void)
 	 * Each pass through the following loop attempts to force a
 	 * context switch on each CPU.
 	 */
-	while (try_stop_cpus(cpu_online_mask,
+	while (try_stop_cpus(sync_sched_exp_cpus(cm),
 			     synchronize_sched_expedited_cpu_stop,
 			     NULL) == -EAGAIN) {
 		put_online_cpus();
@@ -3072,6 +3099,16 @@ void synchronize_sched_expedited(void)
 
 	put_online_cpus();
 }
+
+void synchronize_sched_expedited(void)
+{
+	cpumask_var_t cm;
+	bool cma = zalloc_cpumask_var(&cm, GFP_KERNEL);
+
+	__synchronize_sched_expedited(cma ? cm : NULL);
+	if (cma)
+		free_cpumask_var(cm);
+}
 EXPORT_SYMBOL_GPL(synchronize_sched_expedited);
 
 /*
@@ -42,6 +42,9 @@
 #ifdef CONFIG_RCU_NOCB_CPU
 static cpumask_var_t rcu_nocb_mask; /* CPUs to have callbacks offloaded. */
 static bool have_rcu_nocb_mask;	    /* Was rcu_nocb_mask allocated? */
+#ifdef CONFIG_RCU_NOCB_CPU_HMP_SLOW
+extern struct cpumask hmp_slow_cpu_mask;
+#endif /* #ifdef CONFIG_RCU_NOCB_CPU_HMP_SLOW */
 static bool __read_mostly rcu_nocb_poll;    /* Offload kthread are to poll. */
 static char __initdata nocb_buf[NR_CPUS * 5];
 #endif /* #ifdef CONFIG_RCU_NOCB_CPU */
@@ -2584,6 +2587,11 @@ static void rcu_spawn_one_nocb_kthread(struct rcu_state *rsp, int cpu)
 	t = kthread_run(rcu_nocb_kthread, rdp_spawn,
 			"rcuo%c/%d", rsp->abbr, cpu);
 	BUG_ON(IS_ERR(t));
+#ifdef CONFIG_RCU_NOCB_CPU_HMP_SLOW
+	/* Invoke the offloaded callbacks on the little cluster. */
+	if (!cpumask_empty(&hmp_slow_cpu_mask))
+		set_cpus_allowed_ptr(t, &hmp_slow_cpu_mask);
+#endif /* #ifdef CONFIG_RCU_NOCB_CPU_HMP_SLOW */
 	ACCESS_ONCE(rdp_spawn->nocb_kthread) = t;
 }
 
@@ -658,18 +658,24 @@ int get_nohz_timer_target(int pinned)
 	int i;
 	struct sched_domain *sd;
 
-	if (pinned || !get_sysctl_timer_migration() || !idle_cpu(cpu))
+	if (pinned || !get_sysctl_timer_migration())
+		return cpu;
+	if (!idle_cpu(cpu) && is_housekeeping_cpu(cpu))
 		return cpu;
 
 	rcu_read_lock();
 	for_each_domain(cpu, sd) {
 		for_each_cpu(i, sched_domain_span(sd)) {
-			if (!idle_cpu(i)) {
+			if (!idle_cpu(i) && is_housekeeping_cpu(i)) {
 				cpu = i;
 				goto unlock;
 			}
 		}
 	}
+
+	/* keep unpinned timers off full dynticks cpus */
+	if (!is_housekeeping_cpu(cpu))
+		cpu = housekeeping_any_cpu();
 unlock:
 	rcu_read_unlock();
 	return cpu;
@@ -759,6 +765,11 @@ bool sched_can_stop_tick(void)
 	if (this_rq()->nr_running > 1)
 		return false;
 
+#ifdef CONFIG_SCHED_HMP
+	if (!hmp_can_stop_tick(this_rq()))
+		return false;
+#endif
+
 	return true;
 }
 #endif /* CONFIG_NO_HZ_FULL */
@@ -917,6 +928,7 @@ static void enqueue_task(struct rq *rq, struct task_struct *p, int flags)
 	update_rq_clock(rq);
 	sched_info_queued(rq, p);
 	p->sched_class->enqueue_task(rq, p, flags);
+	inc_cumulative_demand(rq, p);
 #ifdef CONFIG_MTK_SCHED_CMP_TGS
 	sched_tg_enqueue(rq, p);
 #endif
@@ -927,6 +939,7 @@ static void dequeue_task(struct rq *rq, struct task_struct *p, int flags)
 	update_rq_clock(rq);
 	sched_info_dequeued(rq, p);
 	p->sched_class->dequeue_task(rq, p, flags);
+	dec_cumulative_demand(rq, p);
 #ifdef CONFIG_MTK_SCHED_CMP_TGS
 	sched_tg_dequeue(rq, p);
 #endif
@@ -1489,6 +1502,46 @@ out:
 	return dest_cpu;
 }
 
+#ifdef CONFIG_CPU_ISOLATION
+/*
+ * An isolated cpu stays online, with its per-cpu state, timers and kthreads
+ * left alone and no cpu notifiers run, but takes no new tasks so it can
+ * sit in its deepest idle state. Un-isolating is just clearing its bit.
+ * Tasks that may only run on an isolated cpu (per-cpu kthreads) still
+ * run there.
+ */
+static DECLARE_BITMAP(cpu_isolate_bits, CONFIG_NR_CPUS) __read_mostly;
+const struct cpumask *const cpu_isolate_mask = to_cpumask(cpu_isolate_bits);
+EXPORT_SYMBOL(cpu_isolate_mask);
+
+static DEFINE_MUTEX(cpu_isolate_mutex);
+
+/*
+ * Pick an active, non-isolated cpu @p may run on: one sharing cache with
+ * @cpu first, then the shortest runqueue. Returns @cpu if there is none.
+ */
+static int select_unisolated_rq(int cpu, struct task_struct *p)
+{
+	unsigned int nr, best_nr = UINT_MAX;
+	int dest_cpu, best_cpu = cpu;
+
+	for_each_cpu_and(dest_cpu, cpu_active_mask, tsk_cpus_allowed(p)) {
+		if (cpu_isolated(dest_cpu))
+			continue;
+
+		nr = cpu_rq(dest_cpu)->nr_running;
+		if (!cpus_share_cache(cpu, dest_cpu))
+			nr += NR_CPUS;
+		if (nr < best_nr) {
+			best_nr = nr;
+			best_cpu = dest_cpu;
+		}
+	}
+
+	return best_cpu;
+}
+#endif
+
 /*
  * The caller (fork, wakeup) owns p->pi_lock, ->cpus_allowed is stable.
  */
@@ -1510,6 +1563,10 @@ int select_task_rq(struct task_struct *p, int cpu, int sd_flags, int wake_flags)
 	if (unlikely(!cpumask_test_cpu(cpu, tsk_cpus_allowed(p)) ||
 		     !cpu_online(cpu)))
 		cpu = select_fallback_rq(task_cpu(p), p);
+#ifdef CONFIG_CPU_ISOLATION
+	else if (unlikely(cpu_isolated(cpu)))
+		cpu = select_unisolated_rq(cpu, p);
+#endif
 
 	return cpu;
 }
@@ -1940,6 +1997,19 @@ static void __sched_fork(unsigned long clone_flags, struct task_struct *p)
 	p->se.avg.hmp_last_up_migration = 0;
 	p->se.avg.hmp_last_down_migration = 0;
 #endif /* CONFIG_SCHED_HMP */
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	p->uclamp_queued = 0;
+#endif
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+	memset(&p->ravg, 0, sizeof(p->ravg));
+#endif
+#ifdef CONFIG_MTPROF_CPUTIME
+	memset(p->mtk_opp_time, 0, sizeof(p->mtk_opp_time));
+#endif
+#ifdef CONFIG_MTPROF_PMU
+	memset(p->mtk_pmu, 0, sizeof(p->mtk_pmu));
+	p->mtk_pmu_membound = 0;
+#endif
 
 #ifdef CONFIG_SCHEDSTATS
 	memset(&p->se.statistics, 0, sizeof(p->se.statistics));
@@ -2055,6 +2125,9 @@ int sched_fork(unsigned long clone_flags, struct task_struct *p)
 
 		p->prio = p->normal_prio = __normal_prio(p);
 		set_load_weight(p);
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+		p->latency_sensitive = 0;
+#endif
 
 		/*
 		 * We don't need the reset flag anymore after the fork. It has
@@ -3630,6 +3703,9 @@ static int __sched_setscheduler(struct task_struct *p,
 	const struct sched_class *prev_class;
 	struct rq *rq;
 	int reset_on_fork;
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	int latency_sensitive;
+#endif
 
 	/* may grab non-irq protected spin_locks */
 	BUG_ON(in_interrupt());
@@ -3637,9 +3713,15 @@ recheck:
 	/* double check policy once rq lock held */
 	if (policy < 0) {
 		reset_on_fork = p->sched_reset_on_fork;
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+		latency_sensitive = p->latency_sensitive;
+#endif
 		policy = oldpolicy = p->policy;
 	} else {
 		reset_on_fork = !!(attr->sched_flags & SCHED_FLAG_RESET_ON_FORK);
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+		latency_sensitive = !!(attr->sched_flags & SCHED_FLAG_LATENCY_SENSITIVE);
+#endif
 
 		if (policy != SCHED_DEADLINE &&
 				policy != SCHED_FIFO && policy != SCHED_RR &&
@@ -3650,7 +3732,7 @@ recheck:
 		}
 	}
 
-	if (attr->sched_flags & ~(SCHED_FLAG_RESET_ON_FORK)) {
+	if (attr->sched_flags & ~(SCHED_FLAG_RESET_ON_FORK | SCHED_FLAG_LATENCY_SENSITIVE)) {
 		pr_warn("%s %d:%s sched_flags=%llu", __func__, p->pid, p->comm, attr->sched_flags);
 		return -EINVAL;
 	}
@@ -3727,6 +3809,14 @@ recheck:
 			}
 		}
 
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+		/* preferred placement is a privilege, like a negative nice */
+		if (latency_sensitive && !p->latency_sensitive) {
+			pr_warn("%s %d:%s latency_sensitive", __func__, p->pid, p->comm);
+			return -EPERM;
+		}
+#endif
+
 		/* can't change other user's priorities */
 		if (!check_same_owner(p)) {
 			pr_warn("%s %d:%s check_same_owner", __func__, p->pid, p->comm);
@@ -3777,6 +3867,9 @@ recheck:
 			goto change;
 
 		p->sched_reset_on_fork = reset_on_fork;
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+		p->latency_sensitive = latency_sensitive;
+#endif
 		task_rq_unlock(rq, p, &flags);
 		return 0;
 	}
@@ -3834,6 +3927,9 @@ change:
 	}
 
 	p->sched_reset_on_fork = reset_on_fork;
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	p->latency_sensitive = latency_sensitive;
+#endif
 	oldprio = p->prio;
 
 	/*
@@ -4237,6 +4333,10 @@ SYSCALL_DEFINE4(sched_getattr, pid_t, pid, struct sched_attr __user *, uattr,
 	attr.sched_policy = p->policy;
 	if (p->sched_reset_on_fork)
 		attr.sched_flags |= SCHED_FLAG_RESET_ON_FORK;
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	if (p->latency_sensitive)
+		attr.sched_flags |= SCHED_FLAG_LATENCY_SENSITIVE;
+#endif
 	if (task_has_dl_policy(p))
 		__getparam_dl(p, &attr);
 	else if (task_has_rt_policy(p))
@@ -5257,6 +5357,139 @@ static void migrate_tasks(unsigned int dead_cpu)
 
 #endif /* CONFIG_HOTPLUG_CPU */
 
+#ifdef CONFIG_CPU_ISOLATION
+static struct task_struct *cpu_isolate_pick_task(struct rq *rq, int *dest_cpu)
+{
+	int cpu = cpu_of(rq);
+	struct task_struct *p;
+
+	list_for_each_entry(p, &rq->cfs_tasks, se.group_node) {
+		if (p->nr_cpus_allowed == 1)
+			continue;
+		*dest_cpu = select_unisolated_rq(cpu, p);
+		if (*dest_cpu != cpu)
+			return p;
+	}
+
+	/* queued, not running rt tasks allowed on more than one cpu */
+	plist_for_each_entry(p, &rq->rt.pushable_tasks, pushable_tasks) {
+		*dest_cpu = select_unisolated_rq(cpu, p);
+		if (*dest_cpu != cpu)
+			return p;
+	}
+
+	return NULL;
+}
+
+/*
+ * Runs on the cpu being isolated and pushes its queued tasks away.
+ * Sleeping tasks get placed by select_task_rq() at their next wakeup.
+ */
+static int cpu_isolate_cpu_stop(void *data)
+{
+	int cpu = smp_processor_id();
+	struct rq *rq = cpu_rq(cpu);
+	struct task_struct *p;
+	int dest_cpu, nr;
+
+	local_irq_disable();
+	sched_ttwu_pending();
+
+	raw_spin_lock(&rq->lock);
+	for (nr = rq->nr_running; nr > 0; nr--) {
+		p = cpu_isolate_pick_task(rq, &dest_cpu);
+		if (!p)
+			break;
+
+		get_task_struct(p);
+		raw_spin_unlock(&rq->lock);
+
+		__migrate_task(p, cpu, dest_cpu);
+		put_task_struct(p);
+
+		raw_spin_lock(&rq->lock);
+	}
+	raw_spin_unlock(&rq->lock);
+	local_irq_enable();
+
+	return 0;
+}
+
+/*
+ * Make cpu_isolate_mask equal to @mask (offline cpus in @mask are ignored).
+ * Newly isolated cpus are emptied before this returns. At least one active
+ * cpu must stay un-isolated.
+ */
+int cpu_isolate_set(const struct cpumask *mask)
+{
+	cpumask_var_t tmp;
+	int cpu, ret = 0;
+
+	if (!alloc_cpumask_var(&tmp, GFP_KERNEL))
+		return -ENOMEM;
+
+	mutex_lock(&cpu_isolate_mutex);
+	get_online_cpus();
+
+	cpumask_andnot(tmp, cpu_active_mask, mask);
+	if (cpumask_empty(tmp)) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	cpumask_andnot(tmp, cpu_isolate_mask, mask);
+	for_each_cpu(cpu, tmp)
+		cpumask_clear_cpu(cpu, to_cpumask(cpu_isolate_bits));
+
+	cpumask_andnot(tmp, mask, cpu_isolate_mask);
+	cpumask_and(tmp, tmp, cpu_online_mask);
+	for_each_cpu(cpu, tmp) {
+		cpumask_set_cpu(cpu, to_cpumask(cpu_isolate_bits));
+		stop_one_cpu(cpu, cpu_isolate_cpu_stop, NULL);
+	}
+
+out:
+	put_online_cpus();
+	mutex_unlock(&cpu_isolate_mutex);
+	free_cpumask_var(tmp);
+
+	return ret;
+}
+EXPORT_SYMBOL(cpu_isolate_set);
+
+int cpu_up_by_mask(const struct cpumask *mask)
+{
+	int cpu, ret, err = 0;
+
+	for_each_cpu(cpu, mask) {
+		if (cpu_online(cpu))
+			continue;
+		ret = cpu_up(cpu);
+		if (ret)
+			err = ret;
+	}
+
+	return err;
+}
+EXPORT_SYMBOL(cpu_up_by_mask);
+
+int cpu_down_by_mask(const struct cpumask *mask)
+{
+	int cpu, ret, err = 0;
+
+	for_each_cpu(cpu, mask) {
+		if (!cpu_online(cpu))
+			continue;
+		ret = cpu_down(cpu);
+		if (ret)
+			err = ret;
+	}
+
+	return err;
+}
+EXPORT_SYMBOL(cpu_down_by_mask);
+#endif /* CONFIG_CPU_ISOLATION */
+
 #if defined(CONFIG_SCHED_DEBUG) && defined(CONFIG_SYSCTL)
 
 static struct ctl_table sd_ctl_dir[] = {
@@ -5560,6 +5793,10 @@ static int sched_cpu_inactive(struct notifier_block *nfb,
 	switch (action & ~CPU_TASKS_FROZEN) {
 	case CPU_DOWN_PREPARE:
 		set_cpu_active(cpu, false);
+#ifdef CONFIG_CPU_ISOLATION
+		/* an offline cpu comes back un-isolated */
+		cpumask_clear_cpu(cpu, to_cpumask(cpu_isolate_bits));
+#endif
 
 		/* explicitly allow suspend */
 		if (!(action & CPU_TASKS_FROZEN)) {
@@ -7339,6 +7576,10 @@ void __init sched_init(void)
 	INIT_LIST_HEAD(&root_task_group.children);
 	INIT_LIST_HEAD(&root_task_group.siblings);
 	autogroup_init(&init_task);
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	root_task_group.uclamp[UCLAMP_MIN] = 0;
+	root_task_group.uclamp[UCLAMP_MAX] = SCHED_CAPACITY_SCALE;
+#endif
 
 #endif /* CONFIG_CGROUP_SCHED */
 
@@ -7647,6 +7888,11 @@ struct task_group *sched_create_group(struct task_group *parent)
 	if (!tg)
 		return ERR_PTR(-ENOMEM);
 
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	tg->uclamp[UCLAMP_MIN] = 0;
+	tg->uclamp[UCLAMP_MAX] = SCHED_CAPACITY_SCALE;
+#endif
+
 	if (!alloc_fair_sched_group(tg, parent))
 		goto err;
 
@@ -8228,6 +8474,65 @@ static u64 cpu_shares_read_u64(struct cgroup_subsys_state *css,
 	return (u64) scale_load_down(tg->shares);
 }
 
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+static DEFINE_MUTEX(uclamp_mutex);
+
+/*
+ * Clamps are exposed as a percentage of the capacity of the biggest cpu.
+ * Tasks already enqueued keep the bucket they were accounted with until
+ * their next dequeue, so a new value takes effect on the next wakeup.
+ */
+static int cpu_uclamp_write(struct task_group *tg, int clamp_id, u64 pct)
+{
+	unsigned int value;
+	int ret = 0;
+
+	if (pct > 100)
+		return -EINVAL;
+
+	value = DIV_ROUND_UP((unsigned int)pct * SCHED_CAPACITY_SCALE, 100);
+
+	mutex_lock(&uclamp_mutex);
+	if ((clamp_id == UCLAMP_MIN && value > tg->uclamp[UCLAMP_MAX]) ||
+	    (clamp_id == UCLAMP_MAX && value < tg->uclamp[UCLAMP_MIN]))
+		ret = -EINVAL;
+	else
+		tg->uclamp[clamp_id] = value;
+	mutex_unlock(&uclamp_mutex);
+
+	return ret;
+}
+
+static u64 cpu_uclamp_read(struct task_group *tg, int clamp_id)
+{
+	return (u64)tg->uclamp[clamp_id] * 100 / SCHED_CAPACITY_SCALE;
+}
+
+static int cpu_uclamp_min_write_u64(struct cgroup_subsys_state *css,
+				    struct cftype *cftype, u64 pct)
+{
+	return cpu_uclamp_write(css_tg(css), UCLAMP_MIN, pct);
+}
+
+static u64 cpu_uclamp_min_read_u64(struct cgroup_subsys_state *css,
+				   struct cftype *cft)
+{
+	return cpu_uclamp_read(css_tg(css), UCLAMP_MIN);
+}
+
+static int cpu_uclamp_max_write_u64(struct cgroup_subsys_state *css,
+				    struct cftype *cftype, u64 pct)
+{
+	return cpu_uclamp_write(css_tg(css), UCLAMP_MAX, pct);
+}
+
+static u64 cpu_uclamp_max_read_u64(struct cgroup_subsys_state *css,
+				   struct cftype *cft)
+{
+	return cpu_uclamp_read(css_tg(css), UCLAMP_MAX);
+}
+#endif /* CONFIG_UCLAMP_TASK_GROUP */
+
 #ifdef CONFIG_CFS_BANDWIDTH
 static DEFINE_MUTEX(cfs_constraints_mutex);
 
@@ -8499,6 +8804,60 @@ static u64 cpu_rt_period_read_uint(struct cgroup_subsys_state *css,
 }
 #endif /* CONFIG_RT_GROUP_SCHED */
 
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+static int cpu_latency_sensitive_write_u64(struct cgroup_subsys_state *css,
+					   struct cftype *cftype, u64 val)
+{
+	if (val > 1)
+		return -EINVAL;
+
+	css_tg(css)->latency_sensitive = !!val;
+
+	return 0;
+}
+
+static u64 cpu_latency_sensitive_read_u64(struct cgroup_subsys_state *css,
+					  struct cftype *cft)
+{
+	return css_tg(css)->latency_sensitive;
+}
+#endif /* CONFIG_SCHED_LATENCY_SENSITIVE */
+
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+/*
+ * The I/O scheduler asks this when a request is allocated, so the
+ * foreground class follows whatever group (top-app) userspace flags.
+ */
+bool task_io_foreground(struct task_struct *p)
+{
+	bool fg;
+
+	rcu_read_lock();
+	fg = task_group(p)->io_foreground;
+	rcu_read_unlock();
+
+	return fg;
+}
+EXPORT_SYMBOL_GPL(task_io_foreground);
+
+static int cpu_io_foreground_write_u64(struct cgroup_subsys_state *css,
+				       struct cftype *cftype, u64 val)
+{
+	if (val > 1)
+		return -EINVAL;
+
+	css_tg(css)->io_foreground = !!val;
+
+	return 0;
+}
+
+static u64 cpu_io_foreground_read_u64(struct cgroup_subsys_state *css,
+				      struct cftype *cft)
+{
+	return css_tg(css)->io_foreground;
+}
+#endif /* CONFIG_IOSCHED_DEADLINE_FG */
+
 static struct cftype cpu_files[] = {
 #ifdef CONFIG_FAIR_GROUP_SCHED
 	{
@@ -8507,6 +8866,32 @@ static struct cftype cpu_files[] = {
 		.write_u64 = cpu_shares_write_u64,
 	},
 #endif
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	{
+		.name = "uclamp.min",
+		.read_u64 = cpu_uclamp_min_read_u64,
+		.write_u64 = cpu_uclamp_min_write_u64,
+	},
+	{
+		.name = "uclamp.max",
+		.read_u64 = cpu_uclamp_max_read_u64,
+		.write_u64 = cpu_uclamp_max_write_u64,
+	},
+#endif
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	{
+		.name = "latency_sensitive",
+		.read_u64 = cpu_latency_sensitive_read_u64,
+		.write_u64 = cpu_latency_sensitive_write_u64,
+	},
+#endif
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	{
+		.name = "io_foreground",
+		.read_u64 = cpu_io_foreground_read_u64,
+		.write_u64 = cpu_io_foreground_write_u64,
+	},
+#endif
 #ifdef CONFIG_CFS_BANDWIDTH
 	{
 		.name = "cfs_quota_us",
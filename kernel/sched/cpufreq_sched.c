@@ -0,0 +1,439 @@
+/*
+ *  Copyright (C)  2015 Michael Turquette <mturquette@linaro.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Scheduler-driven cpufreq governor.
+ *
+ * Instead of sampling cpu idle time from a deferrable timer, the fair
+ * class pushes a capacity request for a cpu every time its utilization
+ * changes (enqueue, dequeue and HMP up/down migration). The governor
+ * aggregates the requests of all cpus in a policy (one policy == one
+ * cluster on MT6755) and asks the cpufreq driver for the lowest OPP that
+ * satisfies the largest of them.
+ *
+ * Requests arrive with rq->lock held. If the driver can post a change
+ * without sleeping (policy->fast_switch_possible) it is called right away,
+ * otherwise the change is deferred to a per-policy SCHED_FIFO kthread
+ * through irq_work. Frequency changes of a cluster are rate limited by
+ * rate_limit_us either way.
+ */
+
+#include <linux/cpufreq.h>
+#include <linux/module.h>
+#include <linux/kthread.h>
+#include <linux/percpu.h>
+#include <linux/irq_work.h>
+#include <linux/delay.h>
+#include <linux/string.h>
+
+#include "sched.h"
+
+#define THROTTLE_NSEC		2000000 /* 2ms default */
+
+struct static_key __read_mostly __sched_freq = STATIC_KEY_INIT_FALSE;
+#ifndef CONFIG_CPU_FREQ_DEFAULT_GOV_SCHED
+static struct cpufreq_governor cpufreq_gov_sched;
+#endif
+
+static DEFINE_PER_CPU(unsigned long, enabled);
+static DEFINE_PER_CPU(unsigned long, capacity_req);
+
+/**
+ * gov_data - per-policy data internal to the governor
+ * @throttle: next throttling period expiry. Derived from throttle_nsec
+ * @throttle_nsec: throttle period length in nanoseconds
+ * @task: worker thread for dvfs transition that may block/sleep
+ * @irq_work: callback used to wake up worker thread
+ * @requested_freq: last frequency requested by the scheduler
+ * @applied_freq: last frequency handed to the driver, by either path
+ *
+ * struct gov_data is the per-policy cpufreq_sched-specific data structure. A
+ * per-policy instance of it is created when the cpufreq_sched governor
+ * receives the CPUFREQ_GOV_START condition and a pointer to it exists in the
+ * gov_data member of struct cpufreq_policy.
+ */
+struct gov_data {
+	ktime_t throttle;
+	unsigned int throttle_nsec;
+	struct task_struct *task;
+	struct irq_work irq_work;
+	unsigned int requested_freq;
+	unsigned int applied_freq;
+	struct cpufreq_policy *policy;
+};
+
+static DEFINE_PER_CPU(struct gov_data *, cpu_gov_data);
+
+static void cpufreq_sched_try_driver_target(struct cpufreq_policy *policy,
+					    unsigned int freq)
+{
+	struct gov_data *gd = policy->governor_data;
+
+	/* avoid race with cpufreq_sched_stop */
+	if (!down_write_trylock(&policy->rwsem))
+		return;
+
+	__cpufreq_driver_target(policy, freq, CPUFREQ_RELATION_L);
+
+	gd->throttle = ktime_add_ns(ktime_get(), gd->throttle_nsec);
+	up_write(&policy->rwsem);
+}
+
+static bool finish_last_request(struct gov_data *gd)
+{
+	ktime_t now = ktime_get();
+
+	if (ktime_after(now, gd->throttle))
+		return false;
+
+	while (1) {
+		int usec_left = ktime_to_ns(ktime_sub(gd->throttle, now));
+
+		usec_left /= NSEC_PER_USEC;
+		usleep_range(usec_left, usec_left + 100);
+		now = ktime_get();
+		if (ktime_after(now, gd->throttle))
+			return true;
+	}
+}
+
+/*
+ * we pass in struct cpufreq_policy. This is safe because changing out the
+ * policy requires a call to __cpufreq_governor(policy, CPUFREQ_GOV_STOP),
+ * which tears down all of the data structures and __cpufreq_governor(policy,
+ * CPUFREQ_GOV_START) will do a full rebuild, including this kthread with the
+ * new policy pointer
+ */
+static int cpufreq_sched_thread(void *data)
+{
+	struct sched_param param;
+	struct cpufreq_policy *policy;
+	struct gov_data *gd;
+	unsigned int new_request = 0;
+	int ret;
+
+	policy = (struct cpufreq_policy *) data;
+	gd = policy->governor_data;
+
+	param.sched_priority = 50;
+	ret = sched_setscheduler_nocheck(gd->task, SCHED_FIFO, &param);
+	if (ret) {
+		pr_warn("%s: failed to set SCHED_FIFO\n", __func__);
+		do_exit(-EINVAL);
+	} else {
+		pr_debug("%s: kthread (%d) set to SCHED_FIFO\n",
+				__func__, gd->task->pid);
+	}
+
+	do {
+		set_current_state(TASK_INTERRUPTIBLE);
+		new_request = gd->requested_freq;
+		if (new_request == gd->applied_freq) {
+			schedule();
+		} else {
+			/*
+			 * if the frequency thread sleeps while waiting to be
+			 * unthrottled, start over to check for a newer request
+			 */
+			if (finish_last_request(gd))
+				continue;
+			gd->applied_freq = new_request;
+			cpufreq_sched_try_driver_target(policy, new_request);
+		}
+	} while (!kthread_should_stop());
+
+	return 0;
+}
+
+static void cpufreq_sched_irq_work(struct irq_work *irq_work)
+{
+	struct gov_data *gd;
+
+	gd = container_of(irq_work, struct gov_data, irq_work);
+	wake_up_process(gd->task);
+}
+
+/*
+ * Post the request straight to the driver from scheduler context. Returns
+ * false when the kthread has to do it: throttled, or the driver could not
+ * take the request (e.g. its mutex-protected path is running).
+ */
+static bool cpufreq_sched_fast_switch(struct gov_data *gd, unsigned int freq)
+{
+	struct cpufreq_policy *policy = gd->policy;
+	ktime_t now;
+
+	if (!policy->fast_switch_possible)
+		return false;
+
+	now = ktime_get();
+	if (!ktime_after(now, gd->throttle))
+		return false;
+
+	freq = cpufreq_driver_fast_switch(policy, freq);
+	if (!freq)
+		return false;
+
+	policy->cur = freq;
+	gd->applied_freq = gd->requested_freq;
+	gd->throttle = ktime_add_ns(now, gd->throttle_nsec);
+
+	return true;
+}
+
+static void update_fdomain_capacity_request(int cpu)
+{
+	unsigned int freq_new, index_new, cpu_tmp;
+	struct cpufreq_frequency_table *table;
+	struct cpufreq_policy *policy;
+	struct gov_data *gd;
+	unsigned long capacity = 0;
+
+	gd = per_cpu(cpu_gov_data, cpu);
+	if (!gd)
+		return;
+	policy = gd->policy;
+
+	/* find max capacity requested by cpus in this policy */
+	for_each_cpu(cpu_tmp, policy->cpus)
+		capacity = max(capacity, per_cpu(capacity_req, cpu_tmp));
+
+	/*
+	 * Convert the new maximum capacity request into a cpu frequency.
+	 * Requests are normalized against the capacity of the cpu at its
+	 * highest OPP, so this is a plain linear scale of cpuinfo.max_freq.
+	 */
+	freq_new = capacity * policy->cpuinfo.max_freq >> SCHED_CAPACITY_SHIFT;
+	table = cpufreq_frequency_get_table(policy->cpu);
+	if (!table || cpufreq_frequency_table_target(policy, table, freq_new,
+						     CPUFREQ_RELATION_L,
+						     &index_new))
+		return;
+	freq_new = table[index_new].frequency;
+
+	if (freq_new == gd->requested_freq)
+		return;
+
+	gd->requested_freq = freq_new;
+
+	if (cpufreq_sched_fast_switch(gd, freq_new))
+		return;
+
+	/*
+	 * mt_cpufreq has to talk to the PMIC and may sleep, so the
+	 * transition is handed over to the kschedfreq thread.
+	 */
+	irq_work_queue_on(&gd->irq_work, cpu);
+}
+
+/**
+ * cpufreq_sched_set_cap - record a new capacity request for a cpu
+ * @cpu: cpu whose utilization changed
+ * @capacity: requested capacity, normalized to SCHED_CAPACITY_SCALE at the
+ *            highest OPP of @cpu
+ *
+ * Must be called with the rq->lock of @cpu held.
+ */
+void cpufreq_sched_set_cap(int cpu, unsigned long capacity)
+{
+	if (!per_cpu(enabled, cpu))
+		return;
+
+	if (capacity > SCHED_CAPACITY_SCALE)
+		capacity = SCHED_CAPACITY_SCALE;
+
+	if (per_cpu(capacity_req, cpu) == capacity)
+		return;
+
+	per_cpu(capacity_req, cpu) = capacity;
+	update_fdomain_capacity_request(cpu);
+}
+
+static inline void set_sched_freq(void)
+{
+	static_key_slow_inc(&__sched_freq);
+}
+
+static inline void clear_sched_freq(void)
+{
+	static_key_slow_dec(&__sched_freq);
+}
+
+static ssize_t show_rate_limit_us(struct cpufreq_policy *policy, char *buf)
+{
+	struct gov_data *gd = policy->governor_data;
+
+	return sprintf(buf, "%u\n", gd->throttle_nsec / NSEC_PER_USEC);
+}
+
+static ssize_t store_rate_limit_us(struct cpufreq_policy *policy,
+				   const char *buf, size_t count)
+{
+	struct gov_data *gd = policy->governor_data;
+	unsigned int val;
+	int ret;
+
+	ret = kstrtouint(buf, 0, &val);
+	if (ret < 0)
+		return ret;
+
+	gd->throttle_nsec = val * NSEC_PER_USEC;
+	return count;
+}
+
+static struct freq_attr sched_rate_limit_us =
+	__ATTR(rate_limit_us, 0644, show_rate_limit_us, store_rate_limit_us);
+
+static struct attribute *sched_attrs[] = {
+	&sched_rate_limit_us.attr,
+	NULL
+};
+
+static struct attribute_group sched_attr_group = {
+	.attrs = sched_attrs,
+	.name = "sched",
+};
+
+static int cpufreq_sched_policy_init(struct cpufreq_policy *policy)
+{
+	struct gov_data *gd;
+	int cpu;
+
+	for_each_cpu(cpu, policy->cpus)
+		per_cpu(capacity_req, cpu) = 0;
+
+	gd = kzalloc(sizeof(*gd), GFP_KERNEL);
+	if (!gd)
+		return -ENOMEM;
+
+	gd->throttle_nsec = policy->cpuinfo.transition_latency ?
+			    policy->cpuinfo.transition_latency :
+			    THROTTLE_NSEC;
+	gd->policy = policy;
+	pr_debug("%s: throttle threshold = %u [ns]\n",
+		  __func__, gd->throttle_nsec);
+
+	policy->governor_data = gd;
+
+	gd->task = kthread_create(cpufreq_sched_thread, policy,
+				  "kschedfreq:%d",
+				  cpumask_first(policy->related_cpus));
+	if (IS_ERR_OR_NULL(gd->task)) {
+		pr_err("%s: failed to create kschedfreq thread\n", __func__);
+		goto err;
+	}
+	get_task_struct(gd->task);
+	set_cpus_allowed_ptr(gd->task, policy->related_cpus);
+	init_irq_work(&gd->irq_work, cpufreq_sched_irq_work);
+	wake_up_process(gd->task);
+
+	if (sysfs_create_group(&policy->kobj, &sched_attr_group))
+		goto err_sysfs;
+
+	for_each_cpu(cpu, policy->cpus)
+		per_cpu(cpu_gov_data, cpu) = gd;
+
+	set_sched_freq();
+
+	return 0;
+
+err_sysfs:
+	kthread_stop(gd->task);
+	put_task_struct(gd->task);
+err:
+	policy->governor_data = NULL;
+	kfree(gd);
+	return -ENOMEM;
+}
+
+static int cpufreq_sched_policy_exit(struct cpufreq_policy *policy)
+{
+	struct gov_data *gd = policy->governor_data;
+	int cpu;
+
+	clear_sched_freq();
+
+	for_each_cpu(cpu, policy->cpus)
+		per_cpu(cpu_gov_data, cpu) = NULL;
+
+	sysfs_remove_group(&policy->kobj, &sched_attr_group);
+
+	kthread_stop(gd->task);
+	put_task_struct(gd->task);
+
+	policy->governor_data = NULL;
+
+	kfree(gd);
+	return 0;
+}
+
+static int cpufreq_sched_start(struct cpufreq_policy *policy)
+{
+	int cpu;
+
+	for_each_cpu(cpu, policy->cpus)
+		per_cpu(enabled, cpu) = 1;
+
+	return 0;
+}
+
+static int cpufreq_sched_stop(struct cpufreq_policy *policy)
+{
+	int cpu;
+
+	for_each_cpu(cpu, policy->cpus)
+		per_cpu(enabled, cpu) = 0;
+
+	/* make sure no scheduler path still holds a reference to gov_data */
+	synchronize_sched();
+
+	return 0;
+}
+
+static int cpufreq_sched_setup(struct cpufreq_policy *policy,
+			       unsigned int event)
+{
+	switch (event) {
+	case CPUFREQ_GOV_POLICY_INIT:
+		return cpufreq_sched_policy_init(policy);
+	case CPUFREQ_GOV_POLICY_EXIT:
+		return cpufreq_sched_policy_exit(policy);
+	case CPUFREQ_GOV_START:
+		return cpufreq_sched_start(policy);
+	case CPUFREQ_GOV_STOP:
+		return cpufreq_sched_stop(policy);
+	case CPUFREQ_GOV_LIMITS:
+		if (policy->max < policy->cur)
+			__cpufreq_driver_target(policy, policy->max,
+						CPUFREQ_RELATION_H);
+		else if (policy->min > policy->cur)
+			__cpufreq_driver_target(policy, policy->min,
+						CPUFREQ_RELATION_L);
+		break;
+	}
+	return 0;
+}
+
+#ifndef CONFIG_CPU_FREQ_DEFAULT_GOV_SCHED
+static
+#endif
+struct cpufreq_governor cpufreq_gov_sched = {
+	.name			= "sched",
+	.governor		= cpufreq_sched_setup,
+	.owner			= THIS_MODULE,
+};
+
+static int __init cpufreq_sched_init(void)
+{
+	int cpu;
+
+	for_each_cpu(cpu, cpu_possible_mask)
+		per_cpu(enabled, cpu) = 0;
+	return cpufreq_register_governor(&cpufreq_gov_sched);
+}
+
+/* Try to make this the default governor */
+fs_initcall(cpufreq_sched_init);
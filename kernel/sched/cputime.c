@@ -6,6 +6,7 @@
 #include <linux/static_key.h>
 #include <linux/context_tracking.h>
 #include "sched.h"
+#include "mt_cputime.h"
 
 
 #ifdef CONFIG_IRQ_TIME_ACCOUNTING
@@ -155,6 +156,7 @@ void account_user_time(struct task_struct *p, cputime_t cputime,
 	/* Account power usage for user time */
 	acct_update_power(p, cputime);
 #endif
+	mt_cputime_opp_account(p, cputime);
 }
 
 /*
@@ -210,6 +212,7 @@ void __account_system_time(struct task_struct *p, cputime_t cputime,
 	/* Account power usage for system time */
 	acct_update_power(p, cputime);
 #endif
+	mt_cputime_opp_account(p, cputime);
 }
 
 /*
@@ -0,0 +1,142 @@
+/*
+ * Window based per-task demand.
+ *
+ * Run time of a task is accumulated per sched_ravg_window, scaled by the
+ * current capacity of the cpu it ran on, and the last RAVG_HIST_SIZE
+ * windows are kept in the task. Its demand is the larger of the newest
+ * window and the average of all of them, so a task ramping up is seen
+ * within one window while a bursty one is not forgotten at once.
+ *
+ * Windows are aligned to multiples of sched_ravg_window of rq->clock on
+ * every cpu, a task rolls its history over when it is next accounted.
+ * rq->cumulative_demand sums the demand of the queued tasks and is what
+ * the hotplug strategy and the cpufreq governor consume.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/math64.h>
+
+#include "sched.h"
+
+#define MIN_SCHED_RAVG_WINDOW	(8 * NSEC_PER_MSEC)
+#define MAX_SCHED_RAVG_WINDOW	(100 * NSEC_PER_MSEC)
+
+unsigned int sched_ravg_window = 20 * NSEC_PER_MSEC;
+
+static int __init set_sched_ravg_window(char *str)
+{
+	unsigned int window;
+
+	if (get_option(&str, &window) && window >= MIN_SCHED_RAVG_WINDOW &&
+	    window <= MAX_SCHED_RAVG_WINDOW)
+		sched_ravg_window = window;
+
+	return 0;
+}
+early_param("sched_ravg_window", set_sched_ravg_window);
+
+static inline void update_rq_window(struct rq *rq)
+{
+	u64 now = rq_clock(rq);
+	u64 nr_windows;
+
+	if (now < rq->window_start + sched_ravg_window)
+		return;
+
+	nr_windows = div64_u64(now - rq->window_start, sched_ravg_window);
+	rq->window_start += nr_windows * sched_ravg_window;
+}
+
+static void rollover_task_window(struct task_struct *p, u64 window_start)
+{
+	struct ravg *ra = &p->ravg;
+	u32 *hist = ra->sum_history;
+	u64 nr_windows;
+	u32 sum = 0;
+	int i, shift;
+
+	nr_windows = div64_u64(window_start - ra->window_start, sched_ravg_window);
+	ra->window_start = window_start;
+	if (!nr_windows)
+		return;
+
+	shift = min_t(u64, nr_windows, RAVG_HIST_SIZE);
+	for (i = RAVG_HIST_SIZE - 1; i >= shift; i--)
+		hist[i] = hist[i - shift];
+	/* the window just closed, then empty ones up to now */
+	hist[shift - 1] = nr_windows > RAVG_HIST_SIZE ? 0 : ra->curr_window;
+	for (i = 0; i < shift - 1; i++)
+		hist[i] = 0;
+	ra->curr_window = 0;
+
+	for (i = 0; i < RAVG_HIST_SIZE; i++)
+		sum += hist[i];
+
+	ra->demand = div_u64((u64)max(hist[0], sum / RAVG_HIST_SIZE)
+			     << SCHED_CAPACITY_SHIFT, sched_ravg_window);
+}
+
+static void task_demand_changed(struct rq *rq, struct task_struct *p)
+{
+	struct ravg *ra = &p->ravg;
+
+	if (!ra->queued)
+		return;
+
+	rq->cumulative_demand += ra->demand;
+	rq->cumulative_demand -= ra->rq_demand;
+	ra->rq_demand = ra->demand;
+}
+
+/*
+ * Account @delta ns of run time of @p on @rq, called with rq->lock held
+ * from the update_curr() of the cfs and rt classes.
+ */
+void update_task_demand(struct rq *rq, struct task_struct *p, u64 delta)
+{
+	struct ravg *ra = &p->ravg;
+	int cpu = cpu_of(rq);
+	unsigned long cap;
+	u64 scaled;
+
+	update_rq_window(rq);
+	if (ra->window_start < rq->window_start) {
+		rollover_task_window(p, rq->window_start);
+		task_demand_changed(rq, p);
+	}
+
+	cap = rq->cpu_capacity_orig * arch_scale_freq_capacity(NULL, cpu)
+	      >> SCHED_CAPACITY_SHIFT;
+	scaled = (delta * cap) >> SCHED_CAPACITY_SHIFT;
+	ra->curr_window = min_t(u64, ra->curr_window + scaled, sched_ravg_window);
+}
+
+void inc_cumulative_demand(struct rq *rq, struct task_struct *p)
+{
+	struct ravg *ra = &p->ravg;
+
+	if (ra->queued)
+		return;
+
+	/* let a task that slept for long decay before it counts again */
+	update_rq_window(rq);
+	if (ra->window_start < rq->window_start)
+		rollover_task_window(p, rq->window_start);
+
+	ra->rq_demand = ra->demand;
+	rq->cumulative_demand += ra->rq_demand;
+	ra->queued = 1;
+}
+
+void dec_cumulative_demand(struct rq *rq, struct task_struct *p)
+{
+	struct ravg *ra = &p->ravg;
+
+	if (!ra->queued)
+		return;
+
+	rq->cumulative_demand -= ra->rq_demand;
+	ra->rq_demand = 0;
+	ra->queued = 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Per-cluster energy model used by energy-aware wakeup placement.
+ *
+ * The model is provided at runtime by the platform cpufreq driver (on
+ * MT6755 mt_cpufreq.c builds it from its OPP tables and the static power
+ * tables of mt_static_power.c) once the OPP table of a cluster is known.
+ * Readers in the wakeup path never block: the model of a cluster is
+ * published once with rcu_assign_pointer() and replaced copy-on-update.
+ */
+
+#include <linux/slab.h>
+#include <linux/rcupdate.h>
+#include <linux/sched/energy.h>
+
+#include "sched.h"
+
+static struct cluster_energy __rcu *cluster_energy[NR_CPUS];
+static DEFINE_MUTEX(cluster_energy_lock);
+
+const struct cluster_energy *sched_cluster_energy(int cluster)
+{
+	if (cluster < 0 || cluster >= NR_CPUS)
+		return NULL;
+
+	return rcu_dereference_sched(cluster_energy[cluster]);
+}
+
+int sched_energy_register(int cluster, const struct cpumask *cpus,
+			  const struct capacity_state *states,
+			  int nr_states, unsigned long idle_power)
+{
+	struct cluster_energy *ce, *old;
+	int i;
+
+	if (cluster < 0 || cluster >= NR_CPUS)
+		return -EINVAL;
+	if (nr_states <= 0 || nr_states > SCHED_ENERGY_MAX_CAP_STATES)
+		return -EINVAL;
+
+	/* cap_states[] must be sorted by ascending capacity */
+	for (i = 1; i < nr_states; i++)
+		if (states[i].cap < states[i - 1].cap)
+			return -EINVAL;
+
+	ce = kzalloc(sizeof(*ce), GFP_KERNEL);
+	if (!ce)
+		return -ENOMEM;
+
+	cpumask_copy(&ce->cpus, cpus);
+	ce->nr_cap_states = nr_states;
+	memcpy(ce->cap_states, states, nr_states * sizeof(*states));
+	ce->idle_power = idle_power;
+
+	mutex_lock(&cluster_energy_lock);
+	old = rcu_dereference_protected(cluster_energy[cluster],
+					lockdep_is_held(&cluster_energy_lock));
+	rcu_assign_pointer(cluster_energy[cluster], ce);
+	mutex_unlock(&cluster_energy_lock);
+
+	if (old) {
+		synchronize_sched();
+		kfree(old);
+	}
+
+	pr_info("sched: energy model of cluster %d: %d cap states, idle %lu uW\n",
+		cluster, nr_states, idle_power);
+
+	return 0;
+}
+EXPORT_SYMBOL(sched_energy_register);
@@ -31,6 +31,7 @@
 #include <linux/migrate.h>
 #include <linux/task_work.h>
 #include <linux/stop_machine.h>
+#include <linux/sched/energy.h>
 
 #include <trace/events/sched.h>
 #ifdef CONFIG_HMP_FREQUENCY_INVARIANT_SCALE
@@ -41,6 +42,12 @@
 #endif /* CONFIG_HMP_FREQUENCY_INVARIANT_SCALE */
 
 #include "sched.h"
+#ifdef CONFIG_MTPROF
+#include "mt_sched_mon.h"
+#endif
+#ifdef CONFIG_MTPROF_PMU
+#include "mt_pmu.h"
+#endif
 
 /*
  * Targeted preemption latency for CPU-bound tasks:
@@ -833,6 +840,7 @@ static void update_curr(struct cfs_rq *cfs_rq)
 		trace_sched_stat_runtime(curtask, delta_exec, curr->vruntime);
 		cpuacct_charge(curtask, delta_exec);
 		account_group_exec_runtime(curtask, delta_exec);
+		update_task_demand(rq_of(cfs_rq), curtask, delta_exec);
 	}
 
 	account_cfs_rq_runtime(cfs_rq, delta_exec);
@@ -4449,6 +4457,8 @@ static void sched_tg_dequeue_fair(struct rq *rq, struct task_struct *p)
 #define HMP_SELECT_RQ (0x2000)
 #define HMP_LB (0x4000)
 #define HMP_MAX_LOAD (NICE_0_LOAD - 1)
+/* same as the heavy task threshold of rq_stats */
+#define HMP_EVENT_HEAVY_LOAD (650)
 
 /*
  * Returns the current capacity of cpu after applying both
@@ -4657,6 +4667,35 @@ static void hmp_offline_cpu(int cpu)
 		cpumask_clear_cpu(cpu, &domain->cpus);
 }
 
+/*
+ * Per-cluster idle cpu cache, updated by the idle class under rq->lock when
+ * a cpu switches to and away from its idle task. It lets the HMP migration
+ * paths skip idle cpus without taking their rq->lock, and find an idle cpu
+ * of a cluster without probing every rq. A set bit may be stale by a
+ * wakeup that has not switched the cpu away from idle yet, so users that
+ * need a really empty rq still check it.
+ */
+void hmp_idle_enter(int cpu)
+{
+	struct hmp_domain *domain = hmp_cpu_domain(cpu);
+
+	if (domain)
+		cpumask_set_cpu(cpu, &domain->idle_cpus);
+}
+
+void hmp_idle_exit(int cpu)
+{
+	struct hmp_domain *domain = hmp_cpu_domain(cpu);
+
+	if (domain)
+		cpumask_clear_cpu(cpu, &domain->idle_cpus);
+}
+
+static inline bool hmp_cpu_idle_cached(int cpu)
+{
+	return cpumask_test_cpu(cpu, &hmp_cpu_domain(cpu)->idle_cpus);
+}
+
 unsigned int hmp_next_up_threshold = 4096;
 unsigned int hmp_next_down_threshold = 4096;
 #define hmp_last_up_migration(cpu) \
@@ -4775,6 +4814,101 @@ static void hmp_offline_cpu(int cpu) {}
 #endif /* CONFIG_SCHED_HMP */
 
 
+#ifdef CONFIG_CPU_FREQ_GOV_SCHED
+static void update_capacity_of(int cpu);
+#else
+static inline void update_capacity_of(int cpu) { }
+#endif
+
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+static inline unsigned int uclamp_task(struct task_struct *p, int clamp_id)
+{
+	return task_group(p)->uclamp[clamp_id];
+}
+
+/*
+ * Account @p in the clamp buckets of @rq. The bucket is remembered in the
+ * task so that the dequeue drops the same one even if the group clamps
+ * were changed meanwhile.
+ */
+static inline void uclamp_rq_inc(struct rq *rq, struct task_struct *p)
+{
+	unsigned int id;
+	int clamp_id;
+
+	if (p->uclamp_queued)
+		return;
+
+	for (clamp_id = 0; clamp_id < UCLAMP_CNT; clamp_id++) {
+		id = uclamp_bucket_id(uclamp_task(p, clamp_id));
+		p->uclamp_bucket[clamp_id] = id;
+		rq->uclamp_tasks[clamp_id][id]++;
+	}
+	p->uclamp_queued = 1;
+}
+
+static inline void uclamp_rq_dec(struct rq *rq, struct task_struct *p)
+{
+	int clamp_id;
+
+	if (!p->uclamp_queued)
+		return;
+
+	for (clamp_id = 0; clamp_id < UCLAMP_CNT; clamp_id++)
+		rq->uclamp_tasks[clamp_id][p->uclamp_bucket[clamp_id]]--;
+	p->uclamp_queued = 0;
+}
+
+/* max aggregation: the highest bucket with enqueued tasks wins */
+static unsigned int uclamp_rq_value(struct rq *rq, int clamp_id)
+{
+	int id;
+
+	for (id = UCLAMP_BUCKETS - 1; id >= 0; id--)
+		if (rq->uclamp_tasks[clamp_id][id])
+			return uclamp_bucket_value(id);
+
+	return clamp_id == UCLAMP_MIN ? 0 : SCHED_CAPACITY_SCALE;
+}
+
+/*
+ * Clamp a utilization by [min, max]. A boost always wins over a cap so a
+ * boosted task is never slowed down by a capped one sharing its cpu.
+ */
+static inline unsigned long uclamp_value(unsigned long util,
+					 unsigned int min, unsigned int max)
+{
+	return max_t(unsigned long, min_t(unsigned long, util, max), min);
+}
+
+static inline unsigned long uclamp_rq_util(struct rq *rq, unsigned long util)
+{
+	return uclamp_value(util, uclamp_rq_value(rq, UCLAMP_MIN),
+			    uclamp_rq_value(rq, UCLAMP_MAX));
+}
+
+static inline unsigned long uclamp_task_util(struct task_struct *p,
+					     unsigned long util)
+{
+	return uclamp_value(util, uclamp_task(p, UCLAMP_MIN),
+			    uclamp_task(p, UCLAMP_MAX));
+}
+#else
+static inline void uclamp_rq_inc(struct rq *rq, struct task_struct *p) { }
+static inline void uclamp_rq_dec(struct rq *rq, struct task_struct *p) { }
+
+static inline unsigned long uclamp_rq_util(struct rq *rq, unsigned long util)
+{
+	return util;
+}
+
+static inline unsigned long uclamp_task_util(struct task_struct *p,
+					     unsigned long util)
+{
+	return util;
+}
+#endif /* CONFIG_UCLAMP_TASK_GROUP */
+
 /*
  * The enqueue_task method is called before nr_running is
  * increased. Here we update the fair scheduling stats and
@@ -4786,6 +4920,8 @@ enqueue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 	struct cfs_rq *cfs_rq;
 	struct sched_entity *se = &p->se;
 
+	uclamp_rq_inc(rq, p);
+
 	for_each_sched_entity(se) {
 		if (se->on_rq)
 			break;
@@ -4822,6 +4958,7 @@ enqueue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 #ifndef CONFIG_CFS_BANDWIDTH
 		BUG_ON(rq->cfs.nr_running > rq->cfs.h_nr_running);
 #endif
+		update_capacity_of(cpu_of(rq));
 	}
 	hrtick_update(rq);
 #ifdef CONFIG_MTK_SCHED_CMP_TGS
@@ -4846,6 +4983,8 @@ static void dequeue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 	struct sched_entity *se = &p->se;
 	int task_sleep = flags & DEQUEUE_SLEEP;
 
+	uclamp_rq_dec(rq, p);
+
 	for_each_sched_entity(se) {
 		cfs_rq = cfs_rq_of(se);
 		dequeue_entity(cfs_rq, se, flags);
@@ -4893,6 +5032,7 @@ static void dequeue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 		BUG_ON(rq->cfs.nr_running > rq->cfs.h_nr_running);
 #endif
 		update_rq_runnable_avg(rq, 1);
+		update_capacity_of(cpu_of(rq));
 	}
 	hrtick_update(rq);
 #ifdef CONFIG_MTK_SCHED_CMP_TGS
@@ -5567,6 +5707,86 @@ static int mt_select_task_rq_fair(struct task_struct *p, int prev_cpu)
  *
  * preempt must be disabled.
  */
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+static int energy_aware_wake_cpu(struct task_struct *p, int prev_cpu);
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+/*
+ * Wakeup placement of a latency sensitive task, refining the @target cpu
+ * picked by the regular (HMP) selection: prefer the idle cpu of target's
+ * cluster in the shallowest idle state (ties go to @target, then to the
+ * most recently idled cpu for a warmer cache), then an idle cpu of any
+ * other cluster, and with no idle cpu at all the cpu of the cluster whose
+ * running task carries the least load, instead of queueing behind a heavy
+ * one.
+ */
+static int latency_sensitive_wake_cpu(struct task_struct *p, int target)
+{
+	const struct cpumask *cluster = cpu_possible_mask;
+	unsigned int exit_latency, min_exit_latency = UINT_MAX;
+	unsigned long load, min_load = ULONG_MAX;
+	u64 latest_idle_timestamp = 0;
+	int idle_cpu_found = -1, other_idle_cpu = -1, busy_cpu = target;
+	struct task_struct *curr;
+	struct cpuidle_state *idle;
+	struct rq *rq;
+	int i;
+
+#ifdef CONFIG_SCHED_HMP
+	cluster = &hmp_cpu_domain(target)->cpus;
+#endif
+
+	rcu_read_lock();
+	for_each_cpu_and(i, tsk_cpus_allowed(p), cpu_active_mask) {
+		if (cpu_isolated(i))
+			continue;
+
+		rq = cpu_rq(i);
+		if (idle_cpu(i)) {
+			if (!cpumask_test_cpu(i, cluster)) {
+				if (other_idle_cpu == -1)
+					other_idle_cpu = i;
+				continue;
+			}
+
+			idle = idle_get_state(rq);
+			exit_latency = idle ? idle->exit_latency : 0;
+			if (exit_latency < min_exit_latency ||
+			    (exit_latency == min_exit_latency && i == target) ||
+			    (exit_latency == min_exit_latency && idle_cpu_found != target &&
+			     rq->idle_stamp > latest_idle_timestamp)) {
+				min_exit_latency = exit_latency;
+				latest_idle_timestamp = rq->idle_stamp;
+				idle_cpu_found = i;
+			}
+			continue;
+		}
+
+		if (idle_cpu_found != -1 || !cpumask_test_cpu(i, cluster))
+			continue;
+
+		/* an RT task in the way is worse than any fair one */
+		curr = ACCESS_ONCE(rq->curr);
+		if (curr->sched_class != &fair_sched_class)
+			load = ULONG_MAX - 1;
+		else
+			load = curr->se.avg.load_avg_contrib + weighted_cpuload(i);
+		if (load < min_load || (load == min_load && i == target)) {
+			min_load = load;
+			busy_cpu = i;
+		}
+	}
+	rcu_read_unlock();
+
+	if (idle_cpu_found != -1)
+		return idle_cpu_found;
+	if (other_idle_cpu != -1)
+		return other_idle_cpu;
+	return busy_cpu;
+}
+#endif /* CONFIG_SCHED_LATENCY_SENSITIVE */
+
 static int
 select_task_rq_fair(struct task_struct *p, int prev_cpu, int sd_flag, int wake_flags)
 {
@@ -5586,8 +5806,22 @@ select_task_rq_fair(struct task_struct *p, int prev_cpu, int sd_flag, int wake_f
 		return prev_cpu;
 	}
 
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+	if (sched_feat(ENERGY_AWARE) && (sd_flag & SD_BALANCE_WAKE) &&
+	    !task_latency_sensitive(p)) {
+		new_cpu = energy_aware_wake_cpu(p, prev_cpu);
+		if (new_cpu < nr_cpu_ids) {
+#ifdef CONFIG_MTK_SCHED_TRACERS
+			trace_sched_select_task_rq(p, policy, prev_cpu, new_cpu);
+#endif
+			return new_cpu;
+		}
+		new_cpu = cpu;
+	}
+#endif
+
 #ifdef CONFIG_HMP_PACK_SMALL_TASK
-	if (check_pack_buddy(cpu, p))
+	if (!task_latency_sensitive(p) && check_pack_buddy(cpu, p))
 		return per_cpu(sd_pack_buddy, cpu);
 #endif /* CONFIG_HMP_PACK_SMALL_TASK */
 
@@ -5740,6 +5974,10 @@ mt_found:
 		policy |= LB_HMP;
 #endif
 	}
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	if ((sd_flag & SD_BALANCE_WAKE) && task_latency_sensitive(p))
+		new_cpu = latency_sensitive_wake_cpu(p, new_cpu);
+#endif
 #ifdef CONFIG_MTK_SCHED_TRACERS
 	trace_sched_select_task_rq(p, policy, prev_cpu, new_cpu);
 #endif
@@ -5775,6 +6013,155 @@ static int get_cpu_usage(int cpu)
 	return usage + blocked;
 }
 
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+/*
+ * Capacity margin a task must leave on a cpu to be placed there by the
+ * energy-aware path: util * capacity_margin <= capacity * 1024, i.e. the
+ * cpu must stay below ~80% of its capacity_orig.
+ */
+static unsigned int capacity_margin = 1280;
+
+static inline unsigned long task_util(struct task_struct *p)
+{
+	return p->se.avg.utilization_avg_contrib;
+}
+
+/* usage of @cpu with the contribution of @p removed */
+static unsigned long cpu_usage_wo(int cpu, struct task_struct *p)
+{
+	unsigned long usage = get_cpu_usage(cpu);
+
+	if (task_cpu(p) != cpu)
+		return usage;
+
+	return usage > task_util(p) ? usage - task_util(p) : 0;
+}
+
+/*
+ * Estimated power of cluster @ce when @p is placed on @dst_cpu (or on no
+ * cpu of the cluster, if @dst_cpu is outside of it). The cluster runs at
+ * the lowest OPP that covers its busiest cpu; every cpu is busy for
+ * usage/cap of the time at that OPP's power and idle for the rest.
+ */
+static unsigned long cluster_energy_of(const struct cluster_energy *ce,
+				       struct task_struct *p, int dst_cpu)
+{
+	const struct capacity_state *cs;
+	unsigned long usage, max_usage = 0, sum_usage = 0;
+	unsigned long busy, idle, nr_cpus = 0;
+	int cpu, idx;
+
+	for_each_cpu_and(cpu, &ce->cpus, cpu_online_mask) {
+		usage = cpu_usage_wo(cpu, p);
+		if (cpu == dst_cpu)
+			usage += task_util(p);
+		usage = min(usage, capacity_orig_of(cpu));
+
+		max_usage = max(max_usage, usage);
+		sum_usage += usage;
+		nr_cpus++;
+	}
+
+	if (!nr_cpus)
+		return 0;
+
+	for (idx = 0; idx < ce->nr_cap_states - 1; idx++)
+		if (ce->cap_states[idx].cap >= max_usage)
+			break;
+	cs = &ce->cap_states[idx];
+
+	sum_usage = min(sum_usage, nr_cpus * cs->cap);
+	busy = sum_usage * cs->power / cs->cap;
+	idle = (nr_cpus * cs->cap - sum_usage) * ce->idle_power / cs->cap;
+
+	return busy + idle;
+}
+
+/*
+ * energy_aware_wake_cpu - pick the cpu that minimizes the estimated system
+ * energy for waking task @p, among the cpus the task fits on with
+ * capacity_margin headroom. Only the cluster gaining the task changes its
+ * cost between candidates, so the energy delta of each candidate is its
+ * cluster's cost with the task minus without it. Ties go to @prev_cpu to
+ * keep cache affinity, then to the cpu with the lowest usage.
+ *
+ * Returns nr_cpu_ids when no energy model is registered or the task fits
+ * nowhere, in which case the regular HMP selection is used.
+ */
+static int energy_aware_wake_cpu(struct task_struct *p, int prev_cpu)
+{
+	const struct cluster_energy *ce;
+	unsigned long util = task_util(p);
+	unsigned long base, energy, delta, best_delta = ULONG_MAX;
+	unsigned long usage, best_usage = ULONG_MAX;
+	int cluster, cpu, best_cpu = nr_cpu_ids;
+
+	rcu_read_lock_sched();
+	for (cluster = 0; cluster < arch_get_nr_clusters(); cluster++) {
+		ce = sched_cluster_energy(cluster);
+		if (!ce) {
+			best_cpu = nr_cpu_ids;
+			break;
+		}
+
+		base = cluster_energy_of(ce, p, -1);
+
+		for_each_cpu_and(cpu, &ce->cpus, tsk_cpus_allowed(p)) {
+			if (!cpu_online(cpu) || cpu_park(cpu))
+				continue;
+
+			usage = cpu_usage_wo(cpu, p) + util;
+			if (usage * capacity_margin >
+			    capacity_orig_of(cpu) * SCHED_CAPACITY_SCALE)
+				continue;
+
+			energy = cluster_energy_of(ce, p, cpu);
+			delta = energy > base ? energy - base : 0;
+			if (delta < best_delta ||
+			    (delta == best_delta &&
+			     (cpu == prev_cpu ||
+			      (best_cpu != prev_cpu && usage < best_usage)))) {
+				best_delta = delta;
+				best_usage = usage;
+				best_cpu = cpu;
+			}
+		}
+	}
+	rcu_read_unlock_sched();
+
+	mt_sched_printf(sched_log, "eas wakeup %d %s cpu=%d delta=%lu util=%lu",
+			p->pid, p->comm, best_cpu, best_delta, util);
+
+	return best_cpu;
+}
+#endif /* CONFIG_SCHED_ENERGY_MODEL */
+
+#ifdef CONFIG_CPU_FREQ_GOV_SCHED
+/*
+ * update_capacity_of - push the utilization of @cpu to the sched governor.
+ *
+ * Called from enqueue/dequeue (which also covers HMP up/down migrations,
+ * since those go through move_specific_task) and from the tick. The usage
+ * is frequency invariant, so it is normalized against the capacity of the
+ * cpu at its highest OPP and padded with capacity_margin_freq. The usage is
+ * first clamped by the utilization clamps of the tasks enqueued on the cpu.
+ */
+static void update_capacity_of(int cpu)
+{
+	unsigned long usage, req;
+
+	if (!sched_freq())
+		return;
+
+	usage = get_cpu_usage(cpu);
+	/* a single heavy task may drive the ramp on its own */
+	usage = max(usage, min(cpu_demand(cpu), capacity_orig_of(cpu)));
+	usage = uclamp_rq_util(cpu_rq(cpu), usage);
+	req = usage * capacity_margin_freq / capacity_orig_of(cpu);
+	cpufreq_sched_set_cap(cpu, req);
+}
+#endif
+
 /*
  * Called immediately before a task is migrated to a new cpu; task_cpu(p) and
  * cfs_rq_of(p) references at time of call are still valid and identify the
@@ -6478,6 +6865,10 @@ int can_migrate_task(struct task_struct *p, struct lb_env *env)
 	if (throttled_lb_pair(task_group(p), env->src_cpu, env->dst_cpu))
 		return 0;
 
+	/* An isolated cpu takes no tasks, but may be drained */
+	if (cpu_isolated(env->dst_cpu))
+		return 0;
+
 	if (!cpumask_test_cpu(env->dst_cpu, tsk_cpus_allowed(p))) {
 		int cpu;
 
@@ -8690,7 +9081,7 @@ static int idle_balance(struct rq *this_rq)
 	this_rq->idle_stamp = rq_clock(this_rq);
 
 	if (this_rq->avg_idle < sysctl_sched_migration_cost ||
-	    !this_rq->rd->overload) {
+	    !this_rq->rd->overload || cpu_isolated(this_cpu)) {
 		rcu_read_lock();
 		sd = rcu_dereference_check_sched_domain(this_rq->sd);
 		if (sd)
@@ -8876,7 +9267,27 @@ static struct {
 
 static inline int find_new_ilb(void)
 {
-	int ilb = cpumask_first(nohz.idle_cpus_mask);
+	int ilb;
+
+#ifdef CONFIG_SCHED_HMP
+	/*
+	 * nohz_kick_needed() only kicks when our own cluster has a tickless
+	 * cpu; waking that one keeps the other cluster in its idle state.
+	 */
+	if (sched_feat(SCHED_HMP)) {
+		for_each_cpu_and(ilb, nohz.idle_cpus_mask,
+				 &hmp_cpu_domain(smp_processor_id())->idle_cpus) {
+			if (!cpu_isolated(ilb) && idle_cpu(ilb))
+				return ilb;
+		}
+	}
+#endif
+
+	ilb = cpumask_first(nohz.idle_cpus_mask);
+
+	/* leave isolated cpus in their deep idle */
+	while (ilb < nr_cpu_ids && cpu_isolated(ilb))
+		ilb = cpumask_next(ilb, nohz.idle_cpus_mask);
 
 	if (ilb < nr_cpu_ids && idle_cpu(ilb))
 		return ilb;
@@ -9270,6 +9681,25 @@ static struct sched_entity *hmp_get_lightest_task(
 
 #define task_created(f) ((SD_BALANCE_EXEC == f || SD_BALANCE_FORK == f)?1:0)
 
+#ifdef CONFIG_NO_HZ_FULL
+/*
+ * A full dynticks fast cpu stops its tick for its one task only if the
+ * task is at least this heavy. A lighter task may have to go down to the
+ * slow cluster and keeps the tick, which drives the HMP balancing.
+ */
+unsigned int hmp_tickless_min_load = HMP_MAX_LOAD / 2;
+
+bool hmp_can_stop_tick(struct rq *rq)
+{
+	struct task_struct *p = rq->curr;
+
+	if (!hmp_cpu_is_fast(cpu_of(rq)) || p->sched_class != &fair_sched_class)
+		return true;
+
+	return se_load((&p->se)) >= hmp_tickless_min_load;
+}
+#endif /* CONFIG_NO_HZ_FULL */
+
 
 /*
  * Heterogenous Multi-Processor (HMP) - Utility Function
@@ -9310,10 +9740,31 @@ static unsigned int hmp_select_cpu(unsigned int caller, struct task_struct *p,
 	struct cpumask srcp;
 
 	cpumask_and(&srcp, cpu_online_mask, mask);
+#ifdef CONFIG_CPU_ISOLATION
+	cpumask_andnot(&srcp, &srcp, cpu_isolate_mask);
+#endif
 	target = cpumask_any_and(&srcp, tsk_cpus_allowed(p));
 	if (target >= num_possible_cpus())
 		goto out;
 
+	/*
+	 * An empty rq has the minimum weighted load of the cluster, so use
+	 * the cached idle mask to take it without scanning the cluster. Ties
+	 * go to @prev and then to the first cpu, as in the scan below.
+	 */
+	if (prev >= 0 && prev < nr_cpu_ids && cpumask_test_cpu(prev, &srcp) &&
+	    cpumask_test_cpu(prev, tsk_cpus_allowed(p)) && hmp_cpu_idle_cached(prev) &&
+	    !rq_length(prev) && (!hmp_caller_is_gb(caller) || hmp_cpu_stable(prev)))
+		return prev;
+
+	for_each_cpu_and(curr, &srcp, &hmp_cpu_domain(target)->idle_cpus) {
+		if (!cpumask_test_cpu(curr, tsk_cpus_allowed(p)) || rq_length(curr))
+			continue;
+		if (hmp_caller_is_gb(caller) && !hmp_cpu_stable(curr))
+			continue;
+		return curr;
+	}
+
 	/*
 	 * RT class is taken into account because CPU load is multiplied
 	 * by the total number of CPU runnable tasks that includes RT tasks.
@@ -9323,7 +9774,8 @@ static unsigned int hmp_select_cpu(unsigned int caller, struct task_struct *p,
 	target_wload *= rq_length(target);
 	for_each_cpu(curr, mask) {
 		/* Check CPU status and task affinity */
-		if (!cpu_online(curr) || !cpumask_test_cpu(curr, tsk_cpus_allowed(p)))
+		if (!cpu_online(curr) || cpu_isolated(curr) ||
+		    !cpumask_test_cpu(curr, tsk_cpus_allowed(p)))
 			continue;
 
 		/* For global load balancing, unstable CPU will be bypassed */
@@ -9345,6 +9797,33 @@ out:
 	return target;
 }
 
+#ifdef CONFIG_MT_SCHED_MONITOR
+/* nice below 0, which covers the UI and display threads on Android */
+#define task_latency_sensitive(p) ((p)->prio < DEFAULT_PRIO)
+
+/*
+ * @cpu is busy with interrupts: take the shortest runqueue of its cluster
+ * on a cpu that is not, if @p may run there.
+ */
+static int hmp_irq_quiet_cpu(struct task_struct *p, int cpu)
+{
+	unsigned int len, min_len = UINT_MAX;
+	int curr, target = cpu;
+
+	for_each_cpu_and(curr, &hmp_cpu_domain(cpu)->cpus, cpu_online_mask) {
+		if (cpu_isolated(curr) || !cpumask_test_cpu(curr, tsk_cpus_allowed(p)) ||
+		    mt_irq_overloaded(curr))
+			continue;
+		len = rq_length(curr);
+		if (len < min_len) {
+			min_len = len;
+			target = curr;
+		}
+	}
+	return target;
+}
+#endif
+
 /*
  * Heterogenous Multi-Processor (HMP) - Task Runqueue Selection
  */
@@ -9438,6 +9917,11 @@ out:
 		new_cpu = prev_cpu;
 	}
 
+#ifdef CONFIG_MT_SCHED_MONITOR
+	if (task_latency_sensitive(p) && mt_irq_overloaded(new_cpu))
+		new_cpu = hmp_irq_quiet_cpu(p, new_cpu);
+#endif
+
 	cfs_nr_pending(new_cpu)++;
 	cfs_pending_load(new_cpu) += se_load(se);
 #ifdef CONFIG_HMP_TRACER
@@ -9480,6 +9964,8 @@ out:
 #define HMP_LOW_PRIORITY_FILTER              (0x08)
 #define HMP_BIG_BUSY_LITTLE_IDLE             (0x10)
 #define HMP_BIG_IDLE                         (0x20)
+#define HMP_UTIL_CLAMP_FILTER                (0x40)
+#define HMP_MEMBOUND_FILTER                  (0x80)
 #define HMP_MIGRATION_APPROVED              (0x100)
 #define HMP_TASK_UP_MIGRATION               (0x200)
 #define HMP_TASK_DOWN_MIGRATION             (0x400)
@@ -9492,6 +9978,8 @@ struct hmp_statisic hmp_stats;
  * Briefly summarize the flow as below;
  * 1) Migration stabilizing
  * 2) Filter low-priority task
+ * 2.1) Filter capped task
+ * 2.2) Filter memory-bound task
  * 2.5) Keep all cpu busy
  * 3) Check CPU capacity
  * 4) Check dynamic migration threshold
@@ -9540,6 +10028,28 @@ static unsigned int hmp_up_migration(int cpu, int *target_cpu, struct sched_enti
 	}
 #endif
 
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	/*
+	 * [2.1] Filter capped task
+	 * A task whose group caps it below the up-threshold stays on LITTLE
+	 */
+	if (uclamp_task_util(p, SCHED_CAPACITY_SCALE) <= B->threshold) {
+		check->status |= HMP_UTIL_CLAMP_FILTER;
+		goto trace;
+	}
+#endif
+
+#ifdef CONFIG_MTPROF_PMU
+	/*
+	 * [2.2] Filter memory-bound task
+	 * A task stalled on memory most of its cycles gains little on big
+	 */
+	if (mt_pmu_membound_thresh && p->mtk_pmu_membound >= mt_pmu_membound_thresh) {
+		check->status |= HMP_MEMBOUND_FILTER;
+		goto trace;
+	}
+#endif
+
 	/* [2.5]if big is idle, just go to big */
 	if (rq_length(*target_cpu) == 0) {
 		check->status |= HMP_BIG_IDLE;
@@ -9561,7 +10071,7 @@ static unsigned int hmp_up_migration(int cpu, int *target_cpu, struct sched_enti
 	 * [4] Check dynamic migration threshold
 	 * Migrate task from LITTLE to big if load is greater than up-threshold
 	 */
-	if (se_load(se) > B->threshold) {
+	if (uclamp_task_util(p, se_load(se)) > B->threshold) {
 		check->status |= HMP_MIGRATION_APPROVED;
 		check->result = 1;
 	}
@@ -9665,7 +10175,7 @@ static unsigned int hmp_down_migration(int cpu, int *target_cpu, struct sched_en
 	 * Migrate task from big to LITTLE if load ratio is less than
 	 * or equal to down-threshold
 	 */
-	if (L->threshold >= se_load(se)) {
+	if (L->threshold >= uclamp_task_util(p, se_load(se))) {
 		check->status |= HMP_MIGRATION_APPROVED;
 		check->result = 1;
 	}
@@ -9857,8 +10367,8 @@ static void hmp_force_down_migration(int this_cpu)
 
 	/* Migrate light task from big to LITTLE */
 	for_each_cpu(curr_cpu, &hmp_fast_cpu_mask) {
-		/* Check whether CPU is online */
-		if (!cpu_online(curr_cpu))
+		/* Check whether CPU is online, an idle one has nothing to move */
+		if (!cpu_online(curr_cpu) || hmp_cpu_idle_cached(curr_cpu))
 			continue;
 
 		force = 0;
@@ -9972,8 +10482,8 @@ static void hmp_force_up_migration(int this_cpu)
 
 	/* Migrate heavy task from LITTLE to big */
 	for_each_cpu(curr_cpu, &hmp_slow_cpu_mask) {
-		/* Check whether CPU is online */
-		if (!cpu_online(curr_cpu))
+		/* Check whether CPU is online, an idle one has nothing to move */
+		if (!cpu_online(curr_cpu) || hmp_cpu_idle_cached(curr_cpu))
 			continue;
 
 		force = 0;
@@ -10010,6 +10520,12 @@ static void hmp_force_up_migration(int this_cpu)
 
 		target_cpu = hmp_select_cpu(HMP_GB, p, &hmp_fast_cpu_mask, -1);
 		if (target_cpu >= num_possible_cpus()) {
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+			/* heavy task stranded on LITTLE, ask hps for a big core */
+			if (se_load(se) > HMP_EVENT_HEAVY_LOAD &&
+			    cpumask_intersects(&hmp_fast_cpu_mask, tsk_cpus_allowed(p)))
+				sched_nr_event(SCHED_NR_EVENT_HMP_UP);
+#endif
 			raw_spin_unlock_irqrestore(&target->lock, flags);
 			continue;
 		}
@@ -10024,7 +10540,8 @@ static void hmp_force_up_migration(int this_cpu)
 		sched_update_clbstats(&clbenv);
 
 #ifdef CONFIG_HMP_PACK_SMALL_TASK
-		if (is_light_task(p) && !is_buddy_busy(per_cpu(sd_pack_buddy, curr_cpu)))
+		if (is_light_task(p) && !task_latency_sensitive(p) &&
+		    !is_buddy_busy(per_cpu(sd_pack_buddy, curr_cpu)))
 			goto out_force_up;
 #endif
 		/* Check migration threshold */
@@ -10083,6 +10600,9 @@ static unsigned int hmp_idle_pull(int this_cpu)
 	struct task_struct *p = NULL;
 	struct clb_env clbenv;
 
+	if (cpu_isolated(this_cpu))
+		return 0;
+
 	if (!hmp_cpu_is_slowest(this_cpu))
 		hmp_domain = hmp_slower_domain(this_cpu);
 	if (!hmp_domain)
@@ -10097,8 +10617,10 @@ static unsigned int hmp_idle_pull(int this_cpu)
 	cpumask_copy(&clbenv.lcpus, &hmp_slow_cpu_mask);
 	cpumask_copy(&clbenv.bcpus, &hmp_fast_cpu_mask);
 
-	/* first select a task */
+	/* first select a task, idle cpus have none */
 	for_each_cpu(cpu, &hmp_domain->cpus) {
+		if (cpumask_test_cpu(cpu, &hmp_domain->idle_cpus))
+			continue;
 		rq = cpu_rq(cpu);
 		raw_spin_lock_irqsave(&rq->lock, flags);
 		curr = rq->cfs.curr;
@@ -10324,6 +10846,7 @@ static void task_tick_fair(struct rq *rq, struct task_struct *curr, int queued)
 		task_tick_numa(rq, curr);
 
 	update_rq_runnable_avg(rq, 1);
+	update_capacity_of(cpu_of(rq));
 }
 
 /*
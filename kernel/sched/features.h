@@ -93,3 +93,14 @@ SCHED_FEAT(SCHED_HMP, true)
 #else
 SCHED_FEAT(SCHED_HMP, false)
 #endif
+
+/*
+ * Energy-aware wakeup placement. Pick the cpu with the lowest estimated
+ * energy cost from the per-cluster energy model instead of the HMP
+ * thresholds, as long as the task fits with enough capacity margin.
+ */
+#ifdef CONFIG_SCHED_ENERGY_MODEL
+SCHED_FEAT(ENERGY_AWARE, true)
+#else
+SCHED_FEAT(ENERGY_AWARE, false)
+#endif
@@ -29,6 +29,9 @@ pick_next_task_idle(struct rq *rq, struct task_struct *prev)
 	put_prev_task(rq, prev);
 
 	schedstat_inc(rq, sched_goidle);
+#ifdef CONFIG_SCHED_HMP
+	hmp_idle_enter(cpu_of(rq));
+#endif
 	return rq->idle;
 }
 
@@ -47,6 +50,9 @@ dequeue_task_idle(struct rq *rq, struct task_struct *p, int flags)
 
 static void put_prev_task_idle(struct rq *rq, struct task_struct *prev)
 {
+#ifdef CONFIG_SCHED_HMP
+	hmp_idle_exit(cpu_of(rq));
+#endif
 	idle_exit_fair(rq);
 	rq_last_tick_reset(rq);
 }
@@ -1134,6 +1134,7 @@ static void update_curr_rt(struct rq *rq)
 	per_cpu(exec_start, cpu) = curr->se.exec_start;
 	curr->se.sum_exec_runtime += delta_exec;
 	account_group_exec_runtime(curr, delta_exec);
+	update_task_demand(rq, curr, delta_exec);
 
 	curr->se.exec_start = rq_clock_task(rq);
 	cpuacct_charge(curr, delta_exec);
@@ -1437,8 +1438,10 @@ enqueue_task_rt(struct rq *rq, struct task_struct *p, int flags)
 {
 	struct sched_rt_entity *rt_se = &p->rt;
 
-	if (flags & ENQUEUE_WAKEUP)
+	if (flags & ENQUEUE_WAKEUP) {
 		rt_se->timeout = 0;
+		rt_se->wake_stamp = rq_clock(rq);
+	}
 
 	enqueue_rt_entity(rt_se, flags & ENQUEUE_HEAD);
 
@@ -1545,7 +1548,7 @@ select_task_rq_rt(struct task_struct *p, int cpu, int sd_flag, int flags)
 	}
 #endif
 
-#if defined(CONFIG_MT_SCHED_INTEROP)
+#if defined(CONFIG_MT_SCHED_INTEROP) || defined(CONFIG_SCHED_HMP)
 	/* if the task is allowed to put more than one CPU. */
 	if ((p->nr_cpus_allowed > 1)) {
 #else
@@ -1649,6 +1652,10 @@ static struct task_struct *_pick_next_task_rt(struct rq *rq)
 
 	p = rt_task_of(rt_se);
 	p->se.exec_start = rq_clock_task(rq);
+	if (p->rt.wake_stamp) {
+		trace_sched_rt_wakeup_latency(p, cpu_of(rq), rq_clock(rq) - p->rt.wake_stamp);
+		p->rt.wake_stamp = 0;
+	}
 
 	return p;
 }
@@ -1761,7 +1768,7 @@ static struct task_struct *pick_highest_pushable_task(struct rq *rq, int cpu)
 
 static DEFINE_PER_CPU(cpumask_var_t, local_cpu_mask);
 
-#ifdef CONFIG_MT_SCHED_INTEROP
+#if defined(CONFIG_MT_SCHED_INTEROP) && !defined(CONFIG_SCHED_HMP)
 static int mt_sched_interop_rt(int cpu, struct cpumask *lowest_mask)
 {
 	int lowest_cpu = -1, lowest_prio = 0;
@@ -1797,13 +1804,100 @@ static int mt_sched_interop_rt(int cpu, struct cpumask *lowest_mask)
 }
 #endif
 
+#ifdef CONFIG_SCHED_HMP
+/*
+ * Cost, roughly in microseconds of delay, of running an RT task on one of
+ * the lowest priority cpus: waking it from its idle state, or preempting
+ * what it runs, plus a penalty when the cpu at its current OPP is too slow
+ * for the task's demand. Leaving the cluster of the previous cpu costs
+ * extra, so wakeups and pushes stay put unless another cluster is clearly
+ * better.
+ */
+#define RT_COST_PREEMPT_RT	1000	/* a lower priority RT task is running */
+#define RT_COST_PREEMPT_CFS	100	/* per runnable CFS task delayed */
+#define RT_COST_SLOW		500	/* demand above 80% of current capacity */
+#define RT_COST_CROSS_CLUSTER	50
+
+static unsigned long rt_cpu_cost(struct task_struct *p, int cpu, int prev_cpu)
+{
+	struct rq *rq = cpu_rq(cpu);
+	struct cpuidle_state *idle;
+	unsigned long cost = 0, cap;
+
+	if (idle_cpu(cpu)) {
+		idle = idle_get_state(rq);
+		if (idle)
+			cost += idle->exit_latency;
+	} else if (rt_task(rq->curr)) {
+		cost += RT_COST_PREEMPT_RT;
+	} else {
+		cost += RT_COST_PREEMPT_CFS * max(rq->cfs.h_nr_running, 1U);
+	}
+
+	cap = rq->cpu_capacity_orig * arch_scale_freq_capacity(NULL, cpu) >> SCHED_CAPACITY_SHIFT;
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+	if (p->ravg.demand * 5 > cap * 4)
+		cost += RT_COST_SLOW;
+#endif
+	/* between otherwise equal cpus, the faster one runs the task sooner */
+	cost += (SCHED_CAPACITY_SCALE - min(cap, SCHED_CAPACITY_SCALE)) >> 4;
+
+	if (!cpumask_test_cpu(cpu, &hmp_cpu_domain(prev_cpu)->cpus))
+		cost += RT_COST_CROSS_CLUSTER;
+
+	return cost;
+}
+
+static int rt_select_cluster_cpu(struct task_struct *p, struct cpumask *lowest_mask, int prev_cpu)
+{
+	unsigned long cost, best_cost = ULONG_MAX;
+	int cpu, best_cpu = -1;
+
+	rcu_read_lock();
+	/* the previous cpu is cache hot, it wins ties */
+	if (cpumask_test_cpu(prev_cpu, lowest_mask)) {
+		best_cost = rt_cpu_cost(p, prev_cpu, prev_cpu);
+		best_cpu = prev_cpu;
+	}
+	for_each_cpu(cpu, lowest_mask) {
+		if (cpu == prev_cpu)
+			continue;
+		cost = rt_cpu_cost(p, cpu, prev_cpu);
+		if (cost < best_cost) {
+			best_cost = cost;
+			best_cpu = cpu;
+		}
+	}
+	rcu_read_unlock();
+
+	if (best_cpu >= 0)
+		trace_sched_rt_select_cpu(p, prev_cpu, best_cpu, best_cost);
+	return best_cpu;
+}
+
+/* pull from the rt overloaded cpus of our own cluster first */
+#define RT_PULL_PASSES	2
+
+static inline bool rt_pull_pass(int this_cpu, int cpu, int pass)
+{
+	return cpumask_test_cpu(cpu, &hmp_cpu_domain(this_cpu)->cpus) == (pass == 0);
+}
+#else
+#define RT_PULL_PASSES	1
+
+static inline bool rt_pull_pass(int this_cpu, int cpu, int pass)
+{
+	return true;
+}
+#endif
+
 static int find_lowest_rq(struct task_struct *task)
 {
 	struct sched_domain *sd;
 	struct cpumask *lowest_mask = this_cpu_cpumask_var_ptr(local_cpu_mask);
 	int this_cpu = smp_processor_id();
 	int cpu      = task_cpu(task);
-#ifdef CONFIG_MT_SCHED_INTEROP
+#if defined(CONFIG_MT_SCHED_INTEROP) && !defined(CONFIG_SCHED_HMP)
 	int interop_cpu;
 #endif
 
@@ -1820,7 +1914,16 @@ static int find_lowest_rq(struct task_struct *task)
 	if (!cpupri_find(&task_rq(task)->rd->cpupri, task, lowest_mask))
 		return -1; /* No targets found */
 
-#ifdef CONFIG_MT_SCHED_INTEROP
+#ifdef CONFIG_CPU_ISOLATION
+	/* Isolated cpus take no pushed tasks */
+	cpumask_andnot(lowest_mask, lowest_mask, cpu_isolate_mask);
+	if (cpumask_empty(lowest_mask))
+		return -1;
+#endif
+
+#if defined(CONFIG_SCHED_HMP)
+	return rt_select_cluster_cpu(task, lowest_mask, cpu);
+#elif defined(CONFIG_MT_SCHED_INTEROP)
 	interop_cpu = mt_sched_interop_rt(cpu, lowest_mask);
 	if (interop_cpu != -1) {
 		mt_sched_printf(sched_interop, "find idle cpu=%d", interop_cpu);
@@ -2050,13 +2153,16 @@ static void push_rt_tasks(struct rq *rq)
 
 static int pull_rt_task(struct rq *this_rq)
 {
-	int this_cpu = this_rq->cpu, ret = 0, cpu;
+	int this_cpu = this_rq->cpu, ret = 0, cpu, pass;
 	struct task_struct *p;
 	struct rq *src_rq;
 
 	if (likely(!rt_overloaded(this_rq)))
 		return 0;
 
+	if (cpu_isolated(this_cpu))
+		return 0;
+
 	/*
 	 * Match the barrier from rt_set_overloaded; this guarantees that if we
 	 * see overloaded we must also see the rto_mask bit.
@@ -2064,72 +2170,74 @@ static int pull_rt_task(struct rq *this_rq)
 	smp_rmb();
 	/* sched:add trace_sched*/
 	mt_sched_printf(sched_rt_info, "1. pull_rt_task %lu ", this_rq->rd->rto_mask->bits[0]);
-	for_each_cpu(cpu, this_rq->rd->rto_mask) {
-		if (this_cpu == cpu)
-			continue;
-
-		src_rq = cpu_rq(cpu);
-
-		/*
-		 * Don't bother taking the src_rq->lock if the next highest
-		 * task is known to be lower-priority than our current task.
-		 * This may look racy, but if this value is about to go
-		 * logically higher, the src_rq will push this task away.
-		 * And if its going logically lower, we do not care
-		 */
-		/* sched:add trace_sched*/
-		mt_sched_printf(sched_rt_info, "2. pull_rt_task %d %d ",
-				src_rq->rt.highest_prio.next, this_rq->rt.highest_prio.curr);
-		if (src_rq->rt.highest_prio.next >=
-		    this_rq->rt.highest_prio.curr)
-			continue;
-
-		/*
-		 * We can potentially drop this_rq's lock in
-		 * double_lock_balance, and another CPU could
-		 * alter this_rq
-		 */
-		double_lock_balance(this_rq, src_rq);
+	for (pass = 0; pass < RT_PULL_PASSES; pass++) {
+		for_each_cpu(cpu, this_rq->rd->rto_mask) {
+			if (this_cpu == cpu || !rt_pull_pass(this_cpu, cpu, pass))
+				continue;
 
-		/*
-		 * We can pull only a task, which is pushable
-		 * on its rq, and no others.
-		 */
-		p = pick_highest_pushable_task(src_rq, this_cpu);
+			src_rq = cpu_rq(cpu);
 
-		/*
-		 * Do we have an RT task that preempts
-		 * the to-be-scheduled task?
-		 */
-		if (p && (p->prio < this_rq->rt.highest_prio.curr)) {
-			WARN_ON(p == src_rq->curr);
-			WARN_ON(!task_on_rq_queued(p));
+			/*
+			 * Don't bother taking the src_rq->lock if the next highest
+			 * task is known to be lower-priority than our current task.
+			 * This may look racy, but if this value is about to go
+			 * logically higher, the src_rq will push this task away.
+			 * And if its going logically lower, we do not care
+			 */
+			/* sched:add trace_sched*/
+			mt_sched_printf(sched_rt_info, "2. pull_rt_task %d %d ",
+					src_rq->rt.highest_prio.next, this_rq->rt.highest_prio.curr);
+			if (src_rq->rt.highest_prio.next >=
+			    this_rq->rt.highest_prio.curr)
+				continue;
 
 			/*
-			 * There's a chance that p is higher in priority
-			 * than what's currently running on its cpu.
-			 * This is just that p is wakeing up and hasn't
-			 * had a chance to schedule. We only pull
-			 * p if it is lower in priority than the
-			 * current task on the run queue
+			 * We can potentially drop this_rq's lock in
+			 * double_lock_balance, and another CPU could
+			 * alter this_rq
 			 */
-			if (p->prio < src_rq->curr->prio)
-				goto skip;
+			double_lock_balance(this_rq, src_rq);
 
-			ret = 1;
+			/*
+			 * We can pull only a task, which is pushable
+			 * on its rq, and no others.
+			 */
+			p = pick_highest_pushable_task(src_rq, this_cpu);
 
-			deactivate_task(src_rq, p, 0);
-			set_task_cpu(p, this_cpu);
-			activate_task(this_rq, p, 0);
 			/*
-			 * We continue with the search, just in
-			 * case there's an even higher prio task
-			 * in another runqueue. (low likelihood
-			 * but possible)
+			 * Do we have an RT task that preempts
+			 * the to-be-scheduled task?
 			 */
-		}
+			if (p && (p->prio < this_rq->rt.highest_prio.curr)) {
+				WARN_ON(p == src_rq->curr);
+				WARN_ON(!task_on_rq_queued(p));
+
+				/*
+				 * There's a chance that p is higher in priority
+				 * than what's currently running on its cpu.
+				 * This is just that p is wakeing up and hasn't
+				 * had a chance to schedule. We only pull
+				 * p if it is lower in priority than the
+				 * current task on the run queue
+				 */
+				if (p->prio < src_rq->curr->prio)
+					goto skip;
+
+				ret = 1;
+
+				deactivate_task(src_rq, p, 0);
+				set_task_cpu(p, this_cpu);
+				activate_task(this_rq, p, 0);
+				/*
+				 * We continue with the search, just in
+				 * case there's an even higher prio task
+				 * in another runqueue. (low likelihood
+				 * but possible)
+				 */
+			}
 skip:
-		double_unlock_balance(this_rq, src_rq);
+			double_unlock_balance(this_rq, src_rq);
+		}
 	}
 
 	return ret;
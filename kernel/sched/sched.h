@@ -206,6 +206,27 @@ struct cfs_bandwidth {
 };
 
 /* task group related information */
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+enum uclamp_id {
+	UCLAMP_MIN = 0,
+	UCLAMP_MAX,
+	UCLAMP_CNT
+};
+
+/* clamp values are tracked per rq in 5% wide buckets: 0%, 5%, .. 100% */
+#define UCLAMP_BUCKETS		21
+
+static inline unsigned int uclamp_bucket_id(unsigned int value)
+{
+	return DIV_ROUND_UP(value * (UCLAMP_BUCKETS - 1), SCHED_CAPACITY_SCALE);
+}
+
+static inline unsigned int uclamp_bucket_value(unsigned int id)
+{
+	return id * SCHED_CAPACITY_SCALE / (UCLAMP_BUCKETS - 1);
+}
+#endif
+
 struct task_group {
 	struct cgroup_subsys_state css;
 
@@ -241,6 +262,18 @@ struct task_group {
 #endif
 
 	struct cfs_bandwidth cfs_bandwidth;
+
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	/* utilization clamps, in capacity units [0..SCHED_CAPACITY_SCALE] */
+	unsigned int uclamp[UCLAMP_CNT];
+#endif
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+	bool latency_sensitive;
+#endif
+#ifdef CONFIG_IOSCHED_DEADLINE_FG
+	/* I/O of the group's tasks is in the foreground class */
+	bool io_foreground;
+#endif
 };
 
 #ifdef CONFIG_FAIR_GROUP_SCHED
@@ -565,6 +598,17 @@ struct rq {
 	struct rt_rq rt;
 	struct dl_rq dl;
 
+#ifdef CONFIG_UCLAMP_TASK_GROUP
+	/* number of enqueued CFS tasks per clamp bucket */
+	unsigned int uclamp_tasks[UCLAMP_CNT][UCLAMP_BUCKETS];
+#endif
+
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+	/* current demand window, and the sum of demands of queued tasks */
+	u64 window_start;
+	unsigned long cumulative_demand;
+#endif
+
 #ifdef CONFIG_FAIR_GROUP_SCHED
 	/* list of leaf cfs_rq on this cpu: */
 	struct list_head leaf_cfs_rq_list;
@@ -830,10 +874,17 @@ extern struct cpumask hmp_fast_cpu_mask;
 extern struct cpumask hmp_slow_cpu_mask;
 
 extern void __init arch_get_hmp_domains(struct list_head *hmp_domains_list);
+#ifdef CONFIG_NO_HZ_FULL
+extern unsigned int hmp_tickless_min_load;
+extern bool hmp_can_stop_tick(struct rq *rq);
+#endif
 
 static LIST_HEAD(hmp_domains);
 DECLARE_PER_CPU(struct hmp_domain *, hmp_cpu_domain);
 #define hmp_cpu_domain(cpu)     (per_cpu(hmp_cpu_domain, (cpu)))
+
+extern void hmp_idle_enter(int cpu);
+extern void hmp_idle_exit(int cpu);
 #endif
 
 #else
@@ -893,6 +944,28 @@ static inline struct task_group *task_group(struct task_struct *p)
 
 #endif /* CONFIG_CGROUP_SCHED */
 
+#ifdef CONFIG_SCHED_LATENCY_SENSITIVE
+/*
+ * A task is latency sensitive if it set SCHED_FLAG_LATENCY_SENSITIVE or
+ * if its cpu cgroup has cpu.latency_sensitive set.
+ */
+static inline bool task_latency_sensitive(struct task_struct *p)
+{
+	if (p->latency_sensitive)
+		return true;
+#ifdef CONFIG_CGROUP_SCHED
+	return task_group(p)->latency_sensitive;
+#else
+	return false;
+#endif
+}
+#else
+static inline bool task_latency_sensitive(struct task_struct *p)
+{
+	return false;
+}
+#endif
+
 static inline void __set_task_cpu(struct task_struct *p, unsigned int cpu)
 {
 	set_task_rq(p, cpu);
@@ -1624,6 +1697,46 @@ static inline u64 irq_time_read(int cpu)
 #endif /* CONFIG_64BIT */
 #endif /* CONFIG_IRQ_TIME_ACCOUNTING */
 
+#ifdef CONFIG_CPU_FREQ_GOV_SCHED
+/*
+ * Headroom added on top of the utilization of a cpu before it is turned
+ * into a frequency request, so that the selected OPP has ~20% slack.
+ */
+#define capacity_margin_freq	1280
+
+extern struct static_key __sched_freq;
+
+static inline bool sched_freq(void)
+{
+	return static_key_false(&__sched_freq);
+}
+
+void cpufreq_sched_set_cap(int cpu, unsigned long capacity);
+#else
+static inline bool sched_freq(void) { return false; }
+static inline void cpufreq_sched_set_cap(int cpu, unsigned long capacity)
+{ }
+#endif
+
+#ifdef CONFIG_MTK_SCHED_TASK_DEMAND
+extern unsigned int sched_ravg_window;
+
+void update_task_demand(struct rq *rq, struct task_struct *p, u64 delta);
+void inc_cumulative_demand(struct rq *rq, struct task_struct *p);
+void dec_cumulative_demand(struct rq *rq, struct task_struct *p);
+
+/* sum of the windowed demands of the tasks queued on @cpu */
+static inline unsigned long cpu_demand(int cpu)
+{
+	return cpu_rq(cpu)->cumulative_demand;
+}
+#else
+static inline void update_task_demand(struct rq *rq, struct task_struct *p, u64 delta) { }
+static inline void inc_cumulative_demand(struct rq *rq, struct task_struct *p) { }
+static inline void dec_cumulative_demand(struct rq *rq, struct task_struct *p) { }
+static inline unsigned long cpu_demand(int cpu) { return 0; }
+#endif
+
 /* sched:  add for print ke log */
 #ifdef CONFIG_SMP
 static inline int rq_cpu(const struct rq *rq) { return rq->cpu; }
@@ -333,17 +333,26 @@ static int tick_nohz_cpu_down_callback(struct notifier_block *nfb,
  */
 static char __initdata nohz_full_buf[NR_CPUS + 1];
 
+#ifdef CONFIG_NO_HZ_FULL_HMP
+extern struct cpumask hmp_fast_cpu_mask;
+#endif
+
 static int tick_nohz_init_all(void)
 {
 	int err = -1;
 
-#ifdef CONFIG_NO_HZ_FULL_ALL
+#if defined(CONFIG_NO_HZ_FULL_ALL) || defined(CONFIG_NO_HZ_FULL_HMP)
 	if (!alloc_cpumask_var(&tick_nohz_full_mask, GFP_KERNEL)) {
 		WARN(1, "NO_HZ: Can't allocate full dynticks cpumask\n");
 		return err;
 	}
 	err = 0;
+#ifdef CONFIG_NO_HZ_FULL_ALL
 	cpumask_setall(tick_nohz_full_mask);
+#else
+	/* set up by sched_init() from the device tree */
+	cpumask_copy(tick_nohz_full_mask, &hmp_fast_cpu_mask);
+#endif
 	tick_nohz_full_running = true;
 #endif
 	return err;
@@ -3,16 +3,7 @@
 
 #include <linux/string.h>
 #include <linux/seq_file.h>
-
-#ifdef CONFIG_MTK_KERNEL_MARKER
-void mt_kernel_trace_begin(char *name);
-void mt_kernel_trace_counter(char *name, int count);
-void mt_kernel_trace_end(void);
-#else
-#define mt_kernel_trace_begin(name)
-#define mt_kernel_trace_counter(name, count)
-#define mt_kernel_trace_end()
-#endif
+#include <mt-plat/mt_kernel_marker.h>
 
 #if defined(CONFIG_MTK_HIBERNATION) && defined(CONFIG_MTK_SCHED_TRACERS)
 int resize_ring_buffer_for_hibernation(int enable);
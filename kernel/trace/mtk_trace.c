@@ -4,6 +4,10 @@
 #include "trace.h"
 
 #ifdef CONFIG_MTK_KERNEL_MARKER
+#include <linux/dcache.h>
+#include <linux/slab.h>
+#include <trace/events/mtk_events.h>
+
 static unsigned long __read_mostly tracing_mark_write_addr;
 static int kernel_marker_on;
 
@@ -13,34 +17,157 @@ static inline void update_tracing_mark_write_addr(void)
 		tracing_mark_write_addr = kallsyms_lookup_name("tracing_mark_write");
 }
 
-inline void mt_kernel_trace_begin(char *name)
+/*
+ * Marker names are interned: a marker is recorded as a fixed size
+ * tracing_mark_write event holding the id of its name, and the name is
+ * only looked up when the trace is printed. Ids index marker_names[],
+ * marker_hash[] is an open addressed table from name hash to id. Readers
+ * take no lock; an id is published in marker_hash[] after its name.
+ */
+#define MARKER_NAMES		1024
+#define MARKER_HASH_SIZE	2048
+
+static const char *marker_names[MARKER_NAMES];
+static u16 marker_hash[MARKER_HASH_SIZE];
+static int marker_nr = 1;
+static DEFINE_SPINLOCK(marker_lock);
+
+static int marker_lookup(const char *name, unsigned int hash,
+			 unsigned int *slot)
 {
-	if (unlikely(kernel_marker_on) && name) {
-		preempt_disable();
-		event_trace_printk(tracing_mark_write_addr, "B|%d|%s\n", current->tgid, name);
-		preempt_enable();
+	unsigned int i;
+	int id;
+
+	for (i = 0; i < MARKER_HASH_SIZE; i++) {
+		*slot = (hash + i) & (MARKER_HASH_SIZE - 1);
+		id = ACCESS_ONCE(marker_hash[*slot]);
+		if (!id)
+			break;
+		smp_rmb();
+		if (!strcmp(marker_names[id], name))
+			return id;
 	}
+
+	return 0;
+}
+
+static noinline int marker_intern(const char *name, unsigned int hash)
+{
+	unsigned long flags;
+	unsigned int slot;
+	char *copy;
+	int id;
+
+	spin_lock_irqsave(&marker_lock, flags);
+	id = marker_lookup(name, hash, &slot);
+	if (id || marker_nr >= MARKER_NAMES)
+		goto out;
+
+	copy = kstrdup(name, GFP_ATOMIC);
+	if (!copy)
+		goto out;
+	id = marker_nr++;
+	marker_names[id] = copy;
+	smp_wmb();
+	marker_hash[slot] = id;
+out:
+	spin_unlock_irqrestore(&marker_lock, flags);
+	return id;
 }
-EXPORT_SYMBOL(mt_kernel_trace_begin);
 
-inline void mt_kernel_trace_counter(char *name, int count)
+/* 0 when the table is full, the marker then goes out as text */
+static int marker_id(const char *name)
 {
-	if (unlikely(kernel_marker_on) && name) {
-		preempt_disable();
-		event_trace_printk(tracing_mark_write_addr,
-				   "C|%d|%s|%d\n", current->tgid, name, count);
-		preempt_enable();
+	unsigned int hash = full_name_hash(name, strlen(name));
+	unsigned int slot;
+	int id;
+
+	id = marker_lookup(name, hash, &slot);
+	if (likely(id))
+		return id;
+
+	return marker_intern(name, hash);
+}
+
+const char *mt_kernel_marker_print(struct trace_seq *p, char type, int tgid,
+				   int id, int value)
+{
+	const char *ret = trace_seq_buffer_ptr(p);
+	const char *name = "?";
+
+	if (id > 0 && id < MARKER_NAMES && marker_names[id])
+		name = marker_names[id];
+
+	switch (type) {
+	case 'B':
+		trace_seq_printf(p, "B|%d|%s", tgid, name);
+		break;
+	case 'E':
+		trace_seq_putc(p, 'E');
+		break;
+	default:
+		trace_seq_printf(p, "%c|%d|%s|%d", type, tgid, name, value);
+		break;
 	}
+	trace_seq_putc(p, 0);
+
+	return ret;
 }
-EXPORT_SYMBOL(mt_kernel_trace_counter);
 
-inline void mt_kernel_trace_end(void)
+void mt_kernel_marker_write(char type, const char *name, int value)
 {
-	if (unlikely(kernel_marker_on)) {
-		preempt_disable();
+	int tgid = current->tgid;
+	int id = 0;
+
+	if (type == 'C' && in_interrupt())
+		tgid = -1;
+
+	if (trace_tracing_mark_write_enabled()) {
+		if (type != 'E' && name)
+			id = marker_id(name);
+		if (id || type == 'E') {
+			trace_tracing_mark_write(type, tgid, id, value);
+			return;
+		}
+	}
+
+	/* event disabled or no id left, write the marker as text */
+	update_tracing_mark_write_addr();
+	preempt_disable();
+	switch (type) {
+	case 'B':
+		event_trace_printk(tracing_mark_write_addr, "B|%d|%s\n", tgid, name);
+		break;
+	case 'E':
 		event_trace_printk(tracing_mark_write_addr, "E\n");
-		preempt_enable();
+		break;
+	default:
+		event_trace_printk(tracing_mark_write_addr, "%c|%d|%s|%d\n",
+				   type, tgid, name, value);
+		break;
 	}
+	preempt_enable();
+}
+EXPORT_SYMBOL(mt_kernel_marker_write);
+
+void mt_kernel_trace_begin(char *name)
+{
+	if (unlikely(kernel_marker_on) && name)
+		mt_kernel_marker_write('B', name, 0);
+}
+EXPORT_SYMBOL(mt_kernel_trace_begin);
+
+void mt_kernel_trace_counter(char *name, int count)
+{
+	if (unlikely(kernel_marker_on) && name)
+		mt_kernel_marker_write('C', name, count);
+}
+EXPORT_SYMBOL(mt_kernel_trace_counter);
+
+void mt_kernel_trace_end(void)
+{
+	if (unlikely(kernel_marker_on))
+		mt_kernel_marker_write('E', NULL, 0);
 }
 EXPORT_SYMBOL(mt_kernel_trace_end);
 
@@ -68,8 +195,10 @@ kernel_marker_on_simple_write(struct file *filp, const char __user *ubuf,
 
 	kernel_marker_on = !!val;
 
-	if (kernel_marker_on)
+	if (kernel_marker_on) {
 		update_tracing_mark_write_addr();
+		trace_set_clr_event("mtk_events", "tracing_mark_write", 1);
+	}
 
 	(*ppos)++;
 
@@ -83,6 +212,33 @@ static const struct file_operations kernel_marker_on_simple_fops = {
 	.llseek = default_llseek,
 };
 
+/* id to name, for readers of the raw ring buffer */
+static int kernel_marker_names_show(struct seq_file *m, void *v)
+{
+	int i, nr = ACCESS_ONCE(marker_nr);
+
+	for (i = 1; i < nr; i++) {
+		const char *name = ACCESS_ONCE(marker_names[i]);
+
+		if (name)
+			seq_printf(m, "%d\t%s\n", i, name);
+	}
+
+	return 0;
+}
+
+static int kernel_marker_names_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, kernel_marker_names_show, NULL);
+}
+
+static const struct file_operations kernel_marker_names_fops = {
+	.open = kernel_marker_names_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static __init int init_kernel_marker(void)
 {
 	struct dentry *d_tracer;
@@ -92,6 +248,7 @@ static __init int init_kernel_marker(void)
 		return 0;
 
 	trace_create_file("kernel_marker_on", 0644, d_tracer, NULL, &kernel_marker_on_simple_fops);
+	trace_create_file("kernel_marker_names", 0444, d_tracer, NULL, &kernel_marker_names_fops);
 
 	return 0;
 }
@@ -182,26 +182,38 @@ static inline u32 __pure crc32_le_generic(u32 crc, unsigned char const *p,
 }
 
 #if CRC_LE_BITS == 1
-u32 __pure crc32_le(u32 crc, unsigned char const *p, size_t len)
+u32 __pure crc32_le_base(u32 crc, unsigned char const *p, size_t len)
 {
 	return crc32_le_generic(crc, p, len, NULL, CRCPOLY_LE);
 }
-u32 __pure __crc32c_le(u32 crc, unsigned char const *p, size_t len)
+u32 __pure __crc32c_le_base(u32 crc, unsigned char const *p, size_t len)
 {
 	return crc32_le_generic(crc, p, len, NULL, CRC32C_POLY_LE);
 }
 #else
-u32 __pure crc32_le(u32 crc, unsigned char const *p, size_t len)
+u32 __pure crc32_le_base(u32 crc, unsigned char const *p, size_t len)
 {
 	return crc32_le_generic(crc, p, len,
 			(const u32 (*)[256])crc32table_le, CRCPOLY_LE);
 }
-u32 __pure __crc32c_le(u32 crc, unsigned char const *p, size_t len)
+u32 __pure __crc32c_le_base(u32 crc, unsigned char const *p, size_t len)
 {
 	return crc32_le_generic(crc, p, len,
 			(const u32 (*)[256])crc32ctable_le, CRC32C_POLY_LE);
 }
 #endif
+EXPORT_SYMBOL(crc32_le_base);
+EXPORT_SYMBOL(__crc32c_le_base);
+
+/* architectures with crc instructions override these */
+u32 __pure __weak crc32_le(u32 crc, unsigned char const *p, size_t len)
+{
+	return crc32_le_base(crc, p, len);
+}
+u32 __pure __weak __crc32c_le(u32 crc, unsigned char const *p, size_t len)
+{
+	return __crc32c_le_base(crc, p, len);
+}
 EXPORT_SYMBOL(crc32_le);
 EXPORT_SYMBOL(__crc32c_le);
 
@@ -1154,10 +1166,45 @@ static int __init crc32_combine_test(void)
 	return 0;
 }
 
+/* run the vectors through @fn, returns nsec or 0 on a wrong result */
+static u64 __init crc32_time_one(u32 __pure (*fn)(u32, unsigned char const *, size_t),
+				 bool crc32c)
+{
+	struct timespec start, stop;
+	unsigned long flags;
+	u32 want;
+	int i, errors = 0;
+
+	local_irq_save(flags);
+	getnstimeofday(&start);
+	for (i = 0; i < 100; i++) {
+		want = crc32c ? test[i].crc32c_le : test[i].crc_le;
+		if (fn(test[i].crc, test_buf + test[i].start, test[i].length) != want)
+			errors++;
+	}
+	getnstimeofday(&stop);
+	local_irq_restore(flags);
+
+	if (errors)
+		return 0;
+	return stop.tv_nsec - start.tv_nsec + 1000000000ULL * (stop.tv_sec - start.tv_sec);
+}
+
+/* compare an architecture override with the table driven version */
+static int __init crc32_base_test(void)
+{
+	pr_info("crc32: %llu nsec, table driven %llu nsec (0: wrong result)\n",
+		crc32_time_one(crc32_le, false), crc32_time_one(crc32_le_base, false));
+	pr_info("crc32c: %llu nsec, table driven %llu nsec (0: wrong result)\n",
+		crc32_time_one(__crc32c_le, true), crc32_time_one(__crc32c_le_base, true));
+	return 0;
+}
+
 static int __init crc32test_init(void)
 {
 	crc32_test();
 	crc32c_test();
+	crc32_base_test();
 
 	crc32_combine_test();
 	crc32c_combine_test();
@@ -92,7 +92,7 @@ static int lz4_uncompress(const char *source, char *dest, int osize)
 			ip += length;
 			break; /* EOF */
 		}
-		LZ4_WILDCOPY(ip, op, cpy);
+		LZ4_LITCOPY(ip, op, cpy);
 		ip -= (op - cpy);
 		op = cpy;
 
@@ -218,7 +218,7 @@ static int lz4_uncompress_unknownoutputsize(const char *source, char *dest,
 			op += length;
 			break;/* Necessarily EOF, due to parsing restrictions */
 		}
-		LZ4_WILDCOPY(ip, op, cpy);
+		LZ4_LITCOPY(ip, op, cpy);
 		ip -= (op - cpy);
 		op = cpy;
 
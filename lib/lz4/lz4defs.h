@@ -26,6 +26,7 @@ typedef struct _U16_S { u16 v; } U16_S;
 typedef struct _U32_S { u32 v; } U32_S;
 typedef struct _U64_S { u64 v; } U64_S;
 #if defined(CONFIG_HAVE_EFFICIENT_UNALIGNED_ACCESS)		\
+	|| defined(CONFIG_ARM64)				\
 	|| defined(CONFIG_ARM) && __LINUX_ARM_ARCH__ >= 6	\
 	&& defined(ARM_EFFICIENT_UNALIGNED_ACCESS)
 
@@ -148,6 +149,29 @@ typedef struct _U64_S { u64 v; } U64_S;
 		LZ4_COPYPACKET(s, d);	\
 	} while (d < e)
 
+/*
+ * Literals come from the input buffer and never overlap what they are copied
+ * to, so arm64 moves them 16 bytes (one ldp/stp pair) at a time. The last
+ * step is 8 bytes wide, the overrun past e stays within the COPYLENGTH the
+ * decoders keep free before the end of both buffers. Matches may overlap
+ * their source by as little as 8 bytes and stay on LZ4_WILDCOPY.
+ */
+#ifdef CONFIG_ARM64
+#define LZ4_LITCOPY(s, d, e)				\
+	do {						\
+		while ((d) + 8 < (e)) {			\
+			PUT8(s, d);			\
+			PUT8((s) + 8, (d) + 8);		\
+			d += 16;			\
+			s += 16;			\
+		}					\
+		if ((d) < (e))				\
+			LZ4_COPYSTEP(s, d);		\
+	} while (0)
+#else
+#define LZ4_LITCOPY	LZ4_WILDCOPY
+#endif
+
 #define LZ4_BLINDCOPY(s, d, l)	\
 	do {	\
 		u8 *e = (d) + l;	\
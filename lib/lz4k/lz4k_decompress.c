@@ -247,6 +247,23 @@ static int lz4k_decompress_simple(const unsigned char *in, size_t in_len, unsign
 					m_pos += 2;
 					len -= 2;
 				}
+#ifdef CONFIG_64BIT
+				/* 8 bytes at a time once the source can't overlap */
+				if (offset >= 8) {
+					if ((len & 4) != 0) {
+						*(unsigned int *)op = *(unsigned int *)m_pos;
+						op += 4;
+						m_pos += 4;
+						len -= 4;
+					}
+					while (len > 0) {
+						*(u64 *)op = *(u64 *)m_pos;
+						op += 8;
+						m_pos += 8;
+						len -= 8;
+					}
+				}
+#endif
 				while (len > 0) {
 					*(unsigned int *)op = *(unsigned int *)m_pos;
 					op += 4;
@@ -426,6 +443,23 @@ static int lz4k_decompress_hc(const unsigned char *in, size_t in_len, unsigned c
 					m_pos += 2;
 					len -= 2;
 				}
+#ifdef CONFIG_64BIT
+				/* 8 bytes at a time once the source can't overlap */
+				if (offset >= 8) {
+					if ((len & 4) != 0) {
+						*(unsigned int *)op = *(unsigned int *)m_pos;
+						op += 4;
+						m_pos += 4;
+						len -= 4;
+					}
+					while (len > 0) {
+						*(u64 *)op = *(u64 *)m_pos;
+						op += 8;
+						m_pos += 8;
+						len -= 8;
+					}
+				}
+#endif
 				while (len > 0) {
 					*(unsigned int *)op = *(unsigned int *)m_pos;
 					op += 4;
@@ -0,0 +1,208 @@
+/*
+ * Checksum microbenchmark: times csum_partial(), ip_fast_csum() and
+ * csum_partial_copy_nocheck() of the running kernel against the portable
+ * C code of lib/checksum.c, after checking that both agree.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/ktime.h>
+#include <linux/random.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <net/checksum.h>
+
+#define BUF_SIZE	4096
+#define LOOPS		10000
+
+static unsigned int loops = LOOPS;
+module_param(loops, uint, 0444);
+MODULE_PARM_DESC(loops, "iterations per measurement");
+
+/* do_csum() of lib/checksum.c */
+static unsigned int ref_do_csum(const unsigned char *buff, int len)
+{
+	int odd;
+	unsigned int result = 0;
+
+	if (len <= 0)
+		goto out;
+	odd = 1 & (unsigned long) buff;
+	if (odd) {
+#ifdef __LITTLE_ENDIAN
+		result += (*buff << 8);
+#else
+		result = *buff;
+#endif
+		len--;
+		buff++;
+	}
+	if (len >= 2) {
+		if (2 & (unsigned long) buff) {
+			result += *(unsigned short *) buff;
+			len -= 2;
+			buff += 2;
+		}
+		if (len >= 4) {
+			const unsigned char *end = buff + ((unsigned)len & ~3);
+			unsigned int carry = 0;
+
+			do {
+				unsigned int w = *(unsigned int *) buff;
+
+				buff += 4;
+				result += carry;
+				result += w;
+				carry = (w > result);
+			} while (buff < end);
+			result += carry;
+			result = (result & 0xffff) + (result >> 16);
+		}
+		if (len & 2) {
+			result += *(unsigned short *) buff;
+			buff += 2;
+		}
+	}
+	if (len & 1)
+#ifdef __LITTLE_ENDIAN
+		result += *buff;
+#else
+		result += (*buff << 8);
+#endif
+	result = (result & 0xffff) + (result >> 16);
+	result = (result & 0xffff) + (result >> 16);
+	if (odd)
+		result = ((result >> 8) & 0xff) | ((result & 0xff) << 8);
+out:
+	return result;
+}
+
+static __wsum ref_csum_partial(const void *buff, int len, __wsum wsum)
+{
+	unsigned int sum = (__force unsigned int)wsum;
+	unsigned int result = ref_do_csum(buff, len);
+
+	result += sum;
+	if (sum > result)
+		result += 1;
+	return (__force __wsum)result;
+}
+
+static __wsum ref_csum_partial_copy(const void *src, void *dst, int len, __wsum sum)
+{
+	memcpy(dst, src, len);
+	return ref_csum_partial(dst, len, sum);
+}
+
+static __sum16 ref_ip_fast_csum(const void *iph, unsigned int ihl)
+{
+	return (__force __sum16)~ref_do_csum(iph, ihl * 4);
+}
+
+static int __init test_csum_check(const unsigned char *src, unsigned char *dst)
+{
+	int len, off;
+	__wsum sum = (__force __wsum)0x12345678;
+
+	for (off = 0; off < 8; off++) {
+		for (len = 0; len < 256 + 16; len++) {
+			if (csum_fold(csum_partial(src + off, len, sum)) !=
+			    csum_fold(ref_csum_partial(src + off, len, sum))) {
+				pr_err("csum_partial mismatch, off=%d len=%d\n", off, len);
+				return -EINVAL;
+			}
+			if (csum_fold(csum_partial_copy_nocheck(src + off, dst + (len & 7), len, sum)) !=
+			    csum_fold(ref_csum_partial(src + off, len, sum)) ||
+			    memcmp(src + off, dst + (len & 7), len)) {
+				pr_err("csum_partial_copy_nocheck mismatch, off=%d len=%d\n", off, len);
+				return -EINVAL;
+			}
+		}
+	}
+	for (len = 5; len <= 15; len++) {
+		if (ip_fast_csum(src, len) != ref_ip_fast_csum(src, len)) {
+			pr_err("ip_fast_csum mismatch, ihl=%d\n", len);
+			return -EINVAL;
+		}
+	}
+	return 0;
+}
+
+#define TIME_LOOP(ns, expr)					\
+do {								\
+	unsigned int __i;					\
+	ktime_t __t = ktime_get();				\
+								\
+	for (__i = 0; __i < loops; __i++)			\
+		expr;						\
+	ns = ktime_to_ns(ktime_sub(ktime_get(), __t));		\
+} while (0)
+
+static void __init test_csum_bench(const unsigned char *src, unsigned char *dst)
+{
+	static const int lens[] __initconst = { 20, 40, 64, 576, 1500, 4096 };
+	volatile __wsum sink;
+	s64 arch_ns, ref_ns;
+	int i, len;
+
+	TIME_LOOP(arch_ns, sink = (__force __wsum)ip_fast_csum(src, 5));
+	TIME_LOOP(ref_ns, sink = (__force __wsum)ref_ip_fast_csum(src, 5));
+	pr_info("ip_fast_csum: %lld ns vs generic %lld ns per %u\n", arch_ns, ref_ns, loops);
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		len = lens[i];
+		TIME_LOOP(arch_ns, sink = csum_partial(src, len, 0));
+		TIME_LOOP(ref_ns, sink = ref_csum_partial(src, len, 0));
+		pr_info("csum_partial %4d: %lld ns vs generic %lld ns per %u\n", len, arch_ns, ref_ns, loops);
+		TIME_LOOP(arch_ns, sink = csum_partial_copy_nocheck(src, dst, len, 0));
+		TIME_LOOP(ref_ns, sink = ref_csum_partial_copy(src, dst, len, 0));
+		pr_info("csum_partial_copy %4d: %lld ns vs generic %lld ns per %u\n", len, arch_ns, ref_ns, loops);
+	}
+	(void)sink;
+}
+
+static int __init test_csum_init(void)
+{
+	unsigned char *src, *dst;
+	int ret;
+
+	src = kmalloc(BUF_SIZE + 16, GFP_KERNEL);
+	dst = kmalloc(BUF_SIZE + 16, GFP_KERNEL);
+	if (!src || !dst) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	get_random_bytes(src, BUF_SIZE + 16);
+
+	ret = test_csum_check(src, dst);
+	if (ret == 0) {
+		test_csum_bench(src, dst);
+		pr_info("tests passed.\n");
+	}
+out:
+	kfree(src);
+	kfree(dst);
+	return ret;
+}
+
+module_init(test_csum_init);
+
+static void __exit test_csum_exit(void)
+{
+	pr_info("unloaded.\n");
+}
+
+module_exit(test_csum_exit);
+
+MODULE_LICENSE("GPL");
@@ -0,0 +1,217 @@
+/*
+ * memcpy microbenchmark: checks memcpy(), memmove(), copy_page() and the
+ * user copy routines of the running kernel against a byte loop, then times
+ * them for each size class, to compare CPU specific versions.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/ktime.h>
+#include <linux/mm.h>
+#include <linux/mman.h>
+#include <linux/random.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/uaccess.h>
+
+#define BUF_SIZE	(2 * PAGE_SIZE)
+#define CHECK_LEN	256
+#define LOOPS		10000
+
+static unsigned int loops = LOOPS;
+module_param(loops, uint, 0444);
+MODULE_PARM_DESC(loops, "iterations per measurement");
+
+static void ref_memcpy(void *dst, const void *src, size_t len)
+{
+	unsigned char *d = dst;
+	const unsigned char *s = src;
+
+	while (len--)
+		*d++ = *s++;
+}
+
+static int __init test_memcpy_check(unsigned char *src, unsigned char *dst,
+				    unsigned char *ref)
+{
+	int len, soff, doff;
+
+	for (soff = 0; soff < 16; soff++) {
+		for (doff = 0; doff < 16; doff++) {
+			for (len = 0; len < CHECK_LEN; len++) {
+				memset(dst, 0xa5, CHECK_LEN + 32);
+				memset(ref, 0xa5, CHECK_LEN + 32);
+				memcpy(dst + doff, src + soff, len);
+				ref_memcpy(ref + doff, src + soff, len);
+				if (memcmp(dst, ref, CHECK_LEN + 32)) {
+					pr_err("memcpy mismatch, soff=%d doff=%d len=%d\n",
+					       soff, doff, len);
+					return -EINVAL;
+				}
+			}
+		}
+	}
+
+	/* memmove() relies on memcpy() for a forward overlapping copy */
+	for (soff = 1; soff < 80; soff++) {
+		for (len = 0; len < CHECK_LEN; len++) {
+			memcpy(dst, src, CHECK_LEN + 80);
+			memmove(dst, dst + soff, len);
+			memcpy(ref, src, CHECK_LEN + 80);
+			ref_memcpy(ref, ref + soff, len);
+			if (memcmp(dst, ref, CHECK_LEN + 80)) {
+				pr_err("memmove mismatch, off=%d len=%d\n", soff, len);
+				return -EINVAL;
+			}
+		}
+	}
+
+	copy_page(dst, src);
+	if (memcmp(dst, src, PAGE_SIZE)) {
+		pr_err("copy_page mismatch\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int __init test_user_copy_check(unsigned char *src, unsigned char *dst,
+				       char __user *usermem)
+{
+	int len, off;
+
+	for (off = 0; off < 16; off++) {
+		for (len = 0; len < CHECK_LEN + 64; len++) {
+			memset(dst, 0xa5, len);
+			if (copy_to_user(usermem + off, src, len) ||
+			    copy_from_user(dst, usermem + off, len) ||
+			    memcmp(dst, src, len)) {
+				pr_err("user copy mismatch, off=%d len=%d\n", off, len);
+				return -EINVAL;
+			}
+		}
+	}
+	return 0;
+}
+
+static int __init test_user_fault_check(unsigned char *src, unsigned char *dst,
+					char __user *usermem)
+{
+	unsigned long left;
+
+	if (copy_to_user(usermem, src, PAGE_SIZE))
+		return -EFAULT;
+	/* the second page is gone: the tail must be reported and zeroed */
+	memset(dst, 0xa5, 200);
+	left = copy_from_user(dst, usermem + PAGE_SIZE - 100, 200);
+	if (left < 100 || left > 200 || memchr_inv(dst + 200 - left, 0, left) ||
+	    memcmp(dst, src + PAGE_SIZE - 100, 200 - left)) {
+		pr_err("copy_from_user fault handling, %lu left\n", left);
+		return -EINVAL;
+	}
+	left = copy_to_user(usermem + PAGE_SIZE - 100, src, 200);
+	if (left < 100 || left > 200) {
+		pr_err("copy_to_user fault handling, %lu left\n", left);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+#define TIME_LOOP(ns, expr)					\
+do {								\
+	unsigned int __i;					\
+	ktime_t __t = ktime_get();				\
+								\
+	for (__i = 0; __i < loops; __i++)			\
+		expr;						\
+	ns = ktime_to_ns(ktime_sub(ktime_get(), __t));		\
+} while (0)
+
+static void __init test_memcpy_bench(unsigned char *src, unsigned char *dst,
+				     char __user *usermem)
+{
+	static const int lens[] __initconst = { 8, 16, 32, 64, 128, 256, 1024, 4096 };
+	unsigned long left = 0;
+	s64 ns, ref_ns;
+	int i, len;
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		len = lens[i];
+		TIME_LOOP(ns, memcpy(dst, src, len));
+		TIME_LOOP(ref_ns, ref_memcpy(dst, src, len));
+		pr_info("memcpy %4d: %lld ns vs byte loop %lld ns per %u\n", len, ns, ref_ns, loops);
+		TIME_LOOP(ns, memcpy(dst + 1, src + 3, len));
+		pr_info("memcpy unaligned %4d: %lld ns per %u\n", len, ns, loops);
+		TIME_LOOP(ns, left |= copy_to_user(usermem, src, len));
+		TIME_LOOP(ref_ns, left |= copy_from_user(dst, usermem, len));
+		pr_info("copy_to_user %4d: %lld ns, copy_from_user %lld ns per %u\n",
+			len, ns, ref_ns, loops);
+	}
+	TIME_LOOP(ns, copy_page(dst, src));
+	pr_info("copy_page: %lld ns per %u\n", ns, loops);
+	if (left)
+		pr_warn("user copies faulted during the benchmark\n");
+}
+
+static int __init test_memcpy_init(void)
+{
+	unsigned char *src, *dst, *ref;
+	unsigned long user_addr;
+	int ret;
+
+	src = kmalloc(BUF_SIZE, GFP_KERNEL);
+	dst = kmalloc(BUF_SIZE, GFP_KERNEL);
+	ref = kmalloc(BUF_SIZE, GFP_KERNEL);
+	if (!src || !dst || !ref) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	get_random_bytes(src, BUF_SIZE);
+
+	user_addr = vm_mmap(NULL, 0, BUF_SIZE, PROT_READ | PROT_WRITE,
+			    MAP_ANONYMOUS | MAP_PRIVATE, 0);
+	if (user_addr >= (unsigned long)(TASK_SIZE)) {
+		pr_warn("Failed to allocate user memory\n");
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	ret = test_memcpy_check(src, dst, ref);
+	if (ret == 0)
+		ret = test_user_copy_check(src, dst, (char __user *)user_addr);
+	if (ret == 0)
+		test_memcpy_bench(src, dst, (char __user *)user_addr);
+	vm_munmap(user_addr + PAGE_SIZE, PAGE_SIZE);
+	if (ret == 0)
+		ret = test_user_fault_check(src, dst, (char __user *)user_addr);
+	vm_munmap(user_addr, PAGE_SIZE);
+	if (ret == 0)
+		pr_info("tests passed.\n");
+out:
+	kfree(src);
+	kfree(dst);
+	kfree(ref);
+	return ret;
+}
+
+module_init(test_memcpy_init);
+
+static void __exit test_memcpy_exit(void)
+{
+	pr_info("unloaded.\n");
+}
+
+module_exit(test_memcpy_exit);
+
+MODULE_LICENSE("GPL");
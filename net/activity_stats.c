@@ -17,7 +17,14 @@
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
 #include <linux/suspend.h>
+#include <linux/hashtable.h>
+#include <linux/slab.h>
+#include <linux/tcp.h>
+#include <linux/activity_stats.h>
 #include <net/net_namespace.h>
+#include <net/genetlink.h>
+#include <net/sock.h>
+#include <net/activity_stats.h>
 
 /*
  * Track transmission rates in buckets (power of 2).
@@ -60,6 +67,234 @@ void activity_stats_update(void)
 	spin_unlock_irqrestore(&activity_lock, flags);
 }
 
+/*
+ * Per (interface, uid) TCP/UDP socket statistics, fed from the socket
+ * sendmsg/recvmsg paths and read back over generic netlink.
+ */
+#define SOCK_STATS_HASH_BITS	6
+#define SOCK_STATS_MAX		256
+
+struct sock_stats_entry {
+	struct hlist_node node;
+	struct activity_sock_stats stats;
+};
+
+static DEFINE_HASHTABLE(sock_stats_hash, SOCK_STATS_HASH_BITS);
+static unsigned int sock_stats_count;
+static unsigned long sock_stats_dropped;
+static DEFINE_SPINLOCK(sock_stats_lock);
+
+static bool sock_stats_wanted(const struct sock *sk)
+{
+	if (sk->sk_family != AF_INET && sk->sk_family != AF_INET6)
+		return false;
+
+	return sk->sk_protocol == IPPROTO_TCP || sk->sk_protocol == IPPROTO_UDP;
+}
+
+static void sock_stats_dev(struct sock *sk, u32 *ifindex, char *ifname)
+{
+	struct dst_entry *dst = sk_dst_get(sk);
+
+	*ifindex = 0;
+	ifname[0] = '\0';
+	if (dst) {
+		if (dst->dev) {
+			*ifindex = dst->dev->ifindex;
+			strlcpy(ifname, dst->dev->name,
+				ACTIVITY_STATS_IFNAMSIZ);
+		}
+		dst_release(dst);
+	} else if (sk->sk_bound_dev_if) {
+		*ifindex = sk->sk_bound_dev_if;
+	}
+}
+
+/* Called with sock_stats_lock held. */
+static struct activity_sock_stats *sock_stats_get(u32 ifindex,
+						   const char *ifname, u32 uid)
+{
+	struct sock_stats_entry *e;
+	u32 key = (ifindex << 16) ^ uid;
+
+	hash_for_each_possible(sock_stats_hash, e, node, key) {
+		if (e->stats.ifindex == ifindex && e->stats.uid == uid)
+			goto found;
+	}
+
+	if (sock_stats_count >= SOCK_STATS_MAX)
+		return NULL;
+	e = kzalloc(sizeof(*e), GFP_ATOMIC);
+	if (!e)
+		return NULL;
+	e->stats.ifindex = ifindex;
+	e->stats.uid = uid;
+	hash_add(sock_stats_hash, &e->node, key);
+	sock_stats_count++;
+found:
+	/* interfaces such as ccmni are renamed and reused, keep the latest */
+	if (ifname[0])
+		strlcpy(e->stats.ifname, ifname, ACTIVITY_STATS_IFNAMSIZ);
+	return &e->stats;
+}
+
+static unsigned int sock_stats_lat_bucket(ktime_t start)
+{
+	s64 us = ktime_us_delta(ktime_get(), start);
+
+	if (us <= 0)
+		return 0;
+	return min_t(unsigned int, fls64(us), ACTIVITY_STATS_LAT_BUCKETS - 1);
+}
+
+static unsigned int sock_stats_occ_bucket(int used, int size)
+{
+	if (size <= 0 || used <= 0)
+		return 0;
+	return min_t(unsigned int, (u64)used * ACTIVITY_STATS_OCC_BUCKETS / size,
+		     ACTIVITY_STATS_OCC_BUCKETS - 1);
+}
+
+/*
+ * Account one sendmsg (tx) or recvmsg call on @sk that started at @start and
+ * returned @ret. Calls that moved no data are not counted.
+ */
+void activity_stats_sock_xfer(struct sock *sk, ktime_t start, int ret,
+			      bool tx)
+{
+	struct activity_sock_stats *st;
+	char ifname[ACTIVITY_STATS_IFNAMSIZ];
+	unsigned int lat, occ;
+	unsigned long flags;
+	u32 ifindex, uid;
+
+	if (ret <= 0 || !sk || !sock_stats_wanted(sk))
+		return;
+
+	lat = sock_stats_lat_bucket(start);
+	if (tx)
+		occ = sock_stats_occ_bucket(sk->sk_wmem_queued, sk->sk_sndbuf);
+	else
+		occ = sock_stats_occ_bucket(atomic_read(&sk->sk_rmem_alloc),
+					    sk->sk_rcvbuf);
+	uid = from_kuid_munged(&init_user_ns, sock_i_uid(sk));
+	sock_stats_dev(sk, &ifindex, ifname);
+
+	spin_lock_irqsave(&sock_stats_lock, flags);
+	st = sock_stats_get(ifindex, ifname, uid);
+	if (!st) {
+		sock_stats_dropped++;
+	} else if (tx) {
+		st->tx_bytes += ret;
+		st->tx_calls++;
+		st->tx_lat[lat]++;
+		st->sndbuf_occ[occ]++;
+	} else {
+		st->rx_bytes += ret;
+		st->rx_calls++;
+		st->rx_lat[lat]++;
+		st->rcvbuf_occ[occ]++;
+	}
+	spin_unlock_irqrestore(&sock_stats_lock, flags);
+}
+
+/* Fold the retransmit count of a TCP socket in when it goes away. */
+void activity_stats_sock_release(struct sock *sk)
+{
+	struct activity_sock_stats *st;
+	char ifname[ACTIVITY_STATS_IFNAMSIZ];
+	unsigned long flags;
+	u32 ifindex, uid, retrans;
+
+	if (!sk || sk->sk_protocol != IPPROTO_TCP || !sock_stats_wanted(sk))
+		return;
+
+	retrans = tcp_sk(sk)->total_retrans;
+	if (!retrans)
+		return;
+	uid = from_kuid_munged(&init_user_ns, sock_i_uid(sk));
+	sock_stats_dev(sk, &ifindex, ifname);
+
+	spin_lock_irqsave(&sock_stats_lock, flags);
+	st = sock_stats_get(ifindex, ifname, uid);
+	if (st)
+		st->tcp_retrans += retrans;
+	else
+		sock_stats_dropped++;
+	spin_unlock_irqrestore(&sock_stats_lock, flags);
+}
+
+static struct genl_family sock_stats_genl_family = {
+	.id = GENL_ID_GENERATE,
+	.name = ACTIVITY_STATS_GENL_NAME,
+	.hdrsize = 0,
+	.version = ACTIVITY_STATS_GENL_VERSION,
+	.maxattr = ACTIVITY_STATS_A_MAX,
+};
+
+static int sock_stats_genl_dump(struct sk_buff *skb, struct netlink_callback *cb)
+{
+	struct sock_stats_entry *e;
+	unsigned long flags;
+	int bkt, idx = 0, start = cb->args[0];
+	void *hdr;
+
+	spin_lock_irqsave(&sock_stats_lock, flags);
+	hash_for_each(sock_stats_hash, bkt, e, node) {
+		if (idx < start) {
+			idx++;
+			continue;
+		}
+		hdr = genlmsg_put(skb, NETLINK_CB(cb->skb).portid,
+				  cb->nlh->nlmsg_seq, &sock_stats_genl_family,
+				  NLM_F_MULTI, ACTIVITY_STATS_CMD_GET);
+		if (!hdr)
+			break;
+		if (nla_put(skb, ACTIVITY_STATS_A_SOCK, sizeof(e->stats),
+			    &e->stats)) {
+			genlmsg_cancel(skb, hdr);
+			break;
+		}
+		genlmsg_end(skb, hdr);
+		idx++;
+	}
+	spin_unlock_irqrestore(&sock_stats_lock, flags);
+
+	cb->args[0] = idx;
+	return skb->len;
+}
+
+static int sock_stats_genl_reset(struct sk_buff *skb, struct genl_info *info)
+{
+	struct sock_stats_entry *e;
+	struct hlist_node *tmp;
+	unsigned long flags;
+	int bkt;
+
+	spin_lock_irqsave(&sock_stats_lock, flags);
+	hash_for_each_safe(sock_stats_hash, bkt, tmp, e, node) {
+		hash_del(&e->node);
+		kfree(e);
+	}
+	sock_stats_count = 0;
+	sock_stats_dropped = 0;
+	spin_unlock_irqrestore(&sock_stats_lock, flags);
+
+	return 0;
+}
+
+static const struct genl_ops sock_stats_genl_ops[] = {
+	{
+		.cmd = ACTIVITY_STATS_CMD_GET,
+		.dumpit = sock_stats_genl_dump,
+	},
+	{
+		.cmd = ACTIVITY_STATS_CMD_RESET,
+		.doit = sock_stats_genl_reset,
+		.flags = GENL_ADMIN_PERM,
+	},
+};
+
 static int activity_stats_show(struct seq_file *m, void *v)
 {
 	int i;
@@ -73,6 +308,9 @@ static int activity_stats_show(struct seq_file *m, void *v)
 			return ret;
 	}
 
+	seq_printf(m, "Socket stats entries %u dropped %lu\n",
+		   sock_stats_count, sock_stats_dropped);
+
 	return 0;
 }
 
@@ -110,8 +348,14 @@ static struct notifier_block activity_stats_notifier_block = {
 
 static int  __init activity_stats_init(void)
 {
+	int ret;
+
 	proc_create("activity", S_IRUGO,
 		    init_net.proc_net_stat, &activity_stats_fops);
+	ret = genl_register_family_with_ops(&sock_stats_genl_family,
+					    sock_stats_genl_ops);
+	if (ret)
+		pr_err("activity_stats: genl register failed %d\n", ret);
 	return register_pm_notifier(&activity_stats_notifier_block);
 }
 
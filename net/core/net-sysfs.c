@@ -325,6 +325,36 @@ static ssize_t tx_queue_len_store(struct device *dev,
 }
 NETDEVICE_SHOW_RW(tx_queue_len, fmt_ulong);
 
+static int change_tsq_limit(struct net_device *dev, unsigned long new_limit)
+{
+	if (new_limit > INT_MAX)
+		return -EINVAL;
+	dev->tsq_limit = new_limit;
+	return 0;
+}
+
+static ssize_t tsq_limit_store(struct device *dev,
+			       struct device_attribute *attr,
+			       const char *buf, size_t len)
+{
+	return netdev_store(dev, attr, buf, len, change_tsq_limit);
+}
+NETDEVICE_SHOW_RW(tsq_limit, fmt_dec);
+
+static int change_tcp_pacing(struct net_device *dev, unsigned long pacing)
+{
+	dev->tcp_pacing = !!pacing;
+	return 0;
+}
+
+static ssize_t tcp_pacing_store(struct device *dev,
+				struct device_attribute *attr,
+				const char *buf, size_t len)
+{
+	return netdev_store(dev, attr, buf, len, change_tcp_pacing);
+}
+NETDEVICE_SHOW_RW(tcp_pacing, fmt_dec);
+
 static ssize_t ifalias_store(struct device *dev, struct device_attribute *attr,
 			     const char *buf, size_t len)
 {
@@ -422,6 +452,8 @@ static struct attribute *net_class_attrs[] = {
 	&dev_attr_mtu.attr,
 	&dev_attr_flags.attr,
 	&dev_attr_tx_queue_len.attr,
+	&dev_attr_tsq_limit.attr,
+	&dev_attr_tcp_pacing.attr,
 	&dev_attr_phys_port_id.attr,
 	NULL,
 };
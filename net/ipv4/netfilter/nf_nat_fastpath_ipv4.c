@@ -0,0 +1,495 @@
+/*
+ * Fast path for established, NATed IPv4 forwarding (tethering).
+ *
+ * Once conntrack has seen both directions of a forwarded TCP/UDP flow and
+ * the packet made it through FORWARD and SNAT, the flow is learned at
+ * POST_ROUTING. Later packets of that flow are matched on their 5-tuple at
+ * the very start of PRE_ROUTING, NATed, TTL decremented and handed to the
+ * neighbour layer of the egress device, skipping conntrack, NAT, routing and
+ * the iptables chains. Packet and byte counts are folded back into the
+ * conntrack accounting and the conntrack timeout is kept alive from a
+ * periodic worker.
+ *
+ * TCP SYN/FIN/RST, fragments, IP options, packets needing fragmentation
+ * and anything not in the table take the normal path.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/types.h>
+#include <linux/module.h>
+#include <linux/ip.h>
+#include <linux/tcp.h>
+#include <linux/udp.h>
+#include <linux/jhash.h>
+#include <linux/random.h>
+#include <linux/netdevice.h>
+#include <linux/netfilter.h>
+#include <linux/netfilter_ipv4.h>
+#include <linux/workqueue.h>
+#include <net/ip.h>
+#include <net/arp.h>
+#include <net/route.h>
+#include <net/checksum.h>
+#include <net/neighbour.h>
+#include <net/netfilter/nf_conntrack.h>
+#include <net/netfilter/nf_conntrack_acct.h>
+#include <net/netfilter/nf_conntrack_helper.h>
+#include <net/netfilter/nf_nat.h>
+
+#define NF_FP_HASH_BITS		10
+#define NF_FP_MAX_ENTRIES	4096
+#define NF_FP_SYNC_INTERVAL	HZ
+#define NF_FP_IDLE_TIMEOUT	(30 * HZ)
+/* conntrack of a flow on the fast path never gets closer than this to expiry */
+#define NF_FP_CT_TIMEOUT	(60 * HZ)
+
+static bool enable = true;
+module_param(enable, bool, 0644);
+MODULE_PARM_DESC(enable, "forward learned NAT flows from PRE_ROUTING");
+
+struct nf_fp_entry {
+	struct hlist_node	hnode;
+	struct rcu_head		rcu;
+
+	/* ingress packet as received */
+	int			iif;
+	__be32			saddr;
+	__be32			daddr;
+	__be16			sport;
+	__be16			dport;
+	u8			protonum;
+
+	/* what NAT turns it into */
+	__be32			new_saddr;
+	__be32			new_daddr;
+	__be16			new_sport;
+	__be16			new_dport;
+
+	struct dst_entry	*dst;
+	struct nf_conn		*ct;
+	enum ip_conntrack_dir	dir;
+
+	atomic_long_t		packets;	/* since last sync */
+	atomic_long_t		bytes;
+	unsigned long		last_used;
+	bool			dead;
+};
+
+static struct hlist_head nf_fp_hash[1 << NF_FP_HASH_BITS];
+static unsigned int nf_fp_count;
+static DEFINE_SPINLOCK(nf_fp_lock);
+static u32 nf_fp_rnd __read_mostly;
+
+static void nf_fp_sync_work(struct work_struct *work);
+static DECLARE_DELAYED_WORK(nf_fp_work, nf_fp_sync_work);
+
+static u32 nf_fp_hashfn(int iif, __be32 saddr, __be32 daddr,
+			__be16 sport, __be16 dport, u8 protonum)
+{
+	return jhash_3words((__force u32)saddr, (__force u32)daddr,
+			    ((__force u32)sport << 16 | (__force u32)dport) ^
+			    (protonum << 24) ^ iif, nf_fp_rnd) &
+	       ((1 << NF_FP_HASH_BITS) - 1);
+}
+
+static struct nf_fp_entry *nf_fp_lookup(int iif, __be32 saddr, __be32 daddr,
+					__be16 sport, __be16 dport, u8 protonum)
+{
+	struct nf_fp_entry *e;
+	u32 h = nf_fp_hashfn(iif, saddr, daddr, sport, dport, protonum);
+
+	hlist_for_each_entry_rcu(e, &nf_fp_hash[h], hnode) {
+		if (e->saddr == saddr && e->daddr == daddr &&
+		    e->sport == sport && e->dport == dport &&
+		    e->protonum == protonum && e->iif == iif)
+			return e;
+	}
+
+	return NULL;
+}
+
+static void nf_fp_free_rcu(struct rcu_head *head)
+{
+	struct nf_fp_entry *e = container_of(head, struct nf_fp_entry, rcu);
+
+	dst_release(e->dst);
+	nf_ct_put(e->ct);
+	kfree(e);
+}
+
+/* Called with nf_fp_lock held. */
+static void nf_fp_unlink(struct nf_fp_entry *e)
+{
+	hlist_del_rcu(&e->hnode);
+	nf_fp_count--;
+	call_rcu(&e->rcu, nf_fp_free_rcu);
+}
+
+static void nf_fp_flush(const struct net_device *dev)
+{
+	struct nf_fp_entry *e;
+	struct hlist_node *tmp;
+	int i;
+
+	spin_lock_bh(&nf_fp_lock);
+	for (i = 0; i < ARRAY_SIZE(nf_fp_hash); i++) {
+		hlist_for_each_entry_safe(e, tmp, &nf_fp_hash[i], hnode) {
+			if (!dev || e->dst->dev == dev || e->iif == dev->ifindex)
+				nf_fp_unlink(e);
+		}
+	}
+	spin_unlock_bh(&nf_fp_lock);
+}
+
+static void nf_fp_sync_acct(struct nf_fp_entry *e)
+{
+	struct nf_conn_acct *acct;
+	long packets = atomic_long_xchg(&e->packets, 0);
+	long bytes = atomic_long_xchg(&e->bytes, 0);
+
+	if (!packets)
+		return;
+
+	acct = nf_conn_acct_find(e->ct);
+	if (acct) {
+		atomic64_add(packets, &acct->counter[e->dir].packets);
+		atomic64_add(bytes, &acct->counter[e->dir].bytes);
+	}
+
+	/* the normal path refreshes the timeout per packet, do it here instead */
+	if (time_before(e->ct->timeout.expires, jiffies + NF_FP_CT_TIMEOUT))
+		mod_timer_pending(&e->ct->timeout, jiffies + NF_FP_CT_TIMEOUT);
+}
+
+static void nf_fp_sync_work(struct work_struct *work)
+{
+	struct nf_fp_entry *e;
+	struct hlist_node *tmp;
+	int i;
+
+	spin_lock_bh(&nf_fp_lock);
+	for (i = 0; i < ARRAY_SIZE(nf_fp_hash); i++) {
+		hlist_for_each_entry_safe(e, tmp, &nf_fp_hash[i], hnode) {
+			nf_fp_sync_acct(e);
+			if (e->dead || nf_ct_is_dying(e->ct) ||
+			    time_after(jiffies, e->last_used + NF_FP_IDLE_TIMEOUT))
+				nf_fp_unlink(e);
+		}
+	}
+	spin_unlock_bh(&nf_fp_lock);
+
+	schedule_delayed_work(&nf_fp_work, NF_FP_SYNC_INTERVAL);
+}
+
+/* Let the fast path skip TCP window tracking without making conntrack
+ * flag the next slow path packet of the flow as out of window. */
+static void nf_fp_tcp_liberal(struct nf_conn *ct)
+{
+	spin_lock_bh(&ct->lock);
+	ct->proto.tcp.seen[0].flags |= IP_CT_TCP_FLAG_BE_LIBERAL;
+	ct->proto.tcp.seen[1].flags |= IP_CT_TCP_FLAG_BE_LIBERAL;
+	spin_unlock_bh(&ct->lock);
+}
+
+static unsigned int nf_fp_learn(const struct nf_hook_ops *ops,
+				struct sk_buff *skb,
+				const struct net_device *in,
+				const struct net_device *out,
+				int (*okfn)(struct sk_buff *))
+{
+	const struct nf_conntrack_tuple *t, *rt;
+	enum ip_conntrack_info ctinfo;
+	enum ip_conntrack_dir dir;
+	struct nf_fp_entry *e;
+	struct nf_conn *ct;
+	const struct iphdr *iph = ip_hdr(skb);
+	u32 h;
+
+	if (!enable || !(IPCB(skb)->flags & IPSKB_FORWARDED) || !skb_dst(skb))
+		return NF_ACCEPT;
+	if (iph->protocol != IPPROTO_TCP && iph->protocol != IPPROTO_UDP)
+		return NF_ACCEPT;
+
+	ct = nf_ct_get(skb, &ctinfo);
+	if (!ct || nf_ct_is_untracked(ct) || !nf_ct_is_confirmed(ct) ||
+	    !(ct->status & IPS_NAT_DONE_MASK) || !test_bit(IPS_ASSURED_BIT, &ct->status) ||
+	    (ctinfo != IP_CT_ESTABLISHED && ctinfo != IP_CT_ESTABLISHED_REPLY))
+		return NF_ACCEPT;
+	/* helpers (ftp, pptp...) need to see every packet */
+	if (nfct_help(ct))
+		return NF_ACCEPT;
+	if (iph->protocol == IPPROTO_TCP &&
+	    ct->proto.tcp.state != TCP_CONNTRACK_ESTABLISHED)
+		return NF_ACCEPT;
+
+	dir = CTINFO2DIR(ctinfo);
+	t = &ct->tuplehash[dir].tuple;
+	rt = &ct->tuplehash[!dir].tuple;
+
+	/* only flows whose NAT result is what this packet carries */
+	if (iph->saddr != rt->dst.u3.ip || iph->daddr != rt->src.u3.ip)
+		return NF_ACCEPT;
+
+	rcu_read_lock();
+	e = nf_fp_lookup(skb->skb_iif, t->src.u3.ip, t->dst.u3.ip,
+			 t->src.u.all, t->dst.u.all, t->dst.protonum);
+	rcu_read_unlock();
+	if (e)
+		return NF_ACCEPT;
+
+	e = kzalloc(sizeof(*e), GFP_ATOMIC);
+	if (!e)
+		return NF_ACCEPT;
+
+	e->iif = skb->skb_iif;
+	e->saddr = t->src.u3.ip;
+	e->daddr = t->dst.u3.ip;
+	e->sport = t->src.u.all;
+	e->dport = t->dst.u.all;
+	e->protonum = t->dst.protonum;
+	e->new_saddr = rt->dst.u3.ip;
+	e->new_daddr = rt->src.u3.ip;
+	e->new_sport = rt->dst.u.all;
+	e->new_dport = rt->src.u.all;
+	e->dir = dir;
+	e->last_used = jiffies;
+	atomic_long_set(&e->packets, 0);
+	atomic_long_set(&e->bytes, 0);
+
+	if (e->protonum == IPPROTO_TCP)
+		nf_fp_tcp_liberal(ct);
+
+	h = nf_fp_hashfn(e->iif, e->saddr, e->daddr, e->sport, e->dport,
+			 e->protonum);
+	spin_lock_bh(&nf_fp_lock);
+	if (nf_fp_count >= NF_FP_MAX_ENTRIES ||
+	    nf_fp_lookup(e->iif, e->saddr, e->daddr, e->sport, e->dport,
+			 e->protonum)) {
+		spin_unlock_bh(&nf_fp_lock);
+		kfree(e);
+		return NF_ACCEPT;
+	}
+	e->dst = dst_clone(skb_dst(skb));
+	nf_conntrack_get(&ct->ct_general);
+	e->ct = ct;
+	hlist_add_head_rcu(&e->hnode, &nf_fp_hash[h]);
+	nf_fp_count++;
+	spin_unlock_bh(&nf_fp_lock);
+
+	return NF_ACCEPT;
+}
+
+static void nf_fp_kill(struct nf_fp_entry *e)
+{
+	/* unlinked by the sync worker, the ct sees this packet normally */
+	e->dead = true;
+}
+
+static int nf_fp_xmit(struct sk_buff *skb, struct dst_entry *dst)
+{
+	struct rtable *rt = (struct rtable *)dst;
+	struct net_device *dev = dst->dev;
+	unsigned int hh_len = LL_RESERVED_SPACE(dev);
+	struct neighbour *neigh;
+	u32 nexthop;
+	int ret;
+
+	if (unlikely(skb_headroom(skb) < hh_len && dev->header_ops)) {
+		struct sk_buff *skb2 = skb_realloc_headroom(skb, hh_len);
+
+		kfree_skb(skb);
+		if (!skb2)
+			return -ENOMEM;
+		skb = skb2;
+	}
+
+	skb_dst_set(skb, dst_clone(dst));
+	skb->dev = dev;
+	skb->protocol = htons(ETH_P_IP);
+
+	rcu_read_lock_bh();
+	nexthop = (__force u32)rt_nexthop(rt, ip_hdr(skb)->daddr);
+	neigh = __ipv4_neigh_lookup_noref(dev, nexthop);
+	if (unlikely(!neigh))
+		neigh = __neigh_create(&arp_tbl, &nexthop, dev, false);
+	if (!IS_ERR(neigh)) {
+		ret = dst_neigh_output(dst, neigh, skb);
+	} else {
+		kfree_skb(skb);
+		ret = -EINVAL;
+	}
+	rcu_read_unlock_bh();
+
+	return ret;
+}
+
+static unsigned int nf_fp_ingress(const struct nf_hook_ops *ops,
+				  struct sk_buff *skb,
+				  const struct net_device *in,
+				  const struct net_device *out,
+				  int (*okfn)(struct sk_buff *))
+{
+	struct nf_fp_entry *e;
+	struct dst_entry *dst;
+	struct iphdr *iph;
+	__be16 *ports;
+	__sum16 *check = NULL;
+	unsigned int thoff, l4len, mtu;
+
+	if (!enable || skb->pkt_type != PACKET_HOST || skb->nfct)
+		return NF_ACCEPT;
+	if (!pskb_may_pull(skb, sizeof(struct iphdr)))
+		return NF_ACCEPT;
+
+	iph = ip_hdr(skb);
+	if (iph->ihl != 5 || ip_is_fragment(iph) || iph->ttl <= 1)
+		return NF_ACCEPT;
+	if (iph->protocol == IPPROTO_TCP)
+		l4len = sizeof(struct tcphdr);
+	else if (iph->protocol == IPPROTO_UDP)
+		l4len = sizeof(struct udphdr);
+	else
+		return NF_ACCEPT;
+
+	thoff = sizeof(struct iphdr);
+	if (!pskb_may_pull(skb, thoff + l4len))
+		return NF_ACCEPT;
+	iph = ip_hdr(skb);
+	ports = (__be16 *)(skb_network_header(skb) + thoff);
+
+	e = nf_fp_lookup(in->ifindex, iph->saddr, iph->daddr, ports[0],
+			 ports[1], iph->protocol);
+	if (!e || e->dead)
+		return NF_ACCEPT;
+
+	if (iph->protocol == IPPROTO_TCP) {
+		struct tcphdr *th = (struct tcphdr *)ports;
+
+		if (th->syn || th->fin || th->rst) {
+			nf_fp_kill(e);
+			return NF_ACCEPT;
+		}
+	}
+
+	dst = e->dst;
+	/* route changed since the flow was learned */
+	if (!dst_check(dst, 0)) {
+		nf_fp_kill(e);
+		return NF_ACCEPT;
+	}
+	mtu = dst_mtu(dst);
+	if (skb_is_gso(skb) ? skb_gso_network_seglen(skb) > mtu : skb->len > mtu)
+		return NF_ACCEPT;
+
+	if (!skb_make_writable(skb, thoff + l4len))
+		return NF_ACCEPT;
+	iph = ip_hdr(skb);
+	ports = (__be16 *)(skb_network_header(skb) + thoff);
+
+	if (iph->protocol == IPPROTO_TCP) {
+		check = &((struct tcphdr *)ports)->check;
+	} else {
+		struct udphdr *uh = (struct udphdr *)ports;
+
+		if (uh->check || skb->ip_summed == CHECKSUM_PARTIAL)
+			check = &uh->check;
+	}
+
+	if (check) {
+		inet_proto_csum_replace4(check, skb, iph->saddr, e->new_saddr, 1);
+		inet_proto_csum_replace4(check, skb, iph->daddr, e->new_daddr, 1);
+		inet_proto_csum_replace2(check, skb, ports[0], e->new_sport, 0);
+		inet_proto_csum_replace2(check, skb, ports[1], e->new_dport, 0);
+		if (iph->protocol == IPPROTO_UDP && !*check)
+			*check = CSUM_MANGLED_0;
+	}
+	ports[0] = e->new_sport;
+	ports[1] = e->new_dport;
+	csum_replace4(&iph->check, iph->saddr, e->new_saddr);
+	csum_replace4(&iph->check, iph->daddr, e->new_daddr);
+	iph->saddr = e->new_saddr;
+	iph->daddr = e->new_daddr;
+	ip_decrease_ttl(iph);
+
+	atomic_long_inc(&e->packets);
+	atomic_long_add(skb->len, &e->bytes);
+	e->last_used = jiffies;
+
+	skb_dst_drop(skb);
+	nf_reset(skb);
+	nf_fp_xmit(skb, dst);
+
+	return NF_STOLEN;
+}
+
+static struct nf_hook_ops nf_fp_ops[] __read_mostly = {
+	{
+		.hook		= nf_fp_ingress,
+		.owner		= THIS_MODULE,
+		.pf		= NFPROTO_IPV4,
+		.hooknum	= NF_INET_PRE_ROUTING,
+		.priority	= NF_IP_PRI_FIRST,
+	},
+	{
+		/* after FORWARD filtering and SNAT, before confirm */
+		.hook		= nf_fp_learn,
+		.owner		= THIS_MODULE,
+		.pf		= NFPROTO_IPV4,
+		.hooknum	= NF_INET_POST_ROUTING,
+		.priority	= NF_IP_PRI_NAT_SRC + 1,
+	},
+};
+
+static int nf_fp_netdev_event(struct notifier_block *this,
+			      unsigned long event, void *ptr)
+{
+	struct net_device *dev = netdev_notifier_info_to_dev(ptr);
+
+	if (event == NETDEV_DOWN || event == NETDEV_UNREGISTER ||
+	    event == NETDEV_CHANGEMTU)
+		nf_fp_flush(dev);
+
+	return NOTIFY_DONE;
+}
+
+static struct notifier_block nf_fp_netdev_notifier = {
+	.notifier_call	= nf_fp_netdev_event,
+};
+
+static int __init nf_nat_fastpath_ipv4_init(void)
+{
+	int ret;
+
+	get_random_bytes(&nf_fp_rnd, sizeof(nf_fp_rnd));
+
+	ret = register_netdevice_notifier(&nf_fp_netdev_notifier);
+	if (ret < 0)
+		return ret;
+
+	ret = nf_register_hooks(nf_fp_ops, ARRAY_SIZE(nf_fp_ops));
+	if (ret < 0) {
+		unregister_netdevice_notifier(&nf_fp_netdev_notifier);
+		return ret;
+	}
+
+	schedule_delayed_work(&nf_fp_work, NF_FP_SYNC_INTERVAL);
+	return 0;
+}
+
+static void __exit nf_nat_fastpath_ipv4_exit(void)
+{
+	nf_unregister_hooks(nf_fp_ops, ARRAY_SIZE(nf_fp_ops));
+	unregister_netdevice_notifier(&nf_fp_netdev_notifier);
+	cancel_delayed_work_sync(&nf_fp_work);
+	nf_fp_flush(NULL);
+	rcu_barrier();
+}
+
+module_init(nf_nat_fastpath_ipv4_init);
+module_exit(nf_nat_fastpath_ipv4_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("IPv4 NAT forwarding fast path for established flows");
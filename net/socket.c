@@ -107,6 +107,7 @@
 #include <linux/sockios.h>
 #include <linux/atalk.h>
 #include <net/busy_poll.h>
+#include <net/activity_stats.h>
 #include <linux/errqueue.h>
 
 #ifdef CONFIG_NET_RX_BUSY_POLL
@@ -591,6 +592,7 @@ void sock_release(struct socket *sock)
 	if (sock->ops) {
 		struct module *owner = sock->ops->owner;
 
+		activity_stats_sock_release(sock->sk);
 		sock->ops->release(sock);
 		sock->ops = NULL;
 		module_put(owner);
@@ -635,13 +637,18 @@ static inline int __sock_sendmsg_nosec(struct kiocb *iocb, struct socket *sock,
 				       struct msghdr *msg, size_t size)
 {
 	struct sock_iocb *si = kiocb_to_siocb(iocb);
+	ktime_t start;
+	int ret;
 
 	si->sock = sock;
 	si->scm = NULL;
 	si->msg = msg;
 	si->size = size;
 
-	return sock->ops->sendmsg(iocb, sock, msg, size);
+	start = activity_stats_sock_start();
+	ret = sock->ops->sendmsg(iocb, sock, msg, size);
+	activity_stats_sock_xfer(sock->sk, start, ret, true);
+	return ret;
 }
 
 static inline int __sock_sendmsg(struct kiocb *iocb, struct socket *sock,
@@ -781,6 +788,8 @@ static inline int __sock_recvmsg_nosec(struct kiocb *iocb, struct socket *sock,
 				       struct msghdr *msg, size_t size, int flags)
 {
 	struct sock_iocb *si = kiocb_to_siocb(iocb);
+	ktime_t start;
+	int ret;
 
 	si->sock = sock;
 	si->scm = NULL;
@@ -788,7 +797,10 @@ static inline int __sock_recvmsg_nosec(struct kiocb *iocb, struct socket *sock,
 	si->size = size;
 	si->flags = flags;
 
-	return sock->ops->recvmsg(iocb, sock, msg, size, flags);
+	start = activity_stats_sock_start();
+	ret = sock->ops->recvmsg(iocb, sock, msg, size, flags);
+	activity_stats_sock_xfer(sock->sk, start, ret, false);
+	return ret;
 }
 
 static inline int __sock_recvmsg(struct kiocb *iocb, struct socket *sock,
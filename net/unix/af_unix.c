@@ -362,6 +362,7 @@ static void unix_sock_destructor(struct sock *sk)
 	struct unix_sock *u = unix_sk(sk);
 
 	skb_queue_purge(&sk->sk_receive_queue);
+	skb_queue_purge(&u->skb_cache);
 
 	WARN_ON(atomic_read(&sk->sk_wmem_alloc));
 	WARN_ON(!sk_unhashed(sk));
@@ -654,6 +655,7 @@ static struct sock *unix_create1(struct net *net, struct socket *sock)
 	INIT_LIST_HEAD(&u->link);
 	mutex_init(&u->readlock); /* single task reading lock */
 	init_waitqueue_head(&u->peer_wait);
+	skb_queue_head_init(&u->skb_cache);
 	unix_insert_socket(unix_sockets_unbound(sk), sk);
 out:
 	if (sk == NULL)
@@ -1465,6 +1467,71 @@ static void maybe_add_creds(struct sk_buff *skb, const struct socket *sock,
  *	Send AF_UNIX data.
  */
 
+/*
+ * Small datagrams reuse the skbs their receiver is done with: the reader
+ * hands a small linear skb back to the socket that sent it instead of
+ * freeing it, and the next send from that socket takes it again.
+ */
+#define UNIX_SKB_CACHE_LEN	8
+#define UNIX_SKB_CACHE_MAX	2048
+
+static struct sk_buff *unix_skb_cache_get(struct sock *sk, size_t len)
+{
+	struct sk_buff *skb;
+
+	/* the slow path reports errors and waits for send buffer space */
+	if (len > UNIX_SKB_CACHE_MAX || sk->sk_err ||
+	    (sk->sk_shutdown & SEND_SHUTDOWN) ||
+	    atomic_read(&sk->sk_wmem_alloc) >= sk->sk_sndbuf)
+		return NULL;
+
+	skb = skb_dequeue(&unix_sk(sk)->skb_cache);
+	if (!skb)
+		return NULL;
+	if (skb_tailroom(skb) < (int)len) {
+		consume_skb(skb);
+		return NULL;
+	}
+
+	skb_set_owner_w(skb, sk);
+	return skb;
+}
+
+static void unix_skb_recycle(struct sk_buff *skb)
+{
+	struct sock *owner = skb->sk;
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+
+	if (!owner || atomic_read(&skb->users) != 1 || skb_cloned(skb) ||
+	    skb_is_nonlinear(skb) || skb->head_frag || skb->pfmemalloc ||
+	    skb_end_offset(skb) > UNIX_SKB_CACHE_MAX ||
+	    sock_flag(owner, SOCK_DEAD) ||
+	    skb_queue_len(&unix_sk(owner)->skb_cache) >= UNIX_SKB_CACHE_LEN)
+		goto free;
+
+	/* the wmem charge keeps the sender around, not its refcount */
+	if (!atomic_inc_not_zero(&owner->sk_refcnt))
+		goto free;
+
+	skb_orphan(skb);
+
+	/* back to the state __alloc_skb() left it in */
+	memset(shinfo, 0, offsetof(struct skb_shared_info, dataref));
+	atomic_set(&shinfo->dataref, 1);
+	memset(skb, 0, offsetof(struct sk_buff, tail));
+	skb->data = skb->head;
+	skb_reset_tail_pointer(skb);
+	skb->mac_header = (typeof(skb->mac_header))~0U;
+	skb->transport_header = (typeof(skb->transport_header))~0U;
+
+	skb_queue_tail(&unix_sk(owner)->skb_cache, skb);
+	sock_put(owner);
+	return;
+
+free:
+	consume_skb(skb);
+}
+
 static int unix_dgram_sendmsg(struct kiocb *kiocb, struct socket *sock,
 			      struct msghdr *msg, size_t len)
 {
@@ -1524,9 +1591,11 @@ static int unix_dgram_sendmsg(struct kiocb *kiocb, struct socket *sock,
 		BUILD_BUG_ON(SKB_MAX_ALLOC < PAGE_SIZE);
 	}
 
-	skb = sock_alloc_send_pskb(sk, len - data_len, data_len,
-				   msg->msg_flags & MSG_DONTWAIT, &err,
-				   PAGE_ALLOC_COSTLY_ORDER);
+	skb = unix_skb_cache_get(sk, len);
+	if (skb == NULL)
+		skb = sock_alloc_send_pskb(sk, len - data_len, data_len,
+					   msg->msg_flags & MSG_DONTWAIT, &err,
+					   PAGE_ALLOC_COSTLY_ORDER);
 	if (skb == NULL)
 		goto out;
 
@@ -1911,7 +1980,7 @@ static int unix_dgram_recvmsg(struct kiocb *iocb, struct socket *sock,
 	scm_recv(sock, msg, siocb->scm, flags);
 
 out_free:
-	skb_free_datagram(sk, skb);
+	unix_skb_recycle(skb);
 out_unlock:
 	mutex_unlock(&u->readlock);
 out:
@@ -102,6 +102,11 @@ struct AFE_OFFLOAD_T {		/* doug */
 	bool write_blocked;
 	bool firstbuf;
 	bool wakelock;
+	kal_uint32 low_watermark;	/* wake the writer below this many bytes */
+	kal_uint64 drain_boundary;	/* copied_total at the end of the current track */
+	bool partial_drain;
+	kal_uint32 encoder_delay;
+	kal_uint32 encoder_padding;
 };
 
 struct AFE_OFFLOAD_SERVICE_T {
@@ -103,6 +103,8 @@ static bool mPrepareDone;
 #define USE_PERIODS_MAX     8192
 #define OFFLOAD_SIZE_MB     24
 #define OFFLOAD_SIZE_BYTES  (OFFLOAD_SIZE_MB<<20)
+/* refill the data ring only when less than this much audio is left */
+#define OFFLOAD_LOW_WATERMARK_MS    1000
 
 static struct snd_pcm_hardware mtk_pcm_dl2_hardware = {
 	.info = (SNDRV_PCM_INFO_MMAP |
@@ -144,6 +146,11 @@ static struct AFE_OFFLOAD_T afe_offload_block = {
 	.copied            = 0,
 	.firstbuf          = false,
 	.wakelock          = false,
+	.low_watermark     = 0,
+	.drain_boundary    = 0,
+	.partial_drain     = false,
+	.encoder_delay     = 0,
+	.encoder_padding   = 0,
 };
 
 
@@ -155,6 +162,60 @@ static struct AFE_OFFLOAD_T afe_offload_block = {
 ============================================================================================================
 */
 
+static kal_uint32 mtk_compr_offload_gdma_int_data_remained(void)
+{
+	if (afe_offload_block.u4WriteIdx >= afe_offload_block.u4ReadIdx)
+		return afe_offload_block.u4WriteIdx - afe_offload_block.u4ReadIdx;
+
+	return afe_offload_block.data_buffer_size
+		+ afe_offload_block.u4WriteIdx - afe_offload_block.u4ReadIdx;
+}
+
+static void mtk_compr_offload_gdma_int_set_watermark(void)
+{
+	kal_uint64 low_watermark;
+	kal_uint32 frame_bytes = afe_offload_block.channels;
+
+	if (afe_offload_block.pcmformat == SNDRV_PCM_FORMAT_S32_LE ||
+		afe_offload_block.pcmformat == SNDRV_PCM_FORMAT_U32_LE)
+		frame_bytes <<= 2;
+	else
+		frame_bytes <<= 1;
+
+	low_watermark = (kal_uint64)afe_offload_block.samplerate * frame_bytes * OFFLOAD_LOW_WATERMARK_MS;
+	do_div(low_watermark, 1000);
+
+	/* small rings keep the old behaviour of refilling at half buffer */
+	if (low_watermark > (afe_offload_block.data_buffer_size >> 1))
+		low_watermark = afe_offload_block.data_buffer_size >> 1;
+
+	afe_offload_block.low_watermark = (kal_uint32)low_watermark;
+}
+
+/*
+ * Complete a pending drain from the feeding side: a partial drain once the
+ * current track has been moved into the hw buffer, a full drain once the
+ * data ring is empty. Only notify while the core is actually waiting,
+ * otherwise the notification would be overwritten by the DRAINING state.
+ */
+static void mtk_compr_offload_gdma_int_drain_check(struct snd_compr_stream *stream)
+{
+	if (stream->runtime->state != SNDRV_PCM_STATE_DRAINING)
+		return;
+
+	if (afe_offload_block.partial_drain) {
+		if (afe_offload_block.copied_total < afe_offload_block.drain_boundary)
+			return;
+		afe_offload_block.partial_drain = false;
+	} else if (afe_offload_block.state != OFFLOAD_STATE_DRAIN ||
+		   mtk_compr_offload_gdma_int_data_remained() != 0) {
+		return;
+	}
+
+	PRINTK_AUD_DL2("%s, drain done at %llu\n", __func__, afe_offload_block.copied_total);
+	snd_compr_drain_notify(stream);
+}
+
 int mtk_compr_offload_gdma_read(void *stream)
 {
 	/* unsigned long flags; */
@@ -230,7 +291,7 @@ int mtk_compr_offload_gdma_read(void *stream)
 			}
 			afe_offload_block.copied_total += copy_size;
 			afe_offload_block.copied += copy_size;
-			if (afe_offload_block.copied >= (afe_offload_block.data_buffer_size >> 1)) {
+			if (mtk_compr_offload_gdma_int_data_remained() <= afe_offload_block.low_watermark) {
 				PRINTK_AUD_DL2("%s, SetWakeup by request data\n", __func__);
 				afe_offload_block.copied = 0;
 				afe_offload_block.transferred = 0;
@@ -280,9 +341,15 @@ int mtk_compr_offload_gdma_read(void *stream)
 
 		}
 	}
+	mtk_compr_offload_gdma_int_drain_check(pstream);
 	return 0;
 }
 
+static void mtk_compr_offload_gdma_int_isr(void *stream)
+{
+	mtk_compr_offload_gdma_read(stream);
+}
+
 static int mtk_compr_offload_gdma_int_copy(struct snd_compr_runtime *runtime, char __user *buf, size_t count)
 {
 	void *dstn;
@@ -506,6 +573,8 @@ static int mtk_compr_offload_gdma_int_stop(struct snd_compr_stream *stream)
 	afe_offload_block.transferred  = 0;
 	afe_offload_block.copied       = 0;
 	afe_offload_block.copied_total = 0;
+	afe_offload_block.drain_boundary = 0;
+	afe_offload_block.partial_drain  = false;
 	OffloadService_SetWriteblocked(false);
 	afe_offload_block.u4ReadIdx     = 0;
 	afe_offload_block.u4WriteIdx    = 0;
@@ -667,7 +736,7 @@ static int mtk_compr_offload_gdma_open(struct snd_compr_stream *stream)
 
 
 	afe_offload_block.compr_stream  = stream;
-	/* SetOffloadCbk(Soc_Aud_Digital_Block_MEM_DL2, stream,mtk_compr_offload_gdma_read); */
+	SetOffloadCbk(Soc_Aud_Digital_Block_MEM_DL2, stream, mtk_compr_offload_gdma_int_isr);
 	OffloadService_SetVolumeCbk(mtk_compr_offload_gdma_int_setVolume);
 	afe_offload_block.state         = OFFLOAD_STATE_IDLE;
 	afe_offload_block.transferred   = 0;
@@ -677,6 +746,10 @@ static int mtk_compr_offload_gdma_open(struct snd_compr_stream *stream)
 	afe_offload_block.firstbuf      = false;
 	afe_offload_block.u4ReadIdx     = 0;
 	afe_offload_block.u4WriteIdx    = 0;
+	afe_offload_block.drain_boundary = 0;
+	afe_offload_block.partial_drain  = false;
+	afe_offload_block.encoder_delay  = 0;
+	afe_offload_block.encoder_padding = 0;
 #ifdef CONFIG_WAKELOCK
 	wake_lock_init(&Offload_suspend_lock, WAKE_LOCK_SUSPEND, "Offload wakelock");
 	mtk_compr_offload_gdma_int_wakelock(true);
@@ -708,10 +781,16 @@ static int mtk_compr_offload_gdma_set_params(struct snd_compr_stream *stream,
 	afe_offload_block.data_buffer_size = codec.reserved[1];
 	afe_offload_block.pcmformat = codec.format;
 
+	if (afe_offload_block.data_buffer_size == 0)
+		return -EINVAL;
+
 	afe_offload_block.data_buffer_area = vmalloc(afe_offload_block.data_buffer_size);
 
-	if (!(afe_offload_block.data_buffer_area))
+	if (!(afe_offload_block.data_buffer_area)) {
 		pr_warn("%s fail to allocate data buffer, size:%x\n", __func__, afe_offload_block.data_buffer_size);
+		return -ENOMEM;
+	}
+	mtk_compr_offload_gdma_int_set_watermark();
 
 	if (mPlaybackSramState == SRAM_STATE_PLAYBACKFULL) {
 		afe_offload_block.hw_buffer_size = AFE_INTERNAL_SRAM_SIZE;
@@ -725,17 +804,20 @@ static int mtk_compr_offload_gdma_set_params(struct snd_compr_stream *stream,
 
 	afe_offload_block.temp_buffer_size = afe_offload_block.hw_buffer_size;
 	afe_offload_block.temp_buffer_area = kmalloc(afe_offload_block.temp_buffer_size, GFP_KERNEL);
-	if (afe_offload_block.temp_buffer_area == NULL)
+	if (afe_offload_block.temp_buffer_area == NULL) {
 		pr_warn("%s fail to allocate temp buffer, size:%x\n", __func__, afe_offload_block.temp_buffer_size);
+		return -ENOMEM;
+	}
 
 	SetDL2Buffer();
 
-	PRINTK_AUD_DL2("%s, rate:%x, period:%x, hw_buf_size:%x area:%p addr:%x data_buf_size:%x\n", __func__,
-		       afe_offload_block.samplerate, afe_offload_block.period_size,
+	PRINTK_AUD_DL2("%s, rate:%x, period:%x, hw_buf_size:%x area:%p addr:%x data_buf_size:%x low_wm:%x\n",
+		       __func__, afe_offload_block.samplerate, afe_offload_block.period_size,
 		       afe_offload_block.hw_buffer_size,
 		       afe_offload_block.hw_buffer_area,
 		       afe_offload_block.hw_buffer_addr,
-		       afe_offload_block.data_buffer_size);
+		       afe_offload_block.data_buffer_size,
+		       afe_offload_block.low_watermark);
 
 	return 0;
 }
@@ -773,7 +855,18 @@ static int mtk_compr_offload_gdma_get_codec_caps(struct snd_compr_stream *stream
 static int mtk_compr_offload_gdma_set_metadata(struct snd_compr_stream *stream,
 					       struct snd_compr_metadata *metadata)
 {
-	PRINTK_AUD_DL2("%s\n", __func__);
+	PRINTK_AUD_DL2("%s key:%u value:%u\n", __func__, metadata->key, metadata->value[0]);
+
+	switch (metadata->key) {
+	case SNDRV_COMPRESS_ENCODER_DELAY:
+		afe_offload_block.encoder_delay = metadata->value[0];
+		break;
+	case SNDRV_COMPRESS_ENCODER_PADDING:
+		afe_offload_block.encoder_padding = metadata->value[0];
+		break;
+	default:
+		return -EINVAL;
+	}
 	return 0;
 }
 
@@ -783,7 +876,18 @@ static int mtk_compr_offload_gdma_set_metadata(struct snd_compr_stream *stream,
 static int mtk_compr_offload_gdma_get_metadata(struct snd_compr_stream *stream,
 					       struct snd_compr_metadata *metadata)
 {
-	PRINTK_AUD_DL2("%s\n", __func__);
+	PRINTK_AUD_DL2("%s key:%u\n", __func__, metadata->key);
+
+	switch (metadata->key) {
+	case SNDRV_COMPRESS_ENCODER_DELAY:
+		metadata->value[0] = afe_offload_block.encoder_delay;
+		break;
+	case SNDRV_COMPRESS_ENCODER_PADDING:
+		metadata->value[0] = afe_offload_block.encoder_padding;
+		break;
+	default:
+		return -EINVAL;
+	}
 	return 0;
 }
 
@@ -818,19 +922,16 @@ int mtk_compr_offload_gdma_copy(struct snd_compr_stream *stream, char __user *bu
 		break;
 	case OFFLOAD_STATE_RUNNING:
 		mtk_compr_offload_gdma_int_copy(runtime, buf, count);
-		if (afe_offload_block.firstbuf) {
-			if (afe_offload_block.transferred >= (afe_offload_block.data_buffer_size - 32768)) {
-				PRINTK_AUD_DL2("%s buffer full under first buffer\n", __func__);
-				OffloadService_SetWriteblocked(true);
-				afe_offload_block.firstbuf = false;
-				mtk_compr_offload_gdma_int_wakelock(false);
-			}
-		} else {
-			if (afe_offload_block.transferred >= (afe_offload_block.data_buffer_size >> 1)) {
-				PRINTK_AUD_DL2("%s buffer full under running\n", __func__);
-				OffloadService_SetWriteblocked(true);
-				mtk_compr_offload_gdma_int_wakelock(false);
-			}
+		/*
+		 * Fill the whole ring before blocking the writer, it is only woken
+		 * again at the low watermark so the AP can stay idle in between.
+		 */
+		if (mtk_compr_offload_gdma_int_data_remained() + runtime->fragment_size >=
+		    afe_offload_block.data_buffer_size) {
+			PRINTK_AUD_DL2("%s buffer full under running\n", __func__);
+			OffloadService_SetWriteblocked(true);
+			afe_offload_block.firstbuf = false;
+			mtk_compr_offload_gdma_int_wakelock(false);
 		}
 		break;
 	case OFFLOAD_STATE_DRAIN:
@@ -873,6 +974,15 @@ static int mtk_compr_offload_gdma_trigger(struct snd_compr_stream *stream, int c
 		return mtk_compr_offload_gdma_int_pause(stream);
 	case SND_COMPR_TRIGGER_DRAIN:
 		return mtk_compr_offload_gdma_int_drain(stream);
+	case SND_COMPR_TRIGGER_NEXT_TRACK:
+		/* everything written so far belongs to the current track */
+		afe_offload_block.drain_boundary = stream->runtime->total_bytes_available;
+		afe_offload_block.partial_drain = false;
+		return 0;
+	case SND_COMPR_TRIGGER_PARTIAL_DRAIN:
+		afe_offload_block.partial_drain = true;
+		OffloadService_ReleaseWriteblocked();
+		return 0;
 	}
 	return 0;
 }
@@ -70,6 +70,9 @@ static kal_uint32 BTCVSD_write_wait_queue_flag;
 static kal_uint32 BTCVSD_read_wait_queue_flag;
 static kal_uint32 writeToBT_cnt;
 static kal_uint32 readFromBT_cnt;
+static BT_SCO_STAT_T btsco_stat;
+static kal_int32 rx_trim_reads;
+static kal_int32 rx_trim_min_surplus = SCO_RX_PACKER_BUF_NUM;
 
 
 
@@ -317,7 +320,7 @@ int AudDrv_BTCVSD_IRQ_handler(void)
 {
 	kal_uint32 uPacketType, uPacketNumber, uPacketLength, uBufferCount_TX, uBufferCount_RX, uControl;
 
-	pr_warn("+%s, irq=%d\n", __func__, btcvsd_irq_number);
+	LOGBT("+%s, irq=%d\n", __func__, btcvsd_irq_number);
 
 	if ((btsco.uRXState != BT_SCO_RXSTATE_RUNNING && btsco.uRXState != BT_SCO_RXSTATE_ENDING)
 		&& (btsco.uTXState != BT_SCO_TXSTATE_RUNNING && btsco.uTXState != BT_SCO_TXSTATE_ENDING)
@@ -392,7 +395,10 @@ int AudDrv_BTCVSD_IRQ_handler(void)
 											uPacketNumber, uBufferCount_RX,
 											uControl);
 					readFromBT_cnt++;
+					if (btsco.pRX->iPacket_w - btsco.pRX->iPacket_r > btsco_stat.u4RXMaxDepth)
+						btsco_stat.u4RXMaxDepth = btsco.pRX->iPacket_w - btsco.pRX->iPacket_r;
 				} else {
+					btsco_stat.u4RXOverflow++;
 					btsco.pRX->fOverflow = true; /*KAL_TRUE;*/
 					pr_debug("%s pRX->fOverflow TRUE!!!\n", __func__);
 				}
@@ -419,6 +425,7 @@ int AudDrv_BTCVSD_IRQ_handler(void)
 											uPacketNumber, uBufferCount_TX);
 					writeToBT_cnt++;
 				} else {
+					btsco_stat.u4TXUnderflow++;
 					btsco.pTX->fUnderflow = true; /*KAL_TRUE;*/
 					pr_debug("%s pTX->fUnderflow TRUE!!!\n", __func__);
 				}
@@ -459,6 +466,62 @@ bool Register_BTCVSD_Irq(void *dev, uint32 irq_number)
 	return ret;
 }
 
+void AudDrv_btcvsd_Reset_Stat(kal_uint8 isRX)
+{
+	unsigned long flags;
+
+	if (isRX) {
+		spin_lock_irqsave(&auddrv_btcvsd_rx_lock, flags);
+		btsco_stat.u4RXDrop = 0;
+		btsco_stat.u4RXOverflow = 0;
+		btsco_stat.u4RXLate = 0;
+		btsco_stat.u4RXMaxDepth = 0;
+		rx_trim_reads = 0;
+		rx_trim_min_surplus = SCO_RX_PACKER_BUF_NUM;
+		spin_unlock_irqrestore(&auddrv_btcvsd_rx_lock, flags);
+	} else {
+		btsco_stat.u4TXUnderflow = 0;
+	}
+}
+
+void AudDrv_btcvsd_Dump_Stat(kal_uint8 isRX)
+{
+	if (isRX)
+		pr_warn("%s rx drop=%u, overflow=%u, late=%u, max_depth=%u\n", __func__,
+			btsco_stat.u4RXDrop, btsco_stat.u4RXOverflow,
+			btsco_stat.u4RXLate, btsco_stat.u4RXMaxDepth);
+	else
+		pr_warn("%s tx underflow=%u\n", __func__, btsco_stat.u4TXUnderflow);
+}
+
+/*
+ * Called with auddrv_btcvsd_rx_lock held at the start of each read, need is
+ * the number of packets the read asks for. Only the reader moves iPacket_r,
+ * and the drop never exceeds the current surplus, so r cannot pass w.
+ */
+static void AudDrv_btcvsd_RX_Trim(kal_int32 need)
+{
+	kal_int32 surplus = btsco.pRX->iPacket_w - btsco.pRX->iPacket_r - need;
+
+	if (surplus < 0)
+		btsco_stat.u4RXLate++;
+	if (surplus < rx_trim_min_surplus)
+		rx_trim_min_surplus = surplus;
+	if (++rx_trim_reads < BTSCO_CVSD_RX_TRIM_WINDOW)
+		return;
+
+	if (rx_trim_min_surplus > BTSCO_CVSD_RX_TARGET_DEPTH) {
+		kal_int32 drop = rx_trim_min_surplus - BTSCO_CVSD_RX_TARGET_DEPTH;
+
+		btsco.pRX->iPacket_r += drop;
+		btsco_stat.u4RXDrop += drop;
+		LOGBT("%s drop %d packets, w=%d, r=%d\n", __func__, drop,
+			btsco.pRX->iPacket_w, btsco.pRX->iPacket_r);
+	}
+	rx_trim_reads = 0;
+	rx_trim_min_surplus = SCO_RX_PACKER_BUF_NUM;
+}
+
 ssize_t AudDrv_btcvsd_read(char __user *data, size_t count)
 {
 	char *Read_Data_Ptr = (char *)data;
@@ -475,6 +538,10 @@ ssize_t AudDrv_btcvsd_read(char __user *data, size_t count)
 
 	read_timeout_limit = ((kal_uint64)SCO_RX_PACKER_BUF_NUM * SCO_RX_PLC_SIZE * 16 * 1000000000) / 2 / 2 / 64000;
 
+	spin_lock_irqsave(&auddrv_btcvsd_rx_lock, flags);
+	AudDrv_btcvsd_RX_Trim(count / (SCO_RX_PLC_SIZE + BTSCO_CVSD_PACKET_VALID_SIZE));
+	spin_unlock_irqrestore(&auddrv_btcvsd_rx_lock, flags);
+
 	while (count) {
 		LOGBT("%s btsco.pRX->iPacket_w=%d, btsco.pRX->iPacket_r=%d,count=%zu\n",
 				__func__, btsco.pRX->iPacket_w, btsco.pRX->iPacket_r, count);
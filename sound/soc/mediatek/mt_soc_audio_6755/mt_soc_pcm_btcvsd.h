@@ -100,6 +100,15 @@ extern struct device *mDev_btcvsd_tx;
 #define BTSCO_CVSD_PACKET_VALID_SIZE 2
 #define BTSCO_CVSD_RX_TEMPINPUTBUF_SIZE (BTSCO_CVSD_RX_FRAME*(SCO_RX_PLC_SIZE+BTSCO_CVSD_PACKET_VALID_SIZE))
 
+/*
+ * RX jitter buffer: packets kept queued beyond what a read asks for. The
+ * smallest surplus seen over a window of reads is what the link jitter
+ * needs, anything above target depth is dropped (oldest first) to cut
+ * mouth-to-ear latency.
+ */
+#define BTSCO_CVSD_RX_TARGET_DEPTH 2
+#define BTSCO_CVSD_RX_TRIM_WINDOW 64
+
 #define BTSCO_CVSD_TX_FRAME SCO_TX_PACKER_BUF_NUM
 #define BTSCO_CVSD_TX_OUTBUF_SIZE (BTSCO_CVSD_TX_FRAME*SCO_TX_ENCODE_SIZE)
 
@@ -195,6 +204,14 @@ typedef struct {
 		kal_uint32      u4BufferSize; /* TX packetbuf size */
 } BT_SCO_TX_T;
 
+typedef struct {
+		kal_uint32 u4RXDrop;      /* queued packets dropped to hold the target depth */
+		kal_uint32 u4RXOverflow;  /* interrupts whose packets found no room */
+		kal_uint32 u4RXLate;      /* reads that had to wait for the link */
+		kal_uint32 u4RXMaxDepth;  /* deepest queue seen, in packets */
+		kal_uint32 u4TXUnderflow; /* interrupts with nothing to send */
+} BT_SCO_STAT_T;
+
 typedef struct {
 		BT_SCO_TX_T *pTX;
 		BT_SCO_RX_T *pRX;
@@ -236,6 +253,8 @@ ssize_t AudDrv_btcvsd_write(const char __user *data, size_t count);
 void Disable_CVSD_Wakeup(void);
 void Enable_CVSD_Wakeup(void);
 void Set_BTCVSD_State(unsigned long arg);
+void AudDrv_btcvsd_Reset_Stat(kal_uint8 isRX);
+void AudDrv_btcvsd_Dump_Stat(kal_uint8 isRX);
 
 
 /* here is temp address for ioremap BT hardware register */
@@ -298,6 +298,7 @@ static int mtk_pcm_btcvsd_rx_close(struct snd_pcm_substream *substream)
 
 	Set_BTCVSD_State(BT_SCO_RXSTATE_ENDING);
 	Set_BTCVSD_State(BT_SCO_RXSTATE_IDLE);
+	AudDrv_btcvsd_Dump_Stat(1);
 	ret = AudDrv_btcvsd_Free_Buffer(1);
 
 	BT_CVSD_Mem.RX_substream = NULL;
@@ -316,6 +317,7 @@ static int mtk_pcm_btcvsd_rx_open(struct snd_pcm_substream *substream)
 	pr_warn("%s\n", __func__);
 
 	ret = AudDrv_btcvsd_Allocate_Buffer(1);
+	AudDrv_btcvsd_Reset_Stat(1);
 
 	runtime->hw = mtk_btcvsd_rx_hardware;
 
@@ -205,6 +205,7 @@ static int mtk_pcm_btcvsd_tx_close(struct snd_pcm_substream *substream)
 
 	Set_BTCVSD_State(BT_SCO_TXSTATE_ENDING);
 	Set_BTCVSD_State(BT_SCO_TXSTATE_IDLE);
+	AudDrv_btcvsd_Dump_Stat(0);
 	ret = AudDrv_btcvsd_Free_Buffer(0);
 
 	BT_CVSD_Mem.TX_substream = NULL;
@@ -223,6 +224,7 @@ static int mtk_pcm_btcvsd_tx_open(struct snd_pcm_substream *substream)
 	pr_warn("%s\n", __func__);
 
 	ret = AudDrv_btcvsd_Allocate_Buffer(0);
+	AudDrv_btcvsd_Reset_Stat(0);
 
 	runtime->hw = mtk_btcvsd_tx_hardware;
 
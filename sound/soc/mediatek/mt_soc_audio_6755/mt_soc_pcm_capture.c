@@ -80,7 +80,8 @@ static struct snd_pcm_hardware mtk_capture_hardware = {
 	.info = (SNDRV_PCM_INFO_MMAP |
 	SNDRV_PCM_INFO_INTERLEAVED |
 	SNDRV_PCM_INFO_RESUME |
-	SNDRV_PCM_INFO_MMAP_VALID),
+	SNDRV_PCM_INFO_MMAP_VALID |
+	SNDRV_PCM_INFO_NO_PERIOD_WAKEUP),
 	.formats =      SND_SOC_ADV_MT_FMTS,
 	.rates =        SOC_HIGH_USE_RATE,
 	.rate_min =     SOC_HIGH_USE_RATE_MIN,
@@ -176,7 +177,9 @@ static void StartAudioCaptureHardware(struct snd_pcm_substream *substream)
 	/* here to set interrupt */
 	SetIrqMcuCounter(Soc_Aud_IRQ_MCU_MODE_IRQ2_MCU_MODE, substream->runtime->period_size);
 	SetIrqMcuSampleRate(Soc_Aud_IRQ_MCU_MODE_IRQ2_MCU_MODE, substream->runtime->rate);
-	SetIrqEnable(Soc_Aud_IRQ_MCU_MODE_IRQ2_MCU_MODE, true);
+	/* no period wakeup: user space polls the hw pointer, keep IRQ2 off */
+	if (!substream->runtime->no_period_wakeup)
+		SetIrqEnable(Soc_Aud_IRQ_MCU_MODE_IRQ2_MCU_MODE, true);
 
 	SetSampleRate(Soc_Aud_Digital_Block_MEM_VUL, substream->runtime->rate);
 	SetMemoryPathEnable(Soc_Aud_Digital_Block_MEM_VUL, true);
@@ -251,10 +254,23 @@ static snd_pcm_uframes_t mtk_capture_pcm_pointer(struct snd_pcm_substream *subst
 	bool bIsOverflow = false;
 	unsigned long flags;
 	AFE_BLOCK_T *UL1_Block = &(VUL_Control_context->rBlock);
+	struct snd_pcm_runtime *runtime = substream->runtime;
 
 	PRINTK_AUD_UL1("%s Awb_Block->u4WriteIdx;= 0x%x\n", __func__, UL1_Block->u4WriteIdx);
 	Auddrv_UL1_Spinlock_lock();
 	spin_lock_irqsave(&VUL_Control_context->substream_lock, flags);
+
+	/*
+	 * MMAP access never goes through mtk_capture_pcm_copy(), take the read
+	 * side from the application pointer so the overflow check stays valid.
+	 */
+	if (runtime->access == SNDRV_PCM_ACCESS_MMAP_INTERLEAVED && UL1_Block->u4BufferSize) {
+		UL1_Block->u4DataRemained =
+		    audio_frame_to_bytes(substream, snd_pcm_capture_avail(runtime));
+		UL1_Block->u4DMAReadIdx = (UL1_Block->u4WriteIdx + UL1_Block->u4BufferSize -
+					   UL1_Block->u4DataRemained % UL1_Block->u4BufferSize) %
+		    UL1_Block->u4BufferSize;
+	}
 	PRINTK_AUD_UL1("mtk_capture_pcm_pointer UL1_Block->u4WriteIdx= 0x%x, u4DataRemained=0x%x\n",
 		       UL1_Block->u4WriteIdx, UL1_Block->u4DataRemained);
 
@@ -702,6 +718,13 @@ static struct page *mtk_capture_pcm_page(struct snd_pcm_substream *substream,
 }
 
 
+static int mtk_capture_pcm_mmap(struct snd_pcm_substream *substream,
+				struct vm_area_struct *vma)
+{
+	pr_warn("%s\n", __func__);
+	return audio_mmap_dma_area(substream, vma);
+}
+
 static struct snd_pcm_ops mtk_afe_capture_ops = {
 	.open = mtk_capture_pcm_open,
 	.close = mtk_capture_pcm_close,
@@ -714,6 +737,7 @@ static struct snd_pcm_ops mtk_afe_capture_ops = {
 	.copy = mtk_capture_pcm_copy,
 	.silence = mtk_capture_pcm_silence,
 	.page = mtk_capture_pcm_page,
+	.mmap = mtk_capture_pcm_mmap,
 };
 
 static struct snd_soc_platform_driver mtk_soc_platform = {
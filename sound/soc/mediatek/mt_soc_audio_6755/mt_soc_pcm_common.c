@@ -59,3 +59,21 @@ unsigned long audio_bytes_to_frame(struct snd_pcm_substream *substream, unsigned
 	/* pr_debug("%s bytes = %d count = %d\n",__func__,bytes,count); */
 	return count;
 }
+
+/*
+ * Map the AFE buffer (SRAM or DRAM) straight into user space, so MMAP
+ * access streams write/read the memory the memif is fetching from instead
+ * of a dummy page.
+ */
+int audio_mmap_dma_area(struct snd_pcm_substream *substream, struct vm_area_struct *vma)
+{
+	struct snd_pcm_runtime *runtime = substream->runtime;
+	unsigned long size = vma->vm_end - vma->vm_start;
+
+	if (runtime->dma_addr == 0 || size > PAGE_ALIGN(runtime->dma_bytes))
+		return -EINVAL;
+
+	vma->vm_page_prot = pgprot_writecombine(vma->vm_page_prot);
+	return remap_pfn_range(vma, vma->vm_start, runtime->dma_addr >> PAGE_SHIFT,
+			       size, vma->vm_page_prot);
+}
@@ -214,6 +214,7 @@ extern const unsigned int soc_high_supported_sample_rates[13];
 
 unsigned long audio_frame_to_bytes(struct snd_pcm_substream *substream, unsigned long count);
 unsigned long audio_bytes_to_frame(struct snd_pcm_substream *substream, unsigned long count);
+int audio_mmap_dma_area(struct snd_pcm_substream *substream, struct vm_area_struct *vma);
 
 extern void *AFE_BASE_ADDRESS;
 
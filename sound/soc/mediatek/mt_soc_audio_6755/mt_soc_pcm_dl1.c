@@ -147,7 +147,8 @@ static bool mPrepareDone;
 
 static struct snd_pcm_hardware mtk_pcm_dl1_hardware = {
 	.info = (SNDRV_PCM_INFO_MMAP |
-		 SNDRV_PCM_INFO_INTERLEAVED | SNDRV_PCM_INFO_RESUME | SNDRV_PCM_INFO_MMAP_VALID),
+		 SNDRV_PCM_INFO_INTERLEAVED | SNDRV_PCM_INFO_RESUME | SNDRV_PCM_INFO_MMAP_VALID |
+		 SNDRV_PCM_INFO_NO_PERIOD_WAKEUP),
 	.formats = SND_SOC_ADV_MT_FMTS,
 	.rates = SOC_HIGH_USE_RATE,
 	.rate_min = SOC_HIGH_USE_RATE_MIN,
@@ -189,11 +190,23 @@ static snd_pcm_uframes_t mtk_pcm_pointer(struct snd_pcm_substream *substream)
 	kal_uint32 Frameidx = 0;
 	kal_int32 Afe_consumed_bytes = 0;
 	AFE_BLOCK_T *Afe_Block = &pMemControl->rBlock;
-	/* struct snd_pcm_runtime *runtime = substream->runtime; */
+	struct snd_pcm_runtime *runtime = substream->runtime;
+
 	PRINTK_AUD_DL1(" %s Afe_Block->u4DMAReadIdx = 0x%x\n", __func__, Afe_Block->u4DMAReadIdx);
 
 	Auddrv_Dl1_Spinlock_lock();
 
+	/*
+	 * MMAP access never goes through mtk_pcm_copy(), take the write side
+	 * from the application pointer so the ISR underflow check stays valid.
+	 */
+	if (runtime->access == SNDRV_PCM_ACCESS_MMAP_INTERLEAVED && Afe_Block->u4BufferSize) {
+		Afe_Block->u4DataRemained =
+		    audio_frame_to_bytes(substream, snd_pcm_playback_hw_avail(runtime));
+		Afe_Block->u4WriteIdx = (Afe_Block->u4DMAReadIdx + Afe_Block->u4DataRemained) %
+		    Afe_Block->u4BufferSize;
+	}
+
 	/* get total bytes to copy */
 	/* Frameidx = audio_bytes_to_frame(substream , Afe_Block->u4DMAReadIdx); */
 	/* return Frameidx; */
@@ -448,7 +461,9 @@ static int mtk_pcm_dl1_start(struct snd_pcm_substream *substream)
 	SetConnection(Soc_Aud_InterCon_Connection, Soc_Aud_InterConnectionInput_I06,
 		      Soc_Aud_InterConnectionOutput_O04);
 
-	SetIrqEnable(Soc_Aud_IRQ_MCU_MODE_IRQ1_MCU_MODE, true);
+	/* no period wakeup: user space polls the hw pointer, keep IRQ1 off */
+	if (!runtime->no_period_wakeup)
+		SetIrqEnable(Soc_Aud_IRQ_MCU_MODE_IRQ1_MCU_MODE, true);
 
 	SetSampleRate(Soc_Aud_Digital_Block_MEM_DL1, runtime->rate);
 	SetChannels(Soc_Aud_Digital_Block_MEM_DL1, runtime->channels);
@@ -703,6 +718,12 @@ static struct page *mtk_pcm_page(struct snd_pcm_substream *substream, unsigned l
 	return virt_to_page(dummy_page[substream->stream]);	/* the same page */
 }
 
+static int mtk_pcm_mmap(struct snd_pcm_substream *substream, struct vm_area_struct *vma)
+{
+	PRINTK_AUDDRV("%s\n", __func__);
+	return audio_mmap_dma_area(substream, vma);
+}
+
 static struct snd_pcm_ops mtk_afe_ops = {
 	.open = mtk_pcm_dl1_open,
 	.close = mtk_soc_pcm_dl1_close,
@@ -715,6 +736,7 @@ static struct snd_pcm_ops mtk_afe_ops = {
 	.copy = mtk_pcm_copy,
 	.silence = mtk_pcm_silence,
 	.page = mtk_pcm_page,
+	.mmap = mtk_pcm_mmap,
 };
 
 static struct snd_soc_platform_driver mtk_soc_platform = {
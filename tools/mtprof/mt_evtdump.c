@@ -0,0 +1,166 @@
+/*
+ * mt_evtdump - decode the mtprof binary event log
+ *
+ * usage: mt_evtdump [file]
+ *
+ * file defaults to /sys/kernel/debug/mtprof/evtlog; a copy of it taken
+ * with cat/adb pull decodes the same way. Records of all cpus are merged
+ * by timestamp. Function arguments are printed as addresses, look them up
+ * in /proc/kallsyms or with addr2line on vmlinux.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mt_evtlog.h"
+
+#define DEFAULT_PATH "/sys/kernel/debug/mtprof/evtlog"
+
+struct evt {
+	struct mt_evtlog_rec rec;
+	unsigned int cpu;
+};
+
+static const char *evt_name(unsigned int id)
+{
+	switch (id) {
+	case MT_EVT_BOOT:	return "boot";
+	case MT_EVT_INITCALL:	return "initcall";
+	case MT_EVT_ISR:	return "isr";
+	case MT_EVT_SOFTIRQ:	return "softirq";
+	case MT_EVT_TASKLET:	return "tasklet";
+	case MT_EVT_HRTIMER:	return "hrtimer";
+	case MT_EVT_STIMER:	return "timer";
+	default:		return "?";
+	}
+}
+
+static int evt_cmp(const void *a, const void *b)
+{
+	const struct evt *x = a, *y = b;
+
+	if (x->rec.ts == y->rec.ts)
+		return 0;
+	return x->rec.ts < y->rec.ts ? -1 : 1;
+}
+
+static void *map_log(const char *path, size_t *size)
+{
+	struct mt_evtlog_hdr hdr;
+	void *p;
+	ssize_t n;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		perror(path);
+		return NULL;
+	}
+	if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) || hdr.magic != MT_EVTLOG_MAGIC) {
+		fprintf(stderr, "%s: not an event log\n", path);
+		close(fd);
+		return NULL;
+	}
+	if (hdr.version != MT_EVTLOG_VERSION || hdr.rec_size != sizeof(struct mt_evtlog_rec)) {
+		fprintf(stderr, "%s: version %u, record size %u not supported\n",
+			path, hdr.version, hdr.rec_size);
+		close(fd);
+		return NULL;
+	}
+	*size = hdr.data_offset + (size_t)hdr.nr_cpus * hdr.nr_recs * hdr.rec_size;
+
+	p = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED) {
+		/* debugfs copies without mmap support, read it instead */
+		p = malloc(*size);
+		if (p) {
+			n = pread(fd, p, *size, 0);
+			if (n != (ssize_t)*size) {
+				free(p);
+				p = NULL;
+			}
+		}
+	}
+	close(fd);
+	if (!p)
+		fprintf(stderr, "%s: can not map %zu bytes\n", path, *size);
+	return p;
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = argc > 1 ? argv[1] : DEFAULT_PATH;
+	const struct mt_evtlog_hdr *hdr;
+	const struct mt_evtlog_rec *ring;
+	struct evt *evts;
+	unsigned long long head, first, idx;
+	size_t size, n = 0, i;
+	unsigned int cpu;
+
+	hdr = map_log(path, &size);
+	if (!hdr)
+		return 1;
+
+	evts = calloc((size_t)hdr->nr_cpus * hdr->nr_recs, sizeof(*evts));
+	if (!evts) {
+		perror("calloc");
+		return 1;
+	}
+
+	for (cpu = 0; cpu < hdr->nr_cpus; cpu++) {
+		size_t start = n;
+
+		ring = (const struct mt_evtlog_rec *)((const char *)hdr + hdr->data_offset) +
+			(size_t)cpu * hdr->nr_recs;
+		head = *(volatile const unsigned long long *)&hdr->cpu[cpu].head;
+		__sync_synchronize();
+		first = head > hdr->nr_recs ? head - hdr->nr_recs : 0;
+		for (idx = first; idx < head; idx++) {
+			evts[n].rec = ring[idx & (hdr->nr_recs - 1)];
+			evts[n].cpu = cpu;
+			n++;
+		}
+		/* drop what the kernel overwrote while we copied */
+		__sync_synchronize();
+		head = *(volatile const unsigned long long *)&hdr->cpu[cpu].head;
+		if (head >= hdr->nr_recs && head - hdr->nr_recs + 1 > first) {
+			size_t stale = head - hdr->nr_recs + 1 - first;
+
+			if (stale > n - start)
+				stale = n - start;
+			memmove(&evts[start], &evts[start + stale],
+				(n - start - stale) * sizeof(*evts));
+			n -= stale;
+		}
+	}
+
+	qsort(evts, n, sizeof(*evts), evt_cmp);
+
+	for (i = 0; i < n; i++) {
+		const struct mt_evtlog_rec *r = &evts[i].rec;
+
+		printf("%6llu.%06llu cpu%u %6u %-8s ",
+		       (unsigned long long)r->ts / 1000000000ULL,
+		       (unsigned long long)(r->ts % 1000000000ULL) / 1000,
+		       evts[i].cpu, r->pid, evt_name(r->id));
+		switch (r->id) {
+		case MT_EVT_BOOT:
+			printf("#%llu\n", (unsigned long long)r->a0);
+			break;
+		case MT_EVT_ISR:
+		case MT_EVT_SOFTIRQ:
+			printf("%llu dur %llu us\n", (unsigned long long)r->a0,
+			       (unsigned long long)r->a1 / 1000);
+			break;
+		default:
+			printf("0x%llx dur %llu us\n", (unsigned long long)r->a0,
+			       (unsigned long long)r->a1 / 1000);
+			break;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,74 @@
+#!/bin/sh
+#
+# perfbench.sh - run the in-kernel multimedia benchmarks and compare runs
+#
+# usage: perfbench.sh run [bench] [iters] > new.tsv
+#        perfbench.sh compare old.tsv new.tsv [percent]
+#
+# run writes bench (default all) to /sys/kernel/debug/mt_perfbench/run
+# of the device adb talks to, CONFIG_MTPROF_PERFBENCH, and prints the
+# table. Set CPUS to a taskset mask to pin the run, e.g. CPUS=f0.
+#
+# compare matches the rows of two tables by bench and param and prints
+# those whose p50 or p99 grew by more than percent (default 10), or that
+# failed in the new table only. It exits 1 if there is any.
+
+DIR=/sys/kernel/debug/mt_perfbench
+
+die() {
+	echo "perfbench.sh: $*" >&2
+	exit 2
+}
+
+run() {
+	bench=${1:-all}
+	cmd="echo $bench > $DIR/run"
+	[ -n "$2" ] && cmd="echo $2 > $DIR/iters && $cmd"
+	[ -n "$CPUS" ] && cmd="taskset $CPUS sh -c '$cmd'"
+	adb shell "$cmd" || die "run of $bench failed"
+	adb shell cat $DIR/run | tr -d '\r'
+}
+
+compare() {
+	[ -r "$1" ] && [ -r "$2" ] || die "compare needs two tables"
+	[ "$(head -1 "$1")" = "$(head -1 "$2")" ] || die "table versions differ"
+
+	awk -F '\t' -v pct="${3:-10}" '
+		/^#/ || $1 == "bench" { next }
+		FNR == NR { p50[$1 FS $2] = $4; p99[$1 FS $2] = $6; err[$1 FS $2] = $8; next }
+		{
+			k = $1 FS $2
+			if (!(k in p50))
+				next
+			if ($8 != 0 && err[k] == 0) {
+				printf "%s\t%s\tnow fails: %d\n", $1, $2, $8
+				bad = 1
+				next
+			}
+			if ($8 != 0 || p50[k] == 0)
+				next
+			d50 = ($4 - p50[k]) * 100 / p50[k]
+			d99 = p99[k] ? ($6 - p99[k]) * 100 / p99[k] : 0
+			if (d50 > pct || d99 > pct) {
+				printf "%s\t%s\tp50 %d -> %d (%+.0f%%)\tp99 %d -> %d (%+.0f%%)\n",
+				       $1, $2, p50[k], $4, d50, p99[k], $6, d99
+				bad = 1
+			}
+		}
+		END { exit bad }' "$1" "$2"
+}
+
+case "$1" in
+run)
+	shift
+	run "$@"
+	;;
+compare)
+	shift
+	compare "$@"
+	;;
+*)
+	sed -n '3,14s/^# \{0,1\}//p' "$0"
+	exit 2
+	;;
+esac